@@ -18,8 +18,10 @@ limitations under the License.
 
 #ifdef NETWORKX
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <tuple>
 #include <utility>
@@ -28,6 +30,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "apps/apsp/all_pairs_shortest_path_length_context.h"
+#include "apps/bfs/multi_source_bfs.h"
 #include "core/utils/trait_utils.h"
 
 namespace gs {
@@ -35,7 +38,8 @@ namespace gs {
 /**
  * @brief Compute the all pairs shortest path length of a graph.
  * if the graph is weighted graph, use Dijkstra algorithm.
- * if the graph is unweighted graph, use BFS algorithm.
+ * if the graph is unweighted graph, use BFS algorithm, from 64 sources at a
+ * time by MultiSourceBFS.
  * */
 template <typename FRAG_T>
 class AllPairsShortestPathLength
@@ -57,17 +61,21 @@ class AllPairsShortestPathLength
              message_manager_t& messages) {
     auto inner_vertices = frag.InnerVertices();
     auto vertices = frag.Vertices();
-    ForEach(inner_vertices,
-            [&frag, &ctx, &vertices, this](int tid, vertex_t v) {
-              ctx.length[v].Init(vertices, std::numeric_limits<double>::max());
-              if (std::is_same<edata_t, grape::EmptyType>::value) {
-                // unweighted graph, use bfs.
-                this->bfs(frag, v, ctx);
-              } else {
-                // weighted graph, use dijkstra.
+    if (std::is_same<edata_t, grape::EmptyType>::value) {
+      // unweighted graph, use bfs.
+      ForEach(inner_vertices, [&ctx, &vertices](int tid, vertex_t v) {
+        ctx.length[v].Init(vertices, std::numeric_limits<double>::max());
+      });
+      multiSourceBFS(frag, ctx);
+    } else {
+      // weighted graph, use dijkstra.
+      ForEach(inner_vertices,
+              [&frag, &ctx, &vertices, this](int tid, vertex_t v) {
+                ctx.length[v].Init(vertices,
+                                   std::numeric_limits<double>::max());
                 this->dijkstraLength(frag, v, ctx);
-              }
-            });
+              });
+    }
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
@@ -116,25 +124,40 @@ class AllPairsShortestPathLength
     }
   }
 
-  void bfs(const fragment_t& frag, vertex_t& s, context_t& ctx) {
-    std::queue<vertex_t> que;
-    ctx.length[s][s] = 0;
-    que.push(s);
-    while (!que.empty()) {
-      vertex_t u = que.front();
-      que.pop();
-
-      // set depth for neighbors with current depth + 1
-      auto new_depth = ctx.length[s][u] + 1;
-      auto oes = frag.GetOutgoingAdjList(u);
-      for (auto& e : oes) {
-        vertex_t v = e.get_neighbor();
-        if (ctx.length[s][v] > new_depth) {
-          ctx.length[s][v] = new_depth;
-          que.push(v);
-        }
-      }
+  // the inner vertices in batches of MultiSourceBFS::kBatchSize sources, a
+  // batch by a thread.
+  void multiSourceBFS(const fragment_t& frag, context_t& ctx) {
+    using bfs_t = MultiSourceBFS<fragment_t>;
+    std::vector<vertex_t> sources;
+    for (auto& v : frag.InnerVertices()) {
+      sources.push_back(v);
     }
+    std::vector<size_t> batches;
+    for (size_t i = 0; i < sources.size(); i += bfs_t::kBatchSize) {
+      batches.push_back(i);
+    }
+    std::vector<std::unique_ptr<bfs_t>> kernels(thread_num());
+    ForEach(
+        batches.begin(), batches.end(),
+        [&frag, &ctx, &sources, &kernels](int tid, size_t begin) {
+          if (kernels[tid] == nullptr) {
+            kernels[tid].reset(new bfs_t(frag));
+          }
+          int num = static_cast<int>(
+              std::min(sources.size() - begin,
+                       static_cast<size_t>(bfs_t::kBatchSize)));
+          const vertex_t* batch = sources.data() + begin;
+          kernels[tid]->Run(
+              batch, num,
+              [&ctx, batch](vertex_t v, typename bfs_t::lanes_t lanes,
+                            int depth) {
+                while (lanes != 0) {
+                  ctx.length[batch[__builtin_ctzll(lanes)]][v] = depth;
+                  lanes &= lanes - 1;
+                }
+              });
+        },
+        1);
   }
 };
 
@@ -18,8 +18,6 @@ Author: Ning Xin
 #ifndef ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_ATTRIBUTE_ASSORTATIVITY_H_
 #define ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_ATTRIBUTE_ASSORTATIVITY_H_
 
-#include <unordered_map>
-#include <utility>
 #include <vector>
 
 #include "grape/grape.h"
@@ -59,62 +57,77 @@ class AttributeAssortativity
              message_manager_t& messages) {
     auto inner_vertices = frag.InnerVertices();
     for (auto v : inner_vertices) {
-      ProcessVertex<vdata_t>(v, frag, ctx, messages);
+      processVertex(v, frag, ctx, messages);
     }
     messages.ForceContinue();
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    if (!ctx.merge_stage) {
-      UpdateAttributeMixingMap<vertex_t, vdata_t>(frag, ctx, messages);
+    // count the edges from the outer vertices
+    vdata_t source_data;
+    vertex_t u;
+    while (messages.GetMessage(frag, u, source_data)) {
+      attributeMixingCount(source_data, frag.GetData(u), ctx);
+    }
+    if (ctx.numeric) {
+      // numeric assortativity app
+      CorrelationMoments moments;
+      AllReduce(ctx.moments, moments,
+                [](CorrelationMoments& out, const CorrelationMoments& in) {
+                  out += in;
+                });
+      ctx.attribute_assortativity = moments.Correlation();
     } else {
-      // merge in worker 0
-      if (frag.fid() == 0) {
-        MergeAttributeMixingMap<vdata_t>(ctx, messages);
-        std::vector<std::vector<double>> attribute_mixing_matrix;
-        // numeric assortativity app
-        if (ctx.numeric) {
-          std::unordered_map<int, double> map;
-          getNumericMixingMatrix(ctx, attribute_mixing_matrix, map);
-          // compute numeric assortativity
-          ctx.attribute_assortativity =
-              ProcessMatrix(attribute_mixing_matrix, map);
-        } else {  // attribute assortativity app
-          getAttributeMixingMatrix(ctx, attribute_mixing_matrix);
-          // compute attribute assortativity
-          ctx.attribute_assortativity =
-              computeAssortativity(attribute_mixing_matrix);
-        }
-        // write result to ctx
-        std::vector<size_t> shape{1};
-        ctx.set_shape(shape);
-        ctx.assign(ctx.attribute_assortativity);
-        VLOG(0) << "attribute assortativity: " << ctx.attribute_assortativity
-                << std::endl;
-      }
+      // attribute assortativity app
+      attribute_count_t counts;
+      AllReduce(ctx.attribute_counts, counts,
+                [](attribute_count_t& out, const attribute_count_t& in) {
+                  for (auto& pair : in) {
+                    auto& count = out[pair.first];
+                    count.first += pair.second.first;
+                    count.second += pair.second.second;
+                  }
+                });
+      double same_num = 0;
+      Sum(ctx.same_num, same_num);
+      ctx.attribute_assortativity = computeAssortativity(counts, same_num);
+    }
+    if (frag.fid() == 0) {
+      // write result to ctx
+      std::vector<size_t> shape{1};
+      ctx.set_shape(shape);
+      ctx.assign(ctx.attribute_assortativity);
+      VLOG(0) << "attribute assortativity: " << ctx.attribute_assortativity
+              << std::endl;
     }
   }
+
+ private:
+  using attribute_count_t = typename context_t::attribute_count_t;
+
   /**
-   * @brief count the attribute-attribute pairs
+   * @brief count the attribute-attribute pair
    *
    * @param source_data the data of source node
    * @param target_data the data of target node
    * @param ctx
    */
-  template <typename vdata_t, typename context_t>
-  inline void AttributeMixingCount(vdata_t source_data, vdata_t target_data,
-                                   context_t& ctx) {
-    if (ctx.attribute_mixing_map.count(source_data) == 0 ||
-        ctx.attribute_mixing_map[source_data].count(target_data) == 0) {
-      ctx.attribute_mixing_map[source_data][target_data] = 1;
+  inline void attributeMixingCount(const vdata_t& source_data,
+                                   const vdata_t& target_data, context_t& ctx) {
+    if (ctx.numeric) {
+      ctx.moments.Add(toDouble(source_data), toDouble(target_data));
     } else {
-      ctx.attribute_mixing_map[source_data][target_data] += 1;
+      ctx.attribute_counts[source_data].first += 1;
+      ctx.attribute_counts[target_data].second += 1;
+      if (source_data == target_data) {
+        ctx.same_num += 1;
+      }
     }
   }
 
   /**
-   * @brief traverse the outgoing neighbors of vertex v and update the
+   * @brief traverse the outgoing neighbors of vertex v and count the
    * attribute-attribute pairs.
    *
    * @param v
@@ -122,9 +135,7 @@ class AttributeAssortativity
    * @param ctx
    * @param messages
    */
-  template <typename vdata_t, typename vertex_t, typename fragment_t,
-            typename context_t, typename message_manager_t>
-  void ProcessVertex(const vertex_t& v, const fragment_t& frag, context_t& ctx,
+  void processVertex(const vertex_t& v, const fragment_t& frag, context_t& ctx,
                      message_manager_t& messages) {
     vdata_t source_data = frag.GetData(v);
     // get all neighbors of vertex v
@@ -134,188 +145,42 @@ class AttributeAssortativity
       if (frag.IsOuterVertex(neighbor)) {
         messages.SyncStateOnOuterVertex(frag, neighbor, source_data);
       } else {
-        vdata_t target_data = frag.GetData(neighbor);
-        AttributeMixingCount(source_data, target_data, ctx);
-      }
-    }
-  }
-  /**
-   * @brief update the attribute-attribute pairs from the outer vertex.
-   *
-   * @param frag
-   * @param ctx
-   * @param messages
-   */
-  template <typename vertex_t, typename vdata_t, typename fragment_t,
-            typename context_t, typename message_manager_t>
-  void UpdateAttributeMixingMap(const fragment_t& frag, context_t& ctx,
-                                message_manager_t& messages) {
-    vdata_t source_data;
-    vertex_t u;
-    // update attribute mixing map
-    while (messages.GetMessage(frag, u, source_data)) {
-      vdata_t target_data = frag.GetData(u);
-      AttributeMixingCount(source_data, target_data, ctx);
-    }
-    ctx.merge_stage = true;
-    // send message to worker 0
-    if (frag.fid() != 0) {
-      messages.SendToFragment(0, ctx.attribute_mixing_map);
-    }
-    messages.ForceContinue();
-  }
-
-  /**
-   * @brief merge attribute mixing map of all workers in worker 0 and the result
-   * is saved in the context of worker 0.
-   *
-   * @param ctx
-   * @param messages
-   *
-   */
-  template <typename vdata_t, typename context_t, typename message_manager_t>
-  void MergeAttributeMixingMap(context_t& ctx, message_manager_t& messages) {
-    std::unordered_map<vdata_t, std::unordered_map<vdata_t, int>> msg;
-    while (messages.GetMessage(msg)) {
-      for (auto& pair1 : msg) {
-        for (auto& pair2 : pair1.second) {
-          // merge
-          if (ctx.attribute_mixing_map.count(pair1.first) == 0 ||
-              ctx.attribute_mixing_map[pair1.first].count(pair2.first) == 0) {
-            ctx.attribute_mixing_map[pair1.first][pair2.first] = pair2.second;
-          } else {
-            ctx.attribute_mixing_map[pair1.first][pair2.first] += pair2.second;
-          }
-        }
+        attributeMixingCount(source_data, frag.GetData(neighbor), ctx);
       }
     }
   }
 
- private:
   /**
-   * @brief Compute assortativity for attribute matrix attribute_mixing_matrix
+   * @brief Compute assortativity from the marginals of the attribute mixing
+   * matrix, (sum_i e_ii - sum_i a_i b_i) / (1 - sum_i a_i b_i), which is
+   * all the matrix is needed for.
    *
-   * @param attribute_mixing_matrix n x n matrix
+   * @param counts {value: {number of edges from, number of edges to}}
+   * @param same_num the number of edges between equal values
    * @return attribute assortativity
    */
-  double computeAssortativity(
-      std::vector<std::vector<double>>& attribute_mixing_matrix) {
-    int n = attribute_mixing_matrix.size();
-    std::vector<double> a;
-    // sum of column
-    for (auto& row : attribute_mixing_matrix) {
-      a.emplace_back(accumulate(row.begin(), row.end(), 0.0));
+  double computeAssortativity(const attribute_count_t& counts,
+                              double same_num) {
+    double total_edge_num = 0.0;
+    for (auto& pair : counts) {
+      total_edge_num += pair.second.first;
     }
-    std::vector<double> b;
-    // sum of row
-    for (int i = 0; i < n; i++) {
-      double sum = 0.0;
-      for (int j = 0; j < n; j++) {
-        sum += attribute_mixing_matrix[j][i];
-      }
-      b.emplace_back(sum);
-    }
-    double sum_eii = 0.0, sum_ai_bi = 0.0;
-    for (int i = 0; i < n; i++) {
-      sum_eii += attribute_mixing_matrix[i][i];
-      sum_ai_bi += a[i] * b[i];
+    double sum_ai_bi = 0.0;
+    for (auto& pair : counts) {
+      sum_ai_bi += (pair.second.first / total_edge_num) *
+                   (pair.second.second / total_edge_num);
     }
+    double sum_eii = same_num / total_edge_num;
     return (sum_eii - sum_ai_bi) / (1 - sum_ai_bi);
   }
 
-  /**
-   * @brief get attribute mixing matrix by attribute mixing map
-   *
-   * @param ctx
-   * @param[out] attribute_mixing_matrix
-   */
-  void getAttributeMixingMatrix(
-      context_t& ctx,
-      std::vector<std::vector<double>>& attribute_mixing_matrix) {
-    int total_edge_num = 0;
-    // <data, index> pair, index:{0, 1, ..., n}
-    std::unordered_map<vdata_t, int> index_map;
-    int count = 0;
-    for (auto& pair1 : ctx.attribute_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        if (index_map.count(pair1.first) == 0) {
-          index_map[pair1.first] = count;
-          count++;
-        }
-        if (index_map.count(pair2.first) == 0) {
-          index_map[pair2.first] = count;
-          count++;
-        }
-        total_edge_num += pair2.second;
-      }
-    }
-    int n = index_map.size();
-    std::vector<std::vector<double>> tmp(n, std::vector<double>(n, 0.0));
-    attribute_mixing_matrix.swap(tmp);
-    for (auto& pair1 : ctx.attribute_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        int row = index_map[pair1.first];
-        int column = index_map[pair2.first];
-        attribute_mixing_matrix[row][column] =
-            pair2.second / static_cast<double>(total_edge_num);
-      }
-    }
-  }
-
-  /**
-   * @brief get numeric mixing matrix by attribute mixing map
-   *
-   * @param ctx
-   * @param[out] attribute_mixing_matrix
-   * @param[out] map index -> data of a node
-   */
-  void getNumericMixingMatrix(
-      context_t& ctx, std::vector<std::vector<double>>& attribute_mixing_matrix,
-      std::unordered_map<int, double>& map) {
-    int total_edge_num = 0;
-    // <data, index> pair, index:{0, 1, ..., n}
-    std::unordered_map<vdata_t, int> index_map;
-    int count = 0;
-    for (auto& pair1 : ctx.attribute_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        if (index_map.count(pair1.first) == 0) {
-          index_map[pair1.first] = count;
-          vdata_t vdata = pair1.first;
-          double data = 1.0;
-          // convert vdata_t to double in compile-time
-          vineyard::static_if<Conversion<double, vdata_t>::exists>(
-              [&](auto& data, auto& vdata) {
-                data = static_cast<double>(vdata);
-              })(data, vdata);
-          map[count] = data;
-          count++;
-        }
-        if (index_map.count(pair2.first) == 0) {
-          index_map[pair2.first] = count;
-          vdata_t vdata = pair2.first;
-          double data = 1.0;
-          // convert vdata_t to double in compile-time
-          vineyard::static_if<Conversion<double, vdata_t>::exists>(
-              [&](auto& data, auto& vdata) {
-                data = static_cast<double>(vdata);
-              })(data, vdata);
-          map[count] = data;
-          count++;
-        }
-        total_edge_num += pair2.second;
-      }
-    }
-    int n = index_map.size();
-    std::vector<std::vector<double>> tmp(n, std::vector<double>(n, 0.0));
-    attribute_mixing_matrix.swap(tmp);
-    for (auto& pair1 : ctx.attribute_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        int row = index_map[pair1.first];
-        int column = index_map[pair2.first];
-        attribute_mixing_matrix[row][column] =
-            pair2.second / static_cast<double>(total_edge_num);
-      }
-    }
+  double toDouble(const vdata_t& vdata) {
+    double data = 1.0;
+    // convert vdata_t to double in compile-time
+    vineyard::static_if<Conversion<double, vdata_t>::exists>(
+        [&](auto& data, auto& vdata) { data = static_cast<double>(vdata); })(
+        data, vdata);
+    return data;
   }
 };
 }  // namespace gs
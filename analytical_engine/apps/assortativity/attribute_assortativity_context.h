@@ -25,6 +25,7 @@
 
 #include "grape/grape.h"
 
+#include "apps/assortativity/utils.h"
 #include "core/app/app_base.h"
 #include "core/context/tensor_context.h"
 
@@ -36,8 +37,11 @@ class AttributeAssortativityContext : public TensorContext<FRAG_T, double> {
   explicit AttributeAssortativityContext(const FRAG_T& fragment)
       : TensorContext<FRAG_T, double>(fragment) {}
 
+  using attribute_count_t =
+      std::unordered_map<vdata_t, std::pair<double, double>>;
+
   void Init(grape::DefaultMessageManager& messages, bool numeric) {
-    merge_stage = false;
+    same_num = 0;
     this->numeric = numeric;
   }
 
@@ -47,10 +51,13 @@ class AttributeAssortativityContext : public TensorContext<FRAG_T, double> {
       os << attribute_assortativity << std::endl;
     }
   }
-  std::unordered_map<vdata_t, std::unordered_map<vdata_t, int>>
-      attribute_mixing_map;
+  // numeric: the moments of the values of the sources and targets
+  CorrelationMoments moments;
+  // otherwise: {value: {number of edges from, number of edges to}}
+  attribute_count_t attribute_counts;
+  // the number of edges between equal values
+  double same_num;
   double attribute_assortativity;
-  bool merge_stage;
   // if true, it is numeric assortativity app else attribute assortativity app
   bool numeric;
 };
@@ -18,8 +18,7 @@ Author: Ning Xin
 #ifndef ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_AVERAGE_DEGREE_CONNECTIVITY_H_
 #define ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_AVERAGE_DEGREE_CONNECTIVITY_H_
 
-#include <tuple>
-#include <unordered_map>
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -51,8 +50,6 @@ class AverageDegreeConnectivity
   using oid_t = typename fragment_t::oid_t;
   using edata_t = typename fragment_t::edata_t;
   using pair_msg_t = typename std::pair<int, double>;
-  using degree_connectivity_t =
-      typename std::unordered_map<int, std::pair<double, double>>;
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
@@ -64,6 +61,16 @@ class AverageDegreeConnectivity
       messages.ForceTerminate("single node");
     }
     auto inner_vertices = frag.InnerVertices();
+    // size the histogram by the largest source degree of all fragments
+    int local_max_degree = 0, max_degree = 0;
+    for (auto& v : inner_vertices) {
+      local_max_degree = std::max(
+          local_max_degree,
+          getDegreeByType(frag, v, ctx.source_degree_type_, ctx.directed));
+    }
+    Max(local_max_degree, max_degree);
+    ctx.histogram.assign(
+        static_cast<size_t>(max_degree + 1) * context_t::kHistogramWidth, 0.0);
     for (auto& v : inner_vertices) {
       processVertex(v, frag, ctx, messages);
     }
@@ -72,61 +79,42 @@ class AverageDegreeConnectivity
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    if (!ctx.merge_stage) {
-      pair_msg_t msg;
-      vertex_t vertex;
-      while (messages.GetMessage<fragment_t, pair_msg_t>(frag, vertex, msg)) {
-        int source_degree = msg.first;
-        double weight = msg.second;
-        int target_degree = getDegreeByType(
-            frag, vertex, ctx.target_degree_type_, ctx.directed);
-        if (ctx.degree_connectivity_map.count(source_degree) == 0) {
-          ctx.degree_connectivity_map[source_degree].first =
-              static_cast<double>(weight * target_degree);
-        } else {
-          ctx.degree_connectivity_map[source_degree].first +=
-              static_cast<double>(weight * target_degree);
-        }
-      }
-      ctx.merge_stage = true;
-      if (frag.fid() != 0) {
-        messages.SendToFragment<degree_connectivity_t>(
-            0, ctx.degree_connectivity_map);
-      }
-      messages.ForceContinue();
-    } else {
-      // merge in worker 0
-      if (frag.fid() == 0) {
-        std::unordered_map<int, std::pair<double, double>> msg;
-        while (messages.GetMessage(msg)) {
-          for (auto& a : msg) {
-            // merge
-            if (ctx.degree_connectivity_map.count(a.first) != 0) {
-              ctx.degree_connectivity_map[a.first].first += a.second.first;
-              ctx.degree_connectivity_map[a.first].second += a.second.second;
-            } else {
-              ctx.degree_connectivity_map[a.first].first = a.second.first;
-              ctx.degree_connectivity_map[a.first].second = a.second.second;
-            }
-          }
-        }
-
-        // write to ctx
-        size_t row_num = ctx.degree_connectivity_map.size();
-        std::vector<size_t> shape{row_num, 2};
-        std::vector<double> data;
-        for (auto& a : ctx.degree_connectivity_map) {
-          double result = a.second.second == 0.0
-                              ? a.second.first
-                              : a.second.first / a.second.second;
-          ctx.degree_connectivity_map[a.first].first = result;
-          // degree
-          data.push_back(static_cast<double>(a.first));
-          // degree connectivity
-          data.push_back(result);
+    pair_msg_t msg;
+    vertex_t vertex;
+    while (messages.GetMessage<fragment_t, pair_msg_t>(frag, vertex, msg)) {
+      int source_degree = msg.first;
+      double weight = msg.second;
+      int target_degree = getDegreeByType(frag, vertex, ctx.target_degree_type_,
+                                          ctx.directed);
+      ctx.neighbor_degree_sum(source_degree) += weight * target_degree;
+    }
+    std::vector<double> histogram;
+    AllReduce(ctx.histogram, histogram,
+              [](std::vector<double>& out, const std::vector<double>& in) {
+                for (size_t i = 0; i < in.size(); ++i) {
+                  out[i] += in[i];
+                }
+              });
+    ctx.histogram.swap(histogram);
+    if (frag.fid() == 0) {
+      // write to ctx
+      std::vector<double> data;
+      size_t degree_num = ctx.histogram.size() / context_t::kHistogramWidth;
+      for (size_t degree = 0; degree < degree_num; ++degree) {
+        if (ctx.vertex_num(degree) == 0) {
+          continue;
         }
-        ctx.assign(data, shape);
+        double sum = ctx.neighbor_degree_sum(degree);
+        double norm = ctx.degree_sum(degree);
+        double result = norm == 0.0 ? sum : sum / norm;
+        ctx.degree_connectivity.emplace_back(degree, result);
+        // degree
+        data.push_back(static_cast<double>(degree));
+        // degree connectivity
+        data.push_back(result);
       }
+      std::vector<size_t> shape{ctx.degree_connectivity.size(), 2};
+      ctx.assign(data, shape);
     }
   }
 
@@ -143,13 +131,9 @@ class AverageDegreeConnectivity
                      message_manager_t& messages) {
     int source_degree =
         getDegreeByType(frag, v, ctx.source_degree_type_, ctx.directed);
+    ctx.vertex_num(source_degree) += 1;
     // s_i
-    double norm = getWeightedDegree(v, frag, ctx);
-    if (ctx.degree_connectivity_map.count(source_degree) == 0) {
-      ctx.degree_connectivity_map[source_degree].second = norm;
-    } else {
-      ctx.degree_connectivity_map[source_degree].second += norm;
-    }
+    ctx.degree_sum(source_degree) += getWeightedDegree(v, frag, ctx);
     // w_ij * k_j
     // process incoming neighbours
     if (ctx.directed && ctx.source_degree_type_ == DegreeType::IN) {
@@ -181,13 +165,7 @@ class AverageDegreeConnectivity
     } else {
       int target_degree = getDegreeByType(
           frag, neighbor, ctx.target_degree_type_, ctx.directed);
-      if (ctx.degree_connectivity_map.count(source_degree) == 0) {
-        ctx.degree_connectivity_map[source_degree].first =
-            static_cast<double>(data * target_degree);
-      } else {
-        ctx.degree_connectivity_map[source_degree].first +=
-            static_cast<double>(data * target_degree);
-      }
+      ctx.neighbor_degree_sum(source_degree) += data * target_degree;
     }
   }
 
@@ -19,8 +19,8 @@
 #define ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_AVERAGE_DEGREE_CONNECTIVITY_CONTEXT_H_
 
 #include <string>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -40,7 +40,6 @@ class AverageDegreeConnectivityContext : public TensorContext<FRAG_T, double> {
   void Init(grape::DefaultMessageManager& messages,
             std::string source_degree_type = "in+out",
             std::string target_degree_type = "in+out") {
-    merge_stage = false;
     this->directed = this->fragment().directed();
     if (source_degree_type == "in") {
       source_degree_type_ = DegreeType::IN;
@@ -72,18 +71,32 @@ class AverageDegreeConnectivityContext : public TensorContext<FRAG_T, double> {
   void Output(std::ostream& os) override {
     auto& frag = this->fragment();
     if (frag.fid() == 0) {
-      for (auto& a : degree_connectivity_map) {
-        os << a.first << ": " << a.second.first << std::endl;
+      for (auto& a : degree_connectivity) {
+        os << a.first << ": " << a.second << std::endl;
       }
     }
   }
-  bool merge_stage;
+  // the sum over the vertices of a source degree of the weighted degrees of
+  // their neighbors, the sum of their weighted degrees, and their number
+  static constexpr size_t kHistogramWidth = 3;
+  double& neighbor_degree_sum(size_t degree) {
+    return histogram[degree * kHistogramWidth];
+  }
+  double& degree_sum(size_t degree) {
+    return histogram[degree * kHistogramWidth + 1];
+  }
+  double& vertex_num(size_t degree) {
+    return histogram[degree * kHistogramWidth + 2];
+  }
+
   bool directed;
   bool weighted;
   DegreeType source_degree_type_;
   DegreeType target_degree_type_;
-  // <degree, <sum of neighbor's, weighted degree> pair>
-  std::unordered_map<int, std::pair<double, double>> degree_connectivity_map;
+  // indexed by the source degree, dense since the degrees are small integers
+  std::vector<double> histogram;
+  // <degree, degree connectivity> of the degrees of some vertex, in fragment 0
+  std::vector<std::pair<int, double>> degree_connectivity;
 };
 }  // namespace gs
 
@@ -18,9 +18,6 @@ Author: Ning Xin
 #ifndef ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_DEGREE_ASSORTATIVITY_COEFFICIENT_H_
 #define ANALYTICAL_ENGINE_APPS_ASSORTATIVITY_DEGREE_ASSORTATIVITY_COEFFICIENT_H_
 
-#include <numeric>
-#include <unordered_map>
-#include <utility>
 #include <vector>
 
 #include "grape/grape.h"
@@ -67,49 +64,26 @@ class DegreeAssortativity
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    if (!ctx.merge_stage) {
-      vertex_t v;
-      degree_t source_degree;
-      while (messages.GetMessage(frag, v, source_degree)) {
-        degree_t target_degree =
-            getDegreeByType(frag, v, ctx.target_degree_type_, ctx);
-        degreeMixingCount(source_degree, target_degree, ctx);
-      }
-      ctx.merge_stage = true;
-      if (frag.fid() != 0) {
-        messages.SendToFragment(0, ctx.degree_mixing_map);
-      }
-      messages.ForceContinue();
-    } else {
-      // merge in work 0
-      if (frag.fid() == 0) {
-        // {{source_degree, {target_degree, num}}
-        std::unordered_map<degree_t, std::unordered_map<degree_t, int>> msg;
-        while (messages.GetMessage(msg)) {
-          for (auto& pair1 : msg) {
-            for (auto& pair2 : pair1.second) {
-              // merge
-              if (ctx.degree_mixing_map.count(pair1.first) == 0 ||
-                  ctx.degree_mixing_map[pair1.first].count(pair2.first) == 0) {
-                ctx.degree_mixing_map[pair1.first][pair2.first] = pair2.second;
-              } else {
-                ctx.degree_mixing_map[pair1.first][pair2.first] += pair2.second;
-              }
-            }
-          }
-        }
-        std::vector<std::vector<degree_t>> degree_mixing_matrix;
-        std::unordered_map<int, degree_t> map;
-        // get degree mixing matrix
-        getDegreeMixingMatrix(ctx, degree_mixing_matrix, map);
-        ctx.degree_assortativity = ProcessMatrix(degree_mixing_matrix, map);
-
-        std::vector<size_t> shape{1};
-        ctx.set_shape(shape);
-        ctx.assign(ctx.degree_assortativity);
-        VLOG(10) << "degree assortativity: " << ctx.degree_assortativity
-                 << std::endl;
-      }
+    vertex_t v;
+    degree_t source_degree;
+    while (messages.GetMessage(frag, v, source_degree)) {
+      degree_t target_degree =
+          getDegreeByType(frag, v, ctx.target_degree_type_, ctx);
+      ctx.moments.Add(source_degree, target_degree);
+    }
+    CorrelationMoments moments;
+    AllReduce(ctx.moments, moments,
+              [](CorrelationMoments& out, const CorrelationMoments& in) {
+                out += in;
+              });
+    if (frag.fid() == 0) {
+      ctx.degree_assortativity = moments.Correlation();
+
+      std::vector<size_t> shape{1};
+      ctx.set_shape(shape);
+      ctx.assign(ctx.degree_assortativity);
+      VLOG(10) << "degree assortativity: " << ctx.degree_assortativity
+               << std::endl;
     }
   }
 
@@ -136,7 +110,7 @@ class DegreeAssortativity
       } else {
         target_degree =
             getDegreeByType(frag, neighbor, ctx.target_degree_type_, ctx);
-        degreeMixingCount(source_degree, target_degree, ctx);
+        ctx.moments.Add(source_degree, target_degree);
       }
     }
   }
@@ -195,64 +169,6 @@ class DegreeAssortativity
     }
     return res;
   }
-
-  /**
-   * @brief count the degree-degree pair.
-   *
-   * @param source_degree
-   * @param target_degree
-   * @param ctx
-   *
-   */
-  void degreeMixingCount(degree_t source_degree, degree_t target_degree,
-                         context_t& ctx) {
-    if (ctx.degree_mixing_map.count(source_degree) == 0 ||
-        ctx.degree_mixing_map[source_degree].count(target_degree) == 0) {
-      ctx.degree_mixing_map[source_degree][target_degree] = 1;
-    } else {
-      ctx.degree_mixing_map[source_degree][target_degree] += 1;
-    }
-  }
-
-  /**
-   * @brief convert degree mixing map to degree mixing matrix
-   *
-   * @param ctx
-   * @param degree_mixing_matrix
-   * @param map index-degree map
-   */
-  void getDegreeMixingMatrix(
-      context_t& ctx, std::vector<std::vector<degree_t>>& degree_mixing_matrix,
-      std::unordered_map<int, degree_t>& map) {
-    int norm = 0, count = 0;
-    std::unordered_map<degree_t, int> index_map;
-    for (auto& pair1 : ctx.degree_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        if (index_map.count(pair1.first) == 0) {
-          index_map[pair1.first] = count;
-          map[count] = pair1.first;
-          count++;
-        }
-        if (index_map.count(pair2.first) == 0) {
-          index_map[pair2.first] = count;
-          map[count] = pair2.first;
-          count++;
-        }
-        norm += pair2.second;
-      }
-    }
-    int n = map.size();
-    degree_mixing_matrix =
-        std::vector<std::vector<degree_t>>(n, std::vector<degree_t>(n, 0));
-    for (auto& pair1 : ctx.degree_mixing_map) {
-      for (auto& pair2 : pair1.second) {
-        int row = index_map[pair1.first];
-        int column = index_map[pair2.first];
-        degree_mixing_matrix[row][column] =
-            pair2.second / static_cast<degree_t>(norm);
-      }
-    }
-  }
 };
 }  // namespace gs
 
@@ -20,7 +20,6 @@
 
 #include <limits>
 #include <string>
-#include <unordered_map>
 #include <utility>
 
 #include "grape/grape.h"
@@ -40,7 +39,6 @@ class DegreeAssortativityContext : public TensorContext<FRAG_T, double> {
   void Init(grape::DefaultMessageManager& messages,
             std::string source_degree_type = "out",
             std::string target_degree_type = "in", bool weighted = false) {
-    merge_stage = false;
     this->directed = this->fragment().directed();
     this->weighted = weighted;
     if (source_degree_type == "in") {
@@ -68,10 +66,8 @@ class DegreeAssortativityContext : public TensorContext<FRAG_T, double> {
          << std::endl;
     }
   }
-  // {source_degree: {target_degree: num}}
-  std::unordered_map<degree_t, std::unordered_map<degree_t, int>>
-      degree_mixing_map;
-  bool merge_stage;
+  // of the degrees of the sources and targets of the edges of the fragment
+  CorrelationMoments moments;
   bool directed;
   bool weighted;
   DegreeType source_degree_type_;
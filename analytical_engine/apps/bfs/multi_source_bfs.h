@@ -0,0 +1,129 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_BFS_MULTI_SOURCE_BFS_H_
+#define ANALYTICAL_ENGINE_APPS_BFS_MULTI_SOURCE_BFS_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief Bit-parallel BFS from up to 64 sources at once over the edges of a
+ * fragment, in the way of MS-BFS (Then et al., VLDB 2015). Source i of a batch
+ * is bit i of a lane mask: a level expands the vertices any source is at, and
+ * an edge passes the sources of its end that have not reached the other end
+ * yet, so that the sources of a batch share the scan of their edges.
+ *
+ * The state is three words per vertex, reused by the batches of an instance.
+ * It is not thread-safe, a thread runs batches on an instance of its own.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class MultiSourceBFS {
+ public:
+  using vertex_t = typename FRAG_T::vertex_t;
+  using lanes_t = uint64_t;
+
+  static constexpr int kBatchSize = 64;
+
+  /**
+   * @param reversed Whether to follow the incoming edges of a directed
+   * fragment, i.e. to find the distances to the sources.
+   */
+  explicit MultiSourceBFS(const FRAG_T& frag, bool reversed = false)
+      : frag_(frag), reversed_(reversed && frag.directed()) {
+    auto vertices = frag.Vertices();
+    seen_.Init(vertices, 0);
+    visit_.Init(vertices, 0);
+    visit_next_.Init(vertices, 0);
+  }
+
+  /**
+   * @brief Runs a BFS from each of sources[0, num).
+   *
+   * @param func Called as func(v, lanes, depth) once per vertex v and depth
+   * where some sources reach v, with bit i of lanes set if sources[i] is at
+   * distance depth of v. The sources themselves are reported at depth 0.
+   */
+  template <typename FUNC_T>
+  void Run(const vertex_t* sources, int num, const FUNC_T& func) {
+    CHECK_LE(num, static_cast<int>(kBatchSize));
+    frontier_.clear();
+    for (int i = 0; i < num; ++i) {
+      auto& s = sources[i];
+      if (visit_[s] == 0) {
+        frontier_.push_back(s);
+      }
+      visit_[s] |= lanes_t(1) << i;
+      seen_[s] |= lanes_t(1) << i;
+    }
+    for (auto& v : frontier_) {
+      func(v, visit_[v], 0);
+    }
+
+    int depth = 0;
+    while (!frontier_.empty()) {
+      ++depth;
+      next_frontier_.clear();
+      for (auto& u : frontier_) {
+        lanes_t lanes = visit_[u];
+        auto es = reversed_ ? frag_.GetIncomingAdjList(u)
+                            : frag_.GetOutgoingAdjList(u);
+        for (auto& e : es) {
+          vertex_t v = e.get_neighbor();
+          lanes_t arrived = lanes & ~seen_[v];
+          if (arrived != 0) {
+            if (visit_next_[v] == 0) {
+              next_frontier_.push_back(v);
+            }
+            visit_next_[v] |= arrived;
+          }
+        }
+      }
+      // report each vertex reached once, with all the lanes reaching it.
+      for (auto& v : next_frontier_) {
+        seen_[v] |= visit_next_[v];
+        func(v, visit_next_[v], depth);
+      }
+      for (auto& u : frontier_) {
+        visit_[u] = 0;
+      }
+      for (auto& v : next_frontier_) {
+        visit_[v] = visit_next_[v];
+        visit_next_[v] = 0;
+      }
+      frontier_.swap(next_frontier_);
+    }
+    seen_.SetValue(0);
+  }
+
+ private:
+  const FRAG_T& frag_;
+  bool reversed_;
+  typename FRAG_T::template vertex_array_t<lanes_t> seen_;
+  typename FRAG_T::template vertex_array_t<lanes_t> visit_;
+  typename FRAG_T::template vertex_array_t<lanes_t> visit_next_;
+  std::vector<vertex_t> frontier_, next_frontier_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_BFS_MULTI_SOURCE_BFS_H_
@@ -22,6 +22,7 @@
 #include "grape/grape.h"
 
 #include "core/app/app_base.h"
+#include "core/worker/superstep_checkpointer.h"
 
 namespace gs {
 template <typename FRAG_T>
@@ -78,6 +79,26 @@ class BetweennessCentralityContext
     }
   }
 
+  void Checkpoint(grape::InArchive& arc) const {
+    auto vertices = this->fragment().Vertices();
+    ArchiveVertexArray(arc, vertices, centrality);
+    ArchiveVertexArray(arc, vertices, depth);
+    ArchiveVertexArray(arc, vertices, pair_dependency);
+    ArchiveVertexArray(arc, vertices, number_of_path);
+    arc << norm << curr_depth << source << remain_source << epoch_tasks
+        << round << max_round << PEval << endpoints << phase;
+  }
+
+  void Restore(grape::OutArchive& arc) {
+    auto vertices = this->fragment().Vertices();
+    UnarchiveVertexArray(arc, vertices, centrality);
+    UnarchiveVertexArray(arc, vertices, depth);
+    UnarchiveVertexArray(arc, vertices, pair_dependency);
+    UnarchiveVertexArray(arc, vertices, number_of_path);
+    arc >> norm >> curr_depth >> source >> remain_source >> epoch_tasks >>
+        round >> max_round >> PEval >> endpoints >> phase;
+  }
+
   typename FRAG_T::template vertex_array_t<double>& centrality;
   typename FRAG_T::template vertex_array_t<int> depth;
   typename FRAG_T::template vertex_array_t<double> pair_dependency;
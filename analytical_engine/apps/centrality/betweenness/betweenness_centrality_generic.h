@@ -19,7 +19,6 @@ limitations under the License.
 #include <limits>
 #include <map>
 #include <queue>
-#include <stack>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -37,6 +36,8 @@ namespace gs {
 /**
  * @brief Compute the betweenness centrality for vertices. The betweenness
  * centrality for a vertex v is the fraction of vertices it is connected to.
+ * If k is given, it is estimated from k sampled sources, see
+ * BetweennessCentralityGenericContext::Init.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -52,6 +53,7 @@ class BetweennessCentralityGeneric
   static constexpr grape::LoadStrategy load_strategy =
       grape::LoadStrategy::kBothOutIn;
   using vertex_t = typename fragment_t::vertex_t;
+  using vertices_t = typename fragment_t::vertices_t;
   using vid_t = typename fragment_t::vid_t;
   using edata_t = typename fragment_t::edata_t;
 
@@ -61,36 +63,48 @@ class BetweennessCentralityGeneric
     auto inner_vertices = frag.InnerVertices();
     auto vertices = frag.Vertices();
     auto outer_vertices = frag.OuterVertices();
-    // compute pair dependency
-    ForEach(inner_vertices,
-            [&frag, &ctx, &vertices, this](int tid, vertex_t v) {
-              ctx.pair_dependency[v].Init(vertices, 0);
-              if (std::is_same<edata_t, grape::EmptyType>::value) {
-                // unweighted graph, use bfs.
-                this->bfs(frag, v, ctx);
-              } else {
-                // weighted graph, use dijkstra.
-                this->dijkstra(frag, v, ctx);
-              }
-            });
+    // compute pair dependency, each thread sums up the dependencies of its
+    // sources in its own workspace.
+    std::vector<Workspace> workspaces(thread_num());
+    ForEach(
+        ctx.sources.begin(), ctx.sources.end(),
+        [&frag, &ctx, &vertices, &workspaces, this](int tid, vertex_t v) {
+          auto& ws = workspaces[tid];
+          if (!ws.initialized) {
+            ws.Init(vertices);
+          }
+          if (std::is_same<edata_t, grape::EmptyType>::value) {
+            // unweighted graph, use bfs.
+            this->bfs(frag, v, ctx, ws);
+          } else {
+            // weighted graph, use dijkstra.
+            this->dijkstra(frag, v, ctx, ws);
+          }
+          ws.Reset();
+        },
+        1);
+
+    auto dependency_of = [&workspaces](vertex_t v) {
+      double dependency = 0.0;
+      for (auto& ws : workspaces) {
+        if (ws.initialized) {
+          dependency += ws.dependency[v];
+        }
+      }
+      return dependency;
+    };
 
     // accumulate inner pair dependency
-    ForEach(inner_vertices,
-            [&frag, &ctx, &inner_vertices, this](int tid, vertex_t v) {
-              for (auto& u : inner_vertices) {
-                ctx.centrality[v] += ctx.norm * ctx.pair_dependency[u][v];
-              }
-            });
+    ForEach(inner_vertices, [&ctx, &dependency_of](int tid, vertex_t v) {
+      ctx.centrality[v] += ctx.norm * dependency_of(v);
+    });
 
     // exchange pair dependency
-    ForEach(outer_vertices, [&frag, &ctx, &inner_vertices, this, &messages](
-                                int tid, vertex_t v) {
-      double msg = 0.0;
-      for (auto& u : inner_vertices) {
-        msg += ctx.norm * ctx.pair_dependency[u][v];
-      }
-      messages.Channels()[tid].SyncStateOnOuterVertex(frag, v, msg);
-    });
+    ForEach(outer_vertices,
+            [&frag, &ctx, &messages, &dependency_of](int tid, vertex_t v) {
+              messages.Channels()[tid].SyncStateOnOuterVertex(
+                  frag, v, ctx.norm * dependency_of(v));
+            });
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
@@ -102,17 +116,49 @@ class BetweennessCentralityGeneric
   }
 
  private:
-  void dijkstra(const fragment_t& frag, vertex_t& s, context_t& ctx) {
-    auto vertices = frag.Vertices();
+  // The state of the shortest paths from one source, reused by the sources of
+  // a thread, with the dependencies they sum up to.
+  struct Workspace {
+    void Init(const vertices_t& vertices) {
+      P.Init(vertices);
+      D.Init(vertices, false);
+      sigma.Init(vertices, 0.0);
+      delta.Init(vertices, 0.0);
+      seen.Init(vertices, std::numeric_limits<double>::max());
+      dependency.Init(vertices, 0.0);
+      initialized = true;
+    }
+
+    // Clears the vertices reached from the last source, which are all in S.
+    void Reset() {
+      for (auto& v : S) {
+        P[v].clear();
+        D[v] = false;
+        sigma[v] = 0.0;
+        delta[v] = 0.0;
+        seen[v] = std::numeric_limits<double>::max();
+      }
+      S.clear();
+    }
+
+    bool initialized = false;
+    typename FRAG_T::template vertex_array_t<std::vector<vertex_t>> P;
+    typename FRAG_T::template vertex_array_t<bool> D;
+    typename FRAG_T::template vertex_array_t<double> sigma;
+    typename FRAG_T::template vertex_array_t<double> delta;
+    typename FRAG_T::template vertex_array_t<double> seen;
+    // The vertices in the order they are settled.
+    std::vector<vertex_t> S;
+    typename FRAG_T::template vertex_array_t<double> dependency;
+  };
+
+  void dijkstra(const fragment_t& frag, vertex_t& s, context_t& ctx,
+                Workspace& ws) {
     std::priority_queue<std::pair<double, vertex_t>> heap;
-    std::stack<vertex_t> S;
-    typename FRAG_T::template vertex_array_t<std::vector<vertex_t>> P(vertices,
-                                                                      {});
-    typename FRAG_T::template vertex_array_t<bool> D(vertices, false);
-    typename FRAG_T::template vertex_array_t<double> sigma(vertices, 0.0);
-    typename FRAG_T::template vertex_array_t<double> delta(vertices, 0.0);
-    typename FRAG_T::template vertex_array_t<double> seen(
-        vertices, std::numeric_limits<double>::max());
+    auto& P = ws.P;
+    auto& D = ws.D;
+    auto& sigma = ws.sigma;
+    auto& seen = ws.seen;
     seen[s] = 0.0;
     sigma[s] = 1.0;
     heap.emplace(0, s);
@@ -128,7 +174,7 @@ class BetweennessCentralityGeneric
         continue;
       }
       D[u] = true;
-      S.push(u);
+      ws.S.push_back(u);
 
       auto es = frag.GetOutgoingAdjList(u);
       for (auto& e : es) {
@@ -152,40 +198,23 @@ class BetweennessCentralityGeneric
         }
       }
     }
-    if (ctx.endpoints)
-      ctx.pair_dependency[s][s] += S.size() - 1;
-    while (!S.empty()) {
-      auto w = S.top();
-      S.pop();
-      double coeff = (1 + delta[w]) / sigma[w];
-      for (auto& v : P[w]) {
-        delta[v] += sigma[v] * coeff;
-      }
-      if (w != s)
-        ctx.pair_dependency[s][w] += delta[w] + ctx.endpoints;
-    }
+    accumulate(s, ctx, ws);
   }
 
-  void bfs(const fragment_t& frag, vertex_t& s, context_t& ctx) {
-    auto vertices = frag.Vertices();
-    std::queue<vertex_t> que;
-    std::stack<vertex_t> S;
-    typename FRAG_T::template vertex_array_t<std::vector<vertex_t>> P(vertices,
-                                                                      {});
-    typename FRAG_T::template vertex_array_t<bool> D(vertices, false);
-    typename FRAG_T::template vertex_array_t<double> sigma(vertices, 0.0);
-    typename FRAG_T::template vertex_array_t<double> delta(vertices, 0.0);
-    typename FRAG_T::template vertex_array_t<double> seen(
-        vertices, std::numeric_limits<double>::max());
+  void bfs(const fragment_t& frag, vertex_t& s, context_t& ctx,
+           Workspace& ws) {
+    auto& P = ws.P;
+    auto& D = ws.D;
+    auto& sigma = ws.sigma;
+    auto& seen = ws.seen;
     seen[s] = 0.0;
     sigma[s] = 1.0;
     D[s] = true;
 
-    que.push(s);
-    while (!que.empty()) {
-      vertex_t u = que.front();
-      que.pop();
-      S.push(u);
+    // S doubles as the queue of the bfs, head is its front.
+    ws.S.push_back(s);
+    for (size_t head = 0; head < ws.S.size(); ++head) {
+      vertex_t u = ws.S[head];
 
       // set depth for neighbors with current depth + 1
       auto new_depth = seen[u] + 1;
@@ -193,7 +222,7 @@ class BetweennessCentralityGeneric
       for (auto& e : oes) {
         vertex_t v = e.get_neighbor();
         if (!D[v]) {
-          que.push(v);
+          ws.S.push_back(v);
           seen[v] = new_depth;
           D[v] = true;
         }
@@ -203,18 +232,23 @@ class BetweennessCentralityGeneric
         }
       }
     }
+    accumulate(s, ctx, ws);
+  }
 
+  // Adds the dependencies of s on the vertices it reaches, in the reverse
+  // order they are settled.
+  void accumulate(vertex_t& s, context_t& ctx, Workspace& ws) {
+    auto& delta = ws.delta;
     if (ctx.endpoints)
-      ctx.pair_dependency[s][s] += S.size() - 1;
-    while (!S.empty()) {
-      auto w = S.top();
-      S.pop();
-      double coeff = (1 + delta[w]) / sigma[w];
-      for (auto& v : P[w]) {
-        delta[v] += sigma[v] * coeff;
+      ws.dependency[s] += ws.S.size() - 1;
+    for (auto iter = ws.S.rbegin(); iter != ws.S.rend(); ++iter) {
+      auto w = *iter;
+      double coeff = (1 + delta[w]) / ws.sigma[w];
+      for (auto& v : ws.P[w]) {
+        delta[v] += ws.sigma[v] * coeff;
       }
       if (w != s)
-        ctx.pair_dependency[s][w] += delta[w] + ctx.endpoints;
+        ws.dependency[w] += delta[w] + ctx.endpoints;
     }
   }
 };
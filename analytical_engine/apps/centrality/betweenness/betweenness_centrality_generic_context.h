@@ -16,10 +16,14 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_GENERIC_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_GENERIC_CONTEXT_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <queue>
+#include <random>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -37,11 +41,18 @@ class BetweennessCentralityGenericContext
       : grape::VertexDataContext<FRAG_T, double>(fragment),
         centrality(this->data()) {}
 
+  /**
+   * @param k The number of sources (pivots) the betweenness is estimated from,
+   * 0 or no less than the number of vertices for the exact betweenness from
+   * every source. A fragment samples its share of the k pivots, in proportion
+   * to its inner vertices, and scales their dependencies by the inverse of
+   * the fraction sampled.
+   * @param seed The seed of the sampling, the same seed gives the same pivots.
+   */
   void Init(grape::ParallelMessageManager& messages, bool normalized = true,
-            bool endpoints = false) {
+            bool endpoints = false, int64_t k = 0, int64_t seed = 0) {
     auto& frag = this->fragment();
     auto inner_vertices = frag.InnerVertices();
-    pair_dependency.Init(inner_vertices);
     this->factor = frag.GetTotalVerticesNum() - 1;
     this->endpoints = endpoints;
     this->norm = frag.directed() ? 1.0 : 0.5;
@@ -59,6 +70,26 @@ class BetweennessCentralityGenericContext
       }
     }
     centrality.SetValue(0.0);
+
+    sources.clear();
+    int64_t total_vnum = frag.GetTotalVerticesNum();
+    int64_t ivnum = frag.GetInnerVerticesNum();
+    for (auto& v : inner_vertices) {
+      sources.push_back(v);
+    }
+    if (k > 0 && k < total_vnum && ivnum > 0) {
+      int64_t local_k = std::max<int64_t>(
+          1, static_cast<int64_t>(static_cast<double>(k) * ivnum / total_vnum));
+      local_k = std::min(local_k, ivnum);
+      std::mt19937_64 gen(seed + frag.fid());
+      // partial Fisher-Yates shuffle, the first local_k are the pivots.
+      for (int64_t i = 0; i < local_k; ++i) {
+        std::uniform_int_distribution<int64_t> dist(i, ivnum - 1);
+        std::swap(sources[i], sources[dist(gen)]);
+      }
+      sources.resize(local_k);
+      this->norm *= static_cast<double>(ivnum) / local_k;
+    }
   }
 
   void Output(std::ostream& os) override {
@@ -74,9 +105,8 @@ class BetweennessCentralityGenericContext
   double norm;
   double factor;
   typename FRAG_T::template vertex_array_t<double>& centrality;
-  typename FRAG_T::template vertex_array_t<
-      typename FRAG_T::template vertex_array_t<double>>
-      pair_dependency;
+  // The inner vertices the shortest paths are counted from.
+  std::vector<vertex_t> sources;
 };
 }  // namespace gs
 
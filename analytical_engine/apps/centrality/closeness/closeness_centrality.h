@@ -16,14 +16,17 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_H_
 #define ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_H_
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <memory>
 #include <queue>
 #include <utility>
 #include <vector>
 
 #include "grape/grape.h"
 
+#include "apps/bfs/multi_source_bfs.h"
 #include "apps/centrality/closeness/closeness_centrality_context.h"
 
 #include "core/utils/trait_utils.h"
@@ -34,6 +37,8 @@ namespace gs {
  * @brief Compute the closeness centrality of vertices.
  * Closeness centrality 1 of a node u is the reciprocal of the average shortest
  * path distance to u over all n-1 reachable nodes.
+ * The distances of an unweighted graph are found by MultiSourceBFS, 64 vertices
+ * at a time.
  * */
 template <typename FRAG_T>
 class ClosenessCentrality
@@ -54,6 +59,10 @@ class ClosenessCentrality
              message_manager_t& messages) {
     auto inner_vertices = frag.InnerVertices();
     auto vertices = frag.Vertices();
+    if (std::is_same<edata_t, grape::EmptyType>::value) {
+      multiSourceBFS(frag, ctx);
+      return;
+    }
     ctx.length.resize(thread_num());
     for (auto& unit : ctx.length) {
       unit.Init(vertices);
@@ -114,12 +123,59 @@ class ClosenessCentrality
     }
   }
 
+  // the inner vertices in batches of MultiSourceBFS::kBatchSize, a batch by a
+  // thread, sums up the distances of each vertex of a batch as they are found.
+  void multiSourceBFS(const fragment_t& frag, context_t& ctx) {
+    using bfs_t = MultiSourceBFS<fragment_t>;
+    std::vector<vertex_t> sources;
+    for (auto& v : frag.InnerVertices()) {
+      sources.push_back(v);
+    }
+    std::vector<size_t> batches;
+    for (size_t i = 0; i < sources.size(); i += bfs_t::kBatchSize) {
+      batches.push_back(i);
+    }
+    int total_node_num = 0;
+    for (auto& v : frag.Vertices()) {
+      ++total_node_num;
+    }
+    std::vector<std::unique_ptr<bfs_t>> kernels(thread_num());
+    ForEach(
+        batches.begin(), batches.end(),
+        [&frag, &ctx, &sources, &kernels, total_node_num, this](int tid,
+                                                                size_t begin) {
+          if (kernels[tid] == nullptr) {
+            kernels[tid].reset(new bfs_t(frag, true));
+          }
+          int num = static_cast<int>(
+              std::min(sources.size() - begin,
+                       static_cast<size_t>(bfs_t::kBatchSize)));
+          double tot_sp[bfs_t::kBatchSize] = {0.0};
+          int connected_nodes_num[bfs_t::kBatchSize] = {0};
+          kernels[tid]->Run(
+              sources.data() + begin, num,
+              [&tot_sp, &connected_nodes_num](
+                  vertex_t v, typename bfs_t::lanes_t lanes, int depth) {
+                while (lanes != 0) {
+                  int i = __builtin_ctzll(lanes);
+                  tot_sp[i] += depth;
+                  ++connected_nodes_num[i];
+                  lanes &= lanes - 1;
+                }
+              });
+          for (int i = 0; i < num; ++i) {
+            ctx.centrality[sources[begin + i]] = this->closeness(
+                ctx, tot_sp[i], connected_nodes_num[i], total_node_num);
+          }
+        },
+        1);
+  }
+
   void compute(const fragment_t& frag, vertex_t& u, context_t& ctx, int tid) {
     double tot_sp = 0.0;
     int connected_nodes_num = 0;
     int total_node_num = 0;
     auto vertices = frag.Vertices();
-    double closeness_centrality = 0.0;
     for (auto& v : vertices) {
       if (ctx.length[tid][v] < std::numeric_limits<double>::max()) {
         tot_sp += ctx.length[tid][v];
@@ -127,6 +183,13 @@ class ClosenessCentrality
       }
       ++total_node_num;
     }
+    ctx.centrality[u] =
+        closeness(ctx, tot_sp, connected_nodes_num, total_node_num);
+  }
+
+  double closeness(const context_t& ctx, double tot_sp,
+                   int connected_nodes_num, int total_node_num) {
+    double closeness_centrality = 0.0;
     if (tot_sp > 0 && total_node_num > 1) {
       closeness_centrality = (connected_nodes_num - 1.0) / tot_sp;
       if (ctx.wf_improve) {
@@ -134,7 +197,7 @@ class ClosenessCentrality
             ((connected_nodes_num - 1.0) / (total_node_num - 1));
       }
     }
-    ctx.centrality[u] = closeness_centrality;
+    return closeness_centrality;
   }
 };
 
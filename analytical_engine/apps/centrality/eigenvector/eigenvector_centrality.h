@@ -21,6 +21,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "apps/centrality/eigenvector/eigenvector_centrality_context.h"
+#include "apps/centrality/spmv.h"
 
 #include "core/app/app_base.h"
 #include "core/utils/trait_utils.h"
@@ -50,6 +51,7 @@ class EigenvectorCentrality
   using vertex_t = typename fragment_t::vertex_t;
   using edata_t = typename fragment_t::edata_t;
   using vid_t = typename FRAG_T::vid_t;
+  using spmv_t = PullSpMV<FRAG_T>;
 
   bool NormAndCheckTerm(const fragment_t& frag, context_t& ctx, int thrd_num) {
     auto inner_vertices = frag.InnerVertices();
@@ -88,95 +90,47 @@ class EigenvectorCentrality
     return false;
   }
 
-  void Pull(const fragment_t& frag, context_t& ctx,
-            message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices();
+  void Pull(const fragment_t& frag, context_t& ctx) {
     auto& x = ctx.x;
     auto& x_last = ctx.x_last;
 
-    if (frag.directed()) {
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [&x, &x_last, &frag](int tid, vertex_t v) {
-            auto es = frag.GetIncomingAdjList(v);
-            x[v] = x_last[v];
-            for (auto& e : es) {
-              double edata = 1.0;
-              vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
-                  [&](auto& e, auto& data) {
-                    data = static_cast<double>(e.get_data());
-                  })(e, edata);
-              x[v] += x_last[e.get_neighbor()] * edata;
-            }
-          });
-    } else {
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [&x, &x_last, &frag](int tid, vertex_t v) {
-            auto es = frag.GetOutgoingAdjList(v);
-            x[v] = x_last[v];
-            for (auto& e : es) {
-              double edata = 1.0;
-              vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
-                  [&](auto& e, auto& data) {
-                    data = static_cast<double>(e.get_data());
-                  })(e, edata);
-              x[v] += x_last[e.get_neighbor()] * edata;
-            }
-          });
-    }
+    // the incoming edges of a directed graph, or all edges of an undirected
+    spmv_t::template Multiply<true>(
+        *this, frag, frag.directed(), x_last,
+        [&x, &x_last](int tid, vertex_t v, double sum) {
+          x[v] = x_last[v] + sum;
+        });
   }
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     int thrd_num = thread_num();
     messages.InitChannels(thread_num());
-    Pull(frag, ctx, messages);
-    auto inner_vertices = frag.InnerVertices();
+    Pull(frag, ctx);
 
     // call NormAndCheckTerm before send. because we normalize the vector 'x' in
     // the function.
     if (NormAndCheckTerm(frag, ctx, thrd_num))
       return;
 
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    } else {
-      ForEach(inner_vertices.begin(), inner_vertices.end(),
-              [&ctx, &frag, &messages](int tid, vertex_t v) {
-                messages.Channels()[tid].SendMsgThroughOEdges(frag, v,
-                                                              ctx.x[v]);
-              });
-    }
+    spmv_t::Exchange(*this, frag, messages, ctx.x, false);
     ctx.curr_round++;
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
     int thrd_num = thread_num();
-    auto& x = ctx.x;
-    auto& x_last = ctx.x_last;
-    auto inner_vertices = frag.InnerVertices();
 
-    messages.ParallelProcess<fragment_t, double>(
-        thrd_num, frag, [&x](int tid, vertex_t v, double msg) { x[v] = msg; });
+    spmv_t::Receive(*this, frag, messages, ctx.x);
 
-    x_last.Swap(x);
+    ctx.x_last.Swap(ctx.x);
 
-    Pull(frag, ctx, messages);
+    Pull(frag, ctx);
 
     if (NormAndCheckTerm(frag, ctx, thrd_num))
       return;
 
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    } else {
-      ForEach(inner_vertices.begin(), inner_vertices.end(),
-              [&ctx, &frag, &messages](int tid, vertex_t v) {
-                messages.Channels()[tid].SendMsgThroughOEdges(frag, v,
-                                                              ctx.x[v]);
-              });
-    }
+    spmv_t::Exchange(*this, frag, messages, ctx.x, false);
     ctx.curr_round++;
   }
 };
@@ -21,6 +21,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "apps/centrality/katz/katz_centrality_context.h"
+#include "apps/centrality/spmv.h"
 
 #include "core/app/app_base.h"
 #include "core/utils/trait_utils.h"
@@ -47,6 +48,7 @@ class KatzCentrality
   using vertex_t = typename fragment_t::vertex_t;
   using edata_t = typename fragment_t::edata_t;
   using vid_t = typename FRAG_T::vid_t;
+  using spmv_t = PullSpMV<FRAG_T>;
 
   bool CheckTerm(const fragment_t& frag, context_t& ctx, int thrd_num) {
     auto inner_vertices = frag.InnerVertices();
@@ -84,48 +86,19 @@ class KatzCentrality
 
   void pullAndSend(const fragment_t& frag, context_t& ctx,
                    message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices();
-    if (frag.directed()) {
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [this, &ctx, &frag, &messages](int tid, vertex_t v) {
-            if (!filterByDegree(frag, ctx, v)) {
-              auto es = frag.GetIncomingAdjList(v);
-              ctx.x[v] = 0;
-              for (auto& e : es) {
-                // do the multiplication y^T = Alpha * x^T A - Beta
-                double edata = 1.0;
-                vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
-                    [&](auto& e, auto& data) {
-                      data = static_cast<double>(e.get_data());
-                    })(e, edata);
-                ctx.x[v] += ctx.x_last[e.get_neighbor()] * edata;
-              }
-              ctx.x[v] = ctx.x[v] * ctx.alpha + ctx.beta;
-              messages.Channels()[tid].SendMsgThroughOEdges(frag, v, ctx.x[v]);
-            }
-          });
-    } else {
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [this, &ctx, &frag, &messages](int tid, vertex_t v) {
-            if (!filterByDegree(frag, ctx, v)) {
-              auto es = frag.GetOutgoingAdjList(v);
-              ctx.x[v] = 0;
-              for (auto& e : es) {
-                // do the multiplication y^T = Alpha * x^T A - Beta
-                double edata = 1.0;
-                vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
-                    [&](auto& e, auto& data) {
-                      data = static_cast<double>(e.get_data());
-                    })(e, edata);
-                ctx.x[v] += ctx.x_last[e.get_neighbor()] * edata;
-              }
-              ctx.x[v] = ctx.x[v] * ctx.alpha + ctx.beta;
-              messages.Channels()[tid].SendMsgThroughOEdges(frag, v, ctx.x[v]);
-            }
-          });
-    }
+    auto& x = ctx.x;
+    double alpha = ctx.alpha, beta = ctx.beta;
+    // do the multiplication y^T = Alpha * x^T A - Beta, over the incoming
+    // edges of a directed graph, or all edges of an undirected
+    spmv_t::template Multiply<true>(
+        *this, frag, frag.directed(), ctx.x_last,
+        [this, &frag, &ctx](vertex_t v) {
+          return !filterByDegree(frag, ctx, v);
+        },
+        [&x, alpha, beta](int tid, vertex_t v, double sum) {
+          x[v] = sum * alpha + beta;
+        });
+    spmv_t::Exchange(*this, frag, messages, x, false);
   }
 
   void PEval(const fragment_t& frag, context_t& ctx,
@@ -133,9 +106,6 @@ class KatzCentrality
     messages.InitChannels(thread_num());
     pullAndSend(frag, ctx, messages);
 
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    }
     ctx.curr_round++;
   }
 
@@ -158,15 +128,11 @@ class KatzCentrality
       }
       return;
     }
-    messages.ParallelProcess<fragment_t, double>(
-        thrd_num, frag, [&x](int tid, vertex_t v, double msg) { x[v] = msg; });
+    spmv_t::Receive(*this, frag, messages, x);
     x_last.Swap(x);
 
     pullAndSend(frag, ctx, messages);
 
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    }
     ctx.curr_round++;
   }
 
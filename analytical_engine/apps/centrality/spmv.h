@@ -0,0 +1,127 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_SPMV_H_
+#define ANALYTICAL_ENGINE_APPS_CENTRALITY_SPMV_H_
+
+#include <type_traits>
+
+#include "grape/grape.h"
+
+#include "core/app/app_base.h"
+#include "core/utils/trait_utils.h"
+
+namespace gs {
+/**
+ * @brief The sparse matrix-vector multiplication shared by the power
+ * iterations of eigenvector centrality, Katz centrality and HITS, over any
+ * fragment with adjacency lists, e.g. ArrowProjectedFragment and
+ * DynamicProjectedFragment.
+ *
+ * Multiply() pulls: each inner vertex sums the values of its neighbors along
+ * its incoming or outgoing edges, weighted by the edge data if WEIGHTED and
+ * the edges have data, into a local accumulator, so that the only writes are
+ * the results. The input and output are two vectors swapped between
+ * iterations, and the values of the outer vertices are refreshed by one
+ * Exchange() and Receive() per multiplication.
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class PullSpMV {
+ public:
+  using vertex_t = typename FRAG_T::vertex_t;
+  using edata_t = typename FRAG_T::edata_t;
+  using vector_t = typename FRAG_T::template vertex_array_t<double>;
+
+  template <bool WEIGHTED, typename ADJ_LIST_T>
+  static double Dot(const ADJ_LIST_T& es, const vector_t& x) {
+    double sum = 0.0;
+    for (auto& e : es) {
+      double edata = 1.0;
+      vineyard::static_if<WEIGHTED &&
+                          !std::is_same<edata_t, grape::EmptyType>::value>(
+          [&](auto& e, auto& data) {
+            data = static_cast<double>(e.get_data());
+          })(e, edata);
+      sum += x[e.get_neighbor()] * edata;
+    }
+    return sum;
+  }
+
+  /**
+   * @brief Calls func(tid, v, sum) with the sum over the neighbors of each
+   * inner vertex v for which filter(v) holds.
+   */
+  template <bool WEIGHTED, typename FILTER_T, typename FUNC_T>
+  static void Multiply(grape::ParallelEngine& engine, const FRAG_T& frag,
+                       bool incoming, const vector_t& x,
+                       const FILTER_T& filter, const FUNC_T& func) {
+    auto inner_vertices = frag.InnerVertices();
+    engine.ForEach(inner_vertices.begin(), inner_vertices.end(),
+                   [&](int tid, vertex_t v) {
+                     if (!filter(v)) {
+                       return;
+                     }
+                     double sum =
+                         incoming
+                             ? Dot<WEIGHTED>(frag.GetIncomingAdjList(v), x)
+                             : Dot<WEIGHTED>(frag.GetOutgoingAdjList(v), x);
+                     func(tid, v, sum);
+                   });
+  }
+
+  template <bool WEIGHTED, typename FUNC_T>
+  static void Multiply(grape::ParallelEngine& engine, const FRAG_T& frag,
+                       bool incoming, const vector_t& x, const FUNC_T& func) {
+    Multiply<WEIGHTED>(
+        engine, frag, incoming, x, [](vertex_t) { return true; }, func);
+  }
+
+  /**
+   * @brief Sends the values of the inner vertices to the fragments holding
+   * them as outer vertices, along the outgoing edges, or all edges if
+   * all_edges. With a single fragment there is nothing to send, and the next
+   * round is forced.
+   */
+  static void Exchange(grape::ParallelEngine& engine, const FRAG_T& frag,
+                       grape::ParallelMessageManager& messages,
+                       const vector_t& x, bool all_edges) {
+    if (frag.fnum() == 1) {
+      messages.ForceContinue();
+      return;
+    }
+    auto inner_vertices = frag.InnerVertices();
+    engine.ForEach(inner_vertices.begin(), inner_vertices.end(),
+                   [&](int tid, vertex_t v) {
+                     auto& channel = messages.Channels()[tid];
+                     if (all_edges) {
+                       channel.SendMsgThroughEdges(frag, v, x[v]);
+                     } else {
+                       channel.SendMsgThroughOEdges(frag, v, x[v]);
+                     }
+                   });
+  }
+
+  // Sets the values of the outer vertices from the messages of Exchange().
+  static void Receive(grape::ParallelEngine& engine, const FRAG_T& frag,
+                      grape::ParallelMessageManager& messages, vector_t& x) {
+    messages.ParallelProcess<FRAG_T, double>(
+        engine.thread_num(), frag,
+        [&x](int tid, vertex_t v, double msg) { x[v] = msg; });
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CENTRALITY_SPMV_H_
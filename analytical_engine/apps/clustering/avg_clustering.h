@@ -23,6 +23,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "clustering/avg_clustering_context.h"
+#include "clustering/triangle_utils.h"
 
 namespace gs {
 /**
@@ -61,7 +62,6 @@ class AvgClustering
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
     using vid_t = typename context_t::vid_t;
-    auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
     auto outer_vertices = frag.OuterVertices();
     if (ctx.stage == 0) {
@@ -179,27 +179,30 @@ class AvgClustering
                 }
               });
 
-      typename FRAG_T::template vertex_array_t<uint32_t> v0_nbr_set(vertices,
-                                                                    0);
-      for (auto v : inner_vertices) {
-        auto& v0_nbr_vec = ctx.complete_neighbor[v];
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = u.second;
-        }
-        for (auto u : v0_nbr_vec) {
-          auto& v1_nbr_vec = ctx.complete_neighbor[u.first];
-          for (auto w : v1_nbr_vec) {
-            if (v0_nbr_set[w.first] != 0) {
-              ctx.tricnt[u.first] += v0_nbr_set[w.first] * u.second * w.second;
-              ctx.tricnt[v] += v0_nbr_set[w.first] * u.second * w.second;
-              ctx.tricnt[w.first] += v0_nbr_set[w.first] * u.second * w.second;
+      using nbr_t = std::pair<vertex_t, uint32_t>;
+      auto sort_neighbors = [&ctx](int tid, vertex_t v) {
+        triangle_utils::SortNeighbors(ctx.complete_neighbor[v]);
+      };
+      ForEach(inner_vertices, sort_neighbors);
+      ForEach(outer_vertices, sort_neighbors);
+
+      // small chunks, as the work of a vertex grows with its degree.
+      ForEach(
+          inner_vertices,
+          [&ctx](int tid, vertex_t v) {
+            auto& v0_nbr_vec = ctx.complete_neighbor[v];
+            for (auto u : v0_nbr_vec) {
+              triangle_utils::Intersect(
+                  v0_nbr_vec, ctx.complete_neighbor[u.first],
+                  [&ctx, &u, v](const nbr_t& v0_w, const nbr_t& w) {
+                    int cnt = v0_w.second * u.second * w.second;
+                    grape::atomic_add(ctx.tricnt[u.first], cnt);
+                    grape::atomic_add(ctx.tricnt[v], cnt);
+                    grape::atomic_add(ctx.tricnt[w.first], cnt);
+                  });
             }
-          }
-        }
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = 0;
-        }
-      }
+          },
+          64);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
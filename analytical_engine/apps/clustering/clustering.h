@@ -23,6 +23,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "clustering/clustering_context.h"
+#include "clustering/triangle_utils.h"
 
 namespace gs {
 /**
@@ -198,42 +199,32 @@ class Clustering
                 }
               });
 
-      std::vector<typename FRAG_T::template vertex_array_t<uint32_t>>
-          vertexsets(thread_num());
+      using nbr_t = std::pair<vertex_t, uint32_t>;
+      auto sort_neighbors = [&ctx](int tid, vertex_t v) {
+        triangle_utils::SortNeighbors(ctx.complete_neighbor[v]);
+      };
+      ForEach(inner_vertices, sort_neighbors);
+      ForEach(outer_vertices, sort_neighbors);
+
+      // small chunks, as the work of a vertex grows with its degree.
       ForEach(
           inner_vertices,
-          [&vertexsets, &frag](int tid) {
-            auto& ns = vertexsets[tid];
-            ns.Init(frag.Vertices(), 0);
-          },
-          [&vertexsets, &ctx](int tid, vertex_t v) {
+          [&ctx](int tid, vertex_t v) {
             if (ctx.global_degree[v] > 1) {
-              auto& v0_nbr_set = vertexsets[tid];
               auto& v0_nbr_vec = ctx.complete_neighbor[v];
               for (auto u : v0_nbr_vec) {
-                v0_nbr_set[u.first] = u.second;
-              }
-              for (auto u : v0_nbr_vec) {
-                auto& v1_nbr_vec = ctx.complete_neighbor[u.first];
-                for (auto w : v1_nbr_vec) {
-                  if (v0_nbr_set[w.first] != 0) {
-                    grape::atomic_add(
-                        ctx.tricnt[u.first],
-                        v0_nbr_set[w.first] * u.second * w.second);
-                    grape::atomic_add(ctx.tricnt[v], v0_nbr_set[w.first] *
-                                                         u.second * w.second);
-                    grape::atomic_add(
-                        ctx.tricnt[w.first],
-                        v0_nbr_set[w.first] * u.second * w.second);
-                  }
-                }
-              }
-              for (auto u : v0_nbr_vec) {
-                v0_nbr_set[u.first] = 0;
+                triangle_utils::Intersect(
+                    v0_nbr_vec, ctx.complete_neighbor[u.first],
+                    [&ctx, &u, v](const nbr_t& v0_w, const nbr_t& w) {
+                      uint32_t cnt = v0_w.second * u.second * w.second;
+                      grape::atomic_add(ctx.tricnt[u.first], cnt);
+                      grape::atomic_add(ctx.tricnt[v], cnt);
+                      grape::atomic_add(ctx.tricnt[w.first], cnt);
+                    });
               }
             }
           },
-          [](int tid) {});
+          64);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
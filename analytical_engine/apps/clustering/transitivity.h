@@ -23,6 +23,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "clustering/transitivity_context.h"
+#include "clustering/triangle_utils.h"
 
 namespace gs {
 /**
@@ -61,7 +62,6 @@ class Transitivity
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
     using vid_t = typename context_t::vid_t;
-    auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
     auto outer_vertices = frag.OuterVertices();
     if (ctx.stage == 0) {
@@ -202,66 +202,47 @@ class Transitivity
             }
           });
 
-      typename FRAG_T::template vertex_array_t<uint32_t> v0_nbr_set(vertices,
-                                                                    0);
-      for (auto v : inner_vertices) {
-        auto& v0_nbr_vec = ctx.complete_neighbor[v];
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = u.second;
-        }
-        for (auto u : v0_nbr_vec) {
-          auto& v1_nbr_vec = ctx.complete_neighbor[u.first];
-          for (auto w : v1_nbr_vec) {
-            if (v0_nbr_set[w.first] != 0) {
-              int flag = 0;
-              for (size_t i = 0; i < ctx.complete_outer_neighbor[v].size();
-                   i++) {
-                if (ctx.complete_outer_neighbor[v][i] == u.first ||
-                    ctx.complete_outer_neighbor[v][i] == w.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[v] += w.second;
-              }
-              flag = 0;
-              for (size_t i = 0;
-                   i < ctx.complete_outer_neighbor[u.first].size(); i++) {
-                if (ctx.complete_outer_neighbor[u.first][i] == v ||
-                    ctx.complete_outer_neighbor[u.first][i] == w.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[u.first] += v0_nbr_set[w.first];
-              }
-              flag = 0;
-              for (size_t i = 0;
-                   i < ctx.complete_outer_neighbor[w.first].size(); i++) {
-                if (ctx.complete_outer_neighbor[w.first][i] == v ||
-                    ctx.complete_outer_neighbor[w.first][i] == u.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[w.first] += v0_nbr_set[u.first];
-              }
+      using nbr_t = std::pair<vertex_t, uint32_t>;
+      auto sort_neighbors = [&ctx](int tid, vertex_t v) {
+        triangle_utils::SortNeighbors(ctx.complete_neighbor[v]);
+        triangle_utils::SortNeighbors(ctx.complete_outer_neighbor[v]);
+      };
+      ForEach(inner_vertices, sort_neighbors);
+      ForEach(outer_vertices, sort_neighbors);
+
+      // whether x and y are both out neighbors of v.
+      auto has_out_edges = [&ctx](vertex_t v, vertex_t x, vertex_t y) {
+        auto& outer_nbr_vec = ctx.complete_outer_neighbor[v];
+        return triangle_utils::ContainsNeighbor(outer_nbr_vec, x) &&
+               triangle_utils::ContainsNeighbor(outer_nbr_vec, y);
+      };
+
+      // small chunks, as the work of a vertex grows with its degree.
+      ForEach(
+          inner_vertices,
+          [&ctx, &has_out_edges](int tid, vertex_t v) {
+            auto& v0_nbr_vec = ctx.complete_neighbor[v];
+            for (auto u : v0_nbr_vec) {
+              triangle_utils::Intersect(
+                  v0_nbr_vec, ctx.complete_neighbor[u.first],
+                  [&ctx, &has_out_edges, &u, v](const nbr_t& v0_w,
+                                                const nbr_t& w) {
+                    if (has_out_edges(v, u.first, w.first)) {
+                      grape::atomic_add(ctx.tricnt[v],
+                                        static_cast<int>(w.second));
+                    }
+                    if (has_out_edges(u.first, v, w.first)) {
+                      grape::atomic_add(ctx.tricnt[u.first],
+                                        static_cast<int>(v0_w.second));
+                    }
+                    if (has_out_edges(w.first, v, u.first)) {
+                      grape::atomic_add(ctx.tricnt[w.first],
+                                        static_cast<int>(u.second));
+                    }
+                  });
             }
-          }
-        }
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = 0;
-        }
-      }
+          },
+          64);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
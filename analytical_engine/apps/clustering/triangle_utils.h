@@ -0,0 +1,126 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_UTILS_H_
+#define ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_UTILS_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief The intersection of the degree oriented neighbors of the triangle
+ * counting apps: triangles, clustering, avg_clustering and transitivity.
+ *
+ * The neighbor lists, either of vertices or of (vertex, weight) pairs, are
+ * sorted by lid once they are complete, then the common neighbors of two
+ * lists are found by a merge, or by galloping over the longer list if it is
+ * kGallopRatio times longer, instead of marking one list in a per-thread
+ * array over all the vertices.
+ */
+namespace triangle_utils {
+
+static constexpr size_t kGallopRatio = 32;
+
+template <typename VID_T>
+inline VID_T NbrKey(const grape::Vertex<VID_T>& v) {
+  return v.GetValue();
+}
+
+template <typename VID_T, typename W_T>
+inline VID_T NbrKey(const std::pair<grape::Vertex<VID_T>, W_T>& nbr) {
+  return nbr.first.GetValue();
+}
+
+template <typename NBR_T>
+inline void SortNeighbors(std::vector<NBR_T>& nbrs) {
+  std::sort(nbrs.begin(), nbrs.end(), [](const NBR_T& lhs, const NBR_T& rhs) {
+    return NbrKey(lhs) < NbrKey(rhs);
+  });
+}
+
+template <typename NBR_T>
+inline bool ContainsNeighbor(const std::vector<NBR_T>& nbrs,
+                             const NBR_T& nbr) {
+  auto iter = std::lower_bound(nbrs.begin(), nbrs.end(), nbr,
+                               [](const NBR_T& lhs, const NBR_T& rhs) {
+                                 return NbrKey(lhs) < NbrKey(rhs);
+                               });
+  return iter != nbrs.end() && NbrKey(*iter) == NbrKey(nbr);
+}
+
+// Calls func(x, y) for each x of the short list, y of the long list, with
+// the same vertex.
+template <typename NBR_T, typename FUNC_T>
+inline void gallop(const std::vector<NBR_T>& shorter,
+                   const std::vector<NBR_T>& longer, const FUNC_T& func) {
+  auto lo = longer.begin();
+  for (auto& x : shorter) {
+    lo = std::lower_bound(lo, longer.end(), x,
+                          [](const NBR_T& lhs, const NBR_T& rhs) {
+                            return NbrKey(lhs) < NbrKey(rhs);
+                          });
+    if (lo == longer.end()) {
+      return;
+    }
+    if (NbrKey(*lo) == NbrKey(x)) {
+      func(x, *lo);
+      ++lo;
+    }
+  }
+}
+
+/**
+ * @brief Calls func(a[i], b[j]) for each pair of neighbors of the sorted
+ * lists a and b with the same vertex.
+ */
+template <typename NBR_T, typename FUNC_T>
+inline void Intersect(const std::vector<NBR_T>& a, const std::vector<NBR_T>& b,
+                      const FUNC_T& func) {
+  if (a.empty() || b.empty()) {
+    return;
+  }
+  if (a.size() * kGallopRatio < b.size()) {
+    gallop(a, b, func);
+    return;
+  }
+  if (b.size() * kGallopRatio < a.size()) {
+    gallop(b, a, [&func](const NBR_T& y, const NBR_T& x) { func(x, y); });
+    return;
+  }
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    auto ka = NbrKey(a[i]), kb = NbrKey(b[j]);
+    if (ka < kb) {
+      ++i;
+    } else if (kb < ka) {
+      ++j;
+    } else {
+      func(a[i], b[j]);
+      ++i;
+      ++j;
+    }
+  }
+}
+
+}  // namespace triangle_utils
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_UTILS_H_
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "grape/grape.h"
 
+#include "clustering/triangle_utils.h"
 #include "clustering/triangles_context.h"
 
 namespace gs {
@@ -107,36 +108,28 @@ class Triangles
             }
           });
 
-      std::vector<grape::DenseVertexSet<typename FRAG_T::vertices_t>>
-          vertexsets(thread_num());
+      auto sort_neighbors = [&ctx](int tid, vertex_t v) {
+        triangle_utils::SortNeighbors(ctx.complete_neighbor[v]);
+      };
+      ForEach(inner_vertices, sort_neighbors);
+      ForEach(outer_vertices, sort_neighbors);
 
+      // small chunks, as the work of a vertex grows with its degree.
       ForEach(
           inner_vertices,
-          [&vertexsets, &frag](int tid) {
-            auto& ns = vertexsets[tid];
-            ns.Init(frag.Vertices());
-          },
-          [&vertexsets, &ctx](int tid, vertex_t v) {
-            auto& v0_nbr_set = vertexsets[tid];
+          [&ctx](int tid, vertex_t v) {
             auto& v0_nbr_vec = ctx.complete_neighbor[v];
             for (auto u : v0_nbr_vec) {
-              v0_nbr_set.Insert(u);
-            }
-            for (auto u : v0_nbr_vec) {
-              auto& v1_nbr_vec = ctx.complete_neighbor[u];
-              for (auto w : v1_nbr_vec) {
-                if (v0_nbr_set.Exist(w)) {
-                  grape::atomic_add(ctx.tricnt[u], 1);
-                  grape::atomic_add(ctx.tricnt[v], 1);
-                  grape::atomic_add(ctx.tricnt[w], 1);
-                }
-              }
-            }
-            for (auto u : v0_nbr_vec) {
-              v0_nbr_set.Erase(u);
+              triangle_utils::Intersect(
+                  v0_nbr_vec, ctx.complete_neighbor[u],
+                  [&ctx, u, v](const vertex_t& w, const vertex_t&) {
+                    grape::atomic_add(ctx.tricnt[u], 1);
+                    grape::atomic_add(ctx.tricnt[v], 1);
+                    grape::atomic_add(ctx.tricnt[w], 1);
+                  });
             }
           },
-          [](int tid) {});
+          64);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
@@ -0,0 +1,119 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_BFS_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_BFS_CUDA_H_
+
+#ifdef ENABLE_CUDA
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/cuda/device_fragment.h"
+#include "core/app/app_base.h"
+#include "core/cuda/device_graph.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class BFSCudaContext : public grape::VertexDataContext<FRAG_T, int64_t> {
+  using oid_t = typename FRAG_T::oid_t;
+
+ public:
+  explicit BFSCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, int64_t>(fragment, true),
+        partial_result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t src_id) {
+    source_id = src_id;
+    partial_result.SetValue(std::numeric_limits<int64_t>::max());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << partial_result[v] << std::endl;
+    }
+  }
+
+  oid_t source_id;
+  typename FRAG_T::template vertex_array_t<int64_t>& partial_result;
+  cuda::DeviceGraph graph;
+};
+
+/**
+ * @brief The depth of BFS from the source by the kernels of
+ * core/cuda/device_graph.h, a fragment on a GPU of its host.
+ *
+ * A fragment propagates the depth within it till no depth drops, and sends
+ * the depths of the outer vertices dropped to their owners, so the result is
+ * the same as grape::BFS.
+ *
+ * @tparam FRAG_T A fragment of a contiguous range of vertices, i.e.
+ * ArrowProjectedFragment or ImmutableEdgecutFragment.
+ */
+template <typename FRAG_T>
+class BFSCuda : public AppBase<FRAG_T, BFSCudaContext<FRAG_T>> {
+ public:
+  INSTALL_DEFAULT_WORKER(BFSCuda<FRAG_T>, BFSCudaContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  static constexpr uint64_t kUnreached = std::numeric_limits<uint64_t>::max();
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::string error;
+    if (!UploadFragment(frag, false, false, ctx.graph, error)) {
+      LOG(ERROR) << "[frag-" << frag.fid() << "]: " << error;
+      messages.ForceTerminate(error);
+      return;
+    }
+    ctx.graph.SetValues(
+        std::vector<uint64_t>(frag.Vertices().size(), uint64_t(kUnreached)));
+
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      ctx.graph.Lower({static_cast<uint32_t>(source.GetValue())}, {0});
+    }
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    LowerByMessages(frag, messages, ctx.graph);
+    propagate(frag, ctx, messages);
+  }
+
+ private:
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    PropagateOnDevice(frag, cuda::Relax::kHop, ctx.graph, messages,
+                      ctx.partial_result, [](uint64_t depth) {
+                        return depth == kUnreached
+                                   ? std::numeric_limits<int64_t>::max()
+                                   : static_cast<int64_t>(depth);
+                      });
+  }
+};
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_BFS_CUDA_H_
@@ -0,0 +1,147 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_FRAGMENT_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_FRAGMENT_H_
+
+#ifdef ENABLE_CUDA
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/cuda/device_graph.h"
+
+namespace gs {
+
+/**
+ * @brief The weight of an edge of a graph without weights.
+ */
+struct NoWeight {
+  template <typename NBR_T>
+  double operator()(const NBR_T&) const {
+    return 0;
+  }
+};
+
+/**
+ * @brief Copies the out edges of the inner vertices of frag to a GPU, and
+ * their in edges as well if with_in_edges, e.g. for WCC on a directed graph.
+ *
+ * The GPU is picked by the local id of the worker on its host, so that
+ * the fragments on a host are spread over its GPUs.
+ *
+ * @param weight The weight of an edge, kept if with_weights.
+ * @return false with error set if the graph does not fit in the GPU.
+ */
+template <typename FRAG_T, typename WEIGHT_FUNC = NoWeight>
+bool UploadFragment(const FRAG_T& frag, bool with_in_edges,
+                    bool with_weights, cuda::DeviceGraph& graph,
+                    std::string& error,
+                    const WEIGHT_FUNC& weight = WEIGHT_FUNC()) {
+  auto inner_vertices = frag.InnerVertices();
+  size_t ivnum = inner_vertices.size();
+  size_t vnum = frag.Vertices().size();
+  if (vnum > std::numeric_limits<uint32_t>::max()) {
+    error = "A fragment on GPU takes at most 2^32 - 1 vertices";
+    return false;
+  }
+
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> edges;
+  std::vector<double> weights;
+  offsets.reserve(ivnum + 1);
+  offsets.push_back(0);
+  auto add_edges = [&](const auto& es) {
+    for (auto& e : es) {
+      edges.push_back(static_cast<uint32_t>(e.get_neighbor().GetValue()));
+      if (with_weights) {
+        weights.push_back(weight(e));
+      }
+    }
+  };
+  for (auto v : inner_vertices) {
+    add_edges(frag.GetOutgoingAdjList(v));
+    if (with_in_edges) {
+      add_edges(frag.GetIncomingAdjList(v));
+    }
+    offsets.push_back(edges.size());
+  }
+
+  grape::CommSpec comm_spec;
+  comm_spec.Init(MPI_COMM_WORLD);
+  if (!graph.Upload(comm_spec.local_id(), ivnum, vnum, offsets, edges,
+                    weights, error)) {
+    return false;
+  }
+  VLOG(1) << "[frag-" << frag.fid() << "]: uploaded " << ivnum
+          << " vertices and " << edges.size() << " edges to GPU";
+  return true;
+}
+
+/**
+ * @brief Lowers the values of the inner vertices on the GPU by the messages
+ * of the values of their mirrors, to propagate them from.
+ */
+template <typename FRAG_T>
+void LowerByMessages(const FRAG_T& frag, grape::DefaultMessageManager& messages,
+                     cuda::DeviceGraph& graph) {
+  typename FRAG_T::vertex_t v;
+  uint64_t value;
+  std::vector<uint32_t> lids;
+  std::vector<uint64_t> values;
+  while (messages.GetMessage<FRAG_T, uint64_t>(frag, v, value)) {
+    lids.push_back(static_cast<uint32_t>(v.GetValue()));
+    values.push_back(value);
+  }
+  graph.Lower(lids, values);
+}
+
+/**
+ * @brief Propagates the values on the GPU, sends the values of the outer
+ * vertices lowered to their owners, and copies the values back to result by
+ * convert.
+ *
+ * The values are copied back every round rather than at the end, which the
+ * app can not tell, so that the context holds the result when the query
+ * terminates.
+ */
+template <typename FRAG_T, typename RESULT_T, typename CONVERT_FUNC>
+void PropagateOnDevice(const FRAG_T& frag, cuda::Relax relax,
+                       cuda::DeviceGraph& graph,
+                       grape::DefaultMessageManager& messages,
+                       RESULT_T& result, const CONVERT_FUNC& convert) {
+  using vertex_t = typename FRAG_T::vertex_t;
+  std::vector<uint32_t> outer_lids;
+  std::vector<uint64_t> values;
+  graph.Propagate(relax, outer_lids, values);
+  for (size_t i = 0; i < outer_lids.size(); ++i) {
+    messages.SyncStateOnOuterVertex<FRAG_T, uint64_t>(
+        frag, vertex_t(outer_lids[i]), values[i]);
+  }
+
+  graph.GetValues(values);
+  for (auto v : frag.Vertices()) {
+    result[v] = convert(values[v.GetValue()]);
+  }
+}
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_FRAGMENT_H_
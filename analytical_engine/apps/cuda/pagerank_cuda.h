@@ -0,0 +1,171 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
+
+#ifdef ENABLE_CUDA
+
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/cuda/device_fragment.h"
+#include "core/app/app_base.h"
+#include "core/cuda/device_graph.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class PageRankCudaContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  explicit PageRankCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, double delta,
+            int max_round) {
+    auto& frag = this->fragment();
+
+    this->delta = delta;
+    this->max_round = max_round;
+    step = 0;
+    contribs.resize(frag.InnerVertices().size());
+    sums.clear();
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+         << result[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<double>& result;
+  double delta;
+  int max_round;
+  int step;
+  double dangling_sum;
+  // the rank of an inner vertex over its out degree, and the sums of them
+  // along the edges, summed over the fragments for the inner vertices
+  std::vector<double> contribs;
+  std::vector<double> sums;
+  cuda::DeviceGraph graph;
+};
+
+/**
+ * @brief PageRank by the kernels of core/cuda/device_graph.h, a fragment on a
+ * GPU of its host.
+ *
+ * A round pushes the contributions of the inner vertices along their edges
+ * on the GPU, by an atomic add of the sums of the targets, and sends the
+ * sums of the outer vertices to their owners. The rank of a dangling vertex
+ * is spread over all the vertices, as grape::PageRank does.
+ *
+ * @tparam FRAG_T A fragment of a contiguous range of vertices, i.e.
+ * ArrowProjectedFragment or ImmutableEdgecutFragment.
+ */
+template <typename FRAG_T>
+class PageRankCuda : public AppBase<FRAG_T, PageRankCudaContext<FRAG_T>>,
+                     public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(PageRankCuda<FRAG_T>, PageRankCudaContext<FRAG_T>,
+                         FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::string error;
+    int failed = UploadFragment(frag, false, false, ctx.graph, error) ? 0 : 1;
+    // the rounds sum the dangling ranks over the fragments, so a fragment
+    // goes on only if all of them are on GPUs
+    int any_failed = 0;
+    Max(failed, any_failed);
+    if (any_failed) {
+      if (failed) {
+        LOG(ERROR) << "[frag-" << frag.fid() << "]: " << error;
+      }
+      messages.ForceTerminate(failed ? error : "Not all fragments are on GPU");
+      return;
+    }
+
+    double p = 1.0 / frag.GetTotalVerticesNum();
+    for (auto v : frag.InnerVertices()) {
+      ctx.result[v] = p;
+    }
+    if (ctx.max_round > 0) {
+      push(frag, ctx, messages);
+    }
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    {
+      vertex_t v;
+      double sum;
+      while (messages.GetMessage<fragment_t, double>(frag, v, sum)) {
+        ctx.sums[v.GetValue()] += sum;
+      }
+    }
+
+    double graph_vnum = frag.GetTotalVerticesNum();
+    double base = (1.0 - ctx.delta) / graph_vnum +
+                  ctx.delta * ctx.dangling_sum / graph_vnum;
+    for (auto v : inner_vertices) {
+      ctx.result[v] = base + ctx.delta * ctx.sums[v.GetValue()];
+    }
+
+    if (++ctx.step < ctx.max_round) {
+      push(frag, ctx, messages);
+    }
+  }
+
+ private:
+  void push(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    double local_dangling_sum = 0;
+    for (auto v : inner_vertices) {
+      int degree = frag.GetLocalOutDegree(v);
+      if (degree > 0) {
+        ctx.contribs[v.GetValue()] = ctx.result[v] / degree;
+      } else {
+        ctx.contribs[v.GetValue()] = 0;
+        local_dangling_sum += ctx.result[v];
+      }
+    }
+    Sum(local_dangling_sum, ctx.dangling_sum);
+
+    ctx.graph.PushSum(ctx.contribs, ctx.sums);
+    for (auto v : frag.OuterVertices()) {
+      double sum = ctx.sums[v.GetValue()];
+      if (sum != 0) {
+        messages.SyncStateOnOuterVertex<fragment_t, double>(frag, v, sum);
+      }
+    }
+    // terminates by max_round, even if no sum is sent
+    messages.ForceContinue();
+  }
+};
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
@@ -0,0 +1,139 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
+
+#ifdef ENABLE_CUDA
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/cuda/device_fragment.h"
+#include "core/app/app_base.h"
+#include "core/cuda/device_graph.h"
+#include "core/utils/trait_utils.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class SSSPCudaContext : public grape::VertexDataContext<FRAG_T, double> {
+  using oid_t = typename FRAG_T::oid_t;
+
+ public:
+  explicit SSSPCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        partial_result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t source_id_) {
+    source_id = source_id_;
+    partial_result.SetValue(std::numeric_limits<double>::max());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto iv = frag.InnerVertices();
+
+    for (auto v : iv) {
+      os << frag.GetId(v) << "\t" << partial_result[v] << std::endl;
+    }
+  }
+
+  oid_t source_id;
+  typename FRAG_T::template vertex_array_t<double>& partial_result;
+  cuda::DeviceGraph graph;
+};
+
+/**
+ * @brief SSSP from the source by the kernels of core/cuda/device_graph.h,
+ * a fragment on a GPU of its host, the same as SSSPProjected.
+ *
+ * A distance is kept on the GPU as the bits of the double, which order as
+ * the doubles do since the weights are not negative, so that a distance is
+ * lowered by an atomic min of integers.
+ *
+ * @tparam FRAG_T A fragment of a contiguous range of vertices, i.e.
+ * ArrowProjectedFragment or ImmutableEdgecutFragment.
+ */
+template <typename FRAG_T>
+class SSSPCuda : public AppBase<FRAG_T, SSSPCudaContext<FRAG_T>> {
+ public:
+  INSTALL_DEFAULT_WORKER(SSSPCuda<FRAG_T>, SSSPCudaContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using edata_t = typename fragment_t::edata_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto weight = [](const auto& e) {
+      double edata = 1.0;
+      vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
+          [&](auto& e, auto& data) {
+            data = static_cast<double>(e.get_data());
+          })(e, edata);
+      return edata;
+    };
+    std::string error;
+    if (!UploadFragment(frag, false, true, ctx.graph, error, weight)) {
+      LOG(ERROR) << "[frag-" << frag.fid() << "]: " << error;
+      messages.ForceTerminate(error);
+      return;
+    }
+    ctx.graph.SetValues(std::vector<uint64_t>(
+        frag.Vertices().size(), toBits(std::numeric_limits<double>::max())));
+
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      ctx.graph.Lower({static_cast<uint32_t>(source.GetValue())},
+                      {toBits(0.0)});
+    }
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    LowerByMessages(frag, messages, ctx.graph);
+    propagate(frag, ctx, messages);
+  }
+
+ private:
+  static uint64_t toBits(double distance) {
+    uint64_t bits;
+    memcpy(&bits, &distance, sizeof(bits));
+    return bits;
+  }
+
+  static double fromBits(uint64_t bits) {
+    double distance;
+    memcpy(&distance, &bits, sizeof(distance));
+    return distance;
+  }
+
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    PropagateOnDevice(frag, cuda::Relax::kWeight, ctx.graph, messages,
+                      ctx.partial_result, fromBits);
+  }
+};
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
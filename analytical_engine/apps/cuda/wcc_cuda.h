@@ -0,0 +1,120 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
+
+#ifdef ENABLE_CUDA
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/cuda/device_fragment.h"
+#include "core/app/app_base.h"
+#include "core/cuda/device_graph.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class WCCCudaContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  explicit WCCCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages) {}
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto iv = frag.InnerVertices();
+
+    for (auto v : iv) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+  cuda::DeviceGraph graph;
+};
+
+/**
+ * @brief WCC by the kernels of core/cuda/device_graph.h, a fragment on a GPU
+ * of its host, the same as WCCProjected, i.e. a component is labeled by the
+ * least gid of its vertices.
+ *
+ * @tparam FRAG_T A fragment of a contiguous range of vertices, i.e.
+ * ArrowProjectedFragment or ImmutableEdgecutFragment.
+ */
+template <typename FRAG_T>
+class WCCCuda : public AppBase<FRAG_T, WCCCudaContext<FRAG_T>> {
+ public:
+  INSTALL_DEFAULT_WORKER(WCCCuda<FRAG_T>, WCCCudaContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::string error;
+    if (!UploadFragment(frag, frag.directed(), false, ctx.graph, error)) {
+      LOG(ERROR) << "[frag-" << frag.fid() << "]: " << error;
+      messages.ForceTerminate(error);
+      return;
+    }
+
+    auto inner_vertices = frag.InnerVertices();
+    std::vector<uint64_t> comp_ids(frag.Vertices().size());
+    std::vector<uint32_t> lids;
+    lids.reserve(inner_vertices.size());
+    for (auto v : inner_vertices) {
+      comp_ids[v.GetValue()] = frag.GetInnerVertexGid(v);
+      lids.push_back(static_cast<uint32_t>(v.GetValue()));
+    }
+    for (auto v : frag.OuterVertices()) {
+      comp_ids[v.GetValue()] = frag.GetOuterVertexGid(v);
+    }
+    ctx.graph.SetValues(comp_ids);
+    ctx.graph.Activate(lids);
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    LowerByMessages(frag, messages, ctx.graph);
+    propagate(frag, ctx, messages);
+  }
+
+ private:
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    PropagateOnDevice(
+        frag, cuda::Relax::kCopy, ctx.graph, messages, ctx.comp_id,
+        [](uint64_t comp_id) { return static_cast<vid_t>(comp_id); });
+  }
+};
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
@@ -356,13 +356,44 @@ inline VSet edgeMapSparseFunction(const fragment_t& graph,
   fw->ResetAggFunc();
 }
 
+// Beamer's direction optimization: the frontier is pulled densely once the
+// vertices it has plus the edges a push from it would follow pass
+// 1/GetDenseRatio() of those of the graph.
+template <typename fragment_t, typename fw_t, typename value_t>
+bool useDenseEdgeMap(const fragment_t& graph, const std::shared_ptr<fw_t> fw,
+                     VSet& U, int h) {
+  if ((&U) == (&All))
+    return true;
+  typename fragment_t::vertex_t u;
+  int64_t work_local = U.size(), work;
+  for (auto& vid : U.s) {
+    u.SetValue(fw->Key2Lid(vid));
+    if (h == EU || h == ED)
+      work_local += graph.GetLocalOutDegree(u);
+    if (h == EU || h == ER)
+      work_local += graph.GetLocalInDegree(u);
+  }
+  fw->Sum(work_local, work);
+  int64_t total = static_cast<int64_t>(fw->GetSize()) +
+                  (h == EU ? 2 : 1) * fw->GetEdgeNum();
+  return work > total / fw->GetDenseRatio();
+}
+
+// The edges of a user-defined H are not known ahead, so only the vertices of
+// the frontier are compared against those of the graph.
+template <typename fragment_t, typename fw_t, typename value_t, class H>
+bool useDenseEdgeMap(const fragment_t& graph, const std::shared_ptr<fw_t> fw,
+                     VSet& U, H& h) {
+  int len = VSize(U);
+  return len > THRESHOLD;
+}
+
 template <typename fragment_t, typename fw_t, typename value_t, class F,
           class M, class C, class H>
 inline VSet edgeMapFunction(const fragment_t& graph,
                             const std::shared_ptr<fw_t> fw, VSet& U, H h, F& f,
                             M& m, C& c) {
-  int len = VSize(U);
-  if (len > THRESHOLD)
+  if (useDenseEdgeMap(graph, fw, U, h))
     return edgeMapDenseFunction(graph, fw, U, h, f, m, c);
   else
     return edgeMapSparseFunction(graph, fw, U, h, f, m, c);
@@ -373,8 +404,7 @@ template <typename fragment_t, typename fw_t, typename value_t, class F,
 inline VSet edgeMapFunction(const fragment_t& graph,
                             const std::shared_ptr<fw_t> fw, VSet& U, H h, F& f,
                             M& m, C& c, const R& r) {
-  int len = VSize(U);
-  if (len > THRESHOLD)
+  if (useDenseEdgeMap(graph, fw, U, h))
     return edgeMapDenseFunction(graph, fw, U, h, f, m, c);
   else
     return edgeMapSparseFunction(graph, fw, U, h, f, m, c, r);
@@ -34,6 +34,7 @@ namespace gs {
 #define ED -2
 #define ER -3
 #define THRESHOLD (VSize(All) / 50)
+#define DENSE_RATIO 20
 
 #define VSet VertexSubset<fragment_t, value_t>
 #define All fw->all_
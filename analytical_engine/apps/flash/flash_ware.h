@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_FLASH_FLASH_WARE_H_
 #define ANALYTICAL_ENGINE_APPS_FLASH_FLASH_WARE_H_
 
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -88,9 +89,15 @@ class FlashWare : public grape::Communicator, public grape::ParallelEngine {
   }
   inline void ResetAggFunc() { f_agg_ = nullptr; }
 
+  // EdgeMap pulls densely once the vertices and edges of the frontier exceed
+  // 1/ratio of those of the graph, and pushes from the frontier otherwise.
+  inline void SetDenseRatio(int ratio) { dense_ratio_ = ratio; }
+  inline int GetDenseRatio() { return dense_ratio_; }
+
  public:
   inline fid_t GetPid() { return pid_; }
   inline vid_t GetSize() { return n_; }
+  inline int64_t GetEdgeNum() { return e_num_; }
   inline std::vector<vid_t>* GetMasters() { return &masters_; }
   inline std::vector<vid_t>* GetMirrors() { return &mirrors_; }
   inline int GetMasterPid(const vid_t& key) { return key2pid_[key]; }
@@ -134,6 +141,7 @@ class FlashWare : public grape::Communicator, public grape::ParallelEngine {
   inline void processMirrorMessage(const vid_t& key, const value_t& value);
   inline void processAllMessages(const bool& is_master,
                                  const bool& is_parallel);
+  bool gatherSetBits(FlashBitset& b, std::vector<vid_t>& keys);
 
  public:
   vset_t all_;
@@ -141,6 +149,8 @@ class FlashWare : public grape::Communicator, public grape::ParallelEngine {
  private:
   vid_t n_;
   vid_t n_loc_;
+  int64_t e_num_;
+  int dense_ratio_;
   fid_t pid_;
   fid_t n_procs_;
   int n_threads_;
@@ -184,6 +194,12 @@ void FlashWare<fragment_t, value_t>::InitFlashWare(
   vmap_ = graph->GetVertexMap();
   n_ = graph->GetTotalVerticesNum();
   n_loc_ = vmap_->GetInnerVertexSize(pid_);
+  int64_t e_num_loc = 0;
+  for (auto v : graph->InnerVertices()) {
+    e_num_loc += graph->GetLocalOutDegree(v);
+  }
+  Sum(e_num_loc, e_num_);
+  dense_ratio_ = DENSE_RATIO;
 
   vnum_ = new size_t[n_procs_];
   agg_vnum_ = new size_t[n_procs_];
@@ -290,16 +306,66 @@ void FlashWare<fragment_t, value_t>::SyncBitset(FlashBitset& tmp,
                                                 FlashBitset& res) {
   if (res.get_size() != tmp.get_size())
     res.init(tmp.get_size());
+  std::vector<vid_t> keys;
+  if (gatherSetBits(tmp, keys)) {
+    res.clear();
+    for (auto key : keys)
+      res.set_bit(key);
+    return;
+  }
   MPI_Allreduce(tmp.get_data(), res.get_data(), res.get_size_in_words(),
                 MPI_UINT64_T, MPI_BOR, comm_spec_.comm());
 }
 
 template <typename fragment_t, class value_t>
 void FlashWare<fragment_t, value_t>::SyncBitset(FlashBitset& b) {
+  std::vector<vid_t> keys;
+  if (gatherSetBits(b, keys)) {
+    for (auto key : keys)
+      b.set_bit(key);
+    return;
+  }
   MPI_Allreduce(MPI_IN_PLACE, b.get_data(), b.get_size_in_words(), MPI_UINT64_T,
                 MPI_BOR, comm_spec_.comm());
 }
 
+// Gathers the bits set on all the workers as keys, if they take less than
+// half the bytes of the bitset, and returns false to OR the bitsets densely
+// otherwise. Every worker gets every key, as the dense EdgeMap over a
+// user-defined H tests the keys it returns, which need not be neighbors.
+template <typename fragment_t, class value_t>
+bool FlashWare<fragment_t, value_t>::gatherSetBits(FlashBitset& b,
+                                                   std::vector<vid_t>& keys) {
+  int local_num = static_cast<int>(b.count());
+  std::vector<int> nums(n_procs_);
+  MPI_Allgather(&local_num, 1, MPI_INT, nums.data(), 1, MPI_INT,
+                comm_spec_.comm());
+  size_t total = 0;
+  for (auto num : nums)
+    total += num;
+  size_t bytes = total * sizeof(vid_t);
+  if (bytes * 2 >= b.get_size_in_words() * sizeof(uint64_t) ||
+      bytes > static_cast<size_t>(std::numeric_limits<int>::max()))
+    return false;
+
+  std::vector<vid_t> local_keys;
+  local_keys.reserve(local_num);
+  const uint64_t* data = b.get_data();
+  for (size_t i = 0; i < b.get_size_in_words(); ++i) {
+    for (uint64_t word = data[i]; word != 0; word &= word - 1)
+      local_keys.push_back((i << 6) + __builtin_ctzll(word));
+  }
+  std::vector<int> counts(n_procs_), displs(n_procs_);
+  for (fid_t i = 0; i < n_procs_; ++i) {
+    counts[i] = nums[i] * sizeof(vid_t);
+    displs[i] = i == 0 ? 0 : displs[i - 1] + counts[i - 1];
+  }
+  keys.resize(total);
+  MPI_Allgatherv(local_keys.data(), counts[pid_], MPI_CHAR, keys.data(),
+                 counts.data(), displs.data(), MPI_CHAR, comm_spec_.comm());
+  return true;
+}
+
 template <typename fragment_t, class value_t>
 inline value_t* FlashWare<fragment_t, value_t>::Get(const vid_t& key) {
   return &states_[key];
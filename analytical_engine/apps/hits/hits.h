@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "grape/grape.h"
 
+#include "apps/centrality/spmv.h"
 #include "core/app/app_base.h"
 #include "hits/hits_context.h"
 
@@ -42,29 +43,23 @@ class HITS : public grape::ParallelAppBase<FRAG_T, HitsContext<FRAG_T>>,
   static constexpr grape::LoadStrategy load_strategy =
       grape::LoadStrategy::kBothOutIn;
   using vertex_t = typename fragment_t::vertex_t;
+  using spmv_t = PullSpMV<FRAG_T>;
+
+  // auth = A^T hub_last, sent to the mirrors
+  void pullAuth(const fragment_t& frag, context_t& ctx,
+                message_manager_t& messages) {
+    auto& auth = ctx.auth;
+    spmv_t::template Multiply<false>(
+        *this, frag, true, ctx.hub_last,
+        [&auth](int tid, vertex_t u, double sum) { auth[u] = sum; });
+    spmv_t::Exchange(*this, frag, messages, auth, true);
+  }
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     messages.InitChannels(thread_num());
-    auto& channel_0 = messages.Channels()[0];
-    auto inner_vertices = frag.InnerVertices();
-    auto& auth = ctx.auth;
-    auto& hub_last = ctx.hub_last;
-    auto& hub = ctx.hub;
-
-    hub_last.Swap(hub);
-
-    for (auto u : inner_vertices) {
-      auth[u] = 0.0;
-      for (auto& nbr : frag.GetIncomingAdjList(u)) {
-        auth[u] += hub_last[nbr.get_neighbor()];
-      }
-      channel_0.SendMsgThroughEdges<fragment_t, double>(frag, u, auth[u]);
-    }
-
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    }
+    ctx.hub_last.Swap(ctx.hub);
+    pullAuth(frag, ctx, messages);
 
     ctx.stage = HubIteration;
   }
@@ -77,52 +72,21 @@ class HITS : public grape::ParallelAppBase<FRAG_T, HitsContext<FRAG_T>>,
     auto& auth = ctx.auth;
     auto& hub_last = ctx.hub_last;
     double tolerance = ctx.tolerance;
-    int thrd_num = thread_num();
 
     if (ctx.stage == AuthIteration) {
       hub_last.Swap(hub);
-
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [&auth, &hub_last, &frag, &messages](int tid, vertex_t u) {
-            auth[u] = 0.0;
-            for (auto& nbr : frag.GetIncomingAdjList(u)) {
-              auth[u] += hub_last[nbr.get_neighbor()];
-            }
-            messages.Channels()[tid].SendMsgThroughEdges<fragment_t, double>(
-                frag, u, auth[u]);
-          });
-
+      pullAuth(frag, ctx, messages);
       ctx.stage = HubIteration;
-      if (frag.fnum() == 1) {
-        messages.ForceContinue();
-      }
     } else if (ctx.stage == HubIteration) {
-      messages.ParallelProcess<fragment_t, double>(
-          thrd_num, frag, [&auth](int tid, vertex_t v, double auth_val) {
-            auth[v] = auth_val;
-          });
-
-      ForEach(
-          inner_vertices.begin(), inner_vertices.end(),
-          [&hub, &auth, &frag, &messages](int tid, vertex_t u) {
-            hub[u] = 0.0;
-            for (auto& nbr : frag.GetOutgoingAdjList(u)) {
-              hub[u] += auth[nbr.get_neighbor()];
-            }
-
-            messages.Channels()[tid].SendMsgThroughEdges<fragment_t, double>(
-                frag, u, hub[u]);
-          });
+      spmv_t::Receive(*this, frag, messages, auth);
+      spmv_t::template Multiply<false>(
+          *this, frag, false, auth,
+          [&hub](int tid, vertex_t u, double sum) { hub[u] = sum; });
+      spmv_t::Exchange(*this, frag, messages, hub, true);
 
       ctx.stage = Normalize;
-      if (frag.fnum() == 1) {
-        messages.ForceContinue();
-      }
     } else if (ctx.stage == Normalize) {
-      messages.ParallelProcess<fragment_t, double>(
-          thrd_num, frag,
-          [&hub](int tid, vertex_t v, double hub_val) { hub[v] = hub_val; });
+      spmv_t::Receive(*this, frag, messages, hub);
 
       double local_max_h = -std::numeric_limits<double>::max();
       double local_max_a = -std::numeric_limits<double>::max();
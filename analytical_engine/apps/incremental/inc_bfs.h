@@ -0,0 +1,183 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_BFS_H_
+#define ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_BFS_H_
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/incremental_app_base.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class IncBFSContext : public grape::VertexDataContext<FRAG_T, int64_t> {
+ public:
+  using depth_type = int64_t;
+  using oid_t = typename FRAG_T::oid_t;
+  using vertices_t = typename FRAG_T::vertices_t;
+
+  static constexpr depth_type kUnreached =
+      std::numeric_limits<depth_type>::max();
+
+  explicit IncBFSContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, int64_t>(fragment, true),
+        depth(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t source_id) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    this->source_id = source_id;
+    depth.Init(vertices, depth_type(kUnreached));
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  void Grow(const vertices_t& old_vertices) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    GrowVertexArray(depth, old_vertices, vertices, depth_type(kUnreached));
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      if (depth[v] == kUnreached) {
+        os << frag.GetId(v) << " infinity" << std::endl;
+      } else {
+        os << frag.GetId(v) << " " << depth[v] << std::endl;
+      }
+    }
+  }
+
+  oid_t source_id;
+  typename FRAG_T::template vertex_array_t<depth_type>& depth;
+  typename FRAG_T::template vertex_array_t<bool> curr_modified;
+  typename FRAG_T::template vertex_array_t<bool> next_modified;
+};
+
+/**
+ * @brief The BFS depths from a source that can be brought up to date with
+ * the edges added to a DynamicFragment, see IncrementalWorker.
+ *
+ * An edge added only lowers depths, so Resume expands from its inner ends
+ * that are reached. A vertex may be lowered more than once before the depths
+ * settle, as the fragments don't expand level by level.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class IncBFS : public IncrementalAppBase<FRAG_T, IncBFSContext<FRAG_T>> {
+ public:
+  INSTALL_INCREMENTAL_WORKER(IncBFS<FRAG_T>, IncBFSContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using depth_type = typename context_t::depth_type;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      ctx.depth[source] = 0;
+      ctx.curr_modified[source] = true;
+    }
+    expand(frag, ctx, messages);
+  }
+
+  void Resume(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages,
+              const std::vector<std::pair<vertex_t, vertex_t>>& edges_added) {
+    // the source may have been added since
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source) && ctx.depth[source] != 0) {
+      ctx.depth[source] = 0;
+      ctx.curr_modified[source] = true;
+    }
+    for (auto& e : edges_added) {
+      reach(frag, ctx, e.first);
+      reach(frag, ctx, e.second);
+    }
+    expand(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    vertex_t v(0);
+    depth_type val;
+    while (messages.GetMessage<fragment_t, depth_type>(frag, v, val)) {
+      if (ctx.depth[v] > val) {
+        ctx.depth[v] = val;
+        ctx.curr_modified[v] = true;
+      }
+    }
+    expand(frag, ctx, messages);
+  }
+
+ private:
+  static void reach(const fragment_t& frag, context_t& ctx, vertex_t v) {
+    if (frag.IsInnerVertex(v) && ctx.depth[v] != context_t::kUnreached) {
+      ctx.curr_modified[v] = true;
+    }
+  }
+
+  void expand(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    auto outer_vertices = frag.OuterVertices();
+
+    for (auto v : inner_vertices) {
+      if (!ctx.curr_modified[v]) {
+        continue;
+      }
+      ctx.curr_modified[v] = false;
+      depth_type next_depth = ctx.depth[v] + 1;
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        if (next_depth < ctx.depth[u]) {
+          ctx.depth[u] = next_depth;
+          ctx.next_modified[u] = true;
+        }
+      }
+    }
+
+    for (auto v : outer_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.SyncStateOnOuterVertex<fragment_t, depth_type>(frag, v,
+                                                                ctx.depth[v]);
+        ctx.next_modified[v] = false;
+      }
+    }
+    for (auto v : inner_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.ForceContinue();
+        break;
+      }
+    }
+    ctx.curr_modified.Swap(ctx.next_modified);
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_BFS_H_
@@ -0,0 +1,235 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_PAGERANK_H_
+#define ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_PAGERANK_H_
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/incremental_app_base.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class IncPageRankContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using vertices_t = typename FRAG_T::vertices_t;
+
+  explicit IncPageRankContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        rank(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, double delta,
+            double tolerance) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    this->delta = delta;
+    this->tolerance = tolerance;
+    rank.Init(vertices, 0.0);
+    residual.Init(vertices, 0.0);
+    degree.Init(vertices, 0);
+    in_queue.Init(vertices, false);
+    for (auto v : frag.InnerVertices()) {
+      residual[v] = 1 - delta;
+      degree[v] = frag.GetLocalOutDegree(v);
+    }
+  }
+
+  // the vertices added get no degree, for Resume to start them
+  void Grow(const vertices_t& old_vertices) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    GrowVertexArray(rank, old_vertices, vertices, 0.0);
+    GrowVertexArray(residual, old_vertices, vertices, 0.0);
+    GrowVertexArray(degree, old_vertices, vertices, -1);
+    in_queue.Init(vertices, false);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    for (auto v : frag.InnerVertices()) {
+      os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+         << rank[v] << std::endl;
+    }
+  }
+
+  double delta;
+  double tolerance;
+  typename FRAG_T::template vertex_array_t<double>& rank;
+  // The rank of an inner vertex not pushed to its neighbors yet, and the
+  // rank pushed to an outer vertex not sent to its fragment yet.
+  typename FRAG_T::template vertex_array_t<double> residual;
+  // The out-degree of an inner vertex its pushes so far have been shared by.
+  typename FRAG_T::template vertex_array_t<int> degree;
+  typename FRAG_T::template vertex_array_t<bool> in_queue;
+};
+
+/**
+ * @brief PageRank by pushing residuals (Andersen et al., FOCS 2006), that can
+ * be brought up to date with the edges added to a DynamicFragment, see
+ * IncrementalWorker.
+ *
+ * The ranks solve rank(v) = (1 - delta) + delta * sum(rank(u) / degree(u))
+ * over the in-neighbors u of v, without redistributing the ranks of the
+ * vertices with no out-edges, and each vertex pushes its residual while it
+ * is above the tolerance. After edges are added, a vertex whose out-degree
+ * changed has shared its rank by a wrong degree: Resume takes the excess
+ * back from its neighbors before and gives the new ones their share, as
+ * residuals that may be negative, and the vertices added start with the
+ * residual 1 - delta.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class IncPageRank
+    : public IncrementalAppBase<FRAG_T, IncPageRankContext<FRAG_T>> {
+ public:
+  INSTALL_INCREMENTAL_WORKER(IncPageRank<FRAG_T>, IncPageRankContext<FRAG_T>,
+                             FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::vector<vertex_t> active;
+    for (auto v : frag.InnerVertices()) {
+      activate(frag, ctx, v, active);
+    }
+    push(frag, ctx, messages, active);
+  }
+
+  void Resume(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages,
+              const std::vector<std::pair<vertex_t, vertex_t>>& edges_added) {
+    std::vector<vertex_t> active;
+    for (auto v : frag.InnerVertices()) {
+      if (ctx.degree[v] < 0) {
+        ctx.degree[v] = frag.GetLocalOutDegree(v);
+        ctx.residual[v] += 1 - ctx.delta;
+        activate(frag, ctx, v, active);
+      }
+    }
+
+    // the out-neighbors added of each inner vertex
+    std::vector<std::pair<vertex_t, vertex_t>> added;
+    for (auto& e : edges_added) {
+      if (frag.IsInnerVertex(e.first)) {
+        added.push_back(e);
+      }
+      if (!frag.directed() && e.first != e.second &&
+          frag.IsInnerVertex(e.second)) {
+        added.emplace_back(e.second, e.first);
+      }
+    }
+    std::sort(added.begin(), added.end());
+    for (size_t begin = 0, end = 0; begin < added.size(); begin = end) {
+      vertex_t u = added[begin].first;
+      while (end < added.size() && added[end].first == u) {
+        ++end;
+      }
+      int old_degree = ctx.degree[u];
+      int new_degree = frag.GetLocalOutDegree(u);
+      ctx.degree[u] = new_degree;
+      double pushed = ctx.delta * ctx.rank[u];
+      if (pushed == 0 || new_degree == 0) {
+        continue;
+      }
+      // each neighbor before has got pushed / old_degree, and each one
+      // should have got pushed / new_degree
+      double share = pushed / new_degree;
+      if (old_degree > 0) {
+        share -= pushed / old_degree;
+        for (size_t i = begin; i < end; ++i) {
+          give(frag, ctx, added[i].second, pushed / old_degree, active);
+        }
+      }
+      for (auto& e : frag.GetOutgoingAdjList(u)) {
+        give(frag, ctx, e.get_neighbor(), share, active);
+      }
+    }
+    push(frag, ctx, messages, active);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    std::vector<vertex_t> active;
+    vertex_t v(0);
+    double val;
+    while (messages.GetMessage<fragment_t, double>(frag, v, val)) {
+      give(frag, ctx, v, val, active);
+    }
+    push(frag, ctx, messages, active);
+  }
+
+ private:
+  static void activate(const fragment_t& frag, context_t& ctx, vertex_t v,
+                       std::vector<vertex_t>& active) {
+    if (!ctx.in_queue[v] && std::fabs(ctx.residual[v]) > ctx.tolerance) {
+      ctx.in_queue[v] = true;
+      active.push_back(v);
+    }
+  }
+
+  static void give(const fragment_t& frag, context_t& ctx, vertex_t v,
+                   double value, std::vector<vertex_t>& active) {
+    ctx.residual[v] += value;
+    if (frag.IsInnerVertex(v)) {
+      activate(frag, ctx, v, active);
+    }
+  }
+
+  // Pushes the residuals of the inner vertices until none is above the
+  // tolerance, then sends the residuals pushed to the outer vertices.
+  void push(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages, std::vector<vertex_t>& active) {
+    while (!active.empty()) {
+      vertex_t v = active.back();
+      active.pop_back();
+      ctx.in_queue[v] = false;
+      double residual = ctx.residual[v];
+      if (std::fabs(residual) <= ctx.tolerance) {
+        continue;
+      }
+      ctx.residual[v] = 0;
+      ctx.rank[v] += residual;
+      if (ctx.degree[v] == 0) {
+        continue;
+      }
+      double share = ctx.delta * residual / ctx.degree[v];
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        give(frag, ctx, e.get_neighbor(), share, active);
+      }
+    }
+
+    for (auto v : frag.OuterVertices()) {
+      if (ctx.residual[v] != 0) {
+        messages.SyncStateOnOuterVertex<fragment_t, double>(frag, v,
+                                                            ctx.residual[v]);
+        ctx.residual[v] = 0;
+      }
+    }
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_PAGERANK_H_
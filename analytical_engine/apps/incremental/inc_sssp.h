@@ -0,0 +1,195 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_SSSP_H_
+#define ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_SSSP_H_
+
+#include <iomanip>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/incremental_app_base.h"
+#include "core/utils/trait_utils.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class IncSSSPContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vertices_t = typename FRAG_T::vertices_t;
+
+  explicit IncSSSPContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        partial_result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t source_id) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    this->source_id = source_id;
+    partial_result.Init(vertices, std::numeric_limits<double>::max());
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  void Grow(const vertices_t& old_vertices) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    GrowVertexArray(partial_result, old_vertices, vertices,
+                    std::numeric_limits<double>::max());
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      double d = partial_result[v];
+      if (d == std::numeric_limits<double>::max()) {
+        os << frag.GetId(v) << " infinity" << std::endl;
+      } else {
+        os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+           << d << std::endl;
+      }
+    }
+  }
+
+  oid_t source_id;
+  typename FRAG_T::template vertex_array_t<double>& partial_result;
+  typename FRAG_T::template vertex_array_t<bool> curr_modified;
+  typename FRAG_T::template vertex_array_t<bool> next_modified;
+};
+
+/**
+ * @brief Single source shortest paths that can be brought up to date with
+ * the edges added to a DynamicFragment, see IncrementalWorker.
+ *
+ * An edge added only lowers distances, so Resume relaxes the edges of its
+ * inner ends that are reached, and the distances drop from the previous
+ * ones as in a query from a source.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class IncSSSP : public IncrementalAppBase<FRAG_T, IncSSSPContext<FRAG_T>> {
+ public:
+  INSTALL_INCREMENTAL_WORKER(IncSSSP<FRAG_T>, IncSSSPContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using edata_t = typename fragment_t::edata_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      ctx.partial_result[source] = 0;
+      ctx.curr_modified[source] = true;
+    }
+    relax(frag, ctx, messages);
+  }
+
+  void Resume(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages,
+              const std::vector<std::pair<vertex_t, vertex_t>>& edges_added) {
+    // the source may have been added since
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source) &&
+        ctx.partial_result[source] != 0) {
+      ctx.partial_result[source] = 0;
+      ctx.curr_modified[source] = true;
+    }
+    for (auto& e : edges_added) {
+      reach(frag, ctx, e.first);
+      reach(frag, ctx, e.second);
+    }
+    relax(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    vertex_t v(0);
+    double val;
+    while (messages.GetMessage<fragment_t, double>(frag, v, val)) {
+      if (ctx.partial_result[v] > val) {
+        ctx.partial_result[v] = val;
+        ctx.curr_modified[v] = true;
+      }
+    }
+    relax(frag, ctx, messages);
+  }
+
+ private:
+  template <typename EDGE_T>
+  static double edgeWeight(const EDGE_T& e) {
+    double w = 1.0;
+    vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
+        [](auto& e, auto& data) { data = static_cast<double>(e.get_data()); })(
+        e, w);
+    return w;
+  }
+
+  static void reach(const fragment_t& frag, context_t& ctx, vertex_t v) {
+    if (frag.IsInnerVertex(v) &&
+        ctx.partial_result[v] != std::numeric_limits<double>::max()) {
+      ctx.curr_modified[v] = true;
+    }
+  }
+
+  void relax(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    auto outer_vertices = frag.OuterVertices();
+
+    for (auto v : inner_vertices) {
+      if (!ctx.curr_modified[v]) {
+        continue;
+      }
+      ctx.curr_modified[v] = false;
+      double distance = ctx.partial_result[v];
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        double new_distance = distance + edgeWeight(e);
+        if (new_distance < ctx.partial_result[u]) {
+          ctx.partial_result[u] = new_distance;
+          ctx.next_modified[u] = true;
+        }
+      }
+    }
+
+    for (auto v : outer_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.SyncStateOnOuterVertex<fragment_t, double>(
+            frag, v, ctx.partial_result[v]);
+        ctx.next_modified[v] = false;
+      }
+    }
+    for (auto v : inner_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.ForceContinue();
+        break;
+      }
+    }
+    ctx.curr_modified.Swap(ctx.next_modified);
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_SSSP_H_
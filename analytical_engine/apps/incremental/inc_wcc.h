@@ -0,0 +1,193 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_WCC_H_
+#define ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_WCC_H_
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/incremental_app_base.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class IncWCCContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  using vertices_t = typename FRAG_T::vertices_t;
+
+  explicit IncWCCContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  // the vertices added get no component, for Resume to start them from
+  // their own
+  void Grow(const vertices_t& old_vertices) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    GrowVertexArray(comp_id, old_vertices, vertices,
+                    std::numeric_limits<vid_t>::max());
+    curr_modified.Init(vertices, false);
+    next_modified.Init(vertices, false);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto iv = frag.InnerVertices();
+
+    for (auto v : iv) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+  typename FRAG_T::template vertex_array_t<bool> curr_modified;
+  typename FRAG_T::template vertex_array_t<bool> next_modified;
+};
+
+/**
+ * @brief Weakly connected components, by the lowest gid of a component,
+ * that can be brought up to date with the edges added to a DynamicFragment,
+ * see IncrementalWorker.
+ *
+ * An edge added only merges components, so Resume propagates the components
+ * of its inner ends, and of the vertices added, further.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class IncWCC : public IncrementalAppBase<FRAG_T, IncWCCContext<FRAG_T>> {
+ public:
+  INSTALL_INCREMENTAL_WORKER(IncWCC<FRAG_T>, IncWCCContext<FRAG_T>, FRAG_T)
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    for (auto v : frag.InnerVertices()) {
+      ctx.comp_id[v] = frag.GetInnerVertexGid(v);
+      ctx.curr_modified[v] = true;
+    }
+    for (auto v : frag.OuterVertices()) {
+      ctx.comp_id[v] = frag.GetOuterVertexGid(v);
+    }
+    propagate(frag, ctx, messages);
+  }
+
+  void Resume(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages,
+              const std::vector<std::pair<vertex_t, vertex_t>>& edges_added) {
+    for (auto v : frag.InnerVertices()) {
+      if (ctx.comp_id[v] == std::numeric_limits<vid_t>::max()) {
+        ctx.comp_id[v] = frag.GetInnerVertexGid(v);
+        ctx.curr_modified[v] = true;
+      }
+    }
+    for (auto v : frag.OuterVertices()) {
+      if (ctx.comp_id[v] == std::numeric_limits<vid_t>::max()) {
+        ctx.comp_id[v] = frag.GetOuterVertexGid(v);
+      }
+    }
+    for (auto& e : edges_added) {
+      if (frag.IsInnerVertex(e.first)) {
+        ctx.curr_modified[e.first] = true;
+      }
+      if (frag.IsInnerVertex(e.second)) {
+        ctx.curr_modified[e.second] = true;
+      }
+    }
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    vertex_t v(0);
+    vid_t val;
+    while (messages.GetMessage<fragment_t, vid_t>(frag, v, val)) {
+      if (ctx.comp_id[v] > val) {
+        ctx.comp_id[v] = val;
+        ctx.curr_modified[v] = true;
+      }
+    }
+    propagate(frag, ctx, messages);
+  }
+
+ private:
+  template <typename ADJ_LIST_T>
+  static void lower(context_t& ctx, const ADJ_LIST_T& es, vid_t cid) {
+    for (auto& e : es) {
+      auto u = e.get_neighbor();
+      if (ctx.comp_id[u] > cid) {
+        ctx.comp_id[u] = cid;
+        ctx.next_modified[u] = true;
+      }
+    }
+  }
+
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    auto outer_vertices = frag.OuterVertices();
+
+    for (auto v : inner_vertices) {
+      if (!ctx.curr_modified[v]) {
+        continue;
+      }
+      ctx.curr_modified[v] = false;
+      auto cid = ctx.comp_id[v];
+      lower(ctx, frag.GetOutgoingAdjList(v), cid);
+      if (frag.directed()) {
+        lower(ctx, frag.GetIncomingAdjList(v), cid);
+      }
+    }
+
+    for (auto v : outer_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
+                                                           ctx.comp_id[v]);
+        ctx.next_modified[v] = false;
+      }
+    }
+    for (auto v : inner_vertices) {
+      if (ctx.next_modified[v]) {
+        messages.ForceContinue();
+        break;
+      }
+    }
+    ctx.curr_modified.Swap(ctx.next_modified);
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_INCREMENTAL_INC_WCC_H_
@@ -18,6 +18,7 @@ limitations under the License.
 
 #ifdef ENABLE_JAVA_SDK
 
+#include <memory>
 #include <queue>
 #include <utility>
 
@@ -28,6 +29,7 @@ limitations under the License.
 #include "apps/java_pie/java_pie_parallel_context.h"
 #include "core/app/java/java_parallel_app_base.h"
 #include "core/error.h"
+#include "core/java/java_message_batch.h"
 
 namespace gs {
 
@@ -62,6 +64,9 @@ class JavaPIEParallelApp
       auto communicator = static_cast<grape::Communicator*>(this);
       InitJavaCommunicator(env, ctx.url_class_loader_object(), app_object,
                            reinterpret_cast<jlong>(communicator));
+      batch_sender_.reset(
+          new JavaMessageBatchSender<fragment_t>(frag, messages));
+      batch_sender_->Bind(env, ctx.url_class_loader_object());
 
       jclass app_class = env->GetObjectClass(app_object);
       CHECK_NOTNULL(app_class);
@@ -120,6 +125,9 @@ class JavaPIEParallelApp
       LOG(ERROR) << "JNI env not available.";
     }
   }
+
+ private:
+  std::unique_ptr<JavaMessageBatchSender<fragment_t>> batch_sender_;
 };
 
 }  // namespace gs
@@ -18,6 +18,7 @@ limitations under the License.
 
 #ifdef ENABLE_JAVA_SDK
 
+#include <memory>
 #include <utility>
 
 #include "grape/communication/communicator.h"
@@ -26,6 +27,7 @@ limitations under the License.
 
 #include "core/context/java_pie_projected_context.h"
 #include "core/error.h"
+#include "core/java/java_message_batch.h"
 #include "core/java/utils.h"
 
 namespace gs {
@@ -59,6 +61,9 @@ class JavaPIEProjectedParallelApp
       auto communicator = static_cast<grape::Communicator*>(this);
       InitJavaCommunicator(env, ctx.url_class_loader_object(), app_object,
                            reinterpret_cast<jlong>(communicator));
+      batch_sender_.reset(
+          new JavaMessageBatchSender<fragment_t>(frag, messages));
+      batch_sender_->Bind(env, ctx.url_class_loader_object());
 
       jclass app_class = env->GetObjectClass(app_object);
 
@@ -116,6 +121,9 @@ class JavaPIEProjectedParallelApp
       LOG(ERROR) << "JNI env not available.";
     }
   }
+
+ private:
+  std::unique_ptr<JavaMessageBatchSender<fragment_t>> batch_sender_;
 };
 
 template <typename FRAG_T>
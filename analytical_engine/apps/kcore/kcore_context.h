@@ -22,6 +22,7 @@ limitations under the License.
 #include <queue>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -32,16 +33,21 @@ class KCoreContext : public grape::VertexDataContext<FRAG_T, int> {
  public:
   using oid_t = typename FRAG_T::oid_t;
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
 
   explicit KCoreContext(const FRAG_T& fragment)
       : grape::VertexDataContext<FRAG_T, int>(fragment) {}
 
+  // The degrees of the remaining inner vertices, or the edges removed from an
+  // outer vertex not yet sent to its fragment.
   typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
       degrees;
-  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> to_remove_vertices,
-      remaining_vertices, next_remaining_vertices;
+  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> remaining_vertices;
+  // The inner vertices whose degrees drop below k, to be removed by the next
+  // round, and the outer vertices with removed edges, by thread.
+  std::vector<std::vector<vertex_t>> next_frontiers;
+  std::vector<std::vector<vertex_t>> updated_outer_vertices;
   int k;
-  int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
     auto& frag = this->fragment();
@@ -49,16 +55,12 @@ class KCoreContext : public grape::VertexDataContext<FRAG_T, int> {
     auto inner_vertices = frag.InnerVertices();
 
     degrees.Init(vertices);
-    to_remove_vertices.Init(inner_vertices);
     remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
     this->k = k;
-    curr_k = 0;
 
     for (auto& v : vertices) {
       degrees[v] = std::make_shared<std::atomic_int>(0);
       if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
         degrees[v]->store(frag.GetLocalOutDegree(v));
       } else {
         degrees[v]->store(0);
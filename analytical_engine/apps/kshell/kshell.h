@@ -26,6 +26,9 @@ namespace gs {
 /**
  * @brief Get a subgraph induced by nodes with core number k.
  * That is, nodes in the k-core that are not in the (k+1)-core.
+ *
+ * The k-core is peeled from a frontier as by KCore, then the (k+1)-core from
+ * the vertices of degree k, the vertices removed by the latter are the shell.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -41,98 +44,102 @@ class KShell : public grape::ParallelAppBase<FRAG_T, KShellContext<FRAG_T>>,
   using vertex_t = typename fragment_t::vertex_t;
   using vid_t = typename FRAG_T::vid_t;
 
-  void UpdateDegree(
-      const fragment_t& frag,
-      const grape::DenseVertexSet<typename FRAG_T::inner_vertices_t>& frontier,
-      typename FRAG_T::template vertex_array_t<
-          std::shared_ptr<std::atomic_int>>& degrees) {
-    ForEach(frontier, [&degrees, &frag](int tid, vertex_t u) {
-      for (auto& e : frag.GetOutgoingAdjList(u)) {
-        auto v = e.get_neighbor();
-        degrees[v]->operator--();
-      }
-
-      degrees[u]->store(0);
-    });
+  // Removes the edges of the frontier, an inner neighbor joins the next
+  // frontier once its degree drops below threshold.
+  void UpdateDegree(const fragment_t& frag,
+                    const std::vector<vertex_t>& frontier, int threshold,
+                    context_t& ctx) {
+    ForEach(frontier.begin(), frontier.end(),
+            [&frag, &ctx, threshold](int tid, vertex_t u) {
+              for (auto& e : frag.GetOutgoingAdjList(u)) {
+                auto v = e.get_neighbor();
+                int old_degree = ctx.degrees[v]->fetch_sub(1);
+                if (frag.IsInnerVertex(v)) {
+                  if (old_degree == threshold) {
+                    ctx.next_frontiers[tid].push_back(v);
+                  }
+                } else if (old_degree == 0) {
+                  ctx.updated_outer_vertices[tid].push_back(v);
+                }
+              }
+            });
   }
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     messages.InitChannels(thread_num());
-    // we put all computing logic in IncEval
+    ctx.next_frontiers.resize(thread_num());
+    ctx.updated_outer_vertices.resize(thread_num());
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+      if (ctx.degrees[v]->load() < ctx.curr_k) {
+        ctx.next_frontiers[tid].push_back(v);
+      }
+    });
     messages.ForceContinue();
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
     int thrd_num = thread_num();
-    auto outer_vertices = frag.OuterVertices();
-    auto& remaining_vertices = ctx.remaining_vertices;
-    auto& next_remaining_vertices = ctx.next_remaining_vertices;
-    auto& to_remove_vertices_k = ctx.to_remove_vertices_k;
-    auto& to_remove_vertices_inc = ctx.to_remove_vertices_inc;
     auto& curr_k = ctx.curr_k;
-    auto& degrees = ctx.degrees;
 
     messages.ParallelProcess<fragment_t, int32_t>(
-        thrd_num, frag,
-        [&degrees](int tid, vertex_t v, int32_t msg) { *degrees[v] += msg; });
-
-    // remove vertices which degree less or equal than curr_k
-    ForEach(remaining_vertices, [&to_remove_vertices_k, &to_remove_vertices_inc,
-                                 &degrees, curr_k](int tid, vertex_t v) {
-      if (degrees[v]->load() <= curr_k) {
-        to_remove_vertices_k.Insert(v);
-        to_remove_vertices_inc.Insert(v);
-      }
-    });
-
-    // keep vertices which degree greater than currk
-    ForEach(remaining_vertices,
-            [&next_remaining_vertices, &degrees, curr_k](int tid, vertex_t v) {
-              if (degrees[v]->load() > curr_k) {
-                next_remaining_vertices.Insert(v);
-              }
-            });
-
-    UpdateDegree(frag, to_remove_vertices_inc, degrees);
-
-    ForEach(outer_vertices, [&frag, &degrees, &messages](int tid, vertex_t v) {
-      int degree = degrees[v]->load();
-      if (degree != 0) {
-        messages.Channels()[tid].SyncStateOnOuterVertex<fragment_t, int32_t>(
-            frag, v, degree);
-        degrees[v]->store(0);
-      }
-    });
-
-    bool curr_k_changed = false;
-    size_t global_removed_inc_count = 0;
-    Sum(to_remove_vertices_inc.Count(), global_removed_inc_count);
-    if (global_removed_inc_count == 0) {
+        thrd_num, frag, [&ctx, curr_k](int tid, vertex_t v, int32_t msg) {
+          int old_degree = ctx.degrees[v]->fetch_add(msg);
+          if (old_degree >= curr_k && old_degree + msg < curr_k) {
+            ctx.next_frontiers[tid].push_back(v);
+          }
+        });
+
+    auto frontier = collect(ctx.next_frontiers);
+    size_t global_frontier_size = 0;
+    Sum(frontier.size(), global_frontier_size);
+    if (global_frontier_size == 0 && curr_k == ctx.k) {
+      // the k-core is left, peel the (k+1)-core from its vertices of degree k.
       curr_k++;
-      curr_k_changed = true;
+      ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+        if (ctx.degrees[v]->load() == ctx.k) {
+          ctx.next_frontiers[tid].push_back(v);
+        }
+      });
+      frontier = collect(ctx.next_frontiers);
+      Sum(frontier.size(), global_frontier_size);
     }
-
-    to_remove_vertices_inc.Clear();
-    remaining_vertices.Clear();
-    remaining_vertices.Swap(next_remaining_vertices);
-
-    if (curr_k > ctx.k) {
+    if (global_frontier_size == 0) {
       auto inner_vertices = frag.InnerVertices();
 
       for (auto v : inner_vertices) {
-        ctx.data()[v] = to_remove_vertices_k.Exist(v) ? 1 : 0;
+        ctx.data()[v] = ctx.to_remove_vertices_k.Exist(v) ? 1 : 0;
       }
       return;
     }
 
-    if (curr_k_changed) {
-      to_remove_vertices_k.Clear();
+    if (curr_k > ctx.k) {
+      for (auto& v : frontier) {
+        ctx.to_remove_vertices_k.Insert(v);
+      }
     }
-
+    UpdateDegree(frag, frontier, curr_k, ctx);
+
+    auto updated_outer_vertices = collect(ctx.updated_outer_vertices);
+    ForEach(updated_outer_vertices.begin(), updated_outer_vertices.end(),
+            [&frag, &ctx, &messages](int tid, vertex_t v) {
+              messages.Channels()[tid]
+                  .SyncStateOnOuterVertex<fragment_t, int32_t>(
+                      frag, v, ctx.degrees[v]->exchange(0));
+            });
     messages.ForceContinue();
   }
+
+ private:
+  std::vector<vertex_t> collect(std::vector<std::vector<vertex_t>>& lists) {
+    std::vector<vertex_t> ret;
+    for (auto& list : lists) {
+      ret.insert(ret.end(), list.begin(), list.end());
+      list.clear();
+    }
+    return ret;
+  }
 };
 };  // namespace gs
 
@@ -22,6 +22,7 @@ limitations under the License.
 #include <queue>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -33,15 +34,23 @@ class KShellContext
  public:
   using oid_t = typename FRAG_T::oid_t;
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
 
   explicit KShellContext(const FRAG_T& fragment)
       : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
 
+  // The degrees of the remaining inner vertices, or the edges removed from an
+  // outer vertex not yet sent to its fragment.
   typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
       degrees;
-  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> to_remove_vertices_k,
-      to_remove_vertices_inc, remaining_vertices, next_remaining_vertices;
+  // The vertices removed from the k-core to get the (k+1)-core.
+  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> to_remove_vertices_k;
+  // The inner vertices whose degrees drop below curr_k, to be removed by the
+  // next round, and the outer vertices with removed edges, by thread.
+  std::vector<std::vector<vertex_t>> next_frontiers;
+  std::vector<std::vector<vertex_t>> updated_outer_vertices;
   int k;
+  // The degree the remaining vertices keep, k to peel the k-core, then k + 1.
   int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
@@ -51,16 +60,12 @@ class KShellContext
 
     degrees.Init(vertices);
     to_remove_vertices_k.Init(inner_vertices);
-    to_remove_vertices_inc.Init(inner_vertices);
-    remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
     this->k = k;
-    curr_k = 0;
+    curr_k = k;
 
     for (auto& v : vertices) {
       degrees[v] = std::make_shared<std::atomic_int>(0);
       if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
         degrees[v]->store(frag.GetLocalOutDegree(v));
       } else {
         degrees[v]->store(0);
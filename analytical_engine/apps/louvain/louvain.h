@@ -0,0 +1,321 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_H_
+#define ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_H_
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/utils/trait_utils.h"
+#include "louvain/louvain_context.h"
+#include "louvain/louvain_utils.h"
+
+namespace gs {
+
+/**
+ * @brief A native Louvain for undirected graphs, or for the undirected
+ * graph of the edges of a directed one.
+ *
+ * Each fragment first runs the levels of Louvain on the graph of its inner
+ * vertices, in parallel, the moves of a vertex weighed against the degrees of
+ * the whole graph. A community of a fragment is then a vertex, given by the
+ * gid of one of its vertices, and its arcs, summed by the community of their
+ * ends, are gathered by fragment 0 which runs the levels of Louvain on the
+ * graph of all the communities. The community found for each vertex of it is
+ * sent back to its fragment.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class Louvain : public grape::ParallelAppBase<FRAG_T, LouvainContext<FRAG_T>>,
+                public grape::ParallelEngine,
+                public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(Louvain<FRAG_T>, LouvainContext<FRAG_T>, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using edata_t = typename fragment_t::edata_t;
+  using graph_t = louvain_utils::LouvainGraph<vid_t>;
+  using arc_t = louvain_utils::LouvainArc<vid_t>;
+  using arcs_msg_t = std::pair<grape::fid_t, std::vector<arc_t>>;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    auto inner_vertices = frag.InnerVertices();
+    std::vector<vertex_t> vertices;
+    typename FRAG_T::template vertex_array_t<vid_t> index;
+    index.Init(frag.Vertices(), std::numeric_limits<vid_t>::max());
+    for (auto& v : inner_vertices) {
+      index[v] = static_cast<vid_t>(vertices.size());
+      vertices.push_back(v);
+    }
+    auto num = static_cast<vid_t>(vertices.size());
+
+    // the graph of the edges between the inner vertices, with the degrees
+    // counting the edges to the outer vertices as well.
+    graph_t graph;
+    graph.degrees.resize(num, 0.0);
+    graph.offsets.resize(num + 1, 0);
+    ForEach(louvain_utils::Range(num), [&](int tid, grape::Vertex<vid_t> i) {
+      forEachArc(frag, vertices[i.GetValue()], [&](vertex_t v, double w) {
+        graph.degrees[i.GetValue()] += w;
+        if (frag.IsInnerVertex(v)) {
+          ++graph.offsets[i.GetValue() + 1];
+        }
+      });
+    });
+    for (vid_t i = 0; i < num; ++i) {
+      graph.offsets[i + 1] += graph.offsets[i];
+    }
+    graph.nbrs.resize(graph.offsets[num]);
+    graph.weights.resize(graph.offsets[num]);
+    ForEach(louvain_utils::Range(num), [&](int tid, grape::Vertex<vid_t> i) {
+      size_t e = graph.offsets[i.GetValue()];
+      forEachArc(frag, vertices[i.GetValue()], [&](vertex_t v, double w) {
+        if (frag.IsInnerVertex(v)) {
+          graph.nbrs[e] = index[v];
+          graph.weights[e] = w;
+          ++e;
+        }
+      });
+    });
+    double local_weight = 0;
+    for (auto d : graph.degrees) {
+      local_weight += d;
+    }
+    Sum(local_weight, graph.total_weight);
+
+    auto result =
+        louvain_utils::Louvain<vid_t>(*this, std::move(graph), ctx.max_levels,
+                                      ctx.max_rounds, ctx.min_gain);
+
+    vid_t community_num = 0;
+    for (auto c : result) {
+      community_num = std::max(community_num, static_cast<vid_t>(c + 1));
+    }
+    ctx.member_offsets.assign(community_num + 1, 0);
+    for (auto c : result) {
+      ++ctx.member_offsets[c + 1];
+    }
+    for (vid_t c = 0; c < community_num; ++c) {
+      ctx.member_offsets[c + 1] += ctx.member_offsets[c];
+    }
+    ctx.members.resize(num);
+    std::vector<size_t> cursor(ctx.member_offsets.begin(),
+                               ctx.member_offsets.end() - 1);
+    for (vid_t i = 0; i < num; ++i) {
+      ctx.members[cursor[result[i]]++] = vertices[i];
+    }
+
+    ForEach(louvain_utils::Range(community_num),
+            [&frag, &ctx, &messages](int tid, grape::Vertex<vid_t> c) {
+              auto begin = ctx.member_offsets[c.GetValue()];
+              auto end = ctx.member_offsets[c.GetValue() + 1];
+              vid_t gid = frag.Vertex2Gid(ctx.members[begin]);
+              for (auto idx = begin; idx < end; ++idx) {
+                auto& v = ctx.members[idx];
+                ctx.community[v] = gid;
+                messages.Channels()[tid]
+                    .SendMsgThroughEdges<fragment_t, vid_t>(frag, v, gid);
+              }
+            });
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    if (ctx.stage == 0) {
+      ctx.stage = 1;
+      messages.ParallelProcess<fragment_t, vid_t>(
+          thread_num(), frag, [&ctx](int tid, vertex_t u, vid_t gid) {
+            ctx.community[u] = gid;
+          });
+      sendCommunityArcs(frag, ctx, messages);
+      messages.ForceContinue();
+    } else if (ctx.stage == 1) {
+      ctx.stage = 2;
+      std::vector<arcs_msg_t> msgs;
+      std::mutex mutex;
+      messages.ParallelProcess<arcs_msg_t>(
+          thread_num(), [&msgs, &mutex](int tid, arcs_msg_t& msg) {
+            std::lock_guard<std::mutex> lock(mutex);
+            msgs.emplace_back(std::move(msg));
+          });
+      if (frag.fid() == 0) {
+        runGathered(frag, ctx, messages, msgs);
+      }
+      messages.ForceContinue();
+    } else if (ctx.stage == 2) {
+      ctx.stage = 3;
+      std::unordered_map<vid_t, vid_t> final_community;
+      std::mutex mutex;
+      messages.ParallelProcess<std::pair<vid_t, vid_t>>(
+          thread_num(), [&final_community, &mutex](
+                            int tid, const std::pair<vid_t, vid_t>& msg) {
+            std::lock_guard<std::mutex> lock(mutex);
+            final_community.emplace(msg.first, msg.second);
+          });
+      auto& result = ctx.data();
+      ForEach(frag.InnerVertices(),
+              [&frag, &ctx, &final_community, &result](int tid, vertex_t v) {
+                auto iter = final_community.find(ctx.community[v]);
+                result[v] = frag.Gid2Oid(iter == final_community.end()
+                                             ? ctx.community[v]
+                                             : iter->second);
+              });
+    }
+  }
+
+ private:
+  template <typename EDGE_T>
+  static double edgeWeight(const EDGE_T& e) {
+    double w = 1.0;
+    vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
+        [](auto& e, auto& data) { data = static_cast<double>(e.get_data()); })(
+        e, w);
+    return w;
+  }
+
+  // Calls func(v, weight) for each arc of u, i.e. for each of its outgoing
+  // edges, and each of its incoming edges if the fragment is directed.
+  template <typename FUNC_T>
+  void forEachArc(const fragment_t& frag, vertex_t u, const FUNC_T& func) {
+    for (auto& e : frag.GetOutgoingAdjList(u)) {
+      func(e.get_neighbor(), edgeWeight(e));
+    }
+    if (frag.directed()) {
+      for (auto& e : frag.GetIncomingAdjList(u)) {
+        func(e.get_neighbor(), edgeWeight(e));
+      }
+    }
+  }
+
+  // Sends the arcs of the communities of the fragment to fragment 0, each
+  // community with the sum of its arcs to each community they reach.
+  void sendCommunityArcs(const fragment_t& frag, context_t& ctx,
+                         message_manager_t& messages) {
+    auto community_num =
+        static_cast<vid_t>(ctx.member_offsets.empty()
+                               ? 0
+                               : ctx.member_offsets.size() - 1);
+    std::vector<std::vector<arc_t>> arcs(thread_num());
+    std::vector<std::unordered_map<vid_t, double>> nbr_weights(thread_num());
+    ForEach(
+        louvain_utils::Range(community_num),
+        [&](int tid, grape::Vertex<vid_t> c) {
+          auto& weights = nbr_weights[tid];
+          weights.clear();
+          auto begin = ctx.member_offsets[c.GetValue()];
+          auto end = ctx.member_offsets[c.GetValue() + 1];
+          for (auto idx = begin; idx < end; ++idx) {
+            forEachArc(frag, ctx.members[idx], [&](vertex_t v, double w) {
+              weights[ctx.community[v]] += w;
+            });
+          }
+          vid_t gid = ctx.community[ctx.members[begin]];
+          for (auto& pair : weights) {
+            arcs[tid].push_back(arc_t{gid, pair.first, pair.second});
+          }
+        },
+        64);
+    arcs_msg_t msg(frag.fid(), std::vector<arc_t>());
+    for (auto& thread_arcs : arcs) {
+      msg.second.insert(msg.second.end(), thread_arcs.begin(),
+                        thread_arcs.end());
+      std::vector<arc_t>().swap(thread_arcs);
+    }
+    messages.Channels()[0].SendToFragment(0, msg);
+  }
+
+  // Runs Louvain on fragment 0 over the communities of all the fragments,
+  // and sends the community found for each of them to its fragment.
+  void runGathered(const fragment_t& frag, context_t& ctx,
+                   message_manager_t& messages, std::vector<arcs_msg_t>& msgs) {
+    std::unordered_map<vid_t, vid_t> ids;
+    std::vector<vid_t> gids;
+    std::vector<grape::fid_t> owners;
+    for (auto& msg : msgs) {
+      for (auto& arc : msg.second) {
+        if (ids.emplace(arc.src, static_cast<vid_t>(gids.size())).second) {
+          gids.push_back(arc.src);
+          owners.push_back(msg.first);
+        }
+      }
+    }
+    auto num = static_cast<vid_t>(gids.size());
+
+    graph_t graph;
+    graph.degrees.resize(num, 0.0);
+    graph.offsets.resize(num + 1, 0);
+    for (auto& msg : msgs) {
+      for (auto& arc : msg.second) {
+        auto src = ids.at(arc.src);
+        graph.degrees[src] += arc.weight;
+        graph.total_weight += arc.weight;
+        ++graph.offsets[src + 1];
+      }
+    }
+    for (vid_t i = 0; i < num; ++i) {
+      graph.offsets[i + 1] += graph.offsets[i];
+    }
+    graph.nbrs.resize(graph.offsets[num]);
+    graph.weights.resize(graph.offsets[num]);
+    {
+      std::vector<size_t> cursor(graph.offsets.begin(),
+                                 graph.offsets.end() - 1);
+      for (auto& msg : msgs) {
+        for (auto& arc : msg.second) {
+          auto e = cursor[ids.at(arc.src)]++;
+          graph.nbrs[e] = ids.at(arc.dst);
+          graph.weights[e] = arc.weight;
+        }
+        std::vector<arc_t>().swap(msg.second);
+      }
+    }
+
+    auto result =
+        louvain_utils::Louvain<vid_t>(*this, std::move(graph), ctx.max_levels,
+                                      ctx.max_rounds, ctx.min_gain);
+    std::vector<vid_t> reps(num, std::numeric_limits<vid_t>::max());
+    for (vid_t i = 0; i < num; ++i) {
+      if (reps[result[i]] == std::numeric_limits<vid_t>::max()) {
+        reps[result[i]] = gids[i];
+      }
+    }
+    ForEach(louvain_utils::Range(num),
+            [&](int tid, grape::Vertex<vid_t> i) {
+              auto idx = i.GetValue();
+              messages.Channels()[tid].SendToFragment(
+                  owners[idx],
+                  std::pair<vid_t, vid_t>(gids[idx], reps[result[idx]]));
+            });
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_H_
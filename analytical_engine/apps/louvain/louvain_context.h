@@ -0,0 +1,70 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_CONTEXT_H_
+
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class LouvainContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit LouvainContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
+
+  void Init(grape::ParallelMessageManager& messages, int max_levels = 10,
+            int max_rounds = 20, double min_gain = 1e-6) {
+    auto& frag = this->fragment();
+    community.Init(frag.Vertices());
+    this->max_levels = max_levels;
+    this->max_rounds = max_rounds;
+    this->min_gain = min_gain;
+    stage = 0;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto& result = this->data();
+    for (auto& v : frag.InnerVertices()) {
+      os << frag.GetId(v) << " " << result[v] << std::endl;
+    }
+  }
+
+  // The gid of a vertex of the community of the vertex in its fragment, the
+  // vertex of the graph gathered by fragment 0.
+  typename FRAG_T::template vertex_array_t<vid_t> community;
+  // The inner vertices of the i-th community of the fragment are
+  // [member_offsets[i], member_offsets[i + 1]) of members.
+  std::vector<size_t> member_offsets;
+  std::vector<vertex_t> members;
+
+  int max_levels;
+  int max_rounds;
+  double min_gain;
+  int stage;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_CONTEXT_H_
@@ -0,0 +1,288 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_UTILS_H_
+#define ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_UTILS_H_
+
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief The shared-memory levels of the native Louvain: the local moving of
+ * the vertices of a weighted graph in CSR form between communities, and the
+ * coarsening of the communities into the graph of the next level.
+ *
+ * An undirected edge is an arc at each of its ends, so that the weights of
+ * the arcs of a vertex sum to its degree, and the edges inside a community
+ * are a self arc of the coarsened vertex, with twice their weight.
+ */
+namespace louvain_utils {
+
+template <typename VID_T>
+struct LouvainGraph {
+  VID_T VertexNum() const { return static_cast<VID_T>(degrees.size()); }
+
+  // The arcs of vertex i are [offsets[i], offsets[i + 1]) of nbrs and weights.
+  std::vector<size_t> offsets;
+  std::vector<VID_T> nbrs;
+  std::vector<double> weights;
+  // The weighted degrees, which may count arcs to vertices out of the graph,
+  // e.g. to the outer vertices of a fragment.
+  std::vector<double> degrees;
+  // Twice the weight of the edges of the whole graph, i.e. 2m.
+  double total_weight = 0;
+};
+
+// An arc between two vertices given by gid, the unit the graph of the
+// communities of a fragment is sent in.
+template <typename VID_T>
+struct LouvainArc {
+  VID_T src;
+  VID_T dst;
+  double weight;
+};
+
+template <typename VID_T>
+inline grape::VertexRange<VID_T> Range(VID_T num) {
+  return grape::VertexRange<VID_T>(0, num);
+}
+
+/**
+ * @brief The modularity of the partition community of the vertices of graph.
+ */
+template <typename VID_T>
+inline double Modularity(grape::ParallelEngine& engine,
+                         const LouvainGraph<VID_T>& graph,
+                         const std::vector<VID_T>& community,
+                         const std::vector<double>& tot) {
+  std::vector<double> in(engine.thread_num(), 0.0);
+  engine.ForEach(Range(graph.VertexNum()),
+                 [&graph, &community, &in](int tid, grape::Vertex<VID_T> v) {
+                   auto i = v.GetValue();
+                   for (size_t e = graph.offsets[i]; e < graph.offsets[i + 1];
+                        ++e) {
+                     if (community[graph.nbrs[e]] == community[i]) {
+                       in[tid] += graph.weights[e];
+                     }
+                   }
+                 });
+  double q = std::accumulate(in.begin(), in.end(), 0.0) / graph.total_weight;
+  for (auto t : tot) {
+    q -= (t / graph.total_weight) * (t / graph.total_weight);
+  }
+  return q;
+}
+
+/**
+ * @brief Moves the vertices of graph in parallel to the community of
+ * their neighbors with the best gain of modularity, from a community per
+ * vertex, until a round gains less than min_gain or after max_rounds.
+ *
+ * A thread sums the arcs of a vertex by community in a hash map of its own,
+ * and the moves of a round see the moves before them. A vertex alone in its
+ * community only joins another vertex alone in a community of lower id, so
+ * that two of them do not swap their communities.
+ *
+ * @return Whether any vertex has moved. community is then filled by the
+ * community of each vertex, the id of one of its vertices.
+ */
+template <typename VID_T>
+inline bool LocalMoving(grape::ParallelEngine& engine,
+                        const LouvainGraph<VID_T>& graph,
+                        std::vector<VID_T>& community, int max_rounds,
+                        double min_gain) {
+  VID_T num = graph.VertexNum();
+  community.resize(num);
+  std::iota(community.begin(), community.end(), VID_T(0));
+  if (graph.total_weight == 0) {
+    return false;
+  }
+  std::vector<double> tot(graph.degrees);
+  std::vector<VID_T> size(num, 1);
+  std::vector<std::unordered_map<VID_T, double>> nbr_weights(
+      engine.thread_num());
+  double m2 = graph.total_weight;
+
+  bool moved = false;
+  double q = Modularity(engine, graph, community, tot);
+  for (int round = 0; round < max_rounds; ++round) {
+    std::vector<size_t> moves(engine.thread_num(), 0);
+    engine.ForEach(
+        Range(num),
+        [&](int tid, grape::Vertex<VID_T> v) {
+          auto i = v.GetValue();
+          auto& weights = nbr_weights[tid];
+          weights.clear();
+          VID_T from = community[i];
+          weights[from] = 0;
+          for (size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+            if (graph.nbrs[e] != i) {
+              weights[community[graph.nbrs[e]]] += graph.weights[e];
+            }
+          }
+          double k = graph.degrees[i];
+          VID_T best = from;
+          double best_gain = weights[from] - (tot[from] - k) * k / m2;
+          for (auto& pair : weights) {
+            double gain = pair.second - tot[pair.first] * k / m2;
+            if (gain > best_gain) {
+              best = pair.first;
+              best_gain = gain;
+            }
+          }
+          if (best != from && size[from] == 1 && size[best] == 1 &&
+              best > from) {
+            return;
+          }
+          if (best != from) {
+            grape::atomic_add(tot[from], -k);
+            grape::atomic_add(tot[best], k);
+            grape::atomic_sub(size[from], VID_T(1));
+            grape::atomic_add(size[best], VID_T(1));
+            community[i] = best;
+            ++moves[tid];
+          }
+        },
+        1024);
+    if (std::accumulate(moves.begin(), moves.end(), size_t(0)) == 0) {
+      break;
+    }
+    moved = true;
+    double next_q = Modularity(engine, graph, community, tot);
+    if (next_q - q < min_gain) {
+      break;
+    }
+    q = next_q;
+  }
+  return moved;
+}
+
+/**
+ * @brief Renumbers the communities of the vertices of graph from 0 and
+ * builds the graph of the communities, the arcs of a community summed by
+ * community in parallel and then copied into CSR form.
+ */
+template <typename VID_T>
+inline LouvainGraph<VID_T> Coarsen(grape::ParallelEngine& engine,
+                                   const LouvainGraph<VID_T>& graph,
+                                   std::vector<VID_T>& community) {
+  VID_T num = graph.VertexNum();
+  std::vector<VID_T> ids(num, std::numeric_limits<VID_T>::max());
+  VID_T community_num = 0;
+  for (VID_T i = 0; i < num; ++i) {
+    if (ids[community[i]] == std::numeric_limits<VID_T>::max()) {
+      ids[community[i]] = community_num++;
+    }
+  }
+  std::vector<size_t> member_offsets(community_num + 1, 0);
+  for (VID_T i = 0; i < num; ++i) {
+    community[i] = ids[community[i]];
+    ++member_offsets[community[i] + 1];
+  }
+  std::partial_sum(member_offsets.begin(), member_offsets.end(),
+                   member_offsets.begin());
+  std::vector<VID_T> members(num);
+  {
+    std::vector<size_t> cursor(member_offsets.begin(),
+                               member_offsets.end() - 1);
+    for (VID_T i = 0; i < num; ++i) {
+      members[cursor[community[i]]++] = i;
+    }
+  }
+
+  LouvainGraph<VID_T> next;
+  next.total_weight = graph.total_weight;
+  next.degrees.resize(community_num, 0.0);
+  std::vector<std::vector<std::pair<VID_T, double>>> arcs(community_num);
+  std::vector<std::unordered_map<VID_T, double>> nbr_weights(
+      engine.thread_num());
+  engine.ForEach(
+      Range(community_num),
+      [&](int tid, grape::Vertex<VID_T> v) {
+        auto c = v.GetValue();
+        auto& weights = nbr_weights[tid];
+        weights.clear();
+        for (size_t idx = member_offsets[c]; idx < member_offsets[c + 1];
+             ++idx) {
+          VID_T i = members[idx];
+          next.degrees[c] += graph.degrees[i];
+          for (size_t e = graph.offsets[i]; e < graph.offsets[i + 1]; ++e) {
+            weights[community[graph.nbrs[e]]] += graph.weights[e];
+          }
+        }
+        arcs[c].assign(weights.begin(), weights.end());
+      },
+      64);
+
+  next.offsets.resize(community_num + 1, 0);
+  for (VID_T c = 0; c < community_num; ++c) {
+    next.offsets[c + 1] = next.offsets[c] + arcs[c].size();
+  }
+  next.nbrs.resize(next.offsets[community_num]);
+  next.weights.resize(next.offsets[community_num]);
+  engine.ForEach(
+      Range(community_num),
+      [&arcs, &next](int tid, grape::Vertex<VID_T> v) {
+        auto c = v.GetValue();
+        size_t e = next.offsets[c];
+        for (auto& arc : arcs[c]) {
+          next.nbrs[e] = arc.first;
+          next.weights[e] = arc.second;
+          ++e;
+        }
+        std::vector<std::pair<VID_T, double>>().swap(arcs[c]);
+      },
+      64);
+  return next;
+}
+
+/**
+ * @brief Runs the levels of Louvain on graph, up to max_levels, until the
+ * local moving of a level moves no vertex.
+ *
+ * @return The community of each vertex of graph, numbered from 0.
+ */
+template <typename VID_T>
+inline std::vector<VID_T> Louvain(grape::ParallelEngine& engine,
+                                  LouvainGraph<VID_T>&& graph, int max_levels,
+                                  int max_rounds, double min_gain) {
+  std::vector<VID_T> result(graph.VertexNum());
+  std::iota(result.begin(), result.end(), VID_T(0));
+  std::vector<VID_T> community;
+  for (int level = 0; level < max_levels; ++level) {
+    if (!LocalMoving(engine, graph, community, max_rounds, min_gain)) {
+      break;
+    }
+    graph = Coarsen(engine, graph, community);
+    engine.ForEach(Range(static_cast<VID_T>(result.size())),
+                   [&result, &community](int tid, grape::Vertex<VID_T> v) {
+                     result[v.GetValue()] = community[result[v.GetValue()]];
+                   });
+  }
+  return result;
+}
+
+}  // namespace louvain_utils
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_LOUVAIN_LOUVAIN_UTILS_H_
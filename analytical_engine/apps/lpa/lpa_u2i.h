@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_H_
 #define ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_H_
 
+#include <cmath>
 #include <utility>
+#include <vector>
 
 #include "apps/lpa/lpa_u2i_context.h"
 
@@ -24,6 +26,12 @@ namespace gs {
 /**
  * @brief Label propagation algorithm. U stands for the user label. V stands for
  * the item label.
+ *
+ * After the first stage of each label, a stage only updates the vertices
+ * with a neighbor to pull from whose label has changed, or a user whose own
+ * label has, and only the changed labels are sent to the mirrors. A label
+ * changed by up to tolerance is not sent, so tolerance 0 gives the labels of
+ * updating all the vertices at each stage.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -98,6 +106,14 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
 
           if (frag.IsOuterVertex(v)) {
             messages.SyncStateOnOuterVertex(frag, v, ctx.in_degree[v_label][u]);
+            ctx.outer_out_nbrs[frag.vertex_label(v)][v].push_back(u);
+          }
+        }
+        for (auto& e : oes) {
+          auto v = e.neighbor();
+
+          if (frag.IsOuterVertex(v)) {
+            ctx.outer_in_nbrs[frag.vertex_label(v)][v].push_back(u);
           }
         }
       }
@@ -106,13 +122,21 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
     messages.ForceContinue();
   }
 
+  // Sends the labels of the inner vertices of v_label that have changed, by
+  // tolerance since they were last sent, to their mirrors.
   void SyncLabelOnInnerVertex(const fragment_t& frag, context_t& ctx,
                               message_manager_t& messages, uint32_t v_label) {
     auto inner_vertices = frag.InnerVertices(v_label);
     auto& label = ctx.label[v_label];
+    auto& synced_label = ctx.synced_label[v_label];
+    bool all = ctx.step == 1;
 
     for (auto u : inner_vertices) {
-      messages.SendMsgThroughEdges(frag, u, 0, label[u]);
+      if (all || labelChanged(ctx, label[u], synced_label[u])) {
+        synced_label[u] = label[u];
+        ctx.changed[v_label].push_back(u);
+        messages.SendMsgThroughEdges(frag, u, 0, label[u]);
+      }
     }
   }
 
@@ -159,17 +183,30 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
         auto v_label = frag.vertex_label(u);
 
         label[v_label][u] = msg.second;
+        ctx.changed[v_label].push_back(u);
       }
 
       auto v_label = step % 2 == 0 ? 1 : 0;
       auto inner_vertices = frag.InnerVertices(v_label);
+      auto& active = ctx.active[v_label];
+      // the first stage of each label updates all the vertices, then the
+      // ones with a changed neighbor to pull from.
+      bool all = step <= 3;
       // u2i stage
       if (step % 2 == 0) {
+        // the changed users are kept, for the next i2u stage to update them
+        // as well.
+        activate(frag, ctx, ctx.changed[0], ctx.outer_out_nbrs, v_label,
+                 false);
         // pull i label from u label along incoming edges
         for (auto u : inner_vertices) {
+          if (!all && !active[u]) {
+            continue;
+          }
+          active[u] = false;
           auto ies = frag.GetIncomingAdjList(u, 0);
 
-          label[v_label][u].clear();
+          label[v_label][u].assign(prop_num, 0);
           for (auto& e : ies) {
             auto v = e.neighbor();
             auto edata = e.template get_data<edata_t>(0);
@@ -184,37 +221,43 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
 
       } else {
         // i2u stage
-        grape::VertexArray<typename FRAG_T::inner_vertices_t, label_t>
-            inner_tmp_label;
+        activate(frag, ctx, ctx.changed[1], ctx.outer_in_nbrs, v_label, true);
+        for (auto u : ctx.changed[0]) {
+          if (frag.IsInnerVertex(u)) {
+            active[u] = true;
+          }
+        }
+        ctx.changed[1].clear();
+        ctx.changed[0].clear();
+
         grape::VertexArray<typename FRAG_T::inner_vertices_t, label_t>
             inner_new_label;
 
-        inner_tmp_label.Init(inner_vertices);
         inner_new_label.Init(inner_vertices);
 
-        // u_label part1
+        auto& out_degree = ctx.out_degree[v_label];
+        auto& out_nbr_in_degree_sum = ctx.out_nbr_in_degree_sum[v_label];
+
         for (auto u : inner_vertices) {
+          if (!all && !active[u]) {
+            continue;
+          }
+          // u_label part1
+          label_t tmp_label(prop_num, 0);
           auto oes = frag.GetOutgoingAdjList(u, 0);
 
-          inner_tmp_label[u].resize(prop_num, 0);
           for (auto& e : oes) {
             auto v = e.neighbor();
             auto edata = e.template get_data<edata_t>(0);
 
             for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
-              inner_tmp_label[u][prop_id] +=
+              tmp_label[prop_id] +=
                   label[frag.vertex_label(v)][v][prop_id] * edata;
             }
           }
-        }
-
-        // u_label part2
-        auto& out_degree = ctx.out_degree[v_label];
-        auto& out_nbr_in_degree_sum = ctx.out_nbr_in_degree_sum[v_label];
 
-        for (auto u : inner_vertices) {
+          // u_label part2
           inner_new_label[u].resize(prop_num);
-
           for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
             if (label[v_label][u][prop_id] == 0 ||
                 label[v_label][u][prop_id] == 1) {
@@ -222,7 +265,7 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
             } else {
               if (out_nbr_in_degree_sum[u] != out_degree[u]) {
                 inner_new_label[u][prop_id] =
-                    (inner_tmp_label[u][prop_id] -
+                    (tmp_label[prop_id] -
                      out_degree[u] * label[v_label][u][prop_id]) /
                     (out_nbr_in_degree_sum[u] - out_degree[u]);
               } else {
@@ -233,14 +276,56 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
         }
 
         for (auto u : inner_vertices) {
-          label[v_label][u] = inner_new_label[u];
+          if (all || active[u]) {
+            active[u] = false;
+            label[v_label][u] = std::move(inner_new_label[u]);
+          }
         }
 
         SyncLabelOnInnerVertex(frag, ctx, messages, v_label);
       }
     }
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
+    messages.ForceContinue();
+  }
+
+ private:
+  bool labelChanged(const context_t& ctx, const label_t& label,
+                    const label_t& synced) {
+    if (label.size() != synced.size()) {
+      return true;
+    }
+    for (size_t i = 0; i < label.size(); ++i) {
+      if (std::fabs(label[i] - synced[i]) > ctx.tolerance) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Marks the inner vertices of v_label that pull from the changed vertices,
+  // through their incoming edges if reversed, else their outgoing ones.
+  template <typename NBRS_T>
+  void activate(const fragment_t& frag, context_t& ctx,
+                const std::vector<vertex_t>& changed, const NBRS_T& outer_nbrs,
+                uint32_t v_label, bool reversed) {
+    auto& active = ctx.active[v_label];
+    for (auto v : changed) {
+      if (frag.IsOuterVertex(v)) {
+        for (auto& u : outer_nbrs[frag.vertex_label(v)][v]) {
+          if (frag.vertex_label(u) == v_label) {
+            active[u] = true;
+          }
+        }
+        continue;
+      }
+      auto es = reversed ? frag.GetIncomingAdjList(v, 0)
+                         : frag.GetOutgoingAdjList(v, 0);
+      for (auto& e : es) {
+        auto u = e.neighbor();
+        if (frag.IsInnerVertex(u) && frag.vertex_label(u) == v_label) {
+          active[u] = true;
+        }
+      }
     }
   }
 };
@@ -29,13 +29,15 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
  public:
   using vid_t = typename FRAG_T::vid_t;
   using oid_t = typename FRAG_T::oid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
   using label_t = std::vector<double>;
   using edata_t = double;
 
   explicit LPAU2IContext(const FRAG_T& fragment)
       : LabeledVertexPropertyContext<FRAG_T>(fragment) {}
 
-  void Init(grape::DefaultMessageManager& messages, int32_t max_round = 20) {
+  void Init(grape::DefaultMessageManager& messages, int32_t max_round = 20,
+            double tolerance = 0) {
     auto& frag = this->fragment();
     auto v_label_num = frag.vertex_label_num();
     auto e_label_num = frag.edge_label_num();
@@ -44,11 +46,17 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
     CHECK_EQ(e_label_num, 1);
     step = 0;
     this->max_round = max_round;
+    this->tolerance = tolerance;
 
     label.resize(v_label_num);
     in_degree.resize(v_label_num);
     out_degree.resize(v_label_num);
     out_nbr_in_degree_sum.resize(v_label_num);
+    synced_label.resize(v_label_num);
+    active.resize(v_label_num);
+    changed.resize(v_label_num);
+    outer_in_nbrs.resize(v_label_num);
+    outer_out_nbrs.resize(v_label_num);
 
     for (auto v_label = 0; v_label != v_label_num; ++v_label) {
       auto inner_vertices = frag.InnerVertices(v_label);
@@ -57,6 +65,10 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
       in_degree[v_label].Init(inner_vertices, 0);
       out_degree[v_label].Init(inner_vertices, 0);
       out_nbr_in_degree_sum[v_label].Init(inner_vertices, 0);
+      synced_label[v_label].Init(inner_vertices);
+      active[v_label].Init(inner_vertices, false);
+      outer_in_nbrs[v_label].Init(frag.OuterVertices(v_label));
+      outer_out_nbrs[v_label].Init(frag.OuterVertices(v_label));
     }
 
     // Only holds user result
@@ -81,6 +93,7 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
 
   uint32_t step;
   uint32_t max_round;
+  double tolerance;
   std::vector<grape::VertexArray<typename FRAG_T::vertices_t, label_t>> label;
   std::vector<grape::VertexArray<typename FRAG_T::inner_vertices_t, vid_t>>
       in_degree;
@@ -88,6 +101,25 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
       out_degree;
   std::vector<grape::VertexArray<typename FRAG_T::inner_vertices_t, vid_t>>
       out_nbr_in_degree_sum;
+  // The labels last sent to the mirrors of the inner vertices, a label is
+  // sent again once it is tolerance away from it in some prop.
+  std::vector<grape::VertexArray<typename FRAG_T::inner_vertices_t, label_t>>
+      synced_label;
+  // The inner vertices to update in the next stage of their label, i.e. with
+  // a neighbor to pull from whose label has changed.
+  std::vector<grape::VertexArray<typename FRAG_T::inner_vertices_t, bool>>
+      active;
+  // The vertices whose labels have changed in the last stage of their label,
+  // the inner ones as sent and the outer ones as received.
+  std::vector<std::vector<vertex_t>> changed;
+  // The inner vertices with an edge from an outer vertex, and the ones with
+  // an edge to it.
+  std::vector<grape::VertexArray<typename FRAG_T::vertices_t,
+                                 std::vector<vertex_t>>>
+      outer_out_nbrs;
+  std::vector<grape::VertexArray<typename FRAG_T::vertices_t,
+                                 std::vector<vertex_t>>>
+      outer_in_nbrs;
   std::vector<int64_t> label_column_indices;
   static constexpr uint32_t prop_num = 2;
 };
@@ -120,16 +120,7 @@ class LouvainAppBase
                                       ctx.GetLocalEdgeWeightSum());
       ctx.compute_context().aggregate(actual_quality_aggregator,
                                       ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context().aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
@@ -286,16 +277,7 @@ class LouvainAppBase
                                       ctx.GetLocalEdgeWeightSum());
       ctx.compute_context().aggregate(actual_quality_aggregator,
                                       ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context().aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
@@ -82,16 +82,7 @@ class PregelPagerank
   }
 };
 
-class PregelPagerankCombinator : public ICombinator<double> {
- public:
-  double CombineMessages(MessageIterator<double> messages) {
-    double ret = 0.0;
-    for (auto msg : messages) {
-      ret += msg;
-    }
-    return ret;
-  }
-};
+using PregelPagerankCombinator = PregelSumCombinator<double>;
 
 }  // namespace gs
 
@@ -85,6 +85,9 @@ class PregelSSSP
   }
 };
 
+// Only the nearest distance sent to a vertex matters.
+using PregelSSSPCombinator = PregelMinCombinator<double>;
+
 }  // namespace gs
 
 #endif  // ANALYTICAL_ENGINE_APPS_PREGEL_SSSP_PREGEL_H_
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_APPS_PYTHON_PIE_WRAPPER_H_
 #define ANALYTICAL_ENGINE_APPS_PYTHON_PIE_WRAPPER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -48,6 +49,15 @@ class PythonPIEFragment {
   using vertex_map_t = typename fragment_t::vertex_map_t;
   using adj_list_t = PIEAdjList<fragment_t>;
 
+  // The edges of the inner vertices of a label along an edge label in CSR,
+  // with a neighbor given by its label and its offset in the vertices of
+  // that label.
+  struct BatchAdjList {
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> neighbors;
+    std::vector<label_id_t> neighbor_labels;
+  };
+
  public:
   PythonPIEFragment() = default;
   ~PythonPIEFragment() {}
@@ -134,6 +144,39 @@ class PythonPIEFragment {
   adj_list_t get_incoming_edges(const vertex_t& v, label_id_t e_label) {
     return adj_list_t(fragment_->GetIncomingAdjList(v, e_label));
   }
+
+  /**
+   * @brief The batch accessors of the edges, by which a Cython app takes the
+   * adjacency of all the inner vertices of v_label at once as typed memory
+   * views, e.g. <int64_t[:n + 1]> get_outgoing_offsets(v_label, e_label) for
+   * the n inner vertices, in place of a call per vertex and per edge.
+   *
+   * The edges of the inner vertex at offset i are [offsets[i],
+   * offsets[i + 1]) of the neighbors and the neighbor labels. The arrays are
+   * built on the first access and kept with the fragment.
+   */
+  const int64_t* get_outgoing_offsets(label_id_t v_label, label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, true).offsets.data();
+  }
+  const int64_t* get_outgoing_neighbors(label_id_t v_label,
+                                        label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, true).neighbors.data();
+  }
+  const label_id_t* get_outgoing_neighbor_labels(label_id_t v_label,
+                                                 label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, true).neighbor_labels.data();
+  }
+  const int64_t* get_incoming_offsets(label_id_t v_label, label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, false).offsets.data();
+  }
+  const int64_t* get_incoming_neighbors(label_id_t v_label,
+                                        label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, false).neighbors.data();
+  }
+  const label_id_t* get_incoming_neighbor_labels(label_id_t v_label,
+                                                 label_id_t e_label) {
+    return batch_adj_list(v_label, e_label, false).neighbor_labels.data();
+  }
   bool has_child(const vertex_t& v, label_id_t e_label) {
     return fragment_->HasChild(v, e_label);
   }
@@ -250,10 +293,45 @@ class PythonPIEFragment {
     return fragment_->GetVertexMap();
   }
 
-  void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
+  void set_fragment(const fragment_t* fragment) {
+    fragment_ = fragment;
+    batch_adj_lists_.clear();
+  }
 
  private:
+  BatchAdjList& batch_adj_list(label_id_t v_label, label_id_t e_label,
+                               bool outgoing) {
+    size_t index =
+        (static_cast<size_t>(v_label) * fragment_->edge_label_num() +
+         e_label) * 2 + (outgoing ? 0 : 1);
+    if (batch_adj_lists_.size() <= index) {
+      batch_adj_lists_.resize(
+          static_cast<size_t>(fragment_->vertex_label_num()) *
+          fragment_->edge_label_num() * 2);
+    }
+    auto& adj_list = batch_adj_lists_[index];
+    if (adj_list == nullptr) {
+      adj_list = std::make_shared<BatchAdjList>();
+      auto inner_vertices = fragment_->InnerVertices(v_label);
+      adj_list->offsets.reserve(inner_vertices.size() + 1);
+      adj_list->offsets.push_back(0);
+      for (auto v : inner_vertices) {
+        auto es = outgoing ? fragment_->GetOutgoingAdjList(v, e_label)
+                           : fragment_->GetIncomingAdjList(v, e_label);
+        for (auto& e : es) {
+          auto u = e.neighbor();
+          adj_list->neighbors.push_back(fragment_->vertex_offset(u));
+          adj_list->neighbor_labels.push_back(fragment_->vertex_label(u));
+        }
+        adj_list->offsets.push_back(
+            static_cast<int64_t>(adj_list->neighbors.size()));
+      }
+    }
+    return *adj_list;
+  }
+
   const fragment_t* fragment_;
+  std::vector<std::shared_ptr<BatchAdjList>> batch_adj_lists_;
 };
 
 template <typename FRAG_T, typename VD_T, typename MD_T>
@@ -314,6 +392,60 @@ class PythonPIEComputeContext {
     return partial_result_[label][v];
   }
 
+  /**
+   * @brief The values of all the vertices of label, inner ones first, by
+   * their offsets in the label, for a Cython app to read them as a typed
+   * memory view of get_nodes_num(label) elements. The values are not to be
+   * written through it, as set_node_values() marks them updated for the
+   * messages.
+   */
+  const VD_T* get_node_values(label_id_t label) {
+    auto vertices = fragment_->Vertices(label);
+    if (vertices.size() == 0) {
+      return nullptr;
+    }
+    return &partial_result_[label][*vertices.begin()];
+  }
+
+  /**
+   * @brief Sets the values of the num vertices of label from the offset
+   * begin on, as set_node_value() does for each of them.
+   */
+  void set_node_values(label_id_t label, int64_t begin, const VD_T* values,
+                       size_t num) {
+    auto& buffer = partial_result_[label];
+    vid_t first = fragment_->Vertices(label).begin_value();
+    for (size_t i = 0; i < num; ++i) {
+      buffer.SetValue(vertex_t(static_cast<vid_t>(first + begin + i)),
+                      values[i]);
+    }
+  }
+
+  /**
+   * @brief Sets the values of the vertices of label at the num offsets.
+   */
+  void set_node_values_at(label_id_t label, const int64_t* offsets,
+                          const VD_T* values, size_t num) {
+    auto& buffer = partial_result_[label];
+    vid_t first = fragment_->Vertices(label).begin_value();
+    for (size_t i = 0; i < num; ++i) {
+      buffer.SetValue(vertex_t(static_cast<vid_t>(first + offsets[i])),
+                      values[i]);
+    }
+  }
+
+  /**
+   * @brief Fills flags, of get_nodes_num(label) elements, with whether each
+   * vertex of label is updated, e.g. by the messages of the last round.
+   */
+  void get_updated(label_id_t label, uint8_t* flags) {
+    auto& buffer = partial_result_[label];
+    size_t i = 0;
+    for (auto v : fragment_->Vertices(label)) {
+      flags[i++] = buffer.IsUpdated(v) ? 1 : 0;
+    }
+  }
+
   void init_value(vertex_range_t vertices, label_id_t label, VD_T value,
                   const std::function<bool(MD_T*, MD_T&&)>& aggregator) {
     partial_result_[label].Init(vertices, value, aggregator);
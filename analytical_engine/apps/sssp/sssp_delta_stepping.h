@@ -0,0 +1,295 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
+#define ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/utils/trait_utils.h"
+#include "sssp/sssp_delta_stepping_context.h"
+
+namespace gs {
+
+/**
+ * @brief Single source shortest paths by delta-stepping (Meyer and Sanders,
+ * 2003). The vertices are kept by fragment in buckets of distance width
+ * delta, and the fragments agree on the lowest bucket with a vertex left.
+ *
+ * A fragment relaxes the light edges, of weight up to delta, of the vertices
+ * of the current bucket until the bucket is empty, without a superstep for
+ * the vertices it puts back into it. The bucket is settled once no fragment
+ * has sent a distance in a round, then the heavy edges of its vertices are
+ * relaxed once and the next bucket begins.
+ *
+ * If delta is not given, it is the maximum edge weight over the average
+ * degree, as suggested by Meyer and Sanders, and at least the lowest
+ * positive edge weight.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class SSSPDeltaStepping
+    : public grape::ParallelAppBase<FRAG_T, SSSPDeltaSteppingContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(SSSPDeltaStepping<FRAG_T>,
+                          SSSPDeltaSteppingContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using edata_t = typename fragment_t::edata_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    if (ctx.delta <= 0) {
+      ctx.delta = tuneDelta(frag);
+    }
+    VLOG(1) << "[frag-" << frag.fid() << "]: delta-stepping with delta "
+            << ctx.delta;
+
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      ctx.partial_result[source] = 0;
+      ctx.buckets[0].push_back(source);
+    }
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    std::vector<std::vector<vertex_t>> received(thread_num());
+    messages.ParallelProcess<fragment_t, double>(
+        thread_num(), frag,
+        [&ctx, &received](int tid, vertex_t u, double msg) {
+          if (msg < ctx.partial_result[u]) {
+            grape::atomic_min(ctx.partial_result[u], msg);
+            received[tid].push_back(u);
+          }
+        });
+    pushToBuckets(ctx, received);
+    step(frag, ctx, messages);
+  }
+
+ private:
+  template <typename EDGE_T>
+  static double edgeWeight(const EDGE_T& e) {
+    double w = 1.0;
+    vineyard::static_if<!std::is_same<edata_t, grape::EmptyType>{}>(
+        [](auto& e, auto& data) { data = static_cast<double>(e.get_data()); })(
+        e, w);
+    return w;
+  }
+
+  double tuneDelta(const fragment_t& frag) {
+    std::vector<double> max_weights(thread_num(), 0.0);
+    std::vector<double> min_weights(thread_num(),
+                                    std::numeric_limits<double>::max());
+    ForEach(frag.InnerVertices(),
+            [&frag, &max_weights, &min_weights](int tid, vertex_t u) {
+              for (auto& e : frag.GetOutgoingAdjList(u)) {
+                double w = edgeWeight(e);
+                max_weights[tid] = std::max(max_weights[tid], w);
+                if (w > 0) {
+                  min_weights[tid] = std::min(min_weights[tid], w);
+                }
+              }
+            });
+    size_t local_edges = 0, edges = 0;
+    for (auto& v : frag.InnerVertices()) {
+      local_edges += frag.GetLocalOutDegree(v);
+    }
+    double max_weight, min_weight;
+    Max(*std::max_element(max_weights.begin(), max_weights.end()), max_weight);
+    Min(*std::min_element(min_weights.begin(), min_weights.end()), min_weight);
+    Sum(local_edges, edges);
+    if (edges == 0 || max_weight <= 0) {
+      return 1.0;
+    }
+    double avg_degree = static_cast<double>(edges) /
+                        std::max<size_t>(frag.GetTotalVerticesNum(), 1);
+    return std::max(max_weight / std::max(avg_degree, 1.0), min_weight);
+  }
+
+  void pushToBuckets(context_t& ctx,
+                     std::vector<std::vector<vertex_t>>& vertices) {
+    for (auto& thread_vertices : vertices) {
+      for (auto& v : thread_vertices) {
+        ctx.buckets[ctx.BucketOf(ctx.partial_result[v])].push_back(v);
+      }
+      thread_vertices.clear();
+    }
+  }
+
+  // The lowest bucket with a vertex still in it, dropping the buckets before
+  // it whose vertices have all moved to lower ones.
+  int64_t nextBucket(context_t& ctx) {
+    while (!ctx.buckets.empty()) {
+      auto iter = ctx.buckets.begin();
+      for (auto& v : iter->second) {
+        if (ctx.BucketOf(ctx.partial_result[v]) == iter->first) {
+          return iter->first;
+        }
+      }
+      ctx.buckets.erase(iter);
+    }
+    return std::numeric_limits<int64_t>::max();
+  }
+
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    if (ctx.bucket_settled) {
+      int64_t bucket;
+      Min(nextBucket(ctx), bucket);
+      if (bucket == std::numeric_limits<int64_t>::max()) {
+        return;
+      }
+      ctx.curr_bucket = bucket;
+      ctx.bucket_settled = false;
+    }
+
+    relaxLightEdges(frag, ctx);
+    size_t sent = 0;
+    Sum(syncOuterVertices(frag, ctx, messages), sent);
+    if (sent == 0) {
+      relaxHeavyEdges(frag, ctx);
+      syncOuterVertices(frag, ctx, messages);
+      ctx.bucket_settled = true;
+    }
+    messages.ForceContinue();
+  }
+
+  // Lowers the distance of v to distance through an edge of the current
+  // bucket, an inner v joins the next frontier if it stays in the bucket.
+  inline void relax(const fragment_t& frag, context_t& ctx, vertex_t v,
+                    double distance, std::vector<vertex_t>& next_frontier,
+                    std::vector<vertex_t>& later) {
+    if (distance >= ctx.partial_result[v]) {
+      return;
+    }
+    grape::atomic_min(ctx.partial_result[v], distance);
+    if (frag.IsOuterVertex(v)) {
+      ctx.updated.Insert(v);
+    } else if (ctx.BucketOf(distance) != ctx.curr_bucket) {
+      later.push_back(v);
+    } else if (ctx.in_frontier.InsertWithRet(v)) {
+      next_frontier.push_back(v);
+    }
+  }
+
+  void relaxLightEdges(const fragment_t& frag, context_t& ctx) {
+    auto iter = ctx.buckets.find(ctx.curr_bucket);
+    if (iter == ctx.buckets.end()) {
+      return;
+    }
+    std::vector<vertex_t> frontier;
+    for (auto& v : iter->second) {
+      if (ctx.BucketOf(ctx.partial_result[v]) == ctx.curr_bucket &&
+          ctx.in_frontier.InsertWithRet(v)) {
+        frontier.push_back(v);
+      }
+    }
+    ctx.buckets.erase(iter);
+
+    std::vector<std::vector<vertex_t>> next_frontiers(thread_num());
+    std::vector<std::vector<vertex_t>> later(thread_num());
+    std::vector<std::vector<vertex_t>> settled(thread_num());
+    while (!frontier.empty()) {
+      ForEach(
+          frontier.begin(), frontier.end(),
+          [&](int tid, vertex_t u) {
+            ctx.in_frontier.Erase(u);
+            if (ctx.settled.InsertWithRet(u)) {
+              settled[tid].push_back(u);
+            }
+            double distu = ctx.partial_result[u];
+            for (auto& e : frag.GetOutgoingAdjList(u)) {
+              double w = edgeWeight(e);
+              if (w <= ctx.delta) {
+                relax(frag, ctx, e.get_neighbor(), distu + w,
+                      next_frontiers[tid], later[tid]);
+              }
+            }
+          },
+          64);
+      frontier.clear();
+      for (auto& vertices : next_frontiers) {
+        frontier.insert(frontier.end(), vertices.begin(), vertices.end());
+        vertices.clear();
+      }
+    }
+    pushToBuckets(ctx, later);
+    for (auto& vertices : settled) {
+      ctx.settled_vertices.insert(ctx.settled_vertices.end(), vertices.begin(),
+                                  vertices.end());
+    }
+  }
+
+  void relaxHeavyEdges(const fragment_t& frag, context_t& ctx) {
+    std::vector<std::vector<vertex_t>> later(thread_num());
+    ForEach(
+        ctx.settled_vertices.begin(), ctx.settled_vertices.end(),
+        [&frag, &ctx, &later](int tid, vertex_t u) {
+          double distu = ctx.partial_result[u];
+          for (auto& e : frag.GetOutgoingAdjList(u)) {
+            double w = edgeWeight(e);
+            auto v = e.get_neighbor();
+            if (w > ctx.delta && distu + w < ctx.partial_result[v]) {
+              grape::atomic_min(ctx.partial_result[v], distu + w);
+              if (frag.IsOuterVertex(v)) {
+                ctx.updated.Insert(v);
+              } else {
+                later[tid].push_back(v);
+              }
+            }
+          }
+        },
+        64);
+    pushToBuckets(ctx, later);
+    for (auto& u : ctx.settled_vertices) {
+      ctx.settled.Erase(u);
+    }
+    ctx.settled_vertices.clear();
+  }
+
+  // Sends the distances of the outer vertices lowered since the last call,
+  // returns how many were sent.
+  size_t syncOuterVertices(const fragment_t& frag, context_t& ctx,
+                           message_manager_t& messages) {
+    auto& channels = messages.Channels();
+    std::vector<size_t> sent(thread_num(), 0);
+    ForEach(ctx.updated, frag.OuterVertices(),
+            [&channels, &frag, &ctx, &sent](int tid, vertex_t v) {
+              channels[tid].SyncStateOnOuterVertex<fragment_t, double>(
+                  frag, v, ctx.partial_result[v]);
+              ++sent[tid];
+            });
+    ctx.updated.ParallelClear(GetThreadPool());
+    size_t total = 0;
+    for (auto n : sent) {
+      total += n;
+    }
+    return total;
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
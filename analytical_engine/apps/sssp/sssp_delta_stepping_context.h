@@ -0,0 +1,101 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
+
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class SSSPDeltaSteppingContext
+    : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit SSSPDeltaSteppingContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        partial_result(this->data()) {}
+
+  /**
+   * @param delta The width of a bucket, or 0 to derive it from the edge
+   * weights.
+   */
+  void Init(grape::ParallelMessageManager& messages, oid_t source_id,
+            double delta = 0) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    this->source_id = source_id;
+    this->delta = delta;
+    partial_result.Init(vertices, std::numeric_limits<double>::max());
+    settled.Init(frag.InnerVertices());
+    in_frontier.Init(frag.InnerVertices());
+    updated.Init(vertices);
+    buckets.clear();
+    curr_bucket = 0;
+    bucket_settled = true;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      double d = partial_result[v];
+      if (d == std::numeric_limits<double>::max()) {
+        os << frag.GetId(v) << " infinity" << std::endl;
+      } else {
+        os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+           << d << std::endl;
+      }
+    }
+  }
+
+  int64_t BucketOf(double distance) const {
+    return static_cast<int64_t>(distance / delta);
+  }
+
+  oid_t source_id;
+  double delta;
+  typename FRAG_T::template vertex_array_t<double>& partial_result;
+
+  // The inner vertices by bucket, a vertex may stay in the buckets it has
+  // left for a lower one, and is skipped there.
+  std::map<int64_t, std::vector<vertex_t>> buckets;
+  int64_t curr_bucket;
+  // Whether no fragment has a vertex of the current bucket left, so that
+  // the heavy edges of its vertices are relaxed and the next bucket begins.
+  bool bucket_settled;
+  // The inner vertices of the current bucket whose light edges are relaxed,
+  // their heavy edges are relaxed once the bucket is settled.
+  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> settled;
+  std::vector<vertex_t> settled_vertices;
+  grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> in_frontier;
+  // The vertices whose distances dropped, the outer ones are sent.
+  grape::DenseVertexSet<typename FRAG_T::vertices_t> updated;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
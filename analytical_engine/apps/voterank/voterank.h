@@ -145,33 +145,39 @@ class VoteRank : public grape::ParallelAppBase<FRAG_T, VoteRankContext<FRAG_T>>,
       }
     };
 
-    //  pull weights from neighbors and compute new scores
-    std::vector<std::tuple<double, size_t, vid_t>> max_scores(thread_num(),
-                                                              {0, 0, {}});
-    ForEach(inner_vertices,
-            [&ctx, compare, &max_scores, &frag](int tid, vertex_t u) {
-              if (ctx.update.Exist(u) && ctx.rank[u] == 0) {
+    //  pull weights from neighbors and compute new scores of the vertices
+    //  whose out-neighbors changed weights
+    std::vector<std::vector<entry_t>> updated(thread_num());
+    ForEach(ctx.update, inner_vertices,
+            [&ctx, &updated, &frag](int tid, vertex_t u) {
+              if (ctx.rank[u] == 0) {
                 double cur = 0;
                 auto es = frag.GetOutgoingAdjList(u);
                 for (auto& e : es) {
                   cur += ctx.weight[e.get_neighbor()];
                 }
                 ctx.scores[u] = cur;
+                updated[tid].push_back(
+                    {cur, std::hash<oid_t>()(frag.GetId(u)), u});
               }
-              compare(max_scores[tid],
-                      {ctx.scores[u], std::hash<oid_t>()(frag.GetId(u)),
-                       frag.Vertex2Gid(u)});
             });
 
-    ctx.update.Clear();
+    ctx.update.ParallelClear(GetThreadPool());
 
 #ifdef PROFILING
     ctx.exec_time += GetCurrentTime();
     ctx.postprocess_time -= GetCurrentTime();
 #endif
-    for (auto& a : max_scores) {
-      compare(ctx.max_score, a);
+    for (auto& vec : updated) {
+      for (auto& entry : vec) {
+        ctx.heap.push_back(entry);
+        std::push_heap(ctx.heap.begin(), ctx.heap.end());
+      }
     }
+    if (ctx.heap.size() > 2 * inner_vertices.size()) {
+      compactHeap(ctx);
+    }
+    ctx.max_score = localMaxScore(frag, ctx, compare);
     auto max_score = ctx.max_score;
     // select top node
     AllReduce(max_score, ctx.max_score, compare);
@@ -224,6 +230,52 @@ class VoteRank : public grape::ParallelAppBase<FRAG_T, VoteRankContext<FRAG_T>>,
 #endif
     messages.ForceContinue();
   }
+
+ private:
+  using entry_t = typename context_t::ScoreEntry;
+
+  static bool isStale(const context_t& ctx, const entry_t& entry) {
+    return ctx.rank[entry.v] != 0 || ctx.scores[entry.v] != entry.score;
+  }
+
+  static void compactHeap(context_t& ctx) {
+    auto& heap = ctx.heap;
+    heap.erase(std::remove_if(heap.begin(), heap.end(),
+                              [&ctx](const entry_t& entry) {
+                                return isStale(ctx, entry);
+                              }),
+               heap.end());
+    std::make_heap(heap.begin(), heap.end());
+  }
+
+  // The highest score among the inner vertices, folding the scores within
+  // the tolerance of compare from the top of the heap, as a scan of all the
+  // vertices would.
+  template <typename COMPARE_T>
+  static std::tuple<double, size_t, vid_t> localMaxScore(
+      const fragment_t& frag, context_t& ctx, const COMPARE_T& compare) {
+    const double EPS = 1e-8;
+    auto& heap = ctx.heap;
+    std::tuple<double, size_t, vid_t> ret{0, 0, {}};
+    std::vector<entry_t> candidates;
+    while (!heap.empty()) {
+      const entry_t& top = heap.front();
+      if (!candidates.empty() && top.score < candidates[0].score - EPS) {
+        break;
+      }
+      if (!isStale(ctx, top)) {
+        candidates.push_back(top);
+      }
+      std::pop_heap(heap.begin(), heap.end());
+      heap.pop_back();
+    }
+    for (auto& entry : candidates) {
+      compare(ret, {entry.score, entry.hash, frag.Vertex2Gid(entry.v)});
+      heap.push_back(entry);
+      std::push_heap(heap.begin(), heap.end());
+    }
+    return ret;
+  }
 };
 
 }  // namespace gs
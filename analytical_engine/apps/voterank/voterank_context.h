@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <iomanip>
 #include <tuple>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -30,8 +31,21 @@ namespace gs {
 template <typename FRAG_T>
 class VoteRankContext : public grape::VertexDataContext<FRAG_T, int> {
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
 
  public:
+  // The score of an inner vertex with the hash of its id, the higher score
+  // and then the lower hash being preferred.
+  struct ScoreEntry {
+    double score;
+    size_t hash;
+    vertex_t v;
+
+    bool operator<(const ScoreEntry& rhs) const {
+      return score < rhs.score || (score == rhs.score && hash > rhs.hash);
+    }
+  };
+
   explicit VoteRankContext(const FRAG_T& fragment)
       : grape::VertexDataContext<FRAG_T, int32_t>(fragment),
         rank(this->data()) {}
@@ -47,6 +61,7 @@ class VoteRankContext : public grape::VertexDataContext<FRAG_T, int> {
     weight.Init(vertices);
     scores.Init(vertices);
     update.Init(inner_vertices);
+    heap.clear();
     step = 0;
     avg_degree = 0;
 
@@ -74,6 +89,10 @@ class VoteRankContext : public grape::VertexDataContext<FRAG_T, int> {
   typename FRAG_T::template vertex_array_t<double> weight;
   typename FRAG_T::template vertex_array_t<double> scores;
   grape::DenseVertexSet<typename FRAG_T::inner_vertices_t> update;
+  // A max-heap of the scores of the unelected inner vertices. The entry of a
+  // vertex is pushed whenever its score is computed, and the stale ones are
+  // dropped when they reach the top.
+  std::vector<ScoreEntry> heap;
 
 #ifdef PROFILING
   double preprocess_time = 0;
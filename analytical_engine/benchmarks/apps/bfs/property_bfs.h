@@ -17,6 +17,7 @@
 #define ANALYTICAL_ENGINE_BENCHMARKS_APPS_BFS_PROPERTY_BFS_H_
 
 #include <limits>
+#include <memory>
 
 #include "grape/grape.h"
 
@@ -77,6 +78,11 @@ class PropertyBFS
     using depth_type = typename context_t::depth_type;
 
     messages.InitChannels(thread_num(), 2 * 1023 * 64, 2 * 1024 * 64);
+    // A vertex reached twice in a round is sent once.
+    using vid_t = typename fragment_t::vid_t;
+    messages.SetMessageCodec(
+        std::make_shared<DeltaVarintCodec<vid_t, grape::EmptyType>>(
+            [](grape::EmptyType&, const grape::EmptyType&) {}));
 
     ctx.current_depth = 1;
 
@@ -91,6 +91,9 @@ class PropertySSSP
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     messages.InitChannels(thread_num());
+    using vid_t = typename fragment_t::vid_t;
+    messages.SetMessageCodec(std::make_shared<DeltaVarintCodec<vid_t, double>>(
+        [](double& lhs, const double& rhs) { lhs = std::min(lhs, rhs); }));
 
     vertex_t source;
     bool native_source = frag.GetInnerVertex(0, ctx.source_id, source);
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_PROPERTY_WCC_H_
 #define ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_PROPERTY_WCC_H_
 
+#include <algorithm>
 #include <limits>
+#include <memory>
 
 #include "grape/grape.h"
 
@@ -115,6 +117,8 @@ class PropertyWCC
     auto outer_vertices = frag.OuterVertices(0);
 
     messages.InitChannels(thread_num());
+    messages.SetMessageCodec(std::make_shared<DeltaVarintCodec<vid_t, vid_t>>(
+        [](vid_t& lhs, const vid_t& rhs) { lhs = std::min(lhs, rhs); }));
 
     ForEach(inner_vertices, [&frag, &ctx](int tid, vertex_t v) {
       ctx.comp_id[v] = frag.GetInnerVertexGid(v);
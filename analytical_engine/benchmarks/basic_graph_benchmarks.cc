@@ -13,9 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include <cstdio>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "boost/lexical_cast.hpp"
 #include "glog/logging.h"
@@ -31,6 +33,7 @@ limitations under the License.
 #include "benchmarks/apps/pagerank/pagerank.h"
 #include "benchmarks/apps/sssp/sssp.h"
 #include "benchmarks/apps/wcc/wcc.h"
+#include "benchmarks/benchmark_utils.h"
 
 using EmptyGraphType =
     grape::ImmutableEdgecutFragment<vineyard::property_graph_types::OID_TYPE,
@@ -49,32 +52,21 @@ void LoadAndRunApp(const grape::CommSpec& comm_spec, const std::string& efile,
                    const std::string& vfile, bool directed,
                    const grape::ParallelEngineSpec& parallel_spec,
                    const std::string& serial_prefix,
-                   const std::string& out_prefix, Args... args) {
+                   const std::string& out_prefix,
+                   gs::benchmarks::BenchmarkReport& report, Args... args) {
   grape::LoadGraphSpec graph_spec = grape::DefaultLoadGraphSpec();
   graph_spec.set_directed(directed);
   graph_spec.set_deserialize(true, serial_prefix);
   graph_spec.set_rebalance(false, 0);
 
   std::shared_ptr<GRAPH_T> fragment;
+  double t0 = grape::GetCurrentTime();
   fragment = grape::LoadGraph<GRAPH_T>(efile, vfile, comm_spec, graph_spec);
+  report.SetLoadTime(grape::GetCurrentTime() - t0);
 
-  auto app = std::make_shared<APP_T>();
-
-  auto worker = APP_T::CreateWorker(app, fragment);
-  worker->Init(comm_spec, parallel_spec);
-  double t0 = grape::GetCurrentTime();
-  worker->Query(std::forward<Args>(args)...);
-  double t1 = grape::GetCurrentTime();
-  LOG(INFO) << "[worker-" << comm_spec.worker_id()
-            << "]: Query time: " << t1 - t0;
-
-  std::ofstream ostream;
-  std::string output_path =
-      grape::GetResultFilename(out_prefix, fragment->fid());
-  ostream.open(output_path);
-  worker->Output(ostream);
-  ostream.close();
-  worker->Finalize();
+  gs::benchmarks::RunBenchmark<APP_T>(fragment, comm_spec, parallel_spec,
+                                      out_prefix, report,
+                                      std::forward<Args>(args)...);
 }
 
 int main(int argc, char** argv) {
@@ -98,6 +90,9 @@ int main(int argc, char** argv) {
   comm_spec.Init(MPI_COMM_WORLD);
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(
+      comm_spec, parallel_spec, "basic_graph_benchmarks", app_name,
+      std::vector<std::string>(argv + std::min(argc, 6), argv + argc));
 
   if (app_name == "sssp") {
     CHECK_GE(argc, 7);
@@ -105,7 +100,7 @@ int main(int argc, char** argv) {
 
     LoadAndRunApp<EDGraphType, gs::benchmarks::SSSP<EDGraphType>>(
         comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_sssp",
+        "./output_or_sssp", report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "bfs") {
     CHECK_GE(argc, 7);
@@ -113,12 +108,12 @@ int main(int argc, char** argv) {
 
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::BFS<EmptyGraphType>>(
         comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_bfs",
+        "./output_or_bfs", report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::WCC<EmptyGraphType>>(
         comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_wcc");
+        "./output_or_wcc", report);
   } else if (app_name == "pr") {
     CHECK_GE(argc, 8);
     std::string delta = argv[6];
@@ -126,7 +121,7 @@ int main(int argc, char** argv) {
 
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::PageRank<EmptyGraphType>>(
         comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_pr", boost::lexical_cast<double>(delta),
+        "./output_or_pr", report, boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
   }
 
@@ -0,0 +1,318 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_UTILS_H_
+#define ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_UTILS_H_
+
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "grape/util.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+/**
+ * @brief The hardware counters of the calling thread and of the threads it
+ * spawns afterwards, e.g. the thread pool of a worker, by perf_event_open.
+ *
+ * The counts of a spawned thread are folded in once it exits, so the
+ * counters are read after the worker is destroyed. A counter that can not be
+ * opened, e.g. off Linux or under a strict perf_event_paranoid, reads 0.
+ */
+class PerfCounters {
+ public:
+  enum Counter { kCycles, kInstructions, kLLCMisses, kCounterNum };
+
+  PerfCounters() {
+    std::fill(fds_, fds_ + kCounterNum, -1);
+    std::fill(values_, values_ + kCounterNum, 0);
+#ifdef __linux__
+    const uint64_t configs[kCounterNum] = {PERF_COUNT_HW_CPU_CYCLES,
+                                           PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_MISSES};
+    for (int i = 0; i < kCounterNum; ++i) {
+      struct perf_event_attr attr {};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.disabled = 1;
+      attr.inherit = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = static_cast<int>(
+          syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+  }
+
+  ~PerfCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  void Start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  void Stop() {
+#ifdef __linux__
+    for (int i = 0; i < kCounterNum; ++i) {
+      if (fds_[i] >= 0) {
+        ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (read(fds_[i], &value, sizeof(value)) == sizeof(value)) {
+          values_[i] = value;
+        }
+      }
+    }
+#endif
+  }
+
+  bool available() const {
+    return std::any_of(fds_, fds_ + kCounterNum,
+                       [](int fd) { return fd >= 0; });
+  }
+
+  uint64_t value(Counter counter) const { return values_[counter]; }
+
+ private:
+  int fds_[kCounterNum];
+  uint64_t values_[kCounterNum];
+};
+
+/**
+ * @brief The peak resident memory of the process in KB.
+ */
+inline uint64_t PeakMemoryKB() {
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+}
+
+/**
+ * @brief The result of a benchmark, reduced over the workers, written by
+ * worker 0 as a line of JSON to the file GS_BENCHMARK_REPORT names, so that
+ * the reports of two releases can be compared by compare_reports.py.
+ *
+ * Each run gives the slowest and the fastest query time among the workers,
+ * the gap between which is the time the workers wait for each other, and
+ * the hardware counters summed over the workers.
+ */
+class BenchmarkReport {
+ public:
+  BenchmarkReport(const grape::CommSpec& comm_spec,
+                  const grape::ParallelEngineSpec& parallel_spec,
+                  std::string benchmark, std::string app,
+                  std::vector<std::string> args)
+      : comm_spec_(comm_spec),
+        thread_num_(parallel_spec.thread_num),
+        benchmark_(std::move(benchmark)),
+        app_(std::move(app)),
+        args_(std::move(args)) {}
+
+  /**
+   * @brief The number of runs of a query, from GS_BENCHMARK_REPEAT, 1 by
+   * default.
+   */
+  static int Repeat() {
+    const char* repeat = getenv("GS_BENCHMARK_REPEAT");
+    return repeat == nullptr ? 1 : std::max(atoi(repeat), 1);
+  }
+
+  template <typename FRAG_T>
+  void SetGraph(const FRAG_T& frag) {
+    uint64_t local_edges = frag.GetEdgeNum(), edges = 0;
+    MPI_Allreduce(&local_edges, &edges, 1, MPI_UINT64_T, MPI_SUM,
+                  comm_spec_.comm());
+    vertex_num_ = frag.GetTotalVerticesNum();
+    edge_num_ = edges;
+  }
+
+  void SetLoadTime(double load_time) {
+    MPI_Allreduce(&load_time, &load_time_, 1, MPI_DOUBLE, MPI_MAX,
+                  comm_spec_.comm());
+  }
+
+  void AddRun(double query_time, const PerfCounters& counters) {
+    Run run;
+    MPI_Allreduce(&query_time, &run.max_time, 1, MPI_DOUBLE, MPI_MAX,
+                  comm_spec_.comm());
+    MPI_Allreduce(&query_time, &run.min_time, 1, MPI_DOUBLE, MPI_MIN,
+                  comm_spec_.comm());
+    uint64_t local[PerfCounters::kCounterNum];
+    for (int i = 0; i < PerfCounters::kCounterNum; ++i) {
+      local[i] = counters.value(static_cast<PerfCounters::Counter>(i));
+    }
+    MPI_Allreduce(local, run.counters, PerfCounters::kCounterNum,
+                  MPI_UINT64_T, MPI_SUM, comm_spec_.comm());
+    runs_.push_back(run);
+  }
+
+  void Write() {
+    uint64_t local_memory = PeakMemoryKB(), memory = 0;
+    MPI_Allreduce(&local_memory, &memory, 1, MPI_UINT64_T, MPI_MAX,
+                  comm_spec_.comm());
+    if (comm_spec_.worker_id() != grape::kCoordinatorRank) {
+      return;
+    }
+
+    std::ostringstream os;
+    os << "{\"benchmark\": " << quote(benchmark_)
+       << ", \"app\": " << quote(app_) << ", \"args\": [";
+    for (size_t i = 0; i < args_.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << quote(args_[i]);
+    }
+    os << "], \"timestamp\": " << time(nullptr)
+       << ", \"worker_num\": " << comm_spec_.worker_num()
+       << ", \"thread_num\": " << thread_num_
+       << ", \"vertex_num\": " << vertex_num_
+       << ", \"edge_num\": " << edge_num_ << ", \"load_time\": " << load_time_
+       << ", \"peak_memory_kb\": " << memory << ", \"runs\": [";
+    for (size_t i = 0; i < runs_.size(); ++i) {
+      auto& run = runs_[i];
+      os << (i == 0 ? "" : ", ") << "{\"max_time\": " << run.max_time
+         << ", \"min_time\": " << run.min_time
+         << ", \"cycles\": " << run.counters[PerfCounters::kCycles]
+         << ", \"instructions\": " << run.counters[PerfCounters::kInstructions]
+         << ", \"llc_misses\": " << run.counters[PerfCounters::kLLCMisses]
+         << "}";
+    }
+    os << "]}";
+
+    LOG(INFO) << "Benchmark report: " << os.str();
+    const char* path = getenv("GS_BENCHMARK_REPORT");
+    if (path != nullptr) {
+      std::ofstream report(path, std::ios::app);
+      report << os.str() << std::endl;
+    }
+  }
+
+ private:
+  struct Run {
+    double max_time;
+    double min_time;
+    uint64_t counters[PerfCounters::kCounterNum];
+  };
+
+  static std::string quote(const std::string& str) {
+    std::string quoted = "\"";
+    for (char c : str) {
+      if (c == '"' || c == '\\') {
+        quoted.push_back('\\');
+      }
+      quoted.push_back(c);
+    }
+    return quoted + "\"";
+  }
+
+  const grape::CommSpec& comm_spec_;
+  uint32_t thread_num_;
+  std::string benchmark_;
+  std::string app_;
+  std::vector<std::string> args_;
+  uint64_t vertex_num_ = 0;
+  uint64_t edge_num_ = 0;
+  double load_time_ = 0;
+  std::vector<Run> runs_;
+};
+
+/**
+ * @brief Runs APP_T on fragment Repeat() times, each by a worker of its own
+ * whose threads the hardware counters of the run cover, and writes the
+ * result of the last run by out_prefix.
+ */
+template <typename APP_T, typename FRAG_T, typename... Args>
+void RunBenchmark(std::shared_ptr<FRAG_T> fragment,
+                  const grape::CommSpec& comm_spec,
+                  const grape::ParallelEngineSpec& parallel_spec,
+                  const std::string& out_prefix, BenchmarkReport& report,
+                  Args... args) {
+  report.SetGraph(*fragment);
+  int repeat = BenchmarkReport::Repeat();
+  for (int round = 0; round < repeat; ++round) {
+    PerfCounters counters;
+    double query_time;
+    counters.Start();
+    {
+      auto app = std::make_shared<APP_T>();
+      auto worker = APP_T::CreateWorker(app, fragment);
+      worker->Init(comm_spec, parallel_spec);
+      MPI_Barrier(comm_spec.comm());
+      double t0 = grape::GetCurrentTime();
+      worker->Query(args...);
+      query_time = grape::GetCurrentTime() - t0;
+      LOG(INFO) << "[worker-" << comm_spec.worker_id()
+                << "]: Query time: " << query_time;
+
+      if (round + 1 == repeat) {
+        std::ofstream ostream;
+        std::string output_path =
+            grape::GetResultFilename(out_prefix, fragment->fid());
+        ostream.open(output_path);
+        worker->Output(ostream);
+        ostream.close();
+      }
+      worker->Finalize();
+    }
+    counters.Stop();
+    report.AddRun(query_time, counters);
+  }
+  report.Write();
+}
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_UTILS_H_
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""Compares the reports of the benchmark drivers of two releases.
+
+A driver appends a line of JSON per benchmark to the file named by
+GS_BENCHMARK_REPORT, and runs each query GS_BENCHMARK_REPEAT times, e.g.
+
+    GS_BENCHMARK_REPORT=new.jsonl GS_BENCHMARK_REPEAT=5 mpirun -n 4 \\
+        ./basic_graph_benchmarks p2p-31.e p2p-31.v 1 pr /tmp/serial 0.85 10
+
+The benchmarks of the two reports are matched by driver, app, arguments and
+the numbers of workers and threads, and compared by the median of the query
+time of their runs, i.e. the time of the slowest worker. The script exits
+with 1 if any of them is slower than the baseline by more than the threshold.
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+
+def load(path):
+    benchmarks = {}
+    with open(path, "r") as f:
+        for line in f:
+            if not line.strip():
+                continue
+            report = json.loads(line)
+            key = (
+                report["benchmark"],
+                report["app"],
+                tuple(report["args"]),
+                report["worker_num"],
+                report["thread_num"],
+            )
+            # the latest report of a benchmark wins
+            benchmarks[key] = report
+    return benchmarks
+
+
+def median(report, field):
+    return statistics.median(run[field] for run in report["runs"])
+
+
+def ratio(new, old):
+    return new / old if old else float("nan")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="the report of the baseline release")
+    parser.add_argument("candidate", help="the report of the release to check")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.05,
+        help="the slowdown of the median query time taken as a regression",
+    )
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+    regressions = 0
+    print(
+        "%-60s %10s %10s %8s %8s %8s"
+        % ("benchmark", "base(s)", "new(s)", "time", "llc", "memory")
+    )
+    for key in sorted(candidate, key=str):
+        if key not in baseline:
+            continue
+        old, new = baseline[key], candidate[key]
+        old_time, new_time = median(old, "max_time"), median(new, "max_time")
+        slowdown = ratio(new_time, old_time)
+        name = "%s %s %s w%d t%d" % (key[0], key[1], " ".join(key[2]), *key[3:])
+        print(
+            "%-60s %10.4f %10.4f %8.3f %8.3f %8.3f %s"
+            % (
+                name[:60],
+                old_time,
+                new_time,
+                slowdown,
+                ratio(median(new, "llc_misses"), median(old, "llc_misses")),
+                ratio(new["peak_memory_kb"], old["peak_memory_kb"]),
+                "REGRESSION" if slowdown > 1 + args.threshold else "",
+            )
+        )
+        if slowdown > 1 + args.threshold:
+            regressions += 1
+    for key in sorted(set(baseline) - set(candidate), key=str):
+        print("missing from the candidate: %s" % (key,))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -46,24 +46,11 @@ using EDProjectedGraphType =
 template <typename GRAPH_T, typename APP_T, typename... Args>
 void RunApp(std::shared_ptr<GRAPH_T> fragment, const grape::CommSpec& comm_spec,
             const grape::ParallelEngineSpec& parallel_spec,
-            const std::string& out_prefix, Args... args) {
-  auto app = std::make_shared<APP_T>();
-
-  auto worker = APP_T::CreateWorker(app, fragment);
-  worker->Init(comm_spec, parallel_spec);
-  double t0 = grape::GetCurrentTime();
-  worker->Query(std::forward<Args>(args)...);
-  double t1 = grape::GetCurrentTime();
-  LOG(INFO) << "[worker-" << comm_spec.worker_id()
-            << "]: Query time: " << t1 - t0;
-
-  std::ofstream ostream;
-  std::string output_path =
-      grape::GetResultFilename(out_prefix, fragment->fid());
-  ostream.open(output_path);
-  worker->Output(ostream);
-  ostream.close();
-  worker->Finalize();
+            const std::string& out_prefix,
+            gs::benchmarks::BenchmarkReport& report, Args... args) {
+  gs::benchmarks::RunBenchmark<APP_T>(fragment, comm_spec, parallel_spec,
+                                      out_prefix, report,
+                                      std::forward<Args>(args)...);
 }
 
 int main(int argc, char** argv) {
@@ -94,6 +81,9 @@ int main(int argc, char** argv) {
   MPI_Barrier(comm_spec.comm());
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(
+      comm_spec, parallel_spec, "projected_graph_benchmarks", app_name,
+      std::vector<std::string>(argv + basic_argc, argv + argc));
 
   if (app_name == "bfs") {
     CHECK_GE(argc, basic_argc + 1);
@@ -105,6 +95,7 @@ int main(int argc, char** argv) {
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::BFS<EmptyProjectedGraphType>>(
         projected_fragment, comm_spec, parallel_spec, "./output_pb_bfs/",
+        report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "sssp") {
     CHECK_GE(argc, basic_argc + 1);
@@ -115,6 +106,7 @@ int main(int argc, char** argv) {
 
     RunApp<EDProjectedGraphType, gs::benchmarks::SSSP<EDProjectedGraphType>>(
         projected_fragment, comm_spec, parallel_spec, "./output_pb_sssp/",
+        report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     std::shared_ptr<EmptyProjectedGraphType> projected_fragment =
@@ -123,7 +115,8 @@ int main(int argc, char** argv) {
 
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::WCC<EmptyProjectedGraphType>>(
-        projected_fragment, comm_spec, parallel_spec, "./output_pb_wcc/");
+        projected_fragment, comm_spec, parallel_spec, "./output_pb_wcc/",
+        report);
   } else if (app_name == "pr") {
     CHECK_GE(argc, basic_argc + 2);
     std::string delta = argv[basic_argc];
@@ -135,7 +128,7 @@ int main(int argc, char** argv) {
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::PageRank<EmptyProjectedGraphType>>(
         projected_fragment, comm_spec, parallel_spec, "./output_pb_pr/",
-        boost::lexical_cast<double>(delta),
+        report, boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
   }
 
@@ -40,24 +40,11 @@ template <typename APP_T, typename... Args>
 void RunApp(std::shared_ptr<GraphType> fragment,
             const grape::CommSpec& comm_spec,
             const grape::ParallelEngineSpec& parallel_spec,
-            const std::string& out_prefix, Args... args) {
-  auto app = std::make_shared<APP_T>();
-
-  auto worker = APP_T::CreateWorker(app, fragment);
-  worker->Init(comm_spec, parallel_spec);
-  double t0 = grape::GetCurrentTime();
-  worker->Query(std::forward<Args>(args)...);
-  double t1 = grape::GetCurrentTime();
-  LOG(INFO) << "[worker-" << comm_spec.worker_id()
-            << "]: Query time: " << t1 - t0;
-
-  std::ofstream ostream;
-  std::string output_path =
-      grape::GetResultFilename(out_prefix, fragment->fid());
-  ostream.open(output_path);
-  worker->Output(ostream);
-  ostream.close();
-  worker->Finalize();
+            const std::string& out_prefix,
+            gs::benchmarks::BenchmarkReport& report, Args... args) {
+  gs::benchmarks::RunBenchmark<APP_T>(fragment, comm_spec, parallel_spec,
+                                      out_prefix, report,
+                                      std::forward<Args>(args)...);
 }
 
 int main(int argc, char** argv) {
@@ -91,28 +78,31 @@ int main(int argc, char** argv) {
       std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(
+      comm_spec, parallel_spec, "property_graph_benchmarks", app_name,
+      std::vector<std::string>(argv + basic_argc, argv + argc));
 
   if (app_name == "bfs") {
     CHECK_GE(argc, basic_argc + 1);
     std::string root = argv[basic_argc];
     RunApp<gs::benchmarks::PropertyBFS<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_bfs/",
+        fragment, comm_spec, parallel_spec, "./output_pp_bfs/", report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "sssp") {
     CHECK_GE(argc, basic_argc + 1);
     std::string root = argv[basic_argc];
     RunApp<gs::benchmarks::PropertySSSP<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_sssp/",
+        fragment, comm_spec, parallel_spec, "./output_pp_sssp/", report,
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     RunApp<gs::benchmarks::PropertyWCC<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_wcc/");
+        fragment, comm_spec, parallel_spec, "./output_pp_wcc/", report);
   } else if (app_name == "pr") {
     CHECK_GE(argc, basic_argc + 2);
     std::string delta = argv[basic_argc];
     std::string max_round = argv[basic_argc + 1];
     RunApp<gs::benchmarks::PropertyPageRank<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_pr/",
+        fragment, comm_spec, parallel_spec, "./output_pp_pr/", report,
         boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
   }
@@ -0,0 +1,78 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_APP_BASE_H_
+#define ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_APP_BASE_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/app/app_base.h"
+#include "core/worker/incremental_worker.h"  // IWYU pragma: export
+
+namespace gs {
+
+/**
+ * @brief IncrementalAppBase is the base class for the apps whose result can
+ * be brought up to date with the mutations of a DynamicFragment, from the
+ * result before them, by an IncrementalWorker.
+ *
+ * The result must be monotone in the vertices and edges added, e.g. the
+ * distances of BFS or SSSP, which only drop, the components of WCC, which
+ * only merge, or the residuals of PageRank, which are corrected for the
+ * degrees changed. After a removal or an update the query is run again.
+ *
+ * Besides Init, the context provides Grow(old_vertices), which extends its
+ * states of the vertices old_vertices to the vertices of the fragment after
+ * the mutations, keeping the states of the vertices before, see
+ * GrowVertexArray.
+ *
+ * @tparam FRAG_T Fragment class
+ * @tparam CONTEXT_T App context class
+ */
+template <typename FRAG_T, typename CONTEXT_T>
+class IncrementalAppBase : public AppBase<FRAG_T, CONTEXT_T> {
+ public:
+  using vertex_t = typename FRAG_T::vertex_t;
+  using message_manager_t = grape::DefaultMessageManager;
+
+  /**
+   * @brief Resumes from the fixpoint of the last query after the edges are
+   * added, and the vertices in them. Like PEval, it is followed by IncEval
+   * until no message is sent.
+   *
+   * @param edges_added The edges added since, of which the fragment has at
+   * least one end, the same edge of an undirected fragment given once.
+   */
+  virtual void Resume(
+      const FRAG_T& graph, CONTEXT_T& context, message_manager_t& messages,
+      const std::vector<std::pair<vertex_t, vertex_t>>& edges_added) = 0;
+};
+
+#define INSTALL_INCREMENTAL_WORKER(APP_T, CONTEXT_T, FRAG_T)      \
+ public:                                                          \
+  using fragment_t = FRAG_T;                                      \
+  using context_t = CONTEXT_T;                                    \
+  using message_manager_t = grape::DefaultMessageManager;         \
+  using worker_t = gs::IncrementalWorker<APP_T>;                  \
+  static std::shared_ptr<worker_t> CreateWorker(                  \
+      std::shared_ptr<APP_T> app, std::shared_ptr<FRAG_T> frag) { \
+    return std::shared_ptr<worker_t>(new worker_t(app, frag));    \
+  }
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_APP_BASE_H_
@@ -16,11 +16,15 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "grape/communication/communicator.h"
+
 #include "core/app/pregel/i_vertex_program.h"
 
 namespace gs {
@@ -144,6 +148,53 @@ class Aggregator<std::string> : public IAggregator {
   std::string last_value_;
 };
 
+/**
+ * @brief Aggregates the values of the aggregators of all the workers, and
+ * starts a new round of them. The values of all the aggregators are gathered
+ * at once, in the order of their names, instead of by one collective call per
+ * aggregator and superstep.
+ */
+inline void SyncAggregators(
+    grape::Communicator& comm,
+    std::unordered_map<std::string, std::shared_ptr<IAggregator>>&
+        aggregators) {
+  if (aggregators.empty()) {
+    return;
+  }
+  std::vector<std::pair<std::string, IAggregator*>> sorted;
+  sorted.reserve(aggregators.size());
+  for (auto& pair : aggregators) {
+    sorted.emplace_back(pair.first, pair.second.get());
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  grape::InArchive iarc;
+  for (auto& pair : sorted) {
+    grape::InArchive value;
+    pair.second->Serialize(value);
+    pair.second->Reset();
+    iarc << value.GetSize();
+    iarc.AddBytes(value.GetBuffer(), value.GetSize());
+  }
+  std::vector<grape::InArchive> iarcs;
+  comm.AllGather(std::move(iarc), iarcs);
+
+  for (auto& arc : iarcs) {
+    grape::OutArchive oarc(std::move(arc));
+    for (auto& pair : sorted) {
+      size_t size;
+      oarc >> size;
+      grape::OutArchive value;
+      value.SetSlice(
+          static_cast<char*>(const_cast<void*>(oarc.GetBytes(size))), size);
+      pair.second->DeserializeAndAggregate(value);
+    }
+  }
+  for (auto& pair : sorted) {
+    pair.second->StartNewRound();
+  }
+}
+
 }  // namespace gs
 
 #endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_H_
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -66,6 +67,47 @@ class ICombinator {
   virtual MD_T CombineMessages(MessageIterator<MD_T> messages) = 0;
 };
 
+/**
+ * @brief The combinators keeping the minimum, the maximum and the sum of the
+ * messages, for the programs whose messages are folded by an operator.
+ * @tparam MD_T
+ */
+template <typename MD_T>
+class PregelMinCombinator : public ICombinator<MD_T> {
+ public:
+  MD_T CombineMessages(MessageIterator<MD_T> messages) override {
+    MD_T ret = *messages.begin();
+    for (auto& msg : messages) {
+      ret = std::min(ret, msg);
+    }
+    return ret;
+  }
+};
+
+template <typename MD_T>
+class PregelMaxCombinator : public ICombinator<MD_T> {
+ public:
+  MD_T CombineMessages(MessageIterator<MD_T> messages) override {
+    MD_T ret = *messages.begin();
+    for (auto& msg : messages) {
+      ret = std::max(ret, msg);
+    }
+    return ret;
+  }
+};
+
+template <typename MD_T>
+class PregelSumCombinator : public ICombinator<MD_T> {
+ public:
+  MD_T CombineMessages(MessageIterator<MD_T> messages) override {
+    MD_T ret{};
+    for (auto& msg : messages) {
+      ret += msg;
+    }
+    return ret;
+  }
+};
+
 /**
  * @brief Aggregator interface for pregel program
  */
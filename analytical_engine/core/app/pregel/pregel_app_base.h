@@ -65,7 +65,7 @@ class PregelAppBase
   void PEval(const fragment_t& frag, pregel_context_t& ctx,
              message_manager_t& messages) {
     // superstep is 0 in PEval
-    ctx.compute_context_.enable_combine();
+    ctx.compute_context_.enable_combine(combinator_);
 
     PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
     pregel_vertex.set_fragment(&frag);
@@ -99,16 +99,7 @@ class PregelAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -162,16 +153,7 @@ class PregelAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -237,16 +219,7 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -288,16 +261,7 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
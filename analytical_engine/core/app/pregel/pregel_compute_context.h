@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -92,7 +93,7 @@ class PregelComputeContext {
 
   void send_message(const vertex_t& v, const MD_T& value) {
     if (enable_combine_) {
-      messages_out_[v].emplace_back(value);
+      combineMessage(messages_out_[v], MD_T(value));
     } else {
       if (fragment_->IsOuterVertex(v)) {
         message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
@@ -105,7 +106,7 @@ class PregelComputeContext {
 
   void send_message(const vertex_t& v, MD_T&& value) {
     if (enable_combine_) {
-      messages_out_[v].emplace_back(std::move(value));
+      combineMessage(messages_out_[v], std::move(value));
     } else {
       if (fragment_->IsOuterVertex(v)) {
         message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
@@ -199,7 +200,16 @@ class PregelComputeContext {
     }
   }
 
-  void enable_combine() { enable_combine_ = true; }
+  // Messages sent to a vertex are combined by cb as they are sent, so that
+  // at most one is buffered per vertex.
+  template <typename COMBINATOR_T>
+  void enable_combine(COMBINATOR_T& cb) {
+    enable_combine_ = true;
+    combine_ = [&cb](grape::IteratorPair<MD_T*> msgs) {
+      return cb.CombineMessages(msgs);
+    };
+  }
+
   void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
   void set_message_manager(grape::DefaultMessageManager* message_manager) {
     message_manager_ = message_manager;
@@ -254,6 +264,16 @@ class PregelComputeContext {
   }
 
  private:
+  void combineMessage(std::vector<MD_T>& msgs, MD_T&& value) {
+    msgs.emplace_back(std::move(value));
+    if (msgs.size() > 1) {
+      MD_T ret = combine_(grape::IteratorPair<MD_T*>(
+          &msgs[0], &msgs[0] + static_cast<ptrdiff_t>(msgs.size())));
+      msgs.clear();
+      msgs.emplace_back(std::move(ret));
+    }
+  }
+
   const fragment_t* fragment_;
   grape::DefaultMessageManager* message_manager_;
   grape::ParallelMessageManager* parallel_message_manager_;
@@ -270,6 +290,7 @@ class PregelComputeContext {
   size_t total_vertex_num_;
 
   bool enable_combine_;
+  std::function<MD_T(grape::IteratorPair<MD_T*>)> combine_;
 
   int step_;
   std::unordered_map<std::string, std::string> config_;
@@ -68,7 +68,7 @@ class PregelPropertyAppBase
   void PEval(const fragment_t& frag, pregel_context_t& ctx,
              message_manager_t& messages) {
     // superstep is 0 in PEval
-    ctx.compute_context_.enable_combine();
+    ctx.compute_context_.enable_combine(combinator_);
     label_id_t v_label_num = frag.vertex_label_num();
 
     PregelPropertyVertex<fragment_t, vd_t, md_t> pregel_vertex;
@@ -110,16 +110,7 @@ class PregelPropertyAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -184,16 +175,7 @@ class PregelPropertyAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -269,16 +251,7 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -328,16 +301,7 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(*this, ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_PROPERTY_VERTEX_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_PROPERTY_VERTEX_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -511,7 +512,7 @@ class PregelPropertyComputeContext {
   void send_message(const vertex_t& v, const MD_T& value) {
     if (enable_combine_) {
       label_id_t label = fragment_->vertex_label(v);
-      messages_out_[label][v].emplace_back(value);
+      combineMessage(messages_out_[label][v], MD_T(value));
     } else {
       if (fragment_->IsOuterVertex(v)) {
         message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
@@ -526,7 +527,7 @@ class PregelPropertyComputeContext {
   void send_message(const vertex_t& v, MD_T&& value) {
     if (enable_combine_) {
       label_id_t label = fragment_->vertex_label(v);
-      messages_out_[label][v].emplace_back(std::move(value));
+      combineMessage(messages_out_[label][v], std::move(value));
     } else {
       if (fragment_->IsOuterVertex(v)) {
         message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
@@ -618,7 +619,16 @@ class PregelPropertyComputeContext {
     }
   }
 
-  void enable_combine() { enable_combine_ = true; }
+  // Messages sent to a vertex are combined by cb as they are sent, so that
+  // at most one is buffered per vertex.
+  template <typename COMBINATOR_T>
+  void enable_combine(COMBINATOR_T& cb) {
+    enable_combine_ = true;
+    combine_ = [&cb](grape::IteratorPair<MD_T*> msgs) {
+      return cb.CombineMessages(msgs);
+    };
+  }
+
   void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
   void set_message_manager(grape::DefaultMessageManager* message_manager) {
     message_manager_ = message_manager;
@@ -680,6 +690,16 @@ class PregelPropertyComputeContext {
   const vineyard::PropertyGraphSchema* schema() const { return schema_; }
 
  private:
+  void combineMessage(std::vector<MD_T>& msgs, MD_T&& value) {
+    msgs.emplace_back(std::move(value));
+    if (msgs.size() > 1) {
+      MD_T ret = combine_(grape::IteratorPair<MD_T*>(
+          &msgs[0], &msgs[0] + static_cast<ptrdiff_t>(msgs.size())));
+      msgs.clear();
+      msgs.emplace_back(std::move(ret));
+    }
+  }
+
   const fragment_t* fragment_;
   grape::DefaultMessageManager* message_manager_;
 
@@ -701,6 +721,7 @@ class PregelPropertyComputeContext {
   label_id_t edge_label_num_;
 
   bool enable_combine_;
+  std::function<MD_T(grape::IteratorPair<MD_T*>)> combine_;
 
   int step_;
   std::unordered_map<std::string, std::string> config_;
@@ -16,6 +16,7 @@
 #define ANALYTICAL_ENGINE_CORE_COMMUNICATION_SHUFFLE_H_
 
 #include <string>
+#include <vector>
 
 #include "grape/communication/shuffle.h"  // IWYU pragma: export
 #include "vineyard/graph/utils/string_collection.h"
@@ -40,14 +41,20 @@ class ShuffleUnit<std::string> {
   BufferT& data() { return buffer_; }
   const BufferT& data() const { return buffer_; }
 
+  // The header and the chunks of the buffer are all in flight at once, a
+  // chunk being short enough for the int count of MPI.
   void SendTo(int dst_worker_id, int tag, MPI_Comm comm) {
     rsv_header header(buffer_.size_in_bytes(), buffer_.size());
-    MPI_Send(&header, static_cast<int>(sizeof(rsv_header)), MPI_CHAR,
-             dst_worker_id, tag, comm);
-    if (header.size) {
-      MPI_Send(buffer_.data(), static_cast<int>(header.size), MPI_CHAR,
-               dst_worker_id, tag, comm);
+    std::vector<MPI_Request> requests(1 + chunkNum(header.size));
+    MPI_Isend(&header, static_cast<int>(sizeof(rsv_header)), MPI_CHAR,
+              dst_worker_id, tag, comm, &requests[0]);
+    for (size_t i = 1; i < requests.size(); ++i) {
+      size_t offset = (i - 1) * kChunkSize;
+      MPI_Isend(buffer_.data() + offset, chunkSize(header.size, offset),
+                MPI_CHAR, dst_worker_id, tag, comm, &requests[i]);
     }
+    MPI_Waitall(static_cast<int>(requests.size()), requests.data(),
+                MPI_STATUSES_IGNORE);
   }
 
   void RecvFrom(int src_worker_id, int tag, MPI_Comm comm) {
@@ -57,8 +64,15 @@ class ShuffleUnit<std::string> {
              src_worker_id, tag, comm, MPI_STATUS_IGNORE);
     if (header.size) {
       buffer_.resize(header.size + old_size, header.count + buffer_.size());
-      MPI_Recv(buffer_.data() + old_size, static_cast<int>(header.size),
-               MPI_CHAR, src_worker_id, tag, comm, MPI_STATUS_IGNORE);
+      std::vector<MPI_Request> requests(chunkNum(header.size));
+      for (size_t i = 0; i < requests.size(); ++i) {
+        size_t offset = i * kChunkSize;
+        MPI_Irecv(buffer_.data() + old_size + offset,
+                  chunkSize(header.size, offset), MPI_CHAR, src_worker_id,
+                  tag, comm, &requests[i]);
+      }
+      MPI_Waitall(static_cast<int>(requests.size()), requests.data(),
+                  MPI_STATUSES_IGNORE);
     }
   }
 
@@ -69,6 +83,18 @@ class ShuffleUnit<std::string> {
     size_t size;
     size_t count;
   };
+
+  static constexpr size_t kChunkSize = 1ul << 30;
+
+  static size_t chunkNum(size_t size) {
+    return (size + kChunkSize - 1) / kChunkSize;
+  }
+
+  static int chunkSize(size_t size, size_t offset) {
+    return static_cast<int>(size - offset < kChunkSize ? size - offset
+                                                       : kChunkSize);
+  }
+
   BufferT buffer_;
 };
 
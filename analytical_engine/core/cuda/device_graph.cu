@@ -0,0 +1,402 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/cuda/device_graph.h"
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "glog/logging.h"
+
+#define CHECK_CUDA(call)                                        \
+  do {                                                          \
+    cudaError_t err = (call);                                   \
+    CHECK_EQ(err, cudaSuccess) << #call << ": "                 \
+                               << cudaGetErrorString(err);      \
+  } while (0)
+
+namespace gs {
+
+namespace cuda {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+
+// The kernels loop by the grid, so that a grid is kept to a bounded size.
+inline int gridSize(size_t num) {
+  return static_cast<int>(std::max<size_t>(
+      std::min<size_t>((num + kBlockSize - 1) / kBlockSize, 65535), 1));
+}
+
+__device__ inline uint64_t relax(Relax relax, uint64_t value,
+                                 const double* weights, uint64_t e) {
+  switch (relax) {
+  case Relax::kHop:
+    return value + 1;
+  case Relax::kWeight:
+    return static_cast<uint64_t>(__double_as_longlong(
+        __longlong_as_double(static_cast<long long>(value)) + weights[e]));
+  default:
+    return value;
+  }
+}
+
+// Appends v to list once, by the flag of it.
+__device__ inline void appendOnce(uint32_t v, uint32_t* flags,
+                                  uint32_t* list, uint32_t* size) {
+  if (atomicExch(&flags[v], 1u) == 0u) {
+    list[atomicAdd(size, 1u)] = v;
+  }
+}
+
+__global__ void clearFlagsKernel(const uint32_t* lids, uint32_t num,
+                                 uint32_t* flags) {
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num;
+       i += gridDim.x * blockDim.x) {
+    flags[lids[i]] = 0;
+  }
+}
+
+__global__ void activateKernel(const uint32_t* lids, uint32_t num,
+                               uint32_t* flags, uint32_t* frontier,
+                               uint32_t* frontier_size) {
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num;
+       i += gridDim.x * blockDim.x) {
+    appendOnce(lids[i], flags, frontier, frontier_size);
+  }
+}
+
+__global__ void lowerKernel(const uint32_t* lids, const uint64_t* values,
+                            uint32_t num, unsigned long long* dst,
+                            uint32_t* flags, uint32_t* frontier,
+                            uint32_t* frontier_size) {
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num;
+       i += gridDim.x * blockDim.x) {
+    uint32_t v = lids[i];
+    unsigned long long value = values[i];
+    if (value < atomicMin(&dst[v], value)) {
+      appendOnce(v, flags, frontier, frontier_size);
+    }
+  }
+}
+
+// A vertex of the frontier per thread, the inner vertices lowered make the
+// next frontier, and the outer ones are gathered till the end of Propagate.
+__global__ void propagateKernel(Relax relax_type, uint32_t ivnum,
+                                const uint64_t* offsets,
+                                const uint32_t* edges, const double* weights,
+                                const uint32_t* frontier,
+                                uint32_t frontier_size,
+                                unsigned long long* values, uint32_t* flags,
+                                uint32_t* next, uint32_t* next_size,
+                                uint32_t* outer, uint32_t* outer_size) {
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < frontier_size;
+       i += gridDim.x * blockDim.x) {
+    uint32_t u = frontier[i];
+    uint64_t value = values[u];
+    for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      uint32_t v = edges[e];
+      unsigned long long candidate = relax(relax_type, value, weights, e);
+      if (candidate < atomicMin(&values[v], candidate)) {
+        if (v < ivnum) {
+          appendOnce(v, flags, next, next_size);
+        } else {
+          appendOnce(v, flags, outer, outer_size);
+        }
+      }
+    }
+  }
+}
+
+__global__ void gatherKernel(const uint32_t* lids, uint32_t num,
+                             const unsigned long long* values,
+                             uint64_t* gathered) {
+  for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num;
+       i += gridDim.x * blockDim.x) {
+    gathered[i] = values[lids[i]];
+  }
+}
+
+__global__ void pushSumKernel(uint32_t ivnum, const uint64_t* offsets,
+                              const uint32_t* edges, const double* contribs,
+                              double* sums) {
+  for (uint32_t u = blockIdx.x * blockDim.x + threadIdx.x; u < ivnum;
+       u += gridDim.x * blockDim.x) {
+    double contrib = contribs[u];
+    for (uint64_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      atomicAdd(&sums[edges[e]], contrib);
+    }
+  }
+}
+
+template <typename T>
+void allocate(T*& ptr, size_t num) {
+  CHECK_CUDA(cudaMalloc(&ptr, std::max<size_t>(num, 1) * sizeof(T)));
+}
+
+template <typename T>
+void upload(T* dst, const T* src, size_t num) {
+  if (num > 0) {
+    CHECK_CUDA(cudaMemcpy(dst, src, num * sizeof(T), cudaMemcpyHostToDevice));
+  }
+}
+
+template <typename T>
+void download(T* dst, const T* src, size_t num) {
+  if (num > 0) {
+    CHECK_CUDA(cudaMemcpy(dst, src, num * sizeof(T), cudaMemcpyDeviceToHost));
+  }
+}
+
+}  // namespace
+
+struct DeviceGraph::Impl {
+  ~Impl() {
+    if (!uploaded) {
+      return;
+    }
+    cudaFree(offsets);
+    cudaFree(edges);
+    cudaFree(weights);
+    cudaFree(values);
+    cudaFree(flags);
+    cudaFree(frontier[0]);
+    cudaFree(frontier[1]);
+    cudaFree(outer);
+    cudaFree(buffer);
+    cudaFree(sums);
+    cudaFree(counters);
+  }
+
+  // Makes room for num lids and num values to pass in or out.
+  void reserve(size_t num) {
+    if (num > buffer_capacity) {
+      cudaFree(buffer);
+      CHECK_CUDA(cudaMalloc(&buffer, num * (sizeof(uint32_t) +
+                                            sizeof(unsigned long long))));
+      buffer_capacity = num;
+    }
+  }
+
+  uint32_t* buffer_lids() { return static_cast<uint32_t*>(buffer); }
+
+  unsigned long long* buffer_values() {
+    return reinterpret_cast<unsigned long long*>(
+        static_cast<char*>(buffer) + buffer_capacity * sizeof(uint32_t));
+  }
+
+  void gather(const std::vector<uint32_t>& lids,
+              std::vector<uint64_t>& gathered) {
+    gathered.resize(lids.size());
+    if (lids.empty()) {
+      return;
+    }
+    reserve(lids.size());
+    upload(buffer_lids(), lids.data(), lids.size());
+    gatherKernel<<<gridSize(lids.size()), kBlockSize>>>(
+        buffer_lids(), lids.size(), values,
+        reinterpret_cast<uint64_t*>(buffer_values()));
+    CHECK_CUDA(cudaGetLastError());
+    download(gathered.data(),
+             reinterpret_cast<const uint64_t*>(buffer_values()),
+             lids.size());
+  }
+
+  bool uploaded = false;
+  uint32_t ivnum = 0;
+  uint32_t vnum = 0;
+  uint64_t* offsets = nullptr;
+  uint32_t* edges = nullptr;
+  double* weights = nullptr;
+  unsigned long long* values = nullptr;
+  uint32_t* flags = nullptr;
+  // the frontier in frontier[curr], whose size is in counters[0], and the
+  // outer vertices lowered, whose size is in counters[1]
+  uint32_t* frontier[2] = {nullptr, nullptr};
+  int curr = 0;
+  uint32_t* outer = nullptr;
+  uint32_t* counters = nullptr;
+  void* buffer = nullptr;
+  size_t buffer_capacity = 0;
+  double* sums = nullptr;
+};
+
+DeviceGraph::DeviceGraph() : impl_(new Impl()) {}
+
+DeviceGraph::~DeviceGraph() = default;
+
+bool DeviceGraph::Upload(int local_id, uint32_t ivnum, uint32_t vnum,
+                         const std::vector<uint64_t>& offsets,
+                         const std::vector<uint32_t>& edges,
+                         const std::vector<double>& weights,
+                         std::string& error) {
+  CHECK(!impl_->uploaded);
+  CHECK_EQ(offsets.size(), static_cast<size_t>(ivnum) + 1);
+  int device_num = 0;
+  if (cudaGetDeviceCount(&device_num) != cudaSuccess || device_num == 0) {
+    error = "No CUDA device is found";
+    return false;
+  }
+  int device = local_id % device_num;
+  CHECK_CUDA(cudaSetDevice(device));
+
+  size_t enum_ = edges.size();
+  // the CSR, the values, flags and sums of the vertices, and two frontiers
+  size_t required = offsets.size() * sizeof(uint64_t) +
+                    enum_ * sizeof(uint32_t) +
+                    weights.size() * sizeof(double) +
+                    vnum * (sizeof(unsigned long long) + sizeof(uint32_t) +
+                            sizeof(double)) +
+                    (2 * ivnum + (vnum - ivnum)) * sizeof(uint32_t);
+  size_t free_memory = 0, total_memory = 0;
+  CHECK_CUDA(cudaMemGetInfo(&free_memory, &total_memory));
+  if (required > free_memory) {
+    std::stringstream ss;
+    ss << "The fragment takes " << required << " bytes on device " << device
+       << ", but only " << free_memory << " bytes are free";
+    error = ss.str();
+    return false;
+  }
+
+  auto& impl = *impl_;
+  impl.ivnum = ivnum;
+  impl.vnum = vnum;
+  allocate(impl.offsets, offsets.size());
+  allocate(impl.edges, enum_);
+  if (!weights.empty()) {
+    CHECK_EQ(weights.size(), enum_);
+    allocate(impl.weights, enum_);
+    upload(impl.weights, weights.data(), enum_);
+  }
+  allocate(impl.values, vnum);
+  allocate(impl.flags, vnum);
+  allocate(impl.frontier[0], ivnum);
+  allocate(impl.frontier[1], ivnum);
+  allocate(impl.outer, vnum - ivnum);
+  allocate(impl.sums, vnum);
+  allocate(impl.counters, 2);
+  impl.uploaded = true;
+  upload(impl.offsets, offsets.data(), offsets.size());
+  upload(impl.edges, edges.data(), enum_);
+  CHECK_CUDA(cudaMemset(impl.flags, 0, vnum * sizeof(uint32_t)));
+  CHECK_CUDA(cudaMemset(impl.counters, 0, 2 * sizeof(uint32_t)));
+  return true;
+}
+
+void DeviceGraph::SetValues(const std::vector<uint64_t>& values) {
+  auto& impl = *impl_;
+  CHECK_EQ(values.size(), impl.vnum);
+  upload(impl.values, reinterpret_cast<const unsigned long long*>(
+                          values.data()), values.size());
+  CHECK_CUDA(cudaMemset(impl.flags, 0, impl.vnum * sizeof(uint32_t)));
+  CHECK_CUDA(cudaMemset(impl.counters, 0, 2 * sizeof(uint32_t)));
+}
+
+void DeviceGraph::GetValues(std::vector<uint64_t>& values) const {
+  auto& impl = *impl_;
+  values.resize(impl.vnum);
+  download(reinterpret_cast<unsigned long long*>(values.data()), impl.values,
+           values.size());
+}
+
+void DeviceGraph::Activate(const std::vector<uint32_t>& lids) {
+  auto& impl = *impl_;
+  if (lids.empty()) {
+    return;
+  }
+  impl.reserve(lids.size());
+  upload(impl.buffer_lids(), lids.data(), lids.size());
+  activateKernel<<<gridSize(lids.size()), kBlockSize>>>(
+      impl.buffer_lids(), lids.size(), impl.flags, impl.frontier[impl.curr],
+      impl.counters);
+  CHECK_CUDA(cudaGetLastError());
+}
+
+void DeviceGraph::Lower(const std::vector<uint32_t>& lids,
+                        const std::vector<uint64_t>& values) {
+  auto& impl = *impl_;
+  CHECK_EQ(lids.size(), values.size());
+  if (lids.empty()) {
+    return;
+  }
+  impl.reserve(lids.size());
+  upload(impl.buffer_lids(), lids.data(), lids.size());
+  upload(impl.buffer_values(),
+         reinterpret_cast<const unsigned long long*>(values.data()),
+         values.size());
+  lowerKernel<<<gridSize(lids.size()), kBlockSize>>>(
+      impl.buffer_lids(),
+      reinterpret_cast<const uint64_t*>(impl.buffer_values()), lids.size(),
+      impl.values, impl.flags, impl.frontier[impl.curr], impl.counters);
+  CHECK_CUDA(cudaGetLastError());
+}
+
+void DeviceGraph::Propagate(Relax relax, std::vector<uint32_t>& outer_lids,
+                            std::vector<uint64_t>& outer_values) {
+  auto& impl = *impl_;
+  CHECK(relax != Relax::kWeight || impl.weights != nullptr);
+  uint32_t counters[2];
+  download(counters, impl.counters, 2);
+  uint32_t frontier_size = counters[0];
+  while (frontier_size > 0) {
+    uint32_t* frontier = impl.frontier[impl.curr];
+    uint32_t* next = impl.frontier[impl.curr ^ 1];
+    // the vertices of the frontier may join the next one
+    clearFlagsKernel<<<gridSize(frontier_size), kBlockSize>>>(
+        frontier, frontier_size, impl.flags);
+    CHECK_CUDA(cudaMemset(impl.counters, 0, sizeof(uint32_t)));
+    propagateKernel<<<gridSize(frontier_size), kBlockSize>>>(
+        relax, impl.ivnum, impl.offsets, impl.edges, impl.weights, frontier,
+        frontier_size, impl.values, impl.flags, next, impl.counters,
+        impl.outer, impl.counters + 1);
+    CHECK_CUDA(cudaGetLastError());
+    impl.curr ^= 1;
+    download(&frontier_size, impl.counters, 1);
+  }
+
+  download(&counters[1], impl.counters + 1, 1);
+  outer_lids.resize(counters[1]);
+  download(outer_lids.data(), impl.outer, outer_lids.size());
+  if (!outer_lids.empty()) {
+    clearFlagsKernel<<<gridSize(outer_lids.size()), kBlockSize>>>(
+        impl.outer, outer_lids.size(), impl.flags);
+    CHECK_CUDA(cudaGetLastError());
+  }
+  CHECK_CUDA(cudaMemset(impl.counters + 1, 0, sizeof(uint32_t)));
+  impl.gather(outer_lids, outer_values);
+}
+
+void DeviceGraph::PushSum(const std::vector<double>& contribs,
+                          std::vector<double>& sums) {
+  auto& impl = *impl_;
+  CHECK_EQ(contribs.size(), impl.ivnum);
+  // the contributions are passed in the buffer of the values
+  impl.reserve(impl.ivnum);
+  double* d_contribs = reinterpret_cast<double*>(impl.buffer_values());
+  upload(d_contribs, contribs.data(), contribs.size());
+  CHECK_CUDA(cudaMemset(impl.sums, 0, impl.vnum * sizeof(double)));
+  pushSumKernel<<<gridSize(impl.ivnum), kBlockSize>>>(
+      impl.ivnum, impl.offsets, impl.edges, d_contribs, impl.sums);
+  CHECK_CUDA(cudaGetLastError());
+  sums.resize(impl.vnum);
+  download(sums.data(), impl.sums, sums.size());
+}
+
+}  // namespace cuda
+
+}  // namespace gs
@@ -0,0 +1,123 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_CUDA_DEVICE_GRAPH_H_
+#define ANALYTICAL_ENGINE_CORE_CUDA_DEVICE_GRAPH_H_
+
+#ifdef ENABLE_CUDA
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+namespace cuda {
+
+/**
+ * @brief How a value is carried along an edge by DeviceGraph::Propagate.
+ *
+ * A value is an uint64_t, and a distance is kept as the bits of a
+ * non-negative double, which order as the doubles do.
+ */
+enum class Relax {
+  kHop,     // the value plus one, e.g. the depth of BFS
+  kWeight,  // the distance plus the weight of the edge, e.g. SSSP
+  kCopy,    // the value itself, e.g. the component id of WCC
+};
+
+/**
+ * @brief The out edges of the inner vertices of a fragment in the memory of
+ * a GPU, with the kernels the apps under apps/cuda run on them.
+ *
+ * The edges are kept as a CSR of the local ids, i.e. offsets of ivnum + 1
+ * and the local ids of the neighbors, which is why the fragment must number
+ * its inner and outer vertices by a contiguous range [0, vnum). This header
+ * is plain C++ so that the app frames are compiled without nvcc, the kernels
+ * are in libgs_cuda.
+ */
+class DeviceGraph {
+ public:
+  DeviceGraph();
+  ~DeviceGraph();
+
+  DeviceGraph(const DeviceGraph&) = delete;
+  DeviceGraph& operator=(const DeviceGraph&) = delete;
+
+  /**
+   * @brief Copies the CSR to the device local_id % the number of devices,
+   * so that the workers on a host share its GPUs.
+   *
+   * @param weights The weights of the edges, or empty for no weights.
+   * @return false with error set if there is no device or the graph does
+   * not fit in the free memory of it.
+   */
+  bool Upload(int local_id, uint32_t ivnum, uint32_t vnum,
+              const std::vector<uint64_t>& offsets,
+              const std::vector<uint32_t>& edges,
+              const std::vector<double>& weights, std::string& error);
+
+  /**
+   * @brief Sets the values of all the vertices, and empties the frontier.
+   */
+  void SetValues(const std::vector<uint64_t>& values);
+
+  /**
+   * @brief Gets the values of all the vertices.
+   */
+  void GetValues(std::vector<uint64_t>& values) const;
+
+  /**
+   * @brief Adds the inner vertices to the frontier.
+   */
+  void Activate(const std::vector<uint32_t>& lids);
+
+  /**
+   * @brief Lowers the values of the inner vertices to the given ones, and
+   * adds those lowered to the frontier.
+   */
+  void Lower(const std::vector<uint32_t>& lids,
+             const std::vector<uint64_t>& values);
+
+  /**
+   * @brief Carries the values of the frontier along the edges until no value
+   * of an inner vertex is lowered any more, and gives the outer vertices
+   * whose values are lowered, to be sent to their owners.
+   */
+  void Propagate(Relax relax, std::vector<uint32_t>& outer_lids,
+                 std::vector<uint64_t>& outer_values);
+
+  /**
+   * @brief Sums the contributions of the inner vertices along their edges,
+   * i.e. sums[v] is the sum of contribs[u] of the edges (u, v).
+   *
+   * @param contribs The contributions of the ivnum inner vertices.
+   * @param sums The sums of the vnum vertices.
+   */
+  void PushSum(const std::vector<double>& contribs,
+               std::vector<double>& sums);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace cuda
+
+}  // namespace gs
+
+#endif  // ENABLE_CUDA
+#endif  // ANALYTICAL_ENGINE_CORE_CUDA_DEVICE_GRAPH_H_
@@ -16,10 +16,13 @@
 #ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
 #define ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -96,14 +99,10 @@ class UnionIdParser {
 
  private:
   size_t getVertexRangeOffsetIndex(ID_TYPE v) const {
-    size_t index = 0;
-    for (size_t i = 0; i < vertex_range_offset_.size(); ++i) {
-      if (vertex_range_offset_[i] > v) {
-        index = i;
-        break;
-      }
-    }
-    CHECK_NE(index, 0);
+    size_t index = std::upper_bound(vertex_range_offset_.begin(),
+                                    vertex_range_offset_.end(), v) -
+                   vertex_range_offset_.begin();
+    CHECK_LT(index, vertex_range_offset_.size());
     return index;
   }
 
@@ -132,34 +131,44 @@ struct NbrDefault {
   using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
 
  public:
+  // A flat nbr comes from the materialized CSR of the fragment, whose
+  // neighbors are continuous lids already.
   explicit NbrDefault(const prop_id_t& default_prop_id,
-                      const UnionIdParser<VID_T>& union_id_parser)
-      : default_prop_id_(default_prop_id), union_id_parser_(union_id_parser) {}
+                      const UnionIdParser<VID_T>& union_id_parser,
+                      bool flat = false)
+      : default_prop_id_(default_prop_id),
+        union_id_parser_(&union_id_parser),
+        flat_(flat) {}
   NbrDefault(const nbr_t& nbr, const prop_id_t& default_prop_id,
              const UnionIdParser<VID_T>& union_id_parser)
       : nbr_(nbr),
         default_prop_id_(default_prop_id),
-        union_id_parser_(union_id_parser) {}
+        union_id_parser_(&union_id_parser),
+        flat_(false) {}
   NbrDefault(const NbrDefault& rhs)
       : nbr_(rhs.nbr_),
         default_prop_id_(rhs.default_prop_id_),
-        union_id_parser_(rhs.union_id_parser_) {}
+        union_id_parser_(rhs.union_id_parser_),
+        flat_(rhs.flat_) {}
   NbrDefault(NbrDefault&& rhs)
       : nbr_(rhs.nbr_),
         default_prop_id_(rhs.default_prop_id_),
-        union_id_parser_(rhs.union_id_parser_) {}
+        union_id_parser_(rhs.union_id_parser_),
+        flat_(rhs.flat_) {}
 
   NbrDefault& operator=(const NbrDefault& rhs) {
     nbr_ = rhs.nbr_;
     default_prop_id_ = rhs.default_prop_id_;
     union_id_parser_ = rhs.union_id_parser_;
+    flat_ = rhs.flat_;
     return *this;
   }
 
   NbrDefault& operator=(NbrDefault&& rhs) {
     nbr_ = std::move(rhs.nbr_);
     default_prop_id_ = rhs.default_prop_id_;
-    union_id_parser_ = std::move(rhs.union_id_parser_);
+    union_id_parser_ = rhs.union_id_parser_;
+    flat_ = rhs.flat_;
     return *this;
   }
 
@@ -174,15 +183,23 @@ struct NbrDefault {
   }
 
   grape::Vertex<VID_T> neighbor() const {
+    if (flat_) {
+      return nbr_.neighbor();
+    }
     return grape::Vertex<VID_T>(
-        union_id_parser_.GenerateContinuousLid(nbr_.neighbor().GetValue()));
+        union_id_parser_->GenerateContinuousLid(nbr_.neighbor().GetValue()));
   }
 
   grape::Vertex<VID_T> get_neighbor() const {
-    return grape::Vertex<VID_T>(
-        union_id_parser_.GenerateContinuousLid(nbr_.get_neighbor().GetValue()));
+    if (flat_) {
+      return nbr_.get_neighbor();
+    }
+    return grape::Vertex<VID_T>(union_id_parser_->GenerateContinuousLid(
+        nbr_.get_neighbor().GetValue()));
   }
 
+  bool flat() const { return flat_; }
+
   grape::Vertex<VID_T> raw_neighbor() const { return nbr_.neighbor(); }
 
   grape::Vertex<VID_T> get_raw_neighbor() const { return nbr_.neighbor(); }
@@ -238,7 +255,28 @@ struct NbrDefault {
  private:
   nbr_t nbr_;
   prop_id_t default_prop_id_;
-  UnionIdParser<VID_T> union_id_parser_;
+  const UnionIdParser<VID_T>* union_id_parser_;
+  bool flat_;
+};
+
+/**
+ * @brief Edge data of a NbrDefault, to be copied into the materialized CSR of
+ * ArrowFlattenedFragment.
+ */
+template <typename EDATA_T>
+struct FlatEdata {
+  template <typename NBR_T, typename PROP_ID_T>
+  static EDATA_T Get(const NBR_T& nbr, PROP_ID_T prop_id) {
+    return nbr.template get_data<EDATA_T>(prop_id);
+  }
+};
+
+template <>
+struct FlatEdata<grape::EmptyType> {
+  template <typename NBR_T, typename PROP_ID_T>
+  static grape::EmptyType Get(const NBR_T& nbr, PROP_ID_T prop_id) {
+    return grape::EmptyType();
+  }
 };
 
 /**
@@ -263,11 +301,12 @@ class UnionAdjList {
   explicit UnionAdjList(const std::vector<adj_list_t>& adj_lists,
                         const prop_id_t& default_prop_id,
                         const UnionIdParser<VID_T>& union_id_parser,
-                        const FRAGMENT_T* fragment)
+                        const FRAGMENT_T* fragment, bool flat = false)
       : adj_lists_(adj_lists),
         default_prop_id_(default_prop_id),
-        union_id_parser_(union_id_parser),
-        fragment_(fragment) {
+        union_id_parser_(&union_id_parser),
+        fragment_(fragment),
+        flat_(flat) {
     size_ = 0;
     for (auto& adj_list : adj_lists_) {
       size_ += adj_list.Size();
@@ -277,11 +316,12 @@ class UnionAdjList {
   explicit UnionAdjList(std::vector<adj_list_t>&& adj_lists,
                         const prop_id_t& default_prop_id,
                         const UnionIdParser<VID_T>& union_id_parser,
-                        const FRAGMENT_T* fragment)
+                        const FRAGMENT_T* fragment, bool flat = false)
       : adj_lists_(std::move(adj_lists)),
         default_prop_id_(default_prop_id),
-        union_id_parser_(union_id_parser),
-        fragment_(fragment) {
+        union_id_parser_(&union_id_parser),
+        fragment_(fragment),
+        flat_(flat) {
     size_ = 0;
     for (auto& adj_list : adj_lists_) {
       size_ += adj_list.Size();
@@ -297,10 +337,10 @@ class UnionAdjList {
     explicit iterator(const std::vector<adj_list_t>& adj_lists,
                       const nbr_unit_t& nbr, const prop_id_t& default_prop_id,
                       size_t index, const UnionIdParser<VID_T>& union_id_parser,
-                      const FRAGMENT_T* fragment)
+                      const FRAGMENT_T* fragment, bool flat)
         : adj_lists_(adj_lists),
           fragment_(fragment),
-          curr_nbr_(default_prop_id, union_id_parser),
+          curr_nbr_(default_prop_id, union_id_parser, flat),
           curr_list_index_(index) {
       curr_nbr_ = nbr;
       move_to_next_valid_nbr();
@@ -325,7 +365,8 @@ class UnionAdjList {
             curr_nbr_ = adj_lists_.get()[curr_list_index_].begin();
           }
         } else {
-          if (fragment_->is_valid_vertex(curr_nbr_.raw_neighbor())) {
+          if (curr_nbr_.flat() ||
+              fragment_->is_valid_vertex(curr_nbr_.raw_neighbor())) {
             break;
           }
           ++curr_nbr_;
@@ -370,10 +411,10 @@ class UnionAdjList {
                             const nbr_unit_t& nbr,
                             const prop_id_t& default_prop_id, size_t index,
                             const UnionIdParser<VID_T>& union_id_parser,
-                            const FRAGMENT_T* fragment)
+                            const FRAGMENT_T* fragment, bool flat)
         : adj_lists_(adj_lists),
           fragment_(fragment),
-          curr_nbr_(default_prop_id, union_id_parser),
+          curr_nbr_(default_prop_id, union_id_parser, flat),
           curr_list_index_(index) {
       curr_nbr_ = nbr;
       move_to_next_valid_nbr();
@@ -399,7 +440,8 @@ class UnionAdjList {
             curr_nbr_ = adj_lists_.get()[curr_list_index_].begin();
           }
         } else {
-          if (fragment_->is_valid_vertex(curr_nbr_.raw_neighbor())) {
+          if (curr_nbr_.flat() ||
+              fragment_->is_valid_vertex(curr_nbr_.raw_neighbor())) {
             break;
           }
           ++curr_nbr_;
@@ -437,22 +479,22 @@ class UnionAdjList {
   iterator begin() {
     if (size_ == 0) {
       nbr_unit_t nbr;
-      return iterator(adj_lists_, nbr, default_prop_id_, 0, union_id_parser_,
-                      fragment_);
+      return iterator(adj_lists_, nbr, default_prop_id_, 0, *union_id_parser_,
+                      fragment_, flat_);
     } else {
       return iterator(adj_lists_, adj_lists_.front().begin(), default_prop_id_,
-                      0, union_id_parser_, fragment_);
+                      0, *union_id_parser_, fragment_, flat_);
     }
   }
 
   iterator end() {
     if (size_ == 0) {
       nbr_unit_t nbr;
-      return iterator(adj_lists_, nbr, default_prop_id_, 0, union_id_parser_,
-                      fragment_);
+      return iterator(adj_lists_, nbr, default_prop_id_, 0, *union_id_parser_,
+                      fragment_, flat_);
     } else {
       return iterator(adj_lists_, adj_lists_.back().end(), default_prop_id_,
-                      adj_lists_.size(), union_id_parser_, fragment_);
+                      adj_lists_.size(), *union_id_parser_, fragment_, flat_);
     }
   }
 
@@ -460,10 +502,11 @@ class UnionAdjList {
     if (size_ == 0) {
       nbr_unit_t nbr;
       return const_iterator(adj_lists_, nbr, default_prop_id_, 0,
-                            union_id_parser_, fragment_);
+                            *union_id_parser_, fragment_, flat_);
     } else {
       return const_iterator(adj_lists_, adj_lists_.front().begin(),
-                            default_prop_id_, 0, union_id_parser_, fragment_);
+                            default_prop_id_, 0, *union_id_parser_, fragment_,
+                            flat_);
     }
   }
 
@@ -471,11 +514,11 @@ class UnionAdjList {
     if (size_ == 0) {
       nbr_unit_t nbr;
       return const_iterator(adj_lists_, nbr, default_prop_id_, 0,
-                            union_id_parser_, fragment_);
+                            *union_id_parser_, fragment_, flat_);
     } else {
       return const_iterator(adj_lists_, adj_lists_.back().end(),
                             default_prop_id_, adj_lists_.size(),
-                            union_id_parser_, fragment_);
+                            *union_id_parser_, fragment_, flat_);
     }
   }
 
@@ -488,8 +531,9 @@ class UnionAdjList {
  private:
   std::vector<adj_list_t> adj_lists_;
   prop_id_t default_prop_id_;
-  UnionIdParser<VID_T> union_id_parser_;
+  const UnionIdParser<VID_T>* union_id_parser_;
   const FRAGMENT_T* fragment_;
+  bool flat_;
   size_t size_;
 };
 
@@ -834,7 +878,32 @@ class ArrowFlattenedFragment {
     return fragment_->GetInnerVertexGid(v_);
   }
 
+  /**
+   * @brief Copies the valid edges of the inner vertices into a CSR of their
+   * own, with continuous lids as neighbors and the edge data of e_prop_id as
+   * a single column, so that their adjacent lists are neither merged from per
+   * label lists nor filtered by the vertex labels of the neighbors when
+   * iterated. The adjacent lists of outer vertices are left as they are.
+   *
+   * Only arithmetic or empty edge data can be materialized.
+   *
+   * @return false if the edge data cannot be materialized.
+   */
+  bool Materialize(int thread_num = std::thread::hardware_concurrency()) {
+    return materialize(
+        thread_num,
+        std::integral_constant<bool,
+                               std::is_arithmetic<edata_t>::value ||
+                                   std::is_same<edata_t,
+                                                grape::EmptyType>::value>());
+  }
+
+  inline bool materialized() const { return !oe_csr_.offsets.empty(); }
+
   inline adj_list_t GetOutgoingAdjList(const vertex_t& v) const {
+    if (v.GetValue() < ivnum_ && materialized()) {
+      return flatAdjList(oe_csr_, v.GetValue());
+    }
     vertex_t v_(union_id_parser_.ParseContinuousLid(v.GetValue()));
     std::vector<vineyard::property_graph_utils::AdjList<vid_t, eid_t>>
         adj_lists;
@@ -855,6 +924,9 @@ class ArrowFlattenedFragment {
   }
 
   inline adj_list_t GetIncomingAdjList(const vertex_t& v) const {
+    if (v.GetValue() < ivnum_ && materialized()) {
+      return flatAdjList(directed() ? ie_csr_ : oe_csr_, v.GetValue());
+    }
     vertex_t v_(union_id_parser_.ParseContinuousLid(v.GetValue()));
     std::vector<vineyard::property_graph_utils::AdjList<vid_t, eid_t>>
         adj_lists;
@@ -953,6 +1025,106 @@ class ArrowFlattenedFragment {
   }
 
  private:
+  struct FlatCSR {
+    std::vector<int64_t> offsets;
+    std::vector<vineyard::property_graph_utils::NbrUnit<vid_t, eid_t>> nbrs;
+    std::vector<edata_t> edata;
+    // The columns the nbrs read their edata from, by property id.
+    std::vector<const void*> edata_arrays;
+  };
+
+  inline adj_list_t flatAdjList(const FlatCSR& csr, vid_t lid) const {
+    std::vector<vineyard::property_graph_utils::AdjList<vid_t, eid_t>>
+        adj_lists;
+    int64_t begin = csr.offsets[lid], end = csr.offsets[lid + 1];
+    if (begin != end) {
+      adj_lists.emplace_back(csr.nbrs.data() + begin, csr.nbrs.data() + end,
+                             const_cast<const void**>(csr.edata_arrays.data()));
+    }
+    return adj_list_t(std::move(adj_lists), e_prop_id_, union_id_parser_, this,
+                      true);
+  }
+
+  bool materialize(int thread_num, std::false_type) {
+    LOG(WARNING) << "Edge data of type " << vineyard::type_name<edata_t>()
+                 << " cannot be materialized";
+    return false;
+  }
+
+  bool materialize(int thread_num, std::true_type) {
+    materializeCSR(true, thread_num, oe_csr_);
+    if (directed()) {
+      materializeCSR(false, thread_num, ie_csr_);
+    }
+    return true;
+  }
+
+  void materializeCSR(bool outgoing, int thread_num, FlatCSR& csr) {
+    auto& schema = fragment_->schema();
+    label_id_t edge_label_num =
+        static_cast<label_id_t>(schema.AllEdgeEntries().size());
+    auto adj_list_of = [&](const vertex_t& v, label_id_t e_label) {
+      return outgoing ? fragment_->GetOutgoingAdjList(v, e_label)
+                      : fragment_->GetIncomingAdjList(v, e_label);
+    };
+
+    csr.offsets.clear();
+    csr.offsets.resize(ivnum_ + 1, 0);
+    vineyard::parallel_for(
+        static_cast<vid_t>(0), ivnum_,
+        [&](vid_t i) {
+          vertex_t v(union_id_parser_.ParseContinuousLid(i));
+          int64_t degree = 0;
+          for (label_id_t e_label = 0; e_label < edge_label_num; e_label++) {
+            if (!schema.IsEdgeValid(e_label)) {
+              continue;
+            }
+            for (const auto& nbr : adj_list_of(v, e_label)) {
+              if (is_valid_vertex(nbr.neighbor())) {
+                ++degree;
+              }
+            }
+          }
+          csr.offsets[i + 1] = degree;
+        },
+        thread_num, 1024);
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      csr.offsets[i + 1] += csr.offsets[i];
+    }
+
+    csr.nbrs.resize(csr.offsets[ivnum_]);
+    csr.edata.resize(csr.offsets[ivnum_]);
+    vineyard::parallel_for(
+        static_cast<vid_t>(0), ivnum_,
+        [&](vid_t i) {
+          vertex_t v(union_id_parser_.ParseContinuousLid(i));
+          int64_t pos = csr.offsets[i];
+          for (label_id_t e_label = 0; e_label < edge_label_num; e_label++) {
+            if (!schema.IsEdgeValid(e_label)) {
+              continue;
+            }
+            for (const auto& nbr : adj_list_of(v, e_label)) {
+              if (!is_valid_vertex(nbr.neighbor())) {
+                continue;
+              }
+              csr.nbrs[pos].vid = union_id_parser_.GenerateContinuousLid(
+                  nbr.neighbor().GetValue());
+              csr.nbrs[pos].eid = static_cast<eid_t>(pos);
+              csr.edata[pos] =
+                  arrow_flattened_fragment_impl::FlatEdata<edata_t>::Get(
+                      nbr, e_prop_id_);
+              ++pos;
+            }
+          }
+        },
+        thread_num, 1024);
+
+    csr.edata_arrays.assign(std::max<prop_id_t>(e_prop_id_ + 1, 1), nullptr);
+    if (e_prop_id_ >= 0) {
+      csr.edata_arrays[e_prop_id_] = csr.edata.data();
+    }
+  }
+
   fragment_t* fragment_;
   const vineyard::PropertyGraphSchema& schema_;
   prop_id_t v_prop_id_;
@@ -965,6 +1137,9 @@ class ArrowFlattenedFragment {
 
   arrow_flattened_fragment_impl::UnionIdParser<vid_t> union_id_parser_;
   std::vector<vid_t> union_vertex_range_offset_;
+
+  // Filled by Materialize(), ie_csr_ only if directed.
+  FlatCSR oe_csr_, ie_csr_;
 };
 
 }  // namespace gs
@@ -21,6 +21,7 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
 #include <map>
@@ -126,6 +127,10 @@ class DynamicFragment
   void Init(fid_t fid, bool directed, std::vector<internal_vertex_t>& vertices,
             std::vector<edge_t>& edges) override {
     init(fid, directed);
+    invalidateEdgeNums();
+    // The edges loaded keep their data as objects.
+    edata_layout_ =
+        edges.empty() ? EdataLayout::kUndecided : EdataLayout::kDynamic;
 
     load_strategy_ = directed ? grape::LoadStrategy::kBothOutIn
                               : grape::LoadStrategy::kOnlyOut;
@@ -194,24 +199,36 @@ class DynamicFragment
     Init(fid, directed, empty_vertices, empty_edges);
   }
 
-  // Init fragment from arrow property fragment.
+  // Init fragment from arrow property fragment, with the degrees of the inner
+  // vertices counted by the converter. The degrees of the outer vertices
+  // follow the order in which their local ids are assigned here, so they are
+  // counted here as well.
   void Init(fid_t fid, bool directed,
             std::vector<std::vector<internal_vertex_t>>& vertices,
             std::vector<std::vector<edge_t>>& edges,
             std::vector<int>& inner_oe_degree,
-            std::vector<int>& outer_oe_degree,
-            std::vector<int>& inner_ie_degree,
-            std::vector<int>& outer_ie_degree, uint32_t thread_num) {
+            std::vector<int>& inner_ie_degree, uint32_t thread_num) {
     init(fid, directed);
+    invalidateEdgeNums();
+    edata_layout_ = EdataLayout::kDynamic;
     load_strategy_ = directed ? grape::LoadStrategy::kBothOutIn
                               : grape::LoadStrategy::kOnlyOut;
 
     ovnum_ = 0;
+    std::vector<int> outer_oe_degree, outer_ie_degree;
+    auto add_outer_vertex = [&](vid_t gid) {
+      vid_t index = outerVertexLidToIndex(parseOrAddOuterVertexGid(gid));
+      if (index == outer_oe_degree.size()) {
+        outer_oe_degree.push_back(0);
+        outer_ie_degree.push_back(0);
+      }
+      return index;
+    };
     if (load_strategy_ == grape::LoadStrategy::kOnlyOut) {
       for (auto& vec : edges) {
         for (auto& e : vec) {
           if (!IsInnerVertexGid(e.dst)) {
-            parseOrAddOuterVertexGid(e.dst);
+            ++outer_oe_degree[add_outer_vertex(e.dst)];
           }
         }
       }
@@ -220,10 +237,10 @@ class DynamicFragment
         for (auto& e : vec) {
           if (IsInnerVertexGid(e.src)) {
             if (!IsInnerVertexGid(e.dst)) {
-              parseOrAddOuterVertexGid(e.dst);
+              ++outer_ie_degree[add_outer_vertex(e.dst)];
             }
           } else {
-            parseOrAddOuterVertexGid(e.src);
+            ++outer_oe_degree[add_outer_vertex(e.src)];
           }
         }
       }
@@ -252,11 +269,35 @@ class DynamicFragment
     initSchema();
   }
 
+  /**
+   * @brief What the mutations of the fragment have changed, for an app to
+   * bring its result up to date with, see IncrementalWorker.
+   *
+   * The edges added are kept as pairs of the local ids of their ends, which
+   * stay the same over mutations. The mutations that remove or update
+   * vertices or edges, after which a result may not be monotone any more,
+   * are only counted, including the edges added again, whose data may have
+   * changed.
+   */
+  struct MutationLog {
+    std::vector<std::pair<vid_t, vid_t>> edges_added;
+    size_t other_mutations = 0;
+  };
+
+  const MutationLog& GetMutationLog() const { return mutation_log_; }
+
   using base_t::Gid2Lid;
   using base_t::ie_;
   using base_t::oe_;
   using base_t::vm_ptr_;
   void Mutate(mutation_t& mutation) {
+    invalidateEdgeNums();
+    if (!mutation.vertices_to_remove.empty() ||
+        !mutation.edges_to_remove.empty() ||
+        !mutation.edges_to_update.empty()) {
+      ++mutation_log_.other_mutations;
+    }
+    encodeEdges(mutation);
     vertex_t v;
     if (!mutation.vertices_to_remove.empty() &&
         static_cast<double>(mutation.vertices_to_remove.size()) /
@@ -423,17 +464,21 @@ class DynamicFragment
   }
 
   inline size_t GetEdgeNum() const override {
-    size_t res = this->directed_ ? oe_.head_edge_num() + ie_.head_edge_num()
-                                 : oe_.head_edge_num() + is_selfloops_.count();
+    size_t res = edge_num_.load(std::memory_order_relaxed);
+    if (res == kUncounted) {
+      res = this->directed_ ? oe_.head_edge_num() + ie_.head_edge_num()
+                            : oe_.head_edge_num() + selfloops_num();
+      edge_num_.store(res, std::memory_order_relaxed);
+    }
     return res;
   }
 
   inline size_t GetOutgoingEdgeNum() const {
-    return oe_.head_edge_num() + is_selfloops_.count();
+    return oe_.head_edge_num() + selfloops_num();
   }
 
   inline size_t GetIncomingEdgeNum() const {
-    return ie_.head_edge_num() + is_selfloops_.count();
+    return ie_.head_edge_num() + selfloops_num();
   }
 
   using base_t::InnerVertices;
@@ -505,6 +550,7 @@ class DynamicFragment
   }
 
   void ClearEdges() {
+    invalidateEdgeNums();
     if (load_strategy_ == grape::LoadStrategy::kBothOutIn) {
       ie_.clear_edges();
     }
@@ -517,13 +563,16 @@ class DynamicFragment
     this->ovnum_ = 0;
     this->alive_ovnum_ = 0;
     is_selfloops_.clear();
+    edata_layout_ = EdataLayout::kUndecided;
   }
 
   void CopyFrom(std::shared_ptr<DynamicFragment> source,
                 const std::string& copy_type = "identical") {
     init(source->fid_, source->directed_);
+    invalidateEdgeNums();
     load_strategy_ = source->load_strategy_;
     copyVertices(source);
+    copyEdataLayout(source);
 
     // copy edges
     auto vnum = id_parser_.max_local_id();
@@ -631,8 +680,10 @@ class DynamicFragment
   void ToDirectedFrom(std::shared_ptr<DynamicFragment> source) {
     assert(!source->directed_);
     init(source->fid_, true);
+    invalidateEdgeNums();
     load_strategy_ = grape::LoadStrategy::kBothOutIn;
     copyVertices(source);
+    copyEdataLayout(source);
 
     // both inner and outer vertices with the empty slots
     auto vnum = id_parser_.max_local_id();
@@ -670,8 +721,10 @@ class DynamicFragment
   void ToUndirectedFrom(std::shared_ptr<DynamicFragment> source) {
     assert(source->directed_);
     init(source->fid_, false);
+    invalidateEdgeNums();
     load_strategy_ = grape::LoadStrategy::kOnlyOut;
     copyVertices(source);
+    copyEdataLayout(source);
 
     // both inner and outer vertices with the empty slots
     // only use oe_ in the undirected graph
@@ -706,6 +759,7 @@ class DynamicFragment
       const std::vector<oid_t>& induced_vertices,
       const std::vector<std::pair<oid_t, oid_t>>& induced_edges) {
     Init(source->fid_, source->directed_);
+    copyEdataLayout(source);
 
     mutation_t mutation;
     if (induced_edges.empty()) {
@@ -720,7 +774,14 @@ class DynamicFragment
     return vm_ptr_->_GetGid(oid, gid);
   }
 
-  inline size_t selfloops_num() const { return is_selfloops_.count(); }
+  inline size_t selfloops_num() const {
+    size_t res = selfloops_num_.load(std::memory_order_relaxed);
+    if (res == kUncounted) {
+      res = is_selfloops_.count();
+      selfloops_num_.store(res, std::memory_order_relaxed);
+    }
+    return res;
+  }
 
   inline bool HasNode(const oid_t& node) const {
     vid_t gid;
@@ -760,7 +821,7 @@ class DynamicFragment
           Gid2Lid(vid, vlid) && iv_alive_.get_bit(ulid)) {
         auto iter = oe_.binary_find(ulid, vlid);
         if (iter != oe_.get_end(ulid)) {
-          data = iter->data;
+          data = GetEdgeAttrs(iter->data);
           return true;
         }
       } else if (IsInnerVertexGid(vid) && InnerVertexGid2Lid(vid, vlid) &&
@@ -769,7 +830,7 @@ class DynamicFragment
                               : oe_.binary_find(vlid, ulid);
         auto end = directed_ ? ie_.get_end(vlid) : oe_.get_end(vlid);
         if (iter != end) {
-          data = iter->data;
+          data = GetEdgeAttrs(iter->data);
           return true;
         }
       }
@@ -789,6 +850,26 @@ class DynamicFragment
 
   const dynamic::Value& GetSchema() { return schema_; }
 
+  // The attribute `key` of the data of an edge, or nullptr if it has none.
+  inline const rapidjson::Value* GetEdgeAttr(const edata_t& data,
+                                             const std::string& key) const {
+    if (!data.IsObject()) {
+      return key == edata_key_ ? &data : nullptr;
+    }
+    auto iter = data.FindMember(key);
+    return iter == data.MemberEnd() ? nullptr : &iter->value;
+  }
+
+  // The attributes of the data of an edge, as an object.
+  inline edata_t GetEdgeAttrs(const edata_t& data) const {
+    if (data.IsObject()) {
+      return data;
+    }
+    edata_t attrs(rapidjson::kObjectType);
+    attrs.Insert(edata_key_, data);
+    return attrs;
+  }
+
  public:
   using base_t::GetOutgoingAdjList;
   inline adj_list_t GetIncomingAdjList(const vertex_t& v) override {
@@ -905,6 +986,13 @@ class DynamicFragment
   }
 
  private:
+  // Drops the numbers of edges and selfloops, which are counted again when
+  // asked for, after the edges change.
+  void invalidateEdgeNums() {
+    edge_num_.store(kUncounted, std::memory_order_relaxed);
+    selfloops_num_.store(kUncounted, std::memory_order_relaxed);
+  }
+
   inline vid_t outerVertexLidToIndex(vid_t lid) const {
     return id_parser_.max_local_id() - lid - 1;
   }
@@ -1036,7 +1124,7 @@ class DynamicFragment
         if (e.src == invalid_vid) {
           continue;
         }
-        if (updateOrAddEdgeOutIn(e)) {
+        if (logEdgeAdded(e, updateOrAddEdgeOutIn(e))) {
           if (e.src < ivnum_) {
             ++inner_oe_degree_to_add[e.src];
           } else {
@@ -1082,7 +1170,7 @@ class DynamicFragment
         if (e.src == invalid_vid) {
           continue;
         }
-        if (updateOrAddEdgeOut(e)) {
+        if (logEdgeAdded(e, updateOrAddEdgeOut(e))) {
           if (e.src < ivnum_) {
             ++inner_oe_degree_to_add[e.src];
           } else {
@@ -1121,7 +1209,7 @@ class DynamicFragment
         if (e.src == invalid_vid) {
           continue;
         }
-        if (updateOrAddEdgeOutIn(e)) {
+        if (logEdgeAdded(e, updateOrAddEdgeOutIn(e))) {
           ++oe_degree_to_add[e.src];
           ++ie_degree_to_add[e.dst];
         }
@@ -1146,7 +1234,7 @@ class DynamicFragment
         if (e.src == invalid_vid) {
           continue;
         }
-        if (updateOrAddEdgeOut(e)) {
+        if (logEdgeAdded(e, updateOrAddEdgeOut(e))) {
           ++oe_degree_to_add[e.src];
           if (e.src != e.dst) {
             ++oe_degree_to_add[e.dst];
@@ -1157,6 +1245,15 @@ class DynamicFragment
     }
   }
 
+  bool logEdgeAdded(const edge_t& e, bool added) {
+    if (added) {
+      mutation_log_.edges_added.emplace_back(e.src, e.dst);
+    } else {
+      ++mutation_log_.other_mutations;
+    }
+    return added;
+  }
+
   // Return true if add a new edge, otherwise false.
   bool updateOrAddEdgeOut(const edge_t& e) {
     bool ret = false;  // assume it just update existed edge.
@@ -1167,7 +1264,7 @@ class DynamicFragment
         oe_.put_edge(e.src, nbr_t(e.dst, e.edata));
         ret = true;
       } else {
-        iter->data.Update(e.edata);
+        updateEdata(iter->data, e.edata);
       }
       if (ret && e.src == e.dst) {
         is_selfloops_.set_bit(e.src);
@@ -1181,7 +1278,7 @@ class DynamicFragment
         oe_.put_edge(e.dst, nbr_t(e.src, e.edata));
         ret = true;
       } else {
-        iter->data.Update(e.edata);
+        updateEdata(iter->data, e.edata);
       }
     }
     return ret;
@@ -1197,7 +1294,7 @@ class DynamicFragment
         oe_.put_edge(e.src, nbr_t(e.dst, e.edata));
         ret = true;
       } else {
-        iter->data.Update(e.edata);
+        updateEdata(iter->data, e.edata);
       }
       if (ret && e.src == e.dst) {
         is_selfloops_.set_bit(e.src);
@@ -1210,7 +1307,7 @@ class DynamicFragment
         ie_.put_edge(e.dst, nbr_t(e.src, e.edata));
         ret = true;
       } else {
-        iter->data.Update(e.edata);
+        updateEdata(iter->data, e.edata);
       }
     }
     return ret;
@@ -1467,6 +1564,123 @@ class DynamicFragment
     schema_.Insert("edge", dynamic::Value(rapidjson::kObjectType));
   }
 
+  void copyEdataLayout(const std::shared_ptr<DynamicFragment>& source) {
+    edata_layout_ = source->edata_layout_;
+    edata_key_ = source->edata_key_;
+    edata_type_ = source->edata_type_;
+  }
+
+  // Whether an edge attribute fits the typed edge data, which takes the key
+  // and the type of the first attribute offered.
+  bool acceptTypedEdgeAttr(const std::string& key,
+                           const rapidjson::Value& value) {
+    if (edata_layout_ == EdataLayout::kDynamic ||
+        !(value.IsBool() || value.IsInt64() || value.IsDouble() ||
+          value.IsString())) {
+      return false;
+    }
+    auto type = dynamic::GetType(value);
+    if (edata_layout_ == EdataLayout::kUndecided) {
+      edata_layout_ = EdataLayout::kTyped;
+      edata_key_ = key;
+      edata_type_ = type;
+      return true;
+    }
+    return key == edata_key_ && type == edata_type_;
+  }
+
+  bool fitsTypedEdata(const edata_t& data) {
+    if (!data.IsObject()) {
+      // Already typed, as the data of the edges of a typed source fragment.
+      CHECK(edata_layout_ == EdataLayout::kTyped);
+      return true;
+    }
+    if (data.ObjectEmpty()) {
+      return true;
+    }
+    auto member = data.MemberBegin();
+    return data.MemberCount() == 1 &&
+           acceptTypedEdgeAttr(member->name.GetString(), member->value);
+  }
+
+  // Boxes typed edge data in an object.
+  void wrapEdata(edata_t& data) const {
+    if (!data.IsObject()) {
+      edata_t attrs(rapidjson::kObjectType);
+      attrs.Insert(edata_key_, data);
+      data = std::move(attrs);
+    }
+  }
+
+  // Brings the data of the edges to mutate to the layout of the fragment.
+  // The first edge that does not fit the typed layout turns the data of all
+  // the edges, stored or to store, back to objects for good.
+  void encodeEdges(mutation_t& mutation) {
+    if (edata_layout_ == EdataLayout::kDynamic) {
+      return;
+    }
+    bool fits = true;
+    for (auto* edges : {&mutation.edges_to_add, &mutation.edges_to_update}) {
+      for (auto& e : *edges) {
+        fits = fits && fitsTypedEdata(e.edata);
+      }
+    }
+    if (!fits) {
+      if (edata_layout_ == EdataLayout::kTyped) {
+        auto wrap = [this](csr_t& csr, vid_t lid) {
+          for (auto iter = csr.get_begin(lid); iter != csr.get_end(lid);
+               ++iter) {
+            wrapEdata(iter->data);
+          }
+        };
+        for (auto v : this->Vertices()) {
+          wrap(oe_, v.GetValue());
+          if (load_strategy_ == grape::LoadStrategy::kBothOutIn) {
+            wrap(ie_, v.GetValue());
+          }
+        }
+        for (auto* edges :
+             {&mutation.edges_to_add, &mutation.edges_to_update}) {
+          for (auto& e : *edges) {
+            wrapEdata(e.edata);
+          }
+        }
+      }
+      edata_layout_ = EdataLayout::kDynamic;
+      return;
+    }
+    for (auto* edges : {&mutation.edges_to_add, &mutation.edges_to_update}) {
+      for (auto& e : *edges) {
+        if (e.edata.IsObject() && !e.edata.ObjectEmpty()) {
+          rapidjson::Value value;
+          value.Swap(e.edata.MemberBegin()->value);
+          e.edata.Swap(value);
+        }
+      }
+    }
+  }
+
+  // Merges the data of an edge added again into the stored one.
+  inline void updateEdata(edata_t& data, const edata_t& update) {
+    if (!update.IsObject()) {
+      data = update;
+    } else {
+      data.Update(update);
+    }
+  }
+
+  // How the edges keep their attributes. The edges of a networkx graph
+  // whose attributes are all one scalar key of one type, e.g. a double
+  // "weight", are typed: each nbr keeps the bare value, or an empty object
+  // for no attributes, so that an edge takes no allocation of its own. Any
+  // other attributes keep the whole object, which the edges fall back to
+  // once a mutation brings in another key or type.
+  enum class EdataLayout {
+    kUndecided,  // no edge with attributes yet
+    kTyped,
+    kDynamic,
+  };
+
  private:
   using base_t::ivnum_;
   vid_t ovnum_;
@@ -1484,6 +1698,14 @@ class DynamicFragment
   grape::Bitset ov_alive_;
   grape::Bitset is_selfloops_;
 
+  // The numbers of edges and selfloops, counted by the first GetEdgeNum()
+  // and selfloops_num() after the edges change rather than by each, as the
+  // NetworkX client asks for them after nearly every mutation. Atomic since
+  // apps may ask from several threads.
+  static constexpr size_t kUncounted = std::numeric_limits<size_t>::max();
+  mutable std::atomic<size_t> edge_num_{kUncounted};
+  mutable std::atomic<size_t> selfloops_num_{kUncounted};
+
   grape::VertexArray<inner_vertices_t, nbr_t*> iespliter_, oespliter_;
 
   // allocators for parallel convert
@@ -1491,6 +1713,13 @@ class DynamicFragment
 
   dynamic::Value schema_;
 
+  MutationLog mutation_log_;
+
+  EdataLayout edata_layout_ = EdataLayout::kDynamic;
+  // The key and the type of the only attribute of the typed edges.
+  std::string edata_key_;
+  dynamic::Type edata_type_ = dynamic::Type::kNullType;
+
   using base_t::outer_vertices_of_frag_;
 
   template <typename _vdata_t, typename _edata_t>
@@ -1590,12 +1819,17 @@ class DynamicFragmentMutator {
     for (auto& e : edges_to_modify) {
       // the edge could be [src, dst] or [srs, dst, value] or [src, dst,
       // {"key": val}]
-      e_data = common_attrs;
-      if (e.Size() == 3) {
-        if (weight.empty()) {
-          e_data.Update(edata_t(e[2]));
-        } else {
-          e_data.Insert(weight, edata_t(e[2]));
+      bool typed = e.Size() == 3 && modify_type != rpc::NX_DEL_EDGES &&
+                   common_attrs.IsObject() && common_attrs.ObjectEmpty() &&
+                   makeTypedEdata(e[2], weight, e_data);
+      if (!typed) {
+        e_data = common_attrs;
+        if (e.Size() == 3) {
+          if (weight.empty()) {
+            e_data.Update(edata_t(e[2]));
+          } else {
+            e_data.Insert(weight, edata_t(e[2]));
+          }
         }
       }
       src = std::move(e[0]);
@@ -1623,15 +1857,11 @@ class DynamicFragmentMutator {
                                                   std::move(empty_data));
           }
         }
-        if (e_data.IsObject() && !e_data.GetObject().ObjectEmpty()) {
+        if (!e_data.IsObject()) {
+          addEdgeSchema(dynamic::Value(fragment_->edata_key_), e_data);
+        } else if (!e_data.GetObject().ObjectEmpty()) {
           for (const auto& prop : e_data.GetObject()) {
-            if (!fragment_->schema_["edge"].HasMember(prop.name)) {
-              dynamic::Value key(prop.name);
-              fragment_->schema_["edge"].AddMember(
-                  key,
-                  dynamic::DynamicType2RpcType(dynamic::GetType(prop.value)),
-                  dynamic::Value::allocator_);
-            }
+            addEdgeSchema(prop.name, prop.value);
           }
         }
       } else {
@@ -1660,6 +1890,35 @@ class DynamicFragmentMutator {
   }
 
  private:
+  // Takes the only attribute of an edge as its data if it fits the typed
+  // edge data of the fragment, which saves boxing it in an object.
+  bool makeTypedEdata(rapidjson::Value& attr, const std::string& weight,
+                      edata_t& e_data) {
+    rapidjson::Value* value = &attr;
+    if (weight.empty()) {
+      if (!attr.IsObject() || attr.MemberCount() != 1 ||
+          !fragment_->acceptTypedEdgeAttr(attr.MemberBegin()->name.GetString(),
+                                          attr.MemberBegin()->value)) {
+        return false;
+      }
+      value = &attr.MemberBegin()->value;
+    } else if (!fragment_->acceptTypedEdgeAttr(weight, attr)) {
+      return false;
+    }
+    e_data = *value;
+    return true;
+  }
+
+  void addEdgeSchema(const rapidjson::Value& name,
+                     const rapidjson::Value& value) {
+    if (!fragment_->schema_["edge"].HasMember(name)) {
+      dynamic::Value key(name);
+      fragment_->schema_["edge"].AddMember(
+          key, dynamic::DynamicType2RpcType(dynamic::GetType(value)),
+          dynamic::Value::allocator_);
+    }
+  }
+
   grape::CommSpec comm_spec_;
   std::shared_ptr<fragment_t> fragment_;
   std::shared_ptr<vertex_map_t> vm_ptr_;
@@ -73,28 +73,35 @@ unpack_dynamic(const dynamic::Value& data, const std::string& v_prop_key) {
   return grape::EmptyType();
 }
 
+// The attribute `key` of the data of an edge, which typed edge data keeps
+// bare, see DynamicFragment::EdataLayout.
+inline const rapidjson::Value& edge_attr(const dynamic::Value& d,
+                                         const char* key) {
+  return d.IsObject() ? d[key] : static_cast<const rapidjson::Value&>(d);
+}
+
 template <typename VID_T, typename T>
 typename std::enable_if<std::is_integral<T>::value>::type unpack_nbr(
     grape::Nbr<VID_T, T>& nbr, const dynamic::Value& d, const char* key) {
-  nbr.data = d[key].GetInt64();
+  nbr.data = edge_attr(d, key).GetInt64();
 }
 
 template <typename VID_T, typename T>
 typename std::enable_if<std::is_floating_point<T>::value>::type unpack_nbr(
     grape::Nbr<VID_T, T>& nbr, const dynamic::Value& d, const char* key) {
-  nbr.data = d[key].GetDouble();
+  nbr.data = edge_attr(d, key).GetDouble();
 }
 
 template <typename VID_T, typename T>
 typename std::enable_if<std::is_same<std::string, T>::value>::type unpack_nbr(
     grape::Nbr<VID_T, T>& nbr, const dynamic::Value& d, const char* key) {
-  nbr.data = d[key].GetString();
+  nbr.data = edge_attr(d, key).GetString();
 }
 
 template <typename VID_T, typename T>
 typename std::enable_if<std::is_same<bool, T>::value>::type unpack_nbr(
     grape::Nbr<VID_T, T>& nbr, const dynamic::Value& d, const char* key) {
-  nbr.data = d[key].GetBool();
+  nbr.data = edge_attr(d, key).GetBool();
 }
 
 template <typename VID_T, typename T>
@@ -527,6 +534,10 @@ class DynamicProjectedFragment {
     return fragment_->IsAliveInnerVertex(v);
   }
 
+  inline const typename fragment_t::MutationLog& GetMutationLog() const {
+    return fragment_->GetMutationLog();
+  }
+
   inline bool HasChild(const vertex_t& v) const {
     return fragment_->HasChild(v);
   }
@@ -851,6 +862,10 @@ class DynamicProjectedFragment<grape::EmptyType, grape::EmptyType> {
     return fragment_->IsAliveInnerVertex(v);
   }
 
+  inline const typename fragment_t::MutationLog& GetMutationLog() const {
+    return fragment_->GetMutationLog();
+  }
+
   inline bool HasChild(const vertex_t& v) const {
     return fragment_->HasChild(v);
   }
@@ -226,7 +226,7 @@ class DynamicFragmentReporter : public grape::Communicator {
         ? edges = fragment->GetIncomingAdjList(v)
         : edges = fragment->GetOutgoingAdjList(v);
     for (const auto& e : edges) {
-      data_array.PushBack(e.data);
+      data_array.PushBack(fragment->GetEdgeAttrs(e.data));
     }
     arc << data_array;
   }
@@ -335,7 +335,7 @@ class DynamicFragmentReporter : public grape::Communicator {
             ? edges = fragment->GetIncomingAdjList(v)
             : edges = fragment->GetOutgoingAdjList(v);
         for (const auto& e : edges) {
-          neighbor_attrs.PushBack(e.data);
+          neighbor_attrs.PushBack(fragment->GetEdgeAttrs(e.data));
         }
         adj_list.PushBack(neighbor_attrs);
         ++cnt;
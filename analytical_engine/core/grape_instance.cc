@@ -351,11 +351,11 @@ bl::result<void> GrapeInstance::unloadContext(const rpc::GSParams& params) {
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::reportGraph(
-    const rpc::GSParams& params) {
+    const grape::CommSpec& comm_spec, const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
-  return wrapper->ReportGraph(comm_spec_, params);
+  return wrapper->ReportGraph(comm_spec, params);
 }
 
 bl::result<rpc::graph::GraphDefPb> GrapeInstance::modifyVertices(
@@ -451,7 +451,7 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::modifyEdges(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
-    const rpc::GSParams& params) {
+    const grape::CommSpec& comm_spec, const rpc::GSParams& params) {
   std::string s_selector;
   std::pair<std::string, std::string> range;
   std::shared_ptr<IContextWrapper> base_ctx_wrapper;
@@ -465,32 +465,32 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
     BOOST_LEAF_AUTO(axis, params.Get<int64_t>(rpc::AXIS));
 
-    return wrapper->ToNdArray(comm_spec_, axis);
+    return wrapper->ToNdArray(comm_spec, axis);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
 #ifdef ENABLE_JAVA_SDK
   } else if (ctx_type.find(CONTEXT_TYPE_JAVA_PIE_PROPERTY) !=
              std::string::npos) {
@@ -504,7 +504,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
     auto wrapper = std::dynamic_pointer_cast<IJavaPIEPropertyContextWrapper>(
         base_ctx_wrapper);
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
   } else if (ctx_type.find(CONTEXT_TYPE_JAVA_PIE_PROJECTED) !=
              std::string::npos) {
     std::vector<std::string> outer_and_inner;
@@ -517,7 +517,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
     auto wrapper = std::dynamic_pointer_cast<IJavaPIEProjectedContextWrapper>(
         base_ctx_wrapper);
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec, selector, range);
 #endif
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
@@ -536,7 +536,7 @@ bl::result<std::string> GrapeInstance::getContextData(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
-    const rpc::GSParams& params) {
+    const grape::CommSpec& comm_spec, const rpc::GSParams& params) {
   std::string s_selector;
   std::pair<std::string, std::string> range;
   std::shared_ptr<IContextWrapper> base_ctx_wrapper;
@@ -549,32 +549,32 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
     auto wrapper =
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
 
-    return wrapper->ToDataframe(comm_spec_);
+    return wrapper->ToDataframe(comm_spec);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
 #ifdef ENABLE_JAVA_SDK
   } else if (ctx_type.find(CONTEXT_TYPE_JAVA_PIE_PROPERTY) !=
              std::string::npos) {
@@ -588,7 +588,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
     auto wrapper = std::dynamic_pointer_cast<IJavaPIEPropertyContextWrapper>(
         base_ctx_wrapper);
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
   } else if (ctx_type.find(CONTEXT_TYPE_JAVA_PIE_PROJECTED) !=
              std::string::npos) {
     std::vector<std::string> outer_and_inner;
@@ -601,7 +601,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
     auto wrapper = std::dynamic_pointer_cast<IJavaPIEProjectedContextWrapper>(
         base_ctx_wrapper);
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selector));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec, selectors, range);
 #endif
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
@@ -1222,7 +1222,7 @@ bl::result<rpc::graph::GraphDefPb> GrapeInstance::consolidateColumns(
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToNumpy(
-    const rpc::GSParams& params) {
+    const grape::CommSpec& comm_spec, const rpc::GSParams& params) {
   std::pair<std::string, std::string> range;
 
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
@@ -1236,11 +1236,11 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToNumpy(
   }
   BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
 
-  return wrapper->ToNdArray(comm_spec_, selector, range);
+  return wrapper->ToNdArray(comm_spec, selector, range);
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
-    const rpc::GSParams& params) {
+    const grape::CommSpec& comm_spec, const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
 
   BOOST_LEAF_AUTO(
@@ -1256,7 +1256,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
   BOOST_LEAF_AUTO(s_selector, params.Get<std::string>(rpc::SELECTOR));
   BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selector));
 
-  return wrapper->ToDataframe(comm_spec_, selectors, range);
+  return wrapper->ToDataframe(comm_spec, selectors, range);
 }
 
 bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
@@ -1292,7 +1292,7 @@ bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
 }
 
 bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
-    std::shared_ptr<CommandDetail> cmd) {
+    std::shared_ptr<CommandDetail> cmd, const grape::CommSpec& comm_spec) {
   auto r = std::make_shared<DispatchResult>(comm_spec_.worker_id());
   rpc::GSParams params(cmd->params, cmd->large_attr);
 
@@ -1329,7 +1329,7 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::REPORT_GRAPH: {
-    BOOST_LEAF_AUTO(arc, reportGraph(params));
+    BOOST_LEAF_AUTO(arc, reportGraph(comm_spec, params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirstNonEmpty,
                 true);
     break;
@@ -1461,12 +1461,12 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::CONTEXT_TO_NUMPY: {
-    BOOST_LEAF_AUTO(arc, contextToNumpy(params));
+    BOOST_LEAF_AUTO(arc, contextToNumpy(comm_spec, params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst, true);
     break;
   }
   case rpc::CONTEXT_TO_DATAFRAME: {
-    BOOST_LEAF_AUTO(arc, contextToDataframe(params));
+    BOOST_LEAF_AUTO(arc, contextToDataframe(comm_spec, params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst, true);
     break;
   }
@@ -1496,12 +1496,12 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     break;
   }
   case rpc::GRAPH_TO_NUMPY: {
-    BOOST_LEAF_AUTO(arc, graphToNumpy(params));
+    BOOST_LEAF_AUTO(arc, graphToNumpy(comm_spec, params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst, true);
     break;
   }
   case rpc::GRAPH_TO_DATAFRAME: {
-    BOOST_LEAF_AUTO(arc, graphToDataframe(params));
+    BOOST_LEAF_AUTO(arc, graphToDataframe(comm_spec, params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst, true);
     break;
   }
@@ -94,7 +94,8 @@ class GrapeInstance : public Subscriber {
   void Init(const std::string& vineyard_socket);
 
   bl::result<std::shared_ptr<DispatchResult>> OnReceive(
-      std::shared_ptr<CommandDetail> cmd) override;
+      std::shared_ptr<CommandDetail> cmd,
+      const grape::CommSpec& comm_spec) override;
 
  private:
   bl::result<rpc::graph::GraphDefPb> loadGraph(const rpc::GSParams& params);
@@ -113,7 +114,7 @@ class GrapeInstance : public Subscriber {
   bl::result<void> unloadContext(const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> reportGraph(
-      const rpc::GSParams& params);
+      const grape::CommSpec& comm_spec, const rpc::GSParams& params);
 
   bl::result<rpc::graph::GraphDefPb> projectGraph(const rpc::GSParams& params);
 
@@ -130,10 +131,10 @@ class GrapeInstance : public Subscriber {
   bl::result<void> clearGraph(const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> contextToNumpy(
-      const rpc::GSParams& params);
+      const grape::CommSpec& comm_spec, const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> contextToDataframe(
-      const rpc::GSParams& params);
+      const grape::CommSpec& comm_spec, const rpc::GSParams& params);
 
   bl::result<std::string> contextToVineyardTensor(const rpc::GSParams& params);
 
@@ -171,10 +172,10 @@ class GrapeInstance : public Subscriber {
   bl::result<std::string> getContextData(const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> graphToNumpy(
-      const rpc::GSParams& params);
+      const grape::CommSpec& comm_spec, const rpc::GSParams& params);
 
   bl::result<std::shared_ptr<grape::InArchive>> graphToDataframe(
-      const rpc::GSParams& params);
+      const grape::CommSpec& comm_spec, const rpc::GSParams& params);
 
   bl::result<void> registerGraphType(const rpc::GSParams& params);
 
@@ -34,6 +34,7 @@
 #include "vineyard/common/util/status.h"
 
 #include "core/server/rpc_utils.h"
+#include "core/utils/partitioner.h"
 #include "proto/attr_value.pb.h"
 #include "proto/types.pb.h"
 
@@ -133,6 +134,7 @@ struct Graph {
   bool retain_oid = true;
   bool compact_edges = false;
   bool use_perfect_hash = false;
+  PartitionStrategy partition_strategy = PartitionStrategy::kSegmented;
   // This is used to extend the label data
   // when user try to add data to existed labels.
   // the available option is 0/1/2,
@@ -302,6 +304,13 @@ inline bl::result<std::shared_ptr<detail::Graph>> ParseCreatePropertyGraph(
   BOOST_LEAF_AUTO(use_perfect_hash,
                   params.Get<bool>(rpc::USE_PERFECT_HASH, false));
   BOOST_LEAF_AUTO(extend_type, params.Get<int64_t>(rpc::EXTEND_LABEL_DATA, 0));
+  BOOST_LEAF_AUTO(partition_strategy_name,
+                  params.Get<std::string>(rpc::PARTITION_STRATEGY, ""));
+  PartitionStrategy partition_strategy;
+  if (!ParsePartitionStrategy(partition_strategy_name, partition_strategy)) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Unknown partition strategy: " + partition_strategy_name);
+  }
 
   auto graph = std::make_shared<detail::Graph>();
   graph->directed = directed;
@@ -309,6 +318,7 @@ inline bl::result<std::shared_ptr<detail::Graph>> ParseCreatePropertyGraph(
   graph->retain_oid = retain_oid;
   graph->compact_edges = compact_edges;
   graph->use_perfect_hash = use_perfect_hash;
+  graph->partition_strategy = partition_strategy;
   graph->extend_type = extend_type;
 
   const auto& large_attr = params.GetLargeAttr();
@@ -44,26 +44,25 @@
 
 namespace gs {
 namespace graphx_raw_data_impl {
+// Wraps buffer, the strings packed one after another, with lengths as given,
+// instead of appending them to an arrow builder one by one.
 static inline std::shared_ptr<vineyard::Object> buildStringArray(
     vineyard::Client& client, std::vector<char>& buffer,
-    std::vector<int32_t> offsets) {
-  LOG(INFO) << "Building array of size: " << offsets.size();
-  using arrow_builder_t =
-      typename vineyard::ConvertToArrowType<std::string>::BuilderType;
-  arrow_builder_t builder;
-  // builder.AppendValues(raw_data);
-  ARROW_CHECK_OK(builder.Reserve(offsets.size()));
-  ARROW_CHECK_OK(builder.ReserveData(buffer.size()));
-  const char* ptr = buffer.data();
-  for (auto offset : offsets) {
-    builder.UnsafeAppend(ptr, offset);
-    ptr += offset;
-  }
-  LOG(INFO) << "Finish building arrow array";
+    const std::vector<int32_t>& lengths) {
+  LOG(INFO) << "Building array of size: " << lengths.size();
   using arrow_array_t =
       typename vineyard::ConvertToArrowType<std::string>::ArrayType;
-  std::shared_ptr<arrow_array_t> arrow_array;
-  ARROW_CHECK_OK(builder.Finish(&arrow_array));
+  using offset_t = typename arrow_array_t::offset_type;
+  std::vector<offset_t> offsets(lengths.size() + 1);
+  offsets[0] = 0;
+  for (size_t i = 0; i < lengths.size(); ++i) {
+    offsets[i + 1] = offsets[i] + lengths[i];
+  }
+  CHECK_LE(static_cast<size_t>(offsets.back()), buffer.size());
+  auto arrow_array = std::make_shared<arrow_array_t>(
+      static_cast<int64_t>(lengths.size()), arrow::Buffer::Wrap(offsets),
+      arrow::Buffer::Wrap(buffer));
+  LOG(INFO) << "Finish building arrow array";
   using vineyard_builder_t =
       typename vineyard::InternalType<std::string>::vineyard_builder_type;
   vineyard_builder_t v6d_builder(client, arrow_array);
@@ -0,0 +1,159 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_JAVA_JAVA_MESSAGE_BATCH_H_
+#define ANALYTICAL_ENGINE_CORE_JAVA_JAVA_MESSAGE_BATCH_H_
+
+#ifdef ENABLE_JAVA_SDK
+
+#include <jni.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "glog/logging.h"
+
+#include "grape/parallel/parallel_message_manager.h"
+
+#include "core/java/java_messages.h"
+#include "core/java/javasdk.h"
+
+namespace gs {
+
+static constexpr const char* JAVA_MESSAGE_BATCH_SENDER_CLASS =
+    "com/alibaba/graphscope/parallel/BatchedMessageSender";
+
+/**
+ * @brief Sends the messages of primitive type a Java app has packed into an
+ * off-heap buffer, by com.alibaba.graphscope.parallel.BatchedMessageSender,
+ * so that a batch crosses JNI once rather than once per message.
+ *
+ * An entry of a batch is kEntrySize bytes: the local id of the vertex as an
+ * int64_t, then the message, in native byte order. The fragment type is
+ * erased to let the JNI library of the SDK call into the app.
+ */
+class JavaMessageBatchSenderBase {
+ public:
+  enum Op {
+    kSyncStateOnOuterVertex = 0,
+    kSendMsgThroughOEdges = 1,
+    kSendMsgThroughIEdges = 2,
+    kSendMsgThroughEdges = 3,
+  };
+
+  enum MsgType {
+    kLongMsg = 0,
+    kDoubleMsg = 1,
+    kIntMsg = 2,
+  };
+
+  static constexpr size_t kEntrySize = 16;
+
+  virtual ~JavaMessageBatchSenderBase() = default;
+
+  virtual void Send(int op, int msg_type, int channel_id, const char* entries,
+                    size_t num) = 0;
+};
+
+template <typename FRAG_T>
+class JavaMessageBatchSender : public JavaMessageBatchSenderBase {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  JavaMessageBatchSender(const FRAG_T& frag,
+                         grape::ParallelMessageManager& messages)
+      : frag_(frag), messages_(messages) {}
+
+  void Send(int op, int msg_type, int channel_id, const char* entries,
+            size_t num) override {
+    switch (msg_type) {
+    case kLongMsg:
+      send<int64_t>(op, channel_id, entries, num);
+      break;
+    case kDoubleMsg:
+      send<double>(op, channel_id, entries, num);
+      break;
+    case kIntMsg:
+      send<int32_t>(op, channel_id, entries, num);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported message type of a batch: " << msg_type;
+    }
+  }
+
+  /**
+   * @brief Lets the Java side find this sender by the address of the message
+   * manager it has been given.
+   */
+  void Bind(JNIEnv* env, const jobject& url_class_loader) {
+    jclass sender_class = LoadClassWithClassLoader(
+        env, url_class_loader, JAVA_MESSAGE_BATCH_SENDER_CLASS);
+    CHECK_NOTNULL(sender_class);
+    jmethodID bind_method =
+        env->GetStaticMethodID(sender_class, "bind", "(JJ)V");
+    CHECK_NOTNULL(bind_method);
+    env->CallStaticVoidMethod(sender_class, bind_method,
+                              reinterpret_cast<jlong>(&messages_),
+                              reinterpret_cast<jlong>(this));
+    if (env->ExceptionCheck()) {
+      LOG(ERROR) << "Exception occurred in binding the message batch sender";
+      env->ExceptionDescribe();
+      env->ExceptionClear();
+    }
+  }
+
+ private:
+  template <typename T>
+  void send(int op, int channel_id, const char* entries, size_t num) {
+    using msg_t = PrimitiveMessage<T>;
+    for (size_t i = 0; i < num; ++i, entries += kEntrySize) {
+      int64_t lid;
+      T data;
+      memcpy(&lid, entries, sizeof(int64_t));
+      memcpy(&data, entries + sizeof(int64_t), sizeof(T));
+      vertex_t v(static_cast<vid_t>(lid));
+      msg_t msg(data);
+      switch (op) {
+      case kSyncStateOnOuterVertex:
+        messages_.SyncStateOnOuterVertex<FRAG_T, msg_t>(frag_, v, msg,
+                                                        channel_id);
+        break;
+      case kSendMsgThroughOEdges:
+        messages_.SendMsgThroughOEdges<FRAG_T, msg_t>(frag_, v, msg,
+                                                      channel_id);
+        break;
+      case kSendMsgThroughIEdges:
+        messages_.SendMsgThroughIEdges<FRAG_T, msg_t>(frag_, v, msg,
+                                                      channel_id);
+        break;
+      case kSendMsgThroughEdges:
+        messages_.SendMsgThroughEdges<FRAG_T, msg_t>(frag_, v, msg,
+                                                     channel_id);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported send of a batch: " << op;
+      }
+    }
+  }
+
+  const FRAG_T& frag_;
+  grape::ParallelMessageManager& messages_;
+};
+
+}  // namespace gs
+
+#endif
+#endif  // ANALYTICAL_ENGINE_CORE_JAVA_JAVA_MESSAGE_BATCH_H_
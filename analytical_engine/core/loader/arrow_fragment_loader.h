@@ -21,17 +21,21 @@
 #endif
 
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "boost/leaf/error.hpp"
 #include "boost/leaf/result.hpp"
+#include "grape/communication/sync_comm.h"
+#include "grape/config.h"
 #include "grape/worker/comm_spec.h"
 #include "vineyard/basic/ds/arrow_utils.h"
 #include "vineyard/client/client.h"
@@ -43,6 +47,7 @@
 
 #include "core/error.h"
 #include "core/io/property_parser.h"
+#include "core/utils/partitioner.h"
 #ifdef ENABLE_JAVA_SDK
 #include "core/java/java_loader_invoker.h"
 #endif
@@ -81,7 +86,9 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
   using Base::MARKER;
   using Base::SRC_LABEL_TAG;
 
+  using Base::dst_column;
   using Base::id_column;
+  using Base::src_column;
 
   using typename Base::partitioner_t;
 
@@ -113,7 +120,8 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
              retain_oid, vineyard::is_local_vertex_map<vertex_map_t>::value,
              compact_edges, use_perfect_hash),
         graph_info_(nullptr),
-        giraph_enabled_(false) {}
+        giraph_enabled_(false),
+        partition_strategy_(PartitionStrategy::kSegmented) {}
 
   ArrowFragmentLoader(vineyard::Client& client,
                       const grape::CommSpec& comm_spec,
@@ -123,7 +131,8 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
              graph_info->generate_eid, graph_info->retain_oid,
              vineyard::is_local_vertex_map<vertex_map_t>::value,
              graph_info->compact_edges, graph_info->use_perfect_hash),
-        graph_info_(graph_info) {
+        graph_info_(graph_info),
+        partition_strategy_(graph_info->partition_strategy) {
 #ifdef ENABLE_JAVA_SDK
     // check when vformat or eformat start with giraph. if not, we
     // giraph_enabled is false;
@@ -246,8 +255,9 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
   }
 
   boost::leaf::result<vineyard::ObjectID> LoadFragment() {
-    BOOST_LEAF_CHECK(initPartitioner());
+    BOOST_LEAF_CHECK(initPartitioner(true));
     BOOST_LEAF_AUTO(raw_v_e_tables, LoadVertexEdgeTables());
+    BOOST_LEAF_CHECK(rebalancePartitioner(raw_v_e_tables.second));
     return Base::LoadFragment(std::move(raw_v_e_tables));
   }
 
@@ -348,8 +358,18 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
     return vineyard::ConstructFragmentGroup(client_, new_frag_id, comm_spec_);
   }
 
-  bl::result<void> initPartitioner() {
+  /**
+   * @param keep_oids Whether to keep the vertices read for
+   * rebalancePartitioner.
+   */
+  bl::result<void> initPartitioner(bool keep_oids = false) {
 #ifdef HASH_PARTITION
+    if (keep_oids && partition_strategy_ != PartitionStrategy::kSegmented) {
+      RETURN_GS_ERROR(
+          vineyard::ErrorCode::kInvalidOperationError,
+          "The partition strategy needs the segmented partitioner, while the "
+          "loader is built with HASH_PARTITION");
+    }
     Base::partitioner_.Init(comm_spec_.fnum());
 #else
     if (vfiles_.empty() &&
@@ -359,13 +379,20 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
           "Segmented partitioner is not supported when the v-file is "
           "not provided");
     }
+    // every worker reads its share of the vertices instead of all of them,
+    // and the shares are gathered in worker order
     table_vec_t vtables;
     if (graph_info_) {
-      BOOST_LEAF_ASSIGN(vtables, loadVertexTables(graph_info_->vertices, 0, 1));
+      BOOST_LEAF_ASSIGN(vtables,
+                        loadVertexTables(graph_info_->vertices,
+                                         comm_spec_.worker_id(),
+                                         comm_spec_.worker_num()));
     } else {
-      BOOST_LEAF_ASSIGN(vtables, loadVertexTables(vfiles_, 0, 1));
+      BOOST_LEAF_ASSIGN(vtables,
+                        loadVertexTables(vfiles_, comm_spec_.worker_id(),
+                                         comm_spec_.worker_num()));
     }
-    std::vector<oid_t> oid_list;
+    std::vector<oid_t> local_oid_list;
 
     for (auto& table : vtables) {
       std::shared_ptr<arrow::ChunkedArray> oid_array_chunks =
@@ -378,12 +405,25 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
                 oid_array_chunks->chunk(chunk_i));
         int64_t length = array->length();
         for (int64_t i = 0; i < length; ++i) {
-          oid_list.emplace_back(oid_t(array->GetView(i)));
+          local_oid_list.emplace_back(oid_t(array->GetView(i)));
         }
       }
     }
 
+    std::vector<std::vector<oid_t>> gathered(comm_spec_.worker_num());
+    gathered[comm_spec_.worker_id()] = std::move(local_oid_list);
+    grape::sync_comm::AllGather(gathered, comm_spec_.comm());
+    std::vector<oid_t> oid_list;
+    for (auto& oids : gathered) {
+      oid_list.insert(oid_list.end(), std::make_move_iterator(oids.begin()),
+                      std::make_move_iterator(oids.end()));
+      std::vector<oid_t>().swap(oids);
+    }
+
     Base::partitioner_.Init(comm_spec_.fnum(), oid_list);
+    if (keep_oids && partition_strategy_ != PartitionStrategy::kSegmented) {
+      oid_list_ = std::move(oid_list);
+    }
 #endif
     return {};
   }
@@ -395,6 +435,170 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
   using Base::resolveVineyardObject;
   using Base::sanityChecks;
 
+#ifndef HASH_PARTITION
+  /**
+   * @brief Reassigns the vertices kept by initPartitioner to fragments by the
+   * partition strategy, from the edges this worker has read, before the
+   * vertices and edges are shuffled. The vertices are indexed by their
+   * position in the order they are read.
+   */
+  bl::result<void> rebalancePartitioner(
+      const std::vector<table_vec_t>& e_tables) {
+    if (partition_strategy_ == PartitionStrategy::kSegmented) {
+      return {};
+    }
+    fid_t fnum = comm_spec_.fnum();
+    size_t vnum = oid_list_.size();
+    grape::HashMap<internal_oid_t, vid_t> indices;
+    indices.reserve(vnum);
+    for (size_t i = 0; i < vnum; ++i) {
+      indices.emplace(internal_oid_t(oid_list_[i]), static_cast<vid_t>(i));
+    }
+    // the edges whose both ends are vertices read, as pairs of indices
+    std::vector<vid_t> edges;
+    for (auto& table_vec : e_tables) {
+      for (auto& table : table_vec) {
+        auto src_chunks = table->column(src_column);
+        auto dst_chunks = table->column(dst_column);
+        for (int chunk_i = 0; chunk_i < src_chunks->num_chunks(); ++chunk_i) {
+          auto srcs = std::dynamic_pointer_cast<oid_array_t>(
+              src_chunks->chunk(chunk_i));
+          auto dsts = std::dynamic_pointer_cast<oid_array_t>(
+              dst_chunks->chunk(chunk_i));
+          for (int64_t i = 0; i < srcs->length(); ++i) {
+            auto src_iter = indices.find(srcs->GetView(i));
+            auto dst_iter = indices.find(dsts->GetView(i));
+            if (src_iter != indices.end() && dst_iter != indices.end()) {
+              edges.push_back(src_iter->second);
+              edges.push_back(dst_iter->second);
+            }
+          }
+        }
+      }
+    }
+    indices.clear();
+
+    std::vector<fid_t> fids;
+    if (partition_strategy_ == PartitionStrategy::kEdgeBalanced ||
+        partition_strategy_ == PartitionStrategy::kHybrid) {
+      std::vector<uint32_t> degrees(vnum, 0);
+      for (auto v : edges) {
+        ++degrees[v];
+      }
+      allReduceSum(degrees, MPI_UINT32_T);
+      fids = partition_strategy_ == PartitionStrategy::kHybrid
+                 ? PartitionByHybridCut(fnum, degrees)
+                 : PartitionByCumulativeDegree(fnum, degrees);
+    } else {
+      fids = fennelPartition(vnum, edges);
+    }
+
+    for (size_t i = 0; i < vnum; ++i) {
+      Base::partitioner_.SetPartitionId(oid_list_[i], fids[i]);
+    }
+    std::vector<oid_t>().swap(oid_list_);
+    return {};
+  }
+
+  // Each worker streams its own range of the vertices by Fennel, knowing the
+  // neighbors of them from the edges read by all workers, and the fragments
+  // of the neighbors in the same range placed before.
+  std::vector<fid_t> fennelPartition(size_t vnum, std::vector<vid_t>& edges) {
+    fid_t fnum = comm_spec_.fnum();
+    int worker_id = comm_spec_.worker_id();
+    int worker_num = comm_spec_.worker_num();
+    size_t range = (vnum + worker_num - 1) / worker_num;
+    auto owner = [range](vid_t v) { return static_cast<int>(v / range); };
+
+    // send each edge, both ways, to the owner of the vertex it starts from
+    std::vector<std::vector<vid_t>> outgoing(worker_num), incoming(worker_num);
+    for (size_t i = 0; i < edges.size(); i += 2) {
+      vid_t u = edges[i], v = edges[i + 1];
+      if (u == v) {
+        continue;
+      }
+      outgoing[owner(u)].push_back(u);
+      outgoing[owner(u)].push_back(v);
+      outgoing[owner(v)].push_back(v);
+      outgoing[owner(v)].push_back(u);
+    }
+    std::vector<vid_t>().swap(edges);
+    incoming[worker_id] = std::move(outgoing[worker_id]);
+    {
+      std::thread send_thread([&]() {
+        for (int step = 1; step < worker_num; ++step) {
+          int dst_worker_id = (worker_id + step) % worker_num;
+          grape::sync_comm::Send(outgoing[dst_worker_id], dst_worker_id, 0x20,
+                                 comm_spec_.comm());
+        }
+      });
+      std::thread recv_thread([&]() {
+        for (int step = 1; step < worker_num; ++step) {
+          int src_worker_id = (worker_id + worker_num - step) % worker_num;
+          grape::sync_comm::Recv(incoming[src_worker_id], src_worker_id, 0x20,
+                                 comm_spec_.comm());
+        }
+      });
+      send_thread.join();
+      recv_thread.join();
+    }
+    std::vector<std::vector<vid_t>>().swap(outgoing);
+
+    size_t begin = std::min(range * worker_id, vnum);
+    size_t end = std::min(begin + range, vnum);
+    std::vector<size_t> offsets(end - begin + 1, 0);
+    for (auto& buffer : incoming) {
+      for (size_t i = 0; i < buffer.size(); i += 2) {
+        ++offsets[buffer[i] - begin + 1];
+      }
+    }
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+    std::vector<vid_t> neighbors(offsets.back());
+    {
+      std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+      for (auto& buffer : incoming) {
+        for (size_t i = 0; i < buffer.size(); i += 2) {
+          neighbors[cursors[buffer[i] - begin]++] = buffer[i + 1];
+        }
+        std::vector<vid_t>().swap(buffer);
+      }
+    }
+
+    std::vector<fid_t> fids(vnum, 0);
+    FennelPartitioner fennel(fnum, end - begin, neighbors.size() / 2);
+    std::vector<fid_t> neighbor_fids;
+    for (size_t v = begin; v < end; ++v) {
+      neighbor_fids.clear();
+      for (size_t i = offsets[v - begin]; i < offsets[v - begin + 1]; ++i) {
+        vid_t u = neighbors[i];
+        // the vertices of other ranges, and the ones after, are not placed
+        neighbor_fids.push_back(u >= begin && u < v ? fids[u] : fnum);
+      }
+      fids[v] = fennel.Place(neighbor_fids.begin(), neighbor_fids.end());
+    }
+    // the fragments of the other ranges are 0 here
+    allReduceSum(fids, MPI_UNSIGNED);
+    return fids;
+  }
+
+  template <typename T>
+  void allReduceSum(std::vector<T>& values, MPI_Datatype type) {
+    const size_t chunk = 1UL << 30;
+    for (size_t offset = 0; offset < values.size(); offset += chunk) {
+      int count = static_cast<int>(std::min(chunk, values.size() - offset));
+      MPI_Allreduce(MPI_IN_PLACE, values.data() + offset, count, type,
+                    MPI_SUM, comm_spec_.comm());
+    }
+  }
+#else
+  bl::result<void> rebalancePartitioner(
+      const std::vector<table_vec_t>& e_tables) {
+    return {};
+  }
+#endif
+
 #ifdef ENABLE_JAVA_SDK
   // Location like giraph://filename#input_format_class=className
   bl::result<std::shared_ptr<arrow::Table>> readTableFromGiraph(
@@ -634,6 +838,9 @@ class ArrowFragmentLoader : public vineyard::ArrowFragmentLoader<OID_T, VID_T> {
   std::shared_ptr<detail::Graph> graph_info_;
 
   bool giraph_enabled_;
+  PartitionStrategy partition_strategy_;
+  // the vertices read by initPartitioner, in order, for rebalancePartitioner
+  std::vector<oid_t> oid_list_;
 #ifdef ENABLE_JAVA_SDK
   JavaLoaderInvoker java_loader_invoker_;
 #endif
@@ -109,6 +109,7 @@ class ArrowToDynamicConverter {
     CHECK(arrow_vm_ptr_->fnum() == comm_spec_.fnum());
     arrow_id_parser_.Init(comm_spec_.fnum(), arrow_vm_ptr_->label_num());
     dynamic_id_parser_.init(comm_spec_.fnum());
+    initLabelOffsets();
 
     BOOST_LEAF_AUTO(dynamic_vm, convertVertexMap(arrow_frag));
     BOOST_LEAF_AUTO(dynamic_frag, convertFragment(arrow_frag, dynamic_vm));
@@ -175,19 +176,12 @@ class ArrowToDynamicConverter {
     auto& allocators = dynamic_frag->allocators_;
     std::vector<std::vector<internal_vertex_t>> vertices(thread_num);
     std::vector<std::vector<edge_t>> edges(thread_num);
-    vid_t ovnum = 0;
-    for (label_id_t label = 0; label < src_frag->vertex_label_num(); ++label) {
-      ovnum += src_frag->GetOuterVerticesNum(label);
-    }
 
     // we record the degree messages here to avoid fetch these messages in
-    // dynamic_frag.Init again.
+    // dynamic_frag.Init again. Each inner vertex is visited by one thread,
+    // the degrees of the outer vertices are counted by dynamic_frag.Init.
     std::vector<int> inner_oe_degree(dst_vm->GetInnerVertexSize(fid), 0);
     std::vector<int> inner_ie_degree(dst_vm->GetInnerVertexSize(fid), 0);
-    std::vector<int> outer_oe_degree(ovnum, 0);
-    std::vector<int> outer_ie_degree(ovnum, 0);
-    ska::flat_hash_map<vid_t, vid_t> ovg2i;
-    vid_t ov_index = 0, index = 0;
     for (label_id_t v_label = 0; v_label < src_frag->vertex_label_num();
          v_label++) {
       auto inner_vertices = src_frag->InnerVertices(v_label);
@@ -222,18 +216,6 @@ class ArrowToDynamicConverter {
                 auto v = e.get_neighbor();
                 auto e_id = e.edge_id();
                 vid_t v_gid = gid2Gid(src_frag->Vertex2Gid(v));
-                if (src_frag->IsOuterVertex(v)) {
-                  auto iter = ovg2i.find(v_gid);
-                  if (iter != ovg2i.end()) {
-                    index = iter->second;
-                  } else {
-                    ovg2i.emplace(v_gid, ov_index);
-                    index = ov_index;
-                    ++ov_index;
-                  }
-                  src_frag->directed() ? outer_ie_degree[index]++
-                                       : outer_oe_degree[index]++;
-                }
                 dynamic::Value edge_data(rapidjson::kObjectType);
                 PropertyConverter<src_fragment_t>::EdgeValue(
                     e_data, e_id, edge_data, (*allocators)[tid]);
@@ -248,17 +230,6 @@ class ArrowToDynamicConverter {
                   if (src_frag->IsOuterVertex(v)) {
                     auto e_id = e.edge_id();
                     vid_t v_gid = gid2Gid(src_frag->GetOuterVertexGid(v));
-                    if (src_frag->IsOuterVertex(v)) {
-                      auto iter = ovg2i.find(v_gid);
-                      if (iter != ovg2i.end()) {
-                        index = iter->second;
-                      } else {
-                        ovg2i.emplace(v_gid, ov_index);
-                        index = ov_index;
-                        ++ov_index;
-                      }
-                      outer_oe_degree[index]++;
-                    }
                     dynamic::Value edge_data(rapidjson::kObjectType);
                     PropertyConverter<src_fragment_t>::EdgeValue(
                         e_data, e_id, edge_data, (*allocators)[tid]);
@@ -272,8 +243,7 @@ class ArrowToDynamicConverter {
     }
 
     dynamic_frag->Init(src_frag->fid(), src_frag->directed(), vertices, edges,
-                       inner_oe_degree, outer_oe_degree, inner_ie_degree,
-                       outer_ie_degree, thread_num);
+                       inner_oe_degree, inner_ie_degree, thread_num);
 
     initFragmentSchema(dynamic_frag, src_frag->schema());
 
@@ -295,10 +265,22 @@ class ArrowToDynamicConverter {
     auto fid = arrow_id_parser_.GetFid(gid);
     auto label_id = arrow_id_parser_.GetLabelId(gid);
     auto offset = arrow_id_parser_.GetOffset(gid);
-    for (label_id_t i = 0; i < label_id; ++i) {
-      offset += arrow_vm_ptr_->GetInnerVertexSize(fid, i);
+    return dynamic_id_parser_.generate_global_id(
+        fid, label_offsets_[fid][label_id] + offset);
+  }
+
+  // The number of inner vertices of the labels before each label in each
+  // fragment, which gid2Gid adds to the offsets for every edge.
+  void initLabelOffsets() {
+    label_id_t label_num = arrow_vm_ptr_->label_num();
+    label_offsets_.clear();
+    label_offsets_.resize(comm_spec_.fnum(), std::vector<vid_t>(label_num, 0));
+    for (fid_t fid = 0; fid < comm_spec_.fnum(); ++fid) {
+      for (label_id_t i = 1; i < label_num; ++i) {
+        label_offsets_[fid][i] = label_offsets_[fid][i - 1] +
+                                 arrow_vm_ptr_->GetInnerVertexSize(fid, i - 1);
+      }
     }
-    return dynamic_id_parser_.generate_global_id(fid, offset);
   }
 
   void initFragmentSchema(std::shared_ptr<dst_fragment_t> frag,
@@ -327,6 +309,7 @@ class ArrowToDynamicConverter {
   std::shared_ptr<typename src_fragment_t::vertex_map_t> arrow_vm_ptr_;
   vineyard::IdParser<vid_t> arrow_id_parser_;
   grape::IdParser<vid_t> dynamic_id_parser_;
+  std::vector<std::vector<vid_t>> label_offsets_;
 };
 
 }  // namespace gs
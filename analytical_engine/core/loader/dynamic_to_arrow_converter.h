@@ -52,6 +52,7 @@ struct VertexArrayBuilder<arrow::Int64Builder> {
       const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
     arrow::Int64Builder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(src_frag->GetInnerVerticesNum()));
 
     for (const auto& u : src_frag->InnerVertices()) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -80,6 +81,7 @@ struct VertexArrayBuilder<arrow::DoubleBuilder> {
       const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
     arrow::DoubleBuilder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(src_frag->GetInnerVerticesNum()));
 
     for (const auto& u : src_frag->InnerVertices()) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -109,6 +111,7 @@ struct VertexArrayBuilder<arrow::LargeStringBuilder> {
       const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
     arrow::LargeStringBuilder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(src_frag->GetInnerVerticesNum()));
 
     for (const auto& u : src_frag->InnerVertices()) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -142,10 +145,12 @@ struct EdgeArrayBuilder {};
 template <>
 struct EdgeArrayBuilder<arrow::Int64Builder> {
   static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
+      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key,
+      int64_t length) {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::Int64Builder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(length));
 
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -156,22 +161,22 @@ struct EdgeArrayBuilder<arrow::Int64Builder> {
           continue;  // if src_frag is undirected, just append one edge.
         }
 
-        auto& data = e.data;
-        if (data.HasMember(prop_key) == 0) {
+        auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+        if (attr == nullptr) {
           ARROW_OK_OR_RAISE(builder.AppendNull());
         } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetInt64()));
+          ARROW_OK_OR_RAISE(builder.Append(attr->GetInt64()));
         }
       }
       if (src_frag->directed()) {
         for (auto& e : src_frag->GetIncomingAdjList(u)) {
           auto& v = e.neighbor;
           if (src_frag->IsOuterVertex(v)) {
-            auto& data = e.data;
-            if (data.HasMember(prop_key) == 0) {
+            auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+            if (attr == nullptr) {
               ARROW_OK_OR_RAISE(builder.AppendNull());
             } else {
-              ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetInt64()));
+              ARROW_OK_OR_RAISE(builder.Append(attr->GetInt64()));
             }
           }
         }
@@ -189,10 +194,12 @@ struct EdgeArrayBuilder<arrow::Int64Builder> {
 template <>
 struct EdgeArrayBuilder<arrow::DoubleBuilder> {
   static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
+      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key,
+      int64_t length) {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::DoubleBuilder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(length));
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
         continue;
@@ -202,22 +209,22 @@ struct EdgeArrayBuilder<arrow::DoubleBuilder> {
           continue;  // if src_frag is undirected, just append one edge.
         }
 
-        auto& data = e.data;
-        if (data.HasMember(prop_key) == 0) {
+        auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+        if (attr == nullptr) {
           ARROW_OK_OR_RAISE(builder.AppendNull());
         } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetDouble()));
+          ARROW_OK_OR_RAISE(builder.Append(attr->GetDouble()));
         }
       }
       if (src_frag->directed()) {
         for (auto& e : src_frag->GetIncomingAdjList(u)) {
           auto& v = e.neighbor;
           if (src_frag->IsOuterVertex(v)) {
-            auto& data = e.data;
-            if (data.HasMember(prop_key) == 0) {
+            auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+            if (attr == nullptr) {
               ARROW_OK_OR_RAISE(builder.AppendNull());
             } else {
-              ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetDouble()));
+              ARROW_OK_OR_RAISE(builder.Append(attr->GetDouble()));
             }
           }
         }
@@ -235,10 +242,12 @@ struct EdgeArrayBuilder<arrow::DoubleBuilder> {
 template <>
 struct EdgeArrayBuilder<arrow::LargeStringBuilder> {
   static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
+      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key,
+      int64_t length) {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::LargeStringBuilder builder;
     std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(length));
 
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -249,22 +258,22 @@ struct EdgeArrayBuilder<arrow::LargeStringBuilder> {
           continue;  // if src_frag is undirected, just append one edge.
         }
 
-        auto& data = e.data;
-        if (data.HasMember(prop_key) == 0) {
+        auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+        if (attr == nullptr) {
           ARROW_OK_OR_RAISE(builder.AppendNull());
         } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetString()));
+          ARROW_OK_OR_RAISE(builder.Append(attr->GetString()));
         }
       }
       if (src_frag->directed()) {
         for (auto& e : src_frag->GetIncomingAdjList(u)) {
           auto& v = e.neighbor;
           if (src_frag->IsOuterVertex(v)) {
-            auto& data = e.data;
-            if (data.HasMember(prop_key) == 0) {
+            auto attr = src_frag->GetEdgeAttr(e.data, prop_key);
+            if (attr == nullptr) {
               ARROW_OK_OR_RAISE(builder.AppendNull());
             } else {
-              ARROW_OK_OR_RAISE(builder.Append(data[prop_key].GetString()));
+              ARROW_OK_OR_RAISE(builder.Append(attr->GetString()));
             }
           }
         }
@@ -305,6 +314,8 @@ struct COOBuilder<DST_FRAG_T, int32_t> {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::UInt64Builder src_builder, dst_builder;
     std::shared_ptr<arrow::Array> src_array, dst_array;
+    ARROW_OK_OR_RAISE(src_builder.Reserve(src_frag->GetEdgeNum()));
+    ARROW_OK_OR_RAISE(dst_builder.Reserve(src_frag->GetEdgeNum()));
 
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -370,6 +381,8 @@ struct COOBuilder<DST_FRAG_T, int64_t> {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::UInt64Builder src_builder, dst_builder;
     std::shared_ptr<arrow::Array> src_array, dst_array;
+    ARROW_OK_OR_RAISE(src_builder.Reserve(src_frag->GetEdgeNum()));
+    ARROW_OK_OR_RAISE(dst_builder.Reserve(src_frag->GetEdgeNum()));
 
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -435,6 +448,8 @@ struct COOBuilder<DST_FRAG_T, std::string> {
     auto inner_vertices = src_frag->InnerVertices();
     arrow::UInt64Builder src_builder, dst_builder;
     std::shared_ptr<arrow::Array> src_array, dst_array;
+    ARROW_OK_OR_RAISE(src_builder.Reserve(src_frag->GetEdgeNum()));
+    ARROW_OK_OR_RAISE(dst_builder.Reserve(src_frag->GetEdgeNum()));
 
     for (const auto& u : inner_vertices) {
       if (!src_frag->IsAliveInnerVertex(u)) {
@@ -787,7 +802,8 @@ class DynamicToArrowConverter {
       int type = p.value.GetInt();
       switch (type) {
       case rpc::graph::DataTypePb::LONG: {
-        auto r = EdgeArrayBuilder<arrow::Int64Builder>::build(src_frag, key);
+        auto r = EdgeArrayBuilder<arrow::Int64Builder>::build(
+            src_frag, key, src_array->length());
 
         BOOST_LEAF_AUTO(array, r);
         schema_vector.push_back(arrow::field(key, arrow::int64()));
@@ -796,7 +812,8 @@ class DynamicToArrowConverter {
         break;
       }
       case rpc::graph::DataTypePb::DOUBLE: {
-        auto r = EdgeArrayBuilder<arrow::DoubleBuilder>::build(src_frag, key);
+        auto r = EdgeArrayBuilder<arrow::DoubleBuilder>::build(
+            src_frag, key, src_array->length());
 
         BOOST_LEAF_AUTO(array, r);
         schema_vector.push_back(arrow::field(key, arrow::float64()));
@@ -804,8 +821,8 @@ class DynamicToArrowConverter {
         break;
       }
       case rpc::graph::DataTypePb::STRING: {
-        auto r =
-            EdgeArrayBuilder<arrow::LargeStringBuilder>::build(src_frag, key);
+        auto r = EdgeArrayBuilder<arrow::LargeStringBuilder>::build(
+            src_frag, key, src_array->length());
 
         BOOST_LEAF_AUTO(array, r);
         schema_vector.push_back(arrow::field(key, arrow::large_utf8()));
@@ -32,7 +32,7 @@ std::size_t gs::dynamic::Value::hash() const {
     std::size_t hash_value = 0;
     for (const auto& val : GetArray()) {
       if (val.IsString()) {
-        hash_value += std::hash<std::string>()(val.GetString());
+        hash_value += HashString(val.GetString(), val.GetStringLength());
       } else if (val.IsInt64()) {
         hash_value += std::hash<int64_t>()(val.GetInt64());
       } else if (val.IsDouble()) {
@@ -52,7 +52,7 @@ std::size_t gs::dynamic::Value::hash() const {
   case rapidjson::kFalseType:
     return std::hash<bool>()(GetBool());
   case rapidjson::kStringType:
-    return std::hash<std::string>()(GetString());
+    return HashString(GetString(), GetStringLength());
   case rapidjson::kObjectType:
     throw std::runtime_error("Object value can't not be hashed.");
   }
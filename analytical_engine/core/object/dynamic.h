@@ -19,9 +19,13 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 #include <utility>
 
 // IWYU pragma: begin_exports
@@ -309,6 +313,16 @@ static inline rpc::graph::DataTypePb DynamicType2RpcType(const Type& t) {
   return type2type.at(t);
 }
 
+// The std::hash of the string, without copying it into a std::string when
+// std::string_view is available, which hashes alike.
+inline std::size_t HashString(const char* str, std::size_t length) {
+#if __cplusplus >= 201703L
+  return std::hash<std::string_view>()(std::string_view(str, length));
+#else
+  return std::hash<std::string>()(std::string(str, length));
+#endif
+}
+
 inline std::ostream& operator<<(std::ostream& out, Value const& val) {
   out << Stringify(val);
   return out;
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -35,6 +36,9 @@ namespace gs {
 /**
  * @brief ObjectManager manages GSObject like fragment wrapper, loaded app and
  * more.
+ *
+ * The objects may be put and got by the lanes of the dispatcher at the same
+ * time, so the map of them is guarded by a mutex.
  */
 class ObjectManager {
  public:
@@ -43,8 +47,10 @@ class ObjectManager {
 
     DLOG(INFO) << "[object manager] putting " << id;
 
-    if (objects.find(id) != objects.end()) {
-      auto existed_obj_type = objects[id]->type();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = objects.find(id);
+    if (iter != objects.end()) {
+      auto existed_obj_type = iter->second->type();
       std::stringstream ss;
       ss << "Object " << id << "[" << ObjectTypeToString(existed_obj_type)
          << "]"
@@ -57,29 +63,36 @@ class ObjectManager {
 
   bl::result<void> RemoveObject(const std::string& id) {
     DLOG(INFO) << "[object manager] removing " << id;
-    if (objects.find(id) != objects.end()) {
-      objects.erase(id);
-    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    objects.erase(id);
     return {};
   }
 
   bl::result<std::shared_ptr<GSObject>> GetObject(const std::string& id) {
     DLOG(INFO) << "[object manager] getting " << id;
-    if (objects.find(id) == objects.end()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = objects.find(id);
+    if (iter == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
     }
-    return objects[id];
+    return iter->second;
   }
 
   template <typename T>
   bl::result<std::shared_ptr<T>> GetObject(const std::string& id) {
     DLOG(INFO) << "[object manager] getting typed " << id;
-    if (objects.find(id) == objects.end()) {
-      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                      "Object " + id + " does not exist");
+    std::shared_ptr<GSObject> base;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto iter = objects.find(id);
+      if (iter == objects.end()) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                        "Object " + id + " does not exist");
+      }
+      base = iter->second;
     }
-    auto obj = std::dynamic_pointer_cast<T>(objects[id]);
+    auto obj = std::dynamic_pointer_cast<T>(base);
 
     if (obj == nullptr) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
@@ -90,10 +103,12 @@ class ObjectManager {
 
   bool HasObject(const std::string& id) {
     DLOG(INFO) << "[object manager] has " << id;
+    std::lock_guard<std::mutex> lock(mutex_);
     return objects.find(id) != objects.end();
   }
 
  private:
+  std::mutex mutex_;
   std::map<std::string, std::shared_ptr<GSObject>> objects;
 };
 }  // namespace gs
@@ -0,0 +1,67 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_CHECKPOINT_MESSAGE_MANAGER_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_CHECKPOINT_MESSAGE_MANAGER_H_
+
+#include <cstddef>
+
+#include "glog/logging.h"
+
+#include "grape/config.h"
+#include "grape/parallel/default_message_manager.h"
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+
+namespace gs {
+
+/**
+ * @brief A DefaultMessageManager whose messages of a round, until it
+ * finishes, can be archived with a checkpoint and put back on restart, see
+ * SuperstepCheckpointer.
+ */
+class CheckpointMessageManager : public grape::DefaultMessageManager {
+ public:
+  /**
+   * @brief Archives the messages sent in the round so far, by fragment.
+   */
+  void ArchiveOutgoing(grape::InArchive& arc) const {
+    arc << static_cast<grape::fid_t>(to_send_.size());
+    for (auto& buffer : to_send_) {
+      size_t size = buffer.GetSize();
+      arc << size;
+      arc.AddBytes(buffer.GetBuffer(), size);
+    }
+  }
+
+  /**
+   * @brief Puts the messages archived back to be sent in the round, which
+   * has started.
+   */
+  void RestoreOutgoing(grape::OutArchive& arc) {
+    grape::fid_t fnum;
+    arc >> fnum;
+    CHECK_EQ(fnum, to_send_.size());
+    for (auto& buffer : to_send_) {
+      size_t size;
+      arc >> size;
+      buffer.AddBytes(arc.GetBytes(size), size);
+    }
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_CHECKPOINT_MESSAGE_MANAGER_H_
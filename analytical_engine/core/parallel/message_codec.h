@@ -0,0 +1,153 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+
+namespace gs {
+
+/**
+ * @brief The encoding of the message blocks a ParallelPropertyMessageManager
+ * sends between fragments.
+ *
+ * A codec is set by the app, through
+ * ParallelPropertyMessageManager::SetMessageCodec, before its first message is
+ * sent. Every worker runs the same app, so both ends of a block agree on it.
+ * A block holds the (gid, message) pairs one channel has for one fragment.
+ */
+class IMessageCodec {
+ public:
+  virtual ~IMessageCodec() = default;
+
+  /**
+   * @brief Encodes a block of (gid, message) pairs in place.
+   */
+  virtual void Encode(grape::InArchive& arc) const = 0;
+
+  /**
+   * @brief Decodes in place a block produced by Encode back into (gid,
+   * message) pairs.
+   */
+  virtual void Decode(grape::OutArchive& arc) const = 0;
+};
+
+/**
+ * @brief Sorts the pairs of a block by gid and writes each gid as the varint
+ * of its distance to the previous one, so that a gid mostly takes one or two
+ * bytes instead of sizeof(VID_T).
+ *
+ * If a combiner is given, the messages a block has for the same gid are
+ * merged into the first of them by combine(first, other), e.g. a min for
+ * SSSP or WCC. The receiver then gets one message per gid and block.
+ * Messages are left as they are serialized.
+ *
+ * @tparam VID_T The gid type of the fragment.
+ * @tparam MESSAGE_T The message type.
+ */
+template <typename VID_T, typename MESSAGE_T>
+class DeltaVarintCodec : public IMessageCodec {
+ public:
+  using combine_t = std::function<void(MESSAGE_T&, const MESSAGE_T&)>;
+
+  explicit DeltaVarintCodec(combine_t combine = nullptr)
+      : combine_(std::move(combine)) {}
+
+  void Encode(grape::InArchive& arc) const override {
+    std::vector<std::pair<VID_T, MESSAGE_T>> pairs;
+    {
+      grape::OutArchive oarc(std::move(arc));
+      while (!oarc.Empty()) {
+        pairs.emplace_back();
+        oarc >> pairs.back().first >> pairs.back().second;
+      }
+    }
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [](const std::pair<VID_T, MESSAGE_T>& lhs,
+                        const std::pair<VID_T, MESSAGE_T>& rhs) {
+                       return lhs.first < rhs.first;
+                     });
+    if (combine_ && !pairs.empty()) {
+      size_t last = 0;
+      for (size_t i = 1; i < pairs.size(); ++i) {
+        if (pairs[i].first == pairs[last].first) {
+          combine_(pairs[last].second, pairs[i].second);
+        } else if (++last != i) {
+          pairs[last] = std::move(pairs[i]);
+        }
+      }
+      pairs.resize(last + 1);
+    }
+
+    arc.Clear();
+    VID_T prev = 0;
+    for (auto& pair : pairs) {
+      putVarint(arc, static_cast<uint64_t>(pair.first - prev));
+      prev = pair.first;
+      arc << pair.second;
+    }
+  }
+
+  void Decode(grape::OutArchive& arc) const override {
+    grape::InArchive raw;
+    VID_T gid = 0;
+    MESSAGE_T msg;
+    while (!arc.Empty()) {
+      gid += static_cast<VID_T>(getVarint(arc));
+      arc >> msg;
+      raw << gid << msg;
+    }
+    arc = grape::OutArchive(std::move(raw));
+  }
+
+ private:
+  static inline void putVarint(grape::InArchive& arc, uint64_t value) {
+    uint8_t buf[10];
+    size_t len = 0;
+    while (value >= 0x80) {
+      buf[len++] = static_cast<uint8_t>(value) | 0x80;
+      value >>= 7;
+    }
+    buf[len++] = static_cast<uint8_t>(value);
+    arc.AddBytes(buf, len);
+  }
+
+  static inline uint64_t getVarint(grape::OutArchive& arc) {
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      arc >> byte;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return value;
+  }
+
+  combine_t combine_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_MESSAGE_CODEC_H_
@@ -20,6 +20,7 @@
 
 #include <array>
 #include <atomic>
+#include <future>
 #include <memory>
 #include <string>
 #include <thread>
@@ -34,6 +35,7 @@
 #include "grape/utils/concurrent_queue.h"
 #include "grape/worker/comm_spec.h"
 
+#include "core/parallel/message_codec.h"
 #include "core/parallel/thread_local_property_message_buffer.h"
 
 namespace gs {
@@ -47,9 +49,17 @@ namespace gs {
  * For each thread local message buffer, when accumulated a given amount of
  * messages, the buffer will be sent through MPI.
  *
+ * The messages of a round are received while it runs, and the next round
+ * starts as soon as the last of them is handed to MPI, with the sends of the
+ * round still in flight. Its ParallelProcess gets each buffer once it
+ * arrives and returns when every fragment has finished the round.
+ *
  * After a round of evaluation, there is a global barrier to determine whether
  * the fixed point is reached.
  *
+ * An app may set a message codec, which the buffers encode with before they
+ * are sent and the receivers decode with before they are processed, see
+ * IMessageCodec.
  */
 class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   static constexpr size_t default_msg_send_block_size = 2 * 1023 * 1024;
@@ -81,6 +91,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     round_ = 0;
 
     sent_size_ = 0;
+
+    codec_ = nullptr;
   }
 
   /**
@@ -92,18 +104,6 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    * @brief Inherit
    */
   void StartARound() override {
-    if (round_ != 0) {
-      waitSend();
-      auto& rq = recv_queues_[round_ % 2];
-      if (!to_self_.empty()) {
-        for (auto& iarc : to_self_) {
-          grape::OutArchive oarc(std::move(iarc));
-          rq.Put(std::move(oarc));
-        }
-        to_self_.clear();
-      }
-      rq.DecProducerNum();
-    }
     sent_size_ = 0;
     startSendThread();
   }
@@ -196,6 +196,20 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     return channels_;
   }
 
+  /**
+   * @brief Set the codec of the messages, to be called in PEval before any
+   * message is sent. With a codec, every message must be sent with a gid,
+   * i.e., through SyncStateOnOuterVertex or SendMsgThrough*Edges, and be
+   * processed by the ParallelProcess taking a fragment.
+   *
+   * @param codec The codec, or nullptr to send the raw archives.
+   */
+  void SetMessageCodec(std::shared_ptr<IMessageCodec> codec) {
+    codec_ = std::move(codec);
+  }
+
+  const IMessageCodec* GetMessageCodec() const { return codec_.get(); }
+
   /**
    * @brief Send a buffer to a fragment.
    *
@@ -298,8 +312,7 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   inline bool GetMessages(grape::MessageInBuffer& buf) {
     grape::OutArchive arc;
-    auto& que = recv_queues_[round_ % 2];
-    if (que.Get(arc)) {
+    if (getArchive(arc)) {
       buf.Init(std::move(arc));
       return true;
     } else {
@@ -329,9 +342,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
             typename GRAPH_T::vid_t id;
             typename GRAPH_T::vertex_t vertex(0);
             MESSAGE_T msg;
-            auto& que = recv_queues_[round_ % 2];
             grape::OutArchive arc;
-            while (que.Get(arc)) {
+            while (getArchive(arc)) {
               while (!arc.Empty()) {
                 arc >> id >> msg;
                 frag.Gid2Vertex(id, vertex);
@@ -384,31 +396,54 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   }
 
  private:
+  inline bool getArchive(grape::OutArchive& arc) {
+    if (!recv_queues_[round_ % 2].Get(arc)) {
+      return false;
+    }
+    if (codec_ != nullptr) {
+      codec_->Decode(arc);
+    }
+    return true;
+  }
+
+  // The send thread of a round puts the buffers to this fragment to the
+  // receiving queue of the next round directly, and posts the others. Once
+  // the sending queue is drained, which the next round waits for, it waits
+  // for the posted sends and then joins the send thread of the round before.
   void startSendThread() {
+    if (send_drained_.valid()) {
+      send_drained_.wait();
+    }
     force_continue_ = false;
     int round = round_;
 
     CHECK_EQ(sending_queue_.Size(), 0);
     sending_queue_.SetProducerNum(1);
+    std::promise<void> drained;
+    send_drained_ = drained.get_future();
     send_thread_ = std::thread(
-        [this](int msg_round) {
+        [this](int msg_round, std::promise<void> drained,
+               std::thread prev_send_thread) {
+          auto& rq = recv_queues_[msg_round % 2];
           std::vector<MPI_Request> reqs;
+          std::vector<grape::InArchive> to_others;
           std::pair<grape::fid_t, grape::InArchive> item;
           while (sending_queue_.Get(item)) {
             if (item.second.GetSize() == 0) {
               continue;
             }
             if (item.first == fid_) {
-              to_self_.emplace_back(std::move(item.second));
+              rq.Put(grape::OutArchive(std::move(item.second)));
             } else {
               MPI_Request req;
               MPI_Isend(item.second.GetBuffer(), item.second.GetSize(),
                         MPI_CHAR, comm_spec_.FragToWorker(item.first),
                         msg_round, comm_, &req);
               reqs.push_back(req);
-              to_others_.emplace_back(std::move(item.second));
+              to_others.emplace_back(std::move(item.second));
             }
           }
+          rq.DecProducerNum();
           for (grape::fid_t i = 0; i < fnum_; ++i) {
             if (i == fid_) {
               continue;
@@ -418,10 +453,14 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
                       comm_, &req);
             reqs.push_back(req);
           }
-          MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
-          to_others_.clear();
+          drained.set_value();
+          MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
+          to_others.clear();
+          if (prev_send_thread.joinable()) {
+            prev_send_thread.join();
+          }
         },
-        round + 1);
+        round + 1, std::move(drained), std::move(send_thread_));
   }
 
   void probeAllIncomingMessages() {
@@ -478,7 +517,10 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     curr_recv_queue.SetProducerNum(fnum_);
   }
 
-  void waitSend() { send_thread_.join(); }
+  void waitSend() {
+    send_thread_.join();
+    send_drained_ = std::future<void>();
+  }
 
   grape::fid_t fid_;
   grape::fid_t fnum_;
@@ -486,9 +528,6 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
 
   MPI_Comm comm_;
 
-  std::vector<grape::InArchive> to_self_;
-  std::vector<grape::InArchive> to_others_;
-
   std::vector<ThreadLocalPropertyMessageBuffer<ParallelPropertyMessageManager>>
       channels_;
   int round_;
@@ -496,6 +535,7 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   grape::BlockingQueue<std::pair<grape::fid_t, grape::InArchive>>
       sending_queue_;
   std::thread send_thread_;
+  std::future<void> send_drained_;
 
   std::array<grape::BlockingQueue<grape::OutArchive>, 2> recv_queues_;
   std::thread recv_thread_;
@@ -503,6 +543,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   bool force_continue_;
   size_t sent_size_;
 
+  std::shared_ptr<IMessageCodec> codec_;
+
   bool force_terminate_;
   grape::TerminateInfo terminate_info_;
 };
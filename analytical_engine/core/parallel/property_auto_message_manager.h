@@ -50,6 +50,7 @@ template <typename FRAG_T>
 class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   using Base = grape::DefaultMessageManager;
   using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
   using label_id_t = typename FRAG_T::label_id_t;
 
   struct ap_event {
@@ -62,6 +63,9 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
     grape::ISyncBuffer* buffer;
     grape::MessageStrategy message_strategy;
     int event_id;
+    // The updated outer vertices of each fragment, collected by one scan of
+    // the outer vertices, reused between rounds.
+    std::vector<std::vector<vertex_t>> updated_outer_vertices;
   };
 
  public:
@@ -157,35 +161,19 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   void generateAutoMessages() {
     for (auto& event_ref : auto_parallel_events_) {
       ap_event* event = &event_ref;
-      auto& i_ec_frag = event->fragment;
-      auto inner_size = i_ec_frag.InnerVertices(event->label).size();
-      if (event->buffer->updated(0, inner_size)) {
-        ForceContinue();
-        break;
-      }
-    }
 
-    for (auto& event_ref : auto_parallel_events_) {
-      ap_event* event = &event_ref;
-
-      auto& i_ec_frag = event->fragment;
       if (event->message_strategy ==
           grape::MessageStrategy::kSyncOnOuterVertex) {
         if (event->buffer->GetTypeId() == typeid(double)) {
-          syncOnOuterVertexSend<double>(i_ec_frag, event->label, event->buffer,
-                                        event->event_id);
+          syncOnOuterVertexSend<double>(*event);
         } else if (event->buffer->GetTypeId() == typeid(uint32_t)) {
-          syncOnOuterVertexSend<uint32_t>(i_ec_frag, event->label,
-                                          event->buffer, event->event_id);
+          syncOnOuterVertexSend<uint32_t>(*event);
         } else if (event->buffer->GetTypeId() == typeid(int32_t)) {
-          syncOnOuterVertexSend<int32_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id);
+          syncOnOuterVertexSend<int32_t>(*event);
         } else if (event->buffer->GetTypeId() == typeid(int64_t)) {
-          syncOnOuterVertexSend<int64_t>(i_ec_frag, event->label, event->buffer,
-                                         event->event_id);
+          syncOnOuterVertexSend<int64_t>(*event);
         } else if (event->buffer->GetTypeId() == typeid(uint64_t)) {
-          syncOnOuterVertexSend<uint64_t>(i_ec_frag, event->label,
-                                          event->buffer, event->event_id);
+          syncOnOuterVertexSend<uint64_t>(*event);
         } else {
           LOG(FATAL) << "Unexpected data type for auto parallelization: "
                      << event->buffer->GetTypeId().name();
@@ -303,40 +291,53 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   }
   */
 
+  /**
+   * @brief Forces another round if an inner vertex was updated, and sends the
+   * updated outer vertices only, resetting the flags. The flags of the outer
+   * vertices are scanned once, and the updated ones are sent from per-fragment
+   * lists, so a round changing few vertices is not charged a second scan.
+   */
   template <typename T>
-  inline void syncOnOuterVertexSend(const FRAG_T& frag, label_id_t label,
-                                    grape::ISyncBuffer* buffer, int event_id) {
+  inline void syncOnOuterVertexSend(ap_event& event) {
+    auto& frag = event.fragment;
     auto* bptr =
         dynamic_cast<grape::SyncBuffer<typename FRAG_T::vertices_t, T>*>(
-            buffer);
-    auto inner_vertices = frag.InnerVertices(label);
-    auto outer_vertices = frag.OuterVertices(label);
-    std::vector<size_t> message_num(Base::fnum(), 0);
+            event.buffer);
+    auto inner_vertices = frag.InnerVertices(event.label);
+    auto outer_vertices = frag.OuterVertices(event.label);
 
+    bool inner_updated = false;
     for (auto v : inner_vertices) {
-      bptr->Reset(v);
-    }
-
-    for (auto v : outer_vertices) {
       if (bptr->IsUpdated(v)) {
-        fid_t fid = frag.GetFragId(v);
-        ++message_num[fid];
+        inner_updated = true;
+        bptr->Reset(v);
       }
     }
-
-    for (fid_t i = 0; i < Base::fnum(); i++) {
-      if (message_num[i] > 0) {
-        Base::SendToFragment<int>(i, event_id);
-        Base::SendToFragment<size_t>(i, message_num[i]);
-      }
+    if (inner_updated) {
+      ForceContinue();
     }
 
+    auto& updated = event.updated_outer_vertices;
+    updated.resize(Base::fnum());
+    for (auto& vec : updated) {
+      vec.clear();
+    }
     for (auto v : outer_vertices) {
       if (bptr->IsUpdated(v)) {
-        Base::SyncStateOnOuterVertex(frag, v, bptr->GetValue(v));
+        updated[frag.GetFragId(v)].push_back(v);
         bptr->Reset(v);
       }
     }
+
+    for (fid_t i = 0; i < Base::fnum(); i++) {
+      if (!updated[i].empty()) {
+        Base::SendToFragment<int>(i, event.event_id);
+        Base::SendToFragment<size_t>(i, updated[i].size());
+        for (auto v : updated[i]) {
+          Base::SyncStateOnOuterVertex(frag, v, bptr->GetValue(v));
+        }
+      }
+    }
   }
 
   template <typename T>
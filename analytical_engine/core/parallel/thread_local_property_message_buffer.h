@@ -184,6 +184,8 @@ class ThreadLocalPropertyMessageBuffer {
    */
   template <typename MESSAGE_T>
   inline void SendToFragment(grape::fid_t dst_fid, const MESSAGE_T& msg) {
+    CHECK(mm_->GetMessageCodec() == nullptr)
+        << "Messages without a gid can not be sent with a message codec";
     to_send_[dst_fid] << msg;
     if (to_send_[dst_fid].GetSize() > block_size_) {
       flushLocalBuffer(dst_fid);
@@ -208,6 +210,10 @@ class ThreadLocalPropertyMessageBuffer {
 
  private:
   inline void flushLocalBuffer(grape::fid_t fid) {
+    auto codec = mm_->GetMessageCodec();
+    if (codec != nullptr) {
+      codec->Encode(to_send_[fid]);
+    }
     mm_->SendRawMsgByFid(fid, std::move(to_send_[fid]));
     to_send_[fid].Reserve(block_cap_);
   }
@@ -19,9 +19,13 @@
 #include <mpi.h>
 
 #include <exception>
+#include <functional>
+#include <mutex>
 #include <ostream>
+#include <shared_mutex>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "boost/leaf/capture.hpp"
 #include "boost/leaf/handle_errors.hpp"
@@ -45,15 +49,32 @@ namespace bl = boost::leaf;
 namespace gs {
 
 Dispatcher::Dispatcher(const grape::CommSpec& comm_spec)
-    : running_(false), comm_spec_(comm_spec) {
+    : running_(false), side_lane_enabled_(false), comm_spec_(comm_spec) {
   // a naive implementation using MPI
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
+  main_lane_.comm_spec = comm_spec_;
+
+  // the side lane runs beside the main one only if MPI may be called by
+  // threads at the same time, which every worker agrees on
+  int provided;
+  MPI_Query_thread(&provided);
+  side_lane_enabled_ = provided == MPI_THREAD_MULTIPLE;
+  if (side_lane_enabled_) {
+    side_lane_.comm_spec = comm_spec_;
+    side_lane_.comm_spec.Dup();
+  } else if (publisher) {
+    LOG(WARNING) << "MPI is not initialized with MPI_THREAD_MULTIPLE, "
+                    "commands are run one at a time";
+  }
+
   // we use blocking queue as synchronizer
   if (publisher) {
-    cmd_queue_.SetProducerNum(1);
-    cmd_queue_.SetLimit(1);
-    result_queue_.SetProducerNum(1);
-    result_queue_.SetLimit(1);
+    for (Lane* lane : {&main_lane_, &side_lane_}) {
+      lane->cmd_queue.SetProducerNum(1);
+      lane->cmd_queue.SetLimit(1);
+      lane->result_queue.SetProducerNum(1);
+      lane->result_queue.SetLimit(1);
+    }
   }
 }
 
@@ -64,30 +85,56 @@ void Dispatcher::Start() {
   running_ = true;
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
 
-  if (publisher) {
-    auto publisher_th = std::thread([this]() { publisherLoop(); });
-    publisher_th.join();
-  } else {
-    auto subscriber_th = std::thread([this]() { subscriberLoop(); });
-    subscriber_th.join();
+  auto loop = [this, publisher](Lane& lane) {
+    if (publisher) {
+      publisherLoop(lane);
+    } else {
+      subscriberLoop(lane);
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.emplace_back(loop, std::ref(main_lane_));
+  if (side_lane_enabled_) {
+    threads.emplace_back(loop, std::ref(side_lane_));
+  }
+  for (auto& th : threads) {
+    th.join();
   }
 }
 
 void Dispatcher::Stop() {
   running_ = false;
-  if (!cmd_queue_.End()) {
-    cmd_queue_.DecProducerNum();
-  }
-  if (!result_queue_.End()) {
-    result_queue_.DecProducerNum();
+  for (Lane* lane : {&main_lane_, &side_lane_}) {
+    if (!lane->cmd_queue.End()) {
+      lane->cmd_queue.DecProducerNum();
+    }
+    if (!lane->result_queue.End()) {
+      lane->result_queue.DecProducerNum();
+    }
   }
 }
 
 std::vector<DispatchResult> Dispatcher::Dispatch(
     std::shared_ptr<CommandDetail> cmd) {
-  cmd_queue_.Put(cmd);
+  bool side = side_lane_enabled_ && isSideCommand(cmd->type);
+  Lane& lane = side ? side_lane_ : main_lane_;
+  std::lock_guard<std::mutex> dispatch_lock(lane.dispatch_mutex);
+
+  // the side lane never waits for the main one, so that the locks are always
+  // taken in the same order
+  std::shared_lock<std::shared_timed_mutex> shared_lock(objects_mutex_,
+                                                        std::defer_lock);
+  std::unique_lock<std::shared_timed_mutex> exclusive_lock(objects_mutex_,
+                                                           std::defer_lock);
+  if (side) {
+    shared_lock.lock();
+  } else if (isExclusiveCommand(cmd->type)) {
+    exclusive_lock.lock();
+  }
+
+  lane.cmd_queue.Put(cmd);
   std::vector<DispatchResult> results;
-  result_queue_.Get(results);
+  lane.result_queue.Get(results);
   return results;
 }
 
@@ -96,19 +143,47 @@ void Dispatcher::Subscribe(std::shared_ptr<Subscriber> subscriber) {
 }
 
 void Dispatcher::SetCommand(std::shared_ptr<CommandDetail> cmd) {
-  processCmd(cmd);
+  processCmd(main_lane_, cmd);
   MPI_Barrier(comm_spec_.comm());
 }
 
+bool Dispatcher::isSideCommand(rpc::OperationType type) {
+  switch (type) {
+  case rpc::REPORT_GRAPH:
+  case rpc::GET_CONTEXT_DATA:
+  case rpc::CONTEXT_TO_NUMPY:
+  case rpc::CONTEXT_TO_DATAFRAME:
+  case rpc::GRAPH_TO_NUMPY:
+  case rpc::GRAPH_TO_DATAFRAME:
+  case rpc::GET_ENGINE_CONFIG:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool Dispatcher::isExclusiveCommand(rpc::OperationType type) {
+  switch (type) {
+  case rpc::MODIFY_VERTICES:
+  case rpc::MODIFY_EDGES:
+  case rpc::CLEAR_GRAPH:
+  case rpc::CLEAR_EDGES:
+  case rpc::UNLOAD_GRAPH:
+    return true;
+  default:
+    return false;
+  }
+}
+
 std::shared_ptr<DispatchResult> Dispatcher::processCmd(
-    std::shared_ptr<CommandDetail> cmd) {
+    Lane& lane, std::shared_ptr<CommandDetail> cmd) {
   // handle all errors and get error message
 #if !defined(NDEBUG) && defined(LET_IT_CRASH_ON_EXCEPTION)
   // Let it crash if non-leaf exception occurs.
   //
   // note that the error id returned to python side is not the expected error id
   // inside a vineyard::GSError
-  auto err = subscriber_->OnReceive(cmd);
+  auto err = subscriber_->OnReceive(cmd, lane.comm_spec);
   if (!err) {
     auto r = std::make_shared<DispatchResult>(comm_spec_.worker_id());
     r->set_error(
@@ -123,7 +198,7 @@ std::shared_ptr<DispatchResult> Dispatcher::processCmd(
   auto r = bl::try_handle_all(
       [&, this]() -> bl::result<std::shared_ptr<DispatchResult>> {
         try {
-          return subscriber_->OnReceive(cmd);
+          return subscriber_->OnReceive(cmd, lane.comm_spec);
         } catch (const std::exception& e) {
           RETURN_GS_ERROR(
               vineyard::ErrorCode::kCommandError,
@@ -157,7 +232,8 @@ std::shared_ptr<DispatchResult> Dispatcher::processCmd(
   return r;
 }
 
-void Dispatcher::publisherPreprocessCmd(std::shared_ptr<CommandDetail> cmd) {
+void Dispatcher::publisherPreprocessCmd(Lane& lane,
+                                        std::shared_ptr<CommandDetail> cmd) {
   if (cmd->type == rpc::CREATE_GRAPH || cmd->type == rpc::ADD_LABELS) {
     // Distribute raw bytes if there are some data from pandas
     auto params_vec = DistributeGraph(cmd->large_attr, comm_spec_.worker_num());
@@ -166,57 +242,60 @@ void Dispatcher::publisherPreprocessCmd(std::shared_ptr<CommandDetail> cmd) {
       grape::InArchive ia;
       cmd->large_attr = params_vec[i];
       ia << *(cmd.get());
-      grape::sync_comm::Send(ia, i, 0, MPI_COMM_WORLD);
+      grape::sync_comm::Send(ia, i, 0, lane.comm_spec.comm());
     }
     cmd->large_attr = params_vec[0];
   } else {
     grape::sync_comm::Bcast(*(cmd.get()), grape::kCoordinatorRank,
-                            MPI_COMM_WORLD);
+                            lane.comm_spec.comm());
   }
 }
 
-void Dispatcher::subscriberPreprocessCmd(rpc::OperationType type,
+void Dispatcher::subscriberPreprocessCmd(Lane& lane, rpc::OperationType type,
                                          std::shared_ptr<CommandDetail>& cmd) {
   if (type == rpc::CREATE_GRAPH || type == rpc::ADD_LABELS) {
     grape::OutArchive oa;
-    grape::sync_comm::Recv(oa, grape::kCoordinatorRank, 0, MPI_COMM_WORLD);
+    grape::sync_comm::Recv(oa, grape::kCoordinatorRank, 0,
+                           lane.comm_spec.comm());
     oa >> *(cmd.get());
   } else {
     grape::sync_comm::Bcast(*(cmd.get()), grape::kCoordinatorRank,
-                            MPI_COMM_WORLD);
+                            lane.comm_spec.comm());
   }
 }
 
-void Dispatcher::publisherLoop() {
+void Dispatcher::publisherLoop(Lane& lane) {
   CHECK_EQ(comm_spec_.worker_id(), grape::kCoordinatorRank);
   while (running_) {
     std::shared_ptr<CommandDetail> cmd;
-    if (!cmd_queue_.Get(cmd)) {
+    if (!lane.cmd_queue.Get(cmd)) {
       break;
     }
-    grape::sync_comm::Bcast(cmd->type, grape::kCoordinatorRank, MPI_COMM_WORLD);
-    publisherPreprocessCmd(cmd);
+    grape::sync_comm::Bcast(cmd->type, grape::kCoordinatorRank,
+                            lane.comm_spec.comm());
+    publisherPreprocessCmd(lane, cmd);
     // process local event
-    auto r = processCmd(cmd);
+    auto r = processCmd(lane, cmd);
     std::vector<DispatchResult> results(comm_spec_.worker_num());
 
     results[0] = std::move(*r);
-    vineyard::_GatherR(results, comm_spec_.comm());
+    vineyard::_GatherR(results, lane.comm_spec.comm());
 
-    result_queue_.Put(std::move(results));
+    lane.result_queue.Put(std::move(results));
   }
 }
 
-void Dispatcher::subscriberLoop() {
+void Dispatcher::subscriberLoop(Lane& lane) {
   CHECK_NE(comm_spec_.worker_id(), grape::kCoordinatorRank);
   while (running_) {
     rpc::OperationType type;
-    grape::sync_comm::Bcast(type, grape::kCoordinatorRank, MPI_COMM_WORLD);
+    grape::sync_comm::Bcast(type, grape::kCoordinatorRank,
+                            lane.comm_spec.comm());
     std::shared_ptr<CommandDetail> cmd = std::make_shared<CommandDetail>();
-    subscriberPreprocessCmd(type, cmd);
-    auto r = processCmd(cmd);
+    subscriberPreprocessCmd(lane, type, cmd);
+    auto r = processCmd(lane, cmd);
 
-    vineyard::_GatherL(*r, grape::kCoordinatorRank, comm_spec_.comm());
+    vineyard::_GatherL(*r, grape::kCoordinatorRank, lane.comm_spec.comm());
   }
 }
 
@@ -16,6 +16,8 @@
 #define ANALYTICAL_ENGINE_CORE_SERVER_DISPATCHER_H_
 
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -111,6 +113,8 @@ class DispatchResult {
 
   const std::string& data() const { return data_; }
 
+  std::string& data() { return data_; }
+
   AggregatePolicy aggregate_policy() const { return aggregate_policy_; }
 
  private:
@@ -138,12 +142,26 @@ class Subscriber {
   Subscriber() = default;
   virtual ~Subscriber() = default;
 
+  /**
+   * @param comm_spec The communicator the workers run the command over, which
+   * the command must use for its collectives rather than MPI_COMM_WORLD, as
+   * commands of different lanes of the dispatcher may run at the same time.
+   */
   virtual bl::result<std::shared_ptr<DispatchResult>> OnReceive(
-      std::shared_ptr<CommandDetail> cmd) = 0;
+      std::shared_ptr<CommandDetail> cmd, const grape::CommSpec& comm_spec) = 0;
 };
 
 /**
  * @brief The dispatcher broadcast commands to every worker using MPI.
+ *
+ * The commands run on two lanes, each of which runs one command at a time by
+ * a thread and a communicator of its own. The main lane runs most of the
+ * commands, the side lane runs the commands that only read the objects and
+ * take little time, e.g. reporting a graph or fetching a context, so that
+ * they need not wait for an app of another user to finish. A command that
+ * changes an object in place, e.g. modifying the edges of a graph, waits for
+ * the side lane to be idle. The side lane requires MPI_THREAD_MULTIPLE, and
+ * all commands run on the main lane without it.
  */
 class Dispatcher {
  public:
@@ -160,24 +178,40 @@ class Dispatcher {
   void SetCommand(std::shared_ptr<CommandDetail> cmd);
 
  private:
+  struct Lane {
+    grape::CommSpec comm_spec;
+    // pairs a command put to the lane with its result
+    std::mutex dispatch_mutex;
+    vineyard::PCBlockingQueue<std::shared_ptr<CommandDetail>> cmd_queue;
+    vineyard::PCBlockingQueue<std::vector<DispatchResult>> result_queue;
+  };
+
+  static bool isSideCommand(rpc::OperationType type);
+
+  static bool isExclusiveCommand(rpc::OperationType type);
+
   std::shared_ptr<DispatchResult> processCmd(
-      std::shared_ptr<CommandDetail> cmd);
+      Lane& lane, std::shared_ptr<CommandDetail> cmd);
 
-  void publisherLoop();
+  void publisherLoop(Lane& lane);
 
-  void subscriberLoop();
+  void subscriberLoop(Lane& lane);
 
-  void publisherPreprocessCmd(std::shared_ptr<CommandDetail> cmd);
+  void publisherPreprocessCmd(Lane& lane, std::shared_ptr<CommandDetail> cmd);
 
-  void subscriberPreprocessCmd(rpc::OperationType type,
+  void subscriberPreprocessCmd(Lane& lane, rpc::OperationType type,
                                std::shared_ptr<CommandDetail>& cmd);
 
  private:
   bool running_;
+  bool side_lane_enabled_;
   grape::CommSpec comm_spec_;
   std::shared_ptr<Subscriber> subscriber_;
-  vineyard::PCBlockingQueue<std::shared_ptr<CommandDetail>> cmd_queue_;
-  vineyard::PCBlockingQueue<std::vector<DispatchResult>> result_queue_;
+  Lane main_lane_;
+  Lane side_lane_;
+  // held shared by a command on the side lane, and exclusively by a command
+  // that changes an object in place
+  std::shared_timed_mutex objects_mutex_;
 };
 
 }  // namespace gs
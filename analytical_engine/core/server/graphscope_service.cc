@@ -93,8 +93,8 @@ Status GraphScopeService::HeartBeat(ServerContext* context,
   // construct ops result
   RunStepResponse response_head;
   auto* head = response_head.mutable_head();
-  // a list of chunks as response body for large result
-  std::vector<RunStepResponse> response_bodies;
+  // the large results, written as chunks of response body after the head
+  std::vector<std::string> large_results;
 
   // execute the dag
   for (const auto& op : dag_def.op()) {
@@ -129,7 +129,7 @@ Status GraphScopeService::HeartBeat(ServerContext* context,
     // Second pass: aggregate graph def or data result according to the policy
     switch (policy) {
     case DispatchResult::AggregatePolicy::kPickFirst: {
-      splitOpResult(op_result, result[0], response_bodies);
+      splitOpResult(op_result, result[0], large_results);
       break;
     }
     case DispatchResult::AggregatePolicy::kPickFirstNonEmpty: {
@@ -137,7 +137,7 @@ Status GraphScopeService::HeartBeat(ServerContext* context,
         auto& data = e.data();
 
         if (!data.empty()) {
-          splitOpResult(op_result, e, response_bodies);
+          splitOpResult(op_result, e, large_results);
           break;
         }
       }
@@ -177,7 +177,7 @@ Status GraphScopeService::HeartBeat(ServerContext* context,
     }
     case DispatchResult::AggregatePolicy::kConcat: {
       for (auto& e : result) {
-        splitOpResult(op_result, e, response_bodies);
+        splitOpResult(op_result, e, large_results);
       }
       break;
     }
@@ -212,9 +212,7 @@ Status GraphScopeService::HeartBeat(ServerContext* context,
 
   // write responses as stream
   stream->Write(response_head);
-  for (auto& response_body : response_bodies) {
-    stream->Write(response_body);
-  }
+  writeLargeResults(large_results, stream);
 
   return ::grpc::Status::OK;
 }
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_CORE_SERVER_GRAPHSCOPE_SERVICE_H_
 #define ANALYTICAL_ENGINE_CORE_SERVER_GRAPHSCOPE_SERVICE_H_
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -67,28 +68,17 @@ class GraphScopeService final : public EngineService::Service {
                            HeartBeatResponse* response) override;
 
  private:
-  void splitOpResult(OpResult* op_result, const DispatchResult& result,
-                     std::vector<RunStepResponse>& response_bodies) {
+  // The large data of a result is moved out of it, to be split into chunks
+  // when written after the head, so that a single chunk is copied at a time.
+  void splitOpResult(OpResult* op_result, DispatchResult& result,
+                     std::vector<std::string>& large_results) {
     auto policy = result.aggregate_policy();
-    const std::string& data = result.data();
+    std::string& data = result.data();
 
     // has_large_result
     op_result->mutable_meta()->set_has_large_result(result.has_large_data());
     if (op_result->meta().has_large_result()) {
-      // split
-      for (size_t i = 0; i < data.size(); i += chunk_size_) {
-        RunStepResponse response_body;
-        auto* body = response_body.mutable_body();
-        if ((i + chunk_size_) >= data.size()) {
-          body->mutable_chunk()->assign(data.begin() + i, data.end());
-          body->set_has_next(false);
-        } else {
-          body->mutable_chunk()->assign(data.begin() + i,
-                                        data.begin() + i + chunk_size_);
-          body->set_has_next(true);
-        }
-        response_bodies.push_back(std::move(response_body));
-      }
+      large_results.push_back(std::move(data));
     } else {
       if (policy == DispatchResult::AggregatePolicy::kConcat) {
         op_result->mutable_result()->append(data);
@@ -98,6 +88,24 @@ class GraphScopeService final : public EngineService::Service {
     }
   }
 
+  void writeLargeResults(
+      const std::vector<std::string>& large_results,
+      ServerReaderWriter<RunStepResponse, RunStepRequest>* stream) {
+    RunStepResponse response_body;
+    auto* body = response_body.mutable_body();
+    for (auto& data : large_results) {
+      // an empty result is still a chunk, so that the client sees its end
+      size_t i = 0;
+      do {
+        size_t end = std::min(i + chunk_size_, data.size());
+        body->mutable_chunk()->assign(data.begin() + i, data.begin() + end);
+        body->set_has_next(end < data.size());
+        stream->Write(response_body);
+        i = end;
+      } while (i < data.size());
+    }
+  }
+
  private:
   std::shared_ptr<Dispatcher> dispatcher_;
   size_t chunk_size_;
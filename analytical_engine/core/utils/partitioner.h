@@ -18,10 +18,13 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/config.h"
 #include "core/object/dynamic.h"
@@ -46,7 +49,8 @@ class HashPartitioner<::gs::dynamic::Value> {
         (oid[1].IsInt64() || oid[1].IsString())) {
       hash_value = oid[1].IsInt64()
                        ? std::hash<int64_t>()(oid[1].GetInt64())
-                       : std::hash<std::string>()(oid[1].GetString());
+                       : ::gs::dynamic::HashString(oid[1].GetString(),
+                                                   oid[1].GetStringLength());
     } else {
       hash_value = std::hash<oid_t>()(oid);
     }
@@ -89,4 +93,194 @@ class HashPartitioner<::gs::dynamic::Value> {
 #endif  // NETWORKX
 
 }  // namespace grape
+
+namespace gs {
+
+/**
+ * @brief How a loader with a segmented partitioner assigns the vertices it
+ * has read to fragments.
+ */
+enum class PartitionStrategy {
+  // the same number of vertices per fragment, in the order they are read
+  kSegmented,
+  // ranges of vertices, in the order they are read, of about the same number
+  // of edges and vertices per fragment
+  kEdgeBalanced,
+  // vertices streamed by Fennel, which puts a vertex where most of its
+  // neighbors are, to cut fewer edges
+  kFennel,
+  // the hubs, i.e. the vertices of the highest degrees, spread over the
+  // fragments first, and then ranges of the other vertices as in
+  // kEdgeBalanced, so that the hubs do not pile up in a few fragments
+  kHybrid,
+};
+
+inline bool ParsePartitionStrategy(const std::string& name,
+                                   PartitionStrategy& strategy) {
+  if (name.empty() || name == "segmented") {
+    strategy = PartitionStrategy::kSegmented;
+  } else if (name == "edge_balanced") {
+    strategy = PartitionStrategy::kEdgeBalanced;
+  } else if (name == "fennel") {
+    strategy = PartitionStrategy::kFennel;
+  } else if (name == "hybrid") {
+    strategy = PartitionStrategy::kHybrid;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Splits the vertices 0 .. degrees.size() - 1 into fnum ranges, so
+ * that the degrees plus vertex_weight of the vertices of each range sum up to
+ * about the same, e.g. the edges a fragment stores and the vertices it keeps
+ * state for.
+ */
+inline std::vector<fid_t> PartitionByCumulativeDegree(
+    fid_t fnum, const std::vector<uint32_t>& degrees,
+    uint64_t vertex_weight = 1) {
+  uint64_t total = 0;
+  for (auto degree : degrees) {
+    total += degree + vertex_weight;
+  }
+  std::vector<fid_t> fids(degrees.size());
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < degrees.size(); ++i) {
+    uint64_t weight = degrees[i] + vertex_weight;
+    // by the middle of the vertex, so that a heavy vertex goes to the range
+    // that covers most of it
+    double middle = static_cast<double>(prefix) + weight / 2.0;
+    fids[i] = std::min(static_cast<fid_t>(middle * fnum / total), fnum - 1);
+    prefix += weight;
+  }
+  return fids;
+}
+
+/**
+ * @brief Like PartitionByCumulativeDegree, but the hubs, i.e. the vertices of
+ * a degree of at least min_hub_degree, and of at least 1 / 64 of the average
+ * weight of a fragment, are placed first, each to the fragment of the least
+ * weight so far, in descending order of degree as in the LPT scheduling.
+ * The other vertices then fill the fragments in order, up to the average
+ * weight, so that no fragment holds the edges of many hubs while the ranges
+ * of the other vertices keep their locality.
+ */
+inline std::vector<fid_t> PartitionByHybridCut(
+    fid_t fnum, const std::vector<uint32_t>& degrees,
+    uint64_t vertex_weight = 1, uint32_t min_hub_degree = 100) {
+  uint64_t total = 0;
+  for (auto degree : degrees) {
+    total += degree + vertex_weight;
+  }
+  double target = static_cast<double>(total) / fnum;
+  uint64_t hub_degree =
+      std::max<uint64_t>(min_hub_degree, static_cast<uint64_t>(target / 64));
+  std::vector<size_t> hubs;
+  for (size_t i = 0; i < degrees.size(); ++i) {
+    if (degrees[i] >= hub_degree) {
+      hubs.push_back(i);
+    }
+  }
+  std::sort(hubs.begin(), hubs.end(), [&degrees](size_t lhs, size_t rhs) {
+    return degrees[lhs] > degrees[rhs] ||
+           (degrees[lhs] == degrees[rhs] && lhs < rhs);
+  });
+
+  std::vector<fid_t> fids(degrees.size(), fnum);
+  std::vector<uint64_t> loads(fnum, 0);
+  for (auto hub : hubs) {
+    fid_t fid = static_cast<fid_t>(
+        std::min_element(loads.begin(), loads.end()) - loads.begin());
+    fids[hub] = fid;
+    loads[fid] += degrees[hub] + vertex_weight;
+  }
+  fid_t cur = 0;
+  for (size_t i = 0; i < degrees.size(); ++i) {
+    if (fids[i] != fnum) {
+      continue;
+    }
+    uint64_t weight = degrees[i] + vertex_weight;
+    // by the middle of the vertex, as in PartitionByCumulativeDegree
+    while (cur + 1 < fnum && loads[cur] + weight / 2.0 > target) {
+      ++cur;
+    }
+    fids[i] = cur;
+    loads[cur] += weight;
+  }
+  return fids;
+}
+
+/**
+ * @brief Places a stream of vertices to fnum fragments by Fennel
+ * (Tsourakakis et al., WSDM 2014). A vertex goes to the fragment i that
+ * maximizes |N(v) in P_i| - alpha * gamma * |P_i|^(gamma - 1), among the
+ * fragments below slack times the average size, where N(v) are the
+ * neighbors placed before it.
+ */
+class FennelPartitioner {
+ public:
+  FennelPartitioner(fid_t fnum, size_t vertex_num, size_t edge_num,
+                    double gamma = 1.5, double slack = 1.1)
+      : fnum_(fnum),
+        gamma_(gamma),
+        sizes_(fnum, 0),
+        neighbors_(fnum, 0) {
+    double n = std::max<double>(vertex_num, 1);
+    alpha_ = edge_num * std::pow(fnum, gamma - 1) / std::pow(n, gamma);
+    capacity_ = std::max<size_t>(std::ceil(slack * n / fnum), 1);
+  }
+
+  /**
+   * @brief Places a vertex, whose neighbors placed so far are in the
+   * fragments [begin, end), fragments not below fnum are skipped.
+   */
+  template <typename ITER_T>
+  fid_t Place(ITER_T begin, ITER_T end) {
+    touched_.clear();
+    for (auto iter = begin; iter != end; ++iter) {
+      fid_t fid = *iter;
+      if (fid < fnum_) {
+        if (neighbors_[fid]++ == 0) {
+          touched_.push_back(fid);
+        }
+      }
+    }
+    fid_t best = fnum_;
+    double best_score = 0;
+    for (fid_t fid = 0; fid < fnum_; ++fid) {
+      if (sizes_[fid] >= capacity_) {
+        continue;
+      }
+      double score = neighbors_[fid] - alpha_ * gamma_ *
+                                           std::pow(sizes_[fid], gamma_ - 1);
+      if (best == fnum_ || score > best_score ||
+          (score == best_score && sizes_[fid] < sizes_[best])) {
+        best = fid;
+        best_score = score;
+      }
+    }
+    if (best == fnum_) {
+      best = static_cast<fid_t>(
+          std::min_element(sizes_.begin(), sizes_.end()) - sizes_.begin());
+    }
+    for (auto fid : touched_) {
+      neighbors_[fid] = 0;
+    }
+    ++sizes_[best];
+    return best;
+  }
+
+ private:
+  fid_t fnum_;
+  double gamma_;
+  double alpha_;
+  size_t capacity_;
+  std::vector<size_t> sizes_;
+  std::vector<size_t> neighbors_;
+  std::vector<fid_t> touched_;
+};
+
+}  // namespace gs
+
 #endif  // ANALYTICAL_ENGINE_CORE_UTILS_PARTITIONER_H_
@@ -24,6 +24,8 @@
 #include "grape/vertex_map/global_vertex_map.h"
 #include "vineyard/graph/utils/string_collection.h"
 
+#include "core/vertex_map/pthash_string_index.h"
+
 namespace grape {
 
 template <typename VID_T, typename PARTITIONER_T>
@@ -112,7 +114,9 @@ class GlobalVertexMapBuilder<std::string, VID_T, PARTITIONER_T> {
       for (int tid = 0; tid < thread_num; ++tid) {
         work_threads[tid] = std::thread([&] {
           fid_t got;
+#ifndef USE_PTHASH
           RefString rs;
+#endif
           while (true) {
             got = current_fid.fetch_add(1, std::memory_order_relaxed);
             if (got >= fnum) {
@@ -121,6 +125,10 @@ class GlobalVertexMapBuilder<std::string, VID_T, PARTITIONER_T> {
             if (comm_spec.FragToWorker(got) == worker_id) {
               continue;
             }
+#ifdef USE_PTHASH
+            vertex_map.remote_indices_[got].Build(
+                vertex_map.string_collections_[got]);
+#else
             auto& rm = vertex_map.o2l_[got];
             VID_T vnum =
                 static_cast<VID_T>(vertex_map.string_collections_[got].Count());
@@ -129,6 +137,7 @@ class GlobalVertexMapBuilder<std::string, VID_T, PARTITIONER_T> {
               vertex_map.string_collections_[got].Get(lid, rs);
               rm.emplace(rs, lid);
             }
+#endif
           }
         });
       }
@@ -165,12 +174,15 @@ class GlobalVertexMap<std::string, VID_T, PARTITIONER_T>
   void Init() {
     o2l_.resize(comm_spec_.fnum());
     string_collections_.resize(comm_spec_.fnum());
+#ifdef USE_PTHASH
+    remote_indices_.resize(comm_spec_.fnum());
+#endif
   }
 
   size_t GetTotalVertexSize() {
     size_t size = 0;
-    for (const auto& v : o2l_) {
-      size += v.size();
+    for (auto& sc : string_collections_) {
+      size += sc.Count();
     }
     return size;
   }
@@ -226,6 +238,16 @@ class GlobalVertexMap<std::string, VID_T, PARTITIONER_T>
 
   bool GetGid(fid_t fid, const std::string& oid, VID_T& gid) {
     RefString ref_oid(oid);
+#ifdef USE_PTHASH
+    if (remote_indices_[fid].built()) {
+      VID_T lid;
+      if (!remote_indices_[fid].Get(ref_oid, lid)) {
+        return false;
+      }
+      gid = Base::Lid2Gid(fid, lid);
+      return true;
+    }
+#endif
     auto& rm = o2l_[fid];
     auto iter = rm.find(ref_oid);
     if (iter == rm.end()) {
@@ -282,6 +304,10 @@ class GlobalVertexMap<std::string, VID_T, PARTITIONER_T>
 
     o2l_.clear();
     o2l_.resize(Base::GetFragmentNum());
+#ifdef USE_PTHASH
+    remote_indices_.clear();
+    remote_indices_.resize(Base::GetFragmentNum());
+#endif
     {
       int thread_num = (std::thread::hardware_concurrency() +
                         Base::GetCommSpec().local_num() - 1) /
@@ -298,6 +324,13 @@ class GlobalVertexMap<std::string, VID_T, PARTITIONER_T>
             if (got >= fnum) {
               break;
             }
+#ifdef USE_PTHASH
+            if (Base::GetCommSpec().FragToWorker(got) !=
+                Base::GetCommSpec().worker_id()) {
+              remote_indices_[got].Build(string_collections_[got]);
+              continue;
+            }
+#endif
             auto& rm = o2l_[got];
             size_t vnum = string_collections_[got].Count();
             rm.reserve(vnum);
@@ -317,14 +350,68 @@ class GlobalVertexMap<std::string, VID_T, PARTITIONER_T>
     CHECK(io_adaptor->Close());
   }
 
+  /**
+   * @brief Moves the vertices to the fragments and local ids a rebalance has
+   * given them, where gid_maps[fid][lid] is the new gid of the vertex of lid
+   * in fragment fid, and vnum_list[fid] the new number of vertices of fid.
+   */
   void UpdateToBalance(std::vector<VID_T>& vnum_list,
                        std::vector<std::vector<VID_T>>& gid_maps) {
-    LOG(FATAL) << "Not implemented.";
+    fid_t fnum = Base::GetFragmentNum();
+    std::vector<std::vector<std::string>> oid_lists(fnum);
+    for (fid_t fid = 0; fid < fnum; ++fid) {
+      oid_lists[fid].resize(vnum_list[fid]);
+    }
+    std::string oid;
+    for (fid_t fid = 0; fid < fnum; ++fid) {
+      auto& gid_map = gid_maps[fid];
+      auto& sc = string_collections_[fid];
+      for (size_t lid = 0; lid < gid_map.size(); ++lid) {
+        VID_T new_gid = gid_map[lid];
+        fid_t new_fid = GetFidFromGid(new_gid);
+        sc.Get(lid, oid);
+        partitioner_.SetPartitionId(oid, new_fid);
+        oid_lists[new_fid][GetLidFromGid(new_gid)] = oid;
+      }
+    }
+
+    std::vector<StringCollection>(fnum).swap(string_collections_);
+    o2l_.clear();
+    o2l_.resize(fnum);
+#ifdef USE_PTHASH
+    remote_indices_.clear();
+    remote_indices_.resize(fnum);
+#endif
+    for (fid_t fid = 0; fid < fnum; ++fid) {
+      auto& sc = string_collections_[fid];
+      for (auto& str : oid_lists[fid]) {
+        sc.PutString(RefString(str));
+      }
+      std::vector<std::string>().swap(oid_lists[fid]);
+#ifdef USE_PTHASH
+      if (comm_spec_.FragToWorker(fid) != comm_spec_.worker_id()) {
+        remote_indices_[fid].Build(sc);
+        continue;
+      }
+#endif
+      auto& rm = o2l_[fid];
+      RefString rs;
+      rm.reserve(sc.Count());
+      for (size_t lid = 0; lid < sc.Count(); ++lid) {
+        sc.Get(lid, rs);
+        rm.emplace(rs, static_cast<VID_T>(lid));
+      }
+    }
   }
 
  private:
   std::vector<StringCollection> string_collections_;
+  // With USE_PTHASH, the oids of the fragments of other workers, which are not
+  // added to afterwards, are indexed by perfect hashing rather than by o2l_.
   std::vector<HashMap<RefString, VID_T>> o2l_;
+#ifdef USE_PTHASH
+  std::vector<gs::PTHashStringIndex<StringCollection, VID_T>> remote_indices_;
+#endif
   using Base::comm_spec_;
   using Base::id_parser_;
   using Base::partitioner_;
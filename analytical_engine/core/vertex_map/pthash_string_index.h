@@ -0,0 +1,155 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PTHASH_STRING_INDEX_H_
+#define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PTHASH_STRING_INDEX_H_
+
+#ifdef USE_PTHASH
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "vineyard/graph/utils/string_collection.h"
+
+#include "murmurhash.h"
+#include "utils/bucketers.hpp"  // NOLINT(build/include_subdir)
+#include "utils/hasher.hpp"     // NOLINT(build/include_subdir)
+
+#include "pthash.hpp"
+
+namespace gs {
+
+struct RefStringMurmurHasher {
+  typedef pthash::hash64 hash_type;
+
+  static inline hash_type hash(const grape::RefString& val, uint64_t seed) {
+    return MurmurHash2_64(val.data(), val.size(), seed);
+  }
+};
+
+/**
+ * @brief A read-only index from the strings of a collection to their
+ * positions in it, i.e. the local ids of the oids of a fragment, by a minimal
+ * perfect hash over them.
+ *
+ * The strings themselves stay in the collection, the index keeps a few bits
+ * per string for the hash and a slot of VID_T per string for the position, in
+ * place of a hash map of RefString keys. A string not in the collection is
+ * told apart by comparing it with the string at the position it hashes to.
+ *
+ * @tparam COLLECTION_T A string collection, with Count() and Get(i, ref).
+ * @tparam VID_T VID type
+ */
+template <typename COLLECTION_T, typename VID_T>
+class PTHashStringIndex {
+  using phf_t =
+      pthash::single_phf<RefStringMurmurHasher, pthash::dictionary_dictionary,
+                         true>;
+
+  struct key_iterator {
+    key_iterator(COLLECTION_T* collection, size_t index)
+        : collection(collection), index(index) {}
+
+    grape::RefString operator*() const {
+      grape::RefString ref;
+      collection->Get(index, ref);
+      return ref;
+    }
+
+    key_iterator& operator++() {
+      ++index;
+      return *this;
+    }
+
+    key_iterator operator+(uint64_t offset) const {
+      return key_iterator(collection, index + offset);
+    }
+
+    COLLECTION_T* collection;
+    size_t index;
+  };
+
+ public:
+  PTHashStringIndex() : collection_(nullptr) {}
+
+  /**
+   * @brief Builds the index over collection, which must outlive it and not
+   * be changed afterwards.
+   */
+  void Build(COLLECTION_T& collection, int thread_num = 1) {
+    collection_ = &collection;
+    size_t num = collection.Count();
+    slots_.clear();
+    // pthash needs at least two keys, a smaller collection is scanned.
+    if (num < 2) {
+      return;
+    }
+    pthash::build_configuration config;
+    config.c = 7.0;
+    config.alpha = 0.94;
+    // pthash builds a few keys by a single thread only, and takes no more
+    // threads than cores.
+    uint64_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+    config.num_threads =
+        num > 100 ? std::min<uint64_t>(std::max(thread_num, 1), cores) : 1;
+    config.minimal_output = true;
+    config.verbose_output = false;
+    phf_.build_in_internal_memory(key_iterator(collection_, 0), num, config);
+
+    slots_.resize(num);
+    grape::RefString ref;
+    for (size_t lid = 0; lid < num; ++lid) {
+      collection.Get(lid, ref);
+      slots_[phf_(ref)] = static_cast<VID_T>(lid);
+    }
+  }
+
+  bool built() const { return collection_ != nullptr; }
+
+  bool Get(const grape::RefString& oid, VID_T& lid) const {
+    grape::RefString ref;
+    if (slots_.empty()) {
+      size_t num = built() ? collection_->Count() : 0;
+      for (size_t i = 0; i < num; ++i) {
+        collection_->Get(i, ref);
+        if (ref == oid) {
+          lid = static_cast<VID_T>(i);
+          return true;
+        }
+      }
+      return false;
+    }
+    VID_T candidate = slots_[phf_(oid)];
+    collection_->Get(candidate, ref);
+    if (ref != oid) {
+      return false;
+    }
+    lid = candidate;
+    return true;
+  }
+
+ private:
+  COLLECTION_T* collection_;
+  phf_t phf_;
+  std::vector<VID_T> slots_;
+};
+
+}  // namespace gs
+
+#endif  // USE_PTHASH
+#endif  // ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PTHASH_STRING_INDEX_H_
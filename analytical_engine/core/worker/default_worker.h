@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,9 @@
 #include "grape/parallel/parallel_engine.h"
 #include "grape/util.h"
 
+#include "core/parallel/checkpoint_message_manager.h"
+#include "core/worker/superstep_checkpointer.h"
+
 namespace gs {
 
 template <typename FRAG_T, typename CONTEXT_T>
@@ -41,6 +45,9 @@ class JavaContextBase;
  * @brief DefaultWorker manages the computation cycle. DefaultWorker is a kind
  * of serial worker for apps derived from AppBase.
  *
+ * The query of an app whose context is checkpointable is checkpointed at the
+ * end of its rounds and resumed on restart, see SuperstepCheckpointer.
+ *
  * @tparam APP_T
  */
 template <typename APP_T>
@@ -54,7 +61,7 @@ class DefaultWorker {
   using fragment_t = typename APP_T::fragment_t;
   using context_t = typename APP_T::context_t;
 
-  using message_manager_t = grape::DefaultMessageManager;
+  using message_manager_t = CheckpointMessageManager;
 
   DefaultWorker(std::shared_ptr<APP_T> app, std::shared_ptr<fragment_t> graph)
       : app_(app), context_(std::make_shared<context_t>(*graph)) {}
@@ -95,11 +102,18 @@ class DefaultWorker {
 
     context_->Init(messages_, std::forward<Args>(args)...);
 
+    SuperstepCheckpointer<context_t> checkpointer(comm_spec_,
+                                                  typeid(APP_T).name());
+
     messages_.Start();
 
     messages_.StartARound();
 
-    app_->PEval(graph, *context_, messages_);
+    int step = checkpointer.Restore(*context_, messages_) + 1;
+    if (step == 0) {
+      app_->PEval(graph, *context_, messages_);
+      step = 1;
+    }
 
     messages_.FinishARound();
 
@@ -108,14 +122,14 @@ class DefaultWorker {
               << grape::GetCurrentTime() - t << " sec";
     }
 
-    int step = 1;
-
     while (!messages_.ToTerminate()) {
+      checkpointer.Commit();
       t = grape::GetCurrentTime();
       messages_.StartARound();
 
       app_->IncEval(graph, *context_, messages_);
 
+      checkpointer.Snapshot(step, *context_, messages_);
       messages_.FinishARound();
 
       if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
@@ -127,6 +141,7 @@ class DefaultWorker {
 
     MPI_Barrier(comm_spec_.comm());
 
+    checkpointer.Finish();
     messages_.Finalize();
   }
 
@@ -0,0 +1,226 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_WORKER_INCREMENTAL_WORKER_H_
+#define ANALYTICAL_ENGINE_CORE_WORKER_INCREMENTAL_WORKER_H_
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grape/communication/communicator.h"
+#include "grape/parallel/default_message_manager.h"
+#include "grape/parallel/parallel_engine.h"
+#include "grape/util.h"
+
+namespace gs {
+
+template <typename FRAG_T, typename CONTEXT_T>
+class IncrementalAppBase;
+
+/**
+ * @brief Extends array, of the vertices old_range, to the vertices new_range,
+ * which covers old_range, keeping the values of the vertices of old_range
+ * and setting the others to value.
+ */
+template <typename ARRAY_T, typename RANGE_T, typename T>
+void GrowVertexArray(ARRAY_T& array, const RANGE_T& old_range,
+                     const RANGE_T& new_range, const T& value) {
+  std::vector<T> values;
+  for (auto v : old_range) {
+    values.push_back(array[v]);
+  }
+  array.Init(new_range, value);
+  size_t index = 0;
+  for (auto v : old_range) {
+    array[v] = values[index++];
+  }
+}
+
+/**
+ * @brief IncrementalWorker manages the computation cycle of an app derived
+ * from IncrementalAppBase, like DefaultWorker, and keeps its context after a
+ * query, so that Update brings the result up to date with the mutations of
+ * the fragment since, from the vertices they touched rather than from
+ * scratch.
+ *
+ * @tparam APP_T
+ */
+template <typename APP_T>
+class IncrementalWorker {
+  static_assert(
+      std::is_base_of<IncrementalAppBase<typename APP_T::fragment_t,
+                                         typename APP_T::context_t>,
+                      APP_T>::value,
+      "IncrementalWorker should work with IncrementalApp");
+
+ public:
+  using fragment_t = typename APP_T::fragment_t;
+  using context_t = typename APP_T::context_t;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vertices_t = typename fragment_t::vertices_t;
+
+  using message_manager_t = grape::DefaultMessageManager;
+
+  IncrementalWorker(std::shared_ptr<APP_T> app,
+                    std::shared_ptr<fragment_t> graph)
+      : app_(app), context_(std::make_shared<context_t>(*graph)) {}
+
+  ~IncrementalWorker() = default;
+
+  void Init(const grape::CommSpec& comm_spec,
+            const grape::ParallelEngineSpec& pe_spec =
+                grape::DefaultParallelEngineSpec()) {
+    comm_spec_ = comm_spec;
+    prepare();
+
+    MPI_Barrier(comm_spec_.comm());
+
+    messages_.Init(comm_spec_.comm());
+
+    InitParallelEngine(app_, pe_spec);
+    grape::InitCommunicator(app_, comm_spec.comm());
+  }
+
+  void Finalize() {}
+
+  template <class... Args>
+  void Query(Args&&... args) {
+    // kept to run the query again after a mutation Update can't resume from
+    init_ = [this, args...]() { context_->Init(messages_, args...); };
+    run(true);
+  }
+
+  /**
+   * @brief Brings the result of the last query up to date with the mutations
+   * of the fragment since. It resumes from the result if the mutations of
+   * all the fragments only added vertices and edges, and runs the query again
+   * otherwise.
+   *
+   * @return Whether the result is resumed rather than computed again.
+   */
+  bool Update() {
+    auto& log = context_->fragment().GetMutationLog();
+    int local_resumable = log.other_mutations == other_mutations_ &&
+                                  log.edges_added.size() >= edges_logged_
+                              ? 1
+                              : 0,
+        resumable = 0;
+    MPI_Allreduce(&local_resumable, &resumable, 1, MPI_INT, MPI_MIN,
+                  comm_spec_.comm());
+    // the outer vertices may have changed
+    prepare();
+    if (resumable) {
+      context_->Grow(vertices_);
+    }
+    run(!resumable);
+    return resumable;
+  }
+
+  std::shared_ptr<context_t> GetContext() { return context_; }
+
+  void Output(std::ostream& os) { context_->Output(os); }
+
+ private:
+  void prepare() {
+    auto& graph = const_cast<fragment_t&>(context_->fragment());
+    grape::PrepareConf conf;
+    conf.message_strategy = APP_T::message_strategy;
+    conf.need_split_edges = APP_T::need_split_edges;
+    conf.need_mirror_info = false;
+    graph.PrepareToRunApp(comm_spec_, conf);
+  }
+
+  void run(bool from_scratch) {
+    double t = grape::GetCurrentTime();
+
+    auto& graph = context_->fragment();
+    auto& log = graph.GetMutationLog();
+
+    MPI_Barrier(comm_spec_.comm());
+
+    std::vector<std::pair<vertex_t, vertex_t>> edges_added;
+    if (from_scratch) {
+      init_();
+    } else {
+      edges_added.reserve(log.edges_added.size() - edges_logged_);
+      for (size_t i = edges_logged_; i < log.edges_added.size(); ++i) {
+        edges_added.emplace_back(vertex_t(log.edges_added[i].first),
+                                 vertex_t(log.edges_added[i].second));
+      }
+    }
+
+    messages_.Start();
+
+    messages_.StartARound();
+
+    if (from_scratch) {
+      app_->PEval(graph, *context_, messages_);
+    } else {
+      app_->Resume(graph, *context_, messages_, edges_added);
+    }
+
+    messages_.FinishARound();
+
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      VLOG(1) << "[Coordinator]: Finished "
+              << (from_scratch ? "PEval" : "Resume")
+              << ", time: " << grape::GetCurrentTime() - t << " sec";
+    }
+
+    int step = 1;
+
+    while (!messages_.ToTerminate()) {
+      t = grape::GetCurrentTime();
+      messages_.StartARound();
+
+      app_->IncEval(graph, *context_, messages_);
+
+      messages_.FinishARound();
+
+      if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+        VLOG(1) << "[Coordinator]: Finished IncEval - " << step
+                << ", time: " << grape::GetCurrentTime() - t << " sec";
+      }
+      ++step;
+    }
+
+    MPI_Barrier(comm_spec_.comm());
+
+    messages_.Finalize();
+
+    edges_logged_ = log.edges_added.size();
+    other_mutations_ = log.other_mutations;
+    vertices_ = graph.Vertices();
+  }
+
+  std::shared_ptr<APP_T> app_;
+  std::shared_ptr<context_t> context_;
+  message_manager_t messages_;
+  std::function<void()> init_;
+
+  // the mutations the result is up to date with, and the vertices then
+  size_t edges_logged_ = 0;
+  size_t other_mutations_ = 0;
+  vertices_t vertices_;
+
+  grape::CommSpec comm_spec_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_WORKER_INCREMENTAL_WORKER_H_
@@ -0,0 +1,286 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_WORKER_SUPERSTEP_CHECKPOINTER_H_
+#define ANALYTICAL_ENGINE_CORE_WORKER_SUPERSTEP_CHECKPOINTER_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+#include "grape/worker/comm_spec.h"
+
+#include "core/parallel/checkpoint_message_manager.h"
+
+namespace gs {
+
+/**
+ * @brief Whether a context can be checkpointed, by providing
+ *
+ *   void Checkpoint(grape::InArchive& arc) const;
+ *   void Restore(grape::OutArchive& arc);
+ *
+ * which archive its states at the end of a round and put them back into a
+ * context initialized by the same query, see ArchiveVertexArray.
+ */
+template <typename CONTEXT_T, typename = void>
+struct is_checkpointable : std::false_type {};
+
+template <typename CONTEXT_T>
+struct is_checkpointable<
+    CONTEXT_T, decltype(std::declval<const CONTEXT_T&>().Checkpoint(
+                            std::declval<grape::InArchive&>()),
+                        std::declval<CONTEXT_T&>().Restore(
+                            std::declval<grape::OutArchive&>()),
+                        void())> : std::true_type {};
+
+template <typename RANGE_T, typename ARRAY_T>
+void ArchiveVertexArray(grape::InArchive& arc, const RANGE_T& vertices,
+                        const ARRAY_T& array) {
+  for (auto v : vertices) {
+    arc << array[v];
+  }
+}
+
+template <typename RANGE_T, typename ARRAY_T>
+void UnarchiveVertexArray(grape::OutArchive& arc, const RANGE_T& vertices,
+                          ARRAY_T& array) {
+  for (auto v : vertices) {
+    arc >> array[v];
+  }
+}
+
+/**
+ * @brief Checkpoints a query at the end of a round, every
+ * GS_CHECKPOINT_INTERVAL rounds (10 by default), to the directory
+ * GS_CHECKPOINT_DIR, and resumes the query from the latest checkpoint all
+ * the fragments have when it is run again, e.g. after a worker is lost.
+ *
+ * A checkpoint of a fragment is its context and the messages it sends in
+ * the round. It is archived before the messages are exchanged and written
+ * by a thread of its own while the next rounds run, once the round is known
+ * not to be the last one. The fragments write it to two files in turn,
+ * each by renaming a complete one, so that one of them stays whole if a
+ * worker fails while writing. The files are removed when the query
+ * finishes, and a query is resumed only by the same app on the same
+ * number of fragments, so that a directory is meant for a job.
+ *
+ * Nothing is checkpointed without GS_CHECKPOINT_DIR or for a context that
+ * is not checkpointable.
+ */
+template <typename CONTEXT_T, bool = is_checkpointable<CONTEXT_T>::value>
+class SuperstepCheckpointer {
+ public:
+  SuperstepCheckpointer(const grape::CommSpec& comm_spec,
+                        const std::string& tag) {}
+
+  int Restore(CONTEXT_T& ctx, CheckpointMessageManager& messages) {
+    return -1;
+  }
+
+  void Snapshot(int round, const CONTEXT_T& ctx,
+                const CheckpointMessageManager& messages) {}
+
+  void Commit() {}
+
+  void Finish() {}
+};
+
+template <typename CONTEXT_T>
+class SuperstepCheckpointer<CONTEXT_T, true> {
+  static constexpr uint64_t kMagic = 0x3130545043534721ULL;
+
+  struct Header {
+    uint64_t magic;
+    uint64_t fnum;
+    uint64_t fid;
+    int64_t round;
+    uint64_t size;
+  };
+
+ public:
+  SuperstepCheckpointer(const grape::CommSpec& comm_spec,
+                        const std::string& tag)
+      : comm_spec_(comm_spec), interval_(10), snapshot_(false) {
+    const char* dir = getenv("GS_CHECKPOINT_DIR");
+    if (dir != nullptr && dir[0] != '\0') {
+      prefix_ = std::string(dir) + "/" + tag + "_frag_" +
+                std::to_string(comm_spec_.fid());
+    }
+    const char* interval = getenv("GS_CHECKPOINT_INTERVAL");
+    if (interval != nullptr) {
+      interval_ = std::max(atoi(interval), 1);
+    }
+  }
+
+  ~SuperstepCheckpointer() { wait(); }
+
+  /**
+   * @brief Restores the context, initialized by the query, and the messages
+   * of the round, which has started, from the latest checkpoint all the
+   * fragments have.
+   *
+   * @return The round restored, after which the query goes on, or -1 if
+   * there is none.
+   */
+  int Restore(CONTEXT_T& ctx, CheckpointMessageManager& messages) {
+    int64_t rounds[2] = {readRound(0), readRound(1)};
+    int64_t latest = std::max(rounds[0], rounds[1]), round;
+    MPI_Allreduce(&latest, &round, 1, MPI_INT64_T, MPI_MIN,
+                  comm_spec_.comm());
+    int local_found = round >= 0 && (rounds[0] == round || rounds[1] == round),
+        found;
+    MPI_Allreduce(&local_found, &found, 1, MPI_INT, MPI_MIN,
+                  comm_spec_.comm());
+    if (!found) {
+      return -1;
+    }
+
+    std::vector<char> buffer;
+    CHECK(read(rounds[0] == round ? 0 : 1, buffer));
+    grape::OutArchive arc;
+    arc.SetSlice(buffer.data(), buffer.size());
+    ctx.Restore(arc);
+    messages.RestoreOutgoing(arc);
+    // the round has not been the last one
+    messages.ForceContinue();
+    LOG(INFO) << "[frag-" << comm_spec_.fid()
+              << "]: Restored the checkpoint of round " << round;
+    return static_cast<int>(round);
+  }
+
+  /**
+   * @brief Archives the context and the messages of a round before they
+   * are exchanged, if a checkpoint is due.
+   */
+  void Snapshot(int round, const CONTEXT_T& ctx,
+                const CheckpointMessageManager& messages) {
+    if (prefix_.empty() || round == 0 || round % interval_ != 0) {
+      return;
+    }
+    wait();
+    pending_.Clear();
+    ctx.Checkpoint(pending_);
+    messages.ArchiveOutgoing(pending_);
+    round_ = round;
+    snapshot_ = true;
+  }
+
+  /**
+   * @brief Writes the checkpoint archived, once its round is known not to be
+   * the last one, while the next rounds run.
+   */
+  void Commit() {
+    if (!snapshot_) {
+      return;
+    }
+    snapshot_ = false;
+    writer_ = std::thread([this]() { write(); });
+  }
+
+  /**
+   * @brief Removes the checkpoints of the query, which has finished.
+   */
+  void Finish() {
+    wait();
+    if (prefix_.empty()) {
+      return;
+    }
+    for (int slot = 0; slot < 2; ++slot) {
+      std::remove(path(slot).c_str());
+    }
+  }
+
+ private:
+  std::string path(int slot) const {
+    return prefix_ + "." + std::to_string(slot) + ".ckpt";
+  }
+
+  void wait() {
+    if (writer_.joinable()) {
+      writer_.join();
+    }
+  }
+
+  bool readHeader(std::ifstream& is, Header& header) const {
+    return is.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+           header.magic == kMagic && header.fnum == comm_spec_.fnum() &&
+           header.fid == comm_spec_.fid();
+  }
+
+  int64_t readRound(int slot) const {
+    if (prefix_.empty()) {
+      return -1;
+    }
+    std::ifstream is(path(slot), std::ios::binary);
+    Header header;
+    return readHeader(is, header) ? header.round : -1;
+  }
+
+  bool read(int slot, std::vector<char>& buffer) const {
+    std::ifstream is(path(slot), std::ios::binary);
+    Header header;
+    if (!readHeader(is, header)) {
+      return false;
+    }
+    buffer.resize(header.size);
+    return static_cast<bool>(is.read(buffer.data(), header.size));
+  }
+
+  void write() {
+    int slot = (round_ / interval_) % 2;
+    std::string tmp_path = path(slot) + ".tmp";
+    Header header{kMagic, comm_spec_.fnum(), comm_spec_.fid(), round_,
+                  pending_.GetSize()};
+    {
+      std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+      os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      os.write(pending_.GetBuffer(), pending_.GetSize());
+      if (!os.flush()) {
+        LOG(ERROR) << "Failed to write the checkpoint " << tmp_path;
+        return;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path(slot).c_str()) != 0) {
+      LOG(ERROR) << "Failed to rename the checkpoint " << tmp_path;
+    }
+  }
+
+  const grape::CommSpec& comm_spec_;
+  std::string prefix_;
+  int interval_;
+
+  grape::InArchive pending_;
+  int64_t round_ = -1;
+  bool snapshot_;
+  std::thread writer_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_WORKER_SUPERSTEP_CHECKPOINTER_H_
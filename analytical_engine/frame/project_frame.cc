@@ -13,8 +13,12 @@
  * limitations under the License.
  */
 
+#include <cstdlib>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 
 #include "vineyard/basic/ds/arrow_utils.h"
 #include "vineyard/common/util/typename.h"
@@ -81,8 +85,12 @@ class ProjectSimpleFrame<gs::ArrowProjectedFragment<
     BOOST_LEAF_AUTO(e_prop_id, params.Get<int64_t>(rpc::E_PROP_ID));
     auto input_frag =
         std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
-    auto projected_frag = projected_fragment_t::Project(
-        input_frag, v_label_id, v_prop_id, e_label_id, e_prop_id);
+    auto projected_frag = projectCached(input_frag, v_label_id, v_prop_id,
+                                        e_label_id, e_prop_id);
+    if (projected_frag == nullptr) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Failed to project the fragment, see the log");
+    }
 
     rpc::graph::GraphDefPb graph_def;
     graph_def.set_key(projected_graph_name);
@@ -105,6 +113,41 @@ class ProjectSimpleFrame<gs::ArrowProjectedFragment<
   }
 
  private:
+  // An ArrowFragment is immutable, and so are its projections, which share
+  // its tables and topology and only build the offsets of the projected
+  // labels. The same selection of the same fragment gets the projection built
+  // before, as long as vineyard still has it, since each algorithm run on a
+  // property graph projects it again.
+  static std::shared_ptr<projected_fragment_t> projectCached(
+      std::shared_ptr<fragment_t>& input_frag, int64_t v_label_id,
+      int64_t v_prop_id, int64_t e_label_id, int64_t e_prop_id) {
+    using cache_key_t =
+        std::tuple<vineyard::ObjectID, int64_t, int64_t, int64_t, int64_t>;
+    static std::mutex mutex;
+    static std::map<cache_key_t, std::shared_ptr<projected_fragment_t>> cache;
+
+    cache_key_t key(input_frag->id(), v_label_id, v_prop_id, e_label_id,
+                    e_prop_id);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = cache.find(key);
+    if (iter != cache.end()) {
+      auto client =
+          dynamic_cast<vineyard::Client*>(input_frag->meta().GetClient());
+      bool exists = false;
+      if (client != nullptr &&
+          client->Exists(iter->second->id(), exists).ok() && exists) {
+        return iter->second;
+      }
+      cache.erase(iter);
+    }
+    auto projected_frag = projected_fragment_t::Project(
+        input_frag, v_label_id, v_prop_id, e_label_id, e_prop_id);
+    if (projected_frag != nullptr) {
+      cache.emplace(key, projected_frag);
+    }
+    return projected_frag;
+  }
+
   static void setGraphDef(
       std::shared_ptr<projected_fragment_t>& fragment,
       vineyard::property_graph_types::LABEL_ID_TYPE const& v_label,
@@ -182,6 +225,12 @@ class ProjectSimpleFrame<
         std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
     auto projected_frag =
         projected_fragment_t::Project(input_frag, v_prop_key, e_prop_key);
+    // The materialized CSR copies the edges of the inner vertices, hence
+    // opted in.
+    const char* materialize = getenv("GS_MATERIALIZE_FLATTENED_FRAGMENT");
+    if (materialize != nullptr && std::string(materialize) != "0") {
+      projected_frag->Materialize();
+    }
 
     rpc::graph::GraphDefPb graph_def;
 
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2021 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.alibaba.graphscope.parallel;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * Sends messages of primitive type in batches, packed into an off-heap buffer per channel, so that
+ * a batch crosses JNI once rather than once per message as through {@link ParallelMessageManager}.
+ *
+ * <p>A channel is used by one thread at a time, like the channels of the message manager. The
+ * messages buffered in a channel are sent when the buffer is full, when the next message is of
+ * another kind, or by {@link #flush(int)}; they must be flushed before the superstep ends.
+ */
+public class BatchedMessageSender {
+
+    private static final int SYNC_STATE_ON_OUTER_VERTEX = 0;
+    private static final int SEND_MSG_THROUGH_OEDGES = 1;
+    private static final int SEND_MSG_THROUGH_IEDGES = 2;
+    private static final int SEND_MSG_THROUGH_EDGES = 3;
+
+    private static final int LONG_MSG = 0;
+    private static final int DOUBLE_MSG = 1;
+    private static final int INT_MSG = 2;
+
+    /** A local id as a long followed by the message, as read by core/java/java_message_batch.h. */
+    private static final int ENTRY_SIZE = 16;
+
+    private static final int DEFAULT_BATCH_SIZE = 4096;
+
+    /** The native senders by the address of the message manager they send through. */
+    private static final ConcurrentHashMap<Long, Long> senders = new ConcurrentHashMap<>();
+
+    private final long sender;
+    private final ByteBuffer[] buffers;
+    private final int[] ops;
+    private final int[] msgTypes;
+    private final int[] counts;
+    private final int batchSize;
+
+    private BatchedMessageSender(long sender, int channelNum, int batchSize) {
+        this.sender = sender;
+        this.batchSize = batchSize;
+        this.buffers = new ByteBuffer[channelNum];
+        this.ops = new int[channelNum];
+        this.msgTypes = new int[channelNum];
+        this.counts = new int[channelNum];
+        for (int i = 0; i < channelNum; ++i) {
+            buffers[i] =
+                    ByteBuffer.allocateDirect(batchSize * ENTRY_SIZE)
+                            .order(ByteOrder.nativeOrder());
+        }
+    }
+
+    /** Called by the C++ app once it has created the native sender of a message manager. */
+    private static void bind(long messagesAddress, long senderAddress) {
+        senders.put(messagesAddress, senderAddress);
+    }
+
+    public static BatchedMessageSender create(
+            ParallelMessageManager messageManager, int channelNum) {
+        return create(messageManager, channelNum, DEFAULT_BATCH_SIZE);
+    }
+
+    public static BatchedMessageSender create(
+            ParallelMessageManager messageManager, int channelNum, int batchSize) {
+        Long sender = senders.get(messageManager.getAddress());
+        if (sender == null) {
+            throw new IllegalStateException(
+                    "No batched sender bound to the message manager, is the app a parallel app?");
+        }
+        return new BatchedMessageSender(sender, channelNum, batchSize);
+    }
+
+    public void syncStateOnOuterVertex(int channelId, long lid, long msg) {
+        putLong(SYNC_STATE_ON_OUTER_VERTEX, channelId, lid, msg);
+    }
+
+    public void syncStateOnOuterVertex(int channelId, long lid, double msg) {
+        putDouble(SYNC_STATE_ON_OUTER_VERTEX, channelId, lid, msg);
+    }
+
+    public void syncStateOnOuterVertex(int channelId, long lid, int msg) {
+        putInt(SYNC_STATE_ON_OUTER_VERTEX, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughOEdges(int channelId, long lid, long msg) {
+        putLong(SEND_MSG_THROUGH_OEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughOEdges(int channelId, long lid, double msg) {
+        putDouble(SEND_MSG_THROUGH_OEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughOEdges(int channelId, long lid, int msg) {
+        putInt(SEND_MSG_THROUGH_OEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughIEdges(int channelId, long lid, long msg) {
+        putLong(SEND_MSG_THROUGH_IEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughIEdges(int channelId, long lid, double msg) {
+        putDouble(SEND_MSG_THROUGH_IEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughIEdges(int channelId, long lid, int msg) {
+        putInt(SEND_MSG_THROUGH_IEDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughEdges(int channelId, long lid, long msg) {
+        putLong(SEND_MSG_THROUGH_EDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughEdges(int channelId, long lid, double msg) {
+        putDouble(SEND_MSG_THROUGH_EDGES, channelId, lid, msg);
+    }
+
+    public void sendMsgThroughEdges(int channelId, long lid, int msg) {
+        putInt(SEND_MSG_THROUGH_EDGES, channelId, lid, msg);
+    }
+
+    /** Sends the messages buffered in a channel. */
+    public void flush(int channelId) {
+        if (counts[channelId] > 0) {
+            nativeSend(
+                    sender,
+                    ops[channelId],
+                    msgTypes[channelId],
+                    channelId,
+                    buffers[channelId],
+                    counts[channelId]);
+            counts[channelId] = 0;
+            buffers[channelId].clear();
+        }
+    }
+
+    /** Sends the messages buffered in all channels, by the thread ending the superstep. */
+    public void flushAll() {
+        for (int i = 0; i < counts.length; ++i) {
+            flush(i);
+        }
+    }
+
+    private ByteBuffer prepare(int op, int msgType, int channelId, long lid) {
+        if (counts[channelId] > 0 && (ops[channelId] != op || msgTypes[channelId] != msgType)) {
+            flush(channelId);
+        }
+        ops[channelId] = op;
+        msgTypes[channelId] = msgType;
+        ByteBuffer buffer = buffers[channelId];
+        int offset = counts[channelId] * ENTRY_SIZE;
+        buffer.putLong(offset, lid);
+        return buffer;
+    }
+
+    private void commit(int channelId) {
+        if (++counts[channelId] == batchSize) {
+            flush(channelId);
+        }
+    }
+
+    private void putLong(int op, int channelId, long lid, long msg) {
+        ByteBuffer buffer = prepare(op, LONG_MSG, channelId, lid);
+        buffer.putLong(counts[channelId] * ENTRY_SIZE + 8, msg);
+        commit(channelId);
+    }
+
+    private void putDouble(int op, int channelId, long lid, double msg) {
+        ByteBuffer buffer = prepare(op, DOUBLE_MSG, channelId, lid);
+        buffer.putDouble(counts[channelId] * ENTRY_SIZE + 8, msg);
+        commit(channelId);
+    }
+
+    private void putInt(int op, int channelId, long lid, int msg) {
+        ByteBuffer buffer = prepare(op, INT_MSG, channelId, lid);
+        buffer.putInt(counts[channelId] * ENTRY_SIZE + 8, msg);
+        commit(channelId);
+    }
+
+    private static native void nativeSend(
+            long sender, int op, int msgType, int channelId, ByteBuffer buffer, int num);
+}
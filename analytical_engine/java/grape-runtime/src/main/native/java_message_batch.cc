@@ -0,0 +1,40 @@
+/** Copyright 2022 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifdef ENABLE_JAVA_SDK
+
+#include <jni.h>
+#include "core/java/java_message_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sends the entries of a batch in the direct buffer of a
+// com.alibaba.graphscope.parallel.BatchedMessageSender, by the sender the app
+// has bound to its message manager.
+JNIEXPORT
+void JNICALL
+Java_com_alibaba_graphscope_parallel_BatchedMessageSender_nativeSend(
+    JNIEnv* env, jclass, jlong sender, jint op, jint msg_type, jint channel_id,
+    jobject buffer, jint num) {
+  auto* entries = static_cast<const char*>(env->GetDirectBufferAddress(buffer));
+  reinterpret_cast<gs::JavaMessageBatchSenderBase*>(sender)->Send(
+      op, msg_type, channel_id, entries, static_cast<size_t>(num));
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
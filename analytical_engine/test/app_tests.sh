@@ -431,6 +431,9 @@ run_vy ${np} ./run_pregel_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e
 rm -rf ./test_output/*
 cp ./outputs_pregel_sssp/* ./test_output
 exact_verify "${test_dir}"/twitter-sssp-4
+rm -rf ./test_output/*
+cp ./outputs_pregel_sssp_with_combinator/* ./test_output
+exact_verify "${test_dir}"/twitter-sssp-4
 
 run ${np} ./run_pregel_app tc "${test_dir}"/p2p-31.e "${test_dir}"/p2p-31.v ./test_output
 exact_verify "${test_dir}/p2p-31"-triangles
@@ -80,6 +80,11 @@ void Run(vineyard::Client& client, const grape::CommSpec& comm_spec,
                gs::PregelPropertyAppBase<FragmentType, gs::PregelPagerank>>(
       fragment, comm_spec, "{\"delta\": 4, \"max_round\": 10}",
       "./outputs_pregel_pr");
+  RunPregelApp<FragmentType,
+               gs::PregelPropertyAppBase<FragmentType, gs::PregelSSSP,
+                                         gs::PregelSSSPCombinator>>(
+      fragment, comm_spec, "{\"src\": 4}",
+      "./outputs_pregel_sssp_with_combinator");
   RunPregelApp<FragmentType,
                gs::PregelPropertyAppBase<FragmentType, gs::PregelSSSP>>(
       fragment, comm_spec, "{\"src\": 4}", "./outputs_pregel_sssp");
@@ -591,6 +591,8 @@ def compile_app(
             logger.info(
                 "Skip running llvm4jni since env var LLVM4JNI_HOME not found or run.sh not found under LLVM4JNI_HOME"
             )
+    elif app_type == "cpp_pie" and app_header.startswith("apps/cuda/"):
+        cmake_commands += ["-DCUDA_APP=ON"]
     elif app_type == "cpp_flash":
         cmake_commands += ["-DFLASH_APP=ON"]
     elif app_type not in ("cpp_pie", "cpp_pregel"):  # Cython
@@ -22,22 +22,32 @@
 #include <boost/program_options.hpp>
 
 #include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/wal/wal.h"
 #include "flex/engines/http_server/options.h"
 
 #ifdef BUILD_WITH_OSS
 #include <boost/process.hpp>
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
 #include "flex/utils/remote/oss_storage.h"
 #endif
 
 namespace bpo = boost::program_options;
 
 static std::string work_dir;
+// When appending, the directory holds the graph appended to, which is kept
+// as it was since its snapshot version is only bumped at the end.
+static bool append_to_graph = false;
 
 void signal_handler(int signal) {
   LOG(INFO) << "Received signal " << signal << ", exiting...";
   // support SIGKILL, SIGINT, SIGTERM
   if (signal == SIGKILL || signal == SIGINT || signal == SIGTERM ||
       signal == SIGSEGV || signal == SIGABRT) {
+    if (append_to_graph) {
+      LOG(ERROR) << "Received signal " << signal
+                 << ", the graph in " << work_dir << " is left unchanged";
+      exit(signal);
+    }
     LOG(ERROR) << "Received signal " << signal
                << ",Clearing directory: " << work_dir << ", exiting...";
     // remove all files in work_dir
@@ -142,7 +152,10 @@ int main(int argc, char** argv) {
       "graph-config,g", bpo::value<std::string>(), "graph schema config file")(
       "bulk-load,l", bpo::value<std::string>(), "bulk-load config file")(
       "build-csr-in-mem,m", bpo::value<bool>(), "build csr in memory")(
-      "use-mmap-vector", bpo::value<bool>(), "use mmap vector");
+      "use-mmap-vector", bpo::value<bool>(), "use mmap vector")(
+      "stream-upload", bpo::value<bool>(),
+      "upload the files of an oss data path as they are written, instead of "
+      "as a zip file after loading");
 
   google::InitGoogleLogging(argv[0]);
   FLAGS_logtostderr = true;
@@ -167,9 +180,15 @@ int main(int argc, char** argv) {
    * loading to a temporary directory. To improve the performance of the
    * performance, bulk_loader will zip the data directory before uploading.
    * The data path should be in the format of oss://bucket_name/object_path
+   *
+   * With `stream-upload`, the files are put under object_path one by one
+   * while the graph is being loaded instead, and can be downloaded from there
+   * by the interactive server without unzipping.
    */
 #ifdef BUILD_WITH_OSS
   bool upload_to_oss = false;
+  bool stream_upload = vm.count("stream-upload") &&
+                       vm["stream-upload"].as<bool>();
   std::string object_path = "";
   auto oss_conf = gs::OSSConf();
 #endif
@@ -224,6 +243,13 @@ int main(int argc, char** argv) {
         vm["use-mmap-vector"].as<bool>());
   }
 
+  append_to_graph =
+      loading_config_res.value().GetMethod() == gs::BulkLoadMethod::kAppend;
+  if (append_to_graph && data_path.find("oss://") == 0) {
+    LOG(ERROR) << "Appending to a graph on oss is not supported";
+    return -1;
+  }
+
   if (data_path.find("oss://") == 0) {
 #ifdef BUILD_WITH_OSS
     upload_to_oss = true;
@@ -235,14 +261,36 @@ int main(int argc, char** argv) {
   }
 
   std::filesystem::path data_dir_path(data_path);
-  if (!std::filesystem::exists(data_dir_path)) {
-    std::filesystem::create_directory(data_dir_path);
-  }
   std::filesystem::path serial_path = data_dir_path / "schema";
-  if (std::filesystem::exists(serial_path)) {
-    LOG(WARNING) << "data directory is not empty: " << data_dir_path.string()
-                 << ", please remove the directory and try again.";
-    return -1;
+  if (append_to_graph) {
+    if (!std::filesystem::exists(serial_path)) {
+      LOG(ERROR) << "No graph to append to in " << data_dir_path.string();
+      return -1;
+    }
+    // The WALs are replayed on top of the snapshot when the graph is opened,
+    // and would then be applied after the appended data instead of before.
+    gs::WalParserFactory::Init();
+    auto wal_parser =
+        gs::WalParserFactory::CreateWalParser(gs::wal_dir(data_path));
+    bool has_wals =
+        wal_parser->last_ts() != 0 || !wal_parser->get_update_wals().empty();
+    wal_parser->close();
+    gs::WalParserFactory::Finalize();
+    if (has_wals) {
+      LOG(ERROR) << "The graph in " << data_dir_path.string()
+                 << " has write-ahead logs, it can only be appended to "
+                    "right after a bulk load";
+      return -1;
+    }
+  } else {
+    if (!std::filesystem::exists(data_dir_path)) {
+      std::filesystem::create_directory(data_dir_path);
+    }
+    if (std::filesystem::exists(serial_path)) {
+      LOG(WARNING) << "data directory is not empty: " << data_dir_path.string()
+                   << ", please remove the directory and try again.";
+      return -1;
+    }
   }
 
   {
@@ -268,9 +316,27 @@ int main(int argc, char** argv) {
   auto loader = gs::LoaderFactory::CreateFragmentLoader(
       data_dir_path.string(), schema_res.value(), loading_config_res.value());
 
+#ifdef BUILD_WITH_OSS
+  std::shared_ptr<gs::SnapshotUploader> snapshot_uploader;
+  if (upload_to_oss && stream_upload) {
+    auto oss_writer = std::make_shared<gs::OSSRemoteStorageUploader>(oss_conf);
+    if (!oss_writer->Open().ok()) {
+      LOG(ERROR) << "Failed to open oss writer";
+      return -1;
+    }
+    snapshot_uploader = std::make_shared<gs::SnapshotUploader>(
+        oss_writer, data_dir_path.string(), object_path,
+        oss_conf.concurrency_);
+    snapshot_uploader->Enqueue((data_dir_path / "graph.yaml").string());
+    loader->SetSnapshotUploader(snapshot_uploader);
+  }
+#endif
+
   auto result = loader->LoadFragment();
   if (!result.ok()) {
-    std::filesystem::remove_all(data_dir_path);
+    if (!append_to_graph) {
+      std::filesystem::remove_all(data_dir_path);
+    }
     LOG(ERROR) << "Failed to load fragment: "
                << result.status().error_message();
     return -1;
@@ -279,6 +345,13 @@ int main(int argc, char** argv) {
   LOG(INFO) << "Finished bulk loading in " << t << " seconds.";
 
 #ifdef BUILD_WITH_OSS
+  if (snapshot_uploader) {
+    LOG(INFO) << "Successfully uploaded data to oss: " << object_path;
+    loader.reset();
+    snapshot_uploader.reset();
+    std::filesystem::remove_all(data_dir_path);
+    return 0;
+  }
   if (upload_to_oss) {
     return upload_data_dir_to_oss(data_dir_path, object_path, oss_conf);
   }
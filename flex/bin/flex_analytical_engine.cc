@@ -17,18 +17,36 @@
 #include <gflags/gflags_declare.h>
 #include <glog/logging.h>
 
+#include <sstream>
+#include <type_traits>
+
 #include "flex/engines/bsp/apps.h"
 #include "flex/engines/bsp/bsp.h"
+#include "flex/engines/bsp/flex_fragment_loader.h"
+#include "flex/engines/bsp/result_writer.h"
 #include "flex/storages/immutable_graph/immutable_graph.h"
+#include "flex/storages/rt_mutable_graph/file_names.h"
 
 #include "grape/fragment/basic_fragment_loader.h"
 #include "grape/fragment/loader.h"
+#include "grape/io/local_io_adaptor.h"
 
 DEFINE_string(application, "", "application name");
 DEFINE_string(efile, "", "edge file");
 DEFINE_string(vfile, "", "vertex file");
 DEFINE_string(output_prefix, "", "output directory of results");
 
+DEFINE_string(data_path, "",
+              "data directory of a flex graph to run on, in place of files");
+DEFINE_string(vertex_label, "", "vertex label of the flex graph to run on");
+DEFINE_string(edge_label, "", "edge label between the vertices to run on");
+DEFINE_bool(directed, true, "whether the edges of the flex graph are directed");
+DEFINE_string(result_column, "",
+              "vertex property of the flex graph to write the results to");
+DEFINE_bool(replay_wal, false,
+            "run on a read transaction of the flex graph with its wal "
+            "replayed, rather than on its latest snapshot");
+
 DEFINE_int64(bfs_source, 0, "source vertex of bfs.");
 DEFINE_int32(cdlp_mr, 10, "max rounds of cdlp.");
 DEFINE_int64(sssp_source, 0, "source vertex of sssp.");
@@ -49,85 +67,171 @@ using NonWeightedGraph = immutable_graph::ImmutableGraph<
 #define __AFFINITY__ false
 #endif
 
+// Writes the results to the files under out_prefix, and with a result
+// column, to the property of the vertices of the flex graph too.
 template <typename FRAG_T, typename APP_T, typename... Args>
 void DoQuery(std::shared_ptr<FRAG_T> fragment, std::shared_ptr<APP_T> app,
-             const grape::CommSpec& comm_spec, const std::string& out_prefix,
-             Args... args) {
+             const grape::CommSpec& comm_spec, const gs::Schema& schema,
+             const std::string& out_prefix, Args... args) {
   auto spec = grape::MultiProcessSpec(comm_spec, __AFFINITY__);
   auto worker = APP_T::CreateWorker(app, fragment);
   worker->Init(comm_spec, spec);
   worker->Query(std::forward<Args>(args)...);
 
-  std::ofstream ostream;
-  std::string output_path =
-      grape::GetResultFilename(out_prefix, fragment->fid());
-  ostream.open(output_path);
-  worker->Output(ostream);
-  ostream.close();
+  if (FLAGS_result_column.empty() || !out_prefix.empty()) {
+    std::ofstream ostream;
+    std::string output_path =
+        grape::GetResultFilename(out_prefix, fragment->fid());
+    ostream.open(output_path);
+    worker->Output(ostream);
+    ostream.close();
+    VLOG(1) << "Worker-" << comm_spec.worker_id()
+            << " finished: " << output_path;
+  }
+  if (!FLAGS_result_column.empty()) {
+    std::ostringstream ostream;
+    worker->Output(ostream);
+    auto output = bsp::GatherOutput(comm_spec, ostream.str());
+    if (comm_spec.worker_id() == 0) {
+      bool ok = FLAGS_replay_wal
+                    ? bsp::WriteResultColumn(gs::GraphDB::get(),
+                                             FLAGS_vertex_label,
+                                             FLAGS_result_column, output)
+                    : bsp::WriteResultColumn(schema, FLAGS_data_path,
+                                             FLAGS_vertex_label,
+                                             FLAGS_result_column, output);
+      if (!ok) {
+        LOG(FATAL) << "Failed to write the results to "
+                   << FLAGS_result_column;
+      }
+    }
+  }
   worker->Finalize();
-  VLOG(1) << "Worker-" << comm_spec.worker_id() << " finished: " << output_path;
 }
 
-int main(int argc, char** argv) {
-  FLAGS_stderrthreshold = 0;
-  grape::gflags::SetUsageMessage(
-      "Usage: mpiexec [mpi_opts] ./analytical_engine [application _options]");
-  if (argc == 1) {
-    grape::gflags::ShowUsageWithFlagsRestrict(argv[0], "analytical_engine");
-    exit(1);
-  }
-  grape::gflags::ParseCommandLineFlags(&argc, &argv, true);
-  grape::gflags::ShutDownCommandLineFlags();
-
-  google::InitGoogleLogging("analytical_engine");
-  google::InstallFailureSignalHandler();
-
-  bsp::Init();
-  grape::CommSpec comm_spec;
-  comm_spec.Init(MPI_COMM_WORLD);
-
-  std::string name = FLAGS_application;
-  grape::LoadGraphSpec graph_spec = grape::DefaultLoadGraphSpec();
-  auto out_prefix = FLAGS_output_prefix;
+// Runs the app of name on the fragments returned by load, which is called
+// with a null pointer of the type of fragment the app runs on.
+template <typename LOAD_T>
+void Run(const std::string& name, const LOAD_T& load,
+         const grape::CommSpec& comm_spec, const gs::Schema& schema,
+         const std::string& out_prefix) {
   if (name == "sssp") {
-    auto fragment = grape::LoadGraph<WeightedGraph>(FLAGS_efile, FLAGS_vfile,
-                                                    comm_spec, graph_spec);
+    auto fragment = load(static_cast<WeightedGraph*>(nullptr));
     using AppType = bsp::SSSPApp<WeightedGraph>;
     auto app = std::make_shared<AppType>();
 
-    DoQuery(fragment, app, comm_spec, out_prefix, FLAGS_sssp_source);
+    DoQuery(fragment, app, comm_spec, schema, out_prefix, FLAGS_sssp_source);
   } else {
-    auto fragment = grape::LoadGraph<NonWeightedGraph>(FLAGS_efile, FLAGS_vfile,
-                                                       comm_spec, graph_spec);
+    auto fragment = load(static_cast<NonWeightedGraph*>(nullptr));
     if (name == "bfs") {
       using AppType = bsp::BFSApp<NonWeightedGraph>;
       auto app = std::make_shared<AppType>();
 
-      DoQuery(fragment, app, comm_spec, out_prefix, FLAGS_bfs_source);
+      DoQuery(fragment, app, comm_spec, schema, out_prefix, FLAGS_bfs_source);
     } else if (name == "lcc") {
       using AppType = bsp::LCCApp<NonWeightedGraph>;
       auto app = std::make_shared<AppType>();
 
-      DoQuery(fragment, app, comm_spec, out_prefix);
+      DoQuery(fragment, app, comm_spec, schema, out_prefix);
     } else if (name == "cdlp") {
       using AppType = bsp::CDLPApp<NonWeightedGraph>;
       auto app = std::make_shared<AppType>();
 
-      DoQuery(fragment, app, comm_spec, out_prefix, FLAGS_cdlp_mr);
+      DoQuery(fragment, app, comm_spec, schema, out_prefix, FLAGS_cdlp_mr);
     } else if (name == "pagerank") {
       using AppType = bsp::PRApp<NonWeightedGraph>;
       auto app = std::make_shared<AppType>();
 
-      DoQuery(fragment, app, comm_spec, out_prefix, FLAGS_pr_d, FLAGS_pr_mr);
+      DoQuery(fragment, app, comm_spec, schema, out_prefix, FLAGS_pr_d,
+              FLAGS_pr_mr);
     } else if (name == "wcc") {
       using AppType = bsp::WCCApp<NonWeightedGraph>;
       auto app = std::make_shared<AppType>();
 
-      DoQuery(fragment, app, comm_spec, out_prefix);
+      DoQuery(fragment, app, comm_spec, schema, out_prefix);
     } else {
       LOG(FATAL) << "Invalid app: " << name;
     }
   }
+}
+
+int main(int argc, char** argv) {
+  FLAGS_stderrthreshold = 0;
+  grape::gflags::SetUsageMessage(
+      "Usage: mpiexec [mpi_opts] ./analytical_engine [application _options]");
+  if (argc == 1) {
+    grape::gflags::ShowUsageWithFlagsRestrict(argv[0], "analytical_engine");
+    exit(1);
+  }
+  grape::gflags::ParseCommandLineFlags(&argc, &argv, true);
+  grape::gflags::ShutDownCommandLineFlags();
+
+  google::InitGoogleLogging("analytical_engine");
+  google::InstallFailureSignalHandler();
+
+  bsp::Init();
+  grape::CommSpec comm_spec;
+  comm_spec.Init(MPI_COMM_WORLD);
+
+  std::string name = FLAGS_application;
+  grape::LoadGraphSpec graph_spec = grape::DefaultLoadGraphSpec();
+  auto out_prefix = FLAGS_output_prefix;
+  if (FLAGS_data_path.empty()) {
+    if (!FLAGS_result_column.empty()) {
+      LOG(FATAL) << "result_column is only supported with data_path";
+    }
+    auto load = [&](auto* tag) {
+      using FRAG_T = std::remove_pointer_t<decltype(tag)>;
+      return grape::LoadGraph<FRAG_T>(FLAGS_efile, FLAGS_vfile, comm_spec,
+                                      graph_spec);
+    };
+    Run(name, load, comm_spec, gs::Schema(), out_prefix);
+  } else if (FLAGS_replay_wal) {
+    // Worker 0 opens the graph, replaying its wal, and keeps it open to
+    // write the results to.
+    gs::Schema schema;
+    if (comm_spec.worker_id() == 0) {
+      auto io_adaptor = std::unique_ptr<grape::LocalIOAdaptor>(
+          new grape::LocalIOAdaptor(gs::schema_path(FLAGS_data_path)));
+      io_adaptor->Open();
+      schema.Deserialize(io_adaptor);
+      auto res = gs::GraphDB::get().Open(schema, FLAGS_data_path, 1);
+      if (!res.ok()) {
+        LOG(FATAL) << "Failed to open graph at " << FLAGS_data_path << ": "
+                   << res.status().error_message();
+      }
+    }
+    auto load = [&](auto* tag) {
+      using FRAG_T = std::remove_pointer_t<decltype(tag)>;
+      if (comm_spec.worker_id() != 0) {
+        return bsp::LoadFlexFragment<FRAG_T>(comm_spec, nullptr,
+                                             FLAGS_vertex_label,
+                                             FLAGS_edge_label, FLAGS_directed);
+      }
+      auto txn = gs::GraphDB::get().GetSession(0).GetReadTransaction();
+      return bsp::LoadFlexFragment<FRAG_T>(comm_spec, &txn, FLAGS_vertex_label,
+                                           FLAGS_edge_label, FLAGS_directed);
+    };
+    Run(name, load, comm_spec, schema, out_prefix);
+    if (comm_spec.worker_id() == 0) {
+      gs::GraphDB::get().Close();
+    }
+  } else {
+    // Every worker maps the snapshot, which is only read while the fragments
+    // are built.
+    auto graph = std::make_unique<gs::MutablePropertyFragment>();
+    graph->Open(FLAGS_data_path, 0);
+    gs::Schema schema = graph->schema();
+    auto load = [&](auto* tag) {
+      using FRAG_T = std::remove_pointer_t<decltype(tag)>;
+      auto fragment = bsp::LoadFlexFragment<FRAG_T>(
+          comm_spec, *graph, FLAGS_vertex_label, FLAGS_edge_label,
+          FLAGS_directed);
+      graph.reset();
+      return fragment;
+    };
+    Run(name, load, comm_spec, schema, out_prefix);
+  }
 
   bsp::Finalize();
   google::ShutdownGoogleLogging();
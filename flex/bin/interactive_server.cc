@@ -15,8 +15,12 @@
 
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 #include "stdlib.h"
 
+#include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/http_server/codegen_proxy.h"
 #include "flex/engines/http_server/graph_db_service.h"
 #include "flex/engines/http_server/workdir_manipulator.h"
@@ -24,10 +28,12 @@
 #include "flex/storages/rt_mutable_graph/loading_config.h"
 #include "flex/utils/service_utils.h"
 #ifdef BUILD_WITH_OSS
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
 #include "flex/utils/remote/oss_storage.h"
 #endif
 
 #include <yaml-cpp/yaml.h>
+#include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 
 #include <glog/logging.h>
@@ -106,6 +112,88 @@ void config_log_level(int log_level, int verbose_level) {
     }
   }
 }
+// Sets a query limit of a hosted graph from an option name=value of its
+// spec, named as in compute_engine of the engine config.
+void set_hosted_graph_limit(const std::string& spec, const std::string& option,
+                            gs::GraphDBConfig& config) {
+  auto eq = option.find('=');
+  std::string name = option.substr(0, eq);
+  std::string value = eq == std::string::npos ? "" : option.substr(eq + 1);
+  try {
+    size_t parsed = 0;
+    if (name == "query_timeout") {
+      config.query_timeout_ms = std::stoll(value, &parsed);
+      if (config.query_timeout_ms < 0) {
+        parsed = 0;
+      }
+    } else if (name == "query_memory_budget") {
+      config.query_memory_budget = std::stoull(value, &parsed);
+    } else if (name == "result_cache_capacity") {
+      config.result_cache_capacity = std::stoull(value, &parsed);
+    }
+    if (parsed != 0 && parsed == value.size()) {
+      return;
+    }
+  } catch (const std::exception&) {}
+  LOG(FATAL) << "Invalid option " << option << " of hosted graph, expected "
+             << "query_timeout, query_memory_budget or "
+                "result_cache_capacity=<number>: "
+             << spec;
+}
+
+// Opens and hosts the graphs of --hosted-graph, each given as
+// graph_id:schema_yaml:data_path[:name=value]..., beside the running one,
+// see GraphDB::Host. They are served by the same shards, each with its own
+// sessions. The options set the query limits of the graph, which otherwise
+// has those of the service.
+void host_graphs(const bpo::variables_map& vm,
+                 const server::ServiceConfig& service_config) {
+  if (!vm.count("hosted-graph")) {
+    return;
+  }
+  for (auto& spec : vm["hosted-graph"].as<std::vector<std::string>>()) {
+    std::vector<std::string> fields;
+    boost::split(fields, spec, boost::is_any_of(":"));
+    if (fields.size() < 3) {
+      LOG(FATAL) << "Invalid hosted graph, expected "
+                    "graph_id:schema_yaml:data_path[:name=value]...: "
+                 << spec;
+    }
+    const std::string& graph_id = fields[0];
+    const std::string& schema_path = fields[1];
+    const std::string& data_path = fields[2];
+    auto schema_res = gs::Schema::LoadFromYaml(schema_path);
+    if (!schema_res.ok()) {
+      LOG(FATAL) << "Fail to load graph schema from yaml file: "
+                 << schema_path;
+    }
+    gs::GraphDBConfig config(schema_res.value(), data_path, "",
+                             service_config.shard_num);
+    config.intra_query_thread_num = service_config.intra_query_thread_num;
+    config.query_timeout_ms = service_config.query_timeout_ms;
+    config.query_memory_budget = service_config.query_memory_budget;
+    config.result_cache_capacity = service_config.result_cache_capacity;
+    for (size_t i = 3; i < fields.size(); ++i) {
+      set_hosted_graph_limit(spec, fields[i], config);
+    }
+    config.standby = true;
+    auto db = std::make_unique<gs::GraphDB>();
+    auto load_res = db->Open(config);
+    if (!load_res.ok()) {
+      LOG(FATAL) << "Failed to load graph " << graph_id
+                 << " from data directory: "
+                 << load_res.status().error_message();
+    }
+    auto host_res = gs::GraphDB::Host(graph_id, std::move(db));
+    if (!host_res.ok()) {
+      LOG(FATAL) << host_res.error_message();
+    }
+    LOG(INFO) << "Host graph " << graph_id << " from " << data_path
+              << ", query timeout " << config.query_timeout_ms
+              << " ms, memory budget " << config.query_memory_budget
+              << ", result cache " << config.result_cache_capacity;
+  }
+}
 
 #ifdef BUILD_WITH_OSS
 
@@ -145,6 +233,23 @@ std::string download_data_from_oss(const std::string& graph_name,
     data_path_no_bucket =
         data_path_no_bucket.substr(conf.bucket_name_.size() + 1);
   }
+  // Graphs uploaded by `bulk_loader --stream-upload` are a directory of files
+  // instead of a zip file.
+  std::vector<std::string> version_files;
+  if (downloader
+          .List(data_path_no_bucket + "/snapshots/VERSION", version_files)
+          .ok() &&
+      !version_files.empty()) {
+    LOG(INFO) << "Download snapshot from oss: " << data_path_no_bucket
+              << " to " << local_data_dir;
+    auto res = gs::download_snapshot(downloader, data_path_no_bucket,
+                                     local_data_dir, conf.concurrency_);
+    if (!res.ok()) {
+      LOG(FATAL) << "Fail to download snapshot from oss: "
+                 << res.error_message();
+    }
+    return local_data_dir;
+  }
   LOG(INFO) << "Download data from oss: " << data_path_no_bucket << " to "
             << data_dir_zip_path;
 
@@ -203,7 +308,13 @@ int main(int argc, char** argv) {
       "memory-level,m", bpo::value<unsigned>()->default_value(1),
       "memory allocation strategy")("enable-adhoc-handler",
                                     bpo::value<bool>()->default_value(false),
-                                    "whether to enable adhoc handler");
+                                    "whether to enable adhoc handler")(
+      "hosted-graph", bpo::value<std::vector<std::string>>()->composing(),
+      "graph_id:schema_yaml:data_path[:name=value]... of a graph to serve "
+      "beside the running one, may be repeated. Only stored procedure "
+      "queries, POST /v1/graph/{graph_id}/query, are served on it. The "
+      "options query_timeout, query_memory_budget and result_cache_capacity "
+      "set its limits instead of those of compute_engine");
 
   setenv("TZ", "Asia/Shanghai", 1);
   tzset();
@@ -313,6 +424,30 @@ int main(int argc, char** argv) {
     gs::GraphDBConfig config(schema_res.value(), data_path, "",
                              service_config.shard_num);
     config.wal_uri = service_config.wal_uri;
+    config.shared_snapshot_dir = service_config.shared_snapshot_dir;
+    config.warmup = service_config.warmup;
+    config.warmup_targets = service_config.warmup_targets;
+    config.warmup_memory_budget = service_config.warmup_memory_budget;
+    config.warmup_in_background = true;
+    config.replication_port = service_config.replication_port;
+    config.replication_backlog_size = service_config.replication_backlog_size;
+    config.replication_primary = service_config.replication_primary;
+    config.compaction_policy = service_config.compaction_policy;
+    config.snapshot_interval = service_config.snapshot_interval;
+    config.intra_query_thread_num = service_config.intra_query_thread_num;
+    config.profile_sample_rate = service_config.profile_sample_rate;
+    config.query_timeout_ms = service_config.query_timeout_ms;
+    config.query_memory_budget = service_config.query_memory_budget;
+    config.result_cache_capacity = service_config.result_cache_capacity;
+    config.cypher_write_group_size = service_config.cypher_write_group_size;
+    config.incremental_pagerank_vertex_label =
+        service_config.incremental_pagerank_vertex_label;
+    config.incremental_pagerank_edge_label =
+        service_config.incremental_pagerank_edge_label;
+    config.incremental_pagerank_damping_factor =
+        service_config.incremental_pagerank_damping_factor;
+    config.incremental_pagerank_epsilon =
+        service_config.incremental_pagerank_epsilon;
     auto load_res = db.Open(config);
     if (!load_res.ok()) {
       LOG(FATAL) << "Failed to load graph from data directory: "
@@ -320,6 +455,8 @@ int main(int argc, char** argv) {
     }
   }
 
+  gs::host_graphs(vm, service_config);
+
   server::GraphDBService::get().init(service_config);
   server::GraphDBService::get().run_and_wait_for_exit();
 
@@ -20,21 +20,46 @@
 #include <fstream>
 #include <hiactor/core/actor-app.hh>
 #include <iostream>
+#include <map>
+#include <random>
+#include <thread>
 #include <vector>
 #include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/http_server/executor_group.actg.h"
 #include "flex/engines/http_server/generated/actor/executor_ref.act.autogen.h"
 #include "flex/engines/http_server/graph_db_service.h"
+#include "flex/third_party/httplib.h"
+#include "flex/utils/service_utils.h"
 
 namespace bpo = boost::program_options;
 using namespace std::chrono_literals;
+
+// Replays the requests of one or more files, in process through the
+// executors of the actor system or against a running interactive_server over
+// HTTP, by a number of clients per shard or in total.
+//
+// By default each client issues its next request as soon as the previous one
+// returns. With a target QPS the requests are issued at Poisson arrival times
+// instead, and the latency of a request is counted from the time it should
+// have been issued, so that a stall of the server is not hidden by the
+// clients waiting on it, i.e. the latencies are corrected for coordinated
+// omission.
+//
+// With update files the requests are scheduled as an SNB Interactive mix is
+// by the LDBC driver: each update at its date in the update streams, scaled
+// by the time compression ratio, and the reads of each query type
+// interleaved with them, one every `frequency` updates. The report then also
+// tells the share of requests issued on time, i.e. within a second of their
+// schedule, which the LDBC audit rules require of 95% of them.
 class Req {
+  using clock_type = std::chrono::steady_clock;
+
  public:
   static Req& get() {
     static Req r;
     return r;
   }
-  void init(int warmup_num, int benchmark_num) {
+  void init(int warmup_num, int benchmark_num, double qps, uint32_t seed) {
     warmup_num_ = warmup_num;
     num_of_reqs_ = warmup_num + benchmark_num;
 
@@ -43,110 +68,386 @@ class Req {
     }
     std::cout << "warmup count: " << warmup_num_
               << "; benchmark count: " << num_of_reqs_ << "\n";
+
+    qps_ = qps;
+    if (qps_ > 0) {
+      std::mt19937_64 rng(seed);
+      std::exponential_distribution<double> interval(qps_);
+      double t = 0;
+      arrivals_.clear();
+      arrivals_.reserve(num_of_reqs_);
+      for (size_t i = 0; i < num_of_reqs_; ++i) {
+        arrivals_.emplace_back(to_duration(t));
+        t += interval(rng);
+      }
+      std::cout << "open loop at " << qps_ << " qps\n";
+    }
   }
-  void load(const std::string& file) {
-    std::cout << "load queries from " << file << "\n";
-    std::ifstream fi(file, std::ios::binary);
-    const size_t size = 4096;
-    std::vector<char> buffer(size);
-    std::vector<char> tmp(size);
-    size_t index = 0;
-    while (fi.read(buffer.data(), size)) {
-      std::streamsize len = fi.gcount();
-      for (std::streamsize i = 0; i < len; ++i) {
-        if (index >= 4 && tmp[index - 1] == '#') {
-          if (tmp[index - 4] == 'e' && tmp[index - 3] == 'o' &&
-              tmp[index - 2] == 'r') {
-            reqs_.emplace_back(
-                std::string(tmp.begin(), tmp.begin() + index - 4));
 
-            index = 0;
-          }
+  // Requests of several files are interleaved one by one, e.g. to mix a
+  // file of reads with a file of updates.
+  void load(const std::vector<std::string>& files) {
+    std::vector<std::vector<std::string>> per_file;
+    size_t max_num = 0;
+    for (auto& file : files) {
+      per_file.emplace_back(load_file(file));
+      max_num = std::max(max_num, per_file.back().size());
+    }
+    for (size_t i = 0; i < max_num; ++i) {
+      for (auto& reqs : per_file) {
+        if (i < reqs.size()) {
+          reqs_.emplace_back(std::move(reqs[i]));
         }
-        tmp[index++] = buffer[i];
       }
-      buffer.clear();
     }
-    fi.close();
     std::cout << "load " << reqs_.size() << " queries\n";
-    num_of_reqs_ = reqs_.size();
-    // reqs_.resize(100000);
-    start_.resize(reqs_.size());
-    end_.resize(reqs_.size());
+    resize_timings();
+  }
+
+  // Loads the reads and the updates of an SNB Interactive mix and schedules
+  // them. The dates of the updates, in milliseconds, are one per line of the
+  // schedule file, in the order of the updates in their files. The reads of
+  // a type without a frequency are spread evenly over the updates, and reads
+  // scheduled past the last update are dropped, so that the mix follows the
+  // frequencies.
+  bool load_snb(const std::vector<std::string>& read_files,
+                const std::vector<std::string>& update_files,
+                const std::string& schedule_file, double tcr,
+                const std::map<std::string, double>& frequencies) {
+    std::vector<std::string> updates;
+    for (auto& file : update_files) {
+      for (auto& req : load_file(file)) {
+        updates.emplace_back(std::move(req));
+      }
+    }
+    std::vector<int64_t> dates;
+    std::ifstream fi(schedule_file);
+    int64_t date;
+    while (fi >> date) {
+      dates.push_back(date);
+    }
+    if (updates.empty() || dates.size() != updates.size()) {
+      LOG(ERROR) << "got " << dates.size() << " dates in " << schedule_file
+                 << " for " << updates.size() << " updates";
+      return false;
+    }
+
+    std::vector<std::pair<double, std::string>> ops;
+    int64_t first = *std::min_element(dates.begin(), dates.end());
+    double span = 0;
+    for (size_t i = 0; i < updates.size(); ++i) {
+      double at = (dates[i] - first) * tcr / 1000.0;
+      span = std::max(span, at);
+      ops.emplace_back(at, std::move(updates[i]));
+    }
+    size_t update_num = ops.size();
+    std::cout << "schedule " << update_num << " updates over " << span
+              << " s\n";
+
+    std::vector<std::vector<std::string>> reads(256);
+    for (auto& file : read_files) {
+      for (auto& req : load_file(file)) {
+        reads[static_cast<uint8_t>(req.back())].emplace_back(std::move(req));
+      }
+    }
+    double update_interval = span / update_num;
+    for (size_t type = 0; type < reads.size(); ++type) {
+      auto& reqs = reads[type];
+      if (reqs.empty()) {
+        continue;
+      }
+      auto iter = frequencies.find(query_name(type));
+      double step = iter != frequencies.end() ? iter->second * update_interval
+                                              : span / reqs.size();
+      size_t num = 0;
+      for (; step > 0 && num < reqs.size(); ++num) {
+        double at = (num + 1) * step;
+        if (at > span) {
+          break;
+        }
+        ops.emplace_back(at, std::move(reqs[num]));
+      }
+      std::cout << query_name(type) << ": schedule " << num << " of "
+                << reqs.size() << " reads\n";
+    }
+
+    std::stable_sort(ops.begin(), ops.end(),
+                     [](const std::pair<double, std::string>& lhs,
+                        const std::pair<double, std::string>& rhs) {
+                       return lhs.first < rhs.first;
+                     });
+    reqs_.clear();
+    arrivals_.clear();
+    for (auto& op : ops) {
+      arrivals_.emplace_back(to_duration(op.first));
+      reqs_.emplace_back(std::move(op.second));
+    }
+    std::cout << "load " << reqs_.size() << " queries, "
+              << reqs_.size() - update_num << " of them reads\n";
+    resize_timings();
+    return true;
   }
 
+  void start() { begin_ = clock_type::now(); }
+
   seastar::future<> do_query(server::executor_ref& ref) {
     auto id = cur_.fetch_add(1);
     if (id >= num_of_reqs_) {
       return seastar::make_ready_future<>();
     }
-    start_[id] = std::chrono::system_clock::now();
-    return ref.run_graph_db_query(server::query_param{reqs_[id]})
-        .then_wrapped(
-            [&, id](seastar::future<server::query_result>&& fut) mutable {
-              auto result = fut.get0();
-              end_[id] = std::chrono::system_clock::now();
-            })
+    auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+        arrivals_.empty() ? clock_type::duration::zero()
+                          : scheduled(id) - clock_type::now());
+    auto issue = wait.count() > 0 ? seastar::sleep(wait)
+                                  : seastar::make_ready_future<>();
+    return issue
+        .then([&, id] {
+          issued(id);
+          return ref.run_graph_db_query(server::query_param{reqs_[id]})
+              .then_wrapped(
+                  [&, id](seastar::future<server::query_result>&& fut) {
+                    end_[id] = clock_type::now();
+                    if (fut.failed()) {
+                      failed_[id] = 1;
+                      fut.ignore_ready_future();
+                    }
+                  });
+        })
         .then([&] { return do_query(ref); });
   }
 
-  seastar::future<> simulate() {
-    hiactor::scope_builder builder;
-    builder.set_shard(hiactor::local_shard_id())
-        .enter_sub_scope(hiactor::scope<server::executor_group>(0));
-    return seastar::do_with(
-        builder.build_ref<server::executor_ref>(0),
-        [&](server::executor_ref& ref) { return do_query(ref); });
+  seastar::future<> simulate(uint32_t concurrency) {
+    return seastar::parallel_for_each(
+        boost::irange<unsigned>(0u, concurrency), [this](unsigned i) {
+          hiactor::scope_builder builder;
+          builder.set_shard(hiactor::local_shard_id())
+              .enter_sub_scope(hiactor::scope<server::executor_group>(0));
+          return seastar::do_with(
+              builder.build_ref<server::executor_ref>(i),
+              [this](server::executor_ref& ref) { return do_query(ref); });
+        });
+  }
+
+  void simulate_http(const std::string& host, int port,
+                     uint32_t concurrency) {
+    std::vector<std::thread> clients;
+    for (uint32_t i = 0; i < concurrency; ++i) {
+      clients.emplace_back([&, this]() {
+        httplib::Client cli(host, port);
+        cli.set_keep_alive(true);
+        for (auto id = cur_.fetch_add(1); id < num_of_reqs_;
+             id = cur_.fetch_add(1)) {
+          if (!arrivals_.empty()) {
+            std::this_thread::sleep_until(scheduled(id));
+          }
+          issued(id);
+          auto res =
+              cli.Post("/v1/graph/current/query", reqs_[id], "text/plain");
+          end_[id] = clock_type::now();
+          if (!res || res->status != 200) {
+            failed_[id] = 1;
+          }
+        }
+      });
+    }
+    for (auto& client : clients) {
+      client.join();
+    }
   }
 
-  void output() {
-    std::vector<long long> vec(29, 0);
-    std::vector<int> count(29, 0);
-    std::vector<std::vector<long long>> ts(29);
+  void output(const std::string& json_path, const std::string& scale_factor) {
+    std::vector<std::vector<int64_t>> ts(256), service(256);
+    std::vector<int> failures(256, 0);
     for (size_t idx = warmup_num_; idx < num_of_reqs_; idx++) {
       auto& s = reqs_[idx];
-      size_t id = static_cast<size_t>(s.back()) - 1;
-      auto tmp = std::chrono::duration_cast<std::chrono::microseconds>(
-                     end_[idx] - start_[idx])
-                     .count();
-      ts[id].emplace_back(tmp);
-      vec[id] += tmp;
-      count[id] += 1;
-    }
-    std::vector<std::string> queries = {
+      size_t id = static_cast<uint8_t>(s.back());
+      if (failed_[idx]) {
+        failures[id] += 1;
+        continue;
+      }
+      ts[id].emplace_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              end_[idx] - intended_[idx])
+              .count());
+      service[id].emplace_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(end_[idx] -
+                                                                start_[idx])
+              .count());
+    }
+
+    rapidjson::Document json(rapidjson::kObjectType);
+    auto& allocator = json.GetAllocator();
+    rapidjson::Value results(rapidjson::kArrayType);
+    size_t total = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+      size_t sz = ts[i].size();
+      if (sz == 0 && failures[i] == 0) {
+        continue;
+      }
+      std::string name = query_name(i);
+      std::sort(ts[i].begin(), ts[i].end());
+      std::sort(service[i].begin(), service[i].end());
+      int64_t sum = 0;
+      for (auto t : ts[i]) {
+        sum += t;
+      }
+      auto percentile = [&](double p) {
+        return sz == 0 ? int64_t(0)
+                       : ts[i][std::min(sz - 1, static_cast<size_t>(sz * p))];
+      };
+      double mean = sz == 0 ? 0. : sum * 1. / sz;
+      std::cout << name << "; mean: " << mean << "; counts: " << sz << "; ";
+      std::cout << " min: " << percentile(0) << "; ";
+      std::cout << " max: " << (sz == 0 ? 0 : ts[i].back()) << "; ";
+      std::cout << " P50: " << percentile(0.5) << "; ";
+      std::cout << " P90: " << percentile(0.9) << "; ";
+      std::cout << " P95: " << percentile(0.95) << "; ";
+      std::cout << " P99: " << percentile(0.99) << "; ";
+      std::cout << " P999: " << percentile(0.999) << "; ";
+      std::cout << " failures: " << failures[i] << "\n";
+      total += sz;
+
+      rapidjson::Value result(rapidjson::kObjectType);
+      result.AddMember("query", rapidjson::Value(name.c_str(), allocator),
+                       allocator);
+      result.AddMember("count", static_cast<uint64_t>(sz), allocator);
+      result.AddMember("failures", failures[i], allocator);
+      result.AddMember("mean", mean, allocator);
+      result.AddMember("min", percentile(0), allocator);
+      result.AddMember("max", sz == 0 ? int64_t(0) : ts[i].back(), allocator);
+      result.AddMember("p50", percentile(0.5), allocator);
+      result.AddMember("p90", percentile(0.9), allocator);
+      result.AddMember("p99", percentile(0.99), allocator);
+      result.AddMember("p999", percentile(0.999), allocator);
+      result.AddMember(
+          "service_p50",
+          sz == 0 ? int64_t(0) : service[i][sz / 2], allocator);
+      result.AddMember(
+          "service_p99",
+          sz == 0 ? int64_t(0) : service[i][sz * 99 / 100],
+          allocator);
+      results.PushBack(result, allocator);
+    }
+    std::cout << "unit: MICROSECONDS\n";
+
+    double elapsed = 0;
+    if (num_of_reqs_ > warmup_num_) {
+      auto first = *std::min_element(start_.begin() + warmup_num_,
+                                     start_.begin() + num_of_reqs_);
+      auto last = *std::max_element(end_.begin() + warmup_num_,
+                                    end_.begin() + num_of_reqs_);
+      elapsed = std::chrono::duration<double>(last - first).count();
+    }
+    double throughput = elapsed > 0 ? total / elapsed : 0;
+    std::cout << "throughput: " << throughput << " qps\n";
+
+    double on_time = 0;
+    if (!arrivals_.empty() && num_of_reqs_ > warmup_num_) {
+      size_t num = 0;
+      for (size_t idx = warmup_num_; idx < num_of_reqs_; ++idx) {
+        if (start_[idx] - intended_[idx] <= 1s) {
+          ++num;
+        }
+      }
+      on_time = num * 1. / (num_of_reqs_ - warmup_num_);
+      std::cout << "on time: " << on_time * 100
+                << "% of requests issued within 1 s of their schedule"
+                << (on_time >= 0.95 ? "" : ", less than the 95% required")
+                << "\n";
+    }
+
+    if (!json_path.empty()) {
+      if (!scale_factor.empty()) {
+        json.AddMember("scale_factor",
+                       rapidjson::Value(scale_factor.c_str(), allocator),
+                       allocator);
+      }
+      json.AddMember("target_qps", qps_, allocator);
+      json.AddMember("throughput", throughput, allocator);
+      json.AddMember("elapsed_seconds", elapsed, allocator);
+      if (!arrivals_.empty()) {
+        json.AddMember("on_time_ratio", on_time, allocator);
+      }
+      json.AddMember("unit", "us", allocator);
+      json.AddMember("queries", results, allocator);
+      std::ofstream fo(json_path);
+      fo << gs::rapidjson_stringify(json, 2) << std::endl;
+      std::cout << "write report to " << json_path << "\n";
+    }
+  }
+
+ private:
+  Req() : cur_(0), warmup_num_(0), qps_(0) {}
+
+  static std::string query_name(size_t id) {
+    static const std::vector<std::string> queries = {
         "IC1", "IC2",  "IC3",  "IC4",  "IC5",  "IC6",  "IC7", "IC8",
         "IC9", "IC10", "IC11", "IC12", "IC13", "IC14", "IS1", "IS2",
         "IS3", "IS4",  "IS5",  "IS6",  "IS7",  "IU1",  "IU2", "IU3",
         "IU4", "IU5",  "IU6",  "IU7",  "IU8"};
-    for (size_t i = 0; i < vec.size(); ++i) {
-      size_t sz = ts[i].size();
-      if (sz > 0) {
-        std::cout << queries[i] << "; mean: " << vec[i] * 1. / count[i]
-                  << "; counts: " << count[i] << "; ";
-
-        std::sort(ts[i].begin(), ts[i].end());
-        std::cout << " min: " << ts[i][0] << "; ";
-        std::cout << " max: " << ts[i].back() << "; ";
-        std::cout << " P50: " << ts[i][sz / 2] << "; ";
-        std::cout << " P90: " << ts[i][sz * 9 / 10] << "; ";
-        std::cout << " P95: " << ts[i][sz * 95 / 100] << "; ";
-        std::cout << " P99: " << ts[i][sz * 99 / 100] << "\n";
+    return (id >= 1 && id <= queries.size()) ? queries[id - 1]
+                                             : "Q" + std::to_string(id);
+  }
+
+  static clock_type::duration to_duration(double seconds) {
+    return std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(seconds));
+  }
+
+  void resize_timings() {
+    num_of_reqs_ = reqs_.size();
+    intended_.resize(reqs_.size());
+    start_.resize(reqs_.size());
+    end_.resize(reqs_.size());
+    failed_.resize(reqs_.size(), 0);
+  }
+
+  static std::vector<std::string> load_file(const std::string& file) {
+    std::cout << "load queries from " << file << "\n";
+    std::vector<std::string> reqs;
+    std::ifstream fi(file, std::ios::binary);
+    const size_t size = 4096;
+    std::vector<char> buffer(size);
+    std::string tmp;
+    while (fi.read(buffer.data(), size) || fi.gcount() > 0) {
+      std::streamsize len = fi.gcount();
+      for (std::streamsize i = 0; i < len; ++i) {
+        size_t index = tmp.size();
+        if (index >= 4 && tmp[index - 1] == '#') {
+          if (tmp[index - 4] == 'e' && tmp[index - 3] == 'o' &&
+              tmp[index - 2] == 'r') {
+            reqs.emplace_back(tmp.substr(0, index - 4));
+            tmp.clear();
+          }
+        }
+        tmp.push_back(buffer[i]);
       }
     }
-    std::cout << "unit: MICROSECONDS\n";
+    fi.close();
+    return reqs;
   }
 
- private:
-  Req() : cur_(0), warmup_num_(0) {}
+  // the time a request should be issued at in an open loop.
+  clock_type::time_point scheduled(size_t id) const {
+    return begin_ + arrivals_[id];
+  }
+
+  void issued(size_t id) {
+    start_[id] = clock_type::now();
+    intended_[id] = arrivals_.empty() ? start_[id] : scheduled(id);
+  }
 
   std::atomic<uint32_t> cur_;
   uint32_t warmup_num_;
   uint32_t num_of_reqs_;
+  double qps_;
+  clock_type::time_point begin_;
+  std::vector<clock_type::duration> arrivals_;
   std::vector<std::string> reqs_;
-  std::vector<std::chrono::system_clock::time_point> start_;
-  std::vector<std::chrono::system_clock::time_point> end_;
-
-  // std::vector<executor_ref> executor_refs_;
+  std::vector<clock_type::time_point> intended_;
+  std::vector<clock_type::time_point> start_;
+  std::vector<clock_type::time_point> end_;
+  std::vector<uint8_t> failed_;
 };
 
 int main(int argc, char** argv) {
@@ -161,7 +462,30 @@ int main(int argc, char** argv) {
       "num of warmup reqs")("benchmark-num,b",
                             bpo::value<uint32_t>()->default_value(0),
                             "num of benchmark reqs")(
-      "req-file,r", bpo::value<std::string>(), "requests file");
+      "req-file,r", bpo::value<std::vector<std::string>>()->multitoken(),
+      "requests files, interleaved if more than one")(
+      "concurrency,c", bpo::value<uint32_t>()->default_value(1),
+      "num of clients, per shard in process or in total over http")(
+      "qps,q", bpo::value<double>()->default_value(0),
+      "target qps of poisson arrivals, 0 for closed loop")(
+      "seed", bpo::value<uint32_t>()->default_value(0),
+      "seed of the arrival schedule")(
+      "url,u", bpo::value<std::string>(),
+      "host of a running interactive_server to query over http")(
+      "port,p", bpo::value<int>()->default_value(10000),
+      "query port of the interactive_server")(
+      "update-file", bpo::value<std::vector<std::string>>()->multitoken(),
+      "update request files of an snb interactive mix")(
+      "update-schedule", bpo::value<std::string>(),
+      "dates of the updates in milliseconds, one per line")(
+      "time-compression-ratio", bpo::value<double>()->default_value(1),
+      "ratio of the real to the simulated time of the update schedule")(
+      "frequency", bpo::value<std::vector<std::string>>()->multitoken(),
+      "updates per read of a query type, e.g. IC1=26")(
+      "scale-factor", bpo::value<std::string>()->default_value(""),
+      "scale factor of the dataset, for the report")(
+      "output-json,o", bpo::value<std::string>()->default_value(""),
+      "path to write the report in json");
 
   google::InitGoogleLogging(argv[0]);
   FLAGS_logtostderr = true;
@@ -178,9 +502,75 @@ int main(int argc, char** argv) {
     std::cout << "GraphScope/Flex version " << FLEX_VERSION << std::endl;
     return 0;
   }
+  if (!vm.count("req-file") && !vm.count("update-file")) {
+    LOG(ERROR) << "req-file is required";
+    return -1;
+  }
 
-  bool enable_dpdk = false;
   uint32_t shard_num = vm["shard-num"].as<uint32_t>();
+  uint32_t concurrency = std::max(vm["concurrency"].as<uint32_t>(), 1u);
+  uint32_t warmup_num = vm["warmup-num"].as<uint32_t>();
+  uint32_t benchmark_num = vm["benchmark-num"].as<uint32_t>();
+  std::vector<std::string> req_files;
+  if (vm.count("req-file")) {
+    req_files = vm["req-file"].as<std::vector<std::string>>();
+  }
+  double qps = vm["qps"].as<double>();
+  std::string scale_factor = vm["scale-factor"].as<std::string>();
+
+  std::map<std::string, double> frequencies;
+  if (vm.count("frequency")) {
+    for (auto& freq : vm["frequency"].as<std::vector<std::string>>()) {
+      auto pos = freq.find('=');
+      if (pos == std::string::npos) {
+        LOG(ERROR) << "invalid frequency " << freq << ", expect e.g. IC1=26";
+        return -1;
+      }
+      frequencies[freq.substr(0, pos)] = std::stod(freq.substr(pos + 1));
+    }
+  }
+  if (vm.count("update-file")) {
+    if (!vm.count("update-schedule")) {
+      LOG(ERROR) << "update-schedule is required with update-file";
+      return -1;
+    }
+    if (qps > 0) {
+      LOG(ERROR) << "qps is not used with update-file";
+      return -1;
+    }
+  }
+  auto load_requests = [&]() {
+    if (vm.count("update-file")) {
+      return Req::get().load_snb(
+          req_files, vm["update-file"].as<std::vector<std::string>>(),
+          vm["update-schedule"].as<std::string>(),
+          vm["time-compression-ratio"].as<double>(), frequencies);
+    }
+    Req::get().load(req_files);
+    return true;
+  };
+
+  setenv("TZ", "Asia/Shanghai", 1);
+  tzset();
+
+  if (vm.count("url")) {
+    if (!load_requests()) {
+      return -1;
+    }
+    Req::get().init(warmup_num, benchmark_num, qps, vm["seed"].as<uint32_t>());
+    auto begin = std::chrono::system_clock::now();
+    Req::get().start();
+    Req::get().simulate_http(vm["url"].as<std::string>(),
+                             vm["port"].as<int>(), concurrency);
+    auto end = std::chrono::system_clock::now();
+    std::cout << "cost time:"
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end -
+                                                                       begin)
+                     .count()
+              << "\n";
+    Req::get().output(vm["output-json"].as<std::string>(), scale_factor);
+    return 0;
+  }
 
   std::string graph_schema_path = "";
   std::string data_path = "";
@@ -196,9 +586,6 @@ int main(int argc, char** argv) {
   }
   data_path = vm["data-path"].as<std::string>();
 
-  setenv("TZ", "Asia/Shanghai", 1);
-  tzset();
-
   double t0 = -grape::GetCurrentTime();
   auto& db = gs::GraphDB::get();
 
@@ -210,24 +597,25 @@ int main(int argc, char** argv) {
   db.Open(schema.value(), data_path, shard_num);
 
   t0 += grape::GetCurrentTime();
-  uint32_t warmup_num = vm["warmup-num"].as<uint32_t>();
-  uint32_t benchmark_num = vm["benchmark-num"].as<uint32_t>();
   LOG(INFO) << "Finished loading graph, elapsed " << t0 << " s";
-  std::string req_file = vm["req-file"].as<std::string>();
-  Req::get().load(req_file);
-  Req::get().init(warmup_num, benchmark_num);
+  if (!load_requests()) {
+    return -1;
+  }
+  Req::get().init(warmup_num, benchmark_num, qps, vm["seed"].as<uint32_t>());
   hiactor::actor_app app;
 
   auto begin = std::chrono::system_clock::now();
   int ac = 1;
   char* av[] = {(char*) "rt_bench"};
-  app.run(ac, av, [shard_num] {
-    return seastar::parallel_for_each(boost::irange<unsigned>(0u, shard_num),
-                                      [](unsigned id) {
-                                        return seastar::smp::submit_to(id, [] {
-                                          return Req::get().simulate();
-                                        });
-                                      })
+  app.run(ac, av, [shard_num, concurrency] {
+    Req::get().start();
+    return seastar::parallel_for_each(
+               boost::irange<unsigned>(0u, shard_num),
+               [concurrency](unsigned id) {
+                 return seastar::smp::submit_to(id, [concurrency] {
+                   return Req::get().simulate(concurrency);
+                 });
+               })
         .then([] {
           hiactor::actor_engine().exit();
           fmt::print("Exit actor system.\n");
@@ -239,6 +627,5 @@ int main(int argc, char** argv) {
                                                                      begin)
                    .count()
             << "\n";
-  Req::get().output();
-  // std::cout << timer.get_time() / 1us << " microseconds\n";
+  Req::get().output(vm["output-json"].as<std::string>(), scale_factor);
 }
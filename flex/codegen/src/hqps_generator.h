@@ -147,6 +147,53 @@ bool intermediate_edge_op(const physical::EdgeExpand& expand_op) {
   return false;
 }
 
+// Whether the predicate of select only refers to the vertices a get_v with
+// alias just produced, so that it can be evaluated as the filter of the
+// get_v, instead of by a select over the context the get_v returns. Only
+// variables, constants, params and operators are taken.
+bool select_on_get_v(const physical::Select& select_op, int32_t alias) {
+  if (!select_op.has_predicate()) {
+    return false;
+  }
+  for (auto& expr_opr : select_op.predicate().operators()) {
+    switch (expr_opr.item_case()) {
+    case common::ExprOpr::kVar: {
+      auto& var = expr_opr.var();
+      if (var.has_tag() && var.tag().id() != alias) {
+        return false;
+      }
+      break;
+    }
+    case common::ExprOpr::kLogical:
+    case common::ExprOpr::kArith:
+    case common::ExprOpr::kConst:
+    case common::ExprOpr::kBrace:
+    case common::ExprOpr::kParam:
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// (lhs) && (rhs)
+common::Expression and_expression(const common::Expression& lhs,
+                                  const common::Expression& rhs) {
+  common::Expression expr;
+  for (auto* operand : {&lhs, &rhs}) {
+    if (expr.operators_size() > 0) {
+      expr.add_operators()->set_logical(common::Logical::AND);
+    }
+    expr.add_operators()->set_brace(common::ExprOpr::LEFT_BRACE);
+    for (auto& expr_opr : operand->operators()) {
+      *expr.add_operators() = expr_opr;
+    }
+    expr.add_operators()->set_brace(common::ExprOpr::RIGHT_BRACE);
+  }
+  return expr;
+}
+
 template <typename LabelT>
 void extract_vertex_labels(const physical::GetV& get_v_op,
                            std::vector<LabelT>& vertex_labels) {
@@ -194,6 +241,9 @@ class QueryGenerator {
   // if edge expand e is followed by a get_v, we can fuse them into one op
   static constexpr bool FUSE_EDGE_GET_V = true;
   static constexpr bool FUSE_PATH_EXPAND_V = true;
+  // if get_v is followed by a select on the vertices it gets, we can fuse the
+  // select into the filter of get_v
+  static constexpr bool FUSE_GET_V_SELECT = true;
   QueryGenerator(BuildingContext& ctx, const physical::PhysicalPlan& plan)
       : ctx_(ctx), plan_(plan), schema_() {}
 
@@ -479,7 +529,27 @@ class QueryGenerator {
       case physical::PhysicalOpr::Operator::kVertex: {
         physical::PhysicalOpr::MetaData meta_data;
         LOG(INFO) << "Found a get v operator";
-        auto& get_v_op = opr.vertex();
+        physical::GetV get_v_op = opr.vertex();
+        int32_t get_v_alias =
+            get_v_op.has_alias() ? get_v_op.alias().value() : -1;
+        if (FUSE_GET_V_SELECT && (i + 1 < size)) {
+          auto& next_op = plan_.plan(i + 1).opr();
+          if (next_op.op_kind_case() ==
+                  physical::PhysicalOpr::Operator::kSelect &&
+              select_on_get_v(next_op.select(), get_v_alias)) {
+            LOG(INFO) << "Fusing get_v and select";
+            auto& predicate = next_op.select().predicate();
+            auto* params = get_v_op.mutable_params();
+            if (params->has_predicate() &&
+                params->predicate().operators_size() > 0) {
+              *params->mutable_predicate() =
+                  and_expression(params->predicate(), predicate);
+            } else {
+              *params->mutable_predicate() = predicate;
+            }
+            i += 1;  // jump one step
+          }
+        }
         auto get_v_code = BuildGetVOp<LabelT>(ctx_, get_v_op, meta_data);
         // first output code can be empty, just ignore
         ss << get_v_code;
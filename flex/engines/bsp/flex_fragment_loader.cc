@@ -0,0 +1,54 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/bsp/flex_fragment_loader.h"
+
+namespace bsp {
+
+int64_t ToGrapeOid(const gs::Any& oid) {
+  if (oid.type == gs::PropertyType::kInt64) {
+    return oid.AsInt64();
+  } else if (oid.type == gs::PropertyType::kInt32) {
+    return oid.AsInt32();
+  } else if (oid.type == gs::PropertyType::kUInt32) {
+    return oid.AsUInt32();
+  } else if (oid.type == gs::PropertyType::kUInt64) {
+    return static_cast<int64_t>(oid.AsUInt64());
+  }
+  LOG(FATAL) << "Unsupported primary key type: " << oid.type;
+  return 0;
+}
+
+double ToGrapeWeight(const gs::Any& data) {
+  if (data.type == gs::PropertyType::kDouble) {
+    return data.AsDouble();
+  } else if (data.type == gs::PropertyType::kFloat) {
+    return data.AsFloat();
+  } else if (data.type == gs::PropertyType::kInt64) {
+    return data.AsInt64();
+  } else if (data.type == gs::PropertyType::kInt32) {
+    return data.AsInt32();
+  } else if (data.type == gs::PropertyType::kUInt32) {
+    return data.AsUInt32();
+  } else if (data.type == gs::PropertyType::kUInt64) {
+    return data.AsUInt64();
+  } else if (data.type == gs::PropertyType::kEmpty) {
+    return 1;
+  }
+  LOG(FATAL) << "Unsupported edge weight type: " << data.type;
+  return 0;
+}
+
+}  // namespace bsp
@@ -0,0 +1,185 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_BSP_FLEX_FRAGMENT_LOADER_H_
+#define ENGINES_BSP_FLEX_FRAGMENT_LOADER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "grape/communication/sync_comm.h"
+#include "grape/fragment/basic_fragment_loader.h"
+#include "grape/worker/comm_spec.h"
+
+#include "flex/engines/graph_db/database/read_transaction.h"
+#include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+
+namespace bsp {
+
+// The oid of a vertex of a flex graph as the int64_t oid of a grape fragment.
+// Only integral primary keys are supported.
+int64_t ToGrapeOid(const gs::Any& oid);
+
+// The weight of an edge of a flex graph, 1 for an edge without data.
+double ToGrapeWeight(const gs::Any& data);
+
+template <typename EDATA_T>
+struct EdgeDataConverter {
+  static EDATA_T Convert(const gs::Any& data) { return ToGrapeWeight(data); }
+};
+
+template <>
+struct EdgeDataConverter<grape::EmptyType> {
+  static grape::EmptyType Convert(const gs::Any&) { return {}; }
+};
+
+/**
+ * @brief Builds the fragment of this worker from the vertices of v_label and
+ * the edges of e_label between them in a snapshot of a flex graph, e.g. one
+ * opened by MutablePropertyFragment::Open with memory_level 0, whose tables
+ * and adjacency lists are mapped from the snapshot files and shared with the
+ * other processes on the node through the page cache.
+ *
+ * Every worker reads the oids of all the vertices, which the partitioner is
+ * built from, and adds the vertices and out-edges of its own stripe of local
+ * ids, which BasicFragmentLoader shuffles to their fragments. So the graph is
+ * read from the snapshot directly, without exporting it to files.
+ */
+template <typename FRAG_T>
+std::shared_ptr<FRAG_T> LoadFlexFragment(
+    const grape::CommSpec& comm_spec, const gs::MutablePropertyFragment& graph,
+    const std::string& v_label_name, const std::string& e_label_name,
+    bool directed) {
+  using oid_t = typename FRAG_T::oid_t;
+  using vdata_t = typename FRAG_T::vdata_t;
+  using edata_t = typename FRAG_T::edata_t;
+  using partitioner_t = typename FRAG_T::vertex_map_t::partitioner_t;
+
+  const auto& schema = graph.schema();
+  gs::label_t v_label = schema.get_vertex_label_id(v_label_name);
+  gs::label_t e_label = schema.get_edge_label_id(e_label_name);
+  if (!schema.exist(v_label, v_label, e_label)) {
+    LOG(FATAL) << "No edge " << e_label_name << " from " << v_label_name
+               << " to " << v_label_name;
+  }
+
+  gs::vid_t vnum = graph.vertex_num(v_label);
+  std::vector<oid_t> oids(vnum);
+  for (gs::vid_t lid = 0; lid < vnum; ++lid) {
+    oids[lid] = ToGrapeOid(graph.get_oid(v_label, lid));
+  }
+
+  grape::BasicFragmentLoader<FRAG_T> loader(comm_spec);
+  loader.SetPartitioner(partitioner_t(comm_spec.fnum(), oids));
+  loader.Start();
+  gs::vid_t begin = comm_spec.worker_id();
+  gs::vid_t step = comm_spec.worker_num();
+  for (gs::vid_t lid = begin; lid < vnum; lid += step) {
+    loader.AddVertex(oids[lid], vdata_t());
+  }
+  loader.ConstructVertices();
+
+  const auto* csr = graph.get_oe_csr(v_label, v_label, e_label);
+  if (csr != nullptr) {
+    for (gs::vid_t lid = begin; lid < vnum; lid += step) {
+      auto it = csr->edge_iter(lid);
+      for (; it->is_valid(); it->next()) {
+        loader.AddEdge(oids[lid], oids[it->get_neighbor()],
+                       EdgeDataConverter<edata_t>::Convert(it->get_data()));
+      }
+    }
+  }
+
+  std::shared_ptr<FRAG_T> fragment;
+  loader.ConstructFragment(fragment, directed);
+  return fragment;
+}
+
+/**
+ * @brief Builds the fragment of this worker from the vertices of v_label and
+ * the edges of e_label between them as of a read transaction of a GraphDB,
+ * i.e. the snapshot with the wal replayed, so that the updates committed
+ * since the graph was last compacted are seen without dumping it.
+ *
+ * Only worker 0 opens the GraphDB, as its wal must not be replayed by
+ * several processes, and passes the transaction, which is held until the
+ * fragments are built; the other workers pass nullptr. The oids are
+ * broadcast for the partitioner, and worker 0 adds every vertex and the
+ * out-edges committed before the timestamp of the transaction, which
+ * BasicFragmentLoader shuffles to their fragments.
+ */
+template <typename FRAG_T>
+std::shared_ptr<FRAG_T> LoadFlexFragment(const grape::CommSpec& comm_spec,
+                                         const gs::ReadTransaction* txn,
+                                         const std::string& v_label_name,
+                                         const std::string& e_label_name,
+                                         bool directed) {
+  using oid_t = typename FRAG_T::oid_t;
+  using vdata_t = typename FRAG_T::vdata_t;
+  using edata_t = typename FRAG_T::edata_t;
+  using partitioner_t = typename FRAG_T::vertex_map_t::partitioner_t;
+
+  std::vector<oid_t> oids;
+  gs::label_t v_label = 0, e_label = 0;
+  if (txn != nullptr) {
+    const auto& schema = txn->schema();
+    v_label = schema.get_vertex_label_id(v_label_name);
+    e_label = schema.get_edge_label_id(e_label_name);
+    if (!schema.exist(v_label, v_label, e_label)) {
+      LOG(FATAL) << "No edge " << e_label_name << " from " << v_label_name
+                 << " to " << v_label_name;
+    }
+    gs::vid_t vnum = txn->GetVertexNum(v_label);
+    oids.resize(vnum);
+    for (gs::vid_t lid = 0; lid < vnum; ++lid) {
+      oids[lid] = ToGrapeOid(txn->GetVertexId(v_label, lid));
+    }
+  }
+  grape::sync_comm::Bcast(oids, 0, comm_spec.comm());
+
+  grape::BasicFragmentLoader<FRAG_T> loader(comm_spec);
+  loader.SetPartitioner(partitioner_t(comm_spec.fnum(), oids));
+  loader.Start();
+  if (txn != nullptr) {
+    for (auto oid : oids) {
+      loader.AddVertex(oid, vdata_t());
+    }
+  }
+  loader.ConstructVertices();
+
+  if (txn != nullptr) {
+    const auto* csr = txn->graph().get_oe_csr(v_label, v_label, e_label);
+    gs::vid_t vnum = oids.size();
+    for (gs::vid_t lid = 0; csr != nullptr && lid < vnum; ++lid) {
+      auto it = csr->edge_iter(lid);
+      for (; it->is_valid(); it->next()) {
+        if (it->get_timestamp() > txn->timestamp()) {
+          continue;
+        }
+        loader.AddEdge(oids[lid], oids[it->get_neighbor()],
+                       EdgeDataConverter<edata_t>::Convert(it->get_data()));
+      }
+    }
+  }
+
+  std::shared_ptr<FRAG_T> fragment;
+  loader.ConstructFragment(fragment, directed);
+  return fragment;
+}
+
+}  // namespace bsp
+
+#endif  // ENGINES_BSP_FLEX_FRAGMENT_LOADER_H_
@@ -0,0 +1,134 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/bsp/result_writer.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "grape/communication/sync_comm.h"
+
+namespace bsp {
+
+// Outputs are sent in chunks, as MPI counts are ints.
+static constexpr size_t kChunkSize = 1ul << 30;
+// Number of vertices set by an update transaction.
+static constexpr size_t kBatchSize = 1ul << 20;
+
+std::string GatherOutput(const grape::CommSpec& comm_spec,
+                         const std::string& output) {
+  static constexpr int kTag = 0x6273;
+  if (comm_spec.worker_id() != 0) {
+    uint64_t size = output.size();
+    MPI_Send(&size, 1, MPI_UINT64_T, 0, kTag, comm_spec.comm());
+    for (size_t offset = 0; offset < size; offset += kChunkSize) {
+      int len = std::min(kChunkSize, size - offset);
+      MPI_Send(output.data() + offset, len, MPI_CHAR, 0, kTag,
+               comm_spec.comm());
+    }
+    return "";
+  }
+  std::string all = output;
+  for (int src = 1; src < comm_spec.worker_num(); ++src) {
+    uint64_t size;
+    MPI_Recv(&size, 1, MPI_UINT64_T, src, kTag, comm_spec.comm(),
+             MPI_STATUS_IGNORE);
+    size_t begin = all.size();
+    all.resize(begin + size);
+    for (size_t offset = 0; offset < size; offset += kChunkSize) {
+      int len = std::min(kChunkSize, size - offset);
+      MPI_Recv(&all[begin + offset], len, MPI_CHAR, src, kTag,
+               comm_spec.comm(), MPI_STATUS_IGNORE);
+    }
+  }
+  return all;
+}
+
+bool WriteResultColumn(const gs::Schema& schema, const std::string& data_path,
+                       const std::string& v_label, const std::string& column,
+                       const std::string& output) {
+  auto& db = gs::GraphDB::get();
+  auto res = db.Open(schema, data_path, 1);
+  if (!res.ok()) {
+    LOG(ERROR) << "Failed to open graph at " << data_path << ": "
+               << res.status().error_message();
+    return false;
+  }
+  bool ok = WriteResultColumn(db, v_label, column, output);
+  db.Close();
+  return ok;
+}
+
+bool WriteResultColumn(gs::GraphDB& db, const std::string& v_label,
+                       const std::string& column, const std::string& output) {
+  const auto& schema = db.schema();
+  if (!schema.has_vertex_label(v_label)) {
+    LOG(ERROR) << "Vertex label " << v_label << " not found";
+    return false;
+  }
+  gs::label_t label = schema.get_vertex_label_id(v_label);
+  const auto& names = schema.get_vertex_property_names(label);
+  auto iter = std::find(names.begin(), names.end(), column);
+  if (iter == names.end()) {
+    LOG(ERROR) << "Property " << column << " of " << v_label
+               << " not found, it should be declared in the schema";
+    return false;
+  }
+  int col_id = iter - names.begin();
+  auto type = schema.get_vertex_properties(label)[col_id];
+  auto oid_type = std::get<0>(schema.get_vertex_primary_key(label)[0]);
+
+  std::vector<gs::vid_t> lids;
+  std::vector<gs::Any> values;
+  size_t updated = 0;
+  bool ok = true;
+  auto commit = [&]() {
+    auto txn = db.GetSession(0).GetUpdateTransaction();
+    if (!txn.SetVertexFields(label, col_id, lids, values) || !txn.Commit()) {
+      txn.Abort();
+      return false;
+    }
+    updated += lids.size();
+    lids.clear();
+    values.clear();
+    return true;
+  };
+
+  std::istringstream is(output);
+  std::string oid, value;
+  while (ok && is >> oid >> value) {
+    gs::vid_t lid;
+    if (!db.graph().get_lid(label, gs::ConvertStringToAny(oid, oid_type),
+                            lid)) {
+      LOG(ERROR) << "Vertex " << oid << " of " << v_label << " not found";
+      ok = false;
+      break;
+    }
+    lids.push_back(lid);
+    values.push_back(gs::ConvertStringToAny(value, type));
+    if (lids.size() == kBatchSize) {
+      ok = commit();
+    }
+  }
+  if (ok && !lids.empty()) {
+    ok = commit();
+  }
+  LOG(INFO) << "Set " << column << " of " << updated << " vertices of "
+            << v_label;
+  return ok;
+}
+
+}  // namespace bsp
@@ -0,0 +1,56 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_BSP_RESULT_WRITER_H_
+#define ENGINES_BSP_RESULT_WRITER_H_
+
+#include <string>
+
+#include "grape/worker/comm_spec.h"
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/storages/rt_mutable_graph/schema.h"
+
+namespace bsp {
+
+// Gathers the outputs of every worker to worker 0, which returns them one
+// after another, while the other workers return an empty string.
+std::string GatherOutput(const grape::CommSpec& comm_spec,
+                         const std::string& output);
+
+/**
+ * @brief Writes the result of an app back to the flex graph at data_path.
+ *
+ * The output has a line "oid value" per vertex of v_label, as written by
+ * the Output of the grape apps. Each value is set to the property column of
+ * the vertex, which must be declared in the schema with a type the values
+ * can be parsed as, e.g. DT_DOUBLE for pagerank or DT_SIGNED_INT64 for wcc.
+ * The values are set by update transactions, so that they are logged in the
+ * wal and seen by the interactive queries once the graph is reopened.
+ *
+ * The graph must not be opened by another process meanwhile.
+ */
+bool WriteResultColumn(const gs::Schema& schema, const std::string& data_path,
+                       const std::string& v_label, const std::string& column,
+                       const std::string& output);
+
+// As above, to a GraphDB already opened by this process, which is left open.
+// No transaction of this process may be held meanwhile.
+bool WriteResultColumn(gs::GraphDB& db, const std::string& v_label,
+                       const std::string& column, const std::string& output);
+
+}  // namespace bsp
+
+#endif  // ENGINES_BSP_RESULT_WRITER_H_
@@ -28,6 +28,12 @@ bool ReadAppBase::run(GraphDBSession& db, Decoder& input, Encoder& output) {
   return this->Query(db, input, output);
 }
 
+bool ReadAppBase::run_stream(GraphDBSession& db, Decoder& input,
+                             Encoder& output,
+                             std::unique_ptr<ResultStream>& stream) {
+  return this->QueryStream(db, input, output, stream);
+}
+
 AppBase::AppMode WriteAppBase::mode() const { return AppMode::kWrite; }
 
 AppBase::AppType WriteAppBase::type() const { return AppType::kCppProcedure; }
@@ -16,13 +16,17 @@
 #ifndef GRAPHSCOPE_APP_BASE_H_
 #define GRAPHSCOPE_APP_BASE_H_
 
+#include "flex/engines/graph_db/database/label_set.h"
 #include "flex/utils/app_utils.h"
 
 #include <dlfcn.h>
 #include <string.h>
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -49,6 +53,19 @@ class AppBase {
   virtual AppType type() const = 0;
   virtual AppMode mode() const = 0;
   virtual bool run(GraphDBSession& db, Decoder& input, Encoder& output) = 0;
+  // Like run, but the tail of the output may be left in stream, to be
+  // produced while the head written to output is sent. Runs run by default.
+  virtual bool run_stream(GraphDBSession& db, Decoder& input, Encoder& output,
+                          std::unique_ptr<ResultStream>& stream) {
+    return run(db, input, output);
+  }
+  // For a read app, whose output of the last successful run may be cached
+  // until one of labels is written, see ResultCache. Returns false if the
+  // output must not be cached. By default, until any label is written.
+  virtual bool cached_labels(LabelSet& labels) const {
+    labels.add_all();
+    return true;
+  }
   virtual ~AppBase() {}
 };
 
@@ -60,8 +77,18 @@ class ReadAppBase : public AppBase {
 
   bool run(GraphDBSession& db, Decoder& input, Encoder& output) override;
 
+  bool run_stream(GraphDBSession& db, Decoder& input, Encoder& output,
+                  std::unique_ptr<ResultStream>& stream) override;
+
   virtual bool Query(const GraphDBSession& db, Decoder& input,
                      Encoder& output) = 0;
+
+  // See AppBase::run_stream, runs Query by default.
+  virtual bool QueryStream(const GraphDBSession& db, Decoder& input,
+                           Encoder& output,
+                           std::unique_ptr<ResultStream>& stream) {
+    return Query(db, input, output);
+  }
 };
 
 class WriteAppBase : public AppBase {
@@ -137,18 +164,31 @@ class SharedLibraryAppFactory : public AppFactoryBase {
 };
 
 struct AppMetric {
+  // Bucket i counts the values up to 2^i, the last bucket the larger ones.
+  static constexpr int kBucketNum = 28;
+
   AppMetric()
       : total_(0),
         min_val_(std::numeric_limits<int64_t>::max()),
         max_val_(0),
-        count_(0) {}
+        count_(0),
+        buckets_{} {}
   ~AppMetric() {}
 
+  static inline int bucket_of(int64_t val) {
+    if (val <= 1) {
+      return 0;
+    }
+    int bucket = 64 - __builtin_clzll(static_cast<uint64_t>(val - 1));
+    return std::min(bucket, kBucketNum - 1);
+  }
+
   void add_record(int64_t val) {
     total_ += val;
     min_val_ = std::min(min_val_, val);
     max_val_ = std::max(max_val_, val);
     ++count_;
+    ++buckets_[bucket_of(val)];
   }
 
   bool empty() const { return (count_ == 0); }
@@ -158,6 +198,9 @@ struct AppMetric {
     min_val_ = std::min(min_val_, rhs.min_val_);
     max_val_ = std::max(max_val_, rhs.max_val_);
     count_ += rhs.count_;
+    for (int i = 0; i < kBucketNum; ++i) {
+      buckets_[i] += rhs.buckets_[i];
+    }
 
     return *this;
   }
@@ -175,6 +218,7 @@ struct AppMetric {
   int64_t min_val_;
   int64_t max_val_;
   int64_t count_;
+  std::array<int64_t, kBucketNum> buckets_;
 };
 
 }  // namespace gs
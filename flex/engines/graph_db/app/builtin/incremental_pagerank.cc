@@ -0,0 +1,80 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "flex/engines/graph_db/app/builtin/incremental_pagerank.h"
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+results::CollectiveResults IncrementalPageRankApp::Query(
+    const GraphDBSession& sess, int32_t result_limit) {
+  auto* pagerank = sess.db().incremental_pagerank();
+  if (pagerank == nullptr) {
+    LOG(ERROR) << "Incremental pagerank is not enabled, see "
+                  "compute_engine.incremental_pagerank.";
+    return {};
+  }
+  if (result_limit <= 0) {
+    LOG(ERROR) << "The value of the result limit must be greater than 0.";
+    return {};
+  }
+  // The vertices the scores cover may be inserted after the transaction
+  // started, and are skipped.
+  auto txn = sess.GetReadTransaction();
+  auto scores = pagerank->TopK(result_limit);
+  vid_t vertex_num = txn.GetVertexNum(pagerank->vertex_label());
+
+  runtime::GraphReadInterface graph(txn);
+  results::CollectiveResults results;
+  for (const auto& score : scores) {
+    if (score.vid >= vertex_num) {
+      continue;
+    }
+    auto result = results.add_results();
+    runtime::RTAny oid(txn.GetVertexId(pagerank->vertex_label(), score.vid));
+    oid.sink(graph, 0, result->mutable_record()->add_columns());
+
+    auto pagerank_col = result->mutable_record()->add_columns();
+    pagerank_col->mutable_name_or_id()->set_id(1);
+    pagerank_col
+        ->mutable_entry()
+        ->mutable_element()
+        ->mutable_object()
+        ->set_f64(score.pagerank);
+    auto in_degree_col = result->mutable_record()->add_columns();
+    in_degree_col->mutable_name_or_id()->set_id(2);
+    in_degree_col
+        ->mutable_entry()
+        ->mutable_element()
+        ->mutable_object()
+        ->set_i64(score.in_degree);
+    auto out_degree_col = result->mutable_record()->add_columns();
+    out_degree_col->mutable_name_or_id()->set_id(3);
+    out_degree_col
+        ->mutable_entry()
+        ->mutable_element()
+        ->mutable_object()
+        ->set_i64(score.out_degree);
+  }
+
+  txn.Commit();
+  return results;
+}
+
+AppWrapper IncrementalPageRankFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new IncrementalPageRankApp(), NULL);
+}
+}  // namespace gs
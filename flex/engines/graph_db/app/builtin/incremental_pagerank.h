@@ -0,0 +1,41 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_INCREMENTAL_PAGERANK_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_INCREMENTAL_PAGERANK_H_
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/hqps_db/app/interactive_app_base.h"
+
+namespace gs {
+// The result_limit highest scores of the PageRank kept fresh under inserts,
+// with the degrees of their vertices, see GraphDB::incremental_pagerank.
+class IncrementalPageRankApp : public CypherReadAppBase<int32_t> {
+ public:
+  IncrementalPageRankApp() {}
+  results::CollectiveResults Query(const GraphDBSession& sess,
+                                   int32_t result_limit) override;
+};
+
+class IncrementalPageRankFactory : public AppFactoryBase {
+ public:
+  IncrementalPageRankFactory() = default;
+  ~IncrementalPageRankFactory() = default;
+
+  AppWrapper CreateApp(const GraphDB& db) override;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_INCREMENTAL_PAGERANK_H_
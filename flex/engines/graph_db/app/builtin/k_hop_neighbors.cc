@@ -14,8 +14,47 @@
  */
 #include "flex/engines/graph_db/app/builtin/k_hop_neighbors.h"
 
+#include "flex/engines/graph_db/runtime/common/utils/bitset.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+
 namespace gs {
 
+namespace {
+
+// The edges of a vertex label, in one direction, to a neighbor label.
+struct Adjacency {
+  label_t neighbor_label;
+  label_t edge_label;
+  bool outgoing;
+};
+
+// A hop expands bottom-up, from the unvisited vertices, once the frontier
+// holds more than 1 / kBottomUpRatio of them.
+constexpr size_t kBottomUpRatio = 20;
+
+struct Range {
+  label_t label;
+  size_t begin;
+  size_t end;
+};
+
+template <typename FUNC_T>
+void for_each_neighbor(const ReadTransaction& txn, label_t label, vid_t v,
+                       const Adjacency& adj, const FUNC_T& func) {
+  auto edges =
+      adj.outgoing ? txn.GetOutEdgeIterator(label, v, adj.neighbor_label,
+                                            adj.edge_label)
+                   : txn.GetInEdgeIterator(label, v, adj.neighbor_label,
+                                           adj.edge_label);
+  for (; edges.IsValid(); edges.Next()) {
+    if (!func(edges.GetNeighbor())) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
 results::CollectiveResults KNeighbors::Query(const GraphDBSession& sess,
                                              std::string label_name,
                                              int64_t vertex_id, int32_t k) {
@@ -32,93 +71,157 @@ results::CollectiveResults KNeighbors::Query(const GraphDBSession& sess,
     return {};
   }
   label_t vertex_label_ = schema_.get_vertex_label_id(label_name);
-  struct pair_hash {
-    std::size_t operator()(const std::pair<label_t, vid_t>& p) const {
-      auto hash1 = std::hash<label_t>{}(p.first);
-      auto hash2 = std::hash<vid_t>{}(p.second);
-      return hash1 ^ (hash2 << 1);
-    }
-  };
-  std::unordered_set<std::pair<label_t, vid_t>, pair_hash> k_neighbors;
-
-  int vertex_size_ = (int) schema_.vertex_label_num();
-  int edge_size_ = (int) schema_.edge_label_num();
-
-  std::vector<vid_t> nei_index_;
-  std::vector<label_t> nei_label_;
-  std::vector<vid_t> next_nei_indexs_;
-  std::vector<label_t> next_nei_label_;
-
-  nei_label_.push_back(vertex_label_);
   vid_t vertex_index{};
   if (!txn.GetVertexIndex(vertex_label_, vertex_id, vertex_index)) {
     LOG(ERROR) << "Vertex not found.";
     return {};
   }
-  nei_index_.push_back(vertex_index);
-  // get k hop neighbors
-  while (!nei_index_.empty() && k > 0) {
-    for (long unsigned int i = 0; i < nei_index_.size(); i++) {
-      for (int j = 0; j < vertex_size_; j++) {
-        for (int k = 0; k < edge_size_; k++) {
-          if (schema_.has_edge_label(label_t(nei_label_[i]), label_t(j),
-                                     label_t(k))) {
-            auto outedges = txn.GetOutEdgeIterator(
-                nei_label_[i], nei_index_[i], j,
-                k);  // 1.self_label 2.self_index 3.edge_label 4.nei_label
-            while (outedges.IsValid()) {
-              auto neighbor = outedges.GetNeighbor();
-              if (k_neighbors.find(std::make_pair(j, neighbor)) ==
-                  k_neighbors.end()) {
-                next_nei_label_.push_back(j);
-                next_nei_indexs_.push_back(neighbor);
-                k_neighbors.insert(std::make_pair(j, neighbor));
-              }
-              outedges.Next();
-            }
+
+  size_t label_num = schema_.vertex_label_num();
+  size_t edge_label_num = schema_.edge_label_num();
+
+  // The neighbors are reached along the edges of both directions, so that
+  // the adjacencies of a label are also the ones a bottom-up hop looks up.
+  std::vector<std::vector<Adjacency>> adjacencies(label_num);
+  for (label_t l = 0; l < label_num; ++l) {
+    for (label_t j = 0; j < label_num; ++j) {
+      for (label_t e = 0; e < edge_label_num; ++e) {
+        if (schema_.exist(l, j, e)) {
+          adjacencies[l].push_back({j, e, true});
+        }
+        if (schema_.exist(j, l, e)) {
+          adjacencies[l].push_back({j, e, false});
+        }
+      }
+    }
+  }
+
+  std::vector<vid_t> vertex_nums(label_num);
+  std::vector<Bitset> visited(label_num);
+  size_t unvisited_num = 0;
+  for (label_t l = 0; l < label_num; ++l) {
+    vertex_nums[l] = txn.GetVertexNum(l);
+    visited[l].resize(vertex_nums[l]);
+    unvisited_num += vertex_nums[l];
+  }
+  visited[vertex_label_].set(vertex_index);
+  unvisited_num -= 1;
+
+  std::vector<std::vector<vid_t>> frontier(label_num);
+  frontier[vertex_label_].push_back(vertex_index);
+  size_t frontier_num = 1;
+
+  std::vector<std::string> label_names(label_num);
+  for (label_t l = 0; l < label_num; ++l) {
+    label_names[l] = schema_.get_vertex_label_name(l);
+  }
+  results::CollectiveResults results;
+  auto& pool = runtime::MorselPool::get();
+
+  while (frontier_num > 0 && unvisited_num > 0 && k > 0) {
+    bool bottom_up = frontier_num > unvisited_num / kBottomUpRatio;
+    std::vector<Bitset> frontier_bits;
+    std::vector<Range> ranges;
+    size_t total = bottom_up ? unvisited_num : frontier_num;
+    size_t range_num = pool.Enabled(total) ? pool.MorselNum(total) : 1;
+    for (label_t l = 0; l < label_num; ++l) {
+      size_t len = bottom_up ? vertex_nums[l] : frontier[l].size();
+      if (len == 0 || adjacencies[l].empty()) {
+        continue;
+      }
+      size_t num = std::min(len, range_num);
+      for (size_t i = 0; i < num; ++i) {
+        ranges.push_back({l, len * i / num, len * (i + 1) / num});
+      }
+    }
+    if (bottom_up) {
+      frontier_bits.resize(label_num);
+      for (label_t l = 0; l < label_num; ++l) {
+        if (!frontier[l].empty()) {
+          frontier_bits[l].resize(vertex_nums[l]);
+          for (auto v : frontier[l]) {
+            frontier_bits[l].set(v);
           }
-          if (schema_.has_edge_label(label_t(j), label_t(nei_label_[i]),
-                                     label_t(k))) {
-            auto inedges = txn.GetInEdgeIterator(
-                nei_label_[i], nei_index_[i], j,
-                k);  // 1.self_label 2.self_index 3.edge_label 4.nei_label
-            while (inedges.IsValid()) {
-              auto neighbor = inedges.GetNeighbor();
-              if (k_neighbors.find(std::make_pair(j, neighbor)) ==
-                  k_neighbors.end()) {
-                next_nei_label_.push_back(j);
-                next_nei_indexs_.push_back(neighbor);
-                k_neighbors.insert(std::make_pair(j, neighbor));
-              }
-              inedges.Next();
+        }
+      }
+    }
+
+    // The vertices found by each range, per label.
+    std::vector<std::vector<std::vector<vid_t>>> found(
+        ranges.size(), std::vector<std::vector<vid_t>>(label_num));
+    pool.Run(ranges.size(), [&](size_t i) {
+      const auto& range = ranges[i];
+      auto& out = found[i];
+      if (bottom_up) {
+        // A vertex joins the next frontier once any neighbor is in the
+        // current one.
+        for (size_t v = range.begin; v < range.end; ++v) {
+          if (visited[range.label].get(v)) {
+            continue;
+          }
+          bool reached = false;
+          for (const auto& adj : adjacencies[range.label]) {
+            const auto& bits = frontier_bits[adj.neighbor_label];
+            if (bits.size() == 0) {
+              continue;
+            }
+            for_each_neighbor(txn, range.label, v, adj, [&](vid_t u) {
+              reached = bits.get(u);
+              return !reached;
+            });
+            if (reached) {
+              break;
             }
           }
+          if (reached && visited[range.label].atomic_set(v)) {
+            out[range.label].push_back(v);
+          }
+        }
+      } else {
+        const auto& vertices = frontier[range.label];
+        for (size_t idx = range.begin; idx < range.end; ++idx) {
+          for (const auto& adj : adjacencies[range.label]) {
+            auto& bits = visited[adj.neighbor_label];
+            auto& next = out[adj.neighbor_label];
+            for_each_neighbor(txn, range.label, vertices[idx], adj,
+                              [&](vid_t u) {
+                                if (bits.atomic_set(u)) {
+                                  next.push_back(u);
+                                }
+                                return true;
+                              });
+          }
         }
       }
+    });
+
+    // The vertices of a hop are written out before the next one starts.
+    frontier_num = 0;
+    for (label_t l = 0; l < label_num; ++l) {
+      frontier[l].clear();
+      for (auto& out : found) {
+        frontier[l].insert(frontier[l].end(), out[l].begin(), out[l].end());
+      }
+      for (auto v : frontier[l]) {
+        auto result = results.add_results();
+        result->mutable_record()
+            ->add_columns()
+            ->mutable_entry()
+            ->mutable_element()
+            ->mutable_object()
+            ->set_str(label_names[l]);
+        result->mutable_record()
+            ->add_columns()
+            ->mutable_entry()
+            ->mutable_element()
+            ->mutable_object()
+            ->set_i64(txn.GetVertexId(l, v).AsInt64());
+      }
+      frontier_num += frontier[l].size();
     }
-    nei_index_ = next_nei_indexs_;
-    nei_label_ = next_nei_label_;
-    next_nei_label_.clear();
-    next_nei_indexs_.clear();
+    unvisited_num -= frontier_num;
     k--;
   }
-  results::CollectiveResults results;
-  for (auto vertex_ : k_neighbors) {
-    std::string label_name_ = schema_.get_vertex_label_name(vertex_.first);
-    auto result = results.add_results();
-    result->mutable_record()
-        ->add_columns()
-        ->mutable_entry()
-        ->mutable_element()
-        ->mutable_object()
-        ->set_str(label_name_);
-    result->mutable_record()
-        ->add_columns()
-        ->mutable_entry()
-        ->mutable_element()
-        ->mutable_object()
-        ->set_i64(txn.GetVertexId(vertex_.first, vertex_.second).AsInt64());
-  }
 
   txn.Commit();
   return results;
@@ -0,0 +1,130 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "flex/engines/graph_db/app/builtin/label_propagation.h"
+
+#include <algorithm>
+
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+results::CollectiveResults LabelPropagation::Query(const GraphDBSession& sess,
+                                                   std::string vertex_label,
+                                                   std::string edge_label,
+                                                   int32_t max_iterations) {
+  auto txn = sess.GetReadTransaction();
+  const auto& schema = txn.schema();
+  if (!schema.has_vertex_label(vertex_label)) {
+    LOG(ERROR) << "The requested vertex label doesn't exits.";
+    return {};
+  }
+  if (!schema.has_edge_label(vertex_label, vertex_label, edge_label)) {
+    LOG(ERROR) << "The requested edge label doesn't exits.";
+    return {};
+  }
+  if (max_iterations <= 0) {
+    LOG(ERROR) << "The value of the max iterations must be greater than 0.";
+    return {};
+  }
+  label_t vertex_label_id = schema.get_vertex_label_id(vertex_label);
+  UndirectedCsr csr;
+  csr.Build(txn, vertex_label_id, schema.get_edge_label_id(edge_label));
+
+  vid_t vertex_num = csr.vertex_num();
+  std::vector<vid_t> labels(vertex_num);
+  std::vector<vid_t> new_labels(vertex_num);
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    labels[v] = v;
+  }
+  size_t range_num = builtin_range_num(vertex_num);
+  std::vector<size_t> range_changes(range_num, 0);
+
+  for (int iter = 0; iter < max_iterations; ++iter) {
+    builtin_parallel_ranges(
+        vertex_num, range_num, [&](size_t i, size_t begin, size_t end) {
+          std::vector<vid_t> neighbor_labels;
+          size_t changes = 0;
+          for (size_t v = begin; v < end; ++v) {
+            vid_t label = labels[v];
+            if (csr.degree(v) != 0) {
+              neighbor_labels.clear();
+              for (auto p = csr.begin(v); p != csr.end(v); ++p) {
+                neighbor_labels.push_back(labels[*p]);
+              }
+              std::sort(neighbor_labels.begin(), neighbor_labels.end());
+              size_t best_num = 0, own_num = 0;
+              for (size_t j = 0; j < neighbor_labels.size();) {
+                size_t k = j;
+                while (k < neighbor_labels.size() &&
+                       neighbor_labels[k] == neighbor_labels[j]) {
+                  ++k;
+                }
+                if (k - j > best_num) {
+                  best_num = k - j;
+                  label = neighbor_labels[j];
+                }
+                if (neighbor_labels[j] == labels[v]) {
+                  own_num = k - j;
+                }
+                j = k;
+              }
+              // Keeping the label on a tie damps the oscillations of the
+              // synchronous updates.
+              if (own_num == best_num) {
+                label = labels[v];
+              }
+            }
+            changes += label != labels[v];
+            new_labels[v] = label;
+          }
+          range_changes[i] = changes;
+        });
+    std::swap(labels, new_labels);
+    size_t changes = 0;
+    for (auto c : range_changes) {
+      changes += c;
+    }
+    if (changes == 0) {
+      VLOG(10) << "Label propagation converged after " << iter + 1
+               << " iterations";
+      break;
+    }
+  }
+
+  runtime::GraphReadInterface graph(txn);
+  results::CollectiveResults results;
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    auto result = results.add_results();
+    runtime::RTAny oid(txn.GetVertexId(vertex_label_id, v));
+    oid.sink(graph, 0, result->mutable_record()->add_columns());
+    auto community_col = result->mutable_record()->add_columns();
+    community_col->mutable_name_or_id()->set_id(1);
+    community_col
+        ->mutable_entry()
+        ->mutable_element()
+        ->mutable_object()
+        ->set_i64(labels[v]);
+  }
+
+  txn.Commit();
+  return results;
+}
+
+AppWrapper LabelPropagationFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new LabelPropagation(), NULL);
+}
+}  // namespace gs
@@ -0,0 +1,47 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_LABEL_PROPAGATION_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_LABEL_PROPAGATION_H_
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/hqps_db/app/interactive_app_base.h"
+
+namespace gs {
+// Communities of the subgraph of a vertex label and an edge label, taken as
+// undirected, by synchronous label propagation. Each vertex starts with its
+// internal index and takes the most frequent label of its neighbors, the
+// smallest on a tie unless it holds one of them, until no label changes or
+// max_iterations is reached.
+class LabelPropagation
+    : public CypherReadAppBase<std::string, std::string, int32_t> {
+ public:
+  LabelPropagation() {}
+  results::CollectiveResults Query(const GraphDBSession& sess,
+                                   std::string vertex_label,
+                                   std::string edge_label,
+                                   int32_t max_iterations) override;
+};
+
+class LabelPropagationFactory : public AppFactoryBase {
+ public:
+  LabelPropagationFactory() = default;
+  ~LabelPropagationFactory() = default;
+
+  AppWrapper CreateApp(const GraphDB& db) override;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_LABEL_PROPAGATION_H_
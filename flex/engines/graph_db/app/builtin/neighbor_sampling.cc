@@ -0,0 +1,225 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/app/builtin/neighbor_sampling.h"
+
+#include <cmath>
+#include <queue>
+#include <sstream>
+
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+namespace {
+
+// The edges of a vertex label, in one direction, to a neighbor label, and
+// the index of the weight among their properties, -1 if unweighted.
+struct Adjacency {
+  label_t neighbor_label;
+  label_t edge_label;
+  bool outgoing;
+  int weight_idx;
+};
+
+using vertex_t = std::pair<label_t, vid_t>;
+
+// The neighbors of v kept by weighted reservoir sampling without
+// replacement: each edge draws the key log(u) / weight, and the fanout
+// largest keys win. Edges without a positive weight are never sampled.
+void sample(const ReadTransaction& txn, label_t label, vid_t v,
+            const std::vector<Adjacency>& adjacencies, size_t fanout,
+            SplitMix64& rng, std::vector<vertex_t>& nbrs) {
+  nbrs.clear();
+  if (fanout == 0) {
+    return;
+  }
+  using keyed_t = std::pair<double, vertex_t>;
+  std::priority_queue<keyed_t, std::vector<keyed_t>, std::greater<keyed_t>>
+      heap;
+  for (const auto& adj : adjacencies) {
+    auto edges =
+        adj.outgoing ? txn.GetOutEdgeIterator(label, v, adj.neighbor_label,
+                                              adj.edge_label)
+                     : txn.GetInEdgeIterator(label, v, adj.neighbor_label,
+                                             adj.edge_label);
+    for (; edges.IsValid(); edges.Next()) {
+      double weight = 1;
+      if (adj.weight_idx >= 0) {
+        Any data = edges.GetData();
+        if (data.type == PropertyType::kRecordView) {
+          data = data.value.record_view[adj.weight_idx];
+        }
+        if (!builtin_as_double(data, weight) || !(weight > 0)) {
+          continue;
+        }
+      }
+      double key = std::log(rng.uniform()) / weight;
+      if (heap.size() < fanout) {
+        heap.emplace(key, vertex_t(adj.neighbor_label, edges.GetNeighbor()));
+      } else if (key > heap.top().first) {
+        heap.pop();
+        heap.emplace(key, vertex_t(adj.neighbor_label, edges.GetNeighbor()));
+      }
+    }
+  }
+  while (!heap.empty()) {
+    nbrs.push_back(heap.top().second);
+    heap.pop();
+  }
+  std::reverse(nbrs.begin(), nbrs.end());
+}
+
+std::vector<std::string> split(const std::string& str) {
+  std::vector<std::string> items;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    item.erase(0, item.find_first_not_of(" \t"));
+    item.erase(item.find_last_not_of(" \t") + 1);
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+void add_str(results::Results* result, int id, const std::string& str) {
+  auto col = result->mutable_record()->add_columns();
+  col->mutable_name_or_id()->set_id(id);
+  col->mutable_entry()->mutable_element()->mutable_object()->set_str(str);
+}
+
+}  // namespace
+
+results::CollectiveResults NeighborSampling::Query(
+    const GraphDBSession& sess, std::string label_name, std::string seeds,
+    std::string fanouts, std::string direction, std::string weight_property) {
+  auto txn = sess.GetReadTransaction();
+  const auto& schema = txn.schema();
+  if (!schema.has_vertex_label(label_name)) {
+    LOG(ERROR) << "The requested label doesn't exist.";
+    return {};
+  }
+  if (direction != "in" && direction != "out" && direction != "both") {
+    LOG(ERROR) << "direction must be one of in, out and both.";
+    return {};
+  }
+  label_t seed_label = schema.get_vertex_label_id(label_name);
+  std::vector<size_t> hop_fanouts;
+  std::vector<vertex_t> frontier;
+  try {
+    for (auto& fanout : split(fanouts)) {
+      hop_fanouts.push_back(std::stoul(fanout));
+    }
+    auto pk_type = std::get<0>(schema.get_vertex_primary_key(seed_label)[0]);
+    for (auto& seed : split(seeds)) {
+      vid_t vid;
+      if (txn.GetVertexIndex(seed_label, ConvertStringToAny(seed, pk_type),
+                             vid)) {
+        frontier.emplace_back(seed_label, vid);
+      } else {
+        LOG(WARNING) << "Seed " << seed << " not found.";
+      }
+    }
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to parse the seeds or fanouts: " << e.what();
+    return {};
+  }
+
+  size_t label_num = schema.vertex_label_num();
+  size_t edge_label_num = schema.edge_label_num();
+  std::vector<std::vector<Adjacency>> adjacencies(label_num);
+  auto weight_idx = [&](label_t src, label_t dst, label_t e) {
+    if (weight_property.empty()) {
+      return -1;
+    }
+    const auto& names = schema.get_edge_property_names(src, dst, e);
+    auto iter = std::find(names.begin(), names.end(), weight_property);
+    return iter == names.end() ? -2 : static_cast<int>(iter - names.begin());
+  };
+  // Triplets without the weight property are not sampled from.
+  for (label_t l = 0; l < label_num; ++l) {
+    for (label_t j = 0; j < label_num; ++j) {
+      for (label_t e = 0; e < edge_label_num; ++e) {
+        if (direction != "in" && schema.exist(l, j, e)) {
+          int idx = weight_idx(l, j, e);
+          if (idx != -2) {
+            adjacencies[l].push_back({j, e, true, idx});
+          }
+        }
+        if (direction != "out" && schema.exist(j, l, e)) {
+          int idx = weight_idx(j, l, e);
+          if (idx != -2) {
+            adjacencies[l].push_back({j, e, false, idx});
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> label_names(label_num);
+  for (label_t l = 0; l < label_num; ++l) {
+    label_names[l] = schema.get_vertex_label_name(l);
+  }
+  runtime::GraphReadInterface graph(txn);
+  results::CollectiveResults results;
+  for (size_t hop = 0; hop < hop_fanouts.size() && !frontier.empty(); ++hop) {
+    std::vector<std::vector<vertex_t>> sampled(frontier.size());
+    builtin_parallel_ranges(
+        frontier.size(), builtin_range_num(frontier.size()),
+        [&](size_t, size_t begin, size_t end) {
+          for (size_t i = begin; i < end; ++i) {
+            auto [label, v] = frontier[i];
+            SplitMix64 rng((static_cast<uint64_t>(hop) << 40) ^
+                           (static_cast<uint64_t>(label) << 32) ^ v);
+            sample(txn, label, v, adjacencies[label], hop_fanouts[hop], rng,
+                   sampled[i]);
+          }
+        });
+
+    std::vector<vertex_t> next;
+    for (size_t i = 0; i < frontier.size(); ++i) {
+      auto [label, v] = frontier[i];
+      runtime::RTAny src_oid(txn.GetVertexId(label, v));
+      for (auto [nbr_label, nbr] : sampled[i]) {
+        auto result = results.add_results();
+        auto hop_col = result->mutable_record()->add_columns();
+        hop_col->mutable_name_or_id()->set_id(0);
+        hop_col->mutable_entry()->mutable_element()->mutable_object()->set_i32(
+            hop);
+        add_str(result, 1, label_names[label]);
+        src_oid.sink(graph, 2, result->mutable_record()->add_columns());
+        add_str(result, 3, label_names[nbr_label]);
+        runtime::RTAny dst_oid(txn.GetVertexId(nbr_label, nbr));
+        dst_oid.sink(graph, 4, result->mutable_record()->add_columns());
+        next.emplace_back(nbr_label, nbr);
+      }
+    }
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+    frontier.swap(next);
+  }
+
+  txn.Commit();
+  return results;
+}
+
+AppWrapper NeighborSamplingFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new NeighborSampling(), NULL);
+}
+}  // namespace gs
@@ -0,0 +1,54 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_NEIGHBOR_SAMPLING_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_NEIGHBOR_SAMPLING_H_
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/hqps_db/app/interactive_app_base.h"
+
+namespace gs {
+// Samples the multi-hop neighborhoods of a batch of seed vertices, as GNN
+// training does: each vertex of a hop keeps up to fanout of its neighbors,
+// chosen uniformly or in proportion to a numeric edge property, over the
+// edges of every triplet of its label in the direction asked for, and the
+// distinct neighbors sampled are the vertices of the next hop. The vertices
+// of a hop are sampled in parallel, each with a random sequence of its own,
+// so that a batch samples the same neighbors whatever the thread count.
+//
+// The sampled edges are returned hop by hop and, within a hop, grouped by
+// source in the order of the vertices of the hop, so that each hop is a CSR
+// block the client slices by source.
+class NeighborSampling
+    : public CypherReadAppBase<std::string, std::string, std::string,
+                               std::string, std::string> {
+ public:
+  NeighborSampling() {}
+  results::CollectiveResults Query(const GraphDBSession& sess,
+                                   std::string label_name, std::string seeds,
+                                   std::string fanouts, std::string direction,
+                                   std::string weight_property) override;
+};
+
+class NeighborSamplingFactory : public AppFactoryBase {
+ public:
+  NeighborSamplingFactory() = default;
+  ~NeighborSamplingFactory() = default;
+
+  AppWrapper CreateApp(const GraphDB& db) override;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_NEIGHBOR_SAMPLING_H_
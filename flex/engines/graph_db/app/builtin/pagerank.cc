@@ -13,8 +13,13 @@
  * limitations under the License.
  */
 #include "flex/engines/graph_db/app/builtin/pagerank.h"
+
+#include <algorithm>
+#include <functional>
+
 #include "flex/engines/graph_db/runtime/common/graph_interface.h"
 #include "flex/engines/graph_db/runtime/common/rt_any.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 
 namespace gs {
 
@@ -84,137 +89,161 @@ results::CollectiveResults PageRank::Query(
       sess.schema().get_vertex_label_id(dst_vertex_label);
   auto edge_label_id = sess.schema().get_edge_label_id(edge_label);
 
-  auto num_src_vertices = txn.GetVertexNum(src_vertex_label_id);
-  auto num_dst_vertices = txn.GetVertexNum(dst_vertex_label_id);
-  auto num_vertices = src_vertex_label_id == dst_vertex_label_id
-                          ? num_src_vertices
-                          : num_src_vertices + num_dst_vertices;
-
-  std::vector<std::vector<double>> pagerank;
-  std::vector<std::vector<double>> new_pagerank;
-  std::vector<std::vector<int32_t>> outdegree;
-
-  bool dst_to_src = src_vertex_label_id != dst_vertex_label_id &&
+  // The vertices of both labels are numbered in one range, the src vertices
+  // first, so that the scores and degrees are flat arrays.
+  bool same_label = src_vertex_label_id == dst_vertex_label_id;
+  size_t num_src_vertices = txn.GetVertexNum(src_vertex_label_id);
+  size_t num_dst_vertices =
+      same_label ? 0 : txn.GetVertexNum(dst_vertex_label_id);
+  size_t num_vertices = num_src_vertices + num_dst_vertices;
+  if (num_vertices == 0) {
+    txn.Commit();
+    return {};
+  }
+  bool dst_to_src = !same_label &&
                     txn.schema().exist(dst_vertex_label_id, src_vertex_label_id,
                                        edge_label_id);
 
-  pagerank.emplace_back(std::vector<double>(num_src_vertices, 0.0));
-  new_pagerank.emplace_back(std::vector<double>(num_src_vertices, 0.0));
-  outdegree.emplace_back(std::vector<int32_t>(num_src_vertices, 0));
-  if (dst_to_src) {
-    pagerank.emplace_back(std::vector<double>(num_dst_vertices, 0.0));
-    new_pagerank.emplace_back(std::vector<double>(num_dst_vertices, 0.0));
-    outdegree.emplace_back(std::vector<int32_t>(num_dst_vertices, 0));
-  }
-
-  auto src_vertex_iter = txn.GetVertexIterator(src_vertex_label_id);
+  auto& pool = runtime::MorselPool::get();
+  size_t range_num = pool.Enabled(num_vertices)
+                         ? pool.MorselNum(num_vertices)
+                         : 1;
+  auto parallel_ranges = [&](const std::function<void(size_t, size_t,
+                                                      size_t)>& fn) {
+    pool.Run(range_num, [&](size_t i) {
+      fn(i, num_vertices * i / range_num, num_vertices * (i + 1) / range_num);
+    });
+  };
 
-  while (src_vertex_iter.IsValid()) {
-    vid_t vid = src_vertex_iter.GetIndex();
-    pagerank[0][vid] = 1.0 / num_vertices;
-    new_pagerank[0][vid] = 0.0;
-    src_vertex_iter.Next();
-    outdegree[0][vid] = txn.GetOutDegree(src_vertex_label_id, vid,
-                                         dst_vertex_label_id, edge_label_id);
-  }
-  if (dst_to_src) {
-    auto dst_vertex_iter = txn.GetVertexIterator(dst_vertex_label_id);
-    while (dst_vertex_iter.IsValid()) {
-      vid_t vid = dst_vertex_iter.GetIndex();
-      pagerank[1][vid] = 1.0 / num_vertices;
-      new_pagerank[1][vid] = 0.0;
-      dst_vertex_iter.Next();
-      outdegree[1][vid] = txn.GetOutDegree(
-          dst_vertex_label_id, src_vertex_label_id, vid, edge_label_id);
-    }
-  }
-
-  for (int iter = 0; iter < max_iterations; ++iter) {
-    new_pagerank[0].assign(num_src_vertices, 0.0);
-    if (dst_to_src) {
-      new_pagerank[1].assign(num_dst_vertices, 0.0);
+  // Each vertex pulls from the sources of its in-edges: the src vertices
+  // along src -> dst, and the dst vertices along dst -> src if it exists.
+  auto for_each_in_edge = [&](size_t v, auto&& fn) {
+    if (v < num_src_vertices) {
+      label_t nbr_label = same_label ? src_vertex_label_id
+                                     : dst_vertex_label_id;
+      if (!same_label && !dst_to_src) {
+        return;
+      }
+      auto edges = txn.GetInEdgeIterator(src_vertex_label_id, v, nbr_label,
+                                         edge_label_id);
+      size_t nbr_offset = same_label ? 0 : num_src_vertices;
+      for (; edges.IsValid(); edges.Next()) {
+        fn(nbr_offset + edges.GetNeighbor());
+      }
+    } else {
+      auto edges =
+          txn.GetInEdgeIterator(dst_vertex_label_id, v - num_src_vertices,
+                                src_vertex_label_id, edge_label_id);
+      for (; edges.IsValid(); edges.Next()) {
+        fn(edges.GetNeighbor());
+      }
     }
+  };
 
-    auto src_vertex_iter = txn.GetVertexIterator(src_vertex_label_id);
-    while (src_vertex_iter.IsValid()) {
-      vid_t v = src_vertex_iter.GetIndex();
-
-      double sum = 0.0;
-      {
-        auto edges = txn.GetInEdgeIterator(dst_vertex_label_id, v,
-                                           src_vertex_label_id, edge_label_id);
-        while (edges.IsValid()) {
-          auto neighbor = edges.GetNeighbor();
-          sum += pagerank[0][neighbor] / outdegree[0][neighbor];
-          edges.Next();
-        }
+  // The in-edges are copied once into a CSR of vertex indices, and the out
+  // degrees into their inverses, so that an iteration is a loop over flat
+  // arrays instead of edge iterators.
+  std::vector<size_t> offsets(num_vertices + 1, 0);
+  std::vector<double> inv_outdegree(num_vertices, 0.0);
+  parallel_ranges([&](size_t, size_t begin, size_t end) {
+    for (size_t v = begin; v < end; ++v) {
+      size_t outdegree = 0;
+      if (v < num_src_vertices) {
+        outdegree = txn.GetOutDegree(src_vertex_label_id, v,
+                                     dst_vertex_label_id, edge_label_id);
+      } else if (dst_to_src) {
+        outdegree =
+            txn.GetOutDegree(dst_vertex_label_id, v - num_src_vertices,
+                             src_vertex_label_id, edge_label_id);
       }
-
-      new_pagerank[0][v] =
-          damping_factor * sum + (1.0 - damping_factor) / num_vertices;
-      src_vertex_iter.Next();
+      inv_outdegree[v] = outdegree == 0 ? 0.0 : 1.0 / outdegree;
+      size_t indegree = 0;
+      for_each_in_edge(v, [&](size_t) { ++indegree; });
+      offsets[v + 1] = indegree;
+    }
+  });
+  for (size_t v = 0; v < num_vertices; ++v) {
+    offsets[v + 1] += offsets[v];
+  }
+  std::vector<vid_t> in_neighbors(offsets[num_vertices]);
+  parallel_ranges([&](size_t, size_t begin, size_t end) {
+    for (size_t v = begin; v < end; ++v) {
+      size_t pos = offsets[v];
+      for_each_in_edge(v, [&](size_t u) { in_neighbors[pos++] = u; });
     }
+  });
 
-    if (dst_to_src) {
-      auto dst_vertex_iter = txn.GetVertexIterator(dst_vertex_label_id);
-      while (dst_vertex_iter.IsValid()) {
-        vid_t v = dst_vertex_iter.GetIndex();
+  std::vector<double> pagerank(num_vertices, 1.0 / num_vertices);
+  std::vector<double> new_pagerank(num_vertices, 0.0);
+  std::vector<double> contribution(num_vertices, 0.0);
+  std::vector<double> range_diff(range_num, 0.0);
+  double base = (1.0 - damping_factor) / num_vertices;
 
+  for (int iter = 0; iter < max_iterations; ++iter) {
+    parallel_ranges([&](size_t, size_t begin, size_t end) {
+      for (size_t v = begin; v < end; ++v) {
+        contribution[v] = pagerank[v] * inv_outdegree[v];
+      }
+    });
+    parallel_ranges([&](size_t i, size_t begin, size_t end) {
+      const vid_t* nbrs = in_neighbors.data();
+      double diff = 0.0;
+      for (size_t v = begin; v < end; ++v) {
         double sum = 0.0;
-        {
-          auto edges = txn.GetInEdgeIterator(
-              src_vertex_label_id, v, dst_vertex_label_id, edge_label_id);
-          while (edges.IsValid()) {
-            LOG(INFO) << "got edge, from " << edges.GetNeighbor() << " to " << v
-                      << " label: " << std::to_string(src_vertex_label_id)
-                      << " " << std::to_string(dst_vertex_label_id) << " "
-                      << std::to_string(edge_label_id);
-            auto neighbor = edges.GetNeighbor();
-            sum += pagerank[1][neighbor] / outdegree[1][neighbor];
-            edges.Next();
-          }
+        for (size_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+          sum += contribution[nbrs[j]];
         }
-
-        new_pagerank[1][v] =
-            damping_factor * sum + (1.0 - damping_factor) / num_vertices;
-        dst_vertex_iter.Next();
+        double score = base + damping_factor * sum;
+        new_pagerank[v] = score;
+        diff += std::abs(score - pagerank[v]);
       }
-    }
+      range_diff[i] = diff;
+    });
+    std::swap(pagerank, new_pagerank);
 
     double diff = 0.0;
-    for (size_t j = 0; j < new_pagerank[0].size(); ++j) {
-      diff += std::abs(new_pagerank[0][j] - pagerank[0][j]);
-    }
-    if (dst_to_src) {
-      for (size_t j = 0; j < new_pagerank[1].size(); ++j) {
-        diff += std::abs(new_pagerank[1][j] - pagerank[1][j]);
-      }
+    for (auto d : range_diff) {
+      diff += d;
     }
-
     if (diff < epsilon) {
+      VLOG(10) << "PageRank converged after " << iter + 1 << " iterations";
       break;
     }
+  }
 
-    std::swap(pagerank, new_pagerank);
+  // Only the result_limit highest scores are kept, in a min-heap.
+  size_t k = result_limit <= 0
+                 ? 0
+                 : std::min(num_vertices, static_cast<size_t>(result_limit));
+  auto greater = [&](size_t a, size_t b) {
+    return pagerank[a] > pagerank[b] || (pagerank[a] == pagerank[b] && a < b);
+  };
+  std::vector<size_t> top;
+  top.reserve(k + 1);
+  for (size_t v = 0; v < num_vertices; ++v) {
+    if (top.size() < k) {
+      top.push_back(v);
+      std::push_heap(top.begin(), top.end(), greater);
+    } else if (k > 0 && greater(v, top.front())) {
+      std::pop_heap(top.begin(), top.end(), greater);
+      top.back() = v;
+      std::push_heap(top.begin(), top.end(), greater);
+    }
   }
+  std::sort_heap(top.begin(), top.end(), greater);
 
   results::CollectiveResults results;
 
-  std::vector<std::tuple<label_t, vid_t, double>> final_pagerank(num_vertices);
-  for (size_t i = 0; i < pagerank[0].size(); ++i) {
-    final_pagerank[i] = std::make_tuple(src_vertex_label_id, i, pagerank[0][i]);
-  }
-  if (dst_to_src) {
-    for (size_t i = 0; i < pagerank[1].size(); ++i) {
-      final_pagerank[i + num_src_vertices] =
-          std::make_tuple(dst_vertex_label_id, i, pagerank[1][i]);
+  std::vector<std::tuple<label_t, vid_t, double>> final_pagerank;
+  final_pagerank.reserve(top.size());
+  for (auto v : top) {
+    if (v < num_src_vertices) {
+      final_pagerank.emplace_back(src_vertex_label_id, v, pagerank[v]);
+    } else {
+      final_pagerank.emplace_back(dst_vertex_label_id, v - num_src_vertices,
+                                  pagerank[v]);
     }
   }
-  std::sort(final_pagerank.begin(), final_pagerank.end(),
-            [](const std::tuple<label_t, vid_t, double>& a,
-               const std::tuple<label_t, vid_t, double>& b) {
-              return std::get<2>(a) > std::get<2>(b);
-            });
 
   write_result(txn, results, final_pagerank, result_limit);
 
@@ -0,0 +1,284 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/app/builtin/random_walk.h"
+
+#include <stdio.h>
+
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+
+namespace gs {
+
+namespace {
+
+// The alias tables of the neighbor lists of a weighted csr, by Vose's
+// method, so that a weighted step takes constant time: slot i of a list is
+// kept with probability prob[i], and gives way to alias[i] otherwise.
+class AliasTables {
+ public:
+  void Build(const UndirectedCsr& csr) {
+    size_t edge_num = csr.edge_num();
+    prob_.resize(edge_num);
+    alias_.resize(edge_num);
+    vid_t vertex_num = csr.vertex_num();
+    builtin_parallel_ranges(
+        vertex_num, builtin_range_num(vertex_num),
+        [&](size_t, size_t begin, size_t end) {
+          std::vector<uint32_t> small, large;
+          std::vector<double> scaled;
+          for (size_t v = begin; v < end; ++v) {
+            size_t deg = csr.degree(v);
+            size_t offset = csr.begin(v) - csr.begin(0);
+            const double* weights = csr.weights(v);
+            double sum = 0;
+            for (size_t i = 0; i < deg; ++i) {
+              sum += std::max(weights[i], 0.0);
+            }
+            scaled.resize(deg);
+            small.clear();
+            large.clear();
+            for (uint32_t i = 0; i < deg; ++i) {
+              scaled[i] = sum > 0 ? std::max(weights[i], 0.0) * deg / sum : 1;
+              (scaled[i] < 1 ? small : large).push_back(i);
+            }
+            while (!small.empty() && !large.empty()) {
+              uint32_t s = small.back(), l = large.back();
+              small.pop_back();
+              prob_[offset + s] = scaled[s];
+              alias_[offset + s] = l;
+              scaled[l] -= 1 - scaled[s];
+              if (scaled[l] < 1) {
+                large.pop_back();
+                small.push_back(l);
+              }
+            }
+            // The rest are 1 up to rounding.
+            for (uint32_t i : small) {
+              prob_[offset + i] = 1;
+            }
+            for (uint32_t i : large) {
+              prob_[offset + i] = 1;
+            }
+          }
+        });
+  }
+
+  // The index of a neighbor in the list at offset, of deg neighbors.
+  size_t Sample(size_t offset, size_t deg, SplitMix64& rng) const {
+    size_t i = rng.next() % deg;
+    return rng.uniform() < prob_[offset + i] ? i : alias_[offset + i];
+  }
+
+ private:
+  std::vector<double> prob_;
+  std::vector<uint32_t> alias_;
+};
+
+class Walker {
+ public:
+  Walker(const UndirectedCsr& csr, const AliasTables* alias, double p,
+         double q)
+      : csr_(csr), alias_(alias), p_(p), q_(q) {
+    second_order_ = p != 1 || q != 1;
+    max_bias_ = std::max({1 / p, 1.0, 1 / q});
+  }
+
+  // Appends the walk from start to walk.
+  void Walk(vid_t start, size_t length, SplitMix64& rng,
+            std::vector<vid_t>& walk) const {
+    walk.clear();
+    walk.push_back(start);
+    while (walk.size() < length) {
+      vid_t v = walk.back();
+      if (csr_.degree(v) == 0) {
+        return;
+      }
+      if (!second_order_ || walk.size() == 1) {
+        walk.push_back(step(v, rng));
+        continue;
+      }
+      vid_t t = walk[walk.size() - 2];
+      while (true) {
+        vid_t x = step(v, rng);
+        double bias = x == t ? 1 / p_ : csr_.has_edge(t, x) ? 1.0 : 1 / q_;
+        if (rng.uniform() * max_bias_ < bias) {
+          walk.push_back(x);
+          break;
+        }
+      }
+    }
+  }
+
+ private:
+  // A neighbor of v, by the first order transition.
+  vid_t step(vid_t v, SplitMix64& rng) const {
+    size_t deg = csr_.degree(v);
+    size_t i = alias_ != nullptr
+                   ? alias_->Sample(csr_.begin(v) - csr_.begin(0), deg, rng)
+                   : rng.next() % deg;
+    return csr_.begin(v)[i];
+  }
+
+  const UndirectedCsr& csr_;
+  const AliasTables* alias_;
+  double p_, q_;
+  bool second_order_;
+  double max_bias_;
+};
+
+// Walks are written out in blocks of about this many bytes.
+constexpr size_t kFlushSize = 1 << 20;
+
+void add_str(results::Results* result, int id, const std::string& str) {
+  auto col = result->mutable_record()->add_columns();
+  col->mutable_name_or_id()->set_id(id);
+  col->mutable_entry()->mutable_element()->mutable_object()->set_str(str);
+}
+
+}  // namespace
+
+results::CollectiveResults RandomWalk::Query(
+    const GraphDBSession& sess, std::string vertex_label,
+    std::string edge_label, int32_t walk_length, int32_t walks_per_vertex,
+    double p, double q, std::string weight_property, std::string output_path) {
+  auto txn = sess.GetReadTransaction();
+  const auto& schema = txn.schema();
+  if (!schema.has_vertex_label(vertex_label)) {
+    LOG(ERROR) << "The requested vertex label doesn't exits.";
+    return {};
+  }
+  if (!schema.has_edge_label(vertex_label, vertex_label, edge_label)) {
+    LOG(ERROR) << "The requested edge label doesn't exits.";
+    return {};
+  }
+  if (walk_length <= 0 || walks_per_vertex <= 0 || !(p > 0) || !(q > 0)) {
+    LOG(ERROR) << "walk_length, walks_per_vertex, p and q must be positive.";
+    return {};
+  }
+  label_t vertex_label_id = schema.get_vertex_label_id(vertex_label);
+  label_t edge_label_id = schema.get_edge_label_id(edge_label);
+  int weight_idx = -1;
+  if (!weight_property.empty()) {
+    const auto& names = schema.get_edge_property_names(
+        vertex_label_id, vertex_label_id, edge_label_id);
+    auto iter = std::find(names.begin(), names.end(), weight_property);
+    if (iter == names.end()) {
+      LOG(ERROR) << "The requested weight property doesn't exits.";
+      return {};
+    }
+    weight_idx = iter - names.begin();
+  }
+
+  UndirectedCsr csr;
+  csr.Build(txn, vertex_label_id, edge_label_id, weight_idx);
+  AliasTables alias;
+  if (csr.weighted()) {
+    alias.Build(csr);
+  }
+  Walker walker(csr, csr.weighted() ? &alias : nullptr, p, q);
+  vid_t vertex_num = csr.vertex_num();
+  std::vector<std::string> oids(vertex_num);
+  builtin_parallel_ranges(vertex_num, builtin_range_num(vertex_num),
+                          [&](size_t, size_t begin, size_t end) {
+                            for (size_t v = begin; v < end; ++v) {
+                              oids[v] = txn.GetVertexId(vertex_label_id, v)
+                                            .to_string();
+                            }
+                          });
+
+  // Walk w starts from vertex w % vertex_num, so that each round of walks
+  // covers every vertex once.
+  size_t walk_num = static_cast<size_t>(vertex_num) * walks_per_vertex;
+  size_t range_num = builtin_range_num(walk_num);
+  std::vector<std::string> range_walks(range_num);
+  std::vector<std::string> paths(range_num);
+  std::vector<size_t> range_walk_nums(range_num, 0);
+  std::vector<uint8_t> failed(range_num, 0);
+  builtin_parallel_ranges(
+      walk_num, range_num, [&](size_t i, size_t begin, size_t end) {
+        FILE* fout = nullptr;
+        if (!output_path.empty()) {
+          paths[i] = output_path + "." + std::to_string(i);
+          fout = fopen(paths[i].c_str(), "w");
+          if (fout == nullptr) {
+            failed[i] = true;
+            return;
+          }
+        }
+        auto& buf = range_walks[i];
+        std::vector<vid_t> walk;
+        for (size_t w = begin; w < end; ++w) {
+          SplitMix64 rng(w);
+          walker.Walk(w % vertex_num, walk_length, rng, walk);
+          for (size_t j = 0; j < walk.size(); ++j) {
+            if (j > 0) {
+              buf.push_back(' ');
+            }
+            buf.append(oids[walk[j]]);
+          }
+          buf.push_back('\n');
+          if (fout != nullptr && buf.size() >= kFlushSize) {
+            failed[i] = failed[i] ||
+                        fwrite(buf.data(), 1, buf.size(), fout) != buf.size();
+            buf.clear();
+          }
+        }
+        range_walk_nums[i] = end - begin;
+        if (fout != nullptr) {
+          failed[i] = failed[i] ||
+                      fwrite(buf.data(), 1, buf.size(), fout) != buf.size();
+          buf.clear();
+          failed[i] = fclose(fout) != 0 || failed[i];
+        }
+      });
+
+  results::CollectiveResults results;
+  for (size_t i = 0; i < range_num; ++i) {
+    if (failed[i]) {
+      LOG(ERROR) << "Failed to write the walks to " << paths[i];
+      return {};
+    }
+  }
+  auto add_row = [&](const std::string& walk, int64_t num) {
+    auto result = results.add_results();
+    add_str(result, 0, walk);
+    auto num_col = result->mutable_record()->add_columns();
+    num_col->mutable_name_or_id()->set_id(1);
+    num_col->mutable_entry()->mutable_element()->mutable_object()->set_i64(
+        num);
+  };
+  if (!output_path.empty()) {
+    for (size_t i = 0; i < range_num; ++i) {
+      add_row(paths[i], range_walk_nums[i]);
+    }
+  } else {
+    for (auto& walks : range_walks) {
+      size_t start = 0;
+      while (start < walks.size()) {
+        size_t end = walks.find('\n', start);
+        add_row(walks.substr(start, end - start), 1);
+        start = end + 1;
+      }
+    }
+  }
+
+  txn.Commit();
+  return results;
+}
+
+AppWrapper RandomWalkFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new RandomWalk(), NULL);
+}
+}  // namespace gs
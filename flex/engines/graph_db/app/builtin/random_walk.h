@@ -0,0 +1,60 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_RANDOM_WALK_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_RANDOM_WALK_H_
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/hqps_db/app/interactive_app_base.h"
+
+namespace gs {
+// Generates random walks over the edges of edge_label between the vertices
+// of vertex_label, taken as undirected, for DeepWalk and node2vec
+// embeddings: walks_per_vertex walks of walk_length vertices from every
+// vertex. A step picks a neighbor uniformly, or in proportion to the weight
+// property of the edges with an alias table; with p or q other than 1, it is
+// biased as in node2vec by rejection sampling, and a neighbor x of v, coming
+// from t, is kept with probability 1 / p if x is t, 1 if x is a neighbor of
+// t and 1 / q otherwise, over the largest of them. A walk ends early at a
+// vertex without neighbors.
+//
+// The walks run in parallel, each with a random sequence of its own, and
+// are returned one per row as space separated oids. With an output_path,
+// each range of walks streams its walks to a file of its own,
+// output_path.<i>, one per line, and the rows are the files with their walk
+// counts instead.
+class RandomWalk
+    : public CypherReadAppBase<std::string, std::string, int32_t, int32_t,
+                               double, double, std::string, std::string> {
+ public:
+  RandomWalk() {}
+  results::CollectiveResults Query(const GraphDBSession& sess,
+                                   std::string vertex_label,
+                                   std::string edge_label, int32_t walk_length,
+                                   int32_t walks_per_vertex, double p,
+                                   double q, std::string weight_property,
+                                   std::string output_path) override;
+};
+
+class RandomWalkFactory : public AppFactoryBase {
+ public:
+  RandomWalkFactory() = default;
+  ~RandomWalkFactory() = default;
+
+  AppWrapper CreateApp(const GraphDB& db) override;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_RANDOM_WALK_H_
@@ -0,0 +1,118 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "flex/engines/graph_db/app/builtin/triangle_count.h"
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+
+namespace gs {
+
+results::CollectiveResults TriangleCount::Query(const GraphDBSession& sess,
+                                                std::string vertex_label,
+                                                std::string edge_label) {
+  auto txn = sess.GetReadTransaction();
+  const auto& schema = txn.schema();
+  if (!schema.has_vertex_label(vertex_label)) {
+    LOG(ERROR) << "The requested vertex label doesn't exits.";
+    return {};
+  }
+  if (!schema.has_edge_label(vertex_label, vertex_label, edge_label)) {
+    LOG(ERROR) << "The requested edge label doesn't exits.";
+    return {};
+  }
+  UndirectedCsr csr;
+  csr.Build(txn, schema.get_vertex_label_id(vertex_label),
+            schema.get_edge_label_id(edge_label));
+  txn.Commit();
+
+  vid_t vertex_num = csr.vertex_num();
+  auto higher = [&](vid_t u, vid_t v) {
+    size_t du = csr.degree(u), dv = csr.degree(v);
+    return dv > du || (dv == du && v > u);
+  };
+  // The neighbors of a higher rank, still sorted by index.
+  std::vector<size_t> offsets(vertex_num + 1, 0);
+  size_t range_num = builtin_range_num(vertex_num);
+  builtin_parallel_ranges(vertex_num, range_num,
+                          [&](size_t, size_t begin, size_t end) {
+                            for (size_t u = begin; u < end; ++u) {
+                              size_t num = 0;
+                              for (auto p = csr.begin(u); p != csr.end(u);
+                                   ++p) {
+                                num += higher(u, *p);
+                              }
+                              offsets[u + 1] = num;
+                            }
+                          });
+  for (vid_t u = 0; u < vertex_num; ++u) {
+    offsets[u + 1] += offsets[u];
+  }
+  std::vector<vid_t> oriented(offsets[vertex_num]);
+  builtin_parallel_ranges(vertex_num, range_num,
+                          [&](size_t, size_t begin, size_t end) {
+                            for (size_t u = begin; u < end; ++u) {
+                              size_t pos = offsets[u];
+                              for (auto p = csr.begin(u); p != csr.end(u);
+                                   ++p) {
+                                if (higher(u, *p)) {
+                                  oriented[pos++] = *p;
+                                }
+                              }
+                            }
+                          });
+
+  std::vector<uint64_t> range_counts(range_num, 0);
+  builtin_parallel_ranges(
+      vertex_num, range_num, [&](size_t i, size_t begin, size_t end) {
+        const vid_t* adj = oriented.data();
+        uint64_t count = 0;
+        for (size_t u = begin; u < end; ++u) {
+          for (size_t j = offsets[u]; j < offsets[u + 1]; ++j) {
+            vid_t v = adj[j];
+            size_t a = offsets[u], a_end = offsets[u + 1];
+            size_t b = offsets[v], b_end = offsets[v + 1];
+            while (a < a_end && b < b_end) {
+              if (adj[a] < adj[b]) {
+                ++a;
+              } else if (adj[b] < adj[a]) {
+                ++b;
+              } else {
+                ++count;
+                ++a;
+                ++b;
+              }
+            }
+          }
+        }
+        range_counts[i] = count;
+      });
+  uint64_t count = 0;
+  for (auto c : range_counts) {
+    count += c;
+  }
+
+  results::CollectiveResults results;
+  results.add_results()
+      ->mutable_record()
+      ->add_columns()
+      ->mutable_entry()
+      ->mutable_element()
+      ->mutable_object()
+      ->set_i64(count);
+  return results;
+}
+
+AppWrapper TriangleCountFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new TriangleCount(), NULL);
+}
+}  // namespace gs
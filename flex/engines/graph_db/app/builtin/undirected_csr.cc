@@ -0,0 +1,143 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+
+namespace gs {
+
+size_t builtin_range_num(size_t num) {
+  auto& pool = runtime::MorselPool::get();
+  return pool.Enabled(num) ? pool.MorselNum(num) : 1;
+}
+
+void builtin_parallel_ranges(
+    size_t num, size_t range_num,
+    const std::function<void(size_t, size_t, size_t)>& func) {
+  runtime::MorselPool::get().Run(range_num, [&](size_t i) {
+    func(i, num * i / range_num, num * (i + 1) / range_num);
+  });
+}
+
+bool builtin_as_double(const Any& value, double& ret) {
+  if (value.type == PropertyType::kDouble) {
+    ret = value.AsDouble();
+  } else if (value.type == PropertyType::kFloat) {
+    ret = value.AsFloat();
+  } else if (value.type == PropertyType::kInt64) {
+    ret = value.AsInt64();
+  } else if (value.type == PropertyType::kInt32) {
+    ret = value.AsInt32();
+  } else if (value.type == PropertyType::kUInt64) {
+    ret = value.AsUInt64();
+  } else if (value.type == PropertyType::kUInt32) {
+    ret = value.AsUInt32();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void UndirectedCsr::Build(const ReadTransaction& txn, label_t vertex_label,
+                          label_t edge_label, int weight_idx) {
+  vertex_num_ = txn.GetVertexNum(vertex_label);
+  offsets_.assign(vertex_num_ + 1, 0);
+  bool has_edges = txn.schema().exist(vertex_label, vertex_label, edge_label);
+  bool weighted = weight_idx >= 0;
+  size_t range_num = builtin_range_num(vertex_num_);
+  // Each range collects the neighbor lists of its vertices, which are then
+  // copied at their offsets.
+  std::vector<std::vector<vid_t>> range_neighbors(range_num);
+  std::vector<std::vector<double>> range_weights(range_num);
+  builtin_parallel_ranges(
+      vertex_num_, range_num, [&](size_t i, size_t begin, size_t end) {
+        if (!has_edges) {
+          return;
+        }
+        auto& out = range_neighbors[i];
+        auto& out_weights = range_weights[i];
+        std::vector<std::pair<vid_t, double>> nbrs;
+        for (size_t v = begin; v < end; ++v) {
+          size_t start = out.size();
+          nbrs.clear();
+          auto add = [&](const ReadTransaction::edge_iterator& edges) {
+            vid_t u = edges.GetNeighbor();
+            if (u == v) {
+              return;
+            }
+            double weight = 1;
+            if (weighted) {
+              Any data = edges.GetData();
+              if (data.type == PropertyType::kRecordView) {
+                data = data.value.record_view[weight_idx];
+              }
+              builtin_as_double(data, weight);
+            }
+            nbrs.emplace_back(u, weight);
+          };
+          for (auto edges = txn.GetOutEdgeIterator(vertex_label, v,
+                                                   vertex_label, edge_label);
+               edges.IsValid(); edges.Next()) {
+            add(edges);
+          }
+          for (auto edges = txn.GetInEdgeIterator(vertex_label, v,
+                                                  vertex_label, edge_label);
+               edges.IsValid(); edges.Next()) {
+            add(edges);
+          }
+          std::sort(nbrs.begin(), nbrs.end());
+          for (auto& [u, weight] : nbrs) {
+            if (out.size() > start && out.back() == u) {
+              if (weighted) {
+                out_weights.back() += weight;
+              }
+              continue;
+            }
+            out.push_back(u);
+            if (weighted) {
+              out_weights.push_back(weight);
+            }
+          }
+          offsets_[v + 1] = out.size() - start;
+        }
+      });
+  for (vid_t v = 0; v < vertex_num_; ++v) {
+    offsets_[v + 1] += offsets_[v];
+  }
+  neighbors_.resize(offsets_[vertex_num_]);
+  weights_.clear();
+  if (weighted) {
+    weights_.resize(offsets_[vertex_num_]);
+  }
+  builtin_parallel_ranges(
+      vertex_num_, range_num, [&](size_t i, size_t begin, size_t) {
+        const auto& in = range_neighbors[i];
+        if (!in.empty()) {
+          memcpy(neighbors_.data() + offsets_[begin], in.data(),
+                 in.size() * sizeof(vid_t));
+        }
+        const auto& in_weights = range_weights[i];
+        if (!in_weights.empty()) {
+          memcpy(weights_.data() + offsets_[begin], in_weights.data(),
+                 in_weights.size() * sizeof(double));
+        }
+      });
+}
+
+}  // namespace gs
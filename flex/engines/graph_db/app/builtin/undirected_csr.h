@@ -0,0 +1,102 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_UNDIRECTED_CSR_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_UNDIRECTED_CSR_H_
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "flex/engines/graph_db/database/read_transaction.h"
+
+namespace gs {
+
+// Splits [0, num) into ranges for the morsel pool, one if it is disabled.
+size_t builtin_range_num(size_t num);
+
+// Calls func(i, begin, end) on the i-th of range_num ranges of [0, num), on
+// the morsel pool.
+void builtin_parallel_ranges(
+    size_t num, size_t range_num,
+    const std::function<void(size_t, size_t, size_t)>& func);
+
+// Sets ret to a numeric property value, or returns false if value is not
+// one.
+bool builtin_as_double(const Any& value, double& ret);
+
+// splitmix64, a generator cheap enough to be seeded for every vertex or
+// walk, so that the samples of a builtin do not depend on the thread count.
+struct SplitMix64 {
+  explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // A double in [0, 1).
+  double uniform() { return (next() >> 11) * (1.0 / (1ULL << 53)); }
+
+  uint64_t state;
+};
+
+// The edges of edge_label between the vertices of vertex_label, in both
+// directions, as sorted neighbor lists without duplicates or self loops.
+// It is copied out of the snapshot of the transaction once, so that the
+// iterations of the graph algorithms loop over flat arrays.
+//
+// With a weight_idx, the index of a numeric property of the edges, each
+// neighbor also gets a weight, the sum of those of its edges.
+class UndirectedCsr {
+ public:
+  void Build(const ReadTransaction& txn, label_t vertex_label,
+             label_t edge_label, int weight_idx = -1);
+
+  vid_t vertex_num() const { return vertex_num_; }
+
+  size_t edge_num() const { return neighbors_.size(); }
+
+  size_t degree(vid_t v) const { return offsets_[v + 1] - offsets_[v]; }
+
+  const vid_t* begin(vid_t v) const { return neighbors_.data() + offsets_[v]; }
+
+  const vid_t* end(vid_t v) const {
+    return neighbors_.data() + offsets_[v + 1];
+  }
+
+  bool weighted() const { return !weights_.empty(); }
+
+  // The weights of the neighbors of v, if weighted.
+  const double* weights(vid_t v) const {
+    return weights_.data() + offsets_[v];
+  }
+
+  bool has_edge(vid_t u, vid_t v) const {
+    return std::binary_search(begin(u), end(u), v);
+  }
+
+ private:
+  vid_t vertex_num_ = 0;
+  std::vector<size_t> offsets_;
+  std::vector<vid_t> neighbors_;
+  std::vector<double> weights_;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_UNDIRECTED_CSR_H_
@@ -0,0 +1,121 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/app/builtin/vector_search.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+namespace {
+
+// Sets entries to the k vertices of the label nearest to the embedding, or
+// returns an error message.
+std::string search(const runtime::GraphReadInterface& graph,
+                   std::string_view label_name, std::string_view property_name,
+                   std::string_view embedding, int32_t k, label_t& label,
+                   std::vector<std::pair<float, vid_t>>& entries) {
+  const auto& schema = graph.schema();
+  if (k <= 0) {
+    return "k must be greater than 0.";
+  }
+  if (!schema.has_vertex_label(std::string(label_name))) {
+    return "The requested label doesn't exist.";
+  }
+  label = schema.get_vertex_label_id(std::string(label_name));
+  const auto& prop_names = schema.get_vertex_property_names(label);
+  auto iter = std::find(prop_names.begin(), prop_names.end(), property_name);
+  if (iter == prop_names.end()) {
+    return "The requested property doesn't exist.";
+  }
+  std::vector<float> query;
+  if (!VectorIndex::parse(embedding, query)) {
+    return "Failed to parse the embedding.";
+  }
+  if (!graph.SearchVectorIndex(label, iter - prop_names.begin(), query, k,
+                               entries)) {
+    return "The requested property has no vector index.";
+  }
+  return "";
+}
+
+}  // namespace
+
+results::CollectiveResults VectorSearch::Query(const GraphDBSession& sess,
+                                               std::string label_name,
+                                               std::string property_name,
+                                               std::string embedding,
+                                               int32_t k) {
+  auto txn = sess.GetReadTransaction();
+  runtime::GraphReadInterface graph(txn);
+  label_t label;
+  std::vector<std::pair<float, vid_t>> entries;
+  auto error =
+      search(graph, label_name, property_name, embedding, k, label, entries);
+  if (!error.empty()) {
+    LOG(ERROR) << error;
+    return {};
+  }
+
+  results::CollectiveResults results;
+  for (auto& [dist, vid] : entries) {
+    auto result = results.add_results();
+    runtime::RTAny oid(txn.GetVertexId(label, vid));
+    oid.sink(graph, 0, result->mutable_record()->add_columns());
+
+    auto distance_col = result->mutable_record()->add_columns();
+    distance_col->mutable_name_or_id()->set_id(1);
+    distance_col->mutable_entry()->mutable_element()->mutable_object()->set_f64(
+        dist);
+  }
+
+  txn.Commit();
+  return results;
+}
+
+bl::result<bool> VectorSearch::Query(const runtime::GraphReadInterface& graph,
+                                     runtime::ProcedureOutput& output,
+                                     std::string_view label_name,
+                                     std::string_view property_name,
+                                     std::string_view embedding, int32_t k) {
+  label_t label;
+  std::vector<std::pair<float, vid_t>> entries;
+  auto error =
+      search(graph, label_name, property_name, embedding, k, label, entries);
+  if (!error.empty()) {
+    RETURN_BAD_REQUEST_ERROR(error);
+  }
+  for (auto& [dist, vid] : entries) {
+    Any oid = graph.GetVertexId(label, vid);
+    double distance = dist;
+    if (oid.type == PropertyType::kStringView) {
+      output.Emit(oid.AsStringView(), distance);
+    } else if (oid.type == PropertyType::kInt64) {
+      output.Emit(oid.AsInt64(), distance);
+    } else if (oid.type == PropertyType::kInt32) {
+      output.Emit(oid.AsInt32(), distance);
+    } else if (oid.type == PropertyType::kUInt32) {
+      output.Emit(static_cast<int64_t>(oid.AsUInt32()), distance);
+    } else {
+      output.Emit(oid.AsUInt64(), distance);
+    }
+  }
+  return true;
+}
+
+AppWrapper VectorSearchFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new VectorSearch(), NULL);
+}
+}  // namespace gs
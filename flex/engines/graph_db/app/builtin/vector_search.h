@@ -0,0 +1,56 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_APP_BUILDIN_VECTOR_SEARCH_H_
+#define ENGINES_GRAPH_DB_APP_BUILDIN_VECTOR_SEARCH_H_
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/runtime/utils/in_process_procedure.h"
+#include "flex/engines/hqps_db/app/interactive_app_base.h"
+
+namespace gs {
+// The k vertices of a label nearest to an embedding by the vector index on
+// one of their properties, with their distances, see VectorIndex. Called
+// from a query, it runs in process, so that the vertices are expanded from
+// without a round trip.
+class VectorSearch
+    : public CypherReadAppBase<std::string, std::string, std::string,
+                               int32_t>,
+      public runtime::TypedInProcessReadProcedure<
+          std::string_view, std::string_view, std::string_view, int32_t> {
+ public:
+  VectorSearch() {}
+  results::CollectiveResults Query(const GraphDBSession& sess,
+                                   std::string label_name,
+                                   std::string property_name,
+                                   std::string embedding, int32_t k) override;
+
+  bl::result<bool> Query(const runtime::GraphReadInterface& graph,
+                         runtime::ProcedureOutput& output,
+                         std::string_view label_name,
+                         std::string_view property_name,
+                         std::string_view embedding, int32_t k) override;
+};
+
+class VectorSearchFactory : public AppFactoryBase {
+ public:
+  VectorSearchFactory() = default;
+  ~VectorSearchFactory() = default;
+
+  AppWrapper CreateApp(const GraphDB& db) override;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_APP_BUILDIN_VECTOR_SEARCH_H_
@@ -0,0 +1,128 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "flex/engines/graph_db/app/builtin/wcc.h"
+#include "flex/engines/graph_db/app/builtin/undirected_csr.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+namespace {
+
+// The root of v, halving the path to it. The parents only decrease, so
+// that a stale read of another thread still points into the same tree.
+inline vid_t find_root(std::vector<vid_t>& parent, vid_t v) {
+  vid_t p = __atomic_load_n(&parent[v], __ATOMIC_RELAXED);
+  while (p != v) {
+    vid_t gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+    if (gp != p) {
+      __atomic_store_n(&parent[v], gp, __ATOMIC_RELAXED);
+    }
+    v = p;
+    p = gp;
+  }
+  return v;
+}
+
+// Links the larger of the two roots under the smaller one, retrying if
+// another thread has linked it first.
+inline void union_roots(std::vector<vid_t>& parent, vid_t u, vid_t v) {
+  while (true) {
+    u = find_root(parent, u);
+    v = find_root(parent, v);
+    if (u == v) {
+      return;
+    }
+    if (u < v) {
+      std::swap(u, v);
+    }
+    vid_t expected = u;
+    if (__atomic_compare_exchange_n(&parent[u], &expected, v, false,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+results::CollectiveResults WCC::Query(const GraphDBSession& sess,
+                                      std::string vertex_label,
+                                      std::string edge_label) {
+  auto txn = sess.GetReadTransaction();
+  const auto& schema = txn.schema();
+  if (!schema.has_vertex_label(vertex_label)) {
+    LOG(ERROR) << "The requested vertex label doesn't exits.";
+    return {};
+  }
+  if (!schema.has_edge_label(vertex_label, vertex_label, edge_label)) {
+    LOG(ERROR) << "The requested edge label doesn't exits.";
+    return {};
+  }
+  label_t vertex_label_id = schema.get_vertex_label_id(vertex_label);
+  label_t edge_label_id = schema.get_edge_label_id(edge_label);
+  vid_t vertex_num = txn.GetVertexNum(vertex_label_id);
+
+  std::vector<vid_t> parent(vertex_num);
+  size_t range_num = builtin_range_num(vertex_num);
+  builtin_parallel_ranges(vertex_num, range_num,
+                          [&](size_t, size_t begin, size_t end) {
+                            for (size_t v = begin; v < end; ++v) {
+                              parent[v] = v;
+                            }
+                          });
+  // An edge is seen from one of its ends, the outgoing one.
+  builtin_parallel_ranges(
+      vertex_num, range_num, [&](size_t, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+          for (auto edges = txn.GetOutEdgeIterator(
+                   vertex_label_id, v, vertex_label_id, edge_label_id);
+               edges.IsValid(); edges.Next()) {
+            union_roots(parent, v, edges.GetNeighbor());
+          }
+        }
+      });
+  builtin_parallel_ranges(vertex_num, range_num,
+                          [&](size_t, size_t begin, size_t end) {
+                            for (size_t v = begin; v < end; ++v) {
+                              __atomic_store_n(&parent[v],
+                                               find_root(parent, v),
+                                               __ATOMIC_RELAXED);
+                            }
+                          });
+
+  runtime::GraphReadInterface graph(txn);
+  results::CollectiveResults results;
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    auto result = results.add_results();
+    runtime::RTAny oid(txn.GetVertexId(vertex_label_id, v));
+    oid.sink(graph, 0, result->mutable_record()->add_columns());
+    auto component_col = result->mutable_record()->add_columns();
+    component_col->mutable_name_or_id()->set_id(1);
+    component_col
+        ->mutable_entry()
+        ->mutable_element()
+        ->mutable_object()
+        ->set_i64(parent[v]);
+  }
+
+  txn.Commit();
+  return results;
+}
+
+AppWrapper WCCFactory::CreateApp(const GraphDB& db) {
+  return AppWrapper(new WCC(), NULL);
+}
+}  // namespace gs
@@ -18,6 +18,8 @@
 
 #include <sys/wait.h>  // for waitpid()
 #include <unistd.h>    // for fork() and execvp()
+#include <cctype>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -230,4 +232,141 @@ void parse_params(std::string_view sw,
   }
 }
 
+static bool is_identifier_char(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' ||
+         c == '$';
+}
+
+static char unescape(char c) {
+  switch (c) {
+  case 'n':
+    return '\n';
+  case 't':
+    return '\t';
+  case 'r':
+    return '\r';
+  default:
+    return c;
+  }
+}
+
+std::string lift_literals(std::string_view query,
+                          std::map<std::string, std::string>& params) {
+  // int64 literals have 19 digits at most, shorter ones always fit.
+  constexpr size_t kMaxIntDigits = 18;
+  std::string ret;
+  ret.reserve(query.size());
+  size_t lit_num = 0;
+  int brace_depth = 0;
+  // The last character copied that is not a space.
+  char prev = '\0';
+  size_t i = 0;
+  while (i < query.size()) {
+    char c = query[i];
+    bool liftable = prev == '=' || prev == '<' || prev == '>' ||
+                    (prev == ':' && brace_depth > 0);
+    if (c == '`') {
+      size_t end = query.find('`', i + 1);
+      end = end == std::string_view::npos ? query.size() : end + 1;
+      ret.append(query.substr(i, end - i));
+      prev = c;
+      i = end;
+    } else if (c == '\'' || c == '"') {
+      std::string value;
+      size_t j = i + 1;
+      bool closed = false;
+      for (; j < query.size(); ++j) {
+        if (query[j] == '\\' && j + 1 < query.size()) {
+          value.push_back(unescape(query[++j]));
+        } else if (query[j] == c) {
+          closed = true;
+          break;
+        } else {
+          value.push_back(query[j]);
+        }
+      }
+      size_t end = std::min(j + 1, query.size());
+      if (closed && liftable) {
+        std::string name = "__lit_s" + std::to_string(lit_num++);
+        params[name] = std::move(value);
+        ret += "$" + name;
+      } else {
+        ret.append(query.substr(i, end - i));
+      }
+      prev = c;
+      i = end;
+    } else if (std::isdigit(static_cast<unsigned char>(c)) &&
+               (ret.empty() || !is_identifier_char(ret.back()))) {
+      size_t j = i;
+      while (j < query.size() &&
+             std::isdigit(static_cast<unsigned char>(query[j]))) {
+        ++j;
+      }
+      // Floats, whose lifted parameters may be typed as integers, are kept.
+      if (liftable && j - i <= kMaxIntDigits &&
+          (j == query.size() || !is_identifier_char(query[j]))) {
+        std::string name = "__lit_i" + std::to_string(lit_num++);
+        params[name] = std::string(query.substr(i, j - i));
+        ret += "$" + name;
+      } else {
+        ret.append(query.substr(i, j - i));
+      }
+      prev = query[j - 1];
+      i = j;
+    } else {
+      if (c == '{') {
+        ++brace_depth;
+      } else if (c == '}') {
+        --brace_depth;
+      }
+      if (!std::isspace(static_cast<unsigned char>(c))) {
+        prev = c;
+      }
+      ret.push_back(c);
+      ++i;
+    }
+  }
+  return ret;
+}
+
+// Whether query continues at pos with keyword and a space.
+static bool match_keyword(const std::string& query, size_t& pos,
+                          const char* keyword) {
+  size_t len = strlen(keyword);
+  if (query.size() < pos + len + 1 ||
+      !std::isspace(static_cast<unsigned char>(query[pos + len]))) {
+    return false;
+  }
+  for (size_t i = 0; i < len; ++i) {
+    if (std::toupper(static_cast<unsigned char>(query[pos + i])) !=
+        keyword[i]) {
+      return false;
+    }
+  }
+  pos += len;
+  while (pos < query.size() &&
+         std::isspace(static_cast<unsigned char>(query[pos]))) {
+    ++pos;
+  }
+  return true;
+}
+
+bool strip_explain_analyze(std::string& query) {
+  size_t pos = 0;
+  while (pos < query.size() &&
+         std::isspace(static_cast<unsigned char>(query[pos]))) {
+    ++pos;
+  }
+  if (!match_keyword(query, pos, "PROFILE")) {
+    size_t explain = pos;
+    if (!match_keyword(query, explain, "EXPLAIN") ||
+        !match_keyword(query, explain, "ANALYZE")) {
+      return false;
+    }
+    pos = explain;
+  }
+  query.erase(0, pos);
+  return true;
+}
+
 }  // namespace gs
\ No newline at end of file
@@ -28,6 +28,18 @@ bool generate_plan(const std::string& query, const std::string& statistics,
                    physical::PhysicalPlan& plan_cache);
 void parse_params(std::string_view sw,
                   std::map<std::string, std::string>& params);
+
+// Replaces the string and integer literals that are compared with, or are
+// the property values of a map, by parameters added to params, named
+// __lit_s<i> and __lit_i<i> by kind. Queries differing only in these
+// literals then share the returned template.
+std::string lift_literals(std::string_view query,
+                          std::map<std::string, std::string>& params);
+
+// Removes a leading EXPLAIN ANALYZE or PROFILE, in any case, from query.
+// Returns whether there was one, the query then being run profiled and its
+// annotated plan returned instead of its rows.
+bool strip_explain_analyze(std::string& query);
 }  // namespace gs
 
 #endif  // ENGINES_GRAPH_DB_CYPHER_APP_UTILS_H_
\ No newline at end of file
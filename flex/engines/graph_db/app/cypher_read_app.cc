@@ -5,11 +5,26 @@
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/sink.h"
 #include "flex/engines/graph_db/runtime/execute/plan_parser.h"
 #include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
+#include "flex/engines/graph_db/runtime/utils/utils.h"
+#include "flex/utils/sampling_profiler.h"
 
 namespace gs {
 
 bool CypherReadApp::Query(const GraphDBSession& graph, Decoder& input,
                           Encoder& output) {
+  return eval(graph, input, output, nullptr);
+}
+
+bool CypherReadApp::QueryStream(const GraphDBSession& graph, Decoder& input,
+                                Encoder& output,
+                                std::unique_ptr<ResultStream>& stream) {
+  return eval(graph, input, output, &stream);
+}
+
+bool CypherReadApp::eval(const GraphDBSession& graph, Decoder& input,
+                         Encoder& output,
+                         std::unique_ptr<ResultStream>* stream) {
+  cacheable_ = false;
   std::string_view r_bytes = input.get_bytes();
   uint8_t type = static_cast<uint8_t>(r_bytes.back());
   std::string_view bytes = std::string_view(r_bytes.data(), r_bytes.size() - 1);
@@ -21,20 +36,25 @@ bool CypherReadApp::Query(const GraphDBSession& graph, Decoder& input,
     }
 
     LOG(INFO) << "plan: " << plan.DebugString();
-    auto txn = graph.GetReadTransaction();
+    std::unique_ptr<ReadTransaction> txn(
+        new ReadTransaction(graph.GetReadTransaction()));
 
-    gs::runtime::GraphReadInterface gri(txn);
+    gs::runtime::GraphReadInterface gri(*txn);
 
+    runtime::QueryArenaScope arena_scope(arena_);
+    runtime::OprTimer profile_timer;
+    profile_timer.set_profiling(runtime::OprTimer::sample_profile());
+    auto& timer = profile_timer.profiling() ? profile_timer : timer_;
     gs::runtime::Context ctx;
     gs::Status status = gs::Status::OK();
     {
       ctx = bl::try_handle_all(
-          [this, &gri, &plan]() -> bl::result<runtime::Context> {
+          [&gri, &plan, &timer]() -> bl::result<runtime::Context> {
             return runtime::PlanParser::get()
                 .parse_read_pipeline(gri.schema(), gs::runtime::ContextMeta(),
                                      plan)
                 .value()
-                .Execute(gri, runtime::Context(), {}, timer_);
+                .Execute(gri, runtime::Context(), {}, timer);
           },
           [&status](const gs::Status& err) {
             status = err;
@@ -60,7 +80,19 @@ bool CypherReadApp::Query(const GraphDBSession& graph, Decoder& input,
       output.put_string(status.ToString());
       return false;
     }
-    runtime::Sink::sink(ctx, txn, output);
+    if (profile_timer.profiling()) {
+      LOG(INFO) << "Sampled profile of adhoc plan:\n"
+                << profile_timer.explain();
+    }
+    if (stream != nullptr) {
+      // The values kept by the stream pin their chunks of the arena.
+      stream->reset(new runtime::SinkStream(std::move(txn), std::move(ctx)));
+    } else {
+      runtime::Sink::sink(ctx, *txn, output);
+    }
+    read_labels_.clear();
+    runtime::parse_read_labels(plan, read_labels_);
+    cacheable_ = true;
     return true;
   } else {
     size_t sep = bytes.find_first_of("&?");
@@ -69,48 +101,79 @@ bool CypherReadApp::Query(const GraphDBSession& graph, Decoder& input,
     std::map<std::string, std::string> params;
     parse_params(params_str, params);
     auto query = std::string(query_str.data(), query_str.size());
-    if (!pipeline_cache_.count(query)) {
-      if (plan_cache_.count(query)) {
-      } else {
-        physical::PhysicalPlan plan;
-        std::string plan_str;
+    bool explain = strip_explain_analyze(query);
+    std::map<std::string, std::string> lifted = params;
+    // The pipelines hold the column ids of the schema they were parsed with.
+    uint32_t schema_change_num = graph.graph().schema_change_num();
+    if (schema_change_num != schema_change_num_) {
+      pipeline_cache_.clear();
+      schema_change_num_ = schema_change_num;
+    }
+    std::string query_template = lift_literals(query, lifted);
+    SampleTagScope tag_scope(query_template);
+    auto pipeline = pipeline_cache_.get(query_template);
+    if (pipeline != nullptr) {
+      params.swap(lifted);
+    } else if ((pipeline = pipeline_cache_.get(query)) == nullptr) {
+      physical::PhysicalPlan plan;
+      std::string key, plan_str;
 
-        if (!gs::runtime::CypherRunnerImpl::get().gen_plan(db_, query,
-                                                           plan_str)) {
-          LOG(ERROR) << "Generate plan failed for query: " << query;
-          std::string error =
-              "    Compiler failed to generate physical plan: " + query;
-          output.put_bytes(error.data(), error.size());
+      if (!gs::runtime::CypherRunnerImpl::get().gen_plan(db_, query, params,
+                                                         key, plan_str)) {
+        LOG(ERROR) << "Generate plan failed for query: " << query;
+        std::string error =
+            "    Compiler failed to generate physical plan: " + query;
+        output.put_bytes(error.data(), error.size());
 
-          return false;
-        } else {
-          if (!plan.ParseFromString(plan_str)) {
-            LOG(ERROR) << "Parse plan failed for query: " << query;
-            return false;
-          }
-          plan_cache_[query] = std::move(plan);
-        }
+        return false;
+      }
+      if (!plan.ParseFromString(plan_str)) {
+        LOG(ERROR) << "Parse plan failed for query: " << query;
+        return false;
       }
-      const auto& plan = plan_cache_[query];
-      pipeline_cache_.emplace(
-          query, runtime::PlanParser::get()
-                     .parse_read_pipeline(db_.schema(),
-                                          gs::runtime::ContextMeta(), plan)
-                     .value());
+      pipeline = pipeline_cache_.put(
+          key, runtime::PlanParser::get()
+                   .parse_read_pipeline(db_.schema(),
+                                        gs::runtime::ContextMeta(), plan)
+                   .value());
     }
     auto txn = graph.GetReadTransaction();
+    if (graph.graph().schema_change_num() != schema_change_num_) {
+      // Changed while the pipeline was parsed, which eval retries.
+      pipeline_cache_.clear();
+      return false;
+    }
 
     gs::runtime::GraphReadInterface gri(txn);
-    auto ctx = pipeline_cache_.at(query).Execute(gri, runtime::Context(),
-                                                 params, timer_);
+    runtime::QueryArenaScope arena_scope(arena_);
+    runtime::OprTimer profile_timer;
+    profile_timer.set_profiling(explain || runtime::OprTimer::sample_profile());
+    auto ctx = pipeline->Execute(
+        gri, runtime::Context(), params,
+        profile_timer.profiling() ? profile_timer : timer_);
+    if (explain) {
+      output.put_string(profile_timer.explain());
+      return true;
+    }
+    if (profile_timer.profiling()) {
+      LOG(INFO) << "Sampled profile of query " << query << ":\n"
+                << profile_timer.explain();
+    }
     if (type == Schema::CYPHER_READ_PLUGIN_ID) {
       runtime::Sink::sink_encoder(ctx.value(), gri, output);
     } else {
       runtime::Sink::sink_beta(ctx.value(), gri, output);
     }
+    read_labels_ = pipeline->read_labels();
+    cacheable_ = true;
   }
   return true;
 }
+
+bool CypherReadApp::cached_labels(LabelSet& labels) const {
+  labels = read_labels_;
+  return cacheable_;
+}
 AppWrapper CypherReadAppFactory::CreateApp(const GraphDB& db) {
   return AppWrapper(new CypherReadApp(db), NULL);
 }
@@ -17,27 +17,54 @@
 #define ENGINES_GRAPH_DB_CYPHER_READ_APP_H_
 #include "flex/engines/graph_db/app/app_base.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_arena.h"
 #include "flex/engines/graph_db/runtime/execute/pipeline.h"
 #include "flex/proto_generated_gie/physical.pb.h"
+#include "flex/utils/lru_cache.h"
 
 namespace gs {
 class CypherReadApp : public ReadAppBase {
  public:
-  CypherReadApp(const GraphDB& db) : db_(db) {}
+  // The pipelines kept per session.
+  static constexpr size_t PIPELINE_CACHE_CAPACITY = 256;
+
+  CypherReadApp(const GraphDB& db)
+      : db_(db),
+        pipeline_cache_(PIPELINE_CACHE_CAPACITY),
+        schema_change_num_(0),
+        cacheable_(false) {}
 
   AppType type() const override { return AppType::kCypherAdhoc; }
 
   bool Query(const GraphDBSession& graph, Decoder& input,
              Encoder& output) override;
 
+  // Adhoc plans leave their rows in stream, sunk while they are sent.
+  bool QueryStream(const GraphDBSession& graph, Decoder& input,
+                   Encoder& output,
+                   std::unique_ptr<ResultStream>& stream) override;
+
+  // The labels the plan of the last query read, unless it was explained.
+  bool cached_labels(LabelSet& labels) const override;
+
   const runtime::OprTimer& timer() const { return timer_; }
   runtime::OprTimer& timer() { return timer_; }
 
  private:
+  bool eval(const GraphDBSession& graph, Decoder& input, Encoder& output,
+            std::unique_ptr<ResultStream>* stream);
+
   const GraphDB& db_;
-  std::unordered_map<std::string, physical::PhysicalPlan> plan_cache_;
-  std::unordered_map<std::string, runtime::ReadPipeline> pipeline_cache_;
+  // By query template, see lift_literals, or by query if the template does
+  // not compile.
+  LruCache<std::string, runtime::ReadPipeline> pipeline_cache_;
+  // MutablePropertyFragment::schema_change_num when the cache was valid.
+  uint32_t schema_change_num_;
   runtime::OprTimer timer_;
+  // The values of the queries of the session, recycled after each sink.
+  runtime::QueryArena arena_;
+  LabelSet read_labels_;
+  bool cacheable_;
 };
 
 class CypherReadAppFactory : public AppFactoryBase {
@@ -4,50 +4,76 @@
 
 #include "flex/engines/graph_db/runtime/execute/plan_parser.h"
 #include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
+#include "flex/utils/sampling_profiler.h"
 
 namespace gs {
 
 bool CypherWriteApp::Query(GraphDBSession& graph, Decoder& input,
                            Encoder& output) {
-  auto txn = graph.GetInsertTransaction();
   std::string_view r_bytes = input.get_bytes();
-  std::string_view bytes = std::string_view(r_bytes.data(), r_bytes.size() - 1);
+  return QueryGroup(
+      graph, {std::string_view(r_bytes.data(), r_bytes.size() - 1)});
+}
+
+bool CypherWriteApp::QueryGroup(
+    GraphDBSession& graph, const std::vector<std::string_view>& queries) {
+  auto txn = graph.GetInsertTransaction();
+  // No schema change runs along the transaction, but one may have run since
+  // the pipelines were parsed.
+  uint32_t schema_change_num = graph.graph().schema_change_num();
+  if (schema_change_num != schema_change_num_) {
+    pipeline_cache_.clear();
+    schema_change_num_ = schema_change_num;
+  }
+  gs::runtime::GraphInsertInterface gri(txn);
+  for (auto bytes : queries) {
+    SampleTagScope tag_scope(bytes.substr(0, bytes.find_first_of("&?")));
+    std::map<std::string, std::string> params;
+    auto pipeline = getPipeline(bytes, params);
+    if (pipeline == nullptr) {
+      txn.Abort();
+      return false;
+    }
+    auto ctx = pipeline->Execute(gri, runtime::WriteContext(), params, timer_);
+    if (!ctx) {
+      txn.Abort();
+      return false;
+    }
+  }
+  return txn.Commit();
+}
 
+runtime::InsertPipeline* CypherWriteApp::getPipeline(
+    std::string_view bytes, std::map<std::string, std::string>& params) {
   size_t sep = bytes.find_first_of("&?");
   auto query_str = bytes.substr(0, sep);
   auto params_str = bytes.substr(sep + 2);
-  std::map<std::string, std::string> params;
   parse_params(params_str, params);
   auto query = std::string(query_str.data(), query_str.size());
-  if (!pipeline_cache_.count(query)) {
-    if (plan_cache_.count(query)) {
-    } else {
-      physical::PhysicalPlan plan;
-      std::string plan_str;
+  std::map<std::string, std::string> lifted = params;
+  auto pipeline = pipeline_cache_.get(lift_literals(query, lifted));
+  if (pipeline != nullptr) {
+    params.swap(lifted);
+  } else if ((pipeline = pipeline_cache_.get(query)) == nullptr) {
+    physical::PhysicalPlan plan;
+    std::string key, plan_str;
 
-      if (!gs::runtime::CypherRunnerImpl::get().gen_plan(db_, query,
-                                                         plan_str)) {
-        return false;
-      } else {
-        if (!plan.ParseFromString(plan_str)) {
-          LOG(ERROR) << "Parse plan failed for query: " << query;
-          return false;
-        }
-        plan_cache_[query] = std::move(plan);
-      }
+    if (!gs::runtime::CypherRunnerImpl::get().gen_plan(db_, query, params, key,
+                                                       plan_str)) {
+      return nullptr;
+    }
+    if (!plan.ParseFromString(plan_str)) {
+      LOG(ERROR) << "Parse plan failed for query: " << query;
+      return nullptr;
     }
-    const auto& plan = plan_cache_[query];
-    pipeline_cache_.emplace(query, runtime::PlanParser::get()
-                                       .parse_write_pipeline(db_.schema(), plan)
-                                       .value());
+    pipeline = pipeline_cache_.put(
+        key,
+        runtime::PlanParser::get().parse_write_pipeline(db_.schema(), plan)
+            .value());
   }
-
-  gs::runtime::GraphInsertInterface gri(txn);
-  auto ctx = pipeline_cache_.at(query).Execute(gri, runtime::WriteContext(),
-                                               params, timer_);
-  txn.Commit();
-  return true;
+  return pipeline;
 }
+
 AppWrapper CypherWriteAppFactory::CreateApp(const GraphDB& db) {
   return AppWrapper(new CypherWriteApp(db), NULL);
 }
@@ -20,23 +20,44 @@
 #include "flex/engines/graph_db/runtime/execute/pipeline.h"
 
 #include "flex/proto_generated_gie/physical.pb.h"
+#include "flex/utils/lru_cache.h"
 
 namespace gs {
 class CypherWriteApp : public WriteAppBase {
  public:
-  CypherWriteApp(const GraphDB& db) : db_(db) {}
+  // The pipelines kept per session.
+  static constexpr size_t PIPELINE_CACHE_CAPACITY = 256;
+
+  CypherWriteApp(const GraphDB& db)
+      : db_(db),
+        pipeline_cache_(PIPELINE_CACHE_CAPACITY),
+        schema_change_num_(0) {}
 
   AppType type() const override { return AppType::kCypherAdhoc; }
 
   bool Query(GraphDBSession& graph, Decoder& input, Encoder& output) override;
 
+  // Runs the queries, each "query&?params" as read by Query, in one insert
+  // transaction, which is aborted if any of them fails to compile or to run.
+  // Returns false then, or if the transaction fails to commit.
+  bool QueryGroup(GraphDBSession& graph,
+                  const std::vector<std::string_view>& queries);
+
   const runtime::OprTimer& timer() const { return timer_; }
   runtime::OprTimer& timer() { return timer_; }
 
  private:
+  // The pipeline of the query, whose parameters are set to params, or
+  // nullptr if it does not compile.
+  runtime::InsertPipeline* getPipeline(
+      std::string_view bytes, std::map<std::string, std::string>& params);
+
   const GraphDB& db_;
-  std::unordered_map<std::string, physical::PhysicalPlan> plan_cache_;
-  std::unordered_map<std::string, runtime::InsertPipeline> pipeline_cache_;
+  // By query template, see lift_literals, or by query if the template does
+  // not compile.
+  LruCache<std::string, runtime::InsertPipeline> pipeline_cache_;
+  // MutablePropertyFragment::schema_change_num when the cache was valid.
+  uint32_t schema_change_num_;
   runtime::OprTimer timer_;
 };
 
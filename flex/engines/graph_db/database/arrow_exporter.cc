@@ -0,0 +1,632 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/arrow_exporter.h"
+
+#include <arrow/ipc/api.h>
+
+#include "flex/engines/graph_db/runtime/common/columns/value_columns.h"
+#include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
+#include "flex/engines/graph_db/runtime/common/context.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/execute/plan_parser.h"
+#include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+#include "flex/utils/arrow_utils.h"
+
+namespace gs {
+
+namespace arrow_exporter_impl {
+
+// A buffer pointing into the memory of a column, which keeps the owner of
+// the memory alive as long as an array refers to it.
+class PinnedBuffer : public arrow::Buffer {
+ public:
+  PinnedBuffer(const uint8_t* data, int64_t size,
+               std::shared_ptr<const void> owner)
+      : arrow::Buffer(data, size), owner_(std::move(owner)) {}
+
+ private:
+  std::shared_ptr<const void> owner_;
+};
+
+static Status from_arrow_status(const arrow::Status& status) {
+  return Status(StatusCode::IO_ERROR, status.ToString());
+}
+
+static bool is_string_type(const PropertyType& type) {
+  return type.type_enum == impl::PropertyTypeImpl::kStringView ||
+         type.type_enum == impl::PropertyTypeImpl::kString ||
+         type.type_enum == impl::PropertyTypeImpl::kStringMap ||
+         type.type_enum == impl::PropertyTypeImpl::kVarChar;
+}
+
+static bool is_exportable_type(const PropertyType& type) {
+  return type == PropertyType::kBool || type == PropertyType::kInt32 ||
+         type == PropertyType::kUInt32 || type == PropertyType::kInt64 ||
+         type == PropertyType::kUInt64 || type == PropertyType::kFloat ||
+         type == PropertyType::kDouble || type == PropertyType::kDate ||
+         type == PropertyType::kDay || is_string_type(type);
+}
+
+template <typename T>
+static std::shared_ptr<arrow::Array> wrap_buffer(
+    const T* data, size_t num, const std::shared_ptr<const void>& owner) {
+  auto buffer = std::make_shared<PinnedBuffer>(
+      reinterpret_cast<const uint8_t*>(data), num * sizeof(T), owner);
+  return arrow::MakeArray(arrow::ArrayData::Make(
+      TypeConverter<T>::ArrowTypeValue(), num, {nullptr, buffer}, 0));
+}
+
+// Wraps the first num elements of col, which are kept in up to two buffers,
+// as a chunked array.
+template <typename T>
+static std::shared_ptr<arrow::ChunkedArray> wrap_column(
+    const TypedColumn<T>& col, size_t num,
+    const std::shared_ptr<const void>& owner) {
+  static_assert(sizeof(T) == sizeof(typename TypeConverter<T>::ArrowType::
+                                        c_type),
+                "The layout of the column must match the arrow type");
+  arrow::ArrayVector chunks;
+  size_t basic_num = std::min(num, col.basic_buffer_size());
+  if (basic_num > 0) {
+    chunks.emplace_back(wrap_buffer(col.basic_buffer().data(), basic_num,
+                                    owner));
+  }
+  size_t extra_num = std::min(num - basic_num, col.extra_buffer_size());
+  if (extra_num > 0) {
+    chunks.emplace_back(wrap_buffer(col.extra_buffer().data(), extra_num,
+                                    owner));
+  }
+  return std::make_shared<arrow::ChunkedArray>(
+      std::move(chunks), TypeConverter<T>::ArrowTypeValue());
+}
+
+static arrow::Status append_any(arrow::ArrayBuilder* builder,
+                                const PropertyType& type, const Any& value) {
+  if (type == PropertyType::kBool) {
+    return static_cast<arrow::BooleanBuilder*>(builder)->Append(
+        value.AsBool());
+  } else if (type == PropertyType::kInt32) {
+    return static_cast<arrow::Int32Builder*>(builder)->Append(
+        value.AsInt32());
+  } else if (type == PropertyType::kUInt32) {
+    return static_cast<arrow::UInt32Builder*>(builder)->Append(
+        value.AsUInt32());
+  } else if (type == PropertyType::kInt64) {
+    return static_cast<arrow::Int64Builder*>(builder)->Append(
+        value.AsInt64());
+  } else if (type == PropertyType::kUInt64) {
+    return static_cast<arrow::UInt64Builder*>(builder)->Append(
+        value.AsUInt64());
+  } else if (type == PropertyType::kFloat) {
+    return static_cast<arrow::FloatBuilder*>(builder)->Append(
+        value.AsFloat());
+  } else if (type == PropertyType::kDouble) {
+    return static_cast<arrow::DoubleBuilder*>(builder)->Append(
+        value.AsDouble());
+  } else if (type == PropertyType::kDate) {
+    return static_cast<arrow::TimestampBuilder*>(builder)->Append(
+        value.AsDate().milli_second);
+  } else if (type == PropertyType::kDay) {
+    return static_cast<arrow::TimestampBuilder*>(builder)->Append(
+        value.AsDay().to_timestamp());
+  } else if (is_string_type(type)) {
+    return static_cast<arrow::LargeStringBuilder*>(builder)->Append(
+        value.AsStringView());
+  }
+  return arrow::Status::NotImplemented("Unsupported property type: ",
+                                       type.ToString());
+}
+
+static arrow::Result<std::shared_ptr<arrow::ChunkedArray>> finish_builder(
+    arrow::ArrayBuilder* builder) {
+  std::shared_ptr<arrow::Array> array;
+  ARROW_RETURN_NOT_OK(builder->Finish(&array));
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+// Copies the first num values of a column whose layout differs from arrow's.
+static arrow::Result<std::shared_ptr<arrow::ChunkedArray>> copy_column(
+    const ColumnBase& col, size_t num) {
+  auto type = col.type();
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  ARROW_RETURN_NOT_OK(arrow::MakeBuilder(arrow::default_memory_pool(),
+                                         PropertyTypeToArrowType(type),
+                                         &builder));
+  ARROW_RETURN_NOT_OK(builder->Reserve(num));
+  if (type == PropertyType::kBool) {
+    const auto& typed = dynamic_cast<const TypedColumn<bool>&>(col);
+    auto casted = static_cast<arrow::BooleanBuilder*>(builder.get());
+    for (size_t i = 0; i < num; ++i) {
+      casted->UnsafeAppend(typed.get_view(i));
+    }
+  } else if (type == PropertyType::kDay) {
+    const auto& typed = dynamic_cast<const TypedColumn<Day>&>(col);
+    auto casted = static_cast<arrow::TimestampBuilder*>(builder.get());
+    for (size_t i = 0; i < num; ++i) {
+      casted->UnsafeAppend(typed.get_view(i).to_timestamp());
+    }
+  } else if (auto typed =
+                 dynamic_cast<const TypedColumn<std::string_view>*>(&col)) {
+    auto casted = static_cast<arrow::LargeStringBuilder*>(builder.get());
+    for (size_t i = 0; i < num; ++i) {
+      ARROW_RETURN_NOT_OK(casted->Append(typed->get_view(i)));
+    }
+  } else {
+    for (size_t i = 0; i < num; ++i) {
+      ARROW_RETURN_NOT_OK(append_any(builder.get(), type, col.get(i)));
+    }
+  }
+  return finish_builder(builder.get());
+}
+
+static arrow::Result<std::shared_ptr<arrow::ChunkedArray>> export_column(
+    const ColumnBase& col, size_t num,
+    const std::shared_ptr<const void>& owner) {
+  auto type = col.type();
+  if (type == PropertyType::kInt32) {
+    return wrap_column(dynamic_cast<const TypedColumn<int32_t>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kUInt32) {
+    return wrap_column(dynamic_cast<const TypedColumn<uint32_t>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kInt64) {
+    return wrap_column(dynamic_cast<const TypedColumn<int64_t>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kUInt64) {
+    return wrap_column(dynamic_cast<const TypedColumn<uint64_t>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kFloat) {
+    return wrap_column(dynamic_cast<const TypedColumn<float>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kDouble) {
+    return wrap_column(dynamic_cast<const TypedColumn<double>&>(col), num,
+                       owner);
+  } else if (type == PropertyType::kDate) {
+    return wrap_column(dynamic_cast<const TypedColumn<Date>&>(col), num,
+                       owner);
+  }
+  return copy_column(col, num);
+}
+
+static std::shared_ptr<arrow::DataType> rt_type_to_arrow_type(
+    runtime::RTAnyType type) {
+  switch (type) {
+  case runtime::RTAnyType::kI64Value:
+    return arrow::int64();
+  case runtime::RTAnyType::kU64Value:
+  case runtime::RTAnyType::kVertex:
+    return arrow::uint64();
+  case runtime::RTAnyType::kI32Value:
+    return arrow::int32();
+  case runtime::RTAnyType::kF64Value:
+    return arrow::float64();
+  case runtime::RTAnyType::kBoolValue:
+    return arrow::boolean();
+  case runtime::RTAnyType::kDate32:
+  case runtime::RTAnyType::kTimestamp:
+    return arrow::timestamp(arrow::TimeUnit::MILLI);
+  default:
+    return arrow::large_utf8();
+  }
+}
+
+static arrow::Status append_rt_any(arrow::ArrayBuilder* builder,
+                                   runtime::RTAnyType type,
+                                   const runtime::RTAny& value) {
+  if (value.is_null()) {
+    return builder->AppendNull();
+  }
+  switch (type) {
+  case runtime::RTAnyType::kI64Value:
+    return static_cast<arrow::Int64Builder*>(builder)->Append(
+        value.as_int64());
+  case runtime::RTAnyType::kU64Value:
+    return static_cast<arrow::UInt64Builder*>(builder)->Append(
+        value.as_uint64());
+  case runtime::RTAnyType::kVertex: {
+    auto v = value.as_vertex();
+    return static_cast<arrow::UInt64Builder*>(builder)->Append(
+        runtime::encode_unique_vertex_id(v.label_, v.vid_));
+  }
+  case runtime::RTAnyType::kI32Value:
+    return static_cast<arrow::Int32Builder*>(builder)->Append(
+        value.as_int32());
+  case runtime::RTAnyType::kF64Value:
+    return static_cast<arrow::DoubleBuilder*>(builder)->Append(
+        value.as_double());
+  case runtime::RTAnyType::kBoolValue:
+    return static_cast<arrow::BooleanBuilder*>(builder)->Append(
+        value.as_bool());
+  case runtime::RTAnyType::kDate32:
+    return static_cast<arrow::TimestampBuilder*>(builder)->Append(
+        value.as_date32().to_timestamp());
+  case runtime::RTAnyType::kTimestamp:
+    return static_cast<arrow::TimestampBuilder*>(builder)->Append(
+        value.as_timestamp().milli_second);
+  case runtime::RTAnyType::kStringValue:
+    return static_cast<arrow::LargeStringBuilder*>(builder)->Append(
+        value.as_string());
+  default:
+    return static_cast<arrow::LargeStringBuilder*>(builder)->Append(
+        value.to_string());
+  }
+}
+
+template <typename T>
+static std::shared_ptr<arrow::ChunkedArray> wrap_value_column(
+    const std::shared_ptr<runtime::IContextColumn>& col) {
+  auto typed = std::dynamic_pointer_cast<runtime::ValueColumn<T>>(col);
+  if (typed == nullptr) {
+    return nullptr;
+  }
+  const auto& data = typed->data();
+  return std::make_shared<arrow::ChunkedArray>(
+      wrap_buffer(data.data(), data.size(), col));
+}
+
+// Returns nullptr if the column has to be copied.
+static std::shared_ptr<arrow::ChunkedArray> wrap_context_column(
+    const std::shared_ptr<runtime::IContextColumn>& col) {
+  if (col->column_type() != runtime::ContextColumnType::kValue) {
+    return nullptr;
+  }
+  switch (col->elem_type()) {
+  case runtime::RTAnyType::kI64Value:
+    return wrap_value_column<int64_t>(col);
+  case runtime::RTAnyType::kU64Value:
+    return wrap_value_column<uint64_t>(col);
+  case runtime::RTAnyType::kI32Value:
+    return wrap_value_column<int32_t>(col);
+  case runtime::RTAnyType::kF64Value:
+    return wrap_value_column<double>(col);
+  default:
+    return nullptr;
+  }
+}
+
+// Copies the rows in [begin, end) of col.
+static arrow::Result<std::shared_ptr<arrow::Array>> copy_context_rows(
+    const runtime::IContextColumn& col,
+    const std::shared_ptr<arrow::DataType>& type, size_t begin, size_t end) {
+  std::unique_ptr<arrow::ArrayBuilder> builder;
+  ARROW_RETURN_NOT_OK(
+      arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder));
+  ARROW_RETURN_NOT_OK(builder->Reserve(end - begin));
+  if (auto sl = dynamic_cast<const runtime::SLVertexColumn*>(&col)) {
+    auto casted = static_cast<arrow::UInt64Builder*>(builder.get());
+    const auto& vertices = sl->vertices();
+    for (size_t i = begin; i < end; ++i) {
+      casted->UnsafeAppend(
+          runtime::encode_unique_vertex_id(sl->label(), vertices[i]));
+    }
+  } else {
+    auto elem_type = col.elem_type();
+    for (size_t i = begin; i < end; ++i) {
+      ARROW_RETURN_NOT_OK(
+          append_rt_any(builder.get(), elem_type, col.get_elem(i)));
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  ARROW_RETURN_NOT_OK(builder->Finish(&array));
+  return array;
+}
+
+}  // namespace arrow_exporter_impl
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportVertices(
+    const GraphDBSession& session, const std::string& label,
+    const std::vector<std::string>& columns) {
+  const auto& schema = session.schema();
+  if (!schema.has_vertex_label(label)) {
+    return Status(StatusCode::NOT_FOUND, "Vertex label not found: " + label);
+  }
+  std::shared_ptr<ReadTransaction> txn(
+      new ReadTransaction(session.GetReadTransaction()));
+  return ExportVertices(txn, schema.get_vertex_label_id(label), columns);
+}
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportEdges(
+    const GraphDBSession& session, const std::string& src_label,
+    const std::string& dst_label, const std::string& edge_label) {
+  const auto& schema = session.schema();
+  if (!schema.exist(src_label, dst_label, edge_label)) {
+    return Status(StatusCode::NOT_FOUND,
+                  "Edge not found: " + src_label + " -[" + edge_label +
+                      "]-> " + dst_label);
+  }
+  std::shared_ptr<ReadTransaction> txn(
+      new ReadTransaction(session.GetReadTransaction()));
+  return ExportEdges(txn, schema.get_vertex_label_id(src_label),
+                     schema.get_vertex_label_id(dst_label),
+                     schema.get_edge_label_id(edge_label));
+}
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportVertices(
+    std::shared_ptr<ReadTransaction> txn, label_t label,
+    const std::vector<std::string>& columns) {
+  const auto& graph = txn->graph();
+  const auto& schema = txn->schema();
+  const auto& table = graph.get_vertex_table(label);
+  size_t vnum = txn->GetVertexNum(label);
+
+  std::vector<std::string> names = columns;
+  if (names.empty()) {
+    const auto& prop_names = schema.get_vertex_property_names(label);
+    for (size_t i = 0; i < prop_names.size(); ++i) {
+      if (!schema.is_dropped_vertex_property(label, i)) {
+        names.push_back(prop_names[i]);
+      }
+    }
+  }
+  std::vector<std::shared_ptr<ColumnBase>> cols;
+  for (const auto& name : names) {
+    auto col = table.get_column(name);
+    if (col == nullptr) {
+      return Status(StatusCode::NOT_FOUND, "Property not found: " + name);
+    }
+    if (!arrow_exporter_impl::is_exportable_type(col->type())) {
+      return Status(StatusCode::UNSUPPORTED_OPERATION,
+                    "Property " + name + " of type " +
+                        col->type().ToString() + " can not be exported");
+    }
+    cols.emplace_back(col);
+  }
+
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> arrays;
+  const auto& keys = graph.lf_indexers_[label].get_keys();
+  if (!arrow_exporter_impl::is_exportable_type(keys.type())) {
+    return Status(StatusCode::UNSUPPORTED_OPERATION,
+                  "Primary key of type " + keys.type().ToString() +
+                      " can not be exported");
+  }
+  auto pk_array = arrow_exporter_impl::export_column(keys, vnum, txn);
+  if (!pk_array.ok()) {
+    return arrow_exporter_impl::from_arrow_status(pk_array.status());
+  }
+  fields.emplace_back(arrow::field(schema.get_vertex_primary_key_name(label),
+                                   pk_array.ValueOrDie()->type()));
+  arrays.emplace_back(pk_array.ValueOrDie());
+
+  for (size_t i = 0; i < cols.size(); ++i) {
+    auto owner = std::make_shared<std::pair<std::shared_ptr<ReadTransaction>,
+                                            std::shared_ptr<ColumnBase>>>(
+        txn, cols[i]);
+    auto array = arrow_exporter_impl::export_column(*cols[i], vnum, owner);
+    if (!array.ok()) {
+      return arrow_exporter_impl::from_arrow_status(array.status());
+    }
+    fields.emplace_back(arrow::field(names[i], array.ValueOrDie()->type()));
+    arrays.emplace_back(array.ValueOrDie());
+  }
+  return arrow::Table::Make(arrow::schema(fields), arrays, vnum);
+}
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportEdges(
+    std::shared_ptr<ReadTransaction> txn, label_t src_label,
+    label_t dst_label, label_t edge_label) {
+  const auto& graph = txn->graph();
+  const auto& schema = txn->schema();
+  const auto& prop_names =
+      schema.get_edge_property_names(src_label, dst_label, edge_label);
+  const auto& prop_types =
+      schema.get_edge_properties(src_label, dst_label, edge_label);
+  for (size_t i = 0; i < prop_types.size(); ++i) {
+    if (!arrow_exporter_impl::is_exportable_type(prop_types[i])) {
+      return Status(StatusCode::UNSUPPORTED_OPERATION,
+                    "Property " + prop_names[i] + " of type " +
+                        prop_types[i].ToString() + " can not be exported");
+    }
+  }
+  const CsrBase* csr = graph.get_oe_csr(src_label, dst_label, edge_label);
+  if (csr == nullptr) {
+    return Status(StatusCode::UNSUPPORTED_OPERATION,
+                  "Outgoing edges are not stored");
+  }
+
+  arrow::FieldVector fields = {arrow::field("src", arrow::uint32()),
+                               arrow::field("dst", arrow::uint32())};
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders(2);
+  builders[0] = std::make_unique<arrow::UInt32Builder>();
+  builders[1] = std::make_unique<arrow::UInt32Builder>();
+  for (size_t i = 0; i < prop_types.size(); ++i) {
+    auto type = PropertyTypeToArrowType(prop_types[i]);
+    fields.emplace_back(arrow::field(prop_names[i], type));
+    std::unique_ptr<arrow::ArrayBuilder> builder;
+    auto status =
+        arrow::MakeBuilder(arrow::default_memory_pool(), type, &builder);
+    if (!status.ok()) {
+      return arrow_exporter_impl::from_arrow_status(status);
+    }
+    builders.emplace_back(std::move(builder));
+  }
+  auto src_builder = static_cast<arrow::UInt32Builder*>(builders[0].get());
+  auto dst_builder = static_cast<arrow::UInt32Builder*>(builders[1].get());
+
+  timestamp_t ts = txn->timestamp();
+  vid_t vnum = std::min<size_t>(txn->GetVertexNum(src_label), csr->size());
+  for (vid_t v = 0; v < vnum; ++v) {
+    for (auto it = csr->edge_iter(v); it->is_valid(); it->next()) {
+      if (it->get_timestamp() > ts) {
+        continue;
+      }
+      arrow::Status status = src_builder->Append(v);
+      if (status.ok()) {
+        status = dst_builder->Append(it->get_neighbor());
+      }
+      if (status.ok() && prop_types.size() == 1) {
+        status = arrow_exporter_impl::append_any(builders[2].get(),
+                                                 prop_types[0],
+                                                 it->get_data());
+      } else if (status.ok() && prop_types.size() > 1) {
+        auto record = it->get_data().AsRecordView();
+        for (size_t i = 0; i < prop_types.size() && status.ok(); ++i) {
+          status = arrow_exporter_impl::append_any(builders[i + 2].get(),
+                                                   prop_types[i], record[i]);
+        }
+      }
+      if (!status.ok()) {
+        return arrow_exporter_impl::from_arrow_status(status);
+      }
+    }
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> arrays;
+  for (auto& builder : builders) {
+    auto array = arrow_exporter_impl::finish_builder(builder.get());
+    if (!array.ok()) {
+      return arrow_exporter_impl::from_arrow_status(array.status());
+    }
+    arrays.emplace_back(array.ValueOrDie());
+  }
+  return arrow::Table::Make(arrow::schema(fields), arrays);
+}
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportQuery(
+    const GraphDBSession& session, const std::string& query,
+    const std::map<std::string, std::string>& params) {
+  std::map<std::string, std::string> query_params = params;
+  std::string key, plan_str;
+  if (!runtime::CypherRunnerImpl::get().gen_plan(session.db(), query,
+                                                 query_params, key, plan_str)) {
+    return Status(StatusCode::QUERY_FAILED,
+                  "Compiler failed to generate physical plan: " + query);
+  }
+  physical::PhysicalPlan plan;
+  if (!plan.ParseFromString(plan_str)) {
+    return Status(StatusCode::INTERNAL_ERROR, "Parse plan failed: " + query);
+  }
+  auto txn = session.GetReadTransaction();
+  runtime::GraphReadInterface graph(txn);
+  runtime::OprTimer timer;
+  Status status = Status::OK();
+  auto ctx = bl::try_handle_all(
+      [&]() -> bl::result<runtime::Context> {
+        return runtime::PlanParser::get()
+            .parse_read_pipeline(graph.schema(), runtime::ContextMeta(), plan)
+            .value()
+            .Execute(graph, runtime::Context(), query_params, timer);
+      },
+      [&status](const Status& err) {
+        status = err;
+        return runtime::Context();
+      },
+      [&status](const bl::error_info& err) {
+        status = Status(StatusCode::INTERNAL_ERROR,
+                        "Error: " + std::to_string(err.error().value()) +
+                            ", Exception: " + err.exception()->what());
+        return runtime::Context();
+      },
+      [&status]() {
+        status = Status(StatusCode::UNKNOWN, "Unknown error");
+        return runtime::Context();
+      });
+  if (!status.ok()) {
+    return status;
+  }
+  return ExportContext(ctx);
+}
+
+Result<std::shared_ptr<arrow::Table>> ArrowExporter::ExportContext(
+    const runtime::Context& ctx) {
+  size_t row_num = ctx.row_num();
+  arrow::FieldVector fields;
+  std::vector<std::shared_ptr<runtime::IContextColumn>> cols;
+  for (int tag : ctx.tag_ids) {
+    auto col = ctx.get(tag);
+    if (col == nullptr) {
+      continue;
+    }
+    fields.emplace_back(arrow::field(
+        std::to_string(tag),
+        arrow_exporter_impl::rt_type_to_arrow_type(col->elem_type())));
+    cols.emplace_back(col);
+  }
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> arrays(cols.size());
+  std::vector<size_t> copied;
+  for (size_t i = 0; i < cols.size(); ++i) {
+    arrays[i] = arrow_exporter_impl::wrap_context_column(cols[i]);
+    if (arrays[i] == nullptr) {
+      copied.emplace_back(i);
+    }
+  }
+
+  // Each range of rows becomes a chunk of every copied column.
+  auto& pool = runtime::MorselPool::get();
+  size_t range_num =
+      (!copied.empty() && pool.Enabled(row_num)) ? pool.MorselNum(row_num) : 1;
+  std::vector<arrow::ArrayVector> chunks(copied.size(),
+                                         arrow::ArrayVector(range_num));
+  std::vector<arrow::Status> statuses(range_num);
+  auto copy_range = [&](size_t r) {
+    size_t begin = row_num * r / range_num;
+    size_t end = row_num * (r + 1) / range_num;
+    for (size_t k = 0; k < copied.size(); ++k) {
+      auto array = arrow_exporter_impl::copy_context_rows(
+          *cols[copied[k]], fields[copied[k]]->type(), begin, end);
+      if (!array.ok()) {
+        statuses[r] = array.status();
+        return;
+      }
+      chunks[k][r] = array.ValueOrDie();
+    }
+  };
+  if (range_num > 1) {
+    pool.Run(range_num, copy_range);
+  } else {
+    copy_range(0);
+  }
+  for (auto& status : statuses) {
+    if (!status.ok()) {
+      return arrow_exporter_impl::from_arrow_status(status);
+    }
+  }
+  for (size_t k = 0; k < copied.size(); ++k) {
+    arrays[copied[k]] = std::make_shared<arrow::ChunkedArray>(
+        std::move(chunks[k]), fields[copied[k]]->type());
+  }
+  return arrow::Table::Make(arrow::schema(fields), arrays, row_num);
+}
+
+Result<int64_t> ArrowExporter::IpcStreamSize(const arrow::Table& table) {
+  arrow::io::MockOutputStream out;
+  RETURN_IF_NOT_OK(WriteIpcStream(table, &out));
+  auto size = out.Tell();
+  if (!size.ok()) {
+    return arrow_exporter_impl::from_arrow_status(size.status());
+  }
+  return size.ValueOrDie();
+}
+
+Status ArrowExporter::WriteIpcStream(const arrow::Table& table,
+                                     arrow::io::OutputStream* out) {
+  auto writer = arrow::ipc::MakeStreamWriter(out, table.schema());
+  if (!writer.ok()) {
+    return arrow_exporter_impl::from_arrow_status(writer.status());
+  }
+  auto status = writer.ValueOrDie()->WriteTable(table);
+  if (status.ok()) {
+    status = writer.ValueOrDie()->Close();
+  }
+  if (!status.ok()) {
+    return arrow_exporter_impl::from_arrow_status(status);
+  }
+  return Status::OK();
+}
+
+}  // namespace gs
@@ -0,0 +1,101 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_DATABASE_ARROW_EXPORTER_H_
+#define ENGINES_GRAPH_DB_DATABASE_ARROW_EXPORTER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/database/read_transaction.h"
+#include "flex/utils/result.h"
+
+namespace gs {
+
+namespace runtime {
+class Context;
+}  // namespace runtime
+
+/**
+ * @brief Exports the vertices and edges of a label as arrow tables.
+ *
+ * The int32, int64, uint32, uint64, float, double and date columns of a
+ * vertex table, the primary key included, are wrapped into arrow arrays
+ * without copying: each array points into the column buffers and keeps the
+ * read transaction it was exported under, and so the version of the graph it
+ * reads, alive until the last array referring to it is released. Bool, day
+ * and string columns, whose layouts differ from arrow's, and the edges, which
+ * are stored interleaved with their neighbors and timestamps, are copied.
+ *
+ * Note that properties updated in place after the export started may still
+ * show through the wrapped arrays, as the columns keep a single version.
+ *
+ * The results of cypher read queries are exported column by column of the
+ * runtime context, so that clients read them without decoding rows.
+ */
+class ArrowExporter {
+ public:
+  // Exports the primary key and the given properties (all of them if none is
+  // given) of the vertices of label, as of a new read transaction.
+  static Result<std::shared_ptr<arrow::Table>> ExportVertices(
+      const GraphDBSession& session, const std::string& label,
+      const std::vector<std::string>& columns);
+
+  // Exports the source and destination vids and the properties of the edges
+  // visible to a new read transaction.
+  static Result<std::shared_ptr<arrow::Table>> ExportEdges(
+      const GraphDBSession& session, const std::string& src_label,
+      const std::string& dst_label, const std::string& edge_label);
+
+  static Result<std::shared_ptr<arrow::Table>> ExportVertices(
+      std::shared_ptr<ReadTransaction> txn, label_t label,
+      const std::vector<std::string>& columns);
+
+  static Result<std::shared_ptr<arrow::Table>> ExportEdges(
+      std::shared_ptr<ReadTransaction> txn, label_t src_label,
+      label_t dst_label, label_t edge_label);
+
+  // Runs a cypher read query as of a new read transaction, $name in it
+  // standing for params[name], and exports the columns it returns.
+  static Result<std::shared_ptr<arrow::Table>> ExportQuery(
+      const GraphDBSession& session, const std::string& query,
+      const std::map<std::string, std::string>& params);
+
+  // Exports the columns ctx sinks, each named by its tag. Value columns of
+  // numbers are wrapped without copying, keeping the columns alive; the
+  // others are copied a range of rows at a time on the threads of
+  // MorselPool, vertices as the unique ids the protobuf results carry and
+  // the values arrow has no counterpart of as their strings.
+  static Result<std::shared_ptr<arrow::Table>> ExportContext(
+      const runtime::Context& ctx);
+
+  // Returns the number of bytes WriteIpcStream writes for table, without
+  // copying any of its buffers.
+  static Result<int64_t> IpcStreamSize(const arrow::Table& table);
+
+  // Writes table to out in the arrow IPC streaming format.
+  static Status WriteIpcStream(const arrow::Table& table,
+                               arrow::io::OutputStream* out);
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_DATABASE_ARROW_EXPORTER_H_
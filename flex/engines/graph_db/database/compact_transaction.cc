@@ -22,8 +22,14 @@ namespace gs {
 
 CompactTransaction::CompactTransaction(MutablePropertyFragment& graph,
                                        IWalWriter& logger, VersionManager& vm,
-                                       timestamp_t timestamp)
-    : graph_(graph), logger_(logger), vm_(vm), timestamp_(timestamp) {
+                                       timestamp_t timestamp,
+                                       size_t max_vertex_num)
+    : graph_(graph),
+      logger_(logger),
+      vm_(vm),
+      timestamp_(timestamp),
+      max_vertex_num_(max_vertex_num),
+      remaining_(false) {
   arc_.Resize(sizeof(WalHeader));
 }
 
@@ -45,8 +51,9 @@ bool CompactTransaction::Commit() {
     }
     arc_.Clear();
 
+    graph_.FoldVertexPropertyVersions();
     LOG(INFO) << "before compact - " << timestamp_;
-    graph_.Compact(timestamp_);
+    remaining_ = graph_.Compact(timestamp_, max_vertex_num_);
     LOG(INFO) << "after compact - " << timestamp_;
 
     vm_.release_update_timestamp(timestamp_);
@@ -55,6 +62,8 @@ bool CompactTransaction::Commit() {
   return true;
 }
 
+bool CompactTransaction::HasRemaining() const { return remaining_; }
+
 void CompactTransaction::Abort() {
   if (timestamp_ != std::numeric_limits<timestamp_t>::max()) {
     arc_.Clear();
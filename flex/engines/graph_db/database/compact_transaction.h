@@ -16,6 +16,8 @@
 #ifndef GRAPHSCOPE_DATABASE_COMPACT_TRANSACTION_H_
 #define GRAPHSCOPE_DATABASE_COMPACT_TRANSACTION_H_
 
+#include <limits>
+
 #include "flex/storages/rt_mutable_graph/types.h"
 #include "grape/serialization/in_archive.h"
 
@@ -27,14 +29,21 @@ class VersionManager;
 
 class CompactTransaction {
  public:
-  CompactTransaction(MutablePropertyFragment& graph, IWalWriter& logger,
-                     VersionManager& vm, timestamp_t timestamp);
+  // max_vertex_num bounds the work done by this transaction, see
+  // MutablePropertyFragment::Compact.
+  CompactTransaction(
+      MutablePropertyFragment& graph, IWalWriter& logger, VersionManager& vm,
+      timestamp_t timestamp,
+      size_t max_vertex_num = std::numeric_limits<size_t>::max());
   ~CompactTransaction();
 
   timestamp_t timestamp() const;
 
   bool Commit();
 
+  // Whether the committed compaction left triplets for a later one.
+  bool HasRemaining() const;
+
   void Abort();
 
  private:
@@ -42,6 +51,8 @@ class CompactTransaction {
   IWalWriter& logger_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  size_t max_vertex_num_;
+  bool remaining_;
 
   grape::InArchive arc_;
 };
@@ -0,0 +1,49 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/compaction_scheduler.h"
+
+namespace gs {
+
+CompactionScheduler::Decision CompactionScheduler::Decide(
+    const CompactionSignals& signals) const {
+  bool pending = signals.unsorted_vertex_num != 0 ||
+                 signals.property_version_num != 0 || signals.unfrozen_writes;
+  if (!pending) {
+    return Decision::kIdle;
+  }
+  bool idle = signals.qps == 0;
+  bool due = (signals.unsorted_vertex_num != 0 &&
+              signals.unsorted_vertex_num >=
+                  policy_.min_unsorted_ratio * signals.vertex_num) ||
+             signals.property_version_num >= policy_.min_property_version_num;
+  if (!due && !idle) {
+    return Decision::kIdle;
+  }
+  if (signals.long_read_active || signals.qps > policy_.max_qps) {
+    return Decision::kDefer;
+  }
+  return Decision::kCompact;
+}
+
+int64_t CompactionScheduler::PauseAfter(int64_t step_us) const {
+  if (policy_.cpu_share >= 1 || policy_.cpu_share <= 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(step_us * (1 - policy_.cpu_share) /
+                              policy_.cpu_share);
+}
+
+}  // namespace gs
@@ -0,0 +1,91 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_COMPACTION_SCHEDULER_H_
+#define GRAPHSCOPE_DATABASE_COMPACTION_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gs {
+
+struct CompactionPolicy {
+  // Seconds between two decisions.
+  int check_interval = 30;
+  // Compaction is due once the vertices with unsorted adjacency lists reach
+  // this share of all vertices, or the vertex property versions waiting to
+  // be folded this number. Anything smaller waits for an idle interval.
+  double min_unsorted_ratio = 0.01;
+  size_t min_property_version_num = 1 << 20;
+  // Queries per second over the last interval above which compaction is
+  // deferred, and its remaining steps paused.
+  double max_qps = 1000;
+  // Share of the wall time spent in compaction steps while compacting. After
+  // a step, the compaction pauses for as long as it takes to keep it.
+  double cpu_share = 0.5;
+};
+
+// What the scheduler bases a decision on, measured over the last interval.
+struct CompactionSignals {
+  size_t vertex_num = 0;
+  size_t unsorted_vertex_num = 0;
+  size_t property_version_num = 0;
+  // Adjacency lists written since the last compaction, scanned with
+  // visibility tests until they are frozen.
+  bool unfrozen_writes = false;
+  double qps = 0;
+  // A read was running at the same snapshot through the whole interval.
+  bool long_read_active = false;
+};
+
+/**
+ * @brief Decides when auto compaction runs, and how fast.
+ *
+ * Compaction is an exclusive transaction: each of its steps waits for the
+ * running transactions to finish and holds back new ones. It runs when the
+ * graph is fragmented enough or the service is idle, defers under load or
+ * behind a long read, which its steps would stall every transaction behind,
+ * and spaces its steps to keep to its share of the time.
+ */
+class CompactionScheduler {
+ public:
+  enum class Decision {
+    kIdle,     // Nothing worth compacting.
+    kDefer,    // Compaction is due, but would hurt the running queries.
+    kCompact,  // Compact now.
+  };
+
+  explicit CompactionScheduler(const CompactionPolicy& policy)
+      : policy_(policy) {}
+  ~CompactionScheduler() = default;
+
+  Decision Decide(const CompactionSignals& signals) const;
+
+  // Whether the steps left after one should go on, given the queries per
+  // second measured since the previous step.
+  bool ShouldContinue(double qps) const { return qps <= policy_.max_qps; }
+
+  // Microseconds to pause after a step that took step_us.
+  int64_t PauseAfter(int64_t step_us) const;
+
+  const CompactionPolicy& policy() const { return policy_; }
+
+ private:
+  CompactionPolicy policy_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_COMPACTION_SCHEDULER_H_
@@ -15,23 +15,41 @@
 
 #include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/graph_db/app/builtin/count_vertices.h"
+#include "flex/engines/graph_db/app/builtin/incremental_pagerank.h"
 #include "flex/engines/graph_db/app/builtin/k_hop_neighbors.h"
+#include "flex/engines/graph_db/app/builtin/neighbor_sampling.h"
+#include "flex/engines/graph_db/app/builtin/label_propagation.h"
 #include "flex/engines/graph_db/app/builtin/pagerank.h"
+#include "flex/engines/graph_db/app/builtin/random_walk.h"
 #include "flex/engines/graph_db/app/builtin/shortest_path_among_three.h"
+#include "flex/engines/graph_db/app/builtin/triangle_count.h"
+#include "flex/engines/graph_db/app/builtin/vector_search.h"
+#include "flex/engines/graph_db/app/builtin/wcc.h"
 #include "flex/engines/graph_db/app/cypher_read_app.h"
 #include "flex/engines/graph_db/app/cypher_write_app.h"
 #include "flex/engines/graph_db/app/hqps_app.h"
 #include "flex/engines/graph_db/app/server_app.h"
+#include "flex/engines/graph_db/database/compaction_scheduler.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
 #include "flex/engines/graph_db/database/wal/wal.h"
+#include "flex/engines/graph_db/database/wal/wal_manifest.h"
 #include "flex/engines/graph_db/runtime/execute/plan_parser.h"
 #include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+#include "flex/utils/shared_snapshot.h"
 #include "flex/utils/yaml_utils.h"
 
 #include "flex/third_party/httplib.h"
 
+#include <shared_mutex>
+#include <sstream>
+#include <unordered_map>
+
 namespace gs {
 
+// Upper bound of the vertices visited by one step of auto compaction.
+static constexpr size_t kCompactionStepVertexNum = 1 << 22;
+
 struct SessionLocalContext {
   SessionLocalContext(GraphDB& db, const std::string& work_dir, int thread_id,
                       MemoryStrategy allocator_strategy,
@@ -58,6 +76,17 @@ struct SessionLocalContext {
 
 GraphDB::GraphDB() = default;
 GraphDB::~GraphDB() {
+  stopWarmup();
+  if (wal_receiver_ != nullptr) {
+    wal_receiver_->Stop();
+  }
+  if (receiver_logger_ != nullptr) {
+    receiver_logger_->close();
+  }
+  if (wal_shipper_ != nullptr) {
+    wal_shipper_->Stop();
+  }
+  stopAutoSnapshot();
   if (compact_thread_running_) {
     compact_thread_running_ = false;
     compact_thread_.join();
@@ -74,11 +103,95 @@ GraphDB::~GraphDB() {
   WalParserFactory::Finalize();
 }
 
+namespace {
+
+// Owns the running instance, destroyed at exit as a static GraphDB would be.
+struct RunningGraphDB {
+  RunningGraphDB() : db(new GraphDB()) {}
+  ~RunningGraphDB() { delete db.load(); }
+  std::atomic<GraphDB*> db;
+};
+
+RunningGraphDB& running_graph_db() {
+  static RunningGraphDB running;
+  return running;
+}
+
+// The graphs hosted beside the running instance, by graph id.
+struct HostedGraphDBs {
+  std::shared_mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<GraphDB>> dbs;
+};
+
+HostedGraphDBs& hosted_graph_dbs() {
+  static HostedGraphDBs hosted;
+  return hosted;
+}
+
+}  // namespace
+
 GraphDB& GraphDB::get() {
-  static GraphDB db;
+  return *running_graph_db().db.load(std::memory_order_acquire);
+}
+
+std::unique_ptr<GraphDB> GraphDB::Swap(std::unique_ptr<GraphDB>&& db) {
+  CHECK(db != nullptr);
+  // The morsel pool and the plan parser are in use by the running queries,
+  // and the same for any graph.
+  runtime::OprTimer::set_profile_sample_rate(db->config().profile_sample_rate);
+  std::unique_ptr<GraphDB> prev(running_graph_db().db.exchange(
+      db.release(), std::memory_order_acq_rel));
+  ClearPlanCache();
+  return prev;
+}
+
+void GraphDB::ClearPlanCache() {
+  runtime::CypherRunnerImpl::get().clear_cache();
+}
+
+Status GraphDB::Host(const std::string& graph_id,
+                     std::unique_ptr<GraphDB>&& db) {
+  CHECK(db != nullptr);
+  auto& hosted = hosted_graph_dbs();
+  std::unique_lock<std::shared_mutex> lock(hosted.mutex);
+  if (hosted.dbs.count(graph_id)) {
+    return Status(StatusCode::ALREADY_EXISTS,
+                  "Graph " + graph_id + " is hosted already");
+  }
+  hosted.dbs.emplace(graph_id, std::shared_ptr<GraphDB>(std::move(db)));
+  return Status::OK();
+}
+
+std::shared_ptr<GraphDB> GraphDB::get(const std::string& graph_id) {
+  auto& hosted = hosted_graph_dbs();
+  std::shared_lock<std::shared_mutex> lock(hosted.mutex);
+  auto iter = hosted.dbs.find(graph_id);
+  return iter == hosted.dbs.end() ? nullptr : iter->second;
+}
+
+std::shared_ptr<GraphDB> GraphDB::Unhost(const std::string& graph_id) {
+  auto& hosted = hosted_graph_dbs();
+  std::unique_lock<std::shared_mutex> lock(hosted.mutex);
+  auto iter = hosted.dbs.find(graph_id);
+  if (iter == hosted.dbs.end()) {
+    return nullptr;
+  }
+  auto db = std::move(iter->second);
+  hosted.dbs.erase(iter);
   return db;
 }
 
+std::vector<std::string> GraphDB::HostedGraphs() {
+  auto& hosted = hosted_graph_dbs();
+  std::shared_lock<std::shared_mutex> lock(hosted.mutex);
+  std::vector<std::string> graph_ids;
+  for (auto& pair : hosted.dbs) {
+    graph_ids.push_back(pair.first);
+  }
+  std::sort(graph_ids.begin(), graph_ids.end());
+  return graph_ids;
+}
+
 Result<bool> GraphDB::Open(const Schema& schema, const std::string& data_dir,
                            int32_t thread_num, bool warmup, bool memory_only,
                            bool enable_auto_compaction) {
@@ -109,6 +222,12 @@ Result<bool> GraphDB::Open(const GraphDBConfig& config) {
   }
   work_dir_ = data_dir;
   thread_num_ = config.thread_num;
+  // Must be set before the graph is opened, so that the storage is placed
+  // according to the policy when it is first touched.
+  set_numa_policy(config.numa_policy);
+  set_page_in_policy(config.page_in_policy, config.page_in_policy_overrides);
+  set_shared_snapshot_dir(config.memory_level > 0 ? config.shared_snapshot_dir
+                                                  : "");
   try {
     graph_.Open(data_dir, config.memory_level);
   } catch (std::exception& e) {
@@ -117,31 +236,7 @@ Result<bool> GraphDB::Open(const GraphDBConfig& config) {
                         "Exception: " + std::string(e.what()), false);
   }
 
-  if ((!create_empty_graph) && (!graph_.schema().Equals(schema))) {
-    LOG(ERROR) << "Schema inconsistent..\n";
-    return Result<bool>(StatusCode::INTERNAL_ERROR,
-                        "Schema of work directory is not compatible with the "
-                        "graph schema",
-                        false);
-  }
-  // Set the plugin info from schema to graph_.schema(), since the plugin info
-  // is not serialized and deserialized.
-  auto& mutable_schema = graph_.mutable_schema();
-  mutable_schema.SetPluginDir(schema.GetPluginDir());
-  mutable_schema.set_compiler_path(config.compiler_path);
-  std::vector<std::pair<std::string, std::string>> plugin_name_paths;
-  const auto& plugins = schema.GetPlugins();
-  for (auto plugin_pair : plugins) {
-    plugin_name_paths.emplace_back(
-        std::make_pair(plugin_pair.first, plugin_pair.second.first));
-  }
-
-  std::sort(plugin_name_paths.begin(), plugin_name_paths.end(),
-            [&](const std::pair<std::string, std::string>& a,
-                const std::pair<std::string, std::string>& b) {
-              return plugins.at(a.first).second < plugins.at(b.first).second;
-            });
-  mutable_schema.EmplacePlugins(plugin_name_paths);
+  setPlugins(schema, config.compiler_path);
 
   last_compaction_ts_ = 0;
   MemoryStrategy allocator_strategy = MemoryStrategy::kMemoryOnly;
@@ -152,9 +247,28 @@ Result<bool> GraphDB::Open(const GraphDBConfig& config) {
   }
 
   openWalAndCreateContexts(config, data_dir, allocator_strategy);
+  // Checked after the wals are replayed, which may add and drop vertex
+  // properties of the snapshot opened.
+  if ((!create_empty_graph) && (!graph_.schema().Equals(schema))) {
+    LOG(ERROR) << "Schema inconsistent..\n";
+    return Result<bool>(StatusCode::INTERNAL_ERROR,
+                        "Schema of work directory is not compatible with the "
+                        "graph schema",
+                        false);
+  }
+  if (config.memory_level >= 2) {
+    LOG(INFO) << "Graph and allocators are backed by "
+              << hugepage_usage().ToString();
+  }
 
   if ((!create_empty_graph) && config.warmup) {
-    graph_.Warmup(thread_num_);
+    stopWarmup();
+    warmup_running_ = true;
+    if (config.warmup_in_background) {
+      warmup_thread_ = std::thread([this]() { warmup(config_); });
+    } else {
+      warmup(config);
+    }
   }
 
   if (config.enable_monitoring) {
@@ -217,55 +331,106 @@ Result<bool> GraphDB::Open(const GraphDBConfig& config) {
     });
   }
 
-  if (config.enable_auto_compaction) {
+  // A follower compacts when the primary does, by applying its wals.
+  if (config.enable_auto_compaction && config.replication_primary.empty()) {
     if (compact_thread_running_) {
       compact_thread_running_ = false;
       compact_thread_.join();
     }
     compact_thread_running_ = true;
-    compact_thread_ = std::thread([&]() {
-      size_t last_compaction_at = 0;
-      while (compact_thread_running_) {
-        size_t query_num_before = getExecutedQueryNum();
-        sleep(30);
-        if (!compact_thread_running_) {
-          break;
-        }
-        size_t query_num_after = getExecutedQueryNum();
-        if (query_num_before == query_num_after &&
-            (query_num_after > (last_compaction_at + 100000))) {
-          VLOG(10) << "Trigger auto compaction";
-          last_compaction_at = query_num_after;
-          timestamp_t ts = this->version_manager_.acquire_update_timestamp();
-          auto txn =
-              CompactTransaction(this->graph_, *this->contexts_[0].logger,
-                                 this->version_manager_, ts);
-          OutputCypherProfiles("./" + std::to_string(ts) + "_");
-          txn.Commit();
-          VLOG(10) << "Finish compaction";
-        }
-      }
-    });
+    compact_thread_ = std::thread(
+        [this, policy = config.compaction_policy]() { autoCompact(policy); });
+  }
+
+  // A follower has the snapshots of the data directory it was seeded from.
+  if (config.snapshot_interval > 0 && config.replication_primary.empty()) {
+    stopAutoSnapshot();
+    snapshot_thread_running_ = true;
+    snapshot_thread_ = std::thread(
+        [this, interval = config.snapshot_interval]() {
+          autoSnapshot(interval);
+        });
+  }
+
+  if (config.result_cache_capacity > 0) {
+    result_cache_ = std::make_unique<ResultCache>(
+        version_manager_, config.result_cache_capacity);
   }
 
   unlink((work_dir_ + "/statistics.json").c_str());
   graph_.generateStatistics(work_dir_);
-  runtime::CypherRunnerImpl::get().clear_cache();
+  if (!config.standby) {
+    initRuntime(config);
+  }
 
   return Result<bool>(true);
 }
 
+void GraphDB::setPlugins(const Schema& schema,
+                         const std::string& compiler_path) {
+  // Set the plugin info from schema to graph_.schema(), since the plugin info
+  // is not serialized and deserialized.
+  auto& mutable_schema = graph_.mutable_schema();
+  mutable_schema.SetPluginDir(schema.GetPluginDir());
+  mutable_schema.set_compiler_path(compiler_path);
+  std::vector<std::pair<std::string, std::string>> plugin_name_paths;
+  const auto& plugins = schema.GetPlugins();
+  for (auto plugin_pair : plugins) {
+    plugin_name_paths.emplace_back(
+        std::make_pair(plugin_pair.first, plugin_pair.second.first));
+  }
+
+  std::sort(plugin_name_paths.begin(), plugin_name_paths.end(),
+            [&](const std::pair<std::string, std::string>& a,
+                const std::pair<std::string, std::string>& b) {
+              return plugins.at(a.first).second < plugins.at(b.first).second;
+            });
+  mutable_schema.EmplacePlugins(plugin_name_paths);
+}
+
+void GraphDB::reopenGraph() {
+  Schema prev_schema = graph_.schema();
+  graph_.Clear();
+  graph_.Open(work_dir_, config_.memory_level);
+  setPlugins(prev_schema, prev_schema.get_compiler_path());
+}
+
+void GraphDB::initRuntime(const GraphDBConfig& config) {
+  runtime::MorselPool::get().Init(config.intra_query_thread_num);
+  runtime::OprTimer::set_profile_sample_rate(config.profile_sample_rate);
+  runtime::PlanParser::get().init();
+  // The cached plans are of the schema of the previous graph.
+  runtime::CypherRunnerImpl::get().clear_cache();
+}
+
 void GraphDB::Close() {
+  stopWarmup();
+  if (wal_receiver_ != nullptr) {
+    wal_receiver_->Stop();
+    wal_receiver_.reset();
+  }
+  if (receiver_logger_ != nullptr) {
+    receiver_logger_->close();
+    receiver_logger_.reset();
+  }
+  if (wal_shipper_ != nullptr) {
+    wal_shipper_->Stop();
+  }
   if (monitor_thread_running_) {
     monitor_thread_running_ = false;
     monitor_thread_.join();
   }
+  stopAutoSnapshot();
   if (compact_thread_running_) {
     compact_thread_running_ = false;
     compact_thread_.join();
   }
   //-----------Clear graph_db----------------
+  result_cache_.reset();
+  incremental_pagerank_.reset();
   graph_.Clear();
+  CompressedStringColumn::set_epoch_manager(nullptr);
+  receiver_allocator_.reset();
   version_manager_.clear();
   if (contexts_ != nullptr) {
     for (int i = 0; i < thread_num_; ++i) {
@@ -274,6 +439,7 @@ void GraphDB::Close() {
     free(contexts_);
     contexts_ = nullptr;
   }
+  wal_shipper_.reset();
   std::fill(app_paths_.begin(), app_paths_.end(), "");
   std::fill(app_factories_.begin(), app_factories_.end(), nullptr);
 }
@@ -300,6 +466,11 @@ UpdateTransaction GraphDB::GetUpdateTransaction(int thread_id) {
   return contexts_[thread_id].session.GetUpdateTransaction();
 }
 
+PropertyUpdateTransaction GraphDB::GetPropertyUpdateTransaction(
+    int thread_id) {
+  return contexts_[thread_id].session.GetPropertyUpdateTransaction();
+}
+
 GraphDBSession& GraphDB::GetSession(int thread_id) {
   return contexts_[thread_id].session;
 }
@@ -308,8 +479,117 @@ const GraphDBSession& GraphDB::GetSession(int thread_id) const {
   return contexts_[thread_id].session;
 }
 
+void GraphDB::BindSessionThread(int thread_id) const {
+  if (config_.numa_policy == NumaPolicy::kInterleaveBindSessions) {
+    int node = static_cast<int64_t>(thread_id) * numa_node_num() /
+               std::max(thread_num_, 1);
+    bind_current_thread_to_numa_node(node);
+  }
+}
+
+void GraphDB::WaitForReads() const {
+  while (version_manager_.active_read_num() != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
 int GraphDB::SessionNum() const { return thread_num_; }
 
+MemoryUsage GraphDB::AllocatorMemoryUsage() const {
+  MemoryUsage ret;
+  if (contexts_ != nullptr) {
+    for (int i = 0; i < thread_num_; ++i) {
+      ret += contexts_[i].allocator.memory_usage();
+    }
+  }
+  return ret;
+}
+
+void GraphDB::warmup(const GraphDBConfig& config) {
+  double t = -grape::GetCurrentTime();
+  std::vector<WarmupTarget> targets = config.warmup_targets.empty()
+                                          ? graph_.WarmupTargets()
+                                          : config.warmup_targets;
+  {
+    std::lock_guard<std::mutex> lock(warmup_mutex_);
+    warmup_progress_ = WarmupProgress();
+    warmup_progress_.running = true;
+    warmup_progress_.target_num = targets.size();
+  }
+  // Updates and compactions wait for the read, so the storage of a part
+  // stays in place while it is touched, and run between the parts. The read
+  // has no session, whose slot its thread would share with the session.
+  auto pinned = [this](const std::function<void()>& func) {
+    version_manager_.acquire_read_timestamp();
+    uint64_t epoch = version_manager_.epoch_manager().pin();
+    func();
+    version_manager_.epoch_manager().unpin(epoch);
+    version_manager_.release_read_timestamp();
+  };
+  size_t warmed_bytes = 0;
+  for (const auto& target : targets) {
+    if (!warmup_running_) {
+      break;
+    }
+    bool warmed = false;
+    MemoryUsage usage;
+    pinned([&]() { usage = graph_.WarmupMemoryUsage(target); });
+    size_t bytes = usage.mapped_bytes - usage.resident_bytes;
+    if (config.warmup_memory_budget != 0 &&
+        warmed_bytes + bytes > config.warmup_memory_budget) {
+      LOG(INFO) << "Skip warming up " << target.ToString() << ", its "
+                << bytes << " bytes exceed the memory budget";
+    } else if (!graph_.Warmup(target, thread_num_, pinned)) {
+      LOG(ERROR) << "Unknown warmup target: " << target.ToString();
+    } else {
+      warmed = true;
+      warmed_bytes += bytes;
+    }
+    std::lock_guard<std::mutex> lock(warmup_mutex_);
+    if (warmed) {
+      ++warmup_progress_.warmed_num;
+    } else {
+      ++warmup_progress_.skipped_num;
+    }
+    warmup_progress_.warmed_bytes = warmed_bytes;
+    warmup_progress_.elapsed = t + grape::GetCurrentTime();
+    VLOG(1) << "Warmup progress: "
+            << warmup_progress_.warmed_num + warmup_progress_.skipped_num
+            << " / " << targets.size() << ", " << warmed_bytes << " bytes";
+  }
+  t += grape::GetCurrentTime();
+  std::lock_guard<std::mutex> lock(warmup_mutex_);
+  warmup_progress_.running = false;
+  warmup_progress_.elapsed = t;
+  LOG(INFO) << "Warmed up " << warmup_progress_.warmed_num << " of "
+            << targets.size() << " targets, " << warmed_bytes
+            << " bytes paged in, takes: " << t << " s";
+}
+
+void GraphDB::stopWarmup() {
+  warmup_running_ = false;
+  if (warmup_thread_.joinable()) {
+    warmup_thread_.join();
+  }
+}
+
+WarmupProgress GraphDB::GetWarmupProgress() const {
+  std::lock_guard<std::mutex> lock(warmup_mutex_);
+  return warmup_progress_;
+}
+
+ReplicationStatus GraphDB::GetReplicationStatus() const {
+  if (wal_receiver_ != nullptr) {
+    return wal_receiver_->Status();
+  }
+  ReplicationStatus status;
+  if (wal_shipper_ != nullptr) {
+    status.role = "primary";
+    status.connection_num = wal_shipper_->FollowerNum();
+  }
+  return status;
+}
+
 void GraphDB::UpdateCompactionTimestamp(timestamp_t ts) {
   last_compaction_ts_ = ts;
 }
@@ -352,41 +632,167 @@ void GraphDB::GetAppInfo(Encoder& output) {
   }
 }
 
+// An edge of an insert wal, whose data is left in the wal until the thread
+// replaying its source vertex ingests it.
+struct WalEdge {
+  uint32_t ts;
+  label_t src_label, dst_label, edge_label;
+  vid_t src, dst;
+  char* data;
+  size_t size;
+};
+
+// An edge whose endpoint was added by a wal of a later timestamp, which
+// happens when the inserting transaction committed first.
+struct PendingWalEdge {
+  WalEdge edge;
+  Any src_oid, dst_oid;
+};
+
+// Adds the vertices of an insert wal and collects its edges, partitioned by
+// source vertex over the queues.
+static void parseInsertWal(MutablePropertyFragment& graph, uint32_t ts,
+                           char* data, size_t length,
+                           std::vector<std::vector<WalEdge>>& queues,
+                           std::vector<PendingWalEdge>& pending) {
+  grape::OutArchive arc;
+  arc.SetSlice(data, length);
+  while (!arc.Empty()) {
+    uint8_t op_type;
+    arc >> op_type;
+    if (op_type == 0) {
+      Any id;
+      label_t label = deserialize_oid(graph, arc, id);
+      vid_t lid = graph.add_vertex(label, id);
+      graph.get_vertex_table(label).ingest(lid, arc);
+      graph.IndexVertex(label, lid);
+    } else if (op_type == 1) {
+      PendingWalEdge p;
+      auto& edge = p.edge;
+      edge.ts = ts;
+      edge.src_label = deserialize_oid(graph, arc, p.src_oid);
+      edge.dst_label = deserialize_oid(graph, arc, p.dst_oid);
+      arc >> edge.edge_label;
+      edge.size = arc.GetSize();
+      edge.data = data + (length - edge.size);
+      graph.SkipEdgeData(edge.src_label, edge.dst_label, edge.edge_label, arc);
+      edge.size -= arc.GetSize();
+      if (graph.get_lid(edge.src_label, p.src_oid, edge.src) &&
+          graph.get_lid(edge.dst_label, p.dst_oid, edge.dst)) {
+        queues[edge.src % queues.size()].push_back(edge);
+      } else {
+        pending.emplace_back(std::move(p));
+      }
+    } else if (op_type == 2) {
+      label_t src_label, dst_label, edge_label;
+      uint32_t edge_num;
+      arc >> src_label >> dst_label >> edge_label >> edge_num;
+      std::vector<PendingWalEdge> batch(edge_num);
+      Any oid;
+      oid.type =
+          std::get<0>(graph.schema().get_vertex_primary_key(src_label).at(0));
+      for (auto& p : batch) {
+        deserialize_field(arc, oid);
+        p.src_oid = oid;
+      }
+      oid.type =
+          std::get<0>(graph.schema().get_vertex_primary_key(dst_label).at(0));
+      for (auto& p : batch) {
+        deserialize_field(arc, oid);
+        p.dst_oid = oid;
+      }
+      for (auto& p : batch) {
+        auto& edge = p.edge;
+        edge.ts = ts;
+        edge.src_label = src_label;
+        edge.dst_label = dst_label;
+        edge.edge_label = edge_label;
+        edge.size = arc.GetSize();
+        edge.data = data + (length - edge.size);
+        graph.SkipEdgeData(src_label, dst_label, edge_label, arc);
+        edge.size -= arc.GetSize();
+        if (graph.get_lid(src_label, p.src_oid, edge.src) &&
+            graph.get_lid(dst_label, p.dst_oid, edge.dst)) {
+          queues[edge.src % queues.size()].push_back(edge);
+        } else {
+          pending.emplace_back(std::move(p));
+        }
+      }
+    } else {
+      LOG(FATAL) << "Unexpected op-" << static_cast<int>(op_type);
+    }
+  }
+}
+
+/**
+ * Replays the insert wals of [from, to), chunk by chunk. The vertices of a
+ * chunk are added by a single thread in timestamp order, so that a replay
+ * assigns the same vids whatever the thread number. Its edges are then
+ * ingested by thread_num threads, each owning the source vertices hashed to
+ * it, so that the out-edges of a vertex are written by a single thread in
+ * timestamp order.
+ */
 static void IngestWalRange(SessionLocalContext* contexts,
                            MutablePropertyFragment& graph,
                            const IWalParser& parser, uint32_t from, uint32_t to,
                            int thread_num) {
-  std::atomic<uint32_t> cur_ts(from);
-  std::vector<std::thread> threads(thread_num);
-  for (int i = 0; i < thread_num; ++i) {
-    threads[i] = std::thread(
-        [&](int tid) {
-          auto& alloc = contexts[tid].allocator;
-          while (true) {
-            uint32_t got_ts = cur_ts.fetch_add(1);
-            if (got_ts >= to) {
-              break;
-            }
-            const auto& unit = parser.get_insert_wal(got_ts);
-            InsertTransaction::IngestWal(graph, got_ts, unit.ptr, unit.size,
-                                         alloc);
-            if (got_ts % 1000000 == 0) {
-              LOG(INFO) << "Ingested " << got_ts << " WALs";
+  constexpr uint32_t chunk_size = 1 << 20;
+  std::vector<std::vector<WalEdge>> queues(thread_num);
+  std::vector<PendingWalEdge> pending;
+  for (uint32_t begin = from; begin < to;) {
+    uint32_t end = to - begin > chunk_size ? begin + chunk_size : to;
+    for (uint32_t ts = begin; ts < end; ++ts) {
+      const auto& unit = parser.get_insert_wal(ts);
+      parseInsertWal(graph, ts, unit.ptr, unit.size, queues, pending);
+    }
+    std::vector<PendingWalEdge> unresolved;
+    for (auto& p : pending) {
+      auto& edge = p.edge;
+      if (graph.get_lid(edge.src_label, p.src_oid, edge.src) &&
+          graph.get_lid(edge.dst_label, p.dst_oid, edge.dst)) {
+        queues[edge.src % queues.size()].push_back(edge);
+      } else if (end == to) {
+        LOG(FATAL) << "Vertex of edge at " << edge.ts << " not found: "
+                   << p.src_oid.to_string() << " -> "
+                   << p.dst_oid.to_string();
+      } else {
+        unresolved.emplace_back(std::move(p));
+      }
+    }
+    pending.swap(unresolved);
+
+    std::vector<std::thread> threads(thread_num);
+    for (int i = 0; i < thread_num; ++i) {
+      threads[i] = std::thread(
+          [&](int tid) {
+            auto& alloc = contexts[tid].allocator;
+            for (const auto& edge : queues[tid]) {
+              grape::OutArchive arc;
+              arc.SetSlice(edge.data, edge.size);
+              graph.IngestEdge(edge.src_label, edge.src, edge.dst_label,
+                               edge.dst, edge.edge_label, edge.ts, arc, alloc);
             }
-          }
-        },
-        i);
-  }
-  for (auto& thrd : threads) {
-    thrd.join();
+            queues[tid].clear();
+          },
+          i);
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+    LOG(INFO) << "Ingested WALs up to " << end - 1;
+    begin = end;
   }
 }
 
 void GraphDB::ingestWals(IWalParser& parser, const std::string& work_dir,
-                         int thread_num) {
-  uint32_t from_ts = 1;
+                         int thread_num, uint32_t snapshot_ts) {
+  uint32_t from_ts = snapshot_ts + 1;
   for (auto& update_wal : parser.get_update_wals()) {
     uint32_t to_ts = update_wal.timestamp;
+    // In a segment not sealed before a crash.
+    if (to_ts <= snapshot_ts) {
+      continue;
+    }
     if (from_ts < to_ts) {
       IngestWalRange(contexts_, graph_, parser, from_ts, to_ts, thread_num);
     }
@@ -403,7 +809,8 @@ void GraphDB::ingestWals(IWalParser& parser, const std::string& work_dir,
     IngestWalRange(contexts_, graph_, parser, from_ts, parser.last_ts() + 1,
                    thread_num);
   }
-  version_manager_.init_ts(parser.last_ts(), thread_num);
+  version_manager_.init_ts(std::max(parser.last_ts(), snapshot_ts),
+                           thread_num);
 }
 
 void GraphDB::initApps(
@@ -424,6 +831,20 @@ void GraphDB::initApps(
       std::make_shared<KNeighborsFactory>();
   app_factories_[Schema::BUILTIN_TVSP_PLUGIN_ID] =
       std::make_shared<ShortestPathAmongThreeFactory>();
+  app_factories_[Schema::BUILTIN_WCC_PLUGIN_ID] =
+      std::make_shared<WCCFactory>();
+  app_factories_[Schema::BUILTIN_TRIANGLE_COUNT_PLUGIN_ID] =
+      std::make_shared<TriangleCountFactory>();
+  app_factories_[Schema::BUILTIN_LPA_PLUGIN_ID] =
+      std::make_shared<LabelPropagationFactory>();
+  app_factories_[Schema::BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_ID] =
+      std::make_shared<IncrementalPageRankFactory>();
+  app_factories_[Schema::BUILTIN_VECTOR_SEARCH_PLUGIN_ID] =
+      std::make_shared<VectorSearchFactory>();
+  app_factories_[Schema::BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_ID] =
+      std::make_shared<NeighborSamplingFactory>();
+  app_factories_[Schema::BUILTIN_RANDOM_WALK_PLUGIN_ID] =
+      std::make_shared<RandomWalkFactory>();
 
   app_factories_[Schema::HQPS_ADHOC_READ_PLUGIN_ID] =
       std::make_shared<HQPSAdhocReadAppFactory>();
@@ -434,8 +855,6 @@ void GraphDB::initApps(
   app_factories_[Schema::CYPHER_READ_DEBUG_PLUGIN_ID] =
       std::make_shared<CypherReadAppFactory>();
 
-  auto& parser = gs::runtime::PlanParser::get();
-  parser.init();
   app_factories_[Schema::ADHOC_READ_PLUGIN_ID] =
       std::make_shared<CypherReadAppFactory>();
 
@@ -482,22 +901,146 @@ void GraphDB::openWalAndCreateContexts(const GraphDBConfig& config,
                                  data_dir);
   }
   VLOG(1) << "Using wal uri: " << wal_uri;
+  wal_uri_ = wal_uri;
 
+  if (config.replication_port != 0) {
+    wal_shipper_ = std::make_unique<WalShipper>(
+        config.replication_port, config.replication_backlog_size, [this]() {
+          uint32_t ts = version_manager_.acquire_read_timestamp();
+          version_manager_.release_read_timestamp();
+          return ts;
+        });
+  }
   for (int i = 0; i < thread_num_; ++i) {
-    new (&contexts_[i])
-        SessionLocalContext(*this, data_dir, i, allocator_strategy,
-                            WalWriterFactory::CreateWalWriter(wal_uri));
+    auto writer = WalWriterFactory::CreateWalWriter(wal_uri);
+    if (wal_shipper_ != nullptr) {
+      writer = std::make_unique<ReplicatingWalWriter>(std::move(writer),
+                                                      *wal_shipper_);
+    }
+    new (&contexts_[i]) SessionLocalContext(
+        *this, data_dir, i, allocator_strategy, std::move(writer));
+    contexts_[i].allocator.set_epoch_manager(
+        &version_manager_.epoch_manager());
+  }
+  CompressedStringColumn::set_epoch_manager(
+      &version_manager_.epoch_manager());
+  // The segments covered by the snapshot are deleted before they are parsed,
+  // and are left by a crash after the snapshot version was set.
+  uint32_t snapshot_ts = 0;
+  if (std::filesystem::exists(snapshot_version_path(data_dir))) {
+    snapshot_ts = get_snapshot_wal_ts(
+        snapshot_dir(data_dir, get_snapshot_version(data_dir)));
+    WalManifest(get_wal_uri_path(wal_uri)).RemoveCovered(snapshot_ts);
   }
   auto wal_parser = WalParserFactory::CreateWalParser(wal_uri);
-  ingestWals(*wal_parser, data_dir, thread_num_);
+  ingestWals(*wal_parser, data_dir, thread_num_, snapshot_ts);
+  // The replayed vertices may have used up the room reserved on opening.
+  graph_.ReserveVertexGrowth();
 
   for (int i = 0; i < thread_num_; ++i) {
     contexts_[i].logger->open(wal_uri, i);
   }
+  if (!config.replication_primary.empty()) {
+    // Sessions take no writes on a follower, the wals of the primary are
+    // logged as those of one more thread, replayed with the others.
+    receiver_allocator_ = std::make_unique<Allocator>(
+        allocator_strategy,
+        (allocator_strategy != MemoryStrategy::kSyncToFile
+             ? ""
+             : thread_local_allocator_prefix(data_dir, thread_num_)));
+    receiver_allocator_->set_epoch_manager(&version_manager_.epoch_manager());
+    receiver_logger_ = WalWriterFactory::CreateWalWriter(wal_uri);
+    receiver_logger_->open(wal_uri, thread_num_);
+  }
+  replicated_ts_ = std::max(wal_parser->last_ts(), snapshot_ts);
+  // Built on the replayed graph, before it takes inserts.
+  incremental_pagerank_.reset();
+  if (!config.incremental_pagerank_vertex_label.empty() &&
+      !config.incremental_pagerank_edge_label.empty()) {
+    const auto& schema = graph_.schema();
+    if (!schema.has_vertex_label(config.incremental_pagerank_vertex_label) ||
+        !schema.has_edge_label(config.incremental_pagerank_vertex_label,
+                               config.incremental_pagerank_vertex_label,
+                               config.incremental_pagerank_edge_label)) {
+      LOG(ERROR) << "Incremental pagerank disabled, no edge label "
+                 << config.incremental_pagerank_edge_label << " between "
+                 << config.incremental_pagerank_vertex_label << " vertices";
+    } else {
+      incremental_pagerank_ = std::make_unique<IncrementalPageRank>(
+          schema.get_vertex_label_id(config.incremental_pagerank_vertex_label),
+          schema.get_edge_label_id(config.incremental_pagerank_edge_label),
+          config.incremental_pagerank_damping_factor,
+          config.incremental_pagerank_epsilon);
+      incremental_pagerank_->Init(graph_);
+    }
+  }
+  if (wal_shipper_ != nullptr) {
+    wal_shipper_->Start(replicated_ts_);
+  }
+  if (!config.replication_primary.empty()) {
+    wal_receiver_ = std::make_unique<WalReceiver>(
+        config.replication_primary, replicated_ts_,
+        [this](char* data, size_t size, uint32_t primary_ts) {
+          applyReplicatedWals(data, size, primary_ts);
+        });
+    wal_receiver_->Start();
+  }
   initApps(graph_.schema().GetPlugins());
   VLOG(1) << "Successfully restore load plugins";
 }
 
+void GraphDB::applyReplicatedWals(char* data, size_t size,
+                                  uint32_t primary_ts) {
+  auto& alloc = *receiver_allocator_;
+  auto& logger = *receiver_logger_;
+  // The primary released these timestamps without writing a record.
+  auto skip_to = [&](uint32_t ts) {
+    while (replicated_ts_ + 1 < ts) {
+      uint32_t skipped = version_manager_.acquire_insert_timestamp();
+      CHECK_EQ(skipped, replicated_ts_ + 1);
+      version_manager_.release_insert_timestamp(skipped);
+      replicated_ts_ = skipped;
+    }
+  };
+  // The labels of the records are not parsed, any cached result is dropped.
+  LabelSet all_labels;
+  all_labels.add_all();
+  size_t offset = 0;
+  while (offset < size) {
+    auto* header = reinterpret_cast<WalHeader*>(data + offset);
+    char* body = data + offset + sizeof(WalHeader);
+    size_t length = header->length;
+    uint32_t ts = header->timestamp;
+    skip_to(ts);
+    if (!logger.append(data + offset, sizeof(WalHeader) + length)) {
+      LOG(FATAL) << "Failed to append replicated wal of " << ts;
+    }
+    if (header->type) {
+      uint32_t acquired = version_manager_.acquire_update_timestamp();
+      CHECK_EQ(acquired, ts);
+      if (length == 0) {
+        graph_.Compact(ts);
+        last_compaction_ts_ = ts;
+      } else {
+        UpdateTransaction::IngestWal(graph_, work_dir_, ts, body, length,
+                                     alloc);
+        version_manager_.record_write(all_labels, ts);
+      }
+      version_manager_.release_update_timestamp(acquired);
+    } else {
+      uint32_t acquired = version_manager_.acquire_insert_timestamp();
+      CHECK_EQ(acquired, ts);
+      InsertTransaction::IngestWal(graph_, ts, body, length, alloc,
+                                   insert_listener());
+      version_manager_.record_write(all_labels, ts);
+      version_manager_.release_insert_timestamp(acquired);
+    }
+    replicated_ts_ = ts;
+    offset += sizeof(WalHeader) + length;
+  }
+  skip_to(primary_ts + 1);
+}
+
 void GraphDB::showAppMetrics() const {
   int session_num = SessionNum();
   for (int i = 0; i < 256; ++i) {
@@ -517,6 +1060,235 @@ void GraphDB::showAppMetrics() const {
   }
 }
 
+std::string GraphDB::PrometheusMetrics() const {
+  std::vector<std::string> app_names(GraphDBSession::MAX_PLUGIN_NUM);
+  app_names[0] = "ServerApp";
+  for (auto& pair : schema().GetPlugins()) {
+    app_names[pair.second.second] = pair.first;
+  }
+  std::ostringstream ss;
+  ss << "# HELP interactive_procedure_latency_microseconds The latency of "
+        "the queries of each procedure.\n"
+     << "# TYPE interactive_procedure_latency_microseconds histogram\n";
+  int session_num = SessionNum();
+  for (int i = 0; i < GraphDBSession::MAX_PLUGIN_NUM; ++i) {
+    AppMetric summary;
+    for (int k = 0; k < session_num; ++k) {
+      summary += GetSession(k).GetAppMetric(i);
+    }
+    if (summary.empty()) {
+      continue;
+    }
+    std::string name = app_names[i].empty() ? "Query-" + std::to_string(i)
+                                            : app_names[i];
+    std::string prefix =
+        "interactive_procedure_latency_microseconds_bucket{procedure=\"" +
+        name + "\",le=\"";
+    int64_t cumulative = 0;
+    for (int b = 0; b + 1 < AppMetric::kBucketNum; ++b) {
+      cumulative += summary.buckets_[b];
+      ss << prefix << (int64_t(1) << b) << "\"} " << cumulative << "\n";
+    }
+    ss << prefix << "+Inf\"} " << summary.count_ << "\n";
+    ss << "interactive_procedure_latency_microseconds_sum{procedure=\"" << name
+       << "\"} " << summary.total_ << "\n";
+    ss << "interactive_procedure_latency_microseconds_count{procedure=\""
+       << name << "\"} " << summary.count_ << "\n";
+  }
+  double eval_seconds = 0;
+  for (int k = 0; k < session_num; ++k) {
+    eval_seconds += GetSession(k).eval_duration();
+  }
+  ss << "# HELP interactive_queries_total The queries run.\n"
+     << "# TYPE interactive_queries_total counter\n"
+     << "interactive_queries_total " << getExecutedQueryNum() << "\n"
+     << "# HELP interactive_query_seconds_total The time spent running "
+        "queries.\n"
+     << "# TYPE interactive_query_seconds_total counter\n"
+     << "interactive_query_seconds_total " << eval_seconds << "\n";
+  return ss.str();
+}
+
+bool GraphDB::compactionSleep(int64_t us) {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+  while (compact_thread_running_) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+        deadline - now, std::chrono::milliseconds(100)));
+  }
+  return false;
+}
+
+void GraphDB::autoCompact(const CompactionPolicy& policy) {
+  CompactionScheduler scheduler(policy);
+  uint32_t last_read_ts = 0;
+  bool last_read_active = false;
+  while (true) {
+    size_t query_num_before = getExecutedQueryNum();
+    auto interval_start = std::chrono::steady_clock::now();
+    if (!compactionSleep(policy.check_interval * 1000000l)) {
+      break;
+    }
+    auto elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - interval_start)
+                       .count();
+
+    CompactionSignals signals;
+    for (label_t i = 0; i < graph_.schema().vertex_label_num(); ++i) {
+      signals.vertex_num += graph_.vertex_num(i);
+    }
+    signals.unsorted_vertex_num = graph_.PendingCompactionVertexNum();
+    signals.property_version_num =
+        graph_.vertex_property_versions().version_num();
+    signals.unfrozen_writes = graph_.HasUnfrozenWrites();
+    signals.qps = (getExecutedQueryNum() - query_num_before) / elapsed;
+    bool read_active = version_manager_.active_read_num() != 0;
+    uint32_t read_ts = version_manager_.min_active_read_ts();
+    signals.long_read_active =
+        read_active && last_read_active && read_ts == last_read_ts;
+    last_read_active = read_active;
+    last_read_ts = read_ts;
+
+    auto decision = scheduler.Decide(signals);
+    if (decision == CompactionScheduler::Decision::kDefer) {
+      VLOG(10) << "Defer auto compaction of "
+               << signals.unsorted_vertex_num << " vertices at "
+               << signals.qps << " queries per second"
+               << (signals.long_read_active ? ", behind a long read" : "");
+    }
+    if (decision != CompactionScheduler::Decision::kCompact) {
+      continue;
+    }
+    VLOG(10) << "Trigger auto compaction of " << signals.unsorted_vertex_num
+             << " vertices";
+    // Compact in bounded steps, each one an exclusive transaction, so that
+    // queries can run in between.
+    bool remaining = true;
+    while (remaining && compact_thread_running_) {
+      size_t step_query_num = getExecutedQueryNum();
+      auto step_start = std::chrono::steady_clock::now();
+      timestamp_t ts = version_manager_.acquire_update_timestamp();
+      auto txn = CompactTransaction(graph_, *contexts_[0].logger,
+                                    version_manager_, ts,
+                                    kCompactionStepVertexNum);
+      OutputCypherProfiles("./" + std::to_string(ts) + "_");
+      txn.Commit();
+      remaining = txn.HasRemaining();
+      if (!remaining) {
+        break;
+      }
+      int64_t step_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - step_start)
+                            .count();
+      if (!compactionSleep(scheduler.PauseAfter(step_us))) {
+        break;
+      }
+      double step_elapsed = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - step_start)
+                                .count();
+      double qps = (getExecutedQueryNum() - step_query_num) / step_elapsed;
+      if (!scheduler.ShouldContinue(qps)) {
+        VLOG(10) << "Pause auto compaction at " << qps
+                 << " queries per second";
+        break;
+      }
+    }
+    if (!remaining) {
+      refreshStatistics();
+    }
+    VLOG(10) << "Finish compaction";
+  }
+}
+
+void GraphDB::refreshStatistics() {
+  timestamp_t ts = version_manager_.acquire_update_timestamp();
+  graph_.generateStatistics(work_dir_);
+  version_manager_.release_update_timestamp(ts);
+}
+
+Result<uint32_t> GraphDB::CreateSnapshot() {
+  if (wal_receiver_ != nullptr) {
+    return Result<uint32_t>(StatusCode::UNSUPPORTED_OPERATION,
+                            "A follower does not take snapshots", 0);
+  }
+  std::lock_guard<std::mutex> lock(snapshot_mutex_);
+  // No writer appends while the update timestamp is held.
+  timestamp_t ts = version_manager_.acquire_update_timestamp();
+  for (int i = 0; i < thread_num_; ++i) {
+    contexts_[i].logger->close();
+  }
+  WalManifest manifest(get_wal_uri_path(wal_uri_));
+  manifest.Seal(ts);
+  for (int i = 0; i < thread_num_; ++i) {
+    contexts_[i].logger->open(wal_uri_, i);
+  }
+
+  uint32_t version = get_snapshot_version(work_dir_) + 1;
+  try {
+    std::string dir = snapshot_dir(work_dir_, version);
+    std::filesystem::create_directories(dir);
+    set_snapshot_wal_ts(dir, ts);
+    graph_.Dump(work_dir_, version);
+  } catch (std::exception& e) {
+    version_manager_.release_update_timestamp(ts);
+    LOG(ERROR) << "Failed to create snapshot " << version << ": " << e.what();
+    return Result<uint32_t>(StatusCode::IO_ERROR,
+                            "Failed to create snapshot: " +
+                                std::string(e.what()),
+                            0);
+  }
+  // The dump moves the storage of the graph into the snapshot and releases
+  // it, so the graph is opened again from the snapshot before the readers
+  // and writers held off by the update timestamp resume.
+  try {
+    reopenGraph();
+  } catch (std::exception& e) {
+    LOG(FATAL) << "Failed to reopen the graph from snapshot " << version
+               << ": " << e.what();
+  }
+  manifest.RemoveCovered(ts);
+  version_manager_.release_update_timestamp(ts);
+  LOG(INFO) << "Created snapshot " << version << " covering wals up to "
+            << ts;
+  return Result<uint32_t>(ts);
+}
+
+void GraphDB::autoSnapshot(int interval) {
+  uint32_t snapshot_ts = 0;
+  while (snapshot_thread_running_) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(interval);
+    while (snapshot_thread_running_ &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (!snapshot_thread_running_) {
+      break;
+    }
+    uint32_t read_ts = version_manager_.acquire_read_timestamp();
+    version_manager_.release_read_timestamp();
+    // Nothing was committed since the last snapshot.
+    if (read_ts == snapshot_ts) {
+      continue;
+    }
+    auto res = CreateSnapshot();
+    if (res.ok()) {
+      snapshot_ts = res.value();
+    }
+  }
+}
+
+void GraphDB::stopAutoSnapshot() {
+  if (snapshot_thread_running_) {
+    snapshot_thread_running_ = false;
+    snapshot_thread_.join();
+  }
+}
+
 size_t GraphDB::getExecutedQueryNum() const {
   size_t ret = 0;
   for (int i = 0; i < thread_num_; ++i) {
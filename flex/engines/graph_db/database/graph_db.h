@@ -18,21 +18,31 @@
 
 #include <dlfcn.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "flex/engines/graph_db/app/app_base.h"
+#include "flex/engines/graph_db/database/compaction_scheduler.h"
+#include "flex/engines/graph_db/database/incremental_pagerank.h"
 #include "flex/engines/graph_db/database/insert_transaction.h"
+#include "flex/engines/graph_db/database/property_update_transaction.h"
 #include "flex/engines/graph_db/database/read_transaction.h"
+#include "flex/engines/graph_db/database/result_cache.h"
 #include "flex/engines/graph_db/database/single_edge_insert_transaction.h"
 #include "flex/engines/graph_db/database/single_vertex_insert_transaction.h"
 #include "flex/engines/graph_db/database/update_transaction.h"
 #include "flex/engines/graph_db/database/version_manager.h"
+#include "flex/engines/graph_db/database/wal/wal_replication.h"
 #include "flex/storages/rt_mutable_graph/loader/loader_factory.h"
 #include "flex/storages/rt_mutable_graph/loading_config.h"
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+#include "flex/utils/numa_utils.h"
+#include "flex/utils/page_in_policy.h"
 
 namespace gs {
 
@@ -52,7 +62,23 @@ struct GraphDBConfig {
         enable_monitoring(false),
         enable_auto_compaction(false),
         memory_level(1),
-        wal_uri("") {}
+        numa_policy(NumaPolicy::kNone),
+        page_in_policy(PageInPolicy::kDefault),
+        warmup_memory_budget(0),
+        warmup_in_background(false),
+        wal_uri(""),
+        replication_port(0),
+        replication_backlog_size(1ul << 30),
+        snapshot_interval(0),
+        intra_query_thread_num(0),
+        profile_sample_rate(0),
+        query_timeout_ms(0),
+        query_memory_budget(0),
+        result_cache_capacity(0),
+        cypher_write_group_size(0),
+        incremental_pagerank_damping_factor(0.85),
+        incremental_pagerank_epsilon(1e-6),
+        standby(false) {}
 
   Schema schema;
   std::string data_dir;
@@ -65,13 +91,97 @@ struct GraphDBConfig {
   /*
     0 - sync with disk;
     1 - mmap virtual memory;
-    2 - preferring hugepages;
-    3 - force hugepages;
+    2 - preferring hugepages, falling back to transparent hugepages;
+    3 - force hugepages, also for the columns stored on disk;
+    At levels 1 and 2, the vertex properties and the edge triplets whose
+    storage strategy is Disk stay mmaped from files, see
+    Schema::get_csr_storage_strategy.
   */
   int memory_level;
+  // Placement of graph storage and sessions on multi-socket machines.
+  NumaPolicy numa_policy;
+  // How mapped files are paged in at memory level 0 and 1, and per-file
+  // overrides keyed by glob patterns on file names, first match wins.
+  PageInPolicy page_in_policy;
+  std::vector<std::pair<std::string, PageInPolicy>> page_in_policy_overrides;
+  // A directory on tmpfs or hugetlbfs, if set, where the snapshot files are
+  // copied once for the processes of the host opening the same data_dir at
+  // memory level 1 or above to share their pages, e.g. replicas following
+  // a primary, see set_shared_snapshot_dir.
+  std::string shared_snapshot_dir;
+  // With warmup, the targets are warmed up in order, every label and triplet
+  // if none is given. A target is skipped if paging it in would exceed
+  // warmup_memory_budget bytes in all, 0 meaning no limit. In the background,
+  // Open returns before the warmup is done, see GraphDB::GetWarmupProgress.
+  std::vector<WarmupTarget> warmup_targets;
+  size_t warmup_memory_budget;
+  bool warmup_in_background;
   std::string wal_uri;  // Indicate the where shall we store the wal files.
                         // could be file://{GRAPH_DATA_DIR}/wal or other scheme
                         // that interactive supports
+
+  // A primary serves its wal records to followers on replication_port, if
+  // not 0, keeping up to replication_backlog_size bytes of the latest ones
+  // for followers that reconnect. A follower is opened on a copy of the data
+  // directory of the primary, and keeps applying the records of
+  // replication_primary, host:port, if not empty. It serves reads only, and
+  // does not compact on its own.
+  uint32_t replication_port;
+  size_t replication_backlog_size;
+  std::string replication_primary;
+
+  // When and how fast auto compaction runs, if enabled.
+  CompactionPolicy compaction_policy;
+
+  // Seconds between two snapshots taken by GraphDB::CreateSnapshot, 0 not to
+  // take any. Bounds the wals replayed when the graph is opened.
+  int snapshot_interval;
+
+  // Threads, shared by the sessions, running the morsels of large read
+  // queries in parallel, 0 to run each query on the thread of its session.
+  // See runtime::ReadPipeline.
+  int intra_query_thread_num;
+
+  // The fraction of the cypher queries run profiled, their annotated plans
+  // logged, see runtime::OprTimer::explain.
+  double profile_sample_rate;
+
+  // Milliseconds after which a query is aborted, and bytes its operators
+  // may allocate for their rows, 0 for no limit. See runtime::QueryGuard.
+  int64_t query_timeout_ms;
+  size_t query_memory_budget;
+
+  // The results of read queries kept until a label they read is written, 0
+  // to keep none. See ResultCache.
+  size_t result_cache_capacity;
+
+  // Up to this many consecutive cypher write queries of a batch, see
+  // GraphDBSession::EvalBatch, run in one insert transaction, committed with
+  // one timestamp and one wal record. 0 to run each in its own.
+  size_t cypher_write_group_size;
+
+  // The PageRank of the subgraph of this vertex label and edge label, if
+  // both are set, kept fresh under inserts and read with the
+  // incremental_pagerank builtin. See IncrementalPageRank.
+  std::string incremental_pagerank_vertex_label;
+  std::string incremental_pagerank_edge_label;
+  double incremental_pagerank_damping_factor;
+  double incremental_pagerank_epsilon;
+  // Opened in the background to replace the running instance, see
+  // GraphDB::Swap, leaving the process-wide runtime state, i.e. the morsel
+  // pool, the plan parser and the plan cache, to the running instance.
+  bool standby;
+};
+
+struct WarmupProgress {
+  bool running = false;
+  size_t target_num = 0;
+  size_t warmed_num = 0;
+  // Targets not in the schema, or over the memory budget.
+  size_t skipped_num = 0;
+  // Bytes that were not resident before the warmup.
+  size_t warmed_bytes = 0;
+  double elapsed = 0;
 };
 
 class GraphDB {
@@ -79,8 +189,50 @@ class GraphDB {
   GraphDB();
   ~GraphDB();
 
+  // The running instance, the one a Swap made running last if any.
   static GraphDB& get();
 
+  /**
+   * @brief Makes db, opened with config().standby, the instance get()
+   * returns, for a new snapshot to replace the running graph without a
+   * restart. Queries may run meanwhile: those which got the previous
+   * instance finish on it, the ones after run on db. The morsel pool and the
+   * plan parser are kept, and the plan cache is cleared.
+   *
+   * @return The previous instance, to be closed and destroyed once nothing
+   * refers to it anymore, see WaitForReads. The plans its queries cached
+   * meanwhile are dropped by ClearPlanCache once they are done.
+   */
+  static std::unique_ptr<GraphDB> Swap(std::unique_ptr<GraphDB>&& db);
+
+  // Drops the plans of the cypher strings, cached by query text for the
+  // schema of the running graph.
+  static void ClearPlanCache();
+
+  /**
+   * @brief Hosts db, opened with config().standby, beside the running
+   * instance, as graph_id, so that one server serves the queries of several
+   * graphs with the same shards and threads. Each hosted graph keeps its own
+   * sessions, memory budget and caches; the process-wide runtime state is
+   * that of the running instance, so the queries of a hosted graph are the
+   * stored procedures and the compiled plans, not the cypher strings whose
+   * plans are cached by query text.
+   *
+   * @return An error if a graph is hosted as graph_id already.
+   */
+  static Status Host(const std::string& graph_id,
+                     std::unique_ptr<GraphDB>&& db);
+
+  // The graph hosted as graph_id, or nullptr. The instance stays alive while
+  // the caller holds it, even if it is unhosted meanwhile.
+  static std::shared_ptr<GraphDB> get(const std::string& graph_id);
+
+  // Stops hosting graph_id, returning the instance if it was hosted, to be
+  // closed once the queries holding it are done.
+  static std::shared_ptr<GraphDB> Unhost(const std::string& graph_id);
+
+  static std::vector<std::string> HostedGraphs();
+
   /**
    * @brief Load the graph from data directory.
    * @param schema The schema of graph. It should be the same as the schema,
@@ -136,6 +288,13 @@ class GraphDB {
    */
   UpdateTransaction GetUpdateTransaction(int thread_id = 0);
 
+  /** @brief Create a transaction to set properties of existing vertices,
+   * which does not wait for the running transactions to finish.
+   *
+   * @return PropertyUpdateTransaction
+   */
+  PropertyUpdateTransaction GetPropertyUpdateTransaction(int thread_id = 0);
+
   inline const MutablePropertyFragment& graph() const { return graph_; }
   inline MutablePropertyFragment& graph() { return graph_; }
 
@@ -158,8 +317,43 @@ class GraphDB {
   GraphDBSession& GetSession(int thread_id);
   const GraphDBSession& GetSession(int thread_id) const;
 
+  // Under NumaPolicy::kInterleaveBindSessions, binds the calling thread to
+  // the node owning the block of sessions thread_id is in. Called once by a
+  // thread that drives the session, when it starts.
+  void BindSessionThread(int thread_id) const;
+
+  // Waits until no session runs a read, e.g. one streaming its result, for
+  // an instance no query starts on anymore to be closed.
+  void WaitForReads() const;
+
   int SessionNum() const;
 
+  // Sum of the memory usage of the allocators of the sessions, which hold
+  // the adjacency lists and strings written since the graph was loaded.
+  MemoryUsage AllocatorMemoryUsage() const;
+
+  WarmupProgress GetWarmupProgress() const;
+
+  ReplicationStatus GetReplicationStatus() const;
+
+  // The latencies of the procedures, as histograms summed over the sessions,
+  // and the number and time of the queries, in the Prometheus text format.
+  std::string PrometheusMetrics() const;
+
+  /**
+   * @brief Writes the graph as a new snapshot version of the work directory,
+   * and deletes the wal segments it covers.
+   *
+   * The wal writers are reopened on new segments, and the segments they
+   * closed are sealed in the WalManifest of the wal directory with the
+   * timestamp of the snapshot. Once the snapshot version is set, opening the
+   * graph replays the wals after that timestamp only. The graph is opened
+   * again from the snapshot before reads and writes resume.
+   *
+   * @return The timestamp up to which the snapshot covers the wals.
+   */
+  Result<uint32_t> CreateSnapshot();
+
   void UpdateCompactionTimestamp(timestamp_t ts);
   timestamp_t GetLastCompactionTimestamp() const;
 
@@ -169,11 +363,26 @@ class GraphDB {
 
   inline const GraphDBConfig& config() const { return config_; }
 
+  // nullptr unless config().result_cache_capacity is set.
+  ResultCache* result_cache() const { return result_cache_.get(); }
+
+  // nullptr unless config().incremental_pagerank_vertex_label and
+  // incremental_pagerank_edge_label are set.
+  IncrementalPageRank* incremental_pagerank() const {
+    return incremental_pagerank_.get();
+  }
+
+  // Passed the inserts committed on the graph.
+  IInsertListener* insert_listener() const {
+    return incremental_pagerank_.get();
+  }
+
  private:
   bool registerApp(const std::string& path, uint8_t index = 0);
 
+  // Replays the wals after snapshot_ts.
   void ingestWals(IWalParser& parser, const std::string& work_dir,
-                  int thread_num);
+                  int thread_num, uint32_t snapshot_ts);
 
   void initApps(
       const std::unordered_map<std::string, std::pair<std::string, uint8_t>>&
@@ -183,15 +392,46 @@ class GraphDB {
                                 const std::string& data_dir,
                                 MemoryStrategy allocator_strategy);
 
+  // Commits the wal records of a frame of the primary, each one in a
+  // transaction of its own, and the timestamps without a record up to
+  // primary_ts.
+  void applyReplicatedWals(char* data, size_t size, uint32_t primary_ts);
+
+  // Sets the plugins of schema on the schema of graph_, which does not
+  // serialize them.
+  void setPlugins(const Schema& schema, const std::string& compiler_path);
+
+  // Opens graph_ again from the latest snapshot of the work directory, which
+  // a dump of the graph leaves unusable. The update timestamp must be held.
+  void reopenGraph();
+
+  // Sets up the runtime state shared by the instances of the process.
+  void initRuntime(const GraphDBConfig& config);
+
   void showAppMetrics() const;
 
+  void warmup(const GraphDBConfig& config);
+  void stopWarmup();
+
   size_t getExecutedQueryNum() const;
 
+  // Runs on compact_thread_ until it is stopped.
+  void autoCompact(const CompactionPolicy& policy);
+  // Returns false if the compaction thread is stopped before us elapse.
+  bool compactionSleep(int64_t us);
+  // Regenerates statistics.json once a compaction has finished, holding the
+  // update timestamp so that the csrs are not written meanwhile.
+  void refreshStatistics();
+
+  // Runs on snapshot_thread_ until it is stopped.
+  void autoSnapshot(int interval);
+  void stopAutoSnapshot();
+
   friend class GraphDBSession;
 
   GraphDBConfig config_;
   std::string work_dir_;
-  SessionLocalContext* contexts_;
+  SessionLocalContext* contexts_ = nullptr;
 
   int thread_num_;
 
@@ -205,8 +445,30 @@ class GraphDB {
   bool monitor_thread_running_;
 
   timestamp_t last_compaction_ts_;
-  bool compact_thread_running_ = false;
+  std::atomic<bool> compact_thread_running_{false};
   std::thread compact_thread_;
+
+  std::string wal_uri_;
+  std::mutex snapshot_mutex_;
+  std::atomic<bool> snapshot_thread_running_{false};
+  std::thread snapshot_thread_;
+
+  std::atomic<bool> warmup_running_{false};
+  std::thread warmup_thread_;
+  mutable std::mutex warmup_mutex_;
+  WarmupProgress warmup_progress_;
+
+  std::unique_ptr<WalShipper> wal_shipper_;
+  std::unique_ptr<WalReceiver> wal_receiver_;
+  // A follower logs and applies the wals of its primary with these, which no
+  // session shares.
+  std::unique_ptr<Allocator> receiver_allocator_;
+  std::unique_ptr<IWalWriter> receiver_logger_;
+  uint32_t replicated_ts_ = 0;
+
+  std::unique_ptr<ResultCache> result_cache_;
+
+  std::unique_ptr<IncrementalPageRank> incremental_pagerank_;
 };
 
 }  // namespace gs
@@ -114,6 +114,51 @@ Result<std::string> GraphDBOperations::CreateEdge(
   }
   return Result<std::string>(insert_result);
 }
+
+Result<std::string> GraphDBOperations::BulkCreateEdge(
+    GraphDBSession& session, rapidjson::Document&& input_json) {
+  if (input_json.IsArray() == false || input_json.Size() == 0) {
+    return Result<std::string>(gs::Status(
+        StatusCode::INVALID_SCHEMA,
+        "Invalid input json, edge batches should be array and not empty"));
+  }
+  const Schema& schema = session.schema();
+  std::vector<EdgeBatchData> batches;
+  try {
+    for (auto& batch_json : input_json.GetArray()) {
+      batches.push_back(inputEdgeBatch(batch_json, schema));
+    }
+  } catch (std::exception& e) {
+    return Result<std::string>(
+        gs::Status(StatusCode::INVALID_SCHEMA,
+                   " Bad input parameter : " + std::string(e.what())));
+  }
+  size_t edge_num = 0;
+  auto txnWrite = session.GetInsertTransaction();
+  for (auto& batch : batches) {
+    if (txnWrite.AddEdges(batch.src_label_id, batch.dst_label_id,
+                          batch.edge_label_id, batch.src_pk_values,
+                          batch.dst_pk_values,
+                          batch.property_columns) == false) {
+      txnWrite.Abort();
+      return Result<std::string>(
+          gs::Status(StatusCode::INVALID_SCHEMA,
+                     "Fail to create edges; All inserts are rollbacked"));
+    }
+    edge_num += batch.src_pk_values.size();
+  }
+  if (txnWrite.Commit() == false) {
+    return Result<std::string>(
+        gs::Status(StatusCode::INTERNAL_ERROR, "Fail to commit edges"));
+  }
+  rapidjson::Document result(rapidjson::kObjectType);
+  result.AddMember("message", "Edge data is successfully inserted",
+                   result.GetAllocator());
+  result.AddMember("edge_num", static_cast<uint64_t>(edge_num),
+                   result.GetAllocator());
+  return Result<std::string>(rapidjson_stringify(result));
+}
+
 Result<std::string> GraphDBOperations::UpdateVertex(
     GraphDBSession& session, rapidjson::Document&& input_json) {
   std::vector<VertexData> vertex_data;
@@ -258,6 +303,54 @@ Result<std::string> GraphDBOperations::DeleteEdge(
   return Result<std::string>(StatusCode::UNIMPLEMENTED,
                              "delete_edge is not implemented");
 }
+Result<std::string> GraphDBOperations::AddVertexProperty(
+    GraphDBSession& session, rapidjson::Document&& input_json) {
+  PropertyType type;
+  StorageStrategy strategy = StorageStrategy::kMem;
+  if (!input_json.IsObject() || !input_json.HasMember("label") ||
+      !input_json.HasMember("property_name") ||
+      !input_json.HasMember("property_type") ||
+      !input_json["property_type"].IsObject() ||
+      !from_json(input_json["property_type"], type)) {
+    return Result<std::string>(
+        gs::Status(StatusCode::INVALID_ARGUMENT,
+                   "Invalid input json, label, property_name and "
+                   "property_type are required"));
+  }
+  if (input_json.HasMember("storage_strategy") &&
+      jsonToString(input_json["storage_strategy"]) == "Disk") {
+    strategy = StorageStrategy::kDisk;
+  }
+  auto status = session.AddVertexProperty(
+      jsonToString(input_json["label"]),
+      jsonToString(input_json["property_name"]), type, strategy);
+  if (status.ok()) {
+    rapidjson::Document result(rapidjson::kObjectType);
+    result.AddMember("message", "Successfully add vertex property",
+                     result.GetAllocator());
+    return Result<std::string>(rapidjson_stringify(result));
+  }
+  return Result<std::string>(status);
+}
+Result<std::string> GraphDBOperations::DropVertexProperty(
+    GraphDBSession& session, rapidjson::Document&& input_json) {
+  if (!input_json.IsObject() || !input_json.HasMember("label") ||
+      !input_json.HasMember("property_name")) {
+    return Result<std::string>(
+        gs::Status(StatusCode::INVALID_ARGUMENT,
+                   "Invalid input json, label and property_name are required"));
+  }
+  auto status =
+      session.DropVertexProperty(jsonToString(input_json["label"]),
+                                 jsonToString(input_json["property_name"]));
+  if (status.ok()) {
+    rapidjson::Document result(rapidjson::kObjectType);
+    result.AddMember("message", "Successfully drop vertex property",
+                     result.GetAllocator());
+    return Result<std::string>(rapidjson_stringify(result));
+  }
+  return Result<std::string>(status);
+}
 
 VertexData GraphDBOperations::inputVertex(const rapidjson::Value& vertex_json,
                                           const Schema& schema,
@@ -343,6 +436,63 @@ EdgeData GraphDBOperations::inputEdge(const rapidjson::Value& edge_json,
   return edge;
 }
 
+EdgeBatchData GraphDBOperations::inputEdgeBatch(
+    const rapidjson::Value& batch_json, const Schema& schema) {
+  EdgeBatchData batch;
+  batch.src_label_id =
+      schema.get_vertex_label_id(jsonToString(batch_json["src_label"]));
+  batch.dst_label_id =
+      schema.get_vertex_label_id(jsonToString(batch_json["dst_label"]));
+  batch.edge_label_id =
+      schema.get_edge_label_id(jsonToString(batch_json["edge_label"]));
+  auto input_column = [&](const rapidjson::Value& column_json,
+                          const std::string& name, PropertyType type,
+                          std::vector<Any>& column) {
+    if (!column_json.IsArray()) {
+      throw std::runtime_error(name + " should be array");
+    }
+    column.reserve(column_json.Size());
+    for (auto& value : column_json.GetArray()) {
+      column.push_back(ConvertStringToAny(jsonToString(value), type));
+    }
+  };
+  if (!batch_json.HasMember("src_primary_key_values") ||
+      !batch_json.HasMember("dst_primary_key_values")) {
+    throw std::runtime_error(
+        "src_primary_key_values and dst_primary_key_values are required");
+  }
+  input_column(
+      batch_json["src_primary_key_values"], "src_primary_key_values",
+      std::get<0>(schema.get_vertex_primary_key(batch.src_label_id)[0]),
+      batch.src_pk_values);
+  input_column(
+      batch_json["dst_primary_key_values"], "dst_primary_key_values",
+      std::get<0>(schema.get_vertex_primary_key(batch.dst_label_id)[0]),
+      batch.dst_pk_values);
+  if (batch.src_pk_values.size() != batch.dst_pk_values.size()) {
+    throw std::runtime_error(
+        "src_primary_key_values and dst_primary_key_values size not match");
+  }
+
+  const auto& names = schema.get_edge_property_names(
+      batch.src_label_id, batch.dst_label_id, batch.edge_label_id);
+  const auto& types = schema.get_edge_properties(
+      batch.src_label_id, batch.dst_label_id, batch.edge_label_id);
+  batch.property_columns.resize(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!batch_json.HasMember("properties") ||
+        !batch_json["properties"].HasMember(names[i].c_str())) {
+      throw std::runtime_error("property " + names[i] + " not found");
+    }
+    input_column(batch_json["properties"][names[i].c_str()], names[i],
+                 types[i], batch.property_columns[i]);
+    if (batch.property_columns[i].size() != batch.src_pk_values.size()) {
+      throw std::runtime_error("property " + names[i] + " size not match");
+    }
+  }
+  return batch;
+}
+
 Status GraphDBOperations::checkVertexSchema(
     const Schema& schema, VertexData& vertex, const std::string& label,
     std::vector<std::string>& input_property_names, bool is_get) {
@@ -351,15 +501,24 @@ Status GraphDBOperations::checkVertexSchema(
     PropertyType colType =
         std::get<0>(schema.get_vertex_primary_key(vertex.label_id)[0]);
     vertex.pk_value = ConvertStringToAny(vertex.pk_value.to_string(), colType);
-    auto properties_type = schema.get_vertex_properties(vertex.label_id);
-    auto properties_name = schema.get_vertex_property_names(vertex.label_id);
-    if (vertex.properties.size() != properties_name.size() && is_get == false) {
-      throw std::runtime_error("properties size not match");
-    }
     if (is_get) {
-      input_property_names = properties_name;
+      input_property_names = schema.get_vertex_property_names(vertex.label_id);
       return Status::OK();
     }
+    // The properties dropped but not compacted yet are left out.
+    std::vector<PropertyType> properties_type;
+    std::vector<std::string> properties_name;
+    const auto& types = schema.get_vertex_properties(vertex.label_id);
+    const auto& names = schema.get_vertex_property_names(vertex.label_id);
+    for (size_t i = 0; i < types.size(); ++i) {
+      if (!schema.is_dropped_vertex_property(vertex.label_id, i)) {
+        properties_type.push_back(types[i]);
+        properties_name.push_back(names[i]);
+      }
+    }
+    if (vertex.properties.size() != properties_name.size()) {
+      throw std::runtime_error("properties size not match");
+    }
     for (int col_index = 0; col_index < int(properties_name.size());
          col_index++) {
       if (input_property_names[col_index] != properties_name[col_index]) {
@@ -429,6 +588,10 @@ Status GraphDBOperations::checkEdgeExistsWithInsert(
         // It could be that this point is about to be inserted
         continue;
       }
+      if (!txn.MayHaveEdge(edge.src_label_id, src_vid, edge.dst_label_id,
+                           dst_vid, edge.edge_label_id)) {
+        continue;
+      }
       // If the edge already exists, just report the error
       for (auto edgeIt =
                txn.GetOutEdgeIterator(edge.src_label_id, src_vid,
@@ -459,6 +622,10 @@ Status GraphDBOperations::checkEdgeExists(
         txn.Abort();
         throw std::runtime_error("Vertex not exists");
       }
+      if (!txn.MayHaveEdge(edge.src_label_id, src_vid, edge.dst_label_id,
+                           dst_vid, edge.edge_label_id)) {
+        continue;
+      }
       // If the edge already exists, just report the error
       for (auto edgeIt =
                txn.GetOutEdgeIterator(edge.src_label_id, src_vid,
@@ -617,8 +784,15 @@ Status GraphDBOperations::updateVertex(std::vector<VertexData>&& vertex_data,
     }
     txnRead.Commit();
     auto txnWrite = session.GetUpdateTransaction();
-    for (int i = 0; i < int(vertex.properties.size()); i++) {
-      if (txnWrite.SetVertexField(vertex.label_id, vertex_lid, i,
+    // The properties are given but those dropped, which keep their ids until
+    // a compaction.
+    int col_id = 0;
+    for (int i = 0; i < int(vertex.properties.size()); i++, col_id++) {
+      while (txnWrite.schema().is_dropped_vertex_property(vertex.label_id,
+                                                          col_id)) {
+        ++col_id;
+      }
+      if (txnWrite.SetVertexField(vertex.label_id, vertex_lid, col_id,
                                   vertex.properties[i]) == false) {
         txnWrite.Abort();
         throw std::runtime_error("Fail to update vertex");
@@ -645,6 +819,11 @@ Status GraphDBOperations::updateEdge(std::vector<EdgeData>&& edge_data,
       throw std::runtime_error("Vertex not found");
     }
     bool edge_exists = false;
+    if (!txn.MayHaveEdge(edge.src_label_id, src_vid, edge.dst_label_id,
+                         dst_vid, edge.edge_label_id)) {
+      txn.Abort();
+      throw std::runtime_error("Edge not found");
+    }
     for (auto edgeIt = txn.GetOutEdgeIterator(
              edge.src_label_id, src_vid, edge.dst_label_id, edge.edge_label_id);
          edgeIt.IsValid(); edgeIt.Next()) {
@@ -682,6 +861,9 @@ Result<rapidjson::Value> GraphDBOperations::getVertex(
       throw std::runtime_error("Vertex not found");
     }
     for (int i = 0; i < vertex_db.FieldNum(); i++) {
+      if (txn.schema().is_dropped_vertex_property(vertex.label_id, i)) {
+        continue;
+      }
       rapidjson::Document values(rapidjson::kObjectType, &allocator);
       values.AddMember("name", property_names[i], allocator);
       values.AddMember("value", vertex_db.GetField(i).to_string(), allocator);
@@ -43,12 +43,27 @@ struct EdgeData {
   ~EdgeData() {}
 };
 
+// The edges of a triplet, in columns.
+struct EdgeBatchData {
+  label_t src_label_id, dst_label_id, edge_label_id;
+  std::vector<Any> src_pk_values, dst_pk_values;
+  // One column per property of the triplet.
+  std::vector<std::vector<Any>> property_columns;
+};
+
 class GraphDBOperations {
  public:
   static Result<std::string> CreateVertex(GraphDBSession& session,
                                           rapidjson::Document&& input_json);
   static Result<std::string> CreateEdge(GraphDBSession& session,
                                         rapidjson::Document&& input_json);
+  // Inserts batches of edges in a single transaction. Each batch holds the
+  // edges of a triplet in columns: src_primary_key_values,
+  // dst_primary_key_values and, in properties, an array of values per
+  // property name. Unlike CreateEdge, it does not check whether the edges
+  // exist already.
+  static Result<std::string> BulkCreateEdge(GraphDBSession& session,
+                                            rapidjson::Document&& input_json);
   static Result<std::string> UpdateVertex(GraphDBSession& session,
                                           rapidjson::Document&& input_json);
   static Result<std::string> UpdateEdge(GraphDBSession& session,
@@ -63,6 +78,13 @@ class GraphDBOperations {
                                           rapidjson::Document&& input_json);
   static Result<std::string> DeleteEdge(GraphDBSession& session,
                                         rapidjson::Document&& input_json);
+  // Adds the property_name of property_type to the vertex label, see
+  // GraphDBSession::AddVertexProperty. storage_strategy may be "Disk".
+  static Result<std::string> AddVertexProperty(
+      GraphDBSession& session, rapidjson::Document&& input_json);
+  // Drops the property_name of the vertex label.
+  static Result<std::string> DropVertexProperty(
+      GraphDBSession& session, rapidjson::Document&& input_json);
 
  private:
   // The following interfaces are called before the Transaction is constructed
@@ -70,6 +92,8 @@ class GraphDBOperations {
                                 const Schema& schema, GraphDBSession& session);
   static EdgeData inputEdge(const rapidjson::Value& edge_json,
                             const Schema& schema, GraphDBSession& session);
+  static EdgeBatchData inputEdgeBatch(const rapidjson::Value& batch_json,
+                                      const Schema& schema);
   // check schema
   static Status checkVertexSchema(
       const Schema& schema, VertexData& vertex, const std::string& label,
@@ -13,54 +13,209 @@
  * limitations under the License.
  */
 
+#include <string.h>
+
 #include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
 
 #include "flex/engines/graph_db/app/app_base.h"
+#include "flex/engines/graph_db/app/cypher_write_app.h"
 #include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/database/wal/wal.h"
+#include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
 #include "flex/utils/app_utils.h"
+#include "flex/utils/sampling_profiler.h"
 
 #include "flex/proto_generated_gie/stored_procedure.pb.h"
 #include "service_utils.h"
 
 #include <rapidjson/document.h>
+#include <yaml-cpp/yaml.h>
 
 namespace gs {
 
 ReadTransaction GraphDBSession::GetReadTransaction() const {
-  uint32_t ts = db_.version_manager_.acquire_read_timestamp();
+  uint32_t ts = db_.version_manager_.acquire_read_timestamp(thread_id_);
   return ReadTransaction(*this, db_.graph_, db_.version_manager_, ts);
 }
 
+// The timestamps of a follower are taken by its receiver alone, in the order
+// of the primary.
+void GraphDBSession::checkWritable() const {
+  if (db_.wal_receiver_ != nullptr) {
+    throw std::runtime_error("A follower serves reads only");
+  }
+}
+
 InsertTransaction GraphDBSession::GetInsertTransaction() {
+  checkWritable();
   uint32_t ts = db_.version_manager_.acquire_insert_timestamp();
   return InsertTransaction(*this, db_.graph_, alloc_, logger_,
-                           db_.version_manager_, ts);
+                           db_.version_manager_, staged_vertices_, ts,
+                           db_.insert_listener());
 }
 
 SingleVertexInsertTransaction
 GraphDBSession::GetSingleVertexInsertTransaction() {
+  checkWritable();
   uint32_t ts = db_.version_manager_.acquire_insert_timestamp();
   return SingleVertexInsertTransaction(db_.graph_, alloc_, logger_,
-                                       db_.version_manager_, ts);
+                                       db_.version_manager_, ts,
+                                       db_.insert_listener());
 }
 
 SingleEdgeInsertTransaction GraphDBSession::GetSingleEdgeInsertTransaction() {
+  checkWritable();
   uint32_t ts = db_.version_manager_.acquire_insert_timestamp();
   return SingleEdgeInsertTransaction(db_.graph_, alloc_, logger_,
-                                     db_.version_manager_, ts);
+                                     db_.version_manager_, ts,
+                                     db_.insert_listener());
 }
 
 UpdateTransaction GraphDBSession::GetUpdateTransaction() {
+  checkWritable();
   uint32_t ts = db_.version_manager_.acquire_update_timestamp();
   return UpdateTransaction(*this, db_.graph_, alloc_, work_dir_, logger_,
                            db_.version_manager_, ts);
 }
 
+PropertyUpdateTransaction GraphDBSession::GetPropertyUpdateTransaction() {
+  checkWritable();
+  return PropertyUpdateTransaction(db_.graph_, logger_, db_.version_manager_);
+}
+
 bool GraphDBSession::BatchUpdate(UpdateBatch& batch) {
   return GetUpdateTransaction().batch_commit(batch);
 }
 
+// Keeps the graph.yaml the compiler plans cypher queries with in step with
+// a vertex property added, or dropped if type is null.
+static void rewrite_graph_yaml(const std::string& path,
+                               const std::string& label,
+                               const std::string& prop_name,
+                               const PropertyType* type,
+                               StorageStrategy strategy) {
+  if (!std::filesystem::exists(path)) {
+    return;
+  }
+  try {
+    YAML::Node root = YAML::LoadFile(path);
+    for (auto vertex : root["schema"]["vertex_types"]) {
+      if (vertex["type_name"].as<std::string>() != label) {
+        continue;
+      }
+      YAML::Node props = vertex["properties"];
+      YAML::Node kept(YAML::NodeType::Sequence);
+      int max_id = -1;
+      for (auto prop : props) {
+        max_id = std::max(max_id, prop["property_id"].as<int>());
+        if (type != nullptr ||
+            prop["property_name"].as<std::string>() != prop_name) {
+          kept.push_back(prop);
+        }
+      }
+      if (type != nullptr) {
+        YAML::Node prop;
+        prop["property_id"] = max_id + 1;
+        prop["property_name"] = prop_name;
+        prop["property_type"] = *type;
+        if (strategy == StorageStrategy::kDisk) {
+          prop["x_csr_params"]["storage_strategy"] = "Disk";
+        } else if (strategy == StorageStrategy::kCompressed) {
+          prop["x_csr_params"]["storage_strategy"] = "Compressed";
+        }
+        kept.push_back(prop);
+      }
+      vertex["properties"] = kept;
+    }
+    YAML::Emitter emitter;
+    emitter << root;
+    std::ofstream out(path);
+    out << emitter.c_str();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to rewrite " << path << ": " << e.what();
+  }
+}
+
+Status GraphDBSession::AddVertexProperty(const std::string& label,
+                                         const std::string& prop_name,
+                                         const PropertyType& type,
+                                         StorageStrategy strategy) {
+  return changeVertexProperty(label, prop_name, &type, strategy);
+}
+
+Status GraphDBSession::DropVertexProperty(const std::string& label,
+                                          const std::string& prop_name) {
+  return changeVertexProperty(label, prop_name, nullptr,
+                              StorageStrategy::kMem);
+}
+
+Status GraphDBSession::changeVertexProperty(const std::string& label,
+                                            const std::string& prop_name,
+                                            const PropertyType* type,
+                                            StorageStrategy strategy) {
+  if (db_.wal_receiver_ != nullptr) {
+    return Status(StatusCode::UNSUPPORTED_OPERATION,
+                  "A follower changes the schema as its leader does");
+  }
+  auto& vm = db_.version_manager_;
+  // Waits for the reads and inserts in flight, which hold column ids.
+  timestamp_t ts = vm.acquire_update_timestamp();
+  const auto& schema = db_.graph_.schema();
+  Status status = Status::OK();
+  if (!schema.contains_vertex_label(label)) {
+    status = Status(StatusCode::NOT_FOUND, "No vertex label " + label);
+  } else if (type != nullptr) {
+    if (schema.vertex_has_property(label, prop_name)) {
+      status = Status(StatusCode::ALREADY_EXISTS,
+                      "Vertex label " + label + " has property " + prop_name);
+    }
+  } else if (schema.vertex_has_primary_key(label, prop_name)) {
+    status = Status(StatusCode::INVALID_ARGUMENT,
+                    "The primary key " + prop_name + " can not be dropped");
+  } else if (!schema.vertex_has_property(label, prop_name)) {
+    status = Status(StatusCode::NOT_FOUND,
+                    "Vertex label " + label + " has no property " + prop_name);
+  }
+  if (!status.ok()) {
+    vm.release_update_timestamp(ts);
+    return status;
+  }
+
+  label_t label_id = schema.get_vertex_label_id(label);
+  grape::InArchive arc;
+  arc.Resize(sizeof(WalHeader));
+  arc << static_cast<uint8_t>(type != nullptr ? 5 : 6) << label_id
+      << prop_name;
+  if (type != nullptr) {
+    arc << *type << strategy;
+  }
+  auto* header = reinterpret_cast<WalHeader*>(arc.GetBuffer());
+  header->length = arc.GetSize() - sizeof(WalHeader);
+  header->type = 1;
+  header->timestamp = ts;
+  if (!logger_.append(arc.GetBuffer(), arc.GetSize())) {
+    vm.release_update_timestamp(ts);
+    return Status(StatusCode::IO_ERROR, "Failed to append wal log");
+  }
+  if (type != nullptr) {
+    db_.graph_.AddVertexProperty(label_id, prop_name, *type, strategy, ts);
+  } else {
+    db_.graph_.DropVertexProperty(label_id, prop_name);
+  }
+  runtime::CypherRunnerImpl::get().clear_cache();
+  rewrite_graph_yaml(db_.work_dir() + "/graph.yaml", label, prop_name, type,
+                     strategy);
+  LabelSet labels;
+  labels.add_all();
+  vm.record_write(labels, ts);
+  vm.release_update_timestamp(ts);
+  return Status::OK();
+}
+
 const MutablePropertyFragment& GraphDBSession::graph() const {
   return db_.graph();
 }
@@ -108,6 +263,16 @@ std::shared_ptr<RefColumnBase> GraphDBSession::get_vertex_id_column(
 }
 
 Result<std::vector<char>> GraphDBSession::Eval(const std::string& input) {
+  return eval(input, nullptr);
+}
+
+Result<std::vector<char>> GraphDBSession::Eval(
+    const std::string& input, std::unique_ptr<ResultStream>& stream) {
+  return eval(input, &stream);
+}
+
+Result<std::vector<char>> GraphDBSession::eval(
+    const std::string& input, std::unique_ptr<ResultStream>* stream) {
   const auto start = std::chrono::high_resolution_clock::now();
 
   if (input.size() < 2) {
@@ -138,18 +303,85 @@ Result<std::vector<char>> GraphDBSession::Eval(const std::string& input) {
         StatusCode::NOT_FOUND,
         "Procedure not found, id:" + std::to_string((int) type), result_buffer);
   }
+  if (db_.wal_receiver_ != nullptr && app->mode() != AppBase::AppMode::kRead) {
+    return Result<std::vector<char>>(StatusCode::UNSUPPORTED_OPERATION,
+                                     "A follower serves reads only",
+                                     result_buffer);
+  }
+  // The samples of the profiler are tagged with the procedure, and by the
+  // cypher apps with the query.
+  SamplingProfiler::RegisterCurrentThread("session", thread_id_);
+  char tag[16];
+  snprintf(tag, sizeof(tag), "procedure_%d", static_cast<int>(type));
+  SampleTagScope tag_scope(tag);
+
+  auto record_success = [&]() {
+    const auto end = std::chrono::high_resolution_clock::now();
+    app_metrics_[type].add_record(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count());
+    eval_duration_.fetch_add(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count());
+    ++query_num_;
+  };
+
+  // The read timestamp is taken before the query runs, so that an entry is
+  // dropped on any write the query may have missed.
+  ResultCache* cache =
+      app->mode() == AppBase::AppMode::kRead ? db_.result_cache() : nullptr;
+  uint32_t cache_ts = 0;
+  if (cache != nullptr) {
+    if (cache->get(input, result_buffer)) {
+      record_success();
+      return result_buffer;
+    }
+    cache_ts = db_.version_manager_.read_ts();
+  }
+
+  // The deadline and the budget hold for the retries as well.
+  RunningGuard running_guard(*this);
+  auto& guard = running_guard.guard();
 
   for (size_t i = 0; i < MAX_RETRY; ++i) {
     result_buffer.clear();
-    if (app->run(*this, decoder, encoder)) {
+    bool ok;
+    try {
+      ok = stream == nullptr
+               ? app->run(*this, decoder, encoder)
+               : app->run_stream(*this, decoder, encoder, *stream);
+    } catch (const runtime::QueryAborted&) {
+      ok = false;
+    }
+    if (!ok && guard.reason() != runtime::QueryGuard::Reason::kNone) {
+      // Not retried, the query would be aborted again.
       const auto end = std::chrono::high_resolution_clock::now();
-      app_metrics_[type].add_record(
-          std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-              .count());
       eval_duration_.fetch_add(
           std::chrono::duration_cast<std::chrono::microseconds>(end - start)
               .count());
       ++query_num_;
+      if (stream != nullptr) {
+        stream->reset();
+      }
+      LOG(ERROR) << "[Query-" << (int) type << "][Thread-" << thread_id_
+                 << "] " << guard.message();
+      StatusCode code = StatusCode::QUERY_FAILED;
+      if (guard.reason() == runtime::QueryGuard::Reason::kTimeout) {
+        code = StatusCode::TIMEOUT;
+      } else if (guard.reason() == runtime::QueryGuard::Reason::kMemory) {
+        code = StatusCode::RESOURCE_EXHAUSTED;
+      }
+      return Result<std::vector<char>>(code, guard.message(),
+                                       std::vector<char>());
+    }
+    if (ok) {
+      record_success();
+      // A result left partly in the stream is not cached.
+      LabelSet labels;
+      if (cache != nullptr && (stream == nullptr || *stream == nullptr) &&
+          app->cached_labels(labels)) {
+        cache->put(input, cache_ts, labels, result_buffer);
+      }
       return result_buffer;
     }
 
@@ -160,6 +392,9 @@ Result<std::vector<char>> GraphDBSession::Eval(const std::string& input) {
     }
 
     decoder.reset(sv.data(), sv.size());
+    if (stream != nullptr) {
+      stream->reset();
+    }
   }
 
   const auto end = std::chrono::high_resolution_clock::now();
@@ -186,11 +421,177 @@ Result<std::vector<char>> GraphDBSession::Eval(const std::string& input) {
   }
 }
 
+Result<std::vector<char>> GraphDBSession::EvalBatch(const std::string& input) {
+  std::vector<std::string_view> requests;
+  size_t pos = 0;
+  while (pos < input.size()) {
+    int len = 0;
+    if (input.size() - pos < sizeof(int)) {
+      return Result<std::vector<char>>(
+          StatusCode::INVALID_ARGUMENT,
+          "Truncated batch at offset " + std::to_string(pos),
+          std::vector<char>());
+    }
+    memcpy(&len, input.data() + pos, sizeof(int));
+    pos += sizeof(int);
+    if (len < 0 || input.size() - pos < static_cast<size_t>(len)) {
+      return Result<std::vector<char>>(
+          StatusCode::INVALID_ARGUMENT,
+          "Invalid request length in batch: " + std::to_string(len),
+          std::vector<char>());
+    }
+    requests.emplace_back(input.data() + pos, len);
+    pos += len;
+  }
+
+  std::vector<char> result_buffer;
+  Encoder encoder(result_buffer);
+  size_t group_size = db_.config().cypher_write_group_size;
+  for (size_t i = 0; i < requests.size();) {
+    if (group_size > 0 && is_cypher_write(requests[i])) {
+      size_t end = i + 1;
+      while (end < requests.size() && end - i < group_size &&
+             is_cypher_write(requests[end])) {
+        ++end;
+      }
+      if (evalCypherWrites(requests, i, end, encoder)) {
+        i = end;
+        continue;
+      }
+      // Run one by one, so that only the failing ones fail.
+      for (; i < end; ++i) {
+        evalBatched(std::string(requests[i]), encoder);
+      }
+      continue;
+    }
+    evalBatched(std::string(requests[i++]), encoder);
+  }
+  return result_buffer;
+}
+
+bool GraphDBSession::is_cypher_write(std::string_view request) {
+  return request.size() >= 2 &&
+         request.back() == static_cast<char>(InputFormat::kCypherString) &&
+         static_cast<uint8_t>(request[request.size() - 2]) ==
+             Schema::CYPHER_WRITE_PLUGIN_ID;
+}
+
+GraphDBSession::RunningGuard::RunningGuard(GraphDBSession& session)
+    : session_(session),
+      guard_(session.query_timeout_ms_.load(std::memory_order_relaxed) >= 0
+                 ? session.query_timeout_ms_.load(std::memory_order_relaxed)
+                 : session.db_.config().query_timeout_ms,
+             session.db_.config().query_memory_budget),
+      scope_(&guard_) {
+  std::lock_guard<std::mutex> lock(session_.guard_mutex_);
+  session_.running_guard_ = &guard_;
+}
+
+GraphDBSession::RunningGuard::~RunningGuard() {
+  std::lock_guard<std::mutex> lock(session_.guard_mutex_);
+  session_.running_guard_ = nullptr;
+}
+
+bool GraphDBSession::evalCypherWrites(
+    const std::vector<std::string_view>& requests, size_t begin, size_t end,
+    Encoder& encoder) {
+  // Each write is rejected by eval on a follower.
+  if (db_.wal_receiver_ != nullptr) {
+    return false;
+  }
+  const auto start = std::chrono::high_resolution_clock::now();
+  auto app = dynamic_cast<CypherWriteApp*>(
+      GetApp(Schema::CYPHER_WRITE_PLUGIN_ID));
+  if (app == nullptr) {
+    return false;
+  }
+  // The format and the query type are dropped.
+  std::vector<std::string_view> queries;
+  for (size_t i = begin; i < end; ++i) {
+    queries.push_back(requests[i].substr(0, requests[i].size() - 2));
+  }
+  // As in eval, the deadline and the budget hold for the whole group.
+  RunningGuard running_guard(*this);
+  auto& guard = running_guard.guard();
+  bool ok;
+  try {
+    ok = app->QueryGroup(*this, queries);
+  } catch (const runtime::QueryAborted&) {
+    ok = false;
+  }
+  const auto end_time = std::chrono::high_resolution_clock::now();
+  int64_t duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end_time - start)
+          .count();
+  if (!ok && guard.reason() == runtime::QueryGuard::Reason::kNone) {
+    return false;
+  }
+  eval_duration_.fetch_add(duration);
+  query_num_ += end - begin;
+  if (!ok) {
+    // Not run one by one, each would be aborted again.
+    LOG(ERROR) << "[Query-" << static_cast<int>(Schema::CYPHER_WRITE_PLUGIN_ID)
+               << "][Thread-" << thread_id_ << "] " << guard.message();
+    for (size_t i = begin; i < end; ++i) {
+      encoder.put_byte(1);
+      encoder.put_string(guard.message());
+    }
+    return true;
+  }
+  // The writes of the group share its time evenly.
+  int64_t query_duration = duration / static_cast<int64_t>(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    app_metrics_[Schema::CYPHER_WRITE_PLUGIN_ID].add_record(query_duration);
+    // Cypher writes output nothing.
+    encoder.put_byte(0);
+    encoder.put_string_view(std::string_view());
+  }
+  return true;
+}
+
+void GraphDBSession::evalBatched(const std::string& request, Encoder& encoder) {
+  auto ret = Eval(request);
+  if (!ret.ok()) {
+    encoder.put_byte(1);
+    encoder.put_string(ret.status().error_message());
+    return;
+  }
+  const auto& output = ret.value();
+  std::string_view content(output.data(), output.size());
+  // As in the http handler, the outputs of cypher json and protobuf
+  // requests are written with put_string, whose length prefix is dropped.
+  uint8_t format = request.back();
+  if (format != static_cast<uint8_t>(InputFormat::kCppEncoder) &&
+      format != static_cast<uint8_t>(InputFormat::kCypherString)) {
+    if (content.size() < 4) {
+      encoder.put_byte(1);
+      encoder.put_string("Invalid output size: " +
+                         std::to_string(content.size()));
+      return;
+    }
+    content.remove_prefix(4);
+  }
+  encoder.put_byte(0);
+  encoder.put_string_view(content);
+}
+
+void GraphDBSession::CancelQuery() {
+  std::lock_guard<std::mutex> lock(guard_mutex_);
+  if (running_guard_ != nullptr) {
+    running_guard_->Cancel();
+  }
+}
+
+void GraphDBSession::SetQueryTimeout(int64_t timeout_ms) {
+  query_timeout_ms_.store(timeout_ms, std::memory_order_relaxed);
+}
+
 void GraphDBSession::GetAppInfo(Encoder& result) { db_.GetAppInfo(result); }
 
 int GraphDBSession::SessionId() const { return thread_id_; }
 
 CompactTransaction GraphDBSession::GetCompactTransaction() {
+  checkWritable();
   timestamp_t ts = db_.version_manager_.acquire_update_timestamp();
   return CompactTransaction(db_.graph_, logger_, db_.version_manager_, ts);
 }
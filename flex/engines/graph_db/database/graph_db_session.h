@@ -16,14 +16,18 @@
 #ifndef GRAPHSCOPE_DATABASE_GRAPH_DB_SESSION_H_
 #define GRAPHSCOPE_DATABASE_GRAPH_DB_SESSION_H_
 
+#include <mutex>
+
 #include "flex/engines/graph_db/app/app_base.h"
 #include "flex/engines/graph_db/database/compact_transaction.h"
 #include "flex/engines/graph_db/database/insert_transaction.h"
+#include "flex/engines/graph_db/database/property_update_transaction.h"
 #include "flex/engines/graph_db/database/read_transaction.h"
 #include "flex/engines/graph_db/database/single_edge_insert_transaction.h"
 #include "flex/engines/graph_db/database/single_vertex_insert_transaction.h"
 #include "flex/engines/graph_db/database/transaction_utils.h"
 #include "flex/engines/graph_db/database/update_transaction.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
 #include "flex/utils/property/column.h"
 #include "flex/utils/result.h"
@@ -56,6 +60,8 @@ class GraphDBSession {
         logger_(logger),
         work_dir_(work_dir),
         thread_id_(thread_id),
+        running_guard_(nullptr),
+        query_timeout_ms_(-1),
         eval_duration_(0),
         query_num_(0) {
     for (auto& app : apps_) {
@@ -66,6 +72,8 @@ class GraphDBSession {
 
   ReadTransaction GetReadTransaction() const;
 
+  // The write transactions throw std::runtime_error on a follower, which
+  // applies the writes of its primary only, and eval rejects write apps there.
   InsertTransaction GetInsertTransaction();
 
   SingleVertexInsertTransaction GetSingleVertexInsertTransaction();
@@ -74,10 +82,47 @@ class GraphDBSession {
 
   UpdateTransaction GetUpdateTransaction();
 
+  PropertyUpdateTransaction GetPropertyUpdateTransaction();
+
+  // Runs func on a property update transaction and commits it, again on a
+  // new one as long as the commit conflicts, up to max_retries times in all.
+  // func returns false to abort. Returns whether a commit succeeded.
+  template <typename FUNC_T>
+  bool RunPropertyUpdate(const FUNC_T& func, int max_retries = MAX_RETRY) {
+    for (int i = 0; i < max_retries; ++i) {
+      auto txn = GetPropertyUpdateTransaction();
+      if (!func(txn)) {
+        txn.Abort();
+        return false;
+      }
+      if (txn.Commit()) {
+        return true;
+      }
+      if (!txn.conflicted()) {
+        return false;
+      }
+    }
+    return false;
+  }
+
   CompactTransaction GetCompactTransaction();
 
   bool BatchUpdate(UpdateBatch& batch);
 
+  // Appends a property to the vertex label while the graph is served, as an
+  // update transaction. The existing vertices read the default value of the
+  // type until it is set. The cached cypher plans are dropped, and the
+  // graph.yaml of the work directory, if any, is rewritten for the compiler.
+  Status AddVertexProperty(const std::string& label,
+                           const std::string& prop_name,
+                           const PropertyType& type,
+                           StorageStrategy strategy = StorageStrategy::kMem);
+
+  // Removes a property, not the primary key, of the vertex label alike. Its
+  // storage is reclaimed by the next snapshot.
+  Status DropVertexProperty(const std::string& label,
+                            const std::string& prop_name);
+
   const MutablePropertyFragment& graph() const;
   MutablePropertyFragment& graph();
   const GraphDB& db() const;
@@ -92,6 +137,30 @@ class GraphDBSession {
 
   Result<std::vector<char>> Eval(const std::string& input);
 
+  // Like Eval, but the tail of the result may be left in stream, see
+  // AppBase::run_stream.
+  Result<std::vector<char>> Eval(const std::string& input,
+                                 std::unique_ptr<ResultStream>& stream);
+
+  // Runs the requests of a batch back to back, each encoded as the input of
+  // Eval and prefixed with its length as an int. For each request, the
+  // result holds a byte that is 0 if it succeeded, then its output or error
+  // message as by Encoder::put_string, with the length prefix that cypher
+  // outputs carry already dropped. A request failing does not stop the
+  // others; only a malformed batch fails as a whole. With
+  // GraphDBConfig::cypher_write_group_size, consecutive cypher writes run in
+  // one insert transaction, and one by one if any of them fails.
+  Result<std::vector<char>> EvalBatch(const std::string& input);
+
+  // Aborts the query Eval is running, if any, at its next cancellation
+  // check. Called from any thread, e.g. when the client has gone.
+  void CancelQuery();
+
+  // Overrides GraphDBConfig::query_timeout_ms for the queries of this
+  // session, e.g. 0 for no deadline on a session running background jobs.
+  // A negative value restores the one of the config.
+  void SetQueryTimeout(int64_t timeout_ms);
+
   void GetAppInfo(Encoder& result);
 
   int SessionId() const;
@@ -109,6 +178,46 @@ class GraphDBSession {
   AppBase* GetApp(const std::string& name);
 
  private:
+  Result<std::vector<char>> eval(const std::string& input,
+                                 std::unique_ptr<ResultStream>* stream);
+
+  // Adds the property if type is not null, drops it otherwise.
+  Status changeVertexProperty(const std::string& label,
+                              const std::string& prop_name,
+                              const PropertyType* type,
+                              StorageStrategy strategy);
+
+  static bool is_cypher_write(std::string_view request);
+
+  // Throws on a follower, see GetInsertTransaction.
+  void checkWritable() const;
+
+  // The guard of a query with the timeout and the budget of the session,
+  // installed for the calling thread and cancelled by CancelQuery while in
+  // scope.
+  class RunningGuard {
+   public:
+    explicit RunningGuard(GraphDBSession& session);
+    ~RunningGuard();
+
+    runtime::QueryGuard& guard() { return guard_; }
+
+   private:
+    GraphDBSession& session_;
+    runtime::QueryGuard guard_;
+    runtime::QueryGuardScope scope_;
+  };
+
+  // Runs the cypher writes [begin, end) of requests in one transaction under
+  // one guard, see CypherWriteApp::QueryGroup, and appends their results to
+  // encoder. Returns false with nothing appended if the group failed but for
+  // its guard, so that the writes are run one by one.
+  bool evalCypherWrites(const std::vector<std::string_view>& requests,
+                        size_t begin, size_t end, Encoder& encoder);
+
+  // Evals the request of a batch, appending its result to encoder.
+  void evalBatched(const std::string& request, Encoder& encoder);
+
   Result<std::pair<uint8_t, std::string_view>>
   parse_query_type_from_cypher_json(const std::string_view& input);
   Result<std::pair<uint8_t, std::string_view>>
@@ -184,6 +293,7 @@ class GraphDBSession {
   GraphDB& db_;
   Allocator& alloc_;
   IWalWriter& logger_;
+  StagedVertexSet staged_vertices_;
   std::string work_dir_;
   int thread_id_;
 
@@ -191,6 +301,11 @@ class GraphDBSession {
   std::array<AppBase*, MAX_PLUGIN_NUM> apps_;
   std::array<AppMetric, MAX_PLUGIN_NUM> app_metrics_;
 
+  // The guard of the query running, see CancelQuery.
+  std::mutex guard_mutex_;
+  runtime::QueryGuard* running_guard_;
+  std::atomic<int64_t> query_timeout_ms_;
+
   std::atomic<int64_t> eval_duration_;
   std::atomic<int64_t> query_num_;
 };
@@ -0,0 +1,186 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/incremental_pagerank.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+
+namespace gs {
+
+IncrementalPageRank::IncrementalPageRank(label_t vertex_label,
+                                         label_t edge_label,
+                                         double damping_factor,
+                                         double epsilon)
+    : vertex_label_(vertex_label),
+      edge_label_(edge_label),
+      damping_factor_(damping_factor),
+      epsilon_(epsilon) {}
+
+void IncrementalPageRank::Init(const MutablePropertyFragment& graph) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  vid_t vertex_num = graph.vertex_num(vertex_label_);
+  out_edges_.clear();
+  in_degree_.clear();
+  estimate_.clear();
+  residual_.clear();
+  queue_.clear();
+  queued_.clear();
+  grow(vertex_num);
+  const auto& schema = graph.schema();
+  if (schema.exist(vertex_label_, vertex_label_, edge_label_)) {
+    bool outgoing = schema.get_outgoing_edge_strategy(vertex_label_,
+                                                      vertex_label_,
+                                                      edge_label_) !=
+                    EdgeStrategy::kNone;
+    for (vid_t v = 0; v < vertex_num; ++v) {
+      auto edges = outgoing ? graph.get_outgoing_edges(vertex_label_, v,
+                                                       vertex_label_,
+                                                       edge_label_)
+                            : graph.get_incoming_edges(vertex_label_, v,
+                                                       vertex_label_,
+                                                       edge_label_);
+      for (; edges->is_valid(); edges->next()) {
+        vid_t u = edges->get_neighbor();
+        vid_t src = outgoing ? v : u;
+        vid_t dst = outgoing ? u : v;
+        out_edges_[src].push_back(dst);
+        ++in_degree_[dst];
+      }
+    }
+  }
+  push();
+  LOG(INFO) << "Initialized incremental pagerank of "
+            << schema.get_vertex_label_name(vertex_label_) << " over "
+            << schema.get_edge_label_name(edge_label_) << ", " << vertex_num
+            << " vertices";
+}
+
+void IncrementalPageRank::OnVertexInserted(label_t label, vid_t lid) {
+  if (label != vertex_label_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  grow(lid + 1);
+}
+
+void IncrementalPageRank::OnEdgesInserted(label_t src_label, label_t dst_label,
+                                          label_t edge_label,
+                                          const vid_t* src_lids,
+                                          const vid_t* dst_lids, size_t num) {
+  if (src_label != vertex_label_ || dst_label != vertex_label_ ||
+      edge_label != edge_label_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < num; ++i) {
+    vid_t u = src_lids[i], w = dst_lids[i];
+    grow(std::max(u, w) + 1);
+    auto& edges = out_edges_[u];
+    // The old neighbors of u keep getting estimate / k from it.
+    double share = edges.empty() ? estimate_[u] : estimate_[u] / edges.size();
+    if (!edges.empty()) {
+      estimate_[u] += share;
+      residual_[u] -= share;
+      enqueue(u);
+    }
+    residual_[w] += damping_factor_ * share;
+    enqueue(w);
+    edges.push_back(w);
+    ++in_degree_[w];
+  }
+}
+
+std::vector<IncrementalPageRank::Score> IncrementalPageRank::TopK(
+    size_t limit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  push();
+  vid_t vertex_num = estimate_.size();
+  std::vector<vid_t> top;
+  auto greater = [&](vid_t a, vid_t b) {
+    return estimate_[a] > estimate_[b] ||
+           (estimate_[a] == estimate_[b] && a < b);
+  };
+  limit = std::min<size_t>(limit, vertex_num);
+  top.reserve(limit);
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    if (top.size() < limit) {
+      top.push_back(v);
+      std::push_heap(top.begin(), top.end(), greater);
+    } else if (limit > 0 && greater(v, top.front())) {
+      std::pop_heap(top.begin(), top.end(), greater);
+      top.back() = v;
+      std::push_heap(top.begin(), top.end(), greater);
+    }
+  }
+  std::sort_heap(top.begin(), top.end(), greater);
+  std::vector<Score> scores;
+  scores.reserve(top.size());
+  for (auto v : top) {
+    scores.push_back({v, estimate_[v] / vertex_num, in_degree_[v],
+                      static_cast<uint32_t>(out_edges_[v].size())});
+  }
+  return scores;
+}
+
+void IncrementalPageRank::grow(vid_t vertex_num) {
+  vid_t old_num = estimate_.size();
+  if (vertex_num <= old_num) {
+    return;
+  }
+  out_edges_.resize(vertex_num);
+  in_degree_.resize(vertex_num, 0);
+  estimate_.resize(vertex_num, 0.0);
+  residual_.resize(vertex_num, 1.0 - damping_factor_);
+  queued_.resize(vertex_num, 0);
+  for (vid_t v = old_num; v < vertex_num; ++v) {
+    enqueue(v);
+  }
+}
+
+void IncrementalPageRank::enqueue(vid_t v) {
+  if (!queued_[v] && std::abs(residual_[v]) > epsilon_) {
+    queued_[v] = 1;
+    queue_.push_back(v);
+  }
+}
+
+void IncrementalPageRank::push() {
+  // The residuals may be negative after an insert, and are pushed as well.
+  while (!queue_.empty()) {
+    vid_t u = queue_.back();
+    queue_.pop_back();
+    queued_[u] = 0;
+    double r = residual_[u];
+    if (std::abs(r) <= epsilon_) {
+      continue;
+    }
+    residual_[u] = 0;
+    estimate_[u] += r;
+    const auto& edges = out_edges_[u];
+    if (edges.empty()) {
+      continue;
+    }
+    double share = damping_factor_ * r / edges.size();
+    for (auto w : edges) {
+      residual_[w] += share;
+      enqueue(w);
+    }
+  }
+}
+
+}  // namespace gs
@@ -0,0 +1,97 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_INCREMENTAL_PAGERANK_H_
+#define GRAPHSCOPE_DATABASE_INCREMENTAL_PAGERANK_H_
+
+#include <mutex>
+#include <vector>
+
+#include "flex/engines/graph_db/database/insert_listener.h"
+
+namespace gs {
+
+class MutablePropertyFragment;
+
+/**
+ * @brief Keeps the PageRank and degrees of the subgraph of a vertex label
+ * and an edge label fresh under inserts, without recomputing it.
+ *
+ * The scores are kept by residual push: each vertex has an estimate and a
+ * residual, the missing part of its score, and pushing a vertex adds its
+ * residual to its estimate and a damped share of it to the residuals of its
+ * out-neighbors. An inserted edge u -> w scales the estimate of u by
+ * (k + 1) / k, k being the old out degree of u, so that the shares its old
+ * neighbors get are unchanged, and moves the difference to the residuals of
+ * u and w. A new vertex starts with the residual of a teleport. The inserts
+ * are only noted by the committing threads, the residuals are pushed below
+ * epsilon when the scores are read.
+ *
+ * As in the PageRank builtin, the scores of the n vertices sum up to 1 less
+ * the mass lost at vertices without out-edges.
+ */
+class IncrementalPageRank : public IInsertListener {
+ public:
+  struct Score {
+    vid_t vid;
+    double pagerank;
+    uint32_t in_degree;
+    uint32_t out_degree;
+  };
+
+  IncrementalPageRank(label_t vertex_label, label_t edge_label,
+                      double damping_factor, double epsilon);
+  ~IncrementalPageRank() override = default;
+
+  // Reads the edges of the graph and pushes the residuals of all vertices,
+  // to be called before the graph takes inserts.
+  void Init(const MutablePropertyFragment& graph);
+
+  void OnVertexInserted(label_t label, vid_t lid) override;
+
+  void OnEdgesInserted(label_t src_label, label_t dst_label,
+                       label_t edge_label, const vid_t* src_lids,
+                       const vid_t* dst_lids, size_t num) override;
+
+  // The limit highest scores, after pushing the inserts noted so far.
+  std::vector<Score> TopK(size_t limit);
+
+  label_t vertex_label() const { return vertex_label_; }
+  label_t edge_label() const { return edge_label_; }
+
+ private:
+  void grow(vid_t vertex_num);
+  void enqueue(vid_t v);
+  void push();
+
+  label_t vertex_label_;
+  label_t edge_label_;
+  double damping_factor_;
+  double epsilon_;
+
+  std::mutex mutex_;
+  std::vector<std::vector<vid_t>> out_edges_;
+  std::vector<uint32_t> in_degree_;
+  // Unnormalized, a teleport adds 1 - damping_factor to each vertex.
+  std::vector<double> estimate_;
+  std::vector<double> residual_;
+  // The vertices whose residual may exceed epsilon.
+  std::vector<vid_t> queue_;
+  std::vector<uint8_t> queued_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_INCREMENTAL_PAGERANK_H_
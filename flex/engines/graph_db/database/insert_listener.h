@@ -0,0 +1,46 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_INSERT_LISTENER_H_
+#define GRAPHSCOPE_DATABASE_INSERT_LISTENER_H_
+
+#include <stddef.h>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+
+namespace gs {
+
+/**
+ * @brief Receives the vertices and edges of the insert wals committed on the
+ * graph, as they are ingested and before their timestamp is released.
+ *
+ * It is called on the committing threads, concurrently, and should only take
+ * a note of the inserts. The wals replayed when the graph is opened are not
+ * passed, nor the vertices and edges of update transactions.
+ */
+class IInsertListener {
+ public:
+  virtual ~IInsertListener() = default;
+
+  virtual void OnVertexInserted(label_t label, vid_t lid) = 0;
+
+  virtual void OnEdgesInserted(label_t src_label, label_t dst_label,
+                               label_t edge_label, const vid_t* src_lids,
+                               const vid_t* dst_lids, size_t num) = 0;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_INSERT_LISTENER_H_
@@ -15,6 +15,7 @@
 
 #include "flex/engines/graph_db/database/insert_transaction.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/database/insert_listener.h"
 #include "flex/engines/graph_db/database/transaction_utils.h"
 #include "flex/engines/graph_db/database/version_manager.h"
 #include "flex/engines/graph_db/database/wal/wal.h"
@@ -26,14 +27,19 @@ namespace gs {
 InsertTransaction::InsertTransaction(const GraphDBSession& session,
                                      MutablePropertyFragment& graph,
                                      Allocator& alloc, IWalWriter& logger,
-                                     VersionManager& vm, timestamp_t timestamp)
+                                     VersionManager& vm,
+                                     StagedVertexSet& added_vertices,
+                                     timestamp_t timestamp,
+                                     IInsertListener* listener)
 
     : session_(session),
+      added_vertices_(added_vertices),
       graph_(graph),
       alloc_(alloc),
       logger_(logger),
       vm_(vm),
-      timestamp_(timestamp) {
+      timestamp_(timestamp),
+      listener_(listener) {
   arc_.Resize(sizeof(WalHeader));
 }
 
@@ -54,6 +60,11 @@ bool InsertTransaction::AddVertex(label_t label, const Any& id,
       graph_.schema().get_vertex_properties(label);
   if (types.size() != props.size()) {
     arc_.Resize(arc_size);
+    // The properties dropped but not compacted yet may be left out.
+    std::vector<Any> filled(props);
+    if (graph_.schema().fill_dropped_vertex_properties(label, filled)) {
+      return AddVertex(label, id, filled);
+    }
     std::string label_name = graph_.schema().get_vertex_label_name(label);
     LOG(ERROR) << "Vertex [" << label_name
                << "] properties size not match, expected " << types.size()
@@ -77,7 +88,12 @@ bool InsertTransaction::AddVertex(label_t label, const Any& id,
     }
     serialize_field(arc_, prop);
   }
-  added_vertices_.emplace(label, id);
+  added_vertices_.insert(label, id);
+  written_labels_.add_vertex_label(label);
+  if (label >= vertex_nums_.size()) {
+    vertex_nums_.resize(label + 1, 0);
+  }
+  ++vertex_nums_[label];
   return true;
 }
 
@@ -86,8 +102,7 @@ bool InsertTransaction::AddEdge(label_t src_label, const Any& src,
                                 label_t edge_label, const Any& prop) {
   vid_t lid;
   if (!graph_.get_lid(src_label, src, lid)) {
-    if (added_vertices_.find(std::make_pair(src_label, src)) ==
-        added_vertices_.end()) {
+    if (!added_vertices_.contains(src_label, src)) {
       std::string label_name = graph_.schema().get_vertex_label_name(src_label);
       VLOG(1) << "Source vertex " << label_name << "[" << src.to_string()
               << "] not found...";
@@ -95,8 +110,7 @@ bool InsertTransaction::AddEdge(label_t src_label, const Any& src,
     }
   }
   if (!graph_.get_lid(dst_label, dst, lid)) {
-    if (added_vertices_.find(std::make_pair(dst_label, dst)) ==
-        added_vertices_.end()) {
+    if (!added_vertices_.contains(dst_label, dst)) {
       std::string label_name = graph_.schema().get_vertex_label_name(dst_label);
       VLOG(1) << "Destination vertex " << label_name << "[" << dst.to_string()
               << "] not found...";
@@ -141,6 +155,7 @@ bool InsertTransaction::AddEdge(label_t src_label, const Any& src,
   serialize_field(arc_, dst);
   arc_ << edge_label;
   serialize_field(arc_, prop);
+  written_labels_.add_edge_label(edge_label);
   return true;
 }
 
@@ -158,14 +173,21 @@ bool InsertTransaction::Commit() {
   header->type = 0;
   header->timestamp = timestamp_;
 
+  if (!graph_.ClaimVertexSlots(vertex_nums_)) {
+    Abort();
+    return false;
+  }
   if (!logger_.append(arc_.GetBuffer(), arc_.GetSize())) {
     LOG(ERROR) << "Failed to append wal log";
+    graph_.ReleaseVertexSlots(vertex_nums_);
     Abort();
     return false;
   }
   IngestWal(graph_, timestamp_, arc_.GetBuffer() + sizeof(WalHeader),
-            header->length, alloc_);
+            header->length, alloc_, listener_);
+  graph_.ReleaseVertexSlots(vertex_nums_);
 
+  vm_.record_write(written_labels_, timestamp_);
   vm_.release_insert_timestamp(timestamp_);
   clear();
   return true;
@@ -181,9 +203,83 @@ void InsertTransaction::Abort() {
 
 timestamp_t InsertTransaction::timestamp() const { return timestamp_; }
 
+bool InsertTransaction::AddEdges(
+    label_t src_label, label_t dst_label, label_t edge_label,
+    const std::vector<Any>& srcs, const std::vector<Any>& dsts,
+    const std::vector<std::vector<Any>>& prop_columns) {
+  std::string label_name = graph_.schema().get_edge_label_name(edge_label);
+  size_t edge_num = srcs.size();
+  if (dsts.size() != edge_num) {
+    LOG(ERROR) << "Edges " << label_name << " have " << edge_num
+               << " sources but " << dsts.size() << " destinations";
+    return false;
+  }
+  const auto& types =
+      graph_.schema().get_edge_properties(src_label, dst_label, edge_label);
+  if (prop_columns.size() != types.size()) {
+    LOG(ERROR) << "Edge property " << label_name
+               << " size not match, expected " << types.size() << ", got "
+               << prop_columns.size();
+    return false;
+  }
+  for (size_t col_i = 0; col_i < types.size(); ++col_i) {
+    const auto& column = prop_columns[col_i];
+    if (column.size() != edge_num) {
+      LOG(ERROR) << "Edge property " << label_name << "[" << col_i
+                 << "] has " << column.size() << " values, expected "
+                 << edge_num;
+      return false;
+    }
+    for (const auto& prop : column) {
+      if (prop.type != types[col_i]) {
+        LOG(ERROR) << "Edge property " << label_name << "[" << col_i
+                   << "] type not match, expected " << types[col_i]
+                   << ", got " << prop.type;
+        return false;
+      }
+    }
+  }
+  auto check_vertices = [&](label_t label, const std::vector<Any>& oids) {
+    vid_t lid;
+    for (const auto& oid : oids) {
+      if (!graph_.get_lid(label, oid, lid) &&
+          !added_vertices_.contains(label, oid)) {
+        VLOG(1) << "Vertex " << graph_.schema().get_vertex_label_name(label)
+                << "[" << oid.to_string() << "] not found...";
+        return false;
+      }
+    }
+    return true;
+  };
+  if (!check_vertices(src_label, srcs) || !check_vertices(dst_label, dsts)) {
+    return false;
+  }
+
+  arc_ << static_cast<uint8_t>(2) << src_label << dst_label << edge_label
+       << static_cast<uint32_t>(edge_num);
+  for (const auto& src : srcs) {
+    serialize_field(arc_, src);
+  }
+  for (const auto& dst : dsts) {
+    serialize_field(arc_, dst);
+  }
+  // The bytes serialize_field writes for the property of a single edge, a
+  // record if the triplet has several properties.
+  for (size_t i = 0; i < edge_num; ++i) {
+    if (types.size() > 1) {
+      arc_ << types.size();
+    }
+    for (const auto& column : prop_columns) {
+      serialize_field(arc_, column[i]);
+    }
+  }
+  written_labels_.add_edge_label(edge_label);
+  return true;
+}
+
 void InsertTransaction::IngestWal(MutablePropertyFragment& graph,
                                   uint32_t timestamp, char* data, size_t length,
-                                  Allocator& alloc) {
+                                  Allocator& alloc, IInsertListener* listener) {
   grape::OutArchive arc;
   arc.SetSlice(data, length);
   while (!arc.Empty()) {
@@ -195,6 +291,10 @@ void InsertTransaction::IngestWal(MutablePropertyFragment& graph,
       label = deserialize_oid(graph, arc, id);
       vid_t lid = graph.add_vertex(label, id);
       graph.get_vertex_table(label).ingest(lid, arc);
+      graph.IndexVertex(label, lid);
+      if (listener != nullptr) {
+        listener->OnVertexInserted(label, lid);
+      }
     } else if (op_type == 1) {
       label_t src_label, dst_label, edge_label;
       Any src, dst;
@@ -208,6 +308,23 @@ void InsertTransaction::IngestWal(MutablePropertyFragment& graph,
 
       graph.IngestEdge(src_label, src_lid, dst_label, dst_lid, edge_label,
                        timestamp, arc, alloc);
+      if (listener != nullptr) {
+        listener->OnEdgesInserted(src_label, dst_label, edge_label, &src_lid,
+                                  &dst_lid, 1);
+      }
+    } else if (op_type == 2) {
+      label_t src_label, dst_label, edge_label;
+      uint32_t edge_num;
+      arc >> src_label >> dst_label >> edge_label >> edge_num;
+      std::vector<vid_t> src_lids, dst_lids;
+      read_vertex_lids(graph, arc, src_label, edge_num, src_lids);
+      read_vertex_lids(graph, arc, dst_label, edge_num, dst_lids);
+      graph.IngestEdges(src_label, dst_label, edge_label, src_lids, dst_lids,
+                        timestamp, arc, alloc);
+      if (listener != nullptr) {
+        listener->OnEdgesInserted(src_label, dst_label, edge_label,
+                                  src_lids.data(), dst_lids.data(), edge_num);
+      }
     } else {
       LOG(FATAL) << "Unexpected op-" << static_cast<int>(op_type);
     }
@@ -218,6 +335,8 @@ void InsertTransaction::clear() {
   arc_.Clear();
   arc_.Resize(sizeof(WalHeader));
   added_vertices_.clear();
+  written_labels_.clear();
+  vertex_nums_.clear();
 
   timestamp_ = std::numeric_limits<timestamp_t>::max();
 }
@@ -245,6 +364,18 @@ bool InsertTransaction::get_vertex_with_retries(MutablePropertyFragment& graph,
   return false;
 }
 
+void InsertTransaction::read_vertex_lids(MutablePropertyFragment& graph,
+                                         grape::OutArchive& arc, label_t label,
+                                         size_t num, std::vector<vid_t>& lids) {
+  Any oid;
+  oid.type = std::get<0>(graph.schema().get_vertex_primary_key(label).at(0));
+  lids.resize(num);
+  for (size_t i = 0; i < num; ++i) {
+    deserialize_field(arc, oid);
+    CHECK(get_vertex_with_retries(graph, label, oid, lids[i]));
+  }
+}
+
 #undef likely
 
 }  // namespace gs
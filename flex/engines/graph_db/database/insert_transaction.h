@@ -17,12 +17,16 @@
 #define GRAPHSCOPE_DATABASE_INSERT_TRANSACTION_H_
 
 #include <limits>
+#include <vector>
 
+#include "flex/engines/graph_db/database/label_set.h"
+#include "flex/engines/graph_db/database/staged_vertex_set.h"
 #include "flex/storages/rt_mutable_graph/schema.h"
 #include "flex/storages/rt_mutable_graph/types.h"
 #include "flex/utils/allocators.h"
 #include "flex/utils/property/types.h"
 #include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
 
 namespace gs {
 
@@ -30,6 +34,7 @@ class MutablePropertyFragment;
 class IWalWriter;
 class VersionManager;
 class GraphDBSession;
+class IInsertListener;
 
 class InsertTransaction {
  public:
@@ -39,7 +44,8 @@ class InsertTransaction {
   InsertTransaction(const GraphDBSession& session,
                     MutablePropertyFragment& graph, Allocator& alloc,
                     IWalWriter& logger, VersionManager& vm,
-                    timestamp_t timestamp);
+                    StagedVertexSet& added_vertices, timestamp_t timestamp,
+                    IInsertListener* listener = nullptr);
 
   ~InsertTransaction();
 
@@ -48,6 +54,14 @@ class InsertTransaction {
   bool AddEdge(label_t src_label, const Any& src, label_t dst_label,
                const Any& dst, label_t edge_label, const Any& prop);
 
+  // Adds the edges from srcs[i] to dsts[i] of a triplet, prop_columns holding
+  // one column of values per property of the triplet. The edges are logged
+  // as a single entry, which stores the source ids, the destination ids and
+  // the properties one after the other, and are ingested together.
+  bool AddEdges(label_t src_label, label_t dst_label, label_t edge_label,
+                const std::vector<Any>& srcs, const std::vector<Any>& dsts,
+                const std::vector<std::vector<Any>>& prop_columns);
+
   bool Commit();
 
   void Abort();
@@ -55,7 +69,8 @@ class InsertTransaction {
   timestamp_t timestamp() const;
 
   static void IngestWal(MutablePropertyFragment& graph, uint32_t timestamp,
-                        char* data, size_t length, Allocator& alloc);
+                        char* data, size_t length, Allocator& alloc,
+                        IInsertListener* listener = nullptr);
 
   const Schema& schema() const;
 
@@ -67,11 +82,21 @@ class InsertTransaction {
   static bool get_vertex_with_retries(MutablePropertyFragment& graph,
                                       label_t label, const Any& oid,
                                       vid_t& lid);
+
+  // Reads num oids of label from arc and resolves them.
+  static void read_vertex_lids(MutablePropertyFragment& graph,
+                               grape::OutArchive& arc, label_t label,
+                               size_t num, std::vector<vid_t>& lids);
   const GraphDBSession& session_;
 
   grape::InArchive arc_;
 
-  std::set<std::pair<label_t, Any>> added_vertices_;
+  // Owned by the session, and reused by its transactions.
+  StagedVertexSet& added_vertices_;
+  // Recorded in the version manager on commit.
+  LabelSet written_labels_;
+  // The vertices added of each label, whose slots are claimed on commit.
+  std::vector<size_t> vertex_nums_;
 
   MutablePropertyFragment& graph_;
 
@@ -79,6 +104,7 @@ class InsertTransaction {
   IWalWriter& logger_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  IInsertListener* listener_;
 };
 
 }  // namespace gs
@@ -0,0 +1,80 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_LABEL_SET_H_
+#define GRAPHSCOPE_DATABASE_LABEL_SET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <bitset>
+#include <limits>
+
+namespace gs {
+
+/**
+ * @brief The vertex and edge labels written by a transaction or read by a
+ * query, or all of them.
+ *
+ * A label takes a slot, the vertex labels the first ones and the edge labels
+ * the ones after them, see VersionManager::record_write.
+ */
+class LabelSet {
+ public:
+  static constexpr size_t LABEL_NUM =
+      static_cast<size_t>(std::numeric_limits<uint8_t>::max()) + 1;
+  static constexpr size_t SLOT_NUM = 2 * LABEL_NUM;
+
+  LabelSet() : all_(false) {}
+
+  void add_vertex_label(uint8_t label) { slots_.set(label); }
+  void add_edge_label(uint8_t label) { slots_.set(LABEL_NUM + label); }
+  void add_all() { all_ = true; }
+
+  LabelSet& operator|=(const LabelSet& rhs) {
+    slots_ |= rhs.slots_;
+    all_ = all_ || rhs.all_;
+    return *this;
+  }
+
+  bool all() const { return all_; }
+  bool empty() const { return !all_ && slots_.none(); }
+
+  // Calls func with each slot of the labels added, not for all().
+  template <typename FUNC_T>
+  void foreach_slot(const FUNC_T& func) const {
+    if (slots_.none()) {
+      return;
+    }
+    for (size_t i = 0; i < SLOT_NUM; ++i) {
+      if (slots_.test(i)) {
+        func(i);
+      }
+    }
+  }
+
+  void clear() {
+    slots_.reset();
+    all_ = false;
+  }
+
+ private:
+  std::bitset<SLOT_NUM> slots_;
+  bool all_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_LABEL_SET_H_
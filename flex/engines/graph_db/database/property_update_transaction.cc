@@ -0,0 +1,237 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "grape/serialization/out_archive.h"
+
+#include "flex/engines/graph_db/database/property_update_transaction.h"
+#include "flex/engines/graph_db/database/transaction_utils.h"
+#include "flex/engines/graph_db/database/version_manager.h"
+#include "flex/engines/graph_db/database/wal/wal.h"
+#include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+
+namespace gs {
+
+PropertyUpdateTransaction::PropertyUpdateTransaction(
+    MutablePropertyFragment& graph, IWalWriter& logger, VersionManager& vm)
+    : graph_(graph),
+      logger_(logger),
+      vm_(vm),
+      timestamp_(std::numeric_limits<timestamp_t>::max()),
+      read_ts_(std::numeric_limits<timestamp_t>::max()),
+      conflicted_(false) {
+  arc_.Resize(sizeof(WalHeader));
+}
+
+PropertyUpdateTransaction::~PropertyUpdateTransaction() { Abort(); }
+
+bool PropertyUpdateTransaction::SetVertexField(label_t label, vid_t lid,
+                                               int col_id, const Any& value) {
+  if (label >= graph_.schema().vertex_label_num() ||
+      lid >= graph_.vertex_num(label)) {
+    return false;
+  }
+  const std::vector<PropertyType>& types =
+      graph_.schema().get_vertex_properties(label);
+  if (col_id < 0 || static_cast<size_t>(col_id) >= types.size()) {
+    return false;
+  }
+  if (types[col_id] != value.type &&
+      !(types[col_id] == PropertyType::kStringMap &&
+        value.type == PropertyType::kStringView)) {
+    std::string label_name = graph_.schema().get_vertex_label_name(label);
+    LOG(ERROR) << "Vertex [" << label_name << "][" << col_id
+               << "] property type not match, expected " << types[col_id]
+               << ", but got " << value.type;
+    return false;
+  }
+
+  arc_ << static_cast<uint8_t>(2) << label;
+  serialize_field(arc_, graph_.get_oid(label, lid));
+  arc_ << col_id;
+  serialize_field(arc_, value);
+  vids_.push_back(lid);
+
+  Any& written = written_[VertexPropertyVersions::key(label, lid, col_id)];
+  written = value;
+  if (value.type == PropertyType::StringView()) {
+    strings_.emplace_back(value.AsStringView());
+    written.set_string_view(strings_.back());
+  }
+  return true;
+}
+
+Any PropertyUpdateTransaction::GetVertexField(label_t label, vid_t lid,
+                                              int col_id) {
+  uint64_t k = VertexPropertyVersions::key(label, lid, col_id);
+  auto iter = written_.find(k);
+  if (iter != written_.end()) {
+    return iter->second;
+  }
+  if (read_ts_ == std::numeric_limits<timestamp_t>::max()) {
+    read_ts_ = vm_.acquire_read_timestamp();
+  }
+  ReadRecord record{k, 0};
+  Any value;
+  if (!graph_.vertex_property_versions().Get(label, lid, col_id, read_ts_,
+                                             value, &record.version_ts)) {
+    value = graph_.get_vertex_table(label).get_column_by_id(col_id)->get(lid);
+  }
+  reads_.push_back(record);
+  return value;
+}
+
+// The locks are taken and the timestamp acquired before the reads are
+// validated. A concurrent writer of a property read either acquires its
+// timestamp after it took its lock, hence after this one, or holds the lock
+// or has added its version when the read is validated.
+bool PropertyUpdateTransaction::Commit() {
+  conflicted_ = false;
+  if (vids_.empty()) {
+    releaseRead();
+    clear();
+    return true;
+  }
+  // A read holds back the update transactions, so that neither the versions
+  // nor the tables change until the transaction ends, and the timestamp is
+  // acquired without waiting while locks are held.
+  if (read_ts_ == std::numeric_limits<timestamp_t>::max()) {
+    read_ts_ = vm_.acquire_read_timestamp();
+  }
+  auto& versions = graph_.vertex_property_versions();
+  std::vector<size_t> locks;
+  locks.reserve(written_.size());
+  for (auto& pair : written_) {
+    locks.push_back(VertexPropertyVersions::lock_index(pair.first));
+  }
+  std::sort(locks.begin(), locks.end());
+  locks.erase(std::unique(locks.begin(), locks.end()), locks.end());
+  for (size_t idx : locks) {
+    versions.LockKey(idx);
+  }
+  timestamp_ = vm_.upgrade_to_insert_timestamp();
+  read_ts_ = std::numeric_limits<timestamp_t>::max();
+  auto unlock = [&]() {
+    for (size_t idx : locks) {
+      versions.UnlockKey(idx);
+    }
+  };
+
+  if (!validate(locks)) {
+    VLOG(10) << "Property update at " << timestamp_ << " conflicted";
+    unlock();
+    vm_.release_insert_timestamp(timestamp_);
+    clear();
+    timestamp_ = std::numeric_limits<timestamp_t>::max();
+    conflicted_ = true;
+    return false;
+  }
+
+  auto* header = reinterpret_cast<WalHeader*>(arc_.GetBuffer());
+  header->length = arc_.GetSize() - sizeof(WalHeader);
+  header->type = 1;
+  header->timestamp = timestamp_;
+
+  if (!logger_.append(arc_.GetBuffer(), arc_.GetSize())) {
+    LOG(ERROR) << "Failed to append wal log";
+    unlock();
+    vm_.release_insert_timestamp(timestamp_);
+    Abort();
+    return false;
+  }
+  applyVersions();
+  unlock();
+
+  LabelSet labels;
+  for (auto& pair : written_) {
+    labels.add_vertex_label(static_cast<label_t>(pair.first >> 48));
+  }
+  vm_.record_write(labels, timestamp_);
+  vm_.release_insert_timestamp(timestamp_);
+  clear();
+  return true;
+}
+
+bool PropertyUpdateTransaction::validate(
+    const std::vector<size_t>& locks) const {
+  const auto& versions = graph_.vertex_property_versions();
+  for (auto& record : reads_) {
+    size_t idx = VertexPropertyVersions::lock_index(record.key);
+    if (versions.KeyLocked(idx) &&
+        !std::binary_search(locks.begin(), locks.end(), idx)) {
+      return false;
+    }
+    label_t label = record.key >> 48;
+    int col_id = (record.key >> 32) & 0xffff;
+    vid_t vid = static_cast<vid_t>(record.key);
+    if (versions.LatestTs(label, vid, col_id) != record.version_ts) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PropertyUpdateTransaction::Abort() {
+  if (!vids_.empty()) {
+    LOG(ERROR) << "aborting transaction (property update)";
+  }
+  releaseRead();
+  clear();
+  timestamp_ = std::numeric_limits<timestamp_t>::max();
+}
+
+void PropertyUpdateTransaction::releaseRead() {
+  if (read_ts_ != std::numeric_limits<timestamp_t>::max()) {
+    vm_.release_read_timestamp();
+    read_ts_ = std::numeric_limits<timestamp_t>::max();
+  }
+}
+
+timestamp_t PropertyUpdateTransaction::timestamp() const { return timestamp_; }
+
+void PropertyUpdateTransaction::applyVersions() {
+  grape::OutArchive arc;
+  arc.SetSlice(arc_.GetBuffer() + sizeof(WalHeader),
+               arc_.GetSize() - sizeof(WalHeader));
+  auto& versions = graph_.vertex_property_versions();
+  const vid_t* vid_ptr = vids_.data();
+  while (!arc.Empty()) {
+    uint8_t op_type;
+    arc >> op_type;
+    CHECK_EQ(op_type, 2);
+    Any oid, value;
+    int col_id;
+    label_t label = deserialize_oid(graph_, arc, oid);
+    arc >> col_id;
+    const auto& type = graph_.schema().get_vertex_properties(label)[col_id];
+    value.type =
+        type == PropertyType::kStringMap ? PropertyType::kStringView : type;
+    deserialize_field(arc, value);
+    graph_.IndexVertexProperty(label, *vid_ptr, col_id, value);
+    versions.Add(label, *(vid_ptr++), col_id, timestamp_, value);
+  }
+}
+
+void PropertyUpdateTransaction::clear() {
+  arc_.Clear();
+  arc_.Resize(sizeof(WalHeader));
+  vids_.clear();
+  reads_.clear();
+  written_.clear();
+  strings_.clear();
+}
+
+}  // namespace gs
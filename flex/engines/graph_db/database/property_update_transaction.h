@@ -0,0 +1,119 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_PROPERTY_UPDATE_TRANSACTION_H_
+#define GRAPHSCOPE_DATABASE_PROPERTY_UPDATE_TRANSACTION_H_
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/types.h"
+#include "grape/serialization/in_archive.h"
+
+namespace gs {
+
+class MutablePropertyFragment;
+class IWalWriter;
+class VersionManager;
+
+/**
+ * @brief Sets properties of existing vertices without stopping the readers.
+ *
+ * Unlike UpdateTransaction, it runs on an insert timestamp: the new values
+ * are committed as versions of the properties (see VertexPropertyVersions),
+ * seen by the transactions that read at its timestamp or later through
+ * ReadTransaction::GetVertexField, vertex_iterator::GetField and the columns
+ * of runtime::GraphReadInterface, while the earlier ones keep reading the
+ * former values. The versions are written into
+ * the vertex tables by the next update or compaction transaction. The wal is
+ * logged as an update, so it is replayed by UpdateTransaction::IngestWal.
+ *
+ * The timestamp is only acquired by Commit(), after the vertices were looked
+ * up, so that it follows the insertion of every vertex the updates refer to.
+ *
+ * Transactions that read properties before setting them, e.g. to add to a
+ * balance, run concurrently and optimistically. GetVertexField reads at the
+ * snapshot taken by the first read, and records which version it read.
+ * Commit() locks the written properties, takes its timestamp and checks that
+ * every property read still has the version it read. It returns false with
+ * conflicted() set if one was written since, or is being committed: the
+ * transaction is then aborted, and may be retried from scratch.
+ */
+class PropertyUpdateTransaction {
+ public:
+  PropertyUpdateTransaction(MutablePropertyFragment& graph, IWalWriter& logger,
+                            VersionManager& vm);
+  ~PropertyUpdateTransaction();
+
+  // Returns false if the vertex, the property or the type of value does not
+  // match the graph.
+  bool SetVertexField(label_t label, vid_t lid, int col_id, const Any& value);
+
+  // The value of the property at the snapshot of the transaction, or the one
+  // it set. Strings live until the transaction ends.
+  Any GetVertexField(label_t label, vid_t lid, int col_id);
+
+  bool Commit();
+
+  // Whether the last Commit() failed as a property read was written by a
+  // concurrent transaction.
+  bool conflicted() const { return conflicted_; }
+
+  void Abort();
+
+  // The timestamp the updates were committed at, or the max timestamp before
+  // Commit().
+  timestamp_t timestamp() const;
+
+ private:
+  void clear();
+
+  void applyVersions();
+
+  // Whether the properties read still have the versions they were read at.
+  // Must be called with the locks of the written properties held.
+  bool validate(const std::vector<size_t>& locks) const;
+
+  void releaseRead();
+
+  struct ReadRecord {
+    uint64_t key;
+    // Timestamp of the version read, 0 for the value in the table.
+    timestamp_t version_ts;
+  };
+
+  grape::InArchive arc_;
+  std::vector<vid_t> vids_;
+
+  // The snapshot the properties are read at, taken by the first read.
+  timestamp_t read_ts_;
+  std::vector<ReadRecord> reads_;
+  // The values set, by property key, for the reads that follow.
+  std::unordered_map<uint64_t, Any> written_;
+  std::deque<std::string> strings_;
+  bool conflicted_;
+
+  MutablePropertyFragment& graph_;
+  IWalWriter& logger_;
+  VersionManager& vm_;
+  timestamp_t timestamp_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_PROPERTY_UPDATE_TRANSACTION_H_
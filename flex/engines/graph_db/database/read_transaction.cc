@@ -23,7 +23,11 @@ namespace gs {
 ReadTransaction::ReadTransaction(const GraphDBSession& session,
                                  const MutablePropertyFragment& graph,
                                  VersionManager& vm, timestamp_t timestamp)
-    : session_(session), graph_(graph), vm_(vm), timestamp_(timestamp) {}
+    : session_(session),
+      graph_(graph),
+      vm_(vm),
+      timestamp_(timestamp),
+      epoch_(vm.epoch_manager().pin()) {}
 ReadTransaction::~ReadTransaction() { release(); }
 
 std::string ReadTransaction::run(
@@ -44,8 +48,13 @@ void ReadTransaction::Abort() { release(); }
 const MutablePropertyFragment& ReadTransaction::graph() const { return graph_; }
 
 ReadTransaction::vertex_iterator::vertex_iterator(
-    label_t label, vid_t cur, vid_t num, const MutablePropertyFragment& graph)
-    : label_(label), cur_(cur), num_(num), graph_(graph) {}
+    label_t label, vid_t cur, vid_t num, const MutablePropertyFragment& graph,
+    timestamp_t timestamp)
+    : label_(label),
+      cur_(cur),
+      num_(num),
+      graph_(graph),
+      timestamp_(timestamp) {}
 ReadTransaction::vertex_iterator::~vertex_iterator() = default;
 
 bool ReadTransaction::vertex_iterator::IsValid() const { return cur_ < num_; }
@@ -60,7 +69,7 @@ Any ReadTransaction::vertex_iterator::GetId() const {
 vid_t ReadTransaction::vertex_iterator::GetIndex() const { return cur_; }
 
 Any ReadTransaction::vertex_iterator::GetField(int col_id) const {
-  return graph_.get_vertex_table(label_).get_column_by_id(col_id)->get(cur_);
+  return graph_.get_vertex_property(label_, cur_, col_id, timestamp_);
 }
 
 int ReadTransaction::vertex_iterator::FieldNum() const {
@@ -99,16 +108,17 @@ label_t ReadTransaction::edge_iterator::GetEdgeLabel() const {
 
 ReadTransaction::vertex_iterator ReadTransaction::GetVertexIterator(
     label_t label) const {
-  return {label, 0, graph_.vertex_num(label), graph_};
+  return {label, 0, graph_.vertex_num(label), graph_, timestamp_};
 }
 
 ReadTransaction::vertex_iterator ReadTransaction::FindVertex(
     label_t label, const Any& id) const {
   vid_t lid;
   if (graph_.get_lid(label, id, lid)) {
-    return {label, lid, graph_.vertex_num(label), graph_};
+    return {label, lid, graph_.vertex_num(label), graph_, timestamp_};
   } else {
-    return {label, graph_.vertex_num(label), graph_.vertex_num(label), graph_};
+    return {label, graph_.vertex_num(label), graph_.vertex_num(label), graph_,
+            timestamp_};
   }
 }
 
@@ -125,6 +135,11 @@ Any ReadTransaction::GetVertexId(label_t label, vid_t index) const {
   return graph_.get_oid(label, index);
 }
 
+Any ReadTransaction::GetVertexField(label_t label, vid_t index,
+                                    int col_id) const {
+  return graph_.get_vertex_property(label, index, col_id, timestamp_);
+}
+
 ReadTransaction::edge_iterator ReadTransaction::GetOutEdgeIterator(
     label_t label, vid_t u, label_t neighbor_label, label_t edge_label) const {
   return {neighbor_label, edge_label,
@@ -153,7 +168,8 @@ size_t ReadTransaction::GetInDegree(label_t label, vid_t u,
 
 void ReadTransaction::release() {
   if (timestamp_ != std::numeric_limits<timestamp_t>::max()) {
-    vm_.release_read_timestamp();
+    vm_.epoch_manager().unpin(epoch_);
+    vm_.release_read_timestamp(session_.SessionId());
     timestamp_ = std::numeric_limits<timestamp_t>::max();
   }
 }
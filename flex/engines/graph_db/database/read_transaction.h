@@ -19,6 +19,7 @@
 #include <limits>
 #include <utility>
 
+#include "flex/storages/rt_mutable_graph/csr/compressed_csr.h"
 #include "flex/storages/rt_mutable_graph/csr/mutable_csr.h"
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
 #include "flex/storages/rt_mutable_graph/types.h"
@@ -36,11 +37,9 @@ class AdjListView {
 
    public:
     nbr_iterator(const_nbr_ptr_t ptr, const_nbr_ptr_t end,
-                 timestamp_t timestamp)
-        : ptr_(ptr), end_(end), timestamp_(timestamp) {
-      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
-        ++ptr_;
-      }
+                 timestamp_t timestamp, bool frozen)
+        : ptr_(ptr), end_(end), timestamp_(timestamp), frozen_(frozen) {
+      skip_invisible();
     }
 
     inline const_nbr_t& operator*() const { return *ptr_; }
@@ -49,9 +48,7 @@ class AdjListView {
 
     inline nbr_iterator& operator++() {
       ++ptr_;
-      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
-        ++ptr_;
-      }
+      skip_invisible();
       return *this;
     }
 
@@ -64,22 +61,34 @@ class AdjListView {
     }
 
    private:
+    // Frozen lists hold no edge invisible to this reader.
+    inline void skip_invisible() {
+      if (frozen_) {
+        return;
+      }
+      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
+        ++ptr_;
+      }
+    }
+
     const_nbr_ptr_t ptr_;
     const_nbr_ptr_t end_;
     timestamp_t timestamp_;
+    bool frozen_;
   };
 
  public:
   using slice_t = MutableNbrSlice<EDATA_T>;
 
-  AdjListView(const slice_t& slice, timestamp_t timestamp)
-      : edges_(slice), timestamp_(timestamp) {}
+  AdjListView(const slice_t& slice, timestamp_t timestamp,
+              bool frozen = false)
+      : edges_(slice), timestamp_(timestamp), frozen_(frozen) {}
 
   inline nbr_iterator begin() const {
-    return nbr_iterator(edges_.begin(), edges_.end(), timestamp_);
+    return nbr_iterator(edges_.begin(), edges_.end(), timestamp_, frozen_);
   }
   inline nbr_iterator end() const {
-    return nbr_iterator(edges_.end(), edges_.end(), timestamp_);
+    return nbr_iterator(edges_.end(), edges_.end(), timestamp_, true);
   }
 
   inline int estimated_degree() const { return edges_.size(); }
@@ -87,6 +96,7 @@ class AdjListView {
  private:
   slice_t edges_;
   timestamp_t timestamp_;
+  bool frozen_;
 };
 
 template <typename EDATA_T>
@@ -149,7 +159,8 @@ class GraphView {
         unsorted_since_(csr.unsorted_since()) {}
 
   inline AdjListView<EDATA_T> get_edges(vid_t v) const {
-    return AdjListView<EDATA_T>(csr_.get_edges(v), timestamp_);
+    auto edges = csr_.get_edges(v);
+    return AdjListView<EDATA_T>(edges, timestamp_, csr_.is_frozen(v));
   }
 
   // iterate edges with data in [min_value, max_value)
@@ -297,6 +308,22 @@ class ImmutableGraphView {
   const ImmutableCsr<EDATA_T>& csr_;
 };
 
+template <typename EDATA_T>
+class CompressedGraphView {
+ public:
+  CompressedGraphView(const CompressedImmutableCsr<EDATA_T>& csr) : csr_(csr) {}
+
+  // Neighbors are returned in ascending order of vertex id.
+  inline CompressedNbrSlice<EDATA_T> get_edges(vid_t v) const {
+    return csr_.get_edges(v);
+  }
+
+  inline int get_degree(vid_t v) const { return csr_.degree(v); }
+
+ private:
+  const CompressedImmutableCsr<EDATA_T>& csr_;
+};
+
 template <typename EDATA_T>
 class SingleGraphView {
  public:
@@ -428,7 +455,8 @@ class ReadTransaction {
   class vertex_iterator {
    public:
     vertex_iterator(label_t label, vid_t cur, vid_t num,
-                    const MutablePropertyFragment& graph);
+                    const MutablePropertyFragment& graph,
+                    timestamp_t timestamp);
     ~vertex_iterator();
 
     bool IsValid() const;
@@ -438,6 +466,7 @@ class ReadTransaction {
     Any GetId() const;
     vid_t GetIndex() const;
 
+    // The property as of the timestamp of the transaction.
     Any GetField(int col_id) const;
     int FieldNum() const;
 
@@ -446,6 +475,7 @@ class ReadTransaction {
     vid_t cur_;
     vid_t num_;
     const MutablePropertyFragment& graph_;
+    timestamp_t timestamp_;
   };
 
   class edge_iterator {
@@ -483,6 +513,12 @@ class ReadTransaction {
 
   Any GetVertexId(label_t label, vid_t index) const;
 
+  // Property col_id of the vertex as of the timestamp of the transaction,
+  // including the values committed by PropertyUpdateTransaction. The columns
+  // returned by get_vertex_property_column() only hold the values folded
+  // into the tables.
+  Any GetVertexField(label_t label, vid_t index, int col_id) const;
+
   edge_iterator GetOutEdgeIterator(label_t label, vid_t u,
                                    label_t neighbor_label,
                                    label_t edge_label) const;
@@ -494,6 +530,13 @@ class ReadTransaction {
   size_t GetOutDegree(label_t label, vid_t u, label_t neighbor_label,
                       label_t edge_label) const;
 
+  // Returns false if there is no edge from src to dst, so that the caller can
+  // skip scanning the adjacency list. See edge_existence_filter in the schema.
+  inline bool MayHaveEdge(label_t src_label, vid_t src, label_t dst_label,
+                          vid_t dst, label_t edge_label) const {
+    return graph_.may_have_edge(src_label, src, dst_label, dst, edge_label);
+  }
+
   size_t GetInDegree(label_t label, vid_t u, label_t neighbor_label,
                      label_t edge_label) const;
 
@@ -583,6 +626,22 @@ class ReadTransaction {
     return ImmutableGraphView<EDATA_T>(*csr);
   }
 
+  template <typename EDATA_T>
+  CompressedGraphView<EDATA_T> GetOutgoingCompressedGraphView(
+      label_t v_label, label_t neighbor_label, label_t edge_label) const {
+    auto csr = dynamic_cast<const CompressedImmutableCsr<EDATA_T>*>(
+        graph_.get_oe_csr(v_label, neighbor_label, edge_label));
+    return CompressedGraphView<EDATA_T>(*csr);
+  }
+
+  template <typename EDATA_T>
+  CompressedGraphView<EDATA_T> GetIncomingCompressedGraphView(
+      label_t v_label, label_t neighbor_label, label_t edge_label) const {
+    auto csr = dynamic_cast<const CompressedImmutableCsr<EDATA_T>*>(
+        graph_.get_ie_csr(v_label, neighbor_label, edge_label));
+    return CompressedGraphView<EDATA_T>(*csr);
+  }
+
   const GraphDBSession& GetSession() const;
 
  private:
@@ -591,6 +650,7 @@ class ReadTransaction {
   const MutablePropertyFragment& graph_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  uint64_t epoch_;
 };
 
 }  // namespace gs
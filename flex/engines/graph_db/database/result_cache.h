@@ -0,0 +1,137 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_RESULT_CACHE_H_
+#define GRAPHSCOPE_DATABASE_RESULT_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flex/engines/graph_db/database/label_set.h"
+#include "flex/engines/graph_db/database/version_manager.h"
+#include "flex/utils/lru_cache.h"
+
+namespace gs {
+
+struct ResultCacheStats {
+  size_t size = 0;
+  size_t capacity = 0;
+  uint64_t hit_num = 0;
+  uint64_t miss_num = 0;
+  // Entries found but dropped, a label they read written since.
+  uint64_t stale_num = 0;
+  uint64_t eviction_num = 0;
+};
+
+/**
+ * @brief The results of read queries, by query input, least recently used
+ * first evicted once capacity is reached.
+ *
+ * An entry keeps the read timestamp its query ran at no earlier than and the
+ * labels the query read. It is only returned while the version manager has
+ * recorded no write to those labels after that timestamp, and dropped once
+ * it has, so that a hit is the result the query would return now.
+ *
+ * Sharded like runtime::PlanCache.
+ */
+class ResultCache {
+ public:
+  static constexpr size_t SHARD_NUM = 16;
+  // Larger results are not kept, they would evict many smaller ones.
+  static constexpr size_t MAX_RESULT_SIZE = 1 << 20;
+
+  ResultCache(const VersionManager& vm, size_t capacity) : vm_(vm) {
+    for (size_t i = 0; i < SHARD_NUM; ++i) {
+      shards_[i] = std::make_unique<Shard>((capacity + SHARD_NUM - 1) /
+                                           SHARD_NUM);
+    }
+  }
+
+  bool get(const std::string& key, std::vector<char>& result) const {
+    Shard& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const Entry* entry = shard.entries.get(key);
+    if (entry == nullptr) {
+      return false;
+    }
+    if (vm_.last_write_ts(entry->labels) > entry->ts) {
+      shard.entries.erase(key);
+      ++shard.stale_num;
+      return false;
+    }
+    result = entry->result;
+    return true;
+  }
+
+  // ts is a read timestamp taken before the query started.
+  void put(const std::string& key, uint32_t ts, const LabelSet& labels,
+           const std::vector<char>& result) {
+    if (result.size() > MAX_RESULT_SIZE) {
+      return;
+    }
+    Shard& shard = shard_of(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.put(key, Entry{ts, labels, result});
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->entries.clear();
+    }
+  }
+
+  ResultCacheStats stats() const {
+    ResultCacheStats ret;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      ret.size += shard->entries.size();
+      ret.capacity += shard->entries.capacity();
+      ret.hit_num += shard->entries.hit_num() - shard->stale_num;
+      ret.miss_num += shard->entries.miss_num();
+      ret.stale_num += shard->stale_num;
+      ret.eviction_num += shard->entries.eviction_num();
+    }
+    return ret;
+  }
+
+ private:
+  struct Entry {
+    uint32_t ts;
+    LabelSet labels;
+    std::vector<char> result;
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity) : entries(capacity), stale_num(0) {}
+
+    std::mutex mutex;
+    LruCache<std::string, Entry> entries;
+    uint64_t stale_num;
+  };
+
+  Shard& shard_of(const std::string& key) const {
+    return *shards_[std::hash<std::string>()(key) % SHARD_NUM];
+  }
+
+  const VersionManager& vm_;
+  std::unique_ptr<Shard> shards_[SHARD_NUM];
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_RESULT_CACHE_H_
@@ -16,6 +16,7 @@
 #include "grape/serialization/out_archive.h"
 
 #include "flex/engines/graph_db/database/single_edge_insert_transaction.h"
+#include "flex/engines/graph_db/database/insert_listener.h"
 #include "flex/engines/graph_db/database/transaction_utils.h"
 #include "flex/engines/graph_db/database/version_manager.h"
 #include "flex/engines/graph_db/database/wal/wal.h"
@@ -26,12 +27,13 @@ namespace gs {
 
 SingleEdgeInsertTransaction::SingleEdgeInsertTransaction(
     MutablePropertyFragment& graph, Allocator& alloc, IWalWriter& logger,
-    VersionManager& vm, timestamp_t timestamp)
+    VersionManager& vm, timestamp_t timestamp, IInsertListener* listener)
     : graph_(graph),
       alloc_(alloc),
       logger_(logger),
       vm_(vm),
-      timestamp_(timestamp) {
+      timestamp_(timestamp),
+      listener_(listener) {
   arc_.Resize(sizeof(WalHeader));
 }
 
@@ -136,6 +138,13 @@ bool SingleEdgeInsertTransaction::Commit() {
   }
   graph_.IngestEdge(src_label_, src_vid_, dst_label_, dst_vid_, edge_label_,
                     timestamp_, arc, alloc_);
+  if (listener_ != nullptr) {
+    listener_->OnEdgesInserted(src_label_, dst_label_, edge_label_, &src_vid_,
+                               &dst_vid_, 1);
+  }
+  LabelSet labels;
+  labels.add_edge_label(edge_label_);
+  vm_.record_write(labels, timestamp_);
   vm_.release_insert_timestamp(timestamp_);
   clear();
   return true;
@@ -25,13 +25,15 @@ namespace gs {
 class MutablePropertyFragment;
 class IWalWriter;
 class VersionManager;
+class IInsertListener;
 struct Any;
 
 class SingleEdgeInsertTransaction {
  public:
   SingleEdgeInsertTransaction(MutablePropertyFragment& graph, Allocator& alloc,
                               IWalWriter& logger, VersionManager& vm,
-                              timestamp_t timestamp);
+                              timestamp_t timestamp,
+                              IInsertListener* listener = nullptr);
   ~SingleEdgeInsertTransaction();
 
   bool AddEdge(label_t src_label, const Any& src, label_t dst_label,
@@ -60,6 +62,7 @@ class SingleEdgeInsertTransaction {
   IWalWriter& logger_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  IInsertListener* listener_;
 };
 
 }  // namespace gs
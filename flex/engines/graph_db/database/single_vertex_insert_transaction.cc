@@ -16,6 +16,7 @@
 #include "grape/serialization/out_archive.h"
 
 #include "flex/engines/graph_db/database/single_vertex_insert_transaction.h"
+#include "flex/engines/graph_db/database/insert_listener.h"
 #include "flex/engines/graph_db/database/transaction_utils.h"
 #include "flex/engines/graph_db/database/version_manager.h"
 #include "flex/engines/graph_db/database/wal/wal.h"
@@ -26,12 +27,14 @@ namespace gs {
 
 SingleVertexInsertTransaction::SingleVertexInsertTransaction(
     MutablePropertyFragment& graph, Allocator& alloc, IWalWriter& logger,
-    VersionManager& vm, timestamp_t timestamp)
-    : graph_(graph),
+    VersionManager& vm, timestamp_t timestamp, IInsertListener* listener)
+    : added_vertex_num_(0),
+      graph_(graph),
       alloc_(alloc),
       logger_(logger),
       vm_(vm),
-      timestamp_(timestamp) {
+      timestamp_(timestamp),
+      listener_(listener) {
   arc_.Resize(sizeof(WalHeader));
 }
 SingleVertexInsertTransaction::~SingleVertexInsertTransaction() { Abort(); }
@@ -45,6 +48,11 @@ bool SingleVertexInsertTransaction::AddVertex(label_t label, const Any& id,
       graph_.schema().get_vertex_properties(label);
   if (types.size() != props.size()) {
     arc_.Resize(arc_size);
+    // The properties dropped but not compacted yet may be left out.
+    std::vector<Any> filled(props);
+    if (graph_.schema().fill_dropped_vertex_properties(label, filled)) {
+      return AddVertex(label, id, filled);
+    }
     std::string label_name = graph_.schema().get_vertex_label_name(label);
     LOG(ERROR) << "Vertex [" << label_name
                << "] properties size not match, expected " << types.size()
@@ -69,6 +77,8 @@ bool SingleVertexInsertTransaction::AddVertex(label_t label, const Any& id,
   }
   added_vertex_id_ = id;
   added_vertex_label_ = label;
+  ++added_vertex_num_;
+  written_labels_.add_vertex_label(label);
   return true;
 }
 
@@ -147,6 +157,7 @@ bool SingleVertexInsertTransaction::AddEdge(label_t src_label, const Any& src,
   serialize_field(arc_, prop);
   parsed_endpoints_.push_back(src_vid);
   parsed_endpoints_.push_back(dst_vid);
+  written_labels_.add_edge_label(edge_label);
   return true;
 }
 
@@ -164,13 +175,25 @@ bool SingleVertexInsertTransaction::Commit() {
   header->type = 0;
   header->timestamp = timestamp_;
 
+  if (added_vertex_num_ != 0 &&
+      !graph_.ClaimVertexSlots(added_vertex_label_, added_vertex_num_)) {
+    Abort();
+    return false;
+  }
   if (!logger_.append(arc_.GetBuffer(), arc_.GetSize())) {
     LOG(ERROR) << "Failed to append wal log";
+    if (added_vertex_num_ != 0) {
+      graph_.ReleaseVertexSlots(added_vertex_label_, added_vertex_num_);
+    }
     Abort();
     return false;
   }
   ingestWal();
+  if (added_vertex_num_ != 0) {
+    graph_.ReleaseVertexSlots(added_vertex_label_, added_vertex_num_);
+  }
 
+  vm_.record_write(written_labels_, timestamp_);
   vm_.release_insert_timestamp(timestamp_);
   clear();
   return true;
@@ -204,6 +227,10 @@ void SingleVertexInsertTransaction::ingestWal() {
           graph_.add_vertex(added_vertex_label_, added_vertex_id_);
       graph_.get_vertex_table(added_vertex_label_)
           .ingest(added_vertex_vid_, arc);
+      graph_.IndexVertex(added_vertex_label_, added_vertex_vid_);
+      if (listener_ != nullptr) {
+        listener_->OnVertexInserted(added_vertex_label_, added_vertex_vid_);
+      }
     } else if (op_type == 1) {
       Any temp;
       label_t src_label, dst_label, edge_label;
@@ -223,6 +250,10 @@ void SingleVertexInsertTransaction::ingestWal() {
 
       graph_.IngestEdge(src_label, src_vid, dst_label, dst_vid, edge_label,
                         timestamp_, arc, alloc_);
+      if (listener_ != nullptr) {
+        listener_->OnEdgesInserted(src_label, dst_label, edge_label, &src_vid,
+                                   &dst_vid, 1);
+      }
     } else {
       LOG(FATAL) << "Unexpected op-" << static_cast<int>(op_type);
     }
@@ -232,6 +263,8 @@ void SingleVertexInsertTransaction::ingestWal() {
 void SingleVertexInsertTransaction::clear() {
   arc_.Clear();
   arc_.Resize(sizeof(WalHeader));
+  written_labels_.clear();
+  added_vertex_num_ = 0;
 
   timestamp_ = std::numeric_limits<timestamp_t>::max();
 }
@@ -16,6 +16,7 @@
 #ifndef GRAPHSCOPE_DATABASE_SINGLE_VERTEX_INSERT_TRANSACTION_H_
 #define GRAPHSCOPE_DATABASE_SINGLE_VERTEX_INSERT_TRANSACTION_H_
 
+#include "flex/engines/graph_db/database/label_set.h"
 #include "flex/storages/rt_mutable_graph/types.h"
 #include "flex/utils/allocators.h"
 #include "flex/utils/property/types.h"
@@ -26,12 +27,14 @@ namespace gs {
 class MutablePropertyFragment;
 class IWalWriter;
 class VersionManager;
+class IInsertListener;
 
 class SingleVertexInsertTransaction {
  public:
   SingleVertexInsertTransaction(MutablePropertyFragment& graph,
                                 Allocator& alloc, IWalWriter& logger,
-                                VersionManager& vm, timestamp_t timestamp);
+                                VersionManager& vm, timestamp_t timestamp,
+                                IInsertListener* listener = nullptr);
   ~SingleVertexInsertTransaction();
 
   bool AddVertex(label_t label, const Any& id, const std::vector<Any>& props);
@@ -53,9 +56,13 @@ class SingleVertexInsertTransaction {
   grape::InArchive arc_;
 
   label_t added_vertex_label_;
+  // The slots of the vertices added are claimed on commit.
+  size_t added_vertex_num_;
   Any added_vertex_id_;
   vid_t added_vertex_vid_;
   std::vector<vid_t> parsed_endpoints_;
+  // Recorded in the version manager on commit.
+  LabelSet written_labels_;
 
   MutablePropertyFragment& graph_;
 
@@ -64,6 +71,7 @@ class SingleVertexInsertTransaction {
   IWalWriter& logger_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  IInsertListener* listener_;
 };
 
 }  // namespace gs
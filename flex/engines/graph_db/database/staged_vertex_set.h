@@ -0,0 +1,180 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_DATABASE_STAGED_VERTEX_SET_H_
+#define GRAPHSCOPE_DATABASE_STAGED_VERTEX_SET_H_
+
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/id_indexer.h"
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+/**
+ * @brief The vertices added by an insert transaction, one open-addressing
+ * table with linear probing per label.
+ *
+ * String keys are copied into chunks owned by the set. clear() only resets
+ * the slots in use and keeps the tables and the chunks, so a set reused by
+ * the transactions of a session stops allocating once it has grown to the
+ * size of the largest of them.
+ */
+class StagedVertexSet {
+ public:
+  static constexpr size_t MIN_CAPACITY = 16;
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+  StagedVertexSet() : used_chunks_(0), chunk_loc_(0) {}
+  ~StagedVertexSet() = default;
+
+  StagedVertexSet(const StagedVertexSet&) = delete;
+  StagedVertexSet& operator=(const StagedVertexSet&) = delete;
+
+  // Returns false if the vertex is staged already.
+  bool insert(label_t label, const Any& oid) {
+    if (label >= tables_.size()) {
+      tables_.resize(label + 1);
+    }
+    Table& table = tables_[label];
+    if ((table.used.size() + 1) * 2 > table.slots.size()) {
+      grow(table);
+    }
+    Any key = normalize(oid);
+    size_t hash = hasher_(key);
+    size_t mask = table.slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      Slot& slot = table.slots[i];
+      if (!slot.occupied) {
+        slot.occupied = true;
+        slot.hash = hash;
+        slot.key = key.type == PropertyType::kStringView
+                       ? Any::From(copy_string(key.AsStringView()))
+                       : key;
+        table.used.push_back(i);
+        return true;
+      }
+      if (slot.hash == hash && slot.key == key) {
+        return false;
+      }
+    }
+  }
+
+  bool contains(label_t label, const Any& oid) const {
+    if (label >= tables_.size() || tables_[label].used.empty()) {
+      return false;
+    }
+    const Table& table = tables_[label];
+    Any key = normalize(oid);
+    size_t hash = hasher_(key);
+    size_t mask = table.slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot& slot = table.slots[i];
+      if (!slot.occupied) {
+        return false;
+      }
+      if (slot.hash == hash && slot.key == key) {
+        return true;
+      }
+    }
+  }
+
+  void clear() {
+    for (auto& table : tables_) {
+      for (size_t i : table.used) {
+        table.slots[i].occupied = false;
+      }
+      table.used.clear();
+    }
+    used_chunks_ = 0;
+    chunk_loc_ = 0;
+    large_strings_.clear();
+  }
+
+ private:
+  struct Slot {
+    Slot() : occupied(false), hash(0) {}
+
+    bool occupied;
+    size_t hash;
+    Any key;
+  };
+
+  struct Table {
+    // The capacity is a power of two, kept at least twice the size.
+    std::vector<Slot> slots;
+    // The indices of the occupied slots, in insertion order.
+    std::vector<size_t> used;
+  };
+
+  // Strings of any type compare and hash as string views.
+  static Any normalize(const Any& oid) {
+    if (oid.type == PropertyType::kStringView) {
+      return Any::From(oid.AsStringView());
+    }
+    return oid;
+  }
+
+  static void grow(Table& table) {
+    std::vector<Slot> slots(std::max(MIN_CAPACITY, table.slots.size() * 2));
+    size_t mask = slots.size() - 1;
+    for (size_t& idx : table.used) {
+      Slot& old_slot = table.slots[idx];
+      size_t i = old_slot.hash & mask;
+      while (slots[i].occupied) {
+        i = (i + 1) & mask;
+      }
+      slots[i] = old_slot;
+      idx = i;
+    }
+    table.slots.swap(slots);
+  }
+
+  std::string_view copy_string(std::string_view str) {
+    char* ptr;
+    if (str.size() > CHUNK_SIZE) {
+      large_strings_.emplace_back(new char[str.size()]);
+      ptr = large_strings_.back().get();
+    } else {
+      if (used_chunks_ == 0 || chunk_loc_ + str.size() > CHUNK_SIZE) {
+        if (used_chunks_ == chunks_.size()) {
+          chunks_.emplace_back(new char[CHUNK_SIZE]);
+        }
+        ++used_chunks_;
+        chunk_loc_ = 0;
+      }
+      ptr = chunks_[used_chunks_ - 1].get() + chunk_loc_;
+      chunk_loc_ += str.size();
+    }
+    memcpy(ptr, str.data(), str.size());
+    return std::string_view(ptr, str.size());
+  }
+
+  std::vector<Table> tables_;
+  GHash<Any> hasher_;
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  size_t used_chunks_;
+  size_t chunk_loc_;
+  std::vector<std::unique_ptr<char[]>> large_strings_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_DATABASE_STAGED_VERTEX_SET_H_
@@ -44,8 +44,12 @@ UpdateTransaction::UpdateTransaction(const GraphDBSession& session,
       logger_(logger),
       vm_(vm),
       timestamp_(timestamp),
+      epoch_(vm.epoch_manager().pin()),
       op_num_(0) {
   arc_.Resize(sizeof(WalHeader));
+  // No other transaction runs under an update timestamp, so the property
+  // versions can be written into the tables read and written below.
+  graph_.FoldVertexPropertyVersions();
 
   vertex_label_num_ = graph_.schema().vertex_label_num();
   edge_label_num_ = graph_.schema().edge_label_num();
@@ -115,14 +119,28 @@ bool UpdateTransaction::Commit() {
   header->length = arc_.GetSize() - sizeof(WalHeader);
   header->type = 1;
   header->timestamp = timestamp_;
+  std::vector<size_t> added_vertex_nums(vertex_label_num_);
+  for (label_t label = 0; label < vertex_label_num_; ++label) {
+    added_vertex_nums[label] = added_vertices_[label]->size();
+  }
+  if (!graph_.ClaimVertexSlots(added_vertex_nums)) {
+    Abort();
+    return false;
+  }
   if (!logger_.append(arc_.GetBuffer(), arc_.GetSize())) {
     LOG(ERROR) << "Failed to append wal log";
+    graph_.ReleaseVertexSlots(added_vertex_nums);
     Abort();
     return false;
   }
 
   applyVerticesUpdates();
+  graph_.ReleaseVertexSlots(added_vertex_nums);
   applyEdgesUpdates();
+  // Updates may delete vertices and edges of any label, and alter the schema.
+  LabelSet labels;
+  labels.add_all();
+  vm_.record_write(labels, timestamp_);
   release();
   return true;
 }
@@ -135,6 +153,11 @@ bool UpdateTransaction::AddVertex(label_t label, const Any& oid,
   const std::vector<PropertyType>& types =
       graph_.schema().get_vertex_properties(label);
   if (types.size() != props.size()) {
+    // The properties dropped but not compacted yet may be left out.
+    std::vector<Any> filled(props);
+    if (graph_.schema().fill_dropped_vertex_properties(label, filled)) {
+      return AddVertex(label, oid, filled);
+    }
     return false;
   }
   int col_num = types.size();
@@ -153,6 +176,7 @@ bool UpdateTransaction::AddVertex(label_t label, const Any& oid,
   }
 
   vid_t row_num = vertex_offsets_[label].size();
+  reserve_extra_vertex_rows(label, row_num + 1);
   vertex_offsets_[label].emplace(id, row_num);
   grape::InArchive arc;
   for (auto& prop : props) {
@@ -190,12 +214,16 @@ bool UpdateTransaction::AddEdge(label_t src_label, const Any& src,
   size_t offset_out = sentinel, offset_in = sentinel;
   if (graph_.get_lid(src_label, src, src_lid) &&
       graph_.get_lid(dst_label, dst, dst_lid)) {
-    const auto& oe =
-        graph_.get_outgoing_edges(src_label, src_lid, dst_label, edge_label);
-    offset_out = get_offset(oe, dst_lid);
-    const auto& ie =
-        graph_.get_incoming_edges(dst_label, dst_lid, src_label, edge_label);
-    offset_in = get_offset(ie, src_lid);
+    // The existence filter, if any, lets new edges skip both scans.
+    if (graph_.may_have_edge(src_label, src_lid, dst_label, dst_lid,
+                             edge_label)) {
+      const auto& oe =
+          graph_.get_outgoing_edges(src_label, src_lid, dst_label, edge_label);
+      offset_out = get_offset(oe, dst_lid);
+      const auto& ie =
+          graph_.get_incoming_edges(dst_label, dst_lid, src_label, edge_label);
+      offset_in = get_offset(ie, src_lid);
+    }
   } else {
     if (!oid_to_lid(src_label, src, src_lid) ||
         !oid_to_lid(dst_label, dst, dst_lid)) {
@@ -465,20 +493,13 @@ bool UpdateTransaction::SetVertexField(label_t label, vid_t lid, int col_id,
     if (graph_.vertex_num(label) <= lid) {
       return false;
     }
-    vid_t new_offset = vertex_offset.size();
-    vertex_offset.emplace(lid, new_offset);
-    size_t col_num = table.col_num();
-    for (size_t i = 0; i < col_num; ++i) {
-      extra_table.get_column_by_id(i)->set_any(
-          new_offset, table.get_column_by_id(i)->get(lid));
-    }
-    extra_table.get_column_by_id(col_id)->set_any(new_offset, value);
   } else {
     if (extra_table.col_num() <= static_cast<size_t>(col_id)) {
       return false;
     }
-    extra_table.get_column_by_id(col_id)->set_any(iter->second, value);
   }
+  extra_table.get_column_by_id(col_id)->set_any(
+      get_extra_vertex_row(label, lid), value);
 
   op_num_ += 1;
   arc_ << static_cast<uint8_t>(2) << label;
@@ -488,6 +509,46 @@ bool UpdateTransaction::SetVertexField(label_t label, vid_t lid, int col_id,
   return true;
 }
 
+bool UpdateTransaction::SetVertexFields(label_t label, int col_id,
+                                        const std::vector<vid_t>& lids,
+                                        const std::vector<Any>& values) {
+  const std::vector<PropertyType>& types =
+      graph_.schema().get_vertex_properties(label);
+  if (lids.size() != values.size() || col_id < 0 ||
+      static_cast<size_t>(col_id) >= types.size() ||
+      graph_.get_vertex_table(label).col_num() <=
+          static_cast<size_t>(col_id)) {
+    return false;
+  }
+  for (const auto& value : values) {
+    if (types[col_id] != value.type) {
+      return false;
+    }
+  }
+  const auto& vertex_offset = vertex_offsets_[label];
+  vid_t vertex_num = graph_.vertex_num(label);
+  for (auto lid : lids) {
+    if (lid >= vertex_num && vertex_offset.find(lid) == vertex_offset.end()) {
+      return false;
+    }
+  }
+  auto column = extra_vertex_properties_[label].get_column_by_id(col_id);
+  for (size_t i = 0; i < lids.size(); ++i) {
+    column->set_any(get_extra_vertex_row(label, lids[i]), values[i]);
+  }
+
+  op_num_ += lids.size();
+  arc_ << static_cast<uint8_t>(4) << label << col_id
+       << static_cast<uint32_t>(lids.size());
+  for (auto lid : lids) {
+    serialize_field(arc_, lid_to_oid(label, lid));
+  }
+  for (const auto& value : values) {
+    serialize_field(arc_, value);
+  }
+  return true;
+}
+
 void UpdateTransaction::SetEdgeData(bool dir, label_t label, vid_t v,
                                     label_t neighbor_label, vid_t nbr,
                                     label_t edge_label, const Any& value) {
@@ -621,6 +682,7 @@ void UpdateTransaction::IngestWal(MutablePropertyFragment& graph,
         vid = graph.add_vertex(label, oid);
       }
       graph.get_vertex_table(label).ingest(vid, arc);
+      graph.IndexVertex(label, vid);
     } else if (op_type == 1) {
       label_t src_label, dst_label, edge_label;
       Any src, dst;
@@ -640,7 +702,27 @@ void UpdateTransaction::IngestWal(MutablePropertyFragment& graph,
       arc >> col_id;
       vid_t vid;
       CHECK(graph.get_lid(label, oid, vid));
-      graph.get_vertex_table(label).get_column_by_id(col_id)->ingest(vid, arc);
+      auto column = graph.get_vertex_table(label).get_column_by_id(col_id);
+      column->ingest(vid, arc);
+      graph.IndexVertexProperty(label, vid, col_id, column->get(vid));
+    } else if (op_type == 4) {
+      label_t label;
+      int col_id;
+      uint32_t vertex_num;
+      arc >> label >> col_id >> vertex_num;
+      std::vector<vid_t> vids(vertex_num);
+      Any oid;
+      oid.type =
+          std::get<0>(graph.schema().get_vertex_primary_key(label).at(0));
+      for (auto& vid : vids) {
+        deserialize_field(arc, oid);
+        CHECK(graph.get_lid(label, oid, vid));
+      }
+      auto column = graph.get_vertex_table(label).get_column_by_id(col_id);
+      for (auto vid : vids) {
+        column->ingest(vid, arc);
+        graph.IndexVertexProperty(label, vid, col_id, column->get(vid));
+      }
     } else if (op_type == 3) {
       uint8_t dir;
       label_t label, neighbor_label, edge_label;
@@ -673,6 +755,24 @@ void UpdateTransaction::IngestWal(MutablePropertyFragment& graph,
         }
         edge_iter->next();
       }
+    } else if (op_type == 5 || op_type == 6) {
+      // A schema change is a record of its own. Skipped if the graph has it
+      // already, as when opened from a schema that was changed alike.
+      label_t label;
+      std::string prop_name;
+      arc >> label >> prop_name;
+      bool exists =
+          graph.get_vertex_table(label).get_column_id_by_name(prop_name) >= 0;
+      if (op_type == 5) {
+        PropertyType type;
+        StorageStrategy strategy;
+        arc >> type >> strategy;
+        if (!exists) {
+          graph.AddVertexProperty(label, prop_name, type, strategy, timestamp);
+        }
+      } else if (exists) {
+        graph.DropVertexProperty(label, prop_name);
+      }
     } else {
       LOG(FATAL) << "unexpected op_type " << static_cast<int>(op_type) << "..";
     }
@@ -717,9 +817,38 @@ Any UpdateTransaction::lid_to_oid(label_t label, vid_t lid) const {
   }
 }
 
+vid_t UpdateTransaction::get_extra_vertex_row(label_t label, vid_t lid) {
+  auto& vertex_offset = vertex_offsets_[label];
+  auto iter = vertex_offset.find(lid);
+  if (iter != vertex_offset.end()) {
+    return iter->second;
+  }
+  const auto& table = graph_.get_vertex_table(label);
+  auto& extra_table = extra_vertex_properties_[label];
+  vid_t new_offset = vertex_offset.size();
+  reserve_extra_vertex_rows(label, new_offset + 1);
+  vertex_offset.emplace(lid, new_offset);
+  size_t col_num = table.col_num();
+  for (size_t i = 0; i < col_num; ++i) {
+    extra_table.get_column_by_id(i)->set_any(
+        new_offset, table.get_column_by_id(i)->get(lid));
+  }
+  return new_offset;
+}
+
+void UpdateTransaction::reserve_extra_vertex_rows(label_t label,
+                                                  size_t row_num) {
+  auto& extra_table = extra_vertex_properties_[label];
+  size_t capacity = extra_table.row_num();
+  if (row_num > capacity && extra_table.col_num() > 0) {
+    extra_table.resize(std::max(row_num, capacity * 2));
+  }
+}
+
 void UpdateTransaction::release() {
   if (timestamp_ != std::numeric_limits<timestamp_t>::max()) {
     arc_.Clear();
+    vm_.epoch_manager().unpin(epoch_);
     vm_.release_update_timestamp(timestamp_);
     timestamp_ = std::numeric_limits<timestamp_t>::max();
 
@@ -738,9 +867,20 @@ bool UpdateTransaction::batch_commit(UpdateBatch& batch) {
   if (timestamp_ == std::numeric_limits<timestamp_t>::max()) {
     return true;
   }
+  LabelSet labels;
   const auto& updateVertices = batch.GetUpdateVertices();
+  // Vertices updated rather than added claim a slot too, until they are in.
+  std::vector<size_t> vertex_nums(vertex_label_num_, 0);
+  for (auto& [label, oid, props] : updateVertices) {
+    ++vertex_nums[label];
+  }
+  if (!graph_.ClaimVertexSlots(vertex_nums)) {
+    Abort();
+    return false;
+  }
   for (auto& [label, oid, props] : updateVertices) {
     vid_t lid;
+    labels.add_vertex_label(label);
 
     if (graph_.get_lid(label, oid, lid)) {
       graph_.get_vertex_table(label).insert(lid, props);
@@ -748,13 +888,16 @@ bool UpdateTransaction::batch_commit(UpdateBatch& batch) {
       lid = graph_.add_vertex(label, oid);
       graph_.get_vertex_table(label).insert(lid, props);
     }
+    graph_.IndexVertex(label, lid);
   }
+  graph_.ReleaseVertexSlots(vertex_nums);
   const auto& updateEdges = batch.GetUpdateEdges();
 
   for (auto& [src_label, src, dst_label, dst, edge_label, prop] : updateEdges) {
     vid_t src_lid, dst_lid;
     bool src_flag = graph_.get_lid(src_label, src, src_lid);
     bool dst_flag = graph_.get_lid(dst_label, dst, dst_lid);
+    labels.add_edge_label(edge_label);
 
     if (src_flag && dst_flag) {
       graph_.UpdateEdge(src_label, src_lid, dst_label, dst_lid, edge_label,
@@ -774,6 +917,7 @@ bool UpdateTransaction::batch_commit(UpdateBatch& batch) {
     }
   }
 
+  vm_.record_write(labels, timestamp_);
   release();
   return true;
 }
@@ -800,6 +944,7 @@ void UpdateTransaction::applyVerticesUpdates() {
       vid_t offset = vertex_offset.at(pair.first);
       vid_t lid = graph_.add_vertex(label, pair.second);
       graph_.get_vertex_table(label).insert(lid, table.get_row(offset));
+      graph_.IndexVertex(label, lid);
       CHECK_EQ(lid, pair.first);
       vertex_offset.erase(pair.first);
     }
@@ -808,6 +953,7 @@ void UpdateTransaction::applyVerticesUpdates() {
       vid_t lid = pair.first;
       vid_t offset = pair.second;
       graph_.get_vertex_table(label).insert(lid, table.get_row(offset));
+      graph_.IndexVertex(label, lid);
     }
 
     CHECK_EQ(graph_.vertex_num(label), vertex_nums_[label]);
@@ -139,6 +139,13 @@ class UpdateTransaction {
 
   bool SetVertexField(label_t label, vid_t lid, int col_id, const Any& value);
 
+  // Sets property col_id of vertex lids[i] to values[i] for every i. The
+  // assignments are logged as a single entry, which stores the ids and then
+  // the values. Nothing is set if any of the vertices or values is invalid.
+  bool SetVertexFields(label_t label, int col_id,
+                       const std::vector<vid_t>& lids,
+                       const std::vector<Any>& values);
+
   void SetEdgeData(bool dir, label_t label, vid_t v, label_t neighbor_label,
                    vid_t nbr, label_t edge_label, const Any& value);
 
@@ -172,6 +179,13 @@ class UpdateTransaction {
 
   Any lid_to_oid(label_t label, vid_t lid) const;
 
+  // The row of vertex lid in the extra table of the label, which is added
+  // with the properties of the vertex in the graph if there is none yet.
+  vid_t get_extra_vertex_row(label_t label, vid_t lid);
+
+  // Grows the extra table of the label to hold at least row_num rows.
+  void reserve_extra_vertex_rows(label_t label, size_t row_num);
+
   void release();
 
   void applyVerticesUpdates();
@@ -185,6 +199,7 @@ class UpdateTransaction {
   IWalWriter& logger_;
   VersionManager& vm_;
   timestamp_t timestamp_;
+  uint64_t epoch_;
 
   grape::InArchive arc_;
   int op_num_;
@@ -15,6 +15,8 @@
 
 #include "flex/engines/graph_db/database/version_manager.h"
 
+#include <algorithm>
+
 #include "flex/engines/graph_db/app/app_base.h"
 
 #define likely(x) __builtin_expect(!!(x), 1)
@@ -24,7 +26,16 @@ namespace gs {
 constexpr static uint32_t ring_buf_size = 1024 * 1024;
 constexpr static uint32_t ring_index_mask = ring_buf_size - 1;
 
-VersionManager::VersionManager() { buf_.init(ring_buf_size); }
+VersionManager::VersionManager()
+    : released_(new std::atomic<uint32_t>[ring_buf_size]),
+      label_write_ts_(new std::atomic<uint32_t>[LabelSet::SLOT_NUM]) {
+  for (uint32_t i = 0; i < ring_buf_size; ++i) {
+    released_[i].store(0);
+  }
+  for (size_t i = 0; i < LabelSet::SLOT_NUM; ++i) {
+    label_write_ts_[i].store(0);
+  }
+}
 
 VersionManager::~VersionManager() {}
 
@@ -32,102 +43,165 @@ void VersionManager::init_ts(uint32_t ts, int thread_num) {
   write_ts_.store(ts + 1);
   read_ts_.store(ts);
   thread_num_ = thread_num;
+  read_slots_.reset(new ReadSlot[thread_num]);
 }
 
 void VersionManager::clear() {
   write_ts_.store(1);
   read_ts_.store(0);
   pending_reqs_.store(0);
-  buf_.clear();
+  for (uint32_t i = 0; i < ring_buf_size; ++i) {
+    released_[i].store(0);
+  }
+  for (size_t i = 0; i < LabelSet::SLOT_NUM; ++i) {
+    label_write_ts_[i].store(0);
+  }
+  all_write_ts_.store(0);
+  any_write_ts_.store(0);
+  epoch_manager_.clear();
+}
+
+// Registers a read or insert transaction in pending_reqs_, which is negative
+// while an update transaction runs.
+void VersionManager::enter_pending() {
+  if (likely(pending_reqs_.fetch_add(1) >= 0)) {
+    return;
+  }
+  leave_pending();
+  while (true) {
+    update_done_.await([this]() { return pending_reqs_.load() >= 0; });
+    if (pending_reqs_.fetch_add(1) >= 0) {
+      return;
+    }
+    leave_pending();
+  }
+}
+
+void VersionManager::leave_pending() {
+  // Only reaches -thread_num_ when the last transaction ahead of a pending
+  // update leaves.
+  if (pending_reqs_.fetch_sub(1) - 1 == -thread_num_) {
+    drained_.notify_all();
+  }
 }
 
-uint32_t VersionManager::acquire_read_timestamp() {
-  int pr = pending_reqs_.fetch_add(1);
-  if (likely(pr >= 0)) {
+// The timestamp is loaded again after the slot is published: if
+// min_active_read_ts() misses the slot, it loaded read_ts_ before this second
+// load, which therefore returns no less.
+uint32_t VersionManager::acquire_read_timestamp(int session_id) {
+  enter_pending();
+  if (session_id < 0) {
     return read_ts_.load();
+  }
+  ReadSlot& slot = read_slots_[session_id];
+  if (slot.nested++ == 0) {
+    slot.owner = std::this_thread::get_id();
+    slot.ts.store(read_ts_.load());
   } else {
-    --pending_reqs_;
-    while (true) {
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      if (pending_reqs_.load() >= 0) {
-        pr = pending_reqs_.fetch_add(1);
-        if (pr >= 0) {
-          return read_ts_.load();
-        } else {
-          --pending_reqs_;
-        }
-      }
+    DCHECK(slot.owner == std::this_thread::get_id())
+        << "Session " << session_id << " read from two threads at a time";
+  }
+  return read_ts_.load();
+}
+
+void VersionManager::release_read_timestamp(int session_id) {
+  if (session_id >= 0) {
+    ReadSlot& slot = read_slots_[session_id];
+    DCHECK(slot.owner == std::this_thread::get_id())
+        << "Session " << session_id << " read from two threads at a time";
+    if (--slot.nested == 0) {
+      slot.ts.store(NO_READ);
     }
   }
+  leave_pending();
 }
 
-void VersionManager::release_read_timestamp() { pending_reqs_.fetch_sub(1); }
+uint32_t VersionManager::min_active_read_ts() const {
+  uint32_t ret = read_ts_.load();
+  for (int i = 0; i < thread_num_; ++i) {
+    ret = std::min(ret, read_slots_[i].ts.load());
+  }
+  return ret;
+}
+
+int VersionManager::active_read_num() const {
+  int ret = 0;
+  for (int i = 0; i < thread_num_; ++i) {
+    if (read_slots_[i].ts.load() != NO_READ) {
+      ++ret;
+    }
+  }
+  return ret;
+}
 
 uint32_t VersionManager::acquire_insert_timestamp() {
-  int pr = pending_reqs_.fetch_add(1);
-  if (likely(pr >= 0)) {
-    return write_ts_.fetch_add(1);
-  } else {
-    --pending_reqs_;
-    while (true) {
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-      if (pending_reqs_.load() >= 0) {
-        pr = pending_reqs_.fetch_add(1);
-        if (pr >= 0) {
-          return write_ts_.fetch_add(1);
-        } else {
-          --pending_reqs_;
-        }
-      }
+  enter_pending();
+  return write_ts_.fetch_add(1);
+}
+
+uint32_t VersionManager::upgrade_to_insert_timestamp() {
+  return write_ts_.fetch_add(1);
+}
+
+void VersionManager::mark_released(uint32_t ts) {
+  // Only happens when a transaction stalls while a whole ring of later ones
+  // commits.
+  while (ts - read_ts_.load() > ring_buf_size) {
+    std::this_thread::yield();
+  }
+  released_[ts & ring_index_mask].store(ts);
+}
+
+// A thread that marks ts released and then finds ts - 1 unreleased leaves ts
+// to the thread releasing ts - 1: the latter moves read_ts_ to ts - 1 before
+// checking ts, and the seq_cst ordering of the marks, the checks and the
+// compare-exchanges guarantees that one of the two sees the other's write.
+void VersionManager::advance_read_ts() {
+  while (true) {
+    uint32_t cur = read_ts_.load();
+    if (released_[(cur + 1) & ring_index_mask].load() != cur + 1) {
+      return;
     }
+    read_ts_.compare_exchange_strong(cur, cur + 1);
   }
 }
 
 void VersionManager::release_insert_timestamp(uint32_t ts) {
-  lock_.lock();
-  if (ts == read_ts_.load() + 1) {
-    while (buf_.reset_bit_with_ret((ts + 1) & ring_index_mask)) {
-      ++ts;
-    }
-    read_ts_.store(ts);
-  } else {
-    buf_.set_bit(ts & ring_index_mask);
+  uint32_t expected = ts - 1;
+  if (!read_ts_.compare_exchange_strong(expected, ts)) {
+    mark_released(ts);
   }
-  lock_.unlock();
+  advance_read_ts();
 
-  pending_reqs_.fetch_sub(1);
+  leave_pending();
 }
 
 uint32_t VersionManager::acquire_update_timestamp() {
-  int expected_update_reqs = 0;
-  while (
-      !pending_update_reqs_.compare_exchange_strong(expected_update_reqs, 1)) {
-    expected_update_reqs = 0;
-    std::this_thread::sleep_for(std::chrono::microseconds(100));
-  }
+  update_done_.await([this]() {
+    int expected_update_reqs = 0;
+    return pending_update_reqs_.compare_exchange_strong(expected_update_reqs,
+                                                        1);
+  });
 
   int pr = pending_reqs_.fetch_sub(thread_num_);
   if (pr != 0) {
-    while (pending_reqs_.load() != -thread_num_) {
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-    }
+    drained_.await([this]() { return pending_reqs_.load() == -thread_num_; });
   }
 
   return write_ts_.fetch_add(1);
 }
 void VersionManager::release_update_timestamp(uint32_t ts) {
-  lock_.lock();
-  if (ts == read_ts_.load() + 1) {
-    read_ts_.store(ts);
-  } else {
+  uint32_t expected = ts - 1;
+  if (!read_ts_.compare_exchange_strong(expected, ts)) {
     LOG(ERROR) << "read ts is expected to be " << ts - 1 << ", while it is "
-               << read_ts_.load();
-    buf_.set_bit(ts & ring_index_mask);
+               << expected;
+    mark_released(ts);
+    advance_read_ts();
   }
-  lock_.unlock();
 
   pending_reqs_ += thread_num_;
   pending_update_reqs_.store(0);
+  update_done_.notify_all();
 }
 
 bool VersionManager::revert_update_timestamp(uint32_t ts) {
@@ -135,11 +209,37 @@ bool VersionManager::revert_update_timestamp(uint32_t ts) {
   if (write_ts_.compare_exchange_strong(expected_ts, ts)) {
     pending_reqs_ += thread_num_;
     pending_update_reqs_.store(0);
+    update_done_.notify_all();
     return true;
   }
   return false;
 }
 
+static void store_max(std::atomic<uint32_t>& target, uint32_t ts) {
+  uint32_t cur = target.load();
+  while (cur < ts && !target.compare_exchange_weak(cur, ts)) {}
+}
+
+void VersionManager::record_write(const LabelSet& labels, uint32_t ts) {
+  if (labels.all()) {
+    store_max(all_write_ts_, ts);
+  }
+  labels.foreach_slot(
+      [this, ts](size_t slot) { store_max(label_write_ts_[slot], ts); });
+  store_max(any_write_ts_, ts);
+}
+
+uint32_t VersionManager::last_write_ts(const LabelSet& labels) const {
+  if (labels.all()) {
+    return any_write_ts_.load();
+  }
+  uint32_t ret = all_write_ts_.load();
+  labels.foreach_slot([this, &ret](size_t slot) {
+    ret = std::max(ret, label_write_ts_[slot].load());
+  });
+  return ret;
+}
+
 }  // namespace gs
 
 #undef likely
@@ -22,12 +22,15 @@
 
 #include <array>
 #include <atomic>
-#include <bitset>
+#include <limits>
+#include <memory>
 #include <thread>
 
 #include "glog/logging.h"
-#include "grape/utils/bitset.h"
-#include "grape/utils/concurrent_queue.h"
+
+#include "flex/engines/graph_db/database/label_set.h"
+#include "flex/utils/epoch_manager.h"
+#include "flex/utils/event_count.h"
 
 namespace gs {
 
@@ -40,17 +43,50 @@ class VersionManager {
 
   void clear();
 
-  uint32_t acquire_read_timestamp();
+  // A read of session session_id is recorded in the slot of the session
+  // until released, and holds back min_active_read_ts(). Reads without a
+  // session are not recorded.
+  uint32_t acquire_read_timestamp(int session_id = -1);
+
+  void release_read_timestamp(int session_id = -1);
 
-  void release_read_timestamp();
+  // No recorded read runs at a timestamp below the returned one, nor will
+  // any start at one: the smallest timestamp of the recorded reads, or the
+  // read timestamp if there is none. Versions only visible below it can be
+  // dropped.
+  uint32_t min_active_read_ts() const;
+
+  // Number of sessions running a recorded read.
+  int active_read_num() const;
 
   uint32_t acquire_insert_timestamp();
+  // Turns a read acquired without a session into an insert, whose timestamp
+  // is released by release_insert_timestamp(). Unlike acquiring one, it never
+  // waits for an update transaction, which the read holds back already.
+  uint32_t upgrade_to_insert_timestamp();
+  // Called once the writes of ts are visible. The read timestamp advances
+  // over the released timestamps that follow it, by whichever releasing
+  // thread finds them, without taking a lock.
   void release_insert_timestamp(uint32_t ts);
 
   uint32_t acquire_update_timestamp();
   void release_update_timestamp(uint32_t ts);
   bool revert_update_timestamp(uint32_t ts);
 
+  // The timestamp reads acquired now run at, seeing the writes up to it.
+  uint32_t read_ts() const { return read_ts_.load(); }
+
+  // Called by a write transaction before its timestamp ts is released, so
+  // that a read seeing the write finds it recorded.
+  void record_write(const LabelSet& labels, uint32_t ts);
+  // The latest timestamp a write to any of the labels was recorded at, 0 if
+  // there is none since the last clear().
+  uint32_t last_write_ts(const LabelSet& labels) const;
+
+  // Transactions that read adjacency lists pin this, so that buffers retired
+  // by concurrent writers are not reused under them.
+  EpochManager& epoch_manager() { return epoch_manager_; }
+
  private:
   std::atomic<uint32_t> write_ts_{1};
   std::atomic<uint32_t> read_ts_{0};
@@ -58,10 +94,47 @@ class VersionManager {
   std::atomic<int> pending_reqs_{0};
   std::atomic<int> pending_update_reqs_{0};
 
-  grape::Bitset buf_;
-  grape::SpinLock lock_;
-
-  int thread_num_;
+  void enter_pending();
+  void leave_pending();
+
+  // Records ts in its slot of the ring, once read_ts_ passed the timestamp
+  // that held the slot before.
+  void mark_released(uint32_t ts);
+  // Moves read_ts_ over the consecutive released timestamps after it.
+  void advance_read_ts();
+
+  // Slot ts modulo the ring size holds ts once it is released, so that a
+  // slot is never cleared and a stale value never matches.
+  std::unique_ptr<std::atomic<uint32_t>[]> released_;
+
+  static constexpr uint32_t NO_READ = std::numeric_limits<uint32_t>::max();
+
+  // Written by its session only, and padded so that sessions do not share
+  // cache lines. nested counts the reads of the session, of which ts holds
+  // the timestamp of the first, the oldest. A session is driven by one
+  // thread at a time, owner, which takes and releases all of its reads
+  // until nested is back to 0, hence nested needs no atomics.
+  struct alignas(64) ReadSlot {
+    std::atomic<uint32_t> ts{NO_READ};
+    int nested = 0;
+    std::thread::id owner;
+  };
+  std::unique_ptr<ReadSlot[]> read_slots_;
+
+  // Wakes the transactions waiting for a running update to finish, and the
+  // update waiting for the transactions ahead of it to finish.
+  EventCount update_done_;
+  EventCount drained_;
+
+  EpochManager epoch_manager_;
+
+  // The latest write timestamp recorded per slot of LabelSet, for writes to
+  // all labels, and for any write.
+  std::unique_ptr<std::atomic<uint32_t>[]> label_write_ts_;
+  std::atomic<uint32_t> all_write_ts_{0};
+  std::atomic<uint32_t> any_write_ts_{0};
+
+  int thread_num_ = 0;
 };
 
 }  // namespace gs
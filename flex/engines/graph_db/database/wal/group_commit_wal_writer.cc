@@ -0,0 +1,217 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/wal/group_commit_wal_writer.h"
+#include "flex/engines/graph_db/database/wal/local_wal_parser.h"
+#include "flex/engines/graph_db/database/wal/local_wal_writer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gs {
+
+// The wal file of a directory and its flusher, shared by the writers opened
+// on the directory.
+class GroupCommitLog {
+ public:
+  explicit GroupCommitLog(const std::string& dir);
+  ~GroupCommitLog();
+
+  // Returns the log of dir, opening it if no writer holds it.
+  static std::shared_ptr<GroupCommitLog> Get(const std::string& dir);
+
+  // Returns once data is durable.
+  bool append(const char* data, size_t length);
+
+ private:
+  void run();
+
+  void write(const std::vector<char>& batch, size_t offset);
+
+  int fd_;
+  size_t file_size_;
+
+  std::mutex mutex_;
+  std::condition_variable flush_cv_;
+  std::condition_variable durable_cv_;
+  // Records appended since the flusher took the last batch.
+  std::vector<char> buffer_;
+  // Bytes appended to and synced to the file.
+  size_t appended_;
+  size_t durable_;
+  bool running_;
+
+  std::thread flusher_;
+};
+
+GroupCommitLog::GroupCommitLog(const std::string& dir)
+    : fd_(-1), appended_(0), durable_(0), running_(true) {
+  if (!std::filesystem::exists(dir)) {
+    std::filesystem::create_directories(dir);
+  }
+  const int max_version = 65536;
+  for (int version = 0; version != max_version; ++version) {
+    std::string path = dir + "/group_" + std::to_string(version) + ".wal";
+    if (std::filesystem::exists(path)) {
+      continue;
+    }
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    break;
+  }
+  if (fd_ == -1) {
+    LOG(FATAL) << "Failed to open wal file " << strerror(errno);
+  }
+  if (ftruncate(fd_, LocalWalWriter::TRUNC_SIZE) != 0) {
+    LOG(FATAL) << "Failed to truncate wal file " << strerror(errno);
+  }
+  file_size_ = LocalWalWriter::TRUNC_SIZE;
+  buffer_.reserve(GroupCommitWalWriter::FLUSH_SIZE);
+  flusher_ = std::thread([this]() { run(); });
+}
+
+GroupCommitLog::~GroupCommitLog() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  flush_cv_.notify_all();
+  flusher_.join();
+  if (::close(fd_) != 0) {
+    LOG(FATAL) << "Failed to close file" << strerror(errno);
+  }
+}
+
+std::shared_ptr<GroupCommitLog> GroupCommitLog::Get(const std::string& dir) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string, std::weak_ptr<GroupCommitLog>> logs;
+  std::string key = std::filesystem::absolute(dir).lexically_normal().string();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto log = logs[key].lock();
+  if (log == nullptr) {
+    log = std::make_shared<GroupCommitLog>(dir);
+    logs[key] = log;
+  }
+  return log;
+}
+
+bool GroupCommitLog::append(const char* data, size_t length) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!running_) {
+    return false;
+  }
+  bool was_empty = buffer_.empty();
+  buffer_.insert(buffer_.end(), data, data + length);
+  appended_ += length;
+  size_t end = appended_;
+  if (was_empty || buffer_.size() >= GroupCommitWalWriter::FLUSH_SIZE) {
+    flush_cv_.notify_one();
+  }
+  durable_cv_.wait(lock, [&]() { return durable_ >= end; });
+  return true;
+}
+
+void GroupCommitLog::run() {
+  std::vector<char> batch;
+  batch.reserve(GroupCommitWalWriter::FLUSH_SIZE);
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    flush_cv_.wait(lock, [this]() { return !running_ || !buffer_.empty(); });
+    if (buffer_.empty()) {
+      break;
+    }
+    if (running_ && buffer_.size() < GroupCommitWalWriter::FLUSH_SIZE) {
+      // Lets the sessions committing at the same time join the batch.
+      flush_cv_.wait_for(
+          lock,
+          std::chrono::microseconds(GroupCommitWalWriter::FLUSH_INTERVAL_US),
+          [this]() {
+            return !running_ ||
+                   buffer_.size() >= GroupCommitWalWriter::FLUSH_SIZE;
+          });
+    }
+    batch.swap(buffer_);
+    size_t offset = durable_;
+    size_t end = appended_;
+    lock.unlock();
+
+    write(batch, offset);
+    batch.clear();
+
+    lock.lock();
+    durable_ = end;
+    durable_cv_.notify_all();
+  }
+}
+
+void GroupCommitLog::write(const std::vector<char>& batch, size_t offset) {
+  size_t expected_size = offset + batch.size();
+  if (expected_size > file_size_) {
+    size_t new_file_size = (expected_size / LocalWalWriter::TRUNC_SIZE + 1) *
+                           LocalWalWriter::TRUNC_SIZE;
+    if (ftruncate(fd_, new_file_size) != 0) {
+      LOG(FATAL) << "Failed to truncate wal file " << strerror(errno);
+    }
+    file_size_ = new_file_size;
+  }
+  size_t written = 0;
+  while (written < batch.size()) {
+    ssize_t ret = pwrite(fd_, batch.data() + written, batch.size() - written,
+                         offset + written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(FATAL) << "Failed to write wal file " << strerror(errno);
+    }
+    written += ret;
+  }
+  if (fdatasync(fd_) != 0) {
+    LOG(FATAL) << "Failed to fsync wal file " << strerror(errno);
+  }
+}
+
+std::unique_ptr<IWalWriter> GroupCommitWalWriter::Make() {
+  return std::unique_ptr<IWalWriter>(new GroupCommitWalWriter());
+}
+
+void GroupCommitWalWriter::open(const std::string& wal_uri, int thread_id) {
+  log_ = GroupCommitLog::Get(get_wal_uri_path(wal_uri));
+}
+
+void GroupCommitWalWriter::close() { log_.reset(); }
+
+bool GroupCommitWalWriter::append(const char* data, size_t length) {
+  if (log_ == nullptr) {
+    return false;
+  }
+  return log_->append(data, length);
+}
+
+const bool GroupCommitWalWriter::registered_ =
+    WalWriterFactory::RegisterWalWriter(
+        "group", static_cast<WalWriterFactory::wal_writer_initializer_t>(
+                     &GroupCommitWalWriter::Make));
+
+const bool GroupCommitWalWriter::parser_registered_ =
+    WalParserFactory::RegisterWalParser(
+        "group", static_cast<WalParserFactory::wal_parser_initializer_t>(
+                     &LocalWalParser::Make));
+
+}  // namespace gs
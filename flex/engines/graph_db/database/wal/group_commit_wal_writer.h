@@ -0,0 +1,62 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_DATABASE_WAL_GROUP_COMMIT_WAL_WRITER_H_
+#define ENGINES_GRAPH_DB_DATABASE_WAL_GROUP_COMMIT_WAL_WRITER_H_
+
+#include <memory>
+#include "flex/engines/graph_db/database/wal/wal.h"
+
+namespace gs {
+
+class GroupCommitLog;
+
+/**
+ * @brief A wal writer for uris of the "group" scheme, e.g.
+ * group://{GRAPH_DATA_DIR}/wal, that shares a single wal file among the
+ * sessions instead of one per thread.
+ *
+ * append() copies the record into a buffer shared by the writers of the
+ * directory and waits until a flusher thread made it durable: the flusher
+ * writes whatever was buffered since its last round, up to FLUSH_SIZE bytes
+ * or FLUSH_INTERVAL_US after the first pending record, and syncs it with one
+ * fdatasync for the whole batch. The file has the layout of the "file"
+ * writer's, so it is read back by LocalWalParser.
+ */
+class GroupCommitWalWriter : public IWalWriter {
+ public:
+  static std::unique_ptr<IWalWriter> Make();
+
+  static constexpr size_t FLUSH_SIZE = 4ul << 20;
+  static constexpr int64_t FLUSH_INTERVAL_US = 200;
+
+  GroupCommitWalWriter() = default;
+  ~GroupCommitWalWriter() { close(); }
+
+  void open(const std::string& wal_uri, int thread_id) override;
+  void close() override;
+  bool append(const char* data, size_t length) override;
+  std::string type() const override { return "group"; }
+
+ private:
+  std::shared_ptr<GroupCommitLog> log_;
+
+  static const bool registered_;
+  static const bool parser_registered_;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_DATABASE_WAL_GROUP_COMMIT_WAL_WRITER_H_
@@ -18,7 +18,9 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <filesystem>
+#include "flex/engines/graph_db/database/wal/lz_wal_writer.h"
 #include "flex/engines/graph_db/database/wal/wal.h"
+#include "flex/engines/graph_db/database/wal/wal_manifest.h"
 
 namespace gs {
 
@@ -33,8 +35,11 @@ void LocalWalParser::open(const std::string& wal_uri) {
   }
 
   std::vector<std::string> paths;
+  std::vector<char*> buffers;
   for (const auto& entry : std::filesystem::directory_iterator(wal_dir)) {
-    paths.push_back(entry.path().string());
+    if (WalManifest::IsSegment(entry.path().string())) {
+      paths.push_back(entry.path().string());
+    }
   }
   for (auto path : paths) {
     LOG(INFO) << "Start to ingest WALs from file: " << path;
@@ -51,11 +56,26 @@ void LocalWalParser::open(const std::string& wal_uri) {
     fds_.push_back(fd);
     mmapped_ptrs_.push_back(mmapped_buffer);
     mmapped_size_.push_back(file_size);
+
+    std::string suffix = LzWalWriter::FILE_SUFFIX;
+    if (path.size() >= suffix.size() &&
+        path.compare(path.size() - suffix.size(), suffix.size(), suffix) ==
+            0) {
+      std::vector<char> inflated;
+      LzWalWriter::Inflate(static_cast<const char*>(mmapped_buffer),
+                           file_size, inflated);
+      // Ends the records as the zeros after them do in the other files.
+      inflated.resize(inflated.size() + sizeof(WalHeader), 0);
+      inflated_.emplace_back(std::move(inflated));
+      buffers.push_back(inflated_.back().data());
+    } else {
+      buffers.push_back(static_cast<char*>(mmapped_buffer));
+    }
   }
 
   insert_wal_list_.resize(4096);
-  for (size_t i = 0; i < mmapped_ptrs_.size(); ++i) {
-    char* ptr = static_cast<char*>(mmapped_ptrs_[i]);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    char* ptr = buffers[i];
     while (true) {
       const WalHeader* header = reinterpret_cast<const WalHeader*>(ptr);
       ptr += sizeof(WalHeader);
@@ -92,6 +112,8 @@ void LocalWalParser::open(const std::string& wal_uri) {
 
 void LocalWalParser::close() {
   insert_wal_list_.clear();
+  update_wal_list_.clear();
+  inflated_.clear();
   size_t ptr_num = mmapped_ptrs_.size();
   for (size_t i = 0; i < ptr_num; ++i) {
     munmap(mmapped_ptrs_[i], mmapped_size_[i]);
@@ -41,6 +41,8 @@ class LocalWalParser : public IWalParser {
   std::vector<int> fds_;
   std::vector<void*> mmapped_ptrs_;
   std::vector<size_t> mmapped_size_;
+  // The records of the files written by LzWalWriter.
+  std::vector<std::vector<char>> inflated_;
   std::vector<WalContentUnit> insert_wal_list_;
   uint32_t last_ts_{0};
 
@@ -33,7 +33,7 @@ void LocalWalWriter::open(const std::string& wal_uri, int thread_id) {
   const int max_version = 65536;
   for (int version = 0; version != max_version; ++version) {
     std::string path = prefix + "/thread_" + std::to_string(thread_id) + "_" +
-                       std::to_string(version) + ".wal";
+                       std::to_string(version) + suffix_;
     if (std::filesystem::exists(path)) {
       continue;
     }
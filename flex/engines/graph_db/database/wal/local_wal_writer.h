@@ -35,6 +35,10 @@ class LocalWalWriter : public IWalWriter {
   bool append(const char* data, size_t length) override;
   std::string type() const override { return "file"; }
 
+ protected:
+  // Appended to the names of the files, thread_{thread_id}_{version}.
+  std::string suffix_{".wal"};
+
  private:
   int fd_;
   size_t file_size_;
@@ -0,0 +1,90 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/wal/lz_wal_writer.h"
+#include "flex/engines/graph_db/database/wal/local_wal_parser.h"
+#include "flex/utils/lz_codec.h"
+
+#include <cstring>
+
+namespace gs {
+
+std::unique_ptr<IWalWriter> LzWalWriter::Make() {
+  return std::unique_ptr<IWalWriter>(new LzWalWriter());
+}
+
+bool LzWalWriter::append(const char* data, size_t length) {
+  buffer_.resize(sizeof(LzWalFrameHeader) + lz_compress_bound(length));
+  char* body = buffer_.data() + sizeof(LzWalFrameHeader);
+  LzWalFrameHeader header;
+  header.raw_size = length;
+  size_t stored_size = lz_compress(data, length, body);
+  if (stored_size < length) {
+    header.compressed = 1;
+  } else {
+    header.compressed = 0;
+    stored_size = length;
+    memcpy(body, data, length);
+  }
+  header.stored_size = stored_size;
+  memcpy(buffer_.data(), &header, sizeof(header));
+  return LocalWalWriter::append(buffer_.data(),
+                                sizeof(LzWalFrameHeader) + stored_size);
+}
+
+void LzWalWriter::Inflate(const char* data, size_t size,
+                          std::vector<char>& out) {
+  size_t offset = 0;
+  while (offset + sizeof(LzWalFrameHeader) <= size) {
+    LzWalFrameHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    offset += sizeof(header);
+    if (header.raw_size == 0) {
+      break;
+    }
+    if (offset + header.stored_size > size) {
+      LOG(WARNING) << "Wal frame at " << offset << " is truncated";
+      break;
+    }
+    size_t out_size = out.size();
+    out.resize(out_size + header.raw_size);
+    if (header.compressed) {
+      if (!lz_decompress(data + offset, header.stored_size,
+                         out.data() + out_size, header.raw_size)) {
+        LOG(WARNING) << "Wal frame at " << offset << " is corrupted";
+        out.resize(out_size);
+        break;
+      }
+    } else if (header.stored_size == header.raw_size) {
+      memcpy(out.data() + out_size, data + offset, header.raw_size);
+    } else {
+      LOG(WARNING) << "Wal frame at " << offset << " is corrupted";
+      out.resize(out_size);
+      break;
+    }
+    offset += header.stored_size;
+  }
+}
+
+const bool LzWalWriter::registered_ = WalWriterFactory::RegisterWalWriter(
+    "lz", static_cast<WalWriterFactory::wal_writer_initializer_t>(
+              &LzWalWriter::Make));
+
+const bool LzWalWriter::parser_registered_ =
+    WalParserFactory::RegisterWalParser(
+        "lz", static_cast<WalParserFactory::wal_parser_initializer_t>(
+                  &LocalWalParser::Make));
+
+}  // namespace gs
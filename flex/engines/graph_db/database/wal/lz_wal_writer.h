@@ -0,0 +1,69 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_DATABASE_WAL_LZ_WAL_WRITER_H_
+#define ENGINES_GRAPH_DB_DATABASE_WAL_LZ_WAL_WRITER_H_
+
+#include <memory>
+#include <vector>
+#include "flex/engines/graph_db/database/wal/local_wal_writer.h"
+
+namespace gs {
+
+// Precedes each appended segment in the files of LzWalWriter. A zero
+// raw_size ends the file.
+struct LzWalFrameHeader {
+  uint32_t raw_size;
+  uint32_t compressed : 1;
+  uint32_t stored_size : 31;
+};
+
+/**
+ * @brief A wal writer for uris of the "lz" scheme, e.g.
+ * lz://{GRAPH_DATA_DIR}/wal, that compresses what each append writes with
+ * gs::lz_compress.
+ *
+ * The files have the layout of the "file" writer's, one per thread, with the
+ * suffix FILE_SUFFIX, and hold a sequence of frames: a LzWalFrameHeader
+ * followed by the compressed segment, or by the segment as is when it does
+ * not shrink. LocalWalParser inflates the files with this suffix before
+ * reading the wal records out of them.
+ */
+class LzWalWriter : public LocalWalWriter {
+ public:
+  static std::unique_ptr<IWalWriter> Make();
+
+  static constexpr const char* FILE_SUFFIX = ".lz.wal";
+
+  LzWalWriter() { suffix_ = FILE_SUFFIX; }
+  ~LzWalWriter() = default;
+
+  bool append(const char* data, size_t length) override;
+  std::string type() const override { return "lz"; }
+
+  // Appends the segments stored in the size bytes of data to out. A frame
+  // cut short by a crash ends the segments.
+  static void Inflate(const char* data, size_t size, std::vector<char>& out);
+
+ private:
+  std::vector<char> buffer_;
+
+  static const bool registered_;
+  static const bool parser_registered_;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_DATABASE_WAL_LZ_WAL_WRITER_H_
@@ -0,0 +1,337 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef USE_IO_URING
+
+#include "flex/engines/graph_db/database/wal/uring_wal_writer.h"
+#include "flex/engines/graph_db/database/wal/local_wal_parser.h"
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace gs {
+
+static constexpr unsigned ring_entries = 4;
+
+std::unique_ptr<IWalWriter> UringWalWriter::Make() {
+  return std::unique_ptr<IWalWriter>(new UringWalWriter());
+}
+
+// Allocates the blocks up to size, or only grows the file where the file
+// system does not support it.
+static void preallocate(int fd, size_t size) {
+  if (fallocate(fd, 0, 0, size) == 0) {
+    return;
+  }
+  if (ftruncate(fd, size) != 0) {
+    LOG(FATAL) << "Failed to truncate wal file " << strerror(errno);
+  }
+}
+
+void UringWalWriter::open(const std::string& wal_uri, int thread_id) {
+  auto prefix = get_wal_uri_path(wal_uri);
+  if (!std::filesystem::exists(prefix)) {
+    std::filesystem::create_directories(prefix);
+  }
+  const int max_version = 65536;
+  for (int version = 0; version != max_version; ++version) {
+    std::string path = prefix + "/thread_" + std::to_string(thread_id) + "_" +
+                       std::to_string(version) + ".wal";
+    if (std::filesystem::exists(path)) {
+      continue;
+    }
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if (fd_ == -1 && errno == EINVAL) {
+      LOG(WARNING) << "O_DIRECT is not supported for " << path
+                   << ", writing through the page cache";
+      fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    }
+    break;
+  }
+  if (fd_ == -1) {
+    LOG(FATAL) << "Failed to open wal file " << strerror(errno);
+  }
+  preallocate(fd_, TRUNC_SIZE);
+  file_size_ = TRUNC_SIZE;
+
+  void* buf = nullptr;
+  if (posix_memalign(&buf, BLOCK_SIZE, BUFFER_SIZE) != 0) {
+    LOG(FATAL) << "Failed to allocate wal buffer";
+  }
+  buf_ = static_cast<char*>(buf);
+  memset(buf_, 0, BUFFER_SIZE);
+  buf_used_ = 0;
+  buf_offset_ = 0;
+
+  if (!setupRing()) {
+    LOG(WARNING) << "io_uring is not available: " << strerror(errno)
+                 << ", writing wal with pwrite";
+  }
+}
+
+void UringWalWriter::close() {
+  if (fd_ != -1) {
+    closeRing();
+    if (::close(fd_) != 0) {
+      LOG(FATAL) << "Failed to close file" << strerror(errno);
+    }
+    fd_ = -1;
+    file_size_ = 0;
+    free(buf_);
+    buf_ = nullptr;
+    buf_used_ = 0;
+    buf_offset_ = 0;
+  }
+}
+
+#define unlikely(x) __builtin_expect(!!(x), 0)
+
+bool UringWalWriter::append(const char* data, size_t length) {
+  if (unlikely(fd_ == -1)) {
+    return false;
+  }
+  while (length > 0) {
+    size_t n = std::min(length, BUFFER_SIZE - buf_used_);
+    memcpy(buf_ + buf_used_, data, n);
+    buf_used_ += n;
+    data += n;
+    length -= n;
+    if (buf_used_ == BUFFER_SIZE) {
+      writeBuffer(BUFFER_SIZE, false);
+      buf_offset_ += BUFFER_SIZE;
+      buf_used_ = 0;
+    }
+  }
+
+  // Pads the last block with zeros, which end the records when parsing.
+  size_t aligned = (buf_used_ + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+  memset(buf_ + buf_used_, 0, aligned - buf_used_);
+  writeBuffer(aligned, true);
+
+  // Keeps the partial block, it is written again with the next records.
+  size_t full = buf_used_ / BLOCK_SIZE * BLOCK_SIZE;
+  if (full > 0) {
+    memmove(buf_, buf_ + full, buf_used_ - full);
+    buf_offset_ += full;
+    buf_used_ -= full;
+  }
+  return true;
+}
+
+#undef unlikely
+
+void UringWalWriter::writeBuffer(size_t length, bool sync) {
+  size_t expected_size = buf_offset_ + length;
+  if (expected_size > file_size_) {
+    size_t new_file_size = (expected_size / TRUNC_SIZE + 1) * TRUNC_SIZE;
+    preallocate(fd_, new_file_size);
+    file_size_ = new_file_size;
+  }
+
+  if (ring_fd_ == -1) {
+    size_t written = 0;
+    while (written < length) {
+      ssize_t ret = pwrite(fd_, buf_ + written, length - written,
+                           buf_offset_ + written);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        LOG(FATAL) << "Failed to write wal file " << strerror(errno);
+      }
+      written += ret;
+    }
+    if (sync && fdatasync(fd_) != 0) {
+      LOG(FATAL) << "Failed to fsync wal file " << strerror(errno);
+    }
+    return;
+  }
+
+  unsigned num = 0;
+  if (length > 0) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(buf_);
+    sqe->len = length;
+    sqe->off = buf_offset_;
+    sqe->buf_index = 0;
+    // The completion is expected to report the whole length written.
+    sqe->user_data = length;
+    if (sync) {
+      sqe->flags = IOSQE_IO_LINK;
+    }
+    ++num;
+  }
+  if (sync) {
+    io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd_;
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    sqe->user_data = 0;
+    ++num;
+  }
+  submitAndWait(num);
+}
+
+io_uring_sqe* UringWalWriter::getSqe() {
+  unsigned tail = *sq_tail_ + sq_pending_;
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sq_array_[index] = index;
+  ++sq_pending_;
+  return sqe;
+}
+
+void UringWalWriter::submitAndWait(unsigned num) {
+  __atomic_store_n(sq_tail_, *sq_tail_ + sq_pending_, __ATOMIC_RELEASE);
+  unsigned to_submit = sq_pending_;
+  sq_pending_ = 0;
+
+  unsigned completed = 0;
+  while (completed < num) {
+    int ret = syscall(__NR_io_uring_enter, ring_fd_, to_submit,
+                      num - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(FATAL) << "Failed to submit wal writes " << strerror(errno);
+    }
+    to_submit -= std::min<unsigned>(to_submit, ret);
+
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+      const io_uring_cqe* cqe = &cqes_[head & *cq_mask_];
+      if (cqe->res < 0) {
+        LOG(FATAL) << "Failed to write wal file " << strerror(-cqe->res);
+      }
+      if (static_cast<uint64_t>(cqe->res) != cqe->user_data) {
+        LOG(FATAL) << "Short write to wal file: " << cqe->res << " of "
+                   << cqe->user_data << " bytes";
+      }
+      ++head;
+      ++completed;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+}
+
+bool UringWalWriter::setupRing() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = syscall(__NR_io_uring_setup, ring_entries, &params);
+  if (ring_fd < 0) {
+    return false;
+  }
+  ring_fd_ = ring_fd;
+
+  sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_size_ = std::max(sq_size_, cq_size_);
+  }
+  sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (sq_ptr_ == MAP_FAILED) {
+    sq_ptr_ = nullptr;
+    closeRing();
+    return false;
+  }
+  if (single_mmap) {
+    cq_ptr_ = sq_ptr_;
+    cq_size_ = 0;
+  } else {
+    cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ptr_ == MAP_FAILED) {
+      cq_ptr_ = nullptr;
+      closeRing();
+      return false;
+    }
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    closeRing();
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(sq_ptr_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  char* cq = static_cast<char*>(cq_ptr_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  iovec iov;
+  iov.iov_base = buf_;
+  iov.iov_len = BUFFER_SIZE;
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS, &iov,
+              1) != 0) {
+    closeRing();
+    return false;
+  }
+  return true;
+}
+
+void UringWalWriter::closeRing() {
+  if (ring_fd_ == -1) {
+    return;
+  }
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+    munmap(cq_ptr_, cq_size_);
+  }
+  cq_ptr_ = nullptr;
+  if (sq_ptr_ != nullptr) {
+    munmap(sq_ptr_, sq_size_);
+    sq_ptr_ = nullptr;
+  }
+  // Closing the ring also unregisters the buffer.
+  ::close(ring_fd_);
+  ring_fd_ = -1;
+  sq_pending_ = 0;
+}
+
+const bool UringWalWriter::registered_ = WalWriterFactory::RegisterWalWriter(
+    "uring", static_cast<WalWriterFactory::wal_writer_initializer_t>(
+                 &UringWalWriter::Make));
+
+const bool UringWalWriter::parser_registered_ =
+    WalParserFactory::RegisterWalParser(
+        "uring", static_cast<WalParserFactory::wal_parser_initializer_t>(
+                     &LocalWalParser::Make));
+
+}  // namespace gs
+
+#endif  // USE_IO_URING
@@ -0,0 +1,105 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/wal/wal_manifest.h"
+
+#include <glog/logging.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace gs {
+
+static constexpr const char* TMP_SUFFIX = ".tmp";
+
+WalManifest::WalManifest(const std::string& wal_dir) : wal_dir_(wal_dir) {
+  load();
+}
+
+bool WalManifest::IsSegment(const std::string& file_name) {
+  std::string name = std::filesystem::path(file_name).filename().string();
+  return name != FILE_NAME && name != std::string(FILE_NAME) + TMP_SUFFIX;
+}
+
+void WalManifest::Seal(uint32_t ts) {
+  if (!std::filesystem::exists(wal_dir_)) {
+    return;
+  }
+  bool changed = false;
+  for (const auto& entry : std::filesystem::directory_iterator(wal_dir_)) {
+    std::string name = entry.path().filename().string();
+    if (IsSegment(name) && segments_.emplace(name, ts).second) {
+      changed = true;
+    }
+  }
+  if (changed) {
+    save();
+  }
+}
+
+size_t WalManifest::RemoveCovered(uint32_t ts) {
+  size_t removed = 0;
+  for (auto iter = segments_.begin(); iter != segments_.end();) {
+    if (iter->second > ts) {
+      ++iter;
+      continue;
+    }
+    std::error_code ec;
+    std::filesystem::remove(wal_dir_ + "/" + iter->first, ec);
+    if (ec) {
+      LOG(ERROR) << "Failed to remove wal segment " << iter->first << ": "
+                 << ec.message();
+      ++iter;
+      continue;
+    }
+    iter = segments_.erase(iter);
+    ++removed;
+  }
+  if (removed != 0) {
+    save();
+    LOG(INFO) << "Removed " << removed << " wal segments covered by " << ts;
+  }
+  return removed;
+}
+
+void WalManifest::load() {
+  std::ifstream fin(wal_dir_ + "/" + FILE_NAME);
+  std::string name;
+  uint32_t ts;
+  while (fin >> name >> ts) {
+    // Segments deleted before a crash kept the manifest from being saved.
+    if (std::filesystem::exists(wal_dir_ + "/" + name)) {
+      segments_.emplace(name, ts);
+    }
+  }
+}
+
+void WalManifest::save() const {
+  std::string path = wal_dir_ + "/" + FILE_NAME;
+  std::string tmp_path = path + TMP_SUFFIX;
+  {
+    std::ofstream fout(tmp_path, std::ios::trunc);
+    for (const auto& pair : segments_) {
+      fout << pair.first << " " << pair.second << "\n";
+    }
+    fout.flush();
+    if (!fout) {
+      LOG(FATAL) << "Failed to write wal manifest " << tmp_path;
+    }
+  }
+  std::filesystem::rename(tmp_path, path);
+}
+
+}  // namespace gs
@@ -0,0 +1,63 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_DATABASE_WAL_WAL_MANIFEST_H_
+#define ENGINES_GRAPH_DB_DATABASE_WAL_WAL_MANIFEST_H_
+
+#include <map>
+#include <string>
+
+namespace gs {
+
+/**
+ * @brief The sealed segments of a local wal directory, the files no writer
+ * appends to anymore, each with the latest timestamp it may hold.
+ *
+ * The manifest is the file MANIFEST of the directory, one line per segment
+ * with its file name and timestamp, replaced as a whole on every change. The
+ * segments written since the last seal are not listed.
+ */
+class WalManifest {
+ public:
+  static constexpr const char* FILE_NAME = "MANIFEST";
+
+  explicit WalManifest(const std::string& wal_dir);
+  ~WalManifest() = default;
+
+  // Whether the file is a segment, i.e. not the manifest.
+  static bool IsSegment(const std::string& file_name);
+
+  // Lists the segments of the directory not listed yet as ending at ts. Must
+  // be called while the writers are closed.
+  void Seal(uint32_t ts);
+
+  // Deletes the segments ending at ts or before. Returns the deleted number.
+  size_t RemoveCovered(uint32_t ts);
+
+  const std::map<std::string, uint32_t>& segments() const {
+    return segments_;
+  }
+
+ private:
+  void load();
+  void save() const;
+
+  std::string wal_dir_;
+  std::map<std::string, uint32_t> segments_;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_DATABASE_WAL_WAL_MANIFEST_H_
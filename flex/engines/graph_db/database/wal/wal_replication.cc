@@ -0,0 +1,397 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/database/wal/wal_replication.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace gs {
+
+static bool write_all(int fd, const void* data, size_t size) {
+  const char* ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t ret = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return true;
+}
+
+static bool read_all(int fd, void* data, size_t size) {
+  char* ptr = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t ret = ::recv(fd, ptr, size, 0);
+    if (ret < 0 && errno == EINTR) {
+      continue;
+    }
+    if (ret <= 0) {
+      return false;
+    }
+    ptr += ret;
+    size -= ret;
+  }
+  return true;
+}
+
+static int64_t steady_now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void set_no_delay(int fd) {
+  int flag = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+WalShipper::WalShipper(uint32_t port, size_t backlog_size,
+                       std::function<uint32_t()> read_ts)
+    : port_(port),
+      backlog_size_(backlog_size),
+      read_ts_(std::move(read_ts)),
+      listen_fd_(-1),
+      running_(false),
+      backlog_bytes_(0),
+      dropped_ts_(0),
+      follower_num_(0) {}
+
+WalShipper::~WalShipper() { Stop(); }
+
+void WalShipper::Start(uint32_t last_ts) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropped_ts_ = std::max(dropped_ts_, last_ts);
+  }
+  listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    LOG(FATAL) << "Failed to create replication socket " << strerror(errno);
+  }
+  int flag = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port_);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) !=
+          0 ||
+      ::listen(listen_fd_, 16) != 0) {
+    LOG(FATAL) << "Failed to listen on replication port " << port_ << ": "
+               << strerror(errno);
+  }
+  running_ = true;
+  acceptor_ = std::thread([this]() { acceptLoop(); });
+  LOG(INFO) << "Serving wals to followers on port " << port_ << " after "
+            << last_ts;
+}
+
+void WalShipper::Stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  ::shutdown(listen_fd_, SHUT_RDWR);
+  acceptor_.join();
+  ::close(listen_fd_);
+  listen_fd_ = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : follower_fds_) {
+      ::shutdown(fd, SHUT_RDWR);
+    }
+  }
+  cv_.notify_all();
+  for (auto& pair : servers_) {
+    pair.second.join();
+  }
+  servers_.clear();
+  std::lock_guard<std::mutex> lock(mutex_);
+  finished_servers_.clear();
+}
+
+void WalShipper::Publish(const char* data, size_t length) {
+  const WalHeader* header = reinterpret_cast<const WalHeader*>(data);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    backlog_[header->timestamp].assign(data, data + length);
+    backlog_bytes_ += length;
+    while (backlog_bytes_ > backlog_size_ && backlog_.size() > 1) {
+      auto iter = backlog_.begin();
+      backlog_bytes_ -= iter->second.size();
+      dropped_ts_ = iter->first;
+      backlog_.erase(iter);
+    }
+  }
+  cv_.notify_all();
+}
+
+void WalShipper::acceptLoop() {
+  while (running_) {
+    int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (running_ && errno != EINTR) {
+        LOG(ERROR) << "Failed to accept follower " << strerror(errno);
+      }
+      continue;
+    }
+    set_no_delay(fd);
+    reapServers();
+    std::lock_guard<std::mutex> lock(mutex_);
+    follower_fds_.push_back(fd);
+    std::thread thrd([this, fd]() { serve(fd); });
+    auto id = thrd.get_id();
+    servers_.emplace(id, std::move(thrd));
+  }
+}
+
+void WalShipper::reapServers() {
+  std::vector<std::thread::id> finished;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished.swap(finished_servers_);
+  }
+  for (auto id : finished) {
+    auto iter = servers_.find(id);
+    iter->second.join();
+    servers_.erase(iter);
+  }
+}
+
+bool WalShipper::collect(uint32_t from, uint32_t to, std::vector<char>& out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (from < dropped_ts_) {
+    return false;
+  }
+  for (auto iter = backlog_.upper_bound(from);
+       iter != backlog_.end() && iter->first <= to; ++iter) {
+    out.insert(out.end(), iter->second.begin(), iter->second.end());
+  }
+  return true;
+}
+
+void WalShipper::serve(int fd) {
+  uint32_t sent;
+  if (read_all(fd, &sent, sizeof(sent))) {
+    LOG(INFO) << "Follower connected after " << sent;
+    follower_num_.fetch_add(1);
+    std::vector<char> payload;
+    int64_t last_sent_us = 0;
+    while (running_) {
+      uint32_t primary_ts = read_ts_();
+      if (primary_ts < sent) {
+        LOG(ERROR) << "Follower is ahead of the primary: " << sent << " > "
+                   << primary_ts;
+        break;
+      }
+      payload.clear();
+      if (!collect(sent, primary_ts, payload)) {
+        LOG(ERROR) << "Wals after " << sent << " were dropped from the "
+                   << "backlog, the follower has to be seeded again";
+        break;
+      }
+      int64_t now_us = steady_now_us();
+      if (primary_ts != sent ||
+          now_us - last_sent_us >= HEARTBEAT_INTERVAL_MS * 1000) {
+        ReplicationFrameHeader header;
+        header.primary_ts = primary_ts;
+        header.size = payload.size();
+        if (!write_all(fd, &header, sizeof(header)) ||
+            !write_all(fd, payload.data(), payload.size())) {
+          break;
+        }
+        sent = primary_ts;
+        last_sent_us = now_us;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!running_) {
+        break;
+      }
+      if (backlog_.upper_bound(sent) == backlog_.end()) {
+        cv_.wait_for(lock, std::chrono::milliseconds(HEARTBEAT_INTERVAL_MS));
+      } else {
+        // The records after sent are appended, and visible once their
+        // transactions release their timestamps.
+        lock.unlock();
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(POLL_INTERVAL_US));
+      }
+    }
+    follower_num_.fetch_sub(1);
+    LOG(INFO) << "Follower disconnected at " << sent;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  follower_fds_.erase(
+      std::find(follower_fds_.begin(), follower_fds_.end(), fd));
+  ::close(fd);
+  // Joined once the next follower is accepted, or by Stop().
+  finished_servers_.push_back(std::this_thread::get_id());
+}
+
+WalReceiver::WalReceiver(const std::string& primary, uint32_t applied_ts,
+                         apply_func_t apply)
+    : apply_(std::move(apply)),
+      running_(false),
+      fd_(-1),
+      connected_(false),
+      primary_ts_(applied_ts),
+      applied_ts_(applied_ts),
+      behind_us_(0) {
+  auto pos = primary.rfind(':');
+  if (pos == std::string::npos) {
+    LOG(FATAL) << "Primary should be host:port, got " << primary;
+  }
+  host_ = primary.substr(0, pos);
+  port_ = primary.substr(pos + 1);
+}
+
+WalReceiver::~WalReceiver() { Stop(); }
+
+void WalReceiver::Start() {
+  running_ = true;
+  thread_ = std::thread([this]() { run(); });
+}
+
+void WalReceiver::Stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(fd_mutex_);
+    if (fd_ != -1) {
+      ::shutdown(fd_, SHUT_RDWR);
+    }
+  }
+  thread_.join();
+}
+
+ReplicationStatus WalReceiver::Status() const {
+  ReplicationStatus status;
+  status.role = "follower";
+  status.connection_num = connected_.load() ? 1 : 0;
+  int64_t behind_us = behind_us_.load();
+  status.applied_ts = applied_ts_.load();
+  status.primary_ts = std::max(primary_ts_.load(), status.applied_ts);
+  if (status.primary_ts > status.applied_ts && behind_us != 0) {
+    status.lag_seconds = (steady_now_us() - behind_us) / 1000000.0;
+  }
+  return status;
+}
+
+static int connect_to(const std::string& host, const std::string& port) {
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* result = nullptr;
+  if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0) {
+    return -1;
+  }
+  int fd = -1;
+  for (addrinfo* ai = result; ai != nullptr; ai = ai->ai_next) {
+    fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+      break;
+    }
+    ::close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  if (fd != -1) {
+    set_no_delay(fd);
+  }
+  return fd;
+}
+
+void WalReceiver::run() {
+  while (running_) {
+    int fd = connect_to(host_, port_);
+    if (fd != -1) {
+      {
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        fd_ = fd;
+      }
+      if (running_) {
+        receive(fd);
+      }
+      {
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        fd_ = -1;
+      }
+      ::close(fd);
+      connected_ = false;
+    }
+    if (running_) {
+      LOG(WARNING) << "Not connected to primary " << host_ << ":" << port_
+                   << ", retrying in " << RETRY_INTERVAL_MS << " ms";
+    }
+    for (int64_t waited = 0; running_ && waited < RETRY_INTERVAL_MS;
+         waited += 10) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+void WalReceiver::receive(int fd) {
+  uint32_t applied_ts = applied_ts_.load();
+  if (!write_all(fd, &applied_ts, sizeof(applied_ts))) {
+    return;
+  }
+  connected_ = true;
+  LOG(INFO) << "Connected to primary " << host_ << ":" << port_ << " after "
+            << applied_ts;
+  std::vector<char> payload;
+  while (running_) {
+    ReplicationFrameHeader header;
+    if (!read_all(fd, &header, sizeof(header))) {
+      return;
+    }
+    if (header.primary_ts < applied_ts_.load()) {
+      LOG(ERROR) << "Primary is behind the follower: " << header.primary_ts
+                 << " < " << applied_ts_.load();
+      return;
+    }
+    // Heartbeats of a caught up follower leave it caught up, the first frame
+    // of a new timestamp starts the lag, and frames until it is applied do
+    // not restart it.
+    if (header.primary_ts > applied_ts_.load() && behind_us_.load() == 0) {
+      behind_us_ = steady_now_us();
+    }
+    primary_ts_ = header.primary_ts;
+    payload.resize(header.size);
+    if (!read_all(fd, payload.data(), header.size)) {
+      return;
+    }
+    apply_(payload.data(), header.size, header.primary_ts);
+    applied_ts_ = header.primary_ts;
+    behind_us_ = 0;
+  }
+}
+
+}  // namespace gs
@@ -0,0 +1,201 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_GRAPH_DB_DATABASE_WAL_WAL_REPLICATION_H_
+#define ENGINES_GRAPH_DB_DATABASE_WAL_WAL_REPLICATION_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "flex/engines/graph_db/database/wal/wal.h"
+
+namespace gs {
+
+/**
+ * Replication streams the wal records of a primary to followers over TCP.
+ *
+ * A follower connects and sends the last timestamp it applied. The primary
+ * then sends frames, each a ReplicationFrameHeader followed by the wal
+ * records, header included, of the timestamps after those of the previous
+ * frame up to the frame's primary_ts, the read timestamp of the primary when
+ * the frame was built. Timestamps without a record were released without
+ * writing any. Frames without records are sent every HEARTBEAT_INTERVAL_MS
+ * to let followers measure their lag.
+ */
+struct ReplicationFrameHeader {
+  uint32_t primary_ts;
+  uint32_t size;
+};
+
+struct ReplicationStatus {
+  // "none", "primary" or "follower".
+  std::string role = "none";
+  // Primary: the connected followers. Follower: 1 if connected, 0 if not.
+  size_t connection_num = 0;
+  // Follower: the last timestamps known on the primary and applied here.
+  uint32_t primary_ts = 0;
+  uint32_t applied_ts = 0;
+  // Follower: seconds since it first knew of a timestamp of the primary it
+  // has not applied yet, 0 when applied_ts is primary_ts.
+  double lag_seconds = 0;
+};
+
+/**
+ * @brief Serves the wal records appended on the primary to followers.
+ *
+ * The records are kept in memory from the time the primary is opened, up to
+ * backlog_size bytes, beyond which the oldest are dropped. A follower that
+ * needs dropped records is disconnected, and must be seeded again from a copy
+ * of the primary's data directory.
+ */
+class WalShipper {
+ public:
+  static constexpr int64_t HEARTBEAT_INTERVAL_MS = 100;
+  // Between two checks of the read timestamp while records are appended but
+  // not yet committed.
+  static constexpr int64_t POLL_INTERVAL_US = 100;
+
+  WalShipper(uint32_t port, size_t backlog_size,
+             std::function<uint32_t()> read_ts);
+  ~WalShipper();
+
+  // Starts listening. Records up to last_ts are not in the backlog.
+  void Start(uint32_t last_ts);
+  void Stop();
+
+  // Called by the wal writers once a record is durable, before its timestamp
+  // is released.
+  void Publish(const char* data, size_t length);
+
+  size_t FollowerNum() const { return follower_num_.load(); }
+
+ private:
+  void acceptLoop();
+  void serve(int fd);
+  // Joins the threads of the followers which disconnected.
+  void reapServers();
+
+  // Appends the records of the timestamps in (from, to] to out. Returns false
+  // if some may have been dropped.
+  bool collect(uint32_t from, uint32_t to, std::vector<char>& out);
+
+  uint32_t port_;
+  size_t backlog_size_;
+  std::function<uint32_t()> read_ts_;
+
+  int listen_fd_;
+  std::atomic<bool> running_;
+  std::thread acceptor_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<uint32_t, std::vector<char>> backlog_;
+  size_t backlog_bytes_;
+  // The records up to this timestamp are not in the backlog.
+  uint32_t dropped_ts_;
+  std::vector<int> follower_fds_;
+  // The thread serving each follower, only touched by the acceptor and by
+  // Stop() once the acceptor is joined, and those which are done serving.
+  std::unordered_map<std::thread::id, std::thread> servers_;
+  std::vector<std::thread::id> finished_servers_;
+  std::atomic<size_t> follower_num_;
+};
+
+/**
+ * @brief Passes the records appended through another writer to a
+ * WalShipper.
+ */
+class ReplicatingWalWriter : public IWalWriter {
+ public:
+  ReplicatingWalWriter(std::unique_ptr<IWalWriter> writer, WalShipper& shipper)
+      : writer_(std::move(writer)), shipper_(shipper) {}
+  ~ReplicatingWalWriter() { close(); }
+
+  void open(const std::string& wal_uri, int thread_id) override {
+    writer_->open(wal_uri, thread_id);
+  }
+  void close() override { writer_->close(); }
+  bool append(const char* data, size_t length) override {
+    if (!writer_->append(data, length)) {
+      return false;
+    }
+    shipper_.Publish(data, length);
+    return true;
+  }
+  std::string type() const override { return writer_->type(); }
+
+ private:
+  std::unique_ptr<IWalWriter> writer_;
+  WalShipper& shipper_;
+};
+
+/**
+ * @brief Receives the frames of a primary on a follower, reconnecting every
+ * RETRY_INTERVAL_MS while the primary is unreachable.
+ *
+ * apply is called with the records of each frame, and must make every
+ * timestamp up to the primary timestamp of the frame visible, in order.
+ */
+class WalReceiver {
+ public:
+  using apply_func_t =
+      std::function<void(char* data, size_t size, uint32_t primary_ts)>;
+
+  static constexpr int64_t RETRY_INTERVAL_MS = 1000;
+
+  // primary is host:port.
+  WalReceiver(const std::string& primary, uint32_t applied_ts,
+              apply_func_t apply);
+  ~WalReceiver();
+
+  void Start();
+  void Stop();
+
+  ReplicationStatus Status() const;
+
+ private:
+  void run();
+  // Returns when the connection is lost or the receiver stopped.
+  void receive(int fd);
+
+  std::string host_;
+  std::string port_;
+  apply_func_t apply_;
+
+  std::atomic<bool> running_;
+  std::thread thread_;
+
+  std::mutex fd_mutex_;
+  int fd_;
+
+  std::atomic<bool> connected_;
+  std::atomic<uint32_t> primary_ts_;
+  std::atomic<uint32_t> applied_ts_;
+  // Steady clock time in microseconds when primary_ts_ went past
+  // applied_ts_, 0 when caught up.
+  std::atomic<int64_t> behind_us_;
+};
+
+}  // namespace gs
+
+#endif  // ENGINES_GRAPH_DB_DATABASE_WAL_WAL_REPLICATION_H_
@@ -0,0 +1,85 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/**
+ * @file batch.h
+ * @brief The batch extensions of flex to GRIN, which hand out the neighbors
+ * and the vertex properties of many elements per call instead of one.
+ * grin/predefine.h is to be included first.
+ */
+
+#ifndef GRIN_BATCH_H_
+#define GRIN_BATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+/**
+ * @brief Get the neighbors of an adjacent list as contiguous arrays.
+ * The i-th neighbor has internal id (*neighbors)[i] under the neighbor type
+ * of the edge type, and the edge was inserted at (*timestamps)[i]. The arrays
+ * are owned by the adjacent list and valid until it is destroyed.
+ * @param GRIN_GRAPH The graph
+ * @param GRIN_ADJACENT_LIST The adjacent list
+ * @param neighbors Set to the internal ids of the neighbors
+ * @param timestamps Set to the timestamps of the edges, skipped if NULL
+ * @return The number of neighbors
+ */
+size_t grin_get_neighbor_array_from_adjacent_list(
+    GRIN_GRAPH, GRIN_ADJACENT_LIST, const unsigned int** neighbors,
+    const unsigned int** timestamps);
+#endif
+
+#ifdef GRIN_WITH_VERTEX_PROPERTY
+/**
+ * @brief Get the values of a vertex property for a batch of vertices.
+ * The values are written to the caller buffer as an array of the property
+ * datatype, i.e. bool, int, unsigned int, long long int, unsigned long long
+ * int, float, double, or long long int milliseconds for Timestamp64. Other
+ * datatypes are not supported.
+ * @param GRIN_GRAPH The graph
+ * @param GRIN_VERTEX_PROPERTY The vertex property
+ * @param vs The vertices, all of the vertex type of the property
+ * @param num The number of vertices
+ * @param values The buffer of num values
+ * @return Whether the values are written
+ */
+bool grin_get_vertex_property_values_of_batch(GRIN_GRAPH, GRIN_VERTEX_PROPERTY,
+                                              const GRIN_VERTEX* vs,
+                                              size_t num, void* values);
+
+/**
+ * @brief Get the values of a vertex property for the vertices whose internal
+ * ids under the vertex type of the property are in [begin, end), laid out as
+ * by grin_get_vertex_property_values_of_batch.
+ * @param GRIN_GRAPH The graph
+ * @param GRIN_VERTEX_PROPERTY The vertex property
+ * @param begin The first internal id
+ * @param end The internal id past the last
+ * @param values The buffer of end - begin values
+ * @return Whether the values are written
+ */
+bool grin_get_vertex_property_values_of_range(GRIN_GRAPH, GRIN_VERTEX_PROPERTY,
+                                              long long int begin,
+                                              long long int end, void* values);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // GRIN_BATCH_H_
@@ -72,13 +72,13 @@ typedef enum {
 // #define GRIN_WITH_VERTEX_DATA
 #define GRIN_WITH_EDGE_DATA
 #define GRIN_ENABLE_VERTEX_LIST
-// #define GRIN_ENABLE_VERTEX_LIST_ARRAY
+#define GRIN_ENABLE_VERTEX_LIST_ARRAY
 #define GRIN_ENABLE_VERTEX_LIST_ITERATOR
 #define GRIN_ENABLE_EDGE_LIST
 // #define GRIN_ENABLE_EDGE_LIST_ARRAY
 #define GRIN_ENABLE_EDGE_LIST_ITERATOR
 #define GRIN_ENABLE_ADJACENT_LIST
-// #define GRIN_ENABLE_ADJACENT_LIST_ARRAY
+#define GRIN_ENABLE_ADJACENT_LIST_ARRAY
 #define GRIN_ENABLE_ADJACENT_LIST_ITERATOR
 
 // Partition
@@ -230,6 +230,8 @@ typedef struct GRIN_ADJACENT_LIST {
   GRIN_VERTEX v;
   GRIN_DIRECTION dir;
   GRIN_EDGE_TYPE edge_label;
+  // GRIN_ADJACENT_LIST_T*, the neighbors copied out for array access
+  void* nbrs;
 } GRIN_ADJACENT_LIST;
 #endif
 
@@ -35,5 +35,15 @@ typedef std::vector<unsigned> GRIN_EDGE_TYPE_LIST_T;
 typedef std::vector<unsigned> GRIN_EDGE_PROPERTY_LIST_T;
 #endif
 
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+// The neighbors of an adjacent list, copied out of the csr on the first
+// array access and freed with the adjacent list.
+typedef struct GRIN_ADJACENT_LIST_T {
+  bool loaded = false;
+  std::vector<GRIN_VID_T> neighbors;
+  std::vector<gs::timestamp_t> timestamps;
+} GRIN_ADJACENT_LIST_T;
+#endif
+
 GRIN_DATATYPE _get_data_type(const gs::PropertyType& type);
 void init_cache(GRIN_GRAPH_T* g);
\ No newline at end of file
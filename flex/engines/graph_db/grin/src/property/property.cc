@@ -12,6 +12,11 @@ limitations under the License.
 
 #include "grin/src/predefine.h"
 
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+
+#include "grin/batch.h"
 #include "grin/include/common/error.h"
 #include "grin/include/property/property.h"
 
@@ -383,6 +388,126 @@ const void* grin_get_vertex_property_value(GRIN_GRAPH g, GRIN_VERTEX v,
 }
 #endif
 
+#ifdef GRIN_WITH_VERTEX_PROPERTY
+static_assert(sizeof(gs::Date) == sizeof(long long int),
+              "Timestamp64 values are copied out of date columns as is");
+
+template <typename FUNC>
+static bool _visit_fixed_width_column(GRIN_DATATYPE type, const void* col,
+                                      const FUNC& func) {
+  switch (type) {
+  case GRIN_DATATYPE::Bool:
+    func(static_cast<const gs::BoolColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::Int32:
+    func(static_cast<const gs::IntColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::UInt32:
+    func(static_cast<const gs::UIntColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::Int64:
+    func(static_cast<const gs::LongColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::UInt64:
+    func(static_cast<const gs::ULongColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::Timestamp64:
+    func(static_cast<const gs::DateColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::Double:
+    func(static_cast<const gs::DoubleColumn*>(col));
+    return true;
+  case GRIN_DATATYPE::Float:
+    func(static_cast<const gs::FloatColumn*>(col));
+    return true;
+  default:
+    return false;
+  }
+}
+
+static const void* _get_vertex_property_column(GRIN_GRAPH_T* g,
+                                               GRIN_VERTEX_PROPERTY vp) {
+  auto plabel = (vp >> 8) & (0xff);
+  auto pid = vp & (0xff);
+  if (plabel >= g->g.vertex_label_num_ ||
+      pid >= g->vproperties[plabel].size()) {
+    return NULL;
+  }
+  return g->vproperties[plabel][pid];
+}
+
+bool grin_get_vertex_property_values_of_batch(GRIN_GRAPH g,
+                                              GRIN_VERTEX_PROPERTY vp,
+                                              const GRIN_VERTEX* vs,
+                                              size_t num, void* values) {
+  auto _g = static_cast<GRIN_GRAPH_T*>(g);
+  auto col = _get_vertex_property_column(_g, vp);
+  if (col == NULL) {
+    grin_error_code = INVALID_VALUE;
+    return false;
+  }
+  auto plabel = (vp >> 8) & (0xff);
+  auto vertex_num = _g->g.vertex_num(plabel);
+  for (size_t i = 0; i < num; ++i) {
+    if ((vs[i] >> 32) != plabel || (vs[i] & (0xffffffff)) >= vertex_num) {
+      grin_error_code = INVALID_VALUE;
+      return false;
+    }
+  }
+  auto type = (GRIN_DATATYPE)(vp >> 16);
+  bool supported = _visit_fixed_width_column(type, col, [&](auto _col) {
+    using T = std::decay_t<decltype(_col->get_view(0))>;
+    auto out = static_cast<T*>(values);
+    for (size_t i = 0; i < num; ++i) {
+      out[i] = _col->get_view(vs[i] & (0xffffffff));
+    }
+  });
+  if (!supported) {
+    grin_error_code = UNKNOWN_DATATYPE;
+  }
+  return supported;
+}
+
+bool grin_get_vertex_property_values_of_range(GRIN_GRAPH g,
+                                              GRIN_VERTEX_PROPERTY vp,
+                                              long long int begin,
+                                              long long int end,
+                                              void* values) {
+  auto _g = static_cast<GRIN_GRAPH_T*>(g);
+  auto col = _get_vertex_property_column(_g, vp);
+  auto plabel = (vp >> 8) & (0xff);
+  if (col == NULL || begin < 0 || begin > end ||
+      static_cast<size_t>(end) > _g->g.vertex_num(plabel)) {
+    grin_error_code = INVALID_VALUE;
+    return false;
+  }
+  auto type = (GRIN_DATATYPE)(vp >> 16);
+  bool supported = _visit_fixed_width_column(type, col, [&](auto _col) {
+    using T = std::decay_t<decltype(_col->get_view(0))>;
+    auto out = static_cast<T*>(values);
+    // The rows are split between the basic and the extra buffer, each
+    // copied as a whole.
+    size_t from = begin, to = end;
+    size_t basic_size = _col->basic_buffer_size();
+    if (from < basic_size) {
+      size_t basic_to = std::min(to, basic_size);
+      memcpy(out, _col->basic_buffer().data() + from,
+             (basic_to - from) * sizeof(T));
+      out += basic_to - from;
+      from = basic_to;
+    }
+    if (from < to) {
+      memcpy(out, _col->extra_buffer().data() + from - basic_size,
+             (to - from) * sizeof(T));
+    }
+  });
+  if (!supported) {
+    grin_error_code = UNKNOWN_DATATYPE;
+  }
+  return supported;
+}
+#endif
+
 #ifdef GRIN_WITH_EDGE_PROPERTY
 bool grin_equal_edge_property(GRIN_GRAPH g, GRIN_EDGE_PROPERTY ep1,
                               GRIN_EDGE_PROPERTY ep2) {
@@ -70,6 +70,9 @@ GRIN_ADJACENT_LIST grin_get_adjacent_list_by_edge_type(GRIN_GRAPH g,
   adj_list.v = v;
   adj_list.dir = dir;
   adj_list.edge_label = et;
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+  adj_list.nbrs = new GRIN_ADJACENT_LIST_T();
+#endif
   return adj_list;
 }
 #endif
\ No newline at end of file
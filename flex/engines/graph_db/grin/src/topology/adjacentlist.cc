@@ -15,20 +15,140 @@ limitations under the License.
 
 #include "grin/src/predefine.h"
 
+#include "grin/batch.h"
+#include "grin/include/common/error.h"
 #include "grin/include/topology/adjacentlist.h"
 
+#ifdef GRIN_ENABLE_ADJACENT_LIST
+static gs::CsrConstEdgeIterBase* _get_edge_iter(
+    GRIN_GRAPH_T* g, const GRIN_ADJACENT_LIST& adj_list) {
+  auto& v = adj_list.v;
+  auto label = adj_list.edge_label;
+  auto src_label = label >> 16;
+  auto dst_label = (label >> 8) & 0xff;
+  auto edge_label = label & 0xff;
+  auto v_label = v >> 32;
+  auto vid = v & (0xffffffff);
+  if (adj_list.dir == GRIN_DIRECTION::OUT) {
+    if (src_label == v_label) {
+      return g->g.get_outgoing_edges_raw(src_label, vid, dst_label,
+                                         edge_label);
+    }
+  } else {
+    if (dst_label == v_label) {
+      return g->g.get_incoming_edges_raw(dst_label, vid, src_label,
+                                         edge_label);
+    }
+  }
+  return nullptr;
+}
+
+static GRIN_VERTEX _get_neighbor(const GRIN_ADJACENT_LIST& adj_list,
+                                 GRIN_VID_T vid) {
+  auto label = adj_list.edge_label;
+  if (adj_list.dir == GRIN_DIRECTION::OUT) {
+    label = (label >> 8) & 0xff;
+  } else {
+    label = label >> 16;
+  }
+  return ((label * 1ull) << 32) + vid;
+}
+#endif
+
 #if defined(GRIN_ENABLE_ADJACENT_LIST) && !defined(GRIN_ENABLE_EDGE_PROPERTY)
 GRIN_ADJACENT_LIST grin_get_adjacent_list(GRIN_GRAPH g, GRIN_DIRECTION dir,
                                           GRIN_VERTEX v) {
   GRIN_ADJACENT_LIST alt;
   alt.dir = dir;
   alt.v = v;
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+  alt.nbrs = new GRIN_ADJACENT_LIST_T();
+#endif
   return alt;
 }
 #endif
 
 #ifdef GRIN_ENABLE_ADJACENT_LIST
-void grin_destroy_adjacent_list(GRIN_GRAPH g, GRIN_ADJACENT_LIST adj_list) {}
+void grin_destroy_adjacent_list(GRIN_GRAPH g, GRIN_ADJACENT_LIST adj_list) {
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+  delete static_cast<GRIN_ADJACENT_LIST_T*>(adj_list.nbrs);
+#endif
+}
+#endif
+
+#ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
+static const GRIN_ADJACENT_LIST_T* _load_adjacent_list(
+    GRIN_GRAPH g, const GRIN_ADJACENT_LIST& adj_list) {
+  auto nbrs = static_cast<GRIN_ADJACENT_LIST_T*>(adj_list.nbrs);
+  if (nbrs->loaded) {
+    return nbrs;
+  }
+  nbrs->loaded = true;
+  auto edge_iter = _get_edge_iter(static_cast<GRIN_GRAPH_T*>(g), adj_list);
+  if (edge_iter == nullptr) {
+    return nbrs;
+  }
+  nbrs->neighbors.reserve(edge_iter->size());
+  nbrs->timestamps.reserve(edge_iter->size());
+  for (; edge_iter->is_valid(); edge_iter->next()) {
+    nbrs->neighbors.emplace_back(edge_iter->get_neighbor());
+    nbrs->timestamps.emplace_back(edge_iter->get_timestamp());
+  }
+  delete edge_iter;
+  return nbrs;
+}
+
+size_t grin_get_adjacent_list_size(GRIN_GRAPH g, GRIN_ADJACENT_LIST adj_list) {
+  return _load_adjacent_list(g, adj_list)->neighbors.size();
+}
+
+GRIN_VERTEX grin_get_neighbor_from_adjacent_list(GRIN_GRAPH g,
+                                                 GRIN_ADJACENT_LIST adj_list,
+                                                 size_t idx) {
+  auto nbrs = _load_adjacent_list(g, adj_list);
+  if (idx >= nbrs->neighbors.size()) {
+    grin_error_code = INVALID_VALUE;
+    return GRIN_NULL_VERTEX;
+  }
+  return _get_neighbor(adj_list, nbrs->neighbors[idx]);
+}
+
+GRIN_EDGE grin_get_edge_from_adjacent_list(GRIN_GRAPH g,
+                                           GRIN_ADJACENT_LIST adj_list,
+                                           size_t idx) {
+  auto nbrs = _load_adjacent_list(g, adj_list);
+  if (idx >= nbrs->neighbors.size()) {
+    grin_error_code = INVALID_VALUE;
+    return GRIN_NULL_EDGE;
+  }
+  auto edge_iter = _get_edge_iter(static_cast<GRIN_GRAPH_T*>(g), adj_list);
+  *edge_iter += idx;
+  GRIN_EDGE_T* edge = new GRIN_EDGE_T();
+  auto nbr = _get_neighbor(adj_list, edge_iter->get_neighbor());
+  if (adj_list.dir == GRIN_DIRECTION::IN) {
+    edge->src = nbr;
+    edge->dst = adj_list.v;
+  } else {
+    edge->src = adj_list.v;
+    edge->dst = nbr;
+  }
+  edge->dir = adj_list.dir;
+  edge->data = edge_iter->get_data();
+  edge->label = adj_list.edge_label & 0xff;
+  delete edge_iter;
+  return edge;
+}
+
+size_t grin_get_neighbor_array_from_adjacent_list(
+    GRIN_GRAPH g, GRIN_ADJACENT_LIST adj_list, const unsigned int** neighbors,
+    const unsigned int** timestamps) {
+  auto nbrs = _load_adjacent_list(g, adj_list);
+  *neighbors = nbrs->neighbors.data();
+  if (timestamps != NULL) {
+    *timestamps = nbrs->timestamps.data();
+  }
+  return nbrs->neighbors.size();
+}
 #endif
 
 #ifdef GRIN_ENABLE_ADJACENT_LIST_ITERATOR
@@ -36,30 +156,8 @@ GRIN_ADJACENT_LIST_ITERATOR grin_get_adjacent_list_begin(
     GRIN_GRAPH g, GRIN_ADJACENT_LIST adj_list) {
   auto _g = static_cast<GRIN_GRAPH_T*>(g);
   GRIN_ADJACENT_LIST_ITERATOR iter;
-  auto& v = adj_list.v;
   iter.adj_list = adj_list;
-  auto label = adj_list.edge_label;
-  auto src_label = label >> 16;
-  auto dst_label = (label >> 8) & 0xff;
-  auto edge_label = label & 0xff;
-  auto v_label = v >> 32;
-  auto vid = v & (0xffffffff);
-  if (adj_list.dir == GRIN_DIRECTION::OUT) {
-    if (src_label == v_label) {
-      iter.edge_iter =
-          _g->g.get_outgoing_edges_raw(src_label, vid, dst_label, edge_label);
-
-    } else {
-      iter.edge_iter = nullptr;
-    }
-  } else {
-    if (dst_label == v_label) {
-      iter.edge_iter =
-          _g->g.get_incoming_edges_raw(dst_label, vid, src_label, edge_label);
-    } else {
-      iter.edge_iter = nullptr;
-    }
-  }
+  iter.edge_iter = _get_edge_iter(_g, adj_list);
   return iter;
 }
 
@@ -88,15 +186,7 @@ bool grin_is_adjacent_list_end(GRIN_GRAPH g, GRIN_ADJACENT_LIST_ITERATOR iter) {
 GRIN_VERTEX grin_get_neighbor_from_adjacent_list_iter(
     GRIN_GRAPH g, GRIN_ADJACENT_LIST_ITERATOR iter) {
   auto edge_iter = static_cast<gs::CsrConstEdgeIterBase*>(iter.edge_iter);
-  auto vid = edge_iter->get_neighbor();
-  auto label = iter.adj_list.edge_label;
-
-  if (iter.adj_list.dir == GRIN_DIRECTION::OUT) {
-    label = (label >> 8) & 0xff;
-  } else {
-    label = label >> 16;
-  }
-  return ((label * 1ull) << 32) + vid;
+  return _get_neighbor(iter.adj_list, edge_iter->get_neighbor());
 }
 
 GRIN_EDGE grin_get_edge_from_adjacent_list_iter(
@@ -25,6 +25,20 @@ GRIN_VERTEX_LIST grin_get_vertex_list(GRIN_GRAPH g) {}
 void grin_destroy_vertex_list(GRIN_GRAPH g, GRIN_VERTEX_LIST vl) {}
 #endif
 
+#ifdef GRIN_ENABLE_VERTEX_LIST_ARRAY
+size_t grin_get_vertex_list_size(GRIN_GRAPH g, GRIN_VERTEX_LIST vl) {
+  return vl.vertex_num;
+}
+
+GRIN_VERTEX grin_get_vertex_from_list(GRIN_GRAPH g, GRIN_VERTEX_LIST vl,
+                                      size_t idx) {
+  if (idx >= vl.vertex_num) {
+    return GRIN_NULL_VERTEX;
+  }
+  return ((vl.label * 1ull) << 32) + idx;
+}
+#endif
+
 #ifdef GRIN_ENABLE_VERTEX_LIST_ITERATOR
 GRIN_VERTEX_LIST_ITERATOR grin_get_vertex_list_begin(GRIN_GRAPH g,
                                                      GRIN_VERTEX_LIST vl) {
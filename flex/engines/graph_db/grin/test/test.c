@@ -1,11 +1,14 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
 
 #include "grin/predefine.h"
 
+#include "grin/batch.h"
+
 #include "grin/include/common/error.h"
 #include "grin/include/index/internal_id.h"
 #include "grin/include/index/label.h"
@@ -924,6 +927,15 @@ void test_topology_adjacent_list(const char* uri_str, GRIN_DIRECTION dir) {
   }
 #ifdef GRIN_ENABLE_ADJACENT_LIST_ARRAY
   assert(acnt == grin_get_adjacent_list_size(g, al));
+  const unsigned int* nbrs = NULL;
+  const unsigned int* nbr_ts = NULL;
+  assert(acnt ==
+         grin_get_neighbor_array_from_adjacent_list(g, al, &nbrs, &nbr_ts));
+  for (size_t i = 0; i < acnt; ++i) {
+    GRIN_VERTEX u = grin_get_neighbor_from_adjacent_list(g, al, i);
+    assert((u & 0xffffffff) == nbrs[i]);
+    grin_destroy_vertex(g, u);
+  }
 #endif
   grin_destroy_adjacent_list_iter(g, ali);
 #ifdef GRIN_WITH_EDGE_PROPERTY
@@ -1043,6 +1055,23 @@ void test_vertex_property_value(const char* uri_str) {
   double elapsedTime = (t2.tv_sec - t1.tv_sec) * 1000.0;
   elapsedTime += (t2.tv_usec - t1.tv_usec) / 1000.0;
   printf("%f ms.\n", elapsedTime);
+
+  long long int vnum = grin_get_vertex_internal_id_upper_bound_by_type(g, vt);
+  int* ages = (int*) malloc(sizeof(int) * vnum);
+  GRIN_VERTEX* vs = (GRIN_VERTEX*) malloc(sizeof(GRIN_VERTEX) * vnum);
+  assert(grin_get_vertex_property_values_of_range(g, vp, 0, vnum, ages));
+  for (long long int i = 0; i < vnum; ++i) {
+    GRIN_VERTEX u = grin_get_vertex_by_internal_id_by_type(g, vt, i);
+    assert(ages[i] == grin_get_vertex_property_value_of_int32(g, u, vp));
+    vs[vnum - 1 - i] = u;
+  }
+  assert(grin_get_vertex_property_values_of_batch(g, vp, vs, vnum, ages));
+  for (long long int i = 0; i < vnum; ++i) {
+    assert(ages[i] == grin_get_vertex_property_value_of_int32(g, vs[i], vp));
+    grin_destroy_vertex(g, vs[i]);
+  }
+  free(vs);
+  free(ages);
   grin_destroy_vertex(g, v);
   grin_destroy_vertex_property(g, vp);
   grin_destroy_vertex_type(g, vt);
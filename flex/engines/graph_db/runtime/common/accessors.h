@@ -29,6 +29,147 @@ namespace gs {
 
 namespace runtime {
 
+enum class CompareOp { kLT, kLE, kGT, kGE, kEQ, kNE };
+
+// The value types compare_rows has kernels for.
+template <typename T>
+struct BatchComparable {
+  static constexpr bool value =
+      (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) ||
+      std::is_same<T, Day>::value || std::is_same<T, Date>::value ||
+      std::is_same<T, std::string_view>::value;
+};
+
+// Keeps the rows of sel whose value, read through get, is kept by pred. Every
+// row is written and only the kept ones advance the cursor, so the loop has
+// no branch on the predicate.
+template <typename GET_T, typename PRED_T>
+inline void compact_rows(std::vector<size_t>& sel, const GET_T& get,
+                         const PRED_T& pred) {
+  size_t num = 0;
+  size_t* rows = sel.data();
+  size_t row_num = sel.size();
+  for (size_t k = 0; k < row_num; ++k) {
+    size_t idx = rows[k];
+    rows[num] = idx;
+    num += pred(get(idx)) ? 1 : 0;
+  }
+  sel.resize(num);
+}
+
+// Keeps the rows of sel whose value compares to val as op does.
+template <typename T, typename GET_T>
+inline void compare_rows(CompareOp op, const T& val, const GET_T& get,
+                         std::vector<size_t>& sel) {
+  switch (op) {
+  case CompareOp::kLT:
+    compact_rows(sel, get, [&val](const T& x) { return x < val; });
+    break;
+  case CompareOp::kLE:
+    compact_rows(sel, get, [&val](const T& x) { return !(val < x); });
+    break;
+  case CompareOp::kGT:
+    compact_rows(sel, get, [&val](const T& x) { return val < x; });
+    break;
+  case CompareOp::kGE:
+    compact_rows(sel, get, [&val](const T& x) { return !(x < val); });
+    break;
+  case CompareOp::kEQ:
+    compact_rows(sel, get, [&val](const T& x) { return x == val; });
+    break;
+  case CompareOp::kNE:
+    compact_rows(sel, get, [&val](const T& x) { return !(x == val); });
+    break;
+  }
+}
+
+// The value types compare_dense_rows has kernels for, those whose
+// comparisons compile to vector instructions.
+template <typename T>
+struct DenseComparable {
+  static constexpr bool value =
+      (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) ||
+      std::is_same<T, Day>::value || std::is_same<T, Date>::value;
+};
+
+// Whether sel, ascending and within [0, row_num), holds every row.
+inline bool is_all_rows(const std::vector<size_t>& sel, size_t row_num) {
+  return sel.size() == row_num;
+}
+
+// Sets sel to the rows of [0, row_num) whose value in data is kept by pred
+// and, unless validity is null, whose bit in it is set. pred is applied to a
+// block of 64 rows at a time into flags, a loop without branches or
+// indirection that the compiler vectorizes; the flags are packed into a mask
+// of the block, masked by its validity word, and the rows turned into row
+// numbers a set bit at a time.
+template <typename T, typename PRED_T>
+inline void select_dense_rows(const T* data, const uint64_t* validity,
+                              size_t row_num, const PRED_T& pred,
+                              std::vector<size_t>& sel) {
+  constexpr size_t kBlock = ValidityBitmap::kWordBits;
+  sel.resize(row_num);
+  size_t* rows = sel.data();
+  size_t num = 0;
+  for (size_t base = 0; base < row_num; base += kBlock) {
+    size_t block = std::min(kBlock, row_num - base);
+    const T* values = data + base;
+    uint8_t flags[kBlock];
+    for (size_t j = 0; j < block; ++j) {
+      flags[j] = pred(values[j]) ? 1 : 0;
+    }
+    uint64_t mask = 0;
+    for (size_t j = 0; j < block; ++j) {
+      mask |= static_cast<uint64_t>(flags[j]) << j;
+    }
+    if (validity != nullptr) {
+      mask &= validity[base / kBlock];
+    }
+    while (mask != 0) {
+      rows[num++] = base + __builtin_ctzll(mask);
+      mask &= mask - 1;
+    }
+  }
+  sel.resize(num);
+}
+
+// Sets sel to the rows of [0, row_num) whose value in data compares to val
+// as op does and which are valid, as select_dense_rows.
+template <typename T>
+inline void compare_dense_rows(CompareOp op, const T& val, const T* data,
+                               const uint64_t* validity, size_t row_num,
+                               std::vector<size_t>& sel) {
+  switch (op) {
+  case CompareOp::kLT:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return x < val; }, sel);
+    break;
+  case CompareOp::kLE:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return !(val < x); },
+        sel);
+    break;
+  case CompareOp::kGT:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return val < x; }, sel);
+    break;
+  case CompareOp::kGE:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return !(x < val); },
+        sel);
+    break;
+  case CompareOp::kEQ:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return x == val; }, sel);
+    break;
+  case CompareOp::kNE:
+    select_dense_rows(
+        data, validity, row_num, [val](const T& x) { return !(x == val); },
+        sel);
+    break;
+  }
+}
+
 class IAccessor {
  public:
   virtual ~IAccessor() = default;
@@ -54,6 +195,15 @@ class IAccessor {
 
   virtual bool is_optional() const { return false; }
 
+  // Keeps the rows of sel whose value compares to val as op does, in one
+  // typed loop over the column behind the accessor; null values compare to
+  // nothing. Returns false, leaving sel as it was, if the accessor has no such
+  // kernel for val.
+  virtual bool filter_path(CompareOp op, const RTAny& val,
+                           std::vector<size_t>& sel) const {
+    return false;
+  }
+
   virtual std::string name() const { return "unknown"; }
 
   virtual std::shared_ptr<IContextColumnBuilder> builder() const {
@@ -163,6 +313,36 @@ class VertexPropertyPathAccessor : public IAccessor {
     }
   }
 
+  bool filter_path(CompareOp op, const RTAny& val,
+                   std::vector<size_t>& sel) const override {
+    if constexpr (BatchComparable<T>::value) {
+      if (is_optional_ || val.type() != TypedConverter<T>::type()) {
+        return false;
+      }
+      T typed_val = TypedConverter<T>::to_typed(val);
+      if (vertex_col_.vertex_column_type() == VertexColumnType::kSingle) {
+        const auto& sl_col = dynamic_cast<const SLVertexColumn&>(vertex_col_);
+        const vid_t* vids = sl_col.vertices().data();
+        const auto& col = property_columns_[sl_col.label()];
+        compare_rows(
+            op, typed_val,
+            [vids, &col](size_t idx) -> T { return col.get_view(vids[idx]); },
+            sel);
+      } else {
+        compare_rows(
+            op, typed_val,
+            [this](size_t idx) -> T {
+              const auto& v = vertex_col_.get_vertex(idx);
+              return property_columns_[v.label_].get_view(v.vid_);
+            },
+            sel);
+      }
+      return true;
+    } else {
+      return false;
+    }
+  }
+
  private:
   bool is_optional_;
   const IVertexColumn& vertex_col_;
@@ -230,6 +410,57 @@ class ContextValueAccessor : public IAccessor {
     return eval_path(idx);
   }
 
+  bool filter_path(CompareOp op, const RTAny& val,
+                   std::vector<size_t>& sel) const override {
+    if constexpr (BatchComparable<T>::value) {
+      if (val.type() != TypedConverter<T>::type()) {
+        return false;
+      }
+      T typed_val = TypedConverter<T>::to_typed(val);
+      if (col_.is_optional()) {
+        auto opt_col = dynamic_cast<const OptionalValueColumn<T>*>(&col_);
+        if (opt_col == nullptr) {
+          return false;
+        }
+        const T* data = opt_col->data().data();
+        const auto& validity = opt_col->validity();
+        if constexpr (DenseComparable<T>::value) {
+          if (is_all_rows(sel, opt_col->size())) {
+            compare_dense_rows(op, typed_val, data, validity.words(),
+                               opt_col->size(), sel);
+            return true;
+          }
+        }
+        compact_rows(
+            sel, [](size_t idx) { return idx; },
+            [&validity](size_t idx) { return validity.get(idx); });
+        compare_rows(
+            op, typed_val, [data](size_t idx) -> T { return data[idx]; }, sel);
+        return true;
+      }
+      auto value_col = dynamic_cast<const ValueColumn<T>*>(&col_);
+      if (value_col != nullptr) {
+        const T* data = value_col->data().data();
+        if constexpr (DenseComparable<T>::value) {
+          if (is_all_rows(sel, value_col->size())) {
+            compare_dense_rows(op, typed_val, data, nullptr,
+                               value_col->size(), sel);
+            return true;
+          }
+        }
+        compare_rows(
+            op, typed_val, [data](size_t idx) -> T { return data[idx]; }, sel);
+      } else {
+        compare_rows(
+            op, typed_val,
+            [this](size_t idx) -> T { return col_.get_value(idx); }, sel);
+      }
+      return true;
+    } else {
+      return false;
+    }
+  }
+
  private:
   const IValueColumn<elem_t>& col_;
 };
@@ -392,6 +623,36 @@ class EdgePropertyPathAccessor : public IAccessor {
   const IEdgeColumn& col_;
 };
 
+// Reads a single property out of multi-property edges. The TypedColumn
+// backing each label triplet is resolved on first use, after which a field is
+// read straight from its column instead of boxing it through Any.
+template <typename T>
+class RecordViewFieldReader {
+ public:
+  void resize(size_t slot_num) { cache_.resize(slot_num); }
+
+  inline T get(size_t slot, size_t col_id, const RecordView& view) const {
+    auto& entry = cache_[slot];
+    if (entry.table != view.table) {
+      entry.table = view.table;
+      entry.column = view.table->template get_typed_column<T>(col_id);
+    }
+    if (entry.column != nullptr) {
+      return entry.column->get_view(view.offset);
+    }
+    T ret;
+    ConvertAny<T>::to(view[col_id], ret);
+    return ret;
+  }
+
+ private:
+  struct Entry {
+    const Table* table = nullptr;
+    const TypedColumn<T>* column = nullptr;
+  };
+  mutable std::vector<Entry> cache_;
+};
+
 template <typename GraphInterface, typename T>
 class MultiPropsEdgePropertyPathAccessor : public IAccessor {
  public:
@@ -406,6 +667,7 @@ class MultiPropsEdgePropertyPathAccessor : public IAccessor {
     prop_index_.resize(
         2 * vertex_label_num_ * vertex_label_num_ * edge_label_num_,
         std::numeric_limits<size_t>::max());
+    reader_.resize(prop_index_.size());
     for (auto& label : labels) {
       size_t idx = label.src_label * vertex_label_num_ * edge_label_num_ +
                    label.dst_label * edge_label_num_ + label.edge_label;
@@ -448,19 +710,19 @@ class MultiPropsEdgePropertyPathAccessor : public IAccessor {
     } else {
       auto rv = val.as<RecordView>();
       assert(id != std::numeric_limits<size_t>::max());
-      auto tmp = rv[id];
-      elem_t ret;
-      ConvertAny<T>::to(tmp, ret);
-      return ret;
+      return reader_.get(get_slot(e.label_triplet_), id, rv);
     }
   }
 
   bool is_optional() const override { return col_.is_optional(); }
 
+  size_t get_slot(const LabelTriplet& label) const {
+    return label.src_label * vertex_label_num_ * edge_label_num_ +
+           label.dst_label * edge_label_num_ + label.edge_label;
+  }
+
   size_t get_index(const LabelTriplet& label) const {
-    size_t idx = label.src_label * vertex_label_num_ * edge_label_num_ +
-                 label.dst_label * edge_label_num_ + label.edge_label;
-    return prop_index_[idx];
+    return prop_index_[get_slot(label)];
   }
 
   RTAny eval_path(size_t idx, int) const override {
@@ -473,6 +735,7 @@ class MultiPropsEdgePropertyPathAccessor : public IAccessor {
  private:
   const IEdgeColumn& col_;
   std::vector<size_t> prop_index_;
+  RecordViewFieldReader<T> reader_;
   size_t vertex_label_num_;
   size_t edge_label_num_;
 };
@@ -533,6 +796,7 @@ class MultiPropsEdgePropertyEdgeAccessor : public IAccessor {
     vertex_label_num_ = graph.schema().vertex_label_num();
     indexs.resize(2 * vertex_label_num_ * vertex_label_num_ * edge_label_num_,
                   std::numeric_limits<size_t>::max());
+    reader_.resize(indexs.size());
     for (label_t src_label = 0; src_label < vertex_label_num_; ++src_label) {
       auto src = graph.schema().get_vertex_label_name(src_label);
       for (label_t dst_label = 0; dst_label < vertex_label_num_; ++dst_label) {
@@ -568,8 +832,7 @@ class MultiPropsEdgePropertyEdgeAccessor : public IAccessor {
     } else {
       auto id = get_index(label);
       assert(id != std::numeric_limits<size_t>::max());
-      auto view = data.AsRecordView();
-      ConvertAny<T>::to(view[id], ret);
+      ret = reader_.get(get_slot(label), id, data.AsRecordView());
     }
     return ret;
   }
@@ -584,14 +847,18 @@ class MultiPropsEdgePropertyEdgeAccessor : public IAccessor {
     return RTAny(typed_eval_edge(label, src, dst, data, idx));
   }
 
+  size_t get_slot(const LabelTriplet& label) const {
+    return label.src_label * vertex_label_num_ * edge_label_num_ +
+           label.dst_label * edge_label_num_ + label.edge_label;
+  }
+
   size_t get_index(const LabelTriplet& label) const {
-    size_t idx = label.src_label * vertex_label_num_ * edge_label_num_ +
-                 label.dst_label * edge_label_num_ + label.edge_label;
-    return indexs[idx];
+    return indexs[get_slot(label)];
   }
 
  private:
   std::vector<size_t> indexs;
+  RecordViewFieldReader<T> reader_;
   size_t vertex_label_num_;
   size_t edge_label_num_;
 };
@@ -688,6 +688,7 @@ class SDSLEdgeColumnBuilder : public IContextColumnBuilder {
     push_back_opt(e.src_, e.dst_, e.prop_);
   }
   inline void push_back_opt(vid_t src, vid_t dst, const EdgeData& data) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst);
 
     size_t len = edges_.size();
@@ -695,11 +696,13 @@ class SDSLEdgeColumnBuilder : public IContextColumnBuilder {
     set_edge_data(prop_col_.get(), len - 1, data);
   }
   inline void push_back_endpoints(vid_t src, vid_t dst) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst);
   }
 
   inline void push_back_null() {
     assert(is_optional_);
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(std::numeric_limits<vid_t>::max(),
                         std::numeric_limits<vid_t>::max());
   }
@@ -744,6 +747,7 @@ class SDSLEdgeColumnBuilderBeta : public IContextColumnBuilder {
   }
   inline void push_back_opt(vid_t src, vid_t dst, const T& data) {
     size_t len = edges_.size();
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst);
     prop_col_ptr_->set(len, data);
   }
@@ -789,20 +793,24 @@ class BDSLEdgeColumnBuilder : public IContextColumnBuilder {
   }
   inline void push_back_opt(vid_t src, vid_t dst, const EdgeData& data,
                             Direction dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst, dir == Direction::kOut);
     size_t len = edges_.size();
     set_edge_data(prop_col_.get(), len - 1, data);
   }
   inline void push_back_endpoints(vid_t src, vid_t dst, Direction dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst, dir == Direction::kOut);
   }
 
   inline void push_back_endpoints(vid_t src, vid_t dst, bool dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(src, dst, dir);
   }
 
   inline void push_back_null() {
     assert(is_optional_);
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(std::numeric_limits<vid_t>::max(),
                         std::numeric_limits<vid_t>::max(), false);
   }
@@ -854,6 +862,7 @@ class SDMLEdgeColumnBuilder : public IContextColumnBuilder {
   }
   inline void push_back_opt(label_t index, vid_t src, vid_t dst,
                             const EdgeData& data) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(index, src, dst, prop_cols_[index]->size());
     set_edge_data(prop_cols_[index].get(), prop_cols_[index]->size(), data);
   }
@@ -866,6 +875,7 @@ class SDMLEdgeColumnBuilder : public IContextColumnBuilder {
 
   inline void push_back_null() {
     assert(is_optional_);
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(0, std::numeric_limits<vid_t>::max(),
                         std::numeric_limits<vid_t>::max(),
                         prop_cols_[0]->size());
@@ -947,6 +957,7 @@ class BDMLEdgeColumnBuilder : public IContextColumnBuilder {
   }
   inline void push_back_opt(label_t index, vid_t src, vid_t dst,
                             const EdgeData& data, Direction dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(index, src, dst, prop_cols_[index]->size(),
                         dir == Direction::kOut);
     set_edge_data(prop_cols_[index].get(), prop_cols_[index]->size(), data);
@@ -973,17 +984,20 @@ class BDMLEdgeColumnBuilder : public IContextColumnBuilder {
 
   inline void push_back_endpoints(label_t index, vid_t src, vid_t dst,
                                   Direction dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(index, src, dst, prop_cols_[index]->size(),
                         dir == Direction::kOut);
   }
 
   inline void push_back_endpoints(label_t index, vid_t src, vid_t dst,
                                   bool dir) {
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(index, src, dst, prop_cols_[index]->size(), dir);
   }
 
   inline void push_back_null() {
     assert(is_optional_);
+    QueryGuard::ChargeGrowth(edges_);
     edges_.emplace_back(0, std::numeric_limits<vid_t>::max(),
                         std::numeric_limits<vid_t>::max(),
                         prop_cols_[0]->size(), false);
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "flex/engines/graph_db/runtime/common/rt_any.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
 
 #include "glog/logging.h"
 
@@ -157,6 +158,9 @@ class IContextColumn {
     return nullptr;
   }
 
+  // Whether union_col is implemented, for another column of the same type.
+  virtual bool is_unionable() const { return false; }
+
   virtual RTAny get_elem(size_t idx) const {
     LOG(FATAL) << "not implemented for " << this->column_info();
     return RTAny();
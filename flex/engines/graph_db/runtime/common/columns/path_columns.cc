@@ -52,5 +52,51 @@ std::shared_ptr<IContextColumn> OptionalGeneralPathColumn::shuffle(
   return builder.finish(this->get_arena());
 }
 
+std::unique_ptr<PathImpl> PathTrie::path(size_t node) const {
+  std::vector<VertexRecord> vertices(nodes[node].len);
+  std::vector<label_t> edge_labels(nodes[node].len - 1);
+  for (size_t k = vertices.size(); k-- > 0;) {
+    const auto& cur = nodes[node];
+    vertices[k] = {cur.label, cur.vid};
+    if (k > 0) {
+      edge_labels[k - 1] = cur.edge_label;
+    }
+    node = cur.parent;
+  }
+  return PathImpl::make_path_impl(edge_labels, vertices);
+}
+
+std::shared_ptr<IContextColumn> CompactPathColumn::shuffle(
+    const std::vector<size_t>& offsets) const {
+  std::vector<size_t> rows(offsets.size());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    rows[i] = rows_[offsets[i]];
+  }
+  return std::make_shared<CompactPathColumn>(trie_, std::move(rows),
+                                             optional_);
+}
+
+std::shared_ptr<IContextColumn> CompactPathColumn::optional_shuffle(
+    const std::vector<size_t>& offsets) const {
+  std::vector<size_t> rows(offsets.size());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    rows[i] = offsets[i] == std::numeric_limits<size_t>::max()
+                  ? PathTrie::kNoNode
+                  : rows_[offsets[i]];
+  }
+  return std::make_shared<CompactPathColumn>(trie_, std::move(rows), true);
+}
+
+void CompactPathColumn::build_paths() const {
+  paths_.resize(rows_.size());
+  for (size_t i = 0; i < rows_.size(); ++i) {
+    if (rows_[i] != PathTrie::kNoNode) {
+      auto impl = trie_->path(rows_[i]);
+      paths_[i] = Path(impl.get());
+      arena_->emplace_back(std::move(impl));
+    }
+  }
+}
+
 }  // namespace runtime
 }  // namespace gs
\ No newline at end of file
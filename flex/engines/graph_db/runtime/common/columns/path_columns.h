@@ -15,6 +15,10 @@
 
 #ifndef RUNTIME_COMMON_COLUMNS_PATH_COLUMNS_H_
 #define RUNTIME_COMMON_COLUMNS_PATH_COLUMNS_H_
+
+#include <limits>
+#include <mutex>
+
 #include "flex/engines/graph_db/runtime/common/columns/columns_utils.h"
 #include "flex/engines/graph_db/runtime/common/columns/i_context_column.h"
 
@@ -36,6 +40,9 @@ class IPathColumn : public IContextColumn {
   virtual int get_path_length(size_t idx) const {
     return get_path(idx).len() - 1;
   }
+  virtual VertexRecord get_path_end(size_t idx) const {
+    return get_path(idx).get_end();
+  }
   virtual ISigColumn* generate_signature() const = 0;
   virtual void generate_dedup_offset(std::vector<size_t>& offsets) const = 0;
 };
@@ -93,8 +100,12 @@ class GeneralPathColumnBuilder : public IContextColumnBuilder {
  public:
   GeneralPathColumnBuilder() = default;
   ~GeneralPathColumnBuilder() = default;
-  inline void push_back_opt(const Path& p) { data_.push_back(p); }
+  inline void push_back_opt(const Path& p) {
+    QueryGuard::ChargeGrowth(data_);
+    data_.push_back(p);
+  }
   inline void push_back_elem(const RTAny& val) override {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(val.as_path());
   }
   void reserve(size_t size) override { data_.reserve(size); }
@@ -168,14 +179,17 @@ class OptionalGeneralPathColumnBuilder : public IContextColumnBuilder {
   OptionalGeneralPathColumnBuilder() = default;
   ~OptionalGeneralPathColumnBuilder() = default;
   inline void push_back_opt(const Path& p, bool valid) {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(p);
     valids_.push_back(valid);
   }
   inline void push_back_elem(const RTAny& val) override {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(val.as_path());
     valids_.push_back(true);
   }
   inline void push_back_null() {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(Path());
     valids_.push_back(false);
   }
@@ -197,6 +211,124 @@ class OptionalGeneralPathColumnBuilder : public IContextColumnBuilder {
   std::vector<bool> valids_;
 };
 
+/**
+ * @brief The paths of a variable length expansion as a trie, in which each
+ * node is a hop appended to the path of its parent. Paths sharing a prefix
+ * share its nodes, so a path costs a node instead of a copy of its prefix.
+ */
+struct PathTrie {
+  static constexpr size_t kNoNode = std::numeric_limits<size_t>::max();
+
+  struct Node {
+    size_t parent;
+    vid_t vid;
+    label_t label;
+    // The label of the edge from the parent.
+    label_t edge_label;
+    int32_t len;
+  };
+
+  size_t add_root(label_t label, vid_t v) {
+    QueryGuard::ChargeGrowth(nodes);
+    nodes.push_back({kNoNode, v, label, 0, 1});
+    return nodes.size() - 1;
+  }
+
+  size_t add_child(size_t parent, label_t edge_label, label_t label, vid_t v) {
+    QueryGuard::ChargeGrowth(nodes);
+    int32_t len = nodes[parent].len + 1;
+    nodes.push_back({parent, v, label, edge_label, len});
+    return nodes.size() - 1;
+  }
+
+  VertexRecord end(size_t node) const {
+    return {nodes[node].label, nodes[node].vid};
+  }
+
+  int32_t len(size_t node) const { return nodes[node].len; }
+
+  // The path from the root to node, as PathImpl::expand() builds it.
+  std::unique_ptr<PathImpl> path(size_t node) const;
+
+  std::vector<Node> nodes;
+};
+
+/**
+ * @brief A column of the paths to nodes of a PathTrie, one node per row,
+ * kNoNode for the rows of nulls. Shuffling copies the node of each row, the
+ * lengths and ends of the paths are read from the nodes, and Paths are only
+ * built, for all the rows at once, once a row is read as a Path.
+ */
+class CompactPathColumn : public IPathColumn {
+ public:
+  CompactPathColumn(const std::shared_ptr<const PathTrie>& trie,
+                    std::vector<size_t>&& rows, bool optional = false)
+      : trie_(trie),
+        rows_(std::move(rows)),
+        optional_(optional),
+        arena_(std::make_shared<Arena>()) {}
+  ~CompactPathColumn() {}
+
+  inline size_t size() const override { return rows_.size(); }
+  std::string column_info() const override {
+    return "CompactPathColumn[" + std::to_string(size()) + "]";
+  }
+  inline ContextColumnType column_type() const override {
+    return ContextColumnType::kPath;
+  }
+  std::shared_ptr<IContextColumn> shuffle(
+      const std::vector<size_t>& offsets) const override;
+  std::shared_ptr<IContextColumn> optional_shuffle(
+      const std::vector<size_t>& offsets) const override;
+  inline bool is_optional() const override { return optional_; }
+  inline bool has_value(size_t idx) const override {
+    return rows_[idx] != PathTrie::kNoNode;
+  }
+  inline RTAnyType elem_type() const override { return RTAnyType::kPath; }
+  RTAny get_elem(size_t idx) const override {
+    if (!has_value(idx)) {
+      return RTAny(RTAnyType::kNull);
+    }
+    return RTAny(get_path(idx));
+  }
+  const Path& get_path(size_t idx) const override {
+    std::call_once(built_, [this]() { build_paths(); });
+    return paths_[idx];
+  }
+  inline int get_path_length(size_t idx) const override {
+    return trie_->len(rows_[idx]) - 1;
+  }
+  inline VertexRecord get_path_end(size_t idx) const override {
+    return trie_->end(rows_[idx]);
+  }
+  ISigColumn* generate_signature() const override {
+    LOG(FATAL) << "not implemented for " << this->column_info();
+    return nullptr;
+  }
+
+  void generate_dedup_offset(std::vector<size_t>& offsets) const override {
+    std::call_once(built_, [this]() { build_paths(); });
+    ColumnsUtils::generate_dedup_offset(paths_, paths_.size(), offsets);
+  }
+
+  // The Paths built are kept by the arena of the column, and the arenas set
+  // are kept along with them.
+  std::shared_ptr<Arena> get_arena() const override { return arena_; }
+  void set_arena(const std::shared_ptr<Arena>& arena) override {
+    arena_->emplace_back(std::make_unique<ArenaRef>(arena));
+  }
+
+ private:
+  void build_paths() const;
+
+  std::shared_ptr<const PathTrie> trie_;
+  std::vector<size_t> rows_;
+  bool optional_;
+  std::shared_ptr<Arena> arena_;
+  mutable std::once_flag built_;
+  mutable std::vector<Path> paths_;
+};
+
 }  // namespace runtime
 }  // namespace gs
 
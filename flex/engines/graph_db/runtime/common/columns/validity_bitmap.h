@@ -0,0 +1,80 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUNTIME_COMMON_COLUMNS_VALIDITY_BITMAP_H_
+#define RUNTIME_COMMON_COLUMNS_VALIDITY_BITMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+namespace runtime {
+
+// One bit per row of a column, set where the row holds a value, in 64-bit
+// words as the validity bitmaps of Arrow, so that kernels combine a word of
+// rows at once. The bits past size() in the last word are clear.
+class ValidityBitmap {
+ public:
+  static constexpr size_t kWordBits = 64;
+
+  ValidityBitmap() : size_(0) {}
+
+  inline void reserve(size_t size) {
+    words_.reserve((size + kWordBits - 1) / kWordBits);
+  }
+
+  inline void push_back(bool valid) {
+    if (size_ % kWordBits == 0) {
+      words_.push_back(0);
+    }
+    words_.back() |= static_cast<uint64_t>(valid) << (size_ % kWordBits);
+    ++size_;
+  }
+
+  inline bool get(size_t idx) const {
+    return (words_[idx / kWordBits] >> (idx % kWordBits)) & 1;
+  }
+
+  inline size_t size() const { return size_; }
+
+  inline const uint64_t* words() const { return words_.data(); }
+
+  size_t null_count() const {
+    size_t valid_num = 0;
+    for (auto word : words_) {
+      valid_num += __builtin_popcountll(word);
+    }
+    return size_ - valid_num;
+  }
+
+  void swap(ValidityBitmap& rhs) {
+    words_.swap(rhs.words_);
+    std::swap(size_, rhs.size_);
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+  size_t size_;
+};
+
+}  // namespace runtime
+
+}  // namespace gs
+
+#endif  // RUNTIME_COMMON_COLUMNS_VALIDITY_BITMAP_H_
@@ -18,6 +18,7 @@
 
 #include "flex/engines/graph_db/runtime/common/columns/columns_utils.h"
 #include "flex/engines/graph_db/runtime/common/columns/i_context_column.h"
+#include "flex/engines/graph_db/runtime/common/columns/validity_bitmap.h"
 #include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
 #include "flex/engines/graph_db/runtime/common/rt_any.h"
 #include "flex/utils/top_n_generator.h"
@@ -94,6 +95,8 @@ class ValueColumn : public IValueColumn<T> {
   std::shared_ptr<IContextColumn> union_col(
       std::shared_ptr<IContextColumn> other) const override;
 
+  bool is_unionable() const override { return true; }
+
   bool order_by_limit(bool asc, size_t limit,
                       std::vector<size_t>& offsets) const override;
 
@@ -118,10 +121,14 @@ class ValueColumnBuilder : public IContextColumnBuilder {
 
   void reserve(size_t size) override { data_.reserve(size); }
   inline void push_back_elem(const RTAny& val) override {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(TypedConverter<T>::to_typed(val));
   }
 
-  inline void push_back_opt(const T& val) { data_.push_back(val); }
+  inline void push_back_opt(const T& val) {
+    QueryGuard::ChargeGrowth(data_);
+    data_.push_back(val);
+  }
 
   std::shared_ptr<IContextColumn> finish(
       const std::shared_ptr<Arena>& arena) override {
@@ -264,10 +271,14 @@ class ListValueColumnBuilder : public IContextColumnBuilder {
   void reserve(size_t size) override { data_.reserve(size); }
   void push_back_elem(const RTAny& val) override {
     assert(val.type() == RTAnyType::kList);
+    QueryGuard::ChargeGrowth(data_);
     data_.emplace_back(val.as_list());
   }
 
-  void push_back_opt(const List& val) { data_.emplace_back(val); }
+  void push_back_opt(const List& val) {
+    QueryGuard::ChargeGrowth(data_);
+    data_.emplace_back(val);
+  }
 
   std::shared_ptr<IContextColumn> finish(
       const std::shared_ptr<Arena>& ptr) override {
@@ -303,7 +314,7 @@ class OptionalValueColumn : public IValueColumn<T> {
     OptionalValueColumnBuilder<T> builder;
     builder.reserve(offsets.size());
     for (auto offset : offsets) {
-      builder.push_back_opt(data_[offset], valid_[offset]);
+      builder.push_back_opt(data_[offset], valid_.get(offset));
     }
     return builder.finish(this->get_arena());
   }
@@ -318,6 +329,11 @@ class OptionalValueColumn : public IValueColumn<T> {
 
   inline T get_value(size_t idx) const override { return data_[idx]; }
 
+  // Null rows hold T().
+  inline const std::vector<T>& data() const { return data_; }
+
+  inline const ValidityBitmap& validity() const { return valid_; }
+
   ISigColumn* generate_signature() const override {
     if constexpr (std::is_same_v<T, std::string_view>) {
       return new SigColumn<std::string_view>(data_);
@@ -335,7 +351,7 @@ class OptionalValueColumn : public IValueColumn<T> {
     ColumnsUtils::generate_dedup_offset(data_, data_.size(), offsets);
   }
 
-  bool has_value(size_t idx) const override { return valid_[idx]; }
+  bool has_value(size_t idx) const override { return valid_.get(idx); }
   bool is_optional() const override { return true; }
 
   void set_arena(const std::shared_ptr<Arena>& arena) override {
@@ -347,7 +363,7 @@ class OptionalValueColumn : public IValueColumn<T> {
   template <typename _T>
   friend class OptionalValueColumnBuilder;
   std::vector<T> data_;
-  std::vector<bool> valid_;
+  ValidityBitmap valid_;
   std::shared_ptr<Arena> arena_;
 };
 
@@ -363,16 +379,19 @@ class OptionalValueColumnBuilder : public IOptionalContextColumnBuilder {
   }
 
   inline void push_back_elem(const RTAny& val) override {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(TypedConverter<T>::to_typed(val));
     valid_.push_back(true);
   }
 
   inline void push_back_opt(const T& val, bool valid) {
+    QueryGuard::ChargeGrowth(data_);
     data_.push_back(val);
     valid_.push_back(valid);
   }
 
   inline void push_back_null() override {
+    QueryGuard::ChargeGrowth(data_);
     data_.emplace_back(T());
     valid_.push_back(false);
   }
@@ -388,7 +407,7 @@ class OptionalValueColumnBuilder : public IOptionalContextColumnBuilder {
 
  private:
   std::vector<T> data_;
-  std::vector<bool> valid_;
+  ValidityBitmap valid_;
 };
 
 template <typename T>
@@ -112,6 +112,22 @@ SLVertexColumn::generate_aggregate_offset() const {
   return std::make_pair(builder.finish(this->get_arena()), std::move(offsets));
 }
 
+// Appends the vertices of rhs to those of lhs, whatever their labels.
+static std::shared_ptr<IContextColumn> union_vertex_columns(
+    const IVertexColumn& lhs, const std::shared_ptr<IContextColumn>& rhs) {
+  CHECK(rhs->column_type() == ContextColumnType::kVertex);
+  const IVertexColumn& col = *std::dynamic_pointer_cast<IVertexColumn>(rhs);
+  auto builder = MLVertexColumnBuilder::builder();
+  builder.reserve(lhs.size() + col.size());
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    builder.push_back_vertex(lhs.get_vertex(i));
+  }
+  for (size_t i = 0; i < col.size(); ++i) {
+    builder.push_back_vertex(col.get_vertex(i));
+  }
+  return builder.finish(nullptr);
+}
+
 std::shared_ptr<IContextColumn> SLVertexColumn::union_col(
     std::shared_ptr<IContextColumn> other) const {
   CHECK(other->column_type() == ContextColumnType::kVertex);
@@ -157,6 +173,11 @@ std::shared_ptr<IContextColumn> SLVertexColumnBuilder::finish(
   }
 }
 
+std::shared_ptr<IContextColumn> MSVertexColumn::union_col(
+    std::shared_ptr<IContextColumn> other) const {
+  return union_vertex_columns(*this, other);
+}
+
 std::shared_ptr<IContextColumn> MSVertexColumn::shuffle(
     const std::vector<size_t>& offsets) const {
   auto builder = MLVertexColumnBuilder::builder();
@@ -192,6 +213,11 @@ std::shared_ptr<IContextColumn> MSVertexColumnBuilder::finish(
   return ret;
 }
 
+std::shared_ptr<IContextColumn> MLVertexColumn::union_col(
+    std::shared_ptr<IContextColumn> other) const {
+  return union_vertex_columns(*this, other);
+}
+
 std::shared_ptr<IContextColumn> MLVertexColumn::shuffle(
     const std::vector<size_t>& offsets) const {
   auto builder = MLVertexColumnBuilder::builder(labels_);
@@ -100,6 +100,8 @@ class SLVertexColumn : public SLVertexColumnBase {
   std::shared_ptr<IContextColumn> union_col(
       std::shared_ptr<IContextColumn> other) const override;
 
+  bool is_unionable() const override { return true; }
+
   void generate_dedup_offset(std::vector<size_t>& offsets) const override;
 
   std::pair<std::shared_ptr<IContextColumn>, std::vector<std::vector<size_t>>>
@@ -157,12 +159,17 @@ class SLVertexColumnBuilder : public IVertexColumnBuilder {
 
   inline void push_back_vertex(VertexRecord v) override {
     assert(v.label_ == label_);
+    QueryGuard::ChargeGrowth(vertices_);
     vertices_.push_back(v.vid_);
   }
-  inline void push_back_opt(vid_t v) { vertices_.push_back(v); }
+  inline void push_back_opt(vid_t v) {
+    QueryGuard::ChargeGrowth(vertices_);
+    vertices_.push_back(v);
+  }
 
   inline void push_back_null() override {
     assert(is_optional_);
+    QueryGuard::ChargeGrowth(vertices_);
     vertices_.emplace_back(std::numeric_limits<vid_t>::max());
   }
 
@@ -264,6 +271,11 @@ class MSVertexColumn : public IVertexColumn {
   std::shared_ptr<IContextColumn> shuffle(
       const std::vector<size_t>& offsets) const override;
 
+  std::shared_ptr<IContextColumn> union_col(
+      std::shared_ptr<IContextColumn> other) const override;
+
+  bool is_unionable() const override { return true; }
+
   inline VertexRecord get_vertex(size_t idx) const override {
     for (auto& pair : vertices_) {
       if (idx < pair.second.size()) {
@@ -315,26 +327,33 @@ class MSVertexColumnBuilder : public IVertexColumnBuilder {
 
   inline void push_back_vertex(VertexRecord v) override {
     if (v.label_ == cur_label_) {
+      QueryGuard::ChargeGrowth(cur_list_);
       cur_list_.push_back(v.vid_);
     } else {
       if (!cur_list_.empty()) {
+        QueryGuard::ChargeGrowth(vertices_);
         vertices_.emplace_back(cur_label_, std::move(cur_list_));
         cur_list_.clear();
       }
       cur_label_ = v.label_;
+      QueryGuard::ChargeGrowth(cur_list_);
       cur_list_.push_back(v.vid_);
     }
   }
 
   void start_label(label_t label) {
     if (!cur_list_.empty() && cur_label_ != label) {
+      QueryGuard::ChargeGrowth(vertices_);
       vertices_.emplace_back(cur_label_, std::move(cur_list_));
       cur_list_.clear();
     }
     cur_label_ = label;
   }
 
-  inline void push_back_opt(vid_t v) { cur_list_.push_back(v); }
+  inline void push_back_opt(vid_t v) {
+    QueryGuard::ChargeGrowth(cur_list_);
+    cur_list_.push_back(v);
+  }
 
   inline void push_back_null() override {
     LOG(FATAL) << "MSVertexColumnBuilder does not support null value.";
@@ -386,6 +405,11 @@ class MLVertexColumn : public MLVertexColumnBase {
     return vertices_[idx];
   }
 
+  std::shared_ptr<IContextColumn> union_col(
+      std::shared_ptr<IContextColumn> other) const override;
+
+  bool is_unionable() const override { return true; }
+
   template <typename FUNC_T>
   void foreach_vertex(const FUNC_T& func) const {
     size_t index = 0;
@@ -428,11 +452,13 @@ class MLVertexColumnBuilder : public IVertexColumnBuilder {
   void reserve(size_t size) override { vertices_.reserve(size); }
   inline void push_back_opt(VertexRecord v) {
     labels_.insert(v.label_);
+    QueryGuard::ChargeGrowth(vertices_);
     vertices_.push_back(v);
   }
 
   inline void push_back_vertex(VertexRecord v) override {
     labels_.insert(v.label_);
+    QueryGuard::ChargeGrowth(vertices_);
     vertices_.push_back(v);
   }
 
@@ -21,26 +21,115 @@ namespace gs {
 
 namespace runtime {
 
-Context::Context() : head(nullptr), offset_ptr(nullptr) {}
+Context::Context()
+    : head(nullptr), offset_ptr(nullptr), head_level_(0), composed_level_(0) {}
 
 void Context::clear() {
   columns.clear();
   head.reset();
   offset_ptr = nullptr;
   tag_ids.clear();
+  levels_.clear();
+  col_levels_.clear();
+  head_level_ = 0;
+  composed_ = nullptr;
 }
 
 void Context::set(int alias, std::shared_ptr<IContextColumn> col) {
   head = col;
+  head_level_ = levels_.size();
   if (alias >= 0) {
     if (columns.size() <= static_cast<size_t>(alias)) {
       columns.resize(alias + 1, nullptr);
     }
+    if (col_levels_.size() <= static_cast<size_t>(alias)) {
+      col_levels_.resize(alias + 1, 0);
+    }
     assert(columns[alias] == nullptr);
     columns[alias] = col;
+    col_levels_[alias] = levels_.size();
   }
 }
 
+const std::vector<size_t>& Context::composed_offsets(size_t level) const {
+  if (level + 1 == levels_.size()) {
+    return *levels_.back().offsets;
+  }
+  if (composed_ != nullptr && composed_level_ == level) {
+    return *composed_;
+  }
+  auto offsets = std::make_shared<std::vector<size_t>>(*levels_.back().offsets);
+  for (size_t k = levels_.size() - 1; k-- > level;) {
+    const auto& prev = *levels_[k].offsets;
+    for (auto& offset : *offsets) {
+      if (offset != std::numeric_limits<size_t>::max()) {
+        offset = prev[offset];
+      }
+    }
+  }
+  composed_ = offsets;
+  composed_level_ = level;
+  return *composed_;
+}
+
+std::shared_ptr<IContextColumn> Context::materialize(
+    const std::shared_ptr<IContextColumn>& col, size_t level) const {
+  if (col == nullptr || level == levels_.size()) {
+    return col;
+  }
+  bool optional = false;
+  for (size_t k = level; k < levels_.size(); ++k) {
+    optional |= levels_[k].optional;
+  }
+  const auto& offsets = composed_offsets(level);
+  return optional ? col->optional_shuffle(offsets) : col->shuffle(offsets);
+}
+
+size_t Context::col_level(size_t alias) const {
+  return alias < col_levels_.size() ? col_levels_[alias] : levels_.size();
+}
+
+void Context::materialize_column(size_t alias) const {
+  size_t level = col_level(alias);
+  if (level == levels_.size()) {
+    return;
+  }
+  auto col = columns[alias];
+  auto shuffled = materialize(col, level);
+  // The head stays the same column as the one it was set with.
+  if (head == col && head_level_ == level) {
+    head = shuffled;
+    head_level_ = levels_.size();
+  }
+  columns[alias] = shuffled;
+  col_levels_[alias] = levels_.size();
+}
+
+void Context::materialize_head() const {
+  if (head_level_ == levels_.size()) {
+    return;
+  }
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i] == head && col_level(i) == head_level_) {
+      materialize_column(i);
+      return;
+    }
+  }
+  head = materialize(head, head_level_);
+  head_level_ = levels_.size();
+}
+
+void Context::flatten() const {
+  for (size_t i = 0; i < columns.size(); ++i) {
+    materialize_column(i);
+  }
+  materialize_head();
+  levels_.clear();
+  std::fill(col_levels_.begin(), col_levels_.end(), 0);
+  head_level_ = 0;
+  composed_ = nullptr;
+}
+
 void Context::set_with_reshuffle(int alias, std::shared_ptr<IContextColumn> col,
                                  const std::vector<size_t>& offsets) {
   head.reset();
@@ -58,28 +147,20 @@ void Context::set_with_reshuffle(int alias, std::shared_ptr<IContextColumn> col,
   set(alias, col);
 }
 
-void Context::reshuffle(const std::vector<size_t>& offsets) {
-  bool head_shuffled = false;
-  std::vector<std::shared_ptr<IContextColumn>> new_cols;
-
-  for (auto col : columns) {
-    if (col == nullptr) {
-      new_cols.push_back(nullptr);
-
-      continue;
-    }
-    if (col == head) {
-      head = col->shuffle(offsets);
-      new_cols.push_back(head);
-      head_shuffled = true;
-    } else {
-      new_cols.push_back(col->shuffle(offsets));
-    }
+void Context::push_level(const std::vector<size_t>& offsets, bool optional) {
+  bool has_column = (head != nullptr);
+  for (auto& col : columns) {
+    has_column |= (col != nullptr);
   }
-  if (!head_shuffled && head != nullptr) {
-    head = head->shuffle(offsets);
+  if (has_column) {
+    levels_.push_back(
+        {std::make_shared<const std::vector<size_t>>(offsets), optional});
+    composed_ = nullptr;
   }
-  std::swap(new_cols, columns);
+}
+
+void Context::reshuffle(const std::vector<size_t>& offsets) {
+  push_level(offsets, false);
   if (offset_ptr != nullptr) {
     offset_ptr = std::dynamic_pointer_cast<ValueColumn<size_t>>(
         offset_ptr->shuffle(offsets));
@@ -87,27 +168,7 @@ void Context::reshuffle(const std::vector<size_t>& offsets) {
 }
 
 void Context::optional_reshuffle(const std::vector<size_t>& offsets) {
-  bool head_shuffled = false;
-  std::vector<std::shared_ptr<IContextColumn>> new_cols;
-
-  for (auto col : columns) {
-    if (col == nullptr) {
-      new_cols.push_back(nullptr);
-
-      continue;
-    }
-    if (col == head) {
-      head = col->optional_shuffle(offsets);
-      new_cols.push_back(head);
-      head_shuffled = true;
-    } else {
-      new_cols.push_back(col->optional_shuffle(offsets));
-    }
-  }
-  if (!head_shuffled && head != nullptr) {
-    head = head->optional_shuffle(offsets);
-  }
-  std::swap(new_cols, columns);
+  push_level(offsets, true);
   if (offset_ptr != nullptr) {
     offset_ptr = std::dynamic_pointer_cast<ValueColumn<size_t>>(
         offset_ptr->optional_shuffle(offsets));
@@ -116,18 +177,22 @@ void Context::optional_reshuffle(const std::vector<size_t>& offsets) {
 
 std::shared_ptr<IContextColumn> Context::get(int alias) {
   if (alias == -1) {
+    materialize_head();
     return head;
   }
   CHECK(static_cast<size_t>(alias) < columns.size());
+  materialize_column(alias);
   return columns[alias];
 }
 
 const std::shared_ptr<IContextColumn> Context::get(int alias) const {
   if (alias == -1) {
     assert(head != nullptr);
+    materialize_head();
     return head;
   }
   CHECK(static_cast<size_t>(alias) < columns.size());
+  materialize_column(alias);
   // return nullptr if the column is not set
   return columns[alias];
 }
@@ -149,13 +214,15 @@ void Context::remove(int alias) {
 }
 
 size_t Context::row_num() const {
-  for (auto col : columns) {
-    if (col != nullptr) {
-      return col->size();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (columns[i] != nullptr) {
+      return col_level(i) == levels_.size() ? columns[i]->size()
+                                            : levels_.back().offsets->size();
     }
   }
   if (head != nullptr) {
-    return head->size();
+    return head_level_ == levels_.size() ? head->size()
+                                         : levels_.back().offsets->size();
   }
   return 0;
 }
@@ -171,6 +238,7 @@ bool Context::exist(int alias) const {
 }
 
 void Context::desc(const std::string& info) const {
+  flatten();
   if (!info.empty()) {
     LOG(INFO) << info;
   }
@@ -183,6 +251,7 @@ void Context::desc(const std::string& info) const {
 }
 
 void Context::show(const GraphReadInterface& graph) const {
+  flatten();
   size_t rn = row_num();
   size_t cn = col_num();
   for (size_t ri = 0; ri < rn; ++ri) {
@@ -216,6 +285,8 @@ void Context::gen_offset() {
 }
 
 Context Context::union_ctx(const Context& other) const {
+  flatten();
+  other.flatten();
   Context ctx;
   CHECK(columns.size() == other.columns.size());
   for (size_t i = 0; i < col_num(); ++i) {
@@ -26,6 +26,15 @@ namespace gs {
 
 namespace runtime {
 
+/**
+ * @brief The rows of a query, one column per alias.
+ *
+ * Rows are factorized over reshuffles: reshuffle and optional_reshuffle
+ * only record their offsets, and a column is shuffled, once through all the
+ * offsets recorded since it was set, when it is read. Columns that are not
+ * read again, such as the prefix of a path expanded hop after hop, are never
+ * copied, and row_num() needs none of them.
+ */
 class Context {
  public:
   Context();
@@ -62,13 +71,46 @@ class Context {
 
   Context union_ctx(const Context& ctx) const;
 
-  std::vector<std::shared_ptr<IContextColumn>> columns;
-  std::shared_ptr<IContextColumn> head;
+  // Shuffles every column through the pending reshuffles, to read columns
+  // and head directly.
+  void flatten() const;
+
+  // Mutable as const reads shuffle the columns they read.
+  mutable std::vector<std::shared_ptr<IContextColumn>> columns;
+  mutable std::shared_ptr<IContextColumn> head;
 
   // for intersect
   const ValueColumn<size_t>& get_offsets() const;
   std::shared_ptr<ValueColumn<size_t>> offset_ptr;
   std::vector<int> tag_ids;
+
+ private:
+  // A pending reshuffle, mapping the rows after it to those before it. The
+  // offsets of an optional one are the max of size_t for rows of nulls.
+  struct Level {
+    std::shared_ptr<const std::vector<size_t>> offsets;
+    bool optional;
+  };
+
+  void push_level(const std::vector<size_t>& offsets, bool optional);
+  // The offsets from the rows after the last level to those before the
+  // given one, composed once for all the columns read from that level.
+  const std::vector<size_t>& composed_offsets(size_t level) const;
+
+  mutable std::vector<Level> levels_;
+  // The number of levels each column and the head went through already.
+  mutable std::vector<size_t> col_levels_;
+  mutable size_t head_level_;
+  // The offsets last composed, to the rows before composed_level_, if any.
+  mutable std::shared_ptr<const std::vector<size_t>> composed_;
+  mutable size_t composed_level_;
+
+  std::shared_ptr<IContextColumn> materialize(
+      const std::shared_ptr<IContextColumn>& col, size_t level) const;
+  // Columns assigned without set() are taken as up to date.
+  size_t col_level(size_t alias) const;
+  void materialize_column(size_t alias) const;
+  void materialize_head() const;
 };
 
 class ContextMeta {
@@ -16,10 +16,13 @@
 #ifndef RUNTIME_COMMON_GRAPH_INTERFACE_H_
 #define RUNTIME_COMMON_GRAPH_INTERFACE_H_
 
+#include <type_traits>
+
 #include "flex/engines/graph_db/database/insert_transaction.h"
 #include "flex/engines/graph_db/database/read_transaction.h"
 #include "flex/engines/graph_db/database/update_transaction.h"
 #include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/sorted_intersection.h"
 
 namespace gs {
 
@@ -31,24 +34,105 @@ using gs::label_t;
 using gs::timestamp_t;
 using gs::vid_t;
 
+// A value of a column of another type than the one a plan reads it as, e.g.
+// a float column read as double, with numbers converted to PROP_T.
+template <typename PROP_T>
+PROP_T convert_property(const Any& value) {
+  if (value.type == AnyConverter<PROP_T>::type()) {
+    return AnyConverter<PROP_T>::from_any(value);
+  }
+  if constexpr (std::is_arithmetic_v<PROP_T>) {
+    const auto& type = value.type;
+    if (type == PropertyType::kBool) {
+      return static_cast<PROP_T>(value.value.b);
+    } else if (type == PropertyType::kUInt8) {
+      return static_cast<PROP_T>(value.value.u8);
+    } else if (type == PropertyType::kUInt16) {
+      return static_cast<PROP_T>(value.value.u16);
+    } else if (type == PropertyType::kInt32) {
+      return static_cast<PROP_T>(value.value.i);
+    } else if (type == PropertyType::kUInt32) {
+      return static_cast<PROP_T>(value.value.ui);
+    } else if (type == PropertyType::kInt64) {
+      return static_cast<PROP_T>(value.value.l);
+    } else if (type == PropertyType::kUInt64) {
+      return static_cast<PROP_T>(value.value.ul);
+    } else if (type == PropertyType::kFloat) {
+      return static_cast<PROP_T>(value.value.f);
+    } else if (type == PropertyType::kDouble) {
+      return static_cast<PROP_T>(value.value.db);
+    }
+  }
+  return PROP_T();
+}
+
+/**
+ * @brief The values of a vertex property as PROP_T. They are read straight
+ * from the buffers of the column if it is of type PROP_T, with no virtual
+ * call or boxing. Otherwise, e.g. for a column of another numeric type than
+ * the plan reads or of a kind with no typed ref column, they are read from
+ * ColumnBase::get() and converted.
+ *
+ * The values committed by PropertyUpdateTransaction and not yet folded into
+ * the column are read from the versions, if set.
+ */
 template <typename PROP_T>
 class VertexColumn {
  public:
-  VertexColumn(const std::shared_ptr<TypedRefColumn<PROP_T>>& column) {
-    if (column == nullptr) {
-      column_ = nullptr;
-    } else {
-      column_ = column;
+  VertexColumn(const std::shared_ptr<TypedRefColumn<PROP_T>>& column)
+      : column_(column), fallback_(nullptr), versions_(nullptr) {}
+  VertexColumn(const std::shared_ptr<ColumnBase>& fallback)
+      : column_(nullptr), fallback_(fallback), versions_(nullptr) {}
+  VertexColumn() : column_(nullptr), fallback_(nullptr), versions_(nullptr) {}
+
+  // Reads property col_id of the label as of ts through versions first.
+  inline void set_versions(const VertexPropertyVersions* versions,
+                           label_t label, int col_id, timestamp_t ts) {
+    versions_ = versions;
+    label_ = label;
+    col_id_ = col_id;
+    ts_ = ts;
+  }
+
+  inline PROP_T get_view(vid_t v) const {
+    Any version;
+    if (versions_ != nullptr &&
+        versions_->Get(label_, v, col_id_, ts_, version)) {
+      return convert_property<PROP_T>(version);
     }
+    if (column_ != nullptr) {
+      return column_->get_view(v);
+    }
+    return convert_property<PROP_T>(fallback_->get(v));
   }
-  VertexColumn() : column_(nullptr) {}
 
-  inline PROP_T get_view(vid_t v) const { return column_->get_view(v); }
+  // Only for string columns, compares by dictionary code where possible.
+  inline StringDictCode get_code(const PROP_T& val) const {
+    if (column_ == nullptr) {
+      return StringDictCode();
+    }
+    return column_->get_code(val);
+  }
+
+  inline bool equals(vid_t v, const PROP_T& val,
+                     const StringDictCode& code) const {
+    if (column_ == nullptr || versions_ != nullptr) {
+      return get_view(v) == val;
+    }
+    return column_->equals(v, val, code);
+  }
 
-  inline bool is_null() const { return column_ == nullptr; }
+  inline bool is_null() const {
+    return column_ == nullptr && fallback_ == nullptr;
+  }
 
  private:
   std::shared_ptr<TypedRefColumn<PROP_T>> column_;
+  std::shared_ptr<ColumnBase> fallback_;
+  const VertexPropertyVersions* versions_;
+  label_t label_ = 0;
+  int col_id_ = 0;
+  timestamp_t ts_ = 0;
 };
 
 class VertexSet {
@@ -101,86 +185,216 @@ class EdgeIterator {
   gs::ReadTransaction::edge_iterator iter_;
 };
 
+// Whether the triplets of edge data EDATA_T may be kept in a
+// CompressedImmutableCsr. String and record edges keep their own layout.
+template <typename EDATA_T>
+inline constexpr bool is_compressible_edata_v =
+    !std::is_same_v<EDATA_T, std::string_view> &&
+    !std::is_same_v<EDATA_T, RecordView>;
+
 template <typename EDATA_T>
 class AdjListView {
   class nbr_iterator {
-    // const_nbr_t provide two methods:
-    // 1. vid_t get_neighbor() const;
-    // 2. const EDATA_T& get_data() const;
-    using const_nbr_t = typename gs::MutableNbrSlice<EDATA_T>::const_nbr_t;
     using const_nbr_ptr_t =
         typename gs::MutableNbrSlice<EDATA_T>::const_nbr_ptr_t;
+    using compressed_iterator_t = gs::CompressedNbrIterator<EDATA_T>;
 
    public:
     nbr_iterator(const_nbr_ptr_t ptr, const_nbr_ptr_t end,
-                 timestamp_t timestamp)
-        : ptr_(ptr), end_(end), timestamp_(timestamp) {
-      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
-        ++ptr_;
-      }
+                 timestamp_t timestamp, bool frozen)
+        : ptr_(ptr),
+          end_(end),
+          timestamp_(timestamp),
+          frozen_(frozen),
+          compressed_(false) {
+      skip_invisible();
     }
+    // Decodes the neighbors of a compressed csr, which are all visible.
+    explicit nbr_iterator(const compressed_iterator_t& cur)
+        : ptr_(),
+          end_(),
+          timestamp_(0),
+          frozen_(true),
+          compressed_(true),
+          cur_(cur) {}
+
+    // The iterator is the neighbor it points to, as the neighbors of a
+    // compressed csr are decoded into it:
+    // 1. vid_t get_neighbor() const;
+    // 2. get_data() const, a const EDATA_T& unless EDATA_T is a view.
+    inline const nbr_iterator& operator*() const { return *this; }
 
-    inline const_nbr_t& operator*() const { return *ptr_; }
+    inline const nbr_iterator* operator->() const { return this; }
 
-    inline const_nbr_ptr_t operator->() const { return ptr_; }
+    inline vid_t get_neighbor() const {
+      if constexpr (is_compressible_edata_v<EDATA_T>) {
+        if (compressed_) {
+          return cur_.get_neighbor();
+        }
+      }
+      return ptr_->get_neighbor();
+    }
+
+    inline decltype(auto) get_data() const {
+      if constexpr (is_compressible_edata_v<EDATA_T>) {
+        if (compressed_) {
+          return cur_.get_data();
+        }
+      }
+      return ptr_->get_data();
+    }
 
     inline nbr_iterator& operator++() {
-      ++ptr_;
-      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
-        ++ptr_;
+      if constexpr (is_compressible_edata_v<EDATA_T>) {
+        if (compressed_) {
+          ++cur_;
+          return *this;
+        }
       }
+      ++ptr_;
+      skip_invisible();
       return *this;
     }
 
     inline bool operator==(const nbr_iterator& rhs) const {
-      return (ptr_ == rhs.ptr_);
+      return compressed_ ? cur_ == rhs.cur_ : ptr_ == rhs.ptr_;
     }
 
     inline bool operator!=(const nbr_iterator& rhs) const {
-      return (ptr_ != rhs.ptr_);
+      return !(*this == rhs);
     }
 
    private:
+    // Frozen lists hold no edge invisible to this reader.
+    inline void skip_invisible() {
+      if (frozen_) {
+        return;
+      }
+      while (ptr_ != end_ && ptr_->get_timestamp() > timestamp_) {
+        ++ptr_;
+      }
+    }
+
     const_nbr_ptr_t ptr_;
     const_nbr_ptr_t end_;
     timestamp_t timestamp_;
+    bool frozen_;
+    bool compressed_;
+    compressed_iterator_t cur_;
   };
 
  public:
   using slice_t = gs::MutableNbrSlice<EDATA_T>;
-  AdjListView(const slice_t& slice, timestamp_t timestamp)
-      : edges_(slice), timestamp_(timestamp) {}
+  using compressed_slice_t = gs::CompressedNbrSlice<EDATA_T>;
+  AdjListView(const slice_t& slice, timestamp_t timestamp,
+              bool frozen = false)
+      : edges_(slice),
+        timestamp_(timestamp),
+        frozen_(frozen),
+        compressed_(false) {}
+  explicit AdjListView(const compressed_slice_t& slice)
+      : timestamp_(0),
+        frozen_(true),
+        compressed_(true),
+        compressed_edges_(slice) {}
 
   inline nbr_iterator begin() const {
-    return nbr_iterator(edges_.begin(), edges_.end(), timestamp_);
+    if constexpr (is_compressible_edata_v<EDATA_T>) {
+      if (compressed_) {
+        return nbr_iterator(compressed_edges_.begin());
+      }
+    }
+    return nbr_iterator(edges_.begin(), edges_.end(), timestamp_, frozen_);
   }
   inline nbr_iterator end() const {
-    return nbr_iterator(edges_.end(), edges_.end(), timestamp_);
+    if constexpr (is_compressible_edata_v<EDATA_T>) {
+      if (compressed_) {
+        return nbr_iterator(compressed_edges_.end());
+      }
+    }
+    return nbr_iterator(edges_.end(), edges_.end(), timestamp_, true);
   }
 
  private:
   slice_t edges_;
   timestamp_t timestamp_;
+  bool frozen_;
+  bool compressed_;
+  compressed_slice_t compressed_edges_;
 };
 
 template <typename EDATA_T>
 class GraphView {
  public:
-  GraphView() : csr_(nullptr), timestamp_(0), unsorted_since_(0) {}
+  static constexpr size_t PREFETCH_DISTANCE = 8;
+
+  GraphView()
+      : csr_(nullptr),
+        compressed_csr_(nullptr),
+        timestamp_(0),
+        unsorted_since_(0) {}
   GraphView(const gs::MutableCsr<EDATA_T>* csr, timestamp_t timestamp)
       : csr_(csr),
+        compressed_csr_(nullptr),
         timestamp_(timestamp),
         unsorted_since_(csr->unsorted_since()) {}
+  // The edges of a compressed csr are all visible and sorted by neighbor,
+  // see CompressedImmutableCsr.
+  GraphView(const gs::CompressedImmutableCsr<EDATA_T>* csr,
+            timestamp_t timestamp)
+      : csr_(nullptr),
+        compressed_csr_(csr),
+        timestamp_(timestamp),
+        unsorted_since_(0) {}
 
-  inline bool is_null() const { return csr_ == nullptr; }
+  inline bool is_null() const {
+    return csr_ == nullptr && compressed_csr_ == nullptr;
+  }
 
   inline AdjListView<EDATA_T> get_edges(vid_t v) const {
-    return AdjListView<EDATA_T>(csr_->get_edges(v), timestamp_);
+    if constexpr (is_compressible_edata_v<EDATA_T>) {
+      if (compressed_csr_ != nullptr) {
+        return AdjListView<EDATA_T>(compressed_csr_->get_edges(v));
+      }
+    }
+    auto edges = csr_->get_edges(v);
+    return AdjListView<EDATA_T>(edges, timestamp_, csr_->is_frozen(v));
+  }
+
+  // Calls func(idx, v) for the vertices in turn, with the adjacency lists of
+  // the ones ahead prefetched: the headers 2 * PREFETCH_DISTANCE ahead, and
+  // the neighbors, whose headers are cached by then, PREFETCH_DISTANCE ahead.
+  // An expansion of vertices spread over a graph larger than the cache
+  // otherwise waits for two dependent misses per vertex.
+  template <typename FUNC_T>
+  inline void foreach_prefetched(const std::vector<vid_t>& vertices,
+                                 const FUNC_T& func) const {
+    size_t num = vertices.size();
+    if (compressed_csr_ != nullptr) {
+      for (size_t i = 0; i < num; ++i) {
+        func(i, vertices[i]);
+      }
+      return;
+    }
+    for (size_t i = 0; i < std::min(num, 2 * PREFETCH_DISTANCE); ++i) {
+      csr_->prefetch_adj_list(vertices[i]);
+    }
+    for (size_t i = 0; i < num; ++i) {
+      if (i + 2 * PREFETCH_DISTANCE < num) {
+        csr_->prefetch_adj_list(vertices[i + 2 * PREFETCH_DISTANCE]);
+      }
+      if (i + PREFETCH_DISTANCE < num) {
+        csr_->prefetch_edges(vertices[i + PREFETCH_DISTANCE]);
+      }
+      func(i, vertices[i]);
+    }
   }
 
   template <typename FUNC_T>
   inline void foreach_edges_gt(vid_t v, const EDATA_T& min_value,
                                const FUNC_T& func) const {
+    // Compressed csrs are never sorted by edge data.
+    DCHECK(compressed_csr_ == nullptr);
     const auto& edges = csr_->get_edges(v);
     auto ptr = edges.end() - 1;
     auto end = edges.begin() - 1;
@@ -209,6 +423,8 @@ class GraphView {
   template <typename FUNC_T>
   inline void foreach_edges_lt(vid_t v, const EDATA_T& max_value,
                                const FUNC_T& func) const {
+    // Compressed csrs are never sorted by edge data.
+    DCHECK(compressed_csr_ == nullptr);
     const auto& edges = csr_->get_edges(v);
     auto ptr = edges.end() - 1;
     auto end = edges.begin() - 1;
@@ -239,8 +455,131 @@ class GraphView {
     }
   }
 
+  // iterate edges with data in [min_value, max_value): the unsorted tail is
+  // checked edge by edge, the sorted part is binary searched for max_value.
+  // The csr must be sorted by edge data, see Schema::get_sort_on_compaction.
+  template <typename FUNC_T>
+  inline void foreach_edges_between(vid_t v, const EDATA_T& min_value,
+                                    const EDATA_T& max_value,
+                                    const FUNC_T& func) const {
+    // Compressed csrs are never sorted by edge data.
+    DCHECK(compressed_csr_ == nullptr);
+    const auto& edges = csr_->get_edges(v);
+    auto ptr = edges.end() - 1;
+    auto end = edges.begin() - 1;
+    while (ptr != end) {
+      if (ptr->timestamp > timestamp_) {
+        --ptr;
+        continue;
+      }
+      if (ptr->timestamp < unsorted_since_) {
+        break;
+      }
+      if (!(ptr->data < min_value) && ptr->data < max_value) {
+        func(ptr->neighbor, ptr->data);
+      }
+      --ptr;
+    }
+    if (ptr == end) {
+      return;
+    }
+    ptr = std::lower_bound(end + 1, ptr + 1, max_value,
+                           [](const MutableNbr<EDATA_T>& a, const EDATA_T& b) {
+                             return a.data < b;
+                           }) -
+          1;
+    while (ptr != end) {
+      if (ptr->data < min_value) {
+        break;
+      }
+      func(ptr->neighbor, ptr->data);
+      --ptr;
+    }
+  }
+
+  // iterate edges on the part sorted by edge data in increasing order of
+  // data if asc, decreasing otherwise, until func returns false. The edges
+  // of the unsorted tail are visited first, whatever func returns. The csr
+  // must be sorted by edge data, see Schema::get_sort_on_compaction.
+  template <typename FUNC_T>
+  inline void foreach_edges_ordered(vid_t v, bool asc,
+                                    const FUNC_T& func) const {
+    // Compressed csrs are never sorted by edge data.
+    DCHECK(compressed_csr_ == nullptr);
+    const auto& edges = csr_->get_edges(v);
+    auto begin = edges.begin();
+    auto ptr = edges.end();
+    while (ptr != begin && (ptr - 1)->timestamp >= unsorted_since_) {
+      --ptr;
+      if (ptr->timestamp <= timestamp_) {
+        func(ptr->neighbor, ptr->data);
+      }
+    }
+    if (asc) {
+      for (auto e = begin; e != ptr; ++e) {
+        if (e->timestamp <= timestamp_ && !func(e->neighbor, e->data)) {
+          break;
+        }
+      }
+    } else {
+      while (ptr != begin) {
+        --ptr;
+        if (ptr->timestamp <= timestamp_ && !func(ptr->neighbor, ptr->data)) {
+          break;
+        }
+      }
+    }
+  }
+
+  // iterate edges whose neighbor is in the sorted range [begin, end). The
+  // csr must be sorted by neighbor, see Schema::get_sort_by_neighbor, or be
+  // compressed.
+  template <typename FUNC_T>
+  inline void foreach_edges_with_nbr_in(vid_t v, const vid_t* begin,
+                                        const vid_t* end,
+                                        const FUNC_T& func) const {
+    if constexpr (is_compressible_edata_v<EDATA_T>) {
+      if (compressed_csr_ != nullptr) {
+        for (auto& e : compressed_csr_->get_edges(v)) {
+          begin = std::lower_bound(begin, end, e.get_neighbor());
+          if (begin == end) {
+            break;
+          }
+          if (*begin == e.get_neighbor()) {
+            func(e.get_neighbor(), e.get_data());
+          }
+        }
+        return;
+      }
+    }
+    const auto& edges = csr_->get_edges(v);
+    auto ptr = edges.end() - 1;
+    auto rend = edges.begin() - 1;
+    while (ptr != rend) {
+      if (ptr->timestamp > timestamp_) {
+        --ptr;
+        continue;
+      }
+      if (ptr->timestamp < unsorted_since_) {
+        break;
+      }
+      if (std::binary_search(begin, end, ptr->neighbor)) {
+        func(ptr->neighbor, ptr->data);
+      }
+      --ptr;
+    }
+    sorted_intersect(
+        edges.begin(), ptr + 1, begin, end,
+        [](const MutableNbr<EDATA_T>& e) { return e.neighbor; },
+        [](vid_t u) { return u; },
+        [&](const MutableNbr<EDATA_T>* e, const vid_t*) {
+          func(e->neighbor, e->data);
+        });
+  }
+
  private:
   const gs::MutableCsr<EDATA_T>* csr_;
+  const gs::CompressedImmutableCsr<EDATA_T>* compressed_csr_;
   timestamp_t timestamp_;
   timestamp_t unsorted_since_;
 };
@@ -287,7 +626,7 @@ class VertexColumn {
     } else if (col_id == static_cast<int>(ColState::kInvalidColId)) {
       return PROP_T();
     } else {
-      return AnyConverter<PROP_T>::from_any(
+      return graph_interface_impl::convert_property<PROP_T>(
           txn_->GetVertexField(label_, v, col_id));
     }
   }
@@ -324,11 +663,29 @@ class GraphReadInterface {
   GraphReadInterface(const gs::ReadTransaction& txn) : txn_(txn) {}
   ~GraphReadInterface() {}
 
+  // The column of a property other than the primary key is read through
+  // ColumnBase::get() if it is not of type PROP_T, see VertexColumn. The
+  // versions the transaction sees were all added when it started, so they
+  // are looked up only if there were any when the column is taken.
   template <typename PROP_T>
   inline vertex_column_t<PROP_T> GetVertexColumn(
       label_t label, const std::string& prop_name) const {
-    return vertex_column_t<PROP_T>(
-        txn_.get_vertex_ref_property_column<PROP_T>(label, prop_name));
+    auto column = txn_.get_vertex_property_column(label, prop_name);
+    vertex_column_t<PROP_T> ret =
+        column != nullptr && column->type() != AnyConverter<PROP_T>::type()
+            ? vertex_column_t<PROP_T>(column)
+            : vertex_column_t<PROP_T>(
+                  txn_.get_vertex_ref_property_column<PROP_T>(label,
+                                                              prop_name));
+    const auto& versions = txn_.graph().vertex_property_versions();
+    if (column != nullptr && versions.version_num() != 0) {
+      ret.set_versions(
+          &versions, label,
+          txn_.graph().get_vertex_table(label).get_column_id_by_name(
+              prop_name),
+          txn_.timestamp());
+    }
+    return ret;
   }
 
   inline vertex_set_t GetVertexSet(label_t label) const {
@@ -339,12 +696,92 @@ class GraphReadInterface {
     return txn_.GetVertexIndex(label, id, index);
   }
 
+  // Looks up ids[0, num) at once, setting index[i] to the vertex of ids[i],
+  // or to the max of vid_t if there is none. The ids are int64_t or
+  // std::string_view, of the type of the primary key.
+  template <typename KEY_T>
+  inline void GetVertexIndexBatch(label_t label, const KEY_T* ids, size_t num,
+                                  vid_t* index) const {
+    txn_.graph().get_lid_batch(label, ids, num, index);
+  }
+
   inline Any GetVertexId(label_t label, vid_t index) const {
     return txn_.GetVertexId(label, index);
   }
 
   inline Any GetVertexProperty(label_t label, vid_t index, int prop_id) const {
-    return txn_.graph().get_vertex_table(label).at(index, prop_id);
+    return txn_.GetVertexField(label, index, prop_id);
+  }
+
+  // The range index on the property, null if it has none. Its entries are
+  // candidates as those of LookupSecondaryIndex, of vertices yet to be
+  // checked to be visible.
+  inline const RangeIndex* GetRangeIndex(label_t label, int prop_id) const {
+    return txn_.graph().get_range_index(label, prop_id);
+  }
+
+  // The text index on the property, null if it has none. Its lookups
+  // return candidates as those of GetRangeIndex.
+  inline const TextIndex* GetTextIndex(label_t label, int prop_id) const {
+    return txn_.graph().get_text_index(label, prop_id);
+  }
+
+  // Sets entries to the k visible vertices nearest to the query by the
+  // embeddings of the property, with their distances, in ascending order of
+  // distance, or returns false if the property has no vector index. The
+  // candidates of the index are checked against the values this read sees.
+  inline bool SearchVectorIndex(
+      label_t label, int prop_id, const std::vector<float>& query, size_t k,
+      std::vector<std::pair<float, vid_t>>& entries) const {
+    const auto* index = txn_.graph().get_vector_index(label, prop_id);
+    entries.clear();
+    if (index == nullptr) {
+      return false;
+    }
+    // Stale and invisible candidates are dropped, so more are searched for.
+    size_t num = 2 * k + index->stale_num();
+    std::vector<std::pair<float, vid_t>> candidates;
+    index->search(query, num, std::max<size_t>(num, 64), candidates);
+    vid_t vnum = txn_.GetVertexNum(label);
+    std::vector<float> embedding;
+    for (auto& [dist, vid] : candidates) {
+      if (vid >= vnum) {
+        continue;
+      }
+      if (!VectorIndex::parse(
+              GetVertexProperty(label, vid, prop_id).AsStringView(),
+              embedding) ||
+          embedding.size() != query.size()) {
+        continue;
+      }
+      entries.emplace_back(
+          VectorIndex::distance(query.data(), embedding.data(), query.size()),
+          vid);
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    if (entries.size() > k) {
+      entries.resize(k);
+    }
+    return true;
+  }
+
+  // Sets vids to the visible vertices the secondary index on the property
+  // lists for the value, in ascending order, or returns false if the
+  // property has no index. The vertices are candidates: each of them is yet
+  // to be checked to have the value.
+  inline bool LookupSecondaryIndex(label_t label, int prop_id,
+                                   const Any& value,
+                                   std::vector<vid_t>& vids) const {
+    const auto* index = txn_.graph().get_secondary_index(label, prop_id);
+    vids.clear();
+    if (index == nullptr) {
+      return false;
+    }
+    index->lookup(value, vids);
+    vid_t vnum = txn_.GetVertexNum(label);
+    vids.erase(std::lower_bound(vids.begin(), vids.end(), vnum), vids.end());
+    return true;
   }
 
   inline edge_iterator_t GetOutEdgeIterator(label_t label, vid_t v,
@@ -361,22 +798,42 @@ class GraphReadInterface {
         txn_.GetInEdgeIterator(label, v, neighbor_label, edge_label));
   }
 
+  inline bool MayHaveEdge(label_t src_label, vid_t src, label_t dst_label,
+                          vid_t dst, label_t edge_label) const {
+    return txn_.MayHaveEdge(src_label, src, dst_label, dst, edge_label);
+  }
+
+  // The numbers of edges of v in the triplet, counting the ones inserted after
+  // the timestamp of the transaction, e.g. to estimate the cost of expanding
+  // it. 0 if the triplet has no edges in the direction.
+  inline size_t GetOutDegree(label_t label, vid_t v, label_t neighbor_label,
+                             label_t edge_label) const {
+    const auto* csr =
+        txn_.graph().get_oe_csr(label, neighbor_label, edge_label);
+    return csr == nullptr ? 0 : csr->edge_iter(v)->size();
+  }
+
+  inline size_t GetInDegree(label_t label, vid_t v, label_t neighbor_label,
+                            label_t edge_label) const {
+    const auto* csr =
+        txn_.graph().get_ie_csr(label, neighbor_label, edge_label);
+    return csr == nullptr ? 0 : csr->edge_iter(v)->size();
+  }
+
   template <typename EDATA_T>
   inline graph_view_t<EDATA_T> GetOutgoingGraphView(label_t v_label,
                                                     label_t neighbor_label,
                                                     label_t edge_label) const {
-    auto csr = dynamic_cast<const MutableCsr<EDATA_T>*>(
+    return graphViewOf<EDATA_T>(
         txn_.graph().get_oe_csr(v_label, neighbor_label, edge_label));
-    return graph_view_t<EDATA_T>(csr, txn_.timestamp());
   }
 
   template <typename EDATA_T>
   inline graph_view_t<EDATA_T> GetIncomingGraphView(label_t v_label,
                                                     label_t neighbor_label,
                                                     label_t edge_label) const {
-    auto csr = dynamic_cast<const MutableCsr<EDATA_T>*>(
+    return graphViewOf<EDATA_T>(
         txn_.graph().get_ie_csr(v_label, neighbor_label, edge_label));
-    return graph_view_t<EDATA_T>(csr, txn_.timestamp());
   }
 
   inline const Schema& schema() const { return txn_.schema(); }
@@ -384,9 +841,41 @@ class GraphReadInterface {
   const GraphDBSession& GetSession() const { return txn_.GetSession(); }
 
  private:
+  // A view of a multiple-edge csr, mutable or compressed. The view is null
+  // if there is no such csr of edge data EDATA_T.
+  template <typename EDATA_T>
+  inline graph_view_t<EDATA_T> graphViewOf(const CsrBase* csr) const {
+    if (auto casted = dynamic_cast<const MutableCsr<EDATA_T>*>(csr)) {
+      return graph_view_t<EDATA_T>(casted, txn_.timestamp());
+    }
+    if constexpr (graph_interface_impl::is_compressible_edata_v<EDATA_T>) {
+      if (auto casted =
+              dynamic_cast<const CompressedImmutableCsr<EDATA_T>*>(csr)) {
+        return graph_view_t<EDATA_T>(casted, txn_.timestamp());
+      }
+    }
+    return graph_view_t<EDATA_T>();
+  }
+
   const gs::ReadTransaction& txn_;
 };
 
+// The property of edge i of a batch as AddEdge takes it: none, the value of
+// the only property, or a record of the values of all the properties.
+inline Any edge_batch_property(
+    const std::vector<std::vector<Any>>& prop_columns, size_t i) {
+  if (prop_columns.empty()) {
+    return Any();
+  } else if (prop_columns.size() == 1) {
+    return prop_columns[0][i];
+  }
+  std::vector<Any> props;
+  for (const auto& column : prop_columns) {
+    props.push_back(column[i]);
+  }
+  return Any::From(Record(props));
+}
+
 class GraphInsertInterface {
  public:
   GraphInsertInterface(gs::InsertTransaction& txn) : txn_(txn) {}
@@ -402,6 +891,22 @@ class GraphInsertInterface {
     return txn_.AddEdge(src_label, src, dst_label, dst, edge_label, prop);
   }
 
+  // Adds the edges from srcs[i] to dsts[i] in a single log entry, or one by
+  // one if the batch is rejected, so that only the edges AddEdge rejects are
+  // left out.
+  inline void AddEdges(label_t src_label, label_t dst_label,
+                       label_t edge_label, const std::vector<Any>& srcs,
+                       const std::vector<Any>& dsts,
+                       const std::vector<std::vector<Any>>& prop_columns) {
+    if (!txn_.AddEdges(src_label, dst_label, edge_label, srcs, dsts,
+                       prop_columns)) {
+      for (size_t i = 0; i < srcs.size(); ++i) {
+        txn_.AddEdge(src_label, srcs[i], dst_label, dsts[i], edge_label,
+                     edge_batch_property(prop_columns, i));
+      }
+    }
+  }
+
   inline bool Commit() { return txn_.Commit(); }
 
   inline void Abort() { txn_.Abort(); }
@@ -449,6 +954,12 @@ class GraphUpdateInterface {
     txn_.SetVertexField(label, lid, col_id, value);
   }
 
+  inline bool SetVertexFields(label_t label, int col_id,
+                              const std::vector<vid_t>& lids,
+                              const std::vector<Any>& values) {
+    return txn_.SetVertexFields(label, col_id, lids, values);
+  }
+
   inline void SetEdgeData(bool dir, label_t label, vid_t v,
                           label_t neighbor_label, vid_t nbr, label_t edge_label,
                           const Any& value) {
@@ -472,6 +983,18 @@ class GraphUpdateInterface {
     return txn_.AddEdge(src_label, src, dst_label, dst, edge_label, prop);
   }
 
+  // Adds the edges from srcs[i] to dsts[i] one by one, leaving out those
+  // AddEdge rejects.
+  inline void AddEdges(label_t src_label, label_t dst_label,
+                       label_t edge_label, const std::vector<Any>& srcs,
+                       const std::vector<Any>& dsts,
+                       const std::vector<std::vector<Any>>& prop_columns) {
+    for (size_t i = 0; i < srcs.size(); ++i) {
+      txn_.AddEdge(src_label, srcs[i], dst_label, dsts[i], edge_label,
+                   edge_batch_property(prop_columns, i));
+    }
+  }
+
   inline bool Commit() { return txn_.Commit(); }
 
   inline void Abort() { txn_.Abort(); }
@@ -14,11 +14,54 @@
  */
 
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/dedup.h"
+#include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
+#include "flex/engines/graph_db/runtime/common/utils/bitset.h"
 
 namespace gs {
 
 namespace runtime {
 
+// Keeps the first row of every vertex with one bit test per row, on bitsets
+// per label kept by the thread and cleared before returning, so that they
+// are reused by the next queries. The first null row, if any, is kept last.
+static void dedup_vertex_offsets(const IVertexColumn& col,
+                                 std::vector<size_t>& offsets) {
+  static thread_local std::vector<std::unique_ptr<Bitset>> bitsets;
+  offsets.clear();
+  bool has_null = false;
+  size_t null_idx = 0;
+  foreach_vertex(col, [&](size_t idx, label_t label, vid_t v) {
+    if (v == std::numeric_limits<vid_t>::max()) {
+      if (!has_null) {
+        has_null = true;
+        null_idx = idx;
+      }
+      return;
+    }
+    if (label >= bitsets.size()) {
+      bitsets.resize(label + 1);
+    }
+    if (bitsets[label] == nullptr) {
+      bitsets[label] = std::make_unique<Bitset>();
+    }
+    Bitset& bitset = *bitsets[label];
+    if (v >= bitset.size()) {
+      bitset.resize(std::max<size_t>(v + 1, bitset.size() * 2));
+    }
+    if (!bitset.get(v)) {
+      bitset.set(v);
+      offsets.push_back(idx);
+    }
+  });
+  for (size_t idx : offsets) {
+    auto vertex = col.get_vertex(idx);
+    bitsets[vertex.label_]->reset(vertex.vid_);
+  }
+  if (has_null) {
+    offsets.push_back(null_idx);
+  }
+}
+
 bl::result<Context> Dedup::dedup(Context&& ctx,
                                  const std::vector<size_t>& cols) {
   size_t row_num = ctx.row_num();
@@ -26,7 +69,13 @@ bl::result<Context> Dedup::dedup(Context&& ctx,
   if (cols.size() == 0) {
     return ctx;
   } else if (cols.size() == 1) {
-    ctx.get(cols[0])->generate_dedup_offset(offsets);
+    auto col = ctx.get(cols[0]);
+    if (col->column_type() == ContextColumnType::kVertex) {
+      dedup_vertex_offsets(*std::dynamic_pointer_cast<IVertexColumn>(col),
+                           offsets);
+    } else {
+      col->generate_dedup_offset(offsets);
+    }
   } else if (cols.size() == 2) {
     ISigColumn* sig0 = ctx.get(cols[0])->generate_signature();
     ISigColumn* sig1 = ctx.get(cols[1])->generate_signature();
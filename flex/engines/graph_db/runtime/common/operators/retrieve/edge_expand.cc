@@ -16,6 +16,7 @@
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/edge_expand.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/edge_expand_impl.h"
 #include "flex/engines/graph_db/runtime/utils/opr_timer.h"
+#include "flex/utils/top_n_generator.h"
 
 namespace gs {
 
@@ -598,6 +599,138 @@ bl::result<Context> EdgeExpand::expand_vertex_without_predicate(
   }
 }
 
+static bool is_countable_edge_type(const PropertyType& type) {
+  return type == PropertyType::Int32() || type == PropertyType::Int64() ||
+         type == PropertyType::Double() || type == PropertyType::Date();
+}
+
+bool EdgeExpand::can_count_edges(const Schema& schema,
+                                 const std::vector<LabelTriplet>& labels,
+                                 Direction dir) {
+  for (auto& triplet : labels) {
+    if (!schema.exist(triplet.src_label, triplet.dst_label,
+                      triplet.edge_label)) {
+      continue;
+    }
+    const auto& properties = schema.get_edge_properties(
+        triplet.src_label, triplet.dst_label, triplet.edge_label);
+    if (properties.size() > 1 ||
+        (properties.size() == 1 && !is_countable_edge_type(properties[0]))) {
+      return false;
+    }
+    if ((dir == Direction::kOut || dir == Direction::kBoth) &&
+        schema.get_outgoing_edge_strategy(triplet.src_label, triplet.dst_label,
+                                          triplet.edge_label) !=
+            EdgeStrategy::kMultiple) {
+      return false;
+    }
+    if ((dir == Direction::kIn || dir == Direction::kBoth) &&
+        schema.get_incoming_edge_strategy(triplet.src_label, triplet.dst_label,
+                                          triplet.edge_label) !=
+            EdgeStrategy::kMultiple) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename EDATA_T>
+static void count_edges_impl(const GraphReadInterface& graph, label_t label,
+                             label_t nbr_label, label_t edge_label,
+                             Direction dir, const std::vector<vid_t>& vertices,
+                             const std::vector<size_t>& rows,
+                             std::vector<size_t>& counts) {
+  auto view =
+      dir == Direction::kOut
+          ? graph.GetOutgoingGraphView<EDATA_T>(label, nbr_label, edge_label)
+          : graph.GetIncomingGraphView<EDATA_T>(label, nbr_label, edge_label);
+  view.foreach_prefetched(vertices, [&](size_t idx, vid_t v) {
+    auto es = view.get_edges(v);
+    size_t num = 0;
+    for (auto it = es.begin(); it != es.end(); ++it) {
+      ++num;
+    }
+    counts[rows[idx]] += num;
+  });
+}
+
+bl::result<std::vector<size_t>> EdgeExpand::count_edges(
+    const GraphReadInterface& graph, const Context& ctx,
+    const EdgeExpandParams& params) {
+  auto input = std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.v_tag));
+  if (input == nullptr) {
+    LOG(ERROR) << "expand input is not a vertex column";
+    RETURN_UNSUPPORTED_ERROR("expand input is not a vertex column");
+  }
+  // The input is counted a label at a time, so that the edges of each label
+  // are walked in one typed view.
+  size_t label_num = graph.schema().vertex_label_num();
+  std::vector<std::vector<vid_t>> vertices(label_num);
+  std::vector<std::vector<size_t>> rows(label_num);
+  for (size_t i = 0; i < input->size(); ++i) {
+    auto v = input->get_vertex(i);
+    if (v.vid_ != GraphReadInterface::kInvalidVid) {
+      vertices[v.label_].push_back(v.vid_);
+      rows[v.label_].push_back(i);
+    }
+  }
+  std::vector<size_t> counts(input->size(), 0);
+  for (label_t label = 0; label < label_num; ++label) {
+    if (vertices[label].empty()) {
+      continue;
+    }
+    std::vector<LabelTriplet> triplets;
+    std::vector<Direction> dirs;
+    for (auto& triplet : params.labels) {
+      if (!graph.schema().exist(triplet.src_label, triplet.dst_label,
+                                triplet.edge_label)) {
+        continue;
+      }
+      if (triplet.src_label == label && (params.dir == Direction::kOut ||
+                                         params.dir == Direction::kBoth)) {
+        triplets.push_back(triplet);
+        dirs.push_back(Direction::kOut);
+      }
+      if (triplet.dst_label == label &&
+          (params.dir == Direction::kIn || params.dir == Direction::kBoth)) {
+        triplets.push_back(triplet);
+        dirs.push_back(Direction::kIn);
+      }
+    }
+    for (size_t k = 0; k < triplets.size(); ++k) {
+      const auto& triplet = triplets[k];
+      Direction dir = dirs[k];
+      label_t nbr_label =
+          dir == Direction::kOut ? triplet.dst_label : triplet.src_label;
+      const auto& properties = graph.schema().get_edge_properties(
+          triplet.src_label, triplet.dst_label, triplet.edge_label);
+      if (properties.empty()) {
+        count_edges_impl<grape::EmptyType>(graph, label, nbr_label,
+                                           triplet.edge_label, dir,
+                                           vertices[label], rows[label],
+                                           counts);
+      } else if (properties[0] == PropertyType::Int32()) {
+        count_edges_impl<int32_t>(graph, label, nbr_label, triplet.edge_label,
+                                  dir, vertices[label], rows[label], counts);
+      } else if (properties[0] == PropertyType::Int64()) {
+        count_edges_impl<int64_t>(graph, label, nbr_label, triplet.edge_label,
+                                  dir, vertices[label], rows[label], counts);
+      } else if (properties[0] == PropertyType::Double()) {
+        count_edges_impl<double>(graph, label, nbr_label, triplet.edge_label,
+                                 dir, vertices[label], rows[label], counts);
+      } else if (properties[0] == PropertyType::Date()) {
+        count_edges_impl<Date>(graph, label, nbr_label, triplet.edge_label,
+                               dir, vertices[label], rows[label], counts);
+      } else {
+        LOG(ERROR) << "not support counting edges of type " << properties[0];
+        RETURN_UNSUPPORTED_ERROR("not support counting edges of type " +
+                                 properties[0].ToString());
+      }
+    }
+  }
+  return counts;
+}
+
 template <typename T>
 static bl::result<Context> _expand_edge_with_special_edge_predicate(
     const GraphReadInterface& graph, Context&& ctx,
@@ -991,6 +1124,110 @@ bl::result<Context> EdgeExpand::expand_vertex_ep_gt(
   }
 }
 
+template <typename T>
+static Context expand_vertex_ep_between_impl(
+    const GraphReadInterface& graph, Context&& ctx,
+    const std::vector<std::tuple<label_t, label_t, Direction>>& label_dirs,
+    label_t input_label, const std::string& from_val,
+    const std::string& to_val, const SLVertexColumn& input, int alias) {
+  T min_value = TypedConverter<T>::typed_from_string(from_val);
+  T max_value = TypedConverter<T>::typed_from_string(to_val);
+  auto builder = MSVertexColumnBuilder::builder();
+  std::vector<size_t> offsets;
+  for (auto& t : label_dirs) {
+    label_t nbr_label = std::get<0>(t);
+    label_t edge_label = std::get<1>(t);
+    auto csr = std::get<2>(t) == Direction::kOut
+                   ? graph.GetOutgoingGraphView<T>(input_label, nbr_label,
+                                                   edge_label)
+                   : graph.GetIncomingGraphView<T>(input_label, nbr_label,
+                                                   edge_label);
+    builder.start_label(nbr_label);
+    size_t idx = 0;
+    for (auto v : input.vertices()) {
+      csr.foreach_edges_between(v, min_value, max_value,
+                                [&](vid_t nbr, const T&) {
+                                  builder.push_back_opt(nbr);
+                                  offsets.push_back(idx);
+                                });
+      ++idx;
+    }
+  }
+  std::shared_ptr<IContextColumn> col = builder.finish(nullptr);
+  ctx.set_with_reshuffle(alias, col, offsets);
+  return ctx;
+}
+
+bl::result<Context> EdgeExpand::expand_vertex_ep_between(
+    const GraphReadInterface& graph, Context&& ctx,
+    const EdgeExpandParams& params, const std::string& from_val,
+    const std::string& to_val) {
+  if (params.is_optional) {
+    RETURN_UNSUPPORTED_ERROR("not support optional edge expand");
+  }
+  auto input = std::dynamic_pointer_cast<SLVertexColumn>(ctx.get(params.v_tag));
+  if (input == nullptr) {
+    RETURN_UNSUPPORTED_ERROR("not support vertex column type");
+  }
+  const auto& schema = graph.schema();
+  label_t input_label = input->label();
+  std::vector<std::tuple<label_t, label_t, Direction>> label_dirs;
+  std::vector<PropertyType> ed_types;
+  for (auto& triplet : params.labels) {
+    if (!schema.exist(triplet.src_label, triplet.dst_label,
+                      triplet.edge_label)) {
+      continue;
+    }
+    bool out = triplet.src_label == input_label &&
+               params.dir != Direction::kIn;
+    bool in = triplet.dst_label == input_label &&
+              params.dir != Direction::kOut;
+    if (!out && !in) {
+      continue;
+    }
+    const auto& properties = schema.get_edge_properties(
+        triplet.src_label, triplet.dst_label, triplet.edge_label);
+    if (properties.size() != 1 ||
+        !schema.get_sort_on_compaction(
+            schema.get_vertex_label_name(triplet.src_label),
+            schema.get_vertex_label_name(triplet.dst_label),
+            schema.get_edge_label_name(triplet.edge_label))) {
+      RETURN_UNSUPPORTED_ERROR("edges are not sorted by edge data");
+    }
+    if (out) {
+      label_dirs.emplace_back(triplet.dst_label, triplet.edge_label,
+                              Direction::kOut);
+      ed_types.push_back(properties[0]);
+    }
+    if (in) {
+      label_dirs.emplace_back(triplet.src_label, triplet.edge_label,
+                              Direction::kIn);
+      ed_types.push_back(properties[0]);
+    }
+  }
+  if (ed_types.empty()) {
+    RETURN_UNSUPPORTED_ERROR("no edge to expand");
+  }
+  for (auto& type : ed_types) {
+    if (type != ed_types[0]) {
+      RETURN_UNSUPPORTED_ERROR("not support multiple edge types");
+    }
+  }
+  grape::DistinctSort(label_dirs);
+  if (ed_types[0] == PropertyType::Date()) {
+    return expand_vertex_ep_between_impl<Date>(graph, std::move(ctx),
+                                               label_dirs, input_label,
+                                               from_val, to_val, *input,
+                                               params.alias);
+  } else if (ed_types[0] == PropertyType::Int64()) {
+    return expand_vertex_ep_between_impl<int64_t>(graph, std::move(ctx),
+                                                  label_dirs, input_label,
+                                                  from_val, to_val, *input,
+                                                  params.alias);
+  }
+  RETURN_UNSUPPORTED_ERROR("not support edge type " + ed_types[0].ToString());
+}
+
 template <typename T>
 static bl::result<Context> _expand_vertex_with_special_vertex_predicate(
     const GraphReadInterface& graph, Context&& ctx,
@@ -1047,6 +1284,13 @@ bl::result<Context> EdgeExpand::expand_vertex_with_special_vertex_predicate(
     RETURN_UNSUPPORTED_ERROR("not support optional edge expand");
   }
 
+  if (pred.type() == SPPredicateType::kPropertyConjunction) {
+    return EdgeExpand::expand_vertex<
+        EdgeExpand::SPVPWrapper<VertexPropertyConjunctionPredicate>>(
+        graph, std::move(ctx), params,
+        EdgeExpand::SPVPWrapper(
+            dynamic_cast<const VertexPropertyConjunctionPredicate&>(pred)));
+  }
   if (pred.data_type() == RTAnyType::kI64Value) {
     return _expand_vertex_with_special_vertex_predicate<int64_t>(
         graph, std::move(ctx), params, pred);
@@ -1072,6 +1316,247 @@ bl::result<Context> EdgeExpand::expand_vertex_with_special_vertex_predicate(
                            std::to_string(static_cast<int>(pred.data_type())));
 }
 
+template <typename T, typename CMP_T>
+static Context expand_top_k_by_vertex_impl(
+    const GraphReadInterface& graph, Context&& ctx,
+    const EdgeExpandParams& params, const SLVertexColumn& input,
+    label_t nbr_label, const GraphReadInterface::vertex_column_t<T>& prop,
+    size_t limit) {
+  label_t edge_label = params.labels[0].edge_label;
+  TopNGenerator<T, CMP_T> gen(limit);
+  std::vector<size_t> rows;
+  std::vector<vid_t> nbrs;
+  auto visit = [&](size_t idx, vid_t nbr) {
+    auto val = prop.get_view(nbr);
+    if (gen.admits(val)) {
+      gen.push(val, rows.size());
+      rows.push_back(idx);
+      nbrs.push_back(nbr);
+    }
+  };
+  size_t idx = 0;
+  for (auto v : input.vertices()) {
+    if (params.dir == Direction::kOut) {
+      for (auto it = graph.GetOutEdgeIterator(input.label(), v, nbr_label,
+                                              edge_label);
+           it.IsValid(); it.Next()) {
+        visit(idx, it.GetNeighbor());
+      }
+    } else {
+      for (auto it = graph.GetInEdgeIterator(input.label(), v, nbr_label,
+                                             edge_label);
+           it.IsValid(); it.Next()) {
+        visit(idx, it.GetNeighbor());
+      }
+    }
+    ++idx;
+  }
+  std::vector<size_t> kept;
+  gen.generate_indices(kept);
+  std::sort(kept.begin(), kept.end());
+  auto builder = SLVertexColumnBuilder::builder(nbr_label);
+  std::vector<size_t> offsets;
+  builder.reserve(kept.size());
+  offsets.reserve(kept.size());
+  for (auto k : kept) {
+    builder.push_back_opt(nbrs[k]);
+    offsets.push_back(rows[k]);
+  }
+  ctx.set_with_reshuffle(params.alias, builder.finish(nullptr), offsets);
+  return ctx;
+}
+
+template <typename T, typename CMP_T>
+static Context expand_top_k_by_edge_impl(
+    const GraphReadInterface& graph, Context&& ctx,
+    const EdgeExpandParams& params, const SLVertexColumn& input,
+    const GraphReadInterface::graph_view_t<T>& view, bool sorted, bool asc,
+    const PropertyType& prop_type, size_t limit) {
+  TopNGenerator<T, CMP_T> gen(limit);
+  std::vector<size_t> rows;
+  std::vector<vid_t> nbrs;
+  std::vector<T> data;
+  size_t idx = 0;
+  auto visit = [&](vid_t nbr, const T& val) {
+    if (!gen.admits(val)) {
+      return false;
+    }
+    gen.push(val, rows.size());
+    rows.push_back(idx);
+    nbrs.push_back(nbr);
+    data.push_back(val);
+    return true;
+  };
+  const auto& vertices = input.vertices();
+  for (; idx < vertices.size(); ++idx) {
+    if (sorted) {
+      view.foreach_edges_ordered(vertices[idx], asc, visit);
+    } else {
+      for (auto& e : view.get_edges(vertices[idx])) {
+        visit(e.get_neighbor(), e.get_data());
+      }
+    }
+  }
+  std::vector<size_t> kept;
+  gen.generate_indices(kept);
+  std::sort(kept.begin(), kept.end());
+  SDSLEdgeColumnBuilderBeta<T> builder(params.dir, params.labels[0],
+                                       prop_type);
+  std::vector<size_t> offsets;
+  builder.reserve(kept.size());
+  offsets.reserve(kept.size());
+  for (auto k : kept) {
+    vid_t v = vertices[rows[k]];
+    if (params.dir == Direction::kOut) {
+      builder.push_back_opt(v, nbrs[k], data[k]);
+    } else {
+      builder.push_back_opt(nbrs[k], v, data[k]);
+    }
+    offsets.push_back(rows[k]);
+  }
+  ctx.set_with_reshuffle(params.alias, builder.finish(nullptr), offsets);
+  return ctx;
+}
+
+template <typename T>
+static bl::result<Context> expand_top_k_by_vertex(
+    const GraphReadInterface& graph, Context&& ctx,
+    const EdgeExpandParams& params, const SLVertexColumn& input,
+    label_t nbr_label, const std::string& prop_name, bool asc,
+    size_t limit) {
+  auto prop = graph.GetVertexColumn<T>(nbr_label, prop_name);
+  if (prop.is_null()) {
+    RETURN_UNSUPPORTED_ERROR("property not found: " + prop_name);
+  }
+  if (asc) {
+    return expand_top_k_by_vertex_impl<T, TopNAscCmp<T>>(
+        graph, std::move(ctx), params, input, nbr_label, prop, limit);
+  } else {
+    return expand_top_k_by_vertex_impl<T, TopNDescCmp<T>>(
+        graph, std::move(ctx), params, input, nbr_label, prop, limit);
+  }
+}
+
+template <typename T>
+static bl::result<Context> expand_top_k_by_edge(
+    const GraphReadInterface& graph, Context&& ctx,
+    const EdgeExpandParams& params, const SLVertexColumn& input,
+    label_t nbr_label, const PropertyType& prop_type, bool asc,
+    size_t limit) {
+  const auto& triplet = params.labels[0];
+  auto view = params.dir == Direction::kOut
+                  ? graph.GetOutgoingGraphView<T>(input.label(), nbr_label,
+                                                  triplet.edge_label)
+                  : graph.GetIncomingGraphView<T>(input.label(), nbr_label,
+                                                  triplet.edge_label);
+  if (view.is_null()) {
+    RETURN_UNSUPPORTED_ERROR("edges are not in a mutable csr");
+  }
+  const auto& schema = graph.schema();
+  bool sorted = schema.get_sort_on_compaction(
+      schema.get_vertex_label_name(triplet.src_label),
+      schema.get_vertex_label_name(triplet.dst_label),
+      schema.get_edge_label_name(triplet.edge_label));
+  if (asc) {
+    return expand_top_k_by_edge_impl<T, TopNAscCmp<T>>(
+        graph, std::move(ctx), params, input, view, sorted, asc, prop_type,
+        limit);
+  } else {
+    return expand_top_k_by_edge_impl<T, TopNDescCmp<T>>(
+        graph, std::move(ctx), params, input, view, sorted, asc, prop_type,
+        limit);
+  }
+}
+
+bl::result<Context> EdgeExpand::expand_top_k(const GraphReadInterface& graph,
+                                              Context&& ctx,
+                                              const EdgeExpandParams& params,
+                                              bool expand_edge,
+                                              const std::string& prop_name,
+                                              bool asc, size_t limit) {
+  if (params.is_optional || params.labels.size() != 1 ||
+      params.dir == Direction::kBoth || limit == 0) {
+    RETURN_UNSUPPORTED_ERROR("not support top k edge expand");
+  }
+  auto col = ctx.get(params.v_tag);
+  if (col == nullptr || col->column_type() != ContextColumnType::kVertex ||
+      col->is_optional()) {
+    RETURN_UNSUPPORTED_ERROR("not support top k edge expand");
+  }
+  auto vertex_col = std::dynamic_pointer_cast<IVertexColumn>(col);
+  const auto& triplet = params.labels[0];
+  label_t input_label = params.dir == Direction::kOut ? triplet.src_label
+                                                      : triplet.dst_label;
+  label_t nbr_label = params.dir == Direction::kOut ? triplet.dst_label
+                                                    : triplet.src_label;
+  if (vertex_col->vertex_column_type() != VertexColumnType::kSingle ||
+      *vertex_col->get_labels_set().begin() != input_label) {
+    RETURN_UNSUPPORTED_ERROR("not support top k edge expand");
+  }
+  const auto& input = *std::dynamic_pointer_cast<SLVertexColumn>(vertex_col);
+  const auto& schema = graph.schema();
+
+  PropertyType prop_type = PropertyType::Empty();
+  if (expand_edge) {
+    const auto& names = schema.get_edge_property_names(
+        triplet.src_label, triplet.dst_label, triplet.edge_label);
+    if (names.size() != 1 || names[0] != prop_name) {
+      RETURN_UNSUPPORTED_ERROR("not support top k by edge property");
+    }
+    prop_type = schema.get_edge_properties(
+        triplet.src_label, triplet.dst_label, triplet.edge_label)[0];
+    if (prop_type == PropertyType::Date()) {
+      return expand_top_k_by_edge<Date>(graph, std::move(ctx), params, input,
+                                        nbr_label, prop_type, asc, limit);
+    } else if (prop_type == PropertyType::Int64()) {
+      return expand_top_k_by_edge<int64_t>(graph, std::move(ctx), params,
+                                           input, nbr_label, prop_type, asc,
+                                           limit);
+    } else if (prop_type == PropertyType::Int32()) {
+      return expand_top_k_by_edge<int32_t>(graph, std::move(ctx), params,
+                                           input, nbr_label, prop_type, asc,
+                                           limit);
+    } else if (prop_type == PropertyType::Double()) {
+      return expand_top_k_by_edge<double>(graph, std::move(ctx), params,
+                                          input, nbr_label, prop_type, asc,
+                                          limit);
+    }
+    RETURN_UNSUPPORTED_ERROR("not support top k by edge property type");
+  }
+
+  const auto& names = schema.get_vertex_property_names(nbr_label);
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (names[i] == prop_name) {
+      prop_type = schema.get_vertex_properties(nbr_label)[i];
+      break;
+    }
+  }
+  if (prop_type == PropertyType::Date()) {
+    return expand_top_k_by_vertex<Date>(graph, std::move(ctx), params, input,
+                                        nbr_label, prop_name, asc, limit);
+  } else if (prop_type == PropertyType::Day()) {
+    return expand_top_k_by_vertex<Day>(graph, std::move(ctx), params, input,
+                                       nbr_label, prop_name, asc, limit);
+  } else if (prop_type == PropertyType::Int64()) {
+    return expand_top_k_by_vertex<int64_t>(graph, std::move(ctx), params,
+                                           input, nbr_label, prop_name, asc,
+                                           limit);
+  } else if (prop_type == PropertyType::Int32()) {
+    return expand_top_k_by_vertex<int32_t>(graph, std::move(ctx), params,
+                                           input, nbr_label, prop_name, asc,
+                                           limit);
+  } else if (prop_type == PropertyType::Double()) {
+    return expand_top_k_by_vertex<double>(graph, std::move(ctx), params,
+                                          input, nbr_label, prop_name, asc,
+                                          limit);
+  } else if (prop_type == PropertyType::String()) {
+    return expand_top_k_by_vertex<std::string_view>(
+        graph, std::move(ctx), params, input, nbr_label, prop_name, asc,
+        limit);
+  }
+  RETURN_UNSUPPORTED_ERROR("not support top k by vertex property type");
+}
+
 }  // namespace runtime
 
 }  // namespace gs
@@ -16,7 +16,10 @@
 #ifndef RUNTIME_COMMON_OPERATORS_RETRIEVE_EDGE_EXPAND_H_
 #define RUNTIME_COMMON_OPERATORS_RETRIEVE_EDGE_EXPAND_H_
 
+#include <algorithm>
 #include <set>
+#include <tuple>
+#include <vector>
 
 #include "flex/engines/graph_db/runtime/common/columns/edge_columns.h"
 #include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
@@ -390,12 +393,153 @@ class EdgeExpand {
     }
   }
 
+  // Expands the vertices of v_tag to the one vertex of label and vid, with
+  // pred checking that the neighbor is it as ExactVertexPredicate does, e.g.
+  // for a pattern bound at both ends by a parameter. The degrees of a sample
+  // of the input vertices are read at the start: if their adjacency lists
+  // hold more edges than the one of the vertex, the edges of the vertex are
+  // scanned in the opposite direction instead and joined with the input, so
+  // that a high degree vertex on either end costs no more than the other end.
+  template <typename PRED_T>
+  static bl::result<Context> expand_vertex_to_exact(
+      const GraphReadInterface& graph, Context&& ctx,
+      const EdgeExpandParams& params, label_t label, vid_t vid,
+      const PRED_T& pred) {
+    static constexpr size_t kSampleNum = 64;
+    if (params.is_optional) {
+      LOG(ERROR) << "not support optional edge expand with predicate";
+      RETURN_UNSUPPORTED_ERROR("not support optional edge expand");
+    }
+    auto input =
+        std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.v_tag));
+    // The triplets and directions of the expansion that reach the vertex.
+    std::vector<std::pair<LabelTriplet, Direction>> sides;
+    for (auto& triplet : params.labels) {
+      if (!graph.schema().exist(triplet.src_label, triplet.dst_label,
+                                triplet.edge_label)) {
+        continue;
+      }
+      if (params.dir != Direction::kIn && triplet.dst_label == label) {
+        sides.emplace_back(triplet, Direction::kOut);
+      }
+      if (params.dir != Direction::kOut && triplet.src_label == label) {
+        sides.emplace_back(triplet, Direction::kIn);
+      }
+    }
+    auto degree = [&](const std::pair<LabelTriplet, Direction>& side,
+                      label_t v_label, vid_t v, bool reverse) -> size_t {
+      const auto& triplet = side.first;
+      bool out = (side.second == Direction::kOut) != reverse;
+      if (out && v_label == triplet.src_label) {
+        return graph.GetOutDegree(v_label, v, triplet.dst_label,
+                                  triplet.edge_label);
+      } else if (!out && v_label == triplet.dst_label) {
+        return graph.GetInDegree(v_label, v, triplet.src_label,
+                                 triplet.edge_label);
+      }
+      return 0;
+    };
+
+    size_t rows = input->size();
+    size_t step = std::max<size_t>(rows / kSampleNum, 1);
+    size_t sampled = 0, sampled_degree = 0, vertex_degree = 0;
+    for (size_t i = 0; i < rows; i += step) {
+      auto v = input->get_vertex(i);
+      for (auto& side : sides) {
+        sampled_degree += degree(side, v.label_, v.vid_, false);
+      }
+      ++sampled;
+    }
+    for (auto& side : sides) {
+      vertex_degree += degree(side, label, vid, true);
+    }
+    double forward_cost =
+        sampled == 0 ? 0 : sampled_degree * 1.0 / sampled * rows;
+    if (forward_cost <= vertex_degree + rows) {
+      return expand_vertex<PRED_T>(graph, std::move(ctx), params, pred);
+    }
+
+    // The edges of the vertex, by the input vertex at their other end.
+    struct Edge {
+      label_t label;
+      vid_t nbr;
+      size_t side;
+      Any data;
+    };
+    std::vector<Edge> edges;
+    edges.reserve(vertex_degree);
+    for (size_t k = 0; k < sides.size(); ++k) {
+      const auto& triplet = sides[k].first;
+      if (sides[k].second == Direction::kOut) {
+        auto iter = graph.GetInEdgeIterator(label, vid, triplet.src_label,
+                                            triplet.edge_label);
+        for (; iter.IsValid(); iter.Next()) {
+          edges.push_back(
+              {triplet.src_label, iter.GetNeighbor(), k, iter.GetData()});
+        }
+      } else {
+        auto iter = graph.GetOutEdgeIterator(label, vid, triplet.dst_label,
+                                             triplet.edge_label);
+        for (; iter.IsValid(); iter.Next()) {
+          edges.push_back(
+              {triplet.dst_label, iter.GetNeighbor(), k, iter.GetData()});
+        }
+      }
+    }
+    auto less = [](const Edge& lhs, const Edge& rhs) {
+      return std::tie(lhs.label, lhs.nbr, lhs.side) <
+             std::tie(rhs.label, rhs.nbr, rhs.side);
+    };
+    std::stable_sort(edges.begin(), edges.end(), less);
+
+    auto builder = SLVertexColumnBuilder::builder(label);
+    std::vector<size_t> offsets;
+    foreach_vertex(*input, [&](size_t index, label_t v_label, vid_t v) {
+      Edge key{v_label, v, 0, Any()};
+      auto iter = std::lower_bound(edges.begin(), edges.end(), key, less);
+      for (; iter != edges.end() && iter->label == v_label && iter->nbr == v;
+           ++iter) {
+        const auto& side = sides[iter->side];
+        bool matched =
+            side.second == Direction::kOut
+                ? pred(side.first, v, vid, iter->data, Direction::kOut, index)
+                : pred(side.first, vid, v, iter->data, Direction::kIn, index);
+        if (matched) {
+          builder.push_back_opt(vid);
+          offsets.push_back(index);
+        }
+      }
+    });
+    ctx.set_with_reshuffle(params.alias, builder.finish(nullptr), offsets);
+    return ctx;
+  }
+
   static bl::result<Context> expand_vertex_ep_lt(
       const GraphReadInterface& graph, Context&& ctx,
       const EdgeExpandParams& params, const std::string& ep_val);
   static bl::result<Context> expand_vertex_ep_gt(
       const GraphReadInterface& graph, Context&& ctx,
       const EdgeExpandParams& params, const std::string& ep_val);
+  // Expands to the neighbors by edges with data in [from_val, to_val), by
+  // binary searching adjacency lists sorted by edge data. Fails if an edge
+  // label is not sorted on compaction, leaving ctx untouched.
+  static bl::result<Context> expand_vertex_ep_between(
+      const GraphReadInterface& graph, Context&& ctx,
+      const EdgeExpandParams& params, const std::string& from_val,
+      const std::string& to_val);
+  // Expands only the rows that may be among the first limit ones ordered by
+  // prop_name, ascending if asc: a property of the neighbors, or the edge
+  // property if expand_edge. The rows are kept in expansion order, the ties
+  // of the last kept key included, for an order by to sort. Edges sorted on
+  // compaction are only visited until their data cannot be kept. Fails if
+  // the expand or the property is not supported, leaving ctx untouched.
+  static bl::result<Context> expand_top_k(const GraphReadInterface& graph,
+                                          Context&& ctx,
+                                          const EdgeExpandParams& params,
+                                          bool expand_edge,
+                                          const std::string& prop_name,
+                                          bool asc, size_t limit);
+
   template <typename PRED_T>
   struct SPVPWrapper {
     SPVPWrapper(const PRED_T& pred) : pred_(pred) {}
@@ -421,6 +565,19 @@ class EdgeExpand {
       const GraphReadInterface& graph, Context&& ctx,
       const EdgeExpandParams& params);
 
+  // Whether count_edges works on the triplets in the direction: their edges
+  // are kept in multiple-edge csrs, with no property or one of a plain type.
+  static bool can_count_edges(const Schema& schema,
+                              const std::vector<LabelTriplet>& labels,
+                              Direction dir);
+
+  // The number of rows expanding each row of the vertex column at
+  // params.v_tag would produce, without building them. Null vertices expand to
+  // none.
+  static bl::result<std::vector<size_t>> count_edges(
+      const GraphReadInterface& graph, const Context& ctx,
+      const EdgeExpandParams& params);
+
   template <typename T1, typename T2, typename T3>
   static bl::result<Context> tc(
       const GraphReadInterface& graph, Context&& ctx,
@@ -460,6 +617,12 @@ class EdgeExpand {
                                                      d2_e_label)
                     : graph.GetIncomingGraphView<T3>(d1_nbr_label, d2_nbr_label,
                                                      d2_e_label);
+    bool csr2_sorted =
+        (dir2 == Direction::kOut)
+            ? graph.schema().get_sort_by_neighbor(d1_nbr_label, d2_nbr_label,
+                                                  d2_e_label)
+            : graph.schema().get_sort_by_neighbor(d2_nbr_label, d1_nbr_label,
+                                                  d2_e_label);
 
     T1 param = TypedConverter<T1>::typed_from_string(val);
 
@@ -484,14 +647,32 @@ class EdgeExpand {
           d0_vec.push_back(u);
         });
       }
-      for (auto& e1 : csr1.get_edges(v)) {
-        auto nbr1 = e1.get_neighbor();
-        for (auto& e2 : csr2.get_edges(nbr1)) {
-          auto nbr2 = e2.get_neighbor();
-          if (d0_set[nbr2]) {
-            builder1.push_back_opt(nbr1);
-            builder2.push_back_opt(nbr2);
-            offsets.push_back(idx);
+      if (csr2_sorted) {
+        // Gallop the sorted adjacency of nbr1 against the sorted d0
+        // neighbors instead of scanning every edge of nbr1.
+        std::sort(d0_vec.begin(), d0_vec.end());
+        d0_vec.erase(std::unique(d0_vec.begin(), d0_vec.end()), d0_vec.end());
+        const vid_t* d0_begin = d0_vec.data();
+        const vid_t* d0_end = d0_begin + d0_vec.size();
+        for (auto& e1 : csr1.get_edges(v)) {
+          auto nbr1 = e1.get_neighbor();
+          csr2.foreach_edges_with_nbr_in(nbr1, d0_begin, d0_end,
+                                         [&](vid_t nbr2, const T3&) {
+                                           builder1.push_back_opt(nbr1);
+                                           builder2.push_back_opt(nbr2);
+                                           offsets.push_back(idx);
+                                         });
+        }
+      } else {
+        for (auto& e1 : csr1.get_edges(v)) {
+          auto nbr1 = e1.get_neighbor();
+          for (auto& e2 : csr2.get_edges(nbr1)) {
+            auto nbr2 = e2.get_neighbor();
+            if (d0_set[nbr2]) {
+              builder1.push_back_opt(nbr1);
+              builder2.push_back_opt(nbr2);
+              offsets.push_back(idx);
+            }
           }
         }
       }
@@ -64,8 +64,7 @@ expand_vertex_on_graph_view(
 
   auto builder = SLVertexColumnBuilder::builder(nbr_label);
   std::vector<size_t> offsets;
-  size_t idx = 0;
-  for (auto v : input.vertices()) {
+  view.foreach_prefetched(input.vertices(), [&](size_t idx, vid_t v) {
     auto es = view.get_edges(v);
     for (auto& e : es) {
       if (pred(input_label, v, nbr_label, e.get_neighbor(), e_label, dir,
@@ -74,8 +73,7 @@ expand_vertex_on_graph_view(
         offsets.push_back(idx);
       }
     }
-    ++idx;
-  }
+  });
 
   return std::make_pair(builder.finish(nullptr), std::move(offsets));
 }
@@ -225,16 +223,14 @@ expand_vertex_np_me_sp(
 
     col = builder.finish(nullptr);
   } else {
-    size_t idx = 0;
     auto builder = MSVertexColumnBuilder::builder();
     size_t csr_idx = 0;
     for (auto& csr : views) {
       label_t nbr_label = std::get<0>(label_dirs[csr_idx]);
       label_t edge_label = std::get<1>(label_dirs[csr_idx]);
       Direction dir = std::get<2>(label_dirs[csr_idx]);
-      idx = 0;
       builder.start_label(nbr_label);
-      for (auto v : input.vertices()) {
+      csr.foreach_prefetched(input.vertices(), [&](size_t idx, vid_t v) {
         auto es = csr.get_edges(v);
         for (auto& e : es) {
           if (pred(input_label, v, nbr_label, e.get_neighbor(), edge_label, dir,
@@ -243,8 +239,7 @@ expand_vertex_np_me_sp(
             offsets.push_back(idx);
           }
         }
-        ++idx;
-      }
+      });
       ++csr_idx;
     }
     col = builder.finish(nullptr);
@@ -1372,8 +1367,7 @@ expand_edge_ep_se(const GraphReadInterface& graph, const SLVertexColumn& input,
   if (dir == Direction::kIn) {
     GraphReadInterface::graph_view_t<EDATA_T> view =
         graph.GetIncomingGraphView<EDATA_T>(input_label, nbr_label, edge_label);
-    size_t idx = 0;
-    for (auto v : input.vertices()) {
+    view.foreach_prefetched(input.vertices(), [&](size_t idx, vid_t v) {
       auto es = view.get_edges(v);
       for (auto& e : es) {
         Any edata = AnyConverter<EDATA_T>::to_any(e.get_data());
@@ -1382,14 +1376,12 @@ expand_edge_ep_se(const GraphReadInterface& graph, const SLVertexColumn& input,
           offsets.push_back(idx);
         }
       }
-      ++idx;
-    }
+    });
   } else if (dir == Direction::kOut) {
     CHECK(dir == Direction::kOut);
     GraphReadInterface::graph_view_t<EDATA_T> view =
         graph.GetOutgoingGraphView<EDATA_T>(input_label, nbr_label, edge_label);
-    size_t idx = 0;
-    for (auto v : input.vertices()) {
+    view.foreach_prefetched(input.vertices(), [&](size_t idx, vid_t v) {
       auto es = view.get_edges(v);
       for (auto& e : es) {
         Any edata = AnyConverter<EDATA_T>::to_any(e.get_data());
@@ -1398,8 +1390,7 @@ expand_edge_ep_se(const GraphReadInterface& graph, const SLVertexColumn& input,
           offsets.push_back(idx);
         }
       }
-      ++idx;
-    }
+    });
   } else {
     // We will handle edge_expand with both direction outside this function, in
     // EdgeExpand::expand_edge.
@@ -143,15 +143,16 @@ class GetV {
     std::vector<size_t> shuffle_offset;
     auto col = ctx.get(params.tag);
     if (col->column_type() == ContextColumnType::kPath) {
-      auto& input_path_list =
-          *std::dynamic_pointer_cast<GeneralPathColumn>(col);
+      auto& input_path_list = *std::dynamic_pointer_cast<IPathColumn>(col);
 
       auto builder = MLVertexColumnBuilder::builder();
-      input_path_list.foreach_path([&](size_t index, const Path& path) {
-        auto [label, vid] = path.get_end();
-        builder.push_back_vertex({label, vid});
+      for (size_t index = 0; index < input_path_list.size(); ++index) {
+        if (!input_path_list.has_value(index)) {
+          continue;
+        }
+        builder.push_back_vertex(input_path_list.get_path_end(index));
         shuffle_offset.push_back(index);
-      });
+      }
       ctx.set_with_reshuffle(params.alias, builder.finish(nullptr),
                              shuffle_offset);
       return ctx;
@@ -16,13 +16,17 @@
 #ifndef RUNTIME_COMMON_OPERATORS_RETRIEVE_GROUP_BY_H_
 #define RUNTIME_COMMON_OPERATORS_RETRIEVE_GROUP_BY_H_
 
+#include <algorithm>
+#include <limits>
 #include <map>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include "flex/engines/graph_db/runtime/common/columns/value_columns.h"
 #include "flex/engines/graph_db/runtime/common/context.h"
 #include "flex/engines/graph_db/runtime/common/leaf_utils.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 #include "parallel_hashmap/phmap.h"
 namespace std {
 template <>
@@ -60,36 +64,241 @@ struct KeyBase {
   virtual ~KeyBase() = default;
   virtual std::pair<std::vector<size_t>, std::vector<std::vector<size_t>>>
   group(const Context& ctx) = 0;
+  // The first row and the number of rows of every group, in the order of
+  // group(), for reducers that only need the sizes of the groups. Returns
+  // false if the key can only list the rows.
+  virtual bool count(const Context& ctx, std::vector<size_t>& offsets,
+                     std::vector<size_t>& counts) {
+    return false;
+  }
   virtual const std::vector<std::pair<int, int>>& tag_alias() const = 0;
 };
+
+// Integral keys, alone or in a tuple of one, are grouped through an array
+// indexed by the key when their range is dense enough.
+template <typename T, typename = void>
+struct IntegralKey : std::false_type {};
+
+template <typename T>
+struct IntegralKey<T, std::enable_if_t<std::is_integral<T>::value>>
+    : std::true_type {
+  static int64_t code(T val) { return static_cast<int64_t>(val); }
+};
+
+template <typename T>
+struct IntegralKey<std::tuple<T>,
+                   std::enable_if_t<std::is_integral<T>::value>>
+    : std::true_type {
+  static int64_t code(const std::tuple<T>& val) {
+    return static_cast<int64_t>(std::get<0>(val));
+  }
+};
+
+template <typename T, typename = void>
+struct LessComparable : std::false_type {};
+
+template <typename T>
+struct LessComparable<
+    T, std::void_t<decltype(std::declval<T>() < std::declval<T>())>>
+    : std::true_type {};
+
 template <typename EXPR>
 struct Key : public KeyBase {
+  using V = typename EXPR::V;
+  static constexpr size_t kNoGroup = std::numeric_limits<size_t>::max();
+  // The range of integral keys indexed directly, as a multiple of the rows.
+  static constexpr uint64_t kDenseRatio = 2;
+
   Key(EXPR&& expr, const std::vector<std::pair<int, int>>& tag_alias)
       : expr(std::move(expr)), tag_alias_(tag_alias) {}
   std::pair<std::vector<size_t>, std::vector<std::vector<size_t>>> group(
       const Context& ctx) override {
     size_t row_num = ctx.row_num();
-    std::vector<std::vector<size_t>> groups;
-    std::vector<size_t> offsets;
-    phmap::flat_hash_map<typename EXPR::V, size_t> group_map;
+    std::vector<size_t> ids, offsets, counts;
+    assign(row_num, ids, offsets, counts);
+    std::vector<std::vector<size_t>> groups(offsets.size());
+    for (size_t i = 0; i < groups.size(); ++i) {
+      groups[i].reserve(counts[i]);
+    }
     for (size_t i = 0; i < row_num; ++i) {
-      auto val = expr(i);
-      auto iter = group_map.find(val);
-      if (iter == group_map.end()) {
-        size_t idx = groups.size();
-        group_map[val] = idx;
-        groups.emplace_back();
-        groups.back().push_back(i);
-        offsets.push_back(i);
-      } else {
-        groups[iter->second].push_back(i);
-      }
+      groups[ids[i]].push_back(i);
     }
     return std::make_pair(std::move(offsets), std::move(groups));
   }
+  bool count(const Context& ctx, std::vector<size_t>& offsets,
+             std::vector<size_t>& counts) override {
+    size_t row_num = ctx.row_num();
+    if constexpr (IntegralKey<V>::value) {
+      if (parallel_count(row_num, offsets, counts)) {
+        return true;
+      }
+    }
+    std::vector<size_t> ids;
+    assign(row_num, ids, offsets, counts);
+    return true;
+  }
   const std::vector<std::pair<int, int>>& tag_alias() const override {
     return tag_alias_;
   }
+
+  // Numbers the groups by their first rows and sets the group of every row.
+  // Keys sorted on input are grouped by runs, dense integral keys through an
+  // array, others through a hash table.
+  void assign(size_t row_num, std::vector<size_t>& ids,
+              std::vector<size_t>& offsets, std::vector<size_t>& counts) const {
+    ids.resize(row_num);
+    offsets.clear();
+    counts.clear();
+    if (row_num == 0) {
+      return;
+    }
+    if constexpr (IntegralKey<V>::value) {
+      int64_t min_key, max_key;
+      bool sorted = scan_codes(row_num, min_key, max_key);
+      if (sorted) {
+        assign_runs(row_num, ids, offsets, counts);
+        return;
+      }
+      uint64_t span = static_cast<uint64_t>(max_key) -
+                      static_cast<uint64_t>(min_key);
+      if (span < kDenseRatio * row_num) {
+        std::vector<size_t> slots(span + 1, kNoGroup);
+        for (size_t i = 0; i < row_num; ++i) {
+          size_t& slot = slots[static_cast<uint64_t>(
+                                   IntegralKey<V>::code(expr(i))) -
+                               static_cast<uint64_t>(min_key)];
+          if (slot == kNoGroup) {
+            slot = offsets.size();
+            offsets.push_back(i);
+            counts.push_back(0);
+          }
+          ids[i] = slot;
+          ++counts[slot];
+        }
+        return;
+      }
+    } else if constexpr (LessComparable<V>::value) {
+      bool sorted = true;
+      V prev = expr(0);
+      for (size_t i = 1; i < row_num && sorted; ++i) {
+        V cur = expr(i);
+        sorted = !(cur < prev);
+        prev = std::move(cur);
+      }
+      if (sorted) {
+        assign_runs(row_num, ids, offsets, counts);
+        return;
+      }
+    }
+    phmap::flat_hash_map<V, size_t> group_map;
+    for (size_t i = 0; i < row_num; ++i) {
+      auto [iter, inserted] = group_map.emplace(expr(i), offsets.size());
+      if (inserted) {
+        offsets.push_back(i);
+        counts.push_back(0);
+      }
+      ids[i] = iter->second;
+      ++counts[iter->second];
+    }
+  }
+
+  // Returns whether the keys are sorted.
+  bool scan_codes(size_t row_num, int64_t& min_key, int64_t& max_key) const {
+    bool sorted = true;
+    int64_t prev = IntegralKey<V>::code(expr(0));
+    min_key = max_key = prev;
+    for (size_t i = 1; i < row_num; ++i) {
+      int64_t cur = IntegralKey<V>::code(expr(i));
+      sorted = sorted && prev <= cur;
+      min_key = std::min(min_key, cur);
+      max_key = std::max(max_key, cur);
+      prev = cur;
+    }
+    return sorted;
+  }
+
+  // Equal keys are adjacent, every run a group.
+  void assign_runs(size_t row_num, std::vector<size_t>& ids,
+                   std::vector<size_t>& offsets,
+                   std::vector<size_t>& counts) const {
+    V prev = expr(0);
+    offsets.push_back(0);
+    counts.push_back(0);
+    for (size_t i = 0; i < row_num; ++i) {
+      V cur = expr(i);
+      if (!(cur == prev)) {
+        offsets.push_back(i);
+        counts.push_back(0);
+        prev = std::move(cur);
+      }
+      ids[i] = offsets.size() - 1;
+      ++counts.back();
+    }
+  }
+
+  // Counts dense integral keys in morsels, into an array per morsel merged
+  // afterwards. Returns false if the input is too small to run in parallel
+  // or the arrays would outgrow the input.
+  bool parallel_count(size_t row_num, std::vector<size_t>& offsets,
+                      std::vector<size_t>& counts) const {
+    auto& pool = MorselPool::get();
+    if (!pool.Enabled(row_num)) {
+      return false;
+    }
+    size_t morsel_num = pool.MorselNum(row_num);
+    int64_t min_key, max_key;
+    if (morsel_num <= 1 || scan_codes(row_num, min_key, max_key)) {
+      return false;
+    }
+    uint64_t span = static_cast<uint64_t>(max_key) -
+                    static_cast<uint64_t>(min_key);
+    if (span >= row_num / morsel_num) {
+      return false;
+    }
+    size_t range = span + 1;
+    struct Slot {
+      size_t first = kNoGroup;
+      size_t count = 0;
+    };
+    std::vector<std::vector<Slot>> local(morsel_num);
+    pool.Run(morsel_num, [&](size_t m) {
+      auto& slots = local[m];
+      slots.resize(range);
+      size_t end = row_num * (m + 1) / morsel_num;
+      for (size_t i = row_num * m / morsel_num; i < end; ++i) {
+        Slot& slot = slots[static_cast<uint64_t>(
+                               IntegralKey<V>::code(expr(i))) -
+                           static_cast<uint64_t>(min_key)];
+        if (slot.first == kNoGroup) {
+          slot.first = i;
+        }
+        ++slot.count;
+      }
+    });
+    std::vector<std::pair<size_t, size_t>> groups;
+    for (size_t k = 0; k < range; ++k) {
+      Slot merged;
+      for (size_t m = 0; m < morsel_num; ++m) {
+        const Slot& slot = local[m][k];
+        if (merged.first == kNoGroup) {
+          merged.first = slot.first;
+        }
+        merged.count += slot.count;
+      }
+      if (merged.count != 0) {
+        groups.emplace_back(merged.first, merged.count);
+      }
+    }
+    std::sort(groups.begin(), groups.end());
+    offsets.resize(groups.size());
+    counts.resize(groups.size());
+    for (size_t i = 0; i < groups.size(); ++i) {
+      offsets[i] = groups[i].first;
+      counts[i] = groups[i].second;
+    }
+    return true;
+  }
+
   EXPR expr;
   std::vector<std::pair<int, int>> tag_alias_;
 };
@@ -140,8 +349,25 @@ struct ReducerBase {
   virtual Context reduce(const Context& ctx, Context&& ret,
                          const std::vector<std::vector<size_t>>& groups,
                          std::set<size_t>& filter) = 0;
+  // Whether reduce_counts can replace reduce.
+  virtual bool reduces_counts() const { return false; }
+  // Reduces groups given by their sizes only.
+  virtual Context reduce_counts(Context&& ret,
+                                const std::vector<size_t>& counts) {
+    return ret;
+  }
 };
 
+// Reducers that only need the sizes of the groups declare
+// kReducesCounts and take them through reduce_count(count, val).
+template <typename REDUCER_T, typename = void>
+struct ReducesCounts : std::false_type {};
+
+template <typename REDUCER_T>
+struct ReducesCounts<REDUCER_T,
+                     std::void_t<decltype(REDUCER_T::kReducesCounts)>>
+    : std::integral_constant<bool, REDUCER_T::kReducesCounts> {};
+
 template <typename REDUCER_T, typename COLLECTOR_T>
 struct Reducer : public ReducerBase {
   Reducer(REDUCER_T&& reducer, COLLECTOR_T&& collector, int alias)
@@ -166,6 +392,25 @@ struct Reducer : public ReducerBase {
     return ret;
   }
 
+  bool reduces_counts() const override {
+    return ReducesCounts<REDUCER_T>::value;
+  }
+
+  Context reduce_counts(Context&& ret,
+                        const std::vector<size_t>& counts) override {
+    if constexpr (ReducesCounts<REDUCER_T>::value) {
+      using T = typename REDUCER_T::V;
+      collector_.init(counts.size());
+      for (auto count : counts) {
+        T val{};
+        reducer_.reduce_count(count, val);
+        collector_.collect(std::move(val));
+      }
+      ret.set(alias_, collector_.get());
+    }
+    return ret;
+  }
+
   REDUCER_T reducer_;
   COLLECTOR_T collector_;
   int alias_;
@@ -176,9 +421,27 @@ class GroupBy {
   static bl::result<Context> group_by(
       Context&& ctx, std::unique_ptr<KeyBase>&& key,
       std::vector<std::unique_ptr<ReducerBase>>&& aggrs) {
+    const auto& tag_alias = key->tag_alias();
+    bool reduces_counts = true;
+    for (auto& aggr : aggrs) {
+      reduces_counts = reduces_counts && aggr->reduces_counts();
+    }
+    if (reduces_counts) {
+      std::vector<size_t> offsets, counts;
+      if (key->count(ctx, offsets, counts)) {
+        Context ret;
+        for (size_t i = 0; i < tag_alias.size(); ++i) {
+          ret.set(tag_alias[i].second, ctx.get(tag_alias[i].first));
+        }
+        ret.reshuffle(offsets);
+        for (auto& aggr : aggrs) {
+          ret = aggr->reduce_counts(std::move(ret), counts);
+        }
+        return ret;
+      }
+    }
     auto [offsets, groups] = key->group(ctx);
     Context ret;
-    const auto& tag_alias = key->tag_alias();
     for (size_t i = 0; i < tag_alias.size(); ++i) {
       ret.set(tag_alias[i].second, ctx.get(tag_alias[i].first));
     }
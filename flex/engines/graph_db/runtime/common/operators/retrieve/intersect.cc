@@ -17,6 +17,7 @@
 #include "flex/engines/graph_db/runtime/common/columns/edge_columns.h"
 #include "flex/engines/graph_db/runtime/common/columns/value_columns.h"
 #include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
+#include "flex/utils/sorted_intersection.h"
 #include "parallel_hashmap/phmap.h"
 
 namespace gs {
@@ -160,6 +161,16 @@ static Context left_outer_intersect(Context&& ctx, Context&& ctx0,
   }
   return ctx;
 }
+static bool is_sorted_by_vertex(const IVertexColumn& vlist,
+                                const std::vector<size_t>& indices) {
+  for (size_t i = 1; i < indices.size(); ++i) {
+    if (vlist.get_vertex(indices[i]) < vlist.get_vertex(indices[i - 1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static bl::result<Context> intersect_impl(Context&& ctx,
                                           std::vector<Context>&& ctxs,
                                           int key) {
@@ -200,7 +211,20 @@ static bl::result<Context> intersect_impl(Context&& ctx,
           continue;
         }
 
-        if (vec0.size() < vec1.size()) {
+        if (is_sorted_by_vertex(vlist0, vec0[i]) &&
+            is_sorted_by_vertex(vlist1, vec1[i])) {
+          // Both sides come from neighbor-sorted adjacency lists, merge
+          // them directly instead of building a hash table.
+          auto key0 = [&](size_t j) { return vlist0.get_vertex(j); };
+          auto key1 = [&](size_t k) { return vlist1.get_vertex(k); };
+          sorted_intersect(vec0[i].begin(), vec0[i].end(), vec1[i].begin(),
+                           vec1[i].end(), key0, key1,
+                           [&](std::vector<size_t>::const_iterator j,
+                               std::vector<size_t>::const_iterator k) {
+                             shuffle_offsets.push_back(*j);
+                             shuffle_offsets_1.push_back(*k);
+                           });
+        } else if (vec0.size() < vec1.size()) {
           phmap::flat_hash_map<VertexRecord, std::vector<size_t>,
                                VertexRecordHash>
               left_map;
@@ -272,6 +296,204 @@ bl::result<Context> Intersect::intersect(Context&& ctx,
   return intersect_impl(std::move(ctx), std::move(ctxs), key);
 }
 
+static bool expand_out(const EdgeExpandParams& params) {
+  return params.dir == Direction::kOut || params.dir == Direction::kBoth;
+}
+
+static bool expand_in(const EdgeExpandParams& params) {
+  return params.dir == Direction::kIn || params.dir == Direction::kBoth;
+}
+
+// The labels of the vertices an expansion reaches from vertices of labels.
+static std::set<label_t> neighbor_labels(const Schema& schema,
+                                         const EdgeExpandParams& params,
+                                         const std::set<label_t>& labels) {
+  std::set<label_t> ret;
+  for (const auto& triplet : params.labels) {
+    if (!schema.exist(triplet.src_label, triplet.dst_label,
+                      triplet.edge_label)) {
+      continue;
+    }
+    if (expand_out(params) && labels.count(triplet.src_label)) {
+      ret.insert(triplet.dst_label);
+    }
+    if (expand_in(params) && labels.count(triplet.dst_label)) {
+      ret.insert(triplet.src_label);
+    }
+  }
+  return ret;
+}
+
+static void collect_neighbors(const GraphReadInterface& graph,
+                              const EdgeExpandParams& params, VertexRecord v,
+                              std::vector<VertexRecord>& nbrs) {
+  nbrs.clear();
+  for (const auto& triplet : params.labels) {
+    if (!graph.schema().exist(triplet.src_label, triplet.dst_label,
+                              triplet.edge_label)) {
+      continue;
+    }
+    if (expand_out(params) && triplet.src_label == v.label_) {
+      for (auto it = graph.GetOutEdgeIterator(v.label_, v.vid_,
+                                              triplet.dst_label,
+                                              triplet.edge_label);
+           it.IsValid(); it.Next()) {
+        nbrs.push_back({triplet.dst_label, it.GetNeighbor()});
+      }
+    }
+    if (expand_in(params) && triplet.dst_label == v.label_) {
+      for (auto it = graph.GetInEdgeIterator(v.label_, v.vid_,
+                                             triplet.src_label,
+                                             triplet.edge_label);
+           it.IsValid(); it.Next()) {
+        nbrs.push_back({triplet.src_label, it.GetNeighbor()});
+      }
+    }
+  }
+  // Adjacency lists kept sorted by neighbor are already in order when a
+  // single one is read.
+  if (!std::is_sorted(nbrs.begin(), nbrs.end())) {
+    std::sort(nbrs.begin(), nbrs.end());
+  }
+}
+
+// Calls func(v, count) for every vertex in all the sorted lists, count being
+// the product of its multiplicities in them. Each list leaps to the vertex
+// last found in the others, so the cost is bounded by the shortest list
+// rather than by the longest one.
+template <typename FUNC_T>
+static void leapfrog_intersect(
+    std::vector<const std::vector<VertexRecord>*>& lists, const FUNC_T& func) {
+  std::sort(lists.begin(), lists.end(),
+            [](const std::vector<VertexRecord>* a,
+               const std::vector<VertexRecord>* b) {
+              return a->size() < b->size();
+            });
+  size_t list_num = lists.size();
+  if (lists[0]->empty()) {
+    return;
+  }
+  std::vector<const VertexRecord*> cur(list_num), end(list_num);
+  for (size_t i = 0; i < list_num; ++i) {
+    cur[i] = lists[i]->data();
+    end[i] = lists[i]->data() + lists[i]->size();
+  }
+  auto ident = [](const VertexRecord& v) -> const VertexRecord& { return v; };
+  VertexRecord target = *cur[0];
+  size_t agreed = 1;
+  size_t i = 1 % list_num;
+  while (true) {
+    if (agreed == list_num) {
+      size_t count = 1;
+      for (size_t j = 0; j < list_num; ++j) {
+        size_t run = 0;
+        while (cur[j] != end[j] && *cur[j] == target) {
+          ++cur[j];
+          ++run;
+        }
+        count *= run;
+      }
+      func(target, count);
+      for (size_t j = 0; j < list_num; ++j) {
+        if (cur[j] == end[j]) {
+          return;
+        }
+      }
+      target = *cur[0];
+      agreed = 1;
+      i = 1 % list_num;
+      continue;
+    }
+    cur[i] = gallop_lower_bound(cur[i], end[i], target, ident);
+    if (cur[i] == end[i]) {
+      return;
+    }
+    if (*cur[i] == target) {
+      ++agreed;
+    } else {
+      target = *cur[i];
+      agreed = 1;
+    }
+    i = (i + 1) % list_num;
+  }
+}
+
+bl::result<Context> Intersect::multiway_intersect(
+    const GraphReadInterface& graph, Context&& ctx,
+    const std::vector<EdgeExpandParams>& params, int key) {
+  size_t expand_num = params.size();
+  std::vector<std::shared_ptr<IVertexColumn>> inputs;
+  std::set<label_t> labels;
+  for (size_t i = 0; i < expand_num; ++i) {
+    auto input = std::dynamic_pointer_cast<IVertexColumn>(
+        ctx.get(params[i].v_tag));
+    if (input == nullptr || input->is_optional()) {
+      LOG(ERROR) << "multiway intersect expects vertices without nulls";
+      RETURN_UNSUPPORTED_ERROR(
+          "multiway intersect expects vertices without nulls");
+    }
+    auto reached = neighbor_labels(graph.schema(), params[i],
+                                   input->get_labels_set());
+    if (i == 0) {
+      labels = reached;
+    } else {
+      std::set<label_t> common;
+      std::set_intersection(labels.begin(), labels.end(), reached.begin(),
+                            reached.end(),
+                            std::inserter(common, common.begin()));
+      labels.swap(common);
+    }
+    inputs.emplace_back(std::move(input));
+  }
+
+  std::vector<std::vector<VertexRecord>> nbrs(expand_num);
+  // A vertex bound in consecutive rows keeps its neighbors.
+  std::vector<VertexRecord> bound(expand_num);
+  std::vector<bool> collected(expand_num, false);
+  std::vector<const std::vector<VertexRecord>*> lists(expand_num);
+
+  std::vector<VertexRecord> matched;
+  std::vector<size_t> offsets;
+  size_t row_num = ctx.row_num();
+  if (!labels.empty()) {
+    for (size_t r = 0; r < row_num; ++r) {
+      for (size_t i = 0; i < expand_num; ++i) {
+        VertexRecord v = inputs[i]->get_vertex(r);
+        if (!collected[i] || !(bound[i] == v)) {
+          collect_neighbors(graph, params[i], v, nbrs[i]);
+          bound[i] = v;
+          collected[i] = true;
+        }
+        lists[i] = &nbrs[i];
+      }
+      leapfrog_intersect(lists, [&](const VertexRecord& v, size_t count) {
+        for (size_t c = 0; c < count; ++c) {
+          matched.push_back(v);
+          offsets.push_back(r);
+        }
+      });
+    }
+  }
+
+  if (labels.size() <= 1) {
+    auto builder = SLVertexColumnBuilder::builder(
+        labels.empty() ? static_cast<label_t>(0) : *labels.begin());
+    builder.reserve(matched.size());
+    for (const auto& v : matched) {
+      builder.push_back_opt(v.vid_);
+    }
+    ctx.set_with_reshuffle(key, builder.finish(nullptr), offsets);
+  } else {
+    auto builder = MLVertexColumnBuilder::builder(labels);
+    builder.reserve(matched.size());
+    for (const auto& v : matched) {
+      builder.push_back_vertex(v);
+    }
+    ctx.set_with_reshuffle(key, builder.finish(nullptr), offsets);
+  }
+  return ctx;
+}
+
 }  // namespace runtime
 
 }  // namespace gs
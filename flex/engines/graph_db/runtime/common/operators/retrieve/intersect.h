@@ -20,7 +20,9 @@
 #include <vector>
 
 #include "flex/engines/graph_db/runtime/common/context.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
 #include "flex/engines/graph_db/runtime/common/leaf_utils.h"
+#include "flex/engines/graph_db/runtime/utils/params.h"
 
 namespace gs {
 
@@ -30,6 +32,14 @@ class Intersect {
  public:
   static bl::result<Context> intersect(Context&& ctx,
                                        std::vector<Context>&& ctxs, int key);
+
+  // Binds key, in each row, to the vertices adjacent to the vertices of all
+  // the expansions in params, once per combination of edges reaching them.
+  // The sorted adjacency lists of the row are intersected in one leapfrog
+  // pass instead of expanding each of them into a context of its own.
+  static bl::result<Context> multiway_intersect(
+      const GraphReadInterface& graph, Context&& ctx,
+      const std::vector<EdgeExpandParams>& params, int key);
 };
 
 }  // namespace runtime
@@ -14,8 +14,13 @@
  */
 
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/join.h"
+
+#include <algorithm>
+#include <limits>
+
 #include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
-#include "parallel_hashmap/phmap.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 
 // #define DEBUG_JOIN
 
@@ -23,7 +28,333 @@ namespace gs {
 
 namespace runtime {
 
-using vertex_pair = std::pair<VertexRecord, VertexRecord>;
+// A vertex as one key, the label above the vid.
+static inline uint64_t vertex_key(const VertexRecord& v) {
+  return (static_cast<uint64_t>(v.label_) << 32) | v.vid_;
+}
+
+static inline uint64_t join_key_hash(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+static inline uint64_t join_key_hash(const std::pair<uint64_t, uint64_t>& key) {
+  return join_key_hash(key.first ^ join_key_hash(key.second));
+}
+
+// Calls func on [begin, end) ranges covering [0, num), on the morsel pool if
+// num is large.
+template <typename FUNC_T>
+static void parallel_ranges(size_t num, const FUNC_T& func) {
+  auto& pool = MorselPool::get();
+  size_t range_num = pool.Enabled(num) ? pool.MorselNum(num) : 1;
+  if (range_num <= 1) {
+    func(0, num);
+    return;
+  }
+  pool.Run(range_num, [&](size_t i) {
+    func(num * i / range_num, num * (i + 1) / range_num);
+  });
+}
+
+static constexpr size_t kNoRow = std::numeric_limits<size_t>::max();
+
+// Appends the matches of every left row to the offsets, in the order of the
+// left rows, then of the right rows. The left rows without match are kept
+// with kNoRow on the right for left outer joins, and alone for anti joins.
+// Semi and anti joins only fill left_offsets.
+template <typename KEY_T>
+static void merge_join(const std::vector<KEY_T>& left_keys,
+                       const std::vector<KEY_T>& right_keys, JoinKind kind,
+                       std::vector<size_t>& left_offsets,
+                       std::vector<size_t>& right_offsets) {
+  size_t left_size = left_keys.size();
+  size_t right_size = right_keys.size();
+  size_t j = 0;
+  for (size_t i = 0; i < left_size;) {
+    QueryGuard::Check();
+    const KEY_T& key = left_keys[i];
+    while (j < right_size && right_keys[j] < key) {
+      ++j;
+    }
+    size_t end = j;
+    while (end < right_size && right_keys[end] == key) {
+      ++end;
+    }
+    for (; i < left_size && left_keys[i] == key; ++i) {
+      if (kind == JoinKind::kSemiJoin || kind == JoinKind::kAntiJoin) {
+        if ((end != j) == (kind == JoinKind::kSemiJoin)) {
+          left_offsets.push_back(i);
+        }
+        continue;
+      }
+      if (end == j && kind == JoinKind::kLeftOuterJoin) {
+        left_offsets.push_back(i);
+        right_offsets.push_back(kNoRow);
+      }
+      for (size_t k = j; k < end; ++k) {
+        QueryGuard::ChargeGrowth(left_offsets);
+        QueryGuard::ChargeGrowth(right_offsets);
+        left_offsets.push_back(i);
+        right_offsets.push_back(k);
+      }
+    }
+    j = end;
+  }
+}
+
+// merge_join on unsorted keys. Both sides are partitioned by the top bits of
+// the key hashes into partitions of about PARTITION_ROWS right rows, then
+// every partition builds an open addressing table on its right rows and
+// probes it with its left rows, in parallel. The matches are gathered in
+// the order of the left rows.
+template <typename KEY_T>
+static void radix_hash_join(const std::vector<KEY_T>& left_keys,
+                            const std::vector<KEY_T>& right_keys,
+                            JoinKind kind, std::vector<size_t>& left_offsets,
+                            std::vector<size_t>& right_offsets) {
+  constexpr size_t PARTITION_ROWS = 1 << 12;
+  constexpr int MAX_PARTITION_BITS = 12;
+  size_t left_size = left_keys.size();
+  size_t right_size = right_keys.size();
+  int bits = 0;
+  while (bits < MAX_PARTITION_BITS && (right_size >> bits) > PARTITION_ROWS) {
+    ++bits;
+  }
+  size_t part_num = static_cast<size_t>(1) << bits;
+  auto part_of = [bits](uint64_t hash) {
+    return bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - bits));
+  };
+
+  std::vector<uint64_t> left_hashes(left_size), right_hashes(right_size);
+  parallel_ranges(left_size, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      left_hashes[i] = join_key_hash(left_keys[i]);
+    }
+  });
+  parallel_ranges(right_size, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      right_hashes[i] = join_key_hash(right_keys[i]);
+    }
+  });
+  // The rows of both sides grouped by partition, in order in each.
+  auto scatter = [&](const std::vector<uint64_t>& hashes,
+                     std::vector<size_t>& part_begin,
+                     std::vector<size_t>& rows) {
+    part_begin.assign(part_num + 1, 0);
+    for (auto hash : hashes) {
+      ++part_begin[part_of(hash) + 1];
+    }
+    for (size_t p = 0; p < part_num; ++p) {
+      part_begin[p + 1] += part_begin[p];
+    }
+    std::vector<size_t> cursor(part_begin.begin(), part_begin.end() - 1);
+    rows.resize(hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      rows[cursor[part_of(hashes[i])]++] = i;
+    }
+  };
+  std::vector<size_t> left_begin, left_rows, right_begin, right_rows;
+  scatter(left_hashes, left_begin, left_rows);
+  scatter(right_hashes, right_begin, right_rows);
+
+  // The tables of the partitions, holding the first position in right_rows
+  // of every key, the positions of a key chained through next_pos.
+  std::vector<size_t> slot_begin(part_num + 1, 0);
+  for (size_t p = 0; p < part_num; ++p) {
+    size_t cap = 16;
+    while (cap < (right_begin[p + 1] - right_begin[p]) * 2) {
+      cap <<= 1;
+    }
+    slot_begin[p + 1] = slot_begin[p] + cap;
+  }
+  std::vector<size_t> slots(slot_begin[part_num], kNoRow);
+  std::vector<size_t> next_pos(right_size, kNoRow);
+  // The first match of every left row and their number.
+  std::vector<size_t> first_match(left_size, kNoRow);
+  std::vector<size_t> match_num(left_size, 0);
+  bool count_matches =
+      kind == JoinKind::kInnerJoin || kind == JoinKind::kLeftOuterJoin;
+
+  auto join_partition = [&](size_t p) {
+    size_t* table = slots.data() + slot_begin[p];
+    size_t mask = slot_begin[p + 1] - slot_begin[p] - 1;
+    // Backwards, so that the chains list the right rows in order.
+    for (size_t pos = right_begin[p + 1]; pos-- > right_begin[p];) {
+      size_t row = right_rows[pos];
+      for (size_t s = right_hashes[row] & mask;; s = (s + 1) & mask) {
+        if (table[s] == kNoRow) {
+          table[s] = pos;
+          break;
+        }
+        if (right_keys[right_rows[table[s]]] == right_keys[row]) {
+          next_pos[pos] = table[s];
+          table[s] = pos;
+          break;
+        }
+      }
+    }
+    for (size_t pos = left_begin[p]; pos < left_begin[p + 1]; ++pos) {
+      size_t row = left_rows[pos];
+      for (size_t s = left_hashes[row] & mask; table[s] != kNoRow;
+           s = (s + 1) & mask) {
+        if (right_keys[right_rows[table[s]]] == left_keys[row]) {
+          first_match[row] = table[s];
+          break;
+        }
+      }
+      if (count_matches) {
+        size_t num = 0;
+        for (size_t m = first_match[row]; m != kNoRow; m = next_pos[m]) {
+          ++num;
+        }
+        match_num[row] = num;
+      }
+    }
+  };
+  auto& pool = MorselPool::get();
+  if (part_num > 1 && pool.Enabled(left_size + right_size)) {
+    pool.Run(part_num, join_partition);
+  } else {
+    for (size_t p = 0; p < part_num; ++p) {
+      join_partition(p);
+    }
+  }
+
+  if (!count_matches) {
+    for (size_t i = 0; i < left_size; ++i) {
+      if ((first_match[i] != kNoRow) == (kind == JoinKind::kSemiJoin)) {
+        left_offsets.push_back(i);
+      }
+    }
+    return;
+  }
+  std::vector<size_t> out_begin(left_size + 1, 0);
+  for (size_t i = 0; i < left_size; ++i) {
+    size_t num = match_num[i];
+    if (num == 0 && kind == JoinKind::kLeftOuterJoin) {
+      num = 1;
+    }
+    out_begin[i + 1] = out_begin[i] + num;
+  }
+  // Charged before the matches are gathered, so that a join with too many
+  // aborts before allocating them.
+  QueryGuard::Charge(2 * sizeof(size_t) * out_begin[left_size]);
+  left_offsets.resize(out_begin[left_size]);
+  right_offsets.resize(out_begin[left_size]);
+  parallel_ranges(left_size, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      size_t out = out_begin[i];
+      if (first_match[i] == kNoRow && out != out_begin[i + 1]) {
+        left_offsets[out] = i;
+        right_offsets[out] = kNoRow;
+      }
+      for (size_t m = first_match[i]; m != kNoRow; m = next_pos[m]) {
+        left_offsets[out] = i;
+        right_offsets[out++] = right_rows[m];
+      }
+    }
+  });
+}
+
+template <typename KEY_T>
+static void vertex_key_join(const std::vector<KEY_T>& left_keys,
+                            const std::vector<KEY_T>& right_keys,
+                            JoinKind kind, std::vector<size_t>& left_offsets,
+                            std::vector<size_t>& right_offsets) {
+  // Keys read from columns sorted by vid, as after scans, need no table.
+  if (std::is_sorted(left_keys.begin(), left_keys.end()) &&
+      std::is_sorted(right_keys.begin(), right_keys.end())) {
+    merge_join(left_keys, right_keys, kind, left_offsets, right_offsets);
+  } else {
+    radix_hash_join(left_keys, right_keys, kind, left_offsets, right_offsets);
+  }
+}
+
+static bool is_vertex_key(const Context& ctx, const std::vector<int>& cols) {
+  for (auto col : cols) {
+    if (ctx.get(col)->column_type() != ContextColumnType::kVertex) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename KEY_T>
+static std::vector<KEY_T> extract_vertex_keys(const Context& ctx,
+                                              const std::vector<int>& cols);
+
+template <>
+std::vector<uint64_t> extract_vertex_keys<uint64_t>(
+    const Context& ctx, const std::vector<int>& cols) {
+  auto col = std::dynamic_pointer_cast<IVertexColumn>(ctx.get(cols[0]));
+  std::vector<uint64_t> keys(col->size());
+  parallel_ranges(keys.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      keys[i] = vertex_key(col->get_vertex(i));
+    }
+  });
+  return keys;
+}
+
+template <>
+std::vector<std::pair<uint64_t, uint64_t>>
+extract_vertex_keys<std::pair<uint64_t, uint64_t>>(
+    const Context& ctx, const std::vector<int>& cols) {
+  auto col0 = std::dynamic_pointer_cast<IVertexColumn>(ctx.get(cols[0]));
+  auto col1 = std::dynamic_pointer_cast<IVertexColumn>(ctx.get(cols[1]));
+  std::vector<std::pair<uint64_t, uint64_t>> keys(col0->size());
+  parallel_ranges(keys.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      keys[i] = std::make_pair(vertex_key(col0->get_vertex(i)),
+                               vertex_key(col1->get_vertex(i)));
+    }
+  });
+  return keys;
+}
+
+// Joins on one or two vertex columns.
+template <typename KEY_T>
+static Context vertex_column_join(Context&& ctx, Context&& ctx2,
+                                  const JoinParams& params) {
+  std::vector<size_t> left_offsets, right_offsets;
+  vertex_key_join(extract_vertex_keys<KEY_T>(ctx, params.left_columns),
+                  extract_vertex_keys<KEY_T>(ctx2, params.right_columns),
+                  params.join_type, left_offsets, right_offsets);
+  ctx.reshuffle(left_offsets);
+  if (params.join_type == JoinKind::kSemiJoin ||
+      params.join_type == JoinKind::kAntiJoin) {
+    return ctx;
+  }
+  if (params.join_type == JoinKind::kInnerJoin) {
+    ctx2.reshuffle(right_offsets);
+    Context ret;
+    for (size_t i = 0; i < ctx.col_num(); i++) {
+      ret.set(i, ctx.get(i));
+    }
+    for (size_t i = 0; i < ctx2.col_num(); i++) {
+      if (i >= ret.col_num() || ret.get(i) == nullptr) {
+        ret.set(i, ctx2.get(i));
+      }
+    }
+    return ret;
+  }
+  for (auto idx : params.right_columns) {
+    ctx2.remove(idx);
+  }
+  ctx2.optional_reshuffle(right_offsets);
+  for (size_t i = 0; i < ctx2.col_num(); ++i) {
+    if (ctx2.get(i) != nullptr &&
+        (i >= ctx.col_num() || ctx.get(i) == nullptr)) {
+      ctx.set(i, ctx2.get(i));
+    }
+  }
+  return ctx;
+}
 
 static Context default_semi_join(Context&& ctx, Context&& ctx2,
                                  const JoinParams& params) {
@@ -45,6 +376,7 @@ static Context default_semi_join(Context&& ctx, Context&& ctx2,
 
   size_t left_size = ctx.row_num();
   for (size_t r_i = 0; r_i < left_size; ++r_i) {
+    QueryGuard::Check();
     std::vector<char> bytes;
     Encoder encoder(bytes);
     for (size_t i = 0; i < params.left_columns.size(); i++) {
@@ -67,158 +399,6 @@ static Context default_semi_join(Context&& ctx, Context&& ctx2,
   return ctx;
 }
 
-static Context single_vertex_column_inner_join(Context&& ctx, Context&& ctx2,
-                                               const JoinParams& params) {
-  std::vector<size_t> left_offset, right_offset;
-  auto casted_left_col =
-      std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.left_columns[0]));
-  auto casted_right_col = std::dynamic_pointer_cast<IVertexColumn>(
-      ctx2.get(params.right_columns[0]));
-
-  size_t left_size = casted_left_col->size();
-  size_t right_size = casted_right_col->size();
-
-  if (left_size < right_size) {
-    phmap::flat_hash_set<VertexRecord, VertexRecordHash> left_set;
-    phmap::flat_hash_map<VertexRecord, std::vector<size_t>, VertexRecordHash>
-        right_map;
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      left_set.emplace(casted_left_col->get_vertex(r_i));
-    }
-    for (size_t r_i = 0; r_i < right_size; ++r_i) {
-      auto cur = casted_right_col->get_vertex(r_i);
-      if (left_set.find(cur) != left_set.end()) {
-        right_map[cur].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      auto iter = right_map.find(casted_left_col->get_vertex(r_i));
-      if (iter != right_map.end()) {
-        for (auto idx : iter->second) {
-          left_offset.emplace_back(r_i);
-          right_offset.emplace_back(idx);
-        }
-      }
-    }
-  } else {
-    phmap::flat_hash_set<VertexRecord, VertexRecordHash> right_set;
-    phmap::flat_hash_map<VertexRecord, std::vector<size_t>, VertexRecordHash>
-        left_map;
-    if (right_size != 0) {
-      for (size_t r_i = 0; r_i < right_size; ++r_i) {
-        right_set.emplace(casted_right_col->get_vertex(r_i));
-      }
-      for (size_t r_i = 0; r_i < left_size; ++r_i) {
-        auto cur = casted_left_col->get_vertex(r_i);
-        if (right_set.find(cur) != right_set.end()) {
-          left_map[cur].emplace_back(r_i);
-        }
-      }
-      for (size_t r_i = 0; r_i < right_size; ++r_i) {
-        auto iter = left_map.find(casted_right_col->get_vertex(r_i));
-        if (iter != left_map.end()) {
-          for (auto idx : iter->second) {
-            right_offset.emplace_back(r_i);
-            left_offset.emplace_back(idx);
-          }
-        }
-      }
-    }
-  }
-  ctx.reshuffle(left_offset);
-  ctx2.reshuffle(right_offset);
-  Context ret;
-  for (size_t i = 0; i < ctx.col_num(); i++) {
-    ret.set(i, ctx.get(i));
-  }
-  for (size_t i = 0; i < ctx2.col_num(); i++) {
-    if (i >= ret.col_num() || ret.get(i) == nullptr) {
-      ret.set(i, ctx2.get(i));
-    }
-  }
-  return ret;
-}
-
-static Context dual_vertex_column_inner_join(Context&& ctx, Context&& ctx2,
-                                             const JoinParams& params) {
-  std::vector<size_t> left_offset, right_offset;
-  auto casted_left_col =
-      std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.left_columns[0]));
-  auto casted_left_col2 =
-      std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.left_columns[1]));
-  auto casted_right_col = std::dynamic_pointer_cast<IVertexColumn>(
-      ctx2.get(params.right_columns[0]));
-  auto casted_right_col2 = std::dynamic_pointer_cast<IVertexColumn>(
-      ctx2.get(params.right_columns[1]));
-
-  size_t left_size = casted_left_col->size();
-  size_t right_size = casted_right_col->size();
-
-  if (left_size < right_size) {
-    phmap::flat_hash_set<vertex_pair, VertexRecordHash> left_set;
-    phmap::flat_hash_map<vertex_pair, std::vector<size_t>, VertexRecordHash>
-        right_map;
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      left_set.emplace(casted_left_col->get_vertex(r_i),
-                       casted_left_col2->get_vertex(r_i));
-    }
-    for (size_t r_i = 0; r_i < right_size; ++r_i) {
-      auto cur1 = casted_right_col->get_vertex(r_i);
-      auto cur2 = casted_right_col2->get_vertex(r_i);
-      auto cur = std::make_pair(cur1, cur2);
-      if (left_set.find(cur) != left_set.end()) {
-        right_map[cur].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      auto cur1 = casted_left_col->get_vertex(r_i);
-      auto cur2 = casted_left_col2->get_vertex(r_i);
-      auto cur = std::make_pair(cur1, cur2);
-      auto iter = right_map.find(cur);
-      if (iter != right_map.end()) {
-        for (auto idx : iter->second) {
-          left_offset.emplace_back(r_i);
-          right_offset.emplace_back(idx);
-        }
-      }
-    }
-  } else {
-    phmap::flat_hash_map<vertex_pair, std::vector<size_t>, VertexRecordHash>
-        right_map;
-    for (size_t r_i = 0; r_i < right_size; ++r_i) {
-      auto cur1 = casted_right_col->get_vertex(r_i);
-      auto cur2 = casted_right_col2->get_vertex(r_i);
-      auto cur = std::make_pair(cur1, cur2);
-      right_map[cur].emplace_back(r_i);
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      auto cur1 = casted_left_col->get_vertex(r_i);
-      auto cur2 = casted_left_col2->get_vertex(r_i);
-      auto cur = std::make_pair(cur1, cur2);
-
-      auto iter = right_map.find(cur);
-      if (iter != right_map.end()) {
-        for (auto idx : iter->second) {
-          left_offset.emplace_back(r_i);
-          right_offset.emplace_back(idx);
-        }
-      }
-    }
-  }
-  ctx.reshuffle(left_offset);
-  ctx2.reshuffle(right_offset);
-  Context ret;
-  for (size_t i = 0; i < ctx.col_num(); i++) {
-    ret.set(i, ctx.get(i));
-  }
-  for (size_t i = 0; i < ctx2.col_num(); i++) {
-    if (i >= ret.col_num() || ret.get(i) == nullptr) {
-      ret.set(i, ctx2.get(i));
-    }
-  }
-  return ret;
-}
-
 static Context default_inner_join(Context&& ctx, Context&& ctx2,
                                   const JoinParams& params) {
   std::vector<size_t> left_offset, right_offset;
@@ -239,6 +419,7 @@ static Context default_inner_join(Context&& ctx, Context&& ctx2,
 
   size_t left_size = ctx.row_num();
   for (size_t r_i = 0; r_i < left_size; ++r_i) {
+    QueryGuard::Check();
     std::vector<char> bytes;
     Encoder encoder(bytes);
     for (size_t i = 0; i < params.left_columns.size(); i++) {
@@ -249,6 +430,7 @@ static Context default_inner_join(Context&& ctx, Context&& ctx2,
     std::string cur(bytes.begin(), bytes.end());
     if (right_set.find(cur) != right_set.end()) {
       for (auto right : right_set[cur]) {
+        QueryGuard::ChargeGrowth(left_offset);
         left_offset.push_back(r_i);
         right_offset.push_back(right);
       }
@@ -268,164 +450,6 @@ static Context default_inner_join(Context&& ctx, Context&& ctx2,
   return ret;
 }
 
-static Context single_vertex_column_left_outer_join(Context&& ctx,
-                                                    Context&& ctx2,
-                                                    const JoinParams& params) {
-  std::vector<size_t> left_offset, right_offset;
-  auto casted_left_col =
-      std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.left_columns[0]));
-  auto casted_right_col = std::dynamic_pointer_cast<IVertexColumn>(
-      ctx2.get(params.right_columns[0]));
-
-  std::vector<size_t> left_offsets;
-  std::vector<size_t> right_offsets;
-
-  size_t left_size = casted_left_col->size();
-  size_t right_size = casted_right_col->size();
-  if (left_size < right_size) {
-    phmap::flat_hash_set<VertexRecord, VertexRecordHash> left_set;
-    phmap::flat_hash_map<VertexRecord, std::vector<size_t>, VertexRecordHash>
-        right_map;
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      left_set.emplace(casted_left_col->get_vertex(r_i));
-    }
-    for (size_t r_i = 0; r_i < right_size; ++r_i) {
-      auto cur = casted_right_col->get_vertex(r_i);
-      if (left_set.find(cur) != left_set.end()) {
-        right_map[cur].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      auto cur = casted_left_col->get_vertex(r_i);
-      auto iter = right_map.find(cur);
-      if (iter == right_map.end()) {
-        left_offsets.emplace_back(r_i);
-        right_offsets.emplace_back(std::numeric_limits<size_t>::max());
-      } else {
-        for (auto idx : iter->second) {
-          left_offsets.emplace_back(r_i);
-          right_offsets.emplace_back(idx);
-        }
-      }
-    }
-  } else {
-    phmap::flat_hash_map<VertexRecord, std::vector<vid_t>, VertexRecordHash>
-        right_map;
-    if (left_size > 0) {
-      for (size_t r_i = 0; r_i < right_size; ++r_i) {
-        right_map[casted_right_col->get_vertex(r_i)].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      auto cur = casted_left_col->get_vertex(r_i);
-      auto iter = right_map.find(cur);
-      if (iter == right_map.end()) {
-        left_offsets.emplace_back(r_i);
-        right_offsets.emplace_back(std::numeric_limits<size_t>::max());
-      } else {
-        for (auto idx : iter->second) {
-          left_offsets.emplace_back(r_i);
-          right_offsets.emplace_back(idx);
-        }
-      }
-    }
-  }
-  ctx.reshuffle(left_offsets);
-  ctx2.remove(params.right_columns[0]);
-  ctx2.optional_reshuffle(right_offsets);
-  for (size_t i = 0; i < ctx2.col_num(); ++i) {
-    if (ctx2.get(i) != nullptr &&
-        (i >= ctx.col_num() || ctx.get(i) == nullptr)) {
-      ctx.set(i, ctx2.get(i));
-    }
-  }
-  return ctx;
-}
-
-static Context dual_vertex_column_left_outer_join(Context&& ctx, Context&& ctx2,
-                                                  const JoinParams& params) {
-  auto left_col0 = ctx.get(params.left_columns[0]);
-  auto left_col1 = ctx.get(params.left_columns[1]);
-  auto right_col0 = ctx2.get(params.right_columns[0]);
-  auto right_col1 = ctx2.get(params.right_columns[1]);
-  auto casted_left_col0 = std::dynamic_pointer_cast<IVertexColumn>(left_col0);
-  auto casted_left_col1 = std::dynamic_pointer_cast<IVertexColumn>(left_col1);
-  auto casted_right_col0 = std::dynamic_pointer_cast<IVertexColumn>(right_col0);
-  auto casted_right_col1 = std::dynamic_pointer_cast<IVertexColumn>(right_col1);
-
-  std::vector<size_t> left_offsets;
-  std::vector<size_t> right_offsets;
-  size_t left_size = casted_left_col0->size();
-  size_t right_size = casted_right_col0->size();
-
-  if (left_size < right_size) {
-    phmap::flat_hash_set<vertex_pair, VertexRecordHash> left_set;
-    phmap::flat_hash_map<vertex_pair, std::vector<size_t>, VertexRecordHash>
-        right_map;
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      vertex_pair cur(casted_left_col0->get_vertex(r_i),
-                      casted_left_col1->get_vertex(r_i));
-      left_set.emplace(cur);
-    }
-    for (size_t r_i = 0; r_i < right_size; ++r_i) {
-      vertex_pair cur(casted_right_col0->get_vertex(r_i),
-                      casted_right_col1->get_vertex(r_i));
-      if (left_set.find(cur) != left_set.end()) {
-        right_map[cur].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      vertex_pair cur(casted_left_col0->get_vertex(r_i),
-                      casted_left_col1->get_vertex(r_i));
-      auto iter = right_map.find(cur);
-      if (iter == right_map.end()) {
-        left_offsets.emplace_back(r_i);
-        right_offsets.emplace_back(std::numeric_limits<size_t>::max());
-      } else {
-        for (auto idx : iter->second) {
-          left_offsets.emplace_back(r_i);
-          right_offsets.emplace_back(idx);
-        }
-      }
-    }
-  } else {
-    phmap::flat_hash_map<vertex_pair, std::vector<vid_t>, VertexRecordHash>
-        right_map;
-    if (left_size > 0) {
-      for (size_t r_i = 0; r_i < right_size; ++r_i) {
-        vertex_pair cur(casted_right_col0->get_vertex(r_i),
-                        casted_right_col1->get_vertex(r_i));
-        right_map[cur].emplace_back(r_i);
-      }
-    }
-    for (size_t r_i = 0; r_i < left_size; ++r_i) {
-      vertex_pair cur(casted_left_col0->get_vertex(r_i),
-                      casted_left_col1->get_vertex(r_i));
-      auto iter = right_map.find(cur);
-      if (iter == right_map.end()) {
-        left_offsets.emplace_back(r_i);
-        right_offsets.emplace_back(std::numeric_limits<size_t>::max());
-      } else {
-        for (auto idx : iter->second) {
-          left_offsets.emplace_back(r_i);
-          right_offsets.emplace_back(idx);
-        }
-      }
-    }
-  }
-  ctx.reshuffle(left_offsets);
-  ctx2.remove(params.right_columns[0]);
-  ctx2.remove(params.right_columns[1]);
-  ctx2.optional_reshuffle(right_offsets);
-  for (size_t i = 0; i < ctx2.col_num(); ++i) {
-    if (ctx2.get(i) != nullptr &&
-        (i >= ctx.col_num() || ctx.get(i) == nullptr)) {
-      ctx.set(i, ctx2.get(i));
-    }
-  }
-  return ctx;
-}
-
 static Context default_left_outer_join(Context&& ctx, Context&& ctx2,
                                        const JoinParams& params) {
   size_t right_size = ctx2.row_num();
@@ -448,6 +472,7 @@ static Context default_left_outer_join(Context&& ctx, Context&& ctx2,
   std::vector<size_t> right_offsets;
   size_t left_size = ctx.row_num();
   for (size_t r_i = 0; r_i < left_size; r_i++) {
+    QueryGuard::Check();
     std::vector<char> bytes;
     Encoder encoder(bytes);
     for (size_t i = 0; i < params.left_columns.size(); i++) {
@@ -461,6 +486,7 @@ static Context default_left_outer_join(Context&& ctx, Context&& ctx2,
       offsets.emplace_back(r_i);
     } else {
       for (auto idx : right_map[cur]) {
+        QueryGuard::ChargeGrowth(right_offsets);
         right_offsets.emplace_back(idx);
         offsets.emplace_back(r_i);
       }
@@ -492,41 +518,23 @@ bl::result<Context> Join::join(Context&& ctx, Context&& ctx2,
         " right size: " + std::to_string(params.right_columns.size()));
   }
 
+  if (is_vertex_key(ctx, params.left_columns) &&
+      is_vertex_key(ctx2, params.right_columns)) {
+    if (params.left_columns.size() == 1) {
+      return vertex_column_join<uint64_t>(std::move(ctx), std::move(ctx2),
+                                          params);
+    } else if (params.left_columns.size() == 2) {
+      return vertex_column_join<std::pair<uint64_t, uint64_t>>(
+          std::move(ctx), std::move(ctx2), params);
+    }
+  }
   if (params.join_type == JoinKind::kSemiJoin ||
       params.join_type == JoinKind::kAntiJoin) {
     return default_semi_join(std::move(ctx), std::move(ctx2), params);
   } else if (params.join_type == JoinKind::kInnerJoin) {
-    if (params.right_columns.size() == 1 &&
-        ctx.get(params.right_columns[0])->column_type() ==
-            ContextColumnType::kVertex) {
-      return single_vertex_column_inner_join(std::move(ctx), std::move(ctx2),
-                                             params);
-    } else if (params.right_columns.size() == 2 &&
-               ctx.get(params.right_columns[0])->column_type() ==
-                   ContextColumnType::kVertex &&
-               ctx.get(params.right_columns[1])->column_type() ==
-                   ContextColumnType::kVertex) {
-      return dual_vertex_column_inner_join(std::move(ctx), std::move(ctx2),
-                                           params);
-    } else {
-      return default_inner_join(std::move(ctx), std::move(ctx2), params);
-    }
+    return default_inner_join(std::move(ctx), std::move(ctx2), params);
   } else if (params.join_type == JoinKind::kLeftOuterJoin) {
-    if (params.right_columns.size() == 1 &&
-        ctx.get(params.right_columns[0])->column_type() ==
-            ContextColumnType::kVertex) {
-      return single_vertex_column_left_outer_join(std::move(ctx),
-                                                  std::move(ctx2), params);
-    } else if (params.right_columns.size() == 2 &&
-               ctx.get(params.right_columns[0])->column_type() ==
-                   ContextColumnType::kVertex &&
-               ctx.get(params.right_columns[1])->column_type() ==
-                   ContextColumnType::kVertex) {
-      return dual_vertex_column_left_outer_join(std::move(ctx), std::move(ctx2),
-                                                params);
-    } else {
-      return default_left_outer_join(std::move(ctx), std::move(ctx2), params);
-    }
+    return default_left_outer_join(std::move(ctx), std::move(ctx2), params);
   }
   LOG(FATAL) << "Unsupported join type" << params.join_type;
   return ctx;
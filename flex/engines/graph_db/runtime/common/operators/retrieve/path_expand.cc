@@ -14,8 +14,10 @@
  */
 
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/path_expand.h"
+#include "flex/engines/graph_db/runtime/common/operators/retrieve/dedup.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/path_expand_impl.h"
 #include "flex/engines/graph_db/runtime/common/utils/bitset.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
 
 namespace gs {
 
@@ -61,6 +63,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         std::swap(input, output);
         if (depth >= params.hop_lower) {
           for (auto& tuple : input) {
+            QueryGuard::Check();
             builder.push_back_vertex({std::get<0>(tuple), std::get<1>(tuple)});
             shuffle_offset.push_back(std::get<2>(tuple));
           }
@@ -71,6 +74,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         }
 
         for (auto& tuple : input) {
+          QueryGuard::Check();
           auto label = std::get<0>(tuple);
           auto v = std::get<1>(tuple);
           auto index = std::get<2>(tuple);
@@ -115,6 +119,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         std::swap(input, output);
         if (depth >= params.hop_lower) {
           for (const auto& tuple : input) {
+            QueryGuard::Check();
             builder.push_back_vertex({std::get<0>(tuple), std::get<1>(tuple)});
             shuffle_offset.push_back(std::get<2>(tuple));
           }
@@ -125,6 +130,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         }
 
         for (const auto& tuple : input) {
+          QueryGuard::Check();
           auto label = std::get<0>(tuple);
           auto v = std::get<1>(tuple);
           auto index = std::get<2>(tuple);
@@ -182,6 +188,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         std::swap(input, output);
         if (depth >= params.hop_lower) {
           for (auto& tuple : input) {
+            QueryGuard::Check();
             builder.push_back_vertex({std::get<0>(tuple), std::get<1>(tuple)});
             shuffle_offset.push_back(std::get<2>(tuple));
           }
@@ -192,6 +199,7 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
         }
 
         for (auto& tuple : input) {
+          QueryGuard::Check();
           auto label = std::get<0>(tuple);
           auto v = std::get<1>(tuple);
           auto index = std::get<2>(tuple);
@@ -228,13 +236,44 @@ bl::result<Context> PathExpand::edge_expand_v(const GraphReadInterface& graph,
   RETURN_UNSUPPORTED_ERROR("not support path expand options");
 }
 
+bl::result<Context> PathExpand::edge_expand_v_distinct(
+    const GraphReadInterface& graph, Context&& ctx,
+    const PathExpandParams& params, bool per_start) {
+  auto input =
+      std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.start_tag));
+  std::shared_ptr<IContextColumn> col;
+  std::vector<size_t> shuffle_offset;
+  if (input != nullptr &&
+      path_expand_distinct_vertex_impl(
+          graph, *input, params.labels, params.dir, params.hop_lower,
+          params.hop_upper, per_start, col, shuffle_offset)) {
+    ctx.set_with_reshuffle(params.alias, col, shuffle_offset);
+    return ctx;
+  }
+  // Some edges are not kept in typed csrs.
+  std::vector<size_t> keys;
+  if (per_start) {
+    keys.push_back(params.start_tag);
+  }
+  keys.push_back(params.alias);
+  BOOST_LEAF_AUTO(ret, edge_expand_v(graph, std::move(ctx), params));
+  return Dedup::dedup(std::move(ret), keys);
+}
+
+// The paths are kept as a PathTrie, each hop a node appended to the one of
+// the path it extends, so that no path copies its prefix.
 bl::result<Context> PathExpand::edge_expand_p(const GraphReadInterface& graph,
                                               Context&& ctx,
                                               const PathExpandParams& params) {
+  auto dir = params.dir;
+  if (dir != Direction::kOut && dir != Direction::kIn &&
+      dir != Direction::kBoth) {
+    LOG(ERROR) << "not support path expand options";
+    RETURN_UNSUPPORTED_ERROR("not support path expand options");
+  }
   std::vector<size_t> shuffle_offset;
   auto& input_vertex_list =
       *std::dynamic_pointer_cast<IVertexColumn>(ctx.get(params.start_tag));
-  auto label_sets = input_vertex_list.get_labels_set();
   auto labels = params.labels;
   std::vector<std::vector<LabelTriplet>> out_labels_map(
       graph.schema().vertex_label_num()),
@@ -243,193 +282,134 @@ bl::result<Context> PathExpand::edge_expand_p(const GraphReadInterface& graph,
     out_labels_map[triplet.src_label].emplace_back(triplet);
     in_labels_map[triplet.dst_label].emplace_back(triplet);
   }
-  auto dir = params.dir;
-  std::vector<std::pair<std::unique_ptr<PathImpl>, size_t>> input;
-  std::vector<std::pair<std::unique_ptr<PathImpl>, size_t>> output;
-
-  GeneralPathColumnBuilder builder;
-  std::shared_ptr<Arena> arena = std::make_shared<Arena>();
-  if (dir == Direction::kOut) {
-    foreach_vertex(input_vertex_list,
-                   [&](size_t index, label_t label, vid_t v) {
-                     auto p = PathImpl::make_path_impl(label, v);
-                     input.emplace_back(std::move(p), index);
-                   });
-    int depth = 0;
-    while (depth < params.hop_upper) {
-      output.clear();
-      if (depth + 1 < params.hop_upper) {
-        for (auto& [path, index] : input) {
-          auto end = path->get_end();
+  bool expand_out = (dir == Direction::kOut || dir == Direction::kBoth);
+  bool expand_in = (dir == Direction::kIn || dir == Direction::kBoth);
+
+  auto trie = std::make_shared<PathTrie>();
+  // The node of each path and the row it expands.
+  std::vector<std::pair<size_t, size_t>> input;
+  std::vector<std::pair<size_t, size_t>> output;
+  std::vector<size_t> rows;
+  foreach_vertex(input_vertex_list, [&](size_t index, label_t label, vid_t v) {
+    input.emplace_back(trie->add_root(label, v), index);
+  });
+  int depth = 0;
+  while (depth < params.hop_upper) {
+    output.clear();
+    if (depth + 1 < params.hop_upper) {
+      for (auto [node, index] : input) {
+        QueryGuard::Check();
+        auto end = trie->end(node);
+        if (expand_out) {
           for (const auto& label_triplet : out_labels_map[end.label_]) {
             auto oe_iter = graph.GetOutEdgeIterator(end.label_, end.vid_,
                                                     label_triplet.dst_label,
                                                     label_triplet.edge_label);
             while (oe_iter.IsValid()) {
-              std::unique_ptr<PathImpl> new_path =
-                  path->expand(label_triplet.edge_label,
-                               label_triplet.dst_label, oe_iter.GetNeighbor());
-              output.emplace_back(std::move(new_path), index);
+              output.emplace_back(
+                  trie->add_child(node, label_triplet.edge_label,
+                                  label_triplet.dst_label,
+                                  oe_iter.GetNeighbor()),
+                  index);
               oe_iter.Next();
             }
           }
         }
-      }
-
-      if (depth >= params.hop_lower) {
-        for (auto& [path, index] : input) {
-          builder.push_back_opt(Path(path.get()));
-          arena->emplace_back(std::move(path));
-          shuffle_offset.push_back(index);
-        }
-      }
-      if (depth + 1 >= params.hop_upper) {
-        break;
-      }
-
-      input.clear();
-      std::swap(input, output);
-      ++depth;
-    }
-    ctx.set_with_reshuffle(params.alias, builder.finish(arena), shuffle_offset);
-
-    return ctx;
-  } else if (dir == Direction::kIn) {
-    foreach_vertex(input_vertex_list,
-                   [&](size_t index, label_t label, vid_t v) {
-                     auto p = PathImpl::make_path_impl(label, v);
-                     input.emplace_back(std::move(p), index);
-                   });
-    int depth = 0;
-    while (depth < params.hop_upper) {
-      output.clear();
-
-      if (depth + 1 < params.hop_upper) {
-        for (const auto& [path, index] : input) {
-          auto end = path->get_end();
+        if (expand_in) {
           for (const auto& label_triplet : in_labels_map[end.label_]) {
             auto ie_iter = graph.GetInEdgeIterator(end.label_, end.vid_,
                                                    label_triplet.src_label,
                                                    label_triplet.edge_label);
             while (ie_iter.IsValid()) {
-              std::unique_ptr<PathImpl> new_path =
-                  path->expand(label_triplet.edge_label,
-                               label_triplet.src_label, ie_iter.GetNeighbor());
-              output.emplace_back(std::move(new_path), index);
+              output.emplace_back(
+                  trie->add_child(node, label_triplet.edge_label,
+                                  label_triplet.src_label,
+                                  ie_iter.GetNeighbor()),
+                  index);
               ie_iter.Next();
             }
           }
         }
       }
-
-      if (depth >= params.hop_lower) {
-        for (auto& [path, index] : input) {
-          builder.push_back_opt(Path(path.get()));
-          arena->emplace_back(std::move(path));
-          shuffle_offset.push_back(index);
-        }
-      }
-      if (depth + 1 >= params.hop_upper) {
-        break;
-      }
-
-      input.clear();
-      std::swap(input, output);
-      ++depth;
     }
-    ctx.set_with_reshuffle(params.alias, builder.finish(arena), shuffle_offset);
-
-    return ctx;
-
-  } else if (dir == Direction::kBoth) {
-    foreach_vertex(input_vertex_list,
-                   [&](size_t index, label_t label, vid_t v) {
-                     auto p = PathImpl::make_path_impl(label, v);
-                     input.emplace_back(std::move(p), index);
-                   });
-    int depth = 0;
-    while (depth < params.hop_upper) {
-      output.clear();
-      if (depth + 1 < params.hop_upper) {
-        for (auto& [path, index] : input) {
-          auto end = path->get_end();
-          for (const auto& label_triplet : out_labels_map[end.label_]) {
-            auto oe_iter = graph.GetOutEdgeIterator(end.label_, end.vid_,
-                                                    label_triplet.dst_label,
-                                                    label_triplet.edge_label);
-            while (oe_iter.IsValid()) {
-              auto new_path =
-                  path->expand(label_triplet.edge_label,
-                               label_triplet.dst_label, oe_iter.GetNeighbor());
-              output.emplace_back(std::move(new_path), index);
-              oe_iter.Next();
-            }
-          }
 
-          for (const auto& label_triplet : in_labels_map[end.label_]) {
-            auto ie_iter = graph.GetInEdgeIterator(end.label_, end.vid_,
-                                                   label_triplet.src_label,
-                                                   label_triplet.edge_label);
-            while (ie_iter.IsValid()) {
-              auto new_path =
-                  path->expand(label_triplet.edge_label,
-                               label_triplet.src_label, ie_iter.GetNeighbor());
-              output.emplace_back(std::move(new_path), index);
-              ie_iter.Next();
-            }
-          }
-        }
+    if (depth >= params.hop_lower) {
+      for (auto [node, index] : input) {
+        rows.push_back(node);
+        shuffle_offset.push_back(index);
       }
+    }
+    if (depth + 1 >= params.hop_upper) {
+      break;
+    }
 
-      if (depth >= params.hop_lower) {
-        for (auto& [path, index] : input) {
-          builder.push_back_opt(Path(path.get()));
-          arena->emplace_back(std::move(path));
-          shuffle_offset.push_back(index);
-        }
-      }
-      if (depth + 1 >= params.hop_upper) {
-        break;
-      }
+    std::swap(input, output);
+    ++depth;
+  }
+  ctx.set_with_reshuffle(
+      params.alias,
+      std::make_shared<CompactPathColumn>(std::move(trie), std::move(rows)),
+      shuffle_offset);
+  return ctx;
+}
 
-      input.clear();
-      std::swap(input, output);
-      ++depth;
+// The vertex arrays of the bidirectional search, allocated once for all the
+// sources of an operator. Only the vertices a search touched are reset for
+// the next one, so a search costs the vertices it visits, not the graph.
+struct SingleShortestPathState {
+  SingleShortestPathState(const GraphReadInterface& graph, label_t label)
+      : pre(graph.GetVertexSet(label), -1), dis(graph.GetVertexSet(label), 0) {}
+
+  void reset() {
+    for (auto v : touched) {
+      pre[v] = -1;
+      dis[v] = 0;
     }
-    ctx.set_with_reshuffle(params.alias, builder.finish(arena), shuffle_offset);
-    return ctx;
+    touched.clear();
   }
-  LOG(ERROR) << "not support path expand options";
-  RETURN_UNSUPPORTED_ERROR("not support path expand options");
-}
+
+  // dis is the distance + 1 from the source, or -(distance + 1) from the
+  // destination, 0 if not visited.
+  GraphReadInterface::vertex_array_t<int> pre;
+  GraphReadInterface::vertex_array_t<int> dis;
+  std::vector<vid_t> touched;
+};
 
 static bool single_source_single_dest_shortest_path_impl(
     const GraphReadInterface& graph, const ShortestPathParams& params,
-    vid_t src, vid_t dst, std::vector<vid_t>& path) {
+    vid_t src, vid_t dst, SingleShortestPathState& state,
+    std::vector<vid_t>& path) {
   std::queue<vid_t> q1;
   std::queue<vid_t> q2;
   std::queue<vid_t> tmp;
 
   label_t v_label = params.labels[0].src_label;
   label_t e_label = params.labels[0].edge_label;
-  auto vertices = graph.GetVertexSet(v_label);
-  GraphReadInterface::vertex_array_t<int> pre(vertices, -1);
-  GraphReadInterface::vertex_array_t<int> dis(vertices, 0);
+  state.reset();
+  auto& pre = state.pre;
+  auto& dis = state.dis;
+  auto& touched = state.touched;
   q1.push(src);
   dis[src] = 1;
+  touched.push_back(src);
   q2.push(dst);
   dis[dst] = -1;
+  touched.push_back(dst);
+  // The depths of the frontiers, a path found at the next level is
+  // src_dep + dst_dep + 1 long.
+  int src_dep = 0, dst_dep = 0;
 
   while (true) {
+    if (src_dep + dst_dep + 1 >= params.hop_upper) {
+      return false;
+    }
     if (q1.size() <= q2.size()) {
       if (q1.empty()) {
         break;
       }
       while (!q1.empty()) {
+        QueryGuard::Check();
         int x = q1.front();
-        if (dis[x] >= params.hop_upper + 1) {
-          return false;
-        }
         q1.pop();
         auto oe_iter = graph.GetOutEdgeIterator(v_label, x, v_label, e_label);
         while (oe_iter.IsValid()) {
@@ -437,6 +417,7 @@ static bool single_source_single_dest_shortest_path_impl(
           if (dis[y] == 0) {
             dis[y] = dis[x] + 1;
             tmp.push(y);
+            touched.push_back(y);
             pre[y] = x;
           } else if (dis[y] < 0) {
             while (x != -1) {
@@ -459,6 +440,7 @@ static bool single_source_single_dest_shortest_path_impl(
           if (dis[y] == 0) {
             dis[y] = dis[x] + 1;
             tmp.push(y);
+            touched.push_back(y);
             pre[y] = x;
           } else if (dis[y] < 0) {
             while (x != -1) {
@@ -477,15 +459,14 @@ static bool single_source_single_dest_shortest_path_impl(
         }
       }
       std::swap(q1, tmp);
+      ++src_dep;
     } else {
       if (q2.empty()) {
         break;
       }
       while (!q2.empty()) {
+        QueryGuard::Check();
         int x = q2.front();
-        if (dis[x] <= -params.hop_upper - 1) {
-          return false;
-        }
         q2.pop();
         auto oe_iter = graph.GetOutEdgeIterator(v_label, x, v_label, e_label);
         while (oe_iter.IsValid()) {
@@ -493,6 +474,7 @@ static bool single_source_single_dest_shortest_path_impl(
           if (dis[y] == 0) {
             dis[y] = dis[x] - 1;
             tmp.push(y);
+            touched.push_back(y);
             pre[y] = x;
           } else if (dis[y] > 0) {
             while (y != -1) {
@@ -515,6 +497,7 @@ static bool single_source_single_dest_shortest_path_impl(
           if (dis[y] == 0) {
             dis[y] = dis[x] - 1;
             tmp.push(y);
+            touched.push_back(y);
             pre[y] = x;
           } else if (dis[y] > 0) {
             while (y != -1) {
@@ -533,6 +516,7 @@ static bool single_source_single_dest_shortest_path_impl(
         }
       }
       std::swap(q2, tmp);
+      ++dst_dep;
     }
   }
   return false;
@@ -561,10 +545,11 @@ bl::result<Context> PathExpand::single_source_single_dest_shortest_path(
   auto builder = SLVertexColumnBuilder::builder(label_triplet.dst_label);
   GeneralPathColumnBuilder path_builder;
   std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+  SingleShortestPathState state(graph, label_triplet.src_label);
   foreach_vertex(input_vertex_list, [&](size_t index, label_t label, vid_t v) {
     std::vector<vid_t> path;
-    if (single_source_single_dest_shortest_path_impl(graph, params, v,
-                                                     dest.second, path)) {
+    if (single_source_single_dest_shortest_path_impl(
+            graph, params, v, dest.second, state, path)) {
       builder.push_back_opt(dest.second);
       shuffle_offset.push_back(index);
       auto impl = PathImpl::make_path_impl(label_triplet.src_label,
@@ -615,15 +600,40 @@ static void dfs(const GraphReadInterface& graph, vid_t src, vid_t dst,
   }
   cur_path.pop_back();
 }
+// As SingleShortestPathState, for all the shortest paths.
+struct AllShortestPathsState {
+  AllShortestPathsState(const GraphReadInterface& graph, label_t label)
+      : dist_from_src(graph.GetVertexSet(label), -1),
+        dist_from_dst(graph.GetVertexSet(label), -1),
+        visited(graph.GetVertexSet(label), false) {}
+
+  void reset() {
+    for (auto v : touched) {
+      dist_from_src[v] = -1;
+      dist_from_dst[v] = -1;
+      visited[v] = false;
+    }
+    touched.clear();
+  }
+
+  GraphReadInterface::vertex_array_t<int8_t> dist_from_src;
+  GraphReadInterface::vertex_array_t<int8_t> dist_from_dst;
+  GraphReadInterface::vertex_array_t<bool> visited;
+  std::vector<vid_t> touched;
+};
+
 static void all_shortest_path_with_given_source_and_dest_impl(
     const GraphReadInterface& graph, const ShortestPathParams& params,
-    vid_t src, vid_t dst, std::vector<std::vector<vid_t>>& paths) {
-  GraphReadInterface::vertex_array_t<int8_t> dist_from_src(
-      graph.GetVertexSet(params.labels[0].src_label), -1);
-  GraphReadInterface::vertex_array_t<int8_t> dist_from_dst(
-      graph.GetVertexSet(params.labels[0].dst_label), -1);
+    vid_t src, vid_t dst, AllShortestPathsState& state,
+    std::vector<std::vector<vid_t>>& paths) {
+  state.reset();
+  auto& dist_from_src = state.dist_from_src;
+  auto& dist_from_dst = state.dist_from_dst;
+  auto& touched = state.touched;
   dist_from_src[src] = 0;
   dist_from_dst[dst] = 0;
+  touched.push_back(src);
+  touched.push_back(dst);
   std::queue<vid_t> q1, q2, tmp;
   q1.push(src);
   q2.push(dst);
@@ -631,8 +641,8 @@ static void all_shortest_path_with_given_source_and_dest_impl(
   int8_t src_dep = 0, dst_dep = 0;
 
   while (true) {
-    if (src_dep >= params.hop_upper || dst_dep >= params.hop_upper ||
-        !vec.empty()) {
+    // Paths found at the next level are src_dep + dst_dep + 1 long.
+    if (src_dep + dst_dep + 1 >= params.hop_upper || !vec.empty()) {
       break;
     }
     if (q1.size() <= q2.size()) {
@@ -640,6 +650,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
         break;
       }
       while (!q1.empty()) {
+        QueryGuard::Check();
         vid_t v = q1.front();
         q1.pop();
         auto oe_iter = graph.GetOutEdgeIterator(params.labels[0].src_label, v,
@@ -650,6 +661,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
           if (dist_from_src[nbr] == -1) {
             dist_from_src[nbr] = src_dep + 1;
             tmp.push(nbr);
+            touched.push_back(nbr);
             if (dist_from_dst[nbr] != -1) {
               vec.push_back(nbr);
             }
@@ -664,6 +676,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
           if (dist_from_src[nbr] == -1) {
             dist_from_src[nbr] = src_dep + 1;
             tmp.push(nbr);
+            touched.push_back(nbr);
             if (dist_from_dst[nbr] != -1) {
               vec.push_back(nbr);
             }
@@ -678,6 +691,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
         break;
       }
       while (!q2.empty()) {
+        QueryGuard::Check();
         vid_t v = q2.front();
         q2.pop();
         auto oe_iter = graph.GetOutEdgeIterator(params.labels[0].dst_label, v,
@@ -688,6 +702,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
           if (dist_from_dst[nbr] == -1) {
             dist_from_dst[nbr] = dst_dep + 1;
             tmp.push(nbr);
+            touched.push_back(nbr);
             if (dist_from_src[nbr] != -1) {
               vec.push_back(nbr);
             }
@@ -702,6 +717,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
           if (dist_from_dst[nbr] == -1) {
             dist_from_dst[nbr] = dst_dep + 1;
             tmp.push(nbr);
+            touched.push_back(nbr);
             if (dist_from_src[nbr] != -1) {
               vec.push_back(nbr);
             }
@@ -715,6 +731,7 @@ static void all_shortest_path_with_given_source_and_dest_impl(
   }
 
   while (!q1.empty()) {
+    QueryGuard::Check();
     q1.pop();
   }
   if (vec.empty()) {
@@ -723,13 +740,13 @@ static void all_shortest_path_with_given_source_and_dest_impl(
   if (src_dep + dst_dep >= params.hop_upper) {
     return;
   }
-  GraphReadInterface::vertex_array_t<bool> visited(
-      graph.GetVertexSet(params.labels[0].src_label), false);
+  auto& visited = state.visited;
   for (auto v : vec) {
     q1.push(v);
     visited[v] = true;
   }
   while (!q1.empty()) {
+    QueryGuard::Check();
     auto v = q1.front();
     q1.pop();
     auto oe_iter = graph.GetOutEdgeIterator(params.labels[0].src_label, v,
@@ -812,10 +829,11 @@ bl::result<Context> PathExpand::all_shortest_paths_with_given_source_and_dest(
   GeneralPathColumnBuilder path_builder;
   std::vector<size_t> shuffle_offset;
   std::shared_ptr<Arena> arena = std::make_shared<Arena>();
+  AllShortestPathsState state(graph, label_triplet.src_label);
   foreach_vertex(input_vertex_list, [&](size_t index, label_t label, vid_t v) {
     std::vector<std::vector<vid_t>> paths;
-    all_shortest_path_with_given_source_and_dest_impl(graph, params, v,
-                                                      dest.second, paths);
+    all_shortest_path_with_given_source_and_dest_impl(
+        graph, params, v, dest.second, state, paths);
     for (auto& path : paths) {
       auto ptr = PathImpl::make_path_impl(label_triplet.src_label,
                                           label_triplet.edge_label, path);
@@ -881,6 +899,12 @@ bl::result<Context>
 PathExpand::single_source_shortest_path_with_special_vertex_predicate(
     const GraphReadInterface& graph, Context&& ctx,
     const ShortestPathParams& params, const SPVertexPredicate& pred) {
+  if (pred.type() == SPPredicateType::kPropertyConjunction) {
+    return PathExpand::single_source_shortest_path<
+        VertexPropertyConjunctionPredicate>(
+        graph, std::move(ctx), params,
+        dynamic_cast<const VertexPropertyConjunctionPredicate&>(pred));
+  }
   if (pred.data_type() == RTAnyType::kI64Value) {
     return _single_shortest_path<int64_t>(graph, std::move(ctx), params, pred);
   } else if (pred.data_type() == RTAnyType::kStringValue) {
@@ -57,6 +57,12 @@ class PathExpand {
   static bl::result<Context> edge_expand_v(const GraphReadInterface& graph,
                                            Context&& ctx,
                                            const PathExpandParams& params);
+  // edge_expand_v + Dedup on its end vertices, with the start vertices if
+  // per_start. The frontiers are sets, bitsets once they are large, expanded
+  // in parallel hop by hop.
+  static bl::result<Context> edge_expand_v_distinct(
+      const GraphReadInterface& graph, Context&& ctx,
+      const PathExpandParams& params, bool per_start);
   static bl::result<Context> edge_expand_p(const GraphReadInterface& graph,
                                            Context&& ctx,
                                            const PathExpandParams& params);
@@ -14,6 +14,8 @@
  */
 
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/path_expand_impl.h"
+#include "flex/engines/graph_db/runtime/common/utils/bitset.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 
 namespace gs {
 
@@ -57,11 +59,13 @@ iterative_expand_vertex(const GraphReadInterface& graph,
       if (depth >= lower && depth < upper) {
         if (depth == (upper - 1)) {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
           }
         } else {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
 
@@ -75,6 +79,7 @@ iterative_expand_vertex(const GraphReadInterface& graph,
         }
       } else if (depth < lower) {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           auto it = graph.GetOutEdgeIterator(input_label, pair.first,
                                              input_label, edge_label);
           while (it.IsValid()) {
@@ -92,11 +97,13 @@ iterative_expand_vertex(const GraphReadInterface& graph,
       if (depth >= lower && depth < upper) {
         if (depth == (upper - 1)) {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
           }
         } else {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
 
@@ -110,6 +117,7 @@ iterative_expand_vertex(const GraphReadInterface& graph,
         }
       } else if (depth < lower) {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           auto it = graph.GetInEdgeIterator(input_label, pair.first,
                                             input_label, edge_label);
           while (it.IsValid()) {
@@ -127,11 +135,13 @@ iterative_expand_vertex(const GraphReadInterface& graph,
       if (depth >= lower && depth < upper) {
         if (depth == (upper - 1)) {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
           }
         } else {
           for (auto& pair : input_list) {
+            QueryGuard::Check();
             builder.push_back_opt(pair.first);
             offsets.push_back(pair.second);
 
@@ -151,6 +161,7 @@ iterative_expand_vertex(const GraphReadInterface& graph,
         }
       } else if (depth < lower) {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           auto it0 = graph.GetInEdgeIterator(input_label, pair.first,
                                              input_label, edge_label);
           while (it0.IsValid()) {
@@ -271,6 +282,356 @@ path_expand_vertex_without_predicate_impl(
   return std::make_pair(ret, std::vector<size_t>());
 }
 
+namespace {
+
+// The neighbors of the vertices of label from along one label triplet and
+// direction, all of label to.
+class FrontierExpander {
+ public:
+  FrontierExpander(label_t from, label_t to) : from(from), to(to) {}
+  virtual ~FrontierExpander() = default;
+
+  // Sets the neighbors of v in next, appending those not set before to added
+  // unless it is null. Returns their number.
+  virtual size_t expand(vid_t v, Bitset& next,
+                        std::vector<vid_t>* added) const = 0;
+
+  label_t from;
+  label_t to;
+};
+
+template <typename EDATA_T>
+class TypedFrontierExpander : public FrontierExpander {
+ public:
+  TypedFrontierExpander(label_t from, label_t to,
+                        const GraphReadInterface::graph_view_t<EDATA_T>& view)
+      : FrontierExpander(from, to), view_(view) {}
+
+  size_t expand(vid_t v, Bitset& next,
+                std::vector<vid_t>* added) const override {
+    size_t num = 0;
+    for (auto& e : view_.get_edges(v)) {
+      vid_t u = e.get_neighbor();
+      if (next.atomic_set(u)) {
+        ++num;
+        if (added != nullptr) {
+          added->push_back(u);
+        }
+      }
+    }
+    return num;
+  }
+
+ private:
+  GraphReadInterface::graph_view_t<EDATA_T> view_;
+};
+
+template <typename EDATA_T>
+std::unique_ptr<FrontierExpander> make_typed_expander(
+    const GraphReadInterface& graph, label_t from, label_t to,
+    label_t e_label, bool out) {
+  auto view = out ? graph.GetOutgoingGraphView<EDATA_T>(from, to, e_label)
+                  : graph.GetIncomingGraphView<EDATA_T>(from, to, e_label);
+  if (view.is_null()) {
+    return nullptr;
+  }
+  return std::make_unique<TypedFrontierExpander<EDATA_T>>(from, to, view);
+}
+
+std::unique_ptr<FrontierExpander> make_expander(
+    const GraphReadInterface& graph, const LabelTriplet& triplet, bool out) {
+  const auto& properties = graph.schema().get_edge_properties(
+      triplet.src_label, triplet.dst_label, triplet.edge_label);
+  label_t from = out ? triplet.src_label : triplet.dst_label;
+  label_t to = out ? triplet.dst_label : triplet.src_label;
+  label_t e_label = triplet.edge_label;
+  if (properties.size() > 1) {
+    return nullptr;
+  }
+  if (properties.empty() || properties[0] == PropertyType::Empty()) {
+    return make_typed_expander<grape::EmptyType>(graph, from, to, e_label,
+                                                 out);
+  } else if (properties[0] == PropertyType::Int32()) {
+    return make_typed_expander<int>(graph, from, to, e_label, out);
+  } else if (properties[0] == PropertyType::Int64()) {
+    return make_typed_expander<int64_t>(graph, from, to, e_label, out);
+  } else if (properties[0] == PropertyType::Date()) {
+    return make_typed_expander<Date>(graph, from, to, e_label, out);
+  } else if (properties[0] == PropertyType::Double()) {
+    return make_typed_expander<double>(graph, from, to, e_label, out);
+  }
+  return nullptr;
+}
+
+// The vertices of one label at one depth. The bitset dedups them, and the
+// list keeps them as well while they are too few for a scan of the bitset
+// to pay off.
+struct LabelFrontier {
+  // A frontier is dense from one vertex in DENSE_RATIO on, one per word.
+  static constexpr size_t DENSE_RATIO = 64;
+
+  template <typename FUNC_T>
+  void foreach_word(size_t begin, size_t end, const FUNC_T& func) const {
+    for (size_t i = begin; i < end; ++i) {
+      uint64_t word = bits.get_word(i);
+      while (word != 0) {
+        func(static_cast<vid_t>(i * 64 + __builtin_ctzll(word)));
+        word &= word - 1;
+      }
+    }
+  }
+
+  // Drops the vertices pred returns true for, calling it once per vertex.
+  template <typename PRED_T>
+  void remove_if(const PRED_T& pred) {
+    if (sparse) {
+      size_t kept = 0;
+      for (auto v : list) {
+        if (pred(v)) {
+          bits.reset(v);
+        } else {
+          list[kept++] = v;
+        }
+      }
+      list.resize(kept);
+      count = kept;
+    } else {
+      foreach_word(0, bits.word_num(), [&](vid_t v) {
+        if (pred(v)) {
+          bits.reset(v);
+          --count;
+        }
+      });
+    }
+  }
+
+  // Called once the bits and the count are set.
+  void finish(bool listed) {
+    sparse = count * DENSE_RATIO < bits.size();
+    if (!sparse) {
+      list.clear();
+    } else if (!listed) {
+      list.clear();
+      foreach_word(0, bits.word_num(), [&](vid_t v) { list.push_back(v); });
+    }
+  }
+
+  void clear() {
+    if (sparse) {
+      for (auto v : list) {
+        bits.reset(v);
+      }
+    } else {
+      bits.reset_all();
+    }
+    list.clear();
+    count = 0;
+    sparse = true;
+  }
+
+  Bitset bits;
+  std::vector<vid_t> list;
+  bool sparse = true;
+  size_t count = 0;
+};
+
+// Expands cur into next, which is empty. The vertices of large frontiers are
+// expanded on the morsel pool, where the bitsets of next dedup the
+// neighbors found by every thread.
+void expand_frontier(
+    const std::vector<std::vector<const FrontierExpander*>>& expanders,
+    const std::vector<label_t>& frontier_labels,
+    const std::vector<LabelFrontier>& cur, std::vector<LabelFrontier>& next) {
+  // The list entries or the words of the frontier of a label.
+  struct Range {
+    label_t label;
+    size_t begin;
+    size_t end;
+  };
+  size_t total = 0;
+  // The neighbors are listed while every frontier expanded is.
+  bool listed = true;
+  for (auto l : frontier_labels) {
+    if (cur[l].count != 0 && !expanders[l].empty()) {
+      total += cur[l].count;
+      listed &= cur[l].sparse;
+    }
+  }
+  auto& pool = MorselPool::get();
+  size_t range_num = pool.Enabled(total) ? pool.MorselNum(total) : 1;
+  std::vector<Range> ranges;
+  for (auto l : frontier_labels) {
+    if (cur[l].count == 0 || expanders[l].empty()) {
+      continue;
+    }
+    size_t len = cur[l].sparse ? cur[l].list.size() : cur[l].bits.word_num();
+    size_t num = std::min(len, range_num);
+    for (size_t k = 0; k < num; ++k) {
+      ranges.push_back({l, len * k / num, len * (k + 1) / num});
+    }
+  }
+
+  size_t label_num = next.size();
+  std::vector<std::vector<size_t>> counts(ranges.size(),
+                                          std::vector<size_t>(label_num, 0));
+  std::vector<std::vector<std::vector<vid_t>>> added(
+      ranges.size(), std::vector<std::vector<vid_t>>(listed ? label_num : 0));
+  auto expand_range = [&](size_t r) {
+    const auto& range = ranges[r];
+    const auto& frontier = cur[range.label];
+    auto expand = [&](vid_t v) {
+      for (auto expander : expanders[range.label]) {
+        counts[r][expander->to] +=
+            expander->expand(v, next[expander->to].bits,
+                             listed ? &added[r][expander->to] : nullptr);
+      }
+    };
+    if (frontier.sparse) {
+      for (size_t i = range.begin; i < range.end; ++i) {
+        expand(frontier.list[i]);
+      }
+    } else {
+      frontier.foreach_word(range.begin, range.end, expand);
+    }
+  };
+  if (ranges.size() > 1) {
+    pool.Run(ranges.size(), expand_range);
+  } else if (ranges.size() == 1) {
+    expand_range(0);
+  }
+
+  for (auto l : frontier_labels) {
+    auto& frontier = next[l];
+    for (size_t r = 0; r < ranges.size(); ++r) {
+      frontier.count += counts[r][l];
+      if (listed) {
+        frontier.list.insert(frontier.list.end(), added[r][l].begin(),
+                             added[r][l].end());
+      }
+    }
+    frontier.finish(listed);
+  }
+}
+
+}  // namespace
+
+bool path_expand_distinct_vertex_impl(
+    const GraphReadInterface& graph, const IVertexColumn& input,
+    const std::vector<LabelTriplet>& labels, Direction dir, int lower,
+    int upper, bool per_start, std::shared_ptr<IContextColumn>& col,
+    std::vector<size_t>& offsets) {
+  size_t label_num = graph.schema().vertex_label_num();
+  std::vector<std::unique_ptr<FrontierExpander>> owned;
+  std::vector<std::vector<const FrontierExpander*>> expanders(label_num);
+  std::set<label_t> used_labels = input.get_labels_set();
+  std::set<label_t> output_labels;
+  if (lower == 0) {
+    output_labels = used_labels;
+  }
+  for (const auto& triplet : labels) {
+    for (bool out : {true, false}) {
+      if ((out && dir == Direction::kIn) || (!out && dir == Direction::kOut)) {
+        continue;
+      }
+      auto expander = make_expander(graph, triplet, out);
+      if (expander == nullptr) {
+        return false;
+      }
+      expanders[expander->from].push_back(expander.get());
+      used_labels.insert(expander->to);
+      output_labels.insert(expander->to);
+      owned.emplace_back(std::move(expander));
+    }
+  }
+  std::vector<label_t> frontier_labels(used_labels.begin(), used_labels.end());
+
+  // None of them is copied, the vectors are sized once.
+  std::vector<LabelFrontier> cur(label_num), next(label_num);
+  std::vector<Bitset> started(label_num), seen(label_num),
+      emitted(per_start ? 0 : label_num);
+  for (auto l : frontier_labels) {
+    size_t vertex_num = graph.GetVertexSet(l).size();
+    cur[l].bits.resize(vertex_num);
+    next[l].bits.resize(vertex_num);
+    started[l].resize(vertex_num);
+    seen[l].resize(vertex_num);
+    if (!per_start) {
+      emitted[l].resize(vertex_num);
+    }
+  }
+  std::vector<std::vector<vid_t>> seen_lists(label_num);
+  std::vector<VertexRecord> vertices;
+
+  foreach_vertex(input, [&](size_t index, label_t label, vid_t v) {
+    // A repeated start vertex reaches the same vertices again.
+    if (started[label].get(v)) {
+      return;
+    }
+    started[label].set(v);
+    cur[label].bits.set(v);
+    cur[label].list.push_back(v);
+    cur[label].count = 1;
+    for (int depth = 0; depth < upper; ++depth) {
+      if (depth >= lower) {
+        for (auto l : frontier_labels) {
+          // A vertex seen at an earlier depth in the range reached all the
+          // vertices it can reach from here already.
+          cur[l].remove_if([&](vid_t u) {
+            if (seen[l].get(u)) {
+              return true;
+            }
+            seen[l].set(u);
+            seen_lists[l].push_back(u);
+            if (per_start || !emitted[l].get(u)) {
+              if (!per_start) {
+                emitted[l].set(u);
+              }
+              vertices.push_back({l, u});
+              offsets.push_back(index);
+            }
+            return false;
+          });
+        }
+      }
+      if (depth + 1 >= upper) {
+        break;
+      }
+      expand_frontier(expanders, frontier_labels, cur, next);
+      bool empty = true;
+      for (auto l : frontier_labels) {
+        cur[l].clear();
+        empty &= (next[l].count == 0);
+      }
+      std::swap(cur, next);
+      if (empty) {
+        break;
+      }
+    }
+    for (auto l : frontier_labels) {
+      cur[l].clear();
+      for (auto u : seen_lists[l]) {
+        seen[l].reset(u);
+      }
+      seen_lists[l].clear();
+    }
+  });
+
+  if (output_labels.size() == 1) {
+    auto builder = SLVertexColumnBuilder::builder(*output_labels.begin());
+    for (const auto& vertex : vertices) {
+      builder.push_back_opt(vertex.vid_);
+    }
+    col = builder.finish(nullptr);
+  } else {
+    auto builder = MLVertexColumnBuilder::builder(output_labels);
+    for (const auto& vertex : vertices) {
+      builder.push_back_vertex(vertex);
+    }
+    col = builder.finish(nullptr);
+  }
+  return true;
+}
+
 }  // namespace runtime
 
 }  // namespace gs
@@ -67,11 +67,13 @@ iterative_expand_vertex_on_graph_view(
     if (depth >= lower && depth < upper) {
       if (depth == (upper - 1)) {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           builder.push_back_opt(pair.first);
           offsets.push_back(pair.second);
         }
       } else {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           builder.push_back_opt(pair.first);
           offsets.push_back(pair.second);
 
@@ -83,6 +85,7 @@ iterative_expand_vertex_on_graph_view(
       }
     } else if (depth < lower) {
       for (auto& pair : input_list) {
+        QueryGuard::Check();
         auto es = view.get_edges(pair.first);
         for (auto& e : es) {
           output_list.emplace_back(e.get_neighbor(), pair.second);
@@ -133,11 +136,13 @@ iterative_expand_vertex_on_dual_graph_view(
     if (depth >= lower && depth < upper) {
       if (depth == (upper - 1)) {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           builder.push_back_opt(pair.first);
           offsets.push_back(pair.second);
         }
       } else {
         for (auto& pair : input_list) {
+          QueryGuard::Check();
           builder.push_back_opt(pair.first);
           offsets.push_back(pair.second);
 
@@ -153,6 +158,7 @@ iterative_expand_vertex_on_dual_graph_view(
       }
     } else if (depth < lower) {
       for (auto& pair : input_list) {
+        QueryGuard::Check();
         auto ies = iview.get_edges(pair.first);
         for (auto& e : ies) {
           output_list.emplace_back(e.get_neighbor(), pair.second);
@@ -175,6 +181,16 @@ path_expand_vertex_without_predicate_impl(
     const std::vector<LabelTriplet>& labels, Direction dir, int lower,
     int upper);
 
+// The distinct end vertices of the walks of [lower, upper) hops from the
+// input vertices, each with the first input row reaching it, or with every
+// first row of a distinct input vertex reaching it if per_start. Returns
+// false if an edge label triplet is not kept in a typed csr.
+bool path_expand_distinct_vertex_impl(
+    const GraphReadInterface& graph, const IVertexColumn& input,
+    const std::vector<LabelTriplet>& labels, Direction dir, int lower,
+    int upper, bool per_start, std::shared_ptr<IContextColumn>& col,
+    std::vector<size_t>& offsets);
+
 template <typename EDATA_T, typename PRED_T>
 void sssp_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view,
               label_t v_label, vid_t v, label_t e_label,
@@ -193,6 +209,7 @@ void sssp_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view,
     if (depth >= lower) {
       if (depth == upper - 1) {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             std::vector<vid_t> path(depth + 1);
             vid_t x = u;
@@ -210,6 +227,7 @@ void sssp_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view,
         }
       } else {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             std::vector<vid_t> path(depth + 1);
             vid_t x = u;
@@ -235,6 +253,7 @@ void sssp_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view,
       }
     } else {
       for (auto u : cur) {
+        QueryGuard::Check();
         for (auto& e : view.get_edges(u)) {
           auto nbr = e.get_neighbor();
           if (parent[nbr] == GraphReadInterface::kInvalidVid) {
@@ -271,6 +290,7 @@ void sssp_both_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view0,
     if (depth >= lower) {
       if (depth == upper - 1) {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             std::vector<vid_t> path(depth + 1);
             vid_t x = u;
@@ -288,6 +308,7 @@ void sssp_both_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view0,
         }
       } else {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             std::vector<vid_t> path(depth + 1);
             vid_t x = u;
@@ -320,6 +341,7 @@ void sssp_both_dir(const GraphReadInterface::graph_view_t<EDATA_T>& view0,
       }
     } else {
       for (auto u : cur) {
+        QueryGuard::Check();
         for (auto& e : view0.get_edges(u)) {
           auto nbr = e.get_neighbor();
           if (parent[nbr] == GraphReadInterface::kInvalidVid) {
@@ -364,6 +386,7 @@ void sssp_both_dir_with_order_by_length_limit(
     if (depth >= lower) {
       if (depth == upper - 1) {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             dest_col_builder.push_back_opt(u);
 
@@ -373,6 +396,7 @@ void sssp_both_dir_with_order_by_length_limit(
         }
       } else {
         for (auto u : cur) {
+          QueryGuard::Check();
           if (pred(v_label, u)) {
             dest_col_builder.push_back_opt(u);
 
@@ -397,6 +421,7 @@ void sssp_both_dir_with_order_by_length_limit(
       }
     } else {
       for (auto u : cur) {
+        QueryGuard::Check();
         for (auto& e : view0.get_edges(u)) {
           auto nbr = e.get_neighbor();
           if (!vis[nbr]) {
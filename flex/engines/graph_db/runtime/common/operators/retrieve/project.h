@@ -116,6 +116,9 @@ class Project {
     return ret;
   }
 
+  // Projects the exprs of order_index, orders and limits the rows by them,
+  // then projects the other exprs on the rows left only. An append keeps the
+  // columns of ctx.
   template <typename Comparer>
   static bl::result<Context> project_order_by_fuse(
       const GraphReadInterface& graph,
@@ -126,7 +129,7 @@ class Project {
           const Context& ctx)>>& exprs,
       const std::function<Comparer(const Context&)>& cmp, size_t lower,
       size_t upper, const std::set<int>& order_index,
-      const std::tuple<int, int, bool>& first_key) {
+      const std::tuple<int, int, bool>& first_key, bool is_append = false) {
     lower = std::max(lower, static_cast<size_t>(0));
     upper = std::min(upper, ctx.row_num());
 
@@ -170,8 +173,12 @@ class Project {
       ctx = std::move(ctx_res.value());
     }
 
-    for (int i : alias) {
-      ret.set(i, ctx.get(i));
+    if (is_append) {
+      ret = ctx;
+    } else {
+      for (int i : alias) {
+        ret.set(i, ctx.get(i));
+      }
     }
     for (size_t i = 0; i < exprs.size(); ++i) {
       if (order_index.find(i) == order_index.end()) {
@@ -18,6 +18,37 @@
 namespace gs {
 namespace runtime {
 
+void Scan::get_vertex_indices(const GraphReadInterface& graph, label_t label,
+                              const std::vector<Any>& oids,
+                              std::vector<vid_t>& vids) {
+  vids.resize(oids.size());
+  auto is_of_type = [&oids](const PropertyType& type) {
+    return std::all_of(oids.begin(), oids.end(),
+                       [&type](const Any& oid) { return oid.type == type; });
+  };
+  if (is_of_type(PropertyType::kInt64)) {
+    std::vector<int64_t> keys;
+    keys.reserve(oids.size());
+    for (const auto& oid : oids) {
+      keys.push_back(oid.AsInt64());
+    }
+    graph.GetVertexIndexBatch(label, keys.data(), keys.size(), vids.data());
+  } else if (is_of_type(PropertyType::kStringView)) {
+    std::vector<std::string_view> keys;
+    keys.reserve(oids.size());
+    for (const auto& oid : oids) {
+      keys.push_back(oid.AsStringView());
+    }
+    graph.GetVertexIndexBatch(label, keys.data(), keys.size(), vids.data());
+  } else {
+    for (size_t i = 0; i < oids.size(); ++i) {
+      if (!graph.GetVertexIndex(label, oids[i], vids[i])) {
+        vids[i] = std::numeric_limits<vid_t>::max();
+      }
+    }
+  }
+}
+
 bl::result<Context> Scan::find_vertex_with_oid(Context&& ctx,
                                                const GraphReadInterface& graph,
                                                label_t label, const Any& oid,
@@ -84,6 +115,11 @@ static bl::result<Context> _scan_vertex_with_special_vertex_predicate(
 bl::result<Context> Scan::scan_vertex_with_special_vertex_predicate(
     Context&& ctx, const GraphReadInterface& graph, const ScanParams& params,
     const SPVertexPredicate& pred) {
+  if (pred.type() == SPPredicateType::kPropertyConjunction) {
+    return Scan::scan_vertex<VertexPropertyConjunctionPredicate>(
+        std::move(ctx), graph, params,
+        dynamic_cast<const VertexPropertyConjunctionPredicate&>(pred));
+  }
   if (pred.data_type() == RTAnyType::kI64Value) {
     return _scan_vertex_with_special_vertex_predicate<int64_t>(
         std::move(ctx), graph, params, pred);
@@ -147,6 +183,12 @@ static bl::result<Context> _filter_gids_with_special_vertex_predicate(
 bl::result<Context> Scan::filter_gids_with_special_vertex_predicate(
     Context&& ctx, const GraphReadInterface& graph, const ScanParams& params,
     const SPVertexPredicate& predicate, const std::vector<int64_t>& oids) {
+  if (predicate.type() == SPPredicateType::kPropertyConjunction) {
+    return Scan::filter_gids<VertexPropertyConjunctionPredicate>(
+        std::move(ctx), graph, params,
+        dynamic_cast<const VertexPropertyConjunctionPredicate&>(predicate),
+        oids);
+  }
   if (predicate.data_type() == RTAnyType::kI64Value) {
     return _filter_gids_with_special_vertex_predicate<int64_t>(
         std::move(ctx), graph, params, predicate, oids);
@@ -210,6 +252,12 @@ static bl::result<Context> _filter_oid_with_special_vertex_predicate(
 bl::result<Context> Scan::filter_oids_with_special_vertex_predicate(
     Context&& ctx, const GraphReadInterface& graph, const ScanParams& params,
     const SPVertexPredicate& predicate, const std::vector<Any>& oids) {
+  if (predicate.type() == SPPredicateType::kPropertyConjunction) {
+    return Scan::filter_oids<VertexPropertyConjunctionPredicate>(
+        std::move(ctx), graph, params,
+        dynamic_cast<const VertexPropertyConjunctionPredicate&>(predicate),
+        oids);
+  }
   if (predicate.data_type() == RTAnyType::kI64Value) {
     return _filter_oid_with_special_vertex_predicate<int64_t>(
         std::move(ctx), graph, params, predicate, oids);
@@ -106,6 +106,30 @@ class Scan {
       Context&& ctx, const GraphReadInterface& graph, const ScanParams& params,
       const SPVertexPredicate& pred);
 
+  // As scan_vertex, over the given vertices of the single label of params in
+  // the given order instead of all of them.
+  template <typename PRED_T>
+  static bl::result<Context> filter_vids(Context&& ctx,
+                                         const GraphReadInterface& graph,
+                                         const ScanParams& params,
+                                         const PRED_T& predicate,
+                                         const std::vector<vid_t>& vids) {
+    int32_t cur_limit = params.limit;
+    label_t label = params.tables[0];
+    auto builder = SLVertexColumnBuilder::builder(label);
+    for (auto vid : vids) {
+      if (cur_limit <= 0) {
+        break;
+      }
+      if (predicate(label, vid)) {
+        builder.push_back_opt(vid);
+        cur_limit--;
+      }
+    }
+    ctx.set(params.alias, builder.finish(nullptr));
+    return ctx;
+  }
+
   template <typename PRED_T>
   static bl::result<Context> filter_gids(Context&& ctx,
                                          const GraphReadInterface& graph,
@@ -161,19 +185,19 @@ class Scan {
                                          const PRED_T& predicate,
                                          const std::vector<Any>& oids) {
     auto limit = params.limit;
+    static constexpr vid_t absent = std::numeric_limits<vid_t>::max();
+    std::vector<vid_t> oid_vids;
     if (params.tables.size() == 1) {
       label_t label = params.tables[0];
       auto builder = SLVertexColumnBuilder::builder(label);
-      for (auto oid : oids) {
+      get_vertex_indices(graph, label, oids, oid_vids);
+      for (auto vid : oid_vids) {
         if (limit <= 0) {
           break;
         }
-        vid_t vid;
-        if (graph.GetVertexIndex(label, oid, vid)) {
-          if (predicate(label, vid)) {
-            builder.push_back_opt(vid);
-            --limit;
-          }
+        if (vid != absent && predicate(label, vid)) {
+          builder.push_back_opt(vid);
+          --limit;
         }
       }
       ctx.set(params.alias, builder.finish(nullptr));
@@ -184,16 +208,14 @@ class Scan {
         if (limit <= 0) {
           break;
         }
-        for (auto oid : oids) {
+        get_vertex_indices(graph, label, oids, oid_vids);
+        for (auto vid : oid_vids) {
           if (limit <= 0) {
             break;
           }
-          vid_t vid;
-          if (graph.GetVertexIndex(label, oid, vid)) {
-            if (predicate(label, vid)) {
-              vids.emplace_back(label, vid);
-              --limit;
-            }
+          if (vid != absent && predicate(label, vid)) {
+            vids.emplace_back(label, vid);
+            --limit;
           }
         }
       }
@@ -216,6 +238,13 @@ class Scan {
       Context&& ctx, const GraphReadInterface& graph, const ScanParams& params,
       const SPVertexPredicate& predicate, const std::vector<Any>& oids);
 
+  // Sets vids[i] to the vertex of label with oids[i], or to the max of vid_t
+  // if there is none, looking the oids up in a batch when they are all
+  // int64 or all strings.
+  static void get_vertex_indices(const GraphReadInterface& graph,
+                                 label_t label, const std::vector<Any>& oids,
+                                 std::vector<vid_t>& vids);
+
   static bl::result<Context> find_vertex_with_oid(
       Context&& ctx, const GraphReadInterface& graph, label_t label,
       const Any& pk, int32_t alias);
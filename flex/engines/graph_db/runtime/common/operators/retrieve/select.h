@@ -16,6 +16,8 @@
 #ifndef RUNTIME_COMMON_OPERATORS_RETRIEVE_SELECT_H_
 #define RUNTIME_COMMON_OPERATORS_RETRIEVE_SELECT_H_
 
+#include <numeric>
+
 #include "flex/engines/graph_db/runtime/common/context.h"
 #include "flex/engines/graph_db/runtime/common/leaf_utils.h"
 
@@ -38,6 +40,19 @@ class Select {
     ctx.reshuffle(offsets);
     return ctx;
   }
+
+  // filter is given all the rows and keeps those to select, for predicates
+  // evaluated over the whole context at once.
+  template <typename FILTER_T>
+  static bl::result<Context> select_batch(Context&& ctx,
+                                          const FILTER_T& filter) {
+    std::vector<size_t> offsets(ctx.row_num());
+    std::iota(offsets.begin(), offsets.end(), 0);
+    filter(offsets);
+
+    ctx.reshuffle(offsets);
+    return ctx;
+  }
 };
 
 }  // namespace runtime
@@ -16,6 +16,7 @@
 #ifndef RUNTIME_COMMON_OPERATORS_RETRIEVE_SINK_H_
 #define RUNTIME_COMMON_OPERATORS_RETRIEVE_SINK_H_
 
+#include "flex/engines/graph_db/database/read_transaction.h"
 #include "flex/engines/graph_db/runtime/common/context.h"
 #include "flex/utils/app_utils.h"
 
@@ -27,9 +28,15 @@ class Sink {
   template <typename GraphInterface>
   static void sink(const Context& ctx, const GraphInterface& graph,
                    Encoder& output) {
-    size_t row_num = ctx.row_num();
+    sink(ctx, graph, 0, ctx.row_num(), output);
+  }
+
+  // Sinks the rows in [begin, end) only.
+  template <typename GraphInterface>
+  static void sink(const Context& ctx, const GraphInterface& graph,
+                   size_t begin, size_t end, Encoder& output) {
     results::CollectiveResults results;
-    for (size_t i = 0; i < row_num; ++i) {
+    for (size_t i = begin; i < end; ++i) {
       auto result = results.add_results();
       for (size_t j : ctx.tag_ids) {
         auto col = ctx.get(j);
@@ -88,6 +95,48 @@ class Sink {
   }
 };
 
+/**
+ * @brief Sinks the rows of a context as Sink::sink does, about CHUNK_SIZE
+ * bytes at a time, each piece a CollectiveResults of consecutive rows. As
+ * results is a repeated field, the pieces put together parse as the message
+ * Sink::sink writes.
+ *
+ * The read transaction the context was computed in is kept open until the
+ * stream is destroyed, updates waiting for it meanwhile.
+ */
+class SinkStream : public ResultStream {
+ public:
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+
+  SinkStream(std::unique_ptr<ReadTransaction>&& txn, Context&& ctx)
+      : txn_(std::move(txn)),
+        ctx_(std::move(ctx)),
+        row_(0),
+        chunk_rows_(1024) {}
+
+  bool Next(std::vector<char>& out) override {
+    size_t row_num = ctx_.row_num();
+    if (row_ >= row_num) {
+      return false;
+    }
+    size_t end = std::min(row_num, row_ + chunk_rows_);
+    size_t size = out.size();
+    Encoder encoder(out);
+    Sink::sink(ctx_, *txn_, row_, end, encoder);
+    // Sizes the next chunk from the bytes per row of this one.
+    size_t bytes = std::max<size_t>(out.size() - size, 1);
+    chunk_rows_ = std::max<size_t>(1, (end - row_) * CHUNK_SIZE / bytes);
+    row_ = end;
+    return true;
+  }
+
+ private:
+  std::unique_ptr<ReadTransaction> txn_;
+  Context ctx_;
+  size_t row_;
+  size_t chunk_rows_;
+};
+
 }  // namespace runtime
 }  // namespace gs
 
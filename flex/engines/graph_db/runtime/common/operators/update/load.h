@@ -31,25 +31,29 @@ class Load {
       label_t dst_label_id, label_t edge_label_id, PropertyType& src_pk_type,
       PropertyType& dst_pk_type, PropertyType& edge_prop_type, int src_index,
       int dst_index, int prop_index) {
+    // The columns are converted first and the edges added as one batch.
+    int row_num = ctxs.row_num();
+    auto& src = ctxs.get(src_index);
+    auto& dst = ctxs.get(dst_index);
+    std::vector<Any> srcs, dsts;
+    srcs.reserve(row_num);
+    dsts.reserve(row_num);
+    for (int i = 0; i < row_num; i++) {
+      srcs.emplace_back(src.get(i).to_any(src_pk_type));
+      dsts.emplace_back(dst.get(i).to_any(dst_pk_type));
+    }
+    std::vector<std::vector<Any>> prop_columns;
     // grape::EmptyType
-    if (edge_prop_type == PropertyType::kEmpty) {
-      auto& src = ctxs.get(src_index);
-      auto& dst = ctxs.get(dst_index);
-      for (int i = 0; i < ctxs.row_num(); i++) {
-        graph.AddEdge(src_label_id, src.get(i).to_any(src_pk_type),
-                      dst_label_id, dst.get(i).to_any(dst_pk_type),
-                      edge_label_id, Any());
-      }
-    } else {
-      auto& src = ctxs.get(src_index);
-      auto& dst = ctxs.get(dst_index);
+    if (edge_prop_type != PropertyType::kEmpty) {
       auto& prop = ctxs.get(prop_index);
-      for (int i = 0; i < ctxs.row_num(); i++) {
-        graph.AddEdge(src_label_id, src.get(i).to_any(src_pk_type),
-                      dst_label_id, dst.get(i).to_any(dst_pk_type),
-                      edge_label_id, prop.get(i).to_any(edge_prop_type));
+      auto& column = prop_columns.emplace_back();
+      column.reserve(row_num);
+      for (int i = 0; i < row_num; i++) {
+        column.emplace_back(prop.get(i).to_any(edge_prop_type));
       }
     }
+    graph.AddEdges(src_label_id, dst_label_id, edge_label_id, srcs, dsts,
+                   prop_columns);
     return ctxs;
   }
 
@@ -761,6 +761,9 @@ void sink_vertex(const GraphReadInterface& graph, const VertexRecord& vertex,
            pk_prop->mutable_value());
 
   for (size_t i = 0; i < names.size(); ++i) {
+    if (graph.schema().is_dropped_vertex_property(vertex.label_, i)) {
+      continue;
+    }
     auto prop = v->add_properties();
     prop->mutable_key()->set_name(names[i]);
     sink_any(graph.GetVertexProperty(vertex.label_, vertex.vid_, i),
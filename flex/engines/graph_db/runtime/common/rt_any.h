@@ -21,6 +21,7 @@
 
 #include "flex/engines/graph_db/runtime/common/graph_interface.h"
 #include "flex/engines/graph_db/runtime/common/types.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_arena.h"
 #include "flex/utils/app_utils.h"
 
 namespace gs {
@@ -30,6 +31,10 @@ namespace runtime {
 class CObject {
  public:
   virtual ~CObject() = default;
+
+  // The values of a query are taken from its session's QueryArena.
+  static void* operator new(size_t size) { return QueryArena::Allocate(size); }
+  static void operator delete(void* ptr) { QueryArena::Deallocate(ptr); }
 };
 
 using Arena = std::vector<std::unique_ptr<CObject>>;
@@ -318,17 +323,40 @@ class MapImpl : public CObject {
   std::vector<RTAny> values;
 };
 
+// The bytes of a string follow the object within a single allocation from
+// the QueryArena, so that a string built by an expression costs one bump of
+// the arena rather than a heap allocation for the object and its buffer.
 class StringImpl : public CObject {
  public:
   std::string_view str_view() const {
-    return std::string_view(str.data(), str.size());
+    return std::string_view(data(), size_);
+  }
+  static std::unique_ptr<StringImpl> make_string_impl(std::string_view str) {
+    return make_string_impl({str});
   }
-  static std::unique_ptr<StringImpl> make_string_impl(const std::string& str) {
-    auto new_str = std::make_unique<StringImpl>();
-    new_str->str = str;
+  // The concatenation of parts.
+  static std::unique_ptr<StringImpl> make_string_impl(
+      std::initializer_list<std::string_view> parts) {
+    size_t size = 0;
+    for (auto part : parts) {
+      size += part.size();
+    }
+    void* mem = QueryArena::Allocate(sizeof(StringImpl) + size);
+    std::unique_ptr<StringImpl> new_str(::new (mem) StringImpl(size));
+    char* dst = new_str->data();
+    for (auto part : parts) {
+      memcpy(dst, part.data(), part.size());
+      dst += part.size();
+    }
     return new_str;
   }
-  std::string str;
+
+ private:
+  explicit StringImpl(size_t size) : size_(size) {}
+  char* data() { return reinterpret_cast<char*>(this + 1); }
+  const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+
+  size_t size_;
 };
 
 enum class RTAnyType {
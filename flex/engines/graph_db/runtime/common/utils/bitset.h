@@ -93,6 +93,19 @@ class Bitset : public SPAllocator<uint64_t> {
     return data_[WORD_INDEX(i)] & (1ul << BIT_OFFSET(i));
   }
 
+  // Safe against concurrent sets, returns false if the bit was set already.
+  bool atomic_set(size_t i) {
+    uint64_t mask = 1ul << BIT_OFFSET(i);
+    return !(__atomic_fetch_or(&data_[WORD_INDEX(i)], mask, __ATOMIC_RELAXED) &
+             mask);
+  }
+
+  size_t size() const { return size_; }
+
+  size_t word_num() const { return size_in_words_; }
+
+  uint64_t get_word(size_t i) const { return data_[i]; }
+
  private:
   uint64_t* data_;
   size_t size_;
@@ -0,0 +1,125 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/runtime/common/utils/query_arena.h"
+
+#include <stdlib.h>
+#include <new>
+
+#include <glog/logging.h>
+
+namespace gs {
+
+namespace runtime {
+
+static thread_local QueryArena* current_arena = nullptr;
+static thread_local size_t allocated_bytes = 0;
+
+QueryArena::QueryArena() : cur_(nullptr) {}
+
+QueryArena::~QueryArena() {
+  reset();
+  for (auto chunk : free_) {
+    delete chunk;
+  }
+  if (!pinned_.empty()) {
+    // Freeing them would break the objects still alive.
+    LOG(WARNING) << pinned_.size() << " query arena chunks are still in use";
+  }
+}
+
+void* QueryArena::Allocate(size_t size) {
+  allocated_bytes += size;
+  QueryArena* arena = current_arena;
+  if (arena != nullptr && size <= MAX_ALLOC_SIZE) {
+    return arena->allocate(size);
+  }
+  Header* header = static_cast<Header*>(malloc(sizeof(Header) + size));
+  if (header == nullptr) {
+    throw std::bad_alloc();
+  }
+  header->chunk = nullptr;
+  return header + 1;
+}
+
+size_t QueryArena::AllocatedBytes() { return allocated_bytes; }
+
+void QueryArena::Deallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header* header = static_cast<Header*>(ptr) - 1;
+  if (header->chunk == nullptr) {
+    free(header);
+  } else {
+    header->chunk->live.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+void* QueryArena::allocate(size_t size) {
+  constexpr size_t align = alignof(std::max_align_t);
+  size_t need = sizeof(Header) + (size + align - 1) / align * align;
+  if (cur_ == nullptr || cur_->used + need > CHUNK_SIZE) {
+    if (free_.empty()) {
+      cur_ = new Chunk;
+    } else {
+      cur_ = free_.back();
+      free_.pop_back();
+    }
+    used_.push_back(cur_);
+  }
+  Header* header = reinterpret_cast<Header*>(cur_->data + cur_->used);
+  cur_->used += need;
+  cur_->live.fetch_add(1, std::memory_order_relaxed);
+  header->chunk = cur_;
+  return header + 1;
+}
+
+void QueryArena::reset() {
+  std::vector<Chunk*> pinned;
+  auto recycle = [&](Chunk* chunk) {
+    if (chunk->live.load(std::memory_order_acquire) != 0) {
+      pinned.push_back(chunk);
+    } else if (free_.size() < MAX_FREE_CHUNKS) {
+      chunk->used = 0;
+      free_.push_back(chunk);
+    } else {
+      delete chunk;
+    }
+  };
+  for (auto chunk : used_) {
+    recycle(chunk);
+  }
+  for (auto chunk : pinned_) {
+    recycle(chunk);
+  }
+  used_.clear();
+  pinned_.swap(pinned);
+  cur_ = nullptr;
+}
+
+QueryArenaScope::QueryArenaScope(QueryArena& arena)
+    : arena_(arena), prev_(current_arena) {
+  current_arena = &arena;
+}
+
+QueryArenaScope::~QueryArenaScope() {
+  current_arena = prev_;
+  arena_.reset();
+}
+
+}  // namespace runtime
+
+}  // namespace gs
@@ -0,0 +1,104 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUNTIME_COMMON_UTILS_QUERY_ARENA_H_
+#define RUNTIME_COMMON_UTILS_QUERY_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace gs {
+
+namespace runtime {
+
+/**
+ * @brief A bump allocator for the small objects of the queries of one
+ * session, used by the operator new of CObject within a QueryArenaScope.
+ *
+ * Every allocation is prefixed with the chunk it is taken from, whose live
+ * count drops as the objects are freed. Once a query is done, the chunks of
+ * which every object is freed are recycled at once. An object kept past its
+ * query pins its chunk until it is freed, on any thread.
+ */
+class QueryArena {
+ public:
+  static constexpr size_t CHUNK_SIZE = 64 * 1024;
+  // Larger allocations go to malloc.
+  static constexpr size_t MAX_ALLOC_SIZE = CHUNK_SIZE / 16;
+  // The recycled chunks kept beyond are released.
+  static constexpr size_t MAX_FREE_CHUNKS = 64;
+
+  QueryArena();
+  ~QueryArena();
+
+  QueryArena(const QueryArena&) = delete;
+  QueryArena& operator=(const QueryArena&) = delete;
+
+  // From the arena of the scope of this thread if any, from malloc if not.
+  static void* Allocate(size_t size);
+  static void Deallocate(void* ptr);
+
+  // The bytes requested from Allocate on this thread so far.
+  static size_t AllocatedBytes();
+
+ private:
+  friend class QueryArenaScope;
+
+  struct Chunk {
+    std::atomic<size_t> live{0};
+    size_t used = 0;
+    alignas(alignof(std::max_align_t)) char data[CHUNK_SIZE];
+  };
+
+  struct alignas(alignof(std::max_align_t)) Header {
+    // nullptr if taken from malloc.
+    Chunk* chunk;
+  };
+
+  void* allocate(size_t size);
+  void reset();
+
+  Chunk* cur_;
+  // The chunks taken by the running query, cur_ included.
+  std::vector<Chunk*> used_;
+  std::vector<Chunk*> free_;
+  // The chunks with objects of earlier queries.
+  std::vector<Chunk*> pinned_;
+};
+
+/**
+ * @brief Allocates the CObjects created on this thread from arena while
+ * alive, and recycles the memory of arena when destroyed. The objects of
+ * the query must be freed first, so the scope is declared before them.
+ */
+class QueryArenaScope {
+ public:
+  explicit QueryArenaScope(QueryArena& arena);
+  ~QueryArenaScope();
+
+  QueryArenaScope(const QueryArenaScope&) = delete;
+  QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+
+ private:
+  QueryArena& arena_;
+  QueryArena* prev_;
+};
+
+}  // namespace runtime
+
+}  // namespace gs
+
+#endif  // RUNTIME_COMMON_UTILS_QUERY_ARENA_H_
@@ -0,0 +1,83 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
+
+namespace gs {
+
+namespace runtime {
+
+thread_local QueryGuard* QueryGuard::current_ = nullptr;
+thread_local uint32_t QueryGuard::ticks_ = 0;
+
+QueryGuard::QueryGuard(int64_t timeout_ms, size_t memory_budget)
+    : has_deadline_(timeout_ms > 0),
+      memory_budget_(memory_budget),
+      charged_(0),
+      cancelled_(false),
+      reason_(static_cast<int>(Reason::kNone)) {
+  if (has_deadline_) {
+    deadline_ = std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(timeout_ms);
+  }
+}
+
+std::string QueryGuard::message() const {
+  switch (reason()) {
+  case Reason::kCancelled:
+    return "Query cancelled";
+  case Reason::kTimeout:
+    return "Query timed out";
+  case Reason::kMemory:
+    return "Query exceeded its memory budget of " +
+           std::to_string(memory_budget_) + " bytes";
+  default:
+    return "";
+  }
+}
+
+void QueryGuard::check() {
+  if (reason() != Reason::kNone) {
+    abort(reason());
+  }
+  if (cancelled_.load(std::memory_order_relaxed)) {
+    abort(Reason::kCancelled);
+  }
+  if (has_deadline_ && std::chrono::steady_clock::now() > deadline_) {
+    abort(Reason::kTimeout);
+  }
+}
+
+void QueryGuard::charge(size_t bytes) {
+  size_t charged =
+      charged_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (memory_budget_ != 0 && charged > memory_budget_) {
+    abort(Reason::kMemory);
+  }
+}
+
+void QueryGuard::abort(Reason reason) {
+  int expected = static_cast<int>(Reason::kNone);
+  // The first reason sticks, and the other morsels of the query stop at
+  // their next check.
+  reason_.compare_exchange_strong(expected, static_cast<int>(reason),
+                                  std::memory_order_relaxed);
+  cancelled_.store(true, std::memory_order_relaxed);
+  throw QueryAborted(message());
+}
+
+}  // namespace runtime
+
+}  // namespace gs
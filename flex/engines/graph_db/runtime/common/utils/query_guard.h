@@ -0,0 +1,144 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUNTIME_COMMON_UTILS_QUERY_GUARD_H_
+#define RUNTIME_COMMON_UTILS_QUERY_GUARD_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+namespace runtime {
+
+// Thrown by the checks of QueryGuard, and turned into an error by the
+// pipeline running the operator.
+class QueryAborted : public std::runtime_error {
+ public:
+  explicit QueryAborted(const std::string& what) : std::runtime_error(what) {}
+};
+
+/**
+ * @brief The limits of a query: a deadline, a budget of bytes for the rows
+ * it builds, and a flag to cancel it from another thread.
+ *
+ * The operators call Check() in their loops and charge the vectors they grow
+ * with ChargeGrowth(), which do nothing outside a QueryGuardScope, and throw
+ * QueryAborted once the query of the scope is beyond its limits. Freed bytes
+ * are not given back, the budget bounds the bytes allocated by the query.
+ */
+class QueryGuard {
+ public:
+  enum class Reason : int {
+    kNone = 0,
+    kCancelled = 1,
+    kTimeout = 2,
+    kMemory = 3,
+  };
+
+  // The deadline is checked every CHECK_INTERVAL calls to Check.
+  static constexpr uint32_t CHECK_INTERVAL = 1024;
+
+  // 0 for no timeout or no budget.
+  QueryGuard(int64_t timeout_ms, size_t memory_budget);
+  ~QueryGuard() = default;
+
+  QueryGuard(const QueryGuard&) = delete;
+  QueryGuard& operator=(const QueryGuard&) = delete;
+
+  // Aborts the query at its next check, from any thread.
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+  Reason reason() const {
+    return static_cast<Reason>(reason_.load(std::memory_order_relaxed));
+  }
+  size_t charged() const { return charged_.load(std::memory_order_relaxed); }
+
+  std::string message() const;
+
+  static QueryGuard* Current() { return current_; }
+
+  static inline void Check() {
+    QueryGuard* guard = current_;
+    if (guard != nullptr &&
+        (guard->cancelled_.load(std::memory_order_relaxed) ||
+         ++ticks_ % CHECK_INTERVAL == 0)) {
+      guard->check();
+    }
+  }
+
+  static inline void Charge(size_t bytes) {
+    QueryGuard* guard = current_;
+    if (guard != nullptr) {
+      guard->charge(bytes);
+    }
+  }
+
+  // Charges the reallocation of vec when an element is added at capacity.
+  template <typename T, typename ALLOC_T>
+  static inline void ChargeGrowth(const std::vector<T, ALLOC_T>& vec) {
+    if (vec.size() == vec.capacity() && current_ != nullptr) {
+      current_->charge(std::max<size_t>(vec.capacity(), 1) * sizeof(T));
+    }
+  }
+
+ private:
+  friend class QueryGuardScope;
+
+  void check();
+  void charge(size_t bytes);
+  [[noreturn]] void abort(Reason reason);
+
+  std::chrono::steady_clock::time_point deadline_;
+  bool has_deadline_;
+  size_t memory_budget_;
+  std::atomic<size_t> charged_;
+  std::atomic<bool> cancelled_;
+  std::atomic<int> reason_;
+
+  static thread_local QueryGuard* current_;
+  static thread_local uint32_t ticks_;
+};
+
+/**
+ * @brief Subjects the operators run on this thread to guard while alive,
+ * none if guard is nullptr. The threads running the morsels of a query
+ * enter the guard of the query too.
+ */
+class QueryGuardScope {
+ public:
+  explicit QueryGuardScope(QueryGuard* guard) : prev_(QueryGuard::current_) {
+    QueryGuard::current_ = guard;
+  }
+  ~QueryGuardScope() { QueryGuard::current_ = prev_; }
+
+  QueryGuardScope(const QueryGuardScope&) = delete;
+  QueryGuardScope& operator=(const QueryGuardScope&) = delete;
+
+ private:
+  QueryGuard* prev_;
+};
+
+}  // namespace runtime
+
+}  // namespace gs
+
+#endif  // RUNTIME_COMMON_UTILS_QUERY_GUARD_H_
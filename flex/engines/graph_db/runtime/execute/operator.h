@@ -16,6 +16,7 @@
 #ifndef RUNTIME_EXECUTE_OPERATOR_H_
 #define RUNTIME_EXECUTE_OPERATOR_H_
 
+#include <limits>
 #include <map>
 
 #include "flex/engines/graph_db/runtime/common/context.h"
@@ -44,6 +45,19 @@ class IReadOperator {
 
   virtual std::string get_operator_name() const = 0;
 
+  // Whether the rows the operator outputs for an input row depend on that
+  // row only, and are output in the order of the input rows, so that it can
+  // run on the morsels of its input independently, see ReadPipeline.
+  virtual bool is_morsel_parallel() const { return false; }
+
+  // The number of rows from the head of its input the output of the operator
+  // depends on at most, e.g. the upper bound of a Limit, so that the morsel
+  // parallel operators before it can stop once they output as many rows,
+  // see ReadPipeline.
+  virtual size_t row_limit() const {
+    return std::numeric_limits<size_t>::max();
+  }
+
   virtual bl::result<Context> Eval(
       const GraphReadInterface& graph,
       const std::map<std::string, std::string>& params, Context&& ctx,
@@ -15,6 +15,7 @@
 
 #include "flex/engines/graph_db/runtime/execute/ops/retrieve/edge.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/edge_expand.h"
+#include "flex/engines/graph_db/runtime/execute/ops/retrieve/order_by.h"
 #include "flex/engines/graph_db/runtime/utils/predicates.h"
 #include "flex/engines/graph_db/runtime/utils/utils.h"
 
@@ -176,6 +177,8 @@ class EdgeExpandVWithoutPredOpr : public IReadOperator {
     return "EdgeExpandVWithoutPredOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
  private:
   EdgeExpandParams eep_;
 };
@@ -190,6 +193,8 @@ class EdgeExpandVWithEPGTOpr : public IReadOperator {
     return "EdgeExpandVWithEPGTOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -222,6 +227,8 @@ class EdgeExpandVWithEPLTOpr : public IReadOperator {
     return "EdgeExpandVWithEPLTOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -244,6 +251,43 @@ class EdgeExpandVWithEPLTOpr : public IReadOperator {
   common::Expression pred_;
 };
 
+class EdgeExpandVWithEPBetweenOpr : public IReadOperator {
+ public:
+  EdgeExpandVWithEPBetweenOpr(const EdgeExpandParams& eep,
+                              const std::string& from_param,
+                              const std::string& to_param,
+                              const common::Expression& pred)
+      : eep_(eep), from_param_(from_param), to_param_(to_param), pred_(pred) {}
+
+  std::string get_operator_name() const override {
+    return "EdgeExpandVWithEPBetweenOpr";
+  }
+
+  bool is_morsel_parallel() const override { return true; }
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    auto ret = EdgeExpand::expand_vertex_ep_between(
+        graph, std::move(ctx), eep_, params.at(from_param_),
+        params.at(to_param_));
+    if (ret) {
+      return ret.value();
+    }
+    GeneralEdgePredicate pred(graph, ctx, params, pred_);
+    GeneralEdgePredicateWrapper wpred(pred);
+    return EdgeExpand::expand_vertex<GeneralEdgePredicateWrapper>(
+        graph, std::move(ctx), eep_, wpred);
+  }
+
+ private:
+  EdgeExpandParams eep_;
+  std::string from_param_;
+  std::string to_param_;
+  common::Expression pred_;
+};
+
 class EdgeExpandVWithEdgePredOpr : public IReadOperator {
  public:
   EdgeExpandVWithEdgePredOpr(const EdgeExpandParams& eep,
@@ -254,6 +298,8 @@ class EdgeExpandVWithEdgePredOpr : public IReadOperator {
     return "EdgeExpandVWithEdgePredOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -365,6 +411,8 @@ class EdgeExpandVWithExactVertexOpr : public IReadOperator {
     return "EdgeExpandVWithExactVertexOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -385,11 +433,12 @@ class EdgeExpandVWithExactVertexOpr : public IReadOperator {
                                   query_params_.predicate());
       ExactVertexEdgePredicateWrapper ve_pred(v_pred, e_pred);
 
-      return EdgeExpand::expand_vertex<ExactVertexEdgePredicateWrapper>(
-          graph, std::move(ctx), eep_, ve_pred);
+      return EdgeExpand::expand_vertex_to_exact<
+          ExactVertexEdgePredicateWrapper>(graph, std::move(ctx), eep_,
+                                           pk_label_, vid, ve_pred);
     } else {
-      return EdgeExpand::expand_vertex<ExactVertexPredicateWrapper>(
-          graph, std::move(ctx), eep_, v_pred);
+      return EdgeExpand::expand_vertex_to_exact<ExactVertexPredicateWrapper>(
+          graph, std::move(ctx), eep_, pk_label_, vid, v_pred);
     }
   }
 
@@ -411,6 +460,8 @@ class EdgeExpandVWithVertexEdgePredOpr : public IReadOperator {
     return "EdgeExpandVWithVertexEdgePredOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -443,6 +494,8 @@ class EdgeExpandVWithSPVertexPredOpr : public IReadOperator {
     return "EdgeExpandVWithSPVertexPredOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -478,6 +531,8 @@ class EdgeExpandVWithGPVertexPredOpr : public IReadOperator {
     return "EdgeExpandVWithGPVertexPredOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -526,6 +581,36 @@ static bool check_label_in_set(const Direction& dir,
   return within;
 }
 
+// Whether expr is `p >= $from AND p < $to` on a property p of the edge.
+static bool is_ep_between(const common::Expression& expr,
+                          std::string& from_param, std::string& to_param) {
+  if (expr.operators_size() != 7) {
+    return false;
+  }
+  const auto& op0 = expr.operators(0);
+  const auto& op4 = expr.operators(4);
+  if (!op0.has_var() || op0.var().has_tag() || !op0.var().has_property() ||
+      !op4.has_var() || op4.var().has_tag() || !op4.var().has_property() ||
+      op0.var().property().DebugString() !=
+          op4.var().property().DebugString()) {
+    return false;
+  }
+  if (expr.operators(1).item_case() != common::ExprOpr::kLogical ||
+      expr.operators(1).logical() != common::Logical::GE ||
+      expr.operators(3).item_case() != common::ExprOpr::kLogical ||
+      expr.operators(3).logical() != common::Logical::AND ||
+      expr.operators(5).item_case() != common::ExprOpr::kLogical ||
+      expr.operators(5).logical() != common::Logical::LT) {
+    return false;
+  }
+  if (!expr.operators(2).has_param() || !expr.operators(6).has_param()) {
+    return false;
+  }
+  from_param = expr.operators(2).param().name();
+  to_param = expr.operators(6).param().name();
+  return true;
+}
+
 bl::result<ReadOpBuildResultT> EdgeExpandOprBuilder::Build(
     const gs::Schema& schema, const ContextMeta& ctx_meta,
     const physical::PhysicalPlan& plan, int op_idx) {
@@ -552,6 +637,13 @@ bl::result<ReadOpBuildResultT> EdgeExpandOprBuilder::Build(
   eep.is_optional = is_optional;
   if (opr.expand_opt() == physical::EdgeExpand_ExpandOpt_VERTEX) {
     if (query_params.has_predicate()) {
+      std::string from_param, to_param;
+      if (is_ep_between(query_params.predicate(), from_param, to_param)) {
+        return std::make_pair(
+            std::make_unique<EdgeExpandVWithEPBetweenOpr>(
+                eep, from_param, to_param, query_params.predicate()),
+            meta);
+      }
       auto tp = parse_sp_pred(query_params.predicate());
       const auto& op2 = query_params.predicate().operators(2);
       if (op2.has_param()) {
@@ -728,6 +820,293 @@ bl::result<ReadOpBuildResultT> EdgeExpandGetVOprBuilder::Build(
   }
   return std::make_pair(nullptr, ContextMeta());
 }
+class EdgeExpandOrderByOpr : public IReadOperator {
+ public:
+  EdgeExpandOrderByOpr(const EdgeExpandParams& eep, bool expand_edge,
+                       const std::string& prop_name, bool asc, size_t limit,
+                       std::unique_ptr<IReadOperator>&& expand_opr,
+                       std::unique_ptr<IReadOperator>&& order_by_opr)
+      : eep_(eep),
+        expand_edge_(expand_edge),
+        prop_name_(prop_name),
+        asc_(asc),
+        limit_(limit),
+        expand_opr_(std::move(expand_opr)),
+        order_by_opr_(std::move(order_by_opr)) {}
+
+  std::string get_operator_name() const override {
+    return "EdgeExpandOrderByOpr";
+  }
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    auto ret = EdgeExpand::expand_top_k(graph, std::move(ctx), eep_,
+                                        expand_edge_, prop_name_, asc_, limit_);
+    if (!ret) {
+      // The expand is not supported, ctx is left untouched.
+      ret = expand_opr_->Eval(graph, params, std::move(ctx), timer);
+      if (!ret) {
+        return ret;
+      }
+    }
+    return order_by_opr_->Eval(graph, params, std::move(ret.value()), timer);
+  }
+
+ private:
+  EdgeExpandParams eep_;
+  bool expand_edge_;
+  std::string prop_name_;
+  bool asc_;
+  size_t limit_;
+  std::unique_ptr<IReadOperator> expand_opr_;
+  std::unique_ptr<IReadOperator> order_by_opr_;
+};
+
+// Builds an EdgeExpandOrderByOpr if the order by at order_idx has a limit
+// and is first ordered by a property of the expanded alias, expand_res
+// being the plain expand to fall back to.
+static bl::result<ReadOpBuildResultT> build_expand_order_by(
+    const gs::Schema& schema, const physical::PhysicalPlan& plan,
+    int order_idx, const EdgeExpandParams& eep, bool expand_edge,
+    ReadOpBuildResultT&& expand_res) {
+  const auto& opr = plan.plan(order_idx).opr().order_by();
+  if (expand_res.first == nullptr || eep.alias == -1 || !opr.has_limit() ||
+      opr.pairs_size() == 0 || opr.limit().upper() <= 0) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  const auto& pair = opr.pairs(0);
+  const auto& key = pair.key();
+  if (!key.has_tag() ||
+      key.tag().item_case() != common::NameOrId::ItemCase::kId ||
+      key.tag().id() != eep.alias || !key.has_property() ||
+      !key.property().has_key()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  if (pair.order() != algebra::OrderBy_OrderingPair_Order::
+                          OrderBy_OrderingPair_Order_ASC &&
+      pair.order() != algebra::OrderBy_OrderingPair_Order::
+                          OrderBy_OrderingPair_Order_DESC) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  bool asc =
+      pair.order() ==
+      algebra::OrderBy_OrderingPair_Order::OrderBy_OrderingPair_Order_ASC;
+  auto order_res =
+      OrderByOprBuilder().Build(schema, expand_res.second, plan, order_idx);
+  if (!order_res || order_res.value().first == nullptr) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  return std::make_pair(
+      std::make_unique<EdgeExpandOrderByOpr>(
+          eep, expand_edge, key.property().key().name(), asc,
+          static_cast<size_t>(opr.limit().upper()),
+          std::move(expand_res.first), std::move(order_res.value().first)),
+      order_res.value().second);
+}
+
+bl::result<ReadOpBuildResultT> EdgeExpandOrderByOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  const auto& ee_opr = plan.plan(op_idx).opr().edge();
+  if (!ee_opr.has_params() || ee_opr.params().has_predicate() ||
+      ee_opr.is_optional() || !ee_opr.has_alias()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  if (ee_opr.expand_opt() != physical::EdgeExpand_ExpandOpt_VERTEX &&
+      ee_opr.expand_opt() != physical::EdgeExpand_ExpandOpt_EDGE) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  EdgeExpandParams eep;
+  eep.v_tag = ee_opr.has_v_tag() ? ee_opr.v_tag().value() : -1;
+  eep.labels = parse_label_triplets(plan.plan(op_idx).meta_data(0));
+  eep.dir = parse_direction(ee_opr.direction());
+  eep.alias = ee_opr.alias().value();
+  eep.is_optional = false;
+  auto expand_res =
+      EdgeExpandOprBuilder().Build(schema, ctx_meta, plan, op_idx);
+  if (!expand_res) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  return build_expand_order_by(
+      schema, plan, op_idx + 1, eep,
+      ee_opr.expand_opt() == physical::EdgeExpand_ExpandOpt_EDGE,
+      std::move(expand_res.value()));
+}
+
+bl::result<ReadOpBuildResultT> EdgeExpandGetVOrderByOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  const auto& ee_opr = plan.plan(op_idx).opr().edge();
+  const auto& v_opr = plan.plan(op_idx + 1).opr().vertex();
+  if (!edge_expand_get_v_fusable(ee_opr, v_opr,
+                                 plan.plan(op_idx).meta_data(0)) ||
+      !ee_opr.has_params() || ee_opr.is_optional() ||
+      v_opr.params().has_predicate() || !v_opr.has_alias()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  EdgeExpandParams eep;
+  eep.v_tag = ee_opr.has_v_tag() ? ee_opr.v_tag().value() : -1;
+  eep.labels = parse_label_triplets(plan.plan(op_idx).meta_data(0));
+  eep.dir = parse_direction(ee_opr.direction());
+  eep.alias = v_opr.alias().value();
+  eep.is_optional = false;
+  auto expand_res =
+      EdgeExpandGetVOprBuilder().Build(schema, ctx_meta, plan, op_idx);
+  if (!expand_res) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  return build_expand_order_by(schema, plan, op_idx + 2, eep, false,
+                               std::move(expand_res.value()));
+}
+
+// Counts the rows an expand followed by a group by counting them would
+// produce, in all or by the input vertex of the expand, from the adjacency
+// lists instead of building the expanded rows.
+class EdgeExpandCountOpr : public IReadOperator {
+ public:
+  EdgeExpandCountOpr(const EdgeExpandParams& eep, int key_alias, int alias)
+      : eep_(eep), key_alias_(key_alias), alias_(alias) {}
+
+  std::string get_operator_name() const override {
+    return "EdgeExpandCountOpr";
+  }
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    auto res = EdgeExpand::count_edges(graph, ctx, eep_);
+    if (!res) {
+      return res.error();
+    }
+    const auto& counts = res.value();
+    ValueColumnBuilder<int64_t> builder;
+    Context ret;
+    // As after a group by, there is no group without an expanded row.
+    if (key_alias_ == -1) {
+      size_t total = 0;
+      for (auto count : counts) {
+        total += count;
+      }
+      if (total > 0) {
+        builder.push_back_opt(static_cast<int64_t>(total));
+      }
+      ret.set(alias_, builder.finish(nullptr));
+      return ret;
+    }
+    auto input = std::dynamic_pointer_cast<IVertexColumn>(ctx.get(eep_.v_tag));
+    std::unordered_map<VertexRecord, size_t, VertexRecordHash> groups;
+    std::vector<size_t> offsets;
+    std::vector<int64_t> sums;
+    for (size_t i = 0; i < counts.size(); ++i) {
+      if (counts[i] == 0) {
+        continue;
+      }
+      auto iter = groups.emplace(input->get_vertex(i), offsets.size()).first;
+      if (iter->second == offsets.size()) {
+        offsets.push_back(i);
+        sums.push_back(0);
+      }
+      sums[iter->second] += counts[i];
+    }
+    ret.set(key_alias_, ctx.get(eep_.v_tag));
+    ret.reshuffle(offsets);
+    builder.reserve(sums.size());
+    for (auto sum : sums) {
+      builder.push_back_opt(sum);
+    }
+    ret.set(alias_, builder.finish(nullptr));
+    return ret;
+  }
+
+ private:
+  EdgeExpandParams eep_;
+  int key_alias_;
+  int alias_;
+};
+
+// Builds an EdgeExpandCountOpr if the group by at group_idx counts the rows
+// of count_tag, the expanded alias, and has no key but the input vertex of
+// the expand, which must be a plain one.
+static bl::result<ReadOpBuildResultT> build_expand_count(
+    const gs::Schema& schema, const physical::PhysicalPlan& plan,
+    int group_idx, const EdgeExpandParams& eep, int count_tag) {
+  const auto& opr = plan.plan(group_idx).opr().group_by();
+  if (!EdgeExpand::can_count_edges(schema, eep.labels, eep.dir) ||
+      opr.functions_size() != 1 || opr.mappings_size() > 1) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  const auto& func = opr.functions(0);
+  if (func.aggregate() != physical::GroupBy_AggFunc::COUNT ||
+      func.vars_size() != 1 || !func.has_alias()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  const auto& var = func.vars(0);
+  int tag = var.has_tag() ? var.tag().id() : -1;
+  if (var.has_property() || tag != count_tag) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  ContextMeta meta;
+  int key_alias = -1;
+  if (opr.mappings_size() == 1) {
+    const auto& key = opr.mappings(0);
+    if (eep.v_tag == -1 || !key.has_alias() || !key.has_key() ||
+        !key.key().has_tag() || key.key().tag().id() != eep.v_tag ||
+        key.key().has_property()) {
+      return std::make_pair(nullptr, ContextMeta());
+    }
+    key_alias = key.alias().value();
+    meta.set(key_alias);
+  }
+  meta.set(func.alias().value());
+  return std::make_pair(std::make_unique<EdgeExpandCountOpr>(
+                            eep, key_alias, func.alias().value()),
+                        meta);
+}
+
+bl::result<ReadOpBuildResultT> EdgeExpandCountOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  const auto& ee_opr = plan.plan(op_idx).opr().edge();
+  if (!ee_opr.has_params() || ee_opr.params().has_predicate() ||
+      ee_opr.is_optional()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  if (ee_opr.expand_opt() != physical::EdgeExpand_ExpandOpt_VERTEX &&
+      ee_opr.expand_opt() != physical::EdgeExpand_ExpandOpt_EDGE) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  EdgeExpandParams eep;
+  eep.v_tag = ee_opr.has_v_tag() ? ee_opr.v_tag().value() : -1;
+  eep.labels = parse_label_triplets(plan.plan(op_idx).meta_data(0));
+  eep.dir = parse_direction(ee_opr.direction());
+  eep.alias = ee_opr.has_alias() ? ee_opr.alias().value() : -1;
+  eep.is_optional = false;
+  return build_expand_count(schema, plan, op_idx + 1, eep, eep.alias);
+}
+
+bl::result<ReadOpBuildResultT> EdgeExpandGetVCountOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  const auto& ee_opr = plan.plan(op_idx).opr().edge();
+  const auto& v_opr = plan.plan(op_idx + 1).opr().vertex();
+  if (!edge_expand_get_v_fusable(ee_opr, v_opr,
+                                 plan.plan(op_idx).meta_data(0)) ||
+      !ee_opr.has_params() || ee_opr.is_optional() ||
+      v_opr.params().has_predicate()) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  EdgeExpandParams eep;
+  eep.v_tag = ee_opr.has_v_tag() ? ee_opr.v_tag().value() : -1;
+  eep.labels = parse_label_triplets(plan.plan(op_idx).meta_data(0));
+  eep.dir = parse_direction(ee_opr.direction());
+  eep.alias = v_opr.has_alias() ? v_opr.alias().value() : -1;
+  eep.is_optional = false;
+  return build_expand_count(schema, plan, op_idx + 2, eep, eep.alias);
+}
+
 }  // namespace ops
 
 }  // namespace runtime
@@ -59,6 +59,79 @@ class EdgeExpandGetVOprBuilder : public IReadOperatorBuilder {
   }
 };
 
+// An edge expand followed by an order by with a limit on a property of the
+// expanded edges or neighbors, which only keeps the rows that may be among
+// the first ones while expanding.
+class EdgeExpandOrderByOprBuilder : public IReadOperatorBuilder {
+ public:
+  EdgeExpandOrderByOprBuilder() = default;
+  ~EdgeExpandOrderByOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {physical::PhysicalOpr_Operator::OpKindCase::kEdge,
+            physical::PhysicalOpr_Operator::OpKindCase::kOrderBy};
+  }
+};
+
+class EdgeExpandGetVOrderByOprBuilder : public IReadOperatorBuilder {
+ public:
+  EdgeExpandGetVOrderByOprBuilder() = default;
+  ~EdgeExpandGetVOrderByOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {physical::PhysicalOpr_Operator::OpKindCase::kEdge,
+            physical::PhysicalOpr_Operator::OpKindCase::kVertex,
+            physical::PhysicalOpr_Operator::OpKindCase::kOrderBy};
+  }
+};
+
+class EdgeExpandCountOprBuilder : public IReadOperatorBuilder {
+ public:
+  EdgeExpandCountOprBuilder() = default;
+  ~EdgeExpandCountOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {physical::PhysicalOpr_Operator::OpKindCase::kEdge,
+            physical::PhysicalOpr_Operator::OpKindCase::kGroupBy};
+  }
+};
+
+class EdgeExpandGetVCountOprBuilder : public IReadOperatorBuilder {
+ public:
+  EdgeExpandGetVCountOprBuilder() = default;
+  ~EdgeExpandGetVCountOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {physical::PhysicalOpr_Operator::OpKindCase::kEdge,
+            physical::PhysicalOpr_Operator::OpKindCase::kVertex,
+            physical::PhysicalOpr_Operator::OpKindCase::kGroupBy};
+  }
+};
+
 class TCOprBuilder : public IReadOperatorBuilder {
  public:
   TCOprBuilder() = default;
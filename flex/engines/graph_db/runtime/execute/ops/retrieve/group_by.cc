@@ -315,6 +315,9 @@ struct KeyBuilder {
       return nullptr;
     }
     auto col = ctx.get(tag_alias[I - 1].first);
+    if (col->is_optional()) {
+      return nullptr;
+    }
     if (col->column_type() == ContextColumnType::kVertex) {
       auto vertex_col = std::dynamic_pointer_cast<IVertexColumn>(col);
       if (vertex_col->vertex_column_type() == VertexColumnType::kSingle) {
@@ -503,7 +506,11 @@ struct CountReducer {
   EXPR expr;
   using V = int64_t;
 
+  // count(*) and counts of non optional values are the sizes of the groups.
+  static constexpr bool kReducesCounts = !IS_OPTIONAL;
+
   CountReducer(EXPR&& expr) : expr(std::move(expr)) {}
+  void reduce_count(size_t count, V& val) const { val = count; }
   bool operator()(const std::vector<size_t>& group, V& val) const {
     if constexpr (!IS_OPTIONAL) {
       val = group.size();
@@ -1076,6 +1083,8 @@ bl::result<ReadOpBuildResultT> GroupByOprBuilder::Build(
     std::unique_ptr<KeyBase> key = nullptr;
     if (mappings.size() == 1) {
       key = KeyBuilder<1>::make_sp_key(ctx, mappings);
+    } else if (mappings.size() == 2) {
+      key = KeyBuilder<2>::make_sp_key(ctx, mappings);
     }
     if (key == nullptr) {
       std::vector<VarWrapper> key_vars;
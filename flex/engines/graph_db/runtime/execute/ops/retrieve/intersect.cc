@@ -16,6 +16,7 @@
 #include "flex/engines/graph_db/runtime/execute/ops/retrieve/intersect.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/intersect.h"
 #include "flex/engines/graph_db/runtime/execute/pipeline.h"
+#include "flex/engines/graph_db/runtime/utils/utils.h"
 
 #include "flex/engines/graph_db/runtime/execute/plan_parser.h"
 namespace gs {
@@ -51,9 +52,74 @@ class IntersectOpr : public IReadOperator {
   std::vector<ReadPipeline> sub_plans_;
 };
 
+class MultiwayIntersectOpr : public IReadOperator {
+ public:
+  MultiwayIntersectOpr(std::vector<EdgeExpandParams>&& params, int key)
+      : params_(std::move(params)), key_(key) {}
+
+  std::string get_operator_name() const override {
+    return "MultiwayIntersectOpr";
+  }
+
+  bool is_morsel_parallel() const override { return true; }
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    return Intersect::multiway_intersect(graph, std::move(ctx), params_,
+                                         key_);
+  }
+
+ private:
+  std::vector<EdgeExpandParams> params_;
+  int key_;
+};
+
+// A sub plan that only expands from a bound vertex to the key without a
+// predicate, which the multiway intersection runs without executing it.
+static bool parse_key_expand(const physical::PhysicalPlan& sub_plan, int key,
+                             EdgeExpandParams& eep) {
+  if (sub_plan.plan_size() != 1 || !sub_plan.plan(0).opr().has_edge() ||
+      sub_plan.plan(0).meta_data_size() == 0) {
+    return false;
+  }
+  const auto& opr = sub_plan.plan(0).opr().edge();
+  if (opr.expand_opt() != physical::EdgeExpand_ExpandOpt_VERTEX ||
+      opr.is_optional() || !opr.has_v_tag() || !opr.has_alias() ||
+      opr.alias().value() != key ||
+      (opr.has_params() && opr.params().has_predicate())) {
+    return false;
+  }
+  eep.v_tag = opr.v_tag().value();
+  eep.labels = parse_label_triplets(sub_plan.plan(0).meta_data(0));
+  eep.dir = parse_direction(opr.direction());
+  eep.alias = key;
+  eep.is_optional = false;
+  return true;
+}
+
 bl::result<ReadOpBuildResultT> IntersectOprBuilder::Build(
     const Schema& schema, const ContextMeta& ctx_meta,
     const physical::PhysicalPlan& plan, int op_idx) {
+  const auto& intersect_opr = plan.plan(op_idx).opr().intersect();
+  std::vector<EdgeExpandParams> expands;
+  for (const auto& sub_plan : intersect_opr.sub_plans()) {
+    EdgeExpandParams eep;
+    if (!parse_key_expand(sub_plan, intersect_opr.key(), eep)) {
+      break;
+    }
+    expands.emplace_back(std::move(eep));
+  }
+  if (expands.size() >= 2 &&
+      static_cast<int>(expands.size()) == intersect_opr.sub_plans_size()) {
+    ContextMeta meta = ctx_meta;
+    meta.set(intersect_opr.key());
+    return std::make_pair(std::make_unique<MultiwayIntersectOpr>(
+                              std::move(expands), intersect_opr.key()),
+                          meta);
+  }
+
   std::vector<ReadPipeline> sub_plans;
   for (int i = 0; i < plan.plan(op_idx).opr().intersect().sub_plans_size();
        ++i) {
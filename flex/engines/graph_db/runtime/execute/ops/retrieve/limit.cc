@@ -32,6 +32,8 @@ class LimitOpr : public IReadOperator {
 
   std::string get_operator_name() const override { return "LimitOpr"; }
 
+  size_t row_limit() const override { return upper_; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
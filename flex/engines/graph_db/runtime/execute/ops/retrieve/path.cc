@@ -313,7 +313,13 @@ class SPOrderByLimitOpr : public IReadOperator {
       gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
     auto sp_vertex_pred = pred_(graph, params);
     bl::result<gs::runtime::Context> ret;
-    if (sp_vertex_pred->data_type() == RTAnyType::kStringValue) {
+    if (sp_vertex_pred->type() == SPPredicateType::kPropertyConjunction) {
+      const auto& casted_pred =
+          dynamic_cast<const VertexPropertyConjunctionPredicate&>(
+              *sp_vertex_pred);
+      ret = PathExpand::single_source_shortest_path_with_order_by_length_limit(
+          graph, std::move(ctx), spp_, casted_pred, limit_);
+    } else if (sp_vertex_pred->data_type() == RTAnyType::kStringValue) {
       ret = _invoke<std::string_view>(graph, std::move(ctx),
                                       std::move(sp_vertex_pred));
     } else if (sp_vertex_pred->data_type() == RTAnyType::kI32Value) {
@@ -735,9 +741,31 @@ class PathExpandVOpr : public IReadOperator {
   PathExpandParams pep_;
 };
 
-bl::result<ReadOpBuildResultT> PathExpandVOprBuilder::Build(
-    const gs::Schema& schema, const ContextMeta& ctx_meta,
-    const physical::PhysicalPlan& plan, int op_idx) {
+class PathExpandVDedupOpr : public IReadOperator {
+ public:
+  PathExpandVDedupOpr(const PathExpandParams& pep, bool per_start)
+      : pep_(pep), per_start_(per_start) {}
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    return PathExpand::edge_expand_v_distinct(graph, std::move(ctx), pep_,
+                                              per_start_);
+  }
+  std::string get_operator_name() const override {
+    return "PathExpandVDedupOpr";
+  }
+
+ private:
+  PathExpandParams pep_;
+  bool per_start_;
+};
+
+// Parses the PathExpand and the GetV at op_idx into pep, returns false if
+// they are not supported by PathExpand::edge_expand_v.
+static bool parse_path_expand_v(const physical::PhysicalPlan& plan,
+                                int op_idx, PathExpandParams& pep) {
   const auto& opr = plan.plan(op_idx).opr().path();
   const auto& next_opr = plan.plan(op_idx + 1).opr().vertex();
   if (opr.result_opt() ==
@@ -748,28 +776,25 @@ bl::result<ReadOpBuildResultT> PathExpandVOprBuilder::Build(
     if (next_opr.has_alias()) {
       alias = next_opr.alias().value();
     }
-    ContextMeta ret_meta = ctx_meta;
-    ret_meta.set(alias);
     int start_tag = opr.has_start_tag() ? opr.start_tag().value() : -1;
     if (opr.path_opt() !=
         physical::PathExpand_PathOpt::PathExpand_PathOpt_ARBITRARY) {
       LOG(ERROR) << "Currently only support arbitrary path expand";
-      return std::make_pair(nullptr, ContextMeta());
+      return false;
     }
     if (opr.is_optional()) {
       LOG(ERROR) << "Currently only support non-optional path expand without "
                     "predicate";
-      return std::make_pair(nullptr, ContextMeta());
+      return false;
     }
     Direction dir = parse_direction(opr.base().edge_expand().direction());
     if (opr.base().edge_expand().is_optional()) {
       LOG(ERROR) << "Currently only support non-optional path expand without "
                     "predicate";
-      return std::make_pair(nullptr, ContextMeta());
+      return false;
     }
     const algebra::QueryParams& query_params =
         opr.base().edge_expand().params();
-    PathExpandParams pep;
     pep.alias = alias;
     pep.dir = dir;
     pep.hop_lower = opr.hop_range().lower();
@@ -779,17 +804,60 @@ bl::result<ReadOpBuildResultT> PathExpandVOprBuilder::Build(
     if (opr.base().edge_expand().expand_opt() !=
         physical::EdgeExpand_ExpandOpt::EdgeExpand_ExpandOpt_VERTEX) {
       LOG(ERROR) << "Currently only support vertex expand";
-      return std::make_pair(nullptr, ContextMeta());
+      return false;
     }
     if (query_params.has_predicate()) {
       LOG(ERROR) << "Currently only support non-optional path expand without "
                     "predicate";
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+bl::result<ReadOpBuildResultT> PathExpandVOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  PathExpandParams pep;
+  if (!parse_path_expand_v(plan, op_idx, pep)) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  ContextMeta ret_meta = ctx_meta;
+  ret_meta.set(pep.alias);
+  return std::make_pair(std::make_unique<PathExpandVOpr>(pep), ret_meta);
+}
+
+bl::result<ReadOpBuildResultT> PathExpandVDedupOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  PathExpandParams pep;
+  if (!parse_path_expand_v(plan, op_idx, pep) || pep.alias < 0) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  const auto& dedup_opr = plan.plan(op_idx + 2).opr().dedup();
+  std::set<int> tags;
+  for (int k_i = 0; k_i < dedup_opr.keys_size(); ++k_i) {
+    const auto& key = dedup_opr.keys(k_i);
+    if (!key.has_tag() || key.has_property()) {
       return std::make_pair(nullptr, ContextMeta());
     }
-    return std::make_pair(std::make_unique<PathExpandVOpr>(pep), ret_meta);
+    tags.insert(key.tag().id());
+  }
+  // Dedup on the end vertices, or on the pairs of start and end vertices.
+  bool per_start;
+  if (tags == std::set<int>{pep.alias}) {
+    per_start = false;
+  } else if (pep.start_tag >= 0 &&
+             tags == std::set<int>{pep.start_tag, pep.alias}) {
+    per_start = true;
   } else {
     return std::make_pair(nullptr, ContextMeta());
   }
+  ContextMeta ret_meta = ctx_meta;
+  ret_meta.set(pep.alias);
+  return std::make_pair(std::make_unique<PathExpandVDedupOpr>(pep, per_start),
+                        ret_meta);
 }
 
 class PathExpandOpr : public IReadOperator {
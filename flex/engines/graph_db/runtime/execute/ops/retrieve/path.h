@@ -88,6 +88,28 @@ class PathExpandVOprBuilder : public IReadOperatorBuilder {
   }
 };
 
+// PathExpandV followed by a Dedup on its end vertices, alone or with its
+// start vertices.
+class PathExpandVDedupOprBuilder : public IReadOperatorBuilder {
+ public:
+  PathExpandVDedupOprBuilder() = default;
+  ~PathExpandVDedupOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {
+        physical::PhysicalOpr_Operator::OpKindCase::kPath,
+        physical::PhysicalOpr_Operator::OpKindCase::kVertex,
+        physical::PhysicalOpr_Operator::OpKindCase::kDedup,
+    };
+  }
+};
+
 class PathExpandOprBuilder : public IReadOperatorBuilder {
  public:
   PathExpandOprBuilder() = default;
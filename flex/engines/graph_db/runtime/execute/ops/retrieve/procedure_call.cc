@@ -21,14 +21,17 @@
 #include "flex/engines/graph_db/runtime/common/context.h"
 #include "flex/engines/graph_db/runtime/common/leaf_utils.h"
 #include "flex/engines/graph_db/runtime/common/rt_any.h"
+#include "flex/engines/graph_db/runtime/utils/in_process_procedure.h"
 #include "flex/engines/graph_db/runtime/utils/opr_timer.h"
 #include "flex/proto_generated_gie/algebra.pb.h"
 #include "flex/proto_generated_gie/physical.pb.h"
 namespace gs {
 namespace runtime {
 namespace ops {
+// The strings are copied unless they are held by arena already.
 std::shared_ptr<IContextColumn> any_vec_to_column(
-    const std::vector<RTAny>& any_vec) {
+    const std::vector<RTAny>& any_vec,
+    const std::shared_ptr<Arena>& strings = nullptr) {
   if (any_vec.empty()) {
     return nullptr;
   }
@@ -65,9 +68,15 @@ std::shared_ptr<IContextColumn> any_vec_to_column(
     return builder.finish(nullptr);
   } else if (first == RTAnyType::kStringValue) {
     ValueColumnBuilder<std::string_view> builder;
+    if (strings != nullptr) {
+      for (auto& any : any_vec) {
+        builder.push_back_opt(any.as_string());
+      }
+      return builder.finish(strings);
+    }
     std::shared_ptr<Arena> arena = std::make_shared<Arena>();
     for (auto& any : any_vec) {
-      auto ptr = StringImpl::make_string_impl(std::string(any.as_string()));
+      auto ptr = StringImpl::make_string_impl(any.as_string());
       auto sv = ptr->str_view();
       arena->emplace_back(std::move(ptr));
       builder.push_back_opt(sv);
@@ -288,6 +297,53 @@ bl::result<procedure::Query> fill_in_query(const procedure::Query& query,
   return real_query;
 }
 
+// Calls proc on the arguments of every row of ctx, as RTAny, and appends
+// its output rows as columns, with no encoding in between.
+static bl::result<Context> call_in_process(const std::vector<int32_t>& aliases,
+                                           const procedure::Query& query,
+                                           InProcessReadProcedure& proc,
+                                           const GraphReadInterface& txn,
+                                           Context&& ctx) {
+  std::vector<std::shared_ptr<IContextColumn>> arg_cols;
+  std::vector<RTAny> args;
+  for (auto& param : query.arguments()) {
+    if (param.value_case() == procedure::Argument::kVar) {
+      auto col = ctx.get(param.var().tag().id());
+      if (col == nullptr) {
+        RETURN_BAD_REQUEST_ERROR("Tag not found: " +
+                                 std::to_string(param.var().tag().id()));
+      }
+      arg_cols.push_back(col);
+      args.emplace_back();
+    } else {
+      arg_cols.push_back(nullptr);
+      args.push_back(object_to_rt_any(param.const_()));
+    }
+  }
+  ProcedureOutput output(aliases.size());
+  for (size_t i = 0; i < ctx.row_num(); ++i) {
+    for (size_t k = 0; k < arg_cols.size(); ++k) {
+      if (arg_cols[k] != nullptr) {
+        args[k] = arg_cols[k]->get_elem(i);
+      }
+    }
+    output.set_row(i);
+    BOOST_LEAF_CHECK(proc.Call(txn, args, output));
+  }
+  if (output.offsets().empty()) {
+    RETURN_CALL_PROCEDURE_ERROR("Procedure returned no rows");
+  }
+  for (size_t k = 0; k < aliases.size(); ++k) {
+    auto col = any_vec_to_column(output.columns()[k], output.arena());
+    if (k == 0) {
+      ctx.set_with_reshuffle(aliases[k], col, output.offsets());
+    } else {
+      ctx.set(aliases[k], col);
+    }
+  }
+  return std::move(ctx);
+}
+
 /**
  * @brief Evaluate the ProcedureCall operator.
  * The ProcedureCall operator is used to call a stored procedure, which is
@@ -324,6 +380,9 @@ bl::result<Context> eval_procedure_call(const std::vector<int32_t>& aliases,
       RETURN_BAD_REQUEST_ERROR("Stored procedure not found: " +
                                proc_name.name());
     }
+    if (auto proc = dynamic_cast<InProcessReadProcedure*>(app)) {
+      return call_in_process(aliases, query, *proc, txn, std::move(ctx));
+    }
     ReadAppBase* read_app = dynamic_cast<ReadAppBase*>(app);
     if (!app) {
       RETURN_BAD_REQUEST_ERROR("Stored procedure is not a read procedure: " +
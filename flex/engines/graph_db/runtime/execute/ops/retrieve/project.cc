@@ -15,6 +15,7 @@
  */
 
 #include "flex/engines/graph_db/runtime/execute/ops/retrieve/project.h"
+#include "flex/engines/graph_db/runtime/common/operators/retrieve/limit.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/order_by.h"
 #include "flex/engines/graph_db/runtime/common/operators/retrieve/project.h"
 #include "flex/engines/graph_db/runtime/execute/ops/retrieve/order_by_utils.h"
@@ -1164,6 +1165,8 @@ class ProjectOpr : public IReadOperator {
 
   std::string get_operator_name() const override { return "ProjectOpr"; }
 
+  bool is_morsel_parallel() const override { return true; }
+
  private:
   std::vector<std::function<std::unique_ptr<ProjectExprBase>(
       const GraphReadInterface& graph,
@@ -1303,14 +1306,15 @@ class ProjectOrderByOprBeta : public IReadOperator {
       const std::set<int>& order_by_keys,
       const std::vector<std::pair<common::Variable, bool>>& order_by_pairs,
       int lower_bound, int upper_bound,
-      const std::tuple<int, int, bool>& first_pair)
+      const std::tuple<int, int, bool>& first_pair, bool is_append)
       : exprs_(exprs),
         dependencies_(dependencies),
         order_by_keys_(order_by_keys),
         order_by_pairs_(order_by_pairs),
         lower_bound_(lower_bound),
         upper_bound_(upper_bound),
-        first_pair_(first_pair) {}
+        first_pair_(first_pair),
+        is_append_(is_append) {}
 
   std::string get_operator_name() const override {
     return "ProjectOrderByOprBeta";
@@ -1339,7 +1343,7 @@ class ProjectOrderByOprBeta : public IReadOperator {
     };
     auto ret = Project::project_order_by_fuse<GeneralComparer>(
         graph, params, std::move(ctx), exprs_, cmp_func, lower_bound_,
-        upper_bound_, order_by_keys_, first_pair_);
+        upper_bound_, order_by_keys_, first_pair_, is_append_);
     if (!ret) {
       return ret;
     }
@@ -1369,6 +1373,7 @@ class ProjectOrderByOprBeta : public IReadOperator {
   std::vector<std::pair<common::Variable, bool>> order_by_pairs_;
   int lower_bound_, upper_bound_;
   std::tuple<int, int, bool> first_pair_;
+  bool is_append_;
 };
 
 static bool project_order_by_fusable_beta(
@@ -1379,9 +1384,6 @@ static bool project_order_by_fusable_beta(
   if (!order_by_opr.has_limit()) {
     return false;
   }
-  if (project_opr.is_append()) {
-    return false;
-  }
 
   int mappings_size = project_opr.mappings_size();
   if (static_cast<size_t>(mappings_size) != data_types.size()) {
@@ -1417,16 +1419,21 @@ static bool project_order_by_fusable_beta(
     }
     order_by_keys.insert(order_by_opr.pairs(k_i).key().tag().id());
   }
-  if (data_types.size() == order_by_keys.size()) {
+  // The rows are first limited by the first key, which must be projected.
+  if (new_generate_columns.find(order_by_opr.pairs(0).key().tag().id()) ==
+      new_generate_columns.end()) {
     return false;
   }
+  // Nothing is left to project after the order by if every expr is a key.
+  size_t projected_key_num = 0;
   for (auto key : order_by_keys) {
-    if (new_generate_columns.find(key) == new_generate_columns.end() &&
-        !ctx_meta.exist(key)) {
+    if (new_generate_columns.find(key) != new_generate_columns.end()) {
+      ++projected_key_num;
+    } else if (!ctx_meta.exist(key)) {
       return false;
     }
   }
-  return true;
+  return data_types.size() != projected_key_num;
 }
 
 bl::result<ReadOpBuildResultT> ProjectOrderByOprBuilder::Build(
@@ -1444,6 +1451,10 @@ bl::result<ReadOpBuildResultT> ProjectOrderByOprBuilder::Build(
                                     plan.plan(op_idx + 1).opr().order_by(),
                                     ctx_meta, data_types, order_by_keys)) {
     ContextMeta ret_meta;
+    bool is_append = plan.plan(op_idx).opr().project().is_append();
+    if (is_append) {
+      ret_meta = ctx_meta;
+    }
     std::vector<std::function<std::unique_ptr<ProjectExprBase>(
         const GraphReadInterface& graph,
         const std::map<std::string, std::string>& params, const Context& ctx)>>
@@ -1512,13 +1523,62 @@ bl::result<ReadOpBuildResultT> ProjectOrderByOprBuilder::Build(
     }
     return std::make_pair(std::make_unique<ProjectOrderByOprBeta>(
                               std::move(exprs), dependencies, index_set,
-                              order_by_pairs, lower, upper, first_tuple),
+                              order_by_pairs, lower, upper, first_tuple,
+                              is_append),
                           ret_meta);
   } else {
     return std::make_pair(nullptr, ContextMeta());
   }
 }
 
+class ProjectLimitOpr : public IReadOperator {
+ public:
+  ProjectLimitOpr(std::unique_ptr<IReadOperator>&& project, size_t lower,
+                  size_t upper)
+      : project_(std::move(project)), lower_(lower), upper_(upper) {}
+
+  std::string get_operator_name() const override { return "ProjectLimitOpr"; }
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph,
+      const std::map<std::string, std::string>& params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    auto ret = Limit::limit(std::move(ctx), lower_, upper_);
+    if (!ret) {
+      return ret;
+    }
+    return project_->Eval(graph, params, std::move(ret.value()), timer);
+  }
+
+ private:
+  std::unique_ptr<IReadOperator> project_;
+  size_t lower_;
+  size_t upper_;
+};
+
+bl::result<ReadOpBuildResultT> ProjectLimitOprBuilder::Build(
+    const gs::Schema& schema, const ContextMeta& ctx_meta,
+    const physical::PhysicalPlan& plan, int op_idx) {
+  auto project_res = ProjectOprBuilder().Build(schema, ctx_meta, plan, op_idx);
+  if (!project_res) {
+    return project_res;
+  }
+  auto& [project, ret_meta] = project_res.value();
+  if (project == nullptr) {
+    return std::make_pair(nullptr, ContextMeta());
+  }
+  const auto& limit_opr = plan.plan(op_idx + 1).opr().limit();
+  size_t lower = 0;
+  size_t upper = std::numeric_limits<size_t>::max();
+  if (limit_opr.has_range()) {
+    lower = std::max(lower, static_cast<size_t>(limit_opr.range().lower()));
+    upper = std::min(upper, static_cast<size_t>(limit_opr.range().upper()));
+  }
+  return std::make_pair(
+      std::make_unique<ProjectLimitOpr>(std::move(project), lower, upper),
+      ret_meta);
+}
+
 }  // namespace ops
 }  // namespace runtime
 }  // namespace gs
\ No newline at end of file
@@ -55,6 +55,25 @@ class ProjectOrderByOprBuilder : public IReadOperatorBuilder {
   }
 };
 
+// Project expressions are evaluated row by row, so a limit right after a
+// project is applied first and only the rows kept are projected.
+class ProjectLimitOprBuilder : public IReadOperatorBuilder {
+ public:
+  ProjectLimitOprBuilder() = default;
+  ~ProjectLimitOprBuilder() = default;
+
+  bl::result<ReadOpBuildResultT> Build(const gs::Schema& schema,
+                                       const ContextMeta& ctx_meta,
+                                       const physical::PhysicalPlan& plan,
+                                       int op_idx) override;
+
+  std::vector<physical::PhysicalOpr_Operator::OpKindCase> GetOpKinds()
+      const override {
+    return {physical::PhysicalOpr_Operator::OpKindCase::kProject,
+            physical::PhysicalOpr_Operator::OpKindCase::kLimit};
+  }
+};
+
 }  // namespace ops
 
 }  // namespace runtime
@@ -441,6 +441,293 @@ class ScanWithGPredOpr : public IReadOperator {
   common::Expression pred_;
 };
 
+// Scans the vertices of a single label which the secondary index on a
+// property lists for the value it is compared to, checking each of them
+// against the whole predicate.
+class ScanWithSecondaryIndexOpr : public IReadOperator {
+ public:
+  ScanWithSecondaryIndexOpr(const ScanParams& scan_params, int prop_id,
+                            const PropertyType& prop_type,
+                            const std::function<std::string(ParamsType)>& value,
+                            const common::Expression& pred)
+      : scan_params_(scan_params),
+        prop_id_(prop_id),
+        prop_type_(prop_type),
+        value_(value),
+        pred_(pred) {}
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph, ParamsType params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    ctx = Context();
+    std::vector<vid_t> vids;
+    graph.LookupSecondaryIndex(scan_params_.tables[0], prop_id_,
+                               ConvertStringToAny(value_(params), prop_type_),
+                               vids);
+    Arena arena;
+    auto expr =
+        parse_expression(graph, ctx, params, pred_, VarType::kVertexVar);
+    if (expr->is_optional()) {
+      return Scan::filter_vids(
+          std::move(ctx), graph, scan_params_,
+          [&expr, &arena](label_t label, vid_t vid) {
+            return expr->eval_vertex(label, vid, 0, arena, 0).as_bool();
+          },
+          vids);
+    } else {
+      return Scan::filter_vids(
+          std::move(ctx), graph, scan_params_,
+          [&expr, &arena](label_t label, vid_t vid) {
+            return expr->eval_vertex(label, vid, 0, arena).as_bool();
+          },
+          vids);
+    }
+  }
+
+  std::string get_operator_name() const override {
+    return "ScanWithSecondaryIndexOpr";
+  }
+
+ private:
+  ScanParams scan_params_;
+  int prop_id_;
+  PropertyType prop_type_;
+  std::function<std::string(ParamsType)> value_;
+  common::Expression pred_;
+};
+
+// A comparison of an indexed property to a value.
+struct RangeIndexBound {
+  common::Logical cmp;
+  std::function<std::string(ParamsType)> value;
+};
+
+// Scans the vertices of a single label whose property a range index lists in
+// the bounds, in ascending order of the property, checking each of them
+// against the whole predicate. Bounds too loose for the index to pay off fall
+// back to scanning the label.
+class ScanWithRangeIndexOpr : public IReadOperator {
+ public:
+  // The index is used while it keeps at most 1 / MAX_SELECTIVITY_INV of the
+  // label within the bounds.
+  static constexpr size_t MAX_SELECTIVITY_INV = 8;
+
+  ScanWithRangeIndexOpr(const ScanParams& scan_params, int prop_id,
+                        const PropertyType& prop_type,
+                        const std::vector<RangeIndexBound>& bounds,
+                        const common::Expression& pred)
+      : scan_params_(scan_params),
+        prop_id_(prop_id),
+        prop_type_(prop_type),
+        bounds_(bounds),
+        pred_(pred) {}
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph, ParamsType params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    ctx = Context();
+    Arena arena;
+    auto expr =
+        parse_expression(graph, ctx, params, pred_, VarType::kVertexVar);
+    if (expr->is_optional()) {
+      return eval(std::move(ctx), graph, params,
+                  [&expr, &arena](label_t label, vid_t vid) {
+                    return expr->eval_vertex(label, vid, 0, arena, 0)
+                        .as_bool();
+                  });
+    } else {
+      return eval(std::move(ctx), graph, params,
+                  [&expr, &arena](label_t label, vid_t vid) {
+                    return expr->eval_vertex(label, vid, 0, arena).as_bool();
+                  });
+    }
+  }
+
+  std::string get_operator_name() const override {
+    return "ScanWithRangeIndexOpr";
+  }
+
+ private:
+  template <typename PRED_T>
+  bl::result<gs::runtime::Context> eval(
+      gs::runtime::Context&& ctx, const gs::runtime::GraphReadInterface& graph,
+      ParamsType params, const PRED_T& pred) {
+    label_t label = scan_params_.tables[0];
+    int64_t lo = std::numeric_limits<int64_t>::min();
+    int64_t hi = std::numeric_limits<int64_t>::max();
+    for (auto& bound : bounds_) {
+      int64_t key =
+          RangeIndex::key(ConvertStringToAny(bound.value(params), prop_type_));
+      // Keys are integers, so strict bounds are tightened by one.
+      if (bound.cmp == common::Logical::GT) {
+        if (key == std::numeric_limits<int64_t>::max()) {
+          return Scan::filter_vids(std::move(ctx), graph, scan_params_, pred,
+                                   {});
+        }
+        lo = std::max(lo, key + 1);
+      } else if (bound.cmp == common::Logical::LT) {
+        if (key == std::numeric_limits<int64_t>::min()) {
+          return Scan::filter_vids(std::move(ctx), graph, scan_params_, pred,
+                                   {});
+        }
+        hi = std::min(hi, key - 1);
+      } else {
+        if (bound.cmp != common::Logical::LE) {
+          lo = std::max(lo, key);
+        }
+        if (bound.cmp != common::Logical::GE) {
+          hi = std::min(hi, key);
+        }
+      }
+    }
+    const auto* index = graph.GetRangeIndex(label, prop_id_);
+    vid_t vnum = graph.GetVertexSet(label).size();
+    if (index == nullptr ||
+        index->count(lo, hi) * MAX_SELECTIVITY_INV > vnum) {
+      if (scan_params_.limit == std::numeric_limits<int32_t>::max()) {
+        return Scan::scan_vertex(std::move(ctx), graph, scan_params_, pred);
+      } else {
+        return Scan::scan_vertex_with_limit(std::move(ctx), graph,
+                                            scan_params_, pred);
+      }
+    }
+    std::vector<RangeIndex::entry_t> entries;
+    index->lookup(lo, hi, entries);
+    // An entry counts only while it holds the value the vertex has, which
+    // skips the stale ones and keeps each vertex once.
+    std::vector<vid_t> vids;
+    for (auto& [key, vid] : entries) {
+      if (vid < vnum &&
+          RangeIndex::key(graph.GetVertexProperty(label, vid, prop_id_)) ==
+              key) {
+        vids.push_back(vid);
+      }
+    }
+    return Scan::filter_vids(std::move(ctx), graph, scan_params_, pred, vids);
+  }
+
+  ScanParams scan_params_;
+  int prop_id_;
+  PropertyType prop_type_;
+  std::vector<RangeIndexBound> bounds_;
+  common::Expression pred_;
+};
+
+// The literal of a regular expression matching the strings which start
+// with, contain or end with it, the forms STARTS WITH, CONTAINS and ENDS WITH
+// are compiled to, e.g. "^abc.*" or ".*abc.*". Returns false for any other
+// expression.
+static bool parse_text_pattern(std::string_view pattern, std::string& literal,
+                               bool& is_prefix) {
+  if (!pattern.empty() && pattern.front() == '^') {
+    pattern.remove_prefix(1);
+  }
+  if (!pattern.empty() && pattern.back() == '$') {
+    pattern.remove_suffix(1);
+  }
+  is_prefix = pattern.substr(0, 2) != ".*";
+  if (!is_prefix) {
+    pattern.remove_prefix(2);
+  }
+  if (pattern.size() >= 2 && pattern.substr(pattern.size() - 2) == ".*") {
+    pattern.remove_suffix(2);
+  }
+  if (pattern.find_first_of(".^$*+?()[]{}|\\") != std::string_view::npos) {
+    return false;
+  }
+  literal = std::string(pattern);
+  return true;
+}
+
+// Scans the vertices of a single label whose string property a text index
+// lists for a regular expression of parse_text_pattern, checking each of
+// them against the whole predicate. Expressions of other forms, literals
+// too short for the trigrams of a substring, and ones the index does not
+// narrow down enough fall back to scanning the label.
+class ScanWithTextIndexOpr : public IReadOperator {
+ public:
+  // As in ScanWithRangeIndexOpr.
+  static constexpr size_t MAX_SELECTIVITY_INV = 8;
+
+  ScanWithTextIndexOpr(const ScanParams& scan_params, int prop_id,
+                       const std::function<std::string(ParamsType)>& pattern,
+                       const common::Expression& pred)
+      : scan_params_(scan_params),
+        prop_id_(prop_id),
+        pattern_(pattern),
+        pred_(pred) {}
+
+  bl::result<gs::runtime::Context> Eval(
+      const gs::runtime::GraphReadInterface& graph, ParamsType params,
+      gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
+    ctx = Context();
+    Arena arena;
+    auto expr =
+        parse_expression(graph, ctx, params, pred_, VarType::kVertexVar);
+    if (expr->is_optional()) {
+      return eval(std::move(ctx), graph, params,
+                  [&expr, &arena](label_t label, vid_t vid) {
+                    return expr->eval_vertex(label, vid, 0, arena, 0)
+                        .as_bool();
+                  });
+    } else {
+      return eval(std::move(ctx), graph, params,
+                  [&expr, &arena](label_t label, vid_t vid) {
+                    return expr->eval_vertex(label, vid, 0, arena).as_bool();
+                  });
+    }
+  }
+
+  std::string get_operator_name() const override {
+    return "ScanWithTextIndexOpr";
+  }
+
+ private:
+  template <typename PRED_T>
+  bl::result<gs::runtime::Context> eval(
+      gs::runtime::Context&& ctx, const gs::runtime::GraphReadInterface& graph,
+      ParamsType params, const PRED_T& pred) {
+    label_t label = scan_params_.tables[0];
+    const auto* index = graph.GetTextIndex(label, prop_id_);
+    vid_t vnum = graph.GetVertexSet(label).size();
+    std::string literal;
+    bool is_prefix;
+    bool use_index = index != nullptr &&
+                     parse_text_pattern(pattern_(params), literal, is_prefix);
+    if (use_index) {
+      if (is_prefix) {
+        use_index = index->count_prefix(literal) * MAX_SELECTIVITY_INV <= vnum;
+      } else {
+        use_index = literal.size() >= TextIndex::kGramSize &&
+                    index->count_substring(literal) * MAX_SELECTIVITY_INV <=
+                        vnum;
+      }
+    }
+    if (!use_index) {
+      if (scan_params_.limit == std::numeric_limits<int32_t>::max()) {
+        return Scan::scan_vertex(std::move(ctx), graph, scan_params_, pred);
+      } else {
+        return Scan::scan_vertex_with_limit(std::move(ctx), graph,
+                                            scan_params_, pred);
+      }
+    }
+    std::vector<vid_t> vids;
+    if (is_prefix) {
+      index->lookup_prefix(literal, vids);
+    } else {
+      index->lookup_substring(literal, vids);
+    }
+    // The candidates are ascending and distinct, the predicate checks them.
+    vids.erase(std::lower_bound(vids.begin(), vids.end(), vnum), vids.end());
+    return Scan::filter_vids(std::move(ctx), graph, scan_params_, pred, vids);
+  }
+
+  ScanParams scan_params_;
+  int prop_id_;
+  std::function<std::string(ParamsType)> pattern_;
+  common::Expression pred_;
+};
+
 class ScanWithoutPredOpr : public IReadOperator {
  public:
   ScanWithoutPredOpr(const ScanParams& scan_params)
@@ -468,6 +755,152 @@ class ScanWithoutPredOpr : public IReadOperator {
   ScanParams scan_params_;
 };
 
+// Parses the parameter or constant an indexed property is compared to, which
+// is a string exactly when the property is one.
+static bool parse_index_value(const common::ExprOpr& opr, bool is_string,
+                              std::function<std::string(ParamsType)>& value) {
+  if (opr.has_param()) {
+    if (!opr.param().has_data_type()) {
+      return false;
+    }
+    auto type = parse_from_ir_data_type(opr.param().data_type());
+    if ((type == RTAnyType::kStringValue) != is_string ||
+        (type != RTAnyType::kStringValue && type != RTAnyType::kI32Value &&
+         type != RTAnyType::kI64Value && type != RTAnyType::kTimestamp &&
+         type != RTAnyType::kDate32)) {
+      return false;
+    }
+    std::string name = opr.param().name();
+    value = [name](ParamsType params) { return params.at(name); };
+    return true;
+  }
+  if (!opr.has_const_()) {
+    return false;
+  }
+  std::string str;
+  const auto& val = opr.const_();
+  if (val.item_case() == common::Value::kStr && is_string) {
+    str = val.str();
+  } else if (val.item_case() == common::Value::kI32 && !is_string) {
+    str = std::to_string(val.i32());
+  } else if (val.item_case() == common::Value::kI64 && !is_string) {
+    str = std::to_string(val.i64());
+  } else {
+    return false;
+  }
+  value = [str](ParamsType) { return str; };
+  return true;
+}
+
+// The id of the property of the label the operator reads, -1 if it reads
+// something else.
+static int parse_index_property(const gs::Schema& schema, label_t label,
+                                const common::ExprOpr& opr) {
+  if (!opr.has_var() || !opr.var().has_property() ||
+      !opr.var().property().has_key() ||
+      opr.var().property().key().item_case() !=
+          common::NameOrId::ItemCase::kName) {
+    return -1;
+  }
+  const auto& prop_names = schema.get_vertex_property_names(label);
+  auto iter = std::find(prop_names.begin(), prop_names.end(),
+                        opr.var().property().key().name());
+  return iter == prop_names.end() ? -1 : iter - prop_names.begin();
+}
+
+// Matches `property == value` with a parameter or constant value, property
+// having a secondary index on the label.
+static bool parse_secondary_index_pred(
+    const gs::Schema& schema, label_t label, const common::Expression& expr,
+    int& prop_id, PropertyType& prop_type,
+    std::function<std::string(ParamsType)>& value) {
+  if (parse_sp_pred(expr) != SPPredicateType::kPropertyEQ) {
+    return false;
+  }
+  prop_id = parse_index_property(schema, label, expr.operators(0));
+  if (prop_id < 0 ||
+      !schema.has_secondary_index(
+          label, schema.get_vertex_property_names(label)[prop_id])) {
+    return false;
+  }
+  prop_type = schema.get_vertex_properties(label)[prop_id];
+  bool is_string = prop_type == PropertyType::kStringView ||
+                   prop_type == PropertyType::kStringMap;
+  if (!is_string && prop_type != PropertyType::kInt32 &&
+      prop_type != PropertyType::kUInt32 &&
+      prop_type != PropertyType::kInt64 &&
+      prop_type != PropertyType::kUInt64 && prop_type != PropertyType::kDate) {
+    return false;
+  }
+  return parse_index_value(expr.operators(2), is_string, value);
+}
+
+// Matches `property op value`, with op one of == < <= > >=, or two such
+// comparisons of the same property joined by AND, property having a range
+// index on the label.
+static bool parse_range_index_pred(const gs::Schema& schema, label_t label,
+                                   const common::Expression& expr,
+                                   int& prop_id, PropertyType& prop_type,
+                                   std::vector<RangeIndexBound>& bounds) {
+  int opr_num = expr.operators_size();
+  if (opr_num != 3 && opr_num != 7) {
+    return false;
+  }
+  if (opr_num == 7 &&
+      (expr.operators(3).item_case() != common::ExprOpr::kLogical ||
+       expr.operators(3).logical() != common::Logical::AND)) {
+    return false;
+  }
+  prop_id = -1;
+  bounds.clear();
+  for (int i = 0; i < opr_num; i += 4) {
+    int id = parse_index_property(schema, label, expr.operators(i));
+    if (id < 0 || (prop_id >= 0 && id != prop_id)) {
+      return false;
+    }
+    prop_id = id;
+    const auto& cmp = expr.operators(i + 1);
+    if (cmp.item_case() != common::ExprOpr::kLogical ||
+        (cmp.logical() != common::Logical::EQ &&
+         cmp.logical() != common::Logical::LT &&
+         cmp.logical() != common::Logical::LE &&
+         cmp.logical() != common::Logical::GT &&
+         cmp.logical() != common::Logical::GE)) {
+      return false;
+    }
+    RangeIndexBound bound;
+    bound.cmp = cmp.logical();
+    if (!parse_index_value(expr.operators(i + 2), false, bound.value)) {
+      return false;
+    }
+    bounds.emplace_back(std::move(bound));
+  }
+  prop_type = schema.get_vertex_properties(label)[prop_id];
+  return schema.has_range_index(
+             label, schema.get_vertex_property_names(label)[prop_id]) &&
+         RangeIndex::is_supported(prop_type);
+}
+
+// Matches `property REGEX pattern` with a parameter or constant pattern,
+// property being a string with a text index on the label. The pattern is
+// checked by the operator, which may not use the index for it.
+static bool parse_text_index_pred(
+    const gs::Schema& schema, label_t label, const common::Expression& expr,
+    int& prop_id, std::function<std::string(ParamsType)>& pattern) {
+  if (expr.operators_size() != 3 ||
+      expr.operators(1).item_case() != common::ExprOpr::kLogical ||
+      expr.operators(1).logical() != common::Logical::REGEX) {
+    return false;
+  }
+  prop_id = parse_index_property(schema, label, expr.operators(0));
+  return prop_id >= 0 &&
+         schema.has_text_index(
+             label, schema.get_vertex_property_names(label)[prop_id]) &&
+         TextIndex::is_supported(
+             schema.get_vertex_properties(label)[prop_id]) &&
+         parse_index_value(expr.operators(2), true, pattern);
+}
+
 bl::result<ReadOpBuildResultT> ScanOprBuilder::Build(
     const gs::Schema& schema, const ContextMeta& ctx_meta,
     const physical::PhysicalPlan& plan, int op_idx) {
@@ -618,6 +1051,38 @@ bl::result<ReadOpBuildResultT> ScanOprBuilder::Build(
 
   } else {
     if (scan_opr.params().has_predicate()) {
+      int prop_id;
+      PropertyType prop_type;
+      std::function<std::string(ParamsType)> value;
+      if (scan_params.tables.size() == 1 &&
+          parse_secondary_index_pred(schema, scan_params.tables[0],
+                                     scan_opr.params().predicate(), prop_id,
+                                     prop_type, value)) {
+        return std::make_pair(
+            std::make_unique<ScanWithSecondaryIndexOpr>(
+                scan_params, prop_id, prop_type, value,
+                scan_opr.params().predicate()),
+            ret_meta);
+      }
+      std::vector<RangeIndexBound> bounds;
+      if (scan_params.tables.size() == 1 &&
+          parse_range_index_pred(schema, scan_params.tables[0],
+                                 scan_opr.params().predicate(), prop_id,
+                                 prop_type, bounds)) {
+        return std::make_pair(std::make_unique<ScanWithRangeIndexOpr>(
+                                  scan_params, prop_id, prop_type, bounds,
+                                  scan_opr.params().predicate()),
+                              ret_meta);
+      }
+      if (scan_params.tables.size() == 1 &&
+          parse_text_index_pred(schema, scan_params.tables[0],
+                                scan_opr.params().predicate(), prop_id,
+                                value)) {
+        return std::make_pair(std::make_unique<ScanWithTextIndexOpr>(
+                                  scan_params, prop_id, value,
+                                  scan_opr.params().predicate()),
+                              ret_meta);
+      }
       auto sp_vertex_pred =
           parse_special_vertex_predicate(scan_opr.params().predicate());
       if (sp_vertex_pred.has_value()) {
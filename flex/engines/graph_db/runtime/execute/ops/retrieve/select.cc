@@ -21,33 +21,14 @@ namespace gs {
 namespace runtime {
 namespace ops {
 
-struct ExprWrapper {
-  ExprWrapper(Expr&& expr) : expr_(std::move(expr)) {}
-
-  bool operator()(size_t idx, Arena& arena) const {
-    return expr_.eval_path(idx, arena).as_bool();
-  }
-
-  Expr expr_;
-};
-
-struct OptionalExprWrapper {
-  OptionalExprWrapper(Expr&& expr) : expr_(std::move(expr)) {}
-
-  bool operator()(size_t idx, Arena& arena) const {
-    auto val = expr_.eval_path(idx, arena, 0);
-    return (!val.is_null()) && val.as_bool();
-  }
-
-  Expr expr_;
-};
-
 class SelectIdNeOpr : public IReadOperator {
  public:
   SelectIdNeOpr(const common::Expression& expr) : expr_(expr) {}
 
   std::string get_operator_name() const override { return "SelectIdNeOpr"; }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -83,18 +64,10 @@ class SelectIdNeOpr : public IReadOperator {
     }
     Expr expr(graph, ctx, params, expr_, VarType::kPathVar);
     Arena arena;
-
-    if (!expr.is_optional()) {
-      ExprWrapper wrapper(std::move(expr));
-      return Select::select(std::move(ctx), [&wrapper, &arena](size_t i) {
-        return wrapper(i, arena);
-      });
-    } else {
-      OptionalExprWrapper wrapper(std::move(expr));
-      return Select::select(std::move(ctx), [&wrapper, &arena](size_t i) {
-        return wrapper(i, arena);
-      });
-    }
+    return Select::select_batch(
+        std::move(ctx), [&expr, &arena](std::vector<size_t>& offsets) {
+          expr.filter_path(offsets, arena);
+        });
   }
   common::Expression expr_;
 };
@@ -105,23 +78,18 @@ class SelectOpr : public IReadOperator {
 
   std::string get_operator_name() const override { return "SelectOpr"; }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
       gs::runtime::Context&& ctx, gs::runtime::OprTimer& timer) override {
     Expr expr(graph, ctx, params, expr_, VarType::kPathVar);
     Arena arena;
-    if (!expr.is_optional()) {
-      ExprWrapper wrapper(std::move(expr));
-      return Select::select(std::move(ctx), [&wrapper, &arena](size_t i) {
-        return wrapper(i, arena);
-      });
-    } else {
-      OptionalExprWrapper wrapper(std::move(expr));
-      return Select::select(std::move(ctx), [&wrapper, &arena](size_t i) {
-        return wrapper(i, arena);
-      });
-    }
+    return Select::select_batch(
+        std::move(ctx), [&expr, &arena](std::vector<size_t>& offsets) {
+          expr.filter_path(offsets, arena);
+        });
   }
 
  private:
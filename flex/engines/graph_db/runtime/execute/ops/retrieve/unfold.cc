@@ -26,6 +26,8 @@ class UnfoldOpr : public IReadOperator {
 
   std::string get_operator_name() const override { return "UnfoldOpr"; }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
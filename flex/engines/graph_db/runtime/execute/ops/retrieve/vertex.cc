@@ -34,6 +34,8 @@ class GetVFromVerticesWithLabelWithInOpr : public IReadOperator {
     return "GetVFromVerticesWithLabelWithInOpr";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -83,6 +85,8 @@ class GetVFromVerticesWithPKExactOpr : public IReadOperator {
     return "GetVFromVerticesWithPKExact";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -112,6 +116,8 @@ class GetVFromVerticesWithPredicateOpr : public IReadOperator {
     return "GetVFromVerticesWithPredicate";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -154,6 +160,8 @@ class GetVFromEdgesWithPredicateOpr : public IReadOperator {
     return "GetVFromEdgesWithPredicate";
   }
 
+  bool is_morsel_parallel() const override { return true; }
+
   bl::result<gs::runtime::Context> Eval(
       const gs::runtime::GraphReadInterface& graph,
       const std::map<std::string, std::string>& params,
@@ -62,9 +62,13 @@ class SetOpr : public IUpdateOperator {
     }
     return true;
   }
-  bool set_vertex_property(GraphUpdateInterface& graph, label_t label,
-                           vid_t vid, const std::string& key,
-                           const RTAny& value) {
+  // Sets the property of the vertices of a label at once, falling back to
+  // one vertex at a time if the values do not all have the property type,
+  // as those SetVertexField skips.
+  bool set_vertex_properties(GraphUpdateInterface& graph, label_t label,
+                             const std::vector<vid_t>& vids,
+                             const std::string& key,
+                             const std::vector<Any>& values) {
     const auto& properties = graph.schema().get_vertex_property_names(label);
     size_t prop_id = properties.size();
     for (size_t i = 0; i < properties.size(); i++) {
@@ -78,7 +82,11 @@ class SetOpr : public IUpdateOperator {
                  << label;
       return false;
     }
-    graph.SetVertexField(label, vid, prop_id, value.to_any());
+    if (!graph.SetVertexFields(label, prop_id, vids, values)) {
+      for (size_t i = 0; i < vids.size(); ++i) {
+        graph.SetVertexField(label, vids[i], prop_id, values[i]);
+      }
+    }
     return true;
   }
 
@@ -167,12 +175,20 @@ class SetOpr : public IUpdateOperator {
         auto vertex_col = dynamic_cast<const IVertexColumn*>(prop.get());
         Expr expr(graph, ctx, params, value, VarType::kPathVar);
 
+        // The values are evaluated first and then assigned label by label.
+        std::map<label_t, std::pair<std::vector<vid_t>, std::vector<Any>>>
+            assignments;
         for (size_t j = 0; j < ctx.row_num(); j++) {
           auto val = expr.eval_path(j, arena);
 
           auto vertex = vertex_col->get_vertex(j);
-          if (!set_vertex_property(graph, vertex.label_, vertex.vid_,
-                                   key.second, val)) {
+          auto& assignment = assignments[vertex.label_];
+          assignment.first.push_back(vertex.vid_);
+          assignment.second.push_back(val.to_any());
+        }
+        for (const auto& [label, assignment] : assignments) {
+          if (!set_vertex_properties(graph, label, assignment.first,
+                                     key.second, assignment.second)) {
             LOG(ERROR) << "Failed to set vertex property";
             RETURN_BAD_REQUEST_ERROR("Failed to set vertex property");
           }
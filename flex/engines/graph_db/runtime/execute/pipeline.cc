@@ -15,16 +15,71 @@
 
 #include "flex/engines/graph_db/runtime/execute/pipeline.h"
 
+#include <algorithm>
+#include <limits>
+#include <typeinfo>
+
+#include "flex/engines/graph_db/runtime/common/utils/query_arena.h"
+#include "flex/engines/graph_db/runtime/common/utils/query_guard.h"
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+
 namespace gs {
 namespace runtime {
 
 bl::result<Context> ReadPipeline::Execute(
     const GraphReadInterface& graph, Context&& ctx,
     const std::map<std::string, std::string>& params, OprTimer& timer) {
-  for (auto& opr : operators_) {
+  auto& pool = MorselPool::get();
+  size_t begin = 0;
+  while (begin < operators_.size()) {
+    size_t end = begin;
+    while (end < operators_.size() && operators_[end]->is_morsel_parallel()) {
+      ++end;
+    }
+    gs::Status status = gs::Status::OK();
+    if (end == begin) {
+      status = executeRange(graph, ctx, params, timer, begin, begin + 1);
+      ++begin;
+    } else {
+      size_t limit = end < operators_.size()
+                         ? operators_[end]->row_limit()
+                         : std::numeric_limits<size_t>::max();
+      bool done = !sequential_[begin] && limit != 0 &&
+                  limit < ctx.row_num() &&
+                  executeBatches(graph, ctx, params, timer, begin, end, limit,
+                                 status);
+      if (!done && (sequential_[begin] || !pool.Enabled(ctx.row_num()) ||
+                    !executeMorsels(graph, ctx, params, timer, begin, end,
+                                    status))) {
+        status = executeRange(graph, ctx, params, timer, begin, end);
+      }
+      begin = end;
+    }
+    if (!status.ok()) {
+      return bl::new_error(status);
+    }
+  }
+  return ctx;
+}
+
+gs::Status ReadPipeline::executeRange(
+    const GraphReadInterface& graph, Context& ctx,
+    const std::map<std::string, std::string>& params, OprTimer& timer,
+    size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    auto& opr = operators_[i];
     gs::Status status = gs::Status::OK();
+    size_t profile_idx = 0, rows_in = 0, bytes = 0;
+    double start = 0;
+    if (timer.profiling()) {
+      profile_idx = timer.enter_opr(this, i, opr->get_operator_name());
+      rows_in = ctx.row_num();
+      bytes = QueryArena::AllocatedBytes();
+      start = grape::GetCurrentTime();
+    }
     auto ret = bl::try_handle_all(
         [&]() -> bl::result<Context> {
+          QueryGuard::Check();
           return opr->Eval(graph, params, std::move(ctx), timer);
         },
         [&status, &ctx](const gs::Status& err) {
@@ -41,17 +96,203 @@ bl::result<Context> ReadPipeline::Execute(
           status = gs::Status(gs::StatusCode::UNKNOWN, "Unknown error");
           return ctx;
         });
+    if (timer.profiling()) {
+      timer.exit_opr(profile_idx, grape::GetCurrentTime() - start, rows_in,
+                     status.ok() ? ret.row_num() : 0,
+                     QueryArena::AllocatedBytes() - bytes);
+    }
 
     if (!status.ok()) {
       std::stringstream ss;
       ss << "[Execute Failed] " << opr->get_operator_name()
          << " execute failed: " << status.ToString();
-      auto err = gs::Status(gs::StatusCode::INTERNAL_ERROR, ss.str());
-      return bl::new_error(err);
+      return gs::Status(gs::StatusCode::INTERNAL_ERROR, ss.str());
     }
     ctx = std::move(ret);
   }
-  return ctx;
+  return gs::Status::OK();
+}
+
+// Concatenates the columns of the morsels pairwise, in log2 of their number
+// rounds.
+static std::shared_ptr<IContextColumn> concat_columns(
+    std::vector<std::shared_ptr<IContextColumn>>&& cols) {
+  while (cols.size() > 1) {
+    std::vector<std::shared_ptr<IContextColumn>> merged;
+    for (size_t i = 0; i + 1 < cols.size(); i += 2) {
+      merged.push_back(cols[i]->union_col(cols[i + 1]));
+    }
+    if (cols.size() % 2 == 1) {
+      merged.push_back(cols.back());
+    }
+    cols.swap(merged);
+  }
+  return cols[0];
+}
+
+static bool same_column_type(const IContextColumn& lhs,
+                             const IContextColumn& rhs) {
+  if (lhs.column_type() == ContextColumnType::kVertex) {
+    return rhs.column_type() == ContextColumnType::kVertex;
+  }
+  return typeid(lhs) == typeid(rhs);
+}
+
+// Returns false if the morsels cannot be concatenated into ctx.
+static bool concat_morsels(std::vector<Context>& morsels, Context& ctx) {
+  for (auto& morsel : morsels) {
+    morsel.flatten();
+  }
+  const Context& first = morsels[0];
+  int head_alias = -2;
+  for (size_t i = 0; i < first.columns.size(); ++i) {
+    if (first.head != nullptr && first.columns[i] == first.head) {
+      head_alias = i;
+    }
+  }
+  // The columns, the head and the offsets, in that order.
+  size_t col_num = first.columns.size();
+  std::vector<std::vector<std::shared_ptr<IContextColumn>>> cols(col_num + 2);
+  for (auto& morsel : morsels) {
+    if (morsel.columns.size() != col_num) {
+      return false;
+    }
+    for (size_t i = 0; i < col_num + 2; ++i) {
+      std::shared_ptr<IContextColumn> col, first_col;
+      if (i < col_num) {
+        col = morsel.columns[i];
+        first_col = first.columns[i];
+      } else if (i == col_num) {
+        if (head_alias != -2) {
+          if (morsel.head != morsel.columns[head_alias]) {
+            return false;
+          }
+          continue;
+        }
+        col = morsel.head;
+        first_col = first.head;
+      } else {
+        col = morsel.offset_ptr;
+        first_col = first.offset_ptr;
+      }
+      if ((col == nullptr) != (first_col == nullptr)) {
+        return false;
+      }
+      if (col == nullptr) {
+        continue;
+      }
+      if (!col->is_unionable() || !same_column_type(*col, *first_col)) {
+        return false;
+      }
+      cols[i].push_back(col);
+    }
+  }
+
+  std::vector<std::shared_ptr<IContextColumn>> merged(col_num + 2);
+  MorselPool::get().Run(col_num + 2, [&](size_t i) {
+    if (!cols[i].empty()) {
+      merged[i] = concat_columns(std::move(cols[i]));
+    }
+  });
+  Context ret;
+  ret.columns.resize(col_num, nullptr);
+  for (size_t i = 0; i < col_num; ++i) {
+    ret.columns[i] = merged[i];
+  }
+  ret.head = head_alias == -2 ? merged[col_num] : merged[head_alias];
+  if (merged[col_num + 1] != nullptr) {
+    ret.offset_ptr =
+        std::dynamic_pointer_cast<ValueColumn<size_t>>(merged[col_num + 1]);
+  }
+  ret.tag_ids = first.tag_ids;
+  ctx = std::move(ret);
+  return true;
+}
+
+bool ReadPipeline::executeMorsels(
+    const GraphReadInterface& graph, Context& ctx,
+    const std::map<std::string, std::string>& params, OprTimer& timer,
+    size_t begin, size_t end, gs::Status& status) {
+  auto& pool = MorselPool::get();
+  size_t row_num = ctx.row_num();
+  size_t morsel_num = pool.MorselNum(row_num);
+  std::vector<Context> morsels(morsel_num);
+  std::vector<gs::Status> statuses(morsel_num, gs::Status::OK());
+  std::vector<OprTimer> timers(morsel_num, timer.fork());
+  const Context& input = ctx;
+  QueryGuard* guard = QueryGuard::Current();
+  pool.Run(morsel_num, [&](size_t i) {
+    QueryGuardScope guard_scope(guard);
+    size_t from = row_num * i / morsel_num;
+    size_t to = row_num * (i + 1) / morsel_num;
+    std::vector<size_t> offsets(to - from);
+    for (size_t k = from; k < to; ++k) {
+      offsets[k - from] = k;
+    }
+    morsels[i] = input;
+    morsels[i].reshuffle(offsets);
+    statuses[i] =
+        executeRange(graph, morsels[i], params, timers[i], begin, end);
+  });
+  for (size_t i = 0; i < morsel_num; ++i) {
+    timer += timers[i];
+  }
+  for (auto& morsel_status : statuses) {
+    if (!morsel_status.ok()) {
+      status = morsel_status;
+      return true;
+    }
+  }
+  if (!concat_morsels(morsels, ctx)) {
+    VLOG(10) << "Outputs of " << operators_[begin]->get_operator_name()
+             << " cannot be concatenated, running it on a single thread";
+    sequential_[begin] = true;
+    return false;
+  }
+  return true;
+}
+
+// The input rows of the first batch at least.
+static constexpr size_t kMinBatchRows = 64;
+
+bool ReadPipeline::executeBatches(
+    const GraphReadInterface& graph, Context& ctx,
+    const std::map<std::string, std::string>& params, OprTimer& timer,
+    size_t begin, size_t end, size_t limit, gs::Status& status) {
+  size_t row_num = ctx.row_num();
+  size_t batch_rows = std::max(limit, kMinBatchRows);
+  std::vector<Context> batches;
+  size_t output_rows = 0;
+  size_t from = 0;
+  const Context& input = ctx;
+  while (from < row_num && output_rows < limit) {
+    size_t to = std::min(row_num, from + batch_rows);
+    std::vector<size_t> offsets(to - from);
+    for (size_t k = from; k < to; ++k) {
+      offsets[k - from] = k;
+    }
+    Context batch = input;
+    batch.reshuffle(offsets);
+    status = executeRange(graph, batch, params, timer, begin, end);
+    if (!status.ok()) {
+      return true;
+    }
+    output_rows += batch.row_num();
+    batches.emplace_back(std::move(batch));
+    from = to;
+    batch_rows *= 2;
+  }
+  if (batches.size() == 1) {
+    ctx = std::move(batches[0]);
+    return true;
+  }
+  if (!concat_morsels(batches, ctx)) {
+    VLOG(10) << "Outputs of " << operators_[begin]->get_operator_name()
+             << " cannot be concatenated, running it on a single thread";
+    sequential_[begin] = true;
+    return false;
+  }
+  return true;
 }
 
 template <typename GraphInterface>
@@ -16,26 +16,82 @@
 #ifndef RUNTIME_EXECUTE_PIPELINE_H_
 #define RUNTIME_EXECUTE_PIPELINE_H_
 
+#include <atomic>
+#include <memory>
+
+#include "flex/engines/graph_db/database/label_set.h"
 #include "flex/engines/graph_db/runtime/execute/operator.h"
 
 namespace gs {
 
 namespace runtime {
 
+/**
+ * @brief The read operators of a query, run in order.
+ *
+ * A run of morsel parallel operators, see IReadOperator::is_morsel_parallel,
+ * on an input large enough for MorselPool is run on morsels of the input, row
+ * ranges of it, in parallel, and their outputs are concatenated in order
+ * before the next operator, e.g. a GroupBy, an OrderBy, a Dedup or a Join. An
+ * output with columns that cannot be concatenated, e.g. of edges or paths,
+ * makes the run fall back to a single thread, from then on for the pipeline.
+ *
+ * A run followed by an operator with a row limit, e.g. a Limit, is instead
+ * run on batches of its input in order, doubling in size, until the outputs
+ * have as many rows as the limit, so that a LIMIT 25 stops the expansions
+ * before it early. The rows kept are those a full run outputs first.
+ */
 class ReadPipeline {
  public:
   ReadPipeline() {}
-  ReadPipeline(ReadPipeline&& rhs) : operators_(std::move(rhs.operators_)) {}
+  ReadPipeline(ReadPipeline&& rhs)
+      : operators_(std::move(rhs.operators_)),
+        sequential_(std::move(rhs.sequential_)),
+        read_labels_(rhs.read_labels_) {}
   ReadPipeline(std::vector<std::unique_ptr<IReadOperator>>&& operators)
-      : operators_(std::move(operators)) {}
+      : operators_(std::move(operators)),
+        sequential_(new std::atomic<bool>[operators_.size()]) {
+    for (size_t i = 0; i < operators_.size(); ++i) {
+      sequential_[i] = false;
+    }
+  }
   ~ReadPipeline() = default;
 
   bl::result<Context> Execute(const GraphReadInterface& graph, Context&& ctx,
                               const std::map<std::string, std::string>& params,
                               OprTimer& timer);
 
+  // The labels the plan of the pipeline reads, see parse_read_labels.
+  const LabelSet& read_labels() const { return read_labels_; }
+  void set_read_labels(const LabelSet& labels) { read_labels_ = labels; }
+
  private:
+  // Runs the operators in [begin, end) on ctx.
+  gs::Status executeRange(const GraphReadInterface& graph, Context& ctx,
+                          const std::map<std::string, std::string>& params,
+                          OprTimer& timer, size_t begin, size_t end);
+
+  // Runs the morsel parallel operators in [begin, end) on morsels of ctx.
+  // Returns false, leaving ctx as is, if their outputs cannot be
+  // concatenated.
+  bool executeMorsels(const GraphReadInterface& graph, Context& ctx,
+                      const std::map<std::string, std::string>& params,
+                      OprTimer& timer, size_t begin, size_t end,
+                      gs::Status& status);
+
+  // Runs the morsel parallel operators in [begin, end) on batches of ctx
+  // until they output limit rows. Returns false, leaving ctx as is, if their
+  // outputs cannot be concatenated.
+  bool executeBatches(const GraphReadInterface& graph, Context& ctx,
+                      const std::map<std::string, std::string>& params,
+                      OprTimer& timer, size_t begin, size_t end, size_t limit,
+                      gs::Status& status);
+
   std::vector<std::unique_ptr<IReadOperator>> operators_;
+  // Whether the run of morsel parallel operators starting at an index fell
+  // back to a single thread.
+  std::unique_ptr<std::atomic<bool>[]> sequential_;
+  LabelSet read_labels_;
 };
 
 class InsertPipeline {
@@ -43,15 +43,27 @@
 #include "flex/engines/graph_db/runtime/execute/ops/update/select.h"
 #include "flex/engines/graph_db/runtime/execute/ops/update/set.h"
 #include "flex/engines/graph_db/runtime/execute/ops/update/vertex.h"
+#include "flex/engines/graph_db/runtime/utils/utils.h"
 
 namespace gs {
 
 namespace runtime {
 
+// A read builder whose pattern spans several operators is a fusion rule: it
+// builds one operator for the whole chain, or returns null to leave it to the
+// builders of shorter patterns.
 void PlanParser::init() {
   register_read_operator_builder(std::make_unique<ops::ScanOprBuilder>());
 
   register_read_operator_builder(std::make_unique<ops::TCOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::EdgeExpandGetVCountOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::EdgeExpandCountOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::EdgeExpandGetVOrderByOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::EdgeExpandOrderByOprBuilder>());
   register_read_operator_builder(
       std::make_unique<ops::EdgeExpandGetVOprBuilder>());
   register_read_operator_builder(std::make_unique<ops::EdgeExpandOprBuilder>());
@@ -60,6 +72,8 @@ void PlanParser::init() {
 
   register_read_operator_builder(
       std::make_unique<ops::ProjectOrderByOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::ProjectLimitOprBuilder>());
   register_read_operator_builder(std::make_unique<ops::ProjectOprBuilder>());
 
   register_read_operator_builder(std::make_unique<ops::OrderByOprBuilder>());
@@ -73,6 +87,8 @@ void PlanParser::init() {
   register_read_operator_builder(
       std::make_unique<ops::SPOrderByLimitOprBuilder>());
   register_read_operator_builder(std::make_unique<ops::SPOprBuilder>());
+  register_read_operator_builder(
+      std::make_unique<ops::PathExpandVDedupOprBuilder>());
   register_read_operator_builder(
       std::make_unique<ops::PathExpandVOprBuilder>());
   register_read_operator_builder(std::make_unique<ops::PathExpandOprBuilder>());
@@ -119,7 +135,13 @@ PlanParser& PlanParser::get() {
 void PlanParser::register_read_operator_builder(
     std::unique_ptr<IReadOperatorBuilder>&& builder) {
   auto ops = builder->GetOpKinds();
-  read_op_builders_[*ops.begin()].emplace_back(ops, std::move(builder));
+  auto& builders = read_op_builders_[*ops.begin()];
+  // Longer patterns, fusing more operators, are tried first; those as long
+  // keep the order they are registered in.
+  auto iter = std::find_if(
+      builders.begin(), builders.end(),
+      [&ops](const auto& pair) { return pair.first.size() < ops.size(); });
+  builders.emplace(iter, ops, std::move(builder));
 }
 
 void PlanParser::register_write_operator_builder(
@@ -284,6 +306,9 @@ bl::result<ReadPipeline> PlanParser::parse_read_pipeline(
   if (!ret) {
     return ret.error();
   }
+  LabelSet labels;
+  parse_read_labels(plan, labels);
+  ret.value().first.set_read_labels(labels);
   return std::move(ret.value().first);
 }
 
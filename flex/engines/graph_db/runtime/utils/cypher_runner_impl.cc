@@ -26,8 +26,8 @@
 namespace gs {
 namespace runtime {
 
-bool CypherRunnerImpl::gen_plan(const GraphDB& db, const std::string& query,
-                                std::string& plan_str) {
+bool CypherRunnerImpl::compile(const GraphDB& db, const std::string& query,
+                               std::string& plan_str, bool cache_failure) {
   auto& plan_cache = plan_cache_;
   const std::string statistics = db.work_dir() + "/statistics.json";
   const std::string& compiler_yaml = db.work_dir() + "/graph.yaml";
@@ -35,19 +35,23 @@ bool CypherRunnerImpl::gen_plan(const GraphDB& db, const std::string& query,
   const auto& compiler_path = db.schema().get_compiler_path();
 
   if (plan_cache.get(query, plan_str)) {
-    return true;
+    return !plan_str.empty();
   }
 
   physical::PhysicalPlan plan;
   {
     // avoid multiple threads to generate plan for the same query
-    std::unique_lock<std::mutex> lock(mutex_);
-    if (plan_cache.get(query, plan_str)) {
-      return true;
+    std::unique_lock<std::mutex> lock(
+        compile_mutexes_[plan_cache.shard_id(query)]);
+    if (plan_cache.peek(query, plan_str)) {
+      return !plan_str.empty();
     }
     if (!generate_plan(query, statistics, compiler_path, compiler_yaml, tmp_dir,
                        plan)) {
       LOG(ERROR) << "Generate plan failed for query: " << query;
+      if (cache_failure) {
+        plan_cache.put(query, "");
+      }
       return false;
     }
     plan_str = plan.SerializeAsString();
@@ -57,11 +61,31 @@ bool CypherRunnerImpl::gen_plan(const GraphDB& db, const std::string& query,
   return true;
 }
 
+bool CypherRunnerImpl::gen_plan(const GraphDB& db, const std::string& query,
+                                std::string& plan_str) {
+  return compile(db, query, plan_str, false);
+}
+
+bool CypherRunnerImpl::gen_plan(const GraphDB& db, const std::string& query,
+                                std::map<std::string, std::string>& params,
+                                std::string& key, std::string& plan_str) {
+  std::map<std::string, std::string> lifted = params;
+  std::string tmpl = lift_literals(query, lifted);
+  if (tmpl != query && compile(db, tmpl, plan_str, true)) {
+    params.swap(lifted);
+    key = std::move(tmpl);
+    return true;
+  }
+  key = query;
+  return compile(db, query, plan_str, false);
+}
+
 std::string CypherRunnerImpl::run(
     gs::UpdateTransaction& tx, const std::string& cypher,
     const std::map<std::string, std::string>& params) {
-  std::string plan_str;
-  if (!gen_plan(tx.GetSession().db(), cypher, plan_str)) {
+  std::map<std::string, std::string> query_params = params;
+  std::string key, plan_str;
+  if (!gen_plan(tx.GetSession().db(), cypher, query_params, key, plan_str)) {
     std::string error = "    Generate plan failed: " + cypher;
     return "";
   }
@@ -82,14 +106,14 @@ std::string CypherRunnerImpl::run(
   auto pipeline = std::move(res.value());
   GraphUpdateInterface graph(tx);
   if (pipeline.is_insert()) {
-    auto ctx = pipeline.Execute(graph, WriteContext(), params, timer);
+    auto ctx = pipeline.Execute(graph, WriteContext(), query_params, timer);
     if (!ctx) {
       LOG(ERROR) << "Execute pipeline failed for query: " << cypher;
       std::string error = "    Execute pipeline failed: " + cypher;
       return "";
     }
   } else {
-    auto ctx = pipeline.Execute(graph, Context(), params, timer);
+    auto ctx = pipeline.Execute(graph, Context(), query_params, timer);
     if (!ctx) {
       LOG(ERROR) << "Execute pipeline failed for query: " << cypher;
       std::string error = "    Execute pipeline failed: " + cypher;
@@ -106,8 +130,9 @@ std::string CypherRunnerImpl::run(
 std::string CypherRunnerImpl::run(
     const gs::ReadTransaction& tx, const std::string& cypher,
     const std::map<std::string, std::string>& params) {
-  std::string plan_str;
-  if (!gen_plan(tx.GetSession().db(), cypher, plan_str)) {
+  std::map<std::string, std::string> query_params = params;
+  std::string key, plan_str;
+  if (!gen_plan(tx.GetSession().db(), cypher, query_params, key, plan_str)) {
     std::string error = "    Generate plan failed: " + cypher;
     return "";
   }
@@ -129,7 +154,7 @@ std::string CypherRunnerImpl::run(
   auto pipeline = std::move(res.value());
   GraphReadInterface graph(tx);
 
-  auto ctx = pipeline.Execute(graph, Context(), params, timer);
+  auto ctx = pipeline.Execute(graph, Context(), query_params, timer);
   if (!ctx) {
     LOG(ERROR) << "Execute pipeline failed for query: " << cypher;
     std::string error = "    Execute pipeline failed: " + cypher;
@@ -144,8 +169,9 @@ std::string CypherRunnerImpl::run(
 std::string CypherRunnerImpl::run(
     InsertTransaction& tx, const std::string& cypher,
     const std::map<std::string, std::string>& params) {
-  std::string plan_str;
-  if (!gen_plan(tx.GetSession().db(), cypher, plan_str)) {
+  std::map<std::string, std::string> query_params = params;
+  std::string key, plan_str;
+  if (!gen_plan(tx.GetSession().db(), cypher, query_params, key, plan_str)) {
     std::string error = "    Generate plan failed: " + cypher;
     return "";
   }
@@ -164,7 +190,7 @@ std::string CypherRunnerImpl::run(
   OprTimer timer;
   auto pipeline = std::move(res.value());
   GraphInsertInterface graph(tx);
-  auto ctx = pipeline.Execute(graph, WriteContext(), params, timer);
+  auto ctx = pipeline.Execute(graph, WriteContext(), query_params, timer);
   if (!ctx) {
     LOG(ERROR) << "Execute pipeline failed for query: " << cypher;
     std::string error = "    Execute pipeline failed: " + cypher;
@@ -184,7 +210,7 @@ const PlanCache& CypherRunnerImpl::get_plan_cache() const {
   return plan_cache_;
 }
 
-void CypherRunnerImpl::clear_cache() { plan_cache_.plan_cache.clear(); }
+void CypherRunnerImpl::clear_cache() { plan_cache_.clear(); }
 
 }  // namespace runtime
 }  // namespace gs
\ No newline at end of file
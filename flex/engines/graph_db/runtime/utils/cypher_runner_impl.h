@@ -18,9 +18,9 @@
 #include <map>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <string>
-#include <unordered_map>
+
+#include "flex/utils/lru_cache.h"
 
 namespace gs {
 
@@ -30,23 +30,102 @@ class InsertTransaction;
 class GraphDB;
 
 namespace runtime {
-struct PlanCache {
+struct PlanCacheStats {
+  size_t size = 0;
+  size_t capacity = 0;
+  uint64_t hit_num = 0;
+  uint64_t miss_num = 0;
+  uint64_t eviction_num = 0;
+};
+
+/**
+ * @brief The serialized plans of the queries, by query text, least recently
+ * used first evicted once capacity is reached.
+ *
+ * The queries are spread over SHARD_NUM shards by hash, each with its own
+ * lock, so that concurrent sessions looking up different queries do not
+ * wait for each other.
+ */
+class PlanCache {
+ public:
+  static constexpr size_t SHARD_NUM = 16;
+  static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+  explicit PlanCache(size_t capacity = DEFAULT_CAPACITY) {
+    for (size_t i = 0; i < SHARD_NUM; ++i) {
+      shards_[i] = std::make_unique<Shard>((capacity + SHARD_NUM - 1) /
+                                           SHARD_NUM);
+    }
+  }
+
   bool get(const std::string& query, std::string& plan) const {
-    std::shared_lock<std::shared_mutex> lock(mutex);
-    if (plan_cache.count(query)) {
-      plan = plan_cache.at(query);
-      return true;
+    Shard& shard = shard_of(query);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const std::string* ptr = shard.plans.get(query);
+    if (ptr == nullptr) {
+      return false;
     }
-    return false;
+    plan = *ptr;
+    return true;
+  }
+
+  // Like get, but neither counted nor marking the query as used.
+  bool peek(const std::string& query, std::string& plan) const {
+    Shard& shard = shard_of(query);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const std::string* ptr = shard.plans.peek(query);
+    if (ptr == nullptr) {
+      return false;
+    }
+    plan = *ptr;
+    return true;
   }
 
   void put(const std::string& query, const std::string& plan) {
-    std::unique_lock<std::shared_mutex> lock(mutex);
-    plan_cache[query] = plan;
+    Shard& shard = shard_of(query);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.plans.put(query, std::string(plan));
+  }
+
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->plans.clear();
+    }
+  }
+
+  PlanCacheStats stats() const {
+    PlanCacheStats ret;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      ret.size += shard->plans.size();
+      ret.capacity += shard->plans.capacity();
+      ret.hit_num += shard->plans.hit_num();
+      ret.miss_num += shard->plans.miss_num();
+      ret.eviction_num += shard->plans.eviction_num();
+    }
+    return ret;
   }
-  mutable std::shared_mutex mutex;
-  std::unordered_map<std::string, std::string> plan_cache;
+
+  size_t shard_id(const std::string& query) const {
+    return std::hash<std::string>()(query) % SHARD_NUM;
+  }
+
+ private:
+  struct Shard {
+    explicit Shard(size_t capacity) : plans(capacity) {}
+
+    std::mutex mutex;
+    LruCache<std::string, std::string> plans;
+  };
+
+  Shard& shard_of(const std::string& query) const {
+    return *shards_[shard_id(query)];
+  }
+
+  std::unique_ptr<Shard> shards_[SHARD_NUM];
 };
+
 class CypherRunnerImpl {
  public:
   std::string run(gs::UpdateTransaction& tx, const std::string& cypher,
@@ -61,6 +140,13 @@ class CypherRunnerImpl {
 
   bool gen_plan(const GraphDB& db, const std::string& query, std::string& plan);
 
+  // Compiles query with its literals lifted to params, see lift_literals, or
+  // as is if the template does not compile, which is remembered. key is set
+  // to the text the plan is cached by.
+  bool gen_plan(const GraphDB& db, const std::string& query,
+                std::map<std::string, std::string>& params, std::string& key,
+                std::string& plan);
+
   const PlanCache& get_plan_cache() const;
 
   void clear_cache();
@@ -70,8 +156,14 @@ class CypherRunnerImpl {
 
   CypherRunnerImpl(const CypherRunnerImpl&) = delete;
   CypherRunnerImpl& operator=(const CypherRunnerImpl&) = delete;
+  // Compiles query unless cached, with an empty plan cached on failure if
+  // cache_failure.
+  bool compile(const GraphDB& db, const std::string& query, std::string& plan,
+               bool cache_failure);
+
   PlanCache plan_cache_;
-  std::mutex mutex_;
+  // To compile each query once, by shard of the plan cache.
+  std::mutex compile_mutexes_[PlanCache::SHARD_NUM];
 };
 }  // namespace runtime
 }  // namespace gs
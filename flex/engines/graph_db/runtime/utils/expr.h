@@ -43,6 +43,12 @@ class Expr {
 
   RTAnyType type() const;
 
+  // Keeps the rows of sel on which the expression, a predicate, holds. Only
+  // for expressions that are not optional.
+  void filter_path(std::vector<size_t>& sel, Arena& arena) const {
+    expr_->filter_path(sel, arena);
+  }
+
   // for container such as list, set etc.
   RTAnyType elem_type() const { return expr_->elem_type(); }
 
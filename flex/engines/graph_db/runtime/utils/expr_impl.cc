@@ -124,6 +124,54 @@ RTAny LogicalExpr::eval_edge(const LabelTriplet& label, vid_t src, vid_t dst,
 
 RTAnyType LogicalExpr::type() const { return RTAnyType::kBoolValue; }
 
+static bool to_compare_op(common::Logical logic, bool flipped, CompareOp& op) {
+  switch (logic) {
+  case common::Logical::LT:
+    op = flipped ? CompareOp::kGT : CompareOp::kLT;
+    return true;
+  case common::Logical::LE:
+    op = flipped ? CompareOp::kGE : CompareOp::kLE;
+    return true;
+  case common::Logical::GT:
+    op = flipped ? CompareOp::kLT : CompareOp::kGT;
+    return true;
+  case common::Logical::GE:
+    op = flipped ? CompareOp::kLE : CompareOp::kGE;
+    return true;
+  case common::Logical::EQ:
+    op = CompareOp::kEQ;
+    return true;
+  case common::Logical::NE:
+    op = CompareOp::kNE;
+    return true;
+  default:
+    return false;
+  }
+}
+
+void LogicalExpr::filter_path(std::vector<size_t>& sel, Arena& arena) const {
+  if (logic_ == common::Logical::AND) {
+    lhs_->filter_path(sel, arena);
+    rhs_->filter_path(sel, arena);
+    return;
+  }
+  auto lhs_var = dynamic_cast<const VariableExpr*>(lhs_.get());
+  auto rhs_const = dynamic_cast<const ConstExpr*>(rhs_.get());
+  bool flipped = false;
+  if (lhs_var == nullptr || rhs_const == nullptr) {
+    lhs_var = dynamic_cast<const VariableExpr*>(rhs_.get());
+    rhs_const = dynamic_cast<const ConstExpr*>(lhs_.get());
+    flipped = true;
+  }
+  CompareOp op;
+  if (lhs_var != nullptr && rhs_const != nullptr &&
+      to_compare_op(logic_, flipped, op) &&
+      lhs_var->var().filter_path(op, rhs_const->value(), sel)) {
+    return;
+  }
+  ExprBase::filter_path(sel, arena);
+}
+
 UnaryLogicalExpr::UnaryLogicalExpr(std::unique_ptr<ExprBase>&& expr,
                                    common::Logical logic)
     : expr_(std::move(expr)), logic_(logic) {}
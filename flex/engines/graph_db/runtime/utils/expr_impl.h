@@ -50,6 +50,21 @@ class ExprBase {
 
   virtual RTAnyType elem_type() const { return RTAnyType::kEmpty; }
 
+  // Keeps the rows of sel on which the expression, a predicate, holds, null
+  // counting as false. Expressions with typed kernels override it, the rest
+  // are evaluated row by row.
+  virtual void filter_path(std::vector<size_t>& sel, Arena& arena) const {
+    if (is_optional()) {
+      compact_rows(
+          sel, [this, &arena](size_t idx) { return eval_path(idx, arena, 0); },
+          [](const RTAny& val) { return !val.is_null() && val.as_bool(); });
+    } else {
+      compact_rows(
+          sel, [this, &arena](size_t idx) { return eval_path(idx, arena); },
+          [](const RTAny& val) { return val.as_bool(); });
+    }
+  }
+
   virtual ~ExprBase() = default;
 };
 
@@ -282,6 +297,8 @@ class VariableExpr : public ExprBase {
 
   bool is_optional() const override { return var_.is_optional(); }
 
+  const Var& var() const { return var_; }
+
  private:
   Var var_;
 };
@@ -362,6 +379,10 @@ class LogicalExpr : public ExprBase {
     return lhs_->is_optional() || rhs_->is_optional();
   }
 
+  // AND filters through both sides, and a comparison of a variable with a
+  // constant through the typed column of the variable.
+  void filter_path(std::vector<size_t>& sel, Arena& arena) const override;
+
  private:
   std::unique_ptr<ExprBase> lhs_;
   std::unique_ptr<ExprBase> rhs_;
@@ -464,6 +485,8 @@ class ConstExpr : public ExprBase {
 
   bool is_optional() const override { return val_.is_null(); }
 
+  const RTAny& value() const { return val_; }
+
  private:
   RTAny val_;
   std::string s;
@@ -846,9 +869,9 @@ class StrConcatExpr : public ExprBase {
                 std::unique_ptr<ExprBase>&& rhs)
       : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
   RTAny eval_path(size_t idx, Arena& arena) const override {
-    std::string ret = std::string(lhs->eval_path(idx, arena).as_string()) +
-                      ";" + std::string(rhs->eval_path(idx, arena).as_string());
-    auto ptr = StringImpl::make_string_impl(ret);
+    auto ptr = StringImpl::make_string_impl(
+        {lhs->eval_path(idx, arena).as_string(), ";",
+         rhs->eval_path(idx, arena).as_string()});
     auto sv = ptr->str_view();
     arena.emplace_back(std::move(ptr));
 
@@ -865,10 +888,9 @@ class StrConcatExpr : public ExprBase {
 
   RTAny eval_vertex(label_t label, vid_t v, size_t idx,
                     Arena& arena) const override {
-    std::string ret =
-        std::string(lhs->eval_vertex(label, v, idx, arena).as_string()) + ";" +
-        std::string(rhs->eval_vertex(label, v, idx, arena).as_string());
-    auto ptr = StringImpl::make_string_impl(ret);
+    auto ptr = StringImpl::make_string_impl(
+        {lhs->eval_vertex(label, v, idx, arena).as_string(), ";",
+         rhs->eval_vertex(label, v, idx, arena).as_string()});
     auto sv = ptr->str_view();
     arena.emplace_back(std::move(ptr));
 
@@ -877,13 +899,9 @@ class StrConcatExpr : public ExprBase {
 
   RTAny eval_edge(const LabelTriplet& label, vid_t src, vid_t dst,
                   const Any& data, size_t idx, Arena& arena) const override {
-    std::string ret =
-        std::string(
-            lhs->eval_edge(label, src, dst, data, idx, arena).as_string()) +
-        ";" +
-        std::string(
-            rhs->eval_edge(label, src, dst, data, idx, arena).as_string());
-    auto ptr = StringImpl::make_string_impl(ret);
+    auto ptr = StringImpl::make_string_impl(
+        {lhs->eval_edge(label, src, dst, data, idx, arena).as_string(), ";",
+         rhs->eval_edge(label, src, dst, data, idx, arena).as_string()});
     auto sv = ptr->str_view();
     arena.emplace_back(std::move(ptr));
 
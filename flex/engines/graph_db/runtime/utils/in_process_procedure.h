@@ -0,0 +1,120 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RUNTIME_UTILS_IN_PROCESS_PROCEDURE_H_
+#define RUNTIME_UTILS_IN_PROCESS_PROCEDURE_H_
+
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/leaf_utils.h"
+#include "flex/engines/graph_db/runtime/common/rt_any.h"
+
+namespace gs {
+
+namespace runtime {
+
+// The output rows of the calls of a procedure on the rows of a context, one
+// value per output column of the call.
+class ProcedureOutput {
+ public:
+  explicit ProcedureOutput(size_t col_num)
+      : columns_(col_num), arena_(std::make_shared<Arena>()), row_(0) {}
+
+  template <typename... T>
+  void Emit(const T&... vals) {
+    CHECK_EQ(sizeof...(T), columns_.size());
+    size_t col = 0;
+    (columns_[col++].push_back(own(TypedConverter<T>::from_typed(vals))), ...);
+    offsets_.push_back(row_);
+  }
+
+  // The input row of the rows emitted from now on.
+  void set_row(size_t row) { row_ = row; }
+
+  const std::vector<std::vector<RTAny>>& columns() const { return columns_; }
+  const std::vector<size_t>& offsets() const { return offsets_; }
+  // Holds the strings of the columns.
+  const std::shared_ptr<Arena>& arena() const { return arena_; }
+
+ private:
+  RTAny own(RTAny val) {
+    if (val.type() == RTAnyType::kStringValue) {
+      auto ptr = StringImpl::make_string_impl(val.as_string());
+      val = RTAny::from_string(ptr->str_view());
+      arena_->emplace_back(std::move(ptr));
+    }
+    return val;
+  }
+
+  std::vector<std::vector<RTAny>> columns_;
+  std::vector<size_t> offsets_;
+  std::shared_ptr<Arena> arena_;
+  size_t row_;
+};
+
+/**
+ * @brief A read procedure the ProcedureCall operator calls in process, on
+ * the values of the arguments in the context, appending its rows to the
+ * output columns, without the protobuf encoding of the arguments and of
+ * the results Query of ReadAppBase goes through. The app of the procedure
+ * implements it alongside ReadAppBase, which serves the other clients.
+ */
+class InProcessReadProcedure {
+ public:
+  virtual ~InProcessReadProcedure() = default;
+
+  virtual bl::result<bool> Call(const GraphReadInterface& graph,
+                                const std::vector<RTAny>& args,
+                                ProcedureOutput& output) = 0;
+};
+
+// With the arguments converted to ARGS, see TypedConverter.
+template <typename... ARGS>
+class TypedInProcessReadProcedure : public InProcessReadProcedure {
+ public:
+  virtual bl::result<bool> Query(const GraphReadInterface& graph,
+                                 ProcedureOutput& output, ARGS... args) = 0;
+
+  bl::result<bool> Call(const GraphReadInterface& graph,
+                        const std::vector<RTAny>& args,
+                        ProcedureOutput& output) override {
+    if (args.size() != sizeof...(ARGS)) {
+      RETURN_BAD_REQUEST_ERROR("Arguments size mismatch: " +
+                               std::to_string(args.size()) + " vs " +
+                               std::to_string(sizeof...(ARGS)));
+    }
+    return call(graph, args, output, std::index_sequence_for<ARGS...>());
+  }
+
+ private:
+  template <size_t... I>
+  bl::result<bool> call(const GraphReadInterface& graph,
+                        const std::vector<RTAny>& args,
+                        ProcedureOutput& output, std::index_sequence<I...>) {
+    if (!((args[I].type() == TypedConverter<ARGS>::type()) && ...)) {
+      RETURN_BAD_REQUEST_ERROR("Arguments type mismatch");
+    }
+    return Query(graph, output, TypedConverter<ARGS>::to_typed(args[I])...);
+  }
+};
+
+}  // namespace runtime
+
+}  // namespace gs
+
+#endif  // RUNTIME_UTILS_IN_PROCESS_PROCEDURE_H_
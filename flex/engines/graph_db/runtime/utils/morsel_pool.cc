@@ -0,0 +1,137 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
+
+#include <algorithm>
+
+namespace gs {
+
+namespace runtime {
+
+static thread_local bool is_morsel_worker = false;
+
+MorselPool& MorselPool::get() {
+  static MorselPool pool;
+  return pool;
+}
+
+MorselPool::~MorselPool() { stop(); }
+
+void MorselPool::Init(int thread_num, size_t min_rows, size_t morsel_rows) {
+  stop();
+  min_rows_ = std::max<size_t>(min_rows, 1);
+  morsel_rows_ = std::max<size_t>(morsel_rows, 1);
+  if (thread_num <= 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = true;
+  }
+  for (int i = 0; i < thread_num; ++i) {
+    workers_.emplace_back([this]() { workerLoop(); });
+  }
+  thread_num_ = thread_num;
+}
+
+bool MorselPool::Enabled(size_t row_num) const {
+  return thread_num_.load() > 0 && !is_morsel_worker && row_num >= min_rows_;
+}
+
+size_t MorselPool::MorselNum(size_t row_num) const {
+  // The workers and the calling thread.
+  size_t max_num = (thread_num_.load() + 1) * 4;
+  size_t num = (row_num + morsel_rows_ - 1) / morsel_rows_;
+  return std::max<size_t>(std::min(num, max_num), 1);
+}
+
+void MorselPool::Run(size_t task_num, const std::function<void(size_t)>& task) {
+  if (task_num == 0) {
+    return;
+  }
+  if (is_morsel_worker || thread_num_.load() == 0 || task_num == 1) {
+    for (size_t i = 0; i < task_num; ++i) {
+      task(i);
+    }
+    return;
+  }
+  auto batch = std::make_shared<Batch>();
+  batch->task = &task;
+  batch->task_num = task_num;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_.push_back(batch);
+  }
+  cv_.notify_all();
+  runBatch(*batch);
+  std::unique_lock<std::mutex> lock(batch->mutex);
+  batch->cv.wait(lock, [&]() { return batch->done.load() == task_num; });
+}
+
+void MorselPool::runBatch(Batch& batch) {
+  while (true) {
+    size_t i = batch.next.fetch_add(1);
+    if (i >= batch.task_num) {
+      return;
+    }
+    (*batch.task)(i);
+    if (batch.done.fetch_add(1) + 1 == batch.task_num) {
+      std::lock_guard<std::mutex> lock(batch.mutex);
+      batch.cv.notify_all();
+    }
+  }
+}
+
+void MorselPool::workerLoop() {
+  is_morsel_worker = true;
+  while (true) {
+    std::shared_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return !running_ || !batches_.empty(); });
+      if (!running_) {
+        return;
+      }
+      batch = batches_.front();
+      // Every morsel of the batch is taken, the last ones possibly still
+      // running elsewhere.
+      if (batch->next.load() >= batch->task_num) {
+        batches_.pop_front();
+        continue;
+      }
+    }
+    runBatch(*batch);
+  }
+}
+
+void MorselPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  cv_.notify_all();
+  for (auto& thrd : workers_) {
+    thrd.join();
+  }
+  workers_.clear();
+  thread_num_ = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_.clear();
+}
+
+}  // namespace runtime
+
+}  // namespace gs
@@ -0,0 +1,97 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUNTIME_UTILS_MORSEL_POOL_H_
+#define RUNTIME_UTILS_MORSEL_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gs {
+
+namespace runtime {
+
+/**
+ * @brief The threads running the morsels of read pipelines, shared by the
+ * queries of the process.
+ *
+ * Run hands a batch of morsels to the pool. The workers and the calling
+ * thread take the next morsel of the oldest batch from a shared counter until
+ * none is left, so that a query keeps making progress while every worker is
+ * busy with other queries, and a fast morsel does not wait for a slow one.
+ */
+class MorselPool {
+ public:
+  // Below this number of rows, the operators run on the calling thread.
+  static constexpr size_t DEFAULT_MIN_ROWS = 1 << 14;
+  static constexpr size_t DEFAULT_MORSEL_ROWS = 1 << 12;
+
+  static MorselPool& get();
+
+  ~MorselPool();
+
+  // Starts thread_num workers, replacing the previous ones. 0 disables the
+  // parallel execution.
+  void Init(int thread_num, size_t min_rows = DEFAULT_MIN_ROWS,
+            size_t morsel_rows = DEFAULT_MORSEL_ROWS);
+
+  // Whether a pipeline on row_num rows is split into morsels.
+  bool Enabled(size_t row_num) const;
+
+  // The number of morsels to split row_num rows into, a few per thread.
+  size_t MorselNum(size_t row_num) const;
+
+  // Calls task on 0 to task_num - 1, returning once all calls are done. On a
+  // worker, the calls run on the worker itself.
+  void Run(size_t task_num, const std::function<void(size_t)>& task);
+
+ private:
+  struct Batch {
+    const std::function<void(size_t)>* task;
+    size_t task_num;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+
+  MorselPool() = default;
+
+  void stop();
+  void workerLoop();
+  static void runBatch(Batch& batch);
+
+  size_t min_rows_ = DEFAULT_MIN_ROWS;
+  size_t morsel_rows_ = DEFAULT_MORSEL_ROWS;
+  std::atomic<int> thread_num_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<Batch>> batches_;
+  bool running_ = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace runtime
+
+}  // namespace gs
+
+#endif  // RUNTIME_UTILS_MORSEL_POOL_H_
@@ -14,6 +14,12 @@
  */
 
 #include "flex/engines/graph_db/runtime/utils/opr_timer.h"
+
+#include <atomic>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
 #include "flex/proto_generated_gie/physical.pb.h"
 
 namespace gs {
@@ -43,6 +49,9 @@ void OprTimer::output(const std::string& path) const {
 }
 
 void OprTimer::clear() {
+  profiles_.clear();
+  profile_index_.clear();
+  depth_ = 0;
 #ifdef RT_PROFILE
   opr_timers_.clear();
   routine_timers_.clear();
@@ -50,7 +59,91 @@ void OprTimer::clear() {
 #endif
 }
 
+static std::atomic<double> profile_sample_rate(0);
+
+void OprTimer::set_profile_sample_rate(double rate) {
+  profile_sample_rate.store(rate, std::memory_order_relaxed);
+}
+
+bool OprTimer::sample_profile() {
+  double rate = profile_sample_rate.load(std::memory_order_relaxed);
+  if (rate <= 0) {
+    return false;
+  }
+  static thread_local std::mt19937 rng(std::random_device{}());
+  return std::uniform_real_distribution<double>(0, 1)(rng) < rate;
+}
+
+size_t OprTimer::enter_opr(const void* pipeline, size_t op_idx,
+                           const std::string& name) {
+  auto key = std::make_tuple(pipeline, op_idx);
+  auto iter = profile_index_.find(key);
+  size_t idx;
+  if (iter == profile_index_.end()) {
+    idx = profiles_.size();
+    profile_index_.emplace(key, idx);
+    profiles_.emplace_back();
+    profiles_.back().name = name;
+    profiles_.back().depth = depth_;
+  } else {
+    idx = iter->second;
+  }
+  ++depth_;
+  return idx;
+}
+
+void OprTimer::exit_opr(size_t idx, double time, size_t rows_in,
+                        size_t rows_out, size_t bytes) {
+  --depth_;
+  auto& profile = profiles_[idx];
+  ++profile.calls;
+  profile.time += time;
+  profile.rows_in += rows_in;
+  profile.rows_out += rows_out;
+  profile.bytes += bytes;
+}
+
+std::string OprTimer::explain() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  double total = 0;
+  for (const auto& profile : profiles_) {
+    if (profile.depth == 0) {
+      total += profile.time;
+    }
+  }
+  ss << "EXPLAIN ANALYZE (" << total * 1000 << " ms)" << std::endl;
+  for (const auto& profile : profiles_) {
+    ss << std::string(2 * profile.depth + 2, ' ') << "-> " << profile.name
+       << " (calls: " << profile.calls << ", rows: " << profile.rows_in
+       << " -> " << profile.rows_out << ", time: " << profile.time * 1000
+       << " ms, bytes: " << profile.bytes << ")" << std::endl;
+  }
+  return ss.str();
+}
+
 OprTimer& OprTimer::operator+=(const OprTimer& other) {
+  // Appended in the order they first ran in other.
+  std::vector<const std::tuple<const void*, size_t>*> keys(
+      other.profiles_.size());
+  for (const auto& pair : other.profile_index_) {
+    keys[pair.second] = &pair.first;
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto& profile = other.profiles_[i];
+    auto iter = profile_index_.find(*keys[i]);
+    if (iter == profile_index_.end()) {
+      profile_index_.emplace(*keys[i], profiles_.size());
+      profiles_.push_back(profile);
+    } else {
+      auto& merged = profiles_[iter->second];
+      merged.calls += profile.calls;
+      merged.time += profile.time;
+      merged.rows_in += profile.rows_in;
+      merged.rows_out += profile.rows_out;
+      merged.bytes += profile.bytes;
+    }
+  }
 #ifdef RT_PROFILE
   total_time_ += other.total_time_;
   for (const auto& pair : other.opr_timers_) {
@@ -15,6 +15,11 @@
 #ifndef RUNTIME_UTILS_RUNTIME_H_
 #define RUNTIME_UTILS_RUNTIME_H_
 
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
 #include "flex/engines/graph_db/runtime/common/graph_interface.h"
 
 namespace gs {
@@ -46,11 +51,57 @@ class TimerUnit {
 #endif
 };
 
+// What an operator of a profiled query did, summed over its calls, and over
+// its morsels if it ran on several threads.
+struct OprProfile {
+  std::string name;
+  // The nesting of the pipeline the operator belongs to, 0 for the plan.
+  int depth = 0;
+  size_t calls = 0;
+  double time = 0;
+  size_t rows_in = 0;
+  size_t rows_out = 0;
+  // Bytes allocated through the QueryArena while the operator ran.
+  size_t bytes = 0;
+};
+
 class OprTimer {
  public:
-  OprTimer() = default;
+  OprTimer() : profiling_(false), depth_(0) {}
   ~OprTimer() = default;
 
+  // Unlike the timers above, profiling is switched at run time, per query:
+  // while it is on, ReadPipeline records each operator it runs, see
+  // explain().
+  void set_profiling(bool profiling) { profiling_ = profiling; }
+  bool profiling() const { return profiling_; }
+
+  // A timer for a morsel of a pipeline run with this one, merged back with
+  // operator+=.
+  OprTimer fork() const {
+    OprTimer ret;
+    ret.profiling_ = profiling_;
+    ret.depth_ = depth_;
+    return ret;
+  }
+
+  // Returns the profile of the op_idx-th operator of pipeline, created on
+  // first use, and enters it, the pipelines it runs being nested beneath.
+  size_t enter_opr(const void* pipeline, size_t op_idx,
+                   const std::string& name);
+  void exit_opr(size_t idx, double time, size_t rows_in, size_t rows_out,
+                size_t bytes);
+
+  const std::vector<OprProfile>& profiles() const { return profiles_; }
+
+  // The operators recorded, in the order they first ran, as an indented
+  // tree of pipelines with the figures of each.
+  std::string explain() const;
+
+  // The fraction of queries profiled without asking, 0 by default.
+  static void set_profile_sample_rate(double rate);
+  static bool sample_profile();
+
   void add_total(double time) {
 #ifdef RT_PROFILE
     total_time_ += time;
@@ -94,6 +145,11 @@ class OprTimer {
   OprTimer& operator+=(const OprTimer& other);
 
  private:
+  bool profiling_;
+  int depth_;
+  std::vector<OprProfile> profiles_;
+  std::map<std::tuple<const void*, size_t>, size_t> profile_index_;
+
 #ifdef RT_PROFILE
   std::map<std::string, double> opr_timers_;
   std::map<std::string, double> routine_timers_;
@@ -186,6 +186,7 @@ enum class SPPredicateType {
   kPropertyEQ,
   kPropertyNE,
   kPropertyBetween,
+  kPropertyConjunction,
   kWithIn,
   kUnknown
 };
@@ -404,12 +405,14 @@ class VertexPropertyEQPredicateBeta : public SPVertexPredicate {
     }
     target_str_ = target_str;
     target_ = TypedConverter<T>::typed_from_string(target_str_);
+    init_codes();
   }
 
   VertexPropertyEQPredicateBeta(VertexPropertyEQPredicateBeta&& other) {
     columns_ = std::move(other.columns_);
     target_str_ = std::move(other.target_str_);
     target_ = TypedConverter<T>::typed_from_string(target_str_);
+    codes_ = std::move(other.codes_);
   }
 
   ~VertexPropertyEQPredicateBeta() = default;
@@ -423,14 +426,30 @@ class VertexPropertyEQPredicateBeta : public SPVertexPredicate {
   }
 
   inline bool operator()(label_t label, vid_t v) const {
-    return target_ == columns_[label].get_view(v);
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return columns_[label].equals(v, target_, codes_[label]);
+    } else {
+      return target_ == columns_[label].get_view(v);
+    }
   }
 
  private:
+  void init_codes() {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      codes_.resize(columns_.size());
+      for (size_t i = 0; i < columns_.size(); ++i) {
+        if (!columns_[i].is_null()) {
+          codes_[i] = columns_[i].get_code(target_);
+        }
+      }
+    }
+  }
+
   std::vector<GraphReadInterface::vertex_column_t<T>> columns_;
   T target_;
   // for string_view
   std::string target_str_;
+  std::vector<StringDictCode> codes_;
 };
 
 template <typename T>
@@ -445,12 +464,14 @@ class VertexPropertyNEPredicateBeta : public SPVertexPredicate {
     }
     target_str_ = target_str;
     target_ = TypedConverter<T>::typed_from_string(target_str_);
+    init_codes();
   }
 
   VertexPropertyNEPredicateBeta(VertexPropertyNEPredicateBeta&& other) {
     columns_ = std::move(other.columns_);
     target_str_ = std::move(other.target_str_);
     target_ = TypedConverter<T>::typed_from_string(target_str_);
+    codes_ = std::move(other.codes_);
   }
 
   ~VertexPropertyNEPredicateBeta() = default;
@@ -464,13 +485,29 @@ class VertexPropertyNEPredicateBeta : public SPVertexPredicate {
   }
 
   inline bool operator()(label_t label, vid_t v) const {
-    return !(target_ == columns_[label].get_view(v));
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return !columns_[label].equals(v, target_, codes_[label]);
+    } else {
+      return !(target_ == columns_[label].get_view(v));
+    }
   }
 
  private:
+  void init_codes() {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      codes_.resize(columns_.size());
+      for (size_t i = 0; i < columns_.size(); ++i) {
+        if (!columns_[i].is_null()) {
+          codes_[i] = columns_[i].get_code(target_);
+        }
+      }
+    }
+  }
+
   std::vector<GraphReadInterface::vertex_column_t<T>> columns_;
   T target_;
   std::string target_str_;
+  std::vector<StringDictCode> codes_;
 };
 
 template <typename T>
@@ -554,9 +591,244 @@ inline std::unique_ptr<SPVertexPredicate> _make_vertex_predicate(
   }
 }
 
+// One comparison of a VertexPropertyConjunctionPredicate.
+class SPVertexTerm {
+ public:
+  virtual ~SPVertexTerm() {}
+  virtual bool operator()(label_t label, vid_t v) const = 0;
+};
+
+template <typename PRED_T>
+class SPVertexTermImpl : public SPVertexTerm {
+ public:
+  template <typename... ARGS>
+  SPVertexTermImpl(ARGS&&... args) : pred_(std::forward<ARGS>(args)...) {}
+
+  inline bool operator()(label_t label, vid_t v) const override {
+    return pred_(label, v);
+  }
+
+ private:
+  PRED_T pred_;
+};
+
+template <typename T>
+inline std::unique_ptr<SPVertexTerm> _make_vertex_term(
+    const SPPredicateType& ptype, const GraphReadInterface& graph,
+    const std::string& property_name, const std::string& target_str) {
+  if (ptype == SPPredicateType::kPropertyLT) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyLTPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else if (ptype == SPPredicateType::kPropertyEQ) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyEQPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else if (ptype == SPPredicateType::kPropertyGT) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyGTPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else if (ptype == SPPredicateType::kPropertyLE) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyLEPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else if (ptype == SPPredicateType::kPropertyGE) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyGEPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else if (ptype == SPPredicateType::kPropertyNE) {
+    return std::make_unique<SPVertexTermImpl<VertexPropertyNEPredicateBeta<T>>>(
+        graph, property_name, target_str);
+  } else {
+    return nullptr;
+  }
+}
+
+inline std::unique_ptr<SPVertexTerm> make_vertex_term(
+    RTAnyType type, const SPPredicateType& ptype,
+    const GraphReadInterface& graph, const std::string& property_name,
+    const std::string& target_str) {
+  switch (type) {
+  case RTAnyType::kI64Value:
+    return _make_vertex_term<int64_t>(ptype, graph, property_name, target_str);
+  case RTAnyType::kI32Value:
+    return _make_vertex_term<int32_t>(ptype, graph, property_name, target_str);
+  case RTAnyType::kF64Value:
+    return _make_vertex_term<double>(ptype, graph, property_name, target_str);
+  case RTAnyType::kStringValue:
+    return _make_vertex_term<std::string_view>(ptype, graph, property_name,
+                                               target_str);
+  case RTAnyType::kTimestamp:
+    return _make_vertex_term<Date>(ptype, graph, property_name, target_str);
+  case RTAnyType::kDate32:
+    return _make_vertex_term<Day>(ptype, graph, property_name, target_str);
+  default:
+    return nullptr;
+  }
+}
+
+/**
+ * @brief The conjunction of comparisons of vertex properties with
+ * parameters, each instantiated for its property type and operator, so a
+ * vertex is checked with one virtual call per comparison instead of through
+ * the expression interpreter.
+ */
+class VertexPropertyConjunctionPredicate : public SPVertexPredicate {
+ public:
+  VertexPropertyConjunctionPredicate(
+      std::vector<std::unique_ptr<SPVertexTerm>>&& terms)
+      : terms_(std::move(terms)) {}
+
+  ~VertexPropertyConjunctionPredicate() = default;
+
+  inline SPPredicateType type() const override {
+    return SPPredicateType::kPropertyConjunction;
+  }
+
+  // The comparisons have types of their own.
+  inline RTAnyType data_type() const override { return RTAnyType::kEmpty; }
+
+  inline bool operator()(label_t label, vid_t v) const {
+    for (const auto& term : terms_) {
+      if (!(*term)(label, v)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::vector<std::unique_ptr<SPVertexTerm>> terms_;
+};
+
+struct SPVertexTermSpec {
+  std::string property_name;
+  SPPredicateType ptype;
+  std::string param_name;
+  RTAnyType type;
+};
+
+// Parses operators [begin, end) as `property op param`, braced or not.
+inline bool parse_sp_vertex_term(const common::Expression& expr, int begin,
+                                 int end, SPVertexTermSpec& spec) {
+  if (end - begin == 5) {
+    const auto& left = expr.operators(begin);
+    const auto& right = expr.operators(end - 1);
+    if (!(left.item_case() == common::ExprOpr::kBrace &&
+          left.brace() == common::ExprOpr_Brace::ExprOpr_Brace_LEFT_BRACE &&
+          right.item_case() == common::ExprOpr::kBrace &&
+          right.brace() == common::ExprOpr_Brace::ExprOpr_Brace_RIGHT_BRACE)) {
+      return false;
+    }
+    ++begin;
+    --end;
+  }
+  if (end - begin != 3) {
+    return false;
+  }
+  const common::ExprOpr& op0 = expr.operators(begin);
+  if (!(op0.has_var() && op0.var().has_property() &&
+        op0.var().property().has_key() &&
+        op0.var().property().key().item_case() ==
+            common::NameOrId::ItemCase::kName)) {
+    return false;
+  }
+  spec.property_name = op0.var().property().key().name();
+
+  const common::ExprOpr& op1 = expr.operators(begin + 1);
+  if (op1.item_case() != common::ExprOpr::kLogical) {
+    return false;
+  }
+  switch (op1.logical()) {
+  case common::Logical::LT:
+    spec.ptype = SPPredicateType::kPropertyLT;
+    break;
+  case common::Logical::GT:
+    spec.ptype = SPPredicateType::kPropertyGT;
+    break;
+  case common::Logical::EQ:
+    spec.ptype = SPPredicateType::kPropertyEQ;
+    break;
+  case common::Logical::LE:
+    spec.ptype = SPPredicateType::kPropertyLE;
+    break;
+  case common::Logical::GE:
+    spec.ptype = SPPredicateType::kPropertyGE;
+    break;
+  case common::Logical::NE:
+    spec.ptype = SPPredicateType::kPropertyNE;
+    break;
+  default:
+    return false;
+  }
+
+  const common::ExprOpr& op2 = expr.operators(begin + 2);
+  if (!(op2.has_param() && op2.param().has_data_type() &&
+        op2.param().data_type().type_case() ==
+            common::IrDataType::TypeCase::kDataType)) {
+    return false;
+  }
+  spec.param_name = op2.param().name();
+  spec.type = parse_from_ir_data_type(op2.param().data_type());
+  switch (spec.type) {
+  case RTAnyType::kI64Value:
+  case RTAnyType::kI32Value:
+  case RTAnyType::kF64Value:
+  case RTAnyType::kStringValue:
+  case RTAnyType::kTimestamp:
+  case RTAnyType::kDate32:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Parses `term AND term AND ...` with at least two terms, each a comparison
+// of a property of the vertex with a parameter, braced or not.
 inline std::optional<std::function<std::unique_ptr<SPVertexPredicate>(
     const GraphReadInterface&, const std::map<std::string, std::string>&)>>
-parse_special_vertex_predicate(const common::Expression& expr) {
+parse_special_vertex_conjunction(const common::Expression& expr) {
+  std::vector<SPVertexTermSpec> specs;
+  int begin = 0;
+  int op_num = expr.operators_size();
+  while (begin < op_num) {
+    int end = begin;
+    while (end < op_num &&
+           !(expr.operators(end).item_case() == common::ExprOpr::kLogical &&
+             expr.operators(end).logical() == common::Logical::AND)) {
+      ++end;
+    }
+    SPVertexTermSpec spec;
+    if (!parse_sp_vertex_term(expr, begin, end, spec)) {
+      return std::nullopt;
+    }
+    specs.emplace_back(std::move(spec));
+    begin = end + 1;
+    if (end + 1 == op_num) {
+      // A trailing AND.
+      return std::nullopt;
+    }
+  }
+  if (specs.size() < 2) {
+    return std::nullopt;
+  }
+  // Equalities reject the most vertices, check them first.
+  std::stable_partition(specs.begin(), specs.end(),
+                        [](const SPVertexTermSpec& spec) {
+                          return spec.ptype == SPPredicateType::kPropertyEQ;
+                        });
+  return [specs](const GraphReadInterface& graph,
+                 const std::map<std::string, std::string>& params)
+             -> std::unique_ptr<SPVertexPredicate> {
+    std::vector<std::unique_ptr<SPVertexTerm>> terms;
+    for (const auto& spec : specs) {
+      terms.emplace_back(make_vertex_term(spec.type, spec.ptype, graph,
+                                          spec.property_name,
+                                          params.at(spec.param_name)));
+    }
+    return std::make_unique<VertexPropertyConjunctionPredicate>(
+        std::move(terms));
+  };
+}
+
+inline std::optional<std::function<std::unique_ptr<SPVertexPredicate>(
+    const GraphReadInterface&, const std::map<std::string, std::string>&)>>
+parse_special_vertex_comparison(const common::Expression& expr) {
   if (expr.operators_size() == 3) {
     const common::ExprOpr& op0 = expr.operators(0);
     if (!op0.has_var()) {
@@ -799,6 +1071,27 @@ parse_special_vertex_predicate(const common::Expression& expr) {
   return std::nullopt;
 }
 
+/**
+ * Vertex predicates with specialized kernels, which operators check vertices
+ * with instead of the expression interpreter:
+ *  - `property op $param`, op one of <, <=, >, >=, =, <>, for int32, int64,
+ *    double, string and timestamp parameters;
+ *  - `property >= $from AND property < $to` of the same property;
+ *  - `term AND term AND ...` of two or more such comparisons, possibly
+ *    braced, also for date parameters.
+ * Comparisons with constants, disjunctions and anything else are left to the
+ * interpreter.
+ */
+inline std::optional<std::function<std::unique_ptr<SPVertexPredicate>(
+    const GraphReadInterface&, const std::map<std::string, std::string>&)>>
+parse_special_vertex_predicate(const common::Expression& expr) {
+  auto ret = parse_special_vertex_comparison(expr);
+  if (ret.has_value()) {
+    return ret;
+  }
+  return parse_special_vertex_conjunction(expr);
+}
+
 class SPEdgePredicate {
  public:
   virtual ~SPEdgePredicate() {}
@@ -82,6 +82,72 @@ std::vector<LabelTriplet> parse_label_triplets(
   return labels;
 }
 
+void parse_read_labels(const physical::PhysicalPlan& plan, LabelSet& labels) {
+  auto add_tables = [&labels](const algebra::QueryParams& params) {
+    if (params.tables_size() == 0) {
+      labels.add_all();
+    }
+    for (label_t label : parse_tables(params)) {
+      labels.add_vertex_label(label);
+    }
+  };
+  auto add_triplets = [&labels](const physical::PhysicalOpr& opr) {
+    std::vector<LabelTriplet> triplets;
+    if (opr.meta_data_size() > 0) {
+      triplets = parse_label_triplets(opr.meta_data(0));
+    }
+    if (triplets.empty()) {
+      labels.add_all();
+    }
+    for (auto& triplet : triplets) {
+      labels.add_vertex_label(triplet.src_label);
+      labels.add_vertex_label(triplet.dst_label);
+      labels.add_edge_label(triplet.edge_label);
+    }
+  };
+  for (int i = 0; i < plan.plan_size() && !labels.all(); ++i) {
+    const auto& opr = plan.plan(i).opr();
+    switch (opr.op_kind_case()) {
+    case physical::PhysicalOpr_Operator::OpKindCase::kScan:
+      if (opr.scan().scan_opt() != physical::Scan::VERTEX) {
+        labels.add_all();
+      } else {
+        add_tables(opr.scan().params());
+      }
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kVertex:
+      add_tables(opr.vertex().params());
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kEdge:
+    case physical::PhysicalOpr_Operator::OpKindCase::kPath:
+      add_triplets(plan.plan(i));
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kJoin:
+      parse_read_labels(opr.join().left_plan(), labels);
+      parse_read_labels(opr.join().right_plan(), labels);
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kUnion:
+      for (auto& sub_plan : opr.union_().sub_plans()) {
+        parse_read_labels(sub_plan, labels);
+      }
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kIntersect:
+      for (auto& sub_plan : opr.intersect().sub_plans()) {
+        parse_read_labels(sub_plan, labels);
+      }
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kApply:
+      parse_read_labels(opr.apply().sub_plan(), labels);
+      break;
+    case physical::PhysicalOpr_Operator::OpKindCase::kProcedureCall:
+      labels.add_all();
+      break;
+    default:
+      break;
+    }
+  }
+}
+
 template <typename T>
 bool vertex_property_topN_impl(bool asc, size_t limit,
                                const std::shared_ptr<IVertexColumn>& col,
@@ -16,6 +16,7 @@
 #ifndef RUNTIME_UTILS_UTILS_H_
 #define RUNTIME_UTILS_UTILS_H_
 
+#include "flex/engines/graph_db/database/label_set.h"
 #include "flex/engines/graph_db/runtime/common/columns/i_context_column.h"
 #include "flex/engines/graph_db/runtime/common/graph_interface.h"
 #include "flex/engines/graph_db/runtime/common/rt_any.h"
@@ -39,6 +40,11 @@ std::vector<label_t> parse_tables(const algebra::QueryParams& query_params);
 std::vector<LabelTriplet> parse_label_triplets(
     const physical::PhysicalOpr_MetaData& meta);
 
+// Adds the labels the plan reads, all of them where an operator does not
+// name its labels. Properties are read from vertices and edges the plan
+// scanned or expanded to, whose labels are added already.
+void parse_read_labels(const physical::PhysicalPlan& plan, LabelSet& labels);
+
 bool vertex_property_topN(bool asc, size_t limit,
                           const std::shared_ptr<IVertexColumn>& col,
                           const GraphReadInterface& graph,
@@ -60,6 +60,10 @@ class Var {
                  const Any& data, size_t idx, int) const;
   RTAnyType type() const;
   bool is_optional() const { return getter_->is_optional(); }
+  bool filter_path(CompareOp op, const RTAny& val,
+                   std::vector<size_t>& sel) const {
+    return getter_->filter_path(op, val, sel);
+  }
   std::shared_ptr<IContextColumnBuilder> builder() const;
 
  private:
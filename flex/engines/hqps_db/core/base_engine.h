@@ -894,7 +894,11 @@ class BaseEngine {
           }
           new_offsets.emplace_back(active_indices.size());
         }
-        bitset.clear();
+        // Resetting the bits set, instead of clearing the bitset, keeps the
+        // cost of a group proportional to its size rather than to max_vid.
+        for (auto i = y_start; i < y_end; ++i) {
+          bitset.reset_bit(y_vec[i]);
+        }
       }
     }
 
@@ -936,8 +940,18 @@ class BaseEngine {
       }
       return std::make_pair(std::move(active_indices), std::move(new_offsets));
     } else {
-      auto& vertices = head_y.GetVertices();
-      auto& bitset = head_y.GetBitset();
+      // The vids of a group of head_y are marked in a bitmap over all the
+      // vids, reset after the group, as in the intersection of row sets.
+      VID_T max_vid = 0;
+      for (auto vid : head_x.GetVertices()) {
+        max_vid = std::max(max_vid, vid);
+      }
+      for (auto vid : head_y.GetVertices()) {
+        max_vid = std::max(max_vid, vid);
+      }
+      grape::Bitset set;
+      set.init(max_vid + 1);
+      std::vector<VID_T> group_vids;
       for (size_t i = 0; i + 1 < left_repeat_array.size(); ++i) {
         auto left_min = left_repeat_array[i];
         auto left_max = left_repeat_array[i + 1];
@@ -955,23 +969,27 @@ class BaseEngine {
           }
         } else {
           // intersect
-          std::unordered_set<VID_T> set;
+          group_vids.clear();
           for (auto tmp = right_min; tmp < right_max; ++tmp) {
             auto ele = y_iter.GetElement();
             if (ele.first == valid_label_ind) {
-              set.insert(ele.second);
+              set.set_bit(ele.second);
+              group_vids.emplace_back(ele.second);
             }
             ++y_iter;
           }
           for (auto tmp = left_min; tmp < left_max; ++tmp) {
             auto ele = x_iter.GetElement();
-            if (set.find(ele) != set.end()) {
+            if (set.get_bit(ele)) {
               active_indices.emplace_back(ind_x);
             }
             ind_x += 1;
             ++x_iter;
             new_offsets.emplace_back(active_indices.size());
           }
+          for (auto vid : group_vids) {
+            set.reset_bit(vid);
+          }
         }
       }
       return std::make_pair(std::move(active_indices), std::move(new_offsets));
@@ -19,6 +19,7 @@ limitations under the License.
 #include <string>
 #include <tuple>
 
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 #include "flex/engines/hqps_db/core/utils/hqps_utils.h"
 
 #include "flex/engines/hqps_db/structures/multi_edge_set/adj_edge_set.h"
@@ -1321,16 +1322,32 @@ class EdgeExpand {
         state.limit_);
     std::vector<vertex_id_t> vids;
     std::vector<offset_t> offset;
-    offset.reserve(state.cur_vertex_set_.Size() + 1);
-    CHECK(nbr_list_array.size() == state.cur_vertex_set_.Size());
+    size_t src_num = nbr_list_array.size();
+    offset.reserve(src_num + 1);
+    CHECK(src_num == state.cur_vertex_set_.Size());
     // first gather size.
-    offset.emplace_back(vids.size());
-    for (size_t i = 0; i < nbr_list_array.size(); ++i) {
-      auto nbr_list = nbr_list_array.get(i);
-      for (auto nbr : nbr_list) {
-        vids.emplace_back(nbr.neighbor());
+    offset.emplace_back(0);
+    for (size_t i = 0; i < src_num; ++i) {
+      offset.emplace_back(offset.back() + nbr_list_array.get(i).size());
+    }
+    // then copy the neighbors of each range of sources to their slots.
+    vids.resize(offset.back());
+    auto copy_nbrs = [&](size_t begin, size_t end) {
+      auto dst = vids.begin() + offset[begin];
+      for (size_t i = begin; i < end; ++i) {
+        for (auto nbr : nbr_list_array.get(i)) {
+          *dst++ = nbr.neighbor();
+        }
       }
-      offset.emplace_back(vids.size());
+    };
+    auto& pool = runtime::MorselPool::get();
+    if (pool.Enabled(vids.size())) {
+      size_t morsel_num = std::min(pool.MorselNum(vids.size()), src_num);
+      pool.Run(morsel_num, [&](size_t m) {
+        copy_nbrs(src_num * m / morsel_num, src_num * (m + 1) / morsel_num);
+      });
+    } else {
+      copy_nbrs(0, src_num);
     }
 
     vertex_set_t result_set(std::move(vids), state.other_label_);
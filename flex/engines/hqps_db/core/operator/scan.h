@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "grape/utils/bitset.h"
 
+#include "flex/engines/graph_db/runtime/utils/morsel_pool.h"
 #include "flex/engines/hqps_db/structures/multi_vertex_set/general_vertex_set.h"
 #include "flex/engines/hqps_db/structures/multi_vertex_set/row_vertex_set.h"
 #include "flex/engines/hqps_db/structures/multi_vertex_set/two_label_vertex_set.h"
@@ -373,6 +374,40 @@ class Scan {
   static std::vector<vertex_id_t> scan_vertex_with_selector(
       const GRAPH_INTERFACE& graph, const label_id_t& v_label_id,
       const FUNC& func, const std::tuple<SELECTOR...>& selectors) {
+    // if FUNC has filter_null constexpr member, we can use it to filter
+    // vertices
+    constexpr bool filter_null = FilterNull<FUNC>::value;
+    auto vnum = graph.GetVertexNum(v_label_id);
+    auto& pool = runtime::MorselPool::get();
+    size_t morsel_num = pool.Enabled(vnum) ? pool.MorselNum(vnum) : 1;
+    if (morsel_num > 1) {
+      // Each morsel filters a range of vids, and the ranges are concatenated
+      // in order, so that the result is the same as the sequential scan.
+      std::vector<std::vector<vertex_id_t>> local(morsel_num);
+      pool.Run(morsel_num, [&](size_t m) {
+        auto& local_gids = local[m];
+        auto filter =
+            [&](vertex_id_t v,
+                const std::tuple<typename SELECTOR::prop_t...>& real_props) {
+              if (apply_on_tuple(func, real_props)) {
+                local_gids.push_back(v);
+              }
+            };
+        graph.template ScanVerticesInRange(
+            v_label_id, vnum * m / morsel_num, vnum * (m + 1) / morsel_num,
+            selectors, filter, filter_null);
+      });
+      size_t gid_num = 0;
+      for (auto& local_gids : local) {
+        gid_num += local_gids.size();
+      }
+      std::vector<vertex_id_t> gids;
+      gids.reserve(gid_num);
+      for (auto& local_gids : local) {
+        gids.insert(gids.end(), local_gids.begin(), local_gids.end());
+      }
+      return gids;
+    }
     std::vector<vertex_id_t> gids;
     auto filter =
         [&](vertex_id_t v,
@@ -381,13 +416,7 @@ class Scan {
             gids.push_back(v);
           }
         };
-    // if FUNC has filter_null constexpr member, we can use it to filter
-    // vertices
-    if constexpr (FilterNull<FUNC>::value) {
-      graph.template ScanVertices(v_label_id, selectors, filter, true);
-    } else {
-      graph.template ScanVertices(v_label_id, selectors, filter, false);
-    }
+    graph.template ScanVertices(v_label_id, selectors, filter, filter_null);
     return gids;
   }
 
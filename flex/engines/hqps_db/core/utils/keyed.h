@@ -750,6 +750,22 @@ struct KeyedAggT<GI, FlatEdgeSet<VID_T, LabelT, EDATA_T>, AggFunc::COUNT,
   }
 };
 
+// Counting the edges of an AdjEdgeSet reads none of them.
+template <typename GI, typename VID_T, typename LabelT, typename... EDATA_T,
+          int tag_id>
+struct KeyedAggT<GI, AdjEdgeSet<GI, VID_T, LabelT, EDATA_T...>, AggFunc::COUNT,
+                 std::tuple<grape::EmptyType>,
+                 std::integer_sequence<int32_t, tag_id>> {
+  using agg_res_t = Collection<size_t>;
+  using aggregate_res_builder_t = CountBuilder<tag_id>;
+
+  static aggregate_res_builder_t create_agg_builder(
+      const AdjEdgeSet<GI, VID_T, LabelT, EDATA_T...>& set, const GI& graph,
+      std::tuple<PropertySelector<grape::EmptyType>>& selectors) {
+    return CountBuilder<tag_id>();
+  }
+};
+
 template <typename GI, typename VID_T, typename LabelT, int tag_id>
 struct KeyedAggT<GI, CompressedPathSet<VID_T, LabelT>, AggFunc::COUNT,
                  std::tuple<grape::EmptyType>,
@@ -170,10 +170,30 @@ class MutableCSRInterface {
   void ScanVertices(const label_id_t& label_id,
                     const std::tuple<SELECTOR...>& selectors,
                     const FUNC_T& func, bool filter_null = false) const {
-    auto vnum = db_session_.graph().vertex_num(label_id);
+    ScanVerticesInRange(label_id, 0, GetVertexNum(label_id), selectors, func,
+                        filter_null);
+  }
+
+  /**
+   * @brief ScanVerticesInRange is ScanVertices on the vertices [begin, end)
+   * of the label only, so that disjoint ranges can be scanned by different
+   * threads.
+   * @tparam FUNC_T
+   * @tparam SELECTOR
+   * @param label_id
+   * @param begin
+   * @param end
+   * @param selectors
+   * @param func
+   */
+  template <typename FUNC_T, typename... SELECTOR>
+  void ScanVerticesInRange(const label_id_t& label_id, vertex_id_t begin,
+                           vertex_id_t end,
+                           const std::tuple<SELECTOR...>& selectors,
+                           const FUNC_T& func, bool filter_null = false) const {
     std::tuple<typename SELECTOR::prop_t...> t;
     if constexpr (sizeof...(SELECTOR) == 0) {
-      for (size_t v = 0; v != vnum; ++v) {
+      for (size_t v = begin; v != end; ++v) {
         func(v, t);
       }
     } else {
@@ -186,13 +206,21 @@ class MutableCSRInterface {
         }
       }
 
-      for (size_t v = 0; v != vnum; ++v) {
+      for (size_t v = begin; v != end; ++v) {
         get_tuple_from_column_tuple(v, t, columns);
         func(v, t);
       }
     }
   }
 
+  /**
+   * @brief GetVertexNum returns the number of vertices with the given label.
+   * @param label_id
+   */
+  vertex_id_t GetVertexNum(const label_id_t& label_id) const {
+    return db_session_.graph().vertex_num(label_id);
+  }
+
   /**
    * @brief ScanVertices scans all vertices with the given label with give
    * original id.
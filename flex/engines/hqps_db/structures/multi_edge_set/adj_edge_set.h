@@ -16,6 +16,7 @@
 #define ENGINES_HQPS_ENGINE_DS_EDGE_MULTI_EDGE_SET_ADJ_EDGE_SET_H_
 
 #include <array>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -86,7 +87,7 @@ class AdjEdgeSetIter {
   AdjEdgeSetIter(const std::vector<VID_T>& vids,
                  const adj_list_array_t& adj_lists, size_t ind,
                  const std::vector<std::string>& prop_names)
-      : vids_(vids), adj_lists_(adj_lists), ind_(ind) {
+      : vids_(vids), adj_lists_(adj_lists), ind_(ind), prop_names_(prop_names) {
     if (ind_ == vids_.size()) {
       begin_ = adj_list_iter_t();
       end_ = adj_list_iter_t();
@@ -266,6 +267,27 @@ class AdjEdgeSetIter<GI, VID_T, grape::EmptyType> {
   const std::vector<std::string>& prop_names_;
 };
 
+// The neighbors of the adjacency lists, one per edge, as a vertex set whose
+// i-th vertex is the other end of the i-th edge, with the offsets mapping the
+// edges to it. The lists are read directly rather than through the edge
+// iterator, as the edges matter only for their ends here.
+template <typename LabelT, typename VID_T, typename ADJ_LIST_ARRAY_T>
+std::pair<RowVertexSet<LabelT, VID_T, grape::EmptyType>, std::vector<size_t>>
+get_adj_list_neighbors(const ADJ_LIST_ARRAY_T& adj_lists, size_t edge_num,
+                       LabelT label) {
+  std::vector<VID_T> vids;
+  vids.reserve(edge_num);
+  for (size_t i = 0; i < adj_lists.size(); ++i) {
+    for (auto edge : adj_lists.get(i)) {
+      vids.emplace_back(edge.neighbor());
+    }
+  }
+  std::vector<offset_t> offsets(vids.size() + 1);
+  std::iota(offsets.begin(), offsets.end(), 0);
+  auto set = make_default_row_vertex_set(std::move(vids), label);
+  return std::make_pair(std::move(set), std::move(offsets));
+}
+
 template <typename GI, typename VID_T, typename LabelT, typename... EDATA_T>
 class AdjEdgeSet {
  public:
@@ -330,17 +352,8 @@ class AdjEdgeSet {
     } else if (dir_ == Direction::Out) {
       CHECK(v_opt == VOpt::End || v_opt == VOpt::Other);
     }
-    std::vector<offset_t> offsets;
-    std::vector<VID_T> vids;
-    offsets.reserve(Size());
-    vids.reserve(Size());
-    offsets.emplace_back(0);
-    for (auto iter : *this) {
-      vids.emplace_back(iter.GetDst());
-      offsets.emplace_back(vids.size());
-    }
-    auto set = make_default_row_vertex_set(std::move(vids), dst_label_);
-    return std::make_pair(std::move(set), std::move(offsets));
+    return get_adj_list_neighbors<LabelT, VID_T>(adj_lists_, Size(),
+                                                 dst_label_);
   }
 
   template <size_t col_ind, typename... index_ele_tuple_t_>
@@ -362,18 +375,21 @@ class AdjEdgeSet {
                   {prop_names_}, std::move(label_vec));
   }
 
+  // The properties are read from the adjacency lists only now, as the set
+  // holds no copy of them. Element i fills repeat_array[i] tuples.
   template <typename... PropT>
   void fillBuiltinProps(std::vector<std::tuple<PropT...>>& tuples,
                         PropNameArray<PropT...>& prop_names,
                         std::vector<offset_t>& repeat_array) {
-    LOG(WARNING) << "No implemented";
+    CHECK(repeat_array.size() == Size());
+    fillBuiltinPropsImpl<0>(tuples, prop_names[0], &repeat_array);
   }
 
   // fill builtin props without repeat array.
   template <typename... PropT>
   void fillBuiltinProps(std::vector<std::tuple<PropT...>>& tuples,
                         PropNameArray<PropT...>& prop_names) {
-    LOG(WARNING) << "No implemented";
+    fillBuiltinPropsImpl<0>(tuples, prop_names[0], nullptr);
   }
 
   void Repeat(std::vector<offset_t>& cur_offset,
@@ -384,6 +400,35 @@ class AdjEdgeSet {
   size_t Size() const { return size_; }
 
  private:
+  template <size_t I, typename T>
+  void fillBuiltinPropsImpl(std::vector<T>& tuples,
+                            const std::string& prop_name,
+                            const std::vector<offset_t>* repeat_array) {
+    if constexpr (I < sizeof...(EDATA_T)) {
+      using prop_t = std::tuple_element_t<0, T>;
+      if constexpr (std::is_same_v<std::tuple_element_t<I, data_tuple_t>,
+                                   prop_t>) {
+        if (prop_names_[I] == prop_name) {
+          size_t cur_ind = 0, ele_ind = 0;
+          for (auto iter : *this) {
+            size_t repeat_times =
+                repeat_array == nullptr ? 1 : (*repeat_array)[ele_ind];
+            auto prop = std::get<I>(iter.GetData());
+            for (size_t j = 0; j < repeat_times; ++j) {
+              CHECK(cur_ind < tuples.size());
+              std::get<0>(tuples[cur_ind++]) = prop;
+            }
+            ++ele_ind;
+          }
+          return;
+        }
+      }
+      fillBuiltinPropsImpl<I + 1>(tuples, prop_name, repeat_array);
+    } else {
+      VLOG(10) << "Not found built-in property " << prop_name;
+    }
+  }
+
   size_t size_;
   std::vector<VID_T> vids_;
   LabelT edge_label_, src_label_, dst_label_;
@@ -453,16 +498,8 @@ class AdjEdgeSet<GI, VID_T, LabelT, grape::EmptyType> {
     } else if (dir_ == Direction::Out) {
       CHECK(v_opt == VOpt::End || v_opt == VOpt::Other);
     }
-    std::vector<offset_t> offsets;
-    std::vector<VID_T> vids;
-    offsets.reserve(Size());
-    offsets.emplace_back(0);
-    for (auto iter : *this) {
-      vids.emplace_back(iter.GetDst());
-      offsets.emplace_back(vids.size());
-    }
-    auto set = make_default_row_vertex_set(std::move(vids), dst_label_);
-    return std::make_pair(std::move(set), std::move(offsets));
+    return get_adj_list_neighbors<LabelT, VID_T>(adj_lists_, Size(),
+                                                 dst_label_);
   }
 
   template <size_t col_ind, typename... index_ele_tuple_t_>
@@ -15,11 +15,14 @@
 #ifndef ENGINES_HQPS_DS_MULTI_VERTEX_SET_ROW_VERTEX_SET_H_
 #define ENGINES_HQPS_DS_MULTI_VERTEX_SET_ROW_VERTEX_SET_H_
 
+#include <algorithm>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 #include "grape/util.h"
+#include "grape/utils/bitset.h"
 
 // Vertex set in with data in rows.
 namespace gs {
@@ -379,6 +382,51 @@ static std::vector<lid_t> RowSetSubSetImpl(const std::vector<lid_t>& old_vids,
   return new_vids;
 }
 
+// The vids seen so far by a dedup. When the vids are dense in their range, as
+// after a broad expansion, a bitmap over the range replaces the hash set: it
+// takes a bit instead of a few dozen bytes per vid and needs no hashing.
+template <typename lid_t>
+class VidDedupSet {
+ public:
+  // A bitmap is used when it takes at most a word per vid.
+  static constexpr size_t kMaxBitsPerVid = 64;
+
+  explicit VidDedupSet(const std::vector<lid_t>& vids)
+      : min_vid_(0), dense_(false) {
+    if (vids.empty()) {
+      return;
+    }
+    auto minmax = std::minmax_element(vids.begin(), vids.end());
+    min_vid_ = *minmax.first;
+    size_t range = static_cast<size_t>(*minmax.second - min_vid_) + 1;
+    if (range / kMaxBitsPerVid <= vids.size()) {
+      dense_ = true;
+      bitset_.init(range);
+    } else {
+      set_.reserve(vids.size());
+    }
+  }
+
+  // Returns true if vid is seen for the first time.
+  inline bool insert(lid_t vid) {
+    if (dense_) {
+      size_t ind = vid - min_vid_;
+      if (bitset_.get_bit(ind)) {
+        return false;
+      }
+      bitset_.set_bit(ind);
+      return true;
+    }
+    return set_.insert(vid).second;
+  }
+
+ private:
+  lid_t min_vid_;
+  bool dense_;
+  grape::Bitset bitset_;
+  std::unordered_set<lid_t> set_;
+};
+
 template <typename lid_t, typename data_tuple_t>
 std::vector<offset_t> RowSetDedupImpl(
     const std::vector<lid_t>& ori_lids,
@@ -388,13 +436,11 @@ std::vector<offset_t> RowSetDedupImpl(
   VLOG(10) << "lid size" << ori_lids.size();
   offsets.reserve(ori_lids.size());
 
-  // TODO: replace with bitset.
-  std::unordered_map<lid_t, size_t> v2lid;
+  VidDedupSet<lid_t> v2lid(ori_lids);
   size_t cnt = 0;
   for (size_t i = 0; i < ori_lids.size(); ++i) {
     offsets.emplace_back(cnt);
-    auto ret = v2lid.insert({ori_lids[i], i});
-    if (ret.second == true) {
+    if (v2lid.insert(ori_lids[i])) {
       cnt += 1;
       res_lids.emplace_back(ori_lids[i]);
       res_datas.emplace_back(ori_datas[i]);
@@ -414,13 +460,11 @@ std::vector<offset_t> RowSetDedupImpl(const std::vector<lid_t>& ori_lids,
   VLOG(10) << "lid size" << ori_lids.size();
   offsets.reserve(ori_lids.size());
 
-  // TODO: replace with bitset.
-  std::unordered_map<lid_t, size_t> v2lid;
+  VidDedupSet<lid_t> v2lid(ori_lids);
   size_t cnt = 0;
   for (size_t i = 0; i < ori_lids.size(); ++i) {
     offsets.emplace_back(cnt);
-    auto ret = v2lid.insert({ori_lids[i], i});
-    if (ret.second == true) {
+    if (v2lid.insert(ori_lids[i])) {
       cnt += 1;
       res_lids.emplace_back(ori_lids[i]);
     }
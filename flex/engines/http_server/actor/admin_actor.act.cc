@@ -13,12 +13,14 @@
  * limitations under the License.
  */
 
+#include <condition_variable>
 #include <filesystem>
 
 #include "flex/engines/http_server/actor/admin_actor.act.h"
 
 #include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/http_server/async_job_pool.h"
 #include "flex/engines/http_server/codegen_proxy.h"
 #include "flex/engines/http_server/graph_db_service.h"
 #include "flex/engines/http_server/workdir_manipulator.h"
@@ -28,6 +30,8 @@
 #include <rapidjson/pointer.h>
 #include <rapidjson/rapidjson.h>
 #include <seastar/core/print.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/smp.hh>
 
 namespace server {
 
@@ -844,6 +848,7 @@ seastar::future<admin_query_result> admin_actor::start_service(
   // parse query_param.content as json and get graph_name
   auto& content = query_param.content;
   std::string graph_name;
+  bool hot_swap = false;
 
   auto cur_running_graph_res = metadata_store_->GetRunningGraph();
   if (!cur_running_graph_res.ok()) {
@@ -861,6 +866,9 @@ seastar::future<admin_query_result> admin_actor::start_service(
       if (json.HasMember("graph_id")) {
         graph_name = json["graph_id"].GetString();
       }
+      if (json.HasMember("hot_swap")) {
+        hot_swap = json["hot_swap"].GetBool();
+      }
     } else {
       graph_name = cur_running_graph;
       LOG(WARNING)
@@ -876,6 +884,23 @@ seastar::future<admin_query_result> admin_actor::start_service(
                        "Fail to parse json: " + std::string(e.what()))));
   }
 
+  if (hot_swap) {
+    const auto& config = gs::GraphDB::get().config();
+    if (graph_name == cur_running_graph) {
+      return seastar::make_ready_future<admin_query_result>(
+          gs::Result<seastar::sstring>(gs::Status(
+              gs::StatusCode::ILLEGAL_OPERATION,
+              "Hot swap needs a graph other than the running one: " +
+                  graph_name)));
+    }
+    if (config.replication_port > 0 || !config.replication_primary.empty()) {
+      return seastar::make_ready_future<admin_query_result>(
+          gs::Result<seastar::sstring>(
+              gs::Status(gs::StatusCode::ILLEGAL_OPERATION,
+                         "Hot swap is not supported with replication")));
+    }
+  }
+
   auto get_graph_res = metadata_store_->GetGraphMeta(graph_name);
   if (!get_graph_res.ok()) {
     LOG(ERROR) << "Fail to get graph meta: "
@@ -986,6 +1011,10 @@ seastar::future<admin_query_result> admin_actor::start_service(
         gs::Result<seastar::sstring>(data_dir.status()));
   }
   auto data_dir_value = data_dir.value();
+  if (hot_swap) {
+    return hot_swap_service(graph_name, cur_running_graph, schema_value,
+                            data_dir_value, prev_lock);
+  }
 
   // First Stop query_handler's actors.
 
@@ -1005,6 +1034,8 @@ seastar::future<admin_query_result> admin_actor::start_service(
           auto config = db.config();
           config.data_dir = data_dir_value;
           config.schema = schema_value;
+          // Async jobs hold sessions of the graph, stop them first.
+          AsyncJobPool::get().Stop();
           db.Close();
           VLOG(10) << "Closed the previous graph db";
           if (!db.Open(config).ok()) {
@@ -1023,6 +1054,7 @@ seastar::future<admin_query_result> admin_actor::start_service(
           }
           LOG(INFO) << "Successfully load graph from data directory: "
                     << data_dir_value;
+          AsyncJobPool::get().Start();
           // unlock the previous graph
           if (graph_name != cur_running_graph) {
             auto unlock_res =
@@ -1056,6 +1088,131 @@ seastar::future<admin_query_result> admin_actor::start_service(
       });
 }
 
+// Opens the graph while the service keeps running on the current one, and
+// switches the queries to it with the actors running: the queries after the
+// swap run on the new graph, the ones running finish on the current one.
+// The thread which opened the new graph then waits for those and for the
+// reads they left open, e.g. streaming their results, and closes the current
+// graph, off the reactor.
+seastar::future<admin_query_result> admin_actor::hot_swap_service(
+    const std::string& graph_name, const std::string& cur_running_graph,
+    const gs::Schema& schema, const std::string& data_dir, bool prev_lock) {
+  struct Standby {
+    std::unique_ptr<gs::GraphDB> db = std::make_unique<gs::GraphDB>();
+    gs::Status status = gs::Status::OK();
+    std::atomic<bool> done{false};
+    // Handed to the thread once swapped, or with null if not, to be closed.
+    std::unique_ptr<gs::GraphDB> prev;
+    bool swapped = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> closed{false};
+    std::thread thread;
+
+    void hand_over(std::unique_ptr<gs::GraphDB>&& db) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        prev = std::move(db);
+        swapped = true;
+      }
+      cv.notify_one();
+    }
+  };
+  auto standby = std::make_shared<Standby>();
+  auto config = gs::GraphDB::get().config();
+  config.data_dir = data_dir;
+  config.schema = schema;
+  config.standby = true;
+  // Ready once warm, rather than warming up while serving.
+  config.warmup_in_background = false;
+  LOG(INFO) << "Opening graph " << graph_name << " from " << data_dir
+            << " in the background";
+  standby->thread = std::thread([standby, config]() {
+    auto res = standby->db->Open(config);
+    if (!res.ok()) {
+      standby->status = res.status();
+    }
+    standby->done.store(true);
+    std::unique_ptr<gs::GraphDB> prev;
+    {
+      std::unique_lock<std::mutex> lock(standby->mutex);
+      standby->cv.wait(lock, [&] { return standby->swapped; });
+      prev = std::move(standby->prev);
+    }
+    if (prev != nullptr) {
+      prev->WaitForReads();
+      prev->Close();
+      prev.reset();
+      VLOG(10) << "Closed the previous graph db";
+    }
+    standby->closed.store(true);
+  });
+  return seastar::do_until(
+             [standby] { return standby->done.load(); },
+             [] { return seastar::sleep(std::chrono::milliseconds(100)); })
+      .then([this, standby, graph_name, data_dir, prev_lock] {
+        if (!standby->status.ok()) {
+          LOG(ERROR) << "Fail to load graph from data directory: " << data_dir
+                     << ", " << standby->status.error_message();
+          standby->hand_over(nullptr);
+          standby->thread.join();
+          if (!prev_lock) {
+            metadata_store_->UnlockGraphIndices(graph_name);
+          }
+          return seastar::make_ready_future<bool>(false);
+        }
+        {
+          std::lock_guard<std::mutex> lock(mtx_);
+          // Async jobs hold sessions of the graph, stop them first.
+          AsyncJobPool::get().Stop();
+          standby->hand_over(gs::GraphDB::Swap(std::move(standby->db)));
+          AsyncJobPool::get().Start();
+        }
+        GraphDBService::get().reset_start_time();
+        LOG(INFO) << "Swapped service to graph: " << graph_name;
+        // Once each shard ran a task since the swap, the queries it was
+        // running on the previous graph are done, as they run to completion
+        // on its reactor.
+        return seastar::smp::invoke_on_all([] {
+                 gs::GraphDB::get().BindSessionThread(
+                     hiactor::local_shard_id());
+               })
+            .then([] {
+              // Plans of the previous schema its last queries cached.
+              gs::GraphDB::ClearPlanCache();
+              return true;
+            });
+      })
+      .then([this, standby, graph_name, cur_running_graph](bool swapped) {
+        if (!swapped) {
+          return seastar::make_ready_future<admin_query_result>(
+              gs::Result<seastar::sstring>(standby->status));
+        }
+        return seastar::do_until(
+                   [standby] { return standby->closed.load(); },
+                   [] {
+                     return seastar::sleep(std::chrono::milliseconds(100));
+                   })
+            .then([this, standby, graph_name, cur_running_graph] {
+              standby->thread.join();
+              auto unlock_res =
+                  metadata_store_->UnlockGraphIndices(cur_running_graph);
+              if (!unlock_res.ok()) {
+                LOG(ERROR) << "Fail to unlock graph: " << cur_running_graph;
+              }
+              auto set_res = metadata_store_->SetRunningGraph(graph_name);
+              if (!set_res.ok()) {
+                LOG(ERROR) << "Fail to set running graph: " << graph_name;
+                return seastar::make_ready_future<admin_query_result>(
+                    gs::Result<seastar::sstring>(set_res.status()));
+              }
+              return seastar::make_ready_future<admin_query_result>(
+                  gs::Result<seastar::sstring>(
+                      to_message_json("Successfully swapped service")));
+            });
+      });
+}
+
 // Stop service.
 // Actually stop the query_handler's actors.
 // The port is still connectable.
@@ -1201,6 +1358,17 @@ seastar::future<admin_query_result> admin_actor::service_status(
     }
     res.AddMember("start_time", graph_db_service.get_start_time(),
                   res.GetAllocator());
+    if (graph_db_service.is_actors_running()) {
+      rapidjson::Value memory(rapidjson::kObjectType);
+      graph_db_service.memory_usage(memory, res.GetAllocator(), false);
+      res.AddMember("memory_usage", memory, res.GetAllocator());
+      rapidjson::Value warmup(rapidjson::kObjectType);
+      graph_db_service.warmup_progress(warmup, res.GetAllocator());
+      res.AddMember("warmup", warmup, res.GetAllocator());
+      rapidjson::Value replication(rapidjson::kObjectType);
+      graph_db_service.replication_status(replication, res.GetAllocator());
+      res.AddMember("replication", replication, res.GetAllocator());
+    }
   } else {
     LOG(INFO) << "Query service has not been inited!";
     res.AddMember("status", "Query service has not been inited!",
@@ -1210,6 +1378,22 @@ seastar::future<admin_query_result> admin_actor::service_status(
       gs::Result<seastar::sstring>(gs::rapidjson_stringify(res)));
 }
 
+// get the memory usage of the running graph.
+seastar::future<admin_query_result> admin_actor::service_memory_usage(
+    query_param&& query_param) {
+  auto& graph_db_service = GraphDBService::get();
+  if (graph_db_service.get_query_port() == 0 ||
+      !graph_db_service.is_actors_running()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Status(gs::StatusCode::SERVICE_UNAVAILABLE,
+                   "Query service is not running"));
+  }
+  rapidjson::Document res(rapidjson::kObjectType);
+  graph_db_service.memory_usage(res, res.GetAllocator(), true);
+  return seastar::make_ready_future<admin_query_result>(
+      gs::Result<seastar::sstring>(gs::rapidjson_stringify(res)));
+}
+
 // get node status.
 seastar::future<admin_query_result> admin_actor::node_status(
     query_param&& query_param) {
@@ -1299,20 +1483,30 @@ seastar::future<admin_query_result> admin_actor::cancel_job(
     VLOG(10) << "Job status is unknown, try cancelling";
   }
 
-  boost::process::child::child_handle child(job_meta.process_id);
-  std::error_code ec;
-  boost::process::detail::api::terminate(child, ec);
-
-  VLOG(10) << "Killing process: " << job_meta.process_id
-           << ", res: " << ec.message();
-  if (ec.value() != 0) {
-    LOG(ERROR) << "Fail to kill process: " << job_meta.process_id
-               << ", error message: " << ec.message();
-    return seastar::make_ready_future<admin_query_result>(
-        gs::Result<seastar::sstring>(gs::Status(
-            gs::StatusCode::INTERNAL_ERROR,
-            "Fail to kill process: " + std::to_string(job_meta.process_id) +
-                ", error message: " + ec.message())));
+  if (AsyncJobPool::get().Owns(job_meta)) {
+    // An async query runs in this process, which must not be killed.
+    if (!AsyncJobPool::get().Cancel(job_id)) {
+      return seastar::make_ready_future<admin_query_result>(
+          gs::Result<seastar::sstring>(gs::Status(
+              gs::StatusCode::ILLEGAL_OPERATION,
+              "Job already finished: " + std::string(job_id.c_str()))));
+    }
+  } else {
+    boost::process::child::child_handle child(job_meta.process_id);
+    std::error_code ec;
+    boost::process::detail::api::terminate(child, ec);
+
+    VLOG(10) << "Killing process: " << job_meta.process_id
+             << ", res: " << ec.message();
+    if (ec.value() != 0) {
+      LOG(ERROR) << "Fail to kill process: " << job_meta.process_id
+                 << ", error message: " << ec.message();
+      return seastar::make_ready_future<admin_query_result>(
+          gs::Result<seastar::sstring>(gs::Status(
+              gs::StatusCode::INTERNAL_ERROR,
+              "Fail to kill process: " + std::to_string(job_meta.process_id) +
+                  ", error message: " + ec.message())));
+    }
   }
   // Now update job meta to cancelled.
   auto update_job_meta_request = gs::UpdateJobMetaRequest::NewCancel();
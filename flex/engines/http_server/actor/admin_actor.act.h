@@ -54,6 +54,8 @@ class ANNOTATION(actor:impl) admin_actor : public hiactor::actor {
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) service_ready(query_param&& param);
 
+  seastar::future<admin_query_result> ANNOTATION(actor:method) service_memory_usage(query_param&& param);
+
   seastar::future<admin_query_result> ANNOTATION(actor:method) get_procedure_by_procedure_name(procedure_query_param&& param);
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) get_procedures_by_graph_name(query_param&& param);
@@ -81,6 +83,10 @@ class ANNOTATION(actor:impl) admin_actor : public hiactor::actor {
   ACTOR_DO_WORK()
 
  private:
+  seastar::future<admin_query_result> hot_swap_service(
+      const std::string& graph_name, const std::string& cur_running_graph,
+      const gs::Schema& schema, const std::string& data_dir, bool prev_lock);
+
   std::mutex mtx_;
   std::shared_ptr<gs::IGraphMetaStore> metadata_store_;
 };
@@ -15,6 +15,7 @@
 
 #include "flex/engines/http_server/actor/executor.act.h"
 
+#include "flex/engines/graph_db/database/arrow_exporter.h"
 #include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/graph_db/database/graph_db_operations.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
@@ -23,6 +24,8 @@
 
 #include <rapidjson/document.h>
 #include <seastar/core/print.hh>
+#include <map>
+#include <sstream>
 
 namespace server {
 
@@ -39,6 +42,8 @@ executor::executor(hiactor::actor_base* exec_ctx, const hiactor::byte_t* addr)
   auto& graph_db_service = GraphDBService::get();
   // meta_data_ should be thread safe.
   metadata_store_ = graph_db_service.get_metadata_store();
+  // The query actors are restarted on the shards when a graph is opened.
+  gs::GraphDB::get().BindSessionThread(hiactor::local_shard_id());
 }
 
 seastar::future<query_result> executor::run_graph_db_query(
@@ -52,7 +57,86 @@ seastar::future<query_result> executor::run_graph_db_query(
         "Query failed: " + ret.status().error_message());
   }
 
-  auto result = ret.value();
+  const auto& result = ret.value();
+  seastar::sstring content(result.data(), result.size());
+  return seastar::make_ready_future<query_result>(std::move(content));
+}
+
+seastar::future<query_buffer_result> executor::run_graph_db_query_buffer(
+    query_param&& param) {
+  auto ret = gs::GraphDB::get()
+                 .GetSession(hiactor::local_shard_id())
+                 .Eval(param.content);
+  if (!ret.ok()) {
+    LOG(ERROR) << "Eval failed: " << ret.status().error_message();
+    return seastar::make_exception_future<query_buffer_result>(
+        "Query failed: " + ret.status().error_message());
+  }
+
+  // The buffer keeps the vector alive, moving it leaves its data in place.
+  auto result = ret.move_value();
+  auto data = result.data();
+  auto size = result.size();
+  seastar::temporary_buffer<char> content(
+      data, size, seastar::make_object_deleter(std::move(result)));
+  return seastar::make_ready_future<query_buffer_result>(std::move(content));
+}
+
+seastar::future<query_buffer_result> executor::run_hosted_graph_query(
+    hosted_query_param&& param) {
+  std::string graph_id(param.content.first);
+  auto db = gs::GraphDB::get(graph_id);
+  if (db == nullptr) {
+    return seastar::make_exception_future<query_buffer_result>(
+        "Graph " + graph_id + " is not hosted");
+  }
+  auto ret =
+      db->GetSession(hiactor::local_shard_id()).Eval(param.content.second);
+  if (!ret.ok()) {
+    LOG(ERROR) << "Eval on graph " << graph_id
+               << " failed: " << ret.status().error_message();
+    return seastar::make_exception_future<query_buffer_result>(
+        "Query failed: " + ret.status().error_message());
+  }
+
+  auto result = ret.move_value();
+  auto data = result.data();
+  auto size = result.size();
+  seastar::temporary_buffer<char> content(
+      data, size, seastar::make_object_deleter(std::move(result)));
+  return seastar::make_ready_future<query_buffer_result>(std::move(content));
+}
+
+seastar::future<query_stream_result> executor::run_graph_db_query_stream(
+    query_param&& param) {
+  std::unique_ptr<gs::ResultStream> tail;
+  auto ret = gs::GraphDB::get()
+                 .GetSession(hiactor::local_shard_id())
+                 .Eval(param.content, tail);
+  if (!ret.ok()) {
+    LOG(ERROR) << "Eval failed: " << ret.status().error_message();
+    return seastar::make_exception_future<query_stream_result>(
+        "Query failed: " + ret.status().error_message());
+  }
+
+  const auto& result = ret.value();
+  streamed_result content{seastar::sstring(result.data(), result.size()),
+                          std::move(tail)};
+  return seastar::make_ready_future<query_stream_result>(std::move(content));
+}
+
+seastar::future<query_result> executor::run_graph_db_batch_query(
+    query_param&& param) {
+  auto ret = gs::GraphDB::get()
+                 .GetSession(hiactor::local_shard_id())
+                 .EvalBatch(param.content);
+  if (!ret.ok()) {
+    LOG(ERROR) << "Eval batch failed: " << ret.status().error_message();
+    return seastar::make_exception_future<query_result>(
+        "Batch query failed: " + ret.status().error_message());
+  }
+
+  const auto& result = ret.value();
   seastar::sstring content(result.data(), result.size());
   return seastar::make_ready_future<query_result>(std::move(content));
 }
@@ -98,6 +182,26 @@ seastar::future<admin_query_result> executor::create_edge(query_param&& param) {
       gs::Result<seastar::sstring>(result.status()));
 }
 
+seastar::future<admin_query_result> executor::bulk_create_edge(
+    query_param&& param) {
+  rapidjson::Document input_json;
+  if (input_json.Parse(param.content.c_str()).HasParseError()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(gs::Status(
+            gs::StatusCode::INVALID_SCHEMA,
+            "Bad input json : " + std::to_string(input_json.GetParseError()))));
+  }
+  auto result = gs::GraphDBOperations::BulkCreateEdge(
+      gs::GraphDB::get().GetSession(hiactor::local_shard_id()),
+      std::move(input_json));
+  if (result.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(result.value()));
+  }
+  return seastar::make_ready_future<admin_query_result>(
+      gs::Result<seastar::sstring>(result.status()));
+}
+
 seastar::future<admin_query_result> executor::update_vertex(
     query_param&& param) {
   rapidjson::Document input_json;
@@ -176,6 +280,63 @@ seastar::future<admin_query_result> executor::get_edge(
       gs::Result<seastar::sstring>(result.status()));
 }
 
+seastar::future<admin_query_result> executor::export_arrow(
+    graph_management_query_param&& param) {
+  std::unordered_map<std::string, std::string> params;
+  for (auto& [key, value] : param.content) {
+    params[std::string(key)] = std::string(value);
+  }
+  const auto& session =
+      gs::GraphDB::get().GetSession(hiactor::local_shard_id());
+  gs::Result<std::shared_ptr<arrow::Table>> table;
+  if (params.count("query")) {
+    // The other parameters are those of the cypher query.
+    std::map<std::string, std::string> query_params(params.begin(),
+                                                    params.end());
+    query_params.erase("query");
+    table = gs::ArrowExporter::ExportQuery(session, params["query"],
+                                           query_params);
+  } else if (params.count("edge_label")) {
+    table = gs::ArrowExporter::ExportEdges(session, params["src_label"],
+                                           params["dst_label"],
+                                           params["edge_label"]);
+  } else {
+    std::vector<std::string> columns;
+    std::stringstream ss(params["columns"]);
+    std::string column;
+    while (std::getline(ss, column, ',')) {
+      if (!column.empty()) {
+        columns.emplace_back(column);
+      }
+    }
+    table =
+        gs::ArrowExporter::ExportVertices(session, params["label"], columns);
+  }
+  if (!table.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(table.status()));
+  }
+
+  // Serialize straight into the body of the reply, so that the wrapped
+  // columns are copied only once.
+  auto size = gs::ArrowExporter::IpcStreamSize(*table.value());
+  if (!size.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(size.status()));
+  }
+  seastar::sstring content(seastar::sstring::initialized_later(),
+                           size.value());
+  arrow::io::FixedSizeBufferWriter out(std::make_shared<arrow::MutableBuffer>(
+      reinterpret_cast<uint8_t*>(content.data()), content.size()));
+  auto status = gs::ArrowExporter::WriteIpcStream(*table.value(), &out);
+  if (!status.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(status));
+  }
+  return seastar::make_ready_future<admin_query_result>(
+      gs::Result<seastar::sstring>(std::move(content)));
+}
+
 seastar::future<admin_query_result> executor::delete_vertex(
     query_param&& param) {
   return seastar::make_ready_future<admin_query_result>(
@@ -189,4 +350,44 @@ seastar::future<admin_query_result> executor::delete_edge(query_param&& param) {
           gs::StatusCode::UNIMPLEMENTED, "delete_edge is not implemented")));
 }
 
+seastar::future<admin_query_result> executor::create_vertex_property(
+    query_param&& param) {
+  rapidjson::Document input_json;
+  if (input_json.Parse(param.content.c_str()).HasParseError()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(gs::Status(
+            gs::StatusCode::INVALID_SCHEMA,
+            "Bad input json : " + std::to_string(input_json.GetParseError()))));
+  }
+  auto result = gs::GraphDBOperations::AddVertexProperty(
+      gs::GraphDB::get().GetSession(hiactor::local_shard_id()),
+      std::move(input_json));
+  if (result.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(result.value()));
+  }
+  return seastar::make_ready_future<admin_query_result>(
+      gs::Result<seastar::sstring>(result.status()));
+}
+
+seastar::future<admin_query_result> executor::delete_vertex_property(
+    query_param&& param) {
+  rapidjson::Document input_json;
+  if (input_json.Parse(param.content.c_str()).HasParseError()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(gs::Status(
+            gs::StatusCode::INVALID_SCHEMA,
+            "Bad input json : " + std::to_string(input_json.GetParseError()))));
+  }
+  auto result = gs::GraphDBOperations::DropVertexProperty(
+      gs::GraphDB::get().GetSession(hiactor::local_shard_id()),
+      std::move(input_json));
+  if (result.ok()) {
+    return seastar::make_ready_future<admin_query_result>(
+        gs::Result<seastar::sstring>(result.value()));
+  }
+  return seastar::make_ready_future<admin_query_result>(
+      gs::Result<seastar::sstring>(result.status()));
+}
+
 }  // namespace server
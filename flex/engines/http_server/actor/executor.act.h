@@ -31,11 +31,28 @@ class ANNOTATION(actor:impl) executor : public hiactor::actor {
   ~executor() override;
 
   seastar::future<query_result> ANNOTATION(actor:method) run_graph_db_query(query_param&& param);
+
+  // Like run_graph_db_query, but the output is returned in the buffer it was
+  // encoded to, without being copied.
+  seastar::future<query_buffer_result> ANNOTATION(actor:method) run_graph_db_query_buffer(query_param&& param);
+
+  // Like run_graph_db_query_buffer, on a graph hosted beside the running one,
+  // see GraphDB::Host.
+  seastar::future<query_buffer_result> ANNOTATION(actor:method) run_hosted_graph_query(hosted_query_param&& param);
+
+  // Like run_graph_db_query, but the tail of the result may be left to be
+  // produced while the head is sent.
+  seastar::future<query_stream_result> ANNOTATION(actor:method) run_graph_db_query_stream(query_param&& param);
   
+  // Runs a batch of queries back to back, see GraphDBSession::EvalBatch.
+  seastar::future<query_result> ANNOTATION(actor:method) run_graph_db_batch_query(query_param&& param);
+
   seastar::future<admin_query_result> ANNOTATION(actor:method) create_vertex(query_param&& param);
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) create_edge(query_param&& param);
 
+  seastar::future<admin_query_result> ANNOTATION(actor:method) bulk_create_edge(query_param&& param);
+
   seastar::future<admin_query_result> ANNOTATION(actor:method) delete_vertex(query_param&& param);
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) delete_edge(query_param&& param);
@@ -44,10 +61,18 @@ class ANNOTATION(actor:impl) executor : public hiactor::actor {
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) update_edge(query_param&& param);
 
+  // Adds and drops vertex properties online, see
+  // GraphDBSession::AddVertexProperty.
+  seastar::future<admin_query_result> ANNOTATION(actor:method) create_vertex_property(query_param&& param);
+
+  seastar::future<admin_query_result> ANNOTATION(actor:method) delete_vertex_property(query_param&& param);
+
   seastar::future<admin_query_result> ANNOTATION(actor:method) get_vertex(graph_management_query_param&& param);
 
   seastar::future<admin_query_result> ANNOTATION(actor:method) get_edge(graph_management_query_param&& param);
 
+  seastar::future<admin_query_result> ANNOTATION(actor:method) export_arrow(graph_management_query_param&& param);
+
 
   // DECLARE_RUN_QUERIES;
   /// Declare `do_work` func here, no need to implement.
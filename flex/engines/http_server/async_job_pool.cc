@@ -0,0 +1,224 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/engines/http_server/async_job_pool.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <fstream>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/http_server/workdir_manipulator.h"
+#include "flex/utils/service_utils.h"
+
+namespace server {
+
+AsyncJobPool& AsyncJobPool::get() {
+  static AsyncJobPool pool;
+  return pool;
+}
+
+AsyncJobPool::~AsyncJobPool() { Stop(); }
+
+void AsyncJobPool::Init(int first_session_id, int thread_num,
+                        std::shared_ptr<gs::IGraphMetaStore> metadata_store) {
+  first_session_id_ = first_session_id;
+  thread_num_ = thread_num;
+  metadata_store_ = metadata_store;
+}
+
+void AsyncJobPool::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_ || thread_num_ <= 0 || metadata_store_ == nullptr) {
+    return;
+  }
+  auto& db = gs::GraphDB::get();
+  if (db.SessionNum() < first_session_id_ + thread_num_) {
+    LOG(ERROR) << "The running graph has " << db.SessionNum()
+               << " sessions, async jobs need "
+               << first_session_id_ + thread_num_;
+    return;
+  }
+  for (int i = 0; i < thread_num_; ++i) {
+    db.GetSession(first_session_id_ + i).SetQueryTimeout(0);
+  }
+  running_ = true;
+  running_jobs_.assign(thread_num_, gs::JobId());
+  for (int i = 0; i < thread_num_; ++i) {
+    threads_.emplace_back([this, i] { run(i); });
+  }
+  LOG(INFO) << "Started " << thread_num_ << " async job threads";
+}
+
+void AsyncJobPool::Stop() {
+  std::vector<gs::JobId> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+    for (auto& job : queue_) {
+      cancelled.emplace_back(job.id);
+    }
+    queue_.clear();
+    auto& db = gs::GraphDB::get();
+    for (int i = 0; i < thread_num_; ++i) {
+      if (!running_jobs_[i].empty()) {
+        cancelled.emplace_back(running_jobs_[i]);
+        cancelled_.insert(running_jobs_[i]);
+        db.GetSession(first_session_id_ + i).CancelQuery();
+      }
+    }
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  cancelled_.clear();
+  for (auto& job_id : cancelled) {
+    auto res = metadata_store_->UpdateJobMeta(
+        job_id, gs::UpdateJobMetaRequest::NewCancel());
+    if (!res.ok()) {
+      LOG(ERROR) << "Fail to cancel job: " << job_id << ", "
+                 << res.status().error_message();
+    }
+  }
+}
+
+bool AsyncJobPool::is_running() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+gs::Result<gs::JobId> AsyncJobPool::Submit(const std::string& graph_id,
+                                           std::string&& input) {
+  if (!is_running()) {
+    return gs::Result<gs::JobId>(gs::Status(
+        gs::StatusCode::SERVICE_UNAVAILABLE,
+        "Async jobs are not enabled, see http_service.async_job_thread_num"));
+  }
+  static std::atomic<uint64_t> job_seq(0);
+  Job job;
+  job.log_path = WorkDirManipulator::GetLogDir() + "async_query_" + graph_id +
+                 "_" + std::to_string(gs::GetCurrentTimeStamp()) + "_" +
+                 std::to_string(job_seq.fetch_add(1)) + ".log";
+  job.input = std::move(input);
+  auto create_res =
+      metadata_store_->CreateJobMeta(gs::CreateJobMetaRequest::NewRunning(
+          graph_id, getpid(), job.log_path, JOB_TYPE));
+  if (!create_res.ok()) {
+    LOG(ERROR) << "Fail to create job meta for graph: " << graph_id;
+    return create_res;
+  }
+  job.id = create_res.value();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+      queue_.emplace_back(std::move(job));
+      cv_.notify_one();
+      return create_res;
+    }
+  }
+  metadata_store_->UpdateJobMeta(create_res.value(),
+                                 gs::UpdateJobMetaRequest::NewCancel());
+  return gs::Result<gs::JobId>(gs::Status(gs::StatusCode::SERVICE_UNAVAILABLE,
+                                          "Async jobs have been stopped"));
+}
+
+bool AsyncJobPool::Owns(const gs::JobMeta& job_meta) const {
+  return job_meta.type == JOB_TYPE && job_meta.process_id == getpid();
+}
+
+bool AsyncJobPool::Cancel(const gs::JobId& job_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto iter = queue_.begin(); iter != queue_.end(); ++iter) {
+    if (iter->id == job_id) {
+      queue_.erase(iter);
+      return true;
+    }
+  }
+  for (int i = 0; i < thread_num_ && running_; ++i) {
+    if (running_jobs_[i] == job_id) {
+      cancelled_.insert(job_id);
+      gs::GraphDB::get().GetSession(first_session_id_ + i).CancelQuery();
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncJobPool::run(int idx) {
+  gs::GraphDB::get().BindSessionThread(first_session_id_ + idx);
+  auto& session = gs::GraphDB::get().GetSession(first_session_id_ + idx);
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+      if (!running_) {
+        return;
+      }
+      job = std::move(queue_.front());
+      queue_.pop_front();
+      running_jobs_[idx] = job.id;
+    }
+    VLOG(10) << "Running async job: " << job.id;
+    auto result = session.Eval(job.input);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      running_jobs_[idx].clear();
+      // The canceller has marked the job cancelled.
+      if (cancelled_.erase(job.id) > 0) {
+        continue;
+      }
+    }
+    finish(job, result);
+  }
+}
+
+void AsyncJobPool::finish(const Job& job,
+                          const gs::Result<std::vector<char>>& result) {
+  std::ofstream fout(job.log_path, std::ios::binary | std::ios::trunc);
+  if (result.ok()) {
+    const auto& output = result.value();
+    // As for /v1/graph/{graph_id}/query, the output of cypher json and
+    // protobuf queries drops the length prefix put_string adds.
+    size_t offset = 0;
+    uint8_t format = job.input.empty() ? 0 : job.input.back();
+    if (format != static_cast<uint8_t>(
+                      gs::GraphDBSession::InputFormat::kCppEncoder) &&
+        format != static_cast<uint8_t>(
+                      gs::GraphDBSession::InputFormat::kCypherString) &&
+        output.size() >= 4) {
+      offset = 4;
+    }
+    fout.write(output.data() + offset, output.size() - offset);
+  } else {
+    fout << result.status().error_message();
+  }
+  fout.close();
+  auto res = metadata_store_->UpdateJobMeta(
+      job.id, gs::UpdateJobMetaRequest::NewFinished(result.ok() ? 0 : 1));
+  if (!res.ok()) {
+    LOG(ERROR) << "Fail to update job status to finished, job_id: " << job.id;
+  }
+  VLOG(10) << "Finished async job: " << job.id << ", ok: " << result.ok();
+}
+
+}  // namespace server
@@ -0,0 +1,105 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ENGINES_HTTP_SERVER_ASYNC_JOB_POOL_H_
+#define ENGINES_HTTP_SERVER_ASYNC_JOB_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "flex/storages/metadata/graph_meta_store.h"
+#include "flex/utils/result.h"
+
+namespace server {
+
+/**
+ * @brief Runs the queries submitted to /v1/graph/{graph_id}/async_query on
+ * threads of their own, so that long procedures do not hold the shards.
+ *
+ * The i-th thread runs its queries on session first_session_id + i of the
+ * running graph, past the sessions of the shards, with no deadline. Each
+ * query is a job in the metadata store, whose log file gets the output of
+ * the query, or its error, once it finishes; the job is fetched with GET
+ * /v1/job/{job_id} and cancelled with DELETE /v1/job/{job_id} of the admin
+ * service.
+ */
+class AsyncJobPool {
+ public:
+  static constexpr const char* JOB_TYPE = "PROCEDURE";
+
+  static AsyncJobPool& get();
+
+  ~AsyncJobPool();
+
+  void Init(int first_session_id, int thread_num,
+            std::shared_ptr<gs::IGraphMetaStore> metadata_store);
+
+  // Starts the threads on the running graph.
+  void Start();
+
+  // Cancels the queued and running jobs and joins the threads, to be called
+  // before the running graph is closed.
+  void Stop();
+
+  bool is_running() const;
+
+  // Queues a query, encoded as for /v1/graph/{graph_id}/query.
+  gs::Result<gs::JobId> Submit(const std::string& graph_id,
+                               std::string&& input);
+
+  // Whether the job was submitted to the pool of this process.
+  bool Owns(const gs::JobMeta& job_meta) const;
+
+  // Drops the job if queued, or aborts it at its next cancellation check if
+  // running. Returns false if it has finished.
+  bool Cancel(const gs::JobId& job_id);
+
+ private:
+  struct Job {
+    gs::JobId id;
+    std::string log_path;
+    std::string input;
+  };
+
+  AsyncJobPool() = default;
+
+  void run(int idx);
+
+  void finish(const Job& job, const gs::Result<std::vector<char>>& result);
+
+  int first_session_id_ = 0;
+  int thread_num_ = 0;
+  std::shared_ptr<gs::IGraphMetaStore> metadata_store_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool running_ = false;
+  std::deque<Job> queue_;
+  // The job each thread is running, empty if idle.
+  std::vector<gs::JobId> running_jobs_;
+  // The running jobs cancelled, whose results are dropped.
+  std::unordered_set<gs::JobId> cancelled_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace server
+
+#endif  // ENGINES_HTTP_SERVER_ASYNC_JOB_POOL_H_
@@ -16,6 +16,13 @@
 #include "flex/engines/http_server/graph_db_service.h"
 #include "flex/engines/http_server/workdir_manipulator.h"
 
+#include <unistd.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
 namespace server {
 CodegenProxy& CodegenProxy::get() {
   static CodegenProxy instance;
@@ -216,9 +223,25 @@ seastar::future<gs::Result<bool>> CodegenProxy::CallCodegenCmd(
     ofs.close();
     cmd += " --procedure_desc=" + desc_file;
   }
-  LOG(INFO) << "Start call codegen cmd: [" << cmd << "]";
 
-  return hiactor::thread_resource_pool::submit_work([cmd, desc_file] {
+  return hiactor::thread_resource_pool::submit_work([cmd, desc_file,
+                                                     codegen_bin, plan_path,
+                                                     query_name, output_dir,
+                                                     graph_schema_path,
+                                                     engine_config,
+                                                     procedure_desc] {
+    auto cache_key =
+        get_codegen_cache_key(codegen_bin, plan_path, query_name,
+                              graph_schema_path, engine_config, procedure_desc);
+    if (!cache_key.empty() &&
+        load_from_codegen_cache(cache_key, query_name, output_dir)) {
+      if (std::filesystem::exists(desc_file)) {
+        std::filesystem::remove(desc_file);
+      }
+      LOG(INFO) << "Found " << query_name << " in codegen cache: " << cache_key;
+      return gs::Result<bool>(true);
+    }
+    LOG(INFO) << "Start call codegen cmd: [" << cmd << "]";
     //  auto res = std::system(cmd.c_str());
     boost::process::ipstream stdout_pipe;
     boost::process::ipstream stderr_pipe;
@@ -246,10 +269,127 @@ seastar::future<gs::Result<bool>> CodegenProxy::CallCodegenCmd(
     }
 
     LOG(INFO) << "Codegen cmd: [" << cmd << "] success! ";
+    if (!cache_key.empty()) {
+      save_to_codegen_cache(cache_key, query_name, output_dir);
+    }
     return gs::Result<bool>(true);
   });
 }
 
+static std::string get_codegen_cache_dir() {
+  const char* dir = std::getenv("FLEX_CODEGEN_CACHE_DIR");
+  return dir != nullptr ? std::string(dir)
+                        : std::string(CodegenProxy::DEFAULT_CODEGEN_CACHE_DIR);
+}
+
+// The artifacts a codegen run leaves in its output directory.
+static std::vector<std::string> get_codegen_artifacts(
+    const std::string& query_name) {
+  return {"lib" + query_name + ".so", query_name + ".yaml"};
+}
+
+static bool append_file(const std::string& path, std::string& content) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.is_open()) {
+    return false;
+  }
+  content.append(std::istreambuf_iterator<char>(ifs),
+                 std::istreambuf_iterator<char>());
+  content.push_back('\0');
+  return true;
+}
+
+// Identifies the build of the running engine, whose headers and libraries
+// the procedures are compiled against, by the content of its executable.
+static const std::string& get_engine_build_id() {
+  static const std::string build_id = [] {
+    std::string content = FLEX_VERSION;
+    std::error_code ec;
+    auto exe = std::filesystem::read_symlink("/proc/self/exe", ec);
+    if (!ec) {
+      append_file(exe.string(), content);
+    }
+    return std::to_string(std::hash<std::string>()(content));
+  }();
+  return build_id;
+}
+
+std::string CodegenProxy::get_codegen_cache_key(
+    const std::string& codegen_bin, const std::string& plan_path,
+    const std::string& query_name, const std::string& graph_schema_path,
+    const std::string& engine_config, const std::string& description) {
+  std::string content = get_engine_build_id();
+  content.push_back('\0');
+  content += query_name;
+  content.push_back('\0');
+  content += description;
+  content.push_back('\0');
+  for (const auto& path :
+       {codegen_bin, plan_path, graph_schema_path, engine_config}) {
+    if (!append_file(path, content)) {
+      LOG(WARNING) << "Fail to read " << path << ", skip the codegen cache";
+      return "";
+    }
+  }
+  std::stringstream ss;
+  ss << query_name << "_" << std::hex << std::setw(16) << std::setfill('0')
+     << std::hash<std::string>()(content) << "_" << content.size();
+  return ss.str();
+}
+
+bool CodegenProxy::load_from_codegen_cache(const std::string& key,
+                                           const std::string& query_name,
+                                           const std::string& output_dir) {
+  std::filesystem::path entry = get_codegen_cache_dir();
+  entry /= key;
+  auto artifacts = get_codegen_artifacts(query_name);
+  if (!std::filesystem::exists(entry / artifacts[0])) {
+    return false;
+  }
+  std::error_code ec;
+  for (const auto& artifact : artifacts) {
+    if (std::filesystem::exists(entry / artifact)) {
+      std::filesystem::copy_file(
+          entry / artifact, std::filesystem::path(output_dir) / artifact,
+          std::filesystem::copy_options::overwrite_existing, ec);
+      if (ec) {
+        LOG(WARNING) << "Fail to copy " << (entry / artifact)
+                     << " from codegen cache: " << ec.message();
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The artifacts are copied under a temporary name and renamed to the entry,
+// so that a concurrent lookup finds either all of them or none.
+void CodegenProxy::save_to_codegen_cache(const std::string& key,
+                                         const std::string& query_name,
+                                         const std::string& output_dir) {
+  std::filesystem::path entry = get_codegen_cache_dir();
+  entry /= key;
+  std::filesystem::path tmp = entry;
+  auto thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+  tmp += ".tmp." + std::to_string(getpid()) + "." + std::to_string(thread_id);
+  std::error_code ec;
+  std::filesystem::create_directories(tmp, ec);
+  for (const auto& artifact : get_codegen_artifacts(query_name)) {
+    auto src = std::filesystem::path(output_dir) / artifact;
+    if (!ec && std::filesystem::exists(src)) {
+      std::filesystem::copy_file(src, tmp / artifact, ec);
+    }
+  }
+  if (!ec) {
+    std::filesystem::rename(tmp, entry, ec);
+  }
+  if (ec) {
+    // Another run may have added the entry meanwhile.
+    VLOG(10) << "Fail to add " << key << " to codegen cache: " << ec.message();
+    std::filesystem::remove_all(tmp, ec);
+  }
+}
+
 std::string CodegenProxy::get_work_directory(int32_t job_id) {
   std::string work_dir = working_directory_ + "/" + std::to_string(job_id);
   ensure_dir_exists(work_dir);
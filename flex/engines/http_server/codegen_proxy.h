@@ -60,6 +60,10 @@ class CodegenProxy {
  public:
   static CodegenProxy& get();
   static constexpr const char* DEFAULT_CODEGEN_DIR = "/tmp/codegen/";
+  // Where compiled procedures are cached, unless FLEX_CODEGEN_CACHE_DIR is
+  // set.
+  static constexpr const char* DEFAULT_CODEGEN_CACHE_DIR =
+      "/tmp/codegen/cache/";
   CodegenProxy();
 
   ~CodegenProxy();
@@ -83,6 +87,10 @@ class CodegenProxy {
   seastar::future<std::pair<int32_t, std::string>> DoGen(
       const physical::PhysicalPlan& plan);
 
+  // Generates and compiles the procedure, unless the cache holds the
+  // artifacts of a run with the same input, schema, engine config,
+  // description and procedure name, and an engine of the same build, in
+  // which case they are copied to output_dir instead.
   static seastar::future<gs::Result<bool>> CallCodegenCmd(
       const std::string& codegen_bin, const std::string& plan_path,
       const std::string& query_name, const std::string& work_dir,
@@ -90,6 +98,23 @@ class CodegenProxy {
       const std::string& engine_config, const std::string& description = "");
 
  private:
+  // The name of the cache entry of a codegen run, empty if an input cannot
+  // be read.
+  static std::string get_codegen_cache_key(
+      const std::string& codegen_bin, const std::string& plan_path,
+      const std::string& query_name, const std::string& graph_schema_path,
+      const std::string& engine_config, const std::string& description);
+
+  // Copies the artifacts of the cache entry to output_dir, returning false if
+  // there is no such entry.
+  static bool load_from_codegen_cache(const std::string& key,
+                                      const std::string& query_name,
+                                      const std::string& output_dir);
+
+  static void save_to_codegen_cache(const std::string& key,
+                                    const std::string& query_name,
+                                    const std::string& output_dir);
+
   seastar::future<gs::Result<bool>> call_codegen_cmd(
       const physical::PhysicalPlan& plan, const std::string& graph_schema_path);
 
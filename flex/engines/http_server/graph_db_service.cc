@@ -13,8 +13,11 @@
  * limitations under the License.
  */
 #include "flex/engines/http_server/graph_db_service.h"
+#include "flex/engines/graph_db/runtime/utils/cypher_runner_impl.h"
+#include "flex/engines/http_server/async_job_pool.h"
 #include "flex/engines/http_server/options.h"
 #include "flex/engines/http_server/workdir_manipulator.h"
+#include "flex/utils/sampling_profiler.h"
 namespace server {
 
 bool check_port_occupied(uint16_t port) {
@@ -37,6 +40,22 @@ ServiceConfig::ServiceConfig()
       admin_port(DEFAULT_ADMIN_PORT),
       query_port(DEFAULT_QUERY_PORT),
       shard_num(DEFAULT_SHARD_NUM),
+      numa_policy(gs::NumaPolicy::kNone),
+      page_in_policy(gs::PageInPolicy::kDefault),
+      warmup(false),
+      warmup_memory_budget(0),
+      replication_port(0),
+      replication_backlog_size(1ul << 30),
+      snapshot_interval(0),
+      intra_query_thread_num(0),
+      profile_sample_rate(0),
+      sampling_profiler_frequency(0),
+      query_timeout_ms(0),
+      query_memory_budget(0),
+      result_cache_capacity(0),
+      cypher_write_group_size(0),
+      incremental_pagerank_damping_factor(0.85),
+      incremental_pagerank_epsilon(1e-6),
       enable_adhoc_handler(false),
       dpdk_mode(false),
       enable_thread_resource_pool(true),
@@ -50,7 +69,9 @@ ServiceConfig::ServiceConfig()
       verbose_level(DEFAULT_VERBOSE_LEVEL),
       sharding_mode(DEFAULT_SHARDING_MODE),
       admin_svc_max_content_length(DEFAULT_MAX_CONTENT_LENGTH),
-      wal_uri(DEFAULT_WAL_URI) {}
+      wal_uri(DEFAULT_WAL_URI),
+      admission_limits{},
+      async_job_thread_num(0) {}
 
 const std::string GraphDBService::DEFAULT_GRAPH_NAME = "modern_graph";
 const std::string GraphDBService::DEFAULT_INTERACTIVE_HOME = "/opt/flex/";
@@ -96,10 +117,40 @@ void openGraph(const gs::GraphId& graph_id,
                << ", for graph: " << graph_id;
   }
   db.Close();
-  gs::GraphDBConfig config(schema_res.value(), data_dir, "",
-                           service_config.shard_num);
+  // The sessions past those of the shards are for AsyncJobPool.
+  gs::GraphDBConfig config(
+      schema_res.value(), data_dir, "",
+      service_config.shard_num + service_config.async_job_thread_num);
   config.memory_level = service_config.memory_level;
   config.wal_uri = service_config.wal_uri;
+  config.numa_policy = service_config.numa_policy;
+  config.page_in_policy = service_config.page_in_policy;
+  config.page_in_policy_overrides = service_config.page_in_policy_overrides;
+  config.shared_snapshot_dir = service_config.shared_snapshot_dir;
+  // The service takes queries while the graph is warmed up.
+  config.warmup = service_config.warmup;
+  config.warmup_targets = service_config.warmup_targets;
+  config.warmup_memory_budget = service_config.warmup_memory_budget;
+  config.warmup_in_background = true;
+  config.replication_port = service_config.replication_port;
+  config.replication_backlog_size = service_config.replication_backlog_size;
+  config.replication_primary = service_config.replication_primary;
+  config.compaction_policy = service_config.compaction_policy;
+  config.snapshot_interval = service_config.snapshot_interval;
+  config.intra_query_thread_num = service_config.intra_query_thread_num;
+  config.profile_sample_rate = service_config.profile_sample_rate;
+  config.query_timeout_ms = service_config.query_timeout_ms;
+  config.query_memory_budget = service_config.query_memory_budget;
+  config.result_cache_capacity = service_config.result_cache_capacity;
+  config.cypher_write_group_size = service_config.cypher_write_group_size;
+  config.incremental_pagerank_vertex_label =
+      service_config.incremental_pagerank_vertex_label;
+  config.incremental_pagerank_edge_label =
+      service_config.incremental_pagerank_edge_label;
+  config.incremental_pagerank_damping_factor =
+      service_config.incremental_pagerank_damping_factor;
+  config.incremental_pagerank_epsilon =
+      service_config.incremental_pagerank_epsilon;
   if (config.memory_level >= 2) {
     config.enable_auto_compaction = true;
   }
@@ -121,7 +172,7 @@ void GraphDBService::init(const ServiceConfig& config) {
   //  requests.
   query_hdl_ = std::make_unique<graph_db_http_handler>(
       config.query_port, config.shard_num, config.get_cooperative_shard_num(),
-      config.enable_adhoc_handler);
+      config.enable_adhoc_handler, config.admission_limits);
   if (config.start_admin_service) {
     admin_hdl_ = std::make_unique<admin_http_handler>(
         config.admin_port, config.get_exclusive_shard_id(),
@@ -131,6 +182,9 @@ void GraphDBService::init(const ServiceConfig& config) {
   initialized_.store(true);
   service_config_ = config;
   gs::init_cpu_usage_watch();
+  if (config.sampling_profiler_frequency > 0) {
+    gs::SamplingProfiler::get().Start(config.sampling_profiler_frequency);
+  }
   if (config.start_admin_service) {
     metadata_store_ = gs::MetadataStoreFactory::Create(
         config.metadata_store_type_, WorkDirManipulator::GetWorkspace());
@@ -196,6 +250,9 @@ void GraphDBService::init(const ServiceConfig& config) {
       LOG(FATAL) << lock_res.status().error_message();
       return;
     }
+    AsyncJobPool::get().Init(config.shard_num, config.async_job_thread_num,
+                             metadata_store_);
+    AsyncJobPool::get().Start();
   }
 }
 
@@ -250,8 +307,153 @@ gs::Result<seastar::sstring> GraphDBService::service_status() {
     return gs::Result<seastar::sstring>(
         gs::StatusCode::OK, "High QPS service has not been started!", "");
   }
-  return gs::Result<seastar::sstring>(
-      seastar::sstring("High QPS service is running ..."));
+  rapidjson::Document memory(rapidjson::kObjectType);
+  memory_usage(memory, memory.GetAllocator(), false);
+  rapidjson::Document warmup(rapidjson::kObjectType);
+  warmup_progress(warmup, warmup.GetAllocator());
+  rapidjson::Document replication(rapidjson::kObjectType);
+  replication_status(replication, replication.GetAllocator());
+  rapidjson::Document plan_cache(rapidjson::kObjectType);
+  plan_cache_stats(plan_cache, plan_cache.GetAllocator());
+  return gs::Result<seastar::sstring>(seastar::sstring(
+      "High QPS service is running ... memory usage: " +
+      gs::rapidjson_stringify(memory) +
+      ", warmup: " + gs::rapidjson_stringify(warmup) +
+      ", replication: " + gs::rapidjson_stringify(replication) +
+      ", plan cache: " + gs::rapidjson_stringify(plan_cache)));
+}
+
+void GraphDBService::warmup_progress(
+    rapidjson::Value& json,
+    rapidjson::Document::AllocatorType& allocator) const {
+  auto progress = gs::GraphDB::get().GetWarmupProgress();
+  json.AddMember("running", progress.running, allocator);
+  json.AddMember("target_num", static_cast<uint64_t>(progress.target_num),
+                 allocator);
+  json.AddMember("warmed_num", static_cast<uint64_t>(progress.warmed_num),
+                 allocator);
+  json.AddMember("skipped_num", static_cast<uint64_t>(progress.skipped_num),
+                 allocator);
+  json.AddMember("warmed_bytes", static_cast<uint64_t>(progress.warmed_bytes),
+                 allocator);
+  json.AddMember("elapsed", progress.elapsed, allocator);
+}
+
+void GraphDBService::replication_status(
+    rapidjson::Value& json,
+    rapidjson::Document::AllocatorType& allocator) const {
+  auto status = gs::GraphDB::get().GetReplicationStatus();
+  json.AddMember("role", rapidjson::Value(status.role.c_str(), allocator),
+                 allocator);
+  json.AddMember("connection_num",
+                 static_cast<uint64_t>(status.connection_num), allocator);
+  if (status.role == "follower") {
+    json.AddMember("primary_ts", status.primary_ts, allocator);
+    json.AddMember("applied_ts", status.applied_ts, allocator);
+    json.AddMember("lag_seconds", status.lag_seconds, allocator);
+  }
+}
+
+void GraphDBService::plan_cache_stats(
+    rapidjson::Value& json,
+    rapidjson::Document::AllocatorType& allocator) const {
+  auto stats = gs::runtime::CypherRunnerImpl::get().get_plan_cache().stats();
+  json.AddMember("size", static_cast<uint64_t>(stats.size), allocator);
+  json.AddMember("capacity", static_cast<uint64_t>(stats.capacity), allocator);
+  json.AddMember("hit_num", stats.hit_num, allocator);
+  json.AddMember("miss_num", stats.miss_num, allocator);
+  json.AddMember("eviction_num", stats.eviction_num, allocator);
+}
+
+static void add_memory_usage(rapidjson::Value& json, const char* name,
+                             const gs::MemoryUsage& usage,
+                             rapidjson::Document::AllocatorType& allocator) {
+  rapidjson::Value value(rapidjson::kObjectType);
+  value.AddMember("mapped_bytes", static_cast<uint64_t>(usage.mapped_bytes),
+                  allocator);
+  value.AddMember("resident_bytes",
+                  static_cast<uint64_t>(usage.resident_bytes), allocator);
+  json.AddMember(rapidjson::Value(name, allocator), value, allocator);
+}
+
+void GraphDBService::memory_usage(rapidjson::Value& json,
+                                  rapidjson::Document::AllocatorType& allocator,
+                                  bool detailed) const {
+  const auto& graph = gs::GraphDB::get().graph();
+  const auto& schema = graph.schema();
+  gs::MemoryUsage vertex_total, edge_total;
+  rapidjson::Value vertices(rapidjson::kArrayType);
+  for (const auto& label_usage : graph.vertexMemoryUsage()) {
+    gs::MemoryUsage label_total = label_usage.indexer;
+    rapidjson::Value label_json(rapidjson::kObjectType);
+    rapidjson::Value columns(rapidjson::kObjectType);
+    for (const auto& column : label_usage.columns) {
+      label_total += column.second;
+      add_memory_usage(columns, column.first.c_str(), column.second,
+                       allocator);
+    }
+    vertex_total += label_total;
+    if (detailed) {
+      label_json.AddMember(
+          "label",
+          rapidjson::Value(
+              schema.get_vertex_label_name(label_usage.label).c_str(),
+              allocator),
+          allocator);
+      add_memory_usage(label_json, "total", label_total, allocator);
+      add_memory_usage(label_json, "indexer", label_usage.indexer, allocator);
+      label_json.AddMember("properties", columns, allocator);
+      vertices.PushBack(label_json, allocator);
+    }
+  }
+  rapidjson::Value edges(rapidjson::kArrayType);
+  for (const auto& triplet_usage : graph.edgeMemoryUsage()) {
+    gs::MemoryUsage triplet_total = triplet_usage.out_csr;
+    triplet_total += triplet_usage.in_csr;
+    triplet_total += triplet_usage.edge_data;
+    edge_total += triplet_total;
+    if (detailed) {
+      rapidjson::Value triplet_json(rapidjson::kObjectType);
+      triplet_json.AddMember(
+          "src_label",
+          rapidjson::Value(
+              schema.get_vertex_label_name(triplet_usage.src_label).c_str(),
+              allocator),
+          allocator);
+      triplet_json.AddMember(
+          "dst_label",
+          rapidjson::Value(
+              schema.get_vertex_label_name(triplet_usage.dst_label).c_str(),
+              allocator),
+          allocator);
+      triplet_json.AddMember(
+          "edge_label",
+          rapidjson::Value(
+              schema.get_edge_label_name(triplet_usage.edge_label).c_str(),
+              allocator),
+          allocator);
+      add_memory_usage(triplet_json, "total", triplet_total, allocator);
+      add_memory_usage(triplet_json, "out_csr", triplet_usage.out_csr,
+                       allocator);
+      add_memory_usage(triplet_json, "in_csr", triplet_usage.in_csr,
+                       allocator);
+      add_memory_usage(triplet_json, "properties", triplet_usage.edge_data,
+                       allocator);
+      edges.PushBack(triplet_json, allocator);
+    }
+  }
+  auto allocator_total = gs::GraphDB::get().AllocatorMemoryUsage();
+  gs::MemoryUsage total = vertex_total;
+  total += edge_total;
+  total += allocator_total;
+  add_memory_usage(json, "total", total, allocator);
+  add_memory_usage(json, "vertices", vertex_total, allocator);
+  add_memory_usage(json, "edges", edge_total, allocator);
+  add_memory_usage(json, "allocators", allocator_total, allocator);
+  if (detailed) {
+    json.AddMember("vertex_labels", vertices, allocator);
+    json.AddMember("edge_triplets", edges, allocator);
+  }
 }
 
 void GraphDBService::run_and_wait_for_exit() {
@@ -278,6 +480,7 @@ void GraphDBService::run_and_wait_for_exit() {
   if (admin_hdl_) {
     admin_hdl_->stop();
   }
+  AsyncJobPool::get().Stop();
   actor_sys_->terminate();
 }
 
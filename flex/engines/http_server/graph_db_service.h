@@ -62,6 +62,44 @@ struct ServiceConfig {
   uint32_t query_port;
   uint32_t shard_num;
   uint32_t memory_level;
+  gs::NumaPolicy numa_policy;
+  gs::PageInPolicy page_in_policy;
+  std::vector<std::pair<std::string, gs::PageInPolicy>>
+      page_in_policy_overrides;
+  // See gs::GraphDBConfig::shared_snapshot_dir.
+  std::string shared_snapshot_dir;
+  // Whether the graph is warmed up in the background once it is opened, see
+  // gs::GraphDBConfig::warmup_targets.
+  bool warmup;
+  std::vector<gs::WarmupTarget> warmup_targets;
+  size_t warmup_memory_budget;
+  // See gs::GraphDBConfig::replication_port.
+  uint32_t replication_port;
+  size_t replication_backlog_size;
+  std::string replication_primary;
+  // See gs::GraphDBConfig::compaction_policy.
+  gs::CompactionPolicy compaction_policy;
+  // See gs::GraphDBConfig::snapshot_interval.
+  int snapshot_interval;
+  // See gs::GraphDBConfig::intra_query_thread_num.
+  int intra_query_thread_num;
+  // See gs::GraphDBConfig::profile_sample_rate.
+  double profile_sample_rate;
+  // Samples the stacks of the query threads continuously at this frequency,
+  // see gs::SamplingProfiler; 0 to sample only on request.
+  int sampling_profiler_frequency;
+  // See gs::GraphDBConfig::query_timeout_ms and query_memory_budget.
+  int64_t query_timeout_ms;
+  size_t query_memory_budget;
+  // See gs::GraphDBConfig::result_cache_capacity.
+  size_t result_cache_capacity;
+  // See gs::GraphDBConfig::cypher_write_group_size.
+  size_t cypher_write_group_size;
+  // See gs::GraphDBConfig::incremental_pagerank_vertex_label.
+  std::string incremental_pagerank_vertex_label;
+  std::string incremental_pagerank_edge_label;
+  double incremental_pagerank_damping_factor;
+  double incremental_pagerank_epsilon;
   bool enable_adhoc_handler;  // Whether to enable adhoc handler.
   bool dpdk_mode;
   bool enable_thread_resource_pool;
@@ -90,6 +128,11 @@ struct ServiceConfig {
   std::string engine_config_path;       // used for codegen.
   size_t admin_svc_max_content_length;  // max content length for admin service.
   std::string wal_uri;                  // The uri of the wal storage.
+  // See graph_db_http_handler::AdmissionLimits.
+  graph_db_http_handler::AdmissionLimits admission_limits;
+  // The threads of AsyncJobPool, each with a session of the running graph
+  // next to those of the shards. 0 disables async queries.
+  uint32_t async_job_thread_num;
 
   ServiceConfig();
 
@@ -155,6 +198,25 @@ class GraphDBService {
 
   gs::Result<seastar::sstring> service_status();
 
+  // Mapped and resident bytes of the running graph, as a json object with the
+  // totals and, if detailed, the usage of each vertex label and edge triplet.
+  void memory_usage(rapidjson::Value& json,
+                    rapidjson::Document::AllocatorType& allocator,
+                    bool detailed) const;
+
+  // Progress of the warmup of the running graph, as a json object.
+  void warmup_progress(rapidjson::Value& json,
+                       rapidjson::Document::AllocatorType& allocator) const;
+
+  // Role and, on a follower, lag of the running graph, as a json object.
+  void replication_status(rapidjson::Value& json,
+                          rapidjson::Document::AllocatorType& allocator) const;
+
+  // Size, hits, misses and evictions of the cypher plan cache, as a json
+  // object.
+  void plan_cache_stats(rapidjson::Value& json,
+                        rapidjson::Document::AllocatorType& allocator) const;
+
   void run_and_wait_for_exit();
 
   void set_exit_state();
@@ -278,6 +340,211 @@ struct convert<server::ServiceConfig> {
       if (engine_node["wal_uri"]) {
         service_config.wal_uri = engine_node["wal_uri"].as<std::string>();
       }
+      if (engine_node["numa_policy"]) {
+        auto policy_str = engine_node["numa_policy"].as<std::string>();
+        if (!gs::parse_numa_policy(policy_str, service_config.numa_policy)) {
+          LOG(ERROR) << "Unsupported numa policy: " << policy_str;
+          return false;
+        }
+      }
+      if (engine_node["page_in_policy"]) {
+        auto policy_str = engine_node["page_in_policy"].as<std::string>();
+        if (!gs::parse_page_in_policy(policy_str,
+                                      service_config.page_in_policy)) {
+          LOG(ERROR) << "Unsupported page in policy: " << policy_str;
+          return false;
+        }
+      }
+      if (engine_node["shared_snapshot_dir"]) {
+        service_config.shared_snapshot_dir =
+            engine_node["shared_snapshot_dir"].as<std::string>();
+      }
+      auto overrides_node = engine_node["page_in_policy_overrides"];
+      if (overrides_node) {
+        if (!overrides_node.IsSequence()) {
+          LOG(ERROR) << "page_in_policy_overrides should be a sequence";
+          return false;
+        }
+        for (const auto& item : overrides_node) {
+          if (!item["pattern"] || !item["policy"]) {
+            LOG(ERROR) << "page_in_policy_overrides entries should have "
+                          "pattern and policy";
+            return false;
+          }
+          auto policy_str = item["policy"].as<std::string>();
+          gs::PageInPolicy policy;
+          if (!gs::parse_page_in_policy(policy_str, policy)) {
+            LOG(ERROR) << "Unsupported page in policy: " << policy_str;
+            return false;
+          }
+          service_config.page_in_policy_overrides.emplace_back(
+              item["pattern"].as<std::string>(), policy);
+        }
+      }
+      auto warmup_node = engine_node["warmup"];
+      if (warmup_node) {
+        service_config.warmup = true;
+        if (warmup_node["memory_budget"]) {
+          auto budget_str = warmup_node["memory_budget"].as<std::string>();
+          service_config.warmup_memory_budget =
+              gs::human_readable_to_bytes(budget_str);
+          if (service_config.warmup_memory_budget == 0) {
+            LOG(ERROR) << "Invalid warmup memory_budget: " << budget_str;
+            return false;
+          }
+        }
+        auto targets_node = warmup_node["targets"];
+        if (targets_node && !targets_node.IsSequence()) {
+          LOG(ERROR) << "warmup targets should be a sequence";
+          return false;
+        }
+        for (const auto& item : targets_node) {
+          gs::WarmupTarget target;
+          if (item["vertex"]) {
+            target.label = item["vertex"].as<std::string>();
+            if (item["properties"]) {
+              target.properties =
+                  item["properties"].as<std::vector<std::string>>();
+            }
+          } else if (item["edge"] && item["source_vertex"] &&
+                     item["destination_vertex"]) {
+            target.label = item["edge"].as<std::string>();
+            target.src_label = item["source_vertex"].as<std::string>();
+            target.dst_label = item["destination_vertex"].as<std::string>();
+          } else {
+            LOG(ERROR) << "warmup targets should have either vertex, or edge, "
+                          "source_vertex and destination_vertex";
+            return false;
+          }
+          service_config.warmup_targets.emplace_back(std::move(target));
+        }
+      }
+      auto replication_node = engine_node["replication"];
+      if (replication_node) {
+        if (replication_node["port"]) {
+          service_config.replication_port =
+              replication_node["port"].as<uint32_t>();
+        }
+        if (replication_node["backlog_size"]) {
+          auto size_str = replication_node["backlog_size"].as<std::string>();
+          service_config.replication_backlog_size =
+              gs::human_readable_to_bytes(size_str);
+          if (service_config.replication_backlog_size == 0) {
+            LOG(ERROR) << "Invalid replication backlog_size: " << size_str;
+            return false;
+          }
+        }
+        if (replication_node["primary"]) {
+          service_config.replication_primary =
+              replication_node["primary"].as<std::string>();
+        }
+      }
+      auto compaction_node = engine_node["compaction"];
+      if (compaction_node) {
+        auto& policy = service_config.compaction_policy;
+        if (compaction_node["check_interval"]) {
+          policy.check_interval = compaction_node["check_interval"].as<int>();
+        }
+        if (compaction_node["max_qps"]) {
+          policy.max_qps = compaction_node["max_qps"].as<double>();
+        }
+        if (compaction_node["cpu_share"]) {
+          policy.cpu_share = compaction_node["cpu_share"].as<double>();
+        }
+        if (policy.check_interval <= 0 || policy.cpu_share <= 0 ||
+            policy.cpu_share > 1) {
+          LOG(ERROR) << "Invalid compaction check_interval or cpu_share";
+          return false;
+        }
+      }
+      if (engine_node["intra_query_thread_num"]) {
+        service_config.intra_query_thread_num =
+            engine_node["intra_query_thread_num"].as<int>();
+        if (service_config.intra_query_thread_num < 0) {
+          LOG(ERROR) << "Invalid intra_query_thread_num: "
+                     << service_config.intra_query_thread_num;
+          return false;
+        }
+      }
+      if (engine_node["profile_sample_rate"]) {
+        service_config.profile_sample_rate =
+            engine_node["profile_sample_rate"].as<double>();
+        if (service_config.profile_sample_rate < 0 ||
+            service_config.profile_sample_rate > 1) {
+          LOG(ERROR) << "Invalid profile_sample_rate: "
+                     << service_config.profile_sample_rate;
+          return false;
+        }
+      }
+      if (engine_node["sampling_profiler_frequency"]) {
+        service_config.sampling_profiler_frequency =
+            engine_node["sampling_profiler_frequency"].as<int>();
+        if (service_config.sampling_profiler_frequency < 0) {
+          LOG(ERROR) << "Invalid sampling_profiler_frequency: "
+                     << service_config.sampling_profiler_frequency;
+          return false;
+        }
+      }
+      if (engine_node["query_timeout"]) {
+        service_config.query_timeout_ms =
+            engine_node["query_timeout"].as<int64_t>();
+        if (service_config.query_timeout_ms < 0) {
+          LOG(ERROR) << "Invalid query_timeout: "
+                     << service_config.query_timeout_ms;
+          return false;
+        }
+      }
+      if (engine_node["query_memory_budget"]) {
+        service_config.query_memory_budget =
+            engine_node["query_memory_budget"].as<size_t>();
+      }
+      if (engine_node["result_cache_capacity"]) {
+        service_config.result_cache_capacity =
+            engine_node["result_cache_capacity"].as<size_t>();
+      }
+      if (engine_node["cypher_write_group_size"]) {
+        service_config.cypher_write_group_size =
+            engine_node["cypher_write_group_size"].as<size_t>();
+      }
+      auto incremental_pagerank_node = engine_node["incremental_pagerank"];
+      if (incremental_pagerank_node) {
+        if (incremental_pagerank_node["vertex_label"]) {
+          service_config.incremental_pagerank_vertex_label =
+              incremental_pagerank_node["vertex_label"].as<std::string>();
+        }
+        if (incremental_pagerank_node["edge_label"]) {
+          service_config.incremental_pagerank_edge_label =
+              incremental_pagerank_node["edge_label"].as<std::string>();
+        }
+        if (incremental_pagerank_node["damping_factor"]) {
+          service_config.incremental_pagerank_damping_factor =
+              incremental_pagerank_node["damping_factor"].as<double>();
+          if (service_config.incremental_pagerank_damping_factor < 0 ||
+              service_config.incremental_pagerank_damping_factor >= 1) {
+            LOG(ERROR) << "Invalid incremental_pagerank damping_factor: "
+                       << service_config.incremental_pagerank_damping_factor;
+            return false;
+          }
+        }
+        if (incremental_pagerank_node["epsilon"]) {
+          service_config.incremental_pagerank_epsilon =
+              incremental_pagerank_node["epsilon"].as<double>();
+          if (service_config.incremental_pagerank_epsilon <= 0) {
+            LOG(ERROR) << "Invalid incremental_pagerank epsilon: "
+                       << service_config.incremental_pagerank_epsilon;
+            return false;
+          }
+        }
+      }
+      if (engine_node["snapshot_interval"]) {
+        service_config.snapshot_interval =
+            engine_node["snapshot_interval"].as<int>();
+        if (service_config.snapshot_interval < 0) {
+          LOG(ERROR) << "Invalid snapshot_interval: "
+                     << service_config.snapshot_interval;
+          return false;
+        }
+      }
     } else {
       LOG(ERROR) << "Fail to find compute_engine configuration";
       return false;
@@ -318,6 +585,24 @@ struct convert<server::ServiceConfig> {
         LOG(INFO) << "max_content_length: "
                   << service_config.admin_svc_max_content_length;
       }
+      auto admission_node = http_service_node["admission"];
+      if (admission_node) {
+        using RequestClass = graph_db_http_handler::RequestClass;
+        const std::pair<const char*, RequestClass> classes[] = {
+            {"read_queue_depth", RequestClass::kRead},
+            {"write_queue_depth", RequestClass::kWrite},
+            {"background_queue_depth", RequestClass::kBackground}};
+        for (const auto& pair : classes) {
+          if (admission_node[pair.first]) {
+            service_config.admission_limits[static_cast<int>(pair.second)] =
+                admission_node[pair.first].as<uint32_t>();
+          }
+        }
+      }
+      if (http_service_node["async_job_thread_num"]) {
+        service_config.async_job_thread_num =
+            http_service_node["async_job_thread_num"].as<uint32_t>();
+      }
     } else {
       LOG(ERROR) << "Fail to find http_service configuration";
       return false;
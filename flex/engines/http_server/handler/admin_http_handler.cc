@@ -19,11 +19,13 @@
 
 #include <seastar/core/alien.hh>
 #include <seastar/core/print.hh>
+#include <seastar/core/sleep.hh>
 #include <seastar/http/handlers.hh>
 #include "flex/engines/http_server/generated/actor/admin_actor_ref.act.autogen.h"
 #include "flex/engines/http_server/types.h"
 #include "flex/engines/http_server/workdir_manipulator.h"
 #include "flex/third_party/httplib.h"
+#include "flex/utils/sampling_profiler.h"
 
 #include <glog/logging.h>
 #include <rapidjson/document.h>
@@ -509,7 +511,7 @@ class admin_http_service_handler_impl : public seastar::httpd::handler_base {
             std::move(rep), std::string("Unsupported action: ") + action);
       }
     } else {
-      // v1/service/ready or v1/service/status
+      // v1/service/ready, v1/service/memory or v1/service/status
       if (path.find("ready") != seastar::sstring::npos) {
         return admin_actor_refs_[dst_executor]
             .service_ready(query_param{std::move(req->content)})
@@ -519,6 +521,15 @@ class admin_http_service_handler_impl : public seastar::httpd::handler_base {
                   return return_reply_with_result(std::move(rep),
                                                   std::move(fut));
                 });
+      } else if (path.find("memory") != seastar::sstring::npos) {
+        return admin_actor_refs_[dst_executor]
+            .service_memory_usage(query_param{std::move(req->content)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_result(std::move(rep),
+                                                  std::move(fut));
+                });
       } else {
         return admin_actor_refs_[dst_executor]
             .service_status(query_param{std::move(req->content)})
@@ -585,6 +596,75 @@ class admin_http_node_handler_impl : public seastar::httpd::handler_base {
   std::vector<admin_actor_ref> admin_actor_refs_;
 };
 
+// Downloads the samples of gs::SamplingProfiler, as folded stacks or, with
+// format=pprof, as a cpu profile. If the profiler runs continuously, those
+// of the last seconds are returned at once, otherwise it samples at the
+// given frequency for seconds first.
+class admin_http_profile_handler_impl : public seastar::httpd::handler_base {
+ public:
+  static constexpr int kDefaultSeconds = 30;
+  static constexpr int kMaxSeconds = 300;
+  static constexpr int kDefaultFrequency = 99;
+
+  admin_http_profile_handler_impl() = default;
+  ~admin_http_profile_handler_impl() override = default;
+
+  seastar::future<std::unique_ptr<seastar::httpd::reply>> handle(
+      const seastar::sstring& path,
+      std::unique_ptr<seastar::httpd::request> req,
+      std::unique_ptr<seastar::httpd::reply> rep) override {
+    int seconds = kDefaultSeconds;
+    int frequency = kDefaultFrequency;
+    try {
+      auto seconds_str = req->get_query_param("seconds");
+      if (!seconds_str.empty()) {
+        seconds = std::stoi(std::string(seconds_str));
+      }
+      auto frequency_str = req->get_query_param("frequency");
+      if (!frequency_str.empty()) {
+        frequency = std::stoi(std::string(frequency_str));
+      }
+    } catch (const std::exception&) {
+      return new_bad_request_reply(std::move(rep),
+                                   "Invalid seconds or frequency");
+    }
+    if (seconds <= 0 || seconds > kMaxSeconds) {
+      return new_bad_request_reply(
+          std::move(rep),
+          "seconds should be in (0, " + std::to_string(kMaxSeconds) + "]");
+    }
+    auto format = req->get_query_param("format");
+    if (!format.empty() && format != "folded" && format != "pprof") {
+      return new_bad_request_reply(std::move(rep),
+                                   "format should be folded or pprof");
+    }
+    bool pprof = format == "pprof";
+
+    auto& profiler = gs::SamplingProfiler::get();
+    auto sampled = seastar::make_ready_future<>();
+    if (!profiler.running()) {
+      if (!profiler.Start(frequency)) {
+        return new_bad_request_reply(std::move(rep),
+                                     "Failed to start the sampling profiler");
+      }
+      sampled = seastar::sleep(std::chrono::seconds(seconds)).then([] {
+        gs::SamplingProfiler::get().Stop();
+      });
+    }
+    return sampled.then([rep = std::move(rep), seconds, pprof]() mutable {
+      auto& profiler = gs::SamplingProfiler::get();
+      std::string content =
+          pprof ? profiler.Pprof(seconds) : profiler.Folded(seconds);
+      rep->set_status(seastar::httpd::reply::status_type::ok);
+      rep->write_body("bin", seastar::sstring(content.data(), content.size()));
+      rep->set_mime_type(pprof ? "application/octet-stream" : "text/plain");
+      rep->done();
+      return seastar::make_ready_future<
+          std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
+    });
+  }
+};
+
 class admin_http_job_handler_impl : public seastar::httpd::handler_base {
  public:
   admin_http_job_handler_impl(uint32_t group_id, uint32_t shard_concurrency,
@@ -851,6 +931,16 @@ seastar::future<> admin_http_handler::set_routes() {
             new admin_http_service_handler_impl(interactive_admin_group_id,
                                                 shard_admin_concurrency,
                                                 exclusive_shard_id_));
+
+      r.add(seastar::httpd::operation_type::GET,
+            seastar::httpd::url("/v1/service/memory"),
+            new admin_http_service_handler_impl(interactive_admin_group_id,
+                                                shard_admin_concurrency,
+                                                exclusive_shard_id_));
+
+      r.add(seastar::httpd::operation_type::GET,
+            seastar::httpd::url("/v1/service/profile"),
+            new admin_http_profile_handler_impl());
     }
 
     {
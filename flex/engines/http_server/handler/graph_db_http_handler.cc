@@ -14,7 +14,9 @@
  */
 
 #include "flex/engines/http_server/handler/graph_db_http_handler.h"
+#include "flex/engines/graph_db/database/graph_db.h"
 #include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/http_server/async_job_pool.h"
 #include "flex/engines/http_server/executor_group.actg.h"
 #include "flex/engines/http_server/graph_db_service.h"
 #include "flex/engines/http_server/options.h"
@@ -22,62 +24,60 @@
 #include "flex/otel/otel.h"
 
 #include <seastar/core/alien.hh>
+#include <seastar/core/future-util.hh>
 #include <seastar/core/print.hh>
 #include <seastar/core/when_all.hh>
 #include <seastar/http/handlers.hh>
 
+#include <random>
+#include <string_view>
+#include <vector>
+
 #ifdef HAVE_OPENTELEMETRY_CPP
 #include "opentelemetry/context/context.h"
 #include "opentelemetry/trace/span_metadata.h"
 #include "opentelemetry/trace/span_startoptions.h"
 #endif  // HAVE_OPENTELEMETRY_CPP
 
-#define RANDOM_DISPATCHER 1
-// when RANDOM_DISPATCHER is false, the dispatcher will use round-robin
-// algorithm to dispatch the query to different executors
-
-#if RANDOM_DISPATCHER
-#include <random>
-#endif
-
+// Sends each query to the less loaded of two executors picked at random, the
+// power of two choices, by the number of queries the handler has sent to
+// each and not got the reply of yet, so that the queries arriving after a
+// few slow ones go to the other executors instead of queueing behind them.
 class query_dispatcher {
  public:
   query_dispatcher(uint32_t shard_concurrency)
-      :
-#if RANDOM_DISPATCHER
-        rd_(),
+      : rd_(),
         gen_(rd_()),
-        dis_(0, shard_concurrency - 1)
-#else
-        shard_concurrency_(shard_concurrency),
-        executor_idx_(0)
-#endif  // RANDOM_DISPATCHER
-  {
-  }
+        dis_(0, shard_concurrency - 1),
+        pending_(shard_concurrency, 0),
+        shard_id_(hiactor::local_shard_id()) {}
 
   inline int get_executor_idx() {
-#if RANDOM_DISPATCHER
-    return dis_(gen_);
-#else
-    auto idx = executor_idx_;
-    executor_idx_ = (executor_idx_ + 1) % shard_concurrency_;
+    int idx = dis_(gen_);
+    int other = dis_(gen_);
+    if (pending_[other] < pending_[idx]) {
+      idx = other;
+    }
+    ++pending_[idx];
+    server::graph_db_http_handler::queue_depth(shard_id_)++;
     return idx;
-#endif  // RANDOM_DISPATCHER
+  }
+
+  // Called once the reply of a query sent to idx is ready.
+  inline void finish(int idx) {
+    --pending_[idx];
+    server::graph_db_http_handler::queue_depth(shard_id_)--;
   }
 
  private:
-#if RANDOM_DISPATCHER
   std::random_device rd_;
   std::mt19937 gen_;
   std::uniform_int_distribution<> dis_;
-#else
-  int shard_concurrency_;
-  int executor_idx_;
-#endif
+  // Accessed on the shard of the handler only.
+  std::vector<uint32_t> pending_;
+  uint32_t shard_id_;
 };
 
-#undef RANDOM_DISPATCHER
-
 //////////////////////////////////////////////////////////////////////////
 namespace seastar {
 namespace httpd {
@@ -122,6 +122,69 @@ class optional_param_matcher : public matcher {
 
 namespace server {
 
+// Any value asks for a cypher query to be run as by EXPLAIN ANALYZE.
+static constexpr const char* PROFILE_HEADER = "X-Interactive-Profile";
+
+// Writes the head of result, then its tail in chunks, each sent before the
+// next is produced so that a slow client holds back the stream and a chunk
+// at most is buffered.
+static void write_streamed_body(seastar::httpd::reply& rep,
+                                streamed_result&& result) {
+  if (result.tail == nullptr) {
+    rep.write_body("bin", std::move(result.head));
+    return;
+  }
+  std::shared_ptr<gs::ResultStream> tail(std::move(result.tail));
+  rep.write_body(
+      "bin", [head = std::move(result.head),
+              tail](seastar::output_stream<char>&& output) mutable {
+        return seastar::do_with(
+            std::move(output), std::move(head), std::vector<char>(),
+            [tail](seastar::output_stream<char>& out, seastar::sstring& head,
+                   std::vector<char>& chunk) {
+              return out.write(head)
+                  .then([&out, &chunk, tail] {
+                    return seastar::repeat([&out, &chunk, tail] {
+                      chunk.clear();
+                      if (!tail->Next(chunk)) {
+                        return seastar::make_ready_future<
+                            seastar::stop_iteration>(
+                            seastar::stop_iteration::yes);
+                      }
+                      return out.write(chunk.data(), chunk.size())
+                          .then([&out] { return out.flush(); })
+                          .then([] { return seastar::stop_iteration::no; });
+                    });
+                  })
+                  .finally([&out] { return out.close(); });
+            });
+      });
+}
+
+// Results at least this large are handed to the reply without a copy, in a
+// chunked body. Smaller ones are copied, keeping the content length.
+static constexpr size_t ZERO_COPY_RESULT_SIZE = 64 * 1024;
+
+static void write_buffer_body(seastar::httpd::reply& rep,
+                              seastar::temporary_buffer<char>&& result) {
+  if (result.size() < ZERO_COPY_RESULT_SIZE) {
+    rep.write_body("bin", seastar::sstring(result.get(), result.size()));
+    return;
+  }
+  rep.write_body(
+      "bin", [result = std::move(result)](
+                 seastar::output_stream<char>&& output) mutable {
+        return seastar::do_with(
+            std::move(output), std::move(result),
+            [](seastar::output_stream<char>& out,
+               seastar::temporary_buffer<char>& result) {
+              return out.write(std::move(result)).finally([&out] {
+                return out.close();
+              });
+            });
+      });
+}
+
 bool is_running_graph(const seastar::sstring& graph_id) {
   std::string graph_id_str(graph_id.data(), graph_id.size());
   auto running_graph_res =
@@ -134,6 +197,47 @@ bool is_running_graph(const seastar::sstring& graph_id) {
   return running_graph_res.value() == graph_id_str;
 }
 
+// Whether path ends with suffix, as /v1/graph/{graph_id}/<suffix>, whatever
+// the graph id.
+static bool has_path_suffix(const seastar::sstring& path,
+                            std::string_view suffix) {
+  return path.size() >= suffix.size() &&
+         std::string_view(path.data() + path.size() - suffix.size(),
+                          suffix.size()) == suffix;
+}
+
+// The path of the procedure queries, /v1/graph/{graph_id}/query.
+static bool is_query_path(const seastar::sstring& path) {
+  return has_path_suffix(path, "/query");
+}
+
+// The path of the arrow exports, /v1/graph/{graph_id}/arrow.
+static bool is_arrow_path(const seastar::sstring& path) {
+  return has_path_suffix(path, "/arrow");
+}
+
+// Queries, whether of procedures or of single vertices and edges, are reads,
+// bulk loads, exports and schema changes are background work, and the other
+// requests on vertices and edges are writes.
+static graph_db_http_handler::RequestClass request_class_of(
+    const seastar::sstring& path, const seastar::sstring& method) {
+  using RequestClass = graph_db_http_handler::RequestClass;
+  if (is_arrow_path(path) || path.find("bulk_edge") != seastar::sstring::npos ||
+      path.find("vertex_property") != seastar::sstring::npos) {
+    return RequestClass::kBackground;
+  } else if (method == "GET" || path.find("query") != seastar::sstring::npos) {
+    return RequestClass::kRead;
+  }
+  return RequestClass::kWrite;
+}
+
+static seastar::future<std::unique_ptr<seastar::httpd::reply>>
+new_overloaded_reply(std::unique_ptr<seastar::httpd::reply> rep) {
+  return new_reply(std::move(rep),
+                   seastar::httpd::reply::status_type::service_unavailable,
+                   "Too many requests on the shard, try again later");
+}
+
 // We could create a scope_builder to create actors on any shard from the
 // current shard.
 hiactor::scope_builder create_builder(uint32_t exec_shard_id,
@@ -218,25 +322,101 @@ class stored_proc_handler : public StoppableHandler {
       const seastar::sstring& path,
       std::unique_ptr<seastar::httpd::request> req,
       std::unique_ptr<seastar::httpd::reply> rep) override {
+    if (!graph_db_http_handler::admit(StoppableHandler::shard_id(),
+                                      request_class_of(path, req->_method))) {
+      return new_overloaded_reply(std::move(rep));
+    }
     auto dst_executor = dispatcher_.get_executor_idx();
+    return dispatch(path, std::move(req), std::move(rep), dst_executor)
+        .finally([this, dst_executor] { dispatcher_.finish(dst_executor); });
+  }
+
+ private:
+  seastar::future<std::unique_ptr<seastar::httpd::reply>> dispatch(
+      const seastar::sstring& path,
+      std::unique_ptr<seastar::httpd::request> req,
+      std::unique_ptr<seastar::httpd::reply> rep, int dst_executor) {
     // TODO(zhanglei): choose read or write based on the request, after the
     // read/write info is supported in physical plan
+    // Set if the graph is not the running one but hosted beside it, see
+    // GraphDB::Host.
+    std::string hosted_graph_id;
     if (req->param.exists("graph_id") && req->param["graph_id"] != "current") {
       // TODO(zhanglei): get from graph_db.
-      if (!is_running_graph(req->param["graph_id"])) {
-        rep->set_status(
-            seastar::httpd::reply::status_type::internal_server_error);
-        rep->write_body("bin",
-                        seastar::sstring("The querying graph is not running:" +
-                                         req->param["graph_id"]));
-        rep->done();
-        return seastar::make_ready_future<
-            std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
+      const auto& graph_id = req->param["graph_id"];
+      if (!is_running_graph(graph_id)) {
+        if (gs::GraphDB::get(std::string(graph_id)) == nullptr) {
+          rep->set_status(
+              seastar::httpd::reply::status_type::internal_server_error);
+          rep->write_body(
+              "bin", seastar::sstring("The querying graph is not running:" +
+                                      graph_id));
+          rep->done();
+          return seastar::make_ready_future<
+              std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
+        }
+        hosted_graph_id = std::string(graph_id);
       }
     }
+    // Only the queries are served on the hosted graphs.
+    if (!hosted_graph_id.empty() &&
+        (req->_method != "POST" || !is_query_path(path))) {
+      rep->set_status(seastar::httpd::reply::status_type::bad_request);
+      rep->write_body("bin", seastar::sstring("Unsupported request on graph " +
+                                              hosted_graph_id));
+      rep->done();
+      return seastar::make_ready_future<std::unique_ptr<seastar::httpd::reply>>(
+          std::move(rep));
+    }
     auto& method = req->_method;
-    if (method == "POST") {
-      if (path.find("vertex") != seastar::sstring::npos) {
+    if (method == "POST" && hosted_graph_id.empty()) {
+      if (is_arrow_path(path)) {
+        // The body is a cypher query, whose parameters are in the url.
+        req->query_parameters["query"] = std::move(req->content);
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .export_arrow(
+                graph_management_query_param{std::move(req->query_parameters)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_arrow_result(std::move(rep),
+                                                        std::move(fut));
+                });
+      } else if (path.find("batch_query") != seastar::sstring::npos) {
+        // Many small queries in one actor message, see
+        // GraphDBSession::EvalBatch for the encoding.
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .run_graph_db_batch_query(query_param{std::move(req->content)})
+            .then_wrapped([rep = std::move(rep)](
+                              seastar::future<query_result>&& fut) mutable {
+              if (__builtin_expect(fut.failed(), false)) {
+                return catch_exception_and_return_reply(std::move(rep),
+                                                        fut.get_exception());
+              }
+              rep->write_body("bin", std::move(fut.get0().content));
+              rep->done();
+              return seastar::make_ready_future<
+                  std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
+            });
+      } else if (path.find("bulk_edge") != seastar::sstring::npos) {
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .bulk_create_edge(query_param{std::move(req->content)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_result(std::move(rep),
+                                                  std::move(fut));
+                });
+      } else if (path.find("vertex_property") != seastar::sstring::npos) {
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .create_vertex_property(query_param{std::move(req->content)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_result(std::move(rep),
+                                                  std::move(fut));
+                });
+      } else if (path.find("vertex") != seastar::sstring::npos) {
         return get_executors()[StoppableHandler::shard_id()][dst_executor]
             .create_vertex(query_param{std::move(req->content)})
             .then_wrapped(
@@ -256,7 +436,17 @@ class stored_proc_handler : public StoppableHandler {
                 });
       }
     } else if (method == "GET") {
-      if (path.find("vertex") != seastar::sstring::npos) {
+      if (is_arrow_path(path)) {
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .export_arrow(
+                graph_management_query_param{std::move(req->query_parameters)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_arrow_result(std::move(rep),
+                                                        std::move(fut));
+                });
+      } else if (path.find("vertex") != seastar::sstring::npos) {
         return get_executors()[StoppableHandler::shard_id()][dst_executor]
             .get_vertex(
                 graph_management_query_param{std::move(req->query_parameters)})
@@ -278,7 +468,16 @@ class stored_proc_handler : public StoppableHandler {
                 });
       }
     } else if (method == "DELETE") {
-      if (path.find("vertex") != seastar::sstring::npos) {
+      if (path.find("vertex_property") != seastar::sstring::npos) {
+        return get_executors()[StoppableHandler::shard_id()][dst_executor]
+            .delete_vertex_property(query_param{std::move(req->content)})
+            .then_wrapped(
+                [rep = std::move(rep)](
+                    seastar::future<admin_query_result>&& fut) mutable {
+                  return return_reply_with_result(std::move(rep),
+                                                  std::move(fut));
+                });
+      } else if (path.find("vertex") != seastar::sstring::npos) {
         return get_executors()[StoppableHandler::shard_id()][dst_executor]
             .delete_vertex(query_param{std::move(req->content)})
             .then_wrapped(
@@ -341,6 +540,26 @@ class stored_proc_handler : public StoppableHandler {
       return seastar::make_ready_future<std::unique_ptr<seastar::httpd::reply>>(
           std::move(rep));
     }
+    // Cypher queries asked to be profiled return their annotated plans.
+    if (last_byte == static_cast<uint8_t>(
+                         gs::GraphDBSession::InputFormat::kCypherString) &&
+        !req->get_header(PROFILE_HEADER).empty()) {
+      req->content = seastar::sstring("EXPLAIN ANALYZE ") + req->content;
+    }
+    // The plans of the cypher strings are cached by query text, for the
+    // schema of the running graph.
+    if (!hosted_graph_id.empty() &&
+        last_byte == static_cast<uint8_t>(
+                         gs::GraphDBSession::InputFormat::kCypherString)) {
+      rep->set_status(seastar::httpd::reply::status_type::bad_request);
+      rep->write_body("bin",
+                      seastar::sstring("Cypher strings are not supported on "
+                                       "graph " +
+                                       hosted_graph_id));
+      rep->done();
+      return seastar::make_ready_future<std::unique_ptr<seastar::httpd::reply>>(
+          std::move(rep));
+    }
 
 #ifdef HAVE_OPENTELEMETRY_CPP
     auto tracer = otel::get_tracer("hqps_procedure_query_handler");
@@ -355,8 +574,15 @@ class stored_proc_handler : public StoppableHandler {
     auto start_ts = gs::GetCurrentTimeStamp();
 #endif  // HAVE_OPENTELEMETRY_CPP
 
-    return get_executors()[StoppableHandler::shard_id()][dst_executor]
-        .run_graph_db_query(query_param{std::move(req->content)})
+    auto& executor =
+        get_executors()[StoppableHandler::shard_id()][dst_executor];
+    auto query_fut =
+        hosted_graph_id.empty()
+            ? executor.run_graph_db_query_buffer(
+                  query_param{std::move(req->content)})
+            : executor.run_hosted_graph_query(hosted_query_param{
+                  {hosted_graph_id, std::move(req->content)}});
+    return std::move(query_fut)
         .then([last_byte
 #ifdef HAVE_OPENTELEMETRY_CPP
                ,
@@ -368,7 +594,7 @@ class stored_proc_handler : public StoppableHandler {
               last_byte ==
                   static_cast<uint8_t>(
                       gs::GraphDBSession::InputFormat::kCypherString)) {
-            return seastar::make_ready_future<query_param>(
+            return seastar::make_ready_future<query_buffer_result>(
                 std::move(output.content));
           } else {
             // For cypher input format, the results are written with
@@ -385,10 +611,12 @@ class stored_proc_handler : public StoppableHandler {
                     "fail" }};
               total_counter_->Add(1, labels);
 #endif  // HAVE_OPENTELEMETRY_CPP
-              return seastar::make_ready_future<query_param>(std::move(output));
+              return seastar::make_ready_future<query_buffer_result>(
+                  std::move(output));
             }
-            return seastar::make_ready_future<query_param>(
-                std::move(output.content.substr(4)));
+            output.content.trim_front(4);
+            return seastar::make_ready_future<query_buffer_result>(
+                std::move(output.content));
           }
         })
         .then_wrapped([rep = std::move(rep)
@@ -396,7 +624,7 @@ class stored_proc_handler : public StoppableHandler {
                            ,
                        this, outer_span, start_ts
 #endif  // HAVE_OPENTELEMETRY_CPP
-    ](seastar::future<query_result>&& fut) mutable {
+    ](seastar::future<query_buffer_result>&& fut) mutable {
           if (__builtin_expect(fut.failed(), false)) {
             try {
               std::rethrow_exception(fut.get_exception());
@@ -426,7 +654,7 @@ class stored_proc_handler : public StoppableHandler {
                 std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
           }
           auto result = fut.get0();
-          rep->write_body("bin", std::move(result.content));
+          write_buffer_body(*rep, std::move(result.content));
 #ifdef HAVE_OPENTELEMETRY_CPP
           outer_span->End();
           std::map<std::string, std::string> labels = {{ "status", "success" }};
@@ -530,7 +758,21 @@ class adhoc_runtime_query_handler : public StoppableHandler {
       const seastar::sstring& path,
       std::unique_ptr<seastar::httpd::request> req,
       std::unique_ptr<seastar::httpd::reply> rep) override {
+    if (!graph_db_http_handler::admit(
+            StoppableHandler::shard_id(),
+            graph_db_http_handler::RequestClass::kRead)) {
+      return new_overloaded_reply(std::move(rep));
+    }
     auto dst_executor = dispatcher_.get_executor_idx();
+    return dispatch(path, std::move(req), std::move(rep), dst_executor)
+        .finally([this, dst_executor] { dispatcher_.finish(dst_executor); });
+  }
+
+ private:
+  seastar::future<std::unique_ptr<seastar::httpd::reply>> dispatch(
+      const seastar::sstring& path,
+      std::unique_ptr<seastar::httpd::request> req,
+      std::unique_ptr<seastar::httpd::reply> rep, int dst_executor) {
 
     if (path != "/v1/graph/current/adhoc_query" &&
         req->param.exists("graph_id")) {
@@ -574,13 +816,13 @@ class adhoc_runtime_query_handler : public StoppableHandler {
     req->content.append(gs::Schema::ADHOC_READ_PLUGIN_ID_STR, 1);
     req->content.append(gs::GraphDBSession::kCypherProtoAdhocStr, 1);
     return get_executors()[StoppableHandler::shard_id()][dst_executor]
-        .run_graph_db_query(query_param{std::move(req->content)})
+        .run_graph_db_query_stream(query_param{std::move(req->content)})
         .then([
 #ifdef HAVE_OPENTELEMETRY_CPP
                   query_span = query_span, query_scope = std::move(query_scope)
 #endif  // HAVE_OPENTELEMETRY_CPP
     ](auto&& output) {
-          return seastar::make_ready_future<query_param>(
+          return seastar::make_ready_future<query_stream_result>(
               std::move(output.content));
         })
         .then_wrapped([rep = std::move(rep)
@@ -588,7 +830,7 @@ class adhoc_runtime_query_handler : public StoppableHandler {
                            ,
                        this, outer_span, start_ts
 #endif  // HAVE_OPENTELEMETRY_CPP
-    ](seastar::future<query_result>&& fut) mutable {
+    ](seastar::future<query_stream_result>&& fut) mutable {
           if (__builtin_expect(fut.failed(), false)) {
             rep->set_status(
                 seastar::httpd::reply::status_type::internal_server_error);
@@ -609,7 +851,7 @@ class adhoc_runtime_query_handler : public StoppableHandler {
                 std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
           }
           auto result = fut.get0();
-          rep->write_body("bin", std::move(result.content));
+          write_streamed_body(*rep, std::move(result.content));
 #ifdef HAVE_OPENTELEMETRY_CPP
           outer_span->End();
           std::map<std::string, std::string> labels = {{ "status", "success" }};
@@ -724,7 +966,21 @@ class adhoc_query_handler : public StoppableHandler {
       const seastar::sstring& path,
       std::unique_ptr<seastar::httpd::request> req,
       std::unique_ptr<seastar::httpd::reply> rep) override {
+    if (!graph_db_http_handler::admit(
+            StoppableHandler::shard_id(),
+            graph_db_http_handler::RequestClass::kRead)) {
+      return new_overloaded_reply(std::move(rep));
+    }
     auto dst_executor = dispatcher_.get_executor_idx();
+    return dispatch(path, std::move(req), std::move(rep), dst_executor)
+        .finally([this, dst_executor] { dispatcher_.finish(dst_executor); });
+  }
+
+ private:
+  seastar::future<std::unique_ptr<seastar::httpd::reply>> dispatch(
+      const seastar::sstring& path,
+      std::unique_ptr<seastar::httpd::request> req,
+      std::unique_ptr<seastar::httpd::reply> rep, int dst_executor) {
     if (path != "/v1/graph/current/adhoc_query" &&
         req->param.exists("graph_id")) {
       // TODO(zhanglei): get from graph_db.
@@ -904,18 +1160,133 @@ class service_status_handler : public seastar::httpd::handler_base {
               seastar::httpd::reply::status_type::service_unavailable,
               "Service Is Not Ready");
         }
+      } else if (path.find("metrics") != seastar::sstring::npos) {
+        auto metrics = gs::GraphDB::get().PrometheusMetrics() +
+                       graph_db_http_handler::queue_depth_metrics();
+        rep->set_status(seastar::httpd::reply::status_type::ok);
+        rep->write_body("txt", seastar::sstring(metrics));
+        rep->set_mime_type("text/plain; version=0.0.4");
+        rep->done();
+        return seastar::make_ready_future<
+            std::unique_ptr<seastar::httpd::reply>>(std::move(rep));
+      } else if (path.find("queue_depth") != seastar::sstring::npos) {
+        return new_reply(std::move(rep),
+                         seastar::httpd::reply::status_type::ok,
+                         graph_db_http_handler::queue_depth_json());
       }
     }
     return new_bad_request_reply(std::move(rep), "Unsupported action");
   }
 };
 
+////////////////////////////async_query_handler////////////////////////////
+// Queues a query, encoded as for /v1/graph/{graph_id}/query, to AsyncJobPool,
+// returning the id of its job right away instead of the result.
+class async_query_handler : public seastar::httpd::handler_base {
+ public:
+  async_query_handler() {}
+  ~async_query_handler() override = default;
+
+  seastar::future<std::unique_ptr<seastar::httpd::reply>> handle(
+      const seastar::sstring& path,
+      std::unique_ptr<seastar::httpd::request> req,
+      std::unique_ptr<seastar::httpd::reply> rep) override {
+    if (req->content.empty()) {
+      return new_bad_request_reply(std::move(rep), "Empty request content!");
+    }
+    uint8_t last_byte = req->content.back();
+    if (last_byte >
+        static_cast<uint8_t>(gs::GraphDBSession::InputFormat::kCypherString)) {
+      return new_bad_request_reply(std::move(rep),
+                                   "Unsupported request format!");
+    }
+    // The pool runs only along with the admin service and its metadata store.
+    if (!AsyncJobPool::get().is_running()) {
+      return new_reply(std::move(rep),
+                       seastar::httpd::reply::status_type::service_unavailable,
+                       "Async queries are not enabled");
+    }
+    auto running_graph_res =
+        GraphDBService::get().get_metadata_store()->GetRunningGraph();
+    if (!running_graph_res.ok()) {
+      return new_reply(
+          std::move(rep),
+          seastar::httpd::reply::status_type::internal_server_error,
+          running_graph_res.status().error_message());
+    }
+    auto graph_id = running_graph_res.value();
+    if (req->param.exists("graph_id") && req->param["graph_id"] != "current" &&
+        req->param["graph_id"].c_str() != graph_id) {
+      return new_reply(
+          std::move(rep),
+          seastar::httpd::reply::status_type::internal_server_error,
+          "The querying graph is not running:" +
+              std::string(req->param["graph_id"].c_str()));
+    }
+    auto job_id_res = AsyncJobPool::get().Submit(
+        graph_id, std::string(req->content.data(), req->content.size()));
+    if (!job_id_res.ok()) {
+      return new_reply(
+          std::move(rep),
+          status_code_to_http_code(job_id_res.status().error_code()),
+          job_id_res.status().error_message());
+    }
+    return new_reply(std::move(rep), seastar::httpd::reply::status_type::ok,
+                     "{\"job_id\":\"" + job_id_res.value() + "\"}");
+  }
+};
+
 ///////////////////////////graph_db_http_handler/////////////////////////////
 
-graph_db_http_handler::graph_db_http_handler(uint16_t http_port,
-                                             int32_t all_shard_num,
-                                             int32_t query_shard_num,
-                                             bool enable_adhoc_handlers)
+static std::vector<std::atomic<int64_t>>& queue_depths() {
+  static std::vector<std::atomic<int64_t>> depths;
+  return depths;
+}
+
+static graph_db_http_handler::AdmissionLimits& shard_admission_limits() {
+  static graph_db_http_handler::AdmissionLimits limits{};
+  return limits;
+}
+
+std::atomic<int64_t>& graph_db_http_handler::queue_depth(uint32_t shard_id) {
+  return queue_depths()[shard_id];
+}
+
+bool graph_db_http_handler::admit(uint32_t shard_id,
+                                  RequestClass request_class) {
+  auto limit = shard_admission_limits()[static_cast<int>(request_class)];
+  return limit == 0 || queue_depth(shard_id).load() < limit;
+}
+
+std::string graph_db_http_handler::queue_depth_metrics() {
+  std::string metrics =
+      "# HELP interactive_shard_queue_depth The requests dispatched by the "
+      "shard and not replied to yet.\n"
+      "# TYPE interactive_shard_queue_depth gauge\n";
+  auto& depths = queue_depths();
+  for (size_t i = 0; i < depths.size(); ++i) {
+    metrics += "interactive_shard_queue_depth{shard=\"" + std::to_string(i) +
+               "\"} " + std::to_string(depths[i].load()) + "\n";
+  }
+  return metrics;
+}
+
+std::string graph_db_http_handler::queue_depth_json() {
+  std::string json = "{\"queue_depths\": [";
+  auto& depths = queue_depths();
+  for (size_t i = 0; i < depths.size(); ++i) {
+    if (i > 0) {
+      json += ", ";
+    }
+    json += std::to_string(depths[i].load());
+  }
+  json += "]}";
+  return json;
+}
+
+graph_db_http_handler::graph_db_http_handler(
+    uint16_t http_port, int32_t all_shard_num, int32_t query_shard_num,
+    bool enable_adhoc_handlers, const AdmissionLimits& admission_limits)
     : http_port_(http_port),
       all_shard_num_(all_shard_num),
       query_shard_num_(query_shard_num),
@@ -927,6 +1298,13 @@ graph_db_http_handler::graph_db_http_handler(uint16_t http_port,
   adhoc_query_handlers_.resize(all_shard_num_);
   vertex_handlers_.resize(all_shard_num_);
   edge_handlers_.resize(all_shard_num_);
+  arrow_export_handlers_.resize(all_shard_num_);
+  arrow_query_handlers_.resize(all_shard_num_);
+  bulk_edge_handlers_.resize(all_shard_num_);
+  vertex_property_handlers_.resize(all_shard_num_);
+  batch_query_handlers_.resize(all_shard_num_);
+  queue_depths() = std::vector<std::atomic<int64_t>>(all_shard_num_);
+  shard_admission_limits() = admission_limits;
   if (enable_adhoc_handlers_) {
     adhoc_query_handler::get_executors().resize(all_shard_num_);
     adhoc_query_handler::get_codegen_actors().resize(all_shard_num_);
@@ -976,6 +1354,13 @@ seastar::future<> graph_db_http_handler::stop_query_actors(size_t index) {
           futures.push_back(vertex_handlers_[index][i]->stop());
           futures.push_back(edge_handlers_[index][i]->stop());
         }
+        futures.push_back(arrow_export_handlers_[index]->stop());
+        futures.push_back(arrow_query_handlers_[index]->stop());
+        futures.push_back(bulk_edge_handlers_[index]->stop());
+        for (auto handler : vertex_property_handlers_[index]) {
+          futures.push_back(handler->stop());
+        }
+        futures.push_back(batch_query_handlers_[index]->stop());
         return seastar::when_all_succeed(futures.begin(), futures.end());
       })
       .then([this, index] {
@@ -1001,6 +1386,13 @@ void graph_db_http_handler::start_query_actors() {
       vertex_handlers_[i][j]->start();
       edge_handlers_[i][j]->start();
     }
+    arrow_export_handlers_[i]->start();
+    arrow_query_handlers_[i]->start();
+    bulk_edge_handlers_[i]->start();
+    for (auto handler : vertex_property_handlers_[i]) {
+      handler->start();
+    }
+    batch_query_handlers_[i]->start();
     if (enable_adhoc_handlers_.load()) {
       adhoc_query_handlers_[i]->start();
     }
@@ -1110,9 +1502,82 @@ seastar::future<> graph_db_http_handler::set_routes() {
       r.add(match_rule, OPERATIONS[i]);
     }
 
+    // matches /v1/graph/{graph_id}/arrow
+    arrow_export_handlers_[hiactor::local_shard_id()] = new stored_proc_handler(
+        query_shard_num_, ic_query_group_id, max_group_id, group_inc_step,
+        shard_query_concurrency);
+    auto rule_arrow = new seastar::httpd::match_rule(
+        arrow_export_handlers_[hiactor::local_shard_id()]);
+    rule_arrow->add_str("/v1/graph")
+        .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+        .add_str("/arrow");
+    r.add(rule_arrow, seastar::httpd::operation_type::GET);
+
+    // matches POST /v1/graph/{graph_id}/arrow
+    arrow_query_handlers_[hiactor::local_shard_id()] = new stored_proc_handler(
+        query_shard_num_, ic_query_group_id, max_group_id, group_inc_step,
+        shard_query_concurrency);
+    auto rule_arrow_query = new seastar::httpd::match_rule(
+        arrow_query_handlers_[hiactor::local_shard_id()]);
+    rule_arrow_query->add_str("/v1/graph")
+        .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+        .add_str("/arrow");
+    r.add(rule_arrow_query, seastar::httpd::operation_type::POST);
+
+    // matches /v1/graph/{graph_id}/bulk_edge
+    bulk_edge_handlers_[hiactor::local_shard_id()] = new stored_proc_handler(
+        query_shard_num_, ic_query_group_id, max_group_id, group_inc_step,
+        shard_query_concurrency);
+    auto rule_bulk_edge = new seastar::httpd::match_rule(
+        bulk_edge_handlers_[hiactor::local_shard_id()]);
+    rule_bulk_edge->add_str("/v1/graph")
+        .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+        .add_str("/bulk_edge");
+    r.add(rule_bulk_edge, seastar::httpd::operation_type::POST);
+
+    // matches POST and DELETE /v1/graph/{graph_id}/vertex_property
+    const seastar::httpd::operation_type vertex_property_ops[] = {
+        seastar::httpd::operation_type::POST,
+        seastar::httpd::operation_type::DELETE};
+    for (size_t i = 0; i < 2; ++i) {
+      auto& handler = vertex_property_handlers_[hiactor::local_shard_id()][i];
+      handler = new stored_proc_handler(query_shard_num_, ic_query_group_id,
+                                        max_group_id, group_inc_step,
+                                        shard_query_concurrency);
+      auto rule_vertex_property = new seastar::httpd::match_rule(handler);
+      rule_vertex_property->add_str("/v1/graph")
+          .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+          .add_str("/vertex_property");
+      r.add(rule_vertex_property, vertex_property_ops[i]);
+    }
+
+    // matches /v1/graph/{graph_id}/batch_query
+    batch_query_handlers_[hiactor::local_shard_id()] = new stored_proc_handler(
+        query_shard_num_, ic_query_group_id, max_group_id, group_inc_step,
+        shard_query_concurrency);
+    auto rule_batch_query = new seastar::httpd::match_rule(
+        batch_query_handlers_[hiactor::local_shard_id()]);
+    rule_batch_query->add_str("/v1/graph")
+        .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+        .add_str("/batch_query");
+    r.add(rule_batch_query, seastar::httpd::operation_type::POST);
+
+    // matches /v1/graph/{graph_id}/async_query
+    auto rule_async_query =
+        new seastar::httpd::match_rule(new async_query_handler());
+    rule_async_query->add_str("/v1/graph")
+        .add_matcher(new seastar::httpd::optional_param_matcher("graph_id"))
+        .add_str("/async_query");
+    r.add(rule_async_query, seastar::httpd::operation_type::POST);
+
     r.add(seastar::httpd::operation_type::GET,
           seastar::httpd::url("/v1/service/ready"),
           new service_status_handler());
+    r.add(seastar::httpd::operation_type::GET,
+          seastar::httpd::url("/v1/service/queue_depth"),
+          new service_status_handler());
+    r.add(seastar::httpd::operation_type::GET, seastar::httpd::url("/metrics"),
+          new service_status_handler());
 
     return seastar::make_ready_future<>();
   });
@@ -21,6 +21,8 @@
 #include "flex/engines/http_server/generated/actor/executor_ref.act.autogen.h"
 
 #include <array>
+#include <atomic>
+#include <string>
 
 #include <seastar/http/httpd.hh>
 
@@ -112,9 +114,18 @@ class graph_db_http_handler {
       seastar::httpd::operation_type::PUT, seastar::httpd::operation_type::GET,
       seastar::httpd::operation_type::POST,
       seastar::httpd::operation_type::DELETE};
+  // The classes of requests, each admitted up to its own queue depth, so
+  // that reads keep being served while writes and exports are turned away.
+  enum class RequestClass { kRead = 0, kWrite = 1, kBackground = 2 };
+  static constexpr int NUM_REQUEST_CLASS = 3;
+  // For each class, the queue depth of a shard at which its requests are
+  // rejected with 503, 0 for no limit.
+  using AdmissionLimits = std::array<uint32_t, NUM_REQUEST_CLASS>;
+
   graph_db_http_handler(uint16_t http_port, int32_t all_shard_num,
                         int32_t query_shard_num,
-                        bool enable_adhoc_handlers = false);
+                        bool enable_adhoc_handlers = false,
+                        const AdmissionLimits& admission_limits = {});
 
   ~graph_db_http_handler();
 
@@ -131,6 +142,19 @@ class graph_db_http_handler {
 
   void start_query_actors();
 
+  // The number of queries the handlers of a shard have dispatched and not
+  // replied to yet.
+  static std::atomic<int64_t>& queue_depth(uint32_t shard_id);
+
+  // The queue depths of all the shards, as served at /v1/service/queue_depth.
+  static std::string queue_depth_json();
+
+  // The queue depths in the Prometheus text format, as part of /metrics.
+  static std::string queue_depth_metrics();
+
+  // Whether a request of the class is admitted on the shard.
+  static bool admit(uint32_t shard_id, RequestClass request_class);
+
  private:
   seastar::future<> set_routes();
   seastar::future<> stop_query_actors(size_t index);
@@ -151,6 +175,16 @@ class graph_db_http_handler {
   // shard_num * operation time(PUT/GET/POST/DELETE)
   std::vector<std::array<StoppableHandler*, NUM_OPERATION>> vertex_handlers_;
   std::vector<std::array<StoppableHandler*, NUM_OPERATION>> edge_handlers_;
+  // Exports the vertices or edges of a label as an arrow IPC stream
+  std::vector<StoppableHandler*> arrow_export_handlers_;
+  // Exports the result of a cypher query as an arrow IPC stream
+  std::vector<StoppableHandler*> arrow_query_handlers_;
+  // Inserts columnar batches of edges
+  std::vector<StoppableHandler*> bulk_edge_handlers_;
+  // Adds (POST) and drops (DELETE) vertex properties
+  std::vector<std::array<StoppableHandler*, 2>> vertex_property_handlers_;
+  // Runs batches of queries
+  std::vector<StoppableHandler*> batch_query_handlers_;
 };
 
 }  // namespace server
@@ -124,6 +124,27 @@ return_reply_with_result(std::unique_ptr<seastar::httpd::reply> rep,
       std::move(rep));
 }
 
+seastar::future<std::unique_ptr<seastar::httpd::reply>>
+return_reply_with_arrow_result(std::unique_ptr<seastar::httpd::reply> rep,
+                               seastar::future<admin_query_result>&& fut) {
+  if (__builtin_expect(fut.failed(), false)) {
+    return catch_exception_and_return_reply(std::move(rep),
+                                            fut.get_exception());
+  }
+  auto&& result = fut.get0();
+  if (!result.content.ok()) {
+    return return_reply_with_result(
+        std::move(rep),
+        seastar::make_ready_future<admin_query_result>(std::move(result)));
+  }
+  rep->set_status(seastar::httpd::reply::status_type::ok);
+  rep->write_body("bin", std::move(result.content.value()));
+  rep->set_mime_type("application/vnd.apache.arrow.stream");
+  rep->done();
+  return seastar::make_ready_future<std::unique_ptr<seastar::httpd::reply>>(
+      std::move(rep));
+}
+
 std::string trim_slash(const std::string& origin) {
   std::string res = origin;
   if (res.front() == '/') {
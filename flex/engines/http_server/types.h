@@ -20,8 +20,10 @@
 #include <hiactor/net/serializable_queue.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/temporary_buffer.hh>
+#include "flex/utils/app_utils.h"
 #include "flex/utils/service_utils.h"
 
+#include <memory>
 #include <string>
 
 namespace server {
@@ -53,9 +55,21 @@ struct payload {
   BufType content;
 };
 
+// The head of the result of a query and the stream of its tail, if any.
+struct streamed_result {
+  seastar::sstring head;
+  std::unique_ptr<gs::ResultStream> tail;
+};
+
 using query_param = payload<seastar::sstring>;
 using query_result = payload<seastar::sstring>;
+using query_stream_result = payload<streamed_result>;
+// The output of a query in the buffer it was encoded to.
+using query_buffer_result = payload<seastar::temporary_buffer<char>>;
 using admin_query_result = payload<gs::Result<seastar::sstring>>;
+// graph_id, query, for a graph hosted beside the running one.
+using hosted_query_param =
+    payload<std::pair<seastar::sstring, seastar::sstring>>;
 // url_path, query_param
 using graph_management_param =
     payload<std::pair<seastar::sstring, seastar::sstring>>;
@@ -289,6 +289,31 @@ def test_builtin_procedure(interactive_session, neo4j_session, create_modern_gra
         '"4"',
     )
 
+    call_procedure(
+        neo4j_session,
+        create_modern_graph,
+        "wcc",
+        '"person"',
+        '"knows"',
+    )
+
+    call_procedure(
+        neo4j_session,
+        create_modern_graph,
+        "triangle_count",
+        '"person"',
+        '"knows"',
+    )
+
+    call_procedure(
+        neo4j_session,
+        create_modern_graph,
+        "label_propagation",
+        '"person"',
+        '"knows"',
+        "10",
+    )
+
 
 def test_list_jobs(interactive_session, create_vertex_only_modern_graph):
     print("[Test list jobs]")
@@ -138,6 +138,158 @@ const std::vector<PluginMeta>& get_builtin_plugin_metas() {
         {"path", PropertyType::kString});
     builtin_plugins.push_back(shortest_path_among_three);
 
+    // wcc
+    PluginMeta wcc;
+    wcc.id = "wcc";
+    wcc.name = "wcc";
+    wcc.description =
+        "A builtin plugin to calculate weakly connected components";
+    wcc.enable = true;
+    wcc.runnable = true;
+    wcc.type = "cypher";
+    wcc.creation_time = GetCurrentTimeStamp();
+    wcc.update_time = GetCurrentTimeStamp();
+    wcc.params.push_back({"vertex_label", PropertyType::kString, true});
+    wcc.params.push_back({"edge_label", PropertyType::kString, true});
+    wcc.returns.push_back({"vertex_oid", PropertyType::kInt64});
+    wcc.returns.push_back({"component", PropertyType::kInt64});
+    builtin_plugins.push_back(wcc);
+
+    // triangle_count
+    PluginMeta triangle_count;
+    triangle_count.id = "triangle_count";
+    triangle_count.name = "triangle_count";
+    triangle_count.description = "A builtin plugin to count triangles";
+    triangle_count.enable = true;
+    triangle_count.runnable = true;
+    triangle_count.type = "cypher";
+    triangle_count.creation_time = GetCurrentTimeStamp();
+    triangle_count.update_time = GetCurrentTimeStamp();
+    triangle_count.params.push_back(
+        {"vertex_label", PropertyType::kString, true});
+    triangle_count.params.push_back(
+        {"edge_label", PropertyType::kString, true});
+    triangle_count.returns.push_back({"count", PropertyType::kInt64});
+    builtin_plugins.push_back(triangle_count);
+
+    // label_propagation
+    PluginMeta label_propagation;
+    label_propagation.id = "label_propagation";
+    label_propagation.name = "label_propagation";
+    label_propagation.description =
+        "A builtin plugin to detect communities by label propagation";
+    label_propagation.enable = true;
+    label_propagation.runnable = true;
+    label_propagation.type = "cypher";
+    label_propagation.creation_time = GetCurrentTimeStamp();
+    label_propagation.update_time = GetCurrentTimeStamp();
+    label_propagation.params.push_back(
+        {"vertex_label", PropertyType::kString, true});
+    label_propagation.params.push_back(
+        {"edge_label", PropertyType::kString, true});
+    label_propagation.params.push_back(
+        {"max_iterations", PropertyType::kInt32, false});
+    label_propagation.returns.push_back({"vertex_oid", PropertyType::kInt64});
+    label_propagation.returns.push_back({"community", PropertyType::kInt64});
+    builtin_plugins.push_back(label_propagation);
+
+    // incremental_pagerank
+    PluginMeta incremental_pagerank;
+    incremental_pagerank.id = "incremental_pagerank";
+    incremental_pagerank.name = "incremental_pagerank";
+    incremental_pagerank.description =
+        "A builtin plugin to read the pagerank kept fresh under inserts";
+    incremental_pagerank.enable = true;
+    incremental_pagerank.runnable = true;
+    incremental_pagerank.type = "cypher";
+    incremental_pagerank.creation_time = GetCurrentTimeStamp();
+    incremental_pagerank.update_time = GetCurrentTimeStamp();
+    incremental_pagerank.params.push_back(
+        {"result_limit", PropertyType::kInt32, false});
+    incremental_pagerank.returns.push_back(
+        {"vertex_oid", PropertyType::kInt64});
+    incremental_pagerank.returns.push_back(
+        {"pagerank", PropertyType::kDouble});
+    incremental_pagerank.returns.push_back(
+        {"in_degree", PropertyType::kInt64});
+    incremental_pagerank.returns.push_back(
+        {"out_degree", PropertyType::kInt64});
+    builtin_plugins.push_back(incremental_pagerank);
+
+    // vector_search
+    PluginMeta vector_search;
+    vector_search.id = "vector_search";
+    vector_search.name = "vector_search";
+    vector_search.description =
+        "A builtin plugin to find the vertices nearest to an embedding";
+    vector_search.enable = true;
+    vector_search.runnable = true;
+    vector_search.type = "cypher";
+    vector_search.creation_time = GetCurrentTimeStamp();
+    vector_search.update_time = GetCurrentTimeStamp();
+    vector_search.params.push_back({"label_name", PropertyType::kString, true});
+    vector_search.params.push_back(
+        {"property_name", PropertyType::kString, false});
+    vector_search.params.push_back({"embedding", PropertyType::kString, false});
+    vector_search.params.push_back({"k", PropertyType::kInt32, false});
+    vector_search.returns.push_back({"vertex_oid", PropertyType::kInt64});
+    vector_search.returns.push_back({"distance", PropertyType::kDouble});
+    builtin_plugins.push_back(vector_search);
+
+    // neighbor_sampling
+    PluginMeta neighbor_sampling;
+    neighbor_sampling.id = "neighbor_sampling";
+    neighbor_sampling.name = "neighbor_sampling";
+    neighbor_sampling.description =
+        "A builtin plugin to sample the multi-hop neighbors of seed vertices";
+    neighbor_sampling.enable = true;
+    neighbor_sampling.runnable = true;
+    neighbor_sampling.type = "cypher";
+    neighbor_sampling.creation_time = GetCurrentTimeStamp();
+    neighbor_sampling.update_time = GetCurrentTimeStamp();
+    neighbor_sampling.params.push_back(
+        {"label_name", PropertyType::kString, true});
+    neighbor_sampling.params.push_back({"seeds", PropertyType::kString, false});
+    neighbor_sampling.params.push_back(
+        {"fanouts", PropertyType::kString, false});
+    neighbor_sampling.params.push_back(
+        {"direction", PropertyType::kString, false});
+    neighbor_sampling.params.push_back(
+        {"weight_property", PropertyType::kString, false});
+    neighbor_sampling.returns.push_back({"hop", PropertyType::kInt32});
+    neighbor_sampling.returns.push_back(
+        {"src_label_name", PropertyType::kString});
+    neighbor_sampling.returns.push_back({"src_oid", PropertyType::kInt64});
+    neighbor_sampling.returns.push_back(
+        {"dst_label_name", PropertyType::kString});
+    neighbor_sampling.returns.push_back({"dst_oid", PropertyType::kInt64});
+    builtin_plugins.push_back(neighbor_sampling);
+
+    // random_walk
+    PluginMeta random_walk;
+    random_walk.id = "random_walk";
+    random_walk.name = "random_walk";
+    random_walk.description =
+        "A builtin plugin to generate DeepWalk and node2vec random walks";
+    random_walk.enable = true;
+    random_walk.runnable = true;
+    random_walk.type = "cypher";
+    random_walk.creation_time = GetCurrentTimeStamp();
+    random_walk.update_time = GetCurrentTimeStamp();
+    random_walk.params.push_back({"vertex_label", PropertyType::kString, true});
+    random_walk.params.push_back({"edge_label", PropertyType::kString, false});
+    random_walk.params.push_back({"walk_length", PropertyType::kInt32, false});
+    random_walk.params.push_back(
+        {"walks_per_vertex", PropertyType::kInt32, false});
+    random_walk.params.push_back({"p", PropertyType::kDouble, false});
+    random_walk.params.push_back({"q", PropertyType::kDouble, false});
+    random_walk.params.push_back(
+        {"weight_property", PropertyType::kString, false});
+    random_walk.params.push_back({"output_path", PropertyType::kString, false});
+    random_walk.returns.push_back({"walk", PropertyType::kString});
+    random_walk.returns.push_back({"walk_num", PropertyType::kInt64});
+    builtin_plugins.push_back(random_walk);
+
     initialized = true;
   }
   return builtin_plugins;
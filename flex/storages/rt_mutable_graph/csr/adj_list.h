@@ -16,6 +16,13 @@
 #ifndef STORAGES_RT_MUTABLE_GRAPH_CSR_ADJ_LIST_H_
 #define STORAGES_RT_MUTABLE_GRAPH_CSR_ADJ_LIST_H_
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "grape/utils/concurrent_queue.h"
+
 #include "flex/storages/rt_mutable_graph/csr/nbr.h"
 #include "flex/storages/rt_mutable_graph/types.h"
 #include "flex/utils/allocators.h"
@@ -35,17 +42,20 @@ class MutableAdjlist {
   using nbr_t = MutableNbr<EDATA_T>;
   using slice_t = MutableNbrSlice<EDATA_T>;
   using mut_slice_t = MutableNbrSliceMut<EDATA_T>;
-  MutableAdjlist() : buffer_(NULL), size_(0), capacity_(0) {}
+
+  MutableAdjlist() : buffer_(NULL), size_(0), capacity_(0), written_(0) {}
   MutableAdjlist(const MutableAdjlist& rhs)
-      : buffer_(rhs.buffer_),
+      : buffer_(rhs.buffer_.load(std::memory_order_acquire)),
         size_(rhs.size_.load(std::memory_order_acquire)),
-        capacity_(rhs.capacity_) {}
+        capacity_(rhs.capacity_.load(std::memory_order_acquire)),
+        written_(rhs.written_.load(std::memory_order_acquire)) {}
   ~MutableAdjlist() {}
 
   void init(nbr_t* ptr, int cap, int size) {
     buffer_ = ptr;
     capacity_ = cap;
     size_ = size;
+    written_ = size;
   }
 
   void batch_put_edge(vid_t neighbor, const EDATA_T& data, timestamp_t ts = 0) {
@@ -54,37 +64,40 @@ class MutableAdjlist {
     nbr.neighbor = neighbor;
     nbr.data = data;
     nbr.timestamp.store(ts);
+    ++written_;
   }
 
+  // Appends an edge, concurrently with other writers of the list. A slot is
+  // reserved within the capacity without any lock; only the writer growing
+  // a full list takes lock, which the others wait on before reserving again.
   void put_edge(vid_t neighbor, const EDATA_T& data, timestamp_t ts,
-                Allocator& allocator) {
-    if (size_ == capacity_) {
-      capacity_ += ((capacity_) >> 1);
-      capacity_ = std::max(capacity_, 8);
-      nbr_t* new_buffer =
-          static_cast<nbr_t*>(allocator.allocate(capacity_ * sizeof(nbr_t)));
-      if (size_ > 0) {
-        UninitializedUtils<nbr_t>::copy(new_buffer, buffer_, size_);
-      }
-      buffer_ = new_buffer;
+                Allocator& allocator, grape::SpinLock& lock) {
+    int idx;
+    while (!reserve(idx)) {
+      lock.lock();
+      grow(allocator);
+      lock.unlock();
     }
-    auto& nbr = buffer_[size_.fetch_add(1)];
+    // The buffer is the one the slot was reserved in, as it is not replaced
+    // until the slot is written.
+    auto& nbr = buffer_.load(std::memory_order_acquire)[idx];
     nbr.neighbor = neighbor;
     nbr.data = data;
     nbr.timestamp.store(ts);
+    written_.fetch_add(1, std::memory_order_release);
   }
 
   inline slice_t get_edges() const {
     slice_t ret;
     ret.set_size(size_.load(std::memory_order_acquire));
-    ret.set_begin(buffer_);
+    ret.set_begin(buffer_.load(std::memory_order_acquire));
     return ret;
   }
 
   inline mut_slice_t get_edges_mut() {
     mut_slice_t ret;
     ret.set_size(size_.load());
-    ret.set_begin(buffer_);
+    ret.set_begin(buffer_.load());
     return ret;
   }
 
@@ -94,9 +107,59 @@ class MutableAdjlist {
   nbr_t* data() { return buffer_; }
 
  private:
-  nbr_t* buffer_;
+  // Takes the next slot if the list is not full. size_ never exceeds
+  // capacity_, so that readers of size_ stay within the buffer; a size_
+  // beyond the capacity of a buffer is only reached after the buffer that
+  // replaced it was published.
+  bool reserve(int& idx) {
+    idx = size_.load(std::memory_order_relaxed);
+    do {
+      if (idx >= capacity_.load(std::memory_order_acquire)) {
+        return false;
+      }
+    } while (!size_.compare_exchange_weak(idx, idx + 1,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+    return true;
+  }
+
+  // Called holding the lock of the list. Replaces the buffer of a full list
+  // by a larger copy once every reserved slot is written, publishing the
+  // buffer before the capacity that lets writers reserve in it. The list of
+  // any degree stays one contiguous buffer, as the slices, the sort and the
+  // binary searches over it and the runtime graph views rely on.
+  void grow(Allocator& allocator) {
+    int old_capacity = capacity_.load(std::memory_order_relaxed);
+    if (size_.load(std::memory_order_acquire) < old_capacity) {
+      return;
+    }
+    while (written_.load(std::memory_order_acquire) < old_capacity) {
+      std::this_thread::yield();
+    }
+    nbr_t* old_buffer = buffer_.load(std::memory_order_relaxed);
+    size_t new_capacity = std::min<size_t>(
+        std::max<size_t>(static_cast<size_t>(old_capacity) +
+                             (old_capacity >> 1),
+                         8),
+        std::numeric_limits<int>::max());
+    // Use up the whole size class so that the buffer can be recycled.
+    size_t new_size = Allocator::size_class(new_capacity * sizeof(nbr_t));
+    nbr_t* new_buffer = static_cast<nbr_t*>(allocator.allocate_sized(new_size));
+    if (old_capacity > 0) {
+      UninitializedUtils<nbr_t>::copy(new_buffer, old_buffer, old_capacity);
+    }
+    buffer_.store(new_buffer, std::memory_order_release);
+    capacity_.store(std::min<size_t>(new_size / sizeof(nbr_t),
+                                     std::numeric_limits<int>::max()),
+                    std::memory_order_release);
+    allocator.retire(old_buffer, old_capacity * sizeof(nbr_t));
+  }
+
+  std::atomic<nbr_t*> buffer_;
+  // The slots reserved, those written and the slots of buffer_.
   std::atomic<int> size_;
-  int capacity_;
+  std::atomic<int> capacity_;
+  std::atomic<int> written_;
 };
 
 }  // namespace gs
@@ -0,0 +1,533 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_CSR_COMPRESSED_CSR_H_
+#define STORAGES_RT_MUTABLE_GRAPH_CSR_COMPRESSED_CSR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "grape/types.h"
+
+#include "flex/storages/rt_mutable_graph/csr/csr_base.h"
+#include "flex/storages/rt_mutable_graph/csr/immutable_csr.h"
+#include "flex/storages/rt_mutable_graph/csr/mutable_csr.h"
+#include "flex/storages/rt_mutable_graph/csr/nbr.h"
+#include "flex/utils/mmap_array.h"
+
+namespace gs {
+
+namespace compressed_csr_impl {
+
+inline size_t varint_size(uint32_t val) {
+  size_t ret = 1;
+  while (val >= 0x80) {
+    val >>= 7;
+    ++ret;
+  }
+  return ret;
+}
+
+inline uint8_t* encode_varint(uint32_t val, uint8_t* out) {
+  while (val >= 0x80) {
+    *out++ = static_cast<uint8_t>(val | 0x80);
+    val >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(val);
+  return out;
+}
+
+inline const uint8_t* decode_varint(const uint8_t* in, uint32_t& val) {
+  uint32_t ret = 0;
+  int shift = 0;
+  while (true) {
+    uint8_t byte = *in++;
+    ret |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+    shift += 7;
+  }
+  val = ret;
+  return in;
+}
+
+// Run func(begin, end) over [0, num) in chunks with the threads of the
+// CsrThreadBudget.
+template <typename FUNC_T>
+void parallel_for_range(size_t num, const FUNC_T& func) {
+  int thread_num = CsrThreadBudget::get();
+  const size_t chunk = 4096;
+  std::atomic<size_t> cur(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      while (true) {
+        size_t begin = std::min(cur.fetch_add(chunk), num);
+        size_t end = std::min(begin + chunk, num);
+        if (begin == end) {
+          break;
+        }
+        func(begin, end);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+}  // namespace compressed_csr_impl
+
+// Decodes neighbors of one vertex on the fly. It acts as both the iterator and
+// the neighbor it points to, so that it can be used in range-based for loops
+// in the same way as ImmutableNbrSlice.
+template <typename EDATA_T>
+class CompressedNbrIterator {
+  static constexpr bool kHasData = !std::is_same_v<EDATA_T, grape::EmptyType>;
+
+ public:
+  CompressedNbrIterator()
+      : ptr_(nullptr), data_(nullptr), remaining_(0), neighbor_(0) {}
+  CompressedNbrIterator(const uint8_t* ptr, const EDATA_T* data, int size)
+      : ptr_(ptr), data_(data), remaining_(size), neighbor_(0) {
+    if (remaining_ > 0) {
+      ptr_ = compressed_csr_impl::decode_varint(ptr_, neighbor_);
+    }
+  }
+  ~CompressedNbrIterator() = default;
+
+  inline vid_t get_neighbor() const { return neighbor_; }
+  inline const EDATA_T& get_data() const {
+    if constexpr (kHasData) {
+      return *data_;
+    } else {
+      static const EDATA_T empty{};
+      return empty;
+    }
+  }
+
+  inline const CompressedNbrIterator& operator*() const { return *this; }
+  inline const CompressedNbrIterator* operator->() const { return this; }
+
+  inline CompressedNbrIterator& operator++() {
+    --remaining_;
+    if constexpr (kHasData) {
+      ++data_;
+    }
+    if (remaining_ > 0) {
+      uint32_t delta;
+      ptr_ = compressed_csr_impl::decode_varint(ptr_, delta);
+      neighbor_ += delta;
+    }
+    return *this;
+  }
+
+  // Only iterators from the same slice are comparable.
+  inline bool operator==(const CompressedNbrIterator& rhs) const {
+    return remaining_ == rhs.remaining_;
+  }
+  inline bool operator!=(const CompressedNbrIterator& rhs) const {
+    return remaining_ != rhs.remaining_;
+  }
+
+  inline int remaining() const { return remaining_; }
+
+ private:
+  const uint8_t* ptr_;
+  const EDATA_T* data_;
+  int remaining_;
+  vid_t neighbor_;
+};
+
+template <typename EDATA_T>
+class CompressedNbrSlice {
+ public:
+  using const_nbr_t = const CompressedNbrIterator<EDATA_T>;
+  using const_nbr_ptr_t = CompressedNbrIterator<EDATA_T>;
+
+  CompressedNbrSlice() : ptr_(nullptr), data_(nullptr), size_(0) {}
+  CompressedNbrSlice(const uint8_t* ptr, const EDATA_T* data, int size)
+      : ptr_(ptr), data_(data), size_(size) {}
+  ~CompressedNbrSlice() = default;
+
+  int size() const { return size_; }
+
+  const_nbr_ptr_t begin() const {
+    return CompressedNbrIterator<EDATA_T>(ptr_, data_, size_);
+  }
+  const_nbr_ptr_t end() const { return CompressedNbrIterator<EDATA_T>(); }
+
+  static CompressedNbrSlice empty() { return CompressedNbrSlice(); }
+
+ private:
+  const uint8_t* ptr_;
+  const EDATA_T* data_;
+  int size_;
+};
+
+template <typename EDATA_T>
+class CompressedCsrConstEdgeIter : public CsrConstEdgeIterBase {
+ public:
+  explicit CompressedCsrConstEdgeIter(const CompressedNbrSlice<EDATA_T>& slice)
+      : cur_(slice.begin()) {}
+  ~CompressedCsrConstEdgeIter() = default;
+
+  vid_t get_neighbor() const override { return cur_.get_neighbor(); }
+  Any get_data() const override {
+    return AnyConverter<EDATA_T>::to_any(cur_.get_data());
+  }
+  timestamp_t get_timestamp() const override { return 0; }
+
+  void next() override { ++cur_; }
+  CsrConstEdgeIterBase& operator+=(size_t offset) override {
+    while (offset > 0 && cur_.remaining() > 0) {
+      ++cur_;
+      --offset;
+    }
+    return *this;
+  }
+  bool is_valid() const override { return cur_.remaining() > 0; }
+  size_t size() const override { return cur_.remaining(); }
+
+ private:
+  CompressedNbrIterator<EDATA_T> cur_;
+};
+
+// An immutable csr whose adjacency lists are sorted by neighbor id and stored
+// as delta-encoded varints. Edges are staged in an uncompressed ImmutableCsr
+// during bulk loading and encoded when the csr is dumped. Edge data, if any,
+// is kept uncompressed in the same order as the neighbors.
+//
+// Files of a snapshot:
+//   <name>.deg  degree of each vertex
+//   <name>.coff byte offset of each vertex's neighbors in <name>.cnbr
+//   <name>.cnbr encoded neighbors
+//   <name>.cdat edge data, absent for edges without properties
+template <typename EDATA_T>
+class CompressedImmutableCsr : public TypedCsrBase<EDATA_T> {
+  static constexpr bool kHasData = !std::is_same_v<EDATA_T, grape::EmptyType>;
+
+ public:
+  using slice_t = CompressedNbrSlice<EDATA_T>;
+
+  CompressedImmutableCsr() : building_(false) {}
+  ~CompressedImmutableCsr() {}
+
+  size_t batch_init(const std::string& name, const std::string& work_dir,
+                    const std::vector<int>& degree,
+                    double reserve_ratio) override {
+    building_ = true;
+    return builder_.batch_init(name, work_dir, degree, reserve_ratio);
+  }
+
+  size_t batch_init_in_memory(const std::vector<int>& degree,
+                              double reserve_ratio) override {
+    building_ = true;
+    return builder_.batch_init_in_memory(degree, reserve_ratio);
+  }
+
+  void batch_put_edge(vid_t src, vid_t dst, const EDATA_T& data,
+                      timestamp_t ts) override {
+    builder_.batch_put_edge(src, dst, data, ts);
+  }
+
+  void open(const std::string& name, const std::string& snapshot_dir,
+            const std::string& work_dir) override {
+    if (snapshot_dir != "") {
+      load(snapshot_dir + "/" + name, 0, false);
+    }
+  }
+
+  void open_in_memory(const std::string& prefix, size_t v_cap) override {
+    load(prefix, v_cap, false);
+  }
+
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
+    load(prefix, v_cap, true);
+  }
+
+  void dump(const std::string& name,
+            const std::string& new_snapshot_dir) override {
+    if (building_) {
+      encode();
+    }
+    std::string prefix = new_snapshot_dir + "/" + name;
+    size_t vnum = degree_list_.size();
+    write_file(prefix + ".deg", degree_list_.data(), sizeof(int), vnum);
+    write_file(prefix + ".coff", offsets_.data(), sizeof(size_t), vnum);
+    write_file(prefix + ".cnbr", nbr_bytes_.data(), sizeof(uint8_t),
+               nbr_bytes_.size());
+    if constexpr (kHasData) {
+      write_file(prefix + ".cdat", data_list_.data(), sizeof(EDATA_T),
+                 data_list_.size());
+    }
+  }
+
+  void warmup(int thread_num) const override {
+    size_t len = nbr_bytes_.size();
+    std::vector<std::thread> threads;
+    std::atomic<size_t> cur(0);
+    std::atomic<size_t> output(0);
+    const size_t chunk = 4096 * 64;
+    for (int i = 0; i < thread_num; ++i) {
+      threads.emplace_back([&]() {
+        size_t ret = 0;
+        while (true) {
+          size_t begin = std::min(cur.fetch_add(chunk), len);
+          size_t end = std::min(begin + chunk, len);
+          if (begin == end) {
+            break;
+          }
+          while (begin < end) {
+            ret += nbr_bytes_[begin];
+            begin += 64;
+          }
+        }
+        output.fetch_add(ret);
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+    (void) output.load();
+  }
+
+  void resize(vid_t vnum) override {
+    if (building_) {
+      builder_.resize(vnum);
+      return;
+    }
+    size_t old_size = degree_list_.size();
+    degree_list_.resize(vnum);
+    offsets_.resize(vnum);
+    if constexpr (kHasData) {
+      edge_offsets_.resize(vnum);
+    }
+    for (size_t k = old_size; k < vnum; ++k) {
+      degree_list_[k] = 0;
+      offsets_[k] = 0;
+      if constexpr (kHasData) {
+        edge_offsets_[k] = 0;
+      }
+    }
+  }
+
+  void reserve(vid_t vnum) override {
+    if (building_) {
+      builder_.reserve(vnum);
+      return;
+    }
+    degree_list_.reserve(vnum);
+    offsets_.reserve(vnum);
+    if constexpr (kHasData) {
+      edge_offsets_.reserve(vnum);
+    }
+  }
+
+  size_t size() const override {
+    return building_ ? builder_.size() : degree_list_.size();
+  }
+
+  size_t edge_num() const override {
+    if (building_) {
+      return builder_.edge_num();
+    }
+    size_t ret = 0;
+    for (size_t i = 0; i < degree_list_.size(); ++i) {
+      ret += degree_list_[i];
+    }
+    return ret;
+  }
+
+  MemoryUsage memory_usage() const override {
+    if (building_) {
+      return builder_.memory_usage();
+    }
+    MemoryUsage ret = degree_list_.memory_usage();
+    ret += offsets_.memory_usage();
+    ret += edge_offsets_.memory_usage();
+    ret += nbr_bytes_.memory_usage();
+    ret += data_list_.memory_usage();
+    return ret;
+  }
+
+  std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
+    return std::make_shared<CompressedCsrConstEdgeIter<EDATA_T>>(get_edges(v));
+  }
+  CsrConstEdgeIterBase* edge_iter_raw(vid_t v) const override {
+    return new CompressedCsrConstEdgeIter<EDATA_T>(get_edges(v));
+  }
+  std::shared_ptr<CsrEdgeIterBase> edge_iter_mut(vid_t v) override {
+    return nullptr;
+  }
+
+  void put_edge(vid_t src, vid_t dst, const EDATA_T& data, timestamp_t ts,
+                Allocator& alloc) override {
+    LOG(FATAL) << "Put single edge is not supported";
+  }
+
+  // Neighbors are always kept sorted.
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
+  inline slice_t get_edges(vid_t v) const {
+    int deg = degree_list_[v];
+    if (deg == 0) {
+      return slice_t::empty();
+    }
+    if constexpr (kHasData) {
+      return slice_t(nbr_bytes_.data() + offsets_[v],
+                     data_list_.data() + edge_offsets_[v], deg);
+    } else {
+      return slice_t(nbr_bytes_.data() + offsets_[v], nullptr, deg);
+    }
+  }
+
+  inline int degree(vid_t v) const { return degree_list_[v]; }
+
+  // Bytes taken by the encoded neighbor ids.
+  size_t compressed_size() const { return nbr_bytes_.size(); }
+
+  void close() override {
+    builder_.close();
+    degree_list_.reset();
+    offsets_.reset();
+    edge_offsets_.reset();
+    nbr_bytes_.reset();
+    data_list_.reset();
+    building_ = false;
+  }
+
+ private:
+  void load(const std::string& prefix, size_t v_cap, bool hugepages) {
+    building_ = false;
+    if (hugepages) {
+      degree_list_.open_with_hugepages(prefix + ".deg", v_cap);
+      offsets_.open_with_hugepages(prefix + ".coff", v_cap);
+      nbr_bytes_.open_with_hugepages(prefix + ".cnbr");
+      if constexpr (kHasData) {
+        data_list_.open_with_hugepages(prefix + ".cdat");
+      }
+    } else {
+      degree_list_.open(prefix + ".deg", false);
+      offsets_.open(prefix + ".coff", false);
+      nbr_bytes_.open(prefix + ".cnbr", false);
+      if constexpr (kHasData) {
+        data_list_.open(prefix + ".cdat", false);
+      }
+    }
+    size_t vnum = degree_list_.size();
+    CHECK_EQ(offsets_.size(), vnum);
+    if constexpr (kHasData) {
+      edge_offsets_.open("", false);
+      edge_offsets_.resize(vnum);
+      size_t offset = 0;
+      for (size_t i = 0; i < vnum; ++i) {
+        edge_offsets_[i] = offset;
+        offset += degree_list_[i];
+      }
+      CHECK_EQ(offset, data_list_.size());
+    }
+    if (v_cap > vnum) {
+      resize(v_cap);
+    }
+  }
+
+  // Sort the staged adjacency lists by neighbor id and encode them.
+  void encode() {
+    size_t vnum = builder_.size();
+    degree_list_.open("", false);
+    degree_list_.resize(vnum);
+    offsets_.open("", false);
+    offsets_.resize(vnum);
+
+    std::vector<size_t> byte_sizes(vnum, 0);
+    compressed_csr_impl::parallel_for_range(
+        vnum, [&](size_t begin, size_t end) {
+          builder_.batch_sort_by_neighbor(begin, end);
+          for (size_t v = begin; v < end; ++v) {
+            auto edges = builder_.get_edges(v);
+            degree_list_[v] = edges.size();
+            size_t bytes = 0;
+            vid_t prev = 0;
+            for (auto& nbr : edges) {
+              bytes += compressed_csr_impl::varint_size(nbr.neighbor - prev);
+              prev = nbr.neighbor;
+            }
+            byte_sizes[v] = bytes;
+          }
+        });
+
+    if constexpr (kHasData) {
+      edge_offsets_.open("", false);
+      edge_offsets_.resize(vnum);
+    }
+    size_t byte_offset = 0, edge_offset = 0;
+    for (size_t v = 0; v < vnum; ++v) {
+      offsets_[v] = byte_offset;
+      byte_offset += byte_sizes[v];
+      if constexpr (kHasData) {
+        edge_offsets_[v] = edge_offset;
+      }
+      edge_offset += degree_list_[v];
+    }
+    nbr_bytes_.open("", false);
+    nbr_bytes_.resize(byte_offset);
+    if constexpr (kHasData) {
+      data_list_.open("", false);
+      data_list_.resize(edge_offset);
+    }
+
+    compressed_csr_impl::parallel_for_range(
+        vnum, [&](size_t begin, size_t end) {
+          for (size_t v = begin; v < end; ++v) {
+            uint8_t* out = nbr_bytes_.data() + offsets_[v];
+            vid_t prev = 0;
+            size_t idx = 0;
+            for (auto& nbr : builder_.get_edges(v)) {
+              out = compressed_csr_impl::encode_varint(nbr.neighbor - prev,
+                                                       out);
+              prev = nbr.neighbor;
+              if constexpr (kHasData) {
+                data_list_[edge_offsets_[v] + idx] = nbr.data;
+              }
+              ++idx;
+            }
+          }
+        });
+    VLOG(10) << "Compressed " << edge_offset << " edges into " << byte_offset
+             << " bytes";
+    builder_.close();
+    building_ = false;
+  }
+
+  ImmutableCsr<EDATA_T> builder_;
+  bool building_;
+
+  mmap_array<int> degree_list_;
+  mmap_array<size_t> offsets_;
+  mmap_array<size_t> edge_offsets_;
+  mmap_array<uint8_t> nbr_bytes_;
+  mmap_array<EDATA_T> data_list_;
+};
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_CSR_COMPRESSED_CSR_H_
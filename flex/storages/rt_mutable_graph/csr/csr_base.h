@@ -16,11 +16,14 @@
 #ifndef STORAGES_RT_MUTABLE_GRAPH_CSR_CSR_BASE_H_
 #define STORAGES_RT_MUTABLE_GRAPH_CSR_CSR_BASE_H_
 
+#include <algorithm>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "flex/storages/rt_mutable_graph/csr/nbr.h"
 #include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/allocators.h"
 
 namespace gs {
 
@@ -58,6 +61,26 @@ class CsrEdgeIterBase {
   virtual void set_data(const Any& value, timestamp_t ts) = 0;
 };
 
+// The threads a csr may spawn for one of its batch operations: all hardware
+// threads, unless the calling thread runs the operation as one of several
+// tasks in parallel and holds a CsrThreadBudget with its share of them.
+class CsrThreadBudget {
+ public:
+  explicit CsrThreadBudget(int thread_num) : prev_(budget_) {
+    budget_ = std::max(thread_num, 1);
+  }
+  ~CsrThreadBudget() { budget_ = prev_; }
+
+  static int get() {
+    return budget_ > 0 ? budget_
+                       : std::max<int>(std::thread::hardware_concurrency(), 1);
+  }
+
+ private:
+  static inline thread_local int budget_ = 0;
+  int prev_;
+};
+
 class CsrBase {
  public:
   CsrBase() = default;
@@ -73,7 +96,35 @@ class CsrBase {
   virtual void batch_sort_by_edge_data(timestamp_t ts) {
     LOG(FATAL) << "not supported...";
   }
+  // Sort each adjacency list by neighbor id. As with batch_sort_by_edge_data,
+  // edges inserted after `ts` are appended to an unsorted tail.
+  virtual void batch_sort_by_neighbor(timestamp_t ts) {
+    LOG(FATAL) << "not supported...";
+  }
+  // Makes room for degree[v] more edges of each vertex v on top of the ones
+  // it holds, growing the csr to degree.size() vertices if needed, so that
+  // they can be added by batch_put_edge after the csr was opened.
+  virtual void batch_reserve(const std::vector<int>& degree) {
+    LOG(FATAL) << "not supported...";
+  }
+  // Moves the edges of each vertex v < vertex_map.size() to vertex_map[v]
+  // and renames their neighbors u to nbr_map[u]. Both maps are permutations
+  // and the vertices not covered by vertex_map are left without edges. The
+  // adjacency lists are no longer sorted afterwards.
+  virtual void batch_relabel(const std::vector<vid_t>& vertex_map,
+                             const std::vector<vid_t>& nbr_map) {
+    LOG(FATAL) << "not supported...";
+  }
   virtual timestamp_t unsorted_since() const { return 0; }
+  // Upper bound of the number of vertices a batch sort would have to visit,
+  // i.e. those whose adjacency lists changed since they were last sorted.
+  virtual size_t unsorted_vertex_num() const { return size(); }
+
+  // Declares every edge written so far visible to all later readers, which
+  // holds at compaction since it waits for running transactions. Adjacency
+  // lists not written after that may be scanned without visibility tests.
+  virtual void batch_freeze() {}
+  virtual bool has_unfrozen_writes() const { return false; }
 
   virtual void open(const std::string& name, const std::string& snapshot_dir,
                     const std::string& work_dir) = 0;
@@ -91,6 +142,9 @@ class CsrBase {
   virtual void warmup(int thread_num) const = 0;
 
   virtual void resize(vid_t vnum) = 0;
+  // Reserves room for vnum vertices, so that resizing up to vnum afterwards
+  // keeps the adjacency lists in place for their concurrent readers.
+  virtual void reserve(vid_t vnum) {}
   virtual size_t size() const = 0;
 
   // Returns the number of edges in the graph. Note that the returned value is
@@ -98,6 +152,11 @@ class CsrBase {
   // space, the reserved space will count as 0.
   virtual size_t edge_num() const = 0;
 
+  // Bytes mapped by the degree, offset and neighbor buffers of the csr, and
+  // how many are resident. Adjacency lists grown into the allocators of the
+  // sessions are counted with those allocators.
+  virtual MemoryUsage memory_usage() const { return MemoryUsage(); }
+
   virtual void close() = 0;
 
   virtual std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const = 0;
@@ -137,6 +196,13 @@ class TypedMutableCsrBase : public TypedCsrBase<EDATA_T> {
   using slice_t = MutableNbrSlice<EDATA_T>;
 
   virtual slice_t get_edges(vid_t v) const = 0;
+
+  // Single and empty csrs hold a fixed number of edges per vertex.
+  void batch_reserve(const std::vector<int>& degree) override {
+    if (degree.size() > this->size()) {
+      this->resize(degree.size());
+    }
+  }
 };
 
 template <>
@@ -0,0 +1,210 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_CSR_DIRTY_RANGES_H_
+#define STORAGES_RT_MUTABLE_GRAPH_CSR_DIRTY_RANGES_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+
+namespace gs {
+
+// Tracks which fixed-size ranges of source vertices had their adjacency lists
+// modified since the ranges were last cleared, e.g. by a batch sort, so that
+// compaction only re-sorts those. mark() and is_marked() may be called
+// concurrently with writers, and with reserve() and resize() growing the
+// words, whose former allocations are kept until reset() as marks may still
+// land there. The other methods must not race with writers, which holds for
+// compaction since it is exclusive.
+class DirtyVertexRanges {
+ public:
+  static constexpr int kRangeShift = 10;
+  static constexpr size_t kRangeSize = static_cast<size_t>(1) << kRangeShift;
+
+  DirtyVertexRanges()
+      : vnum_(0), word_num_(0), word_capacity_(0), words_(nullptr) {}
+
+  void reset(size_t vnum, bool dirty) {
+    vnum_ = vnum;
+    word_num_ = (range_num(vnum) + 63) / 64;
+    word_capacity_ = std::max(word_capacity_, word_num_);
+    allocations_.clear();
+    allocations_.emplace_back(new std::atomic<uint64_t>[word_capacity_]);
+    auto* words = allocations_.back().get();
+    for (size_t i = 0; i < word_capacity_; ++i) {
+      words[i].store(dirty && i < word_num_ ? ~static_cast<uint64_t>(0) : 0,
+                     std::memory_order_relaxed);
+    }
+    words_.store(words);
+  }
+
+  // Allocates the words for vnum vertices, so that resizing up to vnum
+  // afterwards keeps them in place, with writers marking concurrently.
+  void reserve(size_t vnum) {
+    size_t new_capacity = (range_num(vnum) + 63) / 64;
+    if (new_capacity > word_capacity_) {
+      reallocate(new_capacity);
+    }
+  }
+
+  // Vertices added by growing start with empty, and hence sorted, lists.
+  void resize(size_t vnum) {
+    size_t new_word_num = (range_num(vnum) + 63) / 64;
+    if (new_word_num > word_capacity_) {
+      reallocate(new_word_num);
+    }
+    auto* words = words_.load(std::memory_order_relaxed);
+    for (size_t i = new_word_num; i < word_num_; ++i) {
+      words[i].store(0, std::memory_order_relaxed);
+    }
+    word_num_ = new_word_num;
+    vnum_ = vnum;
+  }
+
+  // A mark that lands in words being replaced is marked again in the new
+  // ones, unless reallocate() copied it there.
+  inline void mark(vid_t v) {
+    size_t range = v >> kRangeShift;
+    uint64_t bit = static_cast<uint64_t>(1) << (range & 63);
+    auto* words = words_.load(std::memory_order_acquire);
+    if ((words[range >> 6].load(std::memory_order_relaxed) & bit) != 0) {
+      return;
+    }
+    while (true) {
+      words[range >> 6].fetch_or(bit);
+      auto* cur = words_.load();
+      if (cur == words) {
+        return;
+      }
+      words = cur;
+    }
+  }
+
+  inline bool is_marked(vid_t v) const {
+    size_t range = v >> kRangeShift;
+    uint64_t bit = static_cast<uint64_t>(1) << (range & 63);
+    auto* words = words_.load(std::memory_order_acquire);
+    return (words[range >> 6].load(std::memory_order_relaxed) & bit) != 0;
+  }
+
+  bool any() const {
+    auto* words = words_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < word_num_; ++i) {
+      if (words[i].load(std::memory_order_relaxed) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Number of vertices in dirty ranges.
+  size_t dirty_vertex_num() const {
+    size_t ret = 0;
+    foreach_dirty([&](vid_t begin, vid_t end) { ret += end - begin; });
+    return ret;
+  }
+
+  template <typename FUNC_T>
+  void foreach_dirty(const FUNC_T& func) const {
+    size_t ranges = range_num(vnum_);
+    auto* words = words_.load(std::memory_order_relaxed);
+    for (size_t w = 0; w < word_num_; ++w) {
+      uint64_t word = words[w].load(std::memory_order_relaxed);
+      while (word != 0) {
+        size_t range = w * 64 + __builtin_ctzll(word);
+        word &= word - 1;
+        if (range >= ranges) {
+          break;
+        }
+        vid_t begin = range << kRangeShift;
+        vid_t end = std::min(vnum_, (range + 1) << kRangeShift);
+        func(begin, end);
+      }
+    }
+  }
+
+  // As foreach_dirty, with the ranges handed out one at a time to up to
+  // thread_num threads, so that a few long adjacency lists do not hold up a
+  // thread while the others are idle.
+  template <typename FUNC_T>
+  void parallel_foreach_dirty(int thread_num, const FUNC_T& func) const {
+    std::vector<vid_t> begins;
+    foreach_dirty([&](vid_t begin, vid_t) { begins.push_back(begin); });
+    thread_num = std::min<size_t>(std::max(thread_num, 1), begins.size());
+    if (thread_num <= 1) {
+      for (auto begin : begins) {
+        func(begin, std::min<vid_t>(vnum_, begin + kRangeSize));
+      }
+      return;
+    }
+    std::atomic<size_t> cur(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_num; ++i) {
+      threads.emplace_back([&]() {
+        size_t k;
+        while ((k = cur.fetch_add(1)) < begins.size()) {
+          func(begins[k], std::min<vid_t>(vnum_, begins[k] + kRangeSize));
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  void clear() {
+    auto* words = words_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < word_num_; ++i) {
+      words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static size_t range_num(size_t vnum) {
+    return (vnum + kRangeSize - 1) >> kRangeShift;
+  }
+
+  // The new words are published before the old ones are copied into them,
+  // so that a mark either is copied or sees the new words and marks again.
+  void reallocate(size_t word_capacity) {
+    auto* old_words = words_.load(std::memory_order_relaxed);
+    allocations_.emplace_back(new std::atomic<uint64_t>[word_capacity]);
+    auto* new_words = allocations_.back().get();
+    for (size_t i = 0; i < word_capacity; ++i) {
+      new_words[i].store(0, std::memory_order_relaxed);
+    }
+    words_.store(new_words);
+    for (size_t i = 0; i < std::min(word_capacity_, word_capacity); ++i) {
+      new_words[i].fetch_or(old_words[i].load());
+    }
+    word_capacity_ = word_capacity;
+  }
+
+  size_t vnum_;
+  size_t word_num_;
+  size_t word_capacity_;
+  std::atomic<std::atomic<uint64_t>*> words_;
+  // The current words last.
+  std::vector<std::unique_ptr<std::atomic<uint64_t>[]>> allocations_;
+};
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_CSR_DIRTY_RANGES_H_
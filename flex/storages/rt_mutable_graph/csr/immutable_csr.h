@@ -55,6 +55,8 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
   using nbr_t = ImmutableNbr<EDATA_T>;
   using slice_t = ImmutableNbrSlice<EDATA_T>;
 
+  ImmutableCsr() : unsorted_since_(0), sorted_(false) {}
+
   size_t batch_init(const std::string& name, const std::string& work_dir,
                     const std::vector<int>& degree,
                     double reserve_ratio) override {
@@ -87,6 +89,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     }
 
     unsorted_since_ = 0;
+    sorted_ = false;
     return edge_num;
   }
 
@@ -121,6 +124,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     }
 
     unsorted_since_ = 0;
+    sorted_ = false;
     return edge_num;
   }
 
@@ -129,6 +133,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     auto& nbr = adj_lists_[src][degree_list_[src]++];
     nbr.neighbor = dst;
     nbr.data = data;
+    sorted_ = false;
   }
 
   void batch_sort_by_edge_data(timestamp_t ts) override {
@@ -140,10 +145,70 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
                 });
     }
     unsorted_since_ = ts;
+    sorted_ = true;
+  }
+
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    batch_sort_by_neighbor(0, adj_lists_.size());
+    unsorted_since_ = ts;
+    sorted_ = true;
+  }
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    size_t vnum = adj_lists_.size();
+    CHECK_LE(vertex_map.size(), vnum);
+    std::vector<vid_t> old_id(vertex_map.size());
+    for (size_t i = 0; i < vertex_map.size(); ++i) {
+      old_id[vertex_map[i]] = i;
+    }
+    mmap_array<nbr_t> new_nbr_list;
+    new_nbr_list.open("", false);
+    new_nbr_list.resize(edge_num());
+    mmap_array<int> new_degree_list;
+    new_degree_list.open("", false);
+    new_degree_list.resize(vnum);
+    nbr_t* ptr = new_nbr_list.data();
+    for (size_t i = 0; i < vnum; ++i) {
+      int deg = i < old_id.size() ? degree_list_[old_id[i]] : 0;
+      if (deg != 0) {
+        std::copy(adj_lists_[old_id[i]], adj_lists_[old_id[i]] + deg, ptr);
+        for (int k = 0; k < deg; ++k) {
+          ptr[k].neighbor = nbr_map[ptr[k].neighbor];
+        }
+      }
+      new_degree_list[i] = deg;
+      ptr += deg;
+    }
+    ptr = new_nbr_list.data();
+    for (size_t i = 0; i < vnum; ++i) {
+      adj_lists_[i] = new_degree_list[i] != 0 ? ptr : NULL;
+      ptr += new_degree_list[i];
+    }
+    nbr_list_.swap(new_nbr_list);
+    degree_list_.swap(new_degree_list);
+    unsorted_since_ = 0;
+    sorted_ = false;
+  }
+
+  // Sort the neighbors of vertices in [from, to) by neighbor id.
+  void batch_sort_by_neighbor(vid_t from, vid_t to) {
+    to = std::min(to, static_cast<vid_t>(adj_lists_.size()));
+    for (vid_t i = from; i < to; ++i) {
+      std::sort(adj_lists_[i], adj_lists_[i] + degree_list_[i],
+                [](const nbr_t& lhs, const nbr_t& rhs) {
+                  return lhs.neighbor < rhs.neighbor;
+                });
+    }
   }
 
   timestamp_t unsorted_since() const override { return unsorted_since_; }
 
+  // The csr cannot be written after loading, so once sorted it stays sorted.
+  size_t unsorted_vertex_num() const override {
+    return sorted_ ? 0 : adj_lists_.size();
+  }
+
   void open(const std::string& name, const std::string& snapshot_dir,
             const std::string& work_dir) override {
     // Changes made to the CSR will not be synchronized to the file
@@ -163,6 +228,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
       adj_lists_[i] = ptr;
       ptr += deg;
     }
+    sorted_ = false;
   }
 
   void open_in_memory(const std::string& prefix, size_t v_cap) override {
@@ -189,6 +255,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
       degree_list_[i] = 0;
       adj_lists_[i] = NULL;
     }
+    sorted_ = false;
   }
 
   void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
@@ -215,6 +282,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
       degree_list_[i] = 0;
       adj_lists_[i] = NULL;
     }
+    sorted_ = false;
   }
 
   void dump(const std::string& name,
@@ -258,6 +326,11 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     }
   }
 
+  void reserve(vid_t vnum) override {
+    adj_lists_.reserve(vnum);
+    degree_list_.reserve(vnum);
+  }
+
   size_t size() const override { return adj_lists_.size(); }
 
   size_t edge_num() const override {
@@ -268,6 +341,13 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     return ret;
   }
 
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = adj_lists_.memory_usage();
+    ret += degree_list_.memory_usage();
+    ret += nbr_list_.memory_usage();
+    return ret;
+  }
+
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<ImmutableCsrConstEdgeIter<EDATA_T>>(get_edges(v));
   }
@@ -321,6 +401,7 @@ class ImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
   mmap_array<int> degree_list_;
   mmap_array<nbr_t> nbr_list_;
   timestamp_t unsorted_since_;
+  bool sorted_;
 };
 
 template <>
@@ -366,9 +447,23 @@ class ImmutableCsr<std::string_view>
     csr_.dump(name, new_snapshot_dir);
   }
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    csr_.batch_sort_by_neighbor(ts);
+  }
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override {
+    return csr_.unsorted_vertex_num();
+  }
+
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
@@ -401,6 +496,7 @@ class ImmutableCsr<std::string_view>
   void close() override { csr_.close(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
  private:
   StringColumn& column_;
@@ -449,9 +545,23 @@ class ImmutableCsr<RecordView> : public TypedImmutableCsrBase<RecordView> {
     csr_.dump(name, new_snapshot_dir);
   }
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    csr_.batch_sort_by_neighbor(ts);
+  }
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override {
+    return csr_.unsorted_vertex_num();
+  }
+
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
@@ -484,6 +594,7 @@ class ImmutableCsr<RecordView> : public TypedImmutableCsrBase<RecordView> {
   void close() override { csr_.close(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
  private:
   Table& table_;
@@ -531,6 +642,31 @@ class SingleImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    size_t vnum = nbr_list_.size();
+    CHECK_LE(vertex_map.size(), vnum);
+    mmap_array<nbr_t> new_nbr_list;
+    new_nbr_list.open("", false);
+    new_nbr_list.resize(vnum);
+    for (size_t k = 0; k != vnum; ++k) {
+      new_nbr_list[k].neighbor = std::numeric_limits<vid_t>::max();
+    }
+    for (size_t i = 0; i < vertex_map.size(); ++i) {
+      const auto& nbr = nbr_list_[i];
+      if (nbr.neighbor != std::numeric_limits<vid_t>::max()) {
+        auto& new_nbr = new_nbr_list[vertex_map[i]];
+        new_nbr = nbr;
+        new_nbr.neighbor = nbr_map[nbr.neighbor];
+      }
+    }
+    nbr_list_.swap(new_nbr_list);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -626,6 +762,8 @@ class SingleImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     }
   }
 
+  void reserve(vid_t vnum) override { nbr_list_.reserve(vnum); }
+
   size_t size() const override { return nbr_list_.size(); }
 
   size_t edge_num() const override {
@@ -638,6 +776,10 @@ class SingleImmutableCsr : public TypedImmutableCsrBase<EDATA_T> {
     return ret;
   }
 
+  MemoryUsage memory_usage() const override {
+    return nbr_list_.memory_usage();
+  }
+
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<ImmutableCsrConstEdgeIter<EDATA_T>>(get_edges(v));
   }
@@ -704,6 +846,15 @@ class SingleImmutableCsr<std::string_view>
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -729,10 +880,12 @@ class SingleImmutableCsr<std::string_view>
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<ImmutableCsrConstEdgeIter<std::string_view>>(
@@ -797,6 +950,15 @@ class SingleImmutableCsr<RecordView>
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -822,10 +984,12 @@ class SingleImmutableCsr<RecordView>
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<ImmutableCsrConstEdgeIter<RecordView>>(
@@ -16,12 +16,15 @@
 #ifndef STORAGES_RT_MUTABLE_GRAPH_CSR_MUTABLE_CSR_H_
 #define STORAGES_RT_MUTABLE_GRAPH_CSR_MUTABLE_CSR_H_
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "grape/utils/concurrent_queue.h"
 
 #include "flex/storages/rt_mutable_graph/csr/adj_list.h"
 #include "flex/storages/rt_mutable_graph/csr/csr_base.h"
+#include "flex/storages/rt_mutable_graph/csr/dirty_ranges.h"
 #include "flex/storages/rt_mutable_graph/csr/nbr.h"
 
 namespace gs {
@@ -187,12 +190,8 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
   using slice_t = MutableNbrSlice<EDATA_T>;
   using mut_slice_t = MutableNbrSliceMut<EDATA_T>;
 
-  MutableCsr() : locks_(nullptr) {}
-  ~MutableCsr() {
-    if (locks_ != nullptr) {
-      delete[] locks_;
-    }
-  }
+  MutableCsr() {}
+  ~MutableCsr() {}
 
   size_t batch_init(const std::string& name, const std::string& work_dir,
                     const std::vector<int>& degree,
@@ -202,7 +201,7 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     adj_lists_.open(work_dir + "/" + name + ".adj", true);
     adj_lists_.resize(vnum);
 
-    locks_ = new grape::SpinLock[vnum];
+    reset_locks(vnum);
 
     size_t edge_num = 0;
     for (auto d : degree) {
@@ -220,6 +219,8 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     }
 
     unsorted_since_ = 0;
+    dirty_.reset(vnum, true);
+    unfrozen_.reset(vnum, true);
     return edge_num;
   }
 
@@ -230,7 +231,7 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     adj_lists_.open("", false);
     adj_lists_.resize(vnum);
 
-    locks_ = new grape::SpinLock[vnum];
+    reset_locks(vnum);
 
     size_t edge_num = 0;
     for (auto d : degree) {
@@ -248,6 +249,8 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     }
 
     unsorted_since_ = 0;
+    dirty_.reset(vnum, true);
+    unfrozen_.reset(vnum, true);
     return edge_num;
   }
 
@@ -256,20 +259,140 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     adj_lists_[src].batch_put_edge(dst, data, ts);
   }
 
-  void batch_sort_by_edge_data(timestamp_t ts) override {
+  // All lists are moved to a new nbr list at once, in vertex order, so that
+  // the csr is dumped as a single copy of it.
+  void batch_reserve(const std::vector<int>& degree) override {
+    if (degree.size() > adj_lists_.size()) {
+      resize(degree.size());
+    }
+    size_t vnum = adj_lists_.size();
+    auto new_cap = [&](size_t i) {
+      int extra = i < degree.size() ? degree[i] : 0;
+      return std::max(adj_lists_[i].capacity(), adj_lists_[i].size() + extra);
+    };
+    size_t edge_num = 0;
+    for (size_t i = 0; i < vnum; ++i) {
+      edge_num += new_cap(i);
+    }
+    mmap_array<nbr_t> new_nbr_list;
+    new_nbr_list.open("", false);
+    new_nbr_list.resize(edge_num);
+    nbr_t* ptr = new_nbr_list.data();
+    for (size_t i = 0; i < vnum; ++i) {
+      int size = adj_lists_[i].size();
+      int cap = new_cap(i);
+      if (size != 0) {
+        UninitializedUtils<nbr_t>::copy(ptr, adj_lists_[i].data(), size);
+      }
+      adj_lists_[i].init(ptr, cap, size);
+      if (i < degree.size() && degree[i] != 0) {
+        dirty_.mark(i);
+        unfrozen_.mark(i);
+      }
+      ptr += cap;
+    }
+    nbr_list_.swap(new_nbr_list);
+  }
+
+  // The lists are copied to a new nbr list in the order of the new ids, so
+  // that the edges of adjacent vertices stay adjacent in memory.
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
     size_t vnum = adj_lists_.size();
-    for (size_t i = 0; i != vnum; ++i) {
-      std::sort(adj_lists_[i].data(),
-                adj_lists_[i].data() + adj_lists_[i].size(),
-                [](const nbr_t& lhs, const nbr_t& rhs) {
-                  return lhs.data < rhs.data;
-                });
+    CHECK_LE(vertex_map.size(), vnum);
+    std::vector<vid_t> old_id(vertex_map.size());
+    for (size_t i = 0; i < vertex_map.size(); ++i) {
+      old_id[vertex_map[i]] = i;
+    }
+    std::vector<int> degree(vnum, 0);
+    size_t edge_num = 0;
+    for (size_t i = 0; i < old_id.size(); ++i) {
+      degree[i] = adj_lists_[old_id[i]].size();
+      edge_num += degree[i];
     }
+    mmap_array<nbr_t> new_nbr_list;
+    new_nbr_list.open("", false);
+    new_nbr_list.resize(edge_num);
+    nbr_t* ptr = new_nbr_list.data();
+    for (size_t i = 0; i < old_id.size(); ++i) {
+      if (degree[i] != 0) {
+        UninitializedUtils<nbr_t>::copy(ptr, adj_lists_[old_id[i]].data(),
+                                        degree[i]);
+        for (int k = 0; k < degree[i]; ++k) {
+          ptr[k].neighbor = nbr_map[ptr[k].neighbor];
+        }
+      }
+      ptr += degree[i];
+    }
+    ptr = new_nbr_list.data();
+    for (size_t i = 0; i < vnum; ++i) {
+      adj_lists_[i].init(ptr, degree[i], degree[i]);
+      ptr += degree[i];
+    }
+    nbr_list_.swap(new_nbr_list);
+    unsorted_since_ = 0;
+    dirty_.reset(vnum, true);
+    unfrozen_.reset(vnum, true);
+  }
+
+  // Only the vertex ranges written since the last sort are sorted again, the
+  // others are still sorted and hold edges older than unsorted_since_ only.
+  // The ranges are sorted on the threads of the CsrThreadBudget.
+  void batch_sort_by_edge_data(timestamp_t ts) override {
+    dirty_.parallel_foreach_dirty(
+        CsrThreadBudget::get(), [this](vid_t begin, vid_t end) {
+          for (vid_t i = begin; i != end; ++i) {
+            std::sort(adj_lists_[i].data(),
+                      adj_lists_[i].data() + adj_lists_[i].size(),
+                      [](const nbr_t& lhs, const nbr_t& rhs) {
+                        return lhs.data < rhs.data;
+                      });
+          }
+        });
+    dirty_.clear();
+    unsorted_since_ = ts;
+  }
+
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    dirty_.parallel_foreach_dirty(
+        CsrThreadBudget::get(), [this](vid_t begin, vid_t end) {
+          for (vid_t i = begin; i != end; ++i) {
+            std::sort(adj_lists_[i].data(),
+                      adj_lists_[i].data() + adj_lists_[i].size(),
+                      [](const nbr_t& lhs, const nbr_t& rhs) {
+                        return lhs.neighbor < rhs.neighbor;
+                      });
+          }
+        });
+    dirty_.clear();
     unsorted_since_ = ts;
   }
 
   timestamp_t unsorted_since() const override { return unsorted_since_; }
 
+  size_t unsorted_vertex_num() const override {
+    return dirty_.dirty_vertex_num();
+  }
+
+  void batch_freeze() override { unfrozen_.clear(); }
+
+  bool has_unfrozen_writes() const override { return unfrozen_.any(); }
+
+  // Whether all edges of v are visible to every reader, see
+  // CsrBase::batch_freeze. It must be called after get_edges(v), whose
+  // acquire load of the size orders it after the writes it reports on.
+  inline bool is_frozen(vid_t v) const { return !unfrozen_.is_marked(v); }
+
+  // Hints for reads of many adjacency lists in turn, see
+  // runtime::GraphView::foreach_prefetched: the header of the list of v,
+  // and its first neighbors once the header is cached.
+  inline void prefetch_adj_list(vid_t v) const {
+    __builtin_prefetch(adj_lists_.data() + v);
+  }
+  inline void prefetch_edges(vid_t v) const {
+    __builtin_prefetch(adj_lists_[v].get_edges().begin());
+  }
+
   void open(const std::string& name, const std::string& snapshot_dir,
             const std::string& work_dir) override {
     mmap_array<int> degree_list;
@@ -287,18 +410,14 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     adj_lists_.open(work_dir + "/" + name + ".adj", true);
 
     adj_lists_.resize(degree_list.size());
-    locks_ = new grape::SpinLock[degree_list.size()];
+    reset_locks(degree_list.size());
 
-    nbr_t* ptr = nbr_list_.data();
-    for (size_t i = 0; i < degree_list.size(); ++i) {
-      int degree = degree_list[i];
-      int cap = (*cap_list)[i];
-      adj_lists_[i].init(ptr, cap, degree);
-      ptr += cap;
-    }
+    init_adj_lists(degree_list, *cap_list, degree_list.size());
     if (cap_list != &degree_list) {
       delete cap_list;
     }
+    dirty_.reset(degree_list.size(), true);
+    unfrozen_.reset(degree_list.size(), true);
   }
 
   void open_in_memory(const std::string& prefix, size_t v_cap) override {
@@ -316,22 +435,15 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     adj_lists_.reset();
     v_cap = std::max(v_cap, degree_list.size());
     adj_lists_.resize(v_cap);
-    locks_ = new grape::SpinLock[v_cap];
+    reset_locks(v_cap);
 
-    nbr_t* ptr = nbr_list_.data();
-    for (size_t i = 0; i < degree_list.size(); ++i) {
-      int degree = degree_list[i];
-      int cap = (*cap_list)[i];
-      adj_lists_[i].init(ptr, cap, degree);
-      ptr += cap;
-    }
-    for (size_t i = degree_list.size(); i < v_cap; ++i) {
-      adj_lists_[i].init(ptr, 0, 0);
-    }
+    init_adj_lists(degree_list, *cap_list, v_cap);
 
     if (cap_list != &degree_list) {
       delete cap_list;
     }
+    dirty_.reset(v_cap, true);
+    unfrozen_.reset(v_cap, true);
   }
 
   void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
@@ -350,22 +462,15 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     v_cap = std::max(v_cap, degree_list.size());
     adj_lists_.open_with_hugepages("");
     adj_lists_.resize(v_cap);
-    locks_ = new grape::SpinLock[v_cap];
+    reset_locks(v_cap);
 
-    nbr_t* ptr = nbr_list_.data();
-    for (size_t i = 0; i < degree_list.size(); ++i) {
-      int degree = degree_list[i];
-      int cap = (*cap_list)[i];
-      adj_lists_[i].init(ptr, cap, degree);
-      ptr += cap;
-    }
-    for (size_t i = degree_list.size(); i < v_cap; ++i) {
-      adj_lists_[i].init(ptr, 0, 0);
-    }
+    init_adj_lists(degree_list, *cap_list, v_cap);
 
     if (cap_list != &degree_list) {
       delete cap_list;
     }
+    dirty_.reset(v_cap, true);
+    unfrozen_.reset(v_cap, true);
   }
 
   void dump(const std::string& name,
@@ -498,12 +603,27 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
       for (size_t k = old_size; k != vnum; ++k) {
         adj_lists_[k].init(NULL, 0, 0);
       }
-      delete[] locks_;
-      locks_ = new grape::SpinLock[vnum];
+      // In place up to the reservation, which the vertices added while the
+      // csr is served never get past, see reserve().
+      if (vnum > locks_.size()) {
+        locks_.resize(vnum);
+      }
     } else {
       adj_lists_.resize(vnum);
     }
+    dirty_.resize(vnum);
+    unfrozen_.resize(vnum);
   }
+
+  // The locks are reserved with the lists, so that they are never freed or
+  // moved under a writer holding one as the csr grows.
+  void reserve(vid_t vnum) override {
+    adj_lists_.reserve(vnum);
+    locks_.reserve(vnum);
+    dirty_.reserve(vnum);
+    unfrozen_.reserve(vnum);
+  }
+
   size_t size() const override { return adj_lists_.size(); }
 
   size_t edge_num() const override {
@@ -514,6 +634,12 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     return res;
   }
 
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = adj_lists_.memory_usage();
+    ret += nbr_list_.memory_usage();
+    return ret;
+  }
+
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<EDATA_T>>(get_edges(v));
   }
@@ -527,29 +653,82 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
   void put_edge(vid_t src, vid_t dst, const EDATA_T& data, timestamp_t ts,
                 Allocator& alloc) override {
     CHECK_LT(src, adj_lists_.size());
-    locks_[src].lock();
-    adj_lists_[src].put_edge(dst, data, ts, alloc);
-    locks_[src].unlock();
+    // Marked before the edge is published, see is_frozen.
+    dirty_.mark(src);
+    unfrozen_.mark(src);
+    // Only taken by adj_lists_[src] if the list has to grow.
+    adj_lists_[src].put_edge(dst, data, ts, alloc, locks_[src]);
   }
 
   inline slice_t get_edges(vid_t v) const override {
     return adj_lists_[v].get_edges();
   }
 
+  // Edge data may be updated through the returned slice, which can break the
+  // order established by the last sort.
   inline mut_slice_t get_edges_mut(vid_t i) {
+    dirty_.mark(i);
+    unfrozen_.mark(i);
     return adj_lists_[i].get_edges_mut();
   }
 
   void close() override {
-    if (locks_ != nullptr) {
-      delete[] locks_;
-      locks_ = nullptr;
-    }
+    locks_.reset();
     adj_lists_.reset();
     nbr_list_.reset();
   }
 
  private:
+  // Points the first v_cap adjacency lists into nbr_list_, back to back with
+  // the given capacities, the vertices beyond degree_list getting empty
+  // lists. The capacities are summed per range of vertices first, so that
+  // the ranges are then set up in parallel.
+  void init_adj_lists(const mmap_array<int>& degree_list,
+                      const mmap_array<int>& cap_list, size_t v_cap) {
+    const size_t chunk = 65536;
+    size_t vnum = degree_list.size();
+    size_t chunk_num = (vnum + chunk - 1) / chunk;
+    std::vector<size_t> offsets(chunk_num + 1, 0);
+    auto for_each_chunk = [&](auto&& func) {
+      int thread_num = std::min<size_t>(CsrThreadBudget::get(), chunk_num);
+      std::atomic<size_t> chunk_i(0);
+      std::vector<std::thread> threads;
+      for (int i = 0; i < thread_num; ++i) {
+        threads.emplace_back([&]() {
+          size_t cur;
+          while ((cur = chunk_i.fetch_add(1)) < chunk_num) {
+            func(cur, cur * chunk, std::min(vnum, (cur + 1) * chunk));
+          }
+        });
+      }
+      for (auto& thrd : threads) {
+        thrd.join();
+      }
+    };
+    for_each_chunk([&](size_t id, size_t begin, size_t end) {
+      size_t cap_sum = 0;
+      for (size_t i = begin; i < end; ++i) {
+        cap_sum += cap_list[i];
+      }
+      offsets[id + 1] = cap_sum;
+    });
+    for (size_t i = 0; i < chunk_num; ++i) {
+      offsets[i + 1] += offsets[i];
+    }
+    nbr_t* base = nbr_list_.data();
+    for_each_chunk([&](size_t id, size_t begin, size_t end) {
+      nbr_t* ptr = base + offsets[id];
+      for (size_t i = begin; i < end; ++i) {
+        int cap = cap_list[i];
+        adj_lists_[i].init(ptr, cap, degree_list[i]);
+        ptr += cap;
+      }
+    });
+    for (size_t i = vnum; i < v_cap; ++i) {
+      adj_lists_[i].init(base + offsets[chunk_num], 0, 0);
+    }
+  }
+
   void load_meta(const std::string& prefix) {
     std::string meta_file_path = prefix + ".meta";
     if (std::filesystem::exists(meta_file_path)) {
@@ -565,10 +744,20 @@ class MutableCsr : public TypedMutableCsrBase<EDATA_T> {
     write_file(meta_file_path, &unsorted_since_, sizeof(timestamp_t), 1);
   }
 
-  grape::SpinLock* locks_;
+  // Anonymous pages, zeroed and so unlocked, only committed as written.
+  void reset_locks(size_t vnum) {
+    locks_.reset();
+    locks_.open("", false);
+    locks_.resize(vnum);
+  }
+
+  mmap_array<grape::SpinLock> locks_;
   mmap_array<adjlist_t> adj_lists_;
   mmap_array<nbr_t> nbr_list_;
   timestamp_t unsorted_since_;
+  DirtyVertexRanges dirty_;
+  // Ranges written since the last batch_freeze.
+  DirtyVertexRanges unfrozen_;
 };
 
 template <>
@@ -599,6 +788,15 @@ class MutableCsr<std::string_view>
     csr_.batch_put_edge(src, dst, data, ts);
   }
 
+  void batch_reserve(const std::vector<int>& degree) override {
+    csr_.batch_reserve(degree);
+  }
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
   void open(const std::string& name, const std::string& snapshot_dir,
             const std::string& work_dir) override {
     csr_.open(name, snapshot_dir, work_dir);
@@ -608,18 +806,42 @@ class MutableCsr<std::string_view>
     csr_.open_in_memory(prefix, v_cap);
   }
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
+    csr_.open_with_hugepages(prefix, v_cap);
+  }
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {
     csr_.dump(name, new_snapshot_dir);
   }
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    csr_.batch_sort_by_neighbor(ts);
+  }
+
+  size_t unsorted_vertex_num() const override {
+    return csr_.unsorted_vertex_num();
+  }
+
+  void batch_freeze() override { csr_.batch_freeze(); }
+
+  bool has_unfrozen_writes() const override {
+    return csr_.has_unfrozen_writes();
+  }
+
+  inline bool is_frozen(vid_t v) const { return csr_.is_frozen(v); }
+  inline void prefetch_adj_list(vid_t v) const { csr_.prefetch_adj_list(v); }
+  inline void prefetch_edges(vid_t v) const { csr_.prefetch_edges(v); }
+
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<std::string_view>>(
@@ -685,6 +907,15 @@ class MutableCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
     csr_.batch_put_edge(src, dst, data, ts);
   }
 
+  void batch_reserve(const std::vector<int>& degree) override {
+    csr_.batch_reserve(degree);
+  }
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
   void open(const std::string& name, const std::string& snapshot_dir,
             const std::string& work_dir) override {
     csr_.open(name, snapshot_dir, work_dir);
@@ -694,18 +925,42 @@ class MutableCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
     csr_.open_in_memory(prefix, v_cap);
   }
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
+    csr_.open_with_hugepages(prefix, v_cap);
+  }
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {
     csr_.dump(name, new_snapshot_dir);
   }
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {
+    csr_.batch_sort_by_neighbor(ts);
+  }
+
+  size_t unsorted_vertex_num() const override {
+    return csr_.unsorted_vertex_num();
+  }
+
+  void batch_freeze() override { csr_.batch_freeze(); }
+
+  bool has_unfrozen_writes() const override {
+    return csr_.has_unfrozen_writes();
+  }
+
+  inline bool is_frozen(vid_t v) const { return csr_.is_frozen(v); }
+  inline void prefetch_adj_list(vid_t v) const { csr_.prefetch_adj_list(v); }
+  inline void prefetch_edges(vid_t v) const { csr_.prefetch_edges(v); }
+
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<RecordView>>(get_edges(v));
@@ -787,6 +1042,31 @@ class SingleMutableCsr : public TypedMutableCsrBase<EDATA_T> {
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    size_t vnum = nbr_list_.size();
+    CHECK_LE(vertex_map.size(), vnum);
+    mmap_array<nbr_t> new_nbr_list;
+    new_nbr_list.open("", false);
+    new_nbr_list.resize(vnum);
+    for (size_t k = 0; k != vnum; ++k) {
+      new_nbr_list[k].timestamp.store(std::numeric_limits<timestamp_t>::max());
+    }
+    for (size_t i = 0; i < vertex_map.size(); ++i) {
+      const auto& nbr = nbr_list_[i];
+      if (nbr.timestamp.load() != std::numeric_limits<timestamp_t>::max()) {
+        auto& new_nbr = new_nbr_list[vertex_map[i]];
+        new_nbr = nbr;
+        new_nbr.neighbor = nbr_map[nbr.neighbor];
+      }
+    }
+    nbr_list_.swap(new_nbr_list);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -888,6 +1168,8 @@ class SingleMutableCsr : public TypedMutableCsrBase<EDATA_T> {
     }
   }
 
+  void reserve(vid_t vnum) override { nbr_list_.reserve(vnum); }
+
   size_t size() const override { return nbr_list_.size(); }
 
   size_t edge_num() const override {
@@ -901,6 +1183,10 @@ class SingleMutableCsr : public TypedMutableCsrBase<EDATA_T> {
     return cnt;
   }
 
+  MemoryUsage memory_usage() const override {
+    return nbr_list_.memory_usage();
+  }
+
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<EDATA_T>>(get_edges(v));
   }
@@ -981,6 +1267,15 @@ class SingleMutableCsr<std::string_view>
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -994,6 +1289,10 @@ class SingleMutableCsr<std::string_view>
     csr_.open_in_memory(prefix, v_cap);
   }
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
+    csr_.open_with_hugepages(prefix, v_cap);
+  }
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {
     csr_.dump(name, new_snapshot_dir);
@@ -1002,10 +1301,12 @@ class SingleMutableCsr<std::string_view>
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<std::string_view>>(
@@ -1085,6 +1386,15 @@ class SingleMutableCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {
+    csr_.batch_relabel(vertex_map, nbr_map);
+  }
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -1098,6 +1408,10 @@ class SingleMutableCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
     csr_.open_in_memory(prefix, v_cap);
   }
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {
+    csr_.open_with_hugepages(prefix, v_cap);
+  }
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {
     csr_.dump(name, new_snapshot_dir);
@@ -1106,10 +1420,12 @@ class SingleMutableCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
   void warmup(int thread_num) const override { csr_.warmup(thread_num); }
 
   void resize(vid_t vnum) override { csr_.resize(vnum); }
+  void reserve(vid_t vnum) override { csr_.reserve(vnum); }
 
   size_t size() const override { return csr_.size(); }
 
   size_t edge_num() const override { return csr_.edge_num(); }
+  MemoryUsage memory_usage() const override { return csr_.memory_usage(); }
 
   std::shared_ptr<CsrConstEdgeIterBase> edge_iter(vid_t v) const override {
     return std::make_shared<MutableCsrConstEdgeIter<RecordView>>(get_edges(v));
@@ -1223,6 +1539,13 @@ class EmptyCsr : public TypedMutableCsrBase<EDATA_T> {
 
   void batch_sort_by_edge_data(timestamp_t ts) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {}
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   timestamp_t unsorted_since() const override {
     return std::numeric_limits<timestamp_t>::max();
   }
@@ -1256,9 +1579,18 @@ class EmptyCsr<std::string_view>
 
   void open_in_memory(const std::string& prefix, size_t v_cap) override {}
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {}
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {}
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   void warmup(int thread_num) const override {}
 
   void resize(vid_t vnum) override {}
@@ -1317,9 +1649,18 @@ class EmptyCsr<RecordView> : public TypedMutableCsrBase<RecordView> {
 
   void open_in_memory(const std::string& prefix, size_t v_cap) override {}
 
+  void open_with_hugepages(const std::string& prefix, size_t v_cap) override {}
+
   void dump(const std::string& name,
             const std::string& new_snapshot_dir) override {}
 
+  void batch_sort_by_neighbor(timestamp_t ts) override {}
+
+  void batch_relabel(const std::vector<vid_t>& vertex_map,
+                     const std::vector<vid_t>& nbr_map) override {}
+
+  size_t unsorted_vertex_num() const override { return 0; }
+
   void warmup(int thread_num) const override {}
 
   void resize(vid_t vnum) override {}
@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include <grape/serialization/in_archive.h>
+#include "flex/storages/rt_mutable_graph/csr/compressed_csr.h"
 #include "flex/storages/rt_mutable_graph/csr/immutable_csr.h"
 #include "flex/storages/rt_mutable_graph/csr/mutable_csr.h"
 #include "flex/utils/allocators.h"
@@ -26,6 +27,14 @@
 
 namespace gs {
 
+inline size_t degree_sum(const std::vector<int>& degree) {
+  size_t sum = 0;
+  for (auto d : degree) {
+    sum += d;
+  }
+  return sum;
+}
+
 class DualCsrBase {
  public:
   DualCsrBase() = default;
@@ -63,8 +72,34 @@ class DualCsrBase {
   virtual void IngestEdge(vid_t src, vid_t dst, grape::OutArchive& oarc,
                           timestamp_t timestamp, Allocator& alloc) = 0;
 
+  // Consumes the edge data IngestEdge would read from oarc.
+  virtual void SkipEdgeData(grape::OutArchive& oarc) const = 0;
+
   virtual void SortByEdgeData(timestamp_t ts) = 0;
 
+  void SortByNeighbor(timestamp_t ts) {
+    GetInCsr()->batch_sort_by_neighbor(ts);
+    GetOutCsr()->batch_sort_by_neighbor(ts);
+  }
+
+  // Number of vertices the next SortByEdgeData or SortByNeighbor has to
+  // visit, zero if nothing was written since the last sort.
+  size_t UnsortedVertexNum() const {
+    return GetInCsr()->unsorted_vertex_num() +
+           GetOutCsr()->unsorted_vertex_num();
+  }
+
+  // See CsrBase::batch_freeze.
+  void Freeze() {
+    GetInCsr()->batch_freeze();
+    GetOutCsr()->batch_freeze();
+  }
+
+  bool HasUnfrozenWrites() const {
+    return GetInCsr()->has_unfrozen_writes() ||
+           GetOutCsr()->has_unfrozen_writes();
+  }
+
   virtual void UpdateEdge(vid_t src, vid_t dst, const Any& oarc,
                           timestamp_t timestamp, Allocator& alloc) = 0;
 
@@ -73,6 +108,23 @@ class DualCsrBase {
     GetOutCsr()->resize(src_vertex_num);
   }
 
+  // Reserves the address space of the given numbers of vertices, so that
+  // Resize up to them keeps the adjacency lists in place for concurrent
+  // readers.
+  void Reserve(vid_t src_vertex_num, vid_t dst_vertex_num) {
+    GetInCsr()->reserve(dst_vertex_num);
+    GetOutCsr()->reserve(src_vertex_num);
+  }
+
+  // Makes room for the given numbers of outgoing and incoming edges per
+  // vertex, see CsrBase::batch_reserve. Used to append edges in bulk to an
+  // opened graph.
+  virtual void BatchReserve(const std::vector<int>& oe_degree,
+                            const std::vector<int>& ie_degree) {
+    GetInCsr()->batch_reserve(ie_degree);
+    GetOutCsr()->batch_reserve(oe_degree);
+  }
+
   void Warmup(int thread_num) {
     GetInCsr()->warmup(thread_num);
     GetOutCsr()->warmup(thread_num);
@@ -90,6 +142,12 @@ class DualCsrBase {
     }
   }
 
+  // Memory used by the edge properties kept beside the csrs, i.e. the string
+  // column or the table the neighbors refer to by index.
+  virtual MemoryUsage EdgeDataMemoryUsage() const { return MemoryUsage(); }
+  // Touches the properties stored aside from the csrs, if any.
+  virtual void WarmupEdgeData() const {}
+
   virtual CsrBase* GetInCsr() = 0;
   virtual CsrBase* GetOutCsr() = 0;
   virtual const CsrBase* GetInCsr() const = 0;
@@ -101,13 +159,17 @@ template <typename EDATA_T>
 class DualCsr : public DualCsrBase {
  public:
   DualCsr(EdgeStrategy oe_strategy, EdgeStrategy ie_strategy, bool oe_mutable,
-          bool ie_mutable)
+          bool ie_mutable,
+          EdgeCompression oe_compression = EdgeCompression::kNone,
+          EdgeCompression ie_compression = EdgeCompression::kNone)
       : in_csr_(nullptr), out_csr_(nullptr) {
     if (ie_strategy == EdgeStrategy::kNone) {
       in_csr_ = new EmptyCsr<EDATA_T>();
     } else if (ie_strategy == EdgeStrategy::kMultiple) {
       if (ie_mutable) {
         in_csr_ = new MutableCsr<EDATA_T>();
+      } else if (ie_compression == EdgeCompression::kDeltaVarint) {
+        in_csr_ = new CompressedImmutableCsr<EDATA_T>();
       } else {
         in_csr_ = new ImmutableCsr<EDATA_T>();
       }
@@ -123,6 +185,8 @@ class DualCsr : public DualCsrBase {
     } else if (oe_strategy == EdgeStrategy::kMultiple) {
       if (oe_mutable) {
         out_csr_ = new MutableCsr<EDATA_T>();
+      } else if (oe_compression == EdgeCompression::kDeltaVarint) {
+        out_csr_ = new CompressedImmutableCsr<EDATA_T>();
       } else {
         out_csr_ = new ImmutableCsr<EDATA_T>();
       }
@@ -202,6 +266,11 @@ class DualCsr : public DualCsrBase {
     out_csr_->put_edge(src, dst, data, ts, alloc);
   }
 
+  void SkipEdgeData(grape::OutArchive& oarc) const override {
+    EDATA_T data;
+    oarc >> data;
+  }
+
   void SortByEdgeData(timestamp_t ts) override {
     in_csr_->batch_sort_by_edge_data(ts);
     out_csr_->batch_sort_by_edge_data(ts);
@@ -241,6 +310,15 @@ class DualCsr : public DualCsrBase {
     out_csr_->batch_put_edge(src, dst, data);
   }
 
+  // Same as BatchPutEdge, for one direction at a time.
+  void BatchPutOutEdge(vid_t src, vid_t dst, const EDATA_T& data) {
+    out_csr_->batch_put_edge(src, dst, data);
+  }
+
+  void BatchPutInEdge(vid_t src, vid_t dst, const EDATA_T& data) {
+    in_csr_->batch_put_edge(dst, src, data);
+  }
+
   void Close() override {
     in_csr_->close();
     out_csr_->close();
@@ -345,7 +423,11 @@ class DualCsr<std::string_view> : public DualCsrBase {
                          const std::string& edata_name,
                          const std::string& snapshot_dir, size_t src_vertex_cap,
                          size_t dst_vertex_cap) override {
-    LOG(FATAL) << "not supported...";
+    in_csr_->open_with_hugepages(snapshot_dir + "/" + ie_name, dst_vertex_cap);
+    out_csr_->open_with_hugepages(snapshot_dir + "/" + oe_name, src_vertex_cap);
+    column_.open_with_hugepages(snapshot_dir + "/" + edata_name, true);
+    column_idx_.store(column_.size());
+    column_.resize(std::max(column_.size() + (column_.size() + 4) / 5, 4096ul));
   }
 
   void Dump(const std::string& oe_name, const std::string& ie_name,
@@ -363,6 +445,12 @@ class DualCsr<std::string_view> : public DualCsrBase {
   const CsrBase* GetInCsr() const override { return in_csr_; }
   const CsrBase* GetOutCsr() const override { return out_csr_; }
 
+  MemoryUsage EdgeDataMemoryUsage() const override {
+    return column_.memory_usage();
+  }
+
+  void WarmupEdgeData() const override { column_.warmup(); }
+
   void IngestEdge(vid_t src, vid_t dst, grape::OutArchive& oarc, timestamp_t ts,
                   Allocator& alloc) override {
     std::string_view prop;
@@ -373,6 +461,11 @@ class DualCsr<std::string_view> : public DualCsrBase {
     out_csr_->put_edge_with_index(src, dst, row_id, ts, alloc);
   }
 
+  void SkipEdgeData(grape::OutArchive& oarc) const override {
+    std::string_view prop;
+    oarc >> prop;
+  }
+
   void SortByEdgeData(timestamp_t ts) override {
     LOG(FATAL) << "Not implemented";
   }
@@ -411,16 +504,28 @@ class DualCsr<std::string_view> : public DualCsrBase {
     }
   }
 
+  void BatchReserve(const std::vector<int>& oe_degree,
+                    const std::vector<int>& ie_degree) override {
+    DualCsrBase::BatchReserve(oe_degree, ie_degree);
+    size_t row_num = column_idx_.load() + std::max(degree_sum(oe_degree),
+                                                   degree_sum(ie_degree));
+    if (row_num > column_.size()) {
+      column_.resize(row_num);
+    }
+  }
+
+  // The rows are reserved without the data of the values, which the column
+  // grows as they are set.
   void BatchPutEdge(vid_t src, vid_t dst, const std::string_view& data) {
     size_t row_id = column_idx_.fetch_add(1);
-    column_.set_value(row_id, data);
+    column_.set_value_safe(row_id, data);
     in_csr_->batch_put_edge_with_index(dst, src, row_id);
     out_csr_->batch_put_edge_with_index(src, dst, row_id);
   }
 
   void BatchPutEdge(vid_t src, vid_t dst, const std::string& data) {
     size_t row_id = column_idx_.fetch_add(1);
-    column_.set_value(row_id, data);
+    column_.set_value_safe(row_id, data);
 
     in_csr_->batch_put_edge_with_index(dst, src, row_id);
     out_csr_->batch_put_edge_with_index(src, dst, row_id);
@@ -551,7 +656,14 @@ class DualCsr<RecordView> : public DualCsrBase {
                          const std::string& edata_name,
                          const std::string& snapshot_dir, size_t src_vertex_cap,
                          size_t dst_vertex_cap) override {
-    LOG(FATAL) << "not supported...";
+    in_csr_->open_with_hugepages(snapshot_dir + "/" + ie_name, dst_vertex_cap);
+    out_csr_->open_with_hugepages(snapshot_dir + "/" + oe_name, src_vertex_cap);
+    // fix me: storage_strategies_ is not used
+    table_.open_with_hugepages(edata_name, snapshot_dir, col_name_,
+                               property_types_, {}, true);
+    table_idx_.store(table_.row_num());
+    table_.resize(
+        std::max(table_.row_num() + (table_.row_num() + 4) / 5, 4096ul));
   }
 
   void Dump(const std::string& oe_name, const std::string& ie_name,
@@ -568,11 +680,51 @@ class DualCsr<RecordView> : public DualCsrBase {
   const CsrBase* GetInCsr() const override { return in_csr_; }
   const CsrBase* GetOutCsr() const override { return out_csr_; }
 
+  MemoryUsage EdgeDataMemoryUsage() const override {
+    return table_.memory_usage();
+  }
+
+  void WarmupEdgeData() const override { table_.warmup(); }
+
   void BatchPutEdge(vid_t src, vid_t dst, size_t row_id) {
     in_csr_->batch_put_edge_with_index(dst, src, row_id);
     out_csr_->batch_put_edge_with_index(src, dst, row_id);
   }
 
+  void BatchPutOutEdge(vid_t src, vid_t dst, size_t row_id) {
+    out_csr_->batch_put_edge_with_index(src, dst, row_id);
+  }
+
+  void BatchPutInEdge(vid_t src, vid_t dst, size_t row_id) {
+    in_csr_->batch_put_edge_with_index(dst, src, row_id);
+  }
+
+  void BatchReserve(const std::vector<int>& oe_degree,
+                    const std::vector<int>& ie_degree) override {
+    DualCsrBase::BatchReserve(oe_degree, ie_degree);
+    size_t row_num = table_idx_.load() + std::max(degree_sum(oe_degree),
+                                                  degree_sum(ie_degree));
+    if (row_num > table_.row_num()) {
+      table_.resize(row_num);
+    }
+  }
+
+  // Copies the first row_num rows of table after the edge data, and returns
+  // the row id of the first copy. The appended edges refer to the rows from
+  // there on.
+  size_t AppendRows(const Table& table, size_t row_num) {
+    size_t begin = table_idx_.fetch_add(row_num);
+    if (begin + row_num > table_.row_num()) {
+      table_.resize(begin + row_num);
+    }
+    for (size_t col = 0; col < table.col_num(); ++col) {
+      copy_column_rows(*table.get_column_by_id(col), row_num,
+                       *table_.get_column_by_id(col),
+                       [begin](size_t i) { return begin + i; });
+    }
+    return begin;
+  }
+
   Table& GetTable() { return table_; }
 
   const Table& GetTable() const { return table_; }
@@ -586,6 +738,12 @@ class DualCsr<RecordView> : public DualCsrBase {
     out_csr_->put_edge_with_index(src, dst, row_id, ts, alloc);
   }
 
+  void SkipEdgeData(grape::OutArchive& oarc) const override {
+    size_t len;
+    oarc >> len;
+    table_.skip(oarc);
+  }
+
   void SortByEdgeData(timestamp_t ts) override {
     LOG(FATAL) << "Not implemented";
   }
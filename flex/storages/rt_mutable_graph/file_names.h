@@ -51,6 +51,7 @@ namespace gs {
     │   │   ├── ie_PERSON_KNOWS_PERSON.nbr 
     │   │   ├── oe_PERSON_KNOWS_PERSON.deg 
     │   │   ├── oe_PERSON_KNOWS_PERSON.nbr 
+    │   │   ├── vertex_map_PERSON.fingerprints 
     │   │   ├── vertex_map_PERSON.indices 
     │   │   ├── vertex_map_PERSON.keys 
     │   │   ├── vertex_map_PERSON.meta 
@@ -62,6 +63,7 @@ namespace gs {
     │   │   ├── ie_PERSON_KNOWS_PERSON.nbr
     │   │   ├── oe_PERSON_KNOWS_PERSON.deg
     │   │   ├── oe_PERSON_KNOWS_PERSON.nbr
+    │   │   ├── vertex_map_PERSON.fingerprints
     │   │   ├── vertex_map_PERSON.indices
     │   │   ├── vertex_map_PERSON.keys
     │   │   ├── vertex_map_PERSON.meta
@@ -193,6 +195,43 @@ inline std::string snapshot_dir(const std::string& work_dir, uint32_t version) {
   return snapshots_dir(work_dir) + std::to_string(version) + "/";
 }
 
+// Lists the name, size and checksum of every file of a snapshot.
+inline std::string snapshot_manifest_path(const std::string& snapshot_dir) {
+  return snapshot_dir + "/MANIFEST";
+}
+
+// The schema a snapshot was dumped with, absent if it was dumped before
+// vertex properties could change online, in which case the one of the work
+// directory holds.
+inline std::string snapshot_schema_path(const std::string& snapshot_dir) {
+  return snapshot_dir + "/schema";
+}
+
+// The latest timestamp whose wal a snapshot covers, absent if it was not
+// taken by GraphDB::CreateSnapshot.
+inline std::string snapshot_wal_ts_path(const std::string& snapshot_dir) {
+  return snapshot_dir + "/WAL_TS";
+}
+
+inline uint32_t get_snapshot_wal_ts(const std::string& snapshot_dir) {
+  uint32_t ts = 0;
+  FILE* fin = fopen(snapshot_wal_ts_path(snapshot_dir).c_str(), "rb");
+  if (fin != nullptr) {
+    CHECK_EQ(fread(&ts, sizeof(uint32_t), 1, fin), 1);
+    fclose(fin);
+  }
+  return ts;
+}
+
+inline void set_snapshot_wal_ts(const std::string& snapshot_dir,
+                                uint32_t ts) {
+  FILE* fout = fopen(snapshot_wal_ts_path(snapshot_dir).c_str(), "wb");
+  CHECK(fout != nullptr);
+  CHECK_EQ(fwrite(&ts, sizeof(uint32_t), 1, fout), 1);
+  fflush(fout);
+  fclose(fout);
+}
+
 inline std::string wal_dir(const std::string& work_dir) {
   return work_dir + "/wal/";
 }
@@ -257,6 +296,26 @@ inline std::string vertex_table_prefix(const std::string& label) {
   return "vertex_table_" + label;
 }
 
+inline std::string secondary_index_prefix(const std::string& label,
+                                          const std::string& prop) {
+  return "secondary_index_" + label + "_" + prop;
+}
+
+inline std::string range_index_prefix(const std::string& label,
+                                      const std::string& prop) {
+  return "range_index_" + label + "_" + prop;
+}
+
+inline std::string vector_index_prefix(const std::string& label,
+                                       const std::string& prop) {
+  return "vector_index_" + label + "_" + prop;
+}
+
+inline std::string text_index_prefix(const std::string& label,
+                                     const std::string& prop) {
+  return "text_index_" + label + "_" + prop;
+}
+
 inline std::string thread_local_allocator_prefix(const std::string& work_dir,
                                                  int thread_id) {
   return allocator_dir(work_dir) + "allocator_" + std::to_string(thread_id) +
@@ -45,9 +45,19 @@ void set_column_from_string_array(gs::ColumnBase* col,
   auto type = array->type();
   auto size = col->size();
   auto typed_col = dynamic_cast<gs::TypedColumn<std::string_view>*>(col);
+  auto compressed_col = dynamic_cast<gs::CompressedStringColumn*>(col);
   if (enable_resize) {
-    CHECK(typed_col != nullptr) << "Only support TypedColumn<std::string_view>";
+    CHECK(typed_col != nullptr || compressed_col != nullptr)
+        << "Only support TypedColumn<std::string_view> and "
+           "CompressedStringColumn";
   }
+  auto set_value_safe = [&](size_t idx, const std::string_view& sw) {
+    if (typed_col != nullptr) {
+      typed_col->set_value_safe(idx, sw);
+    } else {
+      compressed_col->set_value_safe(idx, sw);
+    }
+  };
   CHECK(type->Equals(arrow::large_utf8()) || type->Equals(arrow::utf8()))
       << "Inconsistent data type, expect string, but got " << type->ToString();
   size_t cur_ind = 0;
@@ -70,7 +80,7 @@ void set_column_from_string_array(gs::ColumnBase* col,
           if (!enable_resize) {
             col->set_any(offset[cur_ind++], std::move(sw));
           } else {
-            typed_col->set_value_safe(offset[cur_ind++], std::move(sw));
+            set_value_safe(offset[cur_ind++], sw);
           }
         }
       }
@@ -88,7 +98,7 @@ void set_column_from_string_array(gs::ColumnBase* col,
           if (!enable_resize) {
             col->set_any(offset[cur_ind++], std::move(sw));
           } else {
-            typed_col->set_value_safe(offset[cur_ind++], std::move(sw));
+            set_value_safe(offset[cur_ind++], sw);
           }
         }
       }
@@ -286,9 +296,15 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
       src_label_name, dst_label_name, edge_label_name);
   bool ie_mutable = schema_.incoming_edge_mutable(
       src_label_name, dst_label_name, edge_label_name);
+  EdgeCompression oe_compression = schema_.get_outgoing_edge_compression(
+      src_label_name, dst_label_name, edge_label_name);
+  EdgeCompression ie_compression = schema_.get_incoming_edge_compression(
+      src_label_name, dst_label_name, edge_label_name);
   if (col_num == 0) {
-    auto dual_csr = new DualCsr<grape::EmptyType>(oe_strategy, ie_strategy,
-                                                  oe_mutable, ie_mutable);
+    auto dual_csr =
+        new DualCsr<grape::EmptyType>(oe_strategy, ie_strategy, oe_mutable,
+                                      ie_mutable, oe_compression,
+                                      ie_compression);
     basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                    dual_csr);
     if (filenames.empty()) {
@@ -301,7 +317,8 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
   } else if (col_num == 1) {
     if (property_types[0] == PropertyType::kBool) {
       auto dual_csr =
-          new DualCsr<bool>(oe_strategy, ie_strategy, oe_mutable, ie_mutable);
+          new DualCsr<bool>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                            oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
       if (filenames.empty()) {
@@ -313,7 +330,8 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
       }
     } else if (property_types[0] == PropertyType::kDate) {
       auto dual_csr =
-          new DualCsr<Date>(oe_strategy, ie_strategy, oe_mutable, ie_mutable);
+          new DualCsr<Date>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                            oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
@@ -325,8 +343,9 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
                                       filenames, supplier_creator);
       }
     } else if (property_types[0] == PropertyType::kInt32) {
-      auto dual_csr = new DualCsr<int32_t>(oe_strategy, ie_strategy, oe_mutable,
-                                           ie_mutable);
+      auto dual_csr =
+          new DualCsr<int32_t>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                               oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
@@ -338,8 +357,9 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
                                          filenames, supplier_creator);
       }
     } else if (property_types[0] == PropertyType::kUInt32) {
-      auto dual_csr = new DualCsr<uint32_t>(oe_strategy, ie_strategy,
-                                            oe_mutable, ie_mutable);
+      auto dual_csr =
+          new DualCsr<uint32_t>(oe_strategy, ie_strategy, oe_mutable,
+                                ie_mutable, oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
@@ -352,8 +372,9 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
                                           supplier_creator);
       }
     } else if (property_types[0] == PropertyType::kInt64) {
-      auto dual_csr = new DualCsr<int64_t>(oe_strategy, ie_strategy, oe_mutable,
-                                           ie_mutable);
+      auto dual_csr =
+          new DualCsr<int64_t>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                               oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
@@ -365,8 +386,9 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
                                          filenames, supplier_creator);
       }
     } else if (property_types[0] == PropertyType::kUInt64) {
-      auto dual_csr = new DualCsr<uint64_t>(oe_strategy, ie_strategy,
-                                            oe_mutable, ie_mutable);
+      auto dual_csr =
+          new DualCsr<uint64_t>(oe_strategy, ie_strategy, oe_mutable,
+                                ie_mutable, oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
@@ -380,7 +402,8 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
       }
     } else if (property_types[0] == PropertyType::kDouble) {
       auto dual_csr =
-          new DualCsr<double>(oe_strategy, ie_strategy, oe_mutable, ie_mutable);
+          new DualCsr<double>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                              oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
       if (filenames.empty()) {
@@ -392,7 +415,8 @@ void AbstractArrowFragmentLoader::AddEdgesRecordBatch(
       }
     } else if (property_types[0] == PropertyType::kFloat) {
       auto dual_csr =
-          new DualCsr<float>(oe_strategy, ie_strategy, oe_mutable, ie_mutable);
+          new DualCsr<float>(oe_strategy, ie_strategy, oe_mutable, ie_mutable,
+                             oe_compression, ie_compression);
       basic_fragment_loader_.set_csr(src_label_i, dst_label_i, edge_label_i,
                                      dual_csr);
 
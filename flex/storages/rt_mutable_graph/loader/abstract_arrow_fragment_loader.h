@@ -345,7 +345,10 @@ class AbstractArrowFragmentLoader : public IFragmentLoader {
         thread_num_(loading_config_.GetParallelism()),
         build_csr_in_mem_(loading_config_.GetBuildCsrInMem()),
         use_mmap_vector_(loading_config_.GetUseMmapVector()),
-        basic_fragment_loader_(schema_, work_dir) {
+        basic_fragment_loader_(
+            schema_, work_dir,
+            loading_config_.GetMethod() == BulkLoadMethod::kAppend,
+            loading_config_.GetVertexOrder()) {
     vertex_label_num_ = schema_.vertex_label_num();
     edge_label_num_ = schema_.edge_label_num();
     mtxs_ = new std::mutex[vertex_label_num_];
@@ -357,6 +360,11 @@ class AbstractArrowFragmentLoader : public IFragmentLoader {
     }
   }
 
+  void SetSnapshotUploader(
+      std::shared_ptr<SnapshotUploader> uploader) override {
+    basic_fragment_loader_.SetSnapshotUploader(std::move(uploader));
+  }
+
   void AddVerticesRecordBatch(
       label_t v_label_id, const std::vector<std::string>& input_paths,
       std::function<std::vector<std::shared_ptr<IRecordBatchSupplier>>(
@@ -695,6 +703,7 @@ class AbstractArrowFragmentLoader : public IFragmentLoader {
     auto label_name = schema_.get_vertex_label_name(v_label_id);
 
     v_data.resize(indexer.size());
+    v_data.encode_dictionary();
     v_data.dump(vertex_table_prefix(label_name),
                 snapshot_dir(basic_fragment_loader_.work_dir(), 0));
 
@@ -768,6 +777,58 @@ class AbstractArrowFragmentLoader : public IFragmentLoader {
     }
   }
 
+  // Whether each vertex of the indexer is owned by the shard being loaded.
+  std::vector<uint8_t> localVertices(const IndexerType& indexer) const {
+    const auto& partitioner = loading_config_.GetPartitioner();
+    std::vector<uint8_t> local(indexer.size());
+    for (size_t v = 0; v < local.size(); ++v) {
+      local[v] = partitioner.IsLocal(indexer.get_key(v));
+    }
+    return local;
+  }
+
+  // When loading a shard of a partitioned graph, every vertex stays in the
+  // indexers, so that the cut edges, with one endpoint on another shard,
+  // are kept as the mirror adjacency of their local endpoint, and drops the
+  // edges between two vertices of other shards.
+  template <typename VECTOR_T>
+  void dropRemoteEdges(const IndexerType& src_indexer,
+                       const IndexerType& dst_indexer,
+                       std::vector<VECTOR_T>& parsed_edges_vec,
+                       std::vector<std::atomic<int32_t>>& ie_degree,
+                       std::vector<std::atomic<int32_t>>& oe_degree) {
+    static constexpr auto invalid_vid = std::numeric_limits<vid_t>::max();
+    auto src_local = localVertices(src_indexer);
+    auto dst_local = &src_indexer == &dst_indexer
+                         ? src_local
+                         : localVertices(dst_indexer);
+    std::atomic<size_t> dropped(0);
+    std::vector<std::thread> work_threads;
+    for (size_t i = 0; i < parsed_edges_vec.size(); ++i) {
+      work_threads.emplace_back(
+          [&](int idx) {
+            for (auto& edge : parsed_edges_vec[idx]) {
+              auto src = std::get<0>(edge);
+              auto dst = std::get<1>(edge);
+              if (src == invalid_vid || dst == invalid_vid ||
+                  src_local[src] || dst_local[dst]) {
+                continue;
+              }
+              oe_degree[src]--;
+              ie_degree[dst]--;
+              std::get<0>(edge) = invalid_vid;
+              std::get<1>(edge) = invalid_vid;
+              dropped++;
+            }
+          },
+          i);
+    }
+    for (auto& t : work_threads) {
+      t.join();
+    }
+    VLOG(10) << "Drop " << dropped.load() << " edges of other partitions";
+  }
+
   template <typename EDATA_T, typename VECTOR_T>
   void addEdgesRecordBatchImplHelper(
       label_t src_label_id, label_t dst_label_id, label_t e_label_id,
@@ -1001,6 +1062,10 @@ class AbstractArrowFragmentLoader : public IFragmentLoader {
     VLOG(10) << "Finish parsing edge file:" << e_files.size() << " for label "
              << src_label_name << " -> " << dst_label_name << " -> "
              << edge_label_name;
+    if (!loading_config_.GetPartitioner().trivial()) {
+      dropRemoteEdges(src_indexer, dst_indexer, parsed_edges_vec, ie_degree,
+                      oe_degree);
+    }
     std::vector<int32_t> ie_deg(ie_degree.size());
     std::vector<int32_t> oe_deg(oe_degree.size());
     for (size_t idx = 0; idx < ie_deg.size(); ++idx) {
@@ -16,6 +16,7 @@
 
 #include "flex/storages/rt_mutable_graph/loader/basic_fragment_loader.h"
 #include "flex/storages/rt_mutable_graph/file_names.h"
+#include "flex/storages/rt_mutable_graph/loader/vertex_order.h"
 
 namespace gs {
 
@@ -48,9 +49,14 @@ std::istream& operator>>(std::istream& is, LoadingStatus& status) {
 }
 
 BasicFragmentLoader::BasicFragmentLoader(const Schema& schema,
-                                         const std::string& prefix)
+                                         const std::string& prefix,
+                                         bool append,
+                                         VertexOrder vertex_order)
     : schema_(schema),
       work_dir_(prefix),
+      append_(append),
+      vertex_order_(vertex_order),
+      base_version_(0),
       vertex_label_num_(schema_.vertex_label_num()),
       edge_label_num_(schema_.edge_label_num()) {
   vertex_data_.resize(vertex_label_num_);
@@ -64,11 +70,32 @@ BasicFragmentLoader::BasicFragmentLoader(const Schema& schema,
   std::filesystem::create_directories(wal_dir(prefix));
   std::filesystem::create_directories(tmp_dir(prefix));
 
+  if (append_) {
+    open_base();
+  }
   init_vertex_data();
   // initially create all status files for vertices and edges.
   init_loading_status_file();
 }
 
+void BasicFragmentLoader::open_base() {
+#ifdef USE_PTHASH
+  LOG(FATAL) << "Appending to a graph is not supported with pthash indexers";
+#endif
+  if (!std::filesystem::exists(schema_path(work_dir_))) {
+    LOG(FATAL) << "No graph to append to in " << work_dir_;
+  }
+  base_version_ = get_snapshot_version(work_dir_);
+  base_.Open(work_dir_, 1);
+  // The columns are appended to by position, as loaded for schema_.
+  base_.compactVertexProperties();
+  if (!base_.schema().Equals(schema_)) {
+    LOG(FATAL) << "The schema of the graph in " << work_dir_
+               << " is not the one to append with";
+  }
+  VLOG(1) << "Appending to snapshot " << base_version_ << " of " << work_dir_;
+}
+
 void BasicFragmentLoader::append_vertex_loading_progress(
     const std::string& label_name, LoadingStatus status) {
   auto status_file_path = bulk_load_progress_file(work_dir_);
@@ -133,6 +160,14 @@ void BasicFragmentLoader::init_vertex_data() {
 }
 
 void BasicFragmentLoader::LoadFragment() {
+  if (append_) {
+    reorder_vertices(base_);
+    // The files of the previous snapshot that did not change are shared
+    // with the new one, see MutablePropertyFragment::Dump.
+    base_.Dump(work_dir_, base_version_ + 1, uploader_.get());
+    clear_tmp(work_dir_);
+    return;
+  }
   std::string schema_filename = schema_path(work_dir_);
   auto io_adaptor = std::unique_ptr<grape::LocalIOAdaptor>(
       new grape::LocalIOAdaptor(schema_filename));
@@ -141,17 +176,61 @@ void BasicFragmentLoader::LoadFragment() {
   io_adaptor->Close();
 
   set_snapshot_version(work_dir_, 0);
+  if (vertex_order_ != VertexOrder::kInput) {
+    // Nothing refers to the ids of snapshot 0 yet, so it is replaced.
+    MutablePropertyFragment graph;
+    graph.Open(work_dir_, 1);
+    reorder_vertices(graph);
+    graph.Dump(work_dir_, 1, uploader_.get());
+    std::filesystem::remove_all(snapshot_dir(work_dir_, 0));
+  } else if (uploader_) {
+    // The VERSION file goes last, once the snapshot is complete remotely.
+    uploader_->EnqueueFiles(snapshot_dir(work_dir_, 0));
+    uploader_->Enqueue(schema_filename);
+    auto status = uploader_->Wait();
+    if (status.ok()) {
+      uploader_->Enqueue(snapshot_version_path(work_dir_));
+      status = uploader_->Wait();
+    }
+    if (!status.ok()) {
+      std::string msg = "Failed to upload snapshot: " + status.ToString();
+      LOG(ERROR) << msg;
+      throw std::runtime_error(msg);
+    }
+  }
   clear_tmp(work_dir_);
 }
 
+void BasicFragmentLoader::upload_snapshot_files(
+    const std::vector<std::string>& prefixes) {
+  // Snapshot 0 is only kept when loading from scratch in the input order.
+  if (uploader_ == nullptr || append_ ||
+      vertex_order_ != VertexOrder::kInput) {
+    return;
+  }
+  uploader_->EnqueueFiles(snapshot_dir(work_dir_, 0), prefixes);
+}
+
+void BasicFragmentLoader::reorder_vertices(MutablePropertyFragment& graph) {
+  if (vertex_order_ == VertexOrder::kInput ||
+      !can_renumber_vertices(schema_)) {
+    return;
+  }
+  double t = -grape::GetCurrentTime();
+  auto new_ids = compute_vertex_order(graph, vertex_order_);
+  renumber_vertices(graph, new_ids);
+  t += grape::GetCurrentTime();
+  LOG(INFO) << "Renumbering vertices takes: " << t << " s";
+}
+
 const IndexerType& BasicFragmentLoader::GetLFIndexer(label_t v_label) const {
   CHECK(v_label < vertex_label_num_);
-  return lf_indexers_[v_label];
+  return append_ ? base_.lf_indexers_[v_label] : lf_indexers_[v_label];
 }
 
 IndexerType& BasicFragmentLoader::GetLFIndexer(label_t v_label) {
   CHECK(v_label < vertex_label_num_);
-  return lf_indexers_[v_label];
+  return append_ ? base_.lf_indexers_[v_label] : lf_indexers_[v_label];
 }
 
 void BasicFragmentLoader::set_csr(label_t src_label_id, label_t dst_label_id,
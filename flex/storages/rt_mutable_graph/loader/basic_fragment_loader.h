@@ -19,6 +19,8 @@
 #include "flex/storages/rt_mutable_graph/file_names.h"
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
 #include "flex/storages/rt_mutable_graph/schema.h"
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
+#include "flex/utils/radix_sort.h"
 
 namespace gs {
 
@@ -36,6 +38,29 @@ TypedMutableCsrBase<EDATA_T>* create_typed_csr(EdgeStrategy es,
   return nullptr;
 }
 
+// Splits [0, degree.size()) into at most part_num consecutive ranges with
+// about the same total degree. Returns the bounds of the ranges.
+inline std::vector<size_t> split_by_degree(const std::vector<int32_t>& degree,
+                                           size_t part_num) {
+  size_t total = 0;
+  for (auto d : degree) {
+    total += d;
+  }
+  std::vector<size_t> bounds{0};
+  size_t part = std::max<size_t>(total / std::max<size_t>(part_num, 1), 1);
+  size_t sum = 0;
+  for (size_t v = 0; v < degree.size(); ++v) {
+    sum += degree[v];
+    if (sum >= part * bounds.size() && bounds.size() < part_num) {
+      bounds.push_back(v + 1);
+    }
+  }
+  if (bounds.back() != degree.size()) {
+    bounds.push_back(degree.size());
+  }
+  return bounds;
+}
+
 enum class LoadingStatus {
   kLoading = 0,
   kLoaded = 1,
@@ -50,9 +75,22 @@ std::istream& operator>>(std::istream& is, LoadingStatus& status);
 
 // FragmentLoader should use this BasicFragmentLoader to construct
 // mutable_csr_fragment.
+//
+// When append is set, the current snapshot of the graph in prefix is opened
+// in memory instead. The vertices are still parsed into a fresh indexer and
+// table, and then merged into the ones of the graph. The edges are added to
+// the csrs of the graph after room was made for them, and the result is
+// dumped as the next snapshot, so that the graph is extended at bulk loading
+// speed without replaying the delta through transactions.
+//
+// Unless vertex_order is kInput, the vertices are renumbered in that order
+// once everything is loaded, see renumber_vertices, and the graph is written
+// as the next snapshot.
 class BasicFragmentLoader {
  public:
-  BasicFragmentLoader(const Schema& schema, const std::string& prefix);
+  BasicFragmentLoader(const Schema& schema, const std::string& prefix,
+                      bool append = false,
+                      VertexOrder vertex_order = VertexOrder::kInput);
 
   void LoadFragment();
 
@@ -68,6 +106,10 @@ class BasicFragmentLoader {
   void FinishAddingVertex(label_t v_label,
                           const IdIndexer<KEY_T, vid_t>& indexer) {
     CHECK(v_label < vertex_label_num_);
+    if (append_) {
+      appendVertices(v_label, indexer);
+      return;
+    }
     std::string filename =
         vertex_map_prefix(schema_.get_vertex_label_name(v_label));
     auto primary_keys = schema_.get_vertex_primary_key(v_label);
@@ -82,7 +124,10 @@ class BasicFragmentLoader {
     auto& v_data = vertex_data_[v_label];
     auto label_name = schema_.get_vertex_label_name(v_label);
     v_data.resize(lf_indexers_[v_label].size());
+    v_data.encode_dictionary();
     v_data.dump(vertex_table_prefix(label_name), snapshot_dir(work_dir_, 0));
+    upload_snapshot_files({LFIndexer<vid_t>::prefix() + "_" + filename,
+                           vertex_table_prefix(label_name)});
     append_vertex_loading_progress(label_name, LoadingStatus::kCommited);
   }
 #else
@@ -99,7 +144,10 @@ class BasicFragmentLoader {
     auto& v_data = vertex_data_[v_label];
     auto label_name = schema_.get_vertex_label_name(v_label);
     v_data.resize(lf_indexers_[v_label].size());
+    v_data.encode_dictionary();
     v_data.dump(vertex_table_prefix(label_name), snapshot_dir(work_dir_, 0));
+    // The loader fills and dumps the vertex table again afterwards.
+    upload_snapshot_files({PTIndexer<vid_t>::prefix() + "_" + filename});
     append_vertex_loading_progress(label_name, LoadingStatus::kCommited);
   }
 #endif
@@ -107,6 +155,10 @@ class BasicFragmentLoader {
   template <typename EDATA_T>
   void AddNoPropEdgeBatch(label_t src_label_id, label_t dst_label_id,
                           label_t edge_label_id) {
+    if (append_) {
+      // The edges of the graph are kept as they are.
+      return;
+    }
     size_t index = src_label_id * vertex_label_num_ * edge_label_num_ +
                    dst_label_id * edge_label_num_ + edge_label_id;
     CHECK(ie_[index] == NULL);
@@ -137,8 +189,13 @@ class BasicFragmentLoader {
           src_label_name, dst_label_name, edge_label_name);
       bool ie_mutable = schema_.incoming_edge_mutable(
           src_label_name, dst_label_name, edge_label_name);
-      dual_csr_list_[index] = new DualCsr<EDATA_T>(oe_strategy, ie_strategy,
-                                                   oe_mutable, ie_mutable);
+      EdgeCompression oe_compression = schema_.get_outgoing_edge_compression(
+          src_label_name, dst_label_name, edge_label_name);
+      EdgeCompression ie_compression = schema_.get_incoming_edge_compression(
+          src_label_name, dst_label_name, edge_label_name);
+      dual_csr_list_[index] =
+          new DualCsr<EDATA_T>(oe_strategy, ie_strategy, oe_mutable,
+                               ie_mutable, oe_compression, ie_compression);
     }
     ie_[index] = dual_csr_list_[index]->GetInCsr();
     oe_[index] = dual_csr_list_[index]->GetOutCsr();
@@ -163,9 +220,14 @@ class BasicFragmentLoader {
   }
   template <typename EDATA_T, typename VECTOR_T>
   void PutEdges(label_t src_label_id, label_t dst_label_id,
-                label_t edge_label_id, const std::vector<VECTOR_T>& edges_vec,
+                label_t edge_label_id, std::vector<VECTOR_T>& edges_vec,
                 const std::vector<int32_t>& ie_degree,
                 const std::vector<int32_t>& oe_degree, bool build_csr_in_mem) {
+    if (append_) {
+      appendEdges<EDATA_T, VECTOR_T>(src_label_id, dst_label_id, edge_label_id,
+                                     edges_vec, ie_degree, oe_degree);
+      return;
+    }
     size_t index = src_label_id * vertex_label_num_ * edge_label_num_ +
                    dst_label_id * edge_label_num_ + edge_label_id;
     auto dual_csr = dual_csr_list_[index];
@@ -221,12 +283,19 @@ class BasicFragmentLoader {
       if (schema_.get_sort_on_compaction(src_label_name, dst_label_name,
                                          edge_label_name)) {
         dual_csr->SortByEdgeData(1);
+      } else if (schema_.get_sort_by_neighbor(src_label_name, dst_label_name,
+                                              edge_label_name)) {
+        dual_csr->SortByNeighbor(1);
       }
       dual_csr->Dump(
           oe_prefix(src_label_name, dst_label_name, edge_label_name),
           ie_prefix(src_label_name, dst_label_name, edge_label_name),
           edata_prefix(src_label_name, dst_label_name, edge_label_name),
           snapshot_dir(work_dir_, 0));
+      upload_snapshot_files(
+          {oe_prefix(src_label_name, dst_label_name, edge_label_name),
+           ie_prefix(src_label_name, dst_label_name, edge_label_name),
+           edata_prefix(src_label_name, dst_label_name, edge_label_name)});
     } else {
       CHECK(ie_degree.size() == dst_indexer.size());
       CHECK(oe_degree.size() == src_indexer.size());
@@ -243,32 +312,19 @@ class BasicFragmentLoader {
             tmp_dir(work_dir_), oe_degree, ie_degree);
       }
 
-      std::vector<std::thread> work_threads;
-      for (size_t i = 0; i < edges_vec.size(); ++i) {
-        work_threads.emplace_back(
-            [&](int idx) {
-              edge_count.fetch_add(edges_vec[idx].size());
-              for (auto& edge : edges_vec[idx]) {
-                if (std::get<1>(edge) == INVALID_VID ||
-                    std::get<0>(edge) == INVALID_VID) {
-                  VLOG(10) << "Skip invalid edge:" << std::get<0>(edge) << "->"
-                           << std::get<1>(edge);
-                  continue;
-                }
-                casted_dual_csr->BatchPutEdge(
-                    std::get<0>(edge), std::get<1>(edge), std::get<2>(edge));
-              }
-            },
-            i);
-      }
-      for (auto& t : work_threads) {
-        t.join();
+      for (auto& edges : edges_vec) {
+        edge_count.fetch_add(edges.size());
       }
+      fill_direction(casted_dual_csr, edges_vec, oe_degree, true);
+      fill_direction(casted_dual_csr, edges_vec, ie_degree, false);
       append_edge_loading_progress(src_label_name, dst_label_name,
                                    edge_label_name, LoadingStatus::kLoaded);
       if (schema_.get_sort_on_compaction(src_label_name, dst_label_name,
                                          edge_label_name)) {
         dual_csr->SortByEdgeData(1);
+      } else if (schema_.get_sort_by_neighbor(src_label_name, dst_label_name,
+                                              edge_label_name)) {
+        dual_csr->SortByNeighbor(1);
       }
 
       dual_csr->Dump(
@@ -276,6 +332,10 @@ class BasicFragmentLoader {
           ie_prefix(src_label_name, dst_label_name, edge_label_name),
           edata_prefix(src_label_name, dst_label_name, edge_label_name),
           snapshot_dir(work_dir_, 0));
+      upload_snapshot_files(
+          {oe_prefix(src_label_name, dst_label_name, edge_label_name),
+           ie_prefix(src_label_name, dst_label_name, edge_label_name),
+           edata_prefix(src_label_name, dst_label_name, edge_label_name)});
     }
     append_edge_loading_progress(src_label_name, dst_label_name,
                                  edge_label_name, LoadingStatus::kCommited);
@@ -293,6 +353,12 @@ class BasicFragmentLoader {
 
   const std::string& work_dir() const { return work_dir_; }
 
+  // Uploads the snapshot written by LoadFragment with uploader. Files of a
+  // snapshot 0 that is kept are queued as soon as they are dumped.
+  void SetSnapshotUploader(std::shared_ptr<SnapshotUploader> uploader) {
+    uploader_ = std::move(uploader);
+  }
+
   void set_csr(label_t src_label_id, label_t dst_label_id,
                label_t edge_label_id, DualCsrBase* dual_csr);
 
@@ -303,6 +369,192 @@ class BasicFragmentLoader {
                        label_t edge_label_id);
 
  private:
+  // Puts the edges into the outgoing or the incoming csr, in two parallel
+  // phases. First every vector is sorted in place by the vertex whose list
+  // the edge goes to. Then each thread takes a range of vertices with about
+  // the same number of edges, and copies the edges of that range out of
+  // every sorted vector. Each list is thus written by one thread, front to
+  // back, and edges are not copied to any buffer in between.
+  template <typename DUAL_CSR_T, typename VECTOR_T>
+  static void fill_direction(DUAL_CSR_T* casted_dual_csr,
+                             std::vector<VECTOR_T>& edges_vec,
+                             const std::vector<int32_t>& degree, bool out) {
+    auto INVALID_VID = std::numeric_limits<vid_t>::max();
+    vid_t vnum = degree.size();
+    // Invalid vertices sort after all valid ones.
+    auto key = [vnum, out](const auto& edge) -> size_t {
+      vid_t v = out ? std::get<0>(edge) : std::get<1>(edge);
+      return std::min(v, vnum);
+    };
+    std::vector<std::thread> work_threads;
+    for (size_t i = 0; i < edges_vec.size(); ++i) {
+      work_threads.emplace_back(
+          [&](int idx) {
+            auto& edges = edges_vec[idx];
+            if (edges.size() != 0) {
+              inplace_radix_sort(&edges[0], &edges[0] + edges.size(), key,
+                                 vnum);
+            }
+          },
+          i);
+    }
+    for (auto& t : work_threads) {
+      t.join();
+    }
+    work_threads.clear();
+
+    auto bounds = split_by_degree(degree, edges_vec.size());
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      work_threads.emplace_back(
+          [&](int idx) {
+            size_t begin = bounds[idx], end = bounds[idx + 1];
+            auto less = [&key](const auto& edge, size_t v) {
+              return key(edge) < v;
+            };
+            for (auto& edges : edges_vec) {
+              if (edges.size() == 0) {
+                continue;
+              }
+              auto* first = std::lower_bound(
+                  &edges[0], &edges[0] + edges.size(), begin, less);
+              auto* last = std::lower_bound(
+                  first, &edges[0] + edges.size(), end, less);
+              for (auto* edge = first; edge != last; ++edge) {
+                vid_t src = std::get<0>(*edge);
+                vid_t dst = std::get<1>(*edge);
+                if (src == INVALID_VID || dst == INVALID_VID) {
+                  if (out) {
+                    VLOG(10) << "Skip invalid edge:" << src << "->" << dst;
+                  }
+                  continue;
+                }
+                if (out) {
+                  casted_dual_csr->BatchPutOutEdge(src, dst,
+                                                   std::get<2>(*edge));
+                } else {
+                  casted_dual_csr->BatchPutInEdge(src, dst,
+                                                  std::get<2>(*edge));
+                }
+              }
+            }
+          },
+          i);
+    }
+    for (auto& t : work_threads) {
+      t.join();
+    }
+  }
+
+  // Merges the parsed vertices into the indexer and the table of the graph.
+  // Vertices already in the graph keep their vid and take the properties
+  // parsed for them.
+  template <typename KEY_T>
+  void appendVertices(label_t v_label, const IdIndexer<KEY_T, vid_t>& indexer) {
+    auto label_name = schema_.get_vertex_label_name(v_label);
+    auto& base_indexer = base_.lf_indexers_[v_label];
+    auto& base_table = base_.vertex_data_[v_label];
+    base_.markDirty(base_.indexer_dirty_[v_label]);
+    base_.markDirty(base_.table_dirty_[v_label]);
+    const auto& v_data = vertex_data_[v_label];
+    size_t vnum = indexer.size();
+    size_t old_vnum = base_indexer.size();
+    if (base_indexer.capacity() < old_vnum + vnum) {
+      base_indexer.reserve(old_vnum + vnum);
+    }
+    std::vector<vid_t> vids(vnum);
+    for (size_t i = 0; i < vnum; ++i) {
+      Any oid;
+      CHECK(indexer.get_key(i, oid));
+      if (!base_indexer.get_index(oid, vids[i])) {
+        vids[i] = base_indexer.insert(oid);
+      }
+    }
+    base_table.resize(std::max(base_table.row_num(), base_indexer.size()));
+    for (size_t col = 0; col < v_data.col_num(); ++col) {
+      copy_column_rows(*v_data.get_column_by_id(col), vnum,
+                       *base_table.get_column_by_id(col),
+                       [&](size_t i) { return vids[i]; });
+    }
+    base_table.encode_dictionary();
+    VLOG(10) << "Appended " << base_indexer.size() - old_vnum
+             << " vertices of label " << label_name << ", "
+             << vnum + old_vnum - base_indexer.size() << " updated";
+    append_vertex_loading_progress(label_name, LoadingStatus::kLoaded);
+  }
+
+  // Adds the parsed edges to the csrs of the graph, after making room for
+  // them next to the edges of each vertex.
+  template <typename EDATA_T, typename VECTOR_T>
+  void appendEdges(label_t src_label_id, label_t dst_label_id,
+                   label_t edge_label_id, std::vector<VECTOR_T>& edges_vec,
+                   const std::vector<int32_t>& ie_degree,
+                   const std::vector<int32_t>& oe_degree) {
+    size_t index = src_label_id * vertex_label_num_ * edge_label_num_ +
+                   dst_label_id * edge_label_num_ + edge_label_id;
+    auto dual_csr = base_.dual_csr_list_[index];
+    CHECK(dual_csr != NULL);
+    base_.markDirty(base_.csr_dirty_[index]);
+    auto casted_dual_csr = get_casted_dual_csr<EDATA_T>(dual_csr);
+    auto src_label_name = schema_.get_vertex_label_name(src_label_id);
+    auto dst_label_name = schema_.get_vertex_label_name(dst_label_id);
+    auto edge_label_name = schema_.get_edge_label_name(edge_label_id);
+    CHECK(ie_degree.size() == GetLFIndexer(dst_label_id).size());
+    CHECK(oe_degree.size() == GetLFIndexer(src_label_id).size());
+
+    dual_csr->BatchReserve(oe_degree, ie_degree);
+    auto INVALID_VID = std::numeric_limits<vid_t>::max();
+    if constexpr (std::is_same_v<EDATA_T, std::string_view>) {
+      std::vector<std::thread> work_threads;
+      for (size_t i = 0; i < edges_vec.size(); ++i) {
+        work_threads.emplace_back(
+            [&](int idx) {
+              for (auto& edge : edges_vec[idx]) {
+                if (std::get<1>(edge) == INVALID_VID ||
+                    std::get<0>(edge) == INVALID_VID) {
+                  continue;
+                }
+                casted_dual_csr->BatchPutEdge(
+                    std::get<0>(edge), std::get<1>(edge), std::get<2>(edge));
+              }
+            },
+            i);
+      }
+      for (auto& t : work_threads) {
+        t.join();
+      }
+    } else {
+      if constexpr (std::is_same_v<EDATA_T, RecordView>) {
+        // The properties were parsed into the table of the csr created for
+        // the triplet, at the offsets the edges hold.
+        size_t row_num = 0;
+        for (auto& edges : edges_vec) {
+          row_num += edges.size();
+        }
+        auto parsed_csr =
+            get_casted_dual_csr<RecordView>(dual_csr_list_[index]);
+        size_t row_offset =
+            casted_dual_csr->AppendRows(parsed_csr->GetTable(), row_num);
+        std::vector<std::thread> work_threads;
+        for (size_t i = 0; i < edges_vec.size(); ++i) {
+          work_threads.emplace_back(
+              [&](int idx) {
+                for (auto& edge : edges_vec[idx]) {
+                  std::get<2>(edge) += row_offset;
+                }
+              },
+              i);
+        }
+        for (auto& t : work_threads) {
+          t.join();
+        }
+      }
+      fill_direction(casted_dual_csr, edges_vec, oe_degree, true);
+      fill_direction(casted_dual_csr, edges_vec, ie_degree, false);
+    }
+    append_edge_loading_progress(src_label_name, dst_label_name,
+                                 edge_label_name, LoadingStatus::kLoaded);
+  }
+
   // create status files for each vertex label and edge triplet pair.
   void append_vertex_loading_progress(const std::string& label_name,
                                       LoadingStatus status);
@@ -313,13 +565,22 @@ class BasicFragmentLoader {
                                     LoadingStatus status);
   void init_loading_status_file();
   void init_vertex_data();
+  void open_base();
+  void reorder_vertices(MutablePropertyFragment& graph);
+  void upload_snapshot_files(const std::vector<std::string>& prefixes);
   const Schema& schema_;
   std::string work_dir_;
+  bool append_;
+  VertexOrder vertex_order_;
+  // The graph appended to, and the version of its snapshot.
+  MutablePropertyFragment base_;
+  uint32_t base_version_;
   size_t vertex_label_num_, edge_label_num_;
   std::vector<IndexerType> lf_indexers_;
   std::vector<CsrBase*> ie_, oe_;
   std::vector<DualCsrBase*> dual_csr_list_;
   std::vector<Table> vertex_data_;
+  std::shared_ptr<SnapshotUploader> uploader_;
 
   // loading progress related
   std::mutex loading_progress_mutex_;
@@ -16,6 +16,8 @@
 #include "flex/storages/rt_mutable_graph/loader/csv_fragment_loader.h"
 #include "flex/engines/hqps_db/core/utils/hqps_utils.h"
 
+#include <condition_variable>
+
 namespace gs {
 
 CSVStreamRecordBatchSupplier::CSVStreamRecordBatchSupplier(
@@ -743,10 +745,108 @@ void CSVFragmentLoader::loadEdges() {
   }
 }
 
+void CSVFragmentLoader::loadVerticesAndEdges() {
+  auto vertex_sources = loading_config_.GetVertexLoadingMeta();
+  auto& edge_sources = loading_config_.GetEdgeLoadingMeta();
+  std::vector<std::pair<label_t, std::vector<std::string>>> vertex_files;
+  for (auto iter = vertex_sources.begin(); iter != vertex_sources.end();
+       ++iter) {
+    vertex_files.emplace_back(iter->first, iter->second);
+  }
+  std::vector<std::pair<typename LoadingConfig::edge_triplet_type,
+                        std::vector<std::string>>>
+      edge_files;
+  for (auto iter = edge_sources.begin(); iter != edge_sources.end(); ++iter) {
+    edge_files.emplace_back(iter->first, iter->second);
+  }
+  LOG(INFO) << "Parallel loading with " << thread_num_ << " threads, "
+            << vertex_files.size() << " vertex files, " << edge_files.size()
+            << " edge files.";
+
+  // Labels whose vertices are not loaded yet. Labels without vertex files
+  // stay empty, and edges may refer to them right away.
+  std::vector<bool> label_pending(vertex_label_num_, false);
+  for (auto& vertex_file : vertex_files) {
+    label_pending[vertex_file.first] = true;
+  }
+  std::vector<bool> edge_started(edge_files.size(), false);
+  size_t next_vertex = 0, edge_left = edge_files.size();
+  std::exception_ptr error;
+  std::mutex mtx;
+  std::condition_variable cv;
+
+  std::vector<std::thread> threads(thread_num_);
+  for (int i = 0; i < thread_num_; ++i) {
+    threads[i] = std::thread([&]() {
+      std::unique_lock<std::mutex> lock(mtx);
+      while (error == nullptr) {
+        // Vertex files come first, since edges wait for them.
+        if (next_vertex < vertex_files.size()) {
+          auto& vertex_file = vertex_files[next_vertex++];
+          lock.unlock();
+          try {
+            addVertices(vertex_file.first, vertex_file.second);
+          } catch (...) {
+            lock.lock();
+            error = std::current_exception();
+            cv.notify_all();
+            break;
+          }
+          lock.lock();
+          label_pending[vertex_file.first] = false;
+          cv.notify_all();
+          continue;
+        }
+        if (edge_left == 0) {
+          break;
+        }
+        size_t cur = edge_files.size();
+        for (size_t k = 0; k < edge_files.size(); ++k) {
+          auto& triplet = edge_files[k].first;
+          if (!edge_started[k] && !label_pending[std::get<0>(triplet)] &&
+              !label_pending[std::get<1>(triplet)]) {
+            cur = k;
+            break;
+          }
+        }
+        if (cur == edge_files.size()) {
+          cv.wait(lock);
+          continue;
+        }
+        edge_started[cur] = true;
+        --edge_left;
+        auto& edge_file = edge_files[cur];
+        lock.unlock();
+        try {
+          addEdges(std::get<0>(edge_file.first), std::get<1>(edge_file.first),
+                   std::get<2>(edge_file.first), edge_file.second);
+        } catch (...) {
+          lock.lock();
+          error = std::current_exception();
+          cv.notify_all();
+          break;
+        }
+        lock.lock();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  LOG(INFO) << "Finished loading vertices and edges";
+}
+
 Result<bool> CSVFragmentLoader::LoadFragment() {
   try {
-    loadVertices();
-    loadEdges();
+    if (thread_num_ == 1) {
+      loadVertices();
+      loadEdges();
+    } else {
+      loadVerticesAndEdges();
+    }
 
     basic_fragment_loader_.LoadFragment();
   } catch (const std::exception& e) {
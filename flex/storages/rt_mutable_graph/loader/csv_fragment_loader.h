@@ -82,6 +82,11 @@ class CSVFragmentLoader : public AbstractArrowFragmentLoader {
 
   void loadEdges();
 
+  // Loads vertex and edge files on one pool of threads. The edges of a
+  // triplet are loaded as soon as the vertices of both its endpoint labels
+  // are, while the vertices of other labels may still be loading.
+  void loadVerticesAndEdges();
+
   void addVertices(label_t v_label_id, const std::vector<std::string>& v_files);
 
   void addEdges(label_t src_label_id, label_t dst_label_id, label_t e_label_id,
@@ -17,6 +17,7 @@
 #define STORAGES_RT_MUTABLE_GRAPH_LOADER_FRAGMENT_LOADER_H_
 
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
 
 namespace gs {
 
@@ -25,6 +26,10 @@ class IFragmentLoader {
  public:
   virtual ~IFragmentLoader() = default;
   virtual Result<bool> LoadFragment() = 0;
+
+  // Uploads the loaded snapshot with uploader, for loaders that support it.
+  virtual void SetSnapshotUploader(
+      std::shared_ptr<SnapshotUploader> uploader) {}
 };
 
 }  // namespace gs
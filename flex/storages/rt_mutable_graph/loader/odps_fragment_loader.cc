@@ -73,7 +73,7 @@ TableBatchScanResp ODPSReadClient::createReadSession(
     const TableIdentifier& table_identifier,
     const std::vector<std::string>& selected_cols,
     const std::vector<std::string>& partition_cols,
-    const std::vector<std::string>& selected_partitions) {
+    const std::vector<std::string>& selected_partitions, int split_num) {
   VLOG(1) << "CreateReadSession:" << table_identifier.project_ << ", "
           << table_identifier.table_;
   VLOG(1) << "Selected cols:" << gs::to_string(selected_cols);
@@ -82,8 +82,14 @@ TableBatchScanResp ODPSReadClient::createReadSession(
 
   TableBatchScanReq req;
   req.table_identifier_ = table_identifier;
-  req.split_options_ = SplitOptions::GetDefaultOptions(SplitOptions::SIZE);
-  req.split_options_.split_number_ = 64 * 1024 * 1024;
+  if (split_num > 0) {
+    req.split_options_ =
+        SplitOptions::GetDefaultOptions(SplitOptions::PARALLELISM);
+    req.split_options_.split_number_ = split_num;
+  } else {
+    req.split_options_ = SplitOptions::GetDefaultOptions(SplitOptions::SIZE);
+    req.split_options_.split_number_ = 64 * 1024 * 1024;
+  }
 
   if (!partition_cols.empty()) {
     req.required_partitions_ = selected_partitions;
@@ -114,9 +120,9 @@ void ODPSReadClient::CreateReadSession(
     const TableIdentifier& table_identifier,
     const std::vector<std::string>& selected_cols,
     const std::vector<std::string>& partition_cols,
-    const std::vector<std::string>& selected_partitions) {
+    const std::vector<std::string>& selected_partitions, int split_num) {
   auto resp = createReadSession(table_identifier, selected_cols, partition_cols,
-                                selected_partitions);
+                                selected_partitions, split_num);
   size_t cur_retry = 0;
   while (resp.status_ != apsara::odps::sdk::storage_api::Status::OK &&
          resp.status_ != apsara::odps::sdk::storage_api::Status::WAIT) {
@@ -126,7 +132,7 @@ void ODPSReadClient::CreateReadSession(
                  << ", when creating read session.";
     }
     resp = createReadSession(table_identifier, selected_cols, partition_cols,
-                             selected_partitions);
+                             selected_partitions, split_num);
     cur_retry++;
   }
   *session_id = resp.session_id_;
@@ -324,6 +330,122 @@ ODPSStreamRecordBatchSupplier::GetNextBatch() {
   return record_batch;
 }
 
+////////////////ODPSPrefetchRecordBatchSupplier/////////////////
+
+ODPSPrefetchRecordBatchSupplier::ODPSPrefetchRecordBatchSupplier(
+    label_t label_id, const std::string& file_path,
+    const ODPSReadClient& odps_table_reader, const std::string& session_id,
+    int split_count, TableIdentifier table_identifier, int worker_id,
+    int worker_num, size_t memory_limit)
+    : file_path_(file_path),
+      odps_read_client_(odps_table_reader),
+      session_id_(session_id),
+      split_count_(split_count),
+      table_identifier_(table_identifier),
+      worker_num_(worker_num),
+      memory_limit_(memory_limit),
+      buffered_bytes_(0),
+      finished_(false),
+      stopped_(false) {
+  prefetch_thread_ = std::thread(
+      &ODPSPrefetchRecordBatchSupplier::prefetchRoutine, this, worker_id);
+}
+
+ODPSPrefetchRecordBatchSupplier::~ODPSPrefetchRecordBatchSupplier() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+}
+
+bool ODPSPrefetchRecordBatchSupplier::putBatch(
+    std::shared_ptr<arrow::RecordBatch>&& batch) {
+  size_t bytes = 0;
+  for (auto& column : batch->columns()) {
+    for (auto& buffer : column->data()->buffers) {
+      if (buffer) {
+        bytes += buffer->size();
+      }
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Always admits one batch, so that a batch larger than the limit does not
+  // stall the download.
+  cv_.wait(lock, [&] {
+    return stopped_ || batches_.empty() ||
+           buffered_bytes_ + bytes <= memory_limit_;
+  });
+  if (stopped_) {
+    return false;
+  }
+  buffered_bytes_ += bytes;
+  batches_.emplace_back(std::move(batch), bytes);
+  cv_.notify_all();
+  return true;
+}
+
+void ODPSPrefetchRecordBatchSupplier::prefetchRoutine(int worker_id) {
+  ReadRowsReq req;
+  req.table_identifier_ = table_identifier_;
+  req.session_id_ = session_id_;
+  req.max_batch_rows_ = 20000;
+  for (int split = worker_id; split < split_count_; split += worker_num_) {
+    req.split_index_ = split;
+    // A retry reads the split from its beginning, the batches that were
+    // already delivered are skipped.
+    size_t delivered = 0;
+    size_t cur_retry = 0;
+    while (true) {
+      auto reader = odps_read_client_.GetArrowClient()->ReadRows(req);
+      std::shared_ptr<arrow::RecordBatch> batch;
+      size_t index = 0;
+      while (reader->Read(batch)) {
+        if (index++ < delivered) {
+          continue;
+        }
+        if (!putBatch(std::move(batch))) {
+          return;
+        }
+        ++delivered;
+      }
+      if (reader->GetStatus() == apsara::odps::sdk::storage_api::Status::OK) {
+        VLOG(1) << "Read split " << split << " finished";
+        break;
+      }
+      LOG(ERROR) << "read rows error: " << reader->GetErrorMessage() << ", "
+                 << reader->GetStatus() << ", split id: " << split;
+      if (cur_retry >= ODPSReadClient::MAX_RETRY) {
+        LOG(FATAL) << "Reach max retry times " << ODPSReadClient::MAX_RETRY
+                   << ", split id: " << split;
+      }
+      cur_retry++;
+    }
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  cv_.notify_all();
+}
+
+std::shared_ptr<arrow::RecordBatch>
+ODPSPrefetchRecordBatchSupplier::GetNextBatch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return finished_ || !batches_.empty(); });
+  if (batches_.empty()) {
+    return nullptr;
+  }
+  auto batch = std::move(batches_.front().first);
+  buffered_bytes_ -= batches_.front().second;
+  batches_.pop_front();
+  cv_.notify_all();
+  return batch;
+}
+
 ////////////////ODPSTableRecordBatchSupplier/////////////////
 ODPSTableRecordBatchSupplier::ODPSTableRecordBatchSupplier(
     label_t label_id, const std::string& file_path,
@@ -423,27 +545,18 @@ void ODPSFragmentLoader::addVertices(label_t v_label_id,
     TableIdentifier table_identifier;
     std::vector<std::string> partition_cols;
     std::vector<std::string> selected_partitions;
-    std::vector<std::shared_ptr<IRecordBatchSupplier>> suppliers;
     parseLocation(v_file, table_identifier, partition_cols,
                   selected_partitions);
     auto selected_cols = columnMappingsToSelectedCols(vertex_column_mappings);
-    odps_read_client_.CreateReadSession(&session_id, &split_count,
-                                        table_identifier, selected_cols,
-                                        partition_cols, selected_partitions);
+    auto split_num_str = loading_config.GetMetaData(odps_options::SPLIT_NUM);
+    odps_read_client_.CreateReadSession(
+        &session_id, &split_count, table_identifier, selected_cols,
+        partition_cols, selected_partitions,
+        split_num_str.empty() ? 0 : std::stoi(split_num_str));
     VLOG(1) << "Successfully got session_id: " << session_id
             << ", split count: " << split_count;
-    if (loading_config.GetIsBatchReader()) {
-      for (int i = 0; i < worker_num; ++i) {
-        suppliers.emplace_back(std::make_shared<ODPSStreamRecordBatchSupplier>(
-            label_id, v_file, odps_read_client_, session_id, split_count,
-            table_identifier, i, worker_num));
-      }
-    } else {
-      suppliers.emplace_back(std::make_shared<ODPSTableRecordBatchSupplier>(
-          label_id, v_file, odps_read_client_, session_id, split_count,
-          table_identifier, thread_num_));
-    }
-    return suppliers;
+    return makeSuppliers(label_id, v_file, session_id, split_count,
+                         table_identifier, loading_config, worker_num);
   };
   return AbstractArrowFragmentLoader::AddVerticesRecordBatch(
       v_label_id, v_files, record_batch_supplier_creator);
@@ -509,7 +622,6 @@ void ODPSFragmentLoader::addEdges(label_t src_label_i, label_t dst_label_i,
     TableIdentifier table_identifier;
     std::vector<std::string> partition_cols;
     std::vector<std::string> selected_partitions;
-    std::vector<std::shared_ptr<IRecordBatchSupplier>> suppliers;
     parseLocation(table_path, table_identifier, partition_cols,
                   selected_partitions);
     auto edge_column_mappings = loading_config_.GetEdgeColumnMappings(
@@ -533,24 +645,15 @@ void ODPSFragmentLoader::addEdges(label_t src_label_i, label_t dst_label_i,
     selected_cols.insert(selected_cols.end(), selected_props.begin(),
                          selected_props.end());
 
-    odps_read_client_.CreateReadSession(&session_id, &split_count,
-                                        table_identifier, selected_cols,
-                                        partition_cols, selected_partitions);
+    auto split_num_str = loading_config.GetMetaData(odps_options::SPLIT_NUM);
+    odps_read_client_.CreateReadSession(
+        &session_id, &split_count, table_identifier, selected_cols,
+        partition_cols, selected_partitions,
+        split_num_str.empty() ? 0 : std::stoi(split_num_str));
     VLOG(1) << "Successfully got session_id: " << session_id
             << ", split count: " << split_count;
-    if (loading_config.GetIsBatchReader()) {
-      for (int i = 0; i < worker_num; ++i) {
-        suppliers.emplace_back(std::make_shared<ODPSStreamRecordBatchSupplier>(
-            e_label_id, table_path, odps_read_client_, session_id, split_count,
-            table_identifier, i, worker_num));
-      }
-
-    } else {
-      suppliers.emplace_back(std::make_shared<ODPSTableRecordBatchSupplier>(
-          e_label_id, table_path, odps_read_client_, session_id, split_count,
-          table_identifier, thread_num_));
-    }
-    return suppliers;
+    return makeSuppliers(e_label_id, table_path, session_id, split_count,
+                         table_identifier, loading_config, worker_num);
   };
 
   AbstractArrowFragmentLoader::AddEdgesRecordBatch(
@@ -608,6 +711,49 @@ void ODPSFragmentLoader::loadEdges() {
   }
 }
 
+std::vector<std::shared_ptr<IRecordBatchSupplier>>
+ODPSFragmentLoader::makeSuppliers(label_t label_id,
+                                  const std::string& table_path,
+                                  const std::string& session_id,
+                                  int split_count,
+                                  const TableIdentifier& table_identifier,
+                                  const LoadingConfig& loading_config,
+                                  int worker_num) {
+  std::vector<std::shared_ptr<IRecordBatchSupplier>> suppliers;
+  if (!loading_config.GetIsBatchReader()) {
+    suppliers.emplace_back(std::make_shared<ODPSTableRecordBatchSupplier>(
+        label_id, table_path, odps_read_client_, session_id, split_count,
+        table_identifier, thread_num_));
+    return suppliers;
+  }
+  auto prefetch = loading_config.GetMetaData(odps_options::PREFETCH);
+  if (prefetch == "true" || prefetch == "True" || prefetch == "TRUE") {
+    auto memory_str =
+        loading_config.GetMetaData(odps_options::PREFETCH_MEMORY_MB);
+    size_t memory_limit =
+        (memory_str.empty() ? odps_options::DEFAULT_PREFETCH_MEMORY_MB
+                            : std::stoul(memory_str)) *
+        1024 * 1024;
+    // A supplier without a split would only hold a thread.
+    int supplier_num = std::max(1, std::min(worker_num, split_count));
+    VLOG(1) << "Prefetching " << split_count << " splits of " << table_path
+            << " with " << supplier_num << " suppliers, memory limit: "
+            << memory_limit << " bytes";
+    for (int i = 0; i < supplier_num; ++i) {
+      suppliers.emplace_back(std::make_shared<ODPSPrefetchRecordBatchSupplier>(
+          label_id, table_path, odps_read_client_, session_id, split_count,
+          table_identifier, i, supplier_num, memory_limit / supplier_num));
+    }
+  } else {
+    for (int i = 0; i < worker_num; ++i) {
+      suppliers.emplace_back(std::make_shared<ODPSStreamRecordBatchSupplier>(
+          label_id, table_path, odps_read_client_, session_id, split_count,
+          table_identifier, i, worker_num));
+    }
+  }
+  return suppliers;
+}
+
 std::vector<std::string> ODPSFragmentLoader::columnMappingsToSelectedCols(
     const std::vector<std::tuple<size_t, std::string, std::string>>&
         column_mappings) {
@@ -25,6 +25,10 @@
 #include <boost/convert.hpp>
 #include <boost/convert/strtol.hpp>
 #include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #include "arrow/util/value_parsing.h"
 #include "common/configuration.h"
@@ -56,6 +60,17 @@ using apsara::odps::sdk::storage_api::arrow_adapter::Reader;
 
 namespace gs {
 
+namespace odps_options {
+// Number of splits to create per table. If not set, tables are split by size.
+static constexpr const char* SPLIT_NUM = "split_num";
+// Whether to download the next batches of each split in the background while
+// the current ones are being inserted. Takes effect with batch_reader.
+static constexpr const char* PREFETCH = "prefetch";
+// Upper bound of the memory held by the prefetched batches of one table.
+static constexpr const char* PREFETCH_MEMORY_MB = "prefetch_memory_mb";
+static constexpr const size_t DEFAULT_PREFETCH_MEMORY_MB = 1024;
+}  // namespace odps_options
+
 class ODPSReadClient {
  public:
   static constexpr const int CONNECTION_TIMEOUT = 5;
@@ -71,7 +86,8 @@ class ODPSReadClient {
                          const TableIdentifier& table_identifier,
                          const std::vector<std::string>& selected_cols,
                          const std::vector<std::string>& partition_cols,
-                         const std::vector<std::string>& selected_partitions);
+                         const std::vector<std::string>& selected_partitions,
+                         int split_num = 0);
 
   std::shared_ptr<arrow::Table> ReadTable(const std::string& session_id,
                                           int split_count,
@@ -85,7 +101,7 @@ class ODPSReadClient {
       const TableIdentifier& table_identifier,
       const std::vector<std::string>& selected_cols,
       const std::vector<std::string>& partition_cols,
-      const std::vector<std::string>& selected_partitions);
+      const std::vector<std::string>& selected_partitions, int split_num);
 
   TableBatchScanResp getReadSession(std::string session_id,
                                     const TableIdentifier& table_identifier);
@@ -138,6 +154,49 @@ class ODPSStreamRecordBatchSupplier : public IRecordBatchSupplier {
   std::shared_ptr<Reader> cur_batch_reader_;
 };
 
+// Reads the splits worker_id, worker_id + worker_num, ... like
+// ODPSStreamRecordBatchSupplier, but on a background thread that keeps
+// downloading while the returned batches are being inserted. The thread
+// pauses once the batches waiting to be taken hold more than memory_limit
+// bytes.
+class ODPSPrefetchRecordBatchSupplier : public IRecordBatchSupplier {
+ public:
+  ODPSPrefetchRecordBatchSupplier(label_t label_id,
+                                  const std::string& file_path,
+                                  const ODPSReadClient& odps_table_reader,
+                                  const std::string& session_id,
+                                  int split_count,
+                                  TableIdentifier table_identifier,
+                                  int worker_id, int worker_num,
+                                  size_t memory_limit);
+
+  ~ODPSPrefetchRecordBatchSupplier();
+
+  std::shared_ptr<arrow::RecordBatch> GetNextBatch() override;
+
+ private:
+  void prefetchRoutine(int worker_id);
+
+  // Returns false if the supplier is being destroyed.
+  bool putBatch(std::shared_ptr<arrow::RecordBatch>&& batch);
+
+  std::string file_path_;
+  const ODPSReadClient& odps_read_client_;
+  std::string session_id_;
+  int split_count_;
+  TableIdentifier table_identifier_;
+  int worker_num_;
+  size_t memory_limit_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::pair<std::shared_ptr<arrow::RecordBatch>, size_t>> batches_;
+  size_t buffered_bytes_;
+  bool finished_;
+  bool stopped_;
+  std::thread prefetch_thread_;
+};
+
 class ODPSTableRecordBatchSupplier : public IRecordBatchSupplier {
  public:
   ODPSTableRecordBatchSupplier(label_t label_id, const std::string& file_path,
@@ -198,6 +257,14 @@ class ODPSFragmentLoader : public AbstractArrowFragmentLoader {
   void addEdges(label_t src_label_id, label_t dst_label_id, label_t e_label_id,
                 const std::vector<std::string>& e_files);
 
+  // Creates the suppliers of a table already opened in session_id, according
+  // to the batch_reader and prefetch options.
+  std::vector<std::shared_ptr<IRecordBatchSupplier>> makeSuppliers(
+      label_t label_id, const std::string& table_path,
+      const std::string& session_id, int split_count,
+      const TableIdentifier& table_identifier,
+      const LoadingConfig& loading_config, int worker_num);
+
   std::vector<std::string> columnMappingsToSelectedCols(
       const std::vector<std::tuple<size_t, std::string, std::string>>&
           column_mappings);
@@ -0,0 +1,628 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/loader/parquet_fragment_loader.h"
+
+#include <regex>
+
+#include <arrow/compute/api.h>
+#include <parquet/statistics.h>
+
+namespace gs {
+
+static std::unique_ptr<parquet::arrow::FileReader> open_parquet_file(
+    const std::string& file_path,
+    std::shared_ptr<parquet::FileMetaData> metadata) {
+  auto read_result = arrow::io::ReadableFile::Open(file_path);
+  if (!read_result.ok()) {
+    LOG(FATAL) << "Failed to open file: " << file_path
+               << " error: " << read_result.status().message();
+  }
+  parquet::arrow::FileReaderBuilder builder;
+  auto status = builder.Open(read_result.ValueOrDie(),
+                             parquet::default_reader_properties(), metadata);
+  if (!status.ok()) {
+    LOG(FATAL) << "Failed to open parquet file: " << file_path
+               << " error: " << status.message();
+  }
+  // Parallelism comes from reading different row groups in different
+  // suppliers, so each reader decodes its columns on the calling thread.
+  parquet::ArrowReaderProperties properties;
+  properties.set_use_threads(false);
+  properties.set_pre_buffer(true);
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  status = builder.memory_pool(arrow::default_memory_pool())
+               ->properties(properties)
+               ->Build(&reader);
+  if (!status.ok()) {
+    LOG(FATAL) << "Failed to create parquet reader for file: " << file_path
+               << " error: " << status.message();
+  }
+  return reader;
+}
+
+static bool is_string_type(const std::shared_ptr<arrow::DataType>& type) {
+  return type->Equals(arrow::utf8()) || type->Equals(arrow::large_utf8());
+}
+
+// Evaluates lhs func rhs, treating a failed or null comparison as true so
+// that a row group is only skipped when it provably holds no match.
+static bool compare_scalars(const std::shared_ptr<arrow::Scalar>& lhs,
+                            const std::string& func,
+                            const std::shared_ptr<arrow::Scalar>& rhs) {
+  auto res = arrow::compute::CallFunction(func, {lhs, rhs});
+  if (!res.ok()) {
+    return true;
+  }
+  auto scalar = res.ValueOrDie().scalar();
+  if (!scalar || !scalar->is_valid) {
+    return true;
+  }
+  return std::static_pointer_cast<arrow::BooleanScalar>(scalar)->value;
+}
+
+// Returns true if no value in [min, max] can satisfy the predicate.
+static bool prune_by_min_max(const ParquetColumnPredicate& pred,
+                             const std::shared_ptr<arrow::Scalar>& min,
+                             const std::shared_ptr<arrow::Scalar>& max) {
+  const auto& v = pred.value;
+  if (pred.func == "equal") {
+    return !compare_scalars(max, "greater_equal", v) ||
+           !compare_scalars(min, "less_equal", v);
+  } else if (pred.func == "not_equal") {
+    return !compare_scalars(min, "not_equal", v) &&
+           !compare_scalars(max, "not_equal", v);
+  } else if (pred.func == "less") {
+    return !compare_scalars(min, "less", v);
+  } else if (pred.func == "less_equal") {
+    return !compare_scalars(min, "less_equal", v);
+  } else if (pred.func == "greater") {
+    return !compare_scalars(max, "greater", v);
+  } else if (pred.func == "greater_equal") {
+    return !compare_scalars(max, "greater_equal", v);
+  }
+  return false;
+}
+
+static bool prune_row_group(
+    const parquet::FileMetaData& metadata, int row_group,
+    const std::vector<ParquetColumnPredicate>& predicates) {
+  auto row_group_meta = metadata.RowGroup(row_group);
+  for (auto& pred : predicates) {
+    int leaf = metadata.schema()->ColumnIndex(pred.column);
+    if (leaf < 0) {
+      continue;
+    }
+    auto stats = row_group_meta->ColumnChunk(leaf)->statistics();
+    if (!stats || !stats->HasMinMax()) {
+      continue;
+    }
+    std::shared_ptr<arrow::Scalar> min, max;
+    if (!parquet::arrow::StatisticsAsScalars(*stats, &min, &max).ok()) {
+      continue;
+    }
+    auto min_res = arrow::compute::Cast(min, pred.value->type);
+    auto max_res = arrow::compute::Cast(max, pred.value->type);
+    if (!min_res.ok() || !max_res.ok()) {
+      continue;
+    }
+    if (prune_by_min_max(pred, min_res.ValueOrDie().scalar(),
+                         max_res.ValueOrDie().scalar())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses a filter like "age >= 18 and name == 'Tom'", binding each literal to
+// the type of its column in the file.
+static std::vector<ParquetColumnPredicate> parse_filter(
+    const std::string& filter, const arrow::Schema& file_schema,
+    const std::string& file_path) {
+  static const std::regex and_regex("\\s+and\\s+", std::regex::icase);
+  static const std::regex term_regex(
+      "^\\s*([^\\s<>=!]+)\\s*(==|!=|<=|>=|=|<|>)\\s*(.*?)\\s*$");
+  static const std::unordered_map<std::string, std::string> funcs = {
+      {"==", "equal"}, {"=", "equal"},       {"!=", "not_equal"},
+      {"<", "less"},   {"<=", "less_equal"}, {">", "greater"},
+      {">=", "greater_equal"}};
+  std::vector<ParquetColumnPredicate> predicates;
+  if (filter.empty()) {
+    return predicates;
+  }
+  std::sregex_token_iterator iter(filter.begin(), filter.end(), and_regex, -1);
+  for (; iter != std::sregex_token_iterator(); ++iter) {
+    std::string term = *iter;
+    std::smatch match;
+    if (!std::regex_match(term, match, term_regex)) {
+      LOG(FATAL) << "Invalid filter term: [" << term << "] in filter: "
+                 << filter;
+    }
+    ParquetColumnPredicate pred;
+    pred.column = match[1];
+    pred.func = funcs.at(match[2]);
+    std::string literal = match[3];
+    if (literal.size() >= 2 &&
+        (literal.front() == '\'' || literal.front() == '"') &&
+        literal.back() == literal.front()) {
+      literal = literal.substr(1, literal.size() - 2);
+    }
+    auto field = file_schema.GetFieldByName(pred.column);
+    if (field == nullptr) {
+      LOG(FATAL) << "Column [" << pred.column << "] in filter: " << filter
+                 << " does not exist in file: " << file_path;
+    }
+    auto value = arrow::Scalar::Parse(field->type(), literal);
+    if (!value.ok()) {
+      LOG(FATAL) << "Failed to parse [" << literal << "] as "
+                 << field->type()->ToString() << " in filter: " << filter
+                 << " error: " << value.status().message();
+    }
+    pred.value = value.ValueOrDie();
+    predicates.emplace_back(std::move(pred));
+  }
+  return predicates;
+}
+
+// Resolves the file columns of the properties in column_mappings, or of
+// default_names when no mapping is given. The default names are looked up by
+// name if the file has them all, otherwise the file columns from
+// default_offset on are taken in order.
+static void resolve_column_names(
+    const arrow::Schema& file_schema,
+    const std::vector<std::tuple<size_t, std::string, std::string>>&
+        column_mappings,
+    const std::vector<std::string>& default_names, size_t default_offset,
+    std::vector<std::string>& col_names,
+    std::vector<std::string>& property_names) {
+  if (column_mappings.empty()) {
+    bool by_name = true;
+    for (auto& name : default_names) {
+      if (file_schema.GetFieldIndex(name) < 0) {
+        by_name = false;
+        break;
+      }
+    }
+    if (!by_name) {
+      CHECK(default_offset + default_names.size() <=
+            static_cast<size_t>(file_schema.num_fields()))
+          << "File has " << file_schema.num_fields()
+          << " columns, but expect at least "
+          << default_offset + default_names.size();
+    }
+    for (size_t i = 0; i < default_names.size(); ++i) {
+      col_names.emplace_back(
+          by_name ? default_names[i]
+                  : file_schema.field(default_offset + i)->name());
+      property_names.emplace_back(default_names[i]);
+    }
+    return;
+  }
+  for (auto& [col_id, name, property_name] : column_mappings) {
+    std::string col_name = name;
+    if (col_name.empty()) {
+      if (col_id >= static_cast<size_t>(file_schema.num_fields())) {
+        LOG(FATAL) << "The specified column index: " << col_id
+                   << " is out of range, please check your configuration";
+      }
+      col_name = file_schema.field(col_id)->name();
+    } else if (file_schema.GetFieldIndex(col_name) < 0) {
+      LOG(FATAL) << "The specified column name: " << col_name
+                 << " does not exist in the file";
+    }
+    col_names.emplace_back(col_name);
+    property_names.emplace_back(property_name);
+  }
+}
+
+static std::string resolve_src_dst_column(
+    const arrow::Schema& file_schema,
+    const std::vector<std::pair<std::string, size_t>>& cols) {
+  CHECK(cols.size() == 1);
+  if (!cols[0].first.empty() && file_schema.GetFieldIndex(cols[0].first) >= 0) {
+    return cols[0].first;
+  }
+  CHECK(cols[0].second < static_cast<size_t>(file_schema.num_fields()))
+      << "The specified column index: " << cols[0].second
+      << " is out of range, please check your configuration";
+  return file_schema.field(cols[0].second)->name();
+}
+
+ParquetRecordBatchSupplier::ParquetRecordBatchSupplier(
+    label_t label_id, const std::string& file_path,
+    std::shared_ptr<parquet::FileMetaData> metadata,
+    std::shared_ptr<arrow::Schema> output_schema,
+    const std::vector<int>& row_groups,
+    const std::vector<ParquetColumnPredicate>& predicates)
+    : file_path_(file_path),
+      output_schema_(output_schema),
+      predicates_(predicates) {
+  if (row_groups.empty()) {
+    return;
+  }
+  file_reader_ = open_parquet_file(file_path, metadata);
+  std::vector<int> column_indices;
+  auto add_column = [&](const std::string& name) {
+    int leaf = metadata->schema()->ColumnIndex(name);
+    CHECK(leaf >= 0) << "Column [" << name
+                     << "] does not exist in file: " << file_path;
+    if (std::find(column_indices.begin(), column_indices.end(), leaf) ==
+        column_indices.end()) {
+      column_indices.emplace_back(leaf);
+    }
+  };
+  for (auto& field : output_schema_->fields()) {
+    add_column(field->name());
+  }
+  for (auto& pred : predicates_) {
+    add_column(pred.column);
+  }
+  auto status = file_reader_->GetRecordBatchReader(row_groups, column_indices,
+                                                   &reader_);
+  if (!status.ok()) {
+    LOG(FATAL) << "Failed to create record batch reader for file: "
+               << file_path << " error: " << status.message();
+  }
+  VLOG(10) << "Finish init ParquetRecordBatchSupplier for file: " << file_path
+           << ", row groups: " << row_groups.size()
+           << ", columns: " << column_indices.size();
+}
+
+std::shared_ptr<arrow::RecordBatch> ParquetRecordBatchSupplier::GetNextBatch() {
+  if (!reader_) {
+    return nullptr;
+  }
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+    auto status = reader_->ReadNext(&batch);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to read batch from file: " << file_path_
+                 << " error: " << status.message();
+      return nullptr;
+    }
+    if (batch == nullptr) {
+      return nullptr;
+    }
+    batch = filterAndCast(batch);
+    if (batch->num_rows() > 0) {
+      return batch;
+    }
+  }
+}
+
+std::shared_ptr<arrow::RecordBatch> ParquetRecordBatchSupplier::filterAndCast(
+    const std::shared_ptr<arrow::RecordBatch>& batch) const {
+  std::shared_ptr<arrow::RecordBatch> filtered = batch;
+  if (!predicates_.empty()) {
+    arrow::Datum mask;
+    for (auto& pred : predicates_) {
+      auto res = arrow::compute::CallFunction(
+          pred.func, {batch->GetColumnByName(pred.column), pred.value});
+      CHECK(res.ok()) << "Failed to evaluate filter on column: " << pred.column
+                      << " error: " << res.status().message();
+      if (mask.is_value()) {
+        auto combined = arrow::compute::And(mask, res.ValueOrDie());
+        CHECK(combined.ok()) << combined.status().message();
+        mask = combined.ValueOrDie();
+      } else {
+        mask = res.ValueOrDie();
+      }
+    }
+    // Rows whose comparison is null are dropped as well.
+    auto res = arrow::compute::Filter(batch, mask);
+    CHECK(res.ok()) << "Failed to filter batch from file: " << file_path_
+                    << " error: " << res.status().message();
+    filtered = res.ValueOrDie().record_batch();
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (auto& field : output_schema_->fields()) {
+    auto col = filtered->GetColumnByName(field->name());
+    if (!col->type()->Equals(field->type()) &&
+        !(is_string_type(col->type()) && is_string_type(field->type()))) {
+      auto res = arrow::compute::Cast(*col, field->type());
+      CHECK(res.ok()) << "Failed to cast column: " << field->name() << " from "
+                      << col->type()->ToString() << " to "
+                      << field->type()->ToString()
+                      << " error: " << res.status().message();
+      col = res.ValueOrDie();
+    }
+    columns.emplace_back(col);
+  }
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    fields.emplace_back(
+        arrow::field(output_schema_->field(i)->name(), columns[i]->type()));
+  }
+  return arrow::RecordBatch::Make(arrow::schema(fields), filtered->num_rows(),
+                                  columns);
+}
+
+std::shared_ptr<IFragmentLoader> ParquetFragmentLoader::Make(
+    const std::string& work_dir, const Schema& schema,
+    const LoadingConfig& loading_config) {
+  return std::shared_ptr<IFragmentLoader>(
+      new ParquetFragmentLoader(work_dir, schema, loading_config));
+}
+
+std::shared_ptr<arrow::Schema> ParquetFragmentLoader::vertexOutputSchema(
+    const arrow::Schema& file_schema, label_t v_label) const {
+  auto primary_keys = schema_.get_vertex_primary_key(v_label);
+  CHECK(primary_keys.size() == 1);
+  auto& primary_key = primary_keys[0];
+  auto property_names = schema_.get_vertex_property_names(v_label);
+  auto property_types = schema_.get_vertex_properties(v_label);
+  std::unordered_map<std::string, PropertyType> types;
+  for (size_t i = 0; i < property_names.size(); ++i) {
+    types.emplace(property_names[i], property_types[i]);
+  }
+  types.emplace(std::get<1>(primary_key), std::get<0>(primary_key));
+  // Same default as the csv loader: the primary key followed or preceded by
+  // the properties in schema order.
+  property_names.insert(property_names.begin() + std::get<2>(primary_key),
+                        std::get<1>(primary_key));
+
+  std::vector<std::string> col_names, mapped_property_names;
+  resolve_column_names(file_schema,
+                       loading_config_.GetVertexColumnMappings(v_label),
+                       property_names, 0, col_names, mapped_property_names);
+  CHECK(col_names.size() == types.size())
+      << "The mapping of vertex label: "
+      << schema_.get_vertex_label_name(v_label) << " has " << col_names.size()
+      << " columns, but expect " << types.size();
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < col_names.size(); ++i) {
+    auto iter = types.find(mapped_property_names[i]);
+    if (iter == types.end()) {
+      LOG(FATAL) << "The specified property name: " << mapped_property_names[i]
+                 << " does not exist in vertex label: "
+                 << schema_.get_vertex_label_name(v_label);
+    }
+    fields.emplace_back(
+        arrow::field(col_names[i], PropertyTypeToArrowType(iter->second)));
+  }
+  return arrow::schema(fields);
+}
+
+std::shared_ptr<arrow::Schema> ParquetFragmentLoader::edgeOutputSchema(
+    const arrow::Schema& file_schema, label_t src_label_id,
+    label_t dst_label_id, label_t e_label_id) const {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  auto src_dst_cols =
+      loading_config_.GetEdgeSrcDstCol(src_label_id, dst_label_id, e_label_id);
+  auto src_primary_keys = schema_.get_vertex_primary_key(src_label_id);
+  auto dst_primary_keys = schema_.get_vertex_primary_key(dst_label_id);
+  CHECK(src_primary_keys.size() == 1 && dst_primary_keys.size() == 1);
+  fields.emplace_back(
+      arrow::field(resolve_src_dst_column(file_schema, src_dst_cols.first),
+                   PropertyTypeToArrowType(std::get<0>(src_primary_keys[0]))));
+  fields.emplace_back(
+      arrow::field(resolve_src_dst_column(file_schema, src_dst_cols.second),
+                   PropertyTypeToArrowType(std::get<0>(dst_primary_keys[0]))));
+
+  auto property_names =
+      schema_.get_edge_property_names(src_label_id, dst_label_id, e_label_id);
+  auto property_types =
+      schema_.get_edge_properties(src_label_id, dst_label_id, e_label_id);
+  std::unordered_map<std::string, PropertyType> types;
+  for (size_t i = 0; i < property_names.size(); ++i) {
+    types.emplace(property_names[i], property_types[i]);
+  }
+  std::vector<std::string> col_names, mapped_property_names;
+  resolve_column_names(file_schema,
+                       loading_config_.GetEdgeColumnMappings(
+                           src_label_id, dst_label_id, e_label_id),
+                       property_names, 2, col_names, mapped_property_names);
+  for (size_t i = 0; i < col_names.size(); ++i) {
+    auto iter = types.find(mapped_property_names[i]);
+    if (iter == types.end()) {
+      LOG(FATAL) << "The specified property name: " << mapped_property_names[i]
+                 << " does not exist in edge label: "
+                 << schema_.get_edge_label_name(e_label_id);
+    }
+    fields.emplace_back(
+        arrow::field(col_names[i], PropertyTypeToArrowType(iter->second)));
+  }
+  return arrow::schema(fields);
+}
+
+std::vector<std::shared_ptr<IRecordBatchSupplier>>
+ParquetFragmentLoader::makeSuppliers(
+    label_t label_id, const std::string& file_path,
+    std::shared_ptr<parquet::FileMetaData> metadata,
+    std::shared_ptr<arrow::Schema> output_schema,
+    const std::vector<ParquetColumnPredicate>& predicates,
+    int worker_num) const {
+  std::vector<int> row_groups;
+  for (int i = 0; i < metadata->num_row_groups(); ++i) {
+    if (!prune_row_group(*metadata, i, predicates)) {
+      row_groups.emplace_back(i);
+    }
+  }
+  VLOG(10) << "Read " << row_groups.size() << " of "
+           << metadata->num_row_groups() << " row groups from " << file_path;
+  size_t supplier_num = std::max<size_t>(
+      1, std::min<size_t>(std::max(worker_num, 1), row_groups.size()));
+  // Interleaving balances the suppliers when row groups are of similar size.
+  std::vector<std::vector<int>> assigned(supplier_num);
+  for (size_t i = 0; i < row_groups.size(); ++i) {
+    assigned[i % supplier_num].emplace_back(row_groups[i]);
+  }
+  std::vector<std::shared_ptr<IRecordBatchSupplier>> suppliers;
+  for (auto& groups : assigned) {
+    suppliers.emplace_back(std::make_shared<ParquetRecordBatchSupplier>(
+        label_id, file_path, metadata, output_schema, groups, predicates));
+  }
+  return suppliers;
+}
+
+void ParquetFragmentLoader::addVertices(
+    label_t v_label_id, const std::vector<std::string>& v_files) {
+  auto record_batch_supplier_creator =
+      [this](label_t label_id, const std::string& v_file,
+             const LoadingConfig& loading_config, int worker_num) {
+        auto reader = open_parquet_file(v_file, nullptr);
+        auto metadata = reader->parquet_reader()->metadata();
+        std::shared_ptr<arrow::Schema> file_schema;
+        auto status = reader->GetSchema(&file_schema);
+        if (!status.ok()) {
+          LOG(FATAL) << "Failed to get schema of file: " << v_file
+                     << " error: " << status.message();
+        }
+        auto output_schema = vertexOutputSchema(*file_schema, label_id);
+        auto predicates = parse_filter(loading_config.GetVertexFilter(label_id),
+                                       *file_schema, v_file);
+        return makeSuppliers(label_id, v_file, metadata, output_schema,
+                             predicates, std::min(worker_num, thread_num_));
+      };
+  return AbstractArrowFragmentLoader::AddVerticesRecordBatch(
+      v_label_id, v_files, record_batch_supplier_creator);
+}
+
+void ParquetFragmentLoader::addEdges(label_t src_label_i, label_t dst_label_i,
+                                     label_t edge_label_i,
+                                     const std::vector<std::string>& e_files) {
+  auto lambda = [this](label_t src_label_id, label_t dst_label_id,
+                       label_t e_label_id, const std::string& e_file,
+                       const LoadingConfig& loading_config, int worker_num) {
+    auto reader = open_parquet_file(e_file, nullptr);
+    auto metadata = reader->parquet_reader()->metadata();
+    std::shared_ptr<arrow::Schema> file_schema;
+    auto status = reader->GetSchema(&file_schema);
+    if (!status.ok()) {
+      LOG(FATAL) << "Failed to get schema of file: " << e_file
+                 << " error: " << status.message();
+    }
+    auto output_schema = edgeOutputSchema(*file_schema, src_label_id,
+                                          dst_label_id, e_label_id);
+    auto predicates = parse_filter(
+        loading_config.GetEdgeFilter(src_label_id, dst_label_id, e_label_id),
+        *file_schema, e_file);
+    return makeSuppliers(e_label_id, e_file, metadata, output_schema,
+                         predicates, std::min(worker_num, thread_num_));
+  };
+  AbstractArrowFragmentLoader::AddEdgesRecordBatch(
+      src_label_i, dst_label_i, edge_label_i, e_files, lambda);
+}
+
+void ParquetFragmentLoader::loadVertices() {
+  auto vertex_sources = loading_config_.GetVertexLoadingMeta();
+  if (vertex_sources.empty()) {
+    LOG(INFO) << "Skip loading vertices since no vertex source is specified.";
+    return;
+  }
+
+  if (thread_num_ == 1) {
+    LOG(INFO) << "Loading vertices with single thread...";
+    for (auto iter = vertex_sources.begin(); iter != vertex_sources.end();
+         ++iter) {
+      addVertices(iter->first, iter->second);
+    }
+  } else {
+    std::vector<std::pair<label_t, std::vector<std::string>>> vertex_files;
+    for (auto iter = vertex_sources.begin(); iter != vertex_sources.end();
+         ++iter) {
+      vertex_files.emplace_back(iter->first, iter->second);
+    }
+    LOG(INFO) << "Parallel loading with " << thread_num_ << " threads, "
+              << " " << vertex_files.size() << " vertex files, ";
+    std::atomic<size_t> v_ind(0);
+    std::vector<std::thread> threads(thread_num_);
+    for (int i = 0; i < thread_num_; ++i) {
+      threads[i] = std::thread([&]() {
+        while (true) {
+          size_t cur = v_ind.fetch_add(1);
+          if (cur >= vertex_files.size()) {
+            break;
+          }
+          addVertices(vertex_files[cur].first, vertex_files[cur].second);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  LOG(INFO) << "Finished loading vertices";
+}
+
+void ParquetFragmentLoader::loadEdges() {
+  auto& edge_sources = loading_config_.GetEdgeLoadingMeta();
+  if (edge_sources.empty()) {
+    LOG(INFO) << "Skip loading edges since no edge source is specified.";
+    return;
+  }
+
+  if (thread_num_ == 1) {
+    LOG(INFO) << "Loading edges with single thread...";
+    for (auto iter = edge_sources.begin(); iter != edge_sources.end(); ++iter) {
+      auto& src_label_id = std::get<0>(iter->first);
+      auto& dst_label_id = std::get<1>(iter->first);
+      auto& e_label_id = std::get<2>(iter->first);
+      addEdges(src_label_id, dst_label_id, e_label_id, iter->second);
+    }
+  } else {
+    std::vector<std::pair<typename LoadingConfig::edge_triplet_type,
+                          std::vector<std::string>>>
+        edge_files;
+    for (auto iter = edge_sources.begin(); iter != edge_sources.end(); ++iter) {
+      edge_files.emplace_back(iter->first, iter->second);
+    }
+    LOG(INFO) << "Parallel loading with " << thread_num_ << " threads, "
+              << edge_files.size() << " edge files.";
+    std::atomic<size_t> e_ind(0);
+    std::vector<std::thread> threads(thread_num_);
+    for (int i = 0; i < thread_num_; ++i) {
+      threads[i] = std::thread([&]() {
+        while (true) {
+          size_t cur = e_ind.fetch_add(1);
+          if (cur >= edge_files.size()) {
+            break;
+          }
+          auto& edge_file = edge_files[cur];
+          addEdges(std::get<0>(edge_file.first), std::get<1>(edge_file.first),
+                   std::get<2>(edge_file.first), edge_file.second);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  LOG(INFO) << "Finished loading edges";
+}
+
+Result<bool> ParquetFragmentLoader::LoadFragment() {
+  try {
+    loadVertices();
+    loadEdges();
+
+    basic_fragment_loader_.LoadFragment();
+  } catch (const std::exception& e) {
+    auto work_dir = basic_fragment_loader_.work_dir();
+    printDiskRemaining(work_dir);
+    LOG(ERROR) << "Load fragment failed: " << e.what();
+    return Result<bool>(StatusCode::INTERNAL_ERROR,
+                        "Load fragment failed: " + std::string(e.what()),
+                        false);
+  }
+  return Result<bool>(true);
+}
+
+const bool ParquetFragmentLoader::registered_ =
+    LoaderFactory::Register("file", "parquet",
+                            static_cast<LoaderFactory::loader_initializer_t>(
+                                &ParquetFragmentLoader::Make));
+
+}  // namespace gs
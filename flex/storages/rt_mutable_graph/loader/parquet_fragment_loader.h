@@ -0,0 +1,120 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_LOADER_PARQUET_FRAGMENT_LOADER_H_
+#define STORAGES_RT_MUTABLE_GRAPH_LOADER_PARQUET_FRAGMENT_LOADER_H_
+
+#include "flex/storages/rt_mutable_graph/loader/abstract_arrow_fragment_loader.h"
+#include "flex/storages/rt_mutable_graph/loader/basic_fragment_loader.h"
+#include "flex/storages/rt_mutable_graph/loader/i_fragment_loader.h"
+#include "flex/storages/rt_mutable_graph/loader/loader_factory.h"
+#include "flex/storages/rt_mutable_graph/loading_config.h"
+#include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+
+#include "grape/util.h"
+
+namespace gs {
+
+// A comparison between a column of the file and a literal, parsed from the
+// filter of a vertex or edge mapping. func is the name of the arrow compute
+// comparison function, e.g. "less_equal".
+struct ParquetColumnPredicate {
+  std::string column;
+  std::string func;
+  std::shared_ptr<arrow::Scalar> value;
+};
+
+// Reads the given row groups of a parquet file. Only the columns named in
+// output_schema, and those the predicates refer to, are decoded. The rows
+// that do not match all the predicates are dropped, and the columns are cast
+// to the types of output_schema and returned in its order.
+class ParquetRecordBatchSupplier : public IRecordBatchSupplier {
+ public:
+  ParquetRecordBatchSupplier(
+      label_t label_id, const std::string& file_path,
+      std::shared_ptr<parquet::FileMetaData> metadata,
+      std::shared_ptr<arrow::Schema> output_schema,
+      const std::vector<int>& row_groups,
+      const std::vector<ParquetColumnPredicate>& predicates);
+
+  std::shared_ptr<arrow::RecordBatch> GetNextBatch() override;
+
+ private:
+  std::shared_ptr<arrow::RecordBatch> filterAndCast(
+      const std::shared_ptr<arrow::RecordBatch>& batch) const;
+
+  std::string file_path_;
+  std::shared_ptr<arrow::Schema> output_schema_;
+  std::vector<ParquetColumnPredicate> predicates_;
+  std::unique_ptr<parquet::arrow::FileReader> file_reader_;
+  std::unique_ptr<arrow::RecordBatchReader> reader_;
+};
+
+// LoadFragment for parquet files. The row groups of a file are read by
+// several suppliers in parallel, and the row groups whose statistics show
+// that no row matches the filter of the mapping are not read at all.
+class ParquetFragmentLoader : public AbstractArrowFragmentLoader {
+ public:
+  ParquetFragmentLoader(const std::string& work_dir, const Schema& schema,
+                        const LoadingConfig& loading_config)
+      : AbstractArrowFragmentLoader(work_dir, schema, loading_config) {}
+
+  static std::shared_ptr<IFragmentLoader> Make(
+      const std::string& work_dir, const Schema& schema,
+      const LoadingConfig& loading_config);
+
+  ~ParquetFragmentLoader() {}
+
+  Result<bool> LoadFragment() override;
+
+ private:
+  void loadVertices();
+
+  void loadEdges();
+
+  void addVertices(label_t v_label_id, const std::vector<std::string>& v_files);
+
+  void addEdges(label_t src_label_id, label_t dst_label_id, label_t e_label_id,
+                const std::vector<std::string>& e_files);
+
+  // Returns the columns to read from the file for the vertex label, with the
+  // types they are cast to, ordered as the loader expects them.
+  std::shared_ptr<arrow::Schema> vertexOutputSchema(
+      const arrow::Schema& file_schema, label_t v_label) const;
+
+  // Returns the src and dst columns followed by the property columns of the
+  // edge triplet, with the types they are cast to.
+  std::shared_ptr<arrow::Schema> edgeOutputSchema(
+      const arrow::Schema& file_schema, label_t src_label_id,
+      label_t dst_label_id, label_t e_label_id) const;
+
+  std::vector<std::shared_ptr<IRecordBatchSupplier>> makeSuppliers(
+      label_t label_id, const std::string& file_path,
+      std::shared_ptr<parquet::FileMetaData> metadata,
+      std::shared_ptr<arrow::Schema> output_schema,
+      const std::vector<ParquetColumnPredicate>& predicates,
+      int worker_num) const;
+
+  static const bool registered_;
+};
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_LOADER_PARQUET_FRAGMENT_LOADER_H_
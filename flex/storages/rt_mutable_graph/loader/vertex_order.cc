@@ -0,0 +1,275 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/loader/vertex_order.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <tuple>
+
+namespace gs {
+
+namespace vertex_order_impl {
+
+// A csr holding edges of the vertices of a label, and the label of their
+// neighbors.
+struct LabelCsr {
+  const CsrBase* csr;
+  label_t nbr_label;
+};
+
+static std::vector<std::vector<LabelCsr>> label_csrs(
+    const MutablePropertyFragment& graph) {
+  const auto& schema = graph.schema();
+  size_t vertex_label_num = schema.vertex_label_num();
+  size_t edge_label_num = schema.edge_label_num();
+  std::vector<std::vector<LabelCsr>> ret(vertex_label_num);
+  for (label_t src = 0; src < vertex_label_num; ++src) {
+    for (label_t dst = 0; dst < vertex_label_num; ++dst) {
+      for (label_t e = 0; e < edge_label_num; ++e) {
+        size_t index = src * vertex_label_num * edge_label_num +
+                       dst * edge_label_num + e;
+        if (graph.oe_[index] != NULL) {
+          ret[src].push_back({graph.oe_[index], dst});
+        }
+        if (graph.ie_[index] != NULL) {
+          ret[dst].push_back({graph.ie_[index], src});
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+static std::vector<std::vector<int>> vertex_degrees(
+    const MutablePropertyFragment& graph,
+    const std::vector<std::vector<LabelCsr>>& csrs) {
+  std::vector<std::vector<int>> ret(csrs.size());
+  for (label_t label = 0; label < csrs.size(); ++label) {
+    auto& degree = ret[label];
+    degree.resize(graph.lf_indexers_[label].size(), 0);
+    for (const auto& lc : csrs[label]) {
+      size_t vnum = std::min(degree.size(), lc.csr->size());
+      for (vid_t v = 0; v < vnum; ++v) {
+        degree[v] += lc.csr->edge_iter(v)->size();
+      }
+    }
+  }
+  return ret;
+}
+
+static std::vector<vid_t> order_to_ids(const std::vector<vid_t>& order) {
+  std::vector<vid_t> ret(order.size());
+  for (size_t k = 0; k < order.size(); ++k) {
+    ret[order[k]] = k;
+  }
+  return ret;
+}
+
+static std::vector<std::vector<vid_t>> degree_order(
+    const std::vector<std::vector<int>>& degrees) {
+  std::vector<std::vector<vid_t>> ret;
+  for (const auto& degree : degrees) {
+    std::vector<vid_t> order(degree.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](vid_t a, vid_t b) {
+      return degree[a] > degree[b];
+    });
+    ret.emplace_back(order_to_ids(order));
+  }
+  return ret;
+}
+
+// Reverse Cuthill-McKee over the vertices of all labels: a breadth-first
+// traversal started from the unvisited vertex of the lowest degree, which
+// visits the neighbors of each vertex by ascending degree. Each label
+// numbers its vertices by the reverse of the order they were visited in.
+static std::vector<std::vector<vid_t>> rcm_order(
+    const std::vector<std::vector<LabelCsr>>& csrs,
+    const std::vector<std::vector<int>>& degrees) {
+  std::vector<std::pair<label_t, vid_t>> starts;
+  std::vector<std::vector<bool>> visited(degrees.size());
+  for (label_t label = 0; label < degrees.size(); ++label) {
+    visited[label].resize(degrees[label].size(), false);
+    for (vid_t v = 0; v < degrees[label].size(); ++v) {
+      starts.emplace_back(label, v);
+    }
+  }
+  std::stable_sort(starts.begin(), starts.end(),
+                   [&](const std::pair<label_t, vid_t>& a,
+                       const std::pair<label_t, vid_t>& b) {
+                     return degrees[a.first][a.second] <
+                            degrees[b.first][b.second];
+                   });
+
+  std::vector<std::vector<vid_t>> visit_order(degrees.size());
+  std::vector<std::pair<label_t, vid_t>> queue;
+  std::vector<std::tuple<int, label_t, vid_t>> nbrs;
+  for (const auto& start : starts) {
+    if (visited[start.first][start.second]) {
+      continue;
+    }
+    visited[start.first][start.second] = true;
+    queue.clear();
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size(); ++head) {
+      label_t label = queue[head].first;
+      vid_t v = queue[head].second;
+      visit_order[label].push_back(v);
+      nbrs.clear();
+      for (const auto& lc : csrs[label]) {
+        if (v >= lc.csr->size()) {
+          continue;
+        }
+        auto& nbr_visited = visited[lc.nbr_label];
+        for (auto it = lc.csr->edge_iter(v); it->is_valid(); it->next()) {
+          vid_t u = it->get_neighbor();
+          if (u < nbr_visited.size() && !nbr_visited[u]) {
+            nbr_visited[u] = true;
+            nbrs.emplace_back(degrees[lc.nbr_label][u], lc.nbr_label, u);
+          }
+        }
+      }
+      std::stable_sort(nbrs.begin(), nbrs.end(),
+                       [](const std::tuple<int, label_t, vid_t>& a,
+                          const std::tuple<int, label_t, vid_t>& b) {
+                         return std::get<0>(a) < std::get<0>(b);
+                       });
+      for (const auto& nbr : nbrs) {
+        queue.emplace_back(std::get<1>(nbr), std::get<2>(nbr));
+      }
+    }
+  }
+
+  std::vector<std::vector<vid_t>> ret;
+  for (auto& order : visit_order) {
+    std::reverse(order.begin(), order.end());
+    ret.emplace_back(order_to_ids(order));
+  }
+  return ret;
+}
+
+}  // namespace vertex_order_impl
+
+bool can_renumber_vertices(const Schema& schema) {
+#ifdef USE_PTHASH
+  LOG(WARNING) << "The ids of pthash indexers are fixed by their keys";
+  return false;
+#else
+  size_t vertex_label_num = schema.vertex_label_num();
+  size_t edge_label_num = schema.edge_label_num();
+  for (label_t src = 0; src < vertex_label_num; ++src) {
+    auto src_name = schema.get_vertex_label_name(src);
+    for (label_t dst = 0; dst < vertex_label_num; ++dst) {
+      auto dst_name = schema.get_vertex_label_name(dst);
+      for (label_t e = 0; e < edge_label_num; ++e) {
+        auto edge_name = schema.get_edge_label_name(e);
+        if (!schema.exist(src_name, dst_name, edge_name)) {
+          continue;
+        }
+        if (schema.get_outgoing_edge_compression(src_name, dst_name,
+                                                 edge_name) !=
+                EdgeCompression::kNone ||
+            schema.get_incoming_edge_compression(src_name, dst_name,
+                                                 edge_name) !=
+                EdgeCompression::kNone) {
+          LOG(WARNING) << "Compressed csrs of " << src_name << " -["
+                       << edge_name << "]-> " << dst_name
+                       << " can not be renumbered";
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+#endif
+}
+
+std::vector<std::vector<vid_t>> compute_vertex_order(
+    const MutablePropertyFragment& graph, VertexOrder order) {
+  auto csrs = vertex_order_impl::label_csrs(graph);
+  auto degrees = vertex_order_impl::vertex_degrees(graph, csrs);
+  if (order == VertexOrder::kDegree) {
+    return vertex_order_impl::degree_order(degrees);
+  } else if (order == VertexOrder::kRcm) {
+    return vertex_order_impl::rcm_order(csrs, degrees);
+  }
+  std::vector<std::vector<vid_t>> ret;
+  for (const auto& degree : degrees) {
+    std::vector<vid_t> ids(degree.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    ret.emplace_back(std::move(ids));
+  }
+  return ret;
+}
+
+void renumber_vertices(MutablePropertyFragment& graph,
+                       const std::vector<std::vector<vid_t>>& new_ids) {
+#ifdef USE_PTHASH
+  LOG(FATAL) << "Vertices of pthash indexers can not be renumbered";
+#else
+  const auto& schema = graph.schema();
+  size_t vertex_label_num = schema.vertex_label_num();
+  size_t edge_label_num = schema.edge_label_num();
+  std::vector<std::function<void()>> tasks;
+  for (label_t label = 0; label < vertex_label_num; ++label) {
+    tasks.emplace_back([&graph, &new_ids, label]() {
+      graph.lf_indexers_[label].permute(new_ids[label]);
+    });
+    tasks.emplace_back([&graph, &new_ids, label]() {
+      graph.vertex_data_[label].permute(new_ids[label]);
+    });
+  }
+  for (label_t src = 0; src < vertex_label_num; ++src) {
+    for (label_t dst = 0; dst < vertex_label_num; ++dst) {
+      for (label_t e = 0; e < edge_label_num; ++e) {
+        size_t index = src * vertex_label_num * edge_label_num +
+                       dst * edge_label_num + e;
+        if (graph.oe_[index] != NULL) {
+          tasks.emplace_back([&graph, &new_ids, index, src, dst]() {
+            graph.oe_[index]->batch_relabel(new_ids[src], new_ids[dst]);
+          });
+        }
+        if (graph.ie_[index] != NULL) {
+          tasks.emplace_back([&graph, &new_ids, index, src, dst]() {
+            graph.ie_[index]->batch_relabel(new_ids[dst], new_ids[src]);
+          });
+        }
+      }
+    }
+  }
+
+  int thread_num = std::min<int>(
+      tasks.size(), std::max<int>(std::thread::hardware_concurrency(), 1));
+  std::atomic<size_t> task_id(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      size_t cur;
+      while ((cur = task_id.fetch_add(1)) < tasks.size()) {
+        tasks[cur]();
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+#endif
+}
+
+}  // namespace gs
@@ -0,0 +1,44 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_LOADER_VERTEX_ORDER_H_
+#define STORAGES_RT_MUTABLE_GRAPH_LOADER_VERTEX_ORDER_H_
+
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
+
+namespace gs {
+
+// Returns whether the vertices of graph can be renumbered, i.e. the indexers
+// do not fix the ids and no csr is compressed.
+bool can_renumber_vertices(const Schema& schema);
+
+// Returns new_ids, where new_ids[label][v] is the id that vertex v of the
+// label gets in the given order. The degrees and the traversal count the
+// edges of all the triplets a label takes part in, in both directions.
+std::vector<std::vector<vid_t>> compute_vertex_order(
+    const MutablePropertyFragment& graph, VertexOrder order);
+
+// Renumbers the vertices of graph, opened in memory, by new_ids. The
+// indexers, the vertex tables and the csrs are rewritten, while the edge
+// properties stay in place as the csrs refer to them by index. The new
+// adjacency lists are unsorted until the graph is dumped.
+void renumber_vertices(MutablePropertyFragment& graph,
+                       const std::vector<std::vector<vid_t>>& new_ids);
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_LOADER_VERTEX_ORDER_H_
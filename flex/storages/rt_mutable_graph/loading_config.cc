@@ -15,6 +15,7 @@
 
 #include "flex/storages/rt_mutable_graph/loading_config.h"
 #include <yaml-cpp/yaml.h>
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 #include <sstream>
@@ -209,7 +210,8 @@ static Status parse_vertex_files(
     std::unordered_map<label_t, std::vector<std::string>>& files,
     std::unordered_map<
         label_t, std::vector<std::tuple<size_t, std::string, std::string>>>&
-        vertex_mapping) {
+        vertex_mapping,
+    std::unordered_map<label_t, std::string>& vertex_filters) {
   std::string label_name;
   if (!get_scalar(node, "type_name", label_name)) {
     return Status(StatusCode::INVALID_IMPORT_FILE,
@@ -260,6 +262,11 @@ static Status parse_vertex_files(
     vertex_mapping.emplace(
         label_id, std::vector<std::tuple<size_t, std::string, std::string>>());
   }
+  std::string filter;
+  if (get_scalar(node, "filter", filter) && !filter.empty()) {
+    VLOG(10) << "Filter for vertex [" << label_name << "]: " << filter;
+    vertex_filters[label_id] = filter;
+  }
   if (files_node) {
     if (!files_node.IsSequence()) {
       LOG(ERROR) << "Expect field [inputs] for vertex [" << label_name
@@ -306,7 +313,8 @@ static Status parse_vertices_files_schema(
     std::unordered_map<label_t, std::vector<std::string>>& files,
     std::unordered_map<
         label_t, std::vector<std::tuple<size_t, std::string, std::string>>>&
-        column_mappings) {
+        column_mappings,
+    std::unordered_map<label_t, std::string>& vertex_filters) {
   if (!node.IsSequence()) {
     LOG(ERROR) << "vertex is not set properly";
     return Status(StatusCode::INVALID_IMPORT_FILE,
@@ -315,7 +323,8 @@ static Status parse_vertices_files_schema(
   int num = node.size();
   for (int i = 0; i < num; ++i) {
     RETURN_IF_NOT_OK(parse_vertex_files(node[i], schema, scheme, data_location,
-                                        files, column_mappings));
+                                        files, column_mappings,
+                                        vertex_filters));
   }
   return Status::OK();
 }
@@ -334,7 +343,10 @@ static Status parse_edge_files(
                        std::pair<std::vector<std::pair<std::string, size_t>>,
                                  std::vector<std::pair<std::string, size_t>>>,
                        boost::hash<typename LoadingConfig::edge_triplet_type>>&
-        edge_src_dst_col) {
+        edge_src_dst_col,
+    std::unordered_map<typename LoadingConfig::edge_triplet_type, std::string,
+                       boost::hash<typename LoadingConfig::edge_triplet_type>>&
+        edge_filters) {
   if (!node["type_triplet"]) {
     LOG(ERROR) << "edge [type_triplet] is not set properly";
     return Status(StatusCode::INVALID_IMPORT_FILE,
@@ -456,6 +468,12 @@ static Status parse_edge_files(
         std::tuple{src_label_id, dst_label_id, edge_label_id},
         std::vector<std::tuple<size_t, std::string, std::string>>{});
   }
+  std::string filter;
+  if (get_scalar(node, "filter", filter) && !filter.empty()) {
+    VLOG(10) << "Filter for edge [" << edge_label << "]: " << filter;
+    edge_filters[std::tuple{src_label_id, dst_label_id, edge_label_id}] =
+        filter;
+  }
 
   YAML::Node files_node = node["inputs"];
   if (files_node) {
@@ -513,7 +531,10 @@ static Status parse_edges_files_schema(
                        std::pair<std::vector<std::pair<std::string, size_t>>,
                                  std::vector<std::pair<std::string, size_t>>>,
                        boost::hash<typename LoadingConfig::edge_triplet_type>>&
-        edge_src_dst_col) {
+        edge_src_dst_col,
+    std::unordered_map<typename LoadingConfig::edge_triplet_type, std::string,
+                       boost::hash<typename LoadingConfig::edge_triplet_type>>&
+        edge_filters) {
   if (!node.IsSequence()) {
     LOG(ERROR) << "Field [edge_mappings] should be a list";
     return Status(StatusCode::INVALID_IMPORT_FILE,
@@ -523,7 +544,8 @@ static Status parse_edges_files_schema(
   LOG(INFO) << " Try to parse " << num << " edge configuration";
   for (int i = 0; i < num; ++i) {
     RETURN_IF_NOT_OK(parse_edge_files(node[i], schema, scheme, data_location,
-                                      files, edge_mapping, edge_src_dst_col));
+                                      files, edge_mapping, edge_src_dst_col,
+                                      edge_filters));
   }
   return Status::OK();
 }
@@ -542,6 +564,8 @@ Status parse_bulk_load_method(const YAML::Node& node, BulkLoadMethod& method) {
       method = BulkLoadMethod::kInit;
     } else if (method_str == "overwrite") {
       method = BulkLoadMethod::kOverwrite;
+    } else if (method_str == "append") {
+      method = BulkLoadMethod::kAppend;
     } else {
       LOG(ERROR) << "Unknown import_option: " << method_str;
       return Status(StatusCode::INVALID_ARGUMENT,
@@ -553,6 +577,64 @@ Status parse_bulk_load_method(const YAML::Node& node, BulkLoadMethod& method) {
   return Status::OK();
 }
 
+Status parse_vertex_order(const YAML::Node& node, VertexOrder& order) {
+  std::string order_str;
+  if (get_scalar(node, loader_options::VERTEX_ORDER, order_str)) {
+    if (order_str == "input") {
+      order = VertexOrder::kInput;
+    } else if (order_str == "degree") {
+      order = VertexOrder::kDegree;
+    } else if (order_str == "rcm") {
+      order = VertexOrder::kRcm;
+    } else {
+      LOG(ERROR) << "Unknown vertex_order: " << order_str;
+      return Status(StatusCode::INVALID_ARGUMENT,
+                    "Unknown vertex_order: " + order_str);
+    }
+  }
+  return Status::OK();
+}
+
+// e.g. partition: {method: range, num: 4, id: 1, bounds: [100, 200, 300]}
+Status parse_partition(const YAML::Node& node,
+                       VertexPartitioner& partitioner) {
+  auto partition_node = node[loader_options::PARTITION];
+  if (!partition_node) {
+    return Status::OK();
+  }
+  std::string method_str = "hash";
+  uint32_t num = 1, id = 0;
+  std::vector<int64_t> bounds;
+  get_scalar(partition_node, "method", method_str);
+  get_scalar(partition_node, "num", num);
+  get_scalar(partition_node, "id", id);
+  if (partition_node["bounds"]) {
+    bounds = partition_node["bounds"].as<std::vector<int64_t>>();
+  }
+  PartitionMethod method;
+  if (method_str == "hash") {
+    method = PartitionMethod::kHash;
+  } else if (method_str == "range") {
+    method = PartitionMethod::kRange;
+    if (bounds.size() + 1 != num ||
+        !std::is_sorted(bounds.begin(), bounds.end())) {
+      return Status(StatusCode::INVALID_ARGUMENT,
+                    "Range partitioning needs num - 1 sorted bounds");
+    }
+  } else {
+    return Status(StatusCode::INVALID_ARGUMENT,
+                  "Unknown partition method: " + method_str);
+  }
+  if (num == 0 || id >= num) {
+    return Status(StatusCode::INVALID_ARGUMENT,
+                  "Invalid partition id " + std::to_string(id) + " of " +
+                      std::to_string(num));
+  }
+  partitioner = VertexPartitioner(method, num, id, bounds);
+  VLOG(10) << "Loading partition " << id << " of " << num;
+  return Status::OK();
+}
+
 Status parse_bulk_load_config_yaml(const YAML::Node& root, const Schema& schema,
                                    LoadingConfig& load_config) {
   std::string data_location;
@@ -585,6 +667,10 @@ Status parse_bulk_load_config_yaml(const YAML::Node& root, const Schema& schema,
         VLOG(10) << "Use mmap vector is set to: "
                  << load_config.use_mmap_vector_;
       }
+      RETURN_IF_NOT_OK(parse_vertex_order(loading_config_node["x_csr_params"],
+                                          load_config.vertex_order_));
+      RETURN_IF_NOT_OK(parse_partition(loading_config_node["x_csr_params"],
+                                       load_config.partitioner_));
     }
 
     RETURN_IF_NOT_OK(
@@ -663,10 +749,11 @@ Status parse_bulk_load_config_yaml(const YAML::Node& root, const Schema& schema,
     return Status(StatusCode::INVALID_ARGUMENT, "loading_config is not set");
   }
   if (load_config.method_ != BulkLoadMethod::kInit &&
-      load_config.method_ != BulkLoadMethod::kOverwrite) {
-    LOG(ERROR) << "Only support init/overwrite method now";
+      load_config.method_ != BulkLoadMethod::kOverwrite &&
+      load_config.method_ != BulkLoadMethod::kAppend) {
+    LOG(ERROR) << "Only support init/overwrite/append method now";
     return Status(StatusCode::INVALID_ARGUMENT,
-                  "Only support init/overwrite method now");
+                  "Only support init/overwrite/append method now");
   }
   if (data_location.empty()) {
     LOG(WARNING) << "No data location is configured, If it is intended, "
@@ -690,14 +777,15 @@ Status parse_bulk_load_config_yaml(const YAML::Node& root, const Schema& schema,
     //   return false;
     RETURN_IF_NOT_OK(parse_vertices_files_schema(
         root["vertex_mappings"], schema, load_config.scheme_, data_location,
-        load_config.vertex_loading_meta_, load_config.vertex_column_mappings_));
+        load_config.vertex_loading_meta_, load_config.vertex_column_mappings_,
+        load_config.vertex_filters_));
   }
   if (root["edge_mappings"]) {
     VLOG(10) << "edge_mappings is set";
     RETURN_IF_NOT_OK(parse_edges_files_schema(
         root["edge_mappings"], schema, load_config.scheme_, data_location,
         load_config.edge_loading_meta_, load_config.edge_column_mappings_,
-        load_config.edge_src_dst_col_));
+        load_config.edge_src_dst_col_, load_config.edge_filters_));
     // if (!parse_edges_files_schema(
     //         root["edge_mappings"], schema, load_config.scheme_,
     //         data_location, load_config.edge_loading_meta_,
@@ -758,7 +846,8 @@ LoadingConfig::LoadingConfig(const Schema& schema)
       format_("csv"),
       parallelism_(loader_options::DEFAULT_PARALLELISM),
       build_csr_in_mem_(loader_options::DEFAULT_BUILD_CSR_IN_MEM),
-      use_mmap_vector_(loader_options::DEFAULT_USE_MMAP_VECTOR) {}
+      use_mmap_vector_(loader_options::DEFAULT_USE_MMAP_VECTOR),
+      vertex_order_(VertexOrder::kInput) {}
 
 LoadingConfig::LoadingConfig(const Schema& schema,
                              const std::string& data_source,
@@ -771,7 +860,8 @@ LoadingConfig::LoadingConfig(const Schema& schema,
       format_(format),
       parallelism_(loader_options::DEFAULT_PARALLELISM),
       build_csr_in_mem_(loader_options::DEFAULT_BUILD_CSR_IN_MEM),
-      use_mmap_vector_(loader_options::DEFAULT_USE_MMAP_VECTOR) {
+      use_mmap_vector_(loader_options::DEFAULT_USE_MMAP_VECTOR),
+      vertex_order_(VertexOrder::kInput) {
   metadata_[reader_options::DELIMITER] = delimiter;
 }
 
@@ -922,4 +1012,17 @@ LoadingConfig::GetEdgeSrcDstCol(label_t src_label_id, label_t dst_label_id,
   return edge_src_dst_col_.at(key);
 }
 
+std::string LoadingConfig::GetVertexFilter(label_t label_id) const {
+  auto iter = vertex_filters_.find(label_id);
+  return iter == vertex_filters_.end() ? "" : iter->second;
+}
+
+std::string LoadingConfig::GetEdgeFilter(label_t src_label_id,
+                                         label_t dst_label_id,
+                                         label_t edge_label_id) const {
+  auto iter = edge_filters_.find(
+      std::make_tuple(src_label_id, dst_label_id, edge_label_id));
+  return iter == edge_filters_.end() ? "" : iter->second;
+}
+
 }  // namespace gs
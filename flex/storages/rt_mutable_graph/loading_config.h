@@ -26,6 +26,7 @@
 #include <unordered_set>
 #include "arrow/api.h"
 #include "arrow/csv/options.h"
+#include "flex/storages/rt_mutable_graph/partitioner.h"
 #include "flex/storages/rt_mutable_graph/schema.h"
 #include "flex/utils/arrow_utils.h"
 #include "flex/utils/yaml_utils.h"
@@ -66,6 +67,8 @@ namespace loader_options {
 static constexpr const char* PARALLELISM = "parallelism";
 static constexpr const char* BUILD_CSR_IN_MEM = "build_csr_in_mem";
 static constexpr const char* USE_MMAP_VECTOR = "use_mmap_vector";
+static constexpr const char* VERTEX_ORDER = "vertex_order";
+static constexpr const char* PARTITION = "partition";
 static constexpr const int32_t DEFAULT_PARALLELISM = 1;
 static constexpr const bool DEFAULT_BUILD_CSR_IN_MEM = false;
 static constexpr const bool DEFAULT_USE_MMAP_VECTOR = false;
@@ -83,7 +86,9 @@ Status parse_bulk_load_config_yaml(const YAML::Node& yaml_node,
                                    LoadingConfig& load_config);
 }  // namespace config_parsing
 
-enum class BulkLoadMethod { kInit = 0, kOverwrite = 1 };
+// kAppend adds the vertices and edges to the current snapshot of an existing
+// graph, and writes the result as its next snapshot.
+enum class BulkLoadMethod { kInit = 0, kOverwrite = 1, kAppend = 2 };
 
 // Provide meta info about bulk loading.
 class LoadingConfig {
@@ -159,6 +164,15 @@ class LoadingConfig {
   GetEdgeSrcDstCol(label_t src_label_id, label_t dst_label_id,
                    label_t edge_label_id) const;
 
+  // Get the row filter of a vertex label or an edge triplet, given by the
+  // optional [filter] field of its mapping, or an empty string if not set.
+  // A filter is a conjunction of comparisons between a column and a literal,
+  // e.g. "age >= 18 and city == Beijing". Loaders that can evaluate it skip
+  // the rows that do not match.
+  std::string GetVertexFilter(label_t label_id) const;
+  std::string GetEdgeFilter(label_t src_label_id, label_t dst_label_id,
+                            label_t edge_label_id) const;
+
   inline void SetParallelism(int32_t parallelism) {
     parallelism_ = parallelism;
   }
@@ -168,9 +182,19 @@ class LoadingConfig {
   inline void SetUseMmapVector(bool use_mmap_vector) {
     use_mmap_vector_ = use_mmap_vector;
   }
+  inline void SetVertexOrder(VertexOrder vertex_order) {
+    vertex_order_ = vertex_order;
+  }
+  inline void SetPartitioner(const VertexPartitioner& partitioner) {
+    partitioner_ = partitioner;
+  }
   inline int32_t GetParallelism() const { return parallelism_; }
   inline bool GetBuildCsrInMem() const { return build_csr_in_mem_; }
   inline bool GetUseMmapVector() const { return use_mmap_vector_; }
+  inline VertexOrder GetVertexOrder() const { return vertex_order_; }
+  inline const VertexPartitioner& GetPartitioner() const {
+    return partitioner_;
+  }
 
  private:
   const Schema& schema_;
@@ -180,6 +204,10 @@ class LoadingConfig {
   int32_t parallelism_;    // Number of thread should be used in loading
   bool build_csr_in_mem_;  // Whether to build csr in memory
   bool use_mmap_vector_;   // Whether to use mmap vector
+  // How the vertices are numbered once loaded.
+  VertexOrder vertex_order_;
+  // The shard of a partitioned graph to load, see x_csr_params.partition.
+  VertexPartitioner partitioner_;
 
   std::vector<std::string> null_values_;
 
@@ -219,6 +247,11 @@ class LoadingConfig {
                      boost::hash<edge_triplet_type>>
       edge_src_dst_col_;
 
+  std::unordered_map<schema_label_type, std::string> vertex_filters_;
+  std::unordered_map<edge_triplet_type, std::string,
+                     boost::hash<edge_triplet_type>>
+      edge_filters_;
+
   friend Status config_parsing::parse_bulk_load_config_file(
       const std::string& config_file, const Schema& schema,
       LoadingConfig& load_config);
@@ -239,6 +272,9 @@ inline ostream& operator<<(ostream& os, const gs::BulkLoadMethod& method) {
   case gs::BulkLoadMethod::kOverwrite:
     os << "overwrite";
     break;
+  case gs::BulkLoadMethod::kAppend:
+    os << "append";
+    break;
   default:
     os << "unknown";
     break;
@@ -15,13 +15,42 @@
 
 #include "flex/storages/rt_mutable_graph/mutable_property_fragment.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "flex/engines/hqps_db/core/utils/hqps_utils.h"
 #include "flex/storages/rt_mutable_graph/file_names.h"
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
+#include "flex/utils/file_utils.h"
 #include "flex/utils/property/types.h"
 
 namespace gs {
 
-MutablePropertyFragment::MutablePropertyFragment() {}
+// The capacity whose address space is reserved for a vertex label, which it
+// grows to online with nothing moved: the max_vertex_num of the schema, as
+// far as a vid_t counts, or its vertices if it has more. Only the pages
+// written are committed.
+static size_t vertex_reservation(const Schema& schema, label_t label,
+                                 size_t vertex_num) {
+  size_t max_vnum = std::min<size_t>(
+      schema.get_max_vnum(schema.get_vertex_label_name(label)),
+      std::numeric_limits<vid_t>::max());
+  return std::max(vertex_num, max_vnum);
+}
+
+MutablePropertyFragment::MutablePropertyFragment() : schema_change_num_(0) {}
 
 MutablePropertyFragment::~MutablePropertyFragment() {
   std::vector<size_t> degree_list(vertex_label_num_, 0);
@@ -52,6 +81,7 @@ void MutablePropertyFragment::loadSchema(const std::string& schema_path) {
 }
 
 void MutablePropertyFragment::Clear() {
+  FoldVertexPropertyVersions();
   for (auto ptr : dual_csr_list_) {
     if (ptr != NULL) {
       delete ptr;
@@ -59,12 +89,118 @@ void MutablePropertyFragment::Clear() {
   }
   lf_indexers_.clear();
   vertex_data_.clear();
+  vertex_capacities_.reset();
+  vertex_reserved_.clear();
+  vertex_claims_.reset();
+  vertex_grow_mutexes_.reset();
+  secondary_indexes_.clear();
+  range_indexes_.clear();
+  vector_indexes_.clear();
+  text_indexes_.clear();
   ie_.clear();
   oe_.clear();
   dual_csr_list_.clear();
+  edge_filters_.clear();
   vertex_label_num_ = 0;
   edge_label_num_ = 0;
   schema_.Clear();
+  resetDirty("");
+}
+
+void MutablePropertyFragment::FoldVertexPropertyVersions() {
+  std::vector<bool> written(vertex_data_.size(), false);
+  vertex_property_versions_.Fold(vertex_data_, written);
+  for (size_t i = 0; i < written.size(); ++i) {
+    if (written[i]) {
+      markDirty(table_dirty_[i]);
+    }
+  }
+}
+
+void MutablePropertyFragment::resetDirty(const std::string& snapshot_dir) {
+  indexer_dirty_ = std::vector<std::atomic<bool>>(vertex_label_num_);
+  table_dirty_ = std::vector<std::atomic<bool>>(vertex_label_num_);
+  csr_dirty_ = std::vector<std::atomic<bool>>(
+      vertex_label_num_ * vertex_label_num_ * edge_label_num_);
+  clean_snapshot_dir_ = snapshot_dir;
+}
+
+void MutablePropertyFragment::AddVertexProperty(label_t label,
+                                                const std::string& prop_name,
+                                                const PropertyType& type,
+                                                StorageStrategy strategy,
+                                                timestamp_t ts) {
+  // The versions are folded before the layout changes, as after a drop.
+  FoldVertexPropertyVersions();
+  schema_.add_vertex_property(label, prop_name, type, strategy);
+  // Not named after the column id, whose file may be mapped by the column
+  // that moved to it after a drop.
+  std::string name = vertex_table_prefix(schema_.get_vertex_label_name(label)) +
+                     ".col_added_" + std::to_string(ts);
+  vertex_data_[label].add_column(name, column_dir_, prop_name, type, strategy,
+                                 vertex_capacities_[label].load(),
+                                 vertex_reserved_[label]);
+  markDirty(table_dirty_[label]);
+  schema_change_num_.fetch_add(1, std::memory_order_release);
+}
+
+void MutablePropertyFragment::DropVertexProperty(
+    label_t label, const std::string& prop_name) {
+  FoldVertexPropertyVersions();
+  int col_id = vertex_data_[label].get_column_id_by_name(prop_name);
+  CHECK_GE(col_id, 0) << "No property " << prop_name << " of label "
+                      << schema_.get_vertex_label_name(label);
+  schema_.drop_vertex_property(label, prop_name);
+  vertex_data_[label].drop_column(
+      col_id, Schema::dropped_vertex_property_name(col_id));
+  auto reset = [col_id](auto& indexes) {
+    if (static_cast<size_t>(col_id) < indexes.size()) {
+      indexes[col_id].reset();
+    }
+  };
+  reset(secondary_indexes_[label]);
+  reset(range_indexes_[label]);
+  reset(vector_indexes_[label]);
+  reset(text_indexes_[label]);
+  markDirty(table_dirty_[label]);
+  schema_change_num_.fetch_add(1, std::memory_order_release);
+}
+
+void MutablePropertyFragment::compactVertexProperties() {
+  bool compacted = false;
+  for (label_t label = 0; label < vertex_label_num_; ++label) {
+    const auto& types = schema_.get_vertex_properties(label);
+    std::vector<size_t> dropped;
+    for (size_t col_id = 0; col_id < types.size(); ++col_id) {
+      if (schema_.is_dropped_vertex_property(label, col_id)) {
+        dropped.push_back(col_id);
+      }
+    }
+    if (dropped.empty()) {
+      continue;
+    }
+    if (!compacted) {
+      FoldVertexPropertyVersions();
+      compacted = true;
+    }
+    auto erase = [&dropped](auto& indexes) {
+      for (auto iter = dropped.rbegin(); iter != dropped.rend(); ++iter) {
+        if (*iter < indexes.size()) {
+          indexes.erase(indexes.begin() + *iter);
+        }
+      }
+    };
+    erase(secondary_indexes_[label]);
+    erase(range_indexes_[label]);
+    erase(vector_indexes_[label]);
+    erase(text_indexes_[label]);
+    schema_.compact_vertex_properties(label);
+    vertex_data_[label].compact_columns();
+    markDirty(table_dirty_[label]);
+  }
+  if (compacted) {
+    schema_change_num_.fetch_add(1, std::memory_order_release);
+  }
 }
 
 void MutablePropertyFragment::DumpSchema(const std::string& schema_path) {
@@ -78,26 +214,37 @@ void MutablePropertyFragment::DumpSchema(const std::string& schema_path) {
 inline DualCsrBase* create_csr(EdgeStrategy oes, EdgeStrategy ies,
                                const std::vector<PropertyType>& properties,
                                bool oe_mutable, bool ie_mutable,
-                               const std::vector<std::string>& prop_names) {
+                               const std::vector<std::string>& prop_names,
+                               EdgeCompression oe_compression,
+                               EdgeCompression ie_compression) {
   if (properties.empty()) {
-    return new DualCsr<grape::EmptyType>(oes, ies, oe_mutable, ie_mutable);
+    return new DualCsr<grape::EmptyType>(oes, ies, oe_mutable, ie_mutable,
+                                         oe_compression, ie_compression);
   } else if (properties.size() == 1) {
     if (properties[0] == PropertyType::kBool) {
-      return new DualCsr<bool>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<bool>(oes, ies, oe_mutable, ie_mutable,
+                               oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kInt32) {
-      return new DualCsr<int32_t>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<int32_t>(oes, ies, oe_mutable, ie_mutable,
+                                  oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kUInt32) {
-      return new DualCsr<uint32_t>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<uint32_t>(oes, ies, oe_mutable, ie_mutable,
+                                   oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kDate) {
-      return new DualCsr<Date>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<Date>(oes, ies, oe_mutable, ie_mutable,
+                               oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kInt64) {
-      return new DualCsr<int64_t>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<int64_t>(oes, ies, oe_mutable, ie_mutable,
+                                  oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kUInt64) {
-      return new DualCsr<uint64_t>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<uint64_t>(oes, ies, oe_mutable, ie_mutable,
+                                   oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kDouble) {
-      return new DualCsr<double>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<double>(oes, ies, oe_mutable, ie_mutable,
+                                 oe_compression, ie_compression);
     } else if (properties[0] == PropertyType::kFloat) {
-      return new DualCsr<float>(oes, ies, oe_mutable, ie_mutable);
+      return new DualCsr<float>(oes, ies, oe_mutable, ie_mutable,
+                                oe_compression, ie_compression);
     } else if (properties[0].type_enum == impl::PropertyTypeImpl::kVarChar) {
       return new DualCsr<std::string_view>(
           oes, ies, properties[0].additional_type_info.max_length, oe_mutable,
@@ -116,17 +263,62 @@ inline DualCsrBase* create_csr(EdgeStrategy oes, EdgeStrategy ies,
   return nullptr;
 }
 
+// Runs the tasks on a pool of thread_num threads, or of those of the
+// CsrThreadBudget if it is not positive, which the threads of the pool share
+// for the csr operations of their tasks. The first exception thrown by a task
+// is rethrown once all threads have finished.
+static void run_tasks_in_parallel(
+    const std::vector<std::function<void()>>& tasks, int thread_num = 0) {
+  int total_num = thread_num > 0 ? thread_num : CsrThreadBudget::get();
+  thread_num = std::min<int>(tasks.size(), total_num);
+  int share = std::max(total_num / std::max(thread_num, 1), 1);
+  std::atomic<size_t> task_id(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      CsrThreadBudget budget(share);
+      while (true) {
+        size_t cur = task_id.fetch_add(1);
+        if (cur >= tasks.size()) {
+          break;
+        }
+        try {
+          tasks[cur]();
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 void MutablePropertyFragment::Open(const std::string& work_dir,
                                    int memory_level) {
   std::string schema_file = schema_path(work_dir);
   std::string snapshot_dir{};
   bool build_empty_graph = false;
   if (std::filesystem::exists(schema_file)) {
-    loadSchema(schema_file);
+    snapshot_dir = get_latest_snapshot(work_dir);
+    // The snapshot is laid out as its own schema, which differs from the one
+    // of the work directory if properties changed since.
+    std::string snapshot_schema_file = snapshot_schema_path(snapshot_dir);
+    loadSchema(std::filesystem::exists(snapshot_schema_file)
+                   ? snapshot_schema_file
+                   : schema_file);
     vertex_label_num_ = schema_.vertex_label_num();
     edge_label_num_ = schema_.edge_label_num();
     lf_indexers_.resize(vertex_label_num_);
-    snapshot_dir = get_latest_snapshot(work_dir);
   } else {
     vertex_label_num_ = schema_.vertex_label_num();
     edge_label_num_ = schema_.edge_label_num();
@@ -138,6 +330,14 @@ void MutablePropertyFragment::Open(const std::string& work_dir,
   }
 
   vertex_data_.resize(vertex_label_num_);
+  secondary_indexes_.clear();
+  secondary_indexes_.resize(vertex_label_num_);
+  range_indexes_.clear();
+  range_indexes_.resize(vertex_label_num_);
+  vector_indexes_.clear();
+  vector_indexes_.resize(vertex_label_num_);
+  text_indexes_.clear();
+  text_indexes_.resize(vertex_label_num_);
   std::string tmp_dir_path = tmp_dir(work_dir);
 
   if (std::filesystem::exists(tmp_dir_path)) {
@@ -145,63 +345,87 @@ void MutablePropertyFragment::Open(const std::string& work_dir,
   }
 
   std::filesystem::create_directories(tmp_dir_path);
+  column_dir_ = memory_level == 0 ? tmp_dir_path : "";
 
+  // The labels and then the triplets are opened in parallel, as each of them
+  // maps and copies files of its own. The csrs are sized after the vertex
+  // capacities, hence the two rounds.
   std::vector<size_t> vertex_capacities(vertex_label_num_, 0);
+  vertex_reserved_.assign(vertex_label_num_, 0);
+  std::vector<std::function<void()>> tasks;
+  HugepageUsage vertex_usage = hugepage_usage();
   for (size_t i = 0; i < vertex_label_num_; ++i) {
-    std::string v_label_name = schema_.get_vertex_label_name(i);
-
-    if (memory_level == 0) {
-      lf_indexers_[i].open(
-          IndexerType::prefix() + "_" + vertex_map_prefix(v_label_name),
-          snapshot_dir, tmp_dir_path);
-      vertex_data_[i].open(vertex_table_prefix(v_label_name), snapshot_dir,
-                           tmp_dir_path, schema_.get_vertex_property_names(i),
-                           schema_.get_vertex_properties(i),
-                           schema_.get_vertex_storage_strategies(v_label_name));
-      if (!build_empty_graph) {
-        vertex_data_[i].copy_to_tmp(vertex_table_prefix(v_label_name),
-                                    snapshot_dir, tmp_dir_path);
-      }
-    } else if (memory_level == 1) {
-      lf_indexers_[i].open_in_memory(snapshot_dir + "/" +
-                                     IndexerType::prefix() + "_" +
-                                     vertex_map_prefix(v_label_name));
-      vertex_data_[i].open_in_memory(
-          vertex_table_prefix(v_label_name), snapshot_dir,
-          schema_.get_vertex_property_names(i),
-          schema_.get_vertex_properties(i),
-          schema_.get_vertex_storage_strategies(v_label_name));
-    } else if (memory_level == 2) {
-      lf_indexers_[i].open_with_hugepages(snapshot_dir + "/" +
-                                              IndexerType::prefix() + "_" +
-                                              vertex_map_prefix(v_label_name),
-                                          false);
-      vertex_data_[i].open_with_hugepages(
-          vertex_table_prefix(v_label_name), snapshot_dir,
-          schema_.get_vertex_property_names(i),
-          schema_.get_vertex_properties(i),
-          schema_.get_vertex_storage_strategies(v_label_name), false);
-    } else {
-      assert(memory_level == 3);
-      lf_indexers_[i].open_with_hugepages(snapshot_dir + "/" +
-                                              IndexerType::prefix() + "_" +
-                                              vertex_map_prefix(v_label_name),
-                                          true);
-      vertex_data_[i].open_with_hugepages(
-          vertex_table_prefix(v_label_name), snapshot_dir,
-          schema_.get_vertex_property_names(i),
-          schema_.get_vertex_properties(i),
-          schema_.get_vertex_storage_strategies(v_label_name), true);
-    }
+    tasks.emplace_back([this, i, memory_level, build_empty_graph,
+                        &snapshot_dir, &tmp_dir_path, &vertex_capacities]() {
+      std::string v_label_name = schema_.get_vertex_label_name(i);
+      if (memory_level == 0) {
+        lf_indexers_[i].open(
+            IndexerType::prefix() + "_" + vertex_map_prefix(v_label_name),
+            snapshot_dir, tmp_dir_path);
+        vertex_data_[i].open(
+            vertex_table_prefix(v_label_name), snapshot_dir, tmp_dir_path,
+            schema_.get_vertex_property_names(i),
+            schema_.get_vertex_properties(i),
+            schema_.get_vertex_storage_strategies(v_label_name));
+        if (!build_empty_graph) {
+          vertex_data_[i].copy_to_tmp(vertex_table_prefix(v_label_name),
+                                      snapshot_dir, tmp_dir_path);
+        }
+      } else if (memory_level == 1) {
+        lf_indexers_[i].open_in_memory(snapshot_dir + "/" +
+                                       IndexerType::prefix() + "_" +
+                                       vertex_map_prefix(v_label_name));
+        vertex_data_[i].open_in_memory(
+            vertex_table_prefix(v_label_name), snapshot_dir,
+            schema_.get_vertex_property_names(i),
+            schema_.get_vertex_properties(i),
+            schema_.get_vertex_storage_strategies(v_label_name));
+      } else {
+        assert(memory_level == 2 || memory_level == 3);
+        // Columns stored on disk keep to the mmaped files, unless hugepages
+        // are forced.
+        lf_indexers_[i].open_with_hugepages(
+            snapshot_dir + "/" + IndexerType::prefix() + "_" +
+                vertex_map_prefix(v_label_name),
+            true);
+        vertex_data_[i].open_with_hugepages(
+            vertex_table_prefix(v_label_name), snapshot_dir,
+            schema_.get_vertex_property_names(i),
+            schema_.get_vertex_properties(i),
+            schema_.get_vertex_storage_strategies(v_label_name),
+            memory_level == 3);
+      }
 
-    // We will reserve the at least 4096 slots for each vertex label
-    size_t vertex_capacity =
-        std::max(lf_indexers_[i].capacity(), (size_t) 4096);
-    if (vertex_capacity > lf_indexers_[i].capacity()) {
-      lf_indexers_[i].reserve(vertex_capacity);
-    }
-    vertex_data_[i].resize(vertex_capacity);
-    vertex_capacities[i] = vertex_capacity;
+      // We will reserve the at least 4096 slots for each vertex label
+      size_t vertex_capacity =
+          std::max(lf_indexers_[i].capacity(), (size_t) 4096);
+      if (vertex_capacity > lf_indexers_[i].capacity()) {
+        lf_indexers_[i].reserve(vertex_capacity);
+      }
+      vertex_data_[i].resize(vertex_capacity);
+      vertex_capacities[i] = vertex_capacity;
+      // The label grows to its reservation under live inserts with no
+      // rehash or remap.
+      size_t reserved = vertex_reservation(schema_, i, vertex_capacity);
+      lf_indexers_[i].reserve_growth(reserved);
+      vertex_data_[i].reserve(reserved);
+      vertex_reserved_[i] = reserved;
+      openPropertyIndexes(i, snapshot_dir);
+    });
+  }
+  run_tasks_in_parallel(tasks);
+  tasks.clear();
+  vertex_capacities_ =
+      std::make_unique<std::atomic<size_t>[]>(vertex_label_num_);
+  vertex_claims_ = std::make_unique<std::atomic<size_t>[]>(vertex_label_num_);
+  vertex_grow_mutexes_ = std::make_unique<std::mutex[]>(vertex_label_num_);
+  for (size_t i = 0; i < vertex_label_num_; ++i) {
+    vertex_capacities_[i].store(vertex_capacities[i]);
+    vertex_claims_[i].store(0);
+  }
+  if (memory_level >= 2) {
+    LOG(INFO) << "Vertices are backed by "
+              << (hugepage_usage() - vertex_usage).ToString();
   }
 
   ie_.resize(vertex_label_num_ * vertex_label_num_ * edge_label_num_, NULL);
@@ -209,6 +433,10 @@ void MutablePropertyFragment::Open(const std::string& work_dir,
 
   dual_csr_list_.resize(vertex_label_num_ * vertex_label_num_ * edge_label_num_,
                         NULL);
+  edge_filters_.clear();
+  edge_filters_.resize(dual_csr_list_.size());
+  std::vector<size_t> filtered_triplets;
+  HugepageUsage edge_usage = hugepage_usage();
 
   for (size_t src_label_i = 0; src_label_i != vertex_label_num_;
        ++src_label_i) {
@@ -237,40 +465,155 @@ void MutablePropertyFragment::Open(const std::string& work_dir,
         bool ie_mutable =
             schema_.incoming_edge_mutable(src_label, dst_label, edge_label);
 
+        EdgeCompression oe_compression = schema_.get_outgoing_edge_compression(
+            src_label, dst_label, edge_label);
+        EdgeCompression ie_compression = schema_.get_incoming_edge_compression(
+            src_label, dst_label, edge_label);
+
         auto& prop_names =
             schema_.get_edge_property_names(src_label, dst_label, edge_label);
 
-        dual_csr_list_[index] = create_csr(oe_strategy, ie_strategy, properties,
-                                           oe_mutable, ie_mutable, prop_names);
+        dual_csr_list_[index] =
+            create_csr(oe_strategy, ie_strategy, properties, oe_mutable,
+                       ie_mutable, prop_names, oe_compression, ie_compression);
         ie_[index] = dual_csr_list_[index]->GetInCsr();
         oe_[index] = dual_csr_list_[index]->GetOutCsr();
-        if (memory_level == 0) {
-          dual_csr_list_[index]->Open(
-              oe_prefix(src_label, dst_label, edge_label),
-              ie_prefix(src_label, dst_label, edge_label),
-              edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
-              tmp_dir_path);
-        } else if (memory_level >= 2) {
-          dual_csr_list_[index]->OpenWithHugepages(
-              oe_prefix(src_label, dst_label, edge_label),
-              ie_prefix(src_label, dst_label, edge_label),
-              edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
-              vertex_capacities[src_label_i], vertex_capacities[dst_label_i]);
-        } else {
-          dual_csr_list_[index]->OpenInMemory(
-              oe_prefix(src_label, dst_label, edge_label),
-              ie_prefix(src_label, dst_label, edge_label),
-              edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
-              vertex_capacities[src_label_i], vertex_capacities[dst_label_i]);
+        // Cold triplets stay in files of the work directory below memory
+        // level 3, like every triplet at level 0.
+        bool csr_on_disk =
+            memory_level > 0 && memory_level < 3 &&
+            schema_.get_csr_storage_strategy(src_label_i, dst_label_i,
+                                             e_label_i) ==
+                StorageStrategy::kDisk;
+        tasks.emplace_back([this, index, src_label_i, dst_label_i, src_label,
+                            dst_label, edge_label, memory_level, csr_on_disk,
+                            &snapshot_dir, &tmp_dir_path,
+                            &vertex_capacities]() {
+          if (memory_level == 0 || csr_on_disk) {
+            dual_csr_list_[index]->Open(
+                oe_prefix(src_label, dst_label, edge_label),
+                ie_prefix(src_label, dst_label, edge_label),
+                edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
+                tmp_dir_path);
+          } else if (memory_level >= 2) {
+            dual_csr_list_[index]->OpenWithHugepages(
+                oe_prefix(src_label, dst_label, edge_label),
+                ie_prefix(src_label, dst_label, edge_label),
+                edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
+                vertex_capacities[src_label_i], vertex_capacities[dst_label_i]);
+          } else {
+            dual_csr_list_[index]->OpenInMemory(
+                oe_prefix(src_label, dst_label, edge_label),
+                ie_prefix(src_label, dst_label, edge_label),
+                edata_prefix(src_label, dst_label, edge_label), snapshot_dir,
+                vertex_capacities[src_label_i], vertex_capacities[dst_label_i]);
+          }
+          dual_csr_list_[index]->Reserve(vertex_reserved_[src_label_i],
+                                         vertex_reserved_[dst_label_i]);
+          dual_csr_list_[index]->Resize(vertex_capacities[src_label_i],
+                                        vertex_capacities[dst_label_i]);
+        });
+        if (schema_.get_edge_existence_filter(src_label_i, dst_label_i,
+                                              e_label_i)) {
+          filtered_triplets.push_back(index);
         }
-        dual_csr_list_[index]->Resize(vertex_capacities[src_label_i],
-                                      vertex_capacities[dst_label_i]);
       }
     }
   }
+  run_tasks_in_parallel(tasks);
+  if (memory_level >= 2) {
+    LOG(INFO) << "Edges are backed by "
+              << (hugepage_usage() - edge_usage).ToString();
+  }
+  buildEdgeFilters(filtered_triplets);
+  resetDirty(build_empty_graph ? "" : snapshot_dir);
+}
+
+// Opens the indexes of INDEX_T on the given properties of the label from the
+// snapshot, or builds them from the table.
+template <typename INDEX_T>
+static void open_property_indexes(
+    const Schema& schema, label_t label, const std::vector<std::string>& props,
+    std::string (*prefix)(const std::string&, const std::string&),
+    const std::string& snapshot_dir, const Table& table, vid_t vertex_num,
+    std::vector<std::unique_ptr<INDEX_T>>& indexes) {
+  const auto& prop_names = schema.get_vertex_property_names(label);
+  const auto& prop_types = schema.get_vertex_properties(label);
+  std::string label_name = schema.get_vertex_label_name(label);
+  indexes.resize(prop_names.size());
+  for (auto& prop_name : props) {
+    auto iter = std::find(prop_names.begin(), prop_names.end(), prop_name);
+    if (iter == prop_names.end()) {
+      continue;
+    }
+    size_t col_id = iter - prop_names.begin();
+    std::string name = prefix(label_name, prop_name);
+    if (!INDEX_T::is_supported(prop_types[col_id])) {
+      LOG(WARNING) << name << " of type " << prop_types[col_id]
+                   << " is not supported";
+      continue;
+    }
+    auto index = std::make_unique<INDEX_T>();
+    if (!index->open(snapshot_dir + "/" + name)) {
+      index->rebuild(*table.get_column_by_id(col_id), vertex_num);
+      LOG(INFO) << "Built " << name << " with " << index->size()
+                << " entries";
+    }
+    indexes[col_id] = std::move(index);
+  }
+}
+
+void MutablePropertyFragment::openPropertyIndexes(
+    label_t label, const std::string& snapshot_dir) {
+  open_property_indexes(schema_, label, schema_.get_secondary_indexes(label),
+                        &secondary_index_prefix, snapshot_dir,
+                        vertex_data_[label], lf_indexers_[label].size(),
+                        secondary_indexes_[label]);
+  open_property_indexes(schema_, label, schema_.get_range_indexes(label),
+                        &range_index_prefix, snapshot_dir, vertex_data_[label],
+                        lf_indexers_[label].size(), range_indexes_[label]);
+  open_property_indexes(schema_, label, schema_.get_vector_indexes(label),
+                        &vector_index_prefix, snapshot_dir, vertex_data_[label],
+                        lf_indexers_[label].size(), vector_indexes_[label]);
+  open_property_indexes(schema_, label, schema_.get_text_indexes(label),
+                        &text_index_prefix, snapshot_dir, vertex_data_[label],
+                        lf_indexers_[label].size(), text_indexes_[label]);
+}
+
+void MutablePropertyFragment::IndexVertex(label_t label, vid_t lid) {
+  auto& indexes = secondary_indexes_[label];
+  for (size_t col_id = 0; col_id < indexes.size(); ++col_id) {
+    if (indexes[col_id] != nullptr) {
+      indexes[col_id]->insert(
+          vertex_data_[label].get_column_by_id(col_id)->get(lid), lid);
+    }
+  }
+  auto& range_indexes = range_indexes_[label];
+  for (size_t col_id = 0; col_id < range_indexes.size(); ++col_id) {
+    if (range_indexes[col_id] != nullptr) {
+      range_indexes[col_id]->insert(
+          vertex_data_[label].get_column_by_id(col_id)->get(lid), lid);
+    }
+  }
+  auto& vector_indexes = vector_indexes_[label];
+  for (size_t col_id = 0; col_id < vector_indexes.size(); ++col_id) {
+    if (vector_indexes[col_id] != nullptr) {
+      vector_indexes[col_id]->insert(
+          vertex_data_[label].get_column_by_id(col_id)->get(lid), lid);
+    }
+  }
+  auto& text_indexes = text_indexes_[label];
+  for (size_t col_id = 0; col_id < text_indexes.size(); ++col_id) {
+    if (text_indexes[col_id] != nullptr) {
+      text_indexes[col_id]->insert(
+          vertex_data_[label].get_column_by_id(col_id)->get(lid), lid);
+    }
+  }
 }
 
-void MutablePropertyFragment::Compact(uint32_t version) {
+std::vector<std::tuple<size_t, bool, size_t>>
+MutablePropertyFragment::unsortedTriplets() const {
+  std::vector<std::tuple<size_t, bool, size_t>> ret;
   for (size_t src_label_i = 0; src_label_i != vertex_label_num_;
        ++src_label_i) {
     std::string src_label =
@@ -287,19 +630,397 @@ void MutablePropertyFragment::Compact(uint32_t version) {
         }
         size_t index = src_label_i * vertex_label_num_ * edge_label_num_ +
                        dst_label_i * edge_label_num_ + e_label_i;
-        if (dual_csr_list_[index] != NULL) {
-          if (schema_.get_sort_on_compaction(src_label, dst_label,
-                                             edge_label)) {
-            dual_csr_list_[index]->SortByEdgeData(version);
-          }
+        if (dual_csr_list_[index] == NULL) {
+          continue;
+        }
+        bool by_edge_data =
+            schema_.get_sort_on_compaction(src_label, dst_label, edge_label);
+        if (!by_edge_data &&
+            !schema_.get_sort_by_neighbor(src_label, dst_label, edge_label)) {
+          continue;
+        }
+        // A triplet without writes since its last sort keeps its order.
+        size_t work = dual_csr_list_[index]->UnsortedVertexNum();
+        if (work != 0) {
+          ret.emplace_back(index, by_edge_data, work);
         }
       }
     }
   }
+  return ret;
+}
+
+size_t MutablePropertyFragment::PendingCompactionVertexNum() const {
+  size_t ret = 0;
+  for (auto& triplet : unsortedTriplets()) {
+    ret += std::get<2>(triplet);
+  }
+  return ret;
+}
+
+std::vector<VertexLabelMemoryUsage>
+MutablePropertyFragment::vertexMemoryUsage() const {
+  std::vector<VertexLabelMemoryUsage> ret(vertex_label_num_);
+  for (size_t i = 0; i != vertex_label_num_; ++i) {
+    auto& usage = ret[i];
+    usage.label = static_cast<label_t>(i);
+    usage.indexer = lf_indexers_[i].memory_usage();
+    const auto& table = vertex_data_[i];
+    for (size_t col_i = 0; col_i != table.col_num(); ++col_i) {
+      usage.columns.emplace_back(table.column_name(col_i),
+                                 table.get_column_by_id(col_i)->memory_usage());
+    }
+  }
+  return ret;
+}
+
+std::vector<EdgeTripletMemoryUsage> MutablePropertyFragment::edgeMemoryUsage()
+    const {
+  std::vector<EdgeTripletMemoryUsage> ret;
+  for (size_t src_label_i = 0; src_label_i != vertex_label_num_;
+       ++src_label_i) {
+    for (size_t dst_label_i = 0; dst_label_i != vertex_label_num_;
+         ++dst_label_i) {
+      for (size_t e_label_i = 0; e_label_i != edge_label_num_; ++e_label_i) {
+        size_t index = src_label_i * vertex_label_num_ * edge_label_num_ +
+                       dst_label_i * edge_label_num_ + e_label_i;
+        if (dual_csr_list_[index] == NULL) {
+          continue;
+        }
+        EdgeTripletMemoryUsage usage;
+        usage.src_label = static_cast<label_t>(src_label_i);
+        usage.dst_label = static_cast<label_t>(dst_label_i);
+        usage.edge_label = static_cast<label_t>(e_label_i);
+        if (oe_[index] != NULL) {
+          usage.out_csr = oe_[index]->memory_usage();
+        }
+        if (ie_[index] != NULL) {
+          usage.in_csr = ie_[index]->memory_usage();
+        }
+        usage.edge_data = dual_csr_list_[index]->EdgeDataMemoryUsage();
+        ret.emplace_back(usage);
+      }
+    }
+  }
+  return ret;
+}
+
+bool MutablePropertyFragment::HasUnfrozenWrites() const {
+  for (auto* csr : dual_csr_list_) {
+    if (csr != NULL && csr->HasUnfrozenWrites()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MutablePropertyFragment::Compact(uint32_t version,
+                                      size_t max_vertex_num) {
+  compactVertexProperties();
+  std::vector<std::pair<size_t, bool>> tasks;
+  size_t vertex_num = 0;
+  bool remaining = false;
+  for (auto& triplet : unsortedTriplets()) {
+    size_t work = std::get<2>(triplet);
+    if (!tasks.empty() && vertex_num + work > max_vertex_num) {
+      remaining = true;
+      continue;
+    }
+    vertex_num += work;
+    tasks.emplace_back(std::get<0>(triplet), std::get<1>(triplet));
+  }
+
+  std::vector<std::function<void()>> sort_tasks;
+  for (auto& task : tasks) {
+    markDirty(csr_dirty_[task.first]);
+    sort_tasks.emplace_back([this, task, version]() {
+      auto* csr = dual_csr_list_[task.first];
+      if (task.second) {
+        csr->SortByEdgeData(version);
+      } else {
+        csr->SortByNeighbor(version);
+      }
+    });
+  }
+  run_tasks_in_parallel(sort_tasks);
+  // Compaction runs exclusively, so every edge written so far is visible to
+  // all later readers.
+  for (auto* csr : dual_csr_list_) {
+    if (csr != NULL) {
+      csr->Freeze();
+    }
+  }
+  // Filters that took more keys than they were sized for are rebuilt, to
+  // bring their false positive rate back down.
+  std::vector<size_t> overfull_filters;
+  for (size_t i = 0; i < edge_filters_.size(); ++i) {
+    if (edge_filters_[i] != nullptr &&
+        edge_filters_[i]->key_num() > edge_filters_[i]->capacity()) {
+      overfull_filters.push_back(i);
+    }
+  }
+  buildEdgeFilters(overfull_filters);
+  std::vector<std::function<void()>> encode_tasks;
+  for (auto& table : vertex_data_) {
+    encode_tasks.emplace_back([&table]() { table.encode_dictionary(); });
+  }
+  run_tasks_in_parallel(encode_tasks);
+  // Values written since the range and text indexes were built are merged
+  // into their sorted arrays.
+  std::vector<std::function<void()>> merge_tasks;
+  for (auto& indexes : range_indexes_) {
+    for (auto& index : indexes) {
+      if (index != nullptr) {
+        merge_tasks.emplace_back([&index]() { index->merge(); });
+      }
+    }
+  }
+  for (auto& indexes : text_indexes_) {
+    for (auto& index : indexes) {
+      if (index != nullptr) {
+        merge_tasks.emplace_back([&index]() { index->merge(); });
+      }
+    }
+  }
+  run_tasks_in_parallel(merge_tasks);
+#ifdef USE_PTHASH
+  // Vertices inserted after the perfect hash of their label was built are
+  // looked up in its overlay, after a miss in the hash. Once they are a
+  // sizable share of the label, the hash is rebuilt over all of them.
+  static constexpr size_t kIndexerRebuildRatio = 8;
+  for (auto& indexer : lf_indexers_) {
+    if (indexer.extra_size() * kIndexerRebuildRatio > indexer.size()) {
+      indexer.rebuild();
+    }
+  }
+#endif
+  VLOG(10) << "Compacted " << tasks.size() << " triplets, visited "
+           << vertex_num << " vertices";
+  return remaining;
+}
+
+void MutablePropertyFragment::buildEdgeFilters(
+    const std::vector<size_t>& indices) {
+  // Sized with room for the edges inserted until the next rebuild.
+  static constexpr size_t kFilterHeadroom = 2;
+  std::vector<std::function<void()>> tasks;
+  for (size_t index : indices) {
+    tasks.emplace_back([this, index]() {
+      const DualCsrBase* csr = dual_csr_list_[index];
+      // Either direction holds every edge, unless it is not stored.
+      const CsrBase* oe = csr->GetOutCsr();
+      const CsrBase* ie = csr->GetInCsr();
+      bool from_out = oe->edge_num() != 0 || ie->edge_num() == 0;
+      const CsrBase* scanned = from_out ? oe : ie;
+      auto filter = std::make_unique<BlockedBloomFilter>();
+      filter->init(scanned->edge_num() * kFilterHeadroom);
+      size_t vnum = scanned->size();
+      for (size_t v = 0; v < vnum; ++v) {
+        for (auto it = scanned->edge_iter(v); it->is_valid(); it->next()) {
+          vid_t nbr = it->get_neighbor();
+          filter->insert(from_out ? edge_filter_key(v, nbr)
+                                  : edge_filter_key(nbr, v));
+        }
+      }
+      edge_filters_[index] = std::move(filter);
+    });
+  }
+  run_tasks_in_parallel(tasks);
+}
+
+struct SnapshotFileInfo {
+  std::string name;
+  size_t size;
+  uint64_t checksum;
+};
+
+static std::unordered_map<std::string, SnapshotFileInfo> load_snapshot_manifest(
+    const std::string& dir) {
+  std::unordered_map<std::string, SnapshotFileInfo> ret;
+  std::ifstream fin(snapshot_manifest_path(dir));
+  if (!fin.is_open()) {
+    return ret;
+  }
+  SnapshotFileInfo info;
+  while (fin >> info.name >> info.size >> std::hex >> info.checksum >>
+         std::dec) {
+    ret.emplace(info.name, info);
+  }
+  return ret;
+}
+
+// Whether the file named name, relative to a snapshot dir, is one of the
+// files written under prefix, as SnapshotUploader::EnqueueFiles matches them.
+static bool snapshot_file_matches(const std::string& name,
+                                  const std::string& prefix) {
+  std::string file_name = std::filesystem::path(name).filename().string();
+  return file_name == prefix || file_name.rfind(prefix + ".", 0) == 0;
+}
+
+// Hard links the files of prev_dir under the given prefixes into dir, as
+// listed in prev_files, the manifest of prev_dir, and appends them to
+// linked. Fails, leaving nothing linked, if a prefix has no file or a link
+// cannot be made, in which case the files are to be dumped instead.
+static bool link_snapshot_files(
+    const std::string& prev_dir, const std::string& dir,
+    const std::unordered_map<std::string, SnapshotFileInfo>& prev_files,
+    const std::vector<std::string>& prefixes,
+    std::vector<SnapshotFileInfo>& linked) {
+  std::vector<SnapshotFileInfo> files;
+  for (const auto& prefix : prefixes) {
+    size_t file_num = files.size();
+    for (const auto& pair : prev_files) {
+      if (snapshot_file_matches(pair.first, prefix)) {
+        files.push_back(pair.second);
+      }
+    }
+    if (files.size() == file_num) {
+      return false;
+    }
+  }
+  std::error_code ec;
+  for (size_t i = 0; i < files.size(); ++i) {
+    std::string prev_path = prev_dir + "/" + files[i].name;
+    std::string cur_path = dir + "/" + files[i].name;
+    std::filesystem::create_directories(
+        std::filesystem::path(cur_path).parent_path(), ec);
+    std::filesystem::remove(cur_path, ec);
+    std::filesystem::create_hard_link(prev_path, cur_path, ec);
+    if (ec) {
+      VLOG(10) << "Failed to link " << prev_path << ", " << ec.message();
+      // The linked files are removed, so that dumping does not write
+      // through them into prev_dir.
+      for (size_t j = 0; j < i; ++j) {
+        std::filesystem::remove(dir + "/" + files[j].name, ec);
+      }
+      return false;
+    }
+  }
+  linked.insert(linked.end(), files.begin(), files.end());
+  return true;
+}
+
+// Records every file of the snapshot in its manifest. The linked files take
+// the checksums of the previous snapshot's manifest, the others are
+// checksummed, and replaced by hard links to the files of the previous
+// snapshot they are identical to.
+static void write_snapshot_manifest(
+    const std::string& dir, const std::string& prev_dir,
+    const std::vector<SnapshotFileInfo>& linked) {
+  std::unordered_map<std::string, SnapshotFileInfo> linked_files;
+  for (const auto& file : linked) {
+    linked_files.emplace(file.name, file);
+  }
+  std::vector<SnapshotFileInfo> files;
+  for (const auto& entry :
+       std::filesystem::recursive_directory_iterator(dir)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    std::string name =
+        std::filesystem::relative(entry.path(), dir).generic_string();
+    if (name == "MANIFEST" || name == "MANIFEST.tmp") {
+      continue;
+    }
+    auto iter = linked_files.find(name);
+    if (iter != linked_files.end()) {
+      files.push_back(iter->second);
+    } else {
+      files.push_back({name, static_cast<size_t>(entry.file_size()), 0});
+    }
+  }
+
+  std::vector<std::function<void()>> tasks;
+  for (auto& file : files) {
+    if (linked_files.count(file.name)) {
+      continue;
+    }
+    tasks.emplace_back([&dir, &file]() {
+      if (!checksum_file(dir + "/" + file.name, file.checksum)) {
+        throw std::runtime_error("Failed to checksum snapshot file: " +
+                                 file.name);
+      }
+    });
+  }
+  run_tasks_in_parallel(tasks);
+
+  size_t linked_num = 0, linked_size = 0;
+  if (!prev_dir.empty()) {
+    auto prev_files = load_snapshot_manifest(prev_dir);
+    for (const auto& file : files) {
+      if (linked_files.count(file.name)) {
+        ++linked_num;
+        linked_size += file.size;
+        continue;
+      }
+      auto iter = prev_files.find(file.name);
+      if (iter == prev_files.end() || iter->second.size != file.size ||
+          iter->second.checksum != file.checksum) {
+        continue;
+      }
+      std::string cur_path = dir + "/" + file.name;
+      std::string prev_path = prev_dir + "/" + file.name;
+      std::error_code ec;
+      if (!std::filesystem::exists(prev_path, ec) ||
+          std::filesystem::file_size(prev_path, ec) != file.size ||
+          std::filesystem::equivalent(cur_path, prev_path, ec)) {
+        continue;
+      }
+      // Links under a temporary name first, so that the file is never
+      // missing from the snapshot.
+      std::string tmp_path = cur_path + ".link";
+      std::filesystem::remove(tmp_path, ec);
+      std::filesystem::create_hard_link(prev_path, tmp_path, ec);
+      if (ec) {
+        VLOG(10) << "Failed to link " << prev_path << ", " << ec.message();
+        continue;
+      }
+      std::filesystem::rename(tmp_path, cur_path, ec);
+      if (ec) {
+        LOG(ERROR) << "Failed to replace " << cur_path << ", "
+                   << ec.message();
+        std::filesystem::remove(tmp_path, ec);
+        continue;
+      }
+      ++linked_num;
+      linked_size += file.size;
+    }
+  }
+
+  std::string manifest_path = snapshot_manifest_path(dir);
+  std::string tmp_manifest_path = manifest_path + ".tmp";
+  {
+    std::ofstream fout(tmp_manifest_path, std::ios::out | std::ios::trunc);
+    for (const auto& file : files) {
+      fout << file.name << " " << file.size << " " << std::hex
+           << file.checksum << std::dec << "\n";
+    }
+    fout.flush();
+    if (!fout) {
+      std::string msg = "Failed to write snapshot manifest: " + manifest_path;
+      LOG(ERROR) << msg;
+      throw std::runtime_error(msg);
+    }
+  }
+  std::filesystem::rename(tmp_manifest_path, manifest_path);
+  VLOG(10) << "Snapshot " << dir << " has " << files.size() << " files, "
+           << linked_num << " of them (" << linked_size
+           << " bytes) shared with " << prev_dir;
+}
+
+static void wait_for_upload(SnapshotUploader& uploader) {
+  auto status = uploader.Wait();
+  if (!status.ok()) {
+    std::string msg = "Failed to upload snapshot: " + status.ToString();
+    LOG(ERROR) << msg;
+    throw std::runtime_error(msg);
+  }
 }
 
 void MutablePropertyFragment::Dump(const std::string& work_dir,
-                                   uint32_t version) {
+                                   uint32_t version,
+                                   SnapshotUploader* uploader) {
+  FoldVertexPropertyVersions();
   std::string snapshot_dir_path = snapshot_dir(work_dir, version);
   std::error_code errorCode;
   std::filesystem::create_directories(snapshot_dir_path, errorCode);
@@ -310,16 +1031,140 @@ void MutablePropertyFragment::Dump(const std::string& work_dir,
     LOG(ERROR) << ss.str();
     throw std::runtime_error(ss.str());
   }
+  std::string prev_snapshot_dir_path;
+  if (std::filesystem::exists(snapshot_version_path(work_dir))) {
+    uint32_t prev_version = get_snapshot_version(work_dir);
+    if (prev_version != version) {
+      prev_snapshot_dir_path = snapshot_dir(work_dir, prev_version);
+    }
+  }
+
   std::vector<size_t> vertex_num(vertex_label_num_, 0);
   for (size_t i = 0; i < vertex_label_num_; ++i) {
     vertex_num[i] = lf_indexers_[i].size();
-    lf_indexers_[i].dump(
-        IndexerType::prefix() + "_" +
-            vertex_map_prefix(schema_.get_vertex_label_name(i)),
-        snapshot_dir_path);
-    vertex_data_[i].resize(vertex_num[i]);
-    vertex_data_[i].dump(vertex_table_prefix(schema_.get_vertex_label_name(i)),
-                         snapshot_dir_path);
+  }
+
+  // The parts not written since the snapshot they were opened from or last
+  // dumped to are linked from it, if it is the one this snapshot follows.
+  std::unordered_map<std::string, SnapshotFileInfo> prev_files;
+  std::error_code ec;
+  if (!prev_snapshot_dir_path.empty() && !clean_snapshot_dir_.empty() &&
+      std::filesystem::equivalent(prev_snapshot_dir_path, clean_snapshot_dir_,
+                                  ec)) {
+    prev_files = load_snapshot_manifest(prev_snapshot_dir_path);
+  }
+  std::mutex linked_mutex;
+  std::vector<SnapshotFileInfo> linked;
+  auto link_clean = [&](bool dirty, const std::vector<std::string>& prefixes) {
+    std::vector<SnapshotFileInfo> files;
+    if (dirty || prev_files.empty() ||
+        !link_snapshot_files(prev_snapshot_dir_path, snapshot_dir_path,
+                             prev_files, prefixes, files)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(linked_mutex);
+    linked.insert(linked.end(), files.begin(), files.end());
+    return true;
+  };
+
+  // Indexers, vertex tables and triplets are written to distinct files and
+  // share no state, so they are dumped in parallel.
+  std::vector<std::function<void()>> tasks;
+  for (size_t i = 0; i < vertex_label_num_; ++i) {
+    tasks.emplace_back([this, i, uploader, &snapshot_dir_path, &link_clean]() {
+      std::string prefix =
+          IndexerType::prefix() + "_" +
+          vertex_map_prefix(schema_.get_vertex_label_name(i));
+      if (!link_clean(indexer_dirty_[i].load(), {prefix})) {
+        lf_indexers_[i].dump(prefix, snapshot_dir_path);
+      }
+      if (uploader) {
+        uploader->EnqueueFiles(snapshot_dir_path, {prefix});
+      }
+    });
+    tasks.emplace_back([this, i, uploader, &vertex_num, &snapshot_dir_path,
+                        &link_clean]() {
+      std::string label_name = schema_.get_vertex_label_name(i);
+      const auto& prop_names = schema_.get_vertex_property_names(i);
+      std::vector<std::string> prefixes = {vertex_table_prefix(label_name)};
+      auto add_prefixes = [&](const auto& indexes,
+                              std::string (*index_prefix)(
+                                  const std::string&, const std::string&)) {
+        for (size_t col_id = 0; col_id < indexes.size(); ++col_id) {
+          if (indexes[col_id] != nullptr) {
+            prefixes.push_back(index_prefix(label_name, prop_names[col_id]));
+          }
+        }
+      };
+      add_prefixes(secondary_indexes_[i], &secondary_index_prefix);
+      add_prefixes(range_indexes_[i], &range_index_prefix);
+      add_prefixes(text_indexes_[i], &text_index_prefix);
+      add_prefixes(vector_indexes_[i], &vector_index_prefix);
+      if (link_clean(indexer_dirty_[i].load() || table_dirty_[i].load(),
+                     prefixes)) {
+        if (uploader) {
+          uploader->EnqueueFiles(snapshot_dir_path, prefixes);
+        }
+        return;
+      }
+
+      vertex_data_[i].resize(vertex_num[i]);
+      // The indexes are rebuilt from the folded table before the dump
+      // releases its columns, which drops the entries of values
+      // overwritten since.
+      auto& indexes = secondary_indexes_[i];
+      for (size_t col_id = 0; col_id < indexes.size(); ++col_id) {
+        if (indexes[col_id] == nullptr) {
+          continue;
+        }
+        indexes[col_id]->rebuild(*vertex_data_[i].get_column_by_id(col_id),
+                                 vertex_num[i]);
+        indexes[col_id]->dump(snapshot_dir_path + "/" +
+                              secondary_index_prefix(label_name,
+                                                     prop_names[col_id]));
+      }
+      auto& range_indexes = range_indexes_[i];
+      for (size_t col_id = 0; col_id < range_indexes.size(); ++col_id) {
+        if (range_indexes[col_id] == nullptr) {
+          continue;
+        }
+        range_indexes[col_id]->rebuild(
+            *vertex_data_[i].get_column_by_id(col_id), vertex_num[i]);
+        range_indexes[col_id]->dump(
+            snapshot_dir_path + "/" +
+            range_index_prefix(label_name, prop_names[col_id]));
+      }
+      auto& text_indexes = text_indexes_[i];
+      for (size_t col_id = 0; col_id < text_indexes.size(); ++col_id) {
+        if (text_indexes[col_id] == nullptr) {
+          continue;
+        }
+        text_indexes[col_id]->rebuild(
+            *vertex_data_[i].get_column_by_id(col_id), vertex_num[i]);
+        text_indexes[col_id]->dump(
+            snapshot_dir_path + "/" +
+            text_index_prefix(label_name, prop_names[col_id]));
+      }
+      // Unlike the sorted arrays, an HNSW graph is costly to build, so a
+      // vector index is only rebuilt to drop stale entries.
+      auto& vector_indexes = vector_indexes_[i];
+      for (size_t col_id = 0; col_id < vector_indexes.size(); ++col_id) {
+        if (vector_indexes[col_id] == nullptr) {
+          continue;
+        }
+        if (vector_indexes[col_id]->stale_num() > 0) {
+          vector_indexes[col_id]->rebuild(
+              *vertex_data_[i].get_column_by_id(col_id), vertex_num[i]);
+        }
+        vector_indexes[col_id]->dump(
+            snapshot_dir_path + "/" +
+            vector_index_prefix(label_name, prop_names[col_id]));
+      }
+      vertex_data_[i].dump(prefixes[0], snapshot_dir_path);
+      if (uploader) {
+        uploader->EnqueueFiles(snapshot_dir_path, prefixes);
+      }
+    });
   }
 
   for (size_t src_label_i = 0; src_label_i != vertex_label_num_;
@@ -339,37 +1184,201 @@ void MutablePropertyFragment::Dump(const std::string& work_dir,
         size_t index = src_label_i * vertex_label_num_ * edge_label_num_ +
                        dst_label_i * edge_label_num_ + e_label_i;
         if (dual_csr_list_[index] != NULL) {
-          dual_csr_list_[index]->Resize(vertex_num[src_label_i],
-                                        vertex_num[dst_label_i]);
-          if (schema_.get_sort_on_compaction(src_label, dst_label,
-                                             edge_label)) {
-            dual_csr_list_[index]->SortByEdgeData(version + 1);
-          }
-          dual_csr_list_[index]->Dump(
-              oe_prefix(src_label, dst_label, edge_label),
-              ie_prefix(src_label, dst_label, edge_label),
-              edata_prefix(src_label, dst_label, edge_label),
-              snapshot_dir_path);
+          tasks.emplace_back([this, index, src_label_i, dst_label_i, src_label,
+                              dst_label, edge_label, version, uploader,
+                              &vertex_num, &snapshot_dir_path, &link_clean]() {
+            std::vector<std::string> prefixes = {
+                oe_prefix(src_label, dst_label, edge_label),
+                ie_prefix(src_label, dst_label, edge_label),
+                edata_prefix(src_label, dst_label, edge_label)};
+            // The csrs are sized after the vertices of both labels.
+            bool dirty = csr_dirty_[index].load() ||
+                         indexer_dirty_[src_label_i].load() ||
+                         indexer_dirty_[dst_label_i].load();
+            if (!link_clean(dirty, prefixes)) {
+              dual_csr_list_[index]->Resize(vertex_num[src_label_i],
+                                            vertex_num[dst_label_i]);
+              if (schema_.get_sort_on_compaction(src_label, dst_label,
+                                                 edge_label)) {
+                dual_csr_list_[index]->SortByEdgeData(version + 1);
+              } else if (schema_.get_sort_by_neighbor(src_label, dst_label,
+                                                      edge_label)) {
+                dual_csr_list_[index]->SortByNeighbor(version + 1);
+              }
+              dual_csr_list_[index]->Dump(prefixes[0], prefixes[1],
+                                          prefixes[2], snapshot_dir_path);
+            }
+            if (uploader) {
+              uploader->EnqueueFiles(snapshot_dir_path, prefixes);
+            }
+          });
         }
       }
     }
   }
+  run_tasks_in_parallel(tasks);
+
+  // Dumped with the snapshot, as vertex properties may change after it.
+  DumpSchema(snapshot_schema_path(snapshot_dir_path));
+  write_snapshot_manifest(snapshot_dir_path, prev_snapshot_dir_path, linked);
+  VLOG(10) << "Linked " << linked.size() << " files of unchanged parts from "
+           << prev_snapshot_dir_path;
+  if (uploader) {
+    uploader->EnqueueFiles(snapshot_dir_path);
+    wait_for_upload(*uploader);
+  }
   set_snapshot_version(work_dir, version);
+  resetDirty(snapshot_dir_path);
+  DumpSchema(schema_path(work_dir));
+  if (uploader) {
+    uploader->Enqueue(schema_path(work_dir));
+    wait_for_upload(*uploader);
+    uploader->Enqueue(snapshot_version_path(work_dir));
+    wait_for_upload(*uploader);
+  }
 }
 
 void MutablePropertyFragment::Warmup(int thread_num) {
   double t = -grape::GetCurrentTime();
-  for (auto ptr : dual_csr_list_) {
-    if (ptr != NULL) {
-      ptr->Warmup(thread_num);
-    }
-  }
-  for (auto& indexer : lf_indexers_) {
-    indexer.warmup(thread_num);
+  for (const auto& target : WarmupTargets()) {
+    Warmup(target, thread_num);
   }
   t += grape::GetCurrentTime();
   LOG(INFO) << "Warmup takes: " << t << " s";
 }
+
+std::vector<WarmupTarget> MutablePropertyFragment::WarmupTargets() const {
+  std::vector<WarmupTarget> ret;
+  for (size_t i = 0; i != vertex_label_num_; ++i) {
+    WarmupTarget target;
+    target.label = schema_.get_vertex_label_name(i);
+    ret.emplace_back(std::move(target));
+  }
+  for (size_t src_label_i = 0; src_label_i != vertex_label_num_;
+       ++src_label_i) {
+    for (size_t dst_label_i = 0; dst_label_i != vertex_label_num_;
+         ++dst_label_i) {
+      for (size_t e_label_i = 0; e_label_i != edge_label_num_; ++e_label_i) {
+        size_t index = src_label_i * vertex_label_num_ * edge_label_num_ +
+                       dst_label_i * edge_label_num_ + e_label_i;
+        if (dual_csr_list_[index] == NULL) {
+          continue;
+        }
+        WarmupTarget target;
+        target.label = schema_.get_edge_label_name(e_label_i);
+        target.src_label = schema_.get_vertex_label_name(src_label_i);
+        target.dst_label = schema_.get_vertex_label_name(dst_label_i);
+        ret.emplace_back(std::move(target));
+      }
+    }
+  }
+  return ret;
+}
+
+bool MutablePropertyFragment::warmupParts(
+    const WarmupTarget& target, int thread_num,
+    std::vector<WarmupPart>& parts) const {
+  if (target.is_edge()) {
+    if (!schema_.exist(target.src_label, target.dst_label, target.label)) {
+      return false;
+    }
+    label_t src_label = schema_.get_vertex_label_id(target.src_label);
+    label_t dst_label = schema_.get_vertex_label_id(target.dst_label);
+    label_t edge_label = schema_.get_edge_label_id(target.label);
+    size_t index = src_label * vertex_label_num_ * edge_label_num_ +
+                   dst_label * edge_label_num_ + edge_label;
+    const DualCsrBase* dual_csr = dual_csr_list_[index];
+    if (dual_csr == NULL) {
+      return false;
+    }
+    for (const CsrBase* csr : {dual_csr->GetOutCsr(), dual_csr->GetInCsr()}) {
+      parts.push_back({[csr]() { return csr->memory_usage(); },
+                       [csr, thread_num]() { csr->warmup(thread_num); },
+                       true});
+    }
+    parts.push_back({[dual_csr]() { return dual_csr->EdgeDataMemoryUsage(); },
+                     [dual_csr]() { dual_csr->WarmupEdgeData(); }, false});
+    return true;
+  }
+
+  if (!schema_.contains_vertex_label(target.label)) {
+    return false;
+  }
+  label_t label = schema_.get_vertex_label_id(target.label);
+  const IndexerType* indexer = &lf_indexers_[label];
+  parts.push_back({[indexer]() { return indexer->memory_usage(); },
+                   [indexer, thread_num]() { indexer->warmup(thread_num); },
+                   true});
+  const Table& table = vertex_data_[label];
+  std::vector<const ColumnBase*> columns;
+  if (target.properties.empty()) {
+    for (size_t col_i = 0; col_i != table.col_num(); ++col_i) {
+      columns.push_back(table.get_column_by_id(col_i).get());
+    }
+  }
+  std::string primary_key =
+      std::get<1>(schema_.get_vertex_primary_key(label)[0]);
+  for (const auto& property : target.properties) {
+    auto column = table.get_column(property);
+    if (column != nullptr) {
+      columns.push_back(column.get());
+    } else if (property != primary_key) {
+      // The primary keys are in the indexer.
+      return false;
+    }
+  }
+  for (auto column : columns) {
+    parts.push_back({[column]() { return column->memory_usage(); },
+                     [column]() { column->warmup(); }, false});
+  }
+  return true;
+}
+
+bool MutablePropertyFragment::Warmup(const WarmupTarget& target,
+                                     int thread_num) const {
+  return Warmup(target, thread_num,
+                [](const std::function<void()>& func) { func(); });
+}
+
+bool MutablePropertyFragment::Warmup(
+    const WarmupTarget& target, int thread_num,
+    const std::function<void(const std::function<void()>&)>& run_part) const {
+  std::vector<WarmupPart> parts;
+  if (!warmupParts(target, thread_num, parts)) {
+    return false;
+  }
+  std::vector<std::function<void()>> tasks;
+  auto run_tasks = [&]() {
+    if (!tasks.empty()) {
+      run_part([&]() { run_tasks_in_parallel(tasks, thread_num); });
+      tasks.clear();
+    }
+  };
+  for (const auto& part : parts) {
+    if (part.parallel) {
+      run_part(part.warmup);
+    } else {
+      tasks.push_back(part.warmup);
+      if (tasks.size() >= static_cast<size_t>(std::max(thread_num, 1))) {
+        run_tasks();
+      }
+    }
+  }
+  run_tasks();
+  return true;
+}
+
+MemoryUsage MutablePropertyFragment::WarmupMemoryUsage(
+    const WarmupTarget& target) const {
+  std::vector<WarmupPart> parts;
+  MemoryUsage ret;
+  if (warmupParts(target, 1, parts)) {
+    for (const auto& part : parts) {
+      ret += part.memory_usage();
+    }
+  }
+  return ret;
+}
 void MutablePropertyFragment::IngestEdge(label_t src_label, vid_t src_lid,
                                          label_t dst_label, vid_t dst_lid,
                                          label_t edge_label, timestamp_t ts,
@@ -377,15 +1386,52 @@ void MutablePropertyFragment::IngestEdge(label_t src_label, vid_t src_lid,
                                          Allocator& alloc) {
   size_t index = src_label * vertex_label_num_ * edge_label_num_ +
                  dst_label * edge_label_num_ + edge_label;
+  markDirty(csr_dirty_[index]);
+  // The filter learns the edge before it is published.
+  if (edge_filters_[index] != nullptr) {
+    edge_filters_[index]->insert(edge_filter_key(src_lid, dst_lid));
+  }
   dual_csr_list_[index]->IngestEdge(src_lid, dst_lid, arc, ts, alloc);
 }
 
+void MutablePropertyFragment::IngestEdges(
+    label_t src_label, label_t dst_label, label_t edge_label,
+    const std::vector<vid_t>& src_lids, const std::vector<vid_t>& dst_lids,
+    timestamp_t ts, grape::OutArchive& arc, Allocator& alloc) {
+  size_t index = src_label * vertex_label_num_ * edge_label_num_ +
+                 dst_label * edge_label_num_ + edge_label;
+  markDirty(csr_dirty_[index]);
+  auto* filter = edge_filters_[index].get();
+  auto* dual_csr = dual_csr_list_[index];
+  size_t edge_num = src_lids.size();
+  for (size_t i = 0; i < edge_num; ++i) {
+    if (filter != nullptr) {
+      filter->insert(edge_filter_key(src_lids[i], dst_lids[i]));
+    }
+    dual_csr->IngestEdge(src_lids[i], dst_lids[i], arc, ts, alloc);
+  }
+}
+
+void MutablePropertyFragment::SkipEdgeData(label_t src_label,
+                                           label_t dst_label,
+                                           label_t edge_label,
+                                           grape::OutArchive& arc) const {
+  size_t index = src_label * vertex_label_num_ * edge_label_num_ +
+                 dst_label * edge_label_num_ + edge_label;
+  dual_csr_list_[index]->SkipEdgeData(arc);
+}
+
 void MutablePropertyFragment::UpdateEdge(label_t src_label, vid_t src_lid,
                                          label_t dst_label, vid_t dst_lid,
                                          label_t edge_label, timestamp_t ts,
                                          const Any& arc, Allocator& alloc) {
   size_t index = src_label * vertex_label_num_ * edge_label_num_ +
                  dst_label * edge_label_num_ + edge_label;
+  markDirty(csr_dirty_[index]);
+  // UpdateEdge inserts the edge if it does not exist.
+  if (edge_filters_[index] != nullptr) {
+    edge_filters_[index]->insert(edge_filter_key(src_lid, dst_lid));
+  }
   dual_csr_list_[index]->UpdateEdge(src_lid, dst_lid, arc, ts, alloc);
 }
 const Schema& MutablePropertyFragment::schema() const { return schema_; }
@@ -417,7 +1463,124 @@ Any MutablePropertyFragment::get_oid(label_t label, vid_t lid) const {
 }
 
 vid_t MutablePropertyFragment::add_vertex(label_t label, const Any& id) {
-  return lf_indexers_[label].insert(id);
+  markDirty(indexer_dirty_[label]);
+  vid_t lid = lf_indexers_[label].insert(id);
+  if (lid >= vertex_capacities_[label].load(std::memory_order_acquire)) {
+    growVertexCapacity(label, lid);
+  }
+  return lid;
+}
+
+bool MutablePropertyFragment::ClaimVertexSlots(label_t label, size_t num) {
+  auto& claims = vertex_claims_[label];
+  // The claims are loaded before the vertex num, as the transactions add
+  // their vertices before giving their claims back.
+  size_t claimed = claims.load();
+  do {
+    if (claimed + lf_indexers_[label].size() + num > vertex_reserved_[label]) {
+      LOG(ERROR) << "Vertex label " << schema_.get_vertex_label_name(label)
+                 << " is full at its reserved capacity "
+                 << vertex_reserved_[label]
+                 << ", see max_vertex_num in the schema";
+      return false;
+    }
+  } while (!claims.compare_exchange_weak(claimed, claimed + num));
+  return true;
+}
+
+void MutablePropertyFragment::ReleaseVertexSlots(label_t label, size_t num) {
+  vertex_claims_[label].fetch_sub(num);
+}
+
+bool MutablePropertyFragment::ClaimVertexSlots(
+    const std::vector<size_t>& nums) {
+  for (size_t label = 0; label < nums.size(); ++label) {
+    if (nums[label] != 0 && !ClaimVertexSlots(label, nums[label])) {
+      while (label-- > 0) {
+        ReleaseVertexSlots(label, nums[label]);
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+void MutablePropertyFragment::ReleaseVertexSlots(
+    const std::vector<size_t>& nums) {
+  for (size_t label = 0; label < nums.size(); ++label) {
+    if (nums[label] != 0) {
+      ReleaseVertexSlots(label, nums[label]);
+    }
+  }
+}
+
+void MutablePropertyFragment::ReserveVertexGrowth() {
+  for (label_t label = 0; label < vertex_label_num_; ++label) {
+    std::lock_guard<std::mutex> lock(vertex_grow_mutexes_[label]);
+    size_t reserved =
+        vertex_reservation(schema_, label, lf_indexers_[label].size());
+    if (reserved > vertex_reserved_[label]) {
+      reserveVertexGrowth(label, reserved);
+    }
+  }
+}
+
+void MutablePropertyFragment::reserveVertexGrowth(label_t label,
+                                                  size_t reserved) {
+  lf_indexers_[label].reserve_growth(reserved);
+  vertex_data_[label].reserve(reserved);
+  for (label_t other = 0; other < vertex_label_num_; ++other) {
+    for (label_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+      size_t oe_index = label * vertex_label_num_ * edge_label_num_ +
+                        other * edge_label_num_ + e_label;
+      size_t ie_index = other * vertex_label_num_ * edge_label_num_ +
+                        label * edge_label_num_ + e_label;
+      if (oe_[oe_index] != NULL) {
+        oe_[oe_index]->reserve(reserved);
+      }
+      if (ie_[ie_index] != NULL) {
+        ie_[ie_index]->reserve(reserved);
+      }
+    }
+  }
+  vertex_reserved_[label] = reserved;
+}
+
+void MutablePropertyFragment::growVertexCapacity(label_t label, vid_t lid) {
+  std::lock_guard<std::mutex> lock(vertex_grow_mutexes_[label]);
+  size_t capacity = vertex_capacities_[label].load(std::memory_order_relaxed);
+  if (lid < capacity) {
+    return;
+  }
+  size_t new_capacity = std::max<size_t>(lid + 1, capacity * 2);
+  if (lid < vertex_reserved_[label]) {
+    new_capacity = std::min(new_capacity, vertex_reserved_[label]);
+  } else {
+    // E.g. replaying the wal past the max_vertex_num, the label moves to a
+    // larger reservation. The vertices added while the graph is served never
+    // get here, see ClaimVertexSlots, as their readers would be moved under.
+    size_t reserved = std::max(new_capacity, vertex_reserved_[label] * 2);
+    LOG(WARNING) << "Vertex label " << schema_.get_vertex_label_name(label)
+                 << " grows past its reserved capacity "
+                 << vertex_reserved_[label] << ", reserving " << reserved;
+    reserveVertexGrowth(label, reserved);
+  }
+  vertex_data_[label].resize(new_capacity);
+  for (label_t other = 0; other < vertex_label_num_; ++other) {
+    for (label_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+      size_t oe_index = label * vertex_label_num_ * edge_label_num_ +
+                        other * edge_label_num_ + e_label;
+      size_t ie_index = other * vertex_label_num_ * edge_label_num_ +
+                        label * edge_label_num_ + e_label;
+      if (oe_[oe_index] != NULL) {
+        oe_[oe_index]->resize(new_capacity);
+      }
+      if (ie_[ie_index] != NULL) {
+        ie_[ie_index]->resize(new_capacity);
+      }
+    }
+  }
+  vertex_capacities_[label].store(new_capacity, std::memory_order_release);
 }
 
 std::shared_ptr<CsrConstEdgeIterBase>
@@ -458,18 +1621,188 @@ MutablePropertyFragment::get_incoming_edges_mut(label_t label, vid_t u,
   return get_ie_csr(label, neighbor_label, edge_label)->edge_iter_mut(u);
 }
 
-void MutablePropertyFragment::generateStatistics(
-    const std::string& work_dir) const {
+std::vector<vid_t> MutablePropertyFragment::sampleVertices(
+    label_t label, size_t num, uint64_t seed) const {
+  vid_t vnum = vertex_num(label);
+  std::vector<vid_t> ret;
+  if (num >= vnum) {
+    ret.resize(vnum);
+    std::iota(ret.begin(), ret.end(), 0);
+    return ret;
+  }
+  // Floyd's algorithm, drawing num distinct values in num steps.
+  std::mt19937_64 rng(seed);
+  std::unordered_set<vid_t> picked;
+  picked.reserve(num);
+  for (vid_t j = vnum - num; j < vnum; ++j) {
+    vid_t t = std::uniform_int_distribution<vid_t>(0, j)(rng);
+    if (!picked.insert(t).second) {
+      picked.insert(j);
+    }
+  }
+  ret.assign(picked.begin(), picked.end());
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+static bool numeric_value(const Any& value, double& ret) {
+  switch (value.type.type_enum) {
+  case impl::PropertyTypeImpl::kInt32:
+    ret = value.AsInt32();
+    return true;
+  case impl::PropertyTypeImpl::kUInt32:
+    ret = value.AsUInt32();
+    return true;
+  case impl::PropertyTypeImpl::kInt64:
+    ret = value.AsInt64();
+    return true;
+  case impl::PropertyTypeImpl::kUInt64:
+    ret = value.AsUInt64();
+    return true;
+  case impl::PropertyTypeImpl::kFloat:
+    ret = value.AsFloat();
+    return true;
+  case impl::PropertyTypeImpl::kDouble:
+    ret = value.AsDouble();
+    return true;
+  case impl::PropertyTypeImpl::kDate:
+    ret = value.AsDate().milli_second;
+    return true;
+  case impl::PropertyTypeImpl::kDay:
+    ret = value.AsDay().to_u32();
+    return true;
+  default:
+    return false;
+  }
+}
+
+static std::string double_to_json(double value) {
+  std::ostringstream ss;
+  ss.precision(17);
+  ss << value;
+  return ss.str();
+}
+
+// The degrees of the sampled vertices, as "avg" (exact, edge_num / vnum),
+// "p50", "p90", "p99" and "max" of the sample.
+static std::string degree_statistics(const CsrBase* csr,
+                                     const std::vector<vid_t>& sample,
+                                     size_t edge_num, size_t vnum) {
+  std::vector<size_t> degrees;
+  degrees.reserve(sample.size());
+  if (csr != nullptr) {
+    for (vid_t v : sample) {
+      degrees.push_back(csr->edge_iter(v)->size());
+    }
+  }
+  std::sort(degrees.begin(), degrees.end());
+  auto quantile = [&degrees](double q) -> size_t {
+    if (degrees.empty()) {
+      return 0;
+    }
+    return degrees[std::min(degrees.size() - 1,
+                            static_cast<size_t>(q * degrees.size()))];
+  };
+  double avg = vnum == 0 ? 0 : static_cast<double>(edge_num) / vnum;
+  std::string ss = "{\"avg\": " + double_to_json(avg);
+  ss += ", \"p50\": " + std::to_string(quantile(0.5));
+  ss += ", \"p90\": " + std::to_string(quantile(0.9));
+  ss += ", \"p99\": " + std::to_string(quantile(0.99));
+  ss += ", \"max\": " + std::to_string(degrees.empty() ? 0 : degrees.back());
+  ss += "}";
+  return ss;
+}
+
+// The statistics of a vertex property estimated on the sampled vertices: the
+// distinct count by the GEE estimator, sqrt(vnum / n) * f1 + sum(f2..), with
+// fi the number of values seen i times in the sample, and for numeric and
+// temporal properties the bounds of bucket_num equi-depth buckets.
+static std::string property_statistics(const std::string& name,
+                                       const ColumnBase& column,
+                                       const std::vector<vid_t>& sample,
+                                       size_t vnum, size_t bucket_num) {
+  std::unordered_map<Any, size_t, GHash<Any>> freq;
+  std::vector<double> values;
+  bool numeric = true;
+  for (vid_t v : sample) {
+    Any value = column.get(v);
+    ++freq[value];
+    double d;
+    if (numeric && numeric_value(value, d)) {
+      values.push_back(d);
+    } else {
+      numeric = false;
+    }
+  }
+  double distinct = freq.size();
+  if (sample.size() < vnum) {
+    size_t once = 0;
+    for (auto& pair : freq) {
+      if (pair.second == 1) {
+        ++once;
+      }
+    }
+    distinct = std::sqrt(static_cast<double>(vnum) / sample.size()) * once +
+               (freq.size() - once);
+  }
+  std::string ss = "{\n\"name\": \"" + name + "\", \n";
+  ss += "\"sample_count\": " + std::to_string(sample.size()) + ", \n";
+  ss += "\"distinct_count\": " +
+        std::to_string(static_cast<size_t>(std::llround(distinct)));
+  if (numeric && !values.empty()) {
+    std::sort(values.begin(), values.end());
+    ss += ", \n\"histogram\": [";
+    for (size_t i = 0; i <= bucket_num; ++i) {
+      size_t idx = std::min(values.size() - 1, i * values.size() / bucket_num);
+      if (i != 0) {
+        ss += ", ";
+      }
+      ss += double_to_json(values[idx]);
+    }
+    ss += "]";
+  }
+  ss += "\n}";
+  return ss;
+}
+
+void MutablePropertyFragment::generateStatistics(const std::string& work_dir,
+                                                 size_t sample_num) const {
   std::string filename = work_dir + "/statistics.json";
   size_t vertex_count = 0;
+  size_t vertex_label_num = schema_.vertex_label_num();
+
+  std::vector<std::vector<vid_t>> samples(vertex_label_num);
+  std::vector<std::string> property_stats(vertex_label_num);
+  {
+    std::vector<std::thread> sample_threads;
+    for (size_t idx = 0; idx < vertex_label_num; ++idx) {
+      sample_threads.emplace_back([&, idx] {
+        label_t label = static_cast<label_t>(idx);
+        samples[idx] = sampleVertices(label, sample_num, idx);
+        const auto& table = vertex_data_[idx];
+        auto names = table.column_names();
+        for (size_t i = 0; i < names.size(); ++i) {
+          if (i != 0) {
+            property_stats[idx] += ", \n";
+          }
+          property_stats[idx] += property_statistics(
+              names[i], *table.get_column_by_id(i), samples[idx],
+              vertex_num(label), HISTOGRAM_BUCKET_NUM);
+        }
+      });
+    }
+    for (auto& t : sample_threads) {
+      t.join();
+    }
+  }
 
   std::string ss = "\"vertex_type_statistics\": [\n";
-  size_t vertex_label_num = schema_.vertex_label_num();
   for (size_t idx = 0; idx < vertex_label_num; ++idx) {
     ss += "{\n\"type_id\": " + std::to_string(idx) + ", \n";
     ss += "\"type_name\": \"" + schema_.get_vertex_label_name(idx) + "\", \n";
     size_t count = lf_indexers_[idx].size();
-    ss += "\"count\": " + std::to_string(count) + "\n}";
+    ss += "\"count\": " + std::to_string(count) + ", \n";
+    ss += "\"property_statistics\": [\n" + property_stats[idx] + "\n]\n}";
     vertex_count += count;
     if (idx != vertex_label_num - 1) {
       ss += ", \n";
@@ -483,6 +1816,8 @@ void MutablePropertyFragment::generateStatistics(
   size_t edge_label_num = schema_.edge_label_num();
   std::vector<std::thread> count_threads;
   std::vector<size_t> edge_count_list(dual_csr_list_.size(), 0);
+  std::vector<std::string> out_degree_list(dual_csr_list_.size());
+  std::vector<std::string> in_degree_list(dual_csr_list_.size());
   for (size_t src_label = 0; src_label < vertex_label_num; ++src_label) {
     const auto& src_label_name = schema_.get_vertex_label_name(src_label);
     for (size_t dst_label = 0; dst_label < vertex_label_num; ++dst_label) {
@@ -493,8 +1828,15 @@ void MutablePropertyFragment::generateStatistics(
           size_t index = src_label * vertex_label_num * edge_label_num +
                          dst_label * edge_label_num + edge_label;
           if (dual_csr_list_[index] != NULL) {
-            count_threads.emplace_back([&edge_count_list, index, this] {
-              edge_count_list[index] = dual_csr_list_[index]->EdgeNum();
+            count_threads.emplace_back([&, index, src_label, dst_label] {
+              size_t num = dual_csr_list_[index]->EdgeNum();
+              edge_count_list[index] = num;
+              out_degree_list[index] =
+                  degree_statistics(oe_[index], samples[src_label], num,
+                                    vertex_num(src_label));
+              in_degree_list[index] =
+                  degree_statistics(ie_[index], samples[dst_label], num,
+                                    vertex_num(dst_label));
             });
           }
         }
@@ -528,7 +1870,12 @@ void MutablePropertyFragment::generateStatistics(
           first = false;
           ss += "{\n\"source_vertex\" : \"" + src_label_name + "\", \n";
           ss += "\"destination_vertex\" : \"" + dst_label_name + "\", \n";
-          ss += "\"count\" : " + std::to_string(edge_count_list[index]) + "\n";
+          ss += "\"count\" : " + std::to_string(edge_count_list[index]);
+          if (!out_degree_list[index].empty()) {
+            ss += ", \n\"out_degree\" : " + out_degree_list[index];
+            ss += ", \n\"in_degree\" : " + in_degree_list[index];
+          }
+          ss += "\n";
           edge_count += edge_count_list[index];
           ss += "}";
         }
@@ -544,12 +1891,16 @@ void MutablePropertyFragment::generateStatistics(
   }
   ss += "]\n";
   {
-    std::ofstream out(filename);
+    // Written aside and renamed, so that readers of the file never see it
+    // half written when it is refreshed.
+    std::string tmp_filename = filename + ".tmp";
+    std::ofstream out(tmp_filename);
     out << "{\n\"total_vertex_count\": " << vertex_count << ",\n";
     out << "\"total_edge_count\": " << edge_count << ",\n";
     out << ss;
     out << "}\n";
     out.close();
+    std::filesystem::rename(tmp_filename, filename);
   }
 }
 
@@ -16,6 +16,11 @@
 #ifndef GRAPHSCOPE_FRAGMENT_MUTABLE_PROPERTY_FRAGMENT_H_
 #define GRAPHSCOPE_FRAGMENT_MUTABLE_PROPERTY_FRAGMENT_H_
 
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <tuple>
 #include <vector>
@@ -24,8 +29,14 @@
 
 #include "flex/storages/rt_mutable_graph/csr/mutable_csr.h"
 #include "flex/storages/rt_mutable_graph/dual_csr.h"
+#include "flex/storages/rt_mutable_graph/range_index.h"
+#include "flex/storages/rt_mutable_graph/secondary_index.h"
+#include "flex/storages/rt_mutable_graph/text_index.h"
+#include "flex/storages/rt_mutable_graph/vector_index.h"
 #include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/storages/rt_mutable_graph/vertex_property_versions.h"
 #include "flex/utils/arrow_utils.h"
+#include "flex/utils/bloom_filter.h"
 #include "flex/utils/indexers.h"
 #include "flex/utils/property/table.h"
 #include "flex/utils/yaml_utils.h"
@@ -34,6 +45,36 @@
 
 namespace gs {
 
+class SnapshotUploader;
+
+struct VertexLabelMemoryUsage {
+  label_t label;
+  MemoryUsage indexer;
+  // (property name, usage) of the vertex properties.
+  std::vector<std::pair<std::string, MemoryUsage>> columns;
+};
+
+struct EdgeTripletMemoryUsage {
+  label_t src_label, dst_label, edge_label;
+  MemoryUsage out_csr, in_csr, edge_data;
+};
+
+// An entry of a warmup priority list: the indexer and the given properties
+// (all of them if none is given) of a vertex label, or, when src_label and
+// dst_label are set, the csrs and the properties of a triplet of the edge
+// label.
+struct WarmupTarget {
+  std::string label;
+  std::vector<std::string> properties;
+  std::string src_label, dst_label;
+
+  bool is_edge() const { return !src_label.empty(); }
+
+  std::string ToString() const {
+    return is_edge() ? src_label + "-[" + label + "]->" + dst_label : label;
+  }
+};
+
 class MutablePropertyFragment {
  public:
   MutablePropertyFragment();
@@ -44,17 +85,67 @@ class MutablePropertyFragment {
                   vid_t dst_lid, label_t edge_label, timestamp_t ts,
                   grape::OutArchive& arc, Allocator& alloc);
 
+  // Ingests the edges (src_lids[i], dst_lids[i]) of a triplet, whose data
+  // follow each other in arc.
+  void IngestEdges(label_t src_label, label_t dst_label, label_t edge_label,
+                   const std::vector<vid_t>& src_lids,
+                   const std::vector<vid_t>& dst_lids, timestamp_t ts,
+                   grape::OutArchive& arc, Allocator& alloc);
+
+  // Consumes the data of an edge of the triplet, as IngestEdge reads it.
+  void SkipEdgeData(label_t src_label, label_t dst_label, label_t edge_label,
+                    grape::OutArchive& arc) const;
+
   void UpdateEdge(label_t src_label, vid_t src_lid, label_t dst_label,
                   vid_t dst_lid, label_t edge_label, timestamp_t ts,
                   const Any& arc, Allocator& alloc);
 
   void Open(const std::string& work_dir, int memory_level);
 
-  void Compact(uint32_t version);
+  // Re-sorts the adjacency lists written since the last compaction, in
+  // parallel across triplets. Triplets whose unsorted vertices would exceed
+  // max_vertex_num are left out, except that at least one triplet is always
+  // compacted. Returns true if some triplets were left for a later call.
+  // The vertex properties dropped before are removed first, the ids of the
+  // properties after them move down.
+  bool Compact(uint32_t version,
+               size_t max_vertex_num = std::numeric_limits<size_t>::max());
+
+  // Number of vertices the next full compaction would visit.
+  size_t PendingCompactionVertexNum() const;
+
+  // Whether some adjacency lists were written since the last compaction, and
+  // hence are scanned with visibility tests, see CsrBase::batch_freeze.
+  bool HasUnfrozenWrites() const;
 
+  // Touches the indexers, properties and csrs of every label and triplet.
   void Warmup(int thread_num);
 
-  void Dump(const std::string& work_dir, uint32_t version);
+  // Every vertex label and then every triplet, in schema order.
+  std::vector<WarmupTarget> WarmupTargets() const;
+
+  // Touches the storage of target, its properties thread_num at a time in
+  // parallel. Returns false if the target names a label, triplet or property
+  // not in the schema.
+  bool Warmup(const WarmupTarget& target, int thread_num) const;
+
+  // As above, a part of the target at a time: the indexer, a csr, or up to
+  // thread_num properties or edge data touched together, each by a call of
+  // run_part, e.g. to hold the storage in place for the part only.
+  bool Warmup(
+      const WarmupTarget& target, int thread_num,
+      const std::function<void(const std::function<void()>&)>& run_part) const;
+
+  // Memory that Warmup(target) touches, and how much of it is resident.
+  MemoryUsage WarmupMemoryUsage(const WarmupTarget& target) const;
+
+  // Writes the graph as snapshot version of work_dir. With an uploader, each
+  // file is queued for upload once written, and the VERSION file only after
+  // the rest of the snapshot is uploaded. The indexers, vertex tables and
+  // triplets not written since the latest snapshot was opened or dumped are
+  // hard linked from it instead, with the checksums of its manifest.
+  void Dump(const std::string& work_dir, uint32_t version,
+            SnapshotUploader* uploader = nullptr);
 
   void DumpSchema(const std::string& filename);
 
@@ -64,7 +155,10 @@ class MutablePropertyFragment {
 
   void Clear();
 
+  // The mutable accessors below mark what they return as written, see
+  // Dump. Writers of the storage must go through them.
   inline Table& get_vertex_table(label_t vertex_label) {
+    markDirty(table_dirty_[vertex_label]);
     return vertex_data_[vertex_label];
   }
 
@@ -72,6 +166,113 @@ class MutablePropertyFragment {
     return vertex_data_[vertex_label];
   }
 
+  // Property col_id of vertex lid as seen by a read at timestamp ts, i.e.
+  // the latest version visible at ts or else the value in the table.
+  inline Any get_vertex_property(label_t label, vid_t lid, int col_id,
+                                 timestamp_t ts) const {
+    Any value;
+    if (!vertex_property_versions_.Get(label, lid, col_id, ts, value)) {
+      value = vertex_data_[label].get_column_by_id(col_id)->get(lid);
+    }
+    return value;
+  }
+
+  // The secondary index on property col_id of the label, null if the schema
+  // declares none.
+  inline const SecondaryIndex* get_secondary_index(label_t label,
+                                                   int col_id) const {
+    const auto& indexes = secondary_indexes_[label];
+    return static_cast<size_t>(col_id) < indexes.size()
+               ? indexes[col_id].get()
+               : nullptr;
+  }
+
+  // The range index on property col_id of the label, null if the schema
+  // declares none.
+  inline const RangeIndex* get_range_index(label_t label, int col_id) const {
+    const auto& indexes = range_indexes_[label];
+    return static_cast<size_t>(col_id) < indexes.size()
+               ? indexes[col_id].get()
+               : nullptr;
+  }
+
+  // The vector index on property col_id of the label, null if the schema
+  // declares none.
+  inline const VectorIndex* get_vector_index(label_t label, int col_id) const {
+    const auto& indexes = vector_indexes_[label];
+    return static_cast<size_t>(col_id) < indexes.size()
+               ? indexes[col_id].get()
+               : nullptr;
+  }
+
+  // The text index on property col_id of the label, null if the schema
+  // declares none.
+  inline const TextIndex* get_text_index(label_t label, int col_id) const {
+    const auto& indexes = text_indexes_[label];
+    return static_cast<size_t>(col_id) < indexes.size()
+               ? indexes[col_id].get()
+               : nullptr;
+  }
+
+  // Adds the properties of vertex lid in the table to the property indexes
+  // of the label, once the vertex is written to the table.
+  void IndexVertex(label_t label, vid_t lid);
+
+  // Adds a value written to property col_id of vertex lid, in the table or as
+  // a version, to the indexes on the property if any.
+  inline void IndexVertexProperty(label_t label, vid_t lid, int col_id,
+                                  const Any& value) {
+    size_t col = col_id;
+    auto& indexes = secondary_indexes_[label];
+    if (col < indexes.size() && indexes[col] != nullptr) {
+      indexes[col]->insert(value, lid);
+    }
+    auto& range_indexes = range_indexes_[label];
+    if (col < range_indexes.size() && range_indexes[col] != nullptr) {
+      range_indexes[col]->insert(value, lid);
+    }
+    auto& vector_indexes = vector_indexes_[label];
+    if (col < vector_indexes.size() && vector_indexes[col] != nullptr) {
+      vector_indexes[col]->insert(value, lid);
+    }
+    auto& text_indexes = text_indexes_[label];
+    if (col < text_indexes.size() && text_indexes[col] != nullptr) {
+      text_indexes[col]->insert(value, lid);
+    }
+  }
+
+  inline VertexPropertyVersions& vertex_property_versions() {
+    return vertex_property_versions_;
+  }
+  inline const VertexPropertyVersions& vertex_property_versions() const {
+    return vertex_property_versions_;
+  }
+
+  // Writes the pending property versions into the vertex tables. Only called
+  // while no other transaction runs.
+  void FoldVertexPropertyVersions();
+
+  // Adds a vertex property whose values are the default of the type, in a
+  // column allocated as the values are written, see Table::add_column. The
+  // column is named after ts, the timestamp of the change, which is unique.
+  // Only called while no other transaction runs.
+  void AddVertexProperty(label_t label, const std::string& prop_name,
+                         const PropertyType& type, StorageStrategy strategy,
+                         timestamp_t ts);
+
+  // Drops a vertex property and its indexes. Its column is released, and an
+  // empty one keeps its place, so that the ids of the other properties stay
+  // as they are until the next Compact(). Only called while no other
+  // transaction runs.
+  void DropVertexProperty(label_t label, const std::string& prop_name);
+
+  // How many times vertex properties were added or dropped since the graph
+  // was opened, by which plans bound to the property ids tell they are
+  // stale.
+  inline uint32_t schema_change_num() const {
+    return schema_change_num_.load(std::memory_order_acquire);
+  }
+
   vid_t vertex_num(label_t vertex_label) const;
 
   size_t edge_num(label_t src_label, label_t edge_label,
@@ -79,9 +280,34 @@ class MutablePropertyFragment {
 
   bool get_lid(label_t label, const Any& oid, vid_t& lid) const;
 
+  // Sets lids[i] to the vertex of oids[i] for i in [0, num), or to the max of
+  // vid_t if there is none. KEY_T is int64_t or std::string_view.
+  template <typename KEY_T>
+  inline void get_lid_batch(label_t label, const KEY_T* oids, size_t num,
+                            vid_t* lids) const {
+    lf_indexers_[label].get_index_batch(oids, num, lids);
+  }
+
   Any get_oid(label_t label, vid_t lid) const;
 
   vid_t add_vertex(label_t label, const Any& id);
+
+  // Claims room for num more vertices of the label, for a transaction to
+  // add them while the graph is served, which gives it back once they are
+  // added or it aborts. Fails if the label would grow past its reserved
+  // capacity, its max_vnum, as its table, csrs and keys can not move under
+  // their readers.
+  bool ClaimVertexSlots(label_t label, size_t num);
+  void ReleaseVertexSlots(label_t label, size_t num);
+  // As above, for nums[label] vertices of each label, all or none of them.
+  bool ClaimVertexSlots(const std::vector<size_t>& nums);
+  void ReleaseVertexSlots(const std::vector<size_t>& nums);
+
+  // Reserves room for each label to grow to its max_vnum, or past its
+  // vertices if it has more, before the graph is served, e.g. after
+  // replaying the wal.
+  void ReserveVertexGrowth();
+
   std::shared_ptr<CsrConstEdgeIterBase> get_outgoing_edges(
       label_t label, vid_t u, label_t neighbor_label, label_t edge_label) const;
 
@@ -106,6 +332,7 @@ class MutablePropertyFragment {
                              label_t edge_label) {
     size_t index = label * vertex_label_num_ * edge_label_num_ +
                    neighbor_label * edge_label_num_ + edge_label;
+    markDirty(csr_dirty_[index]);
     return oe_[index];
   }
 
@@ -120,6 +347,7 @@ class MutablePropertyFragment {
                              label_t edge_label) {
     size_t index = neighbor_label * vertex_label_num_ * edge_label_num_ +
                    label * edge_label_num_ + edge_label;
+    markDirty(csr_dirty_[index]);
     return ie_[index];
   }
 
@@ -130,6 +358,17 @@ class MutablePropertyFragment {
     return ie_[index];
   }
 
+  // Returns false if there is no edge from src to dst in the triplet, and
+  // true if there may be one. Triplets without edge_existence_filter in the
+  // schema always return true.
+  inline bool may_have_edge(label_t src_label, vid_t src, label_t dst_label,
+                            vid_t dst, label_t edge_label) const {
+    size_t index = src_label * vertex_label_num_ * edge_label_num_ +
+                   dst_label * edge_label_num_ + edge_label;
+    const auto& filter = edge_filters_[index];
+    return filter == nullptr || filter->may_contain(edge_filter_key(src, dst));
+  }
+
   void loadSchema(const std::string& filename);
   inline std::shared_ptr<ColumnBase> get_vertex_property_column(
       uint8_t label, const std::string& prop) const {
@@ -165,13 +404,106 @@ class MutablePropertyFragment {
     }
   }
 
-  void generateStatistics(const std::string& work_dir) const;
+  // Writes statistics.json into work_dir: the vertex and edge counts, and,
+  // estimated on a sample of at most sample_num vertices per label, the
+  // degree distributions of each triplet and the distinct counts and
+  // equi-depth histograms of the vertex properties.
+  void generateStatistics(const std::string& work_dir,
+                          size_t sample_num = STATISTICS_SAMPLE_NUM) const;
+
+  // Returns min(num, vertex_num(label)) distinct vertices of the label drawn
+  // uniformly at random, in ascending order.
+  std::vector<vid_t> sampleVertices(label_t label, size_t num,
+                                    uint64_t seed) const;
+
+  static constexpr size_t STATISTICS_SAMPLE_NUM = 64 * 1024;
+  static constexpr size_t HISTOGRAM_BUCKET_NUM = 16;
+
+  struct WarmupPart {
+    std::function<MemoryUsage()> memory_usage;
+    std::function<void()> warmup;
+    // Whether warmup spreads over the threads by itself.
+    bool parallel;
+  };
+
+  bool warmupParts(const WarmupTarget& target, int thread_num,
+                   std::vector<WarmupPart>& parts) const;
+
+  // Mapped and resident bytes of the indexer and the properties of each
+  // vertex label, and of the csrs and edge properties of each triplet. The
+  // buffers are measured without locking, so the figures are approximate
+  // while writers or a compaction run.
+  std::vector<VertexLabelMemoryUsage> vertexMemoryUsage() const;
+  std::vector<EdgeTripletMemoryUsage> edgeMemoryUsage() const;
+
+  // (dual csr index, sorted by edge data or by neighbor, unsorted vertex num)
+  // of the triplets that need to be sorted by the next compaction.
+  std::vector<std::tuple<size_t, bool, size_t>> unsortedTriplets() const;
+
+  static inline uint64_t edge_filter_key(vid_t src, vid_t dst) {
+    return (static_cast<uint64_t>(src) << 32) | dst;
+  }
+
+  // (Re)builds the existence filters of the given triplets from their edges.
+  void buildEdgeFilters(const std::vector<size_t>& indices);
+
+  // Removes the vertex properties dropped before, along with their columns
+  // and index slots.
+  void compactVertexProperties();
+
+  // Loads the secondary and range indexes of the label from the snapshot,
+  // building the ones it lacks from the vertex table.
+  void openPropertyIndexes(label_t label, const std::string& snapshot_dir);
+
+  static inline void markDirty(std::atomic<bool>& flag) {
+    // Checked first, so that the flag's cache line is not written again.
+    if (!flag.load(std::memory_order_relaxed)) {
+      flag.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // Marks every part of the graph clean, relative to the snapshot dir.
+  void resetDirty(const std::string& snapshot_dir);
+
+  // Grows the vertex table and the csrs of the label to hold lid, in place
+  // while other threads read them up to the reserved capacity. Past it they
+  // move, which only inserts made while the graph is not served get to, see
+  // ClaimVertexSlots.
+  void growVertexCapacity(label_t label, vid_t lid);
+  // Moves the vertex table, csrs and keys of the label to a reservation of
+  // reserved vertices, which must not race with their readers.
+  void reserveVertexGrowth(label_t label, size_t reserved);
 
   Schema schema_;
   std::vector<IndexerType> lf_indexers_;
   std::vector<CsrBase*> ie_, oe_;
   std::vector<DualCsrBase*> dual_csr_list_;
+  // Indexed as dual_csr_list_, null for triplets without a filter.
+  std::vector<std::unique_ptr<BlockedBloomFilter>> edge_filters_;
   std::vector<Table> vertex_data_;
+  // The rows of the vertex table and the csrs of each label, and the most
+  // they grow online to without moving.
+  std::unique_ptr<std::atomic<size_t>[]> vertex_capacities_;
+  std::vector<size_t> vertex_reserved_;
+  // Slots claimed by transactions for the vertices they are about to add.
+  std::unique_ptr<std::atomic<size_t>[]> vertex_claims_;
+  std::unique_ptr<std::mutex[]> vertex_grow_mutexes_;
+  // Indexed by label and property, null for properties without an index.
+  std::vector<std::vector<std::unique_ptr<SecondaryIndex>>>
+      secondary_indexes_;
+  std::vector<std::vector<std::unique_ptr<RangeIndex>>> range_indexes_;
+  std::vector<std::vector<std::unique_ptr<VectorIndex>>> vector_indexes_;
+  std::vector<std::vector<std::unique_ptr<TextIndex>>> text_indexes_;
+  VertexPropertyVersions vertex_property_versions_;
+  // Where the columns of the vertex tables are mapped from, empty if they
+  // are in memory.
+  std::string column_dir_;
+  std::atomic<uint32_t> schema_change_num_;
+  // Whether vertices were added to each label, properties of each label
+  // written and edges of each triplet written since clean_snapshot_dir_,
+  // which is empty if there is no snapshot to link from.
+  std::vector<std::atomic<bool>> indexer_dirty_, table_dirty_, csr_dirty_;
+  std::string clean_snapshot_dir_;
 
   size_t vertex_label_num_, edge_label_num_;
 };
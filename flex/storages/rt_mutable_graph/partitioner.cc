@@ -0,0 +1,97 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/partitioner.h"
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+#include "glog/logging.h"
+
+namespace gs {
+
+namespace {
+
+// The finalizer of murmur3, so that consecutive keys spread over the
+// partitions. std::hash of an integer is the identity on most platforms.
+uint64_t mix(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+// FNV-1a, which unlike std::hash is the same on every node.
+uint64_t hash_string(std::string_view str) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : str) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool as_integral(const Any& oid, int64_t& key) {
+  if (oid.type == PropertyType::kInt64) {
+    key = oid.AsInt64();
+  } else if (oid.type == PropertyType::kUInt64) {
+    key = static_cast<int64_t>(oid.AsUInt64());
+  } else if (oid.type == PropertyType::kInt32) {
+    key = oid.AsInt32();
+  } else if (oid.type == PropertyType::kUInt32) {
+    key = oid.AsUInt32();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+VertexPartitioner::VertexPartitioner()
+    : method_(PartitionMethod::kHash), fnum_(1), fid_(0) {}
+
+VertexPartitioner::VertexPartitioner(PartitionMethod method, uint32_t fnum,
+                                     uint32_t fid,
+                                     const std::vector<int64_t>& bounds)
+    : method_(method), fnum_(std::max<uint32_t>(fnum, 1)), fid_(fid),
+      bounds_(bounds) {
+  CHECK_LT(fid_, fnum_);
+  if (method_ == PartitionMethod::kRange) {
+    CHECK_EQ(bounds_.size() + 1, fnum_)
+        << "Range partitioning needs " << fnum_ - 1 << " bounds";
+    CHECK(std::is_sorted(bounds_.begin(), bounds_.end()));
+  }
+}
+
+uint32_t VertexPartitioner::GetPartition(const Any& oid) const {
+  if (fnum_ <= 1) {
+    return 0;
+  }
+  int64_t key;
+  bool integral = as_integral(oid, key);
+  if (method_ == PartitionMethod::kRange && integral) {
+    return std::upper_bound(bounds_.begin(), bounds_.end(), key) -
+           bounds_.begin();
+  }
+  uint64_t hash = integral ? mix(static_cast<uint64_t>(key))
+                           : hash_string(oid.AsStringView());
+  return hash % fnum_;
+}
+
+}  // namespace gs
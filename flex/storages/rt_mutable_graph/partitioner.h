@@ -0,0 +1,68 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_PARTITIONER_H_
+#define STORAGES_RT_MUTABLE_GRAPH_PARTITIONER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+enum class PartitionMethod {
+  kHash,
+  kRange,
+};
+
+// Assigns the vertices of a graph to the shards of a partitioned deployment
+// by their primary keys, the same way on every node, so that a coordinator
+// holding the same partitioner finds the shard owning a vertex.
+//
+// kHash mixes the key; kRange looks up integral keys in bounds, the sorted
+// upper bounds (exclusive) of the first fnum - 1 partitions, and hashes the
+// keys of other types.
+class VertexPartitioner {
+ public:
+  VertexPartitioner();
+  VertexPartitioner(PartitionMethod method, uint32_t fnum, uint32_t fid,
+                    const std::vector<int64_t>& bounds = {});
+
+  // Whether the graph is not partitioned, i.e. every vertex is local.
+  bool trivial() const { return fnum_ <= 1; }
+
+  uint32_t fnum() const { return fnum_; }
+  uint32_t fid() const { return fid_; }
+  PartitionMethod method() const { return method_; }
+  const std::vector<int64_t>& bounds() const { return bounds_; }
+
+  uint32_t GetPartition(const Any& oid) const;
+
+  bool IsLocal(const Any& oid) const {
+    return trivial() || GetPartition(oid) == fid_;
+  }
+
+ private:
+  PartitionMethod method_;
+  uint32_t fnum_;
+  uint32_t fid_;
+  std::vector<int64_t> bounds_;
+};
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_PARTITIONER_H_
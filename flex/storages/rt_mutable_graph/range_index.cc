@@ -0,0 +1,175 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/range_index.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+
+#include "glog/logging.h"
+
+namespace gs {
+
+namespace {
+
+struct EntryKeyLess {
+  bool operator()(const RangeIndex::entry_t& lhs, int64_t rhs) const {
+    return lhs.first < rhs;
+  }
+  bool operator()(int64_t lhs, const RangeIndex::entry_t& rhs) const {
+    return lhs < rhs.first;
+  }
+};
+
+}  // namespace
+
+bool RangeIndex::is_supported(const PropertyType& type) {
+  return type == PropertyType::kInt32 || type == PropertyType::kUInt32 ||
+         type == PropertyType::kInt64 || type == PropertyType::kDate ||
+         type == PropertyType::kDay;
+}
+
+int64_t RangeIndex::key(const Any& value) {
+  const auto& type = value.type;
+  if (type == PropertyType::kInt32) {
+    return value.AsInt32();
+  } else if (type == PropertyType::kUInt32) {
+    return value.AsUInt32();
+  } else if (type == PropertyType::kInt64) {
+    return value.AsInt64();
+  } else if (type == PropertyType::kDate) {
+    return value.AsDate().milli_second;
+  } else {
+    return value.AsDay().to_u32();
+  }
+}
+
+void RangeIndex::insert(const Any& value, vid_t vid) {
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  delta_.emplace(key(value), vid);
+}
+
+void RangeIndex::lookup(int64_t lo, int64_t hi,
+                        std::vector<entry_t>& entries) const {
+  entries.clear();
+  if (lo > hi) {
+    return;
+  }
+  auto begin = std::lower_bound(sorted_.begin(), sorted_.end(), lo,
+                                EntryKeyLess());
+  auto end = std::upper_bound(begin, sorted_.end(), hi, EntryKeyLess());
+  std::vector<entry_t> delta;
+  {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    delta.assign(delta_.lower_bound(lo), delta_.upper_bound(hi));
+  }
+  if (delta.empty()) {
+    entries.assign(begin, end);
+    return;
+  }
+  std::sort(delta.begin(), delta.end());
+  entries.reserve((end - begin) + delta.size());
+  std::merge(begin, end, delta.begin(), delta.end(),
+             std::back_inserter(entries));
+  entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+}
+
+size_t RangeIndex::count(int64_t lo, int64_t hi) const {
+  if (lo > hi) {
+    return 0;
+  }
+  auto begin = std::lower_bound(sorted_.begin(), sorted_.end(), lo,
+                                EntryKeyLess());
+  auto end = std::upper_bound(begin, sorted_.end(), hi, EntryKeyLess());
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  return (end - begin) + delta_.size();
+}
+
+void RangeIndex::rebuild(const ColumnBase& column, vid_t vertex_num) {
+  clear();
+  sorted_.reserve(vertex_num);
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    sorted_.emplace_back(key(column.get(v)), v);
+  }
+  std::sort(sorted_.begin(), sorted_.end());
+}
+
+void RangeIndex::merge() {
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  if (delta_.empty()) {
+    return;
+  }
+  std::vector<entry_t> delta(delta_.begin(), delta_.end());
+  std::sort(delta.begin(), delta.end());
+  size_t mid = sorted_.size();
+  sorted_.insert(sorted_.end(), delta.begin(), delta.end());
+  std::inplace_merge(sorted_.begin(), sorted_.begin() + mid, sorted_.end());
+  sorted_.erase(std::unique(sorted_.begin(), sorted_.end()), sorted_.end());
+  delta_.clear();
+}
+
+void RangeIndex::dump(const std::string& path) const {
+  FILE* fout = fopen(path.c_str(), "wb");
+  CHECK(fout != nullptr) << "Failed to open " << path;
+  std::vector<entry_t> delta;
+  {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    delta.assign(delta_.begin(), delta_.end());
+  }
+  std::sort(delta.begin(), delta.end());
+  std::vector<entry_t> entries;
+  entries.reserve(sorted_.size() + delta.size());
+  std::merge(sorted_.begin(), sorted_.end(), delta.begin(), delta.end(),
+             std::back_inserter(entries));
+  uint64_t entry_num = entries.size();
+  CHECK_EQ(fwrite(&entry_num, sizeof(uint64_t), 1, fout), 1);
+  CHECK_EQ(fwrite(entries.data(), sizeof(entry_t), entry_num, fout),
+           entry_num);
+  fflush(fout);
+  fclose(fout);
+}
+
+bool RangeIndex::open(const std::string& path) {
+  clear();
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+  FILE* fin = fopen(path.c_str(), "rb");
+  CHECK(fin != nullptr) << "Failed to open " << path;
+  uint64_t entry_num = 0;
+  CHECK_EQ(fread(&entry_num, sizeof(uint64_t), 1, fin), 1);
+  sorted_.resize(entry_num);
+  CHECK_EQ(fread(sorted_.data(), sizeof(entry_t), entry_num, fin), entry_num);
+  fclose(fin);
+  CHECK(std::is_sorted(sorted_.begin(), sorted_.end()))
+      << "Corrupted range index " << path;
+  return true;
+}
+
+void RangeIndex::clear() {
+  sorted_.clear();
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  delta_.clear();
+}
+
+size_t RangeIndex::size() const {
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  return sorted_.size() + delta_.size();
+}
+
+}  // namespace gs
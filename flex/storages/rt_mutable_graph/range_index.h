@@ -0,0 +1,88 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_FRAGMENT_RANGE_INDEX_H_
+#define GRAPHSCOPE_FRAGMENT_RANGE_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/column.h"
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+// A sorted index of (value, vid) pairs of a vertex property, declared with
+// range_index in the schema, so that a range of values is found by binary
+// search.
+//
+// The sorted array is built when the graph is opened or dumped; values
+// written since go to a delta, which compaction merges into the array. As in
+// SecondaryIndex, overwritten values keep their entries so that older reads
+// still find them, and the caller checks each entry against the value it
+// sees. insert() and lookup() may run concurrently; open(), rebuild() and
+// merge() must not run concurrently with anything else.
+class RangeIndex {
+ public:
+  using entry_t = std::pair<int64_t, vid_t>;
+
+  // Integers but 64-bit unsigned ones, dates and days can be indexed.
+  static bool is_supported(const PropertyType& type);
+
+  // Order preserving: key(a) < key(b) exactly when a < b.
+  static int64_t key(const Any& value);
+
+  void insert(const Any& value, vid_t vid);
+
+  // Sets entries to those with a key in [lo, hi], ordered by key and vid.
+  void lookup(int64_t lo, int64_t hi, std::vector<entry_t>& entries) const;
+
+  // An upper bound of the number of entries with a key in [lo, hi], cheaper
+  // than a lookup.
+  size_t count(int64_t lo, int64_t hi) const;
+
+  // Replaces the entries with the values of vertices [0, vertex_num) of the
+  // column.
+  void rebuild(const ColumnBase& column, vid_t vertex_num);
+
+  // Moves the delta into the sorted array.
+  void merge();
+
+  void dump(const std::string& path) const;
+
+  // Returns false if the file does not exist, leaving the index empty.
+  bool open(const std::string& path);
+
+  void clear();
+
+  // Number of entries, stale ones included.
+  size_t size() const;
+
+ private:
+  std::vector<entry_t> sorted_;
+  mutable std::mutex delta_mutex_;
+  std::multimap<int64_t, vid_t> delta_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_FRAGMENT_RANGE_INDEX_H_
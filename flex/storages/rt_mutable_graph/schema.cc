@@ -52,6 +52,15 @@ void Schema::Clear() {
   ie_mutability_.clear();
   oe_mutability_.clear();
   sort_on_compactions_.clear();
+  oe_compression_.clear();
+  ie_compression_.clear();
+  sort_by_neighbor_.clear();
+  edge_existence_filter_.clear();
+  csr_storage_.clear();
+  secondary_indexes_.clear();
+  range_indexes_.clear();
+  vector_indexes_.clear();
+  text_indexes_.clear();
   max_vnum_.clear();
   plugin_name_to_path_and_id_.clear();
   plugin_dir_.clear();
@@ -87,7 +96,12 @@ void Schema::add_edge_label(const std::string& src_label,
                             const std::vector<std::string>& prop_names,
                             EdgeStrategy oe, EdgeStrategy ie, bool oe_mutable,
                             bool ie_mutable, bool sort_on_compaction,
-                            const std::string& description) {
+                            const std::string& description,
+                            EdgeCompression oe_compression,
+                            EdgeCompression ie_compression,
+                            bool sort_by_neighbor,
+                            bool edge_existence_filter,
+                            StorageStrategy csr_storage) {
   label_t src_label_id = vertex_label_to_index(src_label);
   label_t dst_label_id = vertex_label_to_index(dst_label);
   label_t edge_label_id = edge_label_to_index(edge_label);
@@ -104,6 +118,11 @@ void Schema::add_edge_label(const std::string& src_label,
   ie_mutability_[label_id] = ie_mutable;
   eprop_names_[label_id] = prop_names;
   sort_on_compactions_[label_id] = sort_on_compaction;
+  oe_compression_[label_id] = oe_compression;
+  ie_compression_[label_id] = ie_compression;
+  sort_by_neighbor_[label_id] = sort_by_neighbor;
+  edge_existence_filter_[label_id] = edge_existence_filter;
+  csr_storage_[label_id] = csr_storage;
   e_descriptions_[label_id] = description;
 }
 
@@ -188,6 +207,200 @@ const std::vector<StorageStrategy>& Schema::get_vertex_storage_strategies(
   return vprop_storage_[index];
 }
 
+void Schema::add_vertex_property(label_t label, const std::string& prop_name,
+                                 const PropertyType& type,
+                                 StorageStrategy strategy) {
+  THROW_EXCEPTION_IF(label >= vprop_names_.size(),
+                     "Fail to add vertex property to label " +
+                         std::to_string(label) + ", out of range");
+  vprop_name_to_type_and_index_[label][prop_name] =
+      std::make_pair(type, vproperties_[label].size());
+  vproperties_[label].push_back(type);
+  vprop_names_[label].push_back(prop_name);
+  vprop_storage_[label].push_back(strategy);
+}
+
+void Schema::drop_vertex_property(label_t label,
+                                  const std::string& prop_name) {
+  auto& names = vprop_names_[label];
+  auto iter = std::find(names.begin(), names.end(), prop_name);
+  size_t col_id = iter - names.begin();
+  THROW_EXCEPTION_IF(
+      iter == names.end() || is_dropped_vertex_property(label, col_id),
+      "Fail to drop vertex property: " + prop_name);
+  *iter = dropped_vertex_property_name(col_id);
+  vproperties_[label][col_id] = PropertyType::kEmpty;
+  vprop_storage_[label][col_id] = StorageStrategy::kMem;
+  build_vprop_name_to_type_and_index(label);
+  for (auto* indexes :
+       {&secondary_indexes_, &range_indexes_, &vector_indexes_,
+        &text_indexes_}) {
+    auto index_iter = indexes->find(label);
+    if (index_iter != indexes->end()) {
+      auto& props = index_iter->second;
+      props.erase(std::remove(props.begin(), props.end(), prop_name),
+                  props.end());
+    }
+  }
+}
+
+std::string Schema::dropped_vertex_property_name(size_t prop_id) {
+  return "__dropped_" + std::to_string(prop_id);
+}
+
+bool Schema::is_dropped_vertex_property(label_t label, size_t prop_id) const {
+  return vproperties_[label][prop_id] == PropertyType::kEmpty;
+}
+
+bool Schema::compact_vertex_properties(label_t label) {
+  auto& names = vprop_names_[label];
+  auto& types = vproperties_[label];
+  auto& strategies = vprop_storage_[label];
+  auto& primary_keys = v_primary_keys_[label];
+  bool compacted = false;
+  for (size_t col_id = names.size(); col_id-- > 0;) {
+    if (!is_dropped_vertex_property(label, col_id)) {
+      continue;
+    }
+    names.erase(names.begin() + col_id);
+    types.erase(types.begin() + col_id);
+    strategies.erase(strategies.begin() + col_id);
+    // The indexes of the primary keys count the properties as declared, the
+    // primary keys among them.
+    std::vector<size_t> key_indexes;
+    for (auto& key : primary_keys) {
+      key_indexes.push_back(std::get<2>(key));
+    }
+    std::sort(key_indexes.begin(), key_indexes.end());
+    size_t declared_index = col_id;
+    for (size_t key_index : key_indexes) {
+      if (key_index <= declared_index) {
+        ++declared_index;
+      }
+    }
+    for (auto& key : primary_keys) {
+      if (std::get<2>(key) > declared_index) {
+        --std::get<2>(key);
+      }
+    }
+    compacted = true;
+  }
+  if (compacted) {
+    build_vprop_name_to_type_and_index(label);
+  }
+  return compacted;
+}
+
+bool Schema::fill_dropped_vertex_properties(label_t label,
+                                            std::vector<Any>& props) const {
+  const auto& types = vproperties_[label];
+  if (props.size() == types.size()) {
+    return true;
+  }
+  size_t live_num = std::count_if(types.begin(), types.end(),
+                                  [](const PropertyType& type) {
+                                    return type != PropertyType::kEmpty;
+                                  });
+  if (props.size() != live_num) {
+    return false;
+  }
+  std::vector<Any> filled;
+  filled.reserve(types.size());
+  auto prop_iter = props.begin();
+  for (const auto& type : types) {
+    filled.push_back(type == PropertyType::kEmpty ? Any() : *prop_iter++);
+  }
+  props.swap(filled);
+  return true;
+}
+
+void Schema::build_vprop_name_to_type_and_index(label_t label) {
+  auto& name_to_type_and_index = vprop_name_to_type_and_index_[label];
+  name_to_type_and_index.clear();
+  const auto& names = vprop_names_[label];
+  for (size_t idx = 0; idx < names.size(); ++idx) {
+    if (!is_dropped_vertex_property(label, idx)) {
+      name_to_type_and_index[names[idx]] =
+          std::make_pair(vproperties_[label][idx], idx);
+    }
+  }
+}
+
+void Schema::add_secondary_index(label_t label, const std::string& prop_name) {
+  if (!has_secondary_index(label, prop_name)) {
+    secondary_indexes_[label].push_back(prop_name);
+  }
+}
+
+bool Schema::has_secondary_index(label_t label,
+                                 const std::string& prop_name) const {
+  const auto& props = get_secondary_indexes(label);
+  return std::find(props.begin(), props.end(), prop_name) != props.end();
+}
+
+const std::vector<std::string>& Schema::get_secondary_indexes(
+    label_t label) const {
+  static const std::vector<std::string> empty;
+  auto iter = secondary_indexes_.find(label);
+  return iter == secondary_indexes_.end() ? empty : iter->second;
+}
+
+void Schema::add_range_index(label_t label, const std::string& prop_name) {
+  if (!has_range_index(label, prop_name)) {
+    range_indexes_[label].push_back(prop_name);
+  }
+}
+
+bool Schema::has_range_index(label_t label,
+                             const std::string& prop_name) const {
+  const auto& props = get_range_indexes(label);
+  return std::find(props.begin(), props.end(), prop_name) != props.end();
+}
+
+const std::vector<std::string>& Schema::get_range_indexes(
+    label_t label) const {
+  static const std::vector<std::string> empty;
+  auto iter = range_indexes_.find(label);
+  return iter == range_indexes_.end() ? empty : iter->second;
+}
+
+void Schema::add_vector_index(label_t label, const std::string& prop_name) {
+  if (!has_vector_index(label, prop_name)) {
+    vector_indexes_[label].push_back(prop_name);
+  }
+}
+
+bool Schema::has_vector_index(label_t label,
+                              const std::string& prop_name) const {
+  const auto& props = get_vector_indexes(label);
+  return std::find(props.begin(), props.end(), prop_name) != props.end();
+}
+
+const std::vector<std::string>& Schema::get_vector_indexes(
+    label_t label) const {
+  static const std::vector<std::string> empty;
+  auto iter = vector_indexes_.find(label);
+  return iter == vector_indexes_.end() ? empty : iter->second;
+}
+
+void Schema::add_text_index(label_t label, const std::string& prop_name) {
+  if (!has_text_index(label, prop_name)) {
+    text_indexes_[label].push_back(prop_name);
+  }
+}
+
+bool Schema::has_text_index(label_t label,
+                            const std::string& prop_name) const {
+  const auto& props = get_text_indexes(label);
+  return std::find(props.begin(), props.end(), prop_name) != props.end();
+}
+
+const std::vector<std::string>& Schema::get_text_indexes(label_t label) const {
+  static const std::vector<std::string> empty;
+  auto iter = text_indexes_.find(label);
+  return iter == text_indexes_.end() ? empty : iter->second;
+}
+
 size_t Schema::get_max_vnum(const std::string& label) const {
   label_t index = get_vertex_label_id(label);
   return max_vnum_[index];
@@ -359,6 +572,59 @@ bool Schema::get_sort_on_compaction(const std::string& src_label,
   return sort_on_compactions_.at(index);
 }
 
+bool Schema::get_sort_by_neighbor(const std::string& src_label,
+                                  const std::string& dst_label,
+                                  const std::string& label) const {
+  label_t src = get_vertex_label_id(src_label);
+  label_t dst = get_vertex_label_id(dst_label);
+  label_t edge = get_edge_label_id(label);
+  return get_sort_by_neighbor(src, dst, edge);
+}
+
+bool Schema::get_sort_by_neighbor(label_t src_label, label_t dst_label,
+                                  label_t label) const {
+  uint32_t index = generate_edge_label(src_label, dst_label, label);
+  auto iter = sort_by_neighbor_.find(index);
+  return iter != sort_by_neighbor_.end() && iter->second;
+}
+
+bool Schema::get_edge_existence_filter(label_t src_label, label_t dst_label,
+                                       label_t label) const {
+  uint32_t index = generate_edge_label(src_label, dst_label, label);
+  auto iter = edge_existence_filter_.find(index);
+  return iter != edge_existence_filter_.end() && iter->second;
+}
+
+StorageStrategy Schema::get_csr_storage_strategy(label_t src_label,
+                                                 label_t dst_label,
+                                                 label_t label) const {
+  uint32_t index = generate_edge_label(src_label, dst_label, label);
+  auto iter = csr_storage_.find(index);
+  return iter == csr_storage_.end() ? StorageStrategy::kMem : iter->second;
+}
+
+EdgeCompression Schema::get_outgoing_edge_compression(
+    const std::string& src_label, const std::string& dst_label,
+    const std::string& label) const {
+  label_t src = get_vertex_label_id(src_label);
+  label_t dst = get_vertex_label_id(dst_label);
+  label_t edge = get_edge_label_id(label);
+  uint32_t index = generate_edge_label(src, dst, edge);
+  auto iter = oe_compression_.find(index);
+  return iter == oe_compression_.end() ? EdgeCompression::kNone : iter->second;
+}
+
+EdgeCompression Schema::get_incoming_edge_compression(
+    const std::string& src_label, const std::string& dst_label,
+    const std::string& label) const {
+  label_t src = get_vertex_label_id(src_label);
+  label_t dst = get_vertex_label_id(dst_label);
+  label_t edge = get_edge_label_id(label);
+  uint32_t index = generate_edge_label(src, dst, edge);
+  auto iter = ie_compression_.find(index);
+  return iter == ie_compression_.end() ? EdgeCompression::kNone : iter->second;
+}
+
 label_t Schema::get_edge_label_id(const std::string& label) const {
   label_t ret;
   THROW_EXCEPTION_IF(!elabel_indexer_.get_index(label, ret),
@@ -414,7 +680,10 @@ void Schema::Serialize(std::unique_ptr<grape::LocalIOAdaptor>& writer) const {
       << eproperties_ << eprop_names_ << ie_strategy_ << oe_strategy_
       << ie_mutability_ << oe_mutability_ << sort_on_compactions_ << max_vnum_
       << v_descriptions_ << e_descriptions_ << description_ << version_
-      << remote_path_ << name_ << id_;
+      << remote_path_ << name_ << id_ << oe_compression_ << ie_compression_
+      << sort_by_neighbor_ << edge_existence_filter_ << csr_storage_
+      << secondary_indexes_ << range_indexes_ << vector_indexes_
+      << text_indexes_;
   CHECK(writer->WriteArchive(arc));
 }
 
@@ -429,6 +698,40 @@ void Schema::Deserialize(std::unique_ptr<grape::LocalIOAdaptor>& reader) {
       ie_mutability_ >> oe_mutability_ >> sort_on_compactions_ >> max_vnum_ >>
       v_descriptions_ >> e_descriptions_ >> description_ >> version_ >>
       remote_path_ >> name_ >> id_;
+  // Schemas serialized before edge compression was introduced end here.
+  oe_compression_.clear();
+  ie_compression_.clear();
+  sort_by_neighbor_.clear();
+  edge_existence_filter_.clear();
+  csr_storage_.clear();
+  secondary_indexes_.clear();
+  range_indexes_.clear();
+  vector_indexes_.clear();
+  text_indexes_.clear();
+  if (!arc.Empty()) {
+    arc >> oe_compression_ >> ie_compression_;
+  }
+  if (!arc.Empty()) {
+    arc >> sort_by_neighbor_;
+  }
+  if (!arc.Empty()) {
+    arc >> edge_existence_filter_;
+  }
+  if (!arc.Empty()) {
+    arc >> csr_storage_;
+  }
+  if (!arc.Empty()) {
+    arc >> secondary_indexes_;
+  }
+  if (!arc.Empty()) {
+    arc >> range_indexes_;
+  }
+  if (!arc.Empty()) {
+    arc >> vector_indexes_;
+  }
+  if (!arc.Empty()) {
+    arc >> text_indexes_;
+  }
   has_multi_props_edge_ = false;
   for (auto& eprops : eproperties_) {
     if (eprops.second.size() > 1) {
@@ -439,10 +742,7 @@ void Schema::Deserialize(std::unique_ptr<grape::LocalIOAdaptor>& reader) {
   vprop_name_to_type_and_index_.clear();
   vprop_name_to_type_and_index_.resize(vprop_names_.size());
   for (size_t i = 0; i < vprop_names_.size(); i++) {
-    for (size_t j = 0; j < vprop_names_[i].size(); j++) {
-      vprop_name_to_type_and_index_[i][vprop_names_[i][j]] =
-          std::make_pair(vproperties_[i][j], j);
-    }
+    build_vprop_name_to_type_and_index(i);
   }
 }
 
@@ -484,21 +784,23 @@ bool Schema::Equals(const Schema& other) const {
       edge_label_num() != other.edge_label_num()) {
     return false;
   }
-  for (label_t i = 0; i < vertex_label_num(); ++i) {
-    std::string label_name = get_vertex_label_name(i);
-    {
-      const auto& lhs = get_vertex_properties(label_name);
-      const auto& rhs = other.get_vertex_properties(label_name);
-      if (lhs != rhs) {
-        return false;
+  // The properties dropped but not compacted yet are left out.
+  auto live_properties = [](const Schema& schema, label_t label) {
+    std::vector<std::pair<PropertyType, StorageStrategy>> props;
+    const auto& types = schema.get_vertex_properties(label);
+    const auto& strategies = schema.vprop_storage_[label];
+    for (size_t idx = 0; idx < types.size(); ++idx) {
+      if (!schema.is_dropped_vertex_property(label, idx)) {
+        props.emplace_back(types[idx], strategies[idx]);
       }
     }
-    {
-      const auto& lhs = get_vertex_storage_strategies(label_name);
-      const auto& rhs = other.get_vertex_storage_strategies(label_name);
-      if (lhs != rhs) {
-        return false;
-      }
+    return props;
+  };
+  for (label_t i = 0; i < vertex_label_num(); ++i) {
+    std::string label_name = get_vertex_label_name(i);
+    if (live_properties(*this, i) !=
+        live_properties(other, other.get_vertex_label_id(label_name))) {
+      return false;
     }
     if (get_max_vnum(label_name) != other.get_max_vnum(label_name)) {
       return false;
@@ -546,6 +848,21 @@ bool Schema::Equals(const Schema& other) const {
               return false;
             }
           }
+          if (get_outgoing_edge_compression(src_label_name, dst_label_name,
+                                            edge_label_name) !=
+                  other.get_outgoing_edge_compression(
+                      src_label_name, dst_label_name, edge_label_name) ||
+              get_incoming_edge_compression(src_label_name, dst_label_name,
+                                            edge_label_name) !=
+                  other.get_incoming_edge_compression(
+                      src_label_name, dst_label_name, edge_label_name)) {
+            return false;
+          }
+          if (get_csr_storage_strategy(src_label, dst_label, edge_label) !=
+              other.get_csr_storage_strategy(src_label, dst_label,
+                                             edge_label)) {
+            return false;
+          }
         }
       }
     }
@@ -578,6 +895,19 @@ void RelationToEdgeStrategy(const std::string& rel_str,
   }
 }
 
+static bool StringToEdgeCompression(std::string str,
+                                    EdgeCompression& compression) {
+  std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+  if (str == "NONE") {
+    compression = EdgeCompression::kNone;
+  } else if (str == "DELTA_VARINT") {
+    compression = EdgeCompression::kDeltaVarint;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 StorageStrategy StringToStorageStrategy(const std::string& str) {
   if (str == "None") {
     return StorageStrategy::kNone;
@@ -585,6 +915,8 @@ StorageStrategy StringToStorageStrategy(const std::string& str) {
     return StorageStrategy::kMem;
   } else if (str == "Disk") {
     return StorageStrategy::kDisk;
+  } else if (str == "Compressed") {
+    return StorageStrategy::kCompressed;
   } else {
     return StorageStrategy::kMem;
   }
@@ -600,12 +932,12 @@ static bool parse_property_type(YAML::Node node, PropertyType& type) {
   }
 }
 
-static Status parse_vertex_properties(YAML::Node node,
-                                      const std::string& label_name,
-                                      std::vector<PropertyType>& types,
-                                      std::vector<std::string>& names,
-                                      std::vector<StorageStrategy>& strategies,
-                                      const std::string& version) {
+static Status parse_vertex_properties(
+    YAML::Node node, const std::string& label_name,
+    std::vector<PropertyType>& types, std::vector<std::string>& names,
+    std::vector<StorageStrategy>& strategies,
+    std::vector<std::pair<std::string, std::string>>& indexes,
+    const std::string& version) {
   if (!node || node.IsNull()) {
     VLOG(10) << "Found no vertex properties specified for vertex: "
              << label_name;
@@ -649,9 +981,28 @@ static Status parse_vertex_properties(YAML::Node node,
                     "Fail to parse property type of vertex-" + label_name +
                         " prop-" + std::to_string(i - 1));
     }
-    {
-      if (node[i]["x_csr_params"]) {
-        get_scalar(node[i]["x_csr_params"], "storage_strategy", strategy_str);
+    if (node[i]["x_csr_params"]) {
+      auto csr_node = node[i]["x_csr_params"];
+      get_scalar(csr_node, "storage_strategy", strategy_str);
+      for (const char* option :
+           {"secondary_index", "range_index", "vector_index", "text_index"}) {
+        std::string index_str;
+        if (!get_scalar(csr_node, option, index_str)) {
+          continue;
+        }
+        std::transform(index_str.begin(), index_str.end(), index_str.begin(),
+                       ::toupper);
+        if (index_str == "TRUE") {
+          indexes.emplace_back(option, prop_name_str);
+        } else if (index_str != "FALSE") {
+          LOG(ERROR) << option << " is not set properly for vertex-"
+                     << label_name << " prop-" << prop_name_str
+                     << ", expect TRUE/FALSE";
+          return Status(StatusCode::INVALID_SCHEMA,
+                        std::string(option) +
+                            " is not set properly for vertex-" + label_name +
+                            " prop-" + prop_name_str + ", expect TRUE/FALSE");
+        }
       }
     }
     types.push_back(prop_type);
@@ -750,6 +1101,7 @@ static Status parse_vertex_schema(YAML::Node node, Schema& schema) {
   std::vector<PropertyType> property_types;
   std::vector<std::string> property_names;
   std::vector<StorageStrategy> strategies;
+  std::vector<std::pair<std::string, std::string>> indexes;
   std::string description;  // default is empty string
 
   if (node["description"]) {
@@ -769,7 +1121,8 @@ static Status parse_vertex_schema(YAML::Node node, Schema& schema) {
 
   RETURN_IF_NOT_OK(parse_vertex_properties(node["properties"], label_name,
                                            property_types, property_names,
-                                           strategies, schema.GetVersion()));
+                                           strategies, indexes,
+                                           schema.GetVersion()));
   if (!node["primary_keys"]) {
     LOG(ERROR) << "Expect field primary_keys for " << label_name;
     return Status(StatusCode::INVALID_SCHEMA,
@@ -825,6 +1178,24 @@ static Status parse_vertex_schema(YAML::Node node, Schema& schema) {
 
   schema.add_vertex_label(label_name, property_types, property_names,
                           primary_keys, strategies, max_num, description);
+  label_t label_id = schema.get_vertex_label_id(label_name);
+  for (auto& [option, prop_name] : indexes) {
+    if (std::find(property_names.begin(), property_names.end(), prop_name) ==
+        property_names.end()) {
+      LOG(WARNING) << option << " on the primary key " << prop_name << " of "
+                   << label_name << " is ignored";
+      continue;
+    }
+    if (option == "secondary_index") {
+      schema.add_secondary_index(label_id, prop_name);
+    } else if (option == "range_index") {
+      schema.add_range_index(label_id, prop_name);
+    } else if (option == "vector_index") {
+      schema.add_vector_index(label_id, prop_name);
+    } else {
+      schema.add_text_index(label_id, prop_name);
+    }
+  }
   // check the type_id equals to storage's label_id
   int32_t type_id;
   if (!get_scalar(node, "type_id", type_id)) {
@@ -832,7 +1203,6 @@ static Status parse_vertex_schema(YAML::Node node, Schema& schema) {
                  << ", try to use incremental id";
     type_id = schema.vertex_label_num() - 1;
   }
-  auto label_id = schema.get_vertex_label_id(label_name);
   if (label_id != type_id) {
     LOG(ERROR) << "type_id is not equal to label_id for type: " << label_name;
     return Status(StatusCode::INVALID_SCHEMA,
@@ -906,6 +1276,9 @@ static Status parse_edge_schema(YAML::Node node, Schema& schema) {
     EdgeStrategy cur_ie = default_ie;
     EdgeStrategy cur_oe = default_oe;
     bool cur_sort_on_compaction = default_sort_on_compaction;
+    bool cur_sort_by_neighbor = false;
+    bool cur_edge_existence_filter = false;
+    StorageStrategy cur_csr_storage = StorageStrategy::kMem;
     if (!get_scalar(cur_node, "source_vertex", src_label_name)) {
       LOG(ERROR) << "Expect field source_vertex for edge [" << edge_label_name
                  << "] in vertex_type_pair_relations";
@@ -939,6 +1312,8 @@ static Status parse_edge_schema(YAML::Node node, Schema& schema) {
     }
     // check if x_csr_params presents
     bool oe_mutable = true, ie_mutable = true;
+    EdgeCompression oe_compression = EdgeCompression::kNone,
+                    ie_compression = EdgeCompression::kNone;
     if (cur_node["x_csr_params"]) {
       auto csr_node = cur_node["x_csr_params"];
       if (csr_node["edge_storage_strategy"]) {
@@ -999,6 +1374,78 @@ static Status parse_edge_schema(YAML::Node node, Schema& schema) {
         VLOG(10) << "Do not sort on compaction for edge: " << src_label_name
                  << "-[" << edge_label_name << "]->" << dst_label_name;
       }
+      if (csr_node["sort_by_neighbor"]) {
+        std::string sort_by_neighbor_str;
+        if (get_scalar(csr_node, "sort_by_neighbor", sort_by_neighbor_str)) {
+          std::transform(sort_by_neighbor_str.begin(),
+                         sort_by_neighbor_str.end(),
+                         sort_by_neighbor_str.begin(), ::toupper);
+          if (sort_by_neighbor_str == "TRUE") {
+            cur_sort_by_neighbor = true;
+          } else if (sort_by_neighbor_str == "FALSE") {
+            cur_sort_by_neighbor = false;
+          } else {
+            LOG(ERROR) << "sort_by_neighbor is not set properly for edge: "
+                       << src_label_name << "-[" << edge_label_name << "]->"
+                       << dst_label_name << ", expect TRUE/FALSE";
+            return Status(StatusCode::INVALID_SCHEMA,
+                          "sort_by_neighbor is not set properly for edge: " +
+                              src_label_name + "-[" + edge_label_name + "]->" +
+                              dst_label_name + ", expect TRUE/FALSE");
+          }
+        }
+      }
+      if (csr_node["edge_existence_filter"]) {
+        std::string filter_str;
+        if (get_scalar(csr_node, "edge_existence_filter", filter_str)) {
+          std::transform(filter_str.begin(), filter_str.end(),
+                         filter_str.begin(), ::toupper);
+          if (filter_str == "TRUE") {
+            cur_edge_existence_filter = true;
+          } else if (filter_str == "FALSE") {
+            cur_edge_existence_filter = false;
+          } else {
+            LOG(ERROR) << "edge_existence_filter is not set properly for edge: "
+                       << src_label_name << "-[" << edge_label_name << "]->"
+                       << dst_label_name << ", expect TRUE/FALSE";
+            return Status(StatusCode::INVALID_SCHEMA,
+                          "edge_existence_filter is not set properly for "
+                          "edge: " +
+                              src_label_name + "-[" + edge_label_name + "]->" +
+                              dst_label_name + ", expect TRUE/FALSE");
+          }
+        }
+      }
+      if (csr_node["csr_storage_strategy"]) {
+        std::string csr_storage_str;
+        if (get_scalar(csr_node, "csr_storage_strategy", csr_storage_str)) {
+          if (csr_storage_str == "Mem") {
+            cur_csr_storage = StorageStrategy::kMem;
+          } else if (csr_storage_str == "Disk") {
+            cur_csr_storage = StorageStrategy::kDisk;
+          } else {
+            LOG(ERROR) << "csr_storage_strategy is not set properly for edge: "
+                       << src_label_name << "-[" << edge_label_name << "]->"
+                       << dst_label_name << ", expect Mem/Disk";
+            return Status(
+                StatusCode::INVALID_SCHEMA,
+                "csr_storage_strategy is not set properly for edge: " +
+                    src_label_name + "-[" + edge_label_name + "]->" +
+                    dst_label_name + ", expect Mem/Disk");
+          }
+        }
+      }
+      if (cur_sort_by_neighbor && cur_sort_on_compaction) {
+        LOG(ERROR) << "sort_by_neighbor conflicts with sort_on_compaction for "
+                      "edge: "
+                   << src_label_name << "-[" << edge_label_name << "]->"
+                   << dst_label_name;
+        return Status(StatusCode::INVALID_SCHEMA,
+                      "sort_by_neighbor conflicts with sort_on_compaction for "
+                      "edge: " +
+                          src_label_name + "-[" + edge_label_name + "]->" +
+                          dst_label_name);
+      }
 
       if (csr_node["oe_mutability"]) {
         std::string mutability_str;
@@ -1044,6 +1491,50 @@ static Status parse_edge_schema(YAML::Node node, Schema& schema) {
           }
         }
       }
+      for (auto& pair : {std::make_pair("oe_compression", &oe_compression),
+                         std::make_pair("ie_compression", &ie_compression)}) {
+        std::string compression_str;
+        if (csr_node[pair.first] &&
+            get_scalar(csr_node, pair.first, compression_str) &&
+            !StringToEdgeCompression(compression_str, *pair.second)) {
+          LOG(ERROR) << pair.first << " is not set properly for edge: "
+                     << src_label_name << "-[" << edge_label_name << "]->"
+                     << dst_label_name
+                     << ", expect NONE/DELTA_VARINT, got:" << compression_str;
+          return Status(StatusCode::INVALID_SCHEMA,
+                        std::string(pair.first) +
+                            " is not set properly for edge: " +
+                            src_label_name + "-[" + edge_label_name + "]->" +
+                            dst_label_name + ", expect NONE/DELTA_VARINT");
+        }
+      }
+      // Compressed csrs are immutable and kept sorted by neighbor id.
+      if ((oe_compression != EdgeCompression::kNone &&
+           (oe_mutable || cur_oe != EdgeStrategy::kMultiple)) ||
+          (ie_compression != EdgeCompression::kNone &&
+           (ie_mutable || cur_ie != EdgeStrategy::kMultiple))) {
+        LOG(ERROR) << "Compression is only supported on immutable multiple "
+                      "edges, edge: "
+                   << src_label_name << "-[" << edge_label_name << "]->"
+                   << dst_label_name;
+        return Status(StatusCode::INVALID_SCHEMA,
+                      "Compression is only supported on immutable multiple "
+                      "edges, edge: " +
+                          src_label_name + "-[" + edge_label_name + "]->" +
+                          dst_label_name);
+      }
+      if ((oe_compression != EdgeCompression::kNone ||
+           ie_compression != EdgeCompression::kNone) &&
+          cur_sort_on_compaction) {
+        LOG(ERROR) << "Compression conflicts with sort_on_compaction for edge: "
+                   << src_label_name << "-[" << edge_label_name << "]->"
+                   << dst_label_name;
+        return Status(StatusCode::INVALID_SCHEMA,
+                      "Compression conflicts with sort_on_compaction for "
+                      "edge: " +
+                          src_label_name + "-[" + edge_label_name + "]->" +
+                          dst_label_name);
+      }
     }
 
     VLOG(10) << "edge " << edge_label_name << " from " << src_label_name
@@ -1052,7 +1543,9 @@ static Status parse_edge_schema(YAML::Node node, Schema& schema) {
     schema.add_edge_label(src_label_name, dst_label_name, edge_label_name,
                           property_types, prop_names, cur_oe, cur_ie,
                           oe_mutable, ie_mutable, cur_sort_on_compaction,
-                          description);
+                          description, oe_compression, ie_compression,
+                          cur_sort_by_neighbor, cur_edge_existence_filter,
+                          cur_csr_storage);
   }
 
   // check the type_id equals to storage's label_id
@@ -1384,6 +1877,27 @@ bool Schema::EmplacePlugins(
   plugin_name_to_path_and_id_.emplace(
       Schema::BUILTIN_TVSP_PLUGIN_NAME,
       std::make_pair("", Schema::BUILTIN_TVSP_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_WCC_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_WCC_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_TRIANGLE_COUNT_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_TRIANGLE_COUNT_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_LPA_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_LPA_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_VECTOR_SEARCH_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_VECTOR_SEARCH_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_ID));
+  plugin_name_to_path_and_id_.emplace(
+      Schema::BUILTIN_RANDOM_WALK_PLUGIN_NAME,
+      std::make_pair("", Schema::BUILTIN_RANDOM_WALK_PLUGIN_ID));
 
   LOG(INFO) << "Load " << plugin_name_to_path_and_id_.size() << " plugins";
   return true;
@@ -1418,9 +1932,8 @@ bool Schema::vertex_has_property(const std::string& label,
   auto v_label_id = get_vertex_label_id(label);
   THROW_EXCEPTION_IF(v_label_id >= vprop_names_.size(),
                      "vertex label id out of range of vprop_names_");
-  auto& v_prop_names = vprop_names_[v_label_id];
-  return std::find(v_prop_names.begin(), v_prop_names.end(), prop) !=
-             v_prop_names.end() ||
+  // Leaves out the properties dropped.
+  return vprop_name_to_type_and_index_[v_label_id].count(prop) > 0 ||
          vertex_has_primary_key(label, prop);
 }
 
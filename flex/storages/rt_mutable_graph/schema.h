@@ -31,7 +31,11 @@ class Schema {
   // How many built-in plugins are there.
   // Currently only one builtin plugin, SERVER_APP is supported.
   static constexpr uint8_t RESERVED_PLUGIN_NUM = 1;
-  static constexpr uint8_t MAX_PLUGIN_ID = 245;
+  // The stored procedures of a graph take the ids from RESERVED_PLUGIN_NUM
+  // to MAX_PLUGIN_ID, the ids above are those of the builtin procedures, of
+  // the cypher and of the adhoc queries. It was 245 before the builtins
+  // from wcc to random_walk took the ids from 245 down.
+  static constexpr uint8_t MAX_PLUGIN_ID = 238;
   static constexpr uint8_t ADHOC_READ_PLUGIN_ID = 253;
   static constexpr uint8_t HQPS_ADHOC_READ_PLUGIN_ID = 254;
   static constexpr uint8_t HQPS_ADHOC_WRITE_PLUGIN_ID = 255;
@@ -48,7 +52,7 @@ class Schema {
   static constexpr const char* MAX_LENGTH_KEY = "max_length";
 
   // The builtin plugins are reserved for the system.
-  static constexpr uint8_t BUILTIN_PLUGIN_NUM = 4;
+  static constexpr uint8_t BUILTIN_PLUGIN_NUM = 11;
 
   static constexpr uint8_t BUILTIN_COUNT_VERTICES_PLUGIN_ID = 252;
   static constexpr const char* BUILTIN_COUNT_VERTICES_PLUGIN_NAME =
@@ -61,12 +65,38 @@ class Schema {
   static constexpr uint8_t BUILTIN_TVSP_PLUGIN_ID = 249;
   static constexpr const char* BUILTIN_TVSP_PLUGIN_NAME =
       "shortest_path_among_three";
+  static constexpr uint8_t BUILTIN_WCC_PLUGIN_ID = 245;
+  static constexpr const char* BUILTIN_WCC_PLUGIN_NAME = "wcc";
+  static constexpr uint8_t BUILTIN_TRIANGLE_COUNT_PLUGIN_ID = 244;
+  static constexpr const char* BUILTIN_TRIANGLE_COUNT_PLUGIN_NAME =
+      "triangle_count";
+  static constexpr uint8_t BUILTIN_LPA_PLUGIN_ID = 243;
+  static constexpr const char* BUILTIN_LPA_PLUGIN_NAME = "label_propagation";
+  static constexpr uint8_t BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_ID = 242;
+  static constexpr const char* BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_NAME =
+      "incremental_pagerank";
+  static constexpr uint8_t BUILTIN_VECTOR_SEARCH_PLUGIN_ID = 241;
+  static constexpr const char* BUILTIN_VECTOR_SEARCH_PLUGIN_NAME =
+      "vector_search";
+  static constexpr uint8_t BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_ID = 240;
+  static constexpr const char* BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_NAME =
+      "neighbor_sampling";
+  static constexpr uint8_t BUILTIN_RANDOM_WALK_PLUGIN_ID = 239;
+  static constexpr const char* BUILTIN_RANDOM_WALK_PLUGIN_NAME = "random_walk";
   static constexpr const char* BUILTIN_PLUGIN_NAMES[BUILTIN_PLUGIN_NUM] = {
       BUILTIN_COUNT_VERTICES_PLUGIN_NAME, BUILTIN_PAGERANK_PLUGIN_NAME,
-      BUILTIN_K_DEGREE_NEIGHBORS_PLUGIN_NAME, BUILTIN_TVSP_PLUGIN_NAME};
+      BUILTIN_K_DEGREE_NEIGHBORS_PLUGIN_NAME, BUILTIN_TVSP_PLUGIN_NAME,
+      BUILTIN_WCC_PLUGIN_NAME, BUILTIN_TRIANGLE_COUNT_PLUGIN_NAME,
+      BUILTIN_LPA_PLUGIN_NAME, BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_NAME,
+      BUILTIN_VECTOR_SEARCH_PLUGIN_NAME, BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_NAME,
+      BUILTIN_RANDOM_WALK_PLUGIN_NAME};
   static constexpr uint8_t BUILTIN_PLUGIN_IDS[BUILTIN_PLUGIN_NUM] = {
       BUILTIN_COUNT_VERTICES_PLUGIN_ID, BUILTIN_PAGERANK_PLUGIN_ID,
-      BUILTIN_K_DEGREE_NEIGHBORS_PLUGIN_ID, BUILTIN_TVSP_PLUGIN_ID};
+      BUILTIN_K_DEGREE_NEIGHBORS_PLUGIN_ID, BUILTIN_TVSP_PLUGIN_ID,
+      BUILTIN_WCC_PLUGIN_ID, BUILTIN_TRIANGLE_COUNT_PLUGIN_ID,
+      BUILTIN_LPA_PLUGIN_ID, BUILTIN_INCREMENTAL_PAGERANK_PLUGIN_ID,
+      BUILTIN_VECTOR_SEARCH_PLUGIN_ID, BUILTIN_NEIGHBOR_SAMPLING_PLUGIN_ID,
+      BUILTIN_RANDOM_WALK_PLUGIN_ID};
 
   // An array containing all compatible versions of schema.
   static const std::vector<std::string> COMPATIBLE_VERSIONS;
@@ -100,7 +130,12 @@ class Schema {
                       EdgeStrategy ie = EdgeStrategy::kMultiple,
                       bool oe_mutable = true, bool ie_mutable = true,
                       bool sort_on_compaction = false,
-                      const std::string& description = "");
+                      const std::string& description = "",
+                      EdgeCompression oe_compression = EdgeCompression::kNone,
+                      EdgeCompression ie_compression = EdgeCompression::kNone,
+                      bool sort_by_neighbor = false,
+                      bool edge_existence_filter = false,
+                      StorageStrategy csr_storage = StorageStrategy::kMem);
 
   label_t vertex_label_num() const;
 
@@ -132,6 +167,67 @@ class Schema {
   const std::vector<StorageStrategy>& get_vertex_storage_strategies(
       const std::string& label) const;
 
+  // Appends a property to the vertex label, after the others.
+  void add_vertex_property(label_t label, const std::string& prop_name,
+                           const PropertyType& type,
+                           StorageStrategy strategy = StorageStrategy::kMem);
+
+  // Removes a property, not the primary key, of the vertex label along with
+  // its indexes. Its place is kept by a property of type kEmpty named by
+  // dropped_vertex_property_name(), so that the ids of the others stay as
+  // they are until compact_vertex_properties().
+  void drop_vertex_property(label_t label, const std::string& prop_name);
+
+  static std::string dropped_vertex_property_name(size_t prop_id);
+
+  bool is_dropped_vertex_property(label_t label, size_t prop_id) const;
+
+  // Removes the properties of the vertex label dropped before, the ids of the
+  // properties after each of them move down by one. Returns whether any was
+  // removed.
+  bool compact_vertex_properties(label_t label);
+
+  // Puts an empty value at each dropped property of the vertex label into
+  // props, the values of the other properties in order. Returns false if
+  // props has the values of neither these nor all the properties.
+  bool fill_dropped_vertex_properties(label_t label,
+                                      std::vector<Any>& props) const;
+
+  // Declares a secondary hash index on the vertex property, see
+  // SecondaryIndex. The primary key is indexed by the vertex map already.
+  void add_secondary_index(label_t label, const std::string& prop_name);
+
+  bool has_secondary_index(label_t label, const std::string& prop_name) const;
+
+  // The vertex properties of the label with a secondary index.
+  const std::vector<std::string>& get_secondary_indexes(label_t label) const;
+
+  // Declares a sorted index on the vertex property, see RangeIndex.
+  void add_range_index(label_t label, const std::string& prop_name);
+
+  bool has_range_index(label_t label, const std::string& prop_name) const;
+
+  // The vertex properties of the label with a range index.
+  const std::vector<std::string>& get_range_indexes(label_t label) const;
+
+  // Declares an HNSW index on the embeddings of the vertex property, see
+  // VectorIndex.
+  void add_vector_index(label_t label, const std::string& prop_name);
+
+  bool has_vector_index(label_t label, const std::string& prop_name) const;
+
+  // The vertex properties of the label with a vector index.
+  const std::vector<std::string>& get_vector_indexes(label_t label) const;
+
+  // Declares a prefix and trigram index on the string vertex property, see
+  // TextIndex.
+  void add_text_index(label_t label, const std::string& prop_name);
+
+  bool has_text_index(label_t label, const std::string& prop_name) const;
+
+  // The vertex properties of the label with a text index.
+  const std::vector<std::string>& get_text_indexes(label_t label) const;
+
   size_t get_max_vnum(const std::string& label) const;
 
   bool exist(const std::string& src_label, const std::string& dst_label,
@@ -227,6 +323,36 @@ class Schema {
                               const std::string& dst_label,
                               const std::string& label) const;
 
+  // Whether adjacency lists of the edge triplet are kept sorted by neighbor
+  // id on compaction, with newly inserted edges in an unsorted tail.
+  bool get_sort_by_neighbor(const std::string& src_label,
+                            const std::string& dst_label,
+                            const std::string& label) const;
+
+  bool get_sort_by_neighbor(label_t src_label, label_t dst_label,
+                            label_t label) const;
+
+  // Whether an approximate membership filter of (src, dst) pairs is kept for
+  // the edge triplet, so that lookups of absent edges skip the adjacency scan.
+  bool get_edge_existence_filter(label_t src_label, label_t dst_label,
+                                 label_t label) const;
+
+  // Where the csrs and edge properties of the triplet are kept when the graph
+  // is opened in memory: kMem follows the memory level, while kDisk keeps
+  // them mmaped from files in the work directory, so that the page cache may
+  // evict them.
+  StorageStrategy get_csr_storage_strategy(label_t src_label,
+                                           label_t dst_label,
+                                           label_t label) const;
+
+  EdgeCompression get_outgoing_edge_compression(
+      const std::string& src_label, const std::string& dst_label,
+      const std::string& label) const;
+
+  EdgeCompression get_incoming_edge_compression(
+      const std::string& src_label, const std::string& dst_label,
+      const std::string& label) const;
+
   bool contains_edge_label(const std::string& label) const;
 
   label_t get_edge_label_id(const std::string& label) const;
@@ -291,6 +417,10 @@ class Schema {
  private:
   label_t vertex_label_to_index(const std::string& label);
 
+  // Maps the names of the properties of the vertex label, but those dropped,
+  // to their types and ids.
+  void build_vprop_name_to_type_and_index(label_t label);
+
   label_t edge_label_to_index(const std::string& label);
 
   uint32_t generate_edge_label(label_t src, label_t dst, label_t edge) const;
@@ -313,6 +443,15 @@ class Schema {
   std::map<uint32_t, bool> oe_mutability_;
   std::map<uint32_t, bool> ie_mutability_;
   std::map<uint32_t, bool> sort_on_compactions_;
+  std::map<uint32_t, EdgeCompression> oe_compression_;
+  std::map<uint32_t, EdgeCompression> ie_compression_;
+  std::map<uint32_t, bool> sort_by_neighbor_;
+  std::map<uint32_t, bool> edge_existence_filter_;
+  std::map<uint32_t, StorageStrategy> csr_storage_;
+  std::map<label_t, std::vector<std::string>> secondary_indexes_;
+  std::map<label_t, std::vector<std::string>> range_indexes_;
+  std::map<label_t, std::vector<std::string>> vector_indexes_;
+  std::map<label_t, std::vector<std::string>> text_indexes_;
   std::vector<std::unordered_map<std::string, std::pair<PropertyType, uint8_t>>>
       vprop_name_to_type_and_index_;
   std::vector<size_t> max_vnum_;
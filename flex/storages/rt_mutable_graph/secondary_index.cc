@@ -0,0 +1,156 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/secondary_index.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+#include "glog/logging.h"
+
+namespace gs {
+
+static inline uint64_t mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+bool SecondaryIndex::is_supported(const PropertyType& type) {
+  return type == PropertyType::kInt32 || type == PropertyType::kUInt32 ||
+         type == PropertyType::kInt64 || type == PropertyType::kUInt64 ||
+         type == PropertyType::kDate || type == PropertyType::kStringView ||
+         type == PropertyType::kStringMap;
+}
+
+uint64_t SecondaryIndex::hash(const Any& value) {
+  const auto& type = value.type;
+  if (type == PropertyType::kInt32) {
+    return mix(static_cast<uint64_t>(value.AsInt32()));
+  } else if (type == PropertyType::kUInt32) {
+    return mix(value.AsUInt32());
+  } else if (type == PropertyType::kInt64) {
+    return mix(static_cast<uint64_t>(value.AsInt64()));
+  } else if (type == PropertyType::kUInt64) {
+    return mix(value.AsUInt64());
+  } else if (type == PropertyType::kDate) {
+    return mix(static_cast<uint64_t>(value.AsDate().milli_second));
+  } else {
+    return mix(std::hash<std::string_view>()(value.AsStringView()));
+  }
+}
+
+void SecondaryIndex::insert(const Any& value, vid_t vid) {
+  uint64_t h = hash(value);
+  Shard& shard = shard_of(h);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto& vids = shard.entries[h];
+  // Rewriting the value a vertex got last adds nothing.
+  if (vids.empty() || vids.back() != vid) {
+    vids.push_back(vid);
+  }
+}
+
+void SecondaryIndex::lookup(const Any& value, std::vector<vid_t>& vids) const {
+  uint64_t h = hash(value);
+  const Shard& shard = shard_of(h);
+  size_t begin = vids.size();
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.entries.find(h);
+    if (iter == shard.entries.end()) {
+      return;
+    }
+    vids.insert(vids.end(), iter->second.begin(), iter->second.end());
+  }
+  std::sort(vids.begin() + begin, vids.end());
+  vids.erase(std::unique(vids.begin() + begin, vids.end()), vids.end());
+}
+
+void SecondaryIndex::rebuild(const ColumnBase& column, vid_t vertex_num) {
+  clear();
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    uint64_t h = hash(column.get(v));
+    shard_of(h).entries[h].push_back(v);
+  }
+}
+
+void SecondaryIndex::dump(const std::string& path) const {
+  FILE* fout = fopen(path.c_str(), "wb");
+  CHECK(fout != nullptr) << "Failed to open " << path;
+  uint64_t entry_num = size();
+  CHECK_EQ(fwrite(&entry_num, sizeof(uint64_t), 1, fout), 1);
+  for (auto& shard : shards_) {
+    for (auto& pair : shard.entries) {
+      uint64_t vid_num = pair.second.size();
+      CHECK_EQ(fwrite(&pair.first, sizeof(uint64_t), 1, fout), 1);
+      CHECK_EQ(fwrite(&vid_num, sizeof(uint64_t), 1, fout), 1);
+      CHECK_EQ(fwrite(pair.second.data(), sizeof(vid_t), vid_num, fout),
+               vid_num);
+    }
+  }
+  fflush(fout);
+  fclose(fout);
+}
+
+bool SecondaryIndex::open(const std::string& path) {
+  clear();
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+  FILE* fin = fopen(path.c_str(), "rb");
+  CHECK(fin != nullptr) << "Failed to open " << path;
+  uint64_t entry_num = 0;
+  CHECK_EQ(fread(&entry_num, sizeof(uint64_t), 1, fin), 1);
+  while (entry_num > 0) {
+    uint64_t h = 0, vid_num = 0;
+    CHECK_EQ(fread(&h, sizeof(uint64_t), 1, fin), 1);
+    CHECK_EQ(fread(&vid_num, sizeof(uint64_t), 1, fin), 1);
+    CHECK(vid_num > 0 && vid_num <= entry_num)
+        << "Corrupted secondary index " << path;
+    auto& vids = shard_of(h).entries[h];
+    vids.resize(vid_num);
+    CHECK_EQ(fread(vids.data(), sizeof(vid_t), vid_num, fin), vid_num);
+    entry_num -= vid_num;
+  }
+  fclose(fin);
+  return true;
+}
+
+void SecondaryIndex::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.clear();
+  }
+}
+
+size_t SecondaryIndex::size() const {
+  size_t ret = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& pair : shard.entries) {
+      ret += pair.second.size();
+    }
+  }
+  return ret;
+}
+
+}  // namespace gs
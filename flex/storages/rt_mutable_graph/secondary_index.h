@@ -0,0 +1,87 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_FRAGMENT_SECONDARY_INDEX_H_
+#define GRAPHSCOPE_FRAGMENT_SECONDARY_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/column.h"
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+// A hash index from the values of a vertex property to the vertices having
+// them, declared with secondary_index in the schema.
+//
+// Entries are only added while the graph is open: a vertex whose value is
+// updated keeps the entry of its old value, so that reads at older timestamps
+// still find it. lookup() therefore returns candidates, which the caller
+// checks against the values it sees. rebuild() drops the stale entries and
+// must not run concurrently with anything else; insert() and lookup() may.
+class SecondaryIndex {
+ public:
+  static constexpr size_t SHARD_NUM = 64;
+
+  // Integers, dates and strings can be indexed.
+  static bool is_supported(const PropertyType& type);
+
+  // Equal values hash equally whichever string type holds them.
+  static uint64_t hash(const Any& value);
+
+  void insert(const Any& value, vid_t vid);
+
+  // Appends to vids, in ascending order and without duplicates, the vertices
+  // which have or had a value of the same hash.
+  void lookup(const Any& value, std::vector<vid_t>& vids) const;
+
+  // Replaces the entries with the values of vertices [0, vertex_num) of the
+  // column.
+  void rebuild(const ColumnBase& column, vid_t vertex_num);
+
+  void dump(const std::string& path) const;
+
+  // Returns false if the file does not exist, leaving the index empty.
+  bool open(const std::string& path);
+
+  void clear();
+
+  // Number of entries, stale ones included.
+  size_t size() const;
+
+ private:
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, std::vector<vid_t>> entries;
+  };
+
+  inline Shard& shard_of(uint64_t h) { return shards_[h % SHARD_NUM]; }
+  inline const Shard& shard_of(uint64_t h) const {
+    return shards_[h % SHARD_NUM];
+  }
+
+  Shard shards_[SHARD_NUM];
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_FRAGMENT_SECONDARY_INDEX_H_
@@ -0,0 +1,284 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/snapshot_transport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include <glog/logging.h>
+
+#include "flex/storages/rt_mutable_graph/file_names.h"
+#include "flex/utils/file_utils.h"
+#include "grape/util.h"
+
+namespace gs {
+
+static std::string remote_join(const std::string& dir,
+                               const std::string& name) {
+  if (dir.empty()) {
+    return name;
+  }
+  return dir.back() == '/' ? dir + name : dir + "/" + name;
+}
+
+// Drops the "." and ".." components, the repeated and the trailing slashes.
+static std::filesystem::path normalized(const std::string& path) {
+  auto ret = std::filesystem::path(path).lexically_normal();
+  return ret.has_filename() ? ret : ret.parent_path();
+}
+
+SnapshotUploader::SnapshotUploader(
+    std::shared_ptr<RemoteStorageUploader> uploader,
+    const std::string& work_dir, const std::string& remote_dir,
+    int concurrency)
+    : uploader_(std::move(uploader)),
+      work_dir_(work_dir),
+      remote_dir_(remote_dir),
+      pending_(0),
+      running_(true) {
+  for (int i = 0; i < std::max(concurrency, 1); ++i) {
+    workers_.emplace_back([this]() { run(); });
+  }
+}
+
+SnapshotUploader::~SnapshotUploader() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  queue_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void SnapshotUploader::Enqueue(const std::string& path) {
+  std::string name = normalized(path)
+                         .lexically_relative(normalized(work_dir_))
+                         .generic_string();
+  if (name.empty() || name.rfind("..", 0) == 0) {
+    LOG(ERROR) << "File " << path << " is not under " << work_dir_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status_.ok()) {
+      status_ = Status(StatusCode::INVALID_ARGUMENT,
+                       "File " + path + " is not under " + work_dir_);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!queued_.insert(name).second) {
+      return;
+    }
+    queue_.push_back(name);
+    ++pending_;
+  }
+  queue_cv_.notify_one();
+}
+
+void SnapshotUploader::EnqueueFiles(const std::string& dir,
+                                    const std::vector<std::string>& prefixes) {
+  for (const auto& entry :
+       std::filesystem::recursive_directory_iterator(dir)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+    std::string name = entry.path().filename().string();
+    bool matched = prefixes.empty();
+    for (const auto& prefix : prefixes) {
+      if (name == prefix || name.rfind(prefix + ".", 0) == 0) {
+        matched = true;
+        break;
+      }
+    }
+    if (matched) {
+      Enqueue(entry.path().string());
+    }
+  }
+}
+
+Status SnapshotUploader::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return pending_ == 0; });
+  return status_;
+}
+
+void SnapshotUploader::run() {
+  while (true) {
+    std::string name;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queue_cv_.wait(lock, [this]() { return !running_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      name = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    auto status = uploader_->Put(work_dir_ + "/" + name,
+                                 remote_join(remote_dir_, name), true);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to upload " << name << ": " << status.ToString();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!status.ok() && status_.ok()) {
+        status_ = status;
+      }
+      --pending_;
+    }
+    done_cv_.notify_all();
+  }
+}
+
+struct RemoteSnapshotFile {
+  std::string name;
+  size_t size;
+  uint64_t checksum;
+  bool checked;
+};
+
+static bool read_version(const std::string& path, uint32_t& version) {
+  std::ifstream fin(path, std::ios::binary);
+  return static_cast<bool>(
+      fin.read(reinterpret_cast<char*>(&version), sizeof(uint32_t)));
+}
+
+static Status list_snapshot_files(RemoteStorageDownloader& downloader,
+                                  const std::string& remote_snapshot_dir,
+                                  const std::string& local_dir,
+                                  std::vector<RemoteSnapshotFile>& files) {
+  std::string manifest_path = snapshot_manifest_path(local_dir);
+  auto status = downloader.Get(remote_join(remote_snapshot_dir, "MANIFEST"),
+                               manifest_path);
+  if (status.ok()) {
+    std::ifstream fin(manifest_path);
+    RemoteSnapshotFile file;
+    file.checked = true;
+    while (fin >> file.name >> file.size >> std::hex >> file.checksum >>
+           std::dec) {
+      files.push_back(file);
+    }
+    return Status::OK();
+  }
+  // Snapshots written by a bulk load from scratch have no manifest.
+  VLOG(10) << "No manifest in " << remote_snapshot_dir << ", listing it";
+  std::vector<std::string> keys;
+  std::string prefix = remote_join(remote_snapshot_dir, "");
+  status = downloader.List(prefix, keys);
+  if (!status.ok()) {
+    return status;
+  }
+  for (const auto& key : keys) {
+    if (key.size() <= prefix.size() || key.rfind(prefix, 0) != 0) {
+      continue;
+    }
+    files.push_back({key.substr(prefix.size()), 0, 0, false});
+  }
+  return Status::OK();
+}
+
+Status download_snapshot(RemoteStorageDownloader& downloader,
+                         const std::string& remote_dir,
+                         const std::string& work_dir, int concurrency) {
+  double t = -grape::GetCurrentTime();
+  std::filesystem::create_directories(snapshots_dir(work_dir));
+  std::string version_path = snapshot_version_path(work_dir);
+  std::string remote_version_path = version_path + ".remote";
+  auto status = downloader.Get(remote_join(remote_dir, "snapshots/VERSION"),
+                               remote_version_path);
+  if (!status.ok()) {
+    return status;
+  }
+  uint32_t version;
+  if (!read_version(remote_version_path, version)) {
+    return Status(StatusCode::IO_ERROR,
+                  "Failed to read the snapshot version from " + remote_dir);
+  }
+  status = downloader.Get(remote_join(remote_dir, "schema"),
+                          schema_path(work_dir));
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string remote_snapshot_dir =
+      remote_join(remote_dir, "snapshots/" + std::to_string(version));
+  std::string local_dir = snapshot_dir(work_dir, version);
+  std::filesystem::create_directories(local_dir);
+  std::vector<RemoteSnapshotFile> files;
+  status = list_snapshot_files(downloader, remote_snapshot_dir, local_dir,
+                               files);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::atomic<size_t> file_id(0);
+  std::atomic<size_t> total_size(0);
+  std::mutex status_mutex;
+  std::vector<std::thread> threads;
+  int thread_num = std::min<int>(std::max(concurrency, 1), files.size());
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      size_t cur;
+      while ((cur = file_id.fetch_add(1)) < files.size()) {
+        const auto& file = files[cur];
+        std::string local_path = local_dir + "/" + file.name;
+        std::filesystem::create_directories(
+            std::filesystem::path(local_path).parent_path());
+        auto res = downloader.Get(remote_join(remote_snapshot_dir, file.name),
+                                  local_path);
+        if (res.ok() && file.checked) {
+          uint64_t checksum = 0;
+          std::error_code ec;
+          if (std::filesystem::file_size(local_path, ec) != file.size ||
+              !checksum_file(local_path, checksum) ||
+              checksum != file.checksum) {
+            res = Status(StatusCode::IO_ERROR,
+                         "Snapshot file " + file.name +
+                             " does not match the manifest");
+          }
+        }
+        if (res.ok()) {
+          total_size += std::filesystem::file_size(local_path);
+          continue;
+        }
+        LOG(ERROR) << "Failed to download " << file.name << ": "
+                   << res.ToString();
+        std::lock_guard<std::mutex> lock(status_mutex);
+        if (status.ok()) {
+          status = res;
+        }
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  if (!status.ok()) {
+    return status;
+  }
+  std::filesystem::rename(remote_version_path, version_path);
+  t += grape::GetCurrentTime();
+  LOG(INFO) << "Downloaded snapshot " << version << " (" << files.size()
+            << " files, " << total_size.load() << " bytes) from "
+            << remote_dir << " in " << t << " s";
+  return Status::OK();
+}
+
+}  // namespace gs
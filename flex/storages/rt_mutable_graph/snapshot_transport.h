@@ -0,0 +1,95 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_SNAPSHOT_TRANSPORT_H_
+#define STORAGES_RT_MUTABLE_GRAPH_SNAPSHOT_TRANSPORT_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "flex/utils/remote/remote_storage.h"
+#include "flex/utils/result.h"
+
+namespace gs {
+
+/**
+ * @brief Uploads the files of a work directory to a remote storage in the
+ * background, so that the files of a snapshot are shipped while the rest of
+ * it is still being written.
+ *
+ * Files keep their path relative to the work directory under remote_dir,
+ * e.g. remote_dir/snapshots/1/oe_person_knows_person.nbr. Up to concurrency
+ * files are put at a time, and the remote storage splits each of them into
+ * parts of its own. The VERSION file is expected to be uploaded last, once
+ * Wait() succeeded for the rest of the snapshot, as download_snapshot takes
+ * it as the mark of a complete snapshot.
+ */
+class SnapshotUploader {
+ public:
+  SnapshotUploader(std::shared_ptr<RemoteStorageUploader> uploader,
+                   const std::string& work_dir, const std::string& remote_dir,
+                   int concurrency);
+  ~SnapshotUploader();
+
+  // Queues a file under the work directory that will not be written anymore.
+  // Files queued before are skipped.
+  void Enqueue(const std::string& path);
+
+  // Queues the regular files under dir named after one of the prefixes, i.e.
+  // the prefix itself or the prefix followed by a dot, or all of them if no
+  // prefix is given.
+  void EnqueueFiles(const std::string& dir,
+                    const std::vector<std::string>& prefixes = {});
+
+  // Waits until the queued files are uploaded, and returns the first error.
+  Status Wait();
+
+ private:
+  void run();
+
+  std::shared_ptr<RemoteStorageUploader> uploader_;
+  std::string work_dir_;
+  std::string remote_dir_;
+
+  std::mutex mutex_;
+  std::condition_variable queue_cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::string> queue_;
+  std::unordered_set<std::string> queued_;
+  size_t pending_;
+  bool running_;
+  Status status_;
+  std::vector<std::thread> workers_;
+};
+
+// Downloads the latest snapshot uploaded by SnapshotUploader under
+// remote_dir into work_dir, which can then be opened as a graph. The files
+// listed by the MANIFEST of the snapshot, or by the remote storage for
+// snapshots without one, are fetched concurrency at a time and checked
+// against their recorded sizes and checksums. The VERSION file is only
+// written after every file arrived.
+Status download_snapshot(RemoteStorageDownloader& downloader,
+                         const std::string& remote_dir,
+                         const std::string& work_dir, int concurrency);
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_SNAPSHOT_TRANSPORT_H_
@@ -0,0 +1,309 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/text_index.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+
+#include "glog/logging.h"
+
+namespace gs {
+
+namespace {
+
+// The distinct trigrams of str, in ascending order.
+std::vector<uint32_t> grams_of(std::string_view str) {
+  std::vector<uint32_t> grams;
+  if (str.size() < TextIndex::kGramSize) {
+    return grams;
+  }
+  grams.reserve(str.size() - TextIndex::kGramSize + 1);
+  for (size_t i = 0; i + TextIndex::kGramSize <= str.size(); ++i) {
+    grams.push_back(static_cast<uint32_t>(static_cast<uint8_t>(str[i])) << 16 |
+                    static_cast<uint32_t>(static_cast<uint8_t>(str[i + 1]))
+                        << 8 |
+                    static_cast<uint8_t>(str[i + 2]));
+  }
+  std::sort(grams.begin(), grams.end());
+  grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+  return grams;
+}
+
+void sort_unique(std::vector<vid_t>& vids) {
+  std::sort(vids.begin(), vids.end());
+  vids.erase(std::unique(vids.begin(), vids.end()), vids.end());
+}
+
+template <typename T>
+void write_vector(FILE* fout, const std::vector<T>& vec) {
+  uint64_t size = vec.size();
+  CHECK_EQ(fwrite(&size, sizeof(uint64_t), 1, fout), 1);
+  CHECK_EQ(fwrite(vec.data(), sizeof(T), size, fout), size);
+}
+
+template <typename T>
+void read_vector(FILE* fin, std::vector<T>& vec) {
+  uint64_t size = 0;
+  CHECK_EQ(fread(&size, sizeof(uint64_t), 1, fin), 1);
+  vec.resize(size);
+  CHECK_EQ(fread(vec.data(), sizeof(T), size, fin), size);
+}
+
+}  // namespace
+
+bool TextIndex::is_supported(const PropertyType& type) {
+  return type == PropertyType::kStringView;
+}
+
+void TextIndex::insert(const Any& value, vid_t vid) {
+  auto str = value.AsStringView();
+  auto grams = grams_of(str);
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  delta_.emplace(std::string(str), vid);
+  for (auto gram : grams) {
+    delta_postings_[gram].push_back(vid);
+  }
+}
+
+std::pair<std::vector<TextIndex::Entry>::const_iterator,
+          std::vector<TextIndex::Entry>::const_iterator>
+TextIndex::prefixRange(std::string_view prefix) const {
+  auto begin = std::partition_point(
+      sorted_.begin(), sorted_.end(),
+      [&](const Entry& entry) { return value(entry) < prefix; });
+  auto end = std::partition_point(begin, sorted_.end(), [&](const Entry& e) {
+    return value(e).compare(0, prefix.size(), prefix) <= 0;
+  });
+  return {begin, end};
+}
+
+void TextIndex::lookup_prefix(std::string_view prefix,
+                              std::vector<vid_t>& vids) const {
+  vids.clear();
+  auto [begin, end] = prefixRange(prefix);
+  for (auto iter = begin; iter != end; ++iter) {
+    vids.push_back(iter->vid);
+  }
+  {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    for (auto iter = delta_.lower_bound(std::string(prefix));
+         iter != delta_.end() &&
+         iter->first.compare(0, prefix.size(), prefix) == 0;
+         ++iter) {
+      vids.push_back(iter->second);
+    }
+  }
+  sort_unique(vids);
+}
+
+size_t TextIndex::count_prefix(std::string_view prefix) const {
+  auto [begin, end] = prefixRange(prefix);
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  return (end - begin) + delta_.size();
+}
+
+void TextIndex::lookup_substring(std::string_view str,
+                                 std::vector<vid_t>& vids) const {
+  vids.clear();
+  auto grams = grams_of(str);
+  CHECK(!grams.empty());
+  std::vector<std::vector<vid_t>> lists(grams.size());
+  {
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    for (size_t i = 0; i < grams.size(); ++i) {
+      auto iter = delta_postings_.find(grams[i]);
+      if (iter != delta_postings_.end()) {
+        lists[i] = iter->second;
+      }
+    }
+  }
+  for (size_t i = 0; i < grams.size(); ++i) {
+    auto iter = postings_.find(grams[i]);
+    if (iter != postings_.end()) {
+      lists[i].insert(lists[i].end(), iter->second.begin(),
+                      iter->second.end());
+    }
+    if (lists[i].empty()) {
+      return;
+    }
+  }
+  // Intersects the shortest lists first.
+  std::sort(lists.begin(), lists.end(),
+            [](const std::vector<vid_t>& lhs, const std::vector<vid_t>& rhs) {
+              return lhs.size() < rhs.size();
+            });
+  vids = std::move(lists[0]);
+  sort_unique(vids);
+  std::vector<vid_t> next, ret;
+  for (size_t i = 1; i < lists.size() && !vids.empty(); ++i) {
+    next = std::move(lists[i]);
+    sort_unique(next);
+    ret.clear();
+    std::set_intersection(vids.begin(), vids.end(), next.begin(), next.end(),
+                          std::back_inserter(ret));
+    vids.swap(ret);
+  }
+}
+
+size_t TextIndex::count_substring(std::string_view str) const {
+  auto grams = grams_of(str);
+  size_t count = std::numeric_limits<size_t>::max();
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  for (auto gram : grams) {
+    size_t num = 0;
+    auto iter = postings_.find(gram);
+    if (iter != postings_.end()) {
+      num += iter->second.size();
+    }
+    auto delta_iter = delta_postings_.find(gram);
+    if (delta_iter != delta_postings_.end()) {
+      num += delta_iter->second.size();
+    }
+    count = std::min(count, num);
+  }
+  return count;
+}
+
+void TextIndex::rebuild(const ColumnBase& column, vid_t vertex_num) {
+  clear();
+  std::vector<std::pair<std::string, vid_t>> values;
+  values.reserve(vertex_num);
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    auto str = column.get(v).AsStringView();
+    for (auto gram : grams_of(str)) {
+      postings_[gram].push_back(v);
+    }
+    values.emplace_back(std::string(str), v);
+  }
+  std::sort(values.begin(), values.end());
+  mergeValues(std::move(values));
+}
+
+void TextIndex::mergeValues(
+    std::vector<std::pair<std::string, vid_t>>&& values) {
+  std::vector<Entry> entries;
+  entries.reserve(values.size());
+  for (auto& [str, vid] : values) {
+    entries.push_back({chars_.size(), static_cast<uint32_t>(str.size()), vid});
+    chars_.append(str);
+  }
+  size_t mid = sorted_.size();
+  sorted_.insert(sorted_.end(), entries.begin(), entries.end());
+  std::inplace_merge(sorted_.begin(), sorted_.begin() + mid, sorted_.end(),
+                     [this](const Entry& lhs, const Entry& rhs) {
+                       auto l = value(lhs), r = value(rhs);
+                       return l < r || (l == r && lhs.vid < rhs.vid);
+                     });
+}
+
+void TextIndex::merge() {
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  if (delta_.empty()) {
+    return;
+  }
+  std::vector<std::pair<std::string, vid_t>> values(delta_.begin(),
+                                                    delta_.end());
+  std::sort(values.begin(), values.end());
+  mergeValues(std::move(values));
+  for (auto& [gram, vids] : delta_postings_) {
+    auto& posting = postings_[gram];
+    sort_unique(vids);
+    size_t mid = posting.size();
+    posting.insert(posting.end(), vids.begin(), vids.end());
+    std::inplace_merge(posting.begin(), posting.begin() + mid, posting.end());
+    posting.erase(std::unique(posting.begin(), posting.end()), posting.end());
+  }
+  delta_.clear();
+  delta_postings_.clear();
+}
+
+// The sorted values, the posting lists, then the values of the delta, which
+// are inserted again when the index is opened.
+void TextIndex::dump(const std::string& path) const {
+  FILE* fout = fopen(path.c_str(), "wb");
+  CHECK(fout != nullptr) << "Failed to open " << path;
+  std::vector<char> chars(chars_.begin(), chars_.end());
+  write_vector(fout, chars);
+  write_vector(fout, sorted_);
+  uint64_t gram_num = postings_.size();
+  CHECK_EQ(fwrite(&gram_num, sizeof(uint64_t), 1, fout), 1);
+  for (auto& [gram, vids] : postings_) {
+    CHECK_EQ(fwrite(&gram, sizeof(uint32_t), 1, fout), 1);
+    write_vector(fout, vids);
+  }
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  uint64_t delta_num = delta_.size();
+  CHECK_EQ(fwrite(&delta_num, sizeof(uint64_t), 1, fout), 1);
+  for (auto& [str, vid] : delta_) {
+    std::vector<char> str_chars(str.begin(), str.end());
+    write_vector(fout, str_chars);
+    CHECK_EQ(fwrite(&vid, sizeof(vid_t), 1, fout), 1);
+  }
+  fflush(fout);
+  fclose(fout);
+}
+
+bool TextIndex::open(const std::string& path) {
+  clear();
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+  FILE* fin = fopen(path.c_str(), "rb");
+  CHECK(fin != nullptr) << "Failed to open " << path;
+  std::vector<char> chars;
+  read_vector(fin, chars);
+  chars_.assign(chars.begin(), chars.end());
+  read_vector(fin, sorted_);
+  uint64_t gram_num = 0;
+  CHECK_EQ(fread(&gram_num, sizeof(uint64_t), 1, fin), 1);
+  for (uint64_t i = 0; i < gram_num; ++i) {
+    uint32_t gram;
+    CHECK_EQ(fread(&gram, sizeof(uint32_t), 1, fin), 1);
+    read_vector(fin, postings_[gram]);
+  }
+  uint64_t delta_num = 0;
+  CHECK_EQ(fread(&delta_num, sizeof(uint64_t), 1, fin), 1);
+  for (uint64_t i = 0; i < delta_num; ++i) {
+    std::vector<char> str_chars;
+    read_vector(fin, str_chars);
+    vid_t vid;
+    CHECK_EQ(fread(&vid, sizeof(vid_t), 1, fin), 1);
+    std::string str(str_chars.begin(), str_chars.end());
+    insert(Any::From(std::string_view(str)), vid);
+  }
+  fclose(fin);
+  return true;
+}
+
+void TextIndex::clear() {
+  chars_.clear();
+  sorted_.clear();
+  postings_.clear();
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  delta_.clear();
+  delta_postings_.clear();
+}
+
+size_t TextIndex::size() const {
+  std::lock_guard<std::mutex> lock(delta_mutex_);
+  return sorted_.size() + delta_.size();
+}
+
+}  // namespace gs
@@ -0,0 +1,121 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_FRAGMENT_TEXT_INDEX_H_
+#define GRAPHSCOPE_FRAGMENT_TEXT_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/column.h"
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+// An index of the values of a string vertex property, declared with
+// text_index in the schema, so that the vertices whose value starts with or
+// contains a string are found without a scan: the values sorted, for a
+// prefix, and an inverted index from the trigrams, i.e. the substrings of 3
+// bytes, of the values to the vertices, for a substring of at least 3 bytes.
+//
+// As in RangeIndex, the index is built when the graph is opened or dumped,
+// values written since go to a delta which compaction merges into it, and
+// overwritten values keep their entries, so lookups return candidates which
+// the caller checks against the values it sees. insert() and the lookups may
+// run concurrently; open(), rebuild() and merge() must not run concurrently
+// with anything else.
+class TextIndex {
+ public:
+  static constexpr size_t kGramSize = 3;
+
+  static bool is_supported(const PropertyType& type);
+
+  void insert(const Any& value, vid_t vid);
+
+  // Sets vids to the vertices with a value starting with prefix, in
+  // ascending order.
+  void lookup_prefix(std::string_view prefix, std::vector<vid_t>& vids) const;
+
+  // An upper bound of the number of vertices lookup_prefix returns, cheaper
+  // than the lookup.
+  size_t count_prefix(std::string_view prefix) const;
+
+  // Sets vids to the vertices with a value containing all the trigrams of
+  // str, in ascending order, among which those containing str. str has at
+  // least kGramSize bytes.
+  void lookup_substring(std::string_view str, std::vector<vid_t>& vids) const;
+
+  // An upper bound of the number of vertices lookup_substring returns, the
+  // number of those with the rarest trigram of str.
+  size_t count_substring(std::string_view str) const;
+
+  // Replaces the entries with the values of vertices [0, vertex_num) of the
+  // column.
+  void rebuild(const ColumnBase& column, vid_t vertex_num);
+
+  // Moves the delta into the sorted values and posting lists.
+  void merge();
+
+  void dump(const std::string& path) const;
+
+  // Returns false if the file does not exist, leaving the index empty.
+  bool open(const std::string& path);
+
+  void clear();
+
+  // Number of values, stale ones included.
+  size_t size() const;
+
+ private:
+  struct Entry {
+    uint64_t offset;
+    uint32_t length;
+    vid_t vid;
+  };
+
+  std::string_view value(const Entry& entry) const {
+    return std::string_view(chars_.data() + entry.offset, entry.length);
+  }
+
+  // The sorted entries with a value starting with prefix.
+  std::pair<std::vector<Entry>::const_iterator,
+            std::vector<Entry>::const_iterator>
+  prefixRange(std::string_view prefix) const;
+
+  // Adds the values of the delta, sorted, to the sorted entries.
+  void mergeValues(std::vector<std::pair<std::string, vid_t>>&& values);
+
+  // Values of the sorted entries, one after another.
+  std::string chars_;
+  std::vector<Entry> sorted_;
+  // The ascending vertices of each trigram.
+  std::unordered_map<uint32_t, std::vector<vid_t>> postings_;
+
+  mutable std::mutex delta_mutex_;
+  std::multimap<std::string, vid_t> delta_;
+  std::unordered_map<uint32_t, std::vector<vid_t>> delta_postings_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_FRAGMENT_TEXT_INDEX_H_
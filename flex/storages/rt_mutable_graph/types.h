@@ -27,6 +27,24 @@ enum class EdgeStrategy {
   kMultiple,
 };
 
+// How the neighbor ids of an immutable csr are laid out on disk and in memory.
+// kDeltaVarint sorts each adjacency list by neighbor id and stores the gaps
+// between consecutive neighbors as varints.
+enum class EdgeCompression {
+  kNone,
+  kDeltaVarint,
+};
+
+// How the vertices of each label are numbered once bulk loaded. kInput keeps
+// the order of the input files, kDegree numbers them by descending degree,
+// and kRcm by the reverse Cuthill-McKee order of a breadth-first traversal,
+// so that vertices close in the graph are close in the csrs and tables.
+enum class VertexOrder {
+  kInput,
+  kDegree,
+  kRcm,
+};
+
 using timestamp_t = uint32_t;
 using vid_t = uint32_t;
 using label_t = uint8_t;
@@ -53,6 +71,22 @@ inline ostream& operator<<(ostream& os, const gs::EdgeStrategy& strategy) {
   }
   return os;
 }
+
+inline ostream& operator<<(ostream& os,
+                           const gs::EdgeCompression& compression) {
+  switch (compression) {
+  case gs::EdgeCompression::kNone:
+    os << "None";
+    break;
+  case gs::EdgeCompression::kDeltaVarint:
+    os << "DeltaVarint";
+    break;
+  default:
+    os << "Unknown";
+    break;
+  }
+  return os;
+}
 }  // namespace std
 
 #endif  // STORAGES_RT_MUTABLE_GRAPH_TYPES_H_
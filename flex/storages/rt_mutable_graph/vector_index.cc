@@ -0,0 +1,368 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/vector_index.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+
+#include "glog/logging.h"
+
+namespace gs {
+
+namespace {
+
+using candidate_t = std::pair<float, uint32_t>;
+
+// The layer of a new node, drawn from an exponential distribution so that
+// each layer holds about 1 / kM of the nodes of the one below.
+int random_layer(std::mt19937& rng) {
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  double r = std::max(dist(rng), 1e-12);
+  return static_cast<int>(-std::log(r) / std::log(VectorIndex::kM));
+}
+
+// The nodes visited by the current search of a thread are marked with its
+// number, so that the marks are not cleared between searches.
+struct VisitedNodes {
+  std::vector<uint32_t> marks;
+  uint32_t epoch = 0;
+
+  void reset(size_t node_num) {
+    if (marks.size() < node_num) {
+      marks.resize(node_num, 0);
+    }
+    if (++epoch == 0) {
+      std::fill(marks.begin(), marks.end(), 0);
+      epoch = 1;
+    }
+  }
+
+  // Returns false if the node was already visited.
+  bool visit(uint32_t node) {
+    if (marks[node] == epoch) {
+      return false;
+    }
+    marks[node] = epoch;
+    return true;
+  }
+};
+
+}  // namespace
+
+bool VectorIndex::is_supported(const PropertyType& type) {
+  return type == PropertyType::kStringView;
+}
+
+bool VectorIndex::parse(std::string_view value, std::vector<float>& embedding) {
+  embedding.clear();
+  std::string str(value);
+  const char* ptr = str.c_str();
+  while (*ptr != '\0') {
+    if (*ptr == '[' || *ptr == ']' || *ptr == ',' || isspace(*ptr)) {
+      ++ptr;
+      continue;
+    }
+    char* end = nullptr;
+    float val = strtof(ptr, &end);
+    if (end == ptr) {
+      embedding.clear();
+      return false;
+    }
+    embedding.push_back(val);
+    ptr = end;
+  }
+  return !embedding.empty();
+}
+
+float VectorIndex::distance(const float* lhs, const float* rhs, size_t dim) {
+  float sum = 0;
+  for (size_t i = 0; i < dim; ++i) {
+    float diff = lhs[i] - rhs[i];
+    sum += diff * diff;
+  }
+  return std::sqrt(sum);
+}
+
+void VectorIndex::insert(const Any& value, vid_t vid) {
+  std::vector<float> embedding;
+  if (!parse(value.AsStringView(), embedding)) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  insert(embedding, vid);
+}
+
+void VectorIndex::insert(const std::vector<float>& embedding, vid_t vid) {
+  if (dim_ == 0) {
+    dim_ = embedding.size();
+  } else if (embedding.size() != dim_) {
+    VLOG(10) << "Skip an embedding of dimension " << embedding.size()
+             << " in a vector index of dimension " << dim_;
+    return;
+  }
+  if (indexed_.size() <= vid) {
+    indexed_.resize(vid + 1, 0);
+  }
+  if (indexed_[vid]) {
+    ++stale_num_;
+  }
+  indexed_[vid] = 1;
+
+  node_t node = vids_.size();
+  vids_.push_back(vid);
+  data_.insert(data_.end(), embedding.begin(), embedding.end());
+  int layer = random_layer(rng_);
+  links_.emplace_back(layer + 1);
+  if (max_layer_ < 0) {
+    entry_ = node;
+    max_layer_ = layer;
+    return;
+  }
+
+  const float* query = data(node);
+  node_t cur = entry_;
+  float cur_dist = dist(query, cur);
+  for (int l = max_layer_; l > layer; --l) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (node_t nbr : links_[cur][l]) {
+        float d = dist(query, nbr);
+        if (d < cur_dist) {
+          cur = nbr;
+          cur_dist = d;
+          changed = true;
+        }
+      }
+    }
+  }
+  for (int l = std::min(layer, max_layer_); l >= 0; --l) {
+    auto candidates = searchLayer(query, cur, kEfConstruction, l);
+    size_t max_num = l == 0 ? 2 * kM : kM;
+    auto& links = links_[node][l];
+    for (size_t i = 0; i < candidates.size() && links.size() < kM; ++i) {
+      links.push_back(candidates[i].second);
+    }
+    for (node_t nbr : links) {
+      links_[nbr][l].push_back(node);
+      if (links_[nbr][l].size() > max_num) {
+        shrink(nbr, l, max_num);
+      }
+    }
+    cur = candidates[0].second;
+  }
+  if (layer > max_layer_) {
+    entry_ = node;
+    max_layer_ = layer;
+  }
+}
+
+std::vector<std::pair<float, VectorIndex::node_t>> VectorIndex::searchLayer(
+    const float* query, node_t entry, size_t ef, int layer) const {
+  // The nearest unexpanded candidate first, and the farthest result first.
+  std::priority_queue<candidate_t, std::vector<candidate_t>,
+                      std::greater<candidate_t>>
+      candidates;
+  std::priority_queue<candidate_t> results;
+  thread_local VisitedNodes visited;
+  visited.reset(vids_.size());
+  float d = dist(query, entry);
+  candidates.emplace(d, entry);
+  results.emplace(d, entry);
+  visited.visit(entry);
+  while (!candidates.empty()) {
+    auto [cur_dist, cur] = candidates.top();
+    if (cur_dist > results.top().first && results.size() >= ef) {
+      break;
+    }
+    candidates.pop();
+    for (node_t nbr : links_[cur][layer]) {
+      if (!visited.visit(nbr)) {
+        continue;
+      }
+      float nbr_dist = dist(query, nbr);
+      if (results.size() < ef || nbr_dist < results.top().first) {
+        candidates.emplace(nbr_dist, nbr);
+        results.emplace(nbr_dist, nbr);
+        if (results.size() > ef) {
+          results.pop();
+        }
+      }
+    }
+  }
+  std::vector<candidate_t> ret(results.size());
+  for (size_t i = ret.size(); i > 0; --i) {
+    ret[i - 1] = results.top();
+    results.pop();
+  }
+  return ret;
+}
+
+void VectorIndex::shrink(node_t node, int layer, size_t max_num) {
+  auto& links = links_[node][layer];
+  const float* base = data(node);
+  std::vector<candidate_t> nbrs;
+  nbrs.reserve(links.size());
+  for (node_t nbr : links) {
+    nbrs.emplace_back(dist(base, nbr), nbr);
+  }
+  std::partial_sort(nbrs.begin(), nbrs.begin() + max_num, nbrs.end());
+  links.resize(max_num);
+  for (size_t i = 0; i < max_num; ++i) {
+    links[i] = nbrs[i].second;
+  }
+}
+
+void VectorIndex::search(const std::vector<float>& query, size_t k, size_t ef,
+                         std::vector<entry_t>& entries) const {
+  entries.clear();
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (max_layer_ < 0 || query.size() != dim_ || k == 0) {
+    return;
+  }
+  node_t cur = entry_;
+  float cur_dist = dist(query.data(), cur);
+  for (int l = max_layer_; l > 0; --l) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (node_t nbr : links_[cur][l]) {
+        float d = dist(query.data(), nbr);
+        if (d < cur_dist) {
+          cur = nbr;
+          cur_dist = d;
+          changed = true;
+        }
+      }
+    }
+  }
+  auto nodes = searchLayer(query.data(), cur, std::max(ef, k), 0);
+  size_t num = std::min(k, nodes.size());
+  entries.reserve(num);
+  for (size_t i = 0; i < num; ++i) {
+    entries.emplace_back(nodes[i].first, vids_[nodes[i].second]);
+  }
+}
+
+size_t VectorIndex::stale_num() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return stale_num_;
+}
+
+void VectorIndex::rebuild(const ColumnBase& column, vid_t vertex_num) {
+  clear();
+  std::vector<float> embedding;
+  for (vid_t v = 0; v < vertex_num; ++v) {
+    if (parse(column.get(v).AsStringView(), embedding)) {
+      insert(embedding, v);
+    }
+  }
+}
+
+// The dimension, the entry, the top layer and the nodes, then the number of
+// layers and the neighbors on each layer of every node.
+void VectorIndex::dump(const std::string& path) const {
+  FILE* fout = fopen(path.c_str(), "wb");
+  CHECK(fout != nullptr) << "Failed to open " << path;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  uint64_t header[4] = {dim_, entry_, static_cast<uint64_t>(max_layer_ + 1),
+                        vids_.size()};
+  CHECK_EQ(fwrite(header, sizeof(uint64_t), 4, fout), 4);
+  CHECK_EQ(fwrite(vids_.data(), sizeof(vid_t), vids_.size(), fout),
+           vids_.size());
+  CHECK_EQ(fwrite(data_.data(), sizeof(float), data_.size(), fout),
+           data_.size());
+  for (auto& layers : links_) {
+    uint32_t layer_num = layers.size();
+    CHECK_EQ(fwrite(&layer_num, sizeof(uint32_t), 1, fout), 1);
+    for (auto& links : layers) {
+      uint32_t link_num = links.size();
+      CHECK_EQ(fwrite(&link_num, sizeof(uint32_t), 1, fout), 1);
+      CHECK_EQ(fwrite(links.data(), sizeof(node_t), link_num, fout),
+               link_num);
+    }
+  }
+  fflush(fout);
+  fclose(fout);
+}
+
+bool VectorIndex::open(const std::string& path) {
+  clear();
+  if (!std::filesystem::exists(path)) {
+    return false;
+  }
+  FILE* fin = fopen(path.c_str(), "rb");
+  CHECK(fin != nullptr) << "Failed to open " << path;
+  uint64_t header[4];
+  CHECK_EQ(fread(header, sizeof(uint64_t), 4, fin), 4);
+  dim_ = header[0];
+  entry_ = header[1];
+  max_layer_ = static_cast<int>(header[2]) - 1;
+  size_t node_num = header[3];
+  vids_.resize(node_num);
+  CHECK_EQ(fread(vids_.data(), sizeof(vid_t), node_num, fin), node_num);
+  data_.resize(node_num * dim_);
+  CHECK_EQ(fread(data_.data(), sizeof(float), data_.size(), fin),
+           data_.size());
+  links_.resize(node_num);
+  for (auto& layers : links_) {
+    uint32_t layer_num = 0;
+    CHECK_EQ(fread(&layer_num, sizeof(uint32_t), 1, fin), 1);
+    layers.resize(layer_num);
+    for (auto& links : layers) {
+      uint32_t link_num = 0;
+      CHECK_EQ(fread(&link_num, sizeof(uint32_t), 1, fin), 1);
+      links.resize(link_num);
+      CHECK_EQ(fread(links.data(), sizeof(node_t), link_num, fin), link_num);
+    }
+  }
+  fclose(fin);
+  for (vid_t vid : vids_) {
+    if (indexed_.size() <= vid) {
+      indexed_.resize(vid + 1, 0);
+    }
+    stale_num_ += indexed_[vid];
+    indexed_[vid] = 1;
+  }
+  return true;
+}
+
+void VectorIndex::clear() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  dim_ = 0;
+  data_.clear();
+  vids_.clear();
+  links_.clear();
+  entry_ = 0;
+  max_layer_ = -1;
+  stale_num_ = 0;
+  indexed_.clear();
+  rng_.seed(0);
+}
+
+size_t VectorIndex::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return vids_.size();
+}
+
+}  // namespace gs
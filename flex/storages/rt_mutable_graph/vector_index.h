@@ -0,0 +1,125 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_FRAGMENT_VECTOR_INDEX_H_
+#define GRAPHSCOPE_FRAGMENT_VECTOR_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/column.h"
+#include "flex/utils/property/types.h"
+
+namespace gs {
+
+// An HNSW index over the embeddings of a string vertex property, declared
+// with vector_index in the schema, so that the vertices nearest to a query
+// embedding are found without a scan. An embedding is a list of floats
+// separated by commas or spaces, optionally in brackets, e.g.
+// "[0.1, 0.2, 0.3]"; the first one indexed fixes the dimension, and values
+// of another dimension or not parsed are not indexed.
+//
+// The embeddings are copied into one contiguous float array. As in
+// SecondaryIndex, a vertex whose value is updated keeps the entry of its old
+// value, so that reads at older timestamps still find it: search() returns
+// candidates, which the caller checks against the values it sees. rebuild()
+// drops the stale entries and must not run concurrently with anything else;
+// insert() and search() may.
+class VectorIndex {
+ public:
+  using entry_t = std::pair<float, vid_t>;
+
+  // The maximum number of neighbors of a node on the upper layers, twice as
+  // many on the bottom layer, and the width of the search when inserting.
+  static constexpr size_t kM = 16;
+  static constexpr size_t kEfConstruction = 100;
+
+  static bool is_supported(const PropertyType& type);
+
+  // Parses an embedding, returns false if value is not one.
+  static bool parse(std::string_view value, std::vector<float>& embedding);
+
+  void insert(const Any& value, vid_t vid);
+
+  // Sets entries to the k entries nearest to the query, or fewer, ordered by
+  // Euclidean distance. ef is the width of the search, at least k.
+  void search(const std::vector<float>& query, size_t k, size_t ef,
+              std::vector<entry_t>& entries) const;
+
+  // The Euclidean distance between two embeddings of the same dimension.
+  static float distance(const float* lhs, const float* rhs, size_t dim);
+
+  size_t dim() const { return dim_; }
+
+  // Number of entries which are not the latest ones of their vertices.
+  size_t stale_num() const;
+
+  // Replaces the entries with the values of vertices [0, vertex_num) of the
+  // column.
+  void rebuild(const ColumnBase& column, vid_t vertex_num);
+
+  void dump(const std::string& path) const;
+
+  // Returns false if the file does not exist, leaving the index empty.
+  bool open(const std::string& path);
+
+  void clear();
+
+  // Number of entries, stale ones included.
+  size_t size() const;
+
+ private:
+  using node_t = uint32_t;
+
+  const float* data(node_t node) const { return data_.data() + node * dim_; }
+  float dist(const float* query, node_t node) const {
+    return distance(query, data(node), dim_);
+  }
+
+  void insert(const std::vector<float>& embedding, vid_t vid);
+
+  // The ef nodes nearest to the query found on layer by a best first search
+  // from entry, ordered by distance.
+  std::vector<std::pair<float, node_t>> searchLayer(const float* query,
+                                                    node_t entry, size_t ef,
+                                                    int layer) const;
+
+  // Keeps the max_num neighbors of node on layer nearest to it.
+  void shrink(node_t node, int layer, size_t max_num);
+
+  mutable std::shared_mutex mutex_;
+  size_t dim_ = 0;
+  std::vector<float> data_;
+  std::vector<vid_t> vids_;
+  // links_[node][layer] are the neighbors of the node on the layer.
+  std::vector<std::vector<std::vector<node_t>>> links_;
+  node_t entry_ = 0;
+  int max_layer_ = -1;
+  size_t stale_num_ = 0;
+  std::vector<uint8_t> indexed_;
+  std::mt19937 rng_{0};
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_FRAGMENT_VECTOR_INDEX_H_
@@ -0,0 +1,124 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/storages/rt_mutable_graph/vertex_property_versions.h"
+
+#include <algorithm>
+
+#include <glog/logging.h>
+
+namespace gs {
+
+VertexPropertyVersions::VertexPropertyVersions()
+    : version_num_(0), key_locks_(new std::atomic<bool>[1 << kKeyLockBits]) {
+  for (size_t i = 0; i < (1 << kKeyLockBits); ++i) {
+    key_locks_[i].store(false);
+  }
+}
+
+VertexPropertyVersions::~VertexPropertyVersions() {}
+
+void VertexPropertyVersions::Add(label_t label, vid_t vid, int col_id,
+                                 timestamp_t ts, const Any& value) {
+  uint64_t k = key(label, vid, col_id);
+  auto& shard = shards_[k % kShardNum];
+  shard.lock.lock();
+  Version version{ts, value};
+  if (value.type == PropertyType::StringView()) {
+    shard.strings.emplace_back(value.AsStringView());
+    version.value.set_string_view(shard.strings.back());
+  }
+  auto& versions = shard.versions[k];
+  auto iter = std::upper_bound(
+      versions.begin(), versions.end(), ts,
+      [](timestamp_t lhs, const Version& rhs) { return lhs < rhs.ts; });
+  versions.insert(iter, std::move(version));
+  shard.lock.unlock();
+  version_num_.fetch_add(1, std::memory_order_release);
+}
+
+bool VertexPropertyVersions::Get(label_t label, vid_t vid, int col_id,
+                                 timestamp_t ts, Any& value,
+                                 timestamp_t* version_ts) const {
+  if (version_ts != nullptr) {
+    *version_ts = 0;
+  }
+  if (version_num() == 0) {
+    return false;
+  }
+  uint64_t k = key(label, vid, col_id);
+  const auto& shard = shards_[k % kShardNum];
+  bool found = false;
+  shard.lock.lock();
+  auto iter = shard.versions.find(k);
+  if (iter != shard.versions.end()) {
+    const auto& versions = iter->second;
+    auto ub = std::upper_bound(
+        versions.begin(), versions.end(), ts,
+        [](timestamp_t lhs, const Version& rhs) { return lhs < rhs.ts; });
+    if (ub != versions.begin()) {
+      value = std::prev(ub)->value;
+      if (version_ts != nullptr) {
+        *version_ts = std::prev(ub)->ts;
+      }
+      found = true;
+    }
+  }
+  shard.lock.unlock();
+  return found;
+}
+
+timestamp_t VertexPropertyVersions::LatestTs(label_t label, vid_t vid,
+                                             int col_id) const {
+  if (version_num() == 0) {
+    return 0;
+  }
+  uint64_t k = key(label, vid, col_id);
+  const auto& shard = shards_[k % kShardNum];
+  timestamp_t ret = 0;
+  shard.lock.lock();
+  auto iter = shard.versions.find(k);
+  if (iter != shard.versions.end() && !iter->second.empty()) {
+    ret = iter->second.back().ts;
+  }
+  shard.lock.unlock();
+  return ret;
+}
+
+void VertexPropertyVersions::Fold(std::vector<Table>& tables,
+                                  std::vector<bool>& written) {
+  if (version_num() == 0) {
+    return;
+  }
+  size_t folded = 0;
+  for (auto& shard : shards_) {
+    for (auto& pair : shard.versions) {
+      label_t label = pair.first >> 48;
+      int col_id = (pair.first >> 32) & 0xffff;
+      vid_t vid = static_cast<vid_t>(pair.first);
+      tables[label].get_column_by_id(col_id)->set_any(
+          vid, pair.second.back().value);
+      written[label] = true;
+      ++folded;
+    }
+    shard.versions.clear();
+    shard.strings.clear();
+  }
+  VLOG(10) << "Folded " << version_num() << " versions of " << folded
+           << " vertex properties";
+  version_num_.store(0, std::memory_order_release);
+}
+
+}  // namespace gs
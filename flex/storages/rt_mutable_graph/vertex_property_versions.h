@@ -0,0 +1,124 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STORAGES_RT_MUTABLE_GRAPH_VERTEX_PROPERTY_VERSIONS_H_
+#define STORAGES_RT_MUTABLE_GRAPH_VERTEX_PROPERTY_VERSIONS_H_
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/property/table.h"
+#include "flex/utils/property/types.h"
+#include "grape/utils/concurrent_queue.h"
+
+namespace gs {
+
+/**
+ * @brief Values of vertex properties committed while readers keep running,
+ * kept aside from the vertex tables as timestamped versions.
+ *
+ * A version written at timestamp ts is seen by the reads at ts or later,
+ * while older reads keep seeing the value in the table, so a property update
+ * needs no exclusive timestamp. The versions of a property are ordered by
+ * timestamp, whatever the order their transactions committed in. Fold()
+ * writes the latest versions into the tables once no transaction runs, which
+ * the exclusive update and compaction transactions guarantee.
+ */
+class VertexPropertyVersions {
+ public:
+  VertexPropertyVersions();
+  ~VertexPropertyVersions();
+
+  // Records value as property col_id of vertex vid from ts on. String values
+  // are copied.
+  void Add(label_t label, vid_t vid, int col_id, timestamp_t ts,
+           const Any& value);
+
+  // Sets value to the latest version of the property visible at ts, and
+  // returns false if there is none, i.e. the table holds the value to read.
+  // Strings point into the versions, which live until the next Fold(). If
+  // version_ts is given, it is set to the timestamp of the version, 0 if
+  // there is none.
+  bool Get(label_t label, vid_t vid, int col_id, timestamp_t ts, Any& value,
+           timestamp_t* version_ts = nullptr) const;
+
+  // The timestamp of the latest version of the property, visible or not, 0 if
+  // there is none.
+  timestamp_t LatestTs(label_t label, vid_t vid, int col_id) const;
+
+  size_t version_num() const {
+    return version_num_.load(std::memory_order_acquire);
+  }
+
+  // Writes the latest version of each property into tables, indexed by
+  // vertex label, and drops every version. Sets written[label] for each
+  // table written to. Must not run concurrently with any other method.
+  void Fold(std::vector<Table>& tables, std::vector<bool>& written);
+
+  static inline uint64_t key(label_t label, vid_t vid, int col_id) {
+    return (static_cast<uint64_t>(label) << 48) |
+           (static_cast<uint64_t>(col_id & 0xffff) << 32) | vid;
+  }
+
+  // Locks over the keys of properties, striped, that writers validating the
+  // values they read hold while committing the values they write, see
+  // PropertyUpdateTransaction. Locks taken together are taken in ascending
+  // order.
+  static inline size_t lock_index(uint64_t k) {
+    return (k * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - kKeyLockBits);
+  }
+  void LockKey(size_t idx) {
+    while (key_locks_[idx].exchange(true, std::memory_order_acquire)) {
+      while (key_locks_[idx].load(std::memory_order_relaxed)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+  void UnlockKey(size_t idx) {
+    key_locks_[idx].store(false, std::memory_order_release);
+  }
+  bool KeyLocked(size_t idx) const { return key_locks_[idx].load(); }
+
+ private:
+  static constexpr size_t kShardNum = 64;
+  static constexpr int kKeyLockBits = 16;
+
+  struct Version {
+    timestamp_t ts;
+    Any value;
+  };
+
+  struct Shard {
+    mutable grape::SpinLock lock;
+    std::unordered_map<uint64_t, std::vector<Version>> versions;
+    // Backs the string values, a deque as it keeps them in place.
+    std::deque<std::string> strings;
+  };
+
+  std::array<Shard, kShardNum> shards_;
+  std::atomic<size_t> version_num_;
+  std::unique_ptr<std::atomic<bool>[]> key_locks_;
+};
+
+}  // namespace gs
+
+#endif  // STORAGES_RT_MUTABLE_GRAPH_VERTEX_PROPERTY_VERSIONS_H_
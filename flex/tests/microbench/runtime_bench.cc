@@ -0,0 +1,97 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "flex/engines/graph_db/database/version_manager.h"
+#include "flex/utils/app_utils.h"
+
+namespace {
+
+gs::VersionManager version_manager;
+
+// Every thread commits in a loop, as sessions of update transactions do.
+void BM_VersionManagerInsert(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    version_manager.init_ts(0, state.threads());
+  }
+  for (auto _ : state) {
+    uint32_t ts = version_manager.acquire_insert_timestamp();
+    version_manager.release_insert_timestamp(ts);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VersionManagerInsert)->ThreadRange(1, 16)->UseRealTime();
+
+// Every thread opens and closes read transactions in its own session.
+void BM_VersionManagerRead(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    version_manager.init_ts(0, state.threads());
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        version_manager.acquire_read_timestamp(state.thread_index()));
+    version_manager.release_read_timestamp(state.thread_index());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VersionManagerRead)->ThreadRange(1, 16)->UseRealTime();
+
+void BM_EncoderPut(benchmark::State& state) {
+  std::vector<char> buf;
+  gs::Encoder encoder(buf);
+  std::string str = "a string of the size of a name";
+  for (auto _ : state) {
+    encoder.clear();
+    for (int i = 0; i < 64; ++i) {
+      encoder.put_long(i);
+      encoder.put_int(i);
+      encoder.put_string(str);
+    }
+    benchmark::DoNotOptimize(buf.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 64 * 3);
+  state.SetBytesProcessed(state.iterations() * buf.size());
+}
+BENCHMARK(BM_EncoderPut);
+
+void BM_DecoderGet(benchmark::State& state) {
+  std::vector<char> buf;
+  gs::Encoder encoder(buf);
+  std::string str = "a string of the size of a name";
+  for (int i = 0; i < 64; ++i) {
+    encoder.put_long(i);
+    encoder.put_int(i);
+    encoder.put_string(str);
+  }
+  for (auto _ : state) {
+    gs::Decoder decoder(buf.data(), buf.size());
+    size_t sum = 0;
+    while (!decoder.empty()) {
+      sum += decoder.get_long();
+      sum += decoder.get_int();
+      sum += decoder.get_string().size();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * 64 * 3);
+  state.SetBytesProcessed(state.iterations() * buf.size());
+}
+BENCHMARK(BM_DecoderGet);
+
+}  // namespace
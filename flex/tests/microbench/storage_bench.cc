@@ -0,0 +1,226 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/dual_csr.h"
+#include "flex/utils/allocators.h"
+#include "flex/utils/id_indexer.h"
+#include "flex/utils/mmap_array.h"
+#include "flex/utils/property/table.h"
+
+namespace {
+
+using vid_t = gs::vid_t;
+
+constexpr int kDegree = 16;
+
+// The random out-edges of a synthetic graph, kDegree per vertex, the same for
+// every run of a given vertex number.
+std::vector<vid_t> random_neighbors(size_t vnum) {
+  std::mt19937 rng(vnum);
+  std::uniform_int_distribution<vid_t> dist(0, vnum - 1);
+  std::vector<vid_t> nbrs(vnum * kDegree);
+  for (auto& nbr : nbrs) {
+    nbr = dist(rng);
+  }
+  return nbrs;
+}
+
+template <typename CSR_T>
+void build_csr(CSR_T& csr, size_t vnum) {
+  auto nbrs = random_neighbors(vnum);
+  std::vector<int> degree(vnum, kDegree);
+  csr.batch_init_in_memory(degree, 1.0);
+  for (vid_t v = 0; v < vnum; ++v) {
+    for (int i = 0; i < kDegree; ++i) {
+      csr.batch_put_edge(v, nbrs[v * kDegree + i], v, 0);
+    }
+  }
+}
+
+template <typename CSR_T>
+void BM_CsrScan(benchmark::State& state) {
+  size_t vnum = state.range(0);
+  CSR_T csr;
+  build_csr(csr, vnum);
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (vid_t v = 0; v < vnum; ++v) {
+      for (auto& e : csr.get_edges(v)) {
+        sum += e.get_neighbor();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * vnum * kDegree);
+}
+BENCHMARK_TEMPLATE(BM_CsrScan, gs::MutableCsr<int64_t>)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_CsrScan, gs::ImmutableCsr<int64_t>)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20);
+
+template <typename CSR_T>
+void BM_CsrBatchPutEdge(benchmark::State& state) {
+  size_t vnum = state.range(0);
+  for (auto _ : state) {
+    CSR_T csr;
+    build_csr(csr, vnum);
+    benchmark::DoNotOptimize(csr.edge_num());
+  }
+  state.SetItemsProcessed(state.iterations() * vnum * kDegree);
+}
+BENCHMARK_TEMPLATE(BM_CsrBatchPutEdge, gs::MutableCsr<int64_t>)
+    ->Arg(1 << 16)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CsrBatchPutEdge, gs::ImmutableCsr<int64_t>)
+    ->Arg(1 << 16)
+    ->Unit(benchmark::kMillisecond);
+
+// Inserts edges at random sources of a built MutableCsr, as a transaction
+// does, so that adjacency lists outgrow their reservation.
+void BM_MutableCsrPutEdge(benchmark::State& state) {
+  size_t vnum = state.range(0);
+  gs::MutableCsr<int64_t> csr;
+  build_csr(csr, vnum);
+  gs::Allocator alloc(gs::MemoryStrategy::kMemoryOnly, "");
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<vid_t> dist(0, vnum - 1);
+  for (auto _ : state) {
+    csr.put_edge(dist(rng), dist(rng), 0, 1, alloc);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MutableCsrPutEdge)->Arg(1 << 16);
+
+void BM_LFIndexerInsert(benchmark::State& state) {
+  size_t num = state.range(0);
+  for (auto _ : state) {
+    gs::LFIndexer<vid_t> indexer;
+    indexer.init(gs::PropertyType::kInt64);
+    indexer.open_in_memory("");
+    indexer.reserve(num);
+    for (size_t i = 0; i < num; ++i) {
+      indexer.insert(gs::Any::From(static_cast<int64_t>(i * 7919)));
+    }
+    benchmark::DoNotOptimize(indexer.size());
+  }
+  state.SetItemsProcessed(state.iterations() * num);
+}
+BENCHMARK(BM_LFIndexerInsert)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_LFIndexerLookup(benchmark::State& state) {
+  size_t num = state.range(0);
+  gs::LFIndexer<vid_t> indexer;
+  indexer.init(gs::PropertyType::kInt64);
+  indexer.open_in_memory("");
+  indexer.reserve(num);
+  for (size_t i = 0; i < num; ++i) {
+    indexer.insert(gs::Any::From(static_cast<int64_t>(i * 7919)));
+  }
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, num - 1);
+  for (auto _ : state) {
+    vid_t lid;
+    benchmark::DoNotOptimize(
+        indexer.get_index(gs::Any::From(dist(rng) * 7919), lid));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LFIndexerLookup)->Arg(1 << 16)->Arg(1 << 22);
+
+void BM_LFIndexerLookupBatch(benchmark::State& state) {
+  size_t num = state.range(0);
+  gs::LFIndexer<vid_t> indexer;
+  indexer.init(gs::PropertyType::kInt64);
+  indexer.open_in_memory("");
+  indexer.reserve(num);
+  for (size_t i = 0; i < num; ++i) {
+    indexer.insert(gs::Any::From(static_cast<int64_t>(i * 7919)));
+  }
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, num - 1);
+  std::vector<int64_t> keys(1024);
+  for (auto& key : keys) {
+    key = dist(rng) * 7919;
+  }
+  std::vector<vid_t> lids(keys.size());
+  for (auto _ : state) {
+    indexer.get_index_batch(keys.data(), keys.size(), lids.data());
+    benchmark::DoNotOptimize(lids.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_LFIndexerLookupBatch)->Arg(1 << 16)->Arg(1 << 22);
+
+// Opens a dumped array as a snapshot is opened, i.e. by a private mapping.
+void BM_MmapArrayOpen(benchmark::State& state) {
+  size_t num = state.range(0);
+  auto path = std::filesystem::temp_directory_path() /
+              ("flex_microbench_mmap_" + std::to_string(num));
+  {
+    gs::mmap_array<int64_t> array;
+    array.open("", false);
+    array.resize(num);
+    for (size_t i = 0; i < num; ++i) {
+      array[i] = i;
+    }
+    array.dump(path.string());
+  }
+  for (auto _ : state) {
+    gs::mmap_array<int64_t> array;
+    array.open(path.string(), false);
+    benchmark::DoNotOptimize(array[num - 1]);
+  }
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_MmapArrayOpen)->Arg(1 << 20)->Arg(1 << 24);
+
+void BM_TableColumnScan(benchmark::State& state) {
+  size_t num = state.range(0);
+  gs::Table table;
+  table.open_in_memory("bench", "", {"id", "name"},
+                       {gs::PropertyType::kInt64,
+                        gs::PropertyType::kStringView},
+                       {gs::StorageStrategy::kMem, gs::StorageStrategy::kMem});
+  table.resize(num);
+  auto ids = std::dynamic_pointer_cast<gs::TypedColumn<int64_t>>(
+      table.get_column_by_id(0));
+  auto names = std::dynamic_pointer_cast<gs::TypedColumn<std::string_view>>(
+      table.get_column_by_id(1));
+  std::vector<std::string> values(num);
+  for (size_t i = 0; i < num; ++i) {
+    values[i] = "name_" + std::to_string(i);
+    ids->set_value(i, i);
+    names->set_value(i, values[i]);
+  }
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (size_t i = 0; i < num; ++i) {
+      sum += ids->get_view(i) + names->get_view(i).size();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * num);
+}
+BENCHMARK(BM_TableColumnScan)->Arg(1 << 20);
+
+}  // namespace
@@ -0,0 +1,110 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filesystem>
+#include <random>
+
+#include "flex/storages/rt_mutable_graph/csr/compressed_csr.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+template <typename EDATA_T>
+void check_csr(
+    const CompressedImmutableCsr<EDATA_T>& csr,
+    const std::vector<std::vector<std::pair<vid_t, EDATA_T>>>& expected) {
+  for (vid_t v = 0; v < expected.size(); ++v) {
+    auto edges = csr.get_edges(v);
+    CHECK_EQ(edges.size(), expected[v].size());
+    size_t idx = 0;
+    for (auto& e : edges) {
+      CHECK_EQ(e.get_neighbor(), expected[v][idx].first);
+      CHECK_EQ(e.get_data(), expected[v][idx].second);
+      ++idx;
+    }
+    CHECK_EQ(idx, expected[v].size());
+
+    size_t iter_num = 0;
+    for (auto it = csr.edge_iter(v); it->is_valid(); it->next()) {
+      CHECK_EQ(it->get_neighbor(), expected[v][iter_num].first);
+      ++iter_num;
+    }
+    CHECK_EQ(iter_num, expected[v].size());
+  }
+}
+
+void test_compressed_csr(const std::string& work_dir) {
+  const vid_t vnum = 1000;
+  std::mt19937 rng(42);
+  std::vector<std::vector<std::pair<vid_t, int64_t>>> expected(vnum);
+  std::vector<std::tuple<vid_t, vid_t, int64_t>> edges;
+  for (vid_t src = 0; src < vnum; ++src) {
+    int deg = rng() % 20;
+    for (int i = 0; i < deg; ++i) {
+      // Mix small and large gaps to exercise multi-byte varints.
+      vid_t dst = (i % 3 == 0) ? rng() % vnum : rng();
+      edges.emplace_back(src, dst, static_cast<int64_t>(dst) * 7);
+    }
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+
+  std::vector<int> degree(vnum, 0);
+  for (auto& e : edges) {
+    ++degree[std::get<0>(e)];
+    expected[std::get<0>(e)].emplace_back(std::get<1>(e), std::get<2>(e));
+  }
+  for (auto& list : expected) {
+    std::sort(list.begin(), list.end());
+  }
+
+  CompressedImmutableCsr<int64_t> csr;
+  csr.batch_init_in_memory(degree, 1.0);
+  for (auto& e : edges) {
+    csr.batch_put_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e), 0);
+  }
+  CHECK_EQ(csr.edge_num(), edges.size());
+  csr.dump("test_oe", work_dir);
+  check_csr(csr, expected);
+  LOG(INFO) << "Encoded " << edges.size() << " edges into "
+            << csr.compressed_size() << " bytes";
+
+  CompressedImmutableCsr<int64_t> loaded;
+  loaded.open("test_oe", work_dir, work_dir);
+  CHECK_EQ(loaded.size(), vnum);
+  CHECK_EQ(loaded.edge_num(), edges.size());
+  check_csr(loaded, expected);
+
+  CompressedImmutableCsr<int64_t> in_memory;
+  in_memory.open_in_memory(work_dir + "/test_oe", vnum + 10);
+  CHECK_EQ(in_memory.size(), vnum + 10);
+  CHECK_EQ(in_memory.get_edges(vnum + 5).size(), 0);
+  check_csr(in_memory, expected);
+  LOG(INFO) << "Finish test compressed csr";
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  std::string work_dir =
+      (std::filesystem::temp_directory_path() / "compressed_csr_test").string();
+  if (argc > 1) {
+    work_dir = argv[1];
+  }
+  std::filesystem::create_directories(work_dir);
+  gs::test_compressed_csr(work_dir);
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
@@ -0,0 +1,188 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/runtime/common/columns/vertex_columns.h"
+#include "flex/engines/graph_db/runtime/common/context.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/engines/graph_db/runtime/common/operators/retrieve/edge_expand.h"
+#include "flex/storages/rt_mutable_graph/loader/basic_fragment_loader.h"
+#include "flex/utils/id_indexer.h"
+
+// Bulk loads a graph whose triplet keeps its edges in compressed csrs, and
+// expands over it through GraphReadInterface, both by the graph views and by
+// the EdgeExpand operator, in both directions.
+
+using edge_t = std::tuple<gs::vid_t, gs::vid_t, int64_t>;
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label("PERSON", {gs::PropertyType::kInt32}, {"age"},
+                          {std::tuple<gs::PropertyType, std::string, size_t>(
+                              gs::PropertyType::kInt64, "id", 0)},
+                          {});
+  schema.add_edge_label("PERSON", "PERSON", "KNOWS", {gs::PropertyType::kInt64},
+                        {"since"}, gs::EdgeStrategy::kMultiple,
+                        gs::EdgeStrategy::kMultiple, false, false, false, "",
+                        gs::EdgeCompression::kDeltaVarint,
+                        gs::EdgeCompression::kDeltaVarint);
+  return schema;
+}
+
+static void load(const std::string& work_dir, gs::vid_t vnum,
+                 const std::vector<edge_t>& edges) {
+  auto schema = person_schema();
+  auto label = schema.get_vertex_label_id("PERSON");
+  auto knows = schema.get_edge_label_id("KNOWS");
+  gs::BasicFragmentLoader loader(schema, work_dir);
+  gs::IdIndexer<int64_t, gs::vid_t> indexer;
+  loader.GetVertexTable(label).resize(vnum);
+  for (gs::vid_t v = 0; v < vnum; ++v) {
+    gs::vid_t vid;
+    CHECK(indexer.add(static_cast<int64_t>(v), vid));
+    CHECK_EQ(vid, v);
+    loader.SetVertexProperty(label, 0, vid, gs::Any::From<int32_t>(v));
+  }
+  loader.FinishAddingVertex<int64_t>(label, indexer);
+
+  std::vector<int32_t> oe_degree(vnum, 0), ie_degree(vnum, 0);
+  for (auto& e : edges) {
+    ++oe_degree[std::get<0>(e)];
+    ++ie_degree[std::get<1>(e)];
+  }
+  std::vector<std::vector<edge_t>> edges_vec = {edges};
+  loader.AddNoPropEdgeBatch<int64_t>(label, label, knows);
+  loader.PutEdges<int64_t, std::vector<edge_t>>(
+      label, label, knows, edges_vec, ie_degree, oe_degree, false);
+  loader.LoadFragment();
+}
+
+// The pairs of the vertex columns at src_tag and dst_tag of the rows.
+static std::vector<std::pair<gs::vid_t, gs::vid_t>> rows_of(
+    gs::runtime::Context& ctx, int src_tag, int dst_tag) {
+  auto src = std::dynamic_pointer_cast<gs::runtime::IVertexColumn>(
+      ctx.get(src_tag));
+  auto dst = std::dynamic_pointer_cast<gs::runtime::IVertexColumn>(
+      ctx.get(dst_tag));
+  std::vector<std::pair<gs::vid_t, gs::vid_t>> rows;
+  for (size_t i = 0; i < ctx.row_num(); ++i) {
+    rows.emplace_back(src->get_vertex(i).vid_, dst->get_vertex(i).vid_);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+static void check_expand(const gs::runtime::GraphReadInterface& graph,
+                         gs::label_t label, gs::label_t knows,
+                         gs::runtime::Direction dir, gs::vid_t vnum,
+                         const std::vector<edge_t>& edges) {
+  bool out = dir == gs::runtime::Direction::kOut;
+  // The edges of each vertex in ascending order of neighbor.
+  std::vector<std::vector<std::pair<gs::vid_t, int64_t>>> expected(vnum);
+  std::vector<std::pair<gs::vid_t, gs::vid_t>> expected_rows;
+  for (auto& e : edges) {
+    gs::vid_t v = out ? std::get<0>(e) : std::get<1>(e);
+    gs::vid_t u = out ? std::get<1>(e) : std::get<0>(e);
+    expected[v].emplace_back(u, std::get<2>(e));
+    expected_rows.emplace_back(v, u);
+  }
+  for (auto& list : expected) {
+    std::sort(list.begin(), list.end());
+  }
+  std::sort(expected_rows.begin(), expected_rows.end());
+
+  auto view = out ? graph.GetOutgoingGraphView<int64_t>(label, label, knows)
+                  : graph.GetIncomingGraphView<int64_t>(label, label, knows);
+  CHECK(!view.is_null());
+  for (gs::vid_t v = 0; v < vnum; ++v) {
+    std::vector<std::pair<gs::vid_t, int64_t>> got;
+    for (auto& e : view.get_edges(v)) {
+      got.emplace_back(e.get_neighbor(), e.get_data());
+    }
+    CHECK(got == expected[v]);
+
+    // The neighbors with even ids, by merging with the sorted list.
+    std::vector<gs::vid_t> evens;
+    for (gs::vid_t u = 0; u < vnum; u += 2) {
+      evens.push_back(u);
+    }
+    std::vector<gs::vid_t> matched, expected_matched;
+    view.foreach_edges_with_nbr_in(
+        v, evens.data(), evens.data() + evens.size(),
+        [&](gs::vid_t u, const int64_t&) { matched.push_back(u); });
+    for (auto& pair : expected[v]) {
+      if (pair.first % 2 == 0) {
+        expected_matched.push_back(pair.first);
+      }
+    }
+    CHECK(matched == expected_matched);
+  }
+
+  gs::runtime::Context ctx;
+  auto builder = gs::runtime::SLVertexColumnBuilder::builder(label);
+  for (gs::vid_t v = 0; v < vnum; ++v) {
+    builder.push_back_opt(v);
+  }
+  ctx.set(0, builder.finish(nullptr));
+  gs::runtime::EdgeExpandParams params;
+  params.v_tag = 0;
+  params.labels = {gs::runtime::LabelTriplet(label, label, knows)};
+  params.alias = 1;
+  params.dir = dir;
+  params.is_optional = false;
+  auto res = gs::runtime::EdgeExpand::expand_vertex_without_predicate(
+      graph, std::move(ctx), params);
+  CHECK(res);
+  CHECK(rows_of(res.value(), 0, 1) == expected_rows);
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  std::filesystem::remove_all(work_dir);
+  const gs::vid_t vnum = 500;
+  std::mt19937 rng(7);
+  std::vector<edge_t> edges;
+  for (gs::vid_t src = 0; src < vnum; ++src) {
+    int deg = rng() % 12;
+    for (int i = 0; i < deg; ++i) {
+      gs::vid_t dst = rng() % vnum;
+      edges.emplace_back(src, dst, static_cast<int64_t>(src) * vnum + dst);
+    }
+  }
+  load(work_dir, vnum, edges);
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), work_dir, 1).ok());
+    auto label = db.schema().get_vertex_label_id("PERSON");
+    auto knows = db.schema().get_edge_label_id("KNOWS");
+    auto txn = db.GetReadTransaction();
+    gs::runtime::GraphReadInterface graph(txn);
+    check_expand(graph, label, knows, gs::runtime::Direction::kOut, vnum,
+                 edges);
+    check_expand(graph, label, knows, gs::runtime::Direction::kIn, vnum,
+                 edges);
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
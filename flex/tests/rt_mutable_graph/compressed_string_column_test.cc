@@ -0,0 +1,152 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flex/utils/epoch_manager.h"
+#include "flex/utils/lz_codec.h"
+#include "flex/utils/property/column.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+static void check_round_trip(const std::string& input) {
+  std::string compressed(lz_compress_bound(input.size()), '\0');
+  size_t size = lz_compress(input.data(), input.size(), &compressed[0]);
+  CHECK_LE(size, compressed.size());
+  std::string output(input.size(), '\0');
+  CHECK(lz_decompress(compressed.data(), size, &output[0], output.size()));
+  CHECK(output == input);
+}
+
+void test_lz_codec() {
+  check_round_trip("");
+  check_round_trip("a");
+  check_round_trip("abababababababababababababab");
+
+  std::mt19937 gen(7);
+  std::string random(200000, '\0');
+  for (auto& c : random) {
+    c = static_cast<char>(gen());
+  }
+  check_round_trip(random);
+
+  // Repeats further apart than a 16-bit offset reaches.
+  std::string repeated;
+  while (repeated.size() < 300000) {
+    repeated += "person_" + std::to_string(repeated.size() % 70000) + ";";
+  }
+  check_round_trip(repeated);
+  std::string compressed(lz_compress_bound(repeated.size()), '\0');
+  size_t size =
+      lz_compress(repeated.data(), repeated.size(), &compressed[0]);
+  CHECK_LT(size, repeated.size() / 2);
+
+  std::string output(repeated.size(), '\0');
+  CHECK(!lz_decompress(compressed.data(), size / 2, &output[0],
+                       output.size()));
+  CHECK(!lz_decompress(compressed.data(), size, &output[0],
+                       output.size() - 1));
+  LOG(INFO) << "Finish test lz codec";
+}
+
+static std::string value_of(size_t i) {
+  return "value_" + std::to_string(i % 1000) + "_" + std::to_string(i);
+}
+
+// Views read while a reader keeps its epoch stay valid after their blocks are
+// evicted by the reads of others.
+void test_compressed_string_column() {
+  const size_t row_num = CompressedStringColumn::kBlockSize *
+                             CompressedStringColumn::kCacheBlockNum * 3 +
+                         17;
+  auto path = std::filesystem::temp_directory_path() /
+              "compressed_string_column_test";
+  {
+    CompressedStringColumn column(64);
+    column.open_in_memory("compressed_string_column_test_nonexistent");
+    column.resize(row_num);
+    for (size_t i = 0; i < row_num; ++i) {
+      column.set_value_safe(i, value_of(i));
+    }
+    column.dump(path.string());
+  }
+
+  EpochManager epoch_manager;
+  CompressedStringColumn::set_epoch_manager(&epoch_manager);
+  CompressedStringColumn column(64);
+  column.open_in_memory(path.string());
+  CHECK_EQ(column.size(), row_num);
+  CHECK_LT(column.compressed_size(), row_num * value_of(row_num).size());
+
+  uint64_t epoch = epoch_manager.pin();
+  std::string_view first = column.get_view(0);
+  std::string_view last = column.get_view(row_num - 1);
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < row_num; ++i) {
+      CHECK_EQ(column.get_view(i), value_of(i));
+    }
+  }
+  CHECK_EQ(first, value_of(0));
+  CHECK_EQ(last, value_of(row_num - 1));
+  epoch_manager.unpin(epoch);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 gen(t);
+      for (int round = 0; round < 8; ++round) {
+        uint64_t e = epoch_manager.pin();
+        std::vector<std::pair<size_t, std::string_view>> views;
+        for (int k = 0; k < 20000; ++k) {
+          size_t i = gen() % row_num;
+          views.emplace_back(i, column.get_view(i));
+        }
+        for (auto& pair : views) {
+          CHECK_EQ(pair.second, value_of(pair.first));
+        }
+        epoch_manager.unpin(e);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  CHECK_EQ(column.get(5).AsString(), value_of(5));
+
+  // Values set after the dump shadow the blocks.
+  column.resize(row_num);
+  column.set_value_safe(3, "updated");
+  CHECK_EQ(column.get_view(3), "updated");
+  CHECK_EQ(column.get_view(4), value_of(4));
+
+  column.close();
+  CompressedStringColumn::set_epoch_manager(nullptr);
+  std::filesystem::remove(path.string() + ".zindex");
+  std::filesystem::remove(path.string() + ".zdata");
+  LOG(INFO) << "Finish test compressed string column";
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  gs::test_lz_codec();
+  gs::test_compressed_string_column();
+  return 0;
+}
@@ -0,0 +1,106 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/csr/mutable_csr.h"
+
+// Measures the edges per second that sessions append to the adjacency lists
+// of a few hot vertices, as the in-edges of trending posts, for 1, 2, 4, ...
+// sessions up to the given maximum, and checks that every edge was kept
+// exactly once however the lists grew meanwhile.
+//
+// Usage: csr_ingest_bench [max_session_num] [edges_per_session]
+//                         [hot_vertex_num]
+
+static double run_round(int session_num, int64_t edge_num, int hot_num) {
+  const size_t vnum = 1024;
+  gs::MutableCsr<int64_t> csr;
+  csr.batch_init_in_memory(std::vector<int>(vnum, 0), 1.0);
+  // Each session has an allocator of its own, as in the graph db.
+  std::vector<std::unique_ptr<gs::Allocator>> allocators;
+  for (int i = 0; i < session_num; ++i) {
+    allocators.emplace_back(
+        std::make_unique<gs::Allocator>(gs::MemoryStrategy::kMemoryOnly, ""));
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < session_num; ++i) {
+    threads.emplace_back([&, i]() {
+      auto& alloc = *allocators[i];
+      for (int64_t k = 0; k < edge_num; ++k) {
+        int64_t edge = k * session_num + i;
+        csr.put_edge(edge % hot_num, edge % vnum, edge, 1, alloc);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+
+  int64_t total = edge_num * session_num;
+  std::vector<int64_t> edges;
+  for (int v = 0; v < hot_num; ++v) {
+    for (auto& nbr : csr.get_edges(v)) {
+      CHECK_EQ(nbr.data % hot_num, v);
+      CHECK_EQ(nbr.neighbor, nbr.data % vnum);
+      edges.push_back(nbr.data);
+    }
+  }
+  CHECK_EQ(edges.size(), total) << "edges were lost or duplicated";
+  std::sort(edges.begin(), edges.end());
+  for (int64_t k = 0; k < total; ++k) {
+    CHECK_EQ(edges[k], k) << "edges were lost or duplicated";
+  }
+  return total / seconds;
+}
+
+int main(int argc, char** argv) {
+  int max_session_num = std::thread::hardware_concurrency();
+  int64_t edge_num = 1 << 20;
+  int hot_num = 4;
+  if (argc > 1) {
+    max_session_num = std::stoi(argv[1]);
+  }
+  if (argc > 2) {
+    edge_num = std::stoll(argv[2]);
+  }
+  if (argc > 3) {
+    hot_num = std::stoi(argv[3]);
+  }
+
+  double base = 0;
+  for (int session_num = 1; session_num <= max_session_num;
+       session_num *= 2) {
+    double eps = run_round(session_num, edge_num, hot_num);
+    if (session_num == 1) {
+      base = eps;
+    }
+    LOG(INFO) << session_num << " sessions: " << static_cast<size_t>(eps)
+              << " edges/s, " << eps / base << "x of one session";
+  }
+  return 0;
+}
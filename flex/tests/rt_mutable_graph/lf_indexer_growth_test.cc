@@ -0,0 +1,88 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/types.h"
+#include "flex/utils/id_indexer.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+// Inserts keys from a few threads into an indexer reserved far below their
+// number, so that it grows online while they are inserted and looked up.
+void test_lf_indexer_growth() {
+  const int thread_num = 8;
+  const int64_t key_num = 100000;
+  LFIndexer<vid_t> indexer;
+  indexer.init(PropertyType::kInt64);
+  indexer.open_in_memory("lf_indexer_growth_test_nonexistent");
+  indexer.reserve(16);
+  indexer.reserve_growth(thread_num * key_num);
+
+  std::atomic<int64_t> failed(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int64_t i = 0; i < key_num; ++i) {
+        int64_t key = i * thread_num + t;
+        vid_t lid = indexer.insert(Any::From(key));
+        vid_t found;
+        if (!indexer.get_index(Any::From(key), found) || found != lid) {
+          ++failed;
+        }
+        // A key inserted before the latest growths.
+        int64_t earlier = (i / 2) * thread_num + t;
+        if (!indexer.get_index(Any::From(earlier), found)) {
+          ++failed;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  CHECK_EQ(failed.load(), 0);
+  CHECK_EQ(indexer.size(), thread_num * key_num);
+
+  std::vector<int64_t> keys(thread_num * key_num);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = i;
+  }
+  std::vector<vid_t> lids(keys.size());
+  indexer.get_index_batch(keys.data(), keys.size(), lids.data());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    CHECK_EQ(indexer.get_key(lids[i]).AsInt64(), keys[i]);
+  }
+
+  // Settles the grown table into the indices.
+  indexer.rehash(indexer.capacity());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    vid_t found;
+    CHECK(indexer.get_index(Any::From(keys[i]), found));
+    CHECK_EQ(found, lids[i]);
+  }
+  LOG(INFO) << "Finish test lf indexer growth";
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  gs::test_lf_indexer_growth();
+  return 0;
+}
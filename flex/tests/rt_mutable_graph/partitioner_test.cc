@@ -0,0 +1,69 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/partitioner.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+// Every key falls in exactly one partition, the same for every shard's
+// partitioner, and hashing spreads consecutive keys over the partitions.
+void test_partitioner() {
+  const uint32_t fnum = 4;
+  std::vector<VertexPartitioner> hash, range;
+  for (uint32_t fid = 0; fid < fnum; ++fid) {
+    hash.emplace_back(PartitionMethod::kHash, fnum, fid);
+    range.emplace_back(PartitionMethod::kRange, fnum, fid,
+                       std::vector<int64_t>{100, 200, 300});
+  }
+  std::vector<size_t> counts(fnum, 0);
+  for (int64_t key = 0; key < 400; ++key) {
+    auto oid = Any::From(key);
+    uint32_t owners = 0, range_owners = 0;
+    for (uint32_t fid = 0; fid < fnum; ++fid) {
+      owners += hash[fid].IsLocal(oid);
+      range_owners += range[fid].IsLocal(oid);
+      CHECK_EQ(hash[fid].GetPartition(oid), hash[0].GetPartition(oid));
+    }
+    CHECK_EQ(owners, 1);
+    CHECK_EQ(range_owners, 1);
+    CHECK_EQ(range[0].GetPartition(oid), key / 100);
+    counts[hash[0].GetPartition(oid)]++;
+  }
+  for (auto count : counts) {
+    CHECK_GT(count, 50);
+  }
+
+  std::string name = "vertex";
+  auto str_oid = Any::From(std::string_view(name));
+  CHECK_LT(hash[0].GetPartition(str_oid), fnum);
+  // String keys are hashed under range partitioning.
+  CHECK_EQ(range[0].GetPartition(str_oid), hash[0].GetPartition(str_oid));
+
+  CHECK(VertexPartitioner().trivial());
+  CHECK(VertexPartitioner().IsLocal(str_oid));
+  LOG(INFO) << "Finish test partitioner";
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  gs::test_partitioner();
+  return 0;
+}
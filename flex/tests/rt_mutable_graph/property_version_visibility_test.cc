@@ -0,0 +1,131 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/runtime/common/graph_interface.h"
+#include "flex/utils/property/types.h"
+
+// Checks that the values committed by property update transactions are seen
+// by the runtime reads of the later transactions, through typed and
+// converted columns and single properties, before and after they are folded
+// into the tables, while the earlier transactions keep the former values.
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label(
+      "PERSON", {gs::PropertyType::Varchar(32), gs::PropertyType::kInt32},
+      {"name", "age"},
+      {std::tuple<gs::PropertyType, std::string, size_t>(
+          gs::PropertyType::kInt64, "id", 0)},
+      {});
+  return schema;
+}
+
+static const int64_t kVertexNum = 16;
+static const int64_t kUpdatedNum = 8;
+
+static std::string name_of(int64_t id, bool updated) {
+  return (updated ? "updated_" : "person_") + std::to_string(id);
+}
+
+static int32_t age_of(int64_t id, bool updated) {
+  return updated ? 100 + id : id;
+}
+
+// Reads every vertex as the runtime does, with the values of the updates if
+// updated.
+static void check_reads(const gs::ReadTransaction& txn, bool updated) {
+  gs::runtime::GraphReadInterface graph(txn);
+  auto label = txn.schema().get_vertex_label_id("PERSON");
+  auto names = graph.GetVertexColumn<std::string_view>(label, "name");
+  auto ages = graph.GetVertexColumn<int32_t>(label, "age");
+  // Not of the type of the column, read through ColumnBase::get().
+  auto wide_ages = graph.GetVertexColumn<int64_t>(label, "age");
+  CHECK(!names.is_null() && !ages.is_null() && !wide_ages.is_null());
+  for (int64_t id = 0; id < kVertexNum; ++id) {
+    gs::vid_t vid;
+    CHECK(graph.GetVertexIndex(label, gs::Any::From(id), vid));
+    bool expected = updated && id < kUpdatedNum;
+    std::string name = name_of(id, expected);
+    CHECK_EQ(names.get_view(vid), name);
+    CHECK(names.equals(vid, name, names.get_code(name)));
+    std::string other = name_of(id, !expected);
+    CHECK(!names.equals(vid, other, names.get_code(other)));
+    CHECK_EQ(ages.get_view(vid), age_of(id, expected));
+    CHECK_EQ(wide_ages.get_view(vid), age_of(id, expected));
+    CHECK_EQ(graph.GetVertexProperty(label, vid, 0).AsStringView(), name);
+    CHECK_EQ(graph.GetVertexProperty(label, vid, 1).AsInt32(),
+             age_of(id, expected));
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  std::filesystem::remove_all(work_dir);
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), work_dir, 2).ok());
+    auto label = db.schema().get_vertex_label_id("PERSON");
+    {
+      auto txn = db.GetInsertTransaction();
+      for (int64_t id = 0; id < kVertexNum; ++id) {
+        CHECK(txn.AddVertex(label, gs::Any::From(id),
+                            {gs::Any::From(name_of(id, false)),
+                             gs::Any::From(age_of(id, false))}));
+      }
+      CHECK(txn.Commit());
+    }
+
+    auto before = db.GetReadTransaction(1);
+    CHECK(db.GetSession(0).RunPropertyUpdate(
+        [&](gs::PropertyUpdateTransaction& txn) {
+          for (int64_t id = 0; id < kUpdatedNum; ++id) {
+            gs::vid_t vid;
+            CHECK(db.graph().get_lid(label, gs::Any::From(id), vid));
+            std::string name = name_of(id, true);
+            if (!txn.SetVertexField(label, vid, 0, gs::Any::From(name)) ||
+                !txn.SetVertexField(label, vid, 1,
+                                    gs::Any::From(age_of(id, true)))) {
+              return false;
+            }
+          }
+          return true;
+        }));
+    CHECK_GT(db.graph().vertex_property_versions().version_num(), 0);
+    check_reads(before, false);
+    before.Commit();
+    {
+      auto after = db.GetReadTransaction(1);
+      check_reads(after, true);
+    }
+
+    // The next update transaction folds the versions into the tables.
+    db.GetUpdateTransaction().Abort();
+    CHECK_EQ(db.graph().vertex_property_versions().version_num(), 0);
+    {
+      auto after = db.GetReadTransaction(1);
+      check_reads(after, true);
+    }
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
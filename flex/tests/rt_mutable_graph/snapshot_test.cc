@@ -0,0 +1,132 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <filesystem>
+#include <string>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/engines/graph_db/database/wal/wal_manifest.h"
+#include "flex/storages/rt_mutable_graph/file_names.h"
+#include "flex/utils/property/types.h"
+
+// Takes snapshots of a served graph, and checks that the graph is read,
+// inserted into and snapshotted again after each of them, once the wals it
+// covers are deleted, and that a reopen finds all of it.
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label("PERSON", {gs::PropertyType::Varchar(16)}, {"name"},
+                          {std::tuple<gs::PropertyType, std::string, size_t>(
+                              gs::PropertyType::kInt64, "id", 0)},
+                          {});
+  schema.add_edge_label("PERSON", "PERSON", "KNOWS", {gs::PropertyType::kInt64},
+                        {"since"}, gs::EdgeStrategy::kMultiple,
+                        gs::EdgeStrategy::kMultiple);
+  return schema;
+}
+
+// Vertices begin to end, each one with an edge to the previous one.
+static void insert_range(gs::GraphDB& db, int64_t begin, int64_t end) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  auto knows = db.schema().get_edge_label_id("KNOWS");
+  auto txn = db.GetInsertTransaction();
+  for (int64_t id = begin; id < end; ++id) {
+    CHECK(txn.AddVertex(label, gs::Any::From(id),
+                        {gs::Any::From(std::to_string(id))}));
+    if (id > 0) {
+      CHECK(txn.AddEdge(label, gs::Any::From(id), label,
+                        gs::Any::From(id - 1), knows, gs::Any::From(id)));
+    }
+  }
+  CHECK(txn.Commit());
+}
+
+static void check_range(gs::GraphDB& db, int64_t end) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  auto knows = db.schema().get_edge_label_id("KNOWS");
+  auto txn = db.GetReadTransaction();
+  CHECK_EQ(static_cast<int64_t>(txn.GetVertexNum(label)), end);
+  for (int64_t id = 0; id < end; ++id) {
+    gs::vid_t vid;
+    CHECK(txn.GetVertexIndex(label, gs::Any::From(id), vid));
+    CHECK_EQ(txn.GetVertexField(label, vid, 0).AsStringView(),
+             std::to_string(id));
+    CHECK_EQ(txn.GetOutDegree(label, vid, label, knows), id > 0 ? 1u : 0u);
+    CHECK_EQ(txn.GetInDegree(label, vid, label, knows),
+             id + 1 < end ? 1u : 0u);
+  }
+}
+
+static size_t wal_segment_num(const std::string& work_dir) {
+  size_t num = 0;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(gs::wal_dir(work_dir))) {
+    if (gs::WalManifest::IsSegment(entry.path().filename().string())) {
+      ++num;
+    }
+  }
+  return num;
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  std::filesystem::remove_all(work_dir);
+  const int64_t step = 1000;
+  int64_t end = 0;
+  for (int memory_level = 0; memory_level <= 1; ++memory_level) {
+    std::filesystem::remove_all(work_dir);
+    end = 0;
+    {
+      gs::GraphDB db;
+      CHECK(db.Open(person_schema(), work_dir, 1, false, memory_level == 1)
+                .ok());
+      insert_range(db, end, end + step);
+      end += step;
+
+      uint32_t first_version = gs::get_snapshot_version(work_dir);
+      for (int round = 0; round < 3; ++round) {
+        auto res = db.CreateSnapshot();
+        CHECK(res.ok()) << res.status().error_message();
+        CHECK_EQ(gs::get_snapshot_version(work_dir),
+                 first_version + round + 1);
+        // The segments the snapshot covers are deleted, and the writers
+        // append to new ones.
+        CHECK(gs::WalManifest(gs::wal_dir(work_dir)).segments().empty());
+        check_range(db, end);
+
+        insert_range(db, end, end + step);
+        end += step;
+        check_range(db, end);
+        CHECK_GT(wal_segment_num(work_dir), 0u);
+      }
+      // Updates and compactions run on the reopened graph.
+      CHECK(db.GetSession(0).Compact());
+      check_range(db, end);
+    }
+    {
+      gs::GraphDB db;
+      CHECK(db.Open(person_schema(), work_dir, 1, false, memory_level == 1)
+                .ok());
+      check_range(db, end);
+      insert_range(db, end, end + step);
+      end += step;
+      check_range(db, end);
+    }
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
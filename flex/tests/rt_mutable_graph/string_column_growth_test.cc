@@ -0,0 +1,185 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/dual_csr.h"
+#include "flex/utils/property/column.h"
+#include "flex/utils/string_view_vector.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+// Appends and overwrites the values of a reserved column, so that its data
+// grows past the size it is resized to without moving.
+void test_string_column_growth() {
+  const size_t row_num = 100000;
+  StringColumn column(StorageStrategy::kMem, 64);
+  column.open_in_memory("string_column_growth_test_nonexistent");
+  column.resize(16);
+  column.reserve(row_num);
+  column.resize(row_num);
+
+  std::string long_value(62, 'x');
+  const char* data = column.extra_buffer().get_data({0, 0}).data();
+  for (size_t i = 0; i < row_num; ++i) {
+    column.set_value_safe(i, long_value + std::to_string(i % 10));
+  }
+  for (size_t i = 0; i < row_num; ++i) {
+    CHECK_EQ(column.get_view(i), long_value + std::to_string(i % 10));
+  }
+
+  // Overwrites every row twice, past the size the data is resized to, whose
+  // space is reclaimed by the dump.
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < row_num; ++i) {
+      column.set_value_safe(i, std::to_string(i));
+    }
+  }
+  CHECK_GT(column.extra_buffer().data_size(), row_num * 64);
+  CHECK(column.extra_buffer().get_data({0, 0}).data() == data);
+  auto path = std::filesystem::temp_directory_path() /
+              "string_column_growth_test";
+  column.dump(path.string());
+  CHECK_LE(std::filesystem::file_size(path.string() + ".data"),
+           row_num * std::to_string(row_num).size());
+  StringColumn dumped(StorageStrategy::kMem, 64);
+  dumped.open_in_memory(path.string());
+  CHECK_EQ(dumped.size(), row_num);
+  for (size_t i = 0; i < row_num; ++i) {
+    CHECK_EQ(dumped.get_view(i), std::to_string(i));
+  }
+  dumped.close();
+  std::filesystem::remove(path.string() + ".data");
+  std::filesystem::remove(path.string() + ".items");
+  LOG(INFO) << "Finish test string column growth";
+}
+
+static std::string long_value_of(size_t i) {
+  return std::string(60, 'z') + std::to_string(i % 100);
+}
+
+// Appends long values after the short ones of a dumped column and of the
+// edge data of a dumped csr, both resized by the short average width, as an
+// append import does.
+void test_append_string_growth() {
+  const size_t row_num = 10000;
+  auto dir = std::filesystem::temp_directory_path() /
+             "string_column_append_test";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  std::string path = (dir / "column").string();
+  {
+    StringColumn column(StorageStrategy::kMem, 64);
+    column.open_in_memory((dir / "nonexistent").string());
+    column.resize(row_num);
+    for (size_t i = 0; i < row_num; ++i) {
+      column.set_value(i, std::to_string(i));
+    }
+    column.dump(path);
+  }
+  StringColumn staged(StorageStrategy::kMem, 64);
+  staged.open_in_memory((dir / "nonexistent").string());
+  staged.resize(row_num);
+  for (size_t i = 0; i < row_num; ++i) {
+    staged.set_value(i, long_value_of(i));
+  }
+  StringColumn column(StorageStrategy::kMem, 64);
+  column.open_in_memory(path);
+  column.resize(row_num * 2);
+  CHECK_LT(column.extra_buffer().data_size(), row_num * 60);
+  copy_column_rows(staged, row_num, column,
+                   [&](size_t i) { return row_num + i; });
+  for (size_t i = 0; i < row_num; ++i) {
+    CHECK_EQ(column.get_view(i), std::to_string(i));
+    CHECK_EQ(column.get_view(row_num + i), long_value_of(i));
+  }
+
+  const vid_t vnum = 1000;
+  std::string edata = (dir / "edata").string();
+  {
+    DualCsr<std::string_view> csr(EdgeStrategy::kMultiple,
+                                  EdgeStrategy::kMultiple, 64, true, true);
+    csr.BatchInitInMemory("edata", dir.string(), std::vector<int>(vnum, 1),
+                          std::vector<int>(vnum, 1));
+    for (vid_t v = 0; v < vnum; ++v) {
+      csr.BatchPutEdge(v, v, std::to_string(v));
+    }
+    csr.Dump("oe", "ie", "edata", dir.string());
+  }
+  DualCsr<std::string_view> csr(EdgeStrategy::kMultiple,
+                                EdgeStrategy::kMultiple, 64, true, true);
+  csr.OpenInMemory("oe", "ie", "edata", dir.string(), vnum, vnum);
+  // More edges than the rows added on opening, all of long values.
+  const int append_num = 8;
+  csr.BatchReserve(std::vector<int>(vnum, append_num),
+                   std::vector<int>(vnum, append_num));
+  for (int k = 0; k < append_num; ++k) {
+    for (vid_t v = 0; v < vnum; ++v) {
+      csr.BatchPutEdge(v, (v + 1) % vnum, long_value_of(v));
+    }
+  }
+  for (vid_t v = 0; v < vnum; ++v) {
+    size_t num = 0;
+    for (auto it = csr.GetOutCsr()->edge_iter(v); it->is_valid(); it->next()) {
+      if (it->get_neighbor() == v) {
+        CHECK_EQ(it->get_data().AsStringView(), std::to_string(v));
+      } else {
+        CHECK_EQ(it->get_neighbor(), (v + 1) % vnum);
+        CHECK_EQ(it->get_data().AsStringView(), long_value_of(v));
+      }
+      ++num;
+    }
+    CHECK_EQ(num, append_num + 1);
+  }
+  std::filesystem::remove_all(dir);
+  LOG(INFO) << "Finish test append string growth";
+}
+
+// The views of a StringViewVector stay valid as it grows.
+void test_string_view_vector() {
+  StringViewVector vec;
+  std::vector<std::string_view> views;
+  std::string large(StringViewVector::PAGE_SIZE, 'y');
+  for (size_t i = 0; i < 100000; ++i) {
+    vec.push_back(i % 1000 == 0 ? large : std::to_string(i));
+    views.push_back(vec[i]);
+  }
+  for (size_t i = 0; i < views.size(); ++i) {
+    CHECK(views[i].data() == vec[i].data());
+    CHECK_EQ(views[i], i % 1000 == 0 ? large : std::to_string(i));
+  }
+  StringViewVector copied(vec);
+  CHECK_EQ(copied.size(), vec.size());
+  CHECK_EQ(copied.content_size(), vec.content_size());
+  vec.clear();
+  vec.push_back("reused");
+  CHECK_EQ(vec.size(), 1);
+  CHECK_EQ(vec[0], "reused");
+  CHECK_EQ(copied[1], "1");
+  LOG(INFO) << "Finish test string view vector";
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  gs::test_string_column_growth();
+  gs::test_append_string_growth();
+  gs::test_string_view_vector();
+  return 0;
+}
@@ -30,6 +30,7 @@ using gs::Any;
 using gs::EdgeStrategy;
 using gs::GraphDB;
 using gs::GraphDBSession;
+using gs::PropertyUpdateTransaction;
 using gs::StorageStrategy;
 using oid_t = int64_t;
 using gs::PropertyType;
@@ -1374,6 +1375,63 @@ void LUTest(const std::string& work_dir, int thread_num) {
   }
 }
 
+// Lost Updates, with optimistic property updates
+
+void LUOptimisticTest(const std::string& work_dir, int thread_num) {
+  GraphDB db;
+
+  LUInit(db, work_dir, thread_num);
+  auto person_label_id = db.schema().get_vertex_label_id("PERSON");
+
+  std::map<int64_t, vid_t> lids;
+  {
+    auto txn = db.GetReadTransaction();
+    auto vit = txn.GetVertexIterator(person_label_id);
+    for (; vit.IsValid(); vit.Next()) {
+      lids.emplace(vit.GetField(0).AsInt64(), vit.GetIndex());
+    }
+  }
+
+  std::map<int64_t, int64_t> expNumFriends;
+  std::mutex mtx;
+
+  parallel_client(db, [&](GraphDBSession& session, int client_id) {
+    std::random_device rand_dev;
+    std::mt19937 gen(rand_dev());
+    std::uniform_int_distribution<int> dist(1, 100);
+    std::map<int64_t, int64_t> localExpNumFriends;
+
+    for (int i = 0; i < 1000; ++i) {
+      int64_t person_id = dist(gen);
+      vid_t lid = lids.at(person_id);
+      bool committed = session.RunPropertyUpdate(
+          [&](PropertyUpdateTransaction& txn) {
+            int64_t num_friends =
+                txn.GetVertexField(person_label_id, lid, 1).AsInt64();
+            return txn.SetVertexField(person_label_id, lid, 1,
+                                      Any::From(num_friends + 1));
+          },
+          std::numeric_limits<int>::max());
+      CHECK(committed);
+      ++localExpNumFriends[person_id];
+    }
+
+    mtx.lock();
+    for (auto& pair : localExpNumFriends) {
+      expNumFriends[pair.first] += pair.second;
+    }
+    mtx.unlock();
+  });
+
+  std::map<int64_t, int64_t> numFriends = LU2(db.GetSession(0));
+
+  if (numFriends == expNumFriends) {
+    LOG(INFO) << "LUOptimisticTest passed";
+  } else {
+    LOG(FATAL) << "LUOptimisticTest failed";
+  }
+}
+
 // Write Skews
 
 void WSInit(GraphDB& db, const std::string& work_dir, int thread_num) {
@@ -1557,6 +1615,7 @@ int main(int argc, char** argv) {
   FRTest(work_dir + "/FR", thread_num);
 
   LUTest(work_dir + "/LU", thread_num);
+  LUOptimisticTest(work_dir + "/LUOptimistic", thread_num);
   WSTest(work_dir + "/WS", thread_num);
 
   return 0;
@@ -0,0 +1,195 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "flex/storages/rt_mutable_graph/vector_index.h"
+#include "flex/utils/property/column.h"
+
+#include <glog/logging.h>
+
+namespace gs {
+
+static const size_t kDim = 16;
+static const vid_t kVertexNum = 2000;
+
+static std::vector<float> random_embedding(std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-1.0, 1.0);
+  std::vector<float> embedding(kDim);
+  for (auto& val : embedding) {
+    val = dist(rng);
+  }
+  return embedding;
+}
+
+static std::string to_string(const std::vector<float>& embedding) {
+  std::string str = "[";
+  for (size_t i = 0; i < embedding.size(); ++i) {
+    str += (i == 0 ? "" : ", ") + std::to_string(embedding[i]);
+  }
+  return str + "]";
+}
+
+// The k vertices nearest to the query by a scan of the embeddings.
+static std::vector<vid_t> brute_force(
+    const std::vector<std::vector<float>>& embeddings,
+    const std::vector<float>& query, size_t k) {
+  std::vector<std::pair<float, vid_t>> dists;
+  for (vid_t v = 0; v < embeddings.size(); ++v) {
+    dists.emplace_back(
+        VectorIndex::distance(embeddings[v].data(), query.data(), kDim), v);
+  }
+  std::partial_sort(dists.begin(), dists.begin() + k, dists.end());
+  std::vector<vid_t> ret;
+  for (size_t i = 0; i < k; ++i) {
+    ret.push_back(dists[i].second);
+  }
+  return ret;
+}
+
+static std::vector<VectorIndex::entry_t> search(const VectorIndex& index,
+                                                const std::vector<float>& query,
+                                                size_t k) {
+  std::vector<VectorIndex::entry_t> entries;
+  index.search(query, k, 100, entries);
+  return entries;
+}
+
+// The share of the k nearest vertices of the queries the index finds.
+static double recall(const VectorIndex& index,
+                     const std::vector<std::vector<float>>& embeddings,
+                     const std::vector<std::vector<float>>& queries,
+                     size_t k) {
+  size_t found = 0;
+  for (auto& query : queries) {
+    auto expected = brute_force(embeddings, query, k);
+    std::set<vid_t> expected_set(expected.begin(), expected.end());
+    auto entries = search(index, query, k);
+    CHECK_EQ(entries.size(), k);
+    for (size_t i = 0; i < entries.size(); ++i) {
+      CHECK(i == 0 || entries[i - 1].first <= entries[i].first);
+      found += expected_set.count(entries[i].second);
+    }
+  }
+  return static_cast<double>(found) / (queries.size() * k);
+}
+
+void test_parse() {
+  std::vector<float> embedding;
+  CHECK(VectorIndex::parse("[0.5, -1, 2e1]", embedding));
+  CHECK(embedding == std::vector<float>({0.5, -1, 20}));
+  CHECK(VectorIndex::parse("1 2 3", embedding));
+  CHECK_EQ(embedding.size(), 3);
+  CHECK(!VectorIndex::parse("[1, x]", embedding));
+  CHECK(embedding.empty());
+  CHECK(!VectorIndex::parse("[]", embedding));
+}
+
+void test_vector_index() {
+  std::mt19937 rng(7);
+  std::vector<std::vector<float>> embeddings;
+  VectorIndex index;
+  for (vid_t v = 0; v < kVertexNum; ++v) {
+    embeddings.push_back(random_embedding(rng));
+    index.insert(Any::From(to_string(embeddings.back())), v);
+  }
+  // Neither a value which is not an embedding, nor one of another dimension
+  // is indexed.
+  index.insert(Any::From(std::string("none")), kVertexNum);
+  index.insert(Any::From(std::string("[1, 2]")), kVertexNum);
+  CHECK_EQ(index.dim(), kDim);
+  CHECK_EQ(index.size(), kVertexNum);
+  CHECK_EQ(index.stale_num(), 0);
+  // The embeddings are stored as parsed back from their text.
+  for (auto& embedding : embeddings) {
+    CHECK(VectorIndex::parse(to_string(embedding), embedding));
+  }
+
+  for (vid_t v = 0; v < kVertexNum; v += 97) {
+    auto entries = search(index, embeddings[v], 1);
+    CHECK_EQ(entries.size(), 1);
+    CHECK_EQ(entries[0].second, v);
+    CHECK_EQ(entries[0].first, 0);
+  }
+  CHECK(search(index, std::vector<float>(kDim + 1, 0), 10).empty());
+
+  std::vector<std::vector<float>> queries;
+  for (int i = 0; i < 50; ++i) {
+    queries.push_back(random_embedding(rng));
+  }
+  double index_recall = recall(index, embeddings, queries, 10);
+  LOG(INFO) << "Recall at 10: " << index_recall;
+  CHECK_GE(index_recall, 0.9);
+
+  // The dumped index answers as the one dumped.
+  auto path =
+      std::filesystem::temp_directory_path() / "vector_index_test_dump";
+  index.dump(path.string());
+  VectorIndex opened;
+  CHECK(opened.open(path.string()));
+  CHECK_EQ(opened.dim(), kDim);
+  CHECK_EQ(opened.size(), kVertexNum);
+  CHECK_EQ(opened.stale_num(), 0);
+  for (auto& query : queries) {
+    CHECK(search(opened, query, 10) == search(index, query, 10));
+  }
+  std::filesystem::remove(path);
+  CHECK(!opened.open(path.string()));
+  CHECK_EQ(opened.size(), 0);
+  CHECK(search(opened, queries[0], 10).empty());
+
+  // Updated vertices keep the entries of their old values until a rebuild
+  // from the column, which finds the new ones only.
+  StringColumn column(StorageStrategy::kMem, 1024);
+  column.open_in_memory("vector_index_test_nonexistent");
+  column.resize(kVertexNum);
+  for (vid_t v = 0; v < kVertexNum; ++v) {
+    if (v % 4 == 0) {
+      embeddings[v] = random_embedding(rng);
+      index.insert(Any::From(to_string(embeddings[v])), v);
+      CHECK(VectorIndex::parse(to_string(embeddings[v]), embeddings[v]));
+    }
+    column.set_value(v, to_string(embeddings[v]));
+  }
+  CHECK_EQ(index.stale_num(), kVertexNum / 4);
+  CHECK_EQ(index.size(), kVertexNum + kVertexNum / 4);
+  index.rebuild(column, kVertexNum);
+  CHECK_EQ(index.size(), kVertexNum);
+  CHECK_EQ(index.stale_num(), 0);
+  for (vid_t v = 0; v < kVertexNum; v += 4 * 31) {
+    auto entries = search(index, embeddings[v], 10);
+    CHECK_EQ(entries[0].second, v);
+    CHECK_EQ(entries[0].first, 0);
+    std::set<vid_t> vids;
+    for (auto& entry : entries) {
+      CHECK(vids.insert(entry.second).second);
+    }
+  }
+  CHECK_GE(recall(index, embeddings, queries, 10), 0.9);
+}
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  gs::test_parse();
+  gs::test_vector_index();
+  LOG(INFO) << "vector index test passed";
+  return 0;
+}
@@ -0,0 +1,86 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flex/engines/graph_db/database/version_manager.h"
+
+// Measures the commits per second of sessions that acquire and release
+// insert timestamps in a loop, for 1, 2, 4, ... sessions up to the given
+// maximum, and checks that the read timestamp caught up with every commit.
+//
+// Usage: version_manager_bench [max_session_num] [seconds_per_round]
+
+static double run_round(int session_num, double seconds) {
+  gs::VersionManager vm;
+  vm.init_ts(0, session_num);
+  std::atomic<bool> stop(false);
+  std::vector<size_t> commits(session_num, 0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < session_num; ++i) {
+    threads.emplace_back([&, i]() {
+      size_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        uint32_t ts = vm.acquire_insert_timestamp();
+        vm.release_insert_timestamp(ts);
+        ++count;
+      }
+      commits[i] = count;
+    });
+  }
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000)));
+  stop.store(true);
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  size_t total = 0;
+  for (auto count : commits) {
+    total += count;
+  }
+  uint32_t read_ts = vm.acquire_read_timestamp();
+  vm.release_read_timestamp();
+  CHECK_EQ(read_ts, total) << "read timestamp did not reach the last commit";
+  return total / seconds;
+}
+
+int main(int argc, char** argv) {
+  int max_session_num = std::thread::hardware_concurrency();
+  double seconds = 2;
+  if (argc > 1) {
+    max_session_num = std::stoi(argv[1]);
+  }
+  if (argc > 2) {
+    seconds = std::stod(argv[2]);
+  }
+
+  double base = 0;
+  for (int session_num = 1; session_num <= max_session_num;
+       session_num *= 2) {
+    double tps = run_round(session_num, seconds);
+    if (session_num == 1) {
+      base = tps;
+    }
+    LOG(INFO) << session_num << " sessions: " << static_cast<size_t>(tps)
+              << " commits/s, " << tps / base << "x of one session";
+  }
+  return 0;
+}
@@ -0,0 +1,148 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <filesystem>
+#include <string>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/utils/property/types.h"
+
+// Adds a property to and drops one from a served graph, then checks that the
+// dropped one keeps its place until a compaction, and that a reopen replays
+// the changes and the compaction from the wal.
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label("PERSON",
+                          {
+                              gs::PropertyType::kInt32,       // age
+                              gs::PropertyType::Varchar(16),  // name
+                          },
+                          {"age", "name"},
+                          {std::tuple<gs::PropertyType, std::string, size_t>(
+                              gs::PropertyType::kInt64, "id", 0)},
+                          {}, 4096);
+  return schema;
+}
+
+static void check_evolved(const gs::GraphDB& db, int vertex_num,
+                          bool compacted) {
+  const auto& schema = db.schema();
+  auto label = schema.get_vertex_label_id("PERSON");
+  CHECK(!schema.vertex_has_property("PERSON", "age"));
+  CHECK(schema.vertex_has_property("PERSON", "score"));
+  const auto& names = schema.get_vertex_property_names(label);
+  const auto& table = db.graph().get_vertex_table(label);
+  if (compacted) {
+    CHECK_EQ(names.size(), 2);
+    CHECK_EQ(table.col_num(), 2);
+  } else {
+    // The ids of the others stay as they were until a compaction.
+    CHECK_EQ(names.size(), 3);
+    CHECK_EQ(table.col_num(), 3);
+    CHECK(schema.is_dropped_vertex_property(label, 0));
+    CHECK_EQ(names[0], gs::Schema::dropped_vertex_property_name(0));
+    CHECK(table.get_column_by_id(0)->type() == gs::PropertyType::kEmpty);
+  }
+  size_t first = compacted ? 0 : 1;
+  CHECK_EQ(names[first], "name");
+  CHECK_EQ(names[first + 1], "score");
+  CHECK_EQ(table.get_column_id_by_name("score"), first + 1);
+
+  auto name_col = table.get_column("name");
+  auto score_col = table.get_column("score");
+  CHECK(name_col != nullptr && score_col != nullptr);
+  for (int i = 0; i < vertex_num; ++i) {
+    gs::vid_t vid;
+    CHECK(db.graph().get_lid(label, gs::Any::From<int64_t>(i), vid));
+    CHECK_EQ(name_col->get(vid).AsStringView(), std::to_string(i));
+    // Only the even vertices had their score set.
+    CHECK_EQ(score_col->get(vid).AsInt64(), i % 2 == 0 ? i * 10 : 0);
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  const int vertex_num = 100;
+  std::filesystem::remove_all(work_dir);
+  {
+    gs::GraphDB db;
+    auto schema = person_schema();
+    CHECK(db.Open(schema, work_dir).ok());
+    auto label = schema.get_vertex_label_id("PERSON");
+    {
+      auto txn = db.GetInsertTransaction();
+      for (int i = 0; i < vertex_num; ++i) {
+        CHECK(txn.AddVertex(
+            label, gs::Any::From<int64_t>(i),
+            {gs::Any::From<int32_t>(i), gs::Any::From(std::to_string(i))}));
+      }
+      CHECK(txn.Commit());
+    }
+
+    auto& session = db.GetSession(0);
+    CHECK(session.AddVertexProperty("PERSON", "score", gs::PropertyType::kInt64)
+              .ok());
+    CHECK_EQ(
+        session.AddVertexProperty("PERSON", "score", gs::PropertyType::kInt64)
+            .error_code(),
+        gs::StatusCode::ALREADY_EXISTS);
+    CHECK_EQ(session.DropVertexProperty("PERSON", "id").error_code(),
+             gs::StatusCode::INVALID_ARGUMENT);
+    CHECK_EQ(session.DropVertexProperty("PERSON", "none").error_code(),
+             gs::StatusCode::NOT_FOUND);
+    {
+      auto txn = db.GetUpdateTransaction();
+      int col_id = db.graph().get_vertex_table(label).get_column_id_by_name(
+          "score");
+      CHECK_GE(col_id, 0);
+      for (int i = 0; i < vertex_num; i += 2) {
+        gs::vid_t vid;
+        CHECK(db.graph().get_lid(label, gs::Any::From<int64_t>(i), vid));
+        CHECK(txn.SetVertexField(label, vid, col_id,
+                                 gs::Any::From<int64_t>(i * 10)));
+      }
+      CHECK(txn.Commit());
+    }
+    CHECK(session.DropVertexProperty("PERSON", "age").ok());
+    CHECK_EQ(session.DropVertexProperty("PERSON", "age").error_code(),
+             gs::StatusCode::NOT_FOUND);
+    {
+      // The values of the properties left are enough to insert.
+      auto txn = db.GetInsertTransaction();
+      CHECK(txn.AddVertex(label, gs::Any::From<int64_t>(vertex_num),
+                          {gs::Any::From(std::to_string(vertex_num)),
+                           gs::Any::From<int64_t>(vertex_num * 10)}));
+      CHECK(txn.Commit());
+    }
+    check_evolved(db, vertex_num + 1, false);
+    CHECK(session.GetCompactTransaction().Commit());
+    check_evolved(db, vertex_num + 1, true);
+    LOG(INFO) << "Evolved the schema of the served graph";
+  }
+  {
+    // Opened from the schema the graph was created with, as it was never
+    // dumped.
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), work_dir).ok());
+    check_evolved(db, vertex_num + 1, true);
+    LOG(INFO) << "Replayed the schema changes from the wal";
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
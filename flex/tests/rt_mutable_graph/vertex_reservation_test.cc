@@ -0,0 +1,145 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/utils/property/types.h"
+
+// Inserts vertices into a served graph well past its capacity when opened, up
+// to the max_vertex_num of their label, which holds from concurrent sessions,
+// then checks that a reopen replays the vertices and holds at it as well.
+
+static const int64_t kMaxVertexNum = 20500;
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label("PERSON", {gs::PropertyType::Varchar(16)}, {"name"},
+                          {std::tuple<gs::PropertyType, std::string, size_t>(
+                              gs::PropertyType::kInt64, "id", 0)},
+                          {}, kMaxVertexNum);
+  schema.add_edge_label("PERSON", "PERSON", "KNOWS", {gs::PropertyType::kInt64},
+                        {"since"}, gs::EdgeStrategy::kMultiple,
+                        gs::EdgeStrategy::kMultiple);
+  return schema;
+}
+
+static std::vector<gs::Any> props_of(int64_t id) {
+  return {gs::Any::From(std::to_string(id))};
+}
+
+static bool insert_range(gs::GraphDB& db, int64_t begin, int64_t end) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  auto txn = db.GetInsertTransaction();
+  for (int64_t i = begin; i < end; ++i) {
+    CHECK(txn.AddVertex(label, gs::Any::From(i), props_of(i)));
+  }
+  return txn.Commit();
+}
+
+static void check_vertices(const gs::GraphDB& db,
+                           const std::vector<int64_t>& ids) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  CHECK_EQ(db.graph().vertex_num(label), ids.size());
+  auto name_col = db.graph().get_vertex_table(label).get_column("name");
+  for (auto id : ids) {
+    gs::vid_t vid;
+    CHECK(db.graph().get_lid(label, gs::Any::From(id), vid));
+    CHECK_EQ(name_col->get(vid).AsStringView(), std::to_string(id));
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  const int thread_num = 4;
+  std::filesystem::remove_all(work_dir);
+  std::vector<int64_t> ids;
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), work_dir, thread_num).ok());
+    auto label = db.schema().get_vertex_label_id("PERSON");
+    auto knows = db.schema().get_edge_label_id("KNOWS");
+    // The label is opened with room for 4096 vertices and grows in place up
+    // to its max_vertex_num.
+    int64_t vertex_num = 0;
+    while (insert_range(db, vertex_num, vertex_num + 1000)) {
+      vertex_num += 1000;
+      CHECK_EQ(db.graph().vertex_num(label), vertex_num);
+    }
+    CHECK_EQ(vertex_num, kMaxVertexNum / 1000 * 1000);
+    CHECK_EQ(db.graph().vertex_num(label), vertex_num);
+    for (int64_t i = 0; i < vertex_num; ++i) {
+      ids.push_back(i);
+    }
+
+    // Concurrent sessions fill the rest with single vertex inserts, an edge
+    // each, and none gets past the reservation.
+    std::atomic<int64_t> next(vertex_num);
+    std::vector<std::vector<int64_t>> inserted(thread_num);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+      threads.emplace_back([&, t]() {
+        while (true) {
+          int64_t id = next.fetch_add(1);
+          auto txn = db.GetSingleVertexInsertTransaction(t);
+          CHECK(txn.AddVertex(label, gs::Any::From(id), props_of(id)));
+          CHECK(txn.AddEdge(label, gs::Any::From(id), label,
+                            gs::Any::From<int64_t>(0), knows,
+                            gs::Any::From(id)));
+          if (!txn.Commit()) {
+            break;
+          }
+          inserted[t].push_back(id);
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+    for (auto& vec : inserted) {
+      ids.insert(ids.end(), vec.begin(), vec.end());
+    }
+    int64_t reserved = db.graph().vertex_num(label);
+    CHECK_EQ(reserved, static_cast<int64_t>(ids.size()));
+    CHECK_EQ(reserved, kMaxVertexNum);
+    CHECK_EQ(db.graph().get_incoming_edges(label, 0, label, knows)->size(),
+             static_cast<size_t>(reserved - vertex_num));
+
+    {
+      auto txn = db.GetUpdateTransaction();
+      CHECK(txn.AddVertex(label, gs::Any::From<int64_t>(-1), props_of(-1)));
+      CHECK(!txn.Commit());
+    }
+    CHECK(!insert_range(db, -2, -1));
+    check_vertices(db, ids);
+    LOG(INFO) << "Inserted up to the reservation of " << reserved;
+  }
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), work_dir, thread_num).ok());
+    check_vertices(db, ids);
+    CHECK(!insert_range(db, -2, -1));
+    check_vertices(db, ids);
+    LOG(INFO) << "Replayed the vertices up to the reservation";
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
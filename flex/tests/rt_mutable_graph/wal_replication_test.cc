@@ -0,0 +1,167 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "flex/engines/graph_db/database/graph_db.h"
+#include "flex/engines/graph_db/database/graph_db_session.h"
+#include "flex/utils/property/types.h"
+
+// Replicates the inserts and updates of a primary to a follower opened on a
+// copy of its data directory, checks that the follower takes no writes of
+// its own and reports no lag once caught up, however many heartbeats it
+// received, and that a reopen of the follower replays what it applied.
+//
+// Usage: wal_replication_test work_dir [port]
+
+static gs::Schema person_schema() {
+  gs::Schema schema;
+  schema.add_vertex_label("PERSON", {gs::PropertyType::kInt64}, {"age"},
+                          {std::tuple<gs::PropertyType, std::string, size_t>(
+                              gs::PropertyType::kInt64, "id", 0)},
+                          {});
+  return schema;
+}
+
+static void insert_range(gs::GraphDB& db, int64_t begin, int64_t end) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  auto txn = db.GetInsertTransaction();
+  for (int64_t i = begin; i < end; ++i) {
+    CHECK(txn.AddVertex(label, gs::Any::From(i), {gs::Any::From(i)}));
+  }
+  CHECK(txn.Commit());
+}
+
+static uint32_t read_ts(gs::GraphDB& db) {
+  return db.GetReadTransaction().timestamp();
+}
+
+static void check_ages(const gs::GraphDB& db, int64_t vertex_num,
+                       int64_t updated_num) {
+  auto label = db.schema().get_vertex_label_id("PERSON");
+  CHECK_EQ(db.graph().vertex_num(label), vertex_num);
+  auto age_col = db.graph().get_vertex_table(label).get_column("age");
+  for (int64_t i = 0; i < vertex_num; ++i) {
+    gs::vid_t vid;
+    CHECK(db.graph().get_lid(label, gs::Any::From(i), vid));
+    CHECK_EQ(age_col->get(vid).AsInt64(), i < updated_num ? -i : i);
+  }
+}
+
+static void wait_caught_up(gs::GraphDB& follower, uint32_t ts) {
+  for (int i = 0; i < 1000; ++i) {
+    auto status = follower.GetReplicationStatus();
+    if (status.applied_ts >= ts) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  LOG(FATAL) << "Follower did not apply " << ts;
+}
+
+template <typename FUNC_T>
+static void check_rejected(const FUNC_T& func) {
+  bool rejected = false;
+  try {
+    func();
+  } catch (const std::runtime_error&) {
+    rejected = true;
+  }
+  CHECK(rejected) << "A follower took a write";
+}
+
+int main(int argc, char** argv) {
+  std::string work_dir = argv[1];
+  uint32_t port = argc > 2 ? std::stoi(argv[2]) : 20000 + getpid() % 20000;
+  std::string primary_dir = work_dir + "/primary";
+  std::string follower_dir = work_dir + "/follower";
+  std::filesystem::remove_all(work_dir);
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), primary_dir).ok());
+    insert_range(db, 0, 100);
+  }
+  std::filesystem::copy(primary_dir, follower_dir,
+                        std::filesystem::copy_options::recursive);
+
+  {
+    gs::GraphDB primary;
+    gs::GraphDBConfig primary_config(person_schema(), primary_dir, "", 2);
+    primary_config.replication_port = port;
+    CHECK(primary.Open(primary_config).ok());
+
+    gs::GraphDB follower;
+    gs::GraphDBConfig follower_config(person_schema(), follower_dir, "", 2);
+    follower_config.replication_primary = "127.0.0.1:" + std::to_string(port);
+    CHECK(follower.Open(follower_config).ok());
+    check_ages(follower, 100, 0);
+
+    insert_range(primary, 100, 1000);
+    {
+      auto label = primary.schema().get_vertex_label_id("PERSON");
+      auto txn = primary.GetUpdateTransaction();
+      for (int64_t i = 0; i < 500; ++i) {
+        gs::vid_t vid;
+        CHECK(primary.graph().get_lid(label, gs::Any::From(i), vid));
+        CHECK(txn.SetVertexField(label, vid, 0, gs::Any::From(-i)));
+      }
+      CHECK(txn.Commit());
+    }
+    wait_caught_up(follower, read_ts(primary));
+    check_ages(follower, 1000, 500);
+    CHECK_EQ(read_ts(follower), read_ts(primary));
+
+    // Heartbeats keep coming while nothing is written, and leave a caught up
+    // follower without lag.
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+        gs::WalShipper::HEARTBEAT_INTERVAL_MS * 3));
+    auto status = follower.GetReplicationStatus();
+    CHECK_EQ(status.role, "follower");
+    CHECK_EQ(status.connection_num, 1);
+    CHECK_EQ(status.primary_ts, status.applied_ts);
+    CHECK_EQ(status.lag_seconds, 0);
+
+    // The timestamps of the follower are those of its primary alone.
+    check_rejected([&]() { follower.GetInsertTransaction(); });
+    check_rejected([&]() { follower.GetSingleVertexInsertTransaction(); });
+    check_rejected([&]() { follower.GetSingleEdgeInsertTransaction(); });
+    check_rejected([&]() { follower.GetUpdateTransaction(); });
+    check_rejected([&]() { follower.GetSession(0).GetCompactTransaction(); });
+    check_rejected(
+        [&]() { follower.GetSession(1).GetPropertyUpdateTransaction(); });
+
+    insert_range(primary, 1000, 2000);
+    wait_caught_up(follower, read_ts(primary));
+    check_ages(follower, 2000, 500);
+  }
+
+  // The follower logged what it applied apart from its sessions, and
+  // replays it when opened on its own.
+  {
+    gs::GraphDB db;
+    CHECK(db.Open(person_schema(), follower_dir, 2).ok());
+    check_ages(db, 2000, 500);
+    insert_range(db, 2000, 2100);
+    check_ages(db, 2100, 500);
+  }
+  std::filesystem::remove_all(work_dir);
+  return 0;
+}
@@ -18,16 +18,26 @@
 
 #include <stdlib.h>
 
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "flex/utils/epoch_manager.h"
 #include "flex/utils/mmap_array.h"
 
 namespace gs {
 
 class ArenaAllocator {
   static constexpr size_t batch_size = 16 * 1024 * 1024;
+  // allocate_sized() rounds requests below batch_size / 2 up to a power of
+  // two no less than min_class_size, so that retired buffers can be reused by
+  // later requests of the same class.
+  static constexpr size_t min_class_size = 64;
+  static constexpr int class_num = 17;
 
  public:
   ArenaAllocator(MemoryStrategy strategy, const std::string& prefix)
@@ -36,7 +46,9 @@ class ArenaAllocator {
         cur_loc_(0),
         cur_size_(0),
         allocated_memory_(0),
-        allocated_batches_(0) {
+        allocated_batches_(0),
+        free_memory_(0),
+        epoch_manager_(nullptr) {
     if (strategy_ != MemoryStrategy::kSyncToFile) {
       prefix_.clear();
     }
@@ -74,9 +86,130 @@ class ArenaAllocator {
     }
   }
 
+  // Readers of buffers passed to retire() must be pinned on this epoch
+  // manager. Without one, retired buffers are simply dropped.
+  void set_epoch_manager(EpochManager* epoch_manager) {
+    epoch_manager_ = epoch_manager;
+  }
+
+  static size_t size_class(size_t size) {
+    if (size >= batch_size / 2) {
+      return size;
+    }
+    size_t ret = min_class_size;
+    while (ret < size) {
+      ret <<= 1;
+    }
+    return ret;
+  }
+
+  // Allocate at least `size` bytes, the usable size is size_class(size).
+  void* allocate_sized(size_t size) {
+    size = size_class(size);
+    int idx = class_index(size);
+    reclaim();
+    if (idx >= 0) {
+      auto& free_list = free_lists_[idx];
+      if (!free_list.empty()) {
+        void* ret = free_list.back();
+        free_list.pop_back();
+        free_memory_ -= size;
+        return ret;
+      }
+    }
+    return allocate(size);
+  }
+
+  // Hand a buffer obtained from allocate_sized() back to the allocator once
+  // the writer has unpublished it. It is reused after all readers that might
+  // still see it have finished. Buffers from other allocators are ignored.
+  // Buffers too large for a size class have a batch of their own, which is
+  // not reused but has its memory released to the system instead.
+  void retire(void* ptr, size_t size) {
+    if (epoch_manager_ == nullptr || ptr == nullptr) {
+      return;
+    }
+    int idx = class_index(size_class(size));
+    if (idx < 0) {
+      if (size < batch_size / 2 || !prefix_.empty()) {
+        return;
+      }
+      auto iter = batch_ranges_.find(static_cast<char*>(ptr));
+      if (iter == batch_ranges_.end() || iter->second < size) {
+        return;
+      }
+      size = iter->second;
+    } else if (!owns(ptr)) {
+      return;
+    }
+    // The store that unpublished `ptr` must be visible before the epoch is
+    // sampled.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    retired_.push_back({epoch_manager_->current(), idx, ptr, size});
+  }
+
   size_t allocated_memory() const { return allocated_memory_; }
 
+  // Bytes sitting in the free lists, waiting to be reused.
+  size_t free_memory() const { return free_memory_; }
+
+  // Bytes of the batches mapped so far and how many of them are resident.
+  // Unlike the accessors above, it may be called from other threads.
+  MemoryUsage memory_usage() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    MemoryUsage ret;
+    for (auto buf : mmap_buffers_) {
+      ret += buf->memory_usage();
+    }
+    return ret;
+  }
+
  private:
+  struct RetiredBuffer {
+    uint64_t epoch;
+    int class_idx;
+    void* ptr;
+    size_t size;
+  };
+
+  static int class_index(size_t size) {
+    if (size < min_class_size || size >= batch_size / 2 ||
+        (size & (size - 1)) != 0) {
+      return -1;
+    }
+    return __builtin_ctzll(size) - __builtin_ctzll(min_class_size);
+  }
+
+  void reclaim() {
+    if (retired_.empty()) {
+      return;
+    }
+    uint64_t cur = epoch_manager_->try_advance();
+    while (!retired_.empty() &&
+           EpochManager::reclaimable(retired_.front().epoch, cur)) {
+      auto& buf = retired_.front();
+      if (buf.class_idx < 0) {
+        if (madvise(buf.ptr, buf.size, MADV_DONTNEED) != 0) {
+          VLOG(10) << "Failed to release " << buf.size << " bytes, "
+                   << strerror(errno);
+        }
+      } else {
+        free_lists_[buf.class_idx].push_back(buf.ptr);
+        free_memory_ += min_class_size << buf.class_idx;
+      }
+      retired_.pop_front();
+    }
+  }
+
+  bool owns(void* ptr) const {
+    auto iter = batch_ranges_.upper_bound(static_cast<char*>(ptr));
+    if (iter == batch_ranges_.begin()) {
+      return false;
+    }
+    --iter;
+    return static_cast<char*>(ptr) < iter->first + iter->second;
+  }
+
   void* allocate_batch(size_t size) {
     allocated_batches_ += size;
     if (prefix_.empty()) {
@@ -87,13 +220,21 @@ class ArenaAllocator {
         buf->open("", false);
       }
       buf->resize(size);
-      mmap_buffers_.push_back(buf);
+      {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        mmap_buffers_.push_back(buf);
+      }
+      batch_ranges_.emplace(buf->data(), size);
       return static_cast<void*>(buf->data());
     } else {
       mmap_array<char>* buf = new mmap_array<char>();
       buf->open(prefix_ + std::to_string(mmap_buffers_.size()), true);
       buf->resize(size);
-      mmap_buffers_.push_back(buf);
+      {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        mmap_buffers_.push_back(buf);
+      }
+      batch_ranges_.emplace(buf->data(), size);
       return static_cast<void*>(buf->data());
     }
   }
@@ -101,6 +242,8 @@ class ArenaAllocator {
   MemoryStrategy strategy_;
   std::string prefix_;
   std::vector<mmap_array<char>*> mmap_buffers_;
+  // Guards mmap_buffers_ against memory_usage() from other threads.
+  mutable std::mutex buffers_mutex_;
 
   void* cur_buffer_;
   size_t cur_loc_;
@@ -108,6 +251,12 @@ class ArenaAllocator {
 
   size_t allocated_memory_;
   size_t allocated_batches_;
+
+  std::map<char*, size_t> batch_ranges_;
+  std::vector<void*> free_lists_[class_num];
+  std::deque<RetiredBuffer> retired_;
+  size_t free_memory_;
+  EpochManager* epoch_manager_;
 };
 
 using Allocator = ArenaAllocator;
@@ -16,6 +16,7 @@
 #ifndef GRAPHSCOPE_APP_UTILS_H_
 #define GRAPHSCOPE_APP_UTILS_H_
 
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -98,6 +99,16 @@ class Decoder {
   const char* end_;
 };
 
+// The tail of the output of a query, produced piece by piece while it is
+// sent, e.g. the rows of a large result, so that it is never held whole.
+class ResultStream {
+ public:
+  virtual ~ResultStream() = default;
+
+  // Appends the next piece to out. Returns false once there is none left.
+  virtual bool Next(std::vector<char>& out) = 0;
+};
+
 }  // namespace gs
 
 #endif  // GRAPHSCOPE_APP_UTILS_H_
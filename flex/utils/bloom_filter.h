@@ -0,0 +1,125 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_BLOOM_FILTER_H_
+#define GRAPHSCOPE_UTILS_BLOOM_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace gs {
+
+// A Bloom filter whose keys each set kHashNum bits within one 64-byte block,
+// so that a lookup touches a single cache line. With kBitsPerKey bits per
+// expected key the false positive rate is about 1%, and it grows once more
+// keys than expected are inserted. insert() may run concurrently with other
+// insertions and with lookups; init() and clear() must not.
+class BlockedBloomFilter {
+ public:
+  static constexpr size_t kBitsPerKey = 10;
+  static constexpr int kHashNum = 6;
+
+  BlockedBloomFilter() : block_num_(0), capacity_(0), key_num_(0) {}
+
+  void init(size_t expected_key_num) {
+    capacity_ = std::max<size_t>(expected_key_num, kBlockBits);
+    block_num_ = (capacity_ * kBitsPerKey + kBlockBits - 1) / kBlockBits;
+    blocks_.reset(new Block[block_num_]);
+    clear();
+  }
+
+  void clear() {
+    for (size_t i = 0; i < block_num_; ++i) {
+      for (auto& word : blocks_[i].words) {
+        word.store(0, std::memory_order_relaxed);
+      }
+    }
+    key_num_.store(0, std::memory_order_relaxed);
+  }
+
+  inline void insert(uint64_t key) {
+    uint64_t h = mix(key);
+    Block& block = blocks_[block_of(h)];
+    h = mix(h + kSeed);
+    for (int i = 0; i < kHashNum; ++i) {
+      uint32_t bit = (h >> (i * 9)) & (kBlockBits - 1);
+      uint64_t mask = static_cast<uint64_t>(1) << (bit & 63);
+      auto& word = block.words[bit >> 6];
+      if ((word.load(std::memory_order_relaxed) & mask) == 0) {
+        word.fetch_or(mask, std::memory_order_relaxed);
+      }
+    }
+    key_num_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns false only if the key was never inserted.
+  inline bool may_contain(uint64_t key) const {
+    uint64_t h = mix(key);
+    const Block& block = blocks_[block_of(h)];
+    h = mix(h + kSeed);
+    for (int i = 0; i < kHashNum; ++i) {
+      uint32_t bit = (h >> (i * 9)) & (kBlockBits - 1);
+      uint64_t mask = static_cast<uint64_t>(1) << (bit & 63);
+      if ((block.words[bit >> 6].load(std::memory_order_relaxed) & mask) ==
+          0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool initialized() const { return block_num_ != 0; }
+
+  // Number of keys the filter was sized for.
+  size_t capacity() const { return capacity_; }
+
+  // Number of insertions, counting repeated keys.
+  size_t key_num() const { return key_num_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint32_t kBlockBits = 512;
+  static constexpr uint64_t kSeed = 0x9e3779b97f4a7c15ULL;
+
+  struct alignas(64) Block {
+    std::atomic<uint64_t> words[kBlockBits / 64];
+  };
+
+  static inline uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  // Maps the high half of the hash onto [0, block_num_) without a division.
+  inline size_t block_of(uint64_t h) const {
+    return static_cast<size_t>(((h >> 32) * block_num_) >> 32);
+  }
+
+  std::unique_ptr<Block[]> blocks_;
+  size_t block_num_;
+  size_t capacity_;
+  std::atomic<size_t> key_num_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_BLOOM_FILTER_H_
@@ -0,0 +1,81 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_EPOCH_MANAGER_H_
+#define GRAPHSCOPE_UTILS_EPOCH_MANAGER_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace gs {
+
+// A minimal epoch based reclamation scheme. Readers pin the global epoch
+// before touching shared memory and unpin it when they are done. Memory
+// retired in epoch e can be reused once the global epoch reaches e + 2, since
+// by then every reader that could still hold a reference has unpinned.
+class EpochManager {
+ public:
+  EpochManager() : epoch_(2) {
+    for (auto& cnt : readers_) {
+      cnt.store(0);
+    }
+  }
+  ~EpochManager() = default;
+
+  uint64_t pin() {
+    while (true) {
+      uint64_t e = epoch_.load();
+      readers_[e % 3].fetch_add(1);
+      if (epoch_.load() == e) {
+        return e;
+      }
+      readers_[e % 3].fetch_sub(1);
+    }
+  }
+
+  void unpin(uint64_t e) { readers_[e % 3].fetch_sub(1); }
+
+  uint64_t current() const { return epoch_.load(); }
+
+  // Advance the global epoch if no reader is left in the previous one.
+  // Returns the current epoch after the attempt.
+  uint64_t try_advance() {
+    uint64_t e = epoch_.load();
+    if (readers_[(e - 1) % 3].load() == 0) {
+      epoch_.compare_exchange_strong(e, e + 1);
+      return epoch_.load();
+    }
+    return e;
+  }
+
+  static bool reclaimable(uint64_t retired_epoch, uint64_t cur_epoch) {
+    return retired_epoch + 2 <= cur_epoch;
+  }
+
+  void clear() {
+    epoch_.store(2);
+    for (auto& cnt : readers_) {
+      cnt.store(0);
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> epoch_;
+  std::atomic<int> readers_[3];
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_EPOCH_MANAGER_H_
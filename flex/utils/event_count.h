@@ -0,0 +1,94 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_EVENT_COUNT_H_
+#define GRAPHSCOPE_UTILS_EVENT_COUNT_H_
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+namespace gs {
+
+// Lets threads sleep until a condition on other atomics becomes true, without
+// a lock on the path that makes it true. A waiter takes a key, checks the
+// condition and sleeps on a futex only if the epoch still equals the key; a
+// notifier changes the state, bumps the epoch and issues the wake-up syscall
+// only if someone is registered as waiting, so notifying is a couple of
+// atomic operations when nobody waits.
+class EventCount {
+ public:
+  static constexpr int SPIN_NUM = 128;
+
+  EventCount() : epoch_(0), waiters_(0) {}
+  ~EventCount() = default;
+
+  // Returns once pred() is true, spinning SPIN_NUM rounds before sleeping.
+  template <typename PRED_T>
+  void await(const PRED_T& pred) {
+    for (int i = 0; i < SPIN_NUM; ++i) {
+      if (pred()) {
+        return;
+      }
+      cpu_relax();
+    }
+    while (true) {
+      waiters_.fetch_add(1);
+      uint32_t key = epoch_.load();
+      if (pred()) {
+        waiters_.fetch_sub(1);
+        return;
+      }
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+              FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+      waiters_.fetch_sub(1);
+    }
+  }
+
+  // To be called after the change that may make the waited conditions true.
+  void notify_all() {
+    epoch_.fetch_add(1);
+    if (waiters_.load() != 0) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+              FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+  }
+
+ private:
+  static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "the futex word must be a plain 32-bit integer");
+
+  std::atomic<uint32_t> epoch_;
+  std::atomic<uint32_t> waiters_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_EVENT_COUNT_H_
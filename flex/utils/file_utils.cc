@@ -15,6 +15,12 @@
 
 #include "flex/utils/file_utils.h"
 
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+
 namespace gs {
 
 bool read_string_from_file(const std::string& file_path, std::string& content) {
@@ -42,4 +48,63 @@ bool write_string_to_file(const std::string& content,
   return true;
 }
 
+static constexpr uint64_t kChecksumPrime1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t kChecksumPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+static inline uint64_t checksum_mix(uint64_t h, uint64_t word) {
+  h ^= word * kChecksumPrime2;
+  h = (h << 31) | (h >> 33);
+  return h * kChecksumPrime1;
+}
+
+bool checksum_file(const std::string& file_path, uint64_t& checksum) {
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    LOG(ERROR) << "Error: Could not open the file " << file_path << ", "
+               << strerror(errno);
+    return false;
+  }
+  constexpr size_t kBlockSize = 4 << 20;
+  std::unique_ptr<char[]> buf(new char[kBlockSize]);
+  uint64_t h = kChecksumPrime1;
+  uint64_t total = 0;
+  while (true) {
+    // Fills the whole block unless the end of file is reached, so that only
+    // the last block may end with a partial word.
+    size_t len = 0;
+    while (len < kBlockSize) {
+      ssize_t got = read(fd, buf.get() + len, kBlockSize - len);
+      if (got < 0) {
+        LOG(ERROR) << "Error: Failed to read the file " << file_path << ", "
+                   << strerror(errno);
+        close(fd);
+        return false;
+      }
+      if (got == 0) {
+        break;
+      }
+      len += static_cast<size_t>(got);
+    }
+    if (len == 0) {
+      break;
+    }
+    size_t words = len / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i) {
+      uint64_t word;
+      memcpy(&word, buf.get() + i * sizeof(uint64_t), sizeof(uint64_t));
+      h = checksum_mix(h, word);
+    }
+    if (len % sizeof(uint64_t) != 0) {
+      uint64_t word = 0;
+      memcpy(&word, buf.get() + words * sizeof(uint64_t),
+             len % sizeof(uint64_t));
+      h = checksum_mix(h, word);
+    }
+    total += len;
+  }
+  close(fd);
+  checksum = checksum_mix(h, total);
+  return true;
+}
+
 }  // namespace gs
@@ -16,6 +16,8 @@
 #ifndef UTILS_FILE_UTILS_H_
 #define UTILS_FILE_UTILS_H_
 
+#include <stdint.h>
+
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -30,6 +32,11 @@ bool read_string_from_file(const std::string& file_path, std::string& content);
 bool write_string_to_file(const std::string& content,
                           const std::string& file_path);
 
+// Computes a 64-bit checksum of the file content, reading it in large blocks
+// and mixing eight bytes at a time. It detects changes of content, it is not
+// meant to resist deliberate collisions.
+bool checksum_file(const std::string& file_path, uint64_t& checksum);
+
 }  // namespace gs
 
 #endif  // UTILS_FILE_UTILS_H_
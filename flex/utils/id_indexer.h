@@ -16,15 +16,24 @@ limitations under the License.
 #ifndef GRAPHSCOPE_GRAPH_ID_INDEXER_H_
 #define GRAPHSCOPE_GRAPH_ID_INDEXER_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string_view>
 #include <thread>
 #include <type_traits>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "flat_hash_map/flat_hash_map.hpp"
 #include "flex/utils/mmap_array.h"
 #include "flex/utils/property/column.h"
@@ -102,6 +111,8 @@ struct KeyBuffer<std::string> {
   }
 };
 
+// The strings are written as one buffer of their bytes followed by the
+// offsets into it, and appended back to the pages of the vector on reading.
 template <>
 struct KeyBuffer<std::string_view> {
   using type = StringViewVector;
@@ -109,37 +120,198 @@ struct KeyBuffer<std::string_view> {
   template <typename IOADAPTOR_T>
   static void serialize(std::unique_ptr<IOADAPTOR_T>& writer,
                         const type& buffer) {
-    size_t content_buffer_size = buffer.content_buffer().size();
+    std::vector<char> content;
+    std::vector<size_t> offsets;
+    content.reserve(buffer.content_size());
+    offsets.reserve(buffer.size() + 1);
+    offsets.push_back(0);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      std::string_view val = buffer[i];
+      content.insert(content.end(), val.begin(), val.end());
+      offsets.push_back(content.size());
+    }
+    size_t content_buffer_size = content.size();
     CHECK(writer->Write(&content_buffer_size, sizeof(size_t)));
     if (content_buffer_size > 0) {
-      CHECK(writer->Write(buffer.content_buffer().data(),
-                          content_buffer_size * sizeof(char)));
+      CHECK(writer->Write(content.data(), content_buffer_size * sizeof(char)));
     }
-    size_t offset_buffer_size = buffer.offset_buffer().size();
+    size_t offset_buffer_size = offsets.size();
     CHECK(writer->Write(&offset_buffer_size, sizeof(size_t)));
-    if (offset_buffer_size > 0) {
-      CHECK(writer->Write(buffer.offset_buffer().data(),
-                          offset_buffer_size * sizeof(size_t)));
-    }
+    CHECK(writer->Write(offsets.data(), offset_buffer_size * sizeof(size_t)));
   }
 
   template <typename IOADAPTOR_T>
   static void deserialize(std::unique_ptr<IOADAPTOR_T>& reader, type& buffer) {
+    std::vector<char> content;
+    std::vector<size_t> offsets;
     size_t content_buffer_size;
     CHECK(reader->Read(&content_buffer_size, sizeof(size_t)));
     if (content_buffer_size > 0) {
-      buffer.content_buffer().resize(content_buffer_size);
-      CHECK(reader->Read(buffer.content_buffer().data(),
-                         content_buffer_size * sizeof(char)));
+      content.resize(content_buffer_size);
+      CHECK(reader->Read(content.data(), content_buffer_size * sizeof(char)));
     }
     size_t offset_buffer_size;
     CHECK(reader->Read(&offset_buffer_size, sizeof(size_t)));
     if (offset_buffer_size > 0) {
-      buffer.offset_buffer().resize(offset_buffer_size);
-      CHECK(reader->Read(buffer.offset_buffer().data(),
-                         offset_buffer_size * sizeof(size_t)));
+      offsets.resize(offset_buffer_size);
+      CHECK(reader->Read(offsets.data(), offset_buffer_size * sizeof(size_t)));
+    }
+    buffer.clear();
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      buffer.push_back(std::string_view(content.data() + offsets[i - 1],
+                                        offsets[i] - offsets[i - 1]));
+    }
+  }
+};
+
+// The fingerprint of a hash in a BucketTable, from bits other than those
+// picking the slot, with the high bit set to tell it from an empty slot.
+inline uint8_t fingerprint(size_t hash) {
+  return static_cast<uint8_t>(
+      0x80 | ((static_cast<uint64_t>(hash) * UINT64_C(0x9e3779b97f4a7c15)) >>
+              57));
+}
+
+// The slots of a linear probing hash table of indices, laid out in buckets
+// of a cache line each. A bucket keeps a fingerprint byte per slot before
+// the indices of its slots, and a probe compares the fingerprints of a
+// bucket all at once, by SSE2 where available, so that the keys are only
+// read on fingerprint hits and a hit usually costs a single cache miss in
+// the table. Slot k is slot k % kSlotNum of bucket k / kSlotNum, so the
+// table probes the slots in the order of a flat array of the same size,
+// which is what is dumped as the .indices file.
+//
+// Insert is lock-free: a slot is taken by a CAS of its index, and then its
+// fingerprint is set. A probe reaching a slot without a fingerprint checks
+// its index, as the insert of it may be in flight.
+template <typename INDEX_T>
+class BucketTable {
+ public:
+  static constexpr INDEX_T kSentinel = std::numeric_limits<INDEX_T>::max();
+  // At most 16 slots, of which the fingerprints fit a SSE register.
+  static constexpr size_t kSlotNum =
+      std::min<size_t>(64 / (sizeof(INDEX_T) + 1), 16);
+
+  struct alignas(64) Bucket {
+    uint8_t fingerprints[64 - kSlotNum * sizeof(INDEX_T)];
+    INDEX_T indices[kSlotNum];
+  };
+  static_assert(sizeof(Bucket) == 64, "a bucket is a cache line");
+
+  BucketTable() : slot_num_(0) {}
+  BucketTable(BucketTable&& rhs) : BucketTable() { swap(rhs); }
+
+  void set_hugepage_prefered(bool val) { buckets_.set_hugepage_prefered(val); }
+
+  // Makes the table slot_num empty slots.
+  void resize(size_t slot_num) {
+    slot_num_ = slot_num;
+    buckets_.resize((slot_num + kSlotNum - 1) / kSlotNum);
+    for (size_t b = 0; b < buckets_.size(); ++b) {
+      Bucket& bucket = buckets_[b];
+      memset(bucket.fingerprints, 0, sizeof(bucket.fingerprints));
+      std::fill(bucket.indices, bucket.indices + kSlotNum, kSentinel);
+    }
+  }
+
+  void reset() {
+    buckets_.reset();
+    slot_num_ = 0;
+  }
+
+  void swap(BucketTable& rhs) {
+    buckets_.swap(rhs.buckets_);
+    std::swap(slot_num_, rhs.slot_num_);
+  }
+
+  size_t slot_num() const { return slot_num_; }
+
+  INDEX_T get(size_t k) const {
+    return __atomic_load_n(&buckets_[k / kSlotNum].indices[k % kSlotNum],
+                           __ATOMIC_ACQUIRE);
+  }
+
+  uint8_t get_fingerprint(size_t k) const {
+    return buckets_[k / kSlotNum].fingerprints[k % kSlotNum];
+  }
+
+  // Puts ind in slot k, not concurrently with the other operations.
+  void set(size_t k, INDEX_T ind, uint8_t fp) {
+    Bucket& bucket = buckets_[k / kSlotNum];
+    bucket.indices[k % kSlotNum] = ind;
+    bucket.fingerprints[k % kSlotNum] = fp;
+  }
+
+  void prefetch(size_t k) const {
+    __builtin_prefetch(&buckets_[k / kSlotNum]);
+  }
+
+  // Puts ind in the first free slot from home.
+  void insert(size_t home, uint8_t fp, INDEX_T ind) {
+    size_t k = home;
+    while (true) {
+      Bucket& bucket = buckets_[k / kSlotNum];
+      size_t o = k % kSlotNum;
+      if (__sync_bool_compare_and_swap(&bucket.indices[o], kSentinel, ind)) {
+        __atomic_store_n(&bucket.fingerprints[o], fp, __ATOMIC_RELEASE);
+        return;
+      }
+      k = (k + 1 == slot_num_) ? 0 : k + 1;
+    }
+  }
+
+  // Returns the first index from home of which eq holds, probing the slots
+  // of fingerprint fp, or kSentinel at the first free slot.
+  template <typename EQ_T>
+  INDEX_T find(size_t home, uint8_t fp, const EQ_T& eq) const {
+    size_t bucket_num = buckets_.size();
+    size_t b = home / kSlotNum;
+    uint32_t skipped = (1u << (home % kSlotNum)) - 1;
+    while (true) {
+      const Bucket& bucket = buckets_[b];
+      uint32_t candidates = candidate_mask(bucket, fp) & ~skipped;
+      if (b + 1 == bucket_num) {
+        candidates &= (1u << (slot_num_ - b * kSlotNum)) - 1;
+      }
+      while (candidates != 0) {
+        int o = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+        INDEX_T ind = __atomic_load_n(&bucket.indices[o], __ATOMIC_ACQUIRE);
+        if (ind == kSentinel || eq(ind)) {
+          return ind;
+        }
+      }
+      skipped = 0;
+      b = (b + 1 == bucket_num) ? 0 : b + 1;
+    }
+  }
+
+  MemoryUsage memory_usage() const { return buckets_.memory_usage(); }
+
+ private:
+  // The slots of the bucket of fingerprint fp or of none.
+  static uint32_t candidate_mask(const Bucket& bucket, uint8_t fp) {
+    static constexpr uint32_t kSlotMask = (1u << kSlotNum) - 1;
+#if defined(__SSE2__)
+    __m128i group =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bucket.fingerprints));
+    __m128i match = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(fp)));
+    __m128i empty = _mm_cmpeq_epi8(group, _mm_setzero_si128());
+    uint32_t mask =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(match, empty)));
+    return mask & kSlotMask;
+#else
+    uint32_t mask = 0;
+    for (size_t o = 0; o < kSlotNum; ++o) {
+      uint8_t slot_fp = bucket.fingerprints[o];
+      mask |= static_cast<uint32_t>(slot_fp == fp || slot_fp == 0) << o;
     }
+    return mask;
+#endif
   }
+
+  mmap_array<Bucket> buckets_;
+  size_t slot_num_;
 };
 
 }  // namespace id_indexer_impl
@@ -194,16 +366,21 @@ class LFIndexer {
  public:
   LFIndexer()
       : indices_(),
-        indices_size_(0),
         num_elements_(0),
         num_slots_minus_one_(0),
         keys_(nullptr),
+        key_capacity_(0),
+        key_reserved_(0),
+        grown_(nullptr),
         hasher_() {}
+  // Moves an indexer that has not grown online, as done on opening.
   LFIndexer(LFIndexer&& rhs)
       : indices_(std::move(rhs.indices_)),
-        indices_size_(rhs.indices_size_),
         num_elements_(rhs.num_elements_.load()),
         num_slots_minus_one_(rhs.num_slots_minus_one_),
+        key_capacity_(rhs.key_capacity_.load()),
+        key_reserved_(rhs.key_reserved_),
+        grown_(nullptr),
         hasher_(rhs.hasher_) {
     if (keys_ != rhs.keys_) {
       if (keys_ != nullptr) {
@@ -228,6 +405,7 @@ class LFIndexer {
       delete keys_;
     }
     keys_ = nullptr;
+    key_reserved_ = 0;
     if (type == PropertyType::kInt64) {
       keys_ = new TypedColumn<int64_t>(StorageStrategy::kMem);
     } else if (type == PropertyType::kInt32) {
@@ -255,109 +433,156 @@ class LFIndexer {
                              const std::string& snapshot_dir,
                              const std::string& work_dir) {
     keys_->open(filename + ".keys", "", work_dir);
-    indices_.open(work_dir + "/" + filename + ".indices", true);
+    mmap_array<INDEX_T> indices;
+    indices.open(work_dir + "/" + filename + ".indices", true);
 
     num_elements_.store(0);
-    indices_size_ = 0;
-    dump_meta(work_dir + "/" + filename + ".meta");
     indices_.reset();
+    dump_meta(work_dir + "/" + filename + ".meta");
+    indices.reset();
     keys_->close();
   }
 
   void reserve(size_t size) { rehash(std::max(size, num_elements_.load())); }
 
+  // Reserves the address space of the keys for capacity of them, so that
+  // inserts past capacity() grow the keys in place, see insert().
+  void reserve_growth(size_t capacity) {
+    keys_->reserve(capacity);
+    key_reserved_ = std::max(key_reserved_, capacity);
+  }
+
   void rehash(size_t size) {
+    settle_indices();
     size = std::max(size, 4ul);
-    keys_->resize(size);
+    resize_keys(size);
     size =
         static_cast<size_t>(std::ceil(size / id_indexer_impl::max_load_factor));
-    if (size == indices_size_) {
+    if (size == indices_.slot_num()) {
       return;
     }
 
     auto new_prime_index = hash_policy_.next_size_over(size);
     hash_policy_.commit(new_prime_index);
-    size_t num_elements = num_elements_.load();
-    indices_.resize(size);
-    indices_size_ = size;
-    for (size_t k = 0; k != size; ++k) {
-      indices_[k] = std::numeric_limits<INDEX_T>::max();
-    }
     num_slots_minus_one_ = size - 1;
-    for (INDEX_T idx = 0; idx < num_elements; ++idx) {
-      const auto& oid = keys_->get(idx);
-      size_t index =
-          hash_policy_.index_for_hash(hasher_(oid), num_slots_minus_one_);
-      static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
-      while (true) {
-        if (indices_[index] == sentinel) {
-          indices_[index] = idx;
-          break;
-        }
-        index = (index + 1) % (num_slots_minus_one_ + 1);
-      }
+    rebuild_indices();
+  }
+
+  // Moves the key of each index i to new_index[i], where new_index is a
+  // permutation of [0, size()), and rebuilds the hash table accordingly.
+  void permute(const std::vector<INDEX_T>& new_index) {
+    settle_indices();
+    size_t num_elements = num_elements_.load();
+    CHECK_EQ(new_index.size(), num_elements);
+    ColumnBase* old_keys = keys_;
+    keys_ = nullptr;
+    init(old_keys->type());
+    keys_->open_in_memory("");
+    resize_keys(old_keys->size());
+    for (size_t i = 0; i < num_elements; ++i) {
+      keys_->set_any(new_index[i], old_keys->get(i));
     }
+    delete old_keys;
+    rebuild_indices();
   }
 
   size_t capacity() const { return keys_->size(); }
 
   size_t size() const { return num_elements_.load(); }
+
+  MemoryUsage memory_usage() const {
+    MemoryUsage ret = indices_.memory_usage();
+    if (keys_ != nullptr) {
+      ret += keys_->memory_usage();
+    }
+    for (auto& grown : grown_tables_) {
+      ret += grown->indices.memory_usage();
+    }
+    return ret;
+  }
   PropertyType get_type() const { return keys_->type(); }
 
+  // Inserts grow the indexer online, with lookups and other inserts running
+  // concurrently. Keys past capacity() grow the keys in place, within the
+  // space reserve_growth() reserved. A hash table past its load factor grows
+  // into one of twice the size, which the inserts after move the slots of
+  // the former into, a chunk each, while lookups probe both tables until
+  // all the slots are moved. Only the inserts doing a growth wait for it.
   INDEX_T insert(const Any& oid) {
     assert(oid.type == get_type());
     INDEX_T ind = static_cast<INDEX_T>(num_elements_.fetch_add(1));
+    if (ind >= key_capacity_.load(std::memory_order_acquire)) {
+      grow_keys(static_cast<size_t>(ind) + 1);
+    }
     keys_->set_any(ind, oid);
-    size_t index =
-        hash_policy_.index_for_hash(hasher_(oid), num_slots_minus_one_);
-    static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
-    while (true) {
-      if (__sync_bool_compare_and_swap(&indices_.data()[index], sentinel,
-                                       ind)) {
-        break;
+    size_t hash = hasher_(oid);
+    GrownIndices* grown = grown_.load(std::memory_order_acquire);
+    if (ind >= max_elements(grown)) {
+      grown = grow_indices(ind);
+    }
+    if (grown == nullptr) {
+      insert_slot(indices_, hash_policy_, hash, ind);
+      grown = grown_.load(std::memory_order_acquire);
+      // The table may have grown since, after its slot was moved.
+      if (grown == nullptr) {
+        return ind;
       }
-      index = (index + 1) % (num_slots_minus_one_ + 1);
     }
+    insert_slot(grown->indices, grown->hash_policy, hash, ind);
+    GrownIndices* latest;
+    while ((latest = grown_.load(std::memory_order_acquire)) != grown) {
+      insert_slot(latest->indices, latest->hash_policy, hash, ind);
+      grown = latest;
+    }
+    migrate(grown, kMigrateChunk);
     return ind;
   }
 
   INDEX_T get_index(const Any& oid) const {
     assert(oid.type == get_type());
-    size_t index =
-        hash_policy_.index_for_hash(hasher_(oid), num_slots_minus_one_);
-    static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
-    while (true) {
-      INDEX_T ind = indices_.get(index);
-      if (ind == sentinel) {
-        VLOG(10) << "cannot find " << oid.to_string() << " in lf_indexer";
-        return ind;
-      } else if (keys_->get(ind) == oid) {
-        return ind;
-      } else {
-        index = (index + 1) % (num_slots_minus_one_ + 1);
-      }
+    INDEX_T ind = find(hasher_(oid),
+                       [&](INDEX_T ind) { return keys_->get(ind) == oid; });
+    if (ind == std::numeric_limits<INDEX_T>::max()) {
+      VLOG(10) << "cannot find " << oid.to_string() << " in lf_indexer";
     }
+    return ind;
   }
 
   bool get_index(const Any& oid, INDEX_T& ret) const {
     if (oid.type != get_type()) {
       return false;
     }
-    size_t index =
-        hash_policy_.index_for_hash(hasher_(oid), num_slots_minus_one_);
-    static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
-    while (true) {
-      INDEX_T ind = indices_.get(index);
-      if (ind == sentinel) {
-        return false;
-      } else if (keys_->get(ind) == oid) {
-        ret = ind;
-        return true;
-      } else {
-        index = (index + 1) % (num_slots_minus_one_ + 1);
-      }
+    INDEX_T ind = find(hasher_(oid),
+                       [&](INDEX_T ind) { return keys_->get(ind) == oid; });
+    if (ind == std::numeric_limits<INDEX_T>::max()) {
+      return false;
+    }
+    ret = ind;
+    return true;
+  }
+
+  // Sets ret[i] to the index of keys[i] for i in [0, num), or to the max of
+  // INDEX_T if the key is absent or the keys are not of type int64. The
+  // buckets of a group of keys are all hashed and prefetched before the first
+  // is probed, so that their cache misses overlap.
+  void get_index_batch(const int64_t* keys, size_t num, INDEX_T* ret) const {
+    if (get_type() == PropertyType::kInt64) {
+      get_index_batch_impl(*dynamic_cast<const TypedColumn<int64_t>*>(keys_),
+                           keys, num, ret);
+    } else {
+      std::fill(ret, ret + num, std::numeric_limits<INDEX_T>::max());
+    }
+  }
+
+  // As above, for string keys.
+  void get_index_batch(const std::string_view* keys, size_t num,
+                       INDEX_T* ret) const {
+    const auto* column = dynamic_cast<const StringColumn*>(keys_);
+    if (column != nullptr) {
+      get_index_batch_impl(*column, keys, num, ret);
+    } else {
+      std::fill(ret, ret + num, std::numeric_limits<INDEX_T>::max());
     }
-    return false;
   }
 
   Any get_key(const INDEX_T& index) const { return keys_->get(index); }
@@ -367,6 +592,9 @@ class LFIndexer {
     load_meta(tmp_path + ".meta");
     keys_->copy_to_tmp(cur_path + ".keys", tmp_path + ".keys");
     copy_file(cur_path + ".indices", tmp_path + ".indices");
+    if (std::filesystem::exists(cur_path + ".fingerprints")) {
+      copy_file(cur_path + ".fingerprints", tmp_path + ".fingerprints");
+    }
   }
 
   void open(const std::string& name, const std::string& snapshot_dir,
@@ -379,12 +607,10 @@ class LFIndexer {
 
     load_meta(work_dir + "/" + name + ".meta");
     keys_->open(name + ".keys", "", work_dir);
-    indices_.open(work_dir + "/" + name + ".indices", true);
+    load_indices(work_dir + "/" + name);
     size_t num_elements = num_elements_.load();
 
-    keys_->resize(num_elements + (num_elements >> 2));
-
-    indices_size_ = indices_.size();
+    resize_keys(num_elements + (num_elements >> 2));
   }
 
   void open_in_memory(const std::string& name) {
@@ -394,10 +620,9 @@ class LFIndexer {
       num_elements_.store(0);
     }
     keys_->open_in_memory(name + ".keys");
-    indices_.open(name + ".indices", false);
-    indices_size_ = indices_.size();
+    load_indices(name);
     size_t num_elements = num_elements_.load();
-    keys_->resize(num_elements + (num_elements >> 2));
+    resize_keys(num_elements + (num_elements >> 2));
   }
 
   void open_with_hugepages(const std::string& name, bool hugepage_table) {
@@ -407,25 +632,24 @@ class LFIndexer {
       num_elements_.store(0);
     }
     keys_->open_with_hugepages(name + ".keys", true);
-    if (hugepage_table) {
-      indices_.open_with_hugepages(name + ".indices");
-    } else {
-      indices_.open(name + ".indices", false);
-    }
-    indices_size_ = indices_.size();
+    indices_.set_hugepage_prefered(hugepage_table);
+    load_indices(name);
     size_t num_elements = num_elements_.load();
-    keys_->resize(num_elements + (num_elements >> 2));
+    resize_keys(num_elements + (num_elements >> 2));
   }
 
   void dump(const std::string& name, const std::string& snapshot_dir) {
-    keys_->resize(num_elements_.load());
+    settle_indices();
+    resize_keys(num_elements_.load());
     keys_->dump(snapshot_dir + "/" + name + ".keys");
-    indices_.dump(snapshot_dir + "/" + name + ".indices");
+    dump_indices(snapshot_dir + "/" + name);
     dump_meta(snapshot_dir + "/" + name + ".meta");
     close();
   }
 
   void close() {
+    grown_.store(nullptr);
+    grown_tables_.clear();
     keys_->close();
     indices_.reset();
   }
@@ -465,7 +689,7 @@ class LFIndexer {
   const ColumnBase& get_keys() const { return *keys_; }
   void warmup(int thread_num) const {
     size_t keys_size = num_elements_.load();
-    size_t indices_size = indices_.size();
+    size_t indices_size = indices_.slot_num();
     std::atomic<size_t> k_i(0), i_i(0);
     std::atomic<size_t> output(0);
     size_t chunk = 4096;
@@ -505,15 +729,277 @@ class LFIndexer {
   }
 
  private:
-  mmap_array<INDEX_T>
-      indices_;  // size() == indices_size_ == num_slots_minus_one_ +
-                 // log(num_slots_minus_one_)
-  size_t indices_size_;
+  // A hash table the indexer has grown into, see insert(). The table it
+  // grew from is prev, or the table of the indexer if null.
+  struct GrownIndices {
+    id_indexer_impl::BucketTable<INDEX_T> indices;
+    ska::ska::prime_number_hash_policy hash_policy;
+    const GrownIndices* prev;
+    size_t prev_slot_num;
+    // The next slot of prev to move, and the number of slots moved.
+    std::atomic<size_t> migrate_cursor;
+    std::atomic<size_t> migrated;
+  };
+
+  static constexpr size_t kMigrateChunk = 64;
+
+  void resize_keys(size_t size) {
+    keys_->resize(size);
+    key_capacity_.store(keys_->size(), std::memory_order_release);
+  }
+
+  void grow_keys(size_t size) {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    size_t capacity = key_capacity_.load(std::memory_order_relaxed);
+    if (size > capacity) {
+      size_t new_capacity = std::max(size, 2 * capacity);
+      // Doubling stops at the reserved space, past which the keys move under
+      // their readers. Inserts made while the graph is served do not get
+      // there, see MutablePropertyFragment::ClaimVertexSlots.
+      if (size <= key_reserved_) {
+        new_capacity = std::min(new_capacity, key_reserved_);
+      }
+      resize_keys(new_capacity);
+    }
+  }
+
+  size_t max_elements(const GrownIndices* grown) const {
+    size_t slot_num = grown == nullptr ? num_slots_minus_one_ + 1
+                                       : grown->indices.slot_num();
+    return static_cast<size_t>(slot_num * id_indexer_impl::max_load_factor);
+  }
+
+  // Grows the hash table for the element ind, unless another insert did,
+  // after moving the slots left of the former growth.
+  GrownIndices* grow_indices(INDEX_T ind) {
+    std::lock_guard<std::mutex> lock(grow_mutex_);
+    GrownIndices* grown = grown_.load(std::memory_order_acquire);
+    if (ind < max_elements(grown)) {
+      return grown;
+    }
+    if (grown != nullptr) {
+      finish_migration(grown);
+    }
+    auto next = std::make_unique<GrownIndices>();
+    size_t size = static_cast<size_t>(std::ceil(
+        2 * std::max(max_elements(grown), static_cast<size_t>(ind) + 1) /
+        id_indexer_impl::max_load_factor));
+    next->hash_policy.commit(next->hash_policy.next_size_over(size));
+    next->indices.resize(size);
+    next->prev = grown;
+    next->prev_slot_num =
+        grown == nullptr ? indices_.slot_num() : grown->indices.slot_num();
+    next->migrate_cursor.store(0);
+    next->migrated.store(0);
+    grown = next.get();
+    grown_tables_.emplace_back(std::move(next));
+    grown_.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  // Moves up to num slots of the table grown from into the grown one. A slot
+  // moved twice, or also put by an insert racing with the growth, leaves a
+  // duplicate, which is harmless as both lead to the same index.
+  void migrate(GrownIndices* grown, size_t num) {
+    size_t begin = grown->migrate_cursor.load(std::memory_order_relaxed);
+    if (begin >= grown->prev_slot_num) {
+      return;
+    }
+    begin = grown->migrate_cursor.fetch_add(num);
+    if (begin >= grown->prev_slot_num) {
+      return;
+    }
+    size_t end = std::min(begin + num, grown->prev_slot_num);
+    const auto& prev =
+        grown->prev == nullptr ? indices_ : grown->prev->indices;
+    static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
+    for (size_t k = begin; k < end; ++k) {
+      INDEX_T ind = prev.get(k);
+      if (ind != sentinel) {
+        insert_slot(grown->indices, grown->hash_policy,
+                    hasher_(keys_->get(ind)), ind);
+      }
+    }
+    grown->migrated.fetch_add(end - begin, std::memory_order_release);
+  }
+
+  // Moves the slots left and waits for the inserts moving the others.
+  void finish_migration(GrownIndices* grown) {
+    migrate(grown, grown->prev_slot_num);
+    while (grown->migrated.load(std::memory_order_acquire) <
+           grown->prev_slot_num) {
+      std::this_thread::yield();
+    }
+  }
+
+  static void insert_slot(id_indexer_impl::BucketTable<INDEX_T>& table,
+                          const ska::ska::prime_number_hash_policy& policy,
+                          size_t hash, INDEX_T ind) {
+    table.insert(policy.index_for_hash(hash, table.slot_num() - 1),
+                 id_indexer_impl::fingerprint(hash), ind);
+  }
+
+  template <typename EQ_T>
+  static INDEX_T probe(const id_indexer_impl::BucketTable<INDEX_T>& table,
+                       const ska::ska::prime_number_hash_policy& policy,
+                       size_t hash, const EQ_T& eq) {
+    return table.find(policy.index_for_hash(hash, table.slot_num() - 1),
+                      id_indexer_impl::fingerprint(hash), eq);
+  }
+
+  // Probes the table of the indexer, or the one it has grown into and, until
+  // its slots are all moved, the one it grew from.
+  template <typename EQ_T>
+  INDEX_T find(size_t hash, const EQ_T& eq) const {
+    const GrownIndices* grown = grown_.load(std::memory_order_acquire);
+    if (grown == nullptr) {
+      return probe(indices_, hash_policy_, hash, eq);
+    }
+    INDEX_T ind = probe(grown->indices, grown->hash_policy, hash, eq);
+    if (ind != std::numeric_limits<INDEX_T>::max() ||
+        grown->migrated.load(std::memory_order_acquire) >=
+            grown->prev_slot_num) {
+      return ind;
+    }
+    if (grown->prev == nullptr) {
+      return probe(indices_, hash_policy_, hash, eq);
+    }
+    return probe(grown->prev->indices, grown->prev->hash_policy, hash, eq);
+  }
+
+  // Makes the table grown into that of the indexer, for the operations that
+  // do not run concurrently with lookups and inserts.
+  void settle_indices() {
+    GrownIndices* grown = grown_.load();
+    if (grown == nullptr) {
+      return;
+    }
+    finish_migration(grown);
+    indices_.swap(grown->indices);
+    num_slots_minus_one_ = indices_.slot_num() - 1;
+    hash_policy_.set_mod_function_by_index(
+        grown->hash_policy.get_mod_function_index());
+    grown_.store(nullptr);
+    grown_tables_.clear();
+  }
+
+  // Clears the hash table and inserts the keys of all indices again.
+  void rebuild_indices() {
+    indices_.resize(num_slots_minus_one_ + 1);
+    size_t num_elements = num_elements_.load();
+    for (INDEX_T idx = 0; idx < num_elements; ++idx) {
+      insert_slot(indices_, hash_policy_, hasher_(keys_->get(idx)), idx);
+    }
+  }
+
+  // Loads the hash table from the flat slots of the .indices file of prefix,
+  // with the fingerprints of the .fingerprints file beside, or of the keys if
+  // there is none, as in the snapshots of former releases.
+  void load_indices(const std::string& prefix) {
+    static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
+    mmap_array<INDEX_T> flat;
+    flat.open(prefix + ".indices", false);
+    size_t slot_num = flat.size();
+    indices_.resize(slot_num);
+    mmap_array<uint8_t> fingerprints;
+    if (std::filesystem::exists(prefix + ".fingerprints")) {
+      fingerprints.open(prefix + ".fingerprints", false);
+    }
+    bool has_fingerprints = fingerprints.size() == slot_num;
+    size_t thread_num =
+        slot_num < (1 << 20)
+            ? 1
+            : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t chunk = (slot_num + thread_num - 1) / thread_num;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_num; ++i) {
+      threads.emplace_back([&, i]() {
+        size_t end = std::min(slot_num, (i + 1) * chunk);
+        for (size_t k = i * chunk; k < end; ++k) {
+          INDEX_T ind = flat[k];
+          if (ind != sentinel) {
+            indices_.set(k, ind,
+                         has_fingerprints
+                             ? fingerprints[k]
+                             : id_indexer_impl::fingerprint(
+                                   hasher_(keys_->get(ind))));
+          }
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  // Dumps the hash table as the flat slots of the .indices file of prefix and
+  // their fingerprints.
+  void dump_indices(const std::string& prefix) const {
+    size_t slot_num = indices_.slot_num();
+    mmap_array<INDEX_T> flat;
+    flat.resize(slot_num);
+    for (size_t k = 0; k < slot_num; ++k) {
+      flat[k] = indices_.get(k);
+    }
+    flat.dump(prefix + ".indices");
+    dump_fingerprints(prefix);
+  }
+
+  void dump_fingerprints(const std::string& prefix) const {
+    size_t slot_num = indices_.slot_num();
+    mmap_array<uint8_t> fingerprints;
+    fingerprints.resize(slot_num);
+    for (size_t k = 0; k < slot_num; ++k) {
+      fingerprints[k] = indices_.get_fingerprint(k);
+    }
+    fingerprints.dump(prefix + ".fingerprints");
+  }
+
+  template <typename KEY_T>
+  void get_index_batch_impl(const TypedColumn<KEY_T>& column,
+                            const KEY_T* keys, size_t num,
+                            INDEX_T* ret) const {
+    if (grown_.load(std::memory_order_acquire) != nullptr) {
+      for (size_t i = 0; i < num; ++i) {
+        ret[i] = find(GHash<KEY_T>()(keys[i]), [&](INDEX_T ind) {
+          return column.get_view(ind) == keys[i];
+        });
+      }
+      return;
+    }
+    static constexpr size_t kGroupSize = 16;
+    size_t homes[kGroupSize];
+    uint8_t fingerprints[kGroupSize];
+    for (size_t begin = 0; begin < num; begin += kGroupSize) {
+      size_t end = std::min(num, begin + kGroupSize);
+      for (size_t i = begin; i < end; ++i) {
+        size_t hash = GHash<KEY_T>()(keys[i]);
+        size_t home = hash_policy_.index_for_hash(hash, num_slots_minus_one_);
+        indices_.prefetch(home);
+        homes[i - begin] = home;
+        fingerprints[i - begin] = id_indexer_impl::fingerprint(hash);
+      }
+      for (size_t i = begin; i < end; ++i) {
+        ret[i] = indices_.find(
+            homes[i - begin], fingerprints[i - begin],
+            [&](INDEX_T ind) { return column.get_view(ind) == keys[i]; });
+      }
+    }
+  }
+
+  id_indexer_impl::BucketTable<INDEX_T> indices_;
   std::atomic<size_t> num_elements_;
   size_t num_slots_minus_one_;
   ColumnBase* keys_;
+  std::atomic<size_t> key_capacity_;
+  size_t key_reserved_;
 
   ska::ska::prime_number_hash_policy hash_policy_;
+  // The latest of the tables grown into, which are kept until the indexer
+  // is settled or closed, as lookups may still be probing them.
+  std::atomic<GrownIndices*> grown_;
+  std::vector<std::unique_ptr<GrownIndices>> grown_tables_;
+  std::mutex grow_mutex_;
   GHash<Any> hasher_;
 
   template <typename _KEY_T, typename _INDEX_T>
@@ -986,24 +1472,23 @@ void build_lf_indexer(const IdIndexer<KEY_T, INDEX_T>& input,
   size_t size = input.keys_.size();
   lf.init(type);
   lf.keys_->open(filename + ".keys", "", work_dir);
-  lf.keys_->resize(size);
+  lf.resize_keys(size);
   _move_data<KEY_T, INDEX_T>()(input.keys_, *lf.keys_, size);
   lf.num_elements_.store(size);
 
-  lf.indices_.open(snapshot_dir + "/" + filename + ".indices", true);
-  lf.indices_.resize(input.num_slots_minus_one_ + 1);
-
-  lf.indices_size_ = input.indices_.size();
+  mmap_array<INDEX_T> indices;
+  indices.open(snapshot_dir + "/" + filename + ".indices", true);
+  indices.resize(input.num_slots_minus_one_ + 1);
 
   lf.hash_policy_.set_mod_function_by_index(
       input.hash_policy_.get_mod_function_index());
   lf.num_slots_minus_one_ = input.num_slots_minus_one_;
-  memcpy(lf.indices_.data(), input.indices_.data(),
-         lf.indices_.size() * sizeof(INDEX_T));
+  memcpy(indices.data(), input.indices_.data(),
+         indices.size() * sizeof(INDEX_T));
   static constexpr INDEX_T sentinel = std::numeric_limits<INDEX_T>::max();
 
   std::vector<INDEX_T> residuals;
-  for (size_t idx = lf.indices_.size(); idx < lf.indices_size_; ++idx) {
+  for (size_t idx = indices.size(); idx < input.indices_.size(); ++idx) {
     if (input.indices_[idx] != sentinel) {
       residuals.push_back(input.indices_[idx]);
     }
@@ -1013,21 +1498,24 @@ void build_lf_indexer(const IdIndexer<KEY_T, INDEX_T>& input,
     size_t index = input.hash_policy_.index_for_hash(
         input.hasher_(oid), input.num_slots_minus_one_);
     while (true) {
-      if (lf.indices_[index] == lid) {
+      if (indices[index] == lid) {
         break;
-      } else if (lf.indices_[index] == sentinel) {
-        lf.indices_[index] = lid;
+      } else if (indices[index] == sentinel) {
+        indices[index] = lid;
         break;
       }
       index = (index + 1) % (input.num_slots_minus_one_ + 1);
     }
   }
+  indices.reset();
   lf.dump_meta(snapshot_dir + "/" + filename + ".meta");
 
   lf.keys_->dump(snapshot_dir + "/" + filename + ".keys");
   std::filesystem::remove(work_dir + "/" + filename + ".meta");
   lf.keys_->close();
   lf.keys_->open(filename + ".keys", snapshot_dir, "");
+  lf.load_indices(snapshot_dir + "/" + filename);
+  lf.dump_fingerprints(snapshot_dir + "/" + filename);
 }
 
 }  // namespace gs
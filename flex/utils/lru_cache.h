@@ -0,0 +1,116 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_LRU_CACHE_H_
+#define GRAPHSCOPE_UTILS_LRU_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace gs {
+
+// A map of at most capacity entries which evicts the least recently used one
+// once full, counting its hits, misses and evictions. Not thread safe. The
+// values stay in place until evicted or replaced.
+template <typename K, typename V, typename HASH_T = std::hash<K>>
+class LruCache {
+ public:
+  explicit LruCache(size_t capacity)
+      : capacity_(std::max<size_t>(capacity, 1)),
+        hit_num_(0),
+        miss_num_(0),
+        eviction_num_(0) {}
+
+  LruCache(const LruCache&) = delete;
+  LruCache& operator=(const LruCache&) = delete;
+
+  // Marks the entry as the most recently used, nullptr if absent.
+  V* get(const K& key) {
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      ++miss_num_;
+      return nullptr;
+    }
+    ++hit_num_;
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return &iter->second->second;
+  }
+
+  // Neither counts nor marks the entry as used.
+  const V* peek(const K& key) const {
+    auto iter = index_.find(key);
+    return iter == index_.end() ? nullptr : &iter->second->second;
+  }
+
+  // Inserts or replaces the entry of key as the most recently used.
+  V* put(const K& key, V&& value) {
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      entries_.erase(iter->second);
+      index_.erase(iter);
+    }
+    while (entries_.size() >= capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+      ++eviction_num_;
+    }
+    entries_.emplace_front(key, std::move(value));
+    index_.emplace(key, entries_.begin());
+    return &entries_.front().second;
+  }
+
+  bool erase(const K& key) {
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      return false;
+    }
+    entries_.erase(iter->second);
+    index_.erase(iter);
+    return true;
+  }
+
+  void clear() {
+    index_.clear();
+    entries_.clear();
+  }
+
+  size_t size() const { return entries_.size(); }
+  size_t capacity() const { return capacity_; }
+  uint64_t hit_num() const { return hit_num_; }
+  uint64_t miss_num() const { return miss_num_; }
+  uint64_t eviction_num() const { return eviction_num_; }
+
+ private:
+  using entry_list_t = std::list<std::pair<K, V>>;
+
+  size_t capacity_;
+  // From the most to the least recently used.
+  entry_list_t entries_;
+  std::unordered_map<K, typename entry_list_t::iterator, HASH_T> index_;
+
+  uint64_t hit_num_;
+  uint64_t miss_num_;
+  uint64_t eviction_num_;
+};
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_LRU_CACHE_H_
@@ -0,0 +1,168 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/lz_codec.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace gs {
+
+namespace lz_impl {
+
+static constexpr size_t kMinMatch = 4;
+static constexpr size_t kMaxOffset = 65535;
+static constexpr int kHashBits = 12;
+
+static inline uint32_t read32(const char* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint32_t hash32(uint32_t v) {
+  return (v * 2654435761u) >> (32 - kHashBits);
+}
+
+// Lengths that do not fit a nibble continue in bytes of up to 255.
+static inline char* write_length(char* op, size_t len) {
+  while (len >= 255) {
+    *op++ = static_cast<char>(255);
+    len -= 255;
+  }
+  *op++ = static_cast<char>(len);
+  return op;
+}
+
+static inline bool read_length(const uint8_t*& ip, const uint8_t* end,
+                               size_t& len) {
+  uint8_t b;
+  do {
+    if (ip == end) {
+      return false;
+    }
+    b = *ip++;
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+static char* write_sequence(char* op, const char* literals, size_t literal_len,
+                            size_t offset, size_t match_len) {
+  char* token = op++;
+  uint8_t t = 0;
+  if (literal_len >= 15) {
+    t = 15 << 4;
+    op = write_length(op, literal_len - 15);
+  } else {
+    t = static_cast<uint8_t>(literal_len << 4);
+  }
+  memcpy(op, literals, literal_len);
+  op += literal_len;
+  if (match_len != 0) {
+    *op++ = static_cast<char>(offset & 0xff);
+    *op++ = static_cast<char>(offset >> 8);
+    size_t ml = match_len - kMinMatch;
+    if (ml >= 15) {
+      t |= 15;
+      op = write_length(op, ml - 15);
+    } else {
+      t |= static_cast<uint8_t>(ml);
+    }
+  }
+  *token = static_cast<char>(t);
+  return op;
+}
+
+}  // namespace lz_impl
+
+size_t lz_compress_bound(size_t size) { return size + size / 255 + 16; }
+
+size_t lz_compress(const char* src, size_t size, char* dst) {
+  using namespace lz_impl;
+  uint32_t table[1 << kHashBits];
+  memset(table, 0xff, sizeof(table));
+  const char* anchor = src;
+  char* op = dst;
+  size_t i = 0;
+  while (i + kMinMatch <= size) {
+    uint32_t seq = read32(src + i);
+    uint32_t h = hash32(seq);
+    uint32_t cand = table[h];
+    table[h] = static_cast<uint32_t>(i);
+    if (cand == UINT32_MAX || i - cand > kMaxOffset ||
+        read32(src + cand) != seq) {
+      ++i;
+      continue;
+    }
+    size_t len = kMinMatch;
+    while (i + len < size && src[cand + len] == src[i + len]) {
+      ++len;
+    }
+    op = write_sequence(op, anchor, (src + i) - anchor, i - cand, len);
+    i += len;
+    anchor = src + i;
+  }
+  op = write_sequence(op, anchor, (src + size) - anchor, 0, 0);
+  return op - dst;
+}
+
+bool lz_decompress(const char* src, size_t size, char* dst, size_t dst_size) {
+  using namespace lz_impl;
+  const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* end = ip + size;
+  char* op = dst;
+  char* op_end = dst + dst_size;
+  while (ip < end) {
+    uint8_t token = *ip++;
+    size_t literal_len = token >> 4;
+    if (literal_len == 15 && !read_length(ip, end, literal_len)) {
+      return false;
+    }
+    if (literal_len > static_cast<size_t>(end - ip) ||
+        literal_len > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+    memcpy(op, ip, literal_len);
+    ip += literal_len;
+    op += literal_len;
+    if (ip == end) {
+      break;
+    }
+    if (end - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    size_t match_len = token & 15;
+    if (match_len == 15 && !read_length(ip, end, match_len)) {
+      return false;
+    }
+    match_len += kMinMatch;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst) ||
+        match_len > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+    // The match may overlap the bytes it produces.
+    const char* match = op - offset;
+    for (size_t k = 0; k < match_len; ++k) {
+      op[k] = match[k];
+    }
+    op += match_len;
+  }
+  return op == op_end;
+}
+
+}  // namespace gs
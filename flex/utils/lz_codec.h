@@ -0,0 +1,41 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_LZ_CODEC_H_
+#define UTILS_LZ_CODEC_H_
+
+#include <stddef.h>
+
+namespace gs {
+
+// A byte oriented LZ77 codec in the spirit of LZ4, tuned for decompression
+// speed over ratio. The stream is a sequence of (literals, match) pairs with
+// 16-bit match offsets, and ends with literals only.
+
+// Upper bound of the compressed size of size bytes.
+size_t lz_compress_bound(size_t size);
+
+// Compresses size bytes of src into dst, which must hold at least
+// lz_compress_bound(size) bytes. Returns the compressed size.
+size_t lz_compress(const char* src, size_t size, char* dst);
+
+// Decompresses size bytes of src into dst, which holds dst_size bytes.
+// Returns false if the input is corrupted or does not decompress to exactly
+// dst_size bytes.
+bool lz_decompress(const char* src, size_t size, char* dst, size_t dst_size);
+
+}  // namespace gs
+
+#endif  // UTILS_LZ_CODEC_H_
@@ -0,0 +1,69 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/memory_usage.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace gs {
+
+MemoryUsage mapped_memory_usage(const void* ptr, size_t size) {
+  MemoryUsage ret;
+  if (ptr == nullptr || size == 0) {
+    return ret;
+  }
+  ret.mapped_bytes = size;
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  // Ask in windows of 1G, so that the vector stays small on large mappings.
+  constexpr size_t window_pages = 1 << 18;
+  std::vector<unsigned char> vec;
+  size_t page_num = (size + page_size - 1) / page_size;
+  char* begin = static_cast<char*>(const_cast<void*>(ptr));
+  for (size_t first = 0; first < page_num; first += window_pages) {
+    size_t pages = std::min(window_pages, page_num - first);
+    vec.resize(pages);
+    if (mincore(begin + first * page_size, pages * page_size, vec.data()) !=
+        0) {
+      continue;
+    }
+    for (size_t i = 0; i < pages; ++i) {
+      if (vec[i] & 1) {
+        ret.resident_bytes += page_size;
+      }
+    }
+  }
+  ret.resident_bytes = std::min(ret.resident_bytes, size);
+  return ret;
+}
+
+void warmup_mapped_memory(const void* ptr, size_t size) {
+  if (ptr == nullptr || size == 0) {
+    return;
+  }
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  const volatile char* begin = static_cast<const volatile char*>(ptr);
+  char sum = 0;
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    sum += begin[offset];
+  }
+  sum += begin[size - 1];
+  (void) sum;
+}
+
+}  // namespace gs
@@ -0,0 +1,46 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_MEMORY_USAGE_H_
+#define UTILS_MEMORY_USAGE_H_
+
+#include <stddef.h>
+
+namespace gs {
+
+// Bytes mapped by a storage component, and how many of them are resident in
+// memory, i.e. would not fault when touched.
+struct MemoryUsage {
+  size_t mapped_bytes = 0;
+  size_t resident_bytes = 0;
+
+  MemoryUsage& operator+=(const MemoryUsage& rhs) {
+    mapped_bytes += rhs.mapped_bytes;
+    resident_bytes += rhs.resident_bytes;
+    return *this;
+  }
+};
+
+// Returns the usage of the size bytes mapped at ptr, which must be page
+// aligned, by asking the kernel which of their pages are resident.
+MemoryUsage mapped_memory_usage(const void* ptr, size_t size);
+
+// Reads a byte of every page of the size bytes mapped at ptr, so that the
+// pages are resident when they are next used.
+void warmup_mapped_memory(const void* ptr, size_t size);
+
+}  // namespace gs
+
+#endif  // UTILS_MEMORY_USAGE_H_
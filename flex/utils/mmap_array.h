@@ -17,6 +17,8 @@
 #define GRAPHSCOPE_UTILS_MMAP_ARRAY_H_
 
 #include <assert.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <atomic>
 #include <filesystem>
@@ -24,6 +26,10 @@
 #include <string_view>
 
 #include "flex/storages/rt_mutable_graph/file_names.h"
+#include "flex/utils/memory_usage.h"
+#include "flex/utils/numa_utils.h"
+#include "flex/utils/page_in_policy.h"
+#include "flex/utils/shared_snapshot.h"
 #include "glog/logging.h"
 #include "grape/util.h"
 
@@ -61,6 +67,102 @@ enum class MemoryStrategy {
   kHugepagePrefered,
 };
 
+// The pages backing the memory of an array that prefers hugepages.
+enum class PageKind {
+  kNone,         // no memory of its own, or not preferring hugepages
+  kHugetlb,      // explicit hugepages reserved in the hugetlb pool
+  kTransparent,  // normal pages advised to become transparent hugepages
+  kNormal,       // normal pages, the kernel refused the advice
+};
+
+// Bytes currently mapped by the arrays preferring hugepages, by the kind of
+// pages they actually got.
+struct HugepageUsage {
+  size_t hugetlb_bytes;
+  size_t transparent_bytes;
+  size_t normal_bytes;
+
+  HugepageUsage operator-(const HugepageUsage& rhs) const {
+    return {hugetlb_bytes - rhs.hugetlb_bytes,
+            transparent_bytes - rhs.transparent_bytes,
+            normal_bytes - rhs.normal_bytes};
+  }
+
+  std::string ToString() const {
+    std::stringstream ss;
+    ss << "hugetlb " << (hugetlb_bytes >> 20) << " MB, transparent "
+       << (transparent_bytes >> 20) << " MB, normal " << (normal_bytes >> 20)
+       << " MB";
+    return ss.str();
+  }
+};
+
+namespace hugepage_impl {
+
+inline std::atomic<size_t> hugetlb_bytes(0);
+inline std::atomic<size_t> transparent_bytes(0);
+inline std::atomic<size_t> normal_bytes(0);
+inline std::atomic<bool> hugetlb_failure_logged(false);
+
+inline std::atomic<size_t>* counter(PageKind kind) {
+  switch (kind) {
+  case PageKind::kHugetlb:
+    return &hugetlb_bytes;
+  case PageKind::kTransparent:
+    return &transparent_bytes;
+  case PageKind::kNormal:
+    return &normal_bytes;
+  default:
+    return nullptr;
+  }
+}
+
+}  // namespace hugepage_impl
+
+inline HugepageUsage hugepage_usage() {
+  return {hugepage_impl::hugetlb_bytes.load(),
+          hugepage_impl::transparent_bytes.load(),
+          hugepage_impl::normal_bytes.load()};
+}
+
+// Maps size bytes of anonymous memory for an array preferring hugepages:
+// from the hugetlb pool if it has room, in which case size is rounded up to
+// the hugepage size, or else from normal pages advised to be collapsed into
+// transparent hugepages. Returns MAP_FAILED if neither can be mapped.
+inline void* map_hugepage_prefered(size_t& size, PageKind& kind) {
+  void* ptr = allocate_hugepages(size);
+  if (ptr != MAP_FAILED) {
+    size = hugepage_round_up(size);
+    kind = PageKind::kHugetlb;
+  } else {
+    if (!hugepage_impl::hugetlb_failure_logged.exchange(true)) {
+      LOG(WARNING) << "mmap with hugepage failed, " << strerror(errno)
+                   << ", falling back to transparent hugepages";
+    }
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+      return ptr;
+    }
+    kind = madvise(ptr, size, MADV_HUGEPAGE) == 0 ? PageKind::kTransparent
+                                                  : PageKind::kNormal;
+  }
+  hugepage_impl::counter(kind)->fetch_add(size);
+  return ptr;
+}
+
+inline size_t page_round_up(size_t size) {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return (size + page_size - 1) / page_size * page_size;
+}
+
+inline void unaccount_hugepage_prefered(size_t size, PageKind kind) {
+  auto counter = hugepage_impl::counter(kind);
+  if (counter != nullptr) {
+    counter->fetch_sub(size);
+  }
+}
+
 template <typename T>
 class mmap_array {
  public:
@@ -70,10 +172,17 @@ class mmap_array {
         data_(NULL),
         size_(0),
         mmap_size_(0),
+        reserved_size_(0),
         sync_to_file_(false),
-        hugepage_prefered_(false) {}
-
-  mmap_array(const mmap_array<T>& rhs) : fd_(-1) {
+        hugepage_prefered_(false),
+        page_kind_(PageKind::kNone),
+        shared_page_size_(0) {}
+
+  mmap_array(const mmap_array<T>& rhs)
+      : fd_(-1),
+        reserved_size_(0),
+        page_kind_(PageKind::kNone),
+        shared_page_size_(0) {
     resize(rhs.size_);
     memcpy(data_, rhs.data_, size_ * sizeof(T));
   }
@@ -82,18 +191,23 @@ class mmap_array {
   ~mmap_array() { reset(); }
 
   void reset() {
-    if (data_ != NULL && mmap_size_ != 0) {
-      if (munmap(data_, mmap_size_) != 0) {
+    if (data_ != NULL && (mmap_size_ != 0 || reserved_size_ != 0)) {
+      if (munmap(data_, reserved_size_ != 0 ? reserved_size_ : mmap_size_) !=
+          0) {
         std::stringstream ss;
         ss << "Failed to mummap file [ " << filename_ << " ] "
            << strerror(errno);
         LOG(ERROR) << ss.str();
         throw std::runtime_error(ss.str());
       }
+      unaccount_hugepage_prefered(mmap_size_, page_kind_);
     }
+    page_kind_ = PageKind::kNone;
+    shared_page_size_ = 0;
     data_ = NULL;
     size_ = 0;
     mmap_size_ = 0;
+    reserved_size_ = 0;
     if (fd_ != -1) {
       if (close(fd_) != 0) {
         std::stringstream ss;
@@ -163,8 +277,10 @@ class mmap_array {
       if (mmap_size_ == 0) {
         data_ = NULL;
       } else {
+        PageInPolicy policy = get_page_in_policy(filename_);
         data_ = reinterpret_cast<T*>(
-            mmap(NULL, mmap_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0));
+            mmap(NULL, mmap_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | populate_flag(policy), fd_, 0));
         if (data_ == MAP_FAILED) {
           std::stringstream ss;
           ss << "Failed to mmap file [" << filename_ << "], "
@@ -172,7 +288,7 @@ class mmap_array {
           LOG(ERROR) << ss.str();
           throw std::runtime_error(ss.str());
         }
-        int rt = madvise(data_, mmap_size_, MADV_RANDOM | MADV_WILLNEED);
+        int rt = advise_page_in(data_, mmap_size_, policy, true);
         if (rt != 0) {
           std::stringstream ss;
           ss << "Failed to madvise file [" << filename_ << "], "
@@ -181,6 +297,8 @@ class mmap_array {
           throw std::runtime_error(ss.str());
         }
       }
+    } else if (is_shared_snapshot_file(filename_) && open_shared(filename_)) {
+      return;
     } else {
       if (!filename_.empty() && std::filesystem::exists(filename_)) {
         size_t file_size = std::filesystem::file_size(filename_);
@@ -197,8 +315,10 @@ class mmap_array {
         if (mmap_size_ == 0) {
           data_ = NULL;
         } else {
-          data_ = reinterpret_cast<T*>(mmap(
-              NULL, mmap_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0));
+          PageInPolicy policy = get_page_in_policy(filename_);
+          data_ = reinterpret_cast<T*>(
+              mmap(NULL, mmap_size_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | populate_flag(policy), fd_, 0));
           if (data_ == MAP_FAILED) {
             std::stringstream ss;
             ss << "Failed to mmap file [" << filename_ << "], "
@@ -206,6 +326,10 @@ class mmap_array {
             LOG(ERROR) << ss.str();
             throw std::runtime_error(ss.str());
           }
+          if (advise_page_in(data_, mmap_size_, policy, false) != 0) {
+            VLOG(10) << "Failed to madvise file [" << filename_ << "], "
+                     << strerror(errno);
+          }
         }
       }
     }
@@ -214,14 +338,18 @@ class mmap_array {
   void open_with_hugepages(const std::string& filename, size_t capacity = 0) {
     reset();
     hugepage_prefered_ = true;
+    if (is_shared_snapshot_file(filename) && open_shared(filename)) {
+      return;
+    }
     if (!filename.empty() && std::filesystem::exists(filename)) {
       size_t file_size = std::filesystem::file_size(filename);
       size_ = file_size / sizeof(T);
       if (size_ != 0) {
         capacity = std::max(capacity, size_);
-        mmap_size_ = hugepage_round_up(capacity * sizeof(T));
-        data_ = static_cast<T*>(allocate_hugepages(mmap_size_));
+        mmap_size_ = capacity * sizeof(T);
+        data_ = static_cast<T*>(map_hugepage_prefered(mmap_size_, page_kind_));
         if (data_ != MAP_FAILED) {
+          numa_place_memory(data_, mmap_size_);
           FILE* fin = fopen(filename.c_str(), "rb");
           if (fin == NULL) {
             std::stringstream ss;
@@ -245,9 +373,10 @@ class mmap_array {
             throw std::runtime_error(ss.str());
           }
         } else {
-          LOG(ERROR) << "allocating hugepage failed, " << strerror(errno)
-                     << ", try with normal pages";
+          LOG(ERROR) << "allocating memory failed, " << strerror(errno)
+                     << ", try with mmaped file";
           data_ = NULL;
+          mmap_size_ = 0;
           open(filename, false);
         }
       } else {
@@ -316,11 +445,82 @@ class mmap_array {
     }
   }
 
+  // Reserves the address space of capacity elements, so that the array keeps
+  // in place while it is resized up to capacity afterwards, e.g. by a writer
+  // appending vertices with readers of the elements running concurrently.
+  // The pages of the reserved space are only committed as the array grows.
+  // Reserving moves the array once and must not race with its readers.
+  void reserve(size_t capacity) {
+    size_t reserved = page_round_up(capacity * sizeof(T));
+    if (reserved <= reserved_size_ || reserved == 0) {
+      return;
+    }
+    size_t committed = page_round_up(size_ * sizeof(T));
+    // The mapping of a shared copy is moved to the head of the space, with
+    // the pages written to so far, rather than copied, see open_shared.
+    bool move_shared = shared_page_size_ != 0 && reserved_size_ == 0;
+    if (move_shared) {
+      committed = mmap_size_;
+      reserved = round_up(std::max(reserved, committed), shared_page_size_);
+    }
+    char* region =
+        reserve_space(reserved, move_shared ? shared_page_size_ : 0);
+    if (move_shared && mremap(data_, mmap_size_, mmap_size_,
+                              MREMAP_MAYMOVE | MREMAP_FIXED,
+                              region) != MAP_FAILED) {
+      data_ = NULL;
+    } else if (committed != 0) {
+      if (sync_to_file_) {
+        if (mmap(region, committed, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED, fd_, 0) == MAP_FAILED) {
+          std::stringstream ss;
+          ss << "Failed to mmap file [ " << filename_ << " ], "
+             << strerror(errno);
+          LOG(ERROR) << ss.str();
+          throw std::runtime_error(ss.str());
+        }
+      } else {
+        // Also for a shared copy which can not be moved, e.g. in hugepages
+        // on kernels before 6.3, or past its space, which is then private.
+        commit(region, committed);
+        memcpy(region, reinterpret_cast<void*>(data_), size_ * sizeof(T));
+        shared_page_size_ = 0;
+      }
+    }
+    if (data_ != NULL && (mmap_size_ != 0 || reserved_size_ != 0)) {
+      munmap(data_, reserved_size_ != 0 ? reserved_size_ : mmap_size_);
+      unaccount_hugepage_prefered(mmap_size_, page_kind_);
+    }
+    page_kind_ = PageKind::kNone;
+    data_ = reinterpret_cast<T*>(region);
+    mmap_size_ = committed;
+    reserved_size_ = reserved;
+  }
+
+  size_t reserved_capacity() const { return reserved_size_ / sizeof(T); }
+
   void resize(size_t size) {
     if (size == size_) {
       return;
     }
 
+    // Grows past the shared copy without copying it, see open_shared.
+    if (shared_page_size_ != 0 && reserved_size_ == 0 &&
+        size * sizeof(T) > mmap_size_) {
+      reserve(size);
+    }
+
+    if (reserved_size_ != 0) {
+      if (size * sizeof(T) > reserved_size_) {
+        LOG(WARNING) << "Resizing [ " << filename_ << " ] to " << size
+                     << " beyond its reserved capacity "
+                     << reserved_capacity() << ", moving it";
+        reserve(std::max(size, 2 * reserved_capacity()));
+      }
+      resize_in_place(size);
+      return;
+    }
+
     if (sync_to_file_) {
       if (data_ != NULL && mmap_size_ != 0) {
         if (munmap(data_, mmap_size_) != 0) {
@@ -350,6 +550,13 @@ class mmap_array {
           LOG(ERROR) << ss.str();
           throw std::runtime_error(ss.str());
         }
+        // The access pattern outlives the mapping, what to read at open
+        // does not.
+        PageInPolicy policy = get_page_in_policy(filename_);
+        if (policy == PageInPolicy::kRandom ||
+            policy == PageInPolicy::kSequential) {
+          advise_page_in(data_, new_mmap_size, policy, true);
+        }
       }
       size_ = size;
       mmap_size_ = new_mmap_size;
@@ -360,14 +567,15 @@ class mmap_array {
       } else {
         T* new_data = NULL;
         size_t new_mmap_size = size * sizeof(T);
+        PageKind new_page_kind = PageKind::kNone;
         if (hugepage_prefered_) {
-          new_data = reinterpret_cast<T*>(allocate_hugepages(new_mmap_size));
+          new_data = reinterpret_cast<T*>(
+              map_hugepage_prefered(new_mmap_size, new_page_kind));
           if (new_data == MAP_FAILED) {
             LOG(ERROR) << "mmap with hugepage failed, " << strerror(errno)
                        << ", try with normal pages";
             new_data = NULL;
-          } else {
-            new_mmap_size = hugepage_round_up(new_mmap_size);
+            new_page_kind = PageKind::kNone;
           }
         }
         if (new_data == NULL) {
@@ -381,6 +589,7 @@ class mmap_array {
             throw std::runtime_error(ss.str());
           }
         }
+        numa_place_memory(new_data, new_mmap_size);
 
         size_t copy_size = std::min(size, size_);
         if (copy_size > 0 && data_ != NULL) {
@@ -393,6 +602,7 @@ class mmap_array {
         data_ = new_data;
         size_ = size;
         mmap_size_ = new_mmap_size;
+        page_kind_ = new_page_kind;
       }
     }
   }
@@ -414,28 +624,155 @@ class mmap_array {
 
   size_t size() const { return size_; }
 
+  MemoryUsage memory_usage() const {
+    return mapped_memory_usage(data_, mmap_size_);
+  }
+
+  void warmup() const { warmup_mapped_memory(data_, mmap_size_); }
+
   void swap(mmap_array<T>& rhs) {
     std::swap(filename_, rhs.filename_);
     std::swap(fd_, rhs.fd_);
     std::swap(data_, rhs.data_);
     std::swap(size_, rhs.size_);
     std::swap(mmap_size_, rhs.mmap_size_);
+    std::swap(reserved_size_, rhs.reserved_size_);
     std::swap(hugepage_prefered_, rhs.hugepage_prefered_);
     std::swap(sync_to_file_, rhs.sync_to_file_);
+    std::swap(page_kind_, rhs.page_kind_);
+    std::swap(shared_page_size_, rhs.shared_page_size_);
   }
 
   const std::string& filename() const { return filename_; }
 
  private:
+  static int populate_flag(PageInPolicy policy) {
+    return policy == PageInPolicy::kPopulate ? MAP_POPULATE : 0;
+  }
+
+  static size_t round_up(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  // Maps size bytes of inaccessible address space, starting at a multiple
+  // of alignment if it is set.
+  static char* reserve_space(size_t size, size_t alignment) {
+    size_t extra = alignment > page_round_up(1) ? alignment : 0;
+    char* region = reinterpret_cast<char*>(
+        mmap(NULL, size + extra, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+    if (region == MAP_FAILED) {
+      std::stringstream ss;
+      ss << "Failed to reserve " << size << " bytes, " << strerror(errno);
+      LOG(ERROR) << ss.str();
+      throw std::runtime_error(ss.str());
+    }
+    if (extra != 0) {
+      char* aligned = reinterpret_cast<char*>(
+          round_up(reinterpret_cast<size_t>(region), alignment));
+      if (aligned != region) {
+        munmap(region, aligned - region);
+      }
+      if (aligned + size != region + size + extra) {
+        munmap(aligned + size, region + extra - aligned);
+      }
+      region = aligned;
+    }
+    return region;
+  }
+
+  // Maps the copy of a snapshot file in the shared snapshot directory,
+  // privately: the pages are those of the copy, the same physical pages in
+  // every process mapping it, until they are written. With MAP_NORESERVE,
+  // the hugepages of the copies written to are not reserved up front, a
+  // write with none left in the pool faults. Returns false, leaving the
+  // array empty, if there is no copy.
+  bool open_shared(const std::string& filename) {
+    size_t page_size = 0;
+    std::string path = shared_snapshot_copy(filename, page_size);
+    if (path.empty()) {
+      return false;
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      return false;
+    }
+    size_t copy_size = std::filesystem::file_size(path);
+    void* data = mmap(NULL, copy_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_NORESERVE, fd, 0);
+    if (data == MAP_FAILED) {
+      LOG(WARNING) << "Failed to mmap the shared copy of [ " << filename
+                   << " ], " << strerror(errno);
+      close(fd);
+      return false;
+    }
+    filename_ = filename;
+    fd_ = fd;
+    data_ = reinterpret_cast<T*>(data);
+    size_ = std::filesystem::file_size(filename) / sizeof(T);
+    mmap_size_ = copy_size;
+    shared_page_size_ = page_size;
+    return true;
+  }
+
+  void commit(char* begin, size_t size) {
+    if (mprotect(begin, size, PROT_READ | PROT_WRITE) != 0) {
+      std::stringstream ss;
+      ss << "Failed to commit " << size << " reserved bytes, "
+         << strerror(errno);
+      LOG(ERROR) << ss.str();
+      throw std::runtime_error(ss.str());
+    }
+    if (hugepage_prefered_) {
+      madvise(begin, size, MADV_HUGEPAGE);
+    }
+  }
+
+  // Grows or shrinks the array within its reserved space, by mapping only
+  // the pages past those committed, so that the elements never move. The
+  // pages stay committed on shrinking, as the array may grow back.
+  void resize_in_place(size_t size) {
+    size_t committed = page_round_up(size * sizeof(T));
+    char* begin = reinterpret_cast<char*>(data_);
+    if (sync_to_file_) {
+      if (ftruncate(fd_, size * sizeof(T)) == -1) {
+        std::stringstream ss;
+        ss << "Failed to ftruncate [ " << filename_ << " ], "
+           << strerror(errno);
+        LOG(ERROR) << ss.str();
+        throw std::runtime_error(ss.str());
+      }
+      if (committed > mmap_size_ &&
+          mmap(begin + mmap_size_, committed - mmap_size_,
+               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_,
+               mmap_size_) == MAP_FAILED) {
+        std::stringstream ss;
+        ss << "Failed to mmap file [ " << filename_ << " ], "
+           << strerror(errno);
+        LOG(ERROR) << ss.str();
+        throw std::runtime_error(ss.str());
+      }
+    } else if (committed > mmap_size_) {
+      commit(begin + mmap_size_, committed - mmap_size_);
+    }
+    size_ = size;
+    mmap_size_ = std::max(mmap_size_, committed);
+  }
+
   std::string filename_;
   int fd_;
   T* data_;
   size_t size_;
 
   size_t mmap_size_;
+  // The bytes of address space reserved from data_, 0 if none is.
+  size_t reserved_size_;
 
   bool sync_to_file_;
   bool hugepage_prefered_;
+  PageKind page_kind_;
+  // The page size of the shared copy mapped, 0 if none is, see open_shared.
+  size_t shared_page_size_;
 };
 
 struct string_item {
@@ -480,6 +817,11 @@ class mmap_array<std::string_view> {
     data_.dump(filename + ".data");
   }
 
+  void reserve(size_t size, size_t data_size) {
+    items_.reserve(size);
+    data_.reserve(data_size);
+  }
+
   void resize(size_t size, size_t data_size) {
     items_.resize(size);
     data_.resize(data_size);
@@ -495,10 +837,36 @@ class mmap_array<std::string_view> {
     return std::string_view(data_.data() + item.offset, item.length);
   }
 
+  // Item level access, for rewriting the data without moving the items.
+  const string_item& get_item(size_t idx) const { return items_.get(idx); }
+
+  void set_item(size_t idx, const string_item& item) { items_.set(idx, item); }
+
+  std::string_view get_data(const string_item& item) const {
+    return std::string_view(data_.data() + item.offset, item.length);
+  }
+
+  void set_data(size_t offset, const std::string_view& val) {
+    memcpy(data_.data() + offset, val.data(), val.size());
+  }
+
   size_t size() const { return items_.size(); }
 
   size_t data_size() const { return data_.size(); }
 
+  size_t data_reserved_capacity() const { return data_.reserved_capacity(); }
+
+  MemoryUsage memory_usage() const {
+    MemoryUsage ret = items_.memory_usage();
+    ret += data_.memory_usage();
+    return ret;
+  }
+
+  void warmup() const {
+    items_.warmup();
+    data_.warmup();
+  }
+
   void swap(mmap_array& rhs) {
     items_.swap(rhs.items_);
     data_.swap(rhs.data_);
@@ -0,0 +1,166 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/numa_utils.h"
+
+#include <sched.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <glog/logging.h>
+
+namespace gs {
+
+namespace numa_impl {
+
+// Policy modes of mbind(2) and set_mempolicy(2), spelled out here to avoid
+// a dependency on libnuma.
+static constexpr int kMpolPreferred = 1;
+static constexpr int kMpolInterleave = 3;
+
+static constexpr int kMaxNodeNum = 64;
+
+static std::atomic<NumaPolicy> policy{NumaPolicy::kNone};
+
+static int detect_node_num() {
+  int num = 0;
+  while (num < kMaxNodeNum &&
+         std::filesystem::exists("/sys/devices/system/node/node" +
+                                 std::to_string(num))) {
+    ++num;
+  }
+  return std::max(num, 1);
+}
+
+// Parses a cpulist such as "0-15,32-47".
+static std::vector<int> node_cpus(int node) {
+  std::vector<int> cpus;
+  std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) +
+                    "/cpulist");
+  std::string list;
+  if (!fin.is_open() || !std::getline(fin, list)) {
+    return cpus;
+  }
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int lo = std::stoi(range.substr(0, dash));
+    int hi = (dash == std::string::npos) ? lo : std::stoi(range.substr(dash + 1));
+    for (int cpu = lo; cpu <= hi; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+}  // namespace numa_impl
+
+bool parse_numa_policy(const std::string& str, NumaPolicy& policy) {
+  if (str == "none" || str.empty()) {
+    policy = NumaPolicy::kNone;
+  } else if (str == "interleave") {
+    policy = NumaPolicy::kInterleave;
+  } else if (str == "interleave_bind_sessions") {
+    policy = NumaPolicy::kInterleaveBindSessions;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, NumaPolicy policy) {
+  switch (policy) {
+  case NumaPolicy::kNone:
+    os << "none";
+    break;
+  case NumaPolicy::kInterleave:
+    os << "interleave";
+    break;
+  case NumaPolicy::kInterleaveBindSessions:
+    os << "interleave_bind_sessions";
+    break;
+  }
+  return os;
+}
+
+int numa_node_num() {
+  static int num = numa_impl::detect_node_num();
+  return num;
+}
+
+void set_numa_policy(NumaPolicy policy) {
+  numa_impl::policy.store(policy);
+}
+
+NumaPolicy get_numa_policy() { return numa_impl::policy.load(); }
+
+void numa_place_memory(void* addr, size_t size) {
+  if (addr == nullptr || size == 0 ||
+      numa_impl::policy.load() == NumaPolicy::kNone) {
+    return;
+  }
+  int node_num = numa_node_num();
+  if (node_num < 2) {
+    return;
+  }
+  unsigned long mask = (node_num >= 64) ? ~0UL : ((1UL << node_num) - 1);
+  if (syscall(SYS_mbind, addr, size, numa_impl::kMpolInterleave, &mask,
+              node_num + 1, 0) != 0) {
+    VLOG(10) << "Failed to interleave " << size << " bytes, "
+             << strerror(errno);
+  }
+}
+
+bool bind_current_thread_to_numa_node(int node) {
+  if (node < 0 || node >= numa_node_num()) {
+    return false;
+  }
+  auto cpus = numa_impl::node_cpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    LOG(ERROR) << "Failed to bind thread to numa node " << node << ", "
+               << strerror(errno);
+    return false;
+  }
+  unsigned long mask = 1UL << node;
+  if (syscall(SYS_set_mempolicy, numa_impl::kMpolPreferred, &mask,
+              numa_node_num() + 1) != 0) {
+    LOG(ERROR) << "Failed to prefer numa node " << node << ", "
+               << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace gs
@@ -0,0 +1,60 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_NUMA_UTILS_H_
+#define UTILS_NUMA_UTILS_H_
+
+#include <stddef.h>
+
+#include <ostream>
+#include <string>
+
+namespace gs {
+
+enum class NumaPolicy {
+  // Pages land on the node of the first page fault.
+  kNone,
+  // Pages of graph storage are interleaved across all nodes.
+  kInterleave,
+  // As kInterleave, and the thread driving session i is bound to the node
+  // owning the i-th block of sessions, so that query-local memory stays on
+  // the node the session runs on.
+  kInterleaveBindSessions,
+};
+
+bool parse_numa_policy(const std::string& str, NumaPolicy& policy);
+
+std::ostream& operator<<(std::ostream& os, NumaPolicy policy);
+
+// Number of NUMA nodes of this machine, 1 if it is not a NUMA machine.
+int numa_node_num();
+
+// Sets the placement applied by numa_place_memory, process wide.
+void set_numa_policy(NumaPolicy policy);
+
+NumaPolicy get_numa_policy();
+
+// Applies the current policy to a freshly mapped region. It must be called
+// before the pages are touched, since the policy only affects page faults
+// that have not happened yet.
+void numa_place_memory(void* addr, size_t size);
+
+// Binds the calling thread to the cpus of the given node and prefers that
+// node for its allocations. Returns false if the binding failed.
+bool bind_current_thread_to_numa_node(int node);
+
+}  // namespace gs
+
+#endif  // UTILS_NUMA_UTILS_H_
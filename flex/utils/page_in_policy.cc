@@ -0,0 +1,112 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/page_in_policy.h"
+
+#include <fnmatch.h>
+#include <sys/mman.h>
+
+#include <filesystem>
+#include <mutex>
+
+namespace gs {
+
+namespace page_in_impl {
+
+static std::mutex mutex;
+static PageInPolicy default_policy = PageInPolicy::kDefault;
+static std::vector<std::pair<std::string, PageInPolicy>> overrides;
+
+}  // namespace page_in_impl
+
+bool parse_page_in_policy(const std::string& str, PageInPolicy& policy) {
+  if (str == "default" || str.empty()) {
+    policy = PageInPolicy::kDefault;
+  } else if (str == "random") {
+    policy = PageInPolicy::kRandom;
+  } else if (str == "sequential") {
+    policy = PageInPolicy::kSequential;
+  } else if (str == "populate") {
+    policy = PageInPolicy::kPopulate;
+  } else if (str == "lazy") {
+    policy = PageInPolicy::kLazy;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, PageInPolicy policy) {
+  switch (policy) {
+  case PageInPolicy::kDefault:
+    os << "default";
+    break;
+  case PageInPolicy::kRandom:
+    os << "random";
+    break;
+  case PageInPolicy::kSequential:
+    os << "sequential";
+    break;
+  case PageInPolicy::kPopulate:
+    os << "populate";
+    break;
+  case PageInPolicy::kLazy:
+    os << "lazy";
+    break;
+  }
+  return os;
+}
+
+void set_page_in_policy(
+    PageInPolicy default_policy,
+    const std::vector<std::pair<std::string, PageInPolicy>>& overrides) {
+  std::lock_guard<std::mutex> lock(page_in_impl::mutex);
+  page_in_impl::default_policy = default_policy;
+  page_in_impl::overrides = overrides;
+}
+
+PageInPolicy get_page_in_policy(const std::string& filename) {
+  std::string name = std::filesystem::path(filename).filename().string();
+  std::lock_guard<std::mutex> lock(page_in_impl::mutex);
+  for (const auto& pair : page_in_impl::overrides) {
+    if (fnmatch(pair.first.c_str(), name.c_str(), 0) == 0) {
+      return pair.second;
+    }
+  }
+  return page_in_impl::default_policy;
+}
+
+int advise_page_in(void* addr, size_t size, PageInPolicy policy,
+                   bool shared) {
+  switch (policy) {
+  case PageInPolicy::kDefault:
+    // madvise takes a single advice, the former MADV_RANDOM | MADV_WILLNEED
+    // on shared mappings amounted to MADV_WILLNEED.
+    return shared ? madvise(addr, size, MADV_WILLNEED) : 0;
+  case PageInPolicy::kRandom:
+    return madvise(addr, size, MADV_RANDOM);
+  case PageInPolicy::kSequential:
+    return madvise(addr, size, MADV_SEQUENTIAL);
+  case PageInPolicy::kPopulate:
+    // The mapping is created with MAP_POPULATE, this only covers kernels
+    // that ignore it for the mapping type.
+    return madvise(addr, size, MADV_WILLNEED);
+  case PageInPolicy::kLazy:
+    return madvise(addr, size, MADV_NORMAL);
+  }
+  return 0;
+}
+
+}  // namespace gs
@@ -0,0 +1,66 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_PAGE_IN_POLICY_H_
+#define UTILS_PAGE_IN_POLICY_H_
+
+#include <stddef.h>
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+// How the pages of a file mapped by mmap_array are brought into memory. It
+// only matters for the memory levels that map files (0 and 1), files loaded
+// into hugepages are read as a whole.
+enum class PageInPolicy {
+  // Asynchronous read-ahead of the whole file for shared mappings (memory
+  // level 0), and the kernel's default for private ones (memory level 1).
+  kDefault,
+  // No read-ahead around faults, for point lookups.
+  kRandom,
+  // Aggressive read-ahead, for files scanned front to back such as .nbr.
+  kSequential,
+  // Every page is read when the file is opened.
+  kPopulate,
+  // Pages are read on first access only, with the kernel's default
+  // read-ahead, for rarely used files.
+  kLazy,
+};
+
+bool parse_page_in_policy(const std::string& str, PageInPolicy& policy);
+
+std::ostream& operator<<(std::ostream& os, PageInPolicy policy);
+
+// Sets the policies process wide. Overrides are pairs of a glob pattern on
+// the file name (e.g. "*.nbr" or "oe_person_knows_person.*") and a policy,
+// the first pattern matching a file decides its policy, and files matching
+// none get default_policy. It should be called before the graph is opened.
+void set_page_in_policy(
+    PageInPolicy default_policy,
+    const std::vector<std::pair<std::string, PageInPolicy>>& overrides = {});
+
+PageInPolicy get_page_in_policy(const std::string& filename);
+
+// Advises the kernel about a mapping of a file opened with the policy.
+// Returns 0 on success, otherwise the madvise(2) result with errno set.
+int advise_page_in(void* addr, size_t size, PageInPolicy policy, bool shared);
+
+}  // namespace gs
+
+#endif  // UTILS_PAGE_IN_POLICY_H_
@@ -14,7 +14,14 @@
  */
 
 #include "flex/utils/property/column.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <unordered_map>
+
 #include "flex/utils/id_indexer.h"
+#include "flex/utils/lz_codec.h"
 #include "flex/utils/property/table.h"
 #include "flex/utils/property/types.h"
 
@@ -82,6 +89,11 @@ class TypedEmptyColumn : public ColumnBase {
     arc >> val;
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    T val;
+    arc >> val;
+  }
+
   StorageStrategy storage_strategy() const override {
     return StorageStrategy::kNone;
   }
@@ -121,6 +133,11 @@ class TypedEmptyColumn<std::string_view> : public ColumnBase {
     arc >> val;
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    std::string_view val;
+    arc >> val;
+  }
+
   StorageStrategy storage_strategy() const override {
     return StorageStrategy::kNone;
   }
@@ -174,6 +191,15 @@ std::shared_ptr<ColumnBase> CreateColumn(
       return nullptr;
     }
   } else {
+    if (strategy == StorageStrategy::kCompressed) {
+      if (type.type_enum == impl::PropertyTypeImpl::kVarChar) {
+        return std::make_shared<CompressedStringColumn>(
+            type.additional_type_info.max_length);
+      } else if (type.type_enum == impl::PropertyTypeImpl::kStringView) {
+        return std::make_shared<CompressedStringColumn>();
+      }
+      strategy = StorageStrategy::kMem;
+    }
     if (type == PropertyType::kEmpty) {
       return std::make_shared<TypedColumn<grape::EmptyType>>(strategy);
     } else if (type == PropertyType::kBool) {
@@ -231,6 +257,12 @@ void TypedColumn<std::string_view>::set_value_safe(
         size_t new_avg_width =
             (pos_.load() + idx - basic_size_) / (idx - basic_size_ + 1);
         size_t new_len = std::max(extra_size_ * new_avg_width, pos_.load());
+        // Grows in place while the reserved space is enough, the estimate
+        // from the rows before idx is off once values are overwritten.
+        size_t reserved = extra_buffer_.data_reserved_capacity();
+        if (pos_.load() <= reserved) {
+          new_len = std::min(new_len, reserved);
+        }
         extra_buffer_.resize(extra_buffer_.size(), new_len);
       }
       w_lock.unlock();
@@ -257,6 +289,364 @@ void TypedColumn<std::string_view>::set_value_safe(
   }
 }
 
+bool TypedColumn<std::string_view>::fragmented(
+    const mmap_array<std::string_view>& buffer, size_t size, size_t pos) {
+  size_t live = 0;
+  for (size_t k = 0; k < size; ++k) {
+    live += buffer.get_item(k).length;
+  }
+  return live * 2 < pos;
+}
+
+// Values of a buffer must repeat this many times on average for it to be
+// dictionary encoded.
+static constexpr size_t kDictionaryMinRepeat = 8;
+
+// Rewrites the first size items of the buffer to point into a sorted
+// dictionary of its distinct values, stored at the head of the data. Returns
+// false and leaves the buffer untouched if there are too many distinct values
+// or the dictionary would save less than half of the data. On success pos is
+// set to the end of the dictionary.
+static bool encode_string_buffer(mmap_array<std::string_view>& buffer,
+                                 size_t size, size_t& pos,
+                                 mmap_array<string_item>& dict) {
+  size_t max_distinct = size / kDictionaryMinRepeat;
+  // Keys point into the data, which is only overwritten at the end.
+  std::unordered_map<std::string_view, uint32_t> ids;
+  std::vector<std::string_view> values;
+  size_t dict_size = 0;
+  for (size_t i = 0; i < size; ++i) {
+    auto ret = ids.emplace(buffer.get(i), values.size());
+    if (ret.second) {
+      values.push_back(ret.first->first);
+      dict_size += values.back().size();
+      if (values.size() > max_distinct || dict_size * 2 > pos) {
+        return false;
+      }
+    }
+  }
+
+  std::vector<uint32_t> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&values](uint32_t a, uint32_t b) {
+    return values[a] < values[b];
+  });
+  std::string data;
+  data.reserve(dict_size);
+  std::vector<string_item> items(values.size());
+  dict.reset();
+  dict.resize(values.size());
+  for (size_t k = 0; k < order.size(); ++k) {
+    uint32_t id = order[k];
+    items[id] = {data.size(), static_cast<uint32_t>(values[id].size())};
+    dict.set(k, items[id]);
+    data.append(values[id]);
+  }
+  for (size_t i = 0; i < size; ++i) {
+    buffer.set_item(i, items[ids.at(buffer.get(i))]);
+  }
+  buffer.set_data(0, data);
+  pos = data.size();
+  return true;
+}
+
+void TypedColumn<std::string_view>::encode_dictionary() {
+  size_t basic_pos = basic_pos_.load();
+  if (basic_size_ != 0 && basic_pos > 2 * basic_encoded_pos_) {
+    basic_encoded_pos_ = basic_pos;
+    if (encode_string_buffer(basic_buffer_, basic_size_, basic_pos,
+                             basic_dict_)) {
+      VLOG(10) << "Encoded " << basic_size_ << " strings in "
+               << basic_dict_.size() << " distinct values, data shrinks from "
+               << basic_encoded_pos_ << " to " << basic_pos << " bytes";
+      basic_pos_.store(basic_pos);
+      basic_encoded_pos_ = basic_pos;
+      // Keeps the room resize() reserves for updates.
+      basic_buffer_.resize(basic_size_, basic_pos + (basic_pos + 4) / 5);
+    }
+  }
+  // The extra buffer keeps its data size, since it also holds the room of
+  // the rows not inserted yet.
+  size_t extra_pos = pos_.load();
+  if (extra_size_ != 0 && extra_pos > 2 * extra_encoded_pos_) {
+    extra_encoded_pos_ = extra_pos;
+    if (encode_string_buffer(extra_buffer_, extra_size_, extra_pos,
+                             extra_dict_)) {
+      VLOG(10) << "Encoded " << extra_size_ << " strings in "
+               << extra_dict_.size() << " distinct values, data shrinks from "
+               << extra_encoded_pos_ << " to " << extra_pos << " bytes";
+      pos_.store(extra_pos);
+      extra_encoded_pos_ = extra_pos;
+    }
+  }
+}
+
+void TypedColumn<std::string_view>::open_dictionary(
+    const std::string& prefix) {
+  reset_dictionary();
+  if (basic_size_ != 0 && std::filesystem::exists(prefix + ".dict")) {
+    basic_dict_.open(prefix + ".dict", false);
+    basic_encoded_pos_ = basic_pos_.load();
+  }
+}
+
+void TypedColumn<std::string_view>::reset_dictionary() {
+  basic_dict_.reset();
+  extra_dict_.reset();
+  basic_encoded_pos_ = 0;
+  extra_encoded_pos_ = 0;
+}
+
+namespace compressed_column_impl {
+
+static std::atomic<EpochManager*> epoch_manager{nullptr};
+
+// Keeps the epoch pinned for views that are copied before it is left.
+struct EpochPin {
+  EpochPin()
+      : manager(epoch_manager.load()),
+        epoch(manager == nullptr ? 0 : manager->pin()) {}
+  ~EpochPin() {
+    if (manager != nullptr) {
+      manager->unpin(epoch);
+    }
+  }
+
+  EpochManager* manager;
+  uint64_t epoch;
+};
+
+}  // namespace compressed_column_impl
+
+void CompressedStringColumn::set_epoch_manager(EpochManager* epoch_manager) {
+  compressed_column_impl::epoch_manager.store(epoch_manager);
+}
+
+CompressedStringColumn::CompressedStringColumn(uint16_t width)
+    : compressed_num_(0),
+      delta_(StorageStrategy::kMem, width),
+      size_(0),
+      block_num_(0),
+      resident_num_(0),
+      clock_hand_(0) {}
+
+CompressedStringColumn::CompressedStringColumn()
+    : compressed_num_(0),
+      delta_(StorageStrategy::kMem),
+      size_(0),
+      block_num_(0),
+      resident_num_(0),
+      clock_hand_(0) {}
+
+void CompressedStringColumn::open_blocks(const std::string& prefix) {
+  release_blocks();
+  block_index_.reset();
+  blocks_.reset();
+  compressed_num_ = 0;
+  if (std::filesystem::exists(prefix + ".zindex")) {
+    block_index_.open(prefix + ".zindex", false);
+    blocks_.open(prefix + ".zdata", false);
+    compressed_num_ = block_index_.get(0);
+  }
+  block_num_ = (compressed_num_ + kBlockSize - 1) / kBlockSize;
+  decoded_.reset(new std::atomic<std::string*>[block_num_]);
+  referenced_.reset(new std::atomic<bool>[block_num_]);
+  for (size_t b = 0; b < block_num_; ++b) {
+    decoded_[b].store(nullptr);
+    referenced_[b].store(false);
+  }
+}
+
+// Readers of the column are gone by now, so nothing waits for the epochs.
+void CompressedStringColumn::release_blocks() {
+  std::lock_guard<std::mutex> lock(decode_mutex_);
+  for (size_t b = 0; b < block_num_; ++b) {
+    delete decoded_[b].exchange(nullptr);
+  }
+  for (auto& pair : retired_) {
+    delete pair.second;
+  }
+  retired_.clear();
+  decoded_.reset();
+  referenced_.reset();
+  block_num_ = 0;
+  resident_num_ = 0;
+  clock_hand_ = 0;
+}
+
+void CompressedStringColumn::open(const std::string& name,
+                                  const std::string& snapshot_dir,
+                                  const std::string& work_dir) {
+  open_blocks(snapshot_dir + "/" + name);
+  if (work_dir == "") {
+    // Opens delta_ empty and in memory.
+    delta_.open("", "", "");
+  } else {
+    delta_.open(name, "", work_dir);
+  }
+  // Values left in delta_ by an earlier run are restored by the wal.
+  size_ = std::max(compressed_num_, delta_.size());
+  written_.reset();
+  written_.resize(size_);
+}
+
+void CompressedStringColumn::open_in_memory(const std::string& prefix) {
+  open_blocks(prefix);
+  delta_.open("", "", "");
+  size_ = compressed_num_;
+  written_.reset();
+  written_.resize(size_);
+}
+
+void CompressedStringColumn::copy_to_tmp(const std::string& cur_path,
+                                         const std::string& tmp_path) {
+  if (std::filesystem::exists(cur_path + ".zindex")) {
+    copy_file(cur_path + ".zindex", tmp_path + ".zindex");
+    copy_file(cur_path + ".zdata", tmp_path + ".zdata");
+  }
+  delta_.copy_to_tmp(cur_path, tmp_path);
+}
+
+void CompressedStringColumn::close() {
+  release_blocks();
+  block_index_.reset();
+  blocks_.reset();
+  compressed_num_ = 0;
+  delta_.close();
+  written_.reset();
+  size_ = 0;
+}
+
+void CompressedStringColumn::resize(size_t size) {
+  delta_.resize(size);
+  written_.resize(size);
+  size_ = size;
+}
+
+// A block decompresses to the end offset of each value as uint32_t, then the
+// values. It is stored as its decompressed size as uint32_t, then the
+// compressed stream.
+void CompressedStringColumn::dump(const std::string& filename) {
+  size_t block_num = (size_ + kBlockSize - 1) / kBlockSize;
+  mmap_array<uint64_t> index;
+  index.resize(block_num + 2);
+  index.set(0, size_);
+  mmap_array<char> data;
+  data.resize(std::max<size_t>(blocks_.size(), 4096));
+  size_t pos = 0;
+  std::string raw;
+  compressed_column_impl::EpochPin pin;
+  for (size_t b = 0; b < block_num; ++b) {
+    size_t begin = b * kBlockSize;
+    size_t num = std::min(kBlockSize, size_ - begin);
+    raw.assign(num * sizeof(uint32_t), '\0');
+    for (size_t k = 0; k < num; ++k) {
+      raw.append(get_view(begin + k));
+      uint32_t end = raw.size() - num * sizeof(uint32_t);
+      memcpy(&raw[k * sizeof(uint32_t)], &end, sizeof(end));
+    }
+    size_t bound = sizeof(uint32_t) + lz_compress_bound(raw.size());
+    if (pos + bound > data.size()) {
+      data.resize(std::max(pos + bound, data.size() * 2));
+    }
+    uint32_t raw_size = raw.size();
+    memcpy(data.data() + pos, &raw_size, sizeof(raw_size));
+    index.set(b + 1, pos);
+    pos += sizeof(raw_size);
+    pos += lz_compress(raw.data(), raw.size(), data.data() + pos);
+  }
+  index.set(block_num + 1, pos);
+  data.resize(pos);
+  index.dump(filename + ".zindex");
+  data.dump(filename + ".zdata");
+  VLOG(10) << "Compressed " << size_ << " strings in " << pos << " bytes";
+}
+
+const std::string& CompressedStringColumn::load_block(size_t block) const {
+  std::string* decoded = decoded_[block].load(std::memory_order_acquire);
+  if (decoded != nullptr) {
+    if (!referenced_[block].load(std::memory_order_relaxed)) {
+      referenced_[block].store(true, std::memory_order_relaxed);
+    }
+    return *decoded;
+  }
+  size_t begin = block_index_.get(block + 1);
+  size_t end = block_index_.get(block + 2);
+  uint32_t raw_size;
+  memcpy(&raw_size, blocks_.data() + begin, sizeof(raw_size));
+  auto raw = std::make_unique<std::string>(raw_size, '\0');
+  if (!lz_decompress(blocks_.data() + begin + sizeof(raw_size),
+                     end - begin - sizeof(raw_size), &(*raw)[0], raw_size)) {
+    std::stringstream ss;
+    ss << "Failed to decompress block " << block << " of a string column";
+    LOG(ERROR) << ss.str();
+    throw std::runtime_error(ss.str());
+  }
+  std::lock_guard<std::mutex> lock(decode_mutex_);
+  decoded = decoded_[block].load(std::memory_order_relaxed);
+  if (decoded != nullptr) {
+    // Another reader decompressed it meanwhile.
+    return *decoded;
+  }
+  decoded = raw.release();
+  referenced_[block].store(true, std::memory_order_relaxed);
+  decoded_[block].store(decoded, std::memory_order_release);
+  ++resident_num_;
+  evict_blocks();
+  return *decoded;
+}
+
+void CompressedStringColumn::evict_blocks() const {
+  auto* epoch_manager = compressed_column_impl::epoch_manager.load();
+  if (epoch_manager == nullptr) {
+    return;
+  }
+  uint64_t cur = epoch_manager->try_advance();
+  while (!retired_.empty() &&
+         EpochManager::reclaimable(retired_.front().first, cur)) {
+    delete retired_.front().second;
+    retired_.pop_front();
+  }
+  // Every pass over the blocks clears their bits, so this ends within two.
+  while (resident_num_ > kCacheBlockNum) {
+    size_t b = clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % block_num_;
+    if (decoded_[b].load(std::memory_order_relaxed) == nullptr ||
+        referenced_[b].exchange(false, std::memory_order_relaxed)) {
+      continue;
+    }
+    std::string* victim = decoded_[b].exchange(nullptr);
+    // Read after the exchange: readers that can still see the block pinned
+    // this epoch or an earlier one.
+    retired_.emplace_back(epoch_manager->current(), victim);
+    --resident_num_;
+  }
+}
+
+std::string_view CompressedStringColumn::get_view(size_t idx) const {
+  if (idx < written_.size() && written_.get(idx) != 0) {
+    return delta_.get_view(idx);
+  }
+  if (idx >= compressed_num_) {
+    return std::string_view();
+  }
+  const std::string& block = load_block(idx / kBlockSize);
+  size_t k = idx % kBlockSize;
+  size_t num = std::min(kBlockSize, compressed_num_ - (idx - k));
+  uint32_t begin = 0, end;
+  if (k != 0) {
+    memcpy(&begin, block.data() + (k - 1) * sizeof(uint32_t), sizeof(begin));
+  }
+  memcpy(&end, block.data() + k * sizeof(uint32_t), sizeof(end));
+  return std::string_view(block.data() + num * sizeof(uint32_t) + begin,
+                          end - begin);
+}
+
+Any CompressedStringColumn::get(size_t idx) const {
+  compressed_column_impl::EpochPin pin;
+  return AnyConverter<std::string>::to_any(std::string(get_view(idx)));
+}
+
 std::shared_ptr<RefColumnBase> CreateRefColumn(
     std::shared_ptr<ColumnBase> column) {
   auto type = column->type();
@@ -288,6 +678,10 @@ std::shared_ptr<RefColumnBase> CreateRefColumn(
     return std::make_shared<TypedRefColumn<uint64_t>>(
         *std::dynamic_pointer_cast<TypedColumn<uint64_t>>(column));
   } else if (type == PropertyType::kStringView || type.IsVarchar()) {
+    auto compressed = std::dynamic_pointer_cast<CompressedStringColumn>(column);
+    if (compressed != nullptr) {
+      return std::make_shared<TypedRefColumn<std::string_view>>(*compressed);
+    }
     return std::make_shared<TypedRefColumn<std::string_view>>(
         *std::dynamic_pointer_cast<TypedColumn<std::string_view>>(column));
   } else if (type == PropertyType::kFloat) {
@@ -314,6 +708,16 @@ void TypedColumn<RecordView>::open_in_memory(const std::string& name) {
 
 size_t TypedColumn<RecordView>::size() const { return table_->row_num(); }
 
+MemoryUsage TypedColumn<RecordView>::memory_usage() const {
+  return table_ == nullptr ? MemoryUsage() : table_->memory_usage();
+}
+
+void TypedColumn<RecordView>::warmup() const {
+  if (table_ != nullptr) {
+    table_->warmup();
+  }
+}
+
 void TypedColumn<RecordView>::resize(size_t size) { table_->resize(size); }
 
 void TypedColumn<RecordView>::close() { table_->close(); }
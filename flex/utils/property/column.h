@@ -16,11 +16,17 @@
 #ifndef GRAPHSCOPE_PROPERTY_COLUMN_H_
 #define GRAPHSCOPE_PROPERTY_COLUMN_H_
 
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
 #include "grape/utils/concurrent_queue.h"
 
+#include "flex/utils/epoch_manager.h"
 #include "flex/utils/mmap_array.h"
 #include "flex/utils/property/types.h"
 #include "grape/serialization/out_archive.h"
@@ -52,6 +58,11 @@ class ColumnBase {
                            const std::string& tmp_path) = 0;
   virtual void resize(size_t size) = 0;
 
+  // Reserves room for size rows, so that resizing up to size afterwards
+  // keeps the rows in place for their concurrent readers. A column without
+  // it still moves its rows on growing.
+  virtual void reserve(size_t size) {}
+
   virtual PropertyType type() const = 0;
 
   virtual void set_any(size_t index, const Any& value) = 0;
@@ -60,7 +71,16 @@ class ColumnBase {
 
   virtual void ingest(uint32_t index, grape::OutArchive& arc) = 0;
 
+  // Consumes a value serialized as ingest() reads it, without storing it.
+  virtual void skip(grape::OutArchive& arc) const = 0;
+
   virtual StorageStrategy storage_strategy() const = 0;
+
+  // Bytes mapped by the buffers of the column, and how many are resident.
+  virtual MemoryUsage memory_usage() const { return MemoryUsage(); }
+
+  // Touches the memory counted by memory_usage.
+  virtual void warmup() const {}
 };
 
 template <typename T>
@@ -184,6 +204,12 @@ class TypedColumn : public ColumnBase {
     }
   }
 
+  void reserve(size_t size) override {
+    if (size > basic_buffer_.size()) {
+      extra_buffer_.reserve(size - basic_buffer_.size());
+    }
+  }
+
   PropertyType type() const override { return AnyConverter<T>::type(); }
 
   void set_value(size_t index, const T& val) {
@@ -215,8 +241,24 @@ class TypedColumn : public ColumnBase {
     set_value(index, val);
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    T val;
+    arc >> val;
+  }
+
   StorageStrategy storage_strategy() const override { return strategy_; }
 
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = basic_buffer_.memory_usage();
+    ret += extra_buffer_.memory_usage();
+    return ret;
+  }
+
+  void warmup() const override {
+    basic_buffer_.warmup();
+    extra_buffer_.warmup();
+  }
+
   const mmap_array<T>& basic_buffer() const { return basic_buffer_; }
   size_t basic_buffer_size() const { return basic_size_; }
   const mmap_array<T>& extra_buffer() const { return extra_buffer_; }
@@ -283,11 +325,19 @@ class TypedColumn<RecordView> : public ColumnBase {
     LOG(FATAL) << "RecordView column does not support ingest.";
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    LOG(FATAL) << "RecordView column does not support skip.";
+  }
+
   StorageStrategy storage_strategy() const override {
     LOG(ERROR) << "RecordView column does not have storage strategy.";
     return StorageStrategy::kMem;
   }
 
+  MemoryUsage memory_usage() const override;
+
+  void warmup() const override;
+
   std::vector<PropertyType> sub_types() const { return types_; }
 
  private:
@@ -338,6 +388,8 @@ class TypedColumn<grape::EmptyType> : public ColumnBase {
 
   void ingest(uint32_t index, grape::OutArchive& arc) override {}
 
+  void skip(grape::OutArchive& arc) const override {}
+
   StorageStrategy storage_strategy() const override { return strategy_; }
 
  private:
@@ -349,11 +401,15 @@ class TypedColumn<std::string_view> : public ColumnBase {
   TypedColumn(StorageStrategy strategy, uint16_t width)
       : strategy_(strategy),
         width_(width),
-        type_(PropertyType::Varchar(width_)) {}
+        type_(PropertyType::Varchar(width_)),
+        basic_encoded_pos_(0),
+        extra_encoded_pos_(0) {}
   TypedColumn(StorageStrategy strategy)
       : strategy_(strategy),
         width_(PropertyType::GetStringDefaultMaxLength()),
-        type_(PropertyType::kStringView) {}
+        type_(PropertyType::kStringView),
+        basic_encoded_pos_(0),
+        extra_encoded_pos_(0) {}
   ~TypedColumn() { close(); }
 
   void open(const std::string& name, const std::string& snapshot_dir,
@@ -375,6 +431,7 @@ class TypedColumn<std::string_view> : public ColumnBase {
       extra_size_ = extra_buffer_.size();
       pos_.store(extra_buffer_.data_size());
     }
+    open_dictionary(basic_path);
   }
 
   void open_in_memory(const std::string& prefix) override {
@@ -385,6 +442,7 @@ class TypedColumn<std::string_view> : public ColumnBase {
     extra_buffer_.reset();
     extra_size_ = 0;
     pos_.store(0);
+    open_dictionary(prefix);
   }
 
   void open_with_hugepages(const std::string& prefix, bool force) override {
@@ -397,6 +455,7 @@ class TypedColumn<std::string_view> : public ColumnBase {
       extra_buffer_.set_hugepage_prefered(true);
       extra_size_ = 0;
       pos_.store(0);
+      open_dictionary(prefix);
     } else if (strategy_ == StorageStrategy::kDisk) {
       LOG(INFO) << "Open " << prefix << " with normal mmap pages";
       open_in_memory(prefix);
@@ -427,11 +486,13 @@ class TypedColumn<std::string_view> : public ColumnBase {
     tmp.reset();
 
     pos_.store(offset);
+    reset_dictionary();
   }
 
   void close() override {
     basic_buffer_.reset();
     extra_buffer_.reset();
+    reset_dictionary();
   }
 
   void copy_to_tmp(const std::string& cur_path,
@@ -451,15 +512,26 @@ class TypedColumn<std::string_view> : public ColumnBase {
     extra_buffer_.swap(tmp);
     tmp.reset();
     pos_.store(extra_buffer_.data_size());
+    reset_dictionary();
   }
 
+  // The dictionary of a buffer is dumped along with it, so that the buffer
+  // keeps comparing by code once the snapshot is opened.
   void dump(const std::string& filename) override {
-    if (basic_size_ != 0 && extra_size_ == 0) {
+    if (basic_size_ != 0 && extra_size_ == 0 &&
+        !fragmented(basic_buffer_, basic_size_, basic_pos_.load())) {
       basic_buffer_.resize(basic_size_, basic_pos_.load());
       basic_buffer_.dump(filename);
-    } else if (basic_size_ == 0 && extra_size_ != 0) {
+      if (basic_dict_.size() != 0) {
+        basic_dict_.dump(filename + ".dict");
+      }
+    } else if (basic_size_ == 0 && extra_size_ != 0 &&
+               !fragmented(extra_buffer_, extra_size_, pos_.load())) {
       extra_buffer_.resize(extra_size_, pos_.load());
       extra_buffer_.dump(filename);
+      if (extra_dict_.size() != 0) {
+        extra_dict_.dump(filename + ".dict");
+      }
     } else {
       mmap_array<std::string_view> tmp;
       tmp.open(filename, true);
@@ -511,6 +583,21 @@ class TypedColumn<std::string_view> : public ColumnBase {
     }
   }
 
+  // The data of the rows is reserved by twice the maximum width, to which
+  // values are cut off, so that it does not move as the values of up to size
+  // rows are appended and overwritten, however much longer than the rows of
+  // the snapshot they are. Only the pages written are committed, and the
+  // space of overwritten values is reclaimed as the column is dumped.
+  void reserve(size_t size) override {
+    std::unique_lock<std::shared_mutex> lock(rw_mutex_);
+    if (size <= basic_buffer_.size()) {
+      return;
+    }
+    size_t extra_size = size - basic_buffer_.size();
+    size_t data_size = std::min(extra_size * width_ * 2, MAX_DATA_RESERVE);
+    extra_buffer_.reserve(extra_size, std::max(data_size, pos_.load()));
+  }
+
   PropertyType type() const override { return type_; }
 
   void set_value(size_t idx, const std::string_view& val) {
@@ -571,12 +658,32 @@ class TypedColumn<std::string_view> : public ColumnBase {
     set_value(index, val);
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    std::string_view val;
+    arc >> val;
+  }
+
   const mmap_array<std::string_view>& basic_buffer() const {
     return basic_buffer_;
   }
 
   StorageStrategy storage_strategy() const override { return strategy_; }
 
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = basic_buffer_.memory_usage();
+    ret += extra_buffer_.memory_usage();
+    ret += basic_dict_.memory_usage();
+    ret += extra_dict_.memory_usage();
+    return ret;
+  }
+
+  void warmup() const override {
+    basic_buffer_.warmup();
+    extra_buffer_.warmup();
+    basic_dict_.warmup();
+    extra_dict_.warmup();
+  }
+
   size_t basic_buffer_size() const { return basic_size_; }
 
   const mmap_array<std::string_view>& extra_buffer() const {
@@ -585,7 +692,35 @@ class TypedColumn<std::string_view> : public ColumnBase {
 
   size_t extra_buffer_size() const { return extra_size_; }
 
+  // Distinct values of each buffer in sorted order, empty if the buffer is
+  // not dictionary encoded. See encode_dictionary().
+  const mmap_array<string_item>& basic_dictionary() const {
+    return basic_dict_;
+  }
+
+  const mmap_array<string_item>& extra_dictionary() const {
+    return extra_dict_;
+  }
+
+  // Measures the cardinality of each buffer, and rewrites a buffer of few
+  // distinct values so that each value is stored once, at the head of its
+  // data. Items then point into the dictionary, and equal values have equal
+  // items until they are overwritten. A buffer is only measured again once
+  // its data doubled. Must not run concurrently with readers or writers.
+  void encode_dictionary();
+
  private:
+  // The address space reserved for the data of the extra buffer at most.
+  static constexpr size_t MAX_DATA_RESERVE = size_t(1) << 36;
+
+  void open_dictionary(const std::string& prefix);
+  void reset_dictionary();
+
+  // Whether most of the data of a buffer is taken by overwritten values, so
+  // that it is rewritten with only the current ones as it is dumped.
+  static bool fragmented(const mmap_array<std::string_view>& buffer,
+                         size_t size, size_t pos);
+
   mmap_array<std::string_view> basic_buffer_;
   size_t basic_size_;
   mmap_array<std::string_view> extra_buffer_;
@@ -596,6 +731,11 @@ class TypedColumn<std::string_view> : public ColumnBase {
   std::shared_mutex rw_mutex_;
   uint16_t width_;
   PropertyType type_;
+  mmap_array<string_item> basic_dict_;
+  mmap_array<string_item> extra_dict_;
+  // Data size at the last encoding attempt of each buffer.
+  size_t basic_encoded_pos_;
+  size_t extra_encoded_pos_;
 };
 
 using StringColumn = TypedColumn<std::string_view>;
@@ -644,6 +784,7 @@ class StringMapColumn : public ColumnBase {
 
   size_t size() const override { return index_col_.size(); }
   void resize(size_t size) override { index_col_.resize(size); }
+  void reserve(size_t size) override { index_col_.reserve(size); }
 
   PropertyType type() const override { return PropertyType::kStringMap; }
 
@@ -665,10 +806,26 @@ class StringMapColumn : public ColumnBase {
     set_value(index, val);
   }
 
+  void skip(grape::OutArchive& arc) const override {
+    std::string_view val;
+    arc >> val;
+  }
+
   StorageStrategy storage_strategy() const override {
     return index_col_.storage_strategy();
   }
 
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = index_col_.memory_usage();
+    ret += meta_map_->memory_usage();
+    return ret;
+  }
+
+  void warmup() const override {
+    index_col_.warmup();
+    meta_map_->warmup(1);
+  }
+
   const TypedColumn<INDEX_T>& get_index_col() const { return index_col_; }
   const LFIndexer<INDEX_T>& get_meta_map() const { return *meta_map_; }
 
@@ -730,10 +887,153 @@ void StringMapColumn<INDEX_T>::set_value(size_t idx,
 
 using DefaultStringMapColumn = StringMapColumn<uint8_t>;
 
+// A string column for long values that are rarely filtered on and mostly read
+// for a few rows, e.g. descriptions projected for the final rows of a query.
+// Values are stored in LZ compressed blocks of kBlockSize consecutive rows,
+// which are built by dump(), so an opened snapshot is entirely compressed.
+// Values set afterwards go to a plain delta column until the next dump.
+// Selected with the Compressed storage strategy.
+class CompressedStringColumn : public ColumnBase {
+ public:
+  static constexpr size_t kBlockSize = 64;
+  // Blocks each column keeps decompressed before it evicts some.
+  static constexpr size_t kCacheBlockNum = 1024;
+
+  // Evicted blocks are retired to epoch_manager and freed once no reader
+  // pinned before the eviction is left. Without an epoch manager no block is
+  // evicted until the column is closed.
+  static void set_epoch_manager(EpochManager* epoch_manager);
+
+  CompressedStringColumn(uint16_t width);
+  CompressedStringColumn();
+  ~CompressedStringColumn() { close(); }
+
+  void open(const std::string& name, const std::string& snapshot_dir,
+            const std::string& work_dir) override;
+  void open_in_memory(const std::string& prefix) override;
+  // Blocks are small and read-mostly, they are not worth huge pages.
+  void open_with_hugepages(const std::string& prefix, bool force) override {
+    open_in_memory(prefix);
+  }
+  void touch(const std::string& filename) override { delta_.touch(filename); }
+  void dump(const std::string& filename) override;
+  void copy_to_tmp(const std::string& cur_path,
+                   const std::string& tmp_path) override;
+  void close() override;
+
+  size_t size() const override { return size_; }
+  void resize(size_t size) override;
+
+  PropertyType type() const override { return delta_.type(); }
+
+  void set_value(size_t idx, const std::string_view& val) {
+    delta_.set_value(idx, val);
+    written_.set(idx, 1);
+  }
+
+  void set_value_safe(size_t idx, const std::string_view& val) {
+    delta_.set_value_safe(idx, val);
+    written_.set(idx, 1);
+  }
+
+  void set_any(size_t idx, const Any& value) override {
+    set_value(idx, value.AsStringView());
+  }
+
+  // The view points into a decompressed block shared by all threads, and
+  // stays valid while the caller keeps the epoch it pinned, i.e. until its
+  // read or update transaction ends. Values kept longer must be copied.
+  std::string_view get_view(size_t idx) const;
+
+  // Unlike get_view(), the returned value owns its string and needs no pin.
+  Any get(size_t idx) const override;
+
+  void ingest(uint32_t index, grape::OutArchive& arc) override {
+    std::string_view val;
+    arc >> val;
+    set_value(index, val);
+  }
+
+  void skip(grape::OutArchive& arc) const override {
+    std::string_view val;
+    arc >> val;
+  }
+
+  StorageStrategy storage_strategy() const override {
+    return StorageStrategy::kCompressed;
+  }
+
+  // Bytes taken by the compressed blocks.
+  size_t compressed_size() const { return blocks_.size(); }
+
+  MemoryUsage memory_usage() const override {
+    MemoryUsage ret = block_index_.memory_usage();
+    ret += blocks_.memory_usage();
+    ret += delta_.memory_usage();
+    ret += written_.memory_usage();
+    return ret;
+  }
+
+  void warmup() const override {
+    block_index_.warmup();
+    blocks_.warmup();
+    delta_.warmup();
+    written_.warmup();
+  }
+
+ private:
+  void open_blocks(const std::string& prefix);
+  void release_blocks();
+  const std::string& load_block(size_t block) const;
+  // Called with decode_mutex_ held.
+  void evict_blocks() const;
+
+  // The number of rows in blocks, then the start of each block in blocks_,
+  // then the end of the last block.
+  mmap_array<uint64_t> block_index_;
+  mmap_array<char> blocks_;
+  size_t compressed_num_;
+  StringColumn delta_;
+  // 1 for the rows whose value is in delta_.
+  mmap_array<uint8_t> written_;
+  size_t size_;
+  // The decompressed blocks, null for those not resident. referenced_ is the
+  // second chance bit of the clock that picks the blocks to evict.
+  std::unique_ptr<std::atomic<std::string*>[]> decoded_;
+  std::unique_ptr<std::atomic<bool>[]> referenced_;
+  size_t block_num_;
+  mutable std::mutex decode_mutex_;
+  mutable size_t resident_num_;
+  mutable size_t clock_hand_;
+  // Evicted blocks with the epoch they were retired in.
+  mutable std::deque<std::pair<uint64_t, std::string*>> retired_;
+};
+
 std::shared_ptr<ColumnBase> CreateColumn(
     PropertyType type, StorageStrategy strategy = StorageStrategy::kMem,
     const std::vector<PropertyType>& sub_types = {});
 
+// Sets row dst_row(i) of dst to row i of src for i in [0, num), as set_any()
+// does, but growing the data of a string column when the values do not fit
+// in the space left, as the loaders do for the rows they append.
+template <typename ROW_FUNC_T>
+void copy_column_rows(const ColumnBase& src, size_t num, ColumnBase& dst,
+                      const ROW_FUNC_T& dst_row) {
+  if (auto typed = dynamic_cast<StringColumn*>(&dst)) {
+    for (size_t i = 0; i < num; ++i) {
+      typed->set_value_safe(dst_row(i), src.get(i).AsStringView());
+    }
+  } else if (auto compressed = dynamic_cast<CompressedStringColumn*>(&dst)) {
+    for (size_t i = 0; i < num; ++i) {
+      compressed->set_value_safe(dst_row(i), src.get(i).AsStringView());
+    }
+  } else {
+    for (size_t i = 0; i < num; ++i) {
+      dst.set_any(dst_row(i), src.get(i));
+    }
+  }
+}
+
 #ifdef USE_PTHASH
 template <typename EDATA_T>
 class ConcatColumn : public ColumnBase {
@@ -797,6 +1097,10 @@ class ConcatColumn : public ColumnBase {
     LOG(FATAL) << "not implemented";
   }
 
+  void skip(grape::OutArchive& arc) const {
+    LOG(FATAL) << "not implemented";
+  }
+
   StorageStrategy storage_strategy() const {
     return basic_column_.storage_strategy();
   }
@@ -855,6 +1159,152 @@ class TypedRefColumn : public RefColumnBase {
   StorageStrategy strategy_;
 };
 
+// Identifies a string in the dictionaries of a string column, so that values
+// can be matched by their items instead of their bytes. See
+// TypedColumn<std::string_view>::encode_dictionary().
+struct StringDictCode {
+  static constexpr uint64_t kNoCode = std::numeric_limits<uint64_t>::max();
+
+  uint64_t basic_code = kNoCode;
+  size_t basic_end = 0;
+  uint64_t extra_code = kNoCode;
+  size_t extra_end = 0;
+};
+
+template <>
+class TypedRefColumn<std::string_view> : public RefColumnBase {
+ public:
+  using value_type = std::string_view;
+
+  TypedRefColumn(const mmap_array<std::string_view>& buffer,
+                 StorageStrategy strategy)
+      : basic_buffer(buffer),
+        basic_size(0),
+        extra_buffer(buffer),
+        extra_size(buffer.size()),
+        basic_dict(nullptr),
+        extra_dict(nullptr),
+        compressed(nullptr),
+        strategy_(strategy) {}
+  TypedRefColumn(const TypedColumn<std::string_view>& column)
+      : basic_buffer(column.basic_buffer()),
+        basic_size(column.basic_buffer_size()),
+        extra_buffer(column.extra_buffer()),
+        extra_size(column.extra_buffer_size()),
+        basic_dict(&column.basic_dictionary()),
+        extra_dict(&column.extra_dictionary()),
+        compressed(nullptr),
+        strategy_(column.storage_strategy()) {}
+  // Views of a compressed column point into the block cache of the reading
+  // thread, see CompressedStringColumn::get_view().
+  TypedRefColumn(const CompressedStringColumn& column)
+      : basic_buffer(empty_buffer()),
+        basic_size(0),
+        extra_buffer(empty_buffer()),
+        extra_size(0),
+        basic_dict(nullptr),
+        extra_dict(nullptr),
+        compressed(&column),
+        strategy_(column.storage_strategy()) {}
+  ~TypedRefColumn() {}
+
+  inline std::string_view get_view(size_t index) const {
+    if (compressed != nullptr) {
+      return compressed->get_view(index);
+    }
+    return index < basic_size ? basic_buffer.get(index)
+                              : extra_buffer.get(index - basic_size);
+  }
+
+  size_t size() const {
+    return compressed != nullptr ? compressed->size()
+                                 : basic_size + extra_size;
+  }
+
+  Any get(size_t index) const override {
+    if (compressed != nullptr) {
+      return compressed->get(index);
+    }
+    return AnyConverter<std::string_view>::to_any(get_view(index));
+  }
+
+  // The code is only valid until the column is encoded again, i.e. within a
+  // transaction.
+  StringDictCode get_code(const std::string_view& val) const {
+    StringDictCode code;
+    code.basic_code = find_code(basic_buffer, basic_dict, val, code.basic_end);
+    code.extra_code = find_code(extra_buffer, extra_dict, val, code.extra_end);
+    return code;
+  }
+
+  // Values stored in a dictionary are compared by item, others by bytes.
+  inline bool equals(size_t index, const std::string_view& val,
+                     const StringDictCode& code) const {
+    if (compressed != nullptr) {
+      return compressed->get_view(index) == val;
+    }
+    if (index < basic_size) {
+      return match(basic_buffer, index, val, code.basic_code, code.basic_end);
+    }
+    return match(extra_buffer, index - basic_size, val, code.extra_code,
+                 code.extra_end);
+  }
+
+ private:
+  static const mmap_array<std::string_view>& empty_buffer() {
+    static const mmap_array<std::string_view> buffer;
+    return buffer;
+  }
+
+  static inline uint64_t pack(const string_item& item) {
+    return (static_cast<uint64_t>(item.offset) << 16) | item.length;
+  }
+
+  static inline bool match(const mmap_array<std::string_view>& buffer,
+                           size_t index, const std::string_view& val,
+                           uint64_t code, size_t end) {
+    const string_item& item = buffer.get_item(index);
+    if (item.offset < end) {
+      return pack(item) == code;
+    }
+    return buffer.get_data(item) == val;
+  }
+
+  static uint64_t find_code(const mmap_array<std::string_view>& buffer,
+                            const mmap_array<string_item>* dict,
+                            const std::string_view& val, size_t& end) {
+    end = 0;
+    if (dict == nullptr || dict->size() == 0) {
+      return StringDictCode::kNoCode;
+    }
+    const string_item& last = dict->get(dict->size() - 1);
+    end = last.offset + last.length;
+    size_t lo = 0, hi = dict->size();
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      if (buffer.get_data(dict->get(mid)) < val) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (lo < dict->size() && buffer.get_data(dict->get(lo)) == val) {
+      return pack(dict->get(lo));
+    }
+    return StringDictCode::kNoCode;
+  }
+
+  const mmap_array<std::string_view>& basic_buffer;
+  size_t basic_size;
+  const mmap_array<std::string_view>& extra_buffer;
+  size_t extra_size;
+  const mmap_array<string_item>* basic_dict;
+  const mmap_array<string_item>* extra_dict;
+  const CompressedStringColumn* compressed;
+
+  StorageStrategy strategy_;
+};
+
 template <>
 class TypedRefColumn<LabelKey> : public RefColumnBase {
  public:
@@ -15,6 +15,8 @@
 
 #include "flex/utils/property/table.h"
 
+#include <algorithm>
+
 namespace gs {
 
 Table::Table() : touched_(false) {}
@@ -134,6 +136,53 @@ void Table::reset_header(const std::vector<std::string>& col_name) {
   col_id_indexer_.swap(new_col_id_indexer);
 }
 
+void Table::add_column(const std::string& name, const std::string& work_dir,
+                       const std::string& col_name, const PropertyType& type,
+                       StorageStrategy strategy, size_t row_num,
+                       size_t reserved) {
+  int col_id;
+  CHECK(col_id_indexer_.add(col_name, col_id));
+  CHECK_EQ(static_cast<size_t>(col_id), columns_.size());
+  auto column = CreateColumn(type, strategy);
+  if (work_dir.empty()) {
+    column->open_in_memory("");
+  } else {
+    column->open(name, "", work_dir);
+  }
+  column->resize(row_num);
+  column->reserve(reserved);
+  columns_.push_back(column);
+  buildColumnPtrs();
+}
+
+void Table::drop_column(size_t col_id, const std::string& tombstone_name) {
+  CHECK_LT(col_id, columns_.size());
+  auto names = column_names();
+  names[col_id] = tombstone_name;
+  // The readers holding the column keep it until they are done.
+  columns_[col_id] = CreateColumn(PropertyType::kEmpty);
+  reset_header(names);
+  buildColumnPtrs();
+}
+
+void Table::compact_columns() {
+  auto names = column_names();
+  std::vector<std::string> kept_names;
+  std::vector<std::shared_ptr<ColumnBase>> kept_columns;
+  for (size_t col_i = 0; col_i < columns_.size(); ++col_i) {
+    if (columns_[col_i]->type() != PropertyType::kEmpty) {
+      kept_names.push_back(names[col_i]);
+      kept_columns.push_back(columns_[col_i]);
+    }
+  }
+  if (kept_columns.size() == columns_.size()) {
+    return;
+  }
+  columns_.swap(kept_columns);
+  reset_header(kept_names);
+  buildColumnPtrs();
+}
+
 std::vector<std::string> Table::column_names() const {
   size_t col_num = col_id_indexer_.size();
   std::vector<std::string> names(col_num);
@@ -216,11 +265,28 @@ const std::shared_ptr<ColumnBase> Table::get_column_by_id(size_t index) const {
 }
 
 size_t Table::col_num() const { return columns_.size(); }
+
+MemoryUsage Table::memory_usage() const {
+  MemoryUsage ret;
+  for (auto col : column_ptrs_) {
+    ret += col->memory_usage();
+  }
+  return ret;
+}
+
+void Table::warmup() const {
+  for (auto col : column_ptrs_) {
+    col->warmup();
+  }
+}
+
 size_t Table::row_num() const {
-  if (columns_.empty()) {
-    return 0;
+  // The columns dropped are empty, see drop_column.
+  size_t ret = 0;
+  for (const auto& col : columns_) {
+    ret = std::max(ret, col->size());
   }
-  return columns_[0]->size();
+  return ret;
 }
 std::vector<std::shared_ptr<ColumnBase>>& Table::columns() { return columns_; }
 // get column pointers
@@ -254,17 +320,54 @@ void Table::resize(size_t row_num) {
   }
 }
 
+void Table::reserve(size_t row_num) {
+  for (auto col : columns_) {
+    col->reserve(row_num);
+  }
+}
+
+void Table::encode_dictionary() {
+  for (auto& col : columns_) {
+    auto string_col = dynamic_cast<StringColumn*>(col.get());
+    if (string_col != nullptr) {
+      string_col->encode_dictionary();
+    }
+  }
+}
+
+void Table::permute(const std::vector<uint32_t>& new_index) {
+  for (auto& col : columns_) {
+    auto new_col = CreateColumn(col->type(), col->storage_strategy());
+    new_col->open_in_memory("");
+    new_col->resize(col->size());
+    for (size_t i = 0; i < new_index.size(); ++i) {
+      new_col->set_any(new_index[i], col->get(i));
+    }
+    col = new_col;
+  }
+  buildColumnPtrs();
+  encode_dictionary();
+}
+
 void Table::ingest(uint32_t index, grape::OutArchive& arc) {
   if (column_ptrs_.size() == 0) {
     return;
   }
 
-  CHECK_GT(row_num(), index);
+  size_t rows = row_num();
+  // Unless all columns were dropped.
+  CHECK(rows > index || rows == 0);
   for (auto col : column_ptrs_) {
     col->ingest(index, arc);
   }
 }
 
+void Table::skip(grape::OutArchive& arc) const {
+  for (auto col : column_ptrs_) {
+    col->skip(arc);
+  }
+}
+
 void Table::buildColumnPtrs() {
   size_t col_num = columns_.size();
   column_ptrs_.clear();
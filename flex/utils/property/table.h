@@ -64,6 +64,22 @@ class Table {
 
   void reset_header(const std::vector<std::string>& col_name);
 
+  // Appends a column, mapped from the file name in work_dir, or in memory if
+  // work_dir is empty. Its row_num rows read the default value of the type,
+  // and no page is written until they are set. reserved is as in reserve().
+  void add_column(const std::string& name, const std::string& work_dir,
+                  const std::string& col_name, const PropertyType& type,
+                  StorageStrategy strategy, size_t row_num, size_t reserved);
+
+  // Replaces column col_id by an empty one named tombstone_name, freeing its
+  // storage. The ids of the other columns stay as they are until
+  // compact_columns().
+  void drop_column(size_t col_id, const std::string& tombstone_name);
+
+  // Removes the columns dropped before, the ids of the columns after each of
+  // them move down by one.
+  void compact_columns();
+
   std::vector<std::string> column_names() const;
 
   std::string column_name(size_t index) const;
@@ -82,6 +98,13 @@ class Table {
 
   const std::shared_ptr<ColumnBase> get_column_by_id(size_t index) const;
 
+  // Returns the column with the given id if it is stored as a TypedColumn<T>,
+  // nullptr otherwise.
+  template <typename T>
+  inline const TypedColumn<T>* get_typed_column(size_t col_id) const {
+    return dynamic_cast<const TypedColumn<T>*>(column_ptrs_[col_id]);
+  }
+
   size_t col_num() const;
   size_t row_num() const;
   std::vector<std::shared_ptr<ColumnBase>>& columns();
@@ -97,6 +120,22 @@ class Table {
 
   void resize(size_t row_num);
 
+  // Reserves room for row_num rows in the columns, see ColumnBase::reserve.
+  void reserve(size_t row_num);
+
+  // Sum of the memory usage of the columns.
+  MemoryUsage memory_usage() const;
+
+  void warmup() const;
+
+  // Dictionary encodes the string columns of few distinct values, see
+  // TypedColumn<std::string_view>::encode_dictionary().
+  void encode_dictionary();
+
+  // Moves row i to row new_index[i] in every column, where new_index is a
+  // permutation of the first new_index.size() rows.
+  void permute(const std::vector<uint32_t>& new_index);
+
   inline Any at(size_t row_id, size_t col_id) {
     return column_ptrs_[col_id]->get(row_id);
   }
@@ -107,6 +146,9 @@ class Table {
 
   void ingest(uint32_t index, grape::OutArchive& arc);
 
+  // Consumes a row serialized as ingest() reads it.
+  void skip(grape::OutArchive& arc) const;
+
   void close();
 
  private:
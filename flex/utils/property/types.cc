@@ -109,7 +109,7 @@ uint16_t PropertyType::GetStringDefaultMaxLength() {
 size_t RecordView::size() const { return table->col_num(); }
 
 Any RecordView::operator[](size_t col_id) const {
-  return table->get_column_by_id(col_id)->get(offset);
+  return table->at(offset, col_id);
 }
 
 std::string RecordView::to_string() const {
@@ -59,6 +59,9 @@ enum class StorageStrategy {
   kNone,
   kMem,
   kDisk,
+  // Only for string properties, see CompressedStringColumn. Others are kept
+  // as kMem.
+  kCompressed,
 };
 
 namespace impl {
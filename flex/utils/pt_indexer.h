@@ -67,9 +67,65 @@ struct murmurhash2_64 {
   }
 };
 
+class mem_buffer_saver {
+ public:
+  mem_buffer_saver() = default;
+  ~mem_buffer_saver() = default;
+
+  template <typename T>
+  void visit(T& val) {
+    if constexpr (std::is_pod<T>::value) {
+      char* ptr = reinterpret_cast<char*>(&val);
+      buf_.insert(buf_.end(), ptr, ptr + sizeof(T));
+    } else {
+      val.visit(*this);
+    }
+  }
+
+  template <typename T, typename Allocator>
+  void visit(std::vector<T, Allocator>& vec) {
+    if constexpr (std::is_pod<T>::value) {
+      size_t n = vec.size();
+      visit(n);
+      char* ptr = reinterpret_cast<char*>(vec.data());
+      buf_.insert(buf_.end(), ptr, ptr + sizeof(T) * n);
+    } else {
+      size_t n = vec.size();
+      visit(n);
+      for (auto& v : vec)
+        visit(v);
+    }
+  }
+
+  std::vector<char>& buffer() { return buf_; }
+
+ private:
+  std::vector<char> buf_;
+};
+
 template <typename KEY_T, typename INDEX_T>
 class PTIndexerBuilder;
 
+typedef pthash::single_phf<murmurhash2_64, pthash::dictionary_dictionary, true>
+    pthash_type;
+
+inline pthash::build_configuration pthash_build_config(size_t key_num) {
+  pthash::build_configuration config;
+  config.c = 7.0;
+  config.alpha = 0.94;
+  int thread_num = std::thread::hardware_concurrency();
+  if (key_num > 121242388) {
+    config.num_threads = std::min(thread_num, 32);
+  } else if (key_num > 100) {
+    config.num_threads = std::min(thread_num, 16);
+  } else {
+    config.num_threads = 1;
+  }
+  config.minimal_output = true;
+  config.verbose_output = false;
+  return config;
+}
+
 template <typename INDEX_T>
 class PTIndexer {
  public:
@@ -86,13 +142,20 @@ class PTIndexer {
   PTIndexer(PTIndexer&& rhs)
       : keys_(rhs.keys_),
         base_map_(rhs.base_map_),
+        slots_(std::move(rhs.slots_)),
         base_size_(rhs.base_size_),
         extra_indexer_(std::move(rhs.extra_indexer_)) {
     rhs.keys_ = nullptr;
     rhs.concat_keys_ = nullptr;
   }
 
-  void warmup(int) const {}
+  void warmup(int thread_num) const {
+    slots_.warmup();
+    extra_indexer_.warmup(thread_num);
+    if (keys_ != nullptr) {
+      keys_->warmup();
+    }
+  }
   static std::string prefix() { return "pthash"; }
 
   void reserve(size_t capacity) {
@@ -103,12 +166,26 @@ class PTIndexer {
 
   size_t size() const { return base_size_ + extra_indexer_.size(); }
   size_t capacity() const { return base_size_ + extra_indexer_.capacity(); }
+
+  // The perfect hash function itself is not counted, as it is read into
+  // memory owned by pthash.
+  MemoryUsage memory_usage() const {
+    MemoryUsage ret = slots_.memory_usage();
+    ret += extra_indexer_.memory_usage();
+    if (keys_ != nullptr) {
+      ret += keys_->memory_usage();
+    }
+    return ret;
+  }
   PropertyType get_type() const { return keys_->type(); }
 
+  // Number of keys inserted since the perfect hash was built.
+  size_t extra_size() const { return extra_indexer_.size(); }
+
   INDEX_T get_index(const Any& key) const {
     assert(key.type == get_type());
-    size_t index = base_map_(key.AsInt64());
-    if (index < base_size_ && keys_->get(index) == key) {
+    INDEX_T index;
+    if (get_base_index(key, index)) {
       return index;
     } else {
       return extra_indexer_.get_index(key) + base_size_;
@@ -117,9 +194,7 @@ class PTIndexer {
 
   bool get_index(const Any& oid, INDEX_T& ret) const {
     assert(oid.type == get_type());
-    size_t index = base_map_(oid);
-    if (index < base_size_ && keys_->get(index) == oid) {
-      ret = index;
+    if (get_base_index(oid, ret)) {
       return true;
     } else {
       if (extra_indexer_.get_index(oid, ret)) {
@@ -130,15 +205,90 @@ class PTIndexer {
     }
   }
 
+  // As LFIndexer::get_index_batch, looking up one key at a time.
+  template <typename KEY_T>
+  void get_index_batch(const KEY_T* keys, size_t num, INDEX_T* ret) const {
+    for (size_t i = 0; i < num; ++i) {
+      Any oid = Any::From(keys[i]);
+      if (oid.type != get_type() || !get_index(oid, ret[i])) {
+        ret[i] = std::numeric_limits<INDEX_T>::max();
+      }
+    }
+  }
+
   INDEX_T insert(const Any& oid) {
     assert(oid.type == get_type());
-    size_t index = base_map_(oid);
-    if (index < base_size_ && keys_->get(index) == oid) {
+    INDEX_T index;
+    if (get_base_index(oid, index)) {
       return index;
     }
     return extra_indexer_.insert(oid) + base_size_;
   }
 
+  // Rebuilds the perfect hash over every key, so that the keys inserted since
+  // it was built are no longer looked up in extra_indexer_. Indices are kept,
+  // slots_ maps the positions of the new hash to them. Must not run
+  // concurrently with lookups or insertions.
+  void rebuild() {
+    double t = -grape::GetCurrentTime();
+    size_t key_num = size();
+    std::vector<Any> keys(key_num);
+    for (size_t i = 0; i < key_num; ++i) {
+      keys[i] = get_key(i);
+    }
+    auto config = pthash_build_config(key_num);
+    pthash_type phf;
+    phf.build_in_internal_memory(keys.begin(), keys.size(), config);
+
+    PropertyType type = get_type();
+    ColumnBase* old_keys = keys_;
+    keys_ = nullptr;
+    init(type);
+    keys_->open_in_memory("");
+    keys_->resize(key_num);
+    mmap_array<INDEX_T> slots;
+    slots.resize(key_num);
+    {
+      std::vector<std::thread> threads;
+      std::atomic<size_t> offset(0);
+      const size_t chunk = 4096;
+      for (size_t i = 0; i < config.num_threads; ++i) {
+        threads.emplace_back([&]() {
+          while (true) {
+            size_t begin = offset.fetch_add(chunk);
+            if (begin >= key_num) {
+              break;
+            }
+            size_t end = std::min(begin + chunk, key_num);
+            while (begin < end) {
+              keys_->set_any(begin, keys[begin]);
+              slots.set(phf(keys[begin]), begin);
+              ++begin;
+            }
+          }
+        });
+      }
+      for (auto& thrd : threads) {
+        thrd.join();
+      }
+    }
+    // keys points into the old columns until here.
+    keys.clear();
+    delete old_keys;
+
+    mem_buffer_saver saver;
+    saver.visit(phf);
+    base_map_.Init(saver.buffer());
+    slots_.swap(slots);
+    base_size_ = key_num;
+    extra_indexer_.init(type);
+    extra_indexer_.open_in_memory("");
+    extra_indexer_.reserve(base_size_ / 2);
+    t += grape::GetCurrentTime();
+    LOG(INFO) << "rebuild pthash of " << key_num << " keys with "
+              << config.num_threads << " threads: " << t << "s";
+  }
+
   Any get_key(const INDEX_T& index) const {
     return index < base_size_ ? keys_->get(index)
                               : extra_indexer_.get_key(index - base_size_);
@@ -159,11 +309,15 @@ class PTIndexer {
     keys_->resize(base_size_);
     keys_->dump(snapshot_dir + "/" + name + ".base_map.keys");
     base_map_.Save(snapshot_dir + "/" + name + ".base_map");
+    if (slots_.size() != 0) {
+      slots_.dump(snapshot_dir + "/" + name + ".base_map.slots");
+    }
     extra_indexer_.dump(name + ".extra_indexer", snapshot_dir);
   }
 
   void close() {
     keys_->close();
+    slots_.reset();
     extra_indexer_.close();
   }
 
@@ -209,6 +363,7 @@ class PTIndexer {
             const std::string& work_dir) {
     load_meta(snapshot_dir + "/" + name + ".meta");
     base_map_.Open(snapshot_dir + "/" + name + ".base_map");
+    open_slots(snapshot_dir + "/" + name + ".base_map.slots");
     keys_->open(name + ".base_map.keys", snapshot_dir, work_dir);
     extra_indexer_.open(name + ".extra_indexer", snapshot_dir, work_dir);
 
@@ -218,6 +373,7 @@ class PTIndexer {
   void open_in_memory(const std::string& name) {
     load_meta(name + ".meta");
     base_map_.Open(name + ".base_map");
+    open_slots(name + ".base_map.slots");
     keys_->open_in_memory(name + ".base_map.keys");
     extra_indexer_.open_in_memory(name + ".extra_indexer");
     extra_indexer_.reserve(base_size_ / 2);
@@ -227,6 +383,7 @@ class PTIndexer {
     load_meta(name + ".meta");
     keys_->open_with_hugepages(name + ".keys", true);
     base_map_.Open(name + ".base_map");
+    open_slots(name + ".base_map.slots");
     extra_indexer_.open_with_hugepages(name, hugepage_table);
     extra_indexer_.reserve(base_size_ / 2);
   }
@@ -265,55 +422,42 @@ class PTIndexer {
   template <typename _KEY_T, typename _INDEX_T>
   friend class PTIndexerBuilder;
 
-  ColumnBase* keys_;
-  SinglePHFView<murmurhash2_64> base_map_;
-  size_t base_size_;
-  LFIndexer<INDEX_T> extra_indexer_;
-  mutable ColumnBase* concat_keys_;
-};
-
-class mem_buffer_saver {
- public:
-  mem_buffer_saver() = default;
-  ~mem_buffer_saver() = default;
-
-  template <typename T>
-  void visit(T& val) {
-    if constexpr (std::is_pod<T>::value) {
-      char* ptr = reinterpret_cast<char*>(&val);
-      buf_.insert(buf_.end(), ptr, ptr + sizeof(T));
-    } else {
-      val.visit(*this);
+  inline bool get_base_index(const Any& oid, INDEX_T& ret) const {
+    size_t index = base_map_(oid);
+    if (index >= base_size_) {
+      return false;
+    }
+    if (slots_.size() != 0) {
+      index = slots_.get(index);
+    }
+    if (keys_->get(index) == oid) {
+      ret = index;
+      return true;
     }
+    return false;
   }
 
-  template <typename T, typename Allocator>
-  void visit(std::vector<T, Allocator>& vec) {
-    if constexpr (std::is_pod<T>::value) {
-      size_t n = vec.size();
-      visit(n);
-      char* ptr = reinterpret_cast<char*>(vec.data());
-      buf_.insert(buf_.end(), ptr, ptr + sizeof(T) * n);
-    } else {
-      size_t n = vec.size();
-      visit(n);
-      for (auto& v : vec)
-        visit(v);
+  // Perfect hashes built by the loader place each key at its index, and
+  // have no slots file.
+  void open_slots(const std::string& filename) {
+    slots_.reset();
+    if (std::filesystem::exists(filename)) {
+      slots_.open(filename, false);
     }
   }
 
-  std::vector<char>& buffer() { return buf_; }
-
- private:
-  std::vector<char> buf_;
+  ColumnBase* keys_;
+  SinglePHFView<murmurhash2_64> base_map_;
+  // Index of the key at each position of base_map_, empty if the position
+  // is the index.
+  mmap_array<INDEX_T> slots_;
+  size_t base_size_;
+  LFIndexer<INDEX_T> extra_indexer_;
+  mutable ColumnBase* concat_keys_;
 };
 
 template <typename KEY_T, typename INDEX_T>
 class PTIndexerBuilder {
-  typedef pthash::single_phf<murmurhash2_64, pthash::dictionary_dictionary,
-                             true>
-      pthash_type;
-
  public:
   PTIndexerBuilder() = default;
   ~PTIndexerBuilder() = default;
@@ -323,19 +467,7 @@ class PTIndexerBuilder {
   void finish(const std::string& filename, const std::string& work_dir,
               PTIndexer<INDEX_T>& output) {
     double t = -grape::GetCurrentTime();
-    pthash::build_configuration config;
-    config.c = 7.0;
-    config.alpha = 0.94;
-    int thread_num = std::thread::hardware_concurrency();
-    if (keys_.size() > 121242388) {
-      config.num_threads = std::min(thread_num, 32);
-    } else if (keys_.size() > 100) {
-      config.num_threads = std::min(thread_num, 16);
-    } else {
-      config.num_threads = 1;
-    }
-    config.minimal_output = true;
-    config.verbose_output = false;
+    auto config = pthash_build_config(keys_.size());
 
     pthash_type phf;
     phf.build_in_internal_memory(keys_.begin(), keys_.size(), config);
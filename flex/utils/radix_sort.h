@@ -0,0 +1,91 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_RADIX_SORT_H_
+#define GRAPHSCOPE_UTILS_RADIX_SORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace gs {
+
+namespace radix_sort_impl {
+
+static constexpr size_t kSmallRange = 64;
+
+template <typename T, typename KEY_T>
+void sort(T* first, T* last, const KEY_T& key, int shift) {
+  size_t len = last - first;
+  if (len < kSmallRange) {
+    std::sort(first, last,
+              [&](const T& a, const T& b) { return key(a) < key(b); });
+    return;
+  }
+  size_t count[256] = {0};
+  for (T* p = first; p != last; ++p) {
+    ++count[(key(*p) >> shift) & 0xff];
+  }
+  size_t head[256], tail[256];
+  size_t offset = 0;
+  for (int b = 0; b < 256; ++b) {
+    head[b] = offset;
+    offset += count[b];
+    tail[b] = offset;
+  }
+  // Swaps every element into its bucket, in place.
+  using std::swap;
+  for (int b = 0; b < 256; ++b) {
+    while (head[b] < tail[b]) {
+      T& cur = first[head[b]];
+      size_t digit = (key(cur) >> shift) & 0xff;
+      if (digit == static_cast<size_t>(b)) {
+        ++head[b];
+      } else {
+        swap(cur, first[head[digit]++]);
+      }
+    }
+  }
+  if (shift == 0) {
+    return;
+  }
+  offset = 0;
+  for (int b = 0; b < 256; ++b) {
+    if (count[b] > 1) {
+      sort(first + offset, first + offset + count[b], key, shift - 8);
+    }
+    offset += count[b];
+  }
+}
+
+}  // namespace radix_sort_impl
+
+// Sorts [first, last) by key(x), an unsigned integer not greater than
+// max_key, in place and most significant byte first. Unlike std::sort the
+// cost grows with the number of bytes of max_key rather than with the
+// logarithm of the length. The sort is not stable.
+template <typename T, typename KEY_T>
+void inplace_radix_sort(T* first, T* last, const KEY_T& key, size_t max_key) {
+  int shift = 0;
+  while (shift + 8 < static_cast<int>(sizeof(size_t) * 8) &&
+         (max_key >> (shift + 8)) != 0) {
+    shift += 8;
+  }
+  radix_sort_impl::sort(first, last, key, shift);
+}
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_RADIX_SORT_H_
@@ -157,7 +157,9 @@ gs::Status OSSRemoteStorageUploader::Put(const std::string& local_path,
 
   AlibabaCloud::OSS::UploadObjectRequest request(conf_.bucket_name_,
                                                  remote_path, local_path);
-  request.MetaData().addHeader("x-oss-forbid-overwrite", "true");
+  if (!override) {
+    request.MetaData().addHeader("x-oss-forbid-overwrite", "true");
+  }
   request.setPartSize(conf_.partition_size_);
   request.setThreadNum(conf_.concurrency_);  // Increase the thread number to
                                              // improve the upload speed
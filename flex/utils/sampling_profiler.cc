@@ -0,0 +1,386 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/sampling_profiler.h"
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <glog/logging.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace gs {
+
+namespace sampling_impl {
+
+// The frames of the signal handler and of the trampoline of the kernel,
+// above the interrupted one.
+static constexpr int kSkippedFrames = 2;
+
+struct Sample {
+  // 2 * i + 1 while the i-th sample of the thread is written in the slot,
+  // 2 * i + 2 once it is, so that a reader tells a slot being overwritten.
+  std::atomic<uint64_t> seq;
+  int64_t ts_ms;
+  uint32_t depth;
+  uintptr_t pcs[SamplingProfiler::kMaxDepth];
+  char tag[SamplingProfiler::kTagSize];
+};
+
+static std::atomic<bool> running{false};
+
+static int64_t coarse_now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+}  // namespace sampling_impl
+
+struct ThreadSamples {
+  std::string name;
+  pid_t tid;
+  clockid_t clock;
+  timer_t timer;
+  bool has_timer = false;
+  // Allocated on the first start, and kept, as a signal may still be on its
+  // way after a stop.
+  std::unique_ptr<sampling_impl::Sample[]> ring;
+  size_t capacity = 0;
+  std::atomic<uint64_t> head{0};
+  // Double buffered, so that the signal handler never copies a tag being
+  // written.
+  char tags[2][SamplingProfiler::kTagSize] = {};
+  std::atomic<int> tag_index{0};
+};
+
+static thread_local ThreadSamples* tls_thread = nullptr;
+
+static void handle_sigprof(int, siginfo_t*, void*) {
+  using sampling_impl::Sample;
+  int saved_errno = errno;
+  ThreadSamples* thread = tls_thread;
+  if (thread != nullptr && thread->ring != nullptr &&
+      sampling_impl::running.load(std::memory_order_relaxed)) {
+    uint64_t index = thread->head.load(std::memory_order_relaxed);
+    Sample& sample = thread->ring[index % thread->capacity];
+    sample.seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    void* frames[SamplingProfiler::kMaxDepth + sampling_impl::kSkippedFrames];
+    int depth = backtrace(
+        frames, SamplingProfiler::kMaxDepth + sampling_impl::kSkippedFrames);
+    depth = std::max(depth - sampling_impl::kSkippedFrames, 0);
+    for (int i = 0; i < depth; ++i) {
+      sample.pcs[i] = reinterpret_cast<uintptr_t>(
+          frames[i + sampling_impl::kSkippedFrames]);
+    }
+    sample.depth = depth;
+    memcpy(sample.tag,
+           thread->tags[thread->tag_index.load(std::memory_order_relaxed)],
+           SamplingProfiler::kTagSize);
+    sample.ts_ms = sampling_impl::coarse_now_ms();
+    sample.seq.store(2 * index + 2, std::memory_order_release);
+    thread->head.store(index + 1, std::memory_order_release);
+  }
+  errno = saved_errno;
+}
+
+SamplingProfiler::SamplingProfiler()
+    : frequency_(0), capacity_(kDefaultCapacity), running_(false) {}
+
+SamplingProfiler& SamplingProfiler::get() {
+  static SamplingProfiler profiler;
+  return profiler;
+}
+
+void SamplingProfiler::RegisterCurrentThread(std::string_view name, int id) {
+  if (tls_thread != nullptr) {
+    return;
+  }
+  auto thread = std::make_shared<ThreadSamples>();
+  thread->name = std::string(name);
+  if (id >= 0) {
+    thread->name += "_" + std::to_string(id);
+  }
+  thread->tid = static_cast<pid_t>(syscall(SYS_gettid));
+  if (pthread_getcpuclockid(pthread_self(), &thread->clock) != 0) {
+    thread->clock = CLOCK_MONOTONIC;
+  }
+  // The first backtrace loads the unwinder, which allocates, hence out of
+  // the signal handler.
+  void* frames[1];
+  backtrace(frames, 1);
+  auto& profiler = get();
+  std::lock_guard<std::mutex> lock(profiler.mutex_);
+  tls_thread = thread.get();
+  profiler.threads_.push_back(thread);
+  if (profiler.running_) {
+    thread->capacity = profiler.capacity_;
+    thread->ring.reset(new sampling_impl::Sample[thread->capacity]());
+    profiler.startTimer(*thread);
+  }
+}
+
+std::string SamplingProfiler::SetTag(std::string_view tag) {
+  ThreadSamples* thread = tls_thread;
+  if (thread == nullptr) {
+    return std::string();
+  }
+  int index = thread->tag_index.load(std::memory_order_relaxed);
+  std::string prev(thread->tags[index]);
+  char* next = thread->tags[index ^ 1];
+  size_t len = std::min(tag.size(), kTagSize - 1);
+  memcpy(next, tag.data(), len);
+  next[len] = '\0';
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  thread->tag_index.store(index ^ 1, std::memory_order_relaxed);
+  return prev;
+}
+
+bool SamplingProfiler::startTimer(ThreadSamples& thread) {
+  struct sigevent event;
+  memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = SIGPROF;
+  event.sigev_notify_thread_id = thread.tid;
+  if (timer_create(thread.clock, &event, &thread.timer) != 0) {
+    PLOG(ERROR) << "Failed to create the sampling timer of " << thread.name;
+    return false;
+  }
+  struct itimerspec spec;
+  int64_t interval_ns = 1000000000l / frequency_;
+  spec.it_interval.tv_sec = interval_ns / 1000000000l;
+  spec.it_interval.tv_nsec = interval_ns % 1000000000l;
+  spec.it_value = spec.it_interval;
+  if (timer_settime(thread.timer, 0, &spec, nullptr) != 0) {
+    PLOG(ERROR) << "Failed to arm the sampling timer of " << thread.name;
+    timer_delete(thread.timer);
+    return false;
+  }
+  thread.has_timer = true;
+  return true;
+}
+
+bool SamplingProfiler::Start(int frequency, size_t capacity) {
+  if (frequency <= 0 || frequency > 10000 || capacity == 0) {
+    LOG(ERROR) << "Invalid sampling frequency " << frequency
+               << " or capacity " << capacity;
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_) {
+    return false;
+  }
+  // Installed once and left, as a pending SIGPROF would kill the process
+  // otherwise.
+  static bool installed = false;
+  if (!installed) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = handle_sigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      PLOG(ERROR) << "Failed to install the SIGPROF handler";
+      return false;
+    }
+    installed = true;
+  }
+  frequency_ = frequency;
+  capacity_ = capacity;
+  for (auto& thread : threads_) {
+    if (thread->ring == nullptr) {
+      thread->capacity = capacity_;
+      thread->ring.reset(new sampling_impl::Sample[thread->capacity]());
+    }
+  }
+  sampling_impl::running.store(true);
+  running_ = true;
+  for (auto& thread : threads_) {
+    startTimer(*thread);
+  }
+  LOG(INFO) << "Sampling " << threads_.size() << " threads at " << frequency
+            << " Hz";
+  return true;
+}
+
+void SamplingProfiler::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!running_) {
+    return;
+  }
+  for (auto& thread : threads_) {
+    if (thread->has_timer) {
+      timer_delete(thread->timer);
+      thread->has_timer = false;
+    }
+  }
+  sampling_impl::running.store(false);
+  running_ = false;
+}
+
+bool SamplingProfiler::running() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+int SamplingProfiler::frequency() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frequency_;
+}
+
+void SamplingProfiler::collect(int seconds,
+                               std::vector<Collected>& samples) const {
+  using sampling_impl::Sample;
+  std::vector<std::shared_ptr<ThreadSamples>> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads = threads_;
+  }
+  int64_t since_ms = seconds > 0
+                         ? sampling_impl::coarse_now_ms() - seconds * 1000l
+                         : std::numeric_limits<int64_t>::min();
+  for (auto& thread : threads) {
+    if (thread->ring == nullptr) {
+      continue;
+    }
+    uint64_t head = thread->head.load(std::memory_order_acquire);
+    uint64_t begin = head > thread->capacity ? head - thread->capacity : 0;
+    for (uint64_t i = begin; i < head; ++i) {
+      const Sample& sample = thread->ring[i % thread->capacity];
+      uint64_t seq = sample.seq.load(std::memory_order_acquire);
+      if (seq != 2 * i + 2 || sample.ts_ms < since_ms) {
+        continue;
+      }
+      Collected collected;
+      collected.thread = thread->name;
+      collected.tag.assign(sample.tag, strnlen(sample.tag, kTagSize));
+      collected.pcs.assign(sample.pcs,
+                           sample.pcs + std::min<size_t>(sample.depth,
+                                                         kMaxDepth));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sample.seq.load(std::memory_order_relaxed) != seq) {
+        continue;
+      }
+      samples.emplace_back(std::move(collected));
+    }
+  }
+}
+
+// The dynamic symbol of pc, or the module and offset if it has none, e.g.
+// for static functions.
+static std::string symbolize(uintptr_t pc) {
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void*>(pc), &info) == 0) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << pc;
+    return ss.str();
+  }
+  if (info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled =
+        abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : info.dli_sname;
+    free(demangled);
+    // Separates the frames of a folded stack.
+    std::replace(name.begin(), name.end(), ';', ':');
+    return name;
+  }
+  std::string module = info.dli_fname != nullptr ? info.dli_fname : "";
+  module = module.substr(module.find_last_of('/') + 1);
+  std::stringstream ss;
+  ss << module << "+0x" << std::hex
+     << (pc - reinterpret_cast<uintptr_t>(info.dli_fbase));
+  return ss.str();
+}
+
+std::string SamplingProfiler::Folded(int seconds) const {
+  std::vector<Collected> samples;
+  collect(seconds, samples);
+  std::unordered_map<uintptr_t, std::string> symbols;
+  std::map<std::string, size_t> stacks;
+  for (auto& sample : samples) {
+    std::string stack = sample.thread;
+    stack += ';';
+    stack += sample.tag.empty() ? "-" : sample.tag;
+    for (size_t i = sample.pcs.size(); i > 0; --i) {
+      // A return address is past its call, which is looked up instead.
+      uintptr_t pc = i == 1 ? sample.pcs[0] : sample.pcs[i - 1] - 1;
+      auto iter = symbols.find(pc);
+      if (iter == symbols.end()) {
+        iter = symbols.emplace(pc, symbolize(pc)).first;
+      }
+      stack += ';';
+      stack += iter->second;
+    }
+    ++stacks[stack];
+  }
+  std::string ret;
+  for (auto& pair : stacks) {
+    ret += pair.first;
+    ret += ' ';
+    ret += std::to_string(pair.second);
+    ret += '\n';
+  }
+  return ret;
+}
+
+std::string SamplingProfiler::Pprof(int seconds) const {
+  std::vector<Collected> samples;
+  collect(seconds, samples);
+  std::map<std::vector<uintptr_t>, uintptr_t> stacks;
+  for (auto& sample : samples) {
+    ++stacks[sample.pcs];
+  }
+  std::vector<uintptr_t> words = {0, 3, 0,
+                                  static_cast<uintptr_t>(
+                                      1000000 / std::max(frequency(), 1)),
+                                  0};
+  for (auto& pair : stacks) {
+    words.push_back(pair.second);
+    words.push_back(pair.first.size());
+    words.insert(words.end(), pair.first.begin(), pair.first.end());
+  }
+  words.insert(words.end(), {0, 1, 0});
+  std::string ret(reinterpret_cast<const char*>(words.data()),
+                  words.size() * sizeof(uintptr_t));
+  // The mappings, by which pprof finds the binaries to symbolize from.
+  std::ifstream maps("/proc/self/maps");
+  std::stringstream ss;
+  ss << maps.rdbuf();
+  ret += ss.str();
+  return ret;
+}
+
+}  // namespace gs
@@ -0,0 +1,113 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_SAMPLING_PROFILER_H_
+#define UTILS_SAMPLING_PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gs {
+
+struct ThreadSamples;
+
+// Samples the stacks of the registered threads on a timer of their cpu
+// time, with SIGPROF, so that the hot paths of the engine can be looked at
+// on hosts where perf may not be attached. Each sample carries the tag the
+// thread had set, e.g. the procedure or query template it ran. The samples
+// of a thread are kept in a ring, the latest ones overwriting the oldest,
+// so that the profiler may run continuously at a low frequency.
+//
+// The stacks are symbolized from the dynamic symbols when downloaded as
+// folded stacks, while the pprof tool symbolizes the legacy cpu profiles
+// from the binaries itself. The profiler of seastar, which takes SIGPROF as
+// well, must be left off.
+class SamplingProfiler {
+ public:
+  static constexpr size_t kMaxDepth = 32;
+  static constexpr size_t kTagSize = 64;
+  static constexpr size_t kDefaultCapacity = 4096;
+
+  static SamplingProfiler& get();
+
+  // Registers the calling thread under name, suffixed by id unless it is
+  // negative, once, later calls being cheap. Its samples are taken while the
+  // profiler runs.
+  static void RegisterCurrentThread(std::string_view name, int id = -1);
+
+  // Sets the tag of the samples of the calling thread, truncated to
+  // kTagSize - 1 bytes, and returns the previous one. Cheap enough to be set
+  // per query; see SampleTagScope.
+  static std::string SetTag(std::string_view tag);
+
+  // Samples each registered thread frequency times per second of its cpu
+  // time, keeping the last capacity samples per thread, as of the first
+  // start the thread was sampled in. Returns false if it runs already or the
+  // signal handler could not be installed.
+  bool Start(int frequency, size_t capacity = kDefaultCapacity);
+
+  void Stop();
+
+  bool running() const;
+
+  int frequency() const;
+
+  // The samples of the last seconds, or all those kept if seconds is not
+  // positive, as lines of "thread;tag;root;...;leaf count".
+  std::string Folded(int seconds) const;
+
+  // As Folded, as a legacy cpu profile of gperftools as read by pprof.
+  std::string Pprof(int seconds) const;
+
+ private:
+  SamplingProfiler();
+
+  bool startTimer(ThreadSamples& thread);
+
+  struct Collected {
+    std::string thread;
+    std::string tag;
+    std::vector<uintptr_t> pcs;
+  };
+  void collect(int seconds, std::vector<Collected>& samples) const;
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadSamples>> threads_;
+  int frequency_;
+  size_t capacity_;
+  bool running_;
+};
+
+// Tags the samples of the calling thread for its lifetime, restoring the
+// previous tag afterwards.
+class SampleTagScope {
+ public:
+  explicit SampleTagScope(std::string_view tag)
+      : prev_(SamplingProfiler::SetTag(tag)) {}
+  ~SampleTagScope() { SamplingProfiler::SetTag(prev_); }
+
+ private:
+  std::string prev_;
+};
+
+}  // namespace gs
+
+#endif  // UTILS_SAMPLING_PROFILER_H_
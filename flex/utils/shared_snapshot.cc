@@ -0,0 +1,176 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flex/utils/shared_snapshot.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include "flex/storages/rt_mutable_graph/file_names.h"
+#include "glog/logging.h"
+
+namespace gs {
+
+namespace shared_snapshot_impl {
+
+static std::mutex mutex;
+static std::string dir;
+// The checksums of the files of each snapshot, by name, from its manifest.
+static std::unordered_map<std::string,
+                          std::unordered_map<std::string, std::string>>
+    checksums;
+
+// The checksum of filename in the manifest of its snapshot, empty if it has
+// none.
+static std::string checksum_of(const std::string& filename) {
+  static const std::string kSnapshots = "/snapshots/";
+  size_t pos = filename.rfind(kSnapshots);
+  size_t end = pos == std::string::npos
+                   ? pos
+                   : filename.find('/', pos + kSnapshots.size());
+  if (end == std::string::npos) {
+    return "";
+  }
+  std::string snapshot_dir = filename.substr(0, end);
+  std::string name = filename.substr(end + 1);
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = checksums.find(snapshot_dir);
+  if (iter == checksums.end()) {
+    iter = checksums.emplace(snapshot_dir, decltype(iter->second)()).first;
+    std::ifstream fin(snapshot_manifest_path(snapshot_dir));
+    std::string file, size, checksum;
+    while (fin >> file >> size >> checksum) {
+      iter->second.emplace(file, size + "_" + checksum);
+    }
+  }
+  auto file_iter = iter->second.find(name);
+  return file_iter == iter->second.end() ? "" : file_iter->second;
+}
+
+// Copies filename to path, through a mapping as files on hugetlbfs can not
+// be written with write(2).
+static bool copy_file(const std::string& filename, const std::string& path,
+                      size_t file_size, size_t copy_size) {
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    return false;
+  }
+  bool ok = ftruncate(fd, copy_size) == 0;
+  void* data = MAP_FAILED;
+  if (ok) {
+    data = mmap(NULL, copy_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ok = data != MAP_FAILED;
+  }
+  if (ok) {
+    FILE* fin = fopen(filename.c_str(), "rb");
+    ok = fin != NULL && fread(data, 1, file_size, fin) == file_size;
+    if (fin != NULL) {
+      fclose(fin);
+    }
+    munmap(data, copy_size);
+  }
+  close(fd);
+  return ok;
+}
+
+}  // namespace shared_snapshot_impl
+
+void set_shared_snapshot_dir(const std::string& dir) {
+  if (!dir.empty()) {
+    std::filesystem::create_directories(dir);
+  }
+  std::lock_guard<std::mutex> lock(shared_snapshot_impl::mutex);
+  shared_snapshot_impl::dir = dir;
+  shared_snapshot_impl::checksums.clear();
+}
+
+std::string get_shared_snapshot_dir() {
+  std::lock_guard<std::mutex> lock(shared_snapshot_impl::mutex);
+  return shared_snapshot_impl::dir;
+}
+
+bool is_shared_snapshot_file(const std::string& filename) {
+  return !filename.empty() && !get_shared_snapshot_dir().empty() &&
+         filename.find("/snapshots/") != std::string::npos;
+}
+
+std::string shared_snapshot_copy(const std::string& filename,
+                                 size_t& page_size) {
+  std::string dir = get_shared_snapshot_dir();
+  std::error_code ec;
+  if (dir.empty() || filename.empty()) {
+    return "";
+  }
+  size_t file_size = std::filesystem::file_size(filename, ec);
+  if (ec || file_size == 0) {
+    return "";
+  }
+  struct statfs fs;
+  if (statfs(dir.c_str(), &fs) != 0) {
+    LOG(WARNING) << "Failed to statfs " << dir << ", " << strerror(errno);
+    return "";
+  }
+  page_size = fs.f_bsize;
+  size_t copy_size = (file_size + page_size - 1) / page_size * page_size;
+
+  // A copy is of the size and checksum of the file in the manifest, shared
+  // by the copies of a data directory, e.g. the replicas seeded from it, or
+  // else of the path and size of the file.
+  std::string key = shared_snapshot_impl::checksum_of(filename);
+  if (key.rfind(std::to_string(file_size) + "_", 0) != 0) {
+    auto canonical = std::filesystem::weakly_canonical(filename, ec);
+    std::stringstream ss;
+    ss << file_size << "_" << std::hex
+       << std::hash<std::string>()(ec ? filename : canonical.string());
+    key = ss.str();
+  }
+  std::string path = dir + "/" + key + "_" +
+                     std::filesystem::path(filename).filename().string();
+  if (std::filesystem::exists(path, ec) &&
+      std::filesystem::file_size(path, ec) == copy_size) {
+    return path;
+  }
+  // Processes racing on the same file each write a copy of their own, the
+  // one renamed last wins, and those mapping a replaced copy keep its pages.
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+  if (!shared_snapshot_impl::copy_file(filename, tmp_path, file_size,
+                                       copy_size)) {
+    LOG(WARNING) << "Failed to copy " << filename << " to " << tmp_path
+                 << ", " << strerror(errno) << ", it is mapped privately";
+    std::filesystem::remove(tmp_path, ec);
+    return "";
+  }
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    LOG(WARNING) << "Failed to rename " << tmp_path << " to " << path << ", "
+                 << ec.message();
+    std::filesystem::remove(tmp_path, ec);
+    return "";
+  }
+  return path;
+}
+
+}  // namespace gs
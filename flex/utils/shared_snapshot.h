@@ -0,0 +1,51 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UTILS_SHARED_SNAPSHOT_H_
+#define UTILS_SHARED_SNAPSHOT_H_
+
+#include <stddef.h>
+
+#include <string>
+
+namespace gs {
+
+// The processes of a host opening the same snapshot at memory level 1 or
+// above may share its memory: the files of the snapshot are copied once
+// into a directory on tmpfs (e.g. /dev/shm) or hugetlbfs, by the first
+// process opening them, and every process maps the copies privately, so
+// that the pages are the same physical ones in all of them until a process
+// writes to a page, which is then copied to the process.
+//
+// Sets the directory of the copies process wide, none if dir is empty. It
+// should be called before the graph is opened.
+void set_shared_snapshot_dir(const std::string& dir);
+
+std::string get_shared_snapshot_dir();
+
+// Whether a directory of the copies is set and filename is of a snapshot,
+// whose files are never written once dumped.
+bool is_shared_snapshot_file(const std::string& filename);
+
+// The path of the copy of filename, created if absent, with its size
+// rounded up to page_size, the page size of the directory, i.e. the
+// hugepage size on hugetlbfs. Returns an empty string if filename is empty
+// or the copy cannot be created.
+std::string shared_snapshot_copy(const std::string& filename,
+                                 size_t& page_size);
+
+}  // namespace gs
+
+#endif  // UTILS_SHARED_SNAPSHOT_H_
@@ -0,0 +1,78 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GRAPHSCOPE_UTILS_SORTED_INTERSECTION_H_
+#define GRAPHSCOPE_UTILS_SORTED_INTERSECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+
+namespace gs {
+
+// Returns the first position in [first, last) whose key is not less than
+// value. The range is probed at exponentially growing distances from first
+// before a binary search, so the cost is logarithmic in the distance to the
+// answer rather than in the length of the range.
+template <typename IT, typename K, typename KEY_T>
+IT gallop_lower_bound(IT first, IT last, const K& value, const KEY_T& key) {
+  size_t len = last - first;
+  size_t lo = 0, hi = 1;
+  while (hi < len && key(first[hi - 1]) < value) {
+    lo = hi;
+    hi <<= 1;
+  }
+  if (hi > len) {
+    hi = len;
+  }
+  return std::partition_point(first + lo, first + hi, [&](const auto& x) {
+    return key(x) < value;
+  });
+}
+
+// Calls func(a, b) for every pair of positions a in [a_first, a_last) and b in
+// [b_first, b_last) holding equal keys. Both ranges must be sorted by key.
+// Pairs are reported in order of a, and for the same a in order of b, which
+// is also the order a nested loop over the two ranges would produce.
+template <typename IT1, typename IT2, typename KEY1_T, typename KEY2_T,
+          typename FUNC_T>
+void sorted_intersect(IT1 a_first, IT1 a_last, IT2 b_first, IT2 b_last,
+                      const KEY1_T& key1, const KEY2_T& key2,
+                      const FUNC_T& func) {
+  while (a_first != a_last && b_first != b_last) {
+    auto ka = key1(*a_first);
+    auto kb = key2(*b_first);
+    if (ka < kb) {
+      a_first = gallop_lower_bound(a_first, a_last, kb, key1);
+    } else if (kb < ka) {
+      b_first = gallop_lower_bound(b_first, b_last, ka, key2);
+    } else {
+      IT2 b_run = b_first;
+      while (b_run != b_last && !(ka < key2(*b_run))) {
+        ++b_run;
+      }
+      while (a_first != a_last && !(kb < key1(*a_first))) {
+        for (IT2 b = b_first; b != b_run; ++b) {
+          func(a_first, b);
+        }
+        ++a_first;
+      }
+      b_first = b_run;
+    }
+  }
+}
+
+}  // namespace gs
+
+#endif  // GRAPHSCOPE_UTILS_SORTED_INTERSECTION_H_
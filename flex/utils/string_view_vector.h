@@ -19,63 +19,113 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <memory>
 #include <string_view>
 #include <vector>
 
 namespace gs {
 
+/**
+ * @brief An append-only vector of strings, whose bytes are copied into fixed
+ * size pages that are never reallocated. So appending never copies the
+ * strings appended before, and the views returned stay valid until clear().
+ *
+ * clear() keeps the pages for the strings appended next, only the strings
+ * larger than a quarter of a page, which get an allocation of their own, are
+ * freed.
+ */
 class StringViewVector {
  public:
-  StringViewVector() { offsets_.push_back(0); }
+  static constexpr size_t PAGE_SIZE = 64 * 1024;
+  static constexpr size_t MAX_PAGED_SIZE = PAGE_SIZE / 4;
+
+  StringViewVector() : page_(0), used_(0), content_size_(0) {}
   ~StringViewVector() {}
 
-  void push_back(const std::string_view& val) {
-    size_t old_size = buffer_.size();
-    buffer_.resize(old_size + val.size());
-    memcpy(&buffer_[old_size], val.data(), val.size());
-    offsets_.push_back(buffer_.size());
+  StringViewVector(const StringViewVector& rhs) : StringViewVector() {
+    *this = rhs;
   }
 
-  void emplace_back(const std::string_view& val) {
-    size_t old_size = buffer_.size();
-    buffer_.resize(old_size + val.size());
-    memcpy(&buffer_[old_size], val.data(), val.size());
-    offsets_.push_back(buffer_.size());
+  StringViewVector(StringViewVector&& rhs) : StringViewVector() { swap(rhs); }
+
+  StringViewVector& operator=(const StringViewVector& rhs) {
+    if (this != &rhs) {
+      clear();
+      items_.reserve(rhs.size());
+      for (auto& item : rhs.items_) {
+        push_back(item);
+      }
+    }
+    return *this;
   }
 
-  size_t size() const {
-    assert(offsets_.size() > 0);
-    return offsets_.size() - 1;
+  StringViewVector& operator=(StringViewVector&& rhs) {
+    swap(rhs);
+    return *this;
   }
 
-  std::string_view operator[](size_t index) const {
-    size_t from = offsets_[index];
-    size_t len = offsets_[index + 1] - from;
-    return std::string_view(&buffer_[from], len);
+  void push_back(const std::string_view& val) {
+    items_.emplace_back(append(val), val.size());
+    content_size_ += val.size();
   }
 
-  std::vector<char>& content_buffer() { return buffer_; }
+  void emplace_back(const std::string_view& val) { push_back(val); }
 
-  const std::vector<char>& content_buffer() const { return buffer_; }
+  size_t size() const { return items_.size(); }
 
-  std::vector<size_t>& offset_buffer() { return offsets_; }
+  std::string_view operator[](size_t index) const { return items_[index]; }
 
-  const std::vector<size_t>& offset_buffer() const { return offsets_; }
+  // The bytes of all the strings, without the unused tails of the pages.
+  size_t content_size() const { return content_size_; }
 
   void clear() {
-    buffer_.clear();
-    offsets_.clear();
-    offsets_.push_back(0);
+    items_.clear();
+    large_.clear();
+    page_ = 0;
+    used_ = 0;
+    content_size_ = 0;
   }
 
   void swap(StringViewVector& rhs) {
-    buffer_.swap(rhs.buffer_);
-    offsets_.swap(rhs.offsets_);
+    items_.swap(rhs.items_);
+    pages_.swap(rhs.pages_);
+    large_.swap(rhs.large_);
+    std::swap(page_, rhs.page_);
+    std::swap(used_, rhs.used_);
+    std::swap(content_size_, rhs.content_size_);
   }
 
  private:
-  std::vector<char> buffer_;
-  std::vector<size_t> offsets_;
+  const char* append(const std::string_view& val) {
+    char* ptr;
+    if (val.size() > MAX_PAGED_SIZE) {
+      large_.emplace_back(new char[val.size()]);
+      ptr = large_.back().get();
+    } else {
+      if (page_ == pages_.size() || val.size() > PAGE_SIZE - used_) {
+        if (page_ < pages_.size()) {
+          ++page_;
+        }
+        if (page_ == pages_.size()) {
+          pages_.emplace_back(new char[PAGE_SIZE]);
+        }
+        used_ = 0;
+      }
+      ptr = pages_[page_].get() + used_;
+      used_ += val.size();
+    }
+    memcpy(ptr, val.data(), val.size());
+    return ptr;
+  }
+
+  std::vector<std::string_view> items_;
+  std::vector<std::unique_ptr<char[]>> pages_;
+  std::vector<std::unique_ptr<char[]>> large_;
+  // The page being filled, none if page_ is pages_.size(), and the bytes of
+  // it taken.
+  size_t page_;
+  size_t used_;
+  size_t content_size_;
 };
 
 }  // namespace gs
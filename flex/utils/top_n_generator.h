@@ -92,6 +92,13 @@ class TopNGenerator {
     }
   }
 
+  // Whether push(val, ...) would keep val, so that callers can skip
+  // materializing the values that cannot be among the first n.
+  inline bool admits(const T& val) const {
+    return pq_.empty() || !CMP_T()(pq_.top().val, val) ||
+           pq_.size() + replicated_indices_.size() < n_;
+  }
+
   void generate_indices(std::vector<size_t>& indices) {
     indices = std::move(replicated_indices_);
     replicated_indices_.clear();
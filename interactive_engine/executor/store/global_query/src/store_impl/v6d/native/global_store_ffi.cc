@@ -67,6 +67,11 @@ int v6d_get_vertices_next(GetVertexIterator iter, Vertex* v_out) {
                                       v_out);
 }
 
+int v6d_get_vertices_next_batch(GetVertexIterator iter, Vertex* v_out, int n) {
+  return htap_impl::get_vertices_next_batch(
+      (htap_impl::GetVertexIteratorImpl*)iter, v_out, n);
+}
+
 GetAllVerticesIterator v6d_get_all_vertices(GraphHandle graph,
                                         PartitionId partition_id,
                                         LabelId* labels, int labels_count,
@@ -110,6 +115,12 @@ int v6d_get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out) {
       (htap_impl::GetAllVerticesIteratorImpl*)iter, v_out);
 }
 
+int v6d_get_all_vertices_next_batch(GetAllVerticesIterator iter, Vertex* v_out,
+                                    int n) {
+  return htap_impl::get_all_vertices_next_batch(
+      (htap_impl::GetAllVerticesIteratorImpl*)iter, v_out, n);
+}
+
 VertexId v6d_get_vertex_id(GraphHandle graph, Vertex v) { return (VertexId)v; }
 
 OuterId v6d_get_outer_id(GraphHandle graph, Vertex v) {
@@ -184,6 +195,50 @@ int v6d_get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
   return r;
 }
 
+int v6d_get_vertex_property_batch(GraphHandle graph, const Vertex* vs, int n,
+                                  PropertyId id, Property* p_out) {
+  htap_impl::GraphHandleImpl* handle =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  int count = 0;
+  int begin = 0;
+  while (begin < n) {
+    // 相邻的同一分区、同一label的点作为一段，一起取属性
+    htap_impl::VID_TYPE first = (htap_impl::VID_TYPE)vs[begin];
+    int partition_id = handle->vid_parser.GetFid(first);
+    LabelId label_id = handle->vid_parser.GetLabelId(first);
+    int end = begin + 1;
+    while (end < n &&
+           handle->vid_parser.GetFid((htap_impl::VID_TYPE)vs[end]) ==
+               partition_id &&
+           handle->vid_parser.GetLabelId((htap_impl::VID_TYPE)vs[end]) ==
+               label_id) {
+      ++end;
+    }
+    PropertyId transformed_id =
+        handle->schema->VertexEntries()[label_id].reverse_mapping[id];
+    if (transformed_id == -1) {
+      for (int i = begin; i < end; ++i) {
+        p_out[i].type = INVALID;
+        p_out[i].data = NULL;
+        p_out[i].len = 0;
+      }
+    } else if (handle->use_int64_oid) {
+      count += htap_impl::get_vertex_property_batch(
+          &(handle->fragments[partition_id]), label_id, vs + begin,
+          end - begin, transformed_id, p_out + begin);
+    } else {
+      count += htap_impl::get_vertex_property_batch(
+          &(handle->string_fragments[partition_id]), label_id, vs + begin,
+          end - begin, transformed_id, p_out + begin);
+    }
+    for (int i = begin; i < end; ++i) {
+      p_out[i].id = id;
+    }
+    begin = end;
+  }
+  return count;
+}
+
 PropertiesIterator v6d_get_vertex_properties(GraphHandle graph, Vertex v) {
   PropertiesIterator ret = malloc(sizeof(htap_impl::PropertiesIteratorImpl));
   htap_impl::GraphHandleImpl* handle =
@@ -253,6 +308,11 @@ int v6d_out_edge_next(OutEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::out_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int v6d_out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out, int n) {
+  return htap_impl::out_edge_next_batch((htap_impl::EdgeIteratorImpl*)iter,
+                                        e_out, n);
+}
+
 InEdgeIterator v6d_get_in_edges(GraphHandle graph, PartitionId partition_id,
                             VertexId dst_id, LabelId* labels, int labels_count,
                             int64_t limit) {
@@ -306,6 +366,11 @@ int v6d_in_edge_next(InEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::in_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int v6d_in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int n) {
+  return htap_impl::in_edge_next_batch((htap_impl::EdgeIteratorImpl*)iter,
+                                       e_out, n);
+}
+
 GetAllEdgesIterator v6d_get_all_edges(GraphHandle graph, PartitionId partition_id,
                                   LabelId* labels, int labels_count,
                                   int64_t limit) {
@@ -359,6 +424,12 @@ int v6d_get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out) {
       (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out);
 }
 
+int v6d_get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                                 int n) {
+  return htap_impl::get_all_edges_next_batch(
+      (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out, n);
+}
+
 VertexId v6d_get_edge_src_id(GraphHandle graph, struct Edge* e) { return e->src; }
 
 VertexId v6d_get_edge_dst_id(GraphHandle graph, struct Edge* e) { return e->dst; }
@@ -111,6 +111,9 @@ void v6d_free_get_vertex_iterator(GetVertexIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Vertex
 int v6d_get_vertices_next(GetVertexIterator iter, Vertex* v_out);
 
+// 从迭代器批量取出至多n个元素填入v_out，返回取出的个数，为0表示迭代结束
+int v6d_get_vertices_next_batch(GetVertexIterator iter, Vertex* v_out, int n);
+
 // 查询某个partition内部的所有相关label的点
 // labels是待查询label的列表
 // labels_count表示这个label列表的长度
@@ -128,6 +131,10 @@ void v6d_free_get_all_vertices_iterator(GetAllVerticesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Vertex
 int v6d_get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out);
 
+// 从迭代器批量取出至多n个元素填入v_out，返回取出的个数，为0表示迭代结束
+int v6d_get_all_vertices_next_batch(GetAllVerticesIterator iter, Vertex* v_out,
+                                    int n);
+
 // 获取点id
 VertexId v6d_get_vertex_id(GraphHandle graph, Vertex v);
 
@@ -145,6 +152,12 @@ LabelId v6d_get_vertex_label(GraphHandle graph, Vertex v);
 int v6d_get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
                         struct Property* p_out);
 
+// 批量获取n个点的同一个属性，结果依次填入p_out
+// 返回成功获取的个数，获取失败的点对应的Property类型置为INVALID
+// 相邻的同一分区、同一label的点只解析一次属性列
+int v6d_get_vertex_property_batch(GraphHandle graph, const Vertex* vs, int n,
+                                  PropertyId id, struct Property* p_out);
+
 // 获取点的属性列表，返回一个迭代器
 PropertiesIterator v6d_get_vertex_properties(GraphHandle graph, Vertex v);
 
@@ -165,6 +178,9 @@ void v6d_free_out_edge_iterator(OutEdgeIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int v6d_out_edge_next(OutEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多n个元素填入e_out，返回取出的个数，为0表示迭代结束
+int v6d_out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out, int n);
+
 // 查询某个partition内的点的入边
 // src_ids是待查询的点id列表
 // labels是label列表，表示查询这些点的这些label的出边
@@ -181,6 +197,9 @@ void v6d_free_in_edge_iterator(InEdgeIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int v6d_in_edge_next(InEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多n个元素填入e_out，返回取出的个数，为0表示迭代结束
+int v6d_in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int n);
+
 // 查询某个partition内某些label的边数据
 // labels是待查询的label列表
 // labels_count表示label列表的长度
@@ -197,6 +216,10 @@ void v6d_free_get_all_edges_iterator(GetAllEdgesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int v6d_get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多n个元素填入e_out，返回取出的个数，为0表示迭代结束
+int v6d_get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                                 int n);
+
 // 从edge对象获取起点id
 VertexId v6d_get_edge_src_id(GraphHandle graph, struct Edge* e);
 
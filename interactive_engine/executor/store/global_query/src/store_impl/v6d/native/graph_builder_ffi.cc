@@ -22,6 +22,7 @@
 #include <set>
 #include <string>
 
+#include "arrow/c/bridge.h"
 #include "boost/algorithm/string.hpp"
 #include "vineyard/basic/stream/dataframe_stream.h"
 #include "vineyard/basic/stream/parallel_stream.h"
@@ -217,6 +218,36 @@ int v6d_add_edges(GraphBuilder builder, size_t edge_size,
                              properties);
 }
 
+int v6d_add_vertex_columns(GraphBuilder builder, LabelId labelid,
+                           struct ArrowArray *columns,
+                           struct ArrowSchema *schema) {
+  auto batch = arrow::ImportRecordBatch(columns, schema);
+  if (!batch.ok()) {
+    LOG(ERROR) << "failed to import vertex columns: "
+               << batch.status().ToString();
+    return -1;
+  }
+  auto stream =
+      static_cast<std::shared_ptr<vineyard::htap::PropertyGraphOutStream> *>(builder);
+  return (*stream)->AddVertexColumns(labelid, batch.ValueOrDie());
+}
+
+int v6d_add_edge_columns(GraphBuilder builder, LabelId label,
+                         LabelId src_label, LabelId dst_label,
+                         struct ArrowArray *columns,
+                         struct ArrowSchema *schema) {
+  auto batch = arrow::ImportRecordBatch(columns, schema);
+  if (!batch.ok()) {
+    LOG(ERROR) << "failed to import edge columns: "
+               << batch.status().ToString();
+    return -1;
+  }
+  auto stream =
+      static_cast<std::shared_ptr<vineyard::htap::PropertyGraphOutStream> *>(builder);
+  return (*stream)->AddEdgeColumns(label, src_label, dst_label,
+                                   batch.ValueOrDie());
+}
+
 int v6d_build(GraphBuilder builder) {
   auto stream =
       static_cast<std::shared_ptr<vineyard::htap::PropertyGraphOutStream> *>(builder);
@@ -40,6 +40,10 @@ typedef void* GraphHandle;
 typedef void* VertexTypeBuilder;
 typedef void* EdgeTypeBuilder;
 
+// Arrow C data interface, c.f.: arrow/c/abi.h
+struct ArrowArray;
+struct ArrowSchema;
+
 /**
  * step 1: 创建Local的GraphBuilder
  *
@@ -123,6 +127,28 @@ int v6d_add_edges(GraphBuilder builder, size_t edge_size,
                LabelId* src_labels, LabelId* dst_labels, size_t* property_sizes,
                Property* properties);
 
+/**
+ * 按列批量写入某个label的点，columns/schema是Arrow C data interface导出的
+ * struct array，调用后其所有权转移给builder。
+ *
+ * 第一列为点id（int64），其余列按列名对应到该label的属性，缺少的属性填null，
+ * 列的类型需要与schema中属性的类型一致。整批数据直接写入stream，不再逐行转换。
+ *
+ * 成功返回0，否则返回-1。
+ */
+int v6d_add_vertex_columns(GraphBuilder builder, LabelId labelid,
+                           struct ArrowArray* columns,
+                           struct ArrowSchema* schema);
+
+/**
+ * 按列批量写入某个(label, src_label, dst_label)的边，参数含义与
+ * add_vertex_columns一致，前两列分别为起点id和终点id（int64）。
+ */
+int v6d_add_edge_columns(GraphBuilder builder, LabelId label,
+                         LabelId src_label, LabelId dst_label,
+                         struct ArrowArray* columns,
+                         struct ArrowSchema* schema);
+
 /**
  * 结束local GraphBuilder的build，点、边写完之后分别调用
  */
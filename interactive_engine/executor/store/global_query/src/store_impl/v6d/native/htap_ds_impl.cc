@@ -15,6 +15,7 @@
  */
 #include "htap_ds_impl.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -258,13 +259,10 @@ void free_graph_handle(GraphHandleImpl* handle) {
 #endif
 }
 
-static int get_property_from_table(arrow::Table* table, int64_t row_id,
-                                   PropertyId col_id, Property* p_out) {
-#ifndef NDEBUG
-  LOG(INFO) << "enter " << __FUNCTION__;
-#endif
-  std::shared_ptr<arrow::DataType> dt = table->field(col_id)->type();
-  std::shared_ptr<arrow::Array> array = table->column(col_id)->chunk(0);
+static int get_property_from_array(const std::shared_ptr<arrow::DataType>& dt,
+                                   const std::shared_ptr<arrow::Array>& array,
+                                   int64_t row_id, PropertyId col_id,
+                                   Property* p_out) {
   p_out->id = col_id;
   PodProperties pp;
   pp.long_value = 0;
@@ -377,10 +375,21 @@ static int get_property_from_table(arrow::Table* table, int64_t row_id,
     return -1;
   }
   p_out->len = pp.long_value;
+  return 0;
+}
+
+static int get_property_from_table(arrow::Table* table, int64_t row_id,
+                                   PropertyId col_id, Property* p_out) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__;
+#endif
+  int r = get_property_from_array(table->field(col_id)->type(),
+                                  table->column(col_id)->chunk(0), row_id,
+                                  col_id, p_out);
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
-  return 0;
+  return r;
 }
 
 static void get_properties_from_table(std::shared_ptr<arrow::Table> table,
@@ -446,6 +455,47 @@ template
 int get_vertex_property(STRING_FRAGMENT_TYPE* frag, Vertex v, PropertyId id,
                         Property* p_out);
 
+template <typename FRAGMENT_TYPE>
+int get_vertex_property_batch(FRAGMENT_TYPE* frag, LabelId label,
+                              const Vertex* vs, int n, PropertyId id,
+                              Property* p_out) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ": id = " << id << ", n = " << n;
+#endif
+  // 同一个label的点共享一张表，列和类型只需解析一次
+  std::shared_ptr<arrow::Table> table = frag->vertex_data_table(label);
+  std::shared_ptr<arrow::DataType> dt = table->field(id)->type();
+  std::shared_ptr<arrow::Array> array = table->column(id)->chunk(0);
+  int count = 0;
+  for (int i = 0; i < n; ++i) {
+    VERTEX_TYPE vert;
+    if (frag->InnerVertexGid2Vertex((VID_TYPE)vs[i], vert) &&
+        get_property_from_array(dt, array, frag->vertex_offset(vert), id,
+                                &p_out[i]) == 0) {
+      ++count;
+    } else {
+      p_out[i].id = id;
+      p_out[i].type = INVALID;
+      p_out[i].data = NULL;
+      p_out[i].len = 0;
+    }
+  }
+  return count;
+}
+
+template
+int get_vertex_property_batch(FRAGMENT_TYPE* frag, LabelId label,
+                              const Vertex* vs, int n, PropertyId id,
+                              Property* p_out);
+template
+int get_vertex_property_batch(INT32_FRAGMENT_TYPE* frag, LabelId label,
+                              const Vertex* vs, int n, PropertyId id,
+                              Property* p_out);
+template
+int get_vertex_property_batch(STRING_FRAGMENT_TYPE* frag, LabelId label,
+                              const Vertex* vs, int n, PropertyId id,
+                              Property* p_out);
+
 template <typename FRAGMENT_TYPE>
 void get_vertex_properties(FRAGMENT_TYPE* frag, Vertex v,
                            PropertiesIteratorImpl* iter) {
@@ -541,6 +591,16 @@ int get_vertices_next(GetVertexIteratorImpl* iter, Vertex* v_out) {
   }
 }
 
+int get_vertices_next_batch(GetVertexIteratorImpl* iter, Vertex* v_out,
+                            int n) {
+  int num = std::min(n, iter->count - iter->index);
+  for (int i = 0; i < num; ++i) {
+    v_out[i] = iter->ids[iter->index + i];
+  }
+  iter->index += num;
+  return num;
+}
+
 template
 void get_vertices(FRAGMENT_TYPE* frag, LabelId* label, VertexId* ids, int count,
                   GetVertexIteratorImpl* out);
@@ -681,6 +741,22 @@ int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out) {
   return 0;
 }
 
+int get_all_vertices_next_batch(GetAllVerticesIteratorImpl* iter,
+                                Vertex* v_out, int n) {
+  int count = 0;
+  while (count < n && iter->range_id != iter->range_num) {
+    VID_TYPE end = iter->ranges[iter->range_id].second;
+    while (count < n && iter->cur_vertex_id != end) {
+      v_out[count++] = (Vertex)iter->cur_vertex_id;
+      ++iter->cur_vertex_id;
+    }
+    if (iter->cur_vertex_id == end && ++iter->range_id != iter->range_num) {
+      iter->cur_vertex_id = iter->ranges[iter->range_id].first;
+    }
+  }
+  return count;
+}
+
 template
 void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
                       const VID_TYPE* chunk_sizes, LabelId* labels,
@@ -1080,6 +1156,41 @@ int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out) {
   return 0;
 }
 
+// 批量取出边，out为true时iter->src是起点，否则是终点
+static int edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int n,
+                           bool out) {
+  FRAG_ID_TYPE frag_id = iter->fragment != nullptr
+                             ? iter->fragment->fid()
+                             : iter->string_fragment->fid();
+  int count = 0;
+  while (count < n && iter->list_id != iter->list_num) {
+    const AdjListUnit& list = iter->lists[iter->list_id];
+    for (; count < n && iter->cur_edge != list.end; ++iter->cur_edge) {
+      VERTEX_TYPE nbr(iter->cur_edge->vid);
+      VID_TYPE nbr_gid = iter->fragment != nullptr
+                             ? iter->fragment->Vertex2Gid(nbr)
+                             : iter->string_fragment->Vertex2Gid(nbr);
+      Edge& e = e_out[count++];
+      e.src = out ? iter->src : nbr_gid;
+      e.dst = out ? nbr_gid : iter->src;
+      e.offset = iter->eid_parser->GenerateId(frag_id, list.label,
+                                              iter->cur_edge->eid);
+    }
+    if (iter->cur_edge == list.end && ++iter->list_id != iter->list_num) {
+      iter->cur_edge = iter->lists[iter->list_id].begin;
+    }
+  }
+  return count;
+}
+
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int n) {
+  return edge_next_batch(iter, e_out, n, true);
+}
+
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int n) {
+  return edge_next_batch(iter, e_out, n, false);
+}
+
 template <typename FRAGMENT_TYPE_T>
 void get_all_edges(FRAGMENT_TYPE_T* frag, PartitionId channel_id,
                    const VID_TYPE* chunk_sizes,
@@ -1240,6 +1351,29 @@ int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out) {
 #endif
 }
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int n) {
+  int count = 0;
+  while (count < n) {
+    // 先取完当前点剩余的出边，再由get_all_edges_next切换到下一个点
+    int64_t remaining = std::min<int64_t>(n - count, iter->limit - iter->index);
+    if (remaining > 0 && iter->ei.list_id != iter->ei.list_num) {
+      int got = edge_next_batch(&iter->ei, e_out + count,
+                                static_cast<int>(remaining), true);
+      count += got;
+      iter->index += got;
+      if (got == remaining) {
+        continue;
+      }
+    }
+    if (get_all_edges_next(iter, e_out + count) != 0) {
+      break;
+    }
+    ++count;
+  }
+  return count;
+}
+
 void free_edge_iterator(EdgeIteratorImpl* iter) {
   if (iter->lists != NULL) {
     free(iter->lists);
@@ -97,6 +97,9 @@ void free_get_vertex_iterator(GetVertexIteratorImpl* iter);
 
 int get_vertices_next(GetVertexIteratorImpl* iter, Vertex* v_out);
 
+int get_vertices_next_batch(GetVertexIteratorImpl* iter, Vertex* v_out,
+                            int n);
+
 struct GetAllVerticesIteratorImpl {
   VERTEX_RANGE_TYPE* ranges;
   int range_num;
@@ -115,6 +118,9 @@ void free_get_all_vertices_iterator(GetAllVerticesIteratorImpl* iter);
 
 int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out);
 
+int get_all_vertices_next_batch(GetAllVerticesIteratorImpl* iter,
+                                Vertex* v_out, int n);
+
 struct PropertiesIteratorImpl {
   GraphHandleImpl* handle;
   arrow::Table* table;
@@ -132,6 +138,11 @@ template <typename FRAGMENT_TYPE>
 int get_vertex_property(FRAGMENT_TYPE* frag, Vertex v, PropertyId id,
                         Property* p_out);
 
+template <typename FRAGMENT_TYPE>
+int get_vertex_property_batch(FRAGMENT_TYPE* frag, LabelId label,
+                              const Vertex* vs, int n, PropertyId id,
+                              Property* p_out);
+
 template <typename FRAGMENT_TYPE>
 void get_vertex_properties(FRAGMENT_TYPE* frag, Vertex v,
                            PropertiesIteratorImpl* iter);
@@ -169,6 +180,8 @@ void get_out_edges(FRAGMENT_TYPE* frag,
 
 int out_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int n);
+
 template <typename FRAGMENT_TYPE>
 void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
                   VertexId dst_id, LabelId* labels, int labels_count,
@@ -176,6 +189,8 @@ void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
 
 int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int n);
+
 struct GetAllEdgesIteratorImpl {
   FRAGMENT_TYPE* fragment = nullptr;
   INT32_FRAGMENT_TYPE* int32_fragment = nullptr;
@@ -205,6 +220,9 @@ void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
 
 int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out);
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int n);
+
 void free_edge_iterator(EdgeIteratorImpl* iter);
 
 void free_get_all_edges_iterator(GetAllEdgesIteratorImpl* iter);
@@ -15,6 +15,10 @@
  */
 #include "property_graph_stream.h"
 
+#include <atomic>
+#include <thread>
+
+#include "arrow/array.h"
 #include "arrow/type.h"
 
 #include "vineyard/basic/stream/recordbatch_stream.h"
@@ -302,6 +306,25 @@ void PropertyTableAppender::Flush(
   }
 }
 
+// run func over [0, num) by a thread per core at most, e.g. to flush the
+// builders of different labels at the same time.
+static void ParallelFor(size_t num, std::function<void(size_t)> const& func) {
+  size_t thread_num = std::min<size_t>(
+      num, std::max(std::thread::hardware_concurrency(), 1u));
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t index = next++; index < num; index = next++) {
+        func(index);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 }  // namespace detail
 
 int PropertyGraphOutStream::Initialize(Schema schema) {
@@ -356,15 +379,7 @@ int PropertyGraphOutStream::AddVertex(VertexId id, LabelId labelid,
   std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
   appender->Apply(builder, id, property_size, properties,
                   vertex_property_id_mapping_[labelid], batch_chunk);
-  if (batch_chunk != nullptr && vertex_primary_key_column_[labelid] != kNoPrimaryKeyColumn) {
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-    ARROW_OK_OR_RAISE(
-      batch_chunk->RemoveColumn(vertex_primary_key_column_[labelid], &batch_chunk));
-#else
-    CHECK_ARROW_ERROR_AND_ASSIGN(batch_chunk,
-      batch_chunk->RemoveColumn(vertex_primary_key_column_[labelid]));
-#endif
-  }
+  this->removePrimaryKeyColumn(labelid, batch_chunk);
   this->buildTableChunk(batch_chunk, vertex_stream_, 1,
                         vertex_property_id_mapping_[labelid]);
 
@@ -380,31 +395,7 @@ int PropertyGraphOutStream::AddEdge(VertexId src_id,
   LOG(INFO) << "add edge: labelid = " << label
             << ", property_size = " << property_size;
 #endif
-  auto src_dst_key = std::make_pair(src_label, dst_label);
-  if (edge_builders_[label][src_dst_key] == nullptr) {
-    std::shared_ptr<arrow::KeyValueMetadata> metadata;
-    if (edge_schemas_[label]->metadata() != nullptr) {
-      metadata = edge_schemas_[label]->metadata()->Copy();
-    } else {
-      metadata.reset(new arrow::KeyValueMetadata());
-    }
-    metadata->Append("src_label_id", std::to_string(src_label));
-    metadata->Append("src_label", graph_schema_->GetLabelName(src_label));
-    metadata->Append("dst_label_id", std::to_string(dst_label));
-    metadata->Append("dst_label", graph_schema_->GetLabelName(dst_label));
-    auto schema = edge_schemas_[label]->WithMetadata(metadata);
-
-    std::unique_ptr<arrow::RecordBatchBuilder> builder = nullptr;
-#if defined(ARROW_VERSION) && ARROW_VERSION < 9000000
-    CHECK_ARROW_ERROR(arrow::RecordBatchBuilder::Make(
-        schema, arrow::default_memory_pool(), kDefaultBufferSize, &builder));
-#else
-    ARROW_CHECK_OK_AND_ASSIGN(builder, arrow::RecordBatchBuilder::Make(
-        schema, arrow::default_memory_pool(), kDefaultBufferSize));
-#endif
-    edge_builders_[label][src_dst_key].reset(builder.release());
-  }
-  auto &builder = edge_builders_[label][src_dst_key];
+  auto &builder = this->edgeBuilder(label, src_label, dst_label);
   auto &appender = edge_appenders_[label];
   VINEYARD_ASSERT(appender != nullptr, "edge label = " + std::to_string(label));
   std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
@@ -446,6 +437,47 @@ int PropertyGraphOutStream::AddEdges(size_t edge_size,
   return 0;
 }
 
+int PropertyGraphOutStream::AddVertexColumns(
+    LabelId labelid, std::shared_ptr<arrow::RecordBatch> const& columns) {
+  auto iter = vertex_schemas_.find(labelid);
+  if (iter == vertex_schemas_.end()) {
+    LOG(ERROR) << "add vertex columns: unknown vertex label " << labelid;
+    return -1;
+  }
+  std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
+  auto status = alignColumns(columns, iter->second, 1, batch_chunk);
+  if (!status.ok()) {
+    LOG(ERROR) << "add vertex columns of label " << labelid << ": "
+               << status.ToString();
+    return -1;
+  }
+  this->removePrimaryKeyColumn(labelid, batch_chunk);
+  this->buildTableChunk(batch_chunk, vertex_stream_, 1,
+                        vertex_property_id_mapping_[labelid]);
+  return 0;
+}
+
+int PropertyGraphOutStream::AddEdgeColumns(
+    LabelId label, LabelId src_label, LabelId dst_label,
+    std::shared_ptr<arrow::RecordBatch> const& columns) {
+  if (edge_schemas_.find(label) == edge_schemas_.end()) {
+    LOG(ERROR) << "add edge columns: unknown edge label " << label;
+    return -1;
+  }
+  // the schema carries the src/dst labels in its metadata
+  auto &builder = this->edgeBuilder(label, src_label, dst_label);
+  std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
+  auto status = alignColumns(columns, builder->schema(), 2, batch_chunk);
+  if (!status.ok()) {
+    LOG(ERROR) << "add edge columns of label " << label << ": "
+               << status.ToString();
+    return -1;
+  }
+  this->buildTableChunk(batch_chunk, edge_stream_, 2,
+                        edge_property_id_mapping_[label]);
+  return 0;
+}
+
 Status PropertyGraphOutStream::Abort() {
   VINEYARD_CHECK_OK(vertex_stream_->Abort());
   VINEYARD_CHECK_OK(edge_stream_->Abort());
@@ -576,6 +608,90 @@ void PropertyGraphOutStream::initialTables() {
   }
 }
 
+std::unique_ptr<arrow::RecordBatchBuilder>&
+PropertyGraphOutStream::edgeBuilder(LabelId label, LabelId src_label,
+                                    LabelId dst_label) {
+  auto src_dst_key = std::make_pair(src_label, dst_label);
+  if (edge_builders_[label][src_dst_key] == nullptr) {
+    std::shared_ptr<arrow::KeyValueMetadata> metadata;
+    if (edge_schemas_[label]->metadata() != nullptr) {
+      metadata = edge_schemas_[label]->metadata()->Copy();
+    } else {
+      metadata.reset(new arrow::KeyValueMetadata());
+    }
+    metadata->Append("src_label_id", std::to_string(src_label));
+    metadata->Append("src_label", graph_schema_->GetLabelName(src_label));
+    metadata->Append("dst_label_id", std::to_string(dst_label));
+    metadata->Append("dst_label", graph_schema_->GetLabelName(dst_label));
+    auto schema = edge_schemas_[label]->WithMetadata(metadata);
+
+    std::unique_ptr<arrow::RecordBatchBuilder> builder = nullptr;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 9000000
+    CHECK_ARROW_ERROR(arrow::RecordBatchBuilder::Make(
+        schema, arrow::default_memory_pool(), kDefaultBufferSize, &builder));
+#else
+    ARROW_CHECK_OK_AND_ASSIGN(builder, arrow::RecordBatchBuilder::Make(
+        schema, arrow::default_memory_pool(), kDefaultBufferSize));
+#endif
+    edge_builders_[label][src_dst_key].reset(builder.release());
+  }
+  return edge_builders_[label][src_dst_key];
+}
+
+Status PropertyGraphOutStream::alignColumns(
+    std::shared_ptr<arrow::RecordBatch> const& columns,
+    std::shared_ptr<arrow::Schema> const& schema, int const id_columns,
+    std::shared_ptr<arrow::RecordBatch>& batch_out) {
+  if (columns->num_columns() < id_columns) {
+    return Status::Invalid("expect at least " + std::to_string(id_columns) +
+                           " id columns, but got " +
+                           std::to_string(columns->num_columns()));
+  }
+  std::vector<std::shared_ptr<arrow::Array>> arrays(schema->num_fields());
+  for (int i = 0; i < id_columns; ++i) {
+    arrays[i] = columns->column(i);
+  }
+  for (int i = id_columns; i < columns->num_columns(); ++i) {
+    auto const& name = columns->schema()->field(i)->name();
+    int index = schema->GetFieldIndex(name);
+    if (index < id_columns) {
+      return Status::Invalid("unknown property column: " + name);
+    }
+    arrays[index] = columns->column(i);
+  }
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    auto const& type = schema->field(i)->type();
+    if (arrays[i] == nullptr) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 1000000
+      CHECK_ARROW_ERROR(
+          arrow::MakeArrayOfNull(type, columns->num_rows(), &arrays[i]));
+#else
+      CHECK_ARROW_ERROR_AND_ASSIGN(
+          arrays[i], arrow::MakeArrayOfNull(type, columns->num_rows()));
+#endif
+    } else if (!arrays[i]->type()->Equals(type)) {
+      return Status::Invalid("column '" + schema->field(i)->name() +
+                             "' expects " + type->ToString() + ", but got " +
+                             arrays[i]->type()->ToString());
+    }
+  }
+  batch_out = arrow::RecordBatch::Make(schema, columns->num_rows(), arrays);
+  return Status::OK();
+}
+
+void PropertyGraphOutStream::removePrimaryKeyColumn(
+    LabelId labelid, std::shared_ptr<arrow::RecordBatch>& batch) {
+  if (batch != nullptr && vertex_primary_key_column_[labelid] != kNoPrimaryKeyColumn) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    ARROW_OK_OR_RAISE(
+      batch->RemoveColumn(vertex_primary_key_column_[labelid], &batch));
+#else
+    CHECK_ARROW_ERROR_AND_ASSIGN(batch,
+      batch->RemoveColumn(vertex_primary_key_column_[labelid]));
+#endif
+  }
+}
+
 void PropertyGraphOutStream::buildTableChunk(
     std::shared_ptr<arrow::RecordBatch> batch,
     std::shared_ptr<vineyard::RecordBatchStream> &output_stream,
@@ -607,26 +723,30 @@ int PropertyGraphOutStream::FinishAllVertices() {
   if (vertex_finished_) {
     return 0;
   }
+  // the builders of labels are flushed in parallel, and the batches are
+  // written to the stream one by one.
+  std::vector<LabelId> labels;
+  std::vector<std::unique_ptr<arrow::RecordBatchBuilder>*> builders;
+  std::vector<detail::PropertyTableAppender*> appenders;
   for (auto& vertices : vertex_builders_) {
-    auto &builder = vertices.second;
     auto appender = vertex_appenders_[vertices.first];
-    VINEYARD_ASSERT(builder != nullptr && appender != nullptr);
-    std::shared_ptr<arrow::RecordBatch> batch = nullptr;
-    appender->Flush(builder, batch, true);
+    VINEYARD_ASSERT(vertices.second != nullptr && appender != nullptr);
+    labels.push_back(vertices.first);
+    builders.push_back(&vertices.second);
+    appenders.push_back(appender.get());
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches(labels.size());
+  detail::ParallelFor(labels.size(), [&](size_t index) {
+    appenders[index]->Flush(*builders[index], batches[index], true);
+  });
+  for (size_t index = 0; index < labels.size(); ++index) {
+    auto &batch = batches[index];
 #ifndef NDEBUG
     LOG(INFO) << "finish vertices: " << batch;
 #endif
-    if (batch != nullptr && vertex_primary_key_column_[vertices.first] != kNoPrimaryKeyColumn) {
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-      ARROW_OK_OR_RAISE(
-        batch->RemoveColumn(vertex_primary_key_column_[vertices.first], &batch));
-#else
-      CHECK_ARROW_ERROR_AND_ASSIGN(batch,
-        batch->RemoveColumn(vertex_primary_key_column_[vertices.first]));
-#endif
-    }
+    removePrimaryKeyColumn(labels[index], batch);
     buildTableChunk(batch, vertex_stream_, 1,
-                    vertex_property_id_mapping_[vertices.first]);
+                    vertex_property_id_mapping_[labels[index]]);
   }
   if (!vertex_stream_->IsOpen()) {
     VINEYARD_CHECK_OK(this->Open(vertex_stream_));
@@ -643,19 +763,28 @@ int PropertyGraphOutStream::FinishAllEdges() {
   if (edge_finished_) {
     return 0;
   }
+  std::vector<LabelId> labels;
+  std::vector<std::unique_ptr<arrow::RecordBatchBuilder>*> builders;
+  std::vector<detail::PropertyTableAppender*> appenders;
   for (auto& edges : edge_builders_) {
     for (auto &subedges: edges.second) {
-      auto &builder = subedges.second;
       auto appender = edge_appenders_[edges.first];
-      VINEYARD_ASSERT(builder != nullptr && appender != nullptr);
-      std::shared_ptr<arrow::RecordBatch> batch = nullptr;
-      appender->Flush(builder, batch, true);
+      VINEYARD_ASSERT(subedges.second != nullptr && appender != nullptr);
+      labels.push_back(edges.first);
+      builders.push_back(&subedges.second);
+      appenders.push_back(appender.get());
+    }
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches(labels.size());
+  detail::ParallelFor(labels.size(), [&](size_t index) {
+    appenders[index]->Flush(*builders[index], batches[index], true);
+  });
+  for (size_t index = 0; index < labels.size(); ++index) {
 #ifndef NDEBUG
-    LOG(INFO) << "finish edges: " << batch;
+    LOG(INFO) << "finish edges: " << batches[index];
 #endif
-      buildTableChunk(batch, edge_stream_, 2,
-                      edge_property_id_mapping_[edges.first]);
-    }
+    buildTableChunk(batches[index], edge_stream_, 2,
+                    edge_property_id_mapping_[labels[index]]);
   }
   if (!edge_stream_->IsOpen()) {
     VINEYARD_CHECK_OK(this->Open(edge_stream_));
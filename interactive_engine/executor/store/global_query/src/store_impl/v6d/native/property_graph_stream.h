@@ -333,6 +333,15 @@ class PropertyGraphOutStream : public Registered<PropertyGraphOutStream> {
                 LabelId* dst_labels, size_t* property_sizes,
                 Property* properties);
 
+  // append whole columns of a vertex label, the first column is the id.
+  int AddVertexColumns(LabelId labelid,
+                       std::shared_ptr<arrow::RecordBatch> const& columns);
+
+  // append whole columns of an edge relation, the first two columns are the
+  // src and dst ids.
+  int AddEdgeColumns(LabelId label, LabelId src_label, LabelId dst_label,
+                     std::shared_ptr<arrow::RecordBatch> const& columns);
+
   Status Abort();
 
   Status Finish();
@@ -348,6 +357,20 @@ class PropertyGraphOutStream : public Registered<PropertyGraphOutStream> {
                        int const property_offset,
                        std::map<int, int> const& property_id_mapping);
 
+  std::unique_ptr<arrow::RecordBatchBuilder>& edgeBuilder(LabelId label,
+                                                          LabelId src_label,
+                                                          LabelId dst_label);
+
+  // reorder the columns by the names of the schema and fill nulls for the
+  // missing properties.
+  Status alignColumns(std::shared_ptr<arrow::RecordBatch> const& columns,
+                      std::shared_ptr<arrow::Schema> const& schema,
+                      int const id_columns,
+                      std::shared_ptr<arrow::RecordBatch>& batch_out);
+
+  void removePrimaryKeyColumn(LabelId labelid,
+                              std::shared_ptr<arrow::RecordBatch>& batch);
+
   std::shared_ptr<htap::MGPropertyGraphSchema> graph_schema_;
 
   // record the mapping between property_id and table column index
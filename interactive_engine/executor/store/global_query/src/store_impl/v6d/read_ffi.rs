@@ -109,6 +109,7 @@ extern "C" {
     ) -> GetVertexIterator;
     fn v6d_free_get_vertex_iterator(iter: GetVertexIterator);
     fn v6d_get_vertices_next(iter: GetVertexIterator, v_out: *mut VertexHandle) -> FFIState;
+    fn v6d_get_vertices_next_batch(iter: GetVertexIterator, v_out: *mut VertexHandle, n: i32) -> i32;
 
     fn v6d_get_all_vertices(
         graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FfiLabelId, label_count: i32,
@@ -116,12 +117,18 @@ extern "C" {
     ) -> GetAllVerticesIterator;
     fn v6d_free_get_all_vertices_iterator(iter: GetAllVerticesIterator);
     fn v6d_get_all_vertices_next(iter: GetAllVerticesIterator, v_out: *mut VertexHandle) -> FFIState;
+    fn v6d_get_all_vertices_next_batch(
+        iter: GetAllVerticesIterator, v_out: *mut VertexHandle, n: i32,
+    ) -> i32;
 
     fn v6d_get_vertex_id(graph: GraphHandle, v: VertexHandle) -> VertexId;
     fn v6d_get_vertex_label(graph: GraphHandle, v: VertexHandle) -> LabelId;
     fn v6d_get_vertex_property(
         graph: GraphHandle, v: VertexHandle, id: PropertyId, p_out: *mut NativeProperty,
     ) -> FFIState;
+    fn v6d_get_vertex_property_batch(
+        graph: GraphHandle, vs: *const VertexHandle, n: i32, id: PropertyId, p_out: *mut NativeProperty,
+    ) -> i32;
     fn v6d_get_vertex_properties(graph: GraphHandle, v: VertexHandle) -> PropertiesIterator;
 
     fn v6d_free_properties_iterator(iter: PropertiesIterator);
@@ -133,6 +140,7 @@ extern "C" {
     ) -> OutEdgeIterator;
     fn v6d_free_out_edge_iterator(iter: OutEdgeIterator);
     fn v6d_out_edge_next(iter: OutEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn v6d_out_edge_next_batch(iter: OutEdgeIterator, e_out: *mut EdgeHandle, n: i32) -> i32;
 
     fn v6d_get_in_edges(
         graph: GraphHandle, partition_id: FFIPartitionId, dst_id: VertexId, labels: *const FfiLabelId,
@@ -140,6 +148,7 @@ extern "C" {
     ) -> InEdgeIterator;
     fn v6d_free_in_edge_iterator(iter: InEdgeIterator);
     fn v6d_in_edge_next(iter: InEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn v6d_in_edge_next_batch(iter: InEdgeIterator, e_out: *mut EdgeHandle, n: i32) -> i32;
 
     fn v6d_get_all_edges(
         graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FfiLabelId, label_count: i32,
@@ -147,6 +156,7 @@ extern "C" {
     ) -> GetAllEdgesIterator;
     fn v6d_free_get_all_edges_iterator(iter: GetAllEdgesIterator);
     fn v6d_get_all_edges_next(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn v6d_get_all_edges_next_batch(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle, n: i32) -> i32;
 
     fn v6d_get_edge_src_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
     fn v6d_get_edge_dst_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
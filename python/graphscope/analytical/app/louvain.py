@@ -28,7 +28,15 @@ __all__ = [
 
 @project_to_simple
 @not_compatible_for("arrow_property", "dynamic_property")
-def louvain(graph, min_progress=1000, progress_tries=1):
+def louvain(
+    graph,
+    min_progress=1000,
+    progress_tries=1,
+    native=False,
+    max_levels=10,
+    max_rounds=20,
+    min_gain=1e-6,
+):
     """Compute best partition on the `graph` by louvain.
 
     Args:
@@ -39,6 +47,16 @@ def louvain(graph, min_progress=1000, progress_tries=1):
                       on the current pass compared to the previous pass.
         progress_tries: number of times the min_progress setting is not met
                         before exiting form the current level and compressing the graph.
+        native (bool): Whether to run the native Louvain instead of the Pregel one.
+                       It moves the vertices of a fragment in parallel and coarsens
+                       the communities in CSR form, then fragment 0 runs the levels
+                       over the communities of all the fragments.
+                       min_progress and progress_tries are ignored by it.
+        max_levels (int): The maximum number of levels of the native Louvain.
+        max_rounds (int): The maximum number of rounds of local moving of a level
+                          of the native Louvain.
+        min_gain (float): The native Louvain ends the local moving of a level once
+                          a round gains less modularity than min_gain.
 
     Returns:
         :class:`graphscope.framework.context.VertexDataContextDAGNode`:
@@ -70,6 +88,10 @@ def louvain(graph, min_progress=1000, progress_tries=1):
     """
     if graph.is_directed():
         raise InvalidArgumentError("Louvain not support directed graph.")
+    if native:
+        return AppAssets(algo="louvain_native", context="vertex_data")(
+            graph, max_levels, max_rounds, min_gain
+        )
     return AppAssets(algo="louvain", context="vertex_data")(
         graph, min_progress, progress_tries
     )
@@ -57,12 +57,14 @@ def lpa(graph, max_round=10):
 @not_compatible_for(
     "dynamic_property", "arrow_projected", "dynamic_projected", "arrow_flattened"
 )
-def lpa_u2i(graph, max_round=10):
+def lpa_u2i(graph, max_round=10, tolerance=0.0):
     """Evaluate (multi-) label propagation on a property graph.
 
     Args:
         graph (:class:`graphscope.Graph`): A property graph.
         max_round (int, optional): Maximum number of rounds. Defaults to 10.
+        tolerance (float, optional): A label is sent to the neighbors of its vertex
+            once it has changed by more than tolerance. Defaults to 0.
 
     Returns:
         :class:`graphscope.framework.context.LabeledVertexPropertyContextDAGNode`:
@@ -80,7 +82,9 @@ def lpa_u2i(graph, max_round=10):
 
     """
     max_round = int(max_round)
-    return AppAssets(algo="lpau2i", context="labeled_vertex_property")(graph, max_round)
+    return AppAssets(algo="lpau2i", context="labeled_vertex_property")(
+        graph, max_round, float(tolerance)
+    )
 
 
 cdlp = lpa
@@ -29,7 +29,7 @@ __all__ = [
 
 @project_to_simple
 @not_compatible_for("arrow_property", "dynamic_property")
-def sssp(graph, src=0, weight=None):
+def sssp(graph, src=0, weight=None, delta=None):
     """Compute single source shortest path length on the `graph`.
 
     Note that the `sssp` algorithm requires an numerical property on the edge.
@@ -42,6 +42,9 @@ def sssp(graph, src=0, weight=None):
         weight (str, optional): The edge data key corresponding to the edge weight.
             Note that property under multiple labels should have the consistent index.
             Defaults to None.
+        delta (float, optional): If given, runs delta-stepping with buckets of
+            distances of width `delta`, or of a width derived from the edge weights
+            if `delta` is 0. Defaults to None, to run the frontier-wide relaxation.
 
     Returns:
         :class:`graphscope.framework.context.VertexDataContextDAGNode`:
@@ -72,4 +75,8 @@ def sssp(graph, src=0, weight=None):
                 "The edge data type is string, and the edge data type should be "
                 "integers or floating point numbers to run SSSP."
             )
+    if delta is not None:
+        return AppAssets(algo="sssp_delta_stepping", context="vertex_data")(
+            graph, src, float(delta)
+        )
     return AppAssets(algo="sssp", context="vertex_data")(graph, src)
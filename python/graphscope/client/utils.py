@@ -116,6 +116,8 @@ class GRPCUtils(object):
             yield item
 
     def parse_runstep_responses(self, responses):
+        # the chunks of each large result, joined once it has all arrived
+        # rather than appended to a growing bytes object one by one
         chunks = []
         response_head = None
         has_next = True
@@ -124,10 +126,10 @@ class GRPCUtils(object):
                 response_head = response
             else:
                 if not chunks or not has_next:
-                    chunks.append(response.body.chunk)
-                else:
-                    chunks[-1] += response.body.chunk
+                    chunks.append([])
+                chunks[-1].append(response.body.chunk)
                 has_next = response.body.has_next
+        chunks = [b"".join(pieces) for pieces in chunks]
         cursor = 0
         for op_result in response_head.head.results:
             if op_result.meta.has_large_result:
@@ -60,6 +60,7 @@ def load_from(
     vertex_map="global",
     compact_edges=False,
     use_perfect_hash=False,
+    partition_strategy="segmented",
 ) -> Graph:
     """Load a Arrow property graph using a list of vertex/edge specifications.
 
@@ -168,6 +169,13 @@ def load_from(
             at most 10%~20% performance degeneration in some algorithms.
         use_perfect_hash (bool, optional): Use perfect hashmap in vertex map to optimize the memory usage.
              Defaults to False.
+        partition_strategy (str, optional): How the vertices are partitioned to fragments, can be
+            "segmented", "edge_balanced", which balances the edges of fragments, "fennel",
+            which streams the vertices to the fragments most of their neighbors are in, or
+            "hybrid", which spreads the vertices of the highest degrees over the fragments
+            before balancing the edges as "edge_balanced".
+            The latter three need the loader to be built with the segmented partitioner.
+            Defaults to "segmented".
     """
 
     # Don't import the :code:`nx` in top-level statements to improve the
@@ -201,6 +209,7 @@ def load_from(
         types_pb2.VERTEX_MAP_TYPE: utils.i_to_attr(vertex_map),
         types_pb2.COMPACT_EDGES: utils.b_to_attr(compact_edges),
         types_pb2.USE_PERFECT_HASH: utils.b_to_attr(use_perfect_hash),
+        types_pb2.PARTITION_STRATEGY: utils.s_to_attr(partition_strategy),
     }
     op = dag_utils.create_graph(
         sess.session_id, graph_def_pb2.ARROW_PROPERTY, inputs=[loader_op], attrs=config
@@ -1076,14 +1076,20 @@ def betweenness_centrality(
     def _betweenness_centrality(
         G, k=None, normalized=True, weight=None, endpoints=False, seed=None
     ):
-        algorithm = "betweenness_centrality"
-        if weight is not None:
-            algorithm = "betweenness_centrality_generic"
-        return AppAssets(algo=algorithm, context="vertex_data")(
-            G, normalized=normalized, endpoints=endpoints
+        if weight is None and k is None:
+            return AppAssets(algo="betweenness_centrality", context="vertex_data")(
+                G, normalized=normalized, endpoints=endpoints
+            )
+        # sampled pivots are only supported by the generic app.
+        return AppAssets(algo="betweenness_centrality_generic", context="vertex_data")(
+            G,
+            normalized=normalized,
+            endpoints=endpoints,
+            k=0 if k is None else k,
+            seed=0 if seed is None else seed,
         )
 
-    if not isinstance(G, nx.Graph) or seed is not None:
+    if not isinstance(G, nx.Graph) or (seed is not None and not isinstance(seed, int)):
         return nxa.betweenness_centrality(G, k, normalized, weight, endpoints, seed)
     return _betweenness_centrality(
         G, k=k, normalized=normalized, weight=weight, endpoints=endpoints, seed=seed